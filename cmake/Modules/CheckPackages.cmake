@@ -57,3 +57,21 @@ if (DBUS)
         PURPOSE "Required by the DBUS feature"
     )
 endif()
+
+if (LIBDEFLATE)
+    find_package(PkgConfig QUIET REQUIRED)
+    pkg_check_modules(libdeflate REQUIRED IMPORTED_TARGET "libdeflate")
+endif()
+
+if (ZSTD)
+    find_package(PkgConfig QUIET REQUIRED)
+    pkg_check_modules(libzstd REQUIRED IMPORTED_TARGET "libzstd>=1.4.0")
+endif()
+
+if (IO_URING)
+    if (LibtorrentRasterbar_VERSION VERSION_LESS ${minLibtorrentVersion})
+        message(FATAL_ERROR "The IO_URING feature requires LibtorrentRasterbar >= ${minLibtorrentVersion}")
+    endif()
+    find_package(PkgConfig QUIET REQUIRED)
+    pkg_check_modules(liburing REQUIRED IMPORTED_TARGET "liburing")
+endif()
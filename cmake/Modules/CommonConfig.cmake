@@ -107,6 +107,18 @@ if (DBUS)
     target_compile_definitions(qbt_common_cfg INTERFACE QBT_USES_DBUS)
 endif()
 
+if (IO_URING)
+    target_compile_definitions(qbt_common_cfg INTERFACE QBT_USES_IO_URING)
+endif()
+
+if (LIBDEFLATE)
+    target_compile_definitions(qbt_common_cfg INTERFACE QBT_USES_LIBDEFLATE)
+endif()
+
+if (ZSTD)
+    target_compile_definitions(qbt_common_cfg INTERFACE QBT_USES_ZSTD)
+endif()
+
 if (LibtorrentRasterbar_VERSION VERSION_GREATER_EQUAL ${minLibtorrentVersion})
     target_compile_definitions(qbt_common_cfg INTERFACE QBT_USES_LIBTORRENT2)
 endif()
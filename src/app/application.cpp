@@ -30,6 +30,7 @@
 #include "application.h"
 
 #include <algorithm>
+#include <chrono>
 
 #ifdef DISABLE_GUI
 #include <cstdio>
@@ -47,7 +48,6 @@
 #include <QDebug>
 #include <QLibraryInfo>
 #include <QMetaObject>
-#include <QProcess>
 
 #ifndef DISABLE_GUI
 #include <QAbstractButton>
@@ -71,6 +71,7 @@
 #include "base/global.h"
 #include "base/logger.h"
 #include "base/net/downloadmanager.h"
+#include "base/net/faviconcache.h"
 #include "base/net/geoipmanager.h"
 #include "base/net/proxyconfigurationmanager.h"
 #include "base/net/smtp.h"
@@ -80,14 +81,20 @@
 #include "base/rss/rss_session.h"
 #include "base/search/searchpluginmanager.h"
 #include "base/settingsstorage.h"
+#include "base/speedhistory.h"
 #include "base/torrentfileswatcher.h"
+#include "base/torrentfilterindex.h"
+#include "base/tracer.h"
 #include "base/utils/fs.h"
 #include "base/utils/misc.h"
 #include "base/utils/os.h"
 #include "base/utils/string.h"
+#include "base/utils/thread.h"
 #include "base/version.h"
 #include "applicationinstancemanager.h"
+#include "externalprogramrunner.h"
 #include "filelogger.h"
+#include "startupscheduler.h"
 #include "upgrade.h"
 
 #ifndef DISABLE_GUI
@@ -105,6 +112,8 @@
 #endif
 #endif
 
+using namespace std::chrono_literals;
+
 namespace
 {
 #define SETTINGS_KEY(name) u"Application/" name
@@ -122,8 +131,16 @@ namespace
 
 #ifndef DISABLE_GUI
     const int PIXMAP_CACHE_SIZE = 64 * 1024 * 1024;  // 64MiB
+
+    // events of the same kind occurring within the window are shown in a single summary notification
+    const std::chrono::milliseconds DESKTOP_NOTIFICATION_COALESCING_WINDOW = 2s;
+    // torrents named explicitly in a summary notification
+    const int MAX_NOTIFICATION_TORRENT_NAMES = 5;
 #endif
 
+    // torrents finished within the window are reported in a single email
+    const std::chrono::milliseconds NOTIFICATION_EMAIL_COALESCING_WINDOW = 30s;
+
     const QString PARAM_ADDSTOPPED = u"@addStopped"_s;
     const QString PARAM_CATEGORY = u"@category"_s;
     const QString PARAM_FIRSTLASTPIECEPRIORITY = u"@firstLastPiecePriority"_s;
@@ -248,6 +265,8 @@ namespace
 
 Application::Application(int &argc, char **argv)
     : BaseApplication(argc, argv)
+    , m_notificationEmailCoalescer(NOTIFICATION_EMAIL_COALESCING_WINDOW
+            , [this](const QList<NotificationEmail> &emails) { sendNotificationEmails(emails); }, this)
     , m_commandLineArgs(parseCommandLine(Application::arguments()))
     , m_storeInstanceName(SETTINGS_KEY(u"InstanceName"_s))
     , m_storeFileLoggerEnabled(FILELOGGER_SETTINGS_KEY(u"Enabled"_s))
@@ -258,12 +277,28 @@ Application::Application(int &argc, char **argv)
     , m_storeFileLoggerAgeType(FILELOGGER_SETTINGS_KEY(u"AgeType"_s))
     , m_storeFileLoggerPath(FILELOGGER_SETTINGS_KEY(u"Path"_s))
     , m_storeMemoryWorkingSetLimit(SETTINGS_KEY(u"MemoryWorkingSetLimit"_s))
+    , m_storeBulkWorkPriorityLowered(SETTINGS_KEY(u"LowerBulkWorkPriority"_s))
+    , m_storeLatencySensitiveThreadsCPUAffinity(SETTINGS_KEY(u"LatencySensitiveThreadsCPUAffinity"_s))
 #ifdef Q_OS_WIN
     , m_processMemoryPriority(SETTINGS_KEY(u"ProcessMemoryPriority"_s))
 #endif
 #ifndef DISABLE_GUI
     , m_startUpWindowState(u"GUI/StartUpWindowState"_s)
     , m_storeNotificationTorrentAdded(NOTIFICATIONS_SETTINGS_KEY(u"TorrentAdded"_s))
+    , m_torrentFinishedNotificationCoalescer(DESKTOP_NOTIFICATION_COALESCING_WINDOW
+            , [this](const QStringList &torrentNames)
+    {
+        showNotifications(tr("Download completed")
+                , tr("'%1' has finished downloading.", "e.g: xxx.avi has finished downloading.")
+                , tr("%1 torrents have finished downloading:", "e.g: 10 torrents have finished downloading:")
+                , torrentNames);
+    }, this)
+    , m_torrentAddedNotificationCoalescer(DESKTOP_NOTIFICATION_COALESCING_WINDOW
+            , [this](const QStringList &torrentNames)
+    {
+        showNotifications(tr("Torrent added"), tr("'%1' was added.", "e.g: xxx.avi was added.")
+                , tr("%1 torrents were added:", "e.g: 10 torrents were added:"), torrentNames);
+    }, this)
 #endif
 {
     qRegisterMetaType<Log::Msg>("Log::Msg");
@@ -279,6 +314,8 @@ Application::Application(int &argc, char **argv)
 #endif
 
     Logger::initInstance();
+    if (!m_commandLineArgs.traceFilePath.isEmpty())
+        Tracer::initInstance(m_commandLineArgs.traceFilePath);
 
     const auto portableProfilePath = Path(QCoreApplication::applicationDirPath()) / DEFAULT_PORTABLE_MODE_PROFILE_DIR;
     const bool portableModeEnabled = m_commandLineArgs.profileDir.isEmpty() && Utils::Fs::isDir(portableProfilePath);
@@ -287,6 +324,7 @@ Application::Application(int &argc, char **argv)
                         (m_commandLineArgs.relativeFastresumePaths || portableModeEnabled));
 
     m_instanceManager = new ApplicationInstanceManager(Profile::instance()->location(SpecialFolder::Config), this);
+    m_externalProgramRunner = new ExternalProgramRunner(this);
 
     SettingsStorage::initInstance();
     Preferences::initInstance();
@@ -306,8 +344,11 @@ Application::Application(int &argc, char **argv)
 
     initializeTranslation();
 
+    applyLogMessageTypes();
+    connect(Preferences::instance(), &Preferences::changed, this, &Application::applyLogMessageTypes);
+
     connect(this, &QCoreApplication::aboutToQuit, this, &Application::cleanup);
-    connect(m_instanceManager, &ApplicationInstanceManager::messageReceived, this, &Application::processMessage);
+    connect(m_instanceManager, &ApplicationInstanceManager::messagesReceived, this, &Application::processMessages);
 #if defined(Q_OS_WIN) && !defined(DISABLE_GUI)
     connect(this, &QGuiApplication::commitDataRequest, this, &Application::shutdownCleanup, Qt::DirectConnection);
 #endif
@@ -415,6 +456,47 @@ void Application::setMemoryWorkingSetLimit(const int size)
 #endif
 }
 
+bool Application::isBulkWorkPriorityLowered() const
+{
+    return m_storeBulkWorkPriorityLowered.get(false);
+}
+
+void Application::setBulkWorkPriorityLowered(const bool value)
+{
+    m_storeBulkWorkPriorityLowered = value;
+}
+
+QString Application::latencySensitiveThreadsCPUAffinity() const
+{
+    return m_storeLatencySensitiveThreadsCPUAffinity.get();
+}
+
+void Application::setLatencySensitiveThreadsCPUAffinity(const QString &cpus)
+{
+    m_storeLatencySensitiveThreadsCPUAffinity = cpus.trimmed();
+}
+
+void Application::applyLogMessageTypes() const
+{
+    const auto *pref = Preferences::instance();
+    for (int i = 0; i < Log::CATEGORY_COUNT; ++i)
+    {
+        const auto category = static_cast<Log::Category>(i);
+        Logger::instance()->setMessageTypes(category, pref->getLogMessageTypes(category));
+    }
+}
+
+void Application::applyThreadSchedulingPolicy() const
+{
+    const QString cpus = latencySensitiveThreadsCPUAffinity();
+    const QList<int> latencySensitiveCPUs = Utils::Thread::parseCPUList(cpus);
+    if (!cpus.isEmpty() && latencySensitiveCPUs.isEmpty())
+        LogMsg(tr("Invalid CPU list for latency sensitive threads: \"%1\"").arg(cpus), Log::WARNING);
+
+    Utils::Thread::setSchedulingPolicy({.lowerBulkPriority = isBulkWorkPriorityLowered()
+            , .latencySensitiveCPUs = latencySensitiveCPUs});
+}
+
 bool Application::isFileLoggerEnabled() const
 {
     return m_storeFileLoggerEnabled.get(true);
@@ -501,10 +583,22 @@ void Application::setFileLoggerAgeType(const int value)
     m_storeFileLoggerAgeType = ((value < 0) || (value > 2)) ? 1 : value;
 }
 
-void Application::processMessage(const QString &message)
+void Application::processMessages(const QStringList &messages)
 {
+    // The messages of several instances may be received at once
+    QList<QBtCommandLineParameters> paramsList;
+    paramsList.reserve(messages.size());
+    [[maybe_unused]] bool isActivationRequested = false;
+    for (const QString &message : messages)
+    {
+        if (message.isEmpty())
+            isActivationRequested = true;
+        else
+            paramsList.append(parseParams(message));
+    }
+
 #ifndef DISABLE_GUI
-    if (message.isEmpty())
+    if (isActivationRequested)
     {
         if (BitTorrent::Session::instance()->isRestored()) [[likely]]
         {
@@ -520,18 +614,20 @@ void Application::processMessage(const QString &message)
         {
             createStartupProgressDialog();
         }
-
-        return;
     }
 #endif
 
-    const QBtCommandLineParameters params = parseParams(message);
     // If Application is not allowed to process params immediately
     // (i.e., other components are not ready) store params
     if (m_isProcessingParamsAllowed)
-        processParams(params);
+    {
+        for (const QBtCommandLineParameters &params : asConst(paramsList))
+            processParams(params);
+    }
     else
-        m_paramsQueue.append(params);
+    {
+        m_paramsQueue.append(paramsList);
+    }
 }
 
 void Application::runExternalProgram(const QString &programTemplate, const BitTorrent::Torrent *torrent) const
@@ -602,9 +698,6 @@ void Application::runExternalProgram(const QString &programTemplate, const BitTo
         return str;
     };
 
-    const QString logMsg = tr("Running external program. Torrent: \"%1\". Command: `%2`");
-    const QString logMsgError = tr("Failed to run external program. Torrent: \"%1\". Command: `%2`");
-
     // The processing sequence is different for Windows and other OS, this is intentional
 #if defined(Q_OS_WIN)
     const QString program = replaceVariables(programTemplate);
@@ -623,35 +716,8 @@ void Application::runExternalProgram(const QString &programTemplate, const BitTo
     for (int i = 1; i < argCount; ++i)
         argList += QString::fromWCharArray(args[i]);
 
-    QProcess proc;
-    proc.setProgram(QString::fromWCharArray(args[0]));
-    proc.setArguments(argList);
-    proc.setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments *args)
-    {
-        if (Preferences::instance()->isAutoRunConsoleEnabled())
-        {
-            args->flags |= CREATE_NEW_CONSOLE;
-            args->flags &= ~(CREATE_NO_WINDOW | DETACHED_PROCESS);
-        }
-        else
-        {
-            args->flags |= CREATE_NO_WINDOW;
-            args->flags &= ~(CREATE_NEW_CONSOLE | DETACHED_PROCESS);
-        }
-        args->inheritHandles = false;
-        args->startupInfo->dwFlags &= ~STARTF_USESTDHANDLES;
-        ::CloseHandle(args->startupInfo->hStdInput);
-        ::CloseHandle(args->startupInfo->hStdOutput);
-        ::CloseHandle(args->startupInfo->hStdError);
-        args->startupInfo->hStdInput = nullptr;
-        args->startupInfo->hStdOutput = nullptr;
-        args->startupInfo->hStdError = nullptr;
-    });
-
-    if (proc.startDetached())
-        LogMsg(logMsg.arg(torrent->name(), program));
-    else
-        LogMsg(logMsgError.arg(torrent->name(), program));
+    m_externalProgramRunner->run(programTemplate, {.program = QString::fromWCharArray(args[0]), .arguments = argList
+        , .commandLine = program, .torrentName = torrent->name()});
 #else // Q_OS_WIN
     QStringList args = Utils::String::splitCommand(programTemplate);
 
@@ -674,40 +740,35 @@ void Application::runExternalProgram(const QString &programTemplate, const BitTo
     }
 
     const QString command = args.takeFirst();
-    QProcess proc;
-    proc.setProgram(command);
-    proc.setArguments(args);
-    proc.setUnixProcessParameters(QProcess::UnixProcessFlag::CloseFileDescriptors);
+    // show intended command in log
+    m_externalProgramRunner->run(programTemplate, {.program = command, .arguments = args
+        , .commandLine = replaceVariables(programTemplate), .torrentName = torrent->name()});
+#endif
+}
 
-    if (proc.startDetached())
+void Application::sendNotificationEmails(const QList<NotificationEmail> &emails)
+{
+    QString subject;
+    QString content;
+    if (emails.size() == 1)
     {
-        // show intended command in log
-        LogMsg(logMsg.arg(torrent->name(), replaceVariables(programTemplate)));
+        subject = tr("Torrent \"%1\" has finished downloading").arg(emails.first().torrentName);
+        content = emails.first().content;
     }
     else
     {
-        // show intended command in log
-        LogMsg(logMsgError.arg(torrent->name(), replaceVariables(programTemplate)));
+        subject = tr("%1 torrents have finished downloading").arg(emails.size());
+        for (const NotificationEmail &email : emails)
+            content += email.content + u"\n\n";
     }
-#endif
-}
-
-void Application::sendNotificationEmail(const BitTorrent::Torrent *torrent)
-{
-    // Prepare mail content
-    const QString content = tr("Torrent name: %1").arg(torrent->name()) + u'\n'
-        + tr("Torrent size: %1").arg(Utils::Misc::friendlyUnit(torrent->wantedSize())) + u'\n'
-        + tr("Save path: %1").arg(torrent->savePath().toString()) + u"\n\n"
-        + tr("The torrent was downloaded in %1.", "The torrent was downloaded in 1 hour and 20 seconds")
-            .arg(Utils::Misc::userFriendlyDuration(torrent->activeTime())) + u"\n\n\n"
-        + tr("Thank you for using qBittorrent.") + u'\n';
+    content += u'\n' + tr("Thank you for using qBittorrent.") + u'\n';
 
     // Send the notification email
     const Preferences *pref = Preferences::instance();
     auto *smtp = new Net::Smtp(this);
     smtp->sendMail(pref->getMailNotificationSender(),
                      pref->getMailNotificationEmail(),
-                     tr("Torrent \"%1\" has finished downloading").arg(torrent->name()),
+                     subject,
                      content);
 }
 
@@ -750,7 +811,13 @@ void Application::torrentFinished(const BitTorrent::Torrent *torrent)
     if (pref->isMailNotificationEnabled())
     {
         LogMsg(tr("Torrent: %1, sending mail notification").arg(torrent->name()));
-        sendNotificationEmail(torrent);
+        // Prepare mail content
+        const QString content = tr("Torrent name: %1").arg(torrent->name()) + u'\n'
+            + tr("Torrent size: %1").arg(Utils::Misc::friendlyUnit(torrent->wantedSize())) + u'\n'
+            + tr("Save path: %1").arg(torrent->savePath().toString()) + u"\n\n"
+            + tr("The torrent was downloaded in %1.", "The torrent was downloaded in 1 hour and 20 seconds")
+                .arg(Utils::Misc::userFriendlyDuration(torrent->activeTime())) + u"\n\n";
+        m_notificationEmailCoalescer.add({.torrentName = torrent->name(), .content = content});
     }
 
 #ifndef DISABLE_GUI
@@ -832,11 +899,19 @@ void Application::processParams(const QBtCommandLineParameters &params)
     AddTorrentOption addTorrentOption = AddTorrentOption::Default;
     if (params.skipDialog.has_value())
         addTorrentOption = params.skipDialog.value() ? AddTorrentOption::SkipDialog : AddTorrentOption::ShowDialog;
+
+    // The torrents added without dialog are loaded in batches in the background
+    if ((addTorrentOption == AddTorrentOption::SkipDialog)
+            || ((addTorrentOption == AddTorrentOption::Default) && !Preferences::instance()->isAddNewTorrentDialogEnabled()))
+    {
+        m_addTorrentManager->addTorrents(params.torrentSources, params.addTorrentParams);
+        return;
+    }
+
     for (const QString &torrentSource : params.torrentSources)
         m_addTorrentManager->addTorrent(torrentSource, params.addTorrentParams, addTorrentOption);
 #else
-    for (const QString &torrentSource : params.torrentSources)
-        m_addTorrentManager->addTorrent(torrentSource, params.addTorrentParams);
+    m_addTorrentManager->addTorrents(params.torrentSources, params.addTorrentParams);
 #endif
 }
 
@@ -856,10 +931,20 @@ int Application::exec()
     adjustThreadPriority();
 #endif
 
+    // It should be applied before the worker threads are started
+    applyThreadSchedulingPolicy();
+
     Net::ProxyConfigurationManager::initInstance();
     Net::DownloadManager::initInstance();
 
-    BitTorrent::Session::initInstance();
+    {
+        const TraceSpan traceSpan {"Session::initInstance"};
+        BitTorrent::Session::initInstance();
+    }
+    // Threads inherit the CPU affinity, so it is pinned after the libtorrent threads are started
+    Utils::Thread::applyWorkload(Utils::Thread::Workload::LatencySensitive);
+    TorrentFilterIndex::initInstance();
+    SpeedHistory::initInstance();
 #ifndef DISABLE_GUI
     UIThemeManager::initInstance();
 
@@ -895,21 +980,40 @@ int Application::exec()
         connect(m_desktopIntegration, &DesktopIntegration::activationRequested, this, &Application::createStartupProgressDialog);
     }
 #endif
-    connect(BitTorrent::Session::instance(), &BitTorrent::Session::restored, this, [this]()
+    // Torrents are restored first, the rest of the components are brought up one by one after it,
+    // so they don't compete with restoring torrents for CPU and disk
+    auto *startupScheduler = new StartupScheduler(this);
+    startupScheduler->addStage("Application::initComponents", [this]
     {
         connect(BitTorrent::Session::instance(), &BitTorrent::Session::torrentAdded, this, &Application::torrentAdded);
         connect(BitTorrent::Session::instance(), &BitTorrent::Session::torrentFinished, this, &Application::torrentFinished);
         connect(BitTorrent::Session::instance(), &BitTorrent::Session::allTorrentsFinished, this, &Application::allTorrentsFinished, Qt::QueuedConnection);
 
         m_addTorrentManager = new AddTorrentManagerImpl(this, BitTorrent::Session::instance(), this);
-
+    });
+    startupScheduler->addStage("GeoIPManager::initInstance", []
+    {
         Net::GeoIPManager::initInstance();
+    });
+    startupScheduler->addStage("FaviconCache::initInstance", []
+    {
+        Net::FaviconCache::initInstance();
+    });
+    startupScheduler->addStage("TorrentFilesWatcher::initInstance", []
+    {
         TorrentFilesWatcher::initInstance();
-
+    });
+    startupScheduler->addStage("RSS::Session", []
+    {
         new RSS::Session; // create RSS::Session singleton
+    });
+    startupScheduler->addStage("RSS::AutoDownloader", [this]
+    {
         new RSS::AutoDownloader(this); // create RSS::AutoDownloader singleton
-
+    });
 #ifndef DISABLE_GUI
+    startupScheduler->addStage("MainWindow", [this]
+    {
         const auto *btSession = BitTorrent::Session::instance();
         connect(btSession, &BitTorrent::Session::fullDiskError, this
                 , [this](const BitTorrent::Torrent *torrent, const QString &msg)
@@ -921,13 +1025,13 @@ int Application::exec()
         connect(btSession, &BitTorrent::Session::torrentFinished, this
                 , [this](const BitTorrent::Torrent *torrent)
         {
-            m_desktopIntegration->showNotification(tr("Download completed"), tr("'%1' has finished downloading.", "e.g: xxx.avi has finished downloading.").arg(torrent->name()));
+            m_torrentFinishedNotificationCoalescer.add(torrent->name());
         });
         connect(m_addTorrentManager, &AddTorrentManager::torrentAdded, this
                 , [this]([[maybe_unused]] const QString &source, const BitTorrent::Torrent *torrent)
         {
             if (isTorrentAddedNotificationsEnabled())
-                m_desktopIntegration->showNotification(tr("Torrent added"), tr("'%1' was added.", "e.g: xxx.avi was added.").arg(torrent->name()));
+                m_torrentAddedNotificationCoalescer.add(torrent->name());
         });
         connect(m_addTorrentManager, &AddTorrentManager::addTorrentFailed, this
                 , [this](const QString &source, const BitTorrent::AddTorrentError &reason)
@@ -948,9 +1052,11 @@ int Application::exec()
         m_window = new MainWindow(this, windowState, instanceName());
 
         delete m_startupProgressDialog;
+    });
 #endif // DISABLE_GUI
-
 #ifndef DISABLE_WEBUI
+    startupScheduler->addStage("WebUI", [this]
+    {
 #ifndef DISABLE_GUI
         m_webui = new WebUI(this);
 #else
@@ -993,13 +1099,18 @@ int Application::exec()
             printf("%s\n", qUtf8Printable(tr("The WebUI is disabled! To enable the WebUI, edit the config file manually.")));
         }
 #endif // DISABLE_GUI
+    });
 #endif // DISABLE_WEBUI
-
+    connect(startupScheduler, &StartupScheduler::finished, this, [this, startupScheduler]
+    {
         m_isProcessingParamsAllowed = true;
         for (const QBtCommandLineParameters &params : asConst(m_paramsQueue))
             processParams(params);
         m_paramsQueue.clear();
+
+        startupScheduler->deleteLater();
     });
+    connect(BitTorrent::Session::instance(), &BitTorrent::Session::restored, startupScheduler, &StartupScheduler::start);
 
     const QBtCommandLineParameters params = commandLineArgs();
     if (!params.torrentSources.isEmpty())
@@ -1063,6 +1174,22 @@ void Application::createStartupProgressDialog()
     });
 }
 
+void Application::showNotifications(const QString &title, const QString &singleMessage, const QString &summaryMessage
+        , const QStringList &torrentNames) const
+{
+    if (torrentNames.size() == 1)
+    {
+        m_desktopIntegration->showNotification(title, singleMessage.arg(torrentNames.first()));
+        return;
+    }
+
+    QStringList lines {summaryMessage.arg(torrentNames.size())};
+    lines.append(torrentNames.first(std::min<qsizetype>(torrentNames.size(), MAX_NOTIFICATION_TORRENT_NAMES)));
+    if (torrentNames.size() > MAX_NOTIFICATION_TORRENT_NAMES)
+        lines.append(tr("and %1 more", "e.g: and 5 more").arg(torrentNames.size() - MAX_NOTIFICATION_TORRENT_NAMES));
+    m_desktopIntegration->showNotification(title, lines.join(u'\n'));
+}
+
 void Application::askRecursiveTorrentDownloadConfirmation(const BitTorrent::Torrent *torrent)
 {
     const auto torrentID = torrent->id();
@@ -1392,8 +1519,11 @@ void Application::cleanup()
 
     TorrentFilesWatcher::freeInstance();
     delete m_addTorrentManager;
+    SpeedHistory::freeInstance();
+    TorrentFilterIndex::freeInstance();
     BitTorrent::Session::freeInstance();
     Net::GeoIPManager::freeInstance();
+    Net::FaviconCache::freeInstance();
     Net::DownloadManager::freeInstance();
     Net::ProxyConfigurationManager::freeInstance();
     Preferences::freeInstance();
@@ -1402,6 +1532,7 @@ void Application::cleanup()
     Utils::Fs::removeDirRecursively(Utils::Fs::tempPath());
 
     LogMsg(tr("qBittorrent is now ready to exit"));
+    Tracer::freeInstance();
     Logger::freeInstance();
     delete m_fileLogger;
 
@@ -48,12 +48,14 @@
 #include "base/settingvalue.h"
 #include "base/types.h"
 #include "cmdoptions.h"
+#include "eventcoalescer.h"
 
 #ifndef DISABLE_GUI
 #include "gui/interfaces/iguiapplication.h"
 #endif
 
 class ApplicationInstanceManager;
+class ExternalProgramRunner;
 class FileLogger;
 
 namespace BitTorrent
@@ -127,6 +129,11 @@ public:
     int memoryWorkingSetLimit() const override;
     void setMemoryWorkingSetLimit(int size) override;
 
+    bool isBulkWorkPriorityLowered() const override;
+    void setBulkWorkPriorityLowered(bool value) override;
+    QString latencySensitiveThreadsCPUAffinity() const override;
+    void setLatencySensitiveThreadsCPUAffinity(const QString &cpus) override;
+
     void sendTestEmail() const override;
 
 #ifdef Q_OS_WIN
@@ -146,7 +153,7 @@ public:
 #endif
 
 private slots:
-    void processMessage(const QString &message);
+    void processMessages(const QStringList &messages);
     void torrentAdded(const BitTorrent::Torrent *torrent) const;
     void torrentFinished(const BitTorrent::Torrent *torrent);
     void allTorrentsFinished();
@@ -157,6 +164,12 @@ private slots:
 #endif
 
 private:
+    struct NotificationEmail
+    {
+        QString torrentName;
+        QString content;
+    };
+
     AddTorrentManagerImpl *addTorrentManager() const override;
 #ifndef DISABLE_WEBUI
     WebUI *webUI() const override;
@@ -165,7 +178,9 @@ private:
     void initializeTranslation();
     void processParams(const QBtCommandLineParameters &params);
     void runExternalProgram(const QString &programTemplate, const BitTorrent::Torrent *torrent) const;
-    void sendNotificationEmail(const BitTorrent::Torrent *torrent);
+    void sendNotificationEmails(const QList<NotificationEmail> &emails);
+    void applyLogMessageTypes() const;
+    void applyThreadSchedulingPolicy() const;
 
 #if defined(QBT_USES_LIBTORRENT2) && !defined(Q_OS_MACOS)
     void applyMemoryWorkingSetLimit() const;
@@ -181,11 +196,15 @@ private:
 #ifdef Q_OS_MACOS
     bool event(QEvent *) override;
 #endif
+    void showNotifications(const QString &title, const QString &singleMessage, const QString &summaryMessage
+            , const QStringList &torrentNames) const;
     void askRecursiveTorrentDownloadConfirmation(const BitTorrent::Torrent *torrent);
     void recursiveTorrentDownload(const BitTorrent::TorrentID &torrentID);
 #endif
 
     ApplicationInstanceManager *m_instanceManager = nullptr;
+    ExternalProgramRunner *m_externalProgramRunner = nullptr;
+    EventCoalescer<NotificationEmail> m_notificationEmailCoalescer;
     std::atomic_bool m_isCleanupRun;
     bool m_isProcessingParamsAllowed = false;
     ShutdownDialogAction m_shutdownAct = ShutdownDialogAction::Exit;
@@ -208,6 +227,8 @@ private:
     SettingValue<int> m_storeFileLoggerAgeType;
     SettingValue<Path> m_storeFileLoggerPath;
     SettingValue<int> m_storeMemoryWorkingSetLimit;
+    SettingValue<bool> m_storeBulkWorkPriorityLowered;
+    SettingValue<QString> m_storeLatencySensitiveThreadsCPUAffinity;
 
 #ifdef Q_OS_WIN
     SettingValue<MemoryPriority> m_processMemoryPriority;
@@ -218,6 +239,8 @@ private:
 #ifndef DISABLE_GUI
     SettingValue<WindowState> m_startUpWindowState;
     SettingValue<bool> m_storeNotificationTorrentAdded;
+    EventCoalescer<QString> m_torrentFinishedNotificationCoalescer;
+    EventCoalescer<QString> m_torrentAddedNotificationCoalescer;
 
     DesktopIntegration *m_desktopIntegration = nullptr;
     MainWindow *m_window = nullptr;
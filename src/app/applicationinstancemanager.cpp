@@ -45,7 +45,7 @@ ApplicationInstanceManager::ApplicationInstanceManager(const Path &instancePath,
     , m_peer {new QtLocalPeer(instancePath.data(), this)}
     , m_isFirstInstance {!m_peer->isClient()}
 {
-    connect(m_peer, &QtLocalPeer::messageReceived, this, &ApplicationInstanceManager::messageReceived);
+    connect(m_peer, &QtLocalPeer::messagesReceived, this, &ApplicationInstanceManager::messagesReceived);
 
 #ifdef Q_OS_WIN
     const QString sharedMemoryKey = instancePath.data() + u"/shared-memory";
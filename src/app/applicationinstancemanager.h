@@ -29,6 +29,7 @@
 #pragma once
 
 #include <QObject>
+#include <QStringList>
 
 #include "base/pathfwd.h"
 
@@ -48,7 +49,7 @@ public slots:
     bool sendMessage(const QString &message, int timeout = 5000);
 
 signals:
-    void messageReceived(const QString &message);
+    void messagesReceived(const QStringList &messages);
 
 private:
     QtLocalPeer *m_peer = nullptr;
@@ -321,6 +321,7 @@ namespace
     constexpr const StringOption PROFILE_OPTION {u"profile"};
     constexpr const StringOption CONFIGURATION_OPTION {u"configuration"};
     constexpr const BoolOption RELATIVE_FASTRESUME {u"relative-fastresume"};
+    constexpr const StringOption TRACE_OPTION {u"trace"};
     constexpr const StringOption SAVE_PATH_OPTION {u"save-path"};
     constexpr const TriStateBoolOption STOPPED_OPTION {u"add-stopped", true};
     constexpr const BoolOption SKIP_HASH_CHECK_OPTION {u"skip-hash-check"};
@@ -343,6 +344,7 @@ QBtCommandLineParameters::QBtCommandLineParameters(const QProcessEnvironment &en
     , skipDialog(SKIP_DIALOG_OPTION.value(env))
     , profileDir(Utils::Fs::toAbsolutePath(Path(PROFILE_OPTION.value(env))))
     , configurationName(CONFIGURATION_OPTION.value(env))
+    , traceFilePath(Utils::Fs::toAbsolutePath(Path(TRACE_OPTION.value(env))))
 {
     addTorrentParams.savePath = Path(SAVE_PATH_OPTION.value(env));
     addTorrentParams.category = CATEGORY_OPTION.value(env);
@@ -417,6 +419,10 @@ QBtCommandLineParameters parseCommandLine(const QStringList &args)
             {
                 result.configurationName = CONFIGURATION_OPTION.value(arg);
             }
+            else if (arg == TRACE_OPTION)
+            {
+                result.traceFilePath = Utils::Fs::toAbsolutePath(Path(TRACE_OPTION.value(arg)));
+            }
             else if (arg == SAVE_PATH_OPTION)
             {
                 result.addTorrentParams.savePath = Path(SAVE_PATH_OPTION.value(arg));
@@ -527,6 +533,9 @@ QString makeUsage(const QString &prgName)
         + RELATIVE_FASTRESUME.usage()
         + wrapText(QCoreApplication::translate("CMD Options", "Hack into libtorrent fastresume files and make file paths relative "
                                 "to the profile directory")) + u'\n'
+        + TRACE_OPTION.usage(QCoreApplication::translate("CMD Options", "file"))
+        + wrapText(QCoreApplication::translate("CMD Options", "Record the durations of startup phases and other operations "
+                                "and save them to <file> in Chrome trace format on exit")) + u'\n'
         + Option::padUsageText(QCoreApplication::translate("CMD Options", "files or URLs"))
         + wrapText(QCoreApplication::translate("CMD Options", "Download the torrents passed by the user")) + u'\n'
         + u'\n'
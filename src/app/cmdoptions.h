@@ -59,6 +59,7 @@ struct QBtCommandLineParameters
     std::optional<bool> skipDialog;
     Path profileDir;
     QString configurationName;
+    Path traceFilePath;
 
     QStringList torrentSources;
     BitTorrent::AddTorrentParams addTorrentParams;
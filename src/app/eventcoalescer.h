@@ -0,0 +1,83 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <utility>
+
+#include <QList>
+#include <QObject>
+#include <QTimer>
+
+// Delivers the first event right away and the events following it within `window` together,
+// so a burst of events (e.g. many torrents finished at once) is handled a few times only
+template <typename Event>
+class EventCoalescer
+{
+    Q_DISABLE_COPY_MOVE(EventCoalescer)
+
+public:
+    using Handler = std::function<void (const QList<Event> &events)>;
+
+    EventCoalescer(const std::chrono::milliseconds window, Handler handler, QObject *parent)
+        : m_handler {std::move(handler)}
+        , m_timer {new QTimer(parent)}
+    {
+        m_timer->setSingleShot(true);
+        m_timer->setInterval(window);
+        QObject::connect(m_timer, &QTimer::timeout, m_timer, [this] { flush(); });
+    }
+
+    void add(Event event)
+    {
+        if (m_timer->isActive())
+        {
+            m_pendingEvents.append(std::move(event));
+            return;
+        }
+
+        m_handler({std::move(event)});
+        m_timer->start();
+    }
+
+private:
+    void flush()
+    {
+        if (m_pendingEvents.isEmpty())
+            return;
+
+        m_handler(std::exchange(m_pendingEvents, {}));
+        // the burst may still be going on
+        m_timer->start();
+    }
+
+    Handler m_handler;
+    QTimer *m_timer = nullptr;
+    QList<Event> m_pendingEvents;
+};
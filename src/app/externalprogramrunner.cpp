@@ -0,0 +1,192 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "externalprogramrunner.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <QtSystemDetection>
+#include <QProcess>
+#include <QTimer>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#endif
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/preferences.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Torrents are usually added or finished in bursts (e.g. by RSS or a recheck),
+    // so their invocations are collected a bit before the program is run
+    const std::chrono::milliseconds BATCHING_DELAY = 1s;
+}
+
+ExternalProgramRunner::ExternalProgramRunner(QObject *parent)
+    : QObject(parent)
+    , m_batchingTimer {new QTimer(this)}
+{
+    m_batchingTimer->setSingleShot(true);
+    m_batchingTimer->setInterval(BATCHING_DELAY);
+    connect(m_batchingTimer, &QTimer::timeout, this, &ExternalProgramRunner::processQueue);
+}
+
+// The programs still running are terminated
+ExternalProgramRunner::~ExternalProgramRunner()
+{
+    for (QProcess *process : asConst(m_runningProcesses))
+        process->disconnect(this);
+}
+
+void ExternalProgramRunner::run(const QString &batchKey, const Command &command)
+{
+    const QString inputLine = command.arguments.join(u'\t');
+
+    if (Preferences::instance()->isAutoRunBatchingEnabled())
+    {
+        const auto jobIter = std::ranges::find_if(m_queue, [&batchKey](const Job &job)
+        {
+            return (job.batchKey == batchKey);
+        });
+        if (jobIter != m_queue.end())
+        {
+            jobIter->inputLines.append(inputLine);
+            jobIter->torrentNames.append(command.torrentName);
+            return;
+        }
+
+        m_queue.append({.batchKey = batchKey, .command = command, .inputLines = {inputLine}, .torrentNames = {command.torrentName}});
+        if (!m_batchingTimer->isActive())
+            m_batchingTimer->start();
+        return;
+    }
+
+    m_queue.append({.batchKey = batchKey, .command = command, .inputLines = {}, .torrentNames = {command.torrentName}});
+    processQueue();
+}
+
+void ExternalProgramRunner::processQueue()
+{
+    // the invocations are still being collected
+    if (m_batchingTimer->isActive())
+        return;
+
+    while (!m_queue.isEmpty() && (m_runningProcesses.size() < Preferences::instance()->getAutoRunMaxProcesses()))
+        startJob(m_queue.takeFirst());
+}
+
+void ExternalProgramRunner::startJob(const Job &job)
+{
+    const Command &command = job.command;
+    const bool isBatch = !job.inputLines.isEmpty();
+    const QString torrentNames = (job.torrentNames.size() == 1)
+        ? job.torrentNames.first()
+        : tr("%1 torrents").arg(job.torrentNames.size());
+
+    auto *process = new QProcess(this);
+    process->setProgram(command.program);
+    process->setArguments(command.arguments);
+    if (!isBatch)
+        process->setStandardInputFile(QProcess::nullDevice());
+    process->setStandardOutputFile(QProcess::nullDevice());
+    process->setStandardErrorFile(QProcess::nullDevice());
+
+#ifdef Q_OS_WIN
+    process->setCreateProcessArgumentsModifier([](QProcess::CreateProcessArguments *args)
+    {
+        if (Preferences::instance()->isAutoRunConsoleEnabled())
+        {
+            // the program uses its own console, so the list of torrents can't be passed to it
+            args->flags |= CREATE_NEW_CONSOLE;
+            args->flags &= ~(CREATE_NO_WINDOW | DETACHED_PROCESS);
+            args->inheritHandles = false;
+            args->startupInfo->dwFlags &= ~STARTF_USESTDHANDLES;
+            ::CloseHandle(args->startupInfo->hStdInput);
+            ::CloseHandle(args->startupInfo->hStdOutput);
+            ::CloseHandle(args->startupInfo->hStdError);
+            args->startupInfo->hStdInput = nullptr;
+            args->startupInfo->hStdOutput = nullptr;
+            args->startupInfo->hStdError = nullptr;
+        }
+        else
+        {
+            args->flags |= CREATE_NO_WINDOW;
+            args->flags &= ~(CREATE_NEW_CONSOLE | DETACHED_PROCESS);
+        }
+    });
+#else
+    process->setUnixProcessParameters(QProcess::UnixProcessFlag::CloseFileDescriptors);
+#endif
+
+    const auto removeProcess = [this, process]
+    {
+        if (!m_runningProcesses.removeOne(process))
+            return;
+
+        process->deleteLater();
+        processQueue();
+    };
+
+    connect(process, &QProcess::errorOccurred, this, [process, command, torrentNames, removeProcess](const QProcess::ProcessError error)
+    {
+        // other errors are followed by `finished` signal
+        if (error != QProcess::FailedToStart)
+            return;
+
+        LogMsg(tr("Failed to run external program. Torrent: \"%1\". Command: `%2`").arg(torrentNames, command.commandLine), Log::WARNING);
+        removeProcess();
+    });
+    connect(process, &QProcess::finished, this, removeProcess);
+
+    if (const int timeout = Preferences::instance()->getAutoRunTimeout(); timeout > 0)
+    {
+        QTimer::singleShot(std::chrono::seconds(timeout), process, [process, command, torrentNames]
+        {
+            if (process->state() == QProcess::NotRunning)
+                return;
+
+            LogMsg(tr("External program timed out and was terminated. Torrent: \"%1\". Command: `%2`")
+                .arg(torrentNames, command.commandLine), Log::WARNING);
+            process->kill();
+        });
+    }
+
+    m_runningProcesses.append(process);
+    LogMsg(tr("Running external program. Torrent: \"%1\". Command: `%2`").arg(torrentNames, command.commandLine));
+    process->start(QIODevice::ReadWrite);
+
+    if (isBatch)
+    {
+        process->write((job.inputLines.join(u'\n') + u'\n').toUtf8());
+        process->closeWriteChannel();
+    }
+}
@@ -0,0 +1,79 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QProcess;
+class QTimer;
+
+// Runs the external programs of "run external program" hooks. The number of programs running
+// at once is limited, the rest of them wait in a queue. If batching is enabled, the waiting
+// invocations of the same command are merged, so the program is run once for many torrents.
+class ExternalProgramRunner final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(ExternalProgramRunner)
+
+public:
+    struct Command
+    {
+        QString program;
+        QStringList arguments;
+        // intended command shown in log
+        QString commandLine;
+        QString torrentName;
+    };
+
+    explicit ExternalProgramRunner(QObject *parent = nullptr);
+    ~ExternalProgramRunner() override;
+
+    // Commands of the same `batchKey` (e.g. the ones created from the same template) can be batched
+    void run(const QString &batchKey, const Command &command);
+
+private:
+    struct Job
+    {
+        QString batchKey;
+        Command command;
+        // if batching is enabled, the arguments of every torrent of the job are passed
+        // to the program through standard input, one line (with tab separated arguments) per torrent
+        QStringList inputLines;
+        QStringList torrentNames;
+    };
+
+    void processQueue();
+    void startJob(const Job &job);
+
+    QList<Job> m_queue;
+    QList<QProcess *> m_runningProcesses;
+    QTimer *m_batchingTimer = nullptr;
+};
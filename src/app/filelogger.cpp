@@ -32,60 +32,98 @@
 
 #include <QDateTime>
 #include <QDir>
+#include <QFile>
 #include <QList>
-#include <QTextStream>
+#include <QThread>
 
 #include "base/global.h"
 #include "base/logger.h"
 #include "base/utils/fs.h"
+#include "base/utils/gzip.h"
+#include "base/utils/io.h"
 
 namespace
 {
-    const std::chrono::seconds FLUSH_INTERVAL {2};
+    const std::chrono::seconds FLUSH_INTERVAL {1};
+    // Pending data is passed to the writer immediately once it reaches this size
+    const qsizetype BATCH_SIZE = 64 * 1024;
+    const qint64 MAX_QUEUED_SIZE = 8 * 1024 * 1024;
+    // Larger backups are kept uncompressed to avoid loading them in memory
+    const qint64 MAX_COMPRESSED_BACKUP_SIZE = 32 * 1024 * 1024;
+
+    QByteArray formatMessage(const Log::MsgType type, const qint64 timestamp, const QString &message)
+    {
+        QString prefix;
+        switch (type)
+        {
+        case Log::INFO:
+            prefix = u"(I) "_s;
+            break;
+        case Log::WARNING:
+            prefix = u"(W) "_s;
+            break;
+        case Log::CRITICAL:
+            prefix = u"(C) "_s;
+            break;
+        default:
+            prefix = u"(N) "_s;
+        }
+
+        return (prefix + QDateTime::fromSecsSinceEpoch(timestamp).toString(Qt::ISODate) + u" - " + message + u'\n').toUtf8();
+    }
 }
 
-FileLogger::FileLogger(const Path &path, const bool backup
-                       , const int maxSize, const bool deleteOld, const int age
-                       , const FileLogAgeType ageType)
-    : m_backup(backup)
-    , m_maxSize(maxSize)
+class FileLogger::Writer final : public QObject
 {
-    m_flusher.setInterval(FLUSH_INTERVAL);
-    m_flusher.setSingleShot(true);
-    connect(&m_flusher, &QTimer::timeout, this, &FileLogger::flushLog);
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(Writer)
 
-    changePath(path);
-    if (deleteOld)
-        this->deleteOld(age, ageType);
+public:
+    Writer(bool backup, int maxSize, std::atomic<qint64> &queuedSize);
+    ~Writer() override;
 
-    const Logger *const logger = Logger::instance();
-    for (const Log::Msg &msg : asConst(logger->getMessages()))
-        addLogMessage(msg);
+    void changePath(const Path &newPath);
+    void deleteOld(int age, FileLogAgeType ageType) const;
+    void setBackup(bool value);
+    void setMaxSize(int value);
+    void write(const QByteArray &data);
+    void close();
 
-    connect(logger, &Logger::newLogMessage, this, &FileLogger::addLogMessage);
-}
+private:
+    void openLogFile();
+    void rotate();
 
-FileLogger::~FileLogger()
+    Path m_path;
+    bool m_backup;
+    int m_maxSize;
+    std::atomic<qint64> &m_queuedSize;
+    QFile m_logFile;
+};
+
+FileLogger::Writer::Writer(const bool backup, const int maxSize, std::atomic<qint64> &queuedSize)
+    : m_backup {backup}
+    , m_maxSize {maxSize}
+    , m_queuedSize {queuedSize}
 {
-    closeLogFile();
 }
 
-void FileLogger::changePath(const Path &newPath)
+FileLogger::Writer::~Writer()
 {
-    // compare paths as strings to perform case sensitive comparison on all the platforms
-    if (newPath.data() == m_path.parentPath().data())
-        return;
+    close();
+}
 
-    closeLogFile();
+void FileLogger::Writer::changePath(const Path &newPath)
+{
+    close();
 
-    m_path = newPath / Path(u"qbittorrent.log"_s);
+    m_path = newPath;
     m_logFile.setFileName(m_path.data());
 
-    Utils::Fs::mkpath(newPath);
+    Utils::Fs::mkpath(m_path.parentPath());
     openLogFile();
 }
 
-void FileLogger::deleteOld(const int age, const FileLogAgeType ageType)
+void FileLogger::Writer::deleteOld(const int age, const FileLogAgeType ageType) const
 {
     const QDateTime date = QDateTime::currentDateTime();
     const QDir dir {m_path.parentPath().data()};
@@ -112,82 +150,192 @@ void FileLogger::deleteOld(const int age, const FileLogAgeType ageType)
     }
 }
 
-void FileLogger::setBackup(const bool value)
+void FileLogger::Writer::setBackup(const bool value)
 {
     m_backup = value;
 }
 
-void FileLogger::setMaxSize(const int value)
+void FileLogger::Writer::setMaxSize(const int value)
 {
     m_maxSize = value;
 }
 
-void FileLogger::addLogMessage(const Log::Msg &msg)
+void FileLogger::Writer::write(const QByteArray &data)
 {
-    if (!m_logFile.isOpen()) return;
+    if (m_logFile.isOpen())
+    {
+        m_logFile.write(data);
+        m_logFile.flush();
+    }
 
-    QTextStream stream(&m_logFile);
+    m_queuedSize -= data.size();
+
+    if (m_backup && m_logFile.isOpen() && (m_logFile.size() >= m_maxSize))
+        rotate();
+}
 
-    switch (msg.type)
+void FileLogger::Writer::close()
+{
+    m_logFile.close();
+}
+
+void FileLogger::Writer::openLogFile()
+{
+    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
     {
-    case Log::INFO:
-        stream << QStringView(u"(I) ");
-        break;
-    case Log::WARNING:
-        stream << QStringView(u"(W) ");
-        break;
-    case Log::CRITICAL:
-        stream << QStringView(u"(C) ");
-        break;
-    default:
-        stream << QStringView(u"(N) ");
+        LogMsg(tr("An error occurred while trying to open the log file. Logging to file is disabled. File: \"%1\". Error: \"%2\".")
+            .arg(m_logFile.fileName(), m_logFile.errorString()), Log::CRITICAL);
+        return;
     }
 
-    stream << QDateTime::fromSecsSinceEpoch(msg.timestamp).toString(Qt::ISODate) << QStringView(u" - ") << msg.message << QChar(u'\n');
+    // best effort, don't report error
+    m_logFile.setPermissions(QFile::ReadOwner | QFile::WriteOwner);
+}
 
-    if (m_backup && (m_logFile.size() >= m_maxSize))
-    {
-        closeLogFile();
-        int counter = 0;
-        Path backupLogFilename = m_path + u".bak";
+void FileLogger::Writer::rotate()
+{
+    close();
 
-        while (backupLogFilename.exists())
-        {
-            ++counter;
-            backupLogFilename = m_path + u".bak" + QString::number(counter);
-        }
+    const auto isBackupPathTaken = [](const Path &path)
+    {
+        return path.exists() || (path + u".gz").exists();
+    };
 
-        Utils::Fs::renameFile(m_path, backupLogFilename);
-        openLogFile();
-    }
-    else
+    int counter = 0;
+    Path backupLogFilename = m_path + u".bak";
+    while (isBackupPathTaken(backupLogFilename))
     {
-        if (!m_flusher.isActive())
-            m_flusher.start();
+        ++counter;
+        backupLogFilename = m_path + u".bak" + QString::number(counter);
     }
+
+    const bool isRenamed = Utils::Fs::renameFile(m_path, backupLogFilename);
+    openLogFile();
+
+    if (!isRenamed)
+        return;
+
+    // best effort, the backup is kept uncompressed in case of error
+    const auto readResult = Utils::IO::readFile(backupLogFilename, MAX_COMPRESSED_BACKUP_SIZE);
+    if (!readResult)
+        return;
+
+    bool ok = false;
+    const QByteArray compressedData = Utils::Gzip::compress(readResult.value(), 6, &ok);
+    if (ok && Utils::IO::saveToFile((backupLogFilename + u".gz"), compressedData))
+        Utils::Fs::removeFile(backupLogFilename);
 }
 
-void FileLogger::flushLog()
+FileLogger::FileLogger(const Path &path, const bool backup
+                       , const int maxSize, const bool deleteOld, const int age
+                       , const FileLogAgeType ageType)
+    : m_ioThread {new QThread}
+    , m_writer {new Writer(backup, maxSize, m_queuedSize)}
 {
-    if (m_logFile.isOpen())
-        m_logFile.flush();
+    m_writer->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_writer, &QObject::deleteLater);
+    m_ioThread->setObjectName("FileLogger m_ioThread");
+    m_ioThread->start();
+
+    m_flusher.setInterval(FLUSH_INTERVAL);
+    m_flusher.setSingleShot(true);
+    connect(&m_flusher, &QTimer::timeout, this, &FileLogger::flushLog);
+
+    changePath(path);
+    if (deleteOld)
+        this->deleteOld(age, ageType);
+
+    const Logger *const logger = Logger::instance();
+    for (const Log::Msg &msg : asConst(logger->getMessages()))
+        addLogMessage(msg);
+
+    connect(logger, &Logger::newLogMessage, this, &FileLogger::addLogMessage);
 }
 
-void FileLogger::openLogFile()
+FileLogger::~FileLogger()
 {
-    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Text))
+    flushLog();
+    // make sure all the queued data is written before the thread is stopped
+    QMetaObject::invokeMethod(m_writer, &Writer::close, Qt::BlockingQueuedConnection);
+}
+
+void FileLogger::changePath(const Path &newPath)
+{
+    // compare paths as strings to perform case sensitive comparison on all the platforms
+    if (newPath.data() == m_path.parentPath().data())
+        return;
+
+    // the data pending for the previous file still belongs to it
+    flushLog();
+
+    m_path = newPath / Path(u"qbittorrent.log"_s);
+    QMetaObject::invokeMethod(m_writer, [writer = m_writer, path = m_path] { writer->changePath(path); });
+}
+
+void FileLogger::deleteOld(const int age, const FileLogAgeType ageType)
+{
+    QMetaObject::invokeMethod(m_writer, [writer = m_writer, age, ageType] { writer->deleteOld(age, ageType); });
+}
+
+void FileLogger::setBackup(const bool value)
+{
+    QMetaObject::invokeMethod(m_writer, [writer = m_writer, value] { writer->setBackup(value); });
+}
+
+void FileLogger::setMaxSize(const int value)
+{
+    QMetaObject::invokeMethod(m_writer, [writer = m_writer, value] { writer->setMaxSize(value); });
+}
+
+qint64 FileLogger::droppedMessagesCount() const
+{
+    return m_droppedMessagesCount;
+}
+
+void FileLogger::addLogMessage(const Log::Msg &msg)
+{
+    const QByteArray line = formatMessage(msg.type, msg.timestamp, msg.message);
+    const auto hasSpace = [this](const qsizetype size)
     {
-        LogMsg(tr("An error occurred while trying to open the log file. Logging to file is disabled. File: \"%1\". Error: \"%2\".")
-            .arg(m_logFile.fileName(), m_logFile.errorString()), Log::CRITICAL);
+        return (m_queuedSize + m_pendingData.size() + size) <= MAX_QUEUED_SIZE;
+    };
+
+    if (m_unreportedDroppedMessagesCount > 0)
+    {
+        const QByteArray notice = formatMessage(Log::WARNING, QDateTime::currentSecsSinceEpoch()
+            , tr("%1 log messages were not written to the log file because the writing couldn't keep up.")
+                .arg(m_unreportedDroppedMessagesCount));
+        if (hasSpace(notice.size() + line.size()))
+        {
+            m_pendingData.append(notice);
+            m_unreportedDroppedMessagesCount = 0;
+        }
+    }
+
+    if ((m_unreportedDroppedMessagesCount > 0) || !hasSpace(line.size()))
+    {
+        ++m_droppedMessagesCount;
+        ++m_unreportedDroppedMessagesCount;
         return;
     }
 
-    // best effort, don't report error
-    m_logFile.setPermissions(QFile::ReadOwner | QFile::WriteOwner);
+    m_pendingData.append(line);
+
+    if (m_pendingData.size() >= BATCH_SIZE)
+        flushLog();
+    else if (!m_flusher.isActive())
+        m_flusher.start();
 }
 
-void FileLogger::closeLogFile()
+void FileLogger::flushLog()
 {
     m_flusher.stop();
-    m_logFile.close();
+    if (m_pendingData.isEmpty())
+        return;
+
+    m_queuedSize += m_pendingData.size();
+    QMetaObject::invokeMethod(m_writer, [writer = m_writer, data = m_pendingData] { writer->write(data); });
+    m_pendingData.clear();
 }
+
+#include "filelogger.moc"
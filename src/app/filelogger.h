@@ -28,17 +28,23 @@
 
 #pragma once
 
-#include <QFile>
+#include <atomic>
+
+#include <QByteArray>
 #include <QObject>
 #include <QTimer>
 
 #include "base/path.h"
+#include "base/utils/thread.h"
 
 namespace Log
 {
     struct Msg;
 }
 
+// Log messages are formatted on the calling thread and written to the file by batches
+// on the dedicated I/O thread, which also performs the rotation of the log files.
+// If the writing can't keep up, new messages are dropped until the queue has some space.
 class FileLogger : public QObject
 {
     Q_OBJECT
@@ -60,17 +66,23 @@ public:
     void setBackup(bool value);
     void setMaxSize(int value);
 
+    // Number of log messages that weren't written since the queue was full
+    qint64 droppedMessagesCount() const;
+
 private slots:
     void addLogMessage(const Log::Msg &msg);
     void flushLog();
 
 private:
-    void openLogFile();
-    void closeLogFile();
+    class Writer;
 
     Path m_path;
-    bool m_backup;
-    int m_maxSize;
-    QFile m_logFile;
+    QByteArray m_pendingData;
+    qint64 m_droppedMessagesCount = 0;
+    qint64 m_unreportedDroppedMessagesCount = 0;
+    // Size of the data passed to the writer but not written yet
+    std::atomic<qint64> m_queuedSize = 0;
     QTimer m_flusher;
+    Utils::Thread::UniquePtr m_ioThread;
+    Writer *m_writer = nullptr;
 };
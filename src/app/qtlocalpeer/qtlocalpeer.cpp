@@ -76,6 +76,7 @@
 
 #include <QByteArray>
 #include <QDataStream>
+#include <QElapsedTimer>
 #include <QFileInfo>
 #include <QLocalServer>
 #include <QLocalSocket>
@@ -91,17 +92,52 @@ namespace QtLP_Private
 #endif
 }
 
-const QByteArray ACK = QByteArrayLiteral("ack");
+namespace
+{
+    const QByteArray ACK = QByteArrayLiteral("ack");
+
+    // Message sizes are limited, so the header of a batch can't be confused with size of a single message
+    const quint32 MAX_MESSAGE_SIZE = 65535;
+    const quint32 BATCH_HEADER = 0xFFFFFFFF;
+    const qsizetype MAX_BATCH_SIZE = 10000;
+
+    // A batch is finished when no other message arrives within BATCH_DELAY
+    const int BATCH_DELAY = 500;
+    const int MAX_BATCH_DURATION = 5000;
+
+    bool waitForData(QLocalSocket *socket, const qint64 size)
+    {
+        while (socket->bytesAvailable() < size)
+        {
+            if ((socket->state() == QLocalSocket::UnconnectedState) || !socket->waitForReadyRead(2000))
+                return false;
+        }
+
+        return true;
+    }
+
+    void sleepFor(const int ms)
+    {
+#if defined(Q_OS_WIN)
+        ::Sleep(DWORD(ms));
+#else
+        struct timespec ts = { ms / 1000, (ms % 1000) * 1000 * 1000 };
+        ::nanosleep(&ts, nullptr);
+#endif
+    }
+}
 
 QtLocalPeer::QtLocalPeer(const QString &path, QObject *parent)
     : QObject(parent)
     , m_socketName(path + u"/ipc-socket")
+    , m_batchSocketName(path + u"/batch-ipc-socket")
     , m_server(new QLocalServer(this))
 {
     m_server->setSocketOptions(QLocalServer::UserAccessOption);
 
     m_lockFile.setFileName(path + u"/lockfile");
     m_lockFile.open(QIODevice::ReadWrite);
+    m_batchLockFile.setFileName(path + u"/batch-lockfile");
 }
 
 QtLocalPeer::~QtLocalPeer()
@@ -142,29 +178,96 @@ bool QtLocalPeer::sendMessage(const QString &message, const int timeout)
     if (!isClient())
         return false;
 
+    // Some other client collects the messages already
+    if (sendMessages(m_batchSocketName, {message}, timeout, false))
+        return true;
+
+    return sendMessages(m_socketName, collectMessages(message), timeout, true);
+}
+
+QStringList QtLocalPeer::collectMessages(const QString &message)
+{
+    QStringList messages {message};
+
+    if (!m_batchLockFile.open(QIODevice::ReadWrite))
+        return messages;
+    if (!m_batchLockFile.lock(QtLP_Private::QtLockedFile::WriteLock, false))
+    {
+        // it was locked right after the attempt to pass the message to its owner
+        m_batchLockFile.close();
+        return messages;
+    }
+
+    QLocalServer batchServer;
+    batchServer.setSocketOptions(QLocalServer::UserAccessOption);
+    bool res = batchServer.listen(m_batchSocketName);
+#if defined(Q_OS_UNIX)
+    // the socket is left by a crashed client, it can't be used by anyone else while the lock is held
+    if (!res && batchServer.serverError() == QAbstractSocket::AddressInUseError)
+    {
+        QFile::remove(m_batchSocketName);
+        res = batchServer.listen(m_batchSocketName);
+    }
+#endif
+
+    if (res)
+    {
+        QElapsedTimer batchTimer;
+        batchTimer.start();
+        while ((messages.size() < MAX_BATCH_SIZE) && (batchTimer.elapsed() < MAX_BATCH_DURATION))
+        {
+            if (!batchServer.hasPendingConnections() && !batchServer.waitForNewConnection(BATCH_DELAY))
+                break;
+
+            QLocalSocket *socket = batchServer.nextPendingConnection();
+            if (!socket)
+                continue;
+
+            messages += receiveMessages(socket);
+            delete socket;
+        }
+
+        // the pending connections are refused, so those clients send their messages directly
+        batchServer.close();
+    }
+
+    m_batchLockFile.unlock();
+    m_batchLockFile.close();
+    return messages;
+}
+
+bool QtLocalPeer::sendMessages(const QString &socketName, const QStringList &messages, const int timeout, const bool retry)
+{
     QLocalSocket socket;
     bool connOk = false;
     for(int i = 0; i < 2; i++)
     {
         // Try twice, in case the other instance is just starting up
-        socket.connectToServer(m_socketName);
+        socket.connectToServer(socketName);
         connOk = socket.waitForConnected(timeout/2);
-        if (connOk || i)
+        if (connOk || i || !retry)
             break;
-        int ms = 250;
-#if defined(Q_OS_WIN)
-        ::Sleep(DWORD(ms));
-#else
-        struct timespec ts = { ms / 1000, (ms % 1000) * 1000 * 1000 };
-        ::nanosleep(&ts, nullptr);
-#endif
+        sleepFor(250);
     }
     if (!connOk)
         return false;
 
-    QByteArray uMsg(message.toUtf8());
     QDataStream ds(&socket);
-    ds.writeBytes(uMsg.constData(), uMsg.size());
+    if (messages.size() == 1)
+    {
+        const QByteArray uMsg = messages.first().toUtf8();
+        ds.writeBytes(uMsg.constData(), uMsg.size());
+    }
+    else
+    {
+        ds << BATCH_HEADER << quint32(messages.size());
+        for (const QString &message : messages)
+        {
+            const QByteArray uMsg = message.toUtf8();
+            ds.writeBytes(uMsg.constData(), uMsg.size());
+        }
+    }
+
     bool res = socket.waitForBytesWritten(timeout);
     if (res)
     {
@@ -175,55 +278,76 @@ bool QtLocalPeer::sendMessage(const QString &message, const int timeout)
     return res;
 }
 
-void QtLocalPeer::receiveConnection()
+QStringList QtLocalPeer::receiveMessages(QLocalSocket *socket)
 {
-    QLocalSocket *socket = m_server->nextPendingConnection();
-    if (!socket)
-        return;
+    QDataStream ds(socket);
 
-    while (true)
+    if (!waitForData(socket, sizeof(quint32)))
     {
-        if (socket->state() == QLocalSocket::UnconnectedState)
+        qWarning("QtLocalPeer: Peer disconnected");
+        return {};
+    }
+
+    quint32 header = 0;
+    ds >> header;
+
+    quint32 count = 1;
+    if (header == BATCH_HEADER)
+    {
+        if (!waitForData(socket, sizeof(quint32)))
         {
             qWarning("QtLocalPeer: Peer disconnected");
-            delete socket;
-            return;
+            return {};
         }
-        if (socket->bytesAvailable() >= qint64(sizeof(quint32)))
-            break;
-        socket->waitForReadyRead();
+
+        ds >> count;
+        if (count > MAX_BATCH_SIZE)
+            return {};
     }
 
-    QDataStream ds(socket);
-    QByteArray uMsg;
-    quint32 remaining;
-    ds >> remaining;
-    if (remaining > 65535)
+    QStringList messages;
+    messages.reserve(count);
+    for (quint32 i = 0; i < count; ++i)
     {
+        quint32 size = header;
+        if (header == BATCH_HEADER)
+        {
+            if (!waitForData(socket, sizeof(quint32)))
+            {
+                qWarning("QtLocalPeer: Message reception failed %s", socket->errorString().toLatin1().constData());
+                return {};
+            }
+
+            ds >> size;
+        }
+
         // drop suspiciously large data
-        delete socket;
-        return;
-    }
+        if (size > MAX_MESSAGE_SIZE)
+            return {};
 
-    uMsg.resize(remaining);
-    int got = 0;
-    char* uMsgBuf = uMsg.data();
-    do
-    {
-        got = ds.readRawData(uMsgBuf, remaining);
-        remaining -= got;
-        uMsgBuf += got;
-    } while (remaining && got >= 0 && socket->waitForReadyRead(2000));
-    if (got < 0)
-    {
-        qWarning("QtLocalPeer: Message reception failed %s", socket->errorString().toLatin1().constData());
-        delete socket;
-        return;
+        if (!waitForData(socket, size))
+        {
+            qWarning("QtLocalPeer: Message reception failed %s", socket->errorString().toLatin1().constData());
+            return {};
+        }
+
+        messages.append(QString::fromUtf8(socket->read(size)));
     }
-    QString message(QString::fromUtf8(uMsg));
+
     socket->write(ACK);
     socket->waitForBytesWritten(1000);
     socket->waitForDisconnected(1000); // make sure client reads ack
+    return messages;
+}
+
+void QtLocalPeer::receiveConnection()
+{
+    QLocalSocket *socket = m_server->nextPendingConnection();
+    if (!socket)
+        return;
+
+    const QStringList messages = receiveMessages(socket);
     delete socket;
-    emit messageReceived(message); //### (might take a long time to return)
+    if (!messages.isEmpty())
+        emit messagesReceived(messages); //### (might take a long time to return)
 }
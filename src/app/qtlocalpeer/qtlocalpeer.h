@@ -69,10 +69,12 @@
 #pragma once
 
 #include <QString>
+#include <QStringList>
 
 #include "qtlockedfile.h"
 
 class QLocalServer;
+class QLocalSocket;
 
 class QtLocalPeer final : public QObject
 {
@@ -84,16 +86,24 @@ public:
     ~QtLocalPeer() override;
 
     bool isClient();
+    // The clients started at nearly the same time (e.g. when many files are opened at once)
+    // pass their messages to the first of them, which sends them all to the server at once
     bool sendMessage(const QString &message, int timeout);
 
 signals:
-    void messageReceived(const QString &message);
+    void messagesReceived(const QStringList &messages);
 
 private slots:
     void receiveConnection();
 
 private:
+    QStringList collectMessages(const QString &message);
+    static bool sendMessages(const QString &socketName, const QStringList &messages, int timeout, bool retry);
+    static QStringList receiveMessages(QLocalSocket *socket);
+
     QString m_socketName;
+    QString m_batchSocketName;
     QLocalServer *m_server = nullptr;
     QtLP_Private::QtLockedFile m_lockFile;
+    QtLP_Private::QtLockedFile m_batchLockFile;
 };
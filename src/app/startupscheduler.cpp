@@ -0,0 +1,78 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "startupscheduler.h"
+
+#include <utility>
+
+#include <QString>
+#include <QTimer>
+
+#include "base/logger.h"
+#include "base/tracer.h"
+
+StartupScheduler::StartupScheduler(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void StartupScheduler::addStage(const char *name, StageFunction function)
+{
+    m_stages.append({.name = name, .function = std::move(function)});
+}
+
+void StartupScheduler::start()
+{
+    m_nextStageIndex = 0;
+    m_elapsedTimer.start();
+    QTimer::singleShot(0, this, &StartupScheduler::runNextStage);
+}
+
+void StartupScheduler::runNextStage()
+{
+    if (m_nextStageIndex >= m_stages.size())
+    {
+        LogMsg(tr("Start-up stages completed. Elapsed time: %1 ms").arg(m_elapsedTimer.elapsed()));
+        emit finished();
+        return;
+    }
+
+    // a copy, stages can be added while it is running
+    const Stage stage = m_stages.at(m_nextStageIndex++);
+
+    QElapsedTimer stageTimer;
+    stageTimer.start();
+    {
+        const TraceSpan traceSpan {stage.name};
+        stage.function();
+    }
+    LogMsg(tr("Start-up stage \"%1\" completed. Elapsed time: %2 ms")
+            .arg(QString::fromLatin1(stage.name), QString::number(stageTimer.elapsed())));
+
+    QTimer::singleShot(0, this, &StartupScheduler::runNextStage);
+}
@@ -0,0 +1,69 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QObject>
+
+// Runs the start-up stages one by one. Every stage is run in a separate iteration
+// of the event loop, so the pending events (e.g. libtorrent alerts, UI repaints)
+// are processed in between instead of waiting for all the stages to be completed.
+class StartupScheduler final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(StartupScheduler)
+
+public:
+    using StageFunction = std::function<void ()>;
+
+    explicit StartupScheduler(QObject *parent = nullptr);
+
+    // `name` is expected to be a string literal, it is used in log and trace
+    void addStage(const char *name, StageFunction function);
+    void start();
+
+signals:
+    void finished();
+
+private:
+    struct Stage
+    {
+        const char *name = nullptr;
+        StageFunction function;
+    };
+
+    void runNextStage();
+
+    QList<Stage> m_stages;
+    qsizetype m_nextStageIndex = 0;
+    QElapsedTimer m_elapsedTimer;
+};
@@ -29,6 +29,14 @@
 
 #include "addtorrentmanager.h"
 
+#include <algorithm>
+#include <type_traits>
+
+#include <QFuture>
+#include <QPromise>
+#include <QThreadPool>
+#include <QUrl>
+
 #include "base/bittorrent/addtorrenterror.h"
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/session.h"
@@ -37,6 +45,36 @@
 #include "base/net/downloadmanager.h"
 #include "base/preferences.h"
 
+namespace
+{
+    // Number of torrent sources that are loaded in parallel and then passed to the session at once
+    const qsizetype TORRENTS_BATCH_SIZE = 64;
+
+    Path decodeTorrentFilePath(const QString &source)
+    {
+        return Path(source.startsWith(u"file://", Qt::CaseInsensitive)
+                ? QUrl::fromEncoded(source.toLocal8Bit()).toLocalFile() : source);
+    }
+
+    template <typename Func>
+    QFuture<std::invoke_result_t<Func>> runAsync(Func &&func)
+    {
+        using ResultType = std::invoke_result_t<Func>;
+
+        auto promise = std::make_shared<QPromise<ResultType>>();
+        promise->start();
+        QFuture<ResultType> future = promise->future();
+
+        QThreadPool::globalInstance()->start([promise, func = std::forward<Func>(func)]() mutable
+        {
+            promise->addResult(func());
+            promise->finish();
+        });
+
+        return future;
+    }
+}
+
 AddTorrentManager::AddTorrentManager(IApplication *app, BitTorrent::Session *btSession, QObject *parent)
     : ApplicationComponent(app, parent)
     , m_btSession {btSession}
@@ -63,7 +101,7 @@ bool AddTorrentManager::addTorrent(const QString &source, const BitTorrent::AddT
         LogMsg(tr("Downloading torrent... Source: \"%1\"").arg(source));
         const auto *pref = Preferences::instance();
         // Launch downloader
-        Net::DownloadManager::instance()->download(Net::DownloadRequest(source).limit(pref->getTorrentFileSizeLimit())
+        Net::DownloadManager::instance()->download(Net::DownloadRequest(source).limit(pref->getTorrentFileSizeLimit()).priority(Net::DownloadPriority::High)
                 , pref->useProxyForGeneralPurposes(), this, &AddTorrentManager::onDownloadFinished);
         m_downloadedTorrents[source] = params;
         return true;
@@ -79,8 +117,7 @@ bool AddTorrentManager::addTorrent(const QString &source, const BitTorrent::AddT
         return false;
     }
 
-    const Path decodedPath {source.startsWith(u"file://", Qt::CaseInsensitive)
-            ? QUrl::fromEncoded(source.toLocal8Bit()).toLocalFile() : source};
+    const Path decodedPath = decodeTorrentFilePath(source);
     auto torrentFileGuard = std::make_shared<TorrentFileGuard>(decodedPath);
     if (const auto loadResult = BitTorrent::TorrentDescriptor::loadFromFile(decodedPath))
     {
@@ -96,6 +133,24 @@ bool AddTorrentManager::addTorrent(const QString &source, const BitTorrent::AddT
     return false;
 }
 
+void AddTorrentManager::addTorrents(const QStringList &sources, const BitTorrent::AddTorrentParams &params)
+{
+    for (const QString &source : sources)
+    {
+        if (source.isEmpty())
+            continue;
+
+        // URLs are downloaded asynchronously anyway and magnet URIs are cheap to parse
+        if (Net::DownloadManager::hasSupportedScheme(source) || source.startsWith(u"magnet:", Qt::CaseInsensitive))
+            addTorrent(source, params);
+        else
+            m_pendingTorrentSources.append({.source = source, .addTorrentParams = params});
+    }
+
+    if (!m_isLoadingTorrentSources)
+        loadPendingTorrentSources();
+}
+
 bool AddTorrentManager::addTorrentToSession(const QString &source, const BitTorrent::TorrentDescriptor &torrentDescr
         , const BitTorrent::AddTorrentParams &addTorrentParams)
 {
@@ -106,6 +161,149 @@ bool AddTorrentManager::addTorrentToSession(const QString &source, const BitTorr
     return result;
 }
 
+void AddTorrentManager::loadPendingTorrentSources()
+{
+    m_isLoadingTorrentSources = !m_pendingTorrentSources.isEmpty();
+    if (!m_isLoadingTorrentSources)
+        return;
+
+    const qsizetype batchSize = std::min(TORRENTS_BATCH_SIZE, m_pendingTorrentSources.size());
+    QList<QFuture<LoadedTorrentSource>> results;
+    results.reserve(batchSize);
+    for (qsizetype i = 0; i < batchSize; ++i)
+    {
+        results.append(runAsync([pendingSource = m_pendingTorrentSources.takeFirst()]
+        {
+            LoadedTorrentSource loadedSource {.source = pendingSource.source, .addTorrentParams = pendingSource.addTorrentParams};
+            // `source` can be a bare info hash as well
+            if (const auto parseResult = BitTorrent::TorrentDescriptor::parse(loadedSource.source))
+            {
+                loadedSource.torrentDescr = parseResult.value();
+                loadedSource.infoHash = loadedSource.torrentDescr.infoHash();
+            }
+            else
+            {
+                loadedSource.filePath = decodeTorrentFilePath(loadedSource.source);
+                if (const auto peekResult = BitTorrent::TorrentDescriptor::peekFile(loadedSource.filePath))
+                    loadedSource.infoHash = peekResult.value().infoHash;
+                else
+                    loadedSource.error = peekResult.error();
+            }
+
+            return loadedSource;
+        }));
+    }
+
+    QtFuture::whenAll(results.begin(), results.end())
+        .then(this, [this](const QList<QFuture<LoadedTorrentSource>> &finishedResults)
+    {
+        // peek the next batch while the current one is being loaded and added to the session
+        loadPendingTorrentSources();
+
+        QList<LoadedTorrentSource> loadedSources;
+        loadedSources.reserve(finishedResults.size());
+        for (const QFuture<LoadedTorrentSource> &result : finishedResults)
+            loadedSources.append(result.result());
+
+        loadTorrentFiles(filterTorrentSources(loadedSources));
+    });
+}
+
+QList<AddTorrentManager::LoadedTorrentSource> AddTorrentManager::filterTorrentSources(const QList<LoadedTorrentSource> &loadedSources)
+{
+    QList<LoadedTorrentSource> torrentFiles;
+    torrentFiles.reserve(loadedSources.size());
+
+    for (const LoadedTorrentSource &loadedSource : loadedSources)
+    {
+        if (!loadedSource.error.isEmpty())
+        {
+            processLoadedTorrentSource(loadedSource);
+            continue;
+        }
+
+        // Torrents that are being added aren't known to the session until it finishes adding them,
+        // so sources with the same info hash have to be filtered out here
+        const BitTorrent::InfoHash infoHash = loadedSource.infoHash;
+        if (m_loadingInfoHashes.contains(infoHash) || m_sourcesByInfoHash.contains(infoHash))
+        {
+            const QString message = tr("The same torrent is already being added");
+            LogMsg(tr("Detected an attempt to add a duplicate torrent. Source: %1. Torrent infohash: %2. Result: %3")
+                    .arg(loadedSource.source, infoHash.toString(), message));
+            emit addTorrentFailed(loadedSource.source, {BitTorrent::AddTorrentError::DuplicateTorrent, message});
+            continue;
+        }
+
+        if (loadedSource.filePath.isEmpty())
+        {
+            processLoadedTorrentSource(loadedSource);
+            continue;
+        }
+
+        // There is no need to load the metadata of a torrent file
+        // if the existing torrent can't take anything from it
+        if (BitTorrent::Torrent *torrent = btSession()->findTorrent(infoHash); torrent && torrent->hasMetadata()
+                && (!btSession()->isMergeTrackersEnabled() || torrent->isPrivate()))
+        {
+            handleDuplicateTorrent(loadedSource.source, BitTorrent::TorrentDescriptor(), torrent);
+            continue;
+        }
+
+        m_loadingInfoHashes.insert(infoHash);
+        torrentFiles.append(loadedSource);
+    }
+
+    return torrentFiles;
+}
+
+void AddTorrentManager::loadTorrentFiles(const QList<LoadedTorrentSource> &torrentFiles)
+{
+    if (torrentFiles.isEmpty())
+        return;
+
+    QList<QFuture<LoadedTorrentSource>> results;
+    results.reserve(torrentFiles.size());
+    for (const LoadedTorrentSource &torrentFile : torrentFiles)
+    {
+        results.append(runAsync([loadedSource = torrentFile]() mutable
+        {
+            if (const auto loadResult = BitTorrent::TorrentDescriptor::loadFromFile(loadedSource.filePath))
+                loadedSource.torrentDescr = loadResult.value();
+            else
+                loadedSource.error = loadResult.error();
+
+            return loadedSource;
+        }));
+    }
+
+    QtFuture::whenAll(results.begin(), results.end())
+        .then(this, [this](const QList<QFuture<LoadedTorrentSource>> &finishedResults)
+    {
+        for (const QFuture<LoadedTorrentSource> &result : finishedResults)
+        {
+            const LoadedTorrentSource loadedSource = result.result();
+            m_loadingInfoHashes.remove(loadedSource.infoHash);
+            processLoadedTorrentSource(loadedSource);
+        }
+    });
+}
+
+void AddTorrentManager::processLoadedTorrentSource(const LoadedTorrentSource &loadedSource)
+{
+    auto torrentFileGuard = (!loadedSource.filePath.isEmpty())
+            ? std::make_shared<TorrentFileGuard>(loadedSource.filePath) : nullptr;
+
+    if (!loadedSource.error.isEmpty())
+    {
+        handleAddTorrentFailed(loadedSource.source, loadedSource.error);
+        return;
+    }
+
+    if (torrentFileGuard)
+        setTorrentFileGuard(loadedSource.source, std::move(torrentFileGuard));
+    processTorrent(loadedSource.source, loadedSource.torrentDescr, loadedSource.addTorrentParams);
+}
+
 void AddTorrentManager::onDownloadFinished(const Net::DownloadResult &result)
 {
     const QString &source = result.url;
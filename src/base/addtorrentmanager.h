@@ -32,10 +32,15 @@
 #include <memory>
 
 #include <QHash>
+#include <QList>
 #include <QObject>
+#include <QSet>
+#include <QStringList>
 
 #include "base/applicationcomponent.h"
 #include "base/bittorrent/addtorrentparams.h"
+#include "base/bittorrent/torrentdescriptor.h"
+#include "base/path.h"
 #include "base/torrentfileguard.h"
 
 namespace BitTorrent
@@ -43,7 +48,6 @@ namespace BitTorrent
     class InfoHash;
     class Session;
     class Torrent;
-    class TorrentDescriptor;
     struct AddTorrentError;
 }
 
@@ -64,6 +68,10 @@ public:
 
     BitTorrent::Session *btSession() const;
     bool addTorrent(const QString &source, const BitTorrent::AddTorrentParams &params = {});
+    // Adds many torrents at once. Local .torrent files are peeked in parallel to
+    // filter out duplicates, the rest of them are loaded in parallel and passed to
+    // the session in batches. The other sources are handled by addTorrent()
+    void addTorrents(const QStringList &sources, const BitTorrent::AddTorrentParams &params = {});
 
 signals:
     void torrentAdded(const QString &source, BitTorrent::Torrent *torrent);
@@ -78,14 +86,37 @@ protected:
     std::shared_ptr<TorrentFileGuard> releaseTorrentFileGuard(const QString &source);
 
 private:
+    struct PendingTorrentSource
+    {
+        QString source;
+        BitTorrent::AddTorrentParams addTorrentParams;
+    };
+
+    struct LoadedTorrentSource
+    {
+        QString source;
+        BitTorrent::AddTorrentParams addTorrentParams;
+        Path filePath;
+        BitTorrent::InfoHash infoHash;
+        BitTorrent::TorrentDescriptor torrentDescr;
+        QString error;
+    };
+
     void onDownloadFinished(const Net::DownloadResult &result);
     void onSessionTorrentAdded(BitTorrent::Torrent *torrent);
     void onSessionAddTorrentFailed(const BitTorrent::InfoHash &infoHash, const BitTorrent::AddTorrentError &reason);
     bool processTorrent(const QString &source, const BitTorrent::TorrentDescriptor &torrentDescr
             , const BitTorrent::AddTorrentParams &addTorrentParams);
+    void loadPendingTorrentSources();
+    QList<LoadedTorrentSource> filterTorrentSources(const QList<LoadedTorrentSource> &loadedSources);
+    void loadTorrentFiles(const QList<LoadedTorrentSource> &torrentFiles);
+    void processLoadedTorrentSource(const LoadedTorrentSource &loadedSource);
 
     BitTorrent::Session *m_btSession = nullptr;
     QHash<QString, BitTorrent::AddTorrentParams> m_downloadedTorrents;
     QHash<BitTorrent::InfoHash, QString> m_sourcesByInfoHash;
     QHash<QString, std::shared_ptr<TorrentFileGuard>> m_guardedTorrentFiles;
+    QList<PendingTorrentSource> m_pendingTorrentSources;
+    QSet<BitTorrent::InfoHash> m_loadingInfoHashes;
+    bool m_isLoadingTorrentSources = false;
 };
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <QtContainerFwd>
 #include <QCoreApplication>
 
 #include "base/pathfwd.h"
@@ -51,5 +52,9 @@ namespace BitTorrent
 
         void renameFile(const Path &oldPath, const Path &newPath);
         void renameFolder(const Path &oldFolderPath, const Path &newFolderPath);
+
+    protected:
+        // Renames the already validated files of the folder, one by one by default
+        virtual void renameFolderFiles(const QList<int> &fileIndexes, const Path &oldFolderPath, const Path &newFolderPath);
     };
 }
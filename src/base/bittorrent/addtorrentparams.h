@@ -64,6 +64,9 @@ namespace BitTorrent
         PathList filePaths; // used if TorrentInfo is set
         QList<DownloadPriority> filePriorities; // used if TorrentInfo is set
         bool skipChecking = false;
+        // All pieces are known to be valid (e.g. the torrent was just created from the content),
+        // unlike `skipChecking` they are not verified again when they are uploaded
+        bool isContentVerified = false;
         std::optional<BitTorrent::TorrentContentLayout> contentLayout;
         std::optional<bool> useAutoTMM;
         int uploadLimit = -1;
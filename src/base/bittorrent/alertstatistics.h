@@ -0,0 +1,74 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <QList>
+#include <QString>
+#include <QtTypes>
+
+namespace BitTorrent
+{
+    inline constexpr int ALERT_HISTOGRAM_SIZE = 6;
+    using AlertHistogram = std::array<qint64, ALERT_HISTOGRAM_SIZE>;
+
+    // Inclusive upper bounds of the histogram buckets, the last bucket counts all the greater values
+    inline constexpr std::array<qint64, (ALERT_HISTOGRAM_SIZE - 1)> ALERT_TIME_HISTOGRAM_BOUNDS {10, 100, 1'000, 10'000, 100'000};  // microseconds
+    inline constexpr std::array<qint64, (ALERT_HISTOGRAM_SIZE - 1)> ALERT_BATCH_SIZE_HISTOGRAM_BOUNDS {1, 10, 100, 1'000, 10'000};
+
+    struct AlertTypeStatistics
+    {
+        QString name;
+        qint64 count = 0;
+        // Handling time in microseconds
+        qint64 totalTime = 0;
+        qint64 maxTime = 0;
+        AlertHistogram timeHistogram {};
+    };
+
+    struct AlertStatistics
+    {
+        // Indexed by alert type, types that were never received have zero count
+        QList<AlertTypeStatistics> alertTypes;
+
+        qint64 alertCount = 0;
+        qint64 batchCount = 0;
+        qint64 maxBatchSize = 0;
+        AlertHistogram batchSizeHistogram {};
+
+        // Time in microseconds the main thread spent handling alert batches
+        qint64 totalStallTime = 0;
+        qint64 maxStallTime = 0;
+        AlertHistogram stallTimeHistogram {};
+
+        // Number of times libtorrent reported that alerts were dropped due to full queue
+        qint64 droppedAlertsCount = 0;
+    };
+}
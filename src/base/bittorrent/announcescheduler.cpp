@@ -0,0 +1,109 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "announcescheduler.h"
+
+#include <algorithm>
+
+#include <QUrl>
+
+using namespace BitTorrent;
+
+namespace
+{
+    const qsizetype MAX_CACHED_HOSTS = 4096;
+}
+
+AnnounceScheduler::AnnounceScheduler(const int hostBudget)
+    : m_hostBudget {std::max(1, hostBudget)}
+{
+}
+
+int AnnounceScheduler::hostBudget() const
+{
+    return m_hostBudget;
+}
+
+std::optional<int> AnnounceScheduler::schedule(const TorrentID &id, const QString &trackerURL, const qint64 now)
+{
+    prune(now);
+
+    const std::pair<TorrentID, QString> key {id, trackerURL};
+    if (m_scheduledAnnounces.contains(key))
+        return std::nullopt;
+
+    HostSlot &slot = m_hostSlots[trackerHost(trackerURL)];
+    if (slot.time < now)
+        slot = {.time = now, .count = 0};
+
+    if (slot.count >= m_hostBudget)
+    {
+        ++slot.time;
+        slot.count = 0;
+    }
+
+    ++slot.count;
+    m_scheduledAnnounces.insert(key, slot.time);
+    return static_cast<int>(slot.time - now);
+}
+
+void AnnounceScheduler::clear()
+{
+    m_hostSlots.clear();
+    m_scheduledAnnounces.clear();
+}
+
+QString AnnounceScheduler::trackerHost(const QString &trackerURL)
+{
+    if (const auto iter = m_hosts.constFind(trackerURL); iter != m_hosts.cend())
+        return iter.value();
+
+    if (m_hosts.size() >= MAX_CACHED_HOSTS)
+        m_hosts.clear();
+
+    const QString host = QUrl(trackerURL).host();
+    // Unparsable URLs are paced by themselves
+    return m_hosts.insert(trackerURL, (host.isEmpty() ? trackerURL : host)).value();
+}
+
+void AnnounceScheduler::prune(const qint64 now)
+{
+    if (now == m_pruneTime)
+        return;
+
+    m_pruneTime = now;
+    // the announces which are due are already sent so they can be scheduled again
+    m_scheduledAnnounces.removeIf([now](const QHash<std::pair<TorrentID, QString>, qint64>::iterator &iter)
+    {
+        return iter.value() < now;
+    });
+    m_hostSlots.removeIf([now](const QHash<QString, HostSlot>::iterator &iter)
+    {
+        return iter.value().time < now;
+    });
+}
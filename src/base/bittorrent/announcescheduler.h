@@ -0,0 +1,78 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <optional>
+#include <utility>
+
+#include <QtClassHelperMacros>
+#include <QHash>
+#include <QString>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    // Spreads the forced announces to the same tracker host over time, so that the host isn't sent
+    // more than the given number of announces per second when a lot of torrents announce together.
+    // The announce which is already scheduled for the torrent and the tracker isn't scheduled again.
+    class AnnounceScheduler final
+    {
+        Q_DISABLE_COPY_MOVE(AnnounceScheduler)
+
+    public:
+        static constexpr int DEFAULT_HOST_BUDGET = 20;
+
+        explicit AnnounceScheduler(int hostBudget = DEFAULT_HOST_BUDGET);
+
+        int hostBudget() const;
+
+        // Returns the delay (in seconds) after which the announce should be sent
+        // or nothing if the announce is already scheduled and should be skipped.
+        // `now` is the current time in seconds of any monotonic clock.
+        std::optional<int> schedule(const TorrentID &id, const QString &trackerURL, qint64 now);
+        void clear();
+
+    private:
+        struct HostSlot
+        {
+            qint64 time = 0;
+            int count = 0;
+        };
+
+        QString trackerHost(const QString &trackerURL);
+        void prune(qint64 now);
+
+        int m_hostBudget = 0;
+        qint64 m_pruneTime = 0;
+        QHash<QString, QString> m_hosts;
+        QHash<QString, HostSlot> m_hostSlots;
+        QHash<std::pair<TorrentID, QString>, qint64> m_scheduledAnnounces;
+    };
+}
@@ -28,7 +28,10 @@
 
 #include "bencoderesumedatastorage.h"
 
+#include <iterator>
+
 #include <libtorrent/bdecode.hpp>
+#include <libtorrent/bencode.hpp>
 #include <libtorrent/entry.hpp>
 #include <libtorrent/read_resume_data.hpp>
 #include <libtorrent/torrent_info.hpp>
@@ -46,6 +49,7 @@
 #include "base/preferences.h"
 #include "base/profile.h"
 #include "base/tagset.h"
+#include "base/tracer.h"
 #include "base/utils/fs.h"
 #include "base/utils/io.h"
 #include "base/utils/sslkey.h"
@@ -62,7 +66,7 @@ namespace BitTorrent
     public:
         explicit Worker(const Path &resumeDataDir);
 
-        void store(const TorrentID &id, const LoadTorrentParams &resumeData) const;
+        void store(const TorrentID &id, LoadTorrentParams resumeData) const;
         void remove(const TorrentID &id) const;
         void storeQueue(const QList<TorrentID> &queue) const;
 
@@ -132,6 +136,7 @@ BitTorrent::BencodeResumeDataStorage::BencodeResumeDataStorage(const Path &path,
     m_asyncWorker->moveToThread(m_ioThread.get());
     connect(m_ioThread.get(), &QThread::finished, m_asyncWorker, &QObject::deleteLater);
     m_ioThread->setObjectName("BencodeResumeDataStorage m_ioThread");
+    Utils::Thread::setWorkload(m_ioThread.get(), Utils::Thread::Workload::Bulk);
     m_ioThread->start();
 }
 
@@ -142,6 +147,8 @@ QList<BitTorrent::TorrentID> BitTorrent::BencodeResumeDataStorage::registeredTor
 
 BitTorrent::LoadResumeDataResult BitTorrent::BencodeResumeDataStorage::load(const TorrentID &id) const
 {
+    const TraceSpan traceSpan {"BencodeResumeDataStorage::load"};
+
     const QString idString = id.toString();
     const Path fastresumePath = path() / Path(idString + u".fastresume");
     const Path torrentFilePath = path() / Path(idString + u".torrent");
@@ -165,14 +172,14 @@ BitTorrent::LoadResumeDataResult BitTorrent::BencodeResumeDataStorage::load(cons
 
 void BitTorrent::BencodeResumeDataStorage::doLoadAll() const
 {
+    const TraceSpan traceSpan {"BencodeResumeDataStorage::doLoadAll"};
+
     qDebug() << "Loading torrents count: " << m_registeredTorrents.size();
 
     emit const_cast<BencodeResumeDataStorage *>(this)->loadStarted(m_registeredTorrents);
 
     for (const TorrentID &torrentID : asConst(m_registeredTorrents))
-        onResumeDataLoaded(torrentID, load(torrentID));
-
-    emit const_cast<BencodeResumeDataStorage *>(this)->loadFinished();
+        parseResumeData(torrentID, [this, torrentID] { return load(torrentID); });
 }
 
 void BitTorrent::BencodeResumeDataStorage::loadQueue(const Path &queueFilename)
@@ -220,7 +227,7 @@ void BitTorrent::BencodeResumeDataStorage::loadQueue(const Path &queueFilename)
     }
 }
 
-BitTorrent::LoadResumeDataResult BitTorrent::BencodeResumeDataStorage::loadTorrentResumeData(const QByteArray &data, const QByteArray &metadata) const
+BitTorrent::LoadResumeDataResult BitTorrent::BencodeResumeDataStorage::loadTorrentResumeData(const QByteArray &data, const QByteArray &metadata)
 {
     const auto *pref = Preferences::instance();
 
@@ -352,39 +359,10 @@ BitTorrent::LoadResumeDataResult BitTorrent::BencodeResumeDataStorage::loadTorre
     return torrentParams;
 }
 
-void BitTorrent::BencodeResumeDataStorage::store(const TorrentID &id, LoadTorrentParams resumeData) const
-{
-    QMetaObject::invokeMethod(m_asyncWorker, [this, id, resumeData = std::move(resumeData)]
-    {
-        m_asyncWorker->store(id, resumeData);
-    });
-}
-
-void BitTorrent::BencodeResumeDataStorage::remove(const TorrentID &id) const
-{
-    QMetaObject::invokeMethod(m_asyncWorker, [this, id]()
-    {
-        m_asyncWorker->remove(id);
-    });
-}
-
-void BitTorrent::BencodeResumeDataStorage::storeQueue(const QList<TorrentID> &queue) const
-{
-    QMetaObject::invokeMethod(m_asyncWorker, [this, queue]()
-    {
-        m_asyncWorker->storeQueue(queue);
-    });
-}
-
-BitTorrent::BencodeResumeDataStorage::Worker::Worker(const Path &resumeDataDir)
-    : m_resumeDataDir {resumeDataDir}
-{
-}
-
-void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, const LoadTorrentParams &resumeData) const
+nonstd::expected<BitTorrent::BencodeResumeDataStorage::BencodedResumeData, QString> BitTorrent::BencodeResumeDataStorage::bencodeResumeData(LoadTorrentParams resumeData)
 {
     // We need to adjust native libtorrent resume data
-    lt::add_torrent_params p = resumeData.ltAddTorrentParams;
+    lt::add_torrent_params &p = resumeData.ltAddTorrentParams;
     p.save_path = Profile::instance()->toPortablePath(Path(p.save_path))
             .toString().toStdString();
     if (resumeData.stopped)
@@ -409,7 +387,9 @@ void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, co
 
     lt::entry data = lt::write_resume_data(p);
 
-    // metadata is stored in separate .torrent file
+    BencodedResumeData result;
+
+    // metadata is stored separately
     if (p.ti)
     {
         lt::entry::dictionary_type &dataDict = data.dict();
@@ -420,13 +400,13 @@ void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, co
         metadataDict.insert(dataDict.extract("created by"));
         metadataDict.insert(dataDict.extract("comment"));
 
-        const Path torrentFilepath = m_resumeDataDir / Path(u"%1.torrent"_s.arg(id.toString()));
-        const nonstd::expected<void, QString> result = Utils::IO::saveToFile(torrentFilepath, metadata);
-        if (!result)
+        try
         {
-            LogMsg(tr("Couldn't save torrent metadata to '%1'. Error: %2.")
-                   .arg(torrentFilepath.toString(), result.error()), Log::CRITICAL);
-            return;
+            lt::bencode(std::back_inserter(result.metadata), metadata);
+        }
+        catch (const std::exception &err)
+        {
+            return nonstd::make_unexpected(QString::fromLocal8Bit(err.what()));
         }
     }
 
@@ -457,8 +437,74 @@ void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, co
         data["qBt-downloadPath"] = Profile::instance()->toPortablePath(resumeData.downloadPath).data().toStdString();
     }
 
+    try
+    {
+        lt::bencode(std::back_inserter(result.resumeData), data);
+    }
+    catch (const std::exception &err)
+    {
+        return nonstd::make_unexpected(QString::fromLocal8Bit(err.what()));
+    }
+
+    return result;
+}
+
+void BitTorrent::BencodeResumeDataStorage::store(const TorrentID &id, LoadTorrentParams resumeData) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, id, resumeData = std::move(resumeData)]() mutable
+    {
+        m_asyncWorker->store(id, std::move(resumeData));
+    });
+}
+
+void BitTorrent::BencodeResumeDataStorage::remove(const TorrentID &id) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, id]()
+    {
+        m_asyncWorker->remove(id);
+    });
+}
+
+void BitTorrent::BencodeResumeDataStorage::storeQueue(const QList<TorrentID> &queue) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, queue]()
+    {
+        m_asyncWorker->storeQueue(queue);
+    });
+}
+
+BitTorrent::BencodeResumeDataStorage::Worker::Worker(const Path &resumeDataDir)
+    : m_resumeDataDir {resumeDataDir}
+{
+}
+
+void BitTorrent::BencodeResumeDataStorage::Worker::store(const TorrentID &id, LoadTorrentParams resumeData) const
+{
+    const TraceSpan traceSpan {"BencodeResumeDataStorage::Worker::store"};
+
+    const auto bencodedResumeData = bencodeResumeData(std::move(resumeData));
+    if (!bencodedResumeData)
+    {
+        LogMsg(tr("Couldn't save torrent resume data. Torrent: \"%1\". Error: %2.")
+               .arg(id.toString(), bencodedResumeData.error()), Log::CRITICAL);
+        return;
+    }
+
+    // metadata is stored in separate .torrent file
+    if (const QByteArray &metadata = bencodedResumeData->metadata; !metadata.isEmpty())
+    {
+        const Path torrentFilepath = m_resumeDataDir / Path(u"%1.torrent"_s.arg(id.toString()));
+        const nonstd::expected<void, QString> result = Utils::IO::saveToFile(torrentFilepath, metadata);
+        if (!result)
+        {
+            LogMsg(tr("Couldn't save torrent metadata to '%1'. Error: %2.")
+                   .arg(torrentFilepath.toString(), result.error()), Log::CRITICAL);
+            return;
+        }
+    }
+
     const Path resumeFilepath = m_resumeDataDir / Path(u"%1.fastresume"_s.arg(id.toString()));
-    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(resumeFilepath, data);
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(resumeFilepath, bencodedResumeData->resumeData);
     if (!result)
     {
         LogMsg(tr("Couldn't save torrent resume data to '%1'. Error: %2.")
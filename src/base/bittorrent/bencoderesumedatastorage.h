@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <QByteArray>
 #include <QDir>
 #include <QList>
 
@@ -36,8 +37,6 @@
 
 #include "resumedatastorage.h"
 
-class QByteArray;
-
 namespace BitTorrent
 {
     class BencodeResumeDataStorage final : public ResumeDataStorage
@@ -54,10 +53,20 @@ namespace BitTorrent
         void remove(const TorrentID &id) const override;
         void storeQueue(const QList<TorrentID> &queue) const override;
 
+        struct BencodedResumeData
+        {
+            QByteArray resumeData;
+            QByteArray metadata;
+        };
+
+        // Conversion between LoadTorrentParams and the contents of ".fastresume" and ".torrent" files
+        // Consumes the resume data so the native parameters can be adjusted in place
+        static nonstd::expected<BencodedResumeData, QString> bencodeResumeData(LoadTorrentParams resumeData);
+        static LoadResumeDataResult loadTorrentResumeData(const QByteArray &data, const QByteArray &metadata);
+
     private:
         void doLoadAll() const override;
         void loadQueue(const Path &queueFilename);
-        LoadResumeDataResult loadTorrentResumeData(const QByteArray &data, const QByteArray &metadata) const;
 
         QList<TorrentID> m_registeredTorrents;
         Utils::Thread::UniquePtr m_ioThread;
@@ -38,6 +38,12 @@ namespace BitTorrent
         qint64 jobQueueLength = 0;
         qint64 averageJobTime = 0;
         qint64 queuedBytes = 0;
-        qreal readRatio = 0;  // TODO: remove when LIBTORRENT_VERSION_NUM >= 20000
+        qreal readRatio = 0;
+        // Read cache of CustomDiskIOThread (libtorrent 2.x only)
+        qint64 readCacheHits = 0;
+        qint64 readCacheMisses = 0;
+        qint64 readCacheSize = 0;
+        qint64 persistentReadCacheHits = 0;
+        qint64 persistentReadCacheSize = 0;
     };
 }
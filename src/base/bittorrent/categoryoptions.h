@@ -43,6 +43,12 @@ namespace BitTorrent
     {
         Path savePath;
         std::optional<DownloadPathOption> downloadPath;
+        // Limits shared by the torrents of the category (bytes per second for the rates), 0 means unlimited
+        int downloadLimit = 0;
+        int uploadLimit = 0;
+        int connectionsLimit = 0;
+
+        bool hasLimits() const;
 
         static CategoryOptions fromJSON(const QJsonObject &jsonObj);
         QJsonObject toJSON() const;
@@ -0,0 +1,189 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "checkingreadadvisor.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <QFile>
+#include <QThreadPool>
+
+#include "base/global.h"
+
+namespace
+{
+    // Checking reads the files sequentially so they are read ahead in large chunks
+    const qint64 READAHEAD_SIZE = 32 * 1024 * 1024;
+    const qsizetype MAX_OPEN_FILES = 64;
+}
+
+bool CheckingReadAdvisor::isSupported()
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+    return true;
+#else
+    return false;
+#endif
+}
+
+CheckingReadAdvisor::CheckingReadAdvisor()
+    : m_threadPool {new QThreadPool}
+{
+    // Files must be closed after the pending hints for them are given
+    m_threadPool->setMaxThreadCount(1);
+    m_threadPool->setObjectName("CheckingReadAdvisor m_threadPool");
+}
+
+CheckingReadAdvisor::~CheckingReadAdvisor()
+{
+    m_threadPool->waitForDone();
+    delete m_threadPool;
+
+    const QList<int> storages = m_openFiles.keys();
+    for (const int storage : storages)
+        closeFiles(storage);
+}
+
+void CheckingReadAdvisor::rangesChecked(const int storage, const QList<FileRange> &ranges)
+{
+    m_threadPool->start([this, storage, ranges]
+    {
+        for (const FileRange &range : ranges)
+            adviseRange(storage, range);
+    });
+}
+
+void CheckingReadAdvisor::removeStorage(const int storage)
+{
+    m_threadPool->start([this, storage]
+    {
+        closeFiles(storage);
+    });
+}
+
+void CheckingReadAdvisor::adviseRange(const int storage, const FileRange &range)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+    OpenFile *file = openFile(storage, range.filePath);
+    if (!file)
+        return;
+
+    // The hashed data isn't needed anymore. Pages which the range covers partially
+    // (i.e. shared with the neighbouring pieces) are kept by the kernel.
+    ::posix_fadvise(file->fd, range.offset, range.size, POSIX_FADV_DONTNEED);
+
+    // Pieces are hashed by several threads, so the readahead is extended
+    // in advance to keep the data ready for all of them
+    const qint64 rangeEnd = range.offset + range.size;
+    if ((file->readaheadEnd - rangeEnd) < (READAHEAD_SIZE / 2))
+    {
+        const qint64 readaheadStart = std::max(file->readaheadEnd, rangeEnd);
+        file->readaheadEnd = rangeEnd + READAHEAD_SIZE;
+        ::posix_fadvise(file->fd, readaheadStart, (file->readaheadEnd - readaheadStart), POSIX_FADV_WILLNEED);
+    }
+#else
+    Q_UNUSED(storage);
+    Q_UNUSED(range);
+#endif
+}
+
+CheckingReadAdvisor::OpenFile *CheckingReadAdvisor::openFile(const int storage, const Path &filePath)
+{
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+    QHash<Path, OpenFile> &storageFiles = m_openFiles[storage];
+    if (const auto iter = storageFiles.find(filePath); iter != storageFiles.end())
+    {
+        iter->lastUse = ++m_useCounter;
+        return &iter.value();
+    }
+
+    // Hints are given for the file regardless of which descriptor is used to read it
+    // since the page cache is shared, so the file is opened for reading only
+    const int fd = ::open(QFile::encodeName(filePath.data()).constData(), (O_RDONLY | O_CLOEXEC));
+    if (fd < 0)
+        return nullptr;
+
+    if (m_openFilesCount >= MAX_OPEN_FILES)
+        closeLeastRecentlyUsedFile();
+
+    ++m_openFilesCount;
+    return &storageFiles.insert(filePath, {.fd = fd, .readaheadEnd = 0, .lastUse = ++m_useCounter}).value();
+#else
+    Q_UNUSED(storage);
+    Q_UNUSED(filePath);
+    return nullptr;
+#endif
+}
+
+void CheckingReadAdvisor::closeLeastRecentlyUsedFile()
+{
+    QHash<Path, OpenFile> *lruStorageFiles = nullptr;
+    QHash<Path, OpenFile>::iterator lruFileIter;
+    quint64 lruLastUse = std::numeric_limits<quint64>::max();
+    for (QHash<Path, OpenFile> &storageFiles : m_openFiles)
+    {
+        for (auto it = storageFiles.begin(); it != storageFiles.end(); ++it)
+        {
+            if (it->lastUse < lruLastUse)
+            {
+                lruStorageFiles = &storageFiles;
+                lruFileIter = it;
+                lruLastUse = it->lastUse;
+            }
+        }
+    }
+
+    if (!lruStorageFiles)
+        return;
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+    ::close(lruFileIter->fd);
+#endif
+    lruStorageFiles->erase(lruFileIter);
+    --m_openFilesCount;
+}
+
+void CheckingReadAdvisor::closeFiles(const int storage)
+{
+    const auto iter = m_openFiles.find(storage);
+    if (iter == m_openFiles.end())
+        return;
+
+#if defined(Q_OS_LINUX) || defined(Q_OS_FREEBSD)
+    for (const OpenFile &file : asConst(iter.value()))
+        ::close(file.fd);
+#endif
+    m_openFilesCount -= iter->size();
+    m_openFiles.erase(iter);
+}
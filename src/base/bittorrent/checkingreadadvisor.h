@@ -0,0 +1,86 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QtTypes>
+#include <QHash>
+#include <QList>
+
+#include "base/path.h"
+
+class QThreadPool;
+
+// Gives the kernel hints about the reads done by checking of the torrents.
+// The content being checked is read ahead in large sequential chunks and dropped
+// from the page cache once it is hashed, so the check doesn't evict the data of
+// the other (e.g. seeding) torrents from the cache. The hints are given by a worker
+// thread since starting the readahead may block.
+class CheckingReadAdvisor
+{
+    Q_DISABLE_COPY_MOVE(CheckingReadAdvisor)
+
+public:
+    struct FileRange
+    {
+        Path filePath;
+        qint64 offset = 0;
+        qint64 size = 0;
+    };
+
+    static bool isSupported();
+
+    CheckingReadAdvisor();
+    ~CheckingReadAdvisor();
+
+    // The ranges have been read and hashed by the check of the storage
+    void rangesChecked(int storage, const QList<FileRange> &ranges);
+    // Closes the files opened for the storage, the storage index can be reused by another torrent
+    void removeStorage(int storage);
+
+private:
+    struct OpenFile
+    {
+        int fd = -1;
+        // The data is requested to be read ahead up to this offset
+        qint64 readaheadEnd = 0;
+        quint64 lastUse = 0;
+    };
+
+    void adviseRange(int storage, const FileRange &range);
+    OpenFile *openFile(int storage, const Path &filePath);
+    void closeLeastRecentlyUsedFile();
+    void closeFiles(int storage);
+
+    QThreadPool *m_threadPool = nullptr;
+
+    // Used by the worker thread only
+    QHash<int, QHash<Path, OpenFile>> m_openFiles;
+    qsizetype m_openFilesCount = 0;
+    quint64 m_useCounter = 0;
+};
@@ -34,43 +34,132 @@
 #include "common.h"
 
 #ifdef QBT_USES_LIBTORRENT2
+#include <algorithm>
+#include <cstring>
+
+#include <boost/asio/error.hpp>
+#include <boost/asio/post.hpp>
+#include <libtorrent/disk_observer.hpp>
 #include <libtorrent/mmap_disk_io.hpp>
 #include <libtorrent/posix_disk_io.hpp>
 #include <libtorrent/session.hpp>
 
-std::unique_ptr<lt::disk_interface> customDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+#include "base/digest32.h"
+#include "checkingreadadvisor.h"
+#include "persistentreadcache.h"
+#include "storagecopier.h"
+
+#ifdef QBT_USES_IO_URING
+#include <QCoreApplication>
+
+#include "base/logger.h"
+#include "iouringreader.h"
+#endif
+
+namespace
+{
+    // Number of files copied in parallel when the torrent is moved to another volume
+    const int FAST_MOVE_THREAD_COUNT = 4;
+
+    lt::disk_io_constructor_type wrapDiskIOConstructor(lt::disk_io_constructor_type nativeConstructor, const CustomDiskIOParams &params)
+    {
+        return [nativeConstructor = std::move(nativeConstructor), params]
+                (lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+        {
+            return std::make_unique<CustomDiskIOThread>(ioContext, nativeConstructor(ioContext, settings, counters), params);
+        };
+    }
+}
+
+lt::disk_io_constructor_type customDiskIOConstructor(const CustomDiskIOParams &params)
+{
+    return wrapDiskIOConstructor(lt::default_disk_io_constructor, params);
+}
+
+lt::disk_io_constructor_type customPosixDiskIOConstructor(const CustomDiskIOParams &params)
+{
+    return wrapDiskIOConstructor(lt::posix_disk_io_constructor, params);
+}
+
+lt::disk_io_constructor_type customMMapDiskIOConstructor(const CustomDiskIOParams &params)
 {
-    return std::make_unique<CustomDiskIOThread>(lt::default_disk_io_constructor(ioContext, settings, counters));
+    return wrapDiskIOConstructor(lt::mmap_disk_io_constructor, params);
 }
 
-std::unique_ptr<lt::disk_interface> customPosixDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+#ifdef QBT_USES_IO_URING
+lt::disk_io_constructor_type customIOUringDiskIOConstructor(const CustomDiskIOParams &params)
 {
-    return std::make_unique<CustomDiskIOThread>(lt::posix_disk_io_constructor(ioContext, settings, counters));
+    return [params](lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+    {
+        // everything but reading the blocks is done by the POSIX disk IO
+        std::unique_ptr<IOUringReader> ioUringReader = IOUringReader::create(ioContext, settings);
+        if (!ioUringReader)
+            LogMsg(QCoreApplication::translate("CustomDiskIOThread", "io_uring isn't supported by the system. Using POSIX-compliant disk IO instead."), Log::WARNING);
+
+        return std::make_unique<CustomDiskIOThread>(ioContext, lt::posix_disk_io_constructor(ioContext, settings, counters)
+                , params, std::move(ioUringReader));
+    };
 }
+#endif
+
+class CustomDiskIOThread::WriteQueueObserver final : public lt::disk_observer
+{
+public:
+    explicit WriteQueueObserver(CustomDiskIOThread *diskIOThread)
+        : m_diskIOThread {diskIOThread}
+    {
+    }
+
+    void on_disk() override
+    {
+        m_diskIOThread->handleNativeWriteQueueDrained();
+    }
 
-std::unique_ptr<lt::disk_interface> customMMapDiskIOConstructor(
-        lt::io_context &ioContext, const lt::settings_interface &settings, lt::counters &counters)
+private:
+    CustomDiskIOThread *m_diskIOThread = nullptr;
+};
+
+CustomDiskIOThread::CustomDiskIOThread(lt::io_context &ioContext, std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread
+        , const CustomDiskIOParams &params)
+    : m_ioContext {ioContext}
+    , m_nativeDiskIO {std::move(nativeDiskIOThread)}
+    , m_readCache {params.readCache}
+    , m_readCacheStorageBase {params.readCacheStorageBase}
+    , m_persistentReadCache {params.persistentReadCache}
+    , m_diskIOAccounting {params.diskIOAccounting}
+    , m_checkingReadAdvisor {CheckingReadAdvisor::isSupported() ? std::make_unique<CheckingReadAdvisor>() : nullptr}
+    , m_writeCoalescingSize {params.writeCoalescingSize}
+    , m_writeCoalescingTime {params.writeCoalescingTime}
+    , m_pendingWritesTimer {ioContext}
+    , m_writeQueueObserver {std::make_shared<WriteQueueObserver>(this)}
 {
-    return std::make_unique<CustomDiskIOThread>(lt::mmap_disk_io_constructor(ioContext, settings, counters));
 }
 
-CustomDiskIOThread::CustomDiskIOThread(std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread)
-    : m_nativeDiskIO {std::move(nativeDiskIOThread)}
+#ifdef QBT_USES_IO_URING
+CustomDiskIOThread::CustomDiskIOThread(lt::io_context &ioContext, std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread
+        , const CustomDiskIOParams &params, std::unique_ptr<IOUringReader> ioUringReader)
+    : CustomDiskIOThread(ioContext, std::move(nativeDiskIOThread), params)
 {
+    m_ioUringReader = std::move(ioUringReader);
 }
+#endif
+
+CustomDiskIOThread::~CustomDiskIOThread() = default;
 
 lt::storage_holder CustomDiskIOThread::new_torrent(const lt::storage_params &storageParams, const std::shared_ptr<void> &torrent)
 {
     lt::storage_holder storageHolder = m_nativeDiskIO->new_torrent(storageParams, torrent);
 
     const Path savePath {storageParams.path};
+    const SHA1Hash infoHash {storageParams.info_hash};
     m_storageData[storageHolder] =
     {
         savePath,
         storageParams.mapped_files ? *storageParams.mapped_files : storageParams.files,
-        storageParams.priorities
+        storageParams.priorities,
+        infoHash.toString(),
+        BitTorrent::TorrentID::fromSHA1Hash(infoHash),
+        m_diskIOAccounting->volumeOf(savePath)
     };
 
     return storageHolder;
@@ -78,6 +167,12 @@ lt::storage_holder CustomDiskIOThread::new_torrent(const lt::storage_params &sto
 
 void CustomDiskIOThread::remove_torrent(lt::storage_index_t storage)
 {
+    flushPendingWrites(storage);
+    // storage index can be reused by another torrent
+    m_readCache->removeStorage(readCacheStorage(storage));
+    closeFiles(storage);
+    if (const auto iter = m_storageData.constFind(storage); iter != m_storageData.cend())
+        m_diskIOAccounting->removeTorrent(iter->torrentID);
     m_nativeDiskIO->remove_torrent(storage);
 }
 
@@ -85,54 +180,229 @@ void CustomDiskIOThread::async_read(lt::storage_index_t storage, const lt::peer_
                                     , std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> handler
                                     , lt::disk_job_flags_t flags)
 {
-    m_nativeDiskIO->async_read(storage, peerRequest, std::move(handler), flags);
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_read(storage, peerRequest, std::move(handler), flags);
+        });
+        return;
+    }
+
+    if (hasPendingWrites(storage, peerRequest.piece))
+        flushPendingWrites(storage);
+
+    if (m_readCache->capacity() <= 0)
+    {
+        readFromDisk(storage, peerRequest, std::move(handler), flags);
+        return;
+    }
+
+    const DiskReadCache::BlockKey blockKey = toBlockKey(storage, peerRequest);
+    if (const QByteArray cachedData = m_readCache->find(blockKey); !cachedData.isNull())
+    {
+        boost::asio::post(m_ioContext, [handler = std::move(handler), bufferHolder = makeBufferHolder(cachedData)]() mutable
+        {
+            handler(std::move(bufferHolder), lt::storage_error());
+        });
+        return;
+    }
+
+    if (m_persistentReadCache)
+    {
+        const QString torrentCacheID = cacheID(storage);
+        const bool isCached = m_persistentReadCache->read({torrentCacheID, blockKey.piece, blockKey.offset, blockKey.length}
+                , [this, storage, peerRequest, flags, blockKey, torrentCacheID, handler](const QByteArray &data)
+        {
+            // it is called in the worker thread of the persistent cache
+            boost::asio::post(m_ioContext, [this, storage, peerRequest, flags, blockKey, torrentCacheID, handler, data]() mutable
+            {
+                if (data.isNull())
+                {
+                    readFromDisk(storage, peerRequest, std::move(handler), flags);
+                    return;
+                }
+
+                // Don't let the block into the memory cache if its storage has been reused meanwhile
+                if (cacheID(storage) == torrentCacheID)
+                    storeEvictedBlocks(m_readCache->offer(blockKey, data.constData()));
+                handler(makeBufferHolder(data), lt::storage_error());
+            });
+        });
+        if (isCached)
+            return;
+    }
+
+    readFromDisk(storage, peerRequest, std::move(handler), flags);
 }
 
 bool CustomDiskIOThread::async_write(lt::storage_index_t storage, const lt::peer_request &peerRequest
                                      , const char *buf, std::shared_ptr<lt::disk_observer> diskObserver
                                      , std::function<void (const lt::storage_error &)> handler, lt::disk_job_flags_t flags)
 {
-    return m_nativeDiskIO->async_write(storage, peerRequest, buf, std::move(diskObserver), std::move(handler), flags);
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, data = QByteArray(buf, peerRequest.length), handler = std::move(handler)]() mutable
+        {
+            async_write(storage, peerRequest, data.constData(), diskObserver, std::move(handler), flags);
+        });
+        // the peers don't give more blocks until the move is done
+        m_waitingDiskObservers.push_back(diskObserver);
+        return true;
+    }
+
+    m_readCache->removePiece(readCacheStorage(storage), static_cast<int>(peerRequest.piece));
+    if (m_persistentReadCache)
+        m_persistentReadCache->removePiece(cacheID(storage), static_cast<int>(peerRequest.piece));
+
+    const OperationRecord record = beginOperation(storage, BitTorrent::DiskIOOperation::Write, peerRequest.length);
+    auto completionHandler = [this, record, handler = std::move(handler)](const lt::storage_error &error)
+    {
+        if (!error)
+            endOperation(record);
+        handler(error);
+    };
+
+    if (m_writeCoalescingSize <= 0)
+        return m_nativeDiskIO->async_write(storage, peerRequest, buf, std::move(diskObserver), std::move(completionHandler), flags);
+
+    // The handler is invoked once the block is actually written by the native disk IO so libtorrent
+    // doesn't consider the block (and the piece) to be stored until then
+    const PendingWriteKey key {peerRequest.piece, peerRequest.start};
+    if (const auto iter = m_pendingWrites.constFind(storage); (iter != m_pendingWrites.cend()) && iter->contains(key))
+        flushPendingWrites(storage);
+
+    m_pendingWrites[storage].emplace(key, PendingWrite {peerRequest, QByteArray(buf, peerRequest.length), std::move(completionHandler), flags});
+    m_pendingWritesSize += peerRequest.length;
+
+    if (m_pendingWritesSize >= m_writeCoalescingSize)
+    {
+        flushPendingWrites();
+    }
+    else if (!m_isPendingWritesTimerActive)
+    {
+        m_isPendingWritesTimerActive = true;
+        m_pendingWritesTimer.expires_after(m_writeCoalescingTime);
+        m_pendingWritesTimer.async_wait([this](const boost::system::error_code &error)
+        {
+            // `this` may be already destroyed if the timer is cancelled
+            if (error)
+                return;
+
+            m_isPendingWritesTimerActive = false;
+            flushPendingWrites();
+        });
+    }
+
+    // Keep the backpressure of the native disk IO
+    if (!m_isNativeWriteQueueFull)
+        return false;
+
+    m_waitingDiskObservers.push_back(diskObserver);
+    return true;
 }
 
 void CustomDiskIOThread::async_hash(lt::storage_index_t storage, lt::piece_index_t piece
                                     , lt::span<lt::sha256_hash> hash, lt::disk_job_flags_t flags
                                     , std::function<void (lt::piece_index_t, const lt::sha1_hash &, const lt::storage_error &)> handler)
 {
-    m_nativeDiskIO->async_hash(storage, piece, hash, flags, std::move(handler));
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_hash(storage, piece, hash, flags, std::move(handler));
+        });
+        return;
+    }
+
+    if (hasPendingWrites(storage, piece))
+        flushPendingWrites(storage);
+
+    // libtorrent checks the files reading the pieces one after another just once
+    const bool isChecking = static_cast<bool>(flags & lt::disk_interface::sequential_access)
+            && static_cast<bool>(flags & lt::disk_interface::volatile_read);
+    const OperationRecord record = beginOperation(storage, BitTorrent::DiskIOOperation::Hash, m_storageData[storage].files.piece_size(piece));
+    m_nativeDiskIO->async_hash(storage, piece, hash, flags
+            , [this, storage, isChecking, record, handler = std::move(handler)](const lt::piece_index_t pieceIndex, const lt::sha1_hash &pieceHash, const lt::storage_error &error)
+    {
+        if (!error)
+        {
+            endOperation(record);
+            if (isChecking)
+                handlePieceChecked(storage, pieceIndex);
+        }
+        handler(pieceIndex, pieceHash, error);
+    });
 }
 
 void CustomDiskIOThread::async_hash2(lt::storage_index_t storage, lt::piece_index_t piece
                                      , int offset, lt::disk_job_flags_t flags
                                      , std::function<void (lt::piece_index_t, const lt::sha256_hash &, const lt::storage_error &)> handler)
 {
-    m_nativeDiskIO->async_hash2(storage, piece, offset, flags, std::move(handler));
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_hash2(storage, piece, offset, flags, std::move(handler));
+        });
+        return;
+    }
+
+    if (hasPendingWrites(storage, piece))
+        flushPendingWrites(storage);
+
+    const int blockSize = std::min(lt::default_block_size, (m_storageData[storage].files.piece_size2(piece) - offset));
+    const OperationRecord record = beginOperation(storage, BitTorrent::DiskIOOperation::Hash, blockSize);
+    m_nativeDiskIO->async_hash2(storage, piece, offset, flags
+            , [this, record, handler = std::move(handler)](const lt::piece_index_t pieceIndex, const lt::sha256_hash &blockHash, const lt::storage_error &error)
+    {
+        if (!error)
+            endOperation(record);
+        handler(pieceIndex, blockHash, error);
+    });
 }
 
 void CustomDiskIOThread::async_move_storage(lt::storage_index_t storage, std::string path, lt::move_flags_t flags
                                             , std::function<void (lt::status_t, const std::string &, const lt::storage_error &)> handler)
 {
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_move_storage(storage, path, flags, std::move(handler));
+        });
+        return;
+    }
+
     const Path newSavePath {path};
 
     if (flags == lt::move_flags_t::dont_replace)
         handleCompleteFiles(storage, newSavePath);
 
-    m_nativeDiskIO->async_move_storage(storage, path, flags
-            , [=, this, handler = std::move(handler)](lt::status_t status, const std::string &path, const lt::storage_error &error)
-    {
-#if LIBTORRENT_VERSION_NUM < 20100
-        if ((status != lt::status_t::fatal_disk_error) && (status != lt::status_t::file_exist))
-#else
-        if ((status != lt::disk_status::fatal_disk_error) && (status != lt::disk_status::file_exist))
-#endif
-            m_storageData[storage].savePath = newSavePath;
-
-        handler(status, path, error);
-    });
+    flushPendingWrites(storage);
+    closeFiles(storage);
+    // only the number and duration of moves are accounted since the data may not be copied at all
+    const OperationRecord record = beginOperation(storage, BitTorrent::DiskIOOperation::Move, 0);
+    // the files kept in place or the save path reset don't involve any copying
+    if ((flags == lt::move_flags_t::always_replace_files) || (flags == lt::move_flags_t::fail_if_exist))
+        startFastMove(storage, path, flags, record, std::move(handler));
+    else
+        moveStorage(storage, path, flags, record, std::move(handler));
 }
 
 void CustomDiskIOThread::async_release_files(lt::storage_index_t storage, std::function<void ()> handler)
 {
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_release_files(storage, std::move(handler));
+        });
+        return;
+    }
+
+    flushPendingWrites(storage);
+    closeFiles(storage);
     m_nativeDiskIO->async_release_files(storage, std::move(handler));
 }
 
@@ -140,23 +410,64 @@ void CustomDiskIOThread::async_check_files(lt::storage_index_t storage, const lt
                                            , lt::aux::vector<std::string, lt::file_index_t> links
                                            , std::function<void (lt::status_t, const lt::storage_error &)> handler)
 {
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, links = std::move(links), handler = std::move(handler)]() mutable
+        {
+            async_check_files(storage, resume_data, std::move(links), std::move(handler));
+        });
+        return;
+    }
+
+    flushPendingWrites(storage);
+    // files could be changed outside of qBittorrent
+    m_readCache->removeStorage(readCacheStorage(storage));
+    // full check (i.e. without resume data) is requested when the content is expected to be changed
+    if (m_persistentReadCache && !resume_data)
+        m_persistentReadCache->removeTorrent(cacheID(storage));
     handleCompleteFiles(storage, m_storageData[storage].savePath);
+    closeFiles(storage);
     m_nativeDiskIO->async_check_files(storage, resume_data, std::move(links), std::move(handler));
 }
 
 void CustomDiskIOThread::async_stop_torrent(lt::storage_index_t storage, std::function<void ()> handler)
 {
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_stop_torrent(storage, std::move(handler));
+        });
+        return;
+    }
+
+    flushPendingWrites(storage);
+    m_readCache->removeStorage(readCacheStorage(storage));
+    closeFiles(storage);
     m_nativeDiskIO->async_stop_torrent(storage, std::move(handler));
 }
 
 void CustomDiskIOThread::async_rename_file(lt::storage_index_t storage, lt::file_index_t index, std::string name
                                            , std::function<void (const std::string &, lt::file_index_t, const lt::storage_error &)> handler)
 {
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_rename_file(storage, index, std::move(name), std::move(handler));
+        });
+        return;
+    }
+
+    flushPendingWrites(storage);
     m_nativeDiskIO->async_rename_file(storage, index, name
             , [=, this, handler = std::move(handler)](const std::string &name, lt::file_index_t index, const lt::storage_error &error)
     {
         if (!error)
+        {
             m_storageData[storage].files.rename_file(index, name);
+            closeFiles(storage);
+        }
         handler(name, index, error);
     });
 }
@@ -164,16 +475,42 @@ void CustomDiskIOThread::async_rename_file(lt::storage_index_t storage, lt::file
 void CustomDiskIOThread::async_delete_files(lt::storage_index_t storage, lt::remove_flags_t options
                                             , std::function<void (const lt::storage_error &)> handler)
 {
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_delete_files(storage, options, std::move(handler));
+        });
+        return;
+    }
+
+    flushPendingWrites(storage);
+    m_readCache->removeStorage(readCacheStorage(storage));
+    if (m_persistentReadCache)
+        m_persistentReadCache->removeTorrent(cacheID(storage));
+    closeFiles(storage);
     m_nativeDiskIO->async_delete_files(storage, options, std::move(handler));
 }
 
 void CustomDiskIOThread::async_set_file_priority(lt::storage_index_t storage, lt::aux::vector<lt::download_priority_t, lt::file_index_t> priorities
                                                  , std::function<void (const lt::storage_error &, lt::aux::vector<lt::download_priority_t, lt::file_index_t>)> handler)
 {
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, priorities = std::move(priorities), handler = std::move(handler)]() mutable
+        {
+            async_set_file_priority(storage, std::move(priorities), std::move(handler));
+        });
+        return;
+    }
+
+    flushPendingWrites(storage);
     m_nativeDiskIO->async_set_file_priority(storage, std::move(priorities)
             , [=, this, handler = std::move(handler)](const lt::storage_error &error, const lt::aux::vector<lt::download_priority_t, lt::file_index_t> &priorities)
     {
         m_storageData[storage].filePriorities = priorities;
+        // the files could be moved between the part file and the save path
+        closeFiles(storage);
         handler(error, priorities);
     });
 }
@@ -181,6 +518,21 @@ void CustomDiskIOThread::async_set_file_priority(lt::storage_index_t storage, lt
 void CustomDiskIOThread::async_clear_piece(lt::storage_index_t storage, lt::piece_index_t index
                                            , std::function<void (lt::piece_index_t)> handler)
 {
+    if (isMovingFast(storage))
+    {
+        deferJob(storage, [=, this, handler = std::move(handler)]() mutable
+        {
+            async_clear_piece(storage, index, std::move(handler));
+        });
+        return;
+    }
+
+    if (hasPendingWrites(storage, index))
+        flushPendingWrites(storage);
+
+    m_readCache->removePiece(readCacheStorage(storage), static_cast<int>(index));
+    if (m_persistentReadCache)
+        m_persistentReadCache->removePiece(cacheID(storage), static_cast<int>(index));
     m_nativeDiskIO->async_clear_piece(storage, index, std::move(handler));
 }
 
@@ -196,11 +548,32 @@ std::vector<lt::open_file_state> CustomDiskIOThread::get_status(lt::storage_inde
 
 void CustomDiskIOThread::abort(bool wait)
 {
+    m_isAborted = true;
+    for (const std::shared_ptr<FastMoveJob> &job : asConst(m_fastMoveJobs))
+    {
+        // the copying is interrupted quickly, so it is waited for even if it isn't requested
+        job->copier->cancel();
+        if (job->thread.joinable())
+            job->thread.join();
+    }
+
+    flushPendingWrites();
+    // pending reads of the persistent cache post their completion handlers referring to this object
+    if (wait && m_persistentReadCache)
+        m_persistentReadCache->waitForDone();
+#ifdef QBT_USES_IO_URING
+    if (wait && m_ioUringReader)
+        m_ioUringReader->waitForDone();
+#endif
     m_nativeDiskIO->abort(wait);
 }
 
 void CustomDiskIOThread::submit_jobs()
 {
+#ifdef QBT_USES_IO_URING
+    if (m_ioUringReader)
+        m_ioUringReader->submit();
+#endif
     m_nativeDiskIO->submit_jobs();
 }
 
@@ -209,6 +582,351 @@ void CustomDiskIOThread::settings_updated()
     m_nativeDiskIO->settings_updated();
 }
 
+void CustomDiskIOThread::free_disk_buffer(char *buffer)
+{
+    delete[] buffer;
+}
+
+void CustomDiskIOThread::readFromDisk(lt::storage_index_t storage, const lt::peer_request &peerRequest
+        , std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> handler, lt::disk_job_flags_t flags)
+{
+    const DiskReadCache::BlockKey blockKey = toBlockKey(storage, peerRequest);
+    const bool isVolatileRead = static_cast<bool>(flags & lt::disk_interface::volatile_read);
+    const OperationRecord record = beginOperation(storage, BitTorrent::DiskIOOperation::Read, peerRequest.length);
+    auto completionHandler = [this, blockKey, isVolatileRead, record, handler = std::move(handler)](lt::disk_buffer_holder bufferHolder, const lt::storage_error &error)
+    {
+        if (!error)
+            endOperation(record);
+        if (!error && !isVolatileRead && (bufferHolder.size() == blockKey.length))
+            storeEvictedBlocks(m_readCache->offer(blockKey, bufferHolder.data()));
+        handler(std::move(bufferHolder), error);
+    };
+
+#ifdef QBT_USES_IO_URING
+    if (m_ioUringReader)
+    {
+        const StorageData &storageData = m_storageData[storage];
+        const bool isQueued = m_ioUringReader->read(storage, storageData.files, storageData.filePriorities, storageData.savePath, peerRequest
+                , [completionHandler](lt::disk_buffer_holder bufferHolder)
+        {
+            completionHandler(std::move(bufferHolder), lt::storage_error());
+        }
+                , [this, storage, peerRequest, flags, completionHandler]
+        {
+            // let the native disk IO report the error (or succeed if the failure was transient)
+            m_nativeDiskIO->async_read(storage, peerRequest, completionHandler, flags);
+        });
+        if (isQueued)
+            return;
+    }
+#endif
+
+    m_nativeDiskIO->async_read(storage, peerRequest, std::move(completionHandler), flags);
+}
+
+void CustomDiskIOThread::handlePieceChecked(const lt::storage_index_t storage, const lt::piece_index_t piece)
+{
+    const auto iter = m_storageData.constFind(storage);
+    if (iter == m_storageData.cend())
+        return;
+
+    const lt::file_storage &files = iter->files;
+    const int pieceSize = files.piece_size(piece);
+    m_diskIOAccounting->addCheckedBytes(pieceSize);
+
+    if (!m_checkingReadAdvisor)
+        return;
+
+    const std::vector<lt::file_slice> slices = files.map_block(piece, 0, pieceSize);
+    QList<CheckingReadAdvisor::FileRange> ranges;
+    ranges.reserve(static_cast<qsizetype>(slices.size()));
+    for (const lt::file_slice &slice : slices)
+    {
+        if (files.pad_file_at(slice.file_index))
+            continue;
+
+        // the data of files that have priority 0 can be stored in the part file
+        if ((iter->filePriorities.end_index() > slice.file_index) && (iter->filePriorities[slice.file_index] == lt::dont_download))
+            continue;
+
+        ranges.append({(iter->savePath / Path(files.file_path(slice.file_index))), slice.offset, slice.size});
+    }
+
+    if (!ranges.isEmpty())
+        m_checkingReadAdvisor->rangesChecked(static_cast<int>(storage), ranges);
+}
+
+void CustomDiskIOThread::storeEvictedBlocks(const QList<DiskReadCache::Block> &blocks)
+{
+    if (!m_persistentReadCache)
+        return;
+
+    for (const DiskReadCache::Block &block : blocks)
+    {
+        // The evicted blocks of the other sessions sharing the cache are unknown here
+        const int storage = block.key.storage - m_readCacheStorageBase;
+        if ((storage < 0) || (storage >= READ_CACHE_STORAGE_RANGE))
+            continue;
+
+        const QString torrentCacheID = cacheID(lt::storage_index_t(storage));
+        if (!torrentCacheID.isEmpty())
+            m_persistentReadCache->store({torrentCacheID, block.key.piece, block.key.offset, block.key.length}, block.data);
+    }
+}
+
+lt::disk_buffer_holder CustomDiskIOThread::makeBufferHolder(const QByteArray &data)
+{
+    // The buffer is owned by the holder and released with `free_disk_buffer()`
+    char *buffer = new char[data.size()];
+    std::memcpy(buffer, data.constData(), data.size());
+    return lt::disk_buffer_holder(*this, buffer, static_cast<int>(data.size()));
+}
+
+QString CustomDiskIOThread::cacheID(const lt::storage_index_t storage) const
+{
+    const auto iter = m_storageData.constFind(storage);
+    return (iter != m_storageData.cend()) ? iter->cacheID : QString();
+}
+
+int CustomDiskIOThread::readCacheStorage(const lt::storage_index_t storage) const
+{
+    return m_readCacheStorageBase + static_cast<int>(storage);
+}
+
+DiskReadCache::BlockKey CustomDiskIOThread::toBlockKey(const lt::storage_index_t storage, const lt::peer_request &peerRequest) const
+{
+    return {readCacheStorage(storage), static_cast<int>(peerRequest.piece), peerRequest.start, peerRequest.length};
+}
+
+CustomDiskIOThread::OperationRecord CustomDiskIOThread::beginOperation(const lt::storage_index_t storage
+        , const BitTorrent::DiskIOOperation operation, const qint64 size) const
+{
+    const auto iter = m_storageData.constFind(storage);
+    if (iter == m_storageData.cend())
+        return {{}, {}, operation, size, std::chrono::steady_clock::now()};
+
+    return {iter->torrentID, iter->volume, operation, size, std::chrono::steady_clock::now()};
+}
+
+void CustomDiskIOThread::endOperation(const OperationRecord &record)
+{
+    if (!record.torrentID.isValid())
+        return;
+
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - record.startTime);
+    m_diskIOAccounting->addOperation(record.torrentID, record.volume, record.operation, record.size, latency);
+}
+
+bool CustomDiskIOThread::hasPendingWrites(const lt::storage_index_t storage, const lt::piece_index_t piece) const
+{
+    const auto iter = m_pendingWrites.constFind(storage);
+    if (iter == m_pendingWrites.cend())
+        return false;
+
+    const auto pendingWriteIter = iter->lower_bound({piece, 0});
+    return (pendingWriteIter != iter->cend()) && (pendingWriteIter->first.first == piece);
+}
+
+void CustomDiskIOThread::flushPendingWrites()
+{
+    if (m_isPendingWritesTimerActive)
+    {
+        m_isPendingWritesTimerActive = false;
+        m_pendingWritesTimer.cancel();
+    }
+
+    if (m_pendingWrites.isEmpty())
+        return;
+
+    QHash<lt::storage_index_t, PendingWrites> pendingWrites = std::exchange(m_pendingWrites, {});
+    m_pendingWritesSize = 0;
+    for (auto iter = pendingWrites.begin(); iter != pendingWrites.end(); ++iter)
+        submitPendingWrites(iter.key(), iter.value());
+}
+
+void CustomDiskIOThread::flushPendingWrites(const lt::storage_index_t storage)
+{
+    const auto iter = m_pendingWrites.find(storage);
+    if (iter == m_pendingWrites.end())
+        return;
+
+    PendingWrites pendingWrites = std::move(iter.value());
+    m_pendingWrites.erase(iter);
+    for (const auto &[key, pendingWrite] : pendingWrites)
+        m_pendingWritesSize -= pendingWrite.data.size();
+
+    if (m_pendingWrites.isEmpty() && m_isPendingWritesTimerActive)
+    {
+        m_isPendingWritesTimerActive = false;
+        m_pendingWritesTimer.cancel();
+    }
+
+    submitPendingWrites(storage, pendingWrites);
+}
+
+void CustomDiskIOThread::submitPendingWrites(const lt::storage_index_t storage, PendingWrites &pendingWrites)
+{
+    for (auto &[key, pendingWrite] : pendingWrites)
+    {
+        const bool isWriteQueueFull = m_nativeDiskIO->async_write(storage, pendingWrite.peerRequest, pendingWrite.data.constData()
+                , m_writeQueueObserver, std::move(pendingWrite.handler), pendingWrite.flags);
+        if (isWriteQueueFull)
+            m_isNativeWriteQueueFull = true;
+    }
+}
+
+void CustomDiskIOThread::handleNativeWriteQueueDrained()
+{
+    m_isNativeWriteQueueFull = false;
+
+    const std::vector<std::weak_ptr<lt::disk_observer>> diskObservers = std::exchange(m_waitingDiskObservers, {});
+    for (const std::weak_ptr<lt::disk_observer> &diskObserver : diskObservers)
+    {
+        if (const std::shared_ptr<lt::disk_observer> observer = diskObserver.lock())
+            observer->on_disk();
+    }
+}
+
+void CustomDiskIOThread::moveStorage(const lt::storage_index_t storage, const std::string &path, const lt::move_flags_t flags
+        , const OperationRecord &record, MoveStorageHandler handler)
+{
+    const Path newSavePath {path};
+    m_nativeDiskIO->async_move_storage(storage, path, flags
+            , [=, this, handler = std::move(handler)](lt::status_t status, const std::string &path, const lt::storage_error &error)
+    {
+#if LIBTORRENT_VERSION_NUM < 20100
+        if ((status != lt::status_t::fatal_disk_error) && (status != lt::status_t::file_exist))
+#else
+        if ((status != lt::disk_status::fatal_disk_error) && (status != lt::disk_status::file_exist))
+#endif
+        {
+            endOperation(record);
+            StorageData &storageData = m_storageData[storage];
+            storageData.savePath = newSavePath;
+            storageData.volume = m_diskIOAccounting->volumeOf(newSavePath);
+        }
+
+        handler(status, path, error);
+    });
+}
+
+void CustomDiskIOThread::startFastMove(const lt::storage_index_t storage, const std::string &path, const lt::move_flags_t flags
+        , const OperationRecord &record, MoveStorageHandler handler)
+{
+    const StorageData &storageData = m_storageData[storage];
+    const Path newSavePath {path};
+
+    QList<StorageCopier::File> files;
+    for (const lt::file_index_t fileIndex : storageData.files.file_range())
+    {
+        // libtorrent doesn't move them either
+        if (storageData.files.pad_file_at(fileIndex) || storageData.files.file_absolute_path(fileIndex))
+            continue;
+
+        const Path filePath {storageData.files.file_path(fileIndex)};
+        files.append({(storageData.savePath / filePath), (newSavePath / filePath)});
+    }
+
+    auto job = std::make_shared<FastMoveJob>();
+    job->copier = std::make_unique<StorageCopier>(files
+            , [diskIOAccounting = m_diskIOAccounting, torrentID = storageData.torrentID](const qint64 copiedBytes)
+    {
+        diskIOAccounting->setMoveProgress(torrentID, copiedBytes);
+    });
+    // The jobs of the storage received from now on are deferred until the move is done
+    m_fastMoveJobs.insert(storage, job);
+
+    // The jobs already passed to the native disk IO (e.g. the flushed writes) could be performed
+    // on the old files after they are copied or even removed, so the copying waits for them like
+    // libtorrent's own move does. Releasing the files is a fence job, so it is finished after them.
+    m_nativeDiskIO->async_release_files(storage, [this, job, storage, path, flags, record, handler = std::move(handler)
+            , files, newSavePath, sourceVolume = storageData.volume]() mutable
+    {
+        if (m_isAborted)
+        {
+            finishFastMove(storage, path, flags, record, std::move(handler), false);
+            return;
+        }
+
+        // The job is owned by `m_fastMoveJobs` until the thread is joined in `finishFastMove()`
+        job->thread = std::thread([this, copier = job->copier.get(), storage, path, flags, record, handler = std::move(handler)
+                , files, newSavePath, sourceVolume]() mutable
+        {
+            // libtorrent just renames the files within the same volume
+            bool isCopied = false;
+            if (m_diskIOAccounting->volumeOf(newSavePath) != sourceVolume)
+            {
+                // let libtorrent report the conflict
+                const bool hasConflicts = (flags == lt::move_flags_t::fail_if_exist) && std::ranges::any_of(files
+                        , [](const StorageCopier::File &file) { return file.destination.exists(); });
+                if (!hasConflicts)
+                {
+                    // libtorrent retries with its own copying on failure so it reports the error the usual way
+                    isCopied = copier->copyFiles(FAST_MOVE_THREAD_COUNT).has_value();
+                    if (isCopied)
+                        copier->removeSourceFiles();
+                }
+            }
+
+            boost::asio::post(m_ioContext, [this, storage, path, flags, record, handler = std::move(handler), isCopied]() mutable
+            {
+                finishFastMove(storage, path, flags, record, std::move(handler), isCopied);
+            });
+        });
+    });
+}
+
+void CustomDiskIOThread::finishFastMove(const lt::storage_index_t storage, const std::string &path, const lt::move_flags_t flags
+        , const OperationRecord &record, MoveStorageHandler handler, const bool isCopied)
+{
+    if (const std::shared_ptr<FastMoveJob> job = m_fastMoveJobs.take(storage); job && job->thread.joinable())
+        job->thread.join();
+    if (record.torrentID.isValid())
+        m_diskIOAccounting->removeMoveProgress(record.torrentID);
+
+    if (m_isAborted)
+    {
+        lt::storage_error error;
+        error.ec = boost::asio::error::operation_aborted;
+#if LIBTORRENT_VERSION_NUM < 20100
+        handler(lt::status_t::fatal_disk_error, path, error);
+#else
+        handler(lt::disk_status::fatal_disk_error, path, error);
+#endif
+        return;
+    }
+
+    // The copied files are removed from the old location so libtorrent only
+    // updates the save path and moves the rest (e.g. the part file)
+    moveStorage(storage, path, (isCopied ? lt::move_flags_t::always_replace_files : flags), record, std::move(handler));
+
+    // The native disk IO performs them after the move
+    for (std::function<void ()> &deferredJob : m_deferredJobs.take(storage))
+        deferredJob();
+    if (!m_isNativeWriteQueueFull)
+        handleNativeWriteQueueDrained();
+}
+
+bool CustomDiskIOThread::isMovingFast(const lt::storage_index_t storage) const
+{
+    return m_fastMoveJobs.contains(storage);
+}
+
+void CustomDiskIOThread::deferJob(const lt::storage_index_t storage, std::function<void ()> job)
+{
+    m_deferredJobs[storage].push_back(std::move(job));
+}
+
+void CustomDiskIOThread::closeFiles(const lt::storage_index_t storage)
+{
+    if (m_checkingReadAdvisor)
+        m_checkingReadAdvisor->removeStorage(static_cast<int>(storage));
+#ifdef QBT_USES_IO_URING
+    if (m_ioUringReader)
+        m_ioUringReader->closeFiles(storage);
+#endif
+}
+
 void CustomDiskIOThread::handleCompleteFiles(lt::storage_index_t storage, const Path &savePath)
 {
     const StorageData storageData = m_storageData[storage];
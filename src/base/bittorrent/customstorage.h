@@ -36,27 +36,74 @@
 #include "base/path.h"
 
 #ifdef QBT_USES_LIBTORRENT2
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <boost/asio/steady_timer.hpp>
+#include <libtorrent/disk_buffer_holder.hpp>
 #include <libtorrent/disk_interface.hpp>
 #include <libtorrent/file_storage.hpp>
 #include <libtorrent/io_context.hpp>
 
+#include <QByteArray>
 #include <QHash>
+#include <QList>
+
+#include "diskiostatistics.h"
+#include "diskreadcache.h"
+#include "infohash.h"
+
+class CheckingReadAdvisor;
+class PersistentReadCache;
+class StorageCopier;
+
+#ifdef QBT_USES_IO_URING
+class IOUringReader;
+#endif
 #else
 #include <libtorrent/storage.hpp>
 #endif
 
 #ifdef QBT_USES_LIBTORRENT2
-std::unique_ptr<lt::disk_interface> customDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
-std::unique_ptr<lt::disk_interface> customPosixDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
-std::unique_ptr<lt::disk_interface> customMMapDiskIOConstructor(
-        lt::io_context &ioContext, lt::settings_interface const &settings, lt::counters &counters);
-
-class CustomDiskIOThread final : public lt::disk_interface
+// Number of storage keys of the read cache reserved for each disk IO sharing it
+inline constexpr int READ_CACHE_STORAGE_RANGE = 1 << 24;
+
+struct CustomDiskIOParams
+{
+    std::shared_ptr<DiskReadCache> readCache;
+    std::shared_ptr<PersistentReadCache> persistentReadCache;
+    std::shared_ptr<BitTorrent::DiskIOAccounting> diskIOAccounting;
+    // Written blocks are buffered up to the size (0 disables it) or the time
+    // and then passed to the disk IO sorted by their offsets
+    qint64 writeCoalescingSize = 0;
+    std::chrono::milliseconds writeCoalescingTime {0};
+    // First storage key of the read cache used by the disk IO, the sessions sharing
+    // the cache must use different multiples of READ_CACHE_STORAGE_RANGE
+    int readCacheStorageBase = 0;
+};
+
+lt::disk_io_constructor_type customDiskIOConstructor(const CustomDiskIOParams &params);
+lt::disk_io_constructor_type customPosixDiskIOConstructor(const CustomDiskIOParams &params);
+lt::disk_io_constructor_type customMMapDiskIOConstructor(const CustomDiskIOParams &params);
+#ifdef QBT_USES_IO_URING
+lt::disk_io_constructor_type customIOUringDiskIOConstructor(const CustomDiskIOParams &params);
+#endif
+
+class CustomDiskIOThread final : public lt::disk_interface, public lt::buffer_allocator_interface
 {
 public:
-    explicit CustomDiskIOThread(std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread);
+    CustomDiskIOThread(lt::io_context &ioContext, std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread
+            , const CustomDiskIOParams &params);
+#ifdef QBT_USES_IO_URING
+    CustomDiskIOThread(lt::io_context &ioContext, std::unique_ptr<libtorrent::disk_interface> nativeDiskIOThread
+            , const CustomDiskIOParams &params, std::unique_ptr<IOUringReader> ioUringReader);
+#endif
+    ~CustomDiskIOThread() override;
 
     lt::storage_holder new_torrent(const lt::storage_params &storageParams, const std::shared_ptr<void> &torrent) override;
     void remove_torrent(lt::storage_index_t storageIndex) override;
@@ -89,16 +136,104 @@ public:
     void submit_jobs() override;
     void settings_updated() override;
 
+    void free_disk_buffer(char *buffer) override;
+
 private:
+    class WriteQueueObserver;
+
+    using MoveStorageHandler = std::function<void (lt::status_t, const std::string &, const lt::storage_error &)>;
+
+    struct PendingWrite
+    {
+        lt::peer_request peerRequest;
+        QByteArray data;
+        std::function<void (const lt::storage_error &)> handler;
+        lt::disk_job_flags_t flags;
+    };
+
+    // Sorts the blocks in the order they are laid out in the files
+    using PendingWriteKey = std::pair<lt::piece_index_t, int>;
+    using PendingWrites = std::map<PendingWriteKey, PendingWrite>;
+
+    struct OperationRecord
+    {
+        BitTorrent::TorrentID torrentID;
+        QString volume;
+        BitTorrent::DiskIOOperation operation;
+        qint64 size = 0;
+        std::chrono::steady_clock::time_point startTime;
+    };
+
+    struct FastMoveJob
+    {
+        std::unique_ptr<StorageCopier> copier;
+        std::thread thread;
+    };
+
     void handleCompleteFiles(libtorrent::storage_index_t storage, const Path &savePath);
+    void readFromDisk(lt::storage_index_t storage, const lt::peer_request &peerRequest
+            , std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> handler, lt::disk_job_flags_t flags);
+    void storeEvictedBlocks(const QList<DiskReadCache::Block> &blocks);
+    void handlePieceChecked(lt::storage_index_t storage, lt::piece_index_t piece);
+    lt::disk_buffer_holder makeBufferHolder(const QByteArray &data);
+    QString cacheID(lt::storage_index_t storage) const;
+    int readCacheStorage(lt::storage_index_t storage) const;
+    DiskReadCache::BlockKey toBlockKey(lt::storage_index_t storage, const lt::peer_request &peerRequest) const;
+    void closeFiles(lt::storage_index_t storage);
+    OperationRecord beginOperation(lt::storage_index_t storage, BitTorrent::DiskIOOperation operation, qint64 size) const;
+    void endOperation(const OperationRecord &record);
+    bool hasPendingWrites(lt::storage_index_t storage, lt::piece_index_t piece) const;
+    void flushPendingWrites();
+    void flushPendingWrites(lt::storage_index_t storage);
+    void submitPendingWrites(lt::storage_index_t storage, PendingWrites &pendingWrites);
+    void handleNativeWriteQueueDrained();
+    void moveStorage(lt::storage_index_t storage, const std::string &path, lt::move_flags_t flags
+            , const OperationRecord &record, MoveStorageHandler handler);
+    void startFastMove(lt::storage_index_t storage, const std::string &path, lt::move_flags_t flags
+            , const OperationRecord &record, MoveStorageHandler handler);
+    void finishFastMove(lt::storage_index_t storage, const std::string &path, lt::move_flags_t flags
+            , const OperationRecord &record, MoveStorageHandler handler, bool isCopied);
+    bool isMovingFast(lt::storage_index_t storage) const;
+    void deferJob(lt::storage_index_t storage, std::function<void ()> job);
 
+    lt::io_context &m_ioContext;
     std::unique_ptr<lt::disk_interface> m_nativeDiskIO;
+    std::shared_ptr<DiskReadCache> m_readCache;
+    int m_readCacheStorageBase = 0;
+    std::shared_ptr<PersistentReadCache> m_persistentReadCache;
+    std::shared_ptr<BitTorrent::DiskIOAccounting> m_diskIOAccounting;
+    std::unique_ptr<CheckingReadAdvisor> m_checkingReadAdvisor;
+#ifdef QBT_USES_IO_URING
+    std::unique_ptr<IOUringReader> m_ioUringReader;
+#endif
+
+    const qint64 m_writeCoalescingSize;
+    const std::chrono::milliseconds m_writeCoalescingTime;
+    QHash<lt::storage_index_t, PendingWrites> m_pendingWrites;
+    qint64 m_pendingWritesSize = 0;
+    boost::asio::steady_timer m_pendingWritesTimer;
+    bool m_isPendingWritesTimerActive = false;
+    // Notifies about the native write queue is drained after it was reported to be full
+    std::shared_ptr<lt::disk_observer> m_writeQueueObserver;
+    bool m_isNativeWriteQueueFull = false;
+    // Waiting for the write queue to be drained
+    std::vector<std::weak_ptr<lt::disk_observer>> m_waitingDiskObservers;
+    // Moves to another volume copy the files in a separate thread, the other
+    // jobs of the storage are deferred until the move is done like libtorrent does
+    QHash<lt::storage_index_t, std::shared_ptr<FastMoveJob>> m_fastMoveJobs;
+    QHash<lt::storage_index_t, std::vector<std::function<void ()>>> m_deferredJobs;
+    bool m_isAborted = false;
 
     struct StorageData
     {
         Path savePath;
         lt::file_storage files;
         lt::aux::vector<lt::download_priority_t, lt::file_index_t> filePriorities;
+        // Identifies the torrent in the persistent read cache
+        QString cacheID;
+        BitTorrent::TorrentID torrentID;
+        // Storage device holding the save path
+        QString volume;
     };
     QHash<lt::storage_index_t, StorageData> m_storageData;
 };
@@ -28,8 +28,11 @@
 
 #include "dbresumedatastorage.h"
 
+#include <atomic>
 #include <memory>
+#include <optional>
 #include <queue>
+#include <unordered_map>
 #include <utility>
 
 #include <libtorrent/bdecode.hpp>
@@ -41,6 +44,7 @@
 
 #include <QByteArray>
 #include <QDebug>
+#include <QHash>
 #include <QList>
 #include <QMutex>
 #include <QSet>
@@ -49,6 +53,7 @@
 #include <QSqlQuery>
 #include <QSqlRecord>
 #include <QThread>
+#include <QVariant>
 #include <QWaitCondition>
 
 #include "base/exceptions.h"
@@ -57,17 +62,23 @@
 #include "base/path.h"
 #include "base/preferences.h"
 #include "base/profile.h"
+#include "base/tracer.h"
 #include "base/utils/fs.h"
 #include "base/utils/sslkey.h"
 #include "base/utils/string.h"
+#include "base/utils/thread.h"
+#ifdef QBT_USES_ZSTD
+#include "base/utils/zstd.h"
+#endif
 #include "infohash.h"
 #include "loadtorrentparams.h"
+#include "sparsequeuepositions.h"
 
 namespace
 {
     const QString DB_CONNECTION_NAME = u"ResumeDataStorage"_s;
 
-    const int DB_VERSION = 9;
+    const int DB_VERSION = 11;
 
     const QString DB_TABLE_META = u"meta"_s;
     const QString DB_TABLE_TORRENTS = u"torrents"_s;
@@ -76,42 +87,76 @@ namespace
 
     using namespace BitTorrent;
 
+    // Keeps prepared queries alive for the lifetime of the worker connection
+    // so that repeated jobs don't need to recompile the same statements
+    class QueryCache
+    {
+        Q_DISABLE_COPY_MOVE(QueryCache)
+
+    public:
+        explicit QueryCache(const QSqlDatabase &db);
+
+        QSqlQuery &prepared(const QString &statement);
+
+    private:
+        const QSqlDatabase m_db;
+        std::unordered_map<QString, QSqlQuery> m_queries;
+    };
+
     class Job
     {
     public:
         virtual ~Job() = default;
-        virtual void perform(QSqlDatabase db) = 0;
+        virtual void perform(QueryCache &queryCache) = 0;
     };
 
     class StoreJob final : public Job
     {
     public:
-        StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData);
-        void perform(QSqlDatabase db) override;
+        StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData, bool compress);
+        void perform(QueryCache &queryCache) override;
+
+        void setResumeData(LoadTorrentParams resumeData);
 
     private:
         const TorrentID m_torrentID;
-        const LoadTorrentParams m_resumeData;
+        LoadTorrentParams m_resumeData;
+        const bool m_compress;
     };
 
     class RemoveJob final : public Job
     {
     public:
-        explicit RemoveJob(const TorrentID &torrentID);
-        void perform(QSqlDatabase db) override;
+        RemoveJob(const TorrentID &torrentID, std::optional<SparseQueuePositions> &queuePositions);
+        void perform(QueryCache &queryCache) override;
 
     private:
         const TorrentID m_torrentID;
+        std::optional<SparseQueuePositions> &m_queuePositions;
+    };
+
+    class StoreCountersJob final : public Job
+    {
+    public:
+        StoreCountersJob(const TorrentID &torrentID, const TorrentCounters &counters);
+        void perform(QueryCache &queryCache) override;
+
+    private:
+        const TorrentID m_torrentID;
+        const TorrentCounters m_counters;
     };
 
     class StoreQueueJob final : public Job
     {
     public:
-        explicit StoreQueueJob(const QList<TorrentID> &queue);
-        void perform(QSqlDatabase db) override;
+        StoreQueueJob(const QList<TorrentID> &queue, std::optional<SparseQueuePositions> &queuePositions);
+        void perform(QueryCache &queryCache) override;
 
     private:
+        void loadQueuePositions(QueryCache &queryCache);
+
         const QList<TorrentID> m_queue;
+        std::optional<SparseQueuePositions> &m_queuePositions;
     };
 
     struct Column
@@ -149,6 +194,15 @@ namespace
     const Column DB_COLUMN_SSL_DH_PARAMS = makeColumn(u"ssl_dh_params"_s);
     const Column DB_COLUMN_RESUMEDATA = makeColumn(u"libtorrent_resume_data"_s);
     const Column DB_COLUMN_METADATA = makeColumn(u"metadata"_s);
+    const Column DB_COLUMN_RESUMEDATA_COMPRESSED = makeColumn(u"libtorrent_resume_data_compressed"_s);
+    const Column DB_COLUMN_METADATA_COMPRESSED = makeColumn(u"metadata_compressed"_s);
+    const Column DB_COLUMN_TOTAL_UPLOADED = makeColumn(u"total_uploaded"_s);
+    const Column DB_COLUMN_TOTAL_DOWNLOADED = makeColumn(u"total_downloaded"_s);
+    const Column DB_COLUMN_ACTIVE_TIME = makeColumn(u"active_time"_s);
+    const Column DB_COLUMN_FINISHED_TIME = makeColumn(u"finished_time"_s);
+    const Column DB_COLUMN_SEEDING_TIME = makeColumn(u"seeding_time"_s);
+    const Column DB_COLUMN_LAST_UPLOAD = makeColumn(u"last_upload"_s);
+    const Column DB_COLUMN_LAST_DOWNLOAD = makeColumn(u"last_download"_s);
     const Column DB_COLUMN_VALUE = makeColumn(u"value"_s);
 
     template <typename LTStr>
@@ -218,6 +272,91 @@ namespace
     {
         return u"%1 %2"_s.arg(quoted(column.name), definition);
     }
+
+    // Counters are stored in separate columns so that they can be updated
+    // without rewriting entire resume data. They take precedence over the
+    // values contained in the resume data when loading.
+    const QList<Column> DB_COUNTERS_COLUMNS {
+        DB_COLUMN_TOTAL_UPLOADED,
+        DB_COLUMN_TOTAL_DOWNLOADED,
+        DB_COLUMN_ACTIVE_TIME,
+        DB_COLUMN_FINISHED_TIME,
+        DB_COLUMN_SEEDING_TIME,
+        DB_COLUMN_LAST_UPLOAD,
+        DB_COLUMN_LAST_DOWNLOAD
+    };
+
+    void bindCounters(QSqlQuery &query, const TorrentCounters &counters)
+    {
+        query.bindValue(DB_COLUMN_TOTAL_UPLOADED.placeholder, counters.totalUploaded);
+        query.bindValue(DB_COLUMN_TOTAL_DOWNLOADED.placeholder, counters.totalDownloaded);
+        query.bindValue(DB_COLUMN_ACTIVE_TIME.placeholder, counters.activeTime);
+        query.bindValue(DB_COLUMN_FINISHED_TIME.placeholder, counters.finishedTime);
+        query.bindValue(DB_COLUMN_SEEDING_TIME.placeholder, counters.seedingTime);
+        query.bindValue(DB_COLUMN_LAST_UPLOAD.placeholder, counters.lastUpload);
+        query.bindValue(DB_COLUMN_LAST_DOWNLOAD.placeholder, counters.lastDownload);
+    }
+
+    // Codec is recorded for each stored blob, so the blobs stored with different
+    // codecs (or without compression) can coexist after the setting is changed.
+    // The values are stored in the "compressed" columns, so zlib keeps the value it had as a flag.
+    enum class BlobCodec : int
+    {
+        None = 0,
+        Zlib = 1,
+        Zstd = 2
+    };
+
+    // Piece hashes of metadata hardly compress so the fastest level is used
+    const int BLOB_COMPRESSION_LEVEL = 1;
+
+    // Returns the codec of the compressed blob, it is left as is if it doesn't get smaller
+    BlobCodec compressBlob(QByteArray &blob)
+    {
+#ifdef QBT_USES_ZSTD
+        bool ok = false;
+        QByteArray compressedBlob = Utils::Zstd::compress(blob, BLOB_COMPRESSION_LEVEL, &ok);
+        const BlobCodec codec = BlobCodec::Zstd;
+#else
+        QByteArray compressedBlob = qCompress(blob, BLOB_COMPRESSION_LEVEL);
+        const bool ok = !compressedBlob.isEmpty();
+        const BlobCodec codec = BlobCodec::Zlib;
+#endif
+        if (!ok || (compressedBlob.size() >= blob.size()))
+            return BlobCodec::None;
+
+        blob = std::move(compressedBlob);
+        return codec;
+    }
+
+    nonstd::expected<QByteArray, QString> uncompressBlob(const QByteArray &blob, const int codec)
+    {
+        switch (static_cast<BlobCodec>(codec))
+        {
+        case BlobCodec::None:
+            return blob;
+
+        case BlobCodec::Zlib:
+            if (QByteArray uncompressedBlob = qUncompress(blob); !uncompressedBlob.isEmpty())
+                return uncompressedBlob;
+            break;
+
+#ifdef QBT_USES_ZSTD
+        case BlobCodec::Zstd:
+            {
+                bool ok = false;
+                if (QByteArray uncompressedBlob = Utils::Zstd::decompress(blob, &ok); ok)
+                    return uncompressedBlob;
+            }
+            break;
+#endif
+
+        default:
+            return nonstd::make_unexpected(DBResumeDataStorage::tr("Data is compressed using unsupported method."));
+        }
+
+        return nonstd::make_unexpected(DBResumeDataStorage::tr("Couldn't decompress data."));
+    }
 }
 
 namespace BitTorrent
@@ -235,17 +374,36 @@ namespace BitTorrent
         void store(const TorrentID &id, LoadTorrentParams resumeData);
         void remove(const TorrentID &id);
         void storeQueue(const QList<TorrentID> &queue);
+        void storeCounters(const TorrentID &id, const TorrentCounters &counters);
+
+        void setBatchSize(int size);
+        void setCompressionEnabled(bool enabled);
 
     private:
-        void addJob(std::unique_ptr<Job> job);
+        struct QueuedJob
+        {
+            std::unique_ptr<Job> job;
+            TorrentID storedTorrentID;
+        };
+
+        void addJob(QueuedJob queuedJob);
 
         const QString m_connectionName = u"ResumeDataStorageWorker"_s;
         const Path m_path;
         QReadWriteLock &m_dbLock;
+        std::atomic_int m_batchSize = 0;
+        std::atomic_bool m_isCompressionEnabled = false;
 
-        std::queue<std::unique_ptr<Job>> m_jobs;
+        std::queue<QueuedJob> m_jobs;
+        // Store jobs that are still queued, so newer resume data of the same torrent
+        // can replace the data of the pending job instead of being stored twice
+        QHash<TorrentID, StoreJob *> m_pendingStoreJobs;
         QMutex m_jobsMutex;
         QWaitCondition m_waitCondition;
+
+        // Queue positions stored in the database, they are loaded when the queue is stored first time.
+        // It is accessed by the jobs only, so they are used in the worker thread only.
+        std::optional<SparseQueuePositions> m_queuePositions;
     };
 }
 
@@ -302,6 +460,8 @@ QList<BitTorrent::TorrentID> BitTorrent::DBResumeDataStorage::registeredTorrents
 
 BitTorrent::LoadResumeDataResult BitTorrent::DBResumeDataStorage::load(const TorrentID &id) const
 {
+    const TraceSpan traceSpan {"DBResumeDataStorage::load"};
+
     const QString selectTorrentStatement = u"SELECT * FROM %1 WHERE %2 = %3;"_s
         .arg(quoted(DB_TABLE_TORRENTS), quoted(DB_COLUMN_TORRENT_ID.name), DB_COLUMN_TORRENT_ID.placeholder);
 
@@ -325,7 +485,7 @@ BitTorrent::LoadResumeDataResult BitTorrent::DBResumeDataStorage::load(const Tor
             .arg(id.toString(), err.message()));
     }
 
-    return parseQueryResultRow(query);
+    return parseQueryResultRow(query.record());
 }
 
 void BitTorrent::DBResumeDataStorage::store(const TorrentID &id, LoadTorrentParams resumeData) const
@@ -343,8 +503,30 @@ void BitTorrent::DBResumeDataStorage::storeQueue(const QList<TorrentID> &queue)
     m_asyncWorker->storeQueue(queue);
 }
 
+bool BitTorrent::DBResumeDataStorage::canStoreCounters() const
+{
+    return true;
+}
+
+void BitTorrent::DBResumeDataStorage::storeCounters(const TorrentID &id, const TorrentCounters &counters) const
+{
+    m_asyncWorker->storeCounters(id, counters);
+}
+
+void BitTorrent::DBResumeDataStorage::setBatchSize(const int size)
+{
+    m_asyncWorker->setBatchSize(size);
+}
+
+void BitTorrent::DBResumeDataStorage::setCompressionEnabled(const bool enabled)
+{
+    m_asyncWorker->setCompressionEnabled(enabled);
+}
+
 void BitTorrent::DBResumeDataStorage::doLoadAll() const
 {
+    const TraceSpan traceSpan {"DBResumeDataStorage::doLoadAll"};
+
     const QString connectionName = u"ResumeDataStorageLoadAll"_s;
 
     {
@@ -377,12 +559,10 @@ void BitTorrent::DBResumeDataStorage::doLoadAll() const
         while (query.next())
         {
             const auto torrentID = TorrentID::fromString(query.value(DB_COLUMN_TORRENT_ID.name).toString());
-            onResumeDataLoaded(torrentID, parseQueryResultRow(query));
+            parseResumeData(torrentID, [this, record = query.record()] { return parseQueryResultRow(record); });
         }
     }
 
-    emit const_cast<DBResumeDataStorage *>(this)->loadFinished();
-
     QSqlDatabase::removeDatabase(connectionName);
 }
 
@@ -479,7 +659,16 @@ void BitTorrent::DBResumeDataStorage::createDB() const
             makeColumnDefinition(DB_COLUMN_SSL_PRIVATE_KEY, u"TEXT"_s),
             makeColumnDefinition(DB_COLUMN_SSL_DH_PARAMS, u"TEXT"_s),
             makeColumnDefinition(DB_COLUMN_RESUMEDATA, u"BLOB NOT NULL"_s),
-            makeColumnDefinition(DB_COLUMN_METADATA, u"BLOB"_s)
+            makeColumnDefinition(DB_COLUMN_RESUMEDATA_COMPRESSED, u"INTEGER NOT NULL DEFAULT 0"_s),
+            makeColumnDefinition(DB_COLUMN_METADATA, u"BLOB"_s),
+            makeColumnDefinition(DB_COLUMN_METADATA_COMPRESSED, u"INTEGER NOT NULL DEFAULT 0"_s),
+            makeColumnDefinition(DB_COLUMN_TOTAL_UPLOADED, u"INTEGER"_s),
+            makeColumnDefinition(DB_COLUMN_TOTAL_DOWNLOADED, u"INTEGER"_s),
+            makeColumnDefinition(DB_COLUMN_ACTIVE_TIME, u"INTEGER"_s),
+            makeColumnDefinition(DB_COLUMN_FINISHED_TIME, u"INTEGER"_s),
+            makeColumnDefinition(DB_COLUMN_SEEDING_TIME, u"INTEGER"_s),
+            makeColumnDefinition(DB_COLUMN_LAST_UPLOAD, u"INTEGER"_s),
+            makeColumnDefinition(DB_COLUMN_LAST_DOWNLOAD, u"INTEGER"_s)
         };
         const QString createTableTorrentsQuery = makeCreateTableStatement(DB_TABLE_TORRENTS, tableTorrentsItems);
         if (!query.exec(createTableTorrentsQuery))
@@ -583,6 +772,18 @@ void BitTorrent::DBResumeDataStorage::updateDB(const int fromVersion) const
         if (fromVersion <= 8)
             addColumn(DB_TABLE_TORRENTS, DB_COLUMN_COMMENT, u"TEXT"_s);
 
+        if (fromVersion <= 9)
+        {
+            for (const Column &column : DB_COUNTERS_COLUMNS)
+                addColumn(DB_TABLE_TORRENTS, column, u"INTEGER"_s);
+        }
+
+        if (fromVersion <= 10)
+        {
+            addColumn(DB_TABLE_TORRENTS, DB_COLUMN_RESUMEDATA_COMPRESSED, u"INTEGER NOT NULL DEFAULT 0"_s);
+            addColumn(DB_TABLE_TORRENTS, DB_COLUMN_METADATA_COMPRESSED, u"INTEGER NOT NULL DEFAULT 0"_s);
+        }
+
         const QString updateMetaVersionQuery = makeUpdateStatement(DB_TABLE_META, {DB_COLUMN_NAME, DB_COLUMN_VALUE});
         if (!query.prepare(updateMetaVersionQuery))
             throw RuntimeError(query.lastError().text());
@@ -619,55 +820,59 @@ void BitTorrent::DBResumeDataStorage::enableWALMode() const
         throw RuntimeError(tr("WAL mode is probably unsupported due to filesystem limitations."));
 }
 
-LoadResumeDataResult DBResumeDataStorage::parseQueryResultRow(const QSqlQuery &query) const
+LoadResumeDataResult DBResumeDataStorage::parseQueryResultRow(const QSqlRecord &record) const
 {
     LoadTorrentParams resumeData;
-    resumeData.name = query.value(DB_COLUMN_NAME.name).toString();
-    resumeData.category = query.value(DB_COLUMN_CATEGORY.name).toString();
-    resumeData.comment = query.value(DB_COLUMN_COMMENT.name).toString();
-    const QString tagsData = query.value(DB_COLUMN_TAGS.name).toString();
+    resumeData.name = record.value(DB_COLUMN_NAME.name).toString();
+    resumeData.category = record.value(DB_COLUMN_CATEGORY.name).toString();
+    resumeData.comment = record.value(DB_COLUMN_COMMENT.name).toString();
+    const QString tagsData = record.value(DB_COLUMN_TAGS.name).toString();
     if (!tagsData.isEmpty())
     {
         const QStringList tagList = tagsData.split(u',');
         resumeData.tags.insert(tagList.cbegin(), tagList.cend());
     }
-    resumeData.hasFinishedStatus = query.value(DB_COLUMN_HAS_SEED_STATUS.name).toBool();
-    resumeData.firstLastPiecePriority = query.value(DB_COLUMN_HAS_OUTER_PIECES_PRIORITY.name).toBool();
-    resumeData.ratioLimit = query.value(DB_COLUMN_RATIO_LIMIT.name).toInt() / 1000.0;
-    resumeData.seedingTimeLimit = query.value(DB_COLUMN_SEEDING_TIME_LIMIT.name).toInt();
-    resumeData.inactiveSeedingTimeLimit = query.value(DB_COLUMN_INACTIVE_SEEDING_TIME_LIMIT.name).toInt();
+    resumeData.hasFinishedStatus = record.value(DB_COLUMN_HAS_SEED_STATUS.name).toBool();
+    resumeData.firstLastPiecePriority = record.value(DB_COLUMN_HAS_OUTER_PIECES_PRIORITY.name).toBool();
+    resumeData.ratioLimit = record.value(DB_COLUMN_RATIO_LIMIT.name).toInt() / 1000.0;
+    resumeData.seedingTimeLimit = record.value(DB_COLUMN_SEEDING_TIME_LIMIT.name).toInt();
+    resumeData.inactiveSeedingTimeLimit = record.value(DB_COLUMN_INACTIVE_SEEDING_TIME_LIMIT.name).toInt();
     resumeData.shareLimitAction = Utils::String::toEnum<ShareLimitAction>(
-        query.value(DB_COLUMN_SHARE_LIMIT_ACTION.name).toString(), ShareLimitAction::Default);
+        record.value(DB_COLUMN_SHARE_LIMIT_ACTION.name).toString(), ShareLimitAction::Default);
     resumeData.contentLayout = Utils::String::toEnum<TorrentContentLayout>(
-        query.value(DB_COLUMN_CONTENT_LAYOUT.name).toString(), TorrentContentLayout::Original);
+        record.value(DB_COLUMN_CONTENT_LAYOUT.name).toString(), TorrentContentLayout::Original);
     resumeData.operatingMode = Utils::String::toEnum<TorrentOperatingMode>(
-        query.value(DB_COLUMN_OPERATING_MODE.name).toString(), TorrentOperatingMode::AutoManaged);
-    resumeData.stopped = query.value(DB_COLUMN_STOPPED.name).toBool();
+        record.value(DB_COLUMN_OPERATING_MODE.name).toString(), TorrentOperatingMode::AutoManaged);
+    resumeData.stopped = record.value(DB_COLUMN_STOPPED.name).toBool();
     resumeData.stopCondition = Utils::String::toEnum(
-        query.value(DB_COLUMN_STOP_CONDITION.name).toString(), Torrent::StopCondition::None);
+        record.value(DB_COLUMN_STOP_CONDITION.name).toString(), Torrent::StopCondition::None);
     resumeData.sslParameters =
         {
-            .certificate = QSslCertificate(query.value(DB_COLUMN_SSL_CERTIFICATE.name).toByteArray()),
-            .privateKey = Utils::SSLKey::load(query.value(DB_COLUMN_SSL_PRIVATE_KEY.name).toByteArray()),
-            .dhParams = query.value(DB_COLUMN_SSL_DH_PARAMS.name).toByteArray()
+            .certificate = QSslCertificate(record.value(DB_COLUMN_SSL_CERTIFICATE.name).toByteArray()),
+            .privateKey = Utils::SSLKey::load(record.value(DB_COLUMN_SSL_PRIVATE_KEY.name).toByteArray()),
+            .dhParams = record.value(DB_COLUMN_SSL_DH_PARAMS.name).toByteArray()
         };
 
     resumeData.savePath = Profile::instance()->fromPortablePath(
-        Path(query.value(DB_COLUMN_TARGET_SAVE_PATH.name).toString()));
+        Path(record.value(DB_COLUMN_TARGET_SAVE_PATH.name).toString()));
     resumeData.useAutoTMM = resumeData.savePath.isEmpty();
     if (!resumeData.useAutoTMM)
     {
         resumeData.downloadPath = Profile::instance()->fromPortablePath(
-            Path(query.value(DB_COLUMN_DOWNLOAD_PATH.name).toString()));
+            Path(record.value(DB_COLUMN_DOWNLOAD_PATH.name).toString()));
     }
 
-    const QByteArray bencodedResumeData = query.value(DB_COLUMN_RESUMEDATA.name).toByteArray();
+    const auto bencodedResumeData = uncompressBlob(record.value(DB_COLUMN_RESUMEDATA.name).toByteArray()
+            , record.value(DB_COLUMN_RESUMEDATA_COMPRESSED.name).toInt());
+    if (!bencodedResumeData)
+        return nonstd::make_unexpected(tr("Cannot parse resume data: %1").arg(bencodedResumeData.error()));
+
     const auto *pref = Preferences::instance();
     const int bdecodeDepthLimit = pref->getBdecodeDepthLimit();
     const int bdecodeTokenLimit = pref->getBdecodeTokenLimit();
 
     lt::error_code ec;
-    const lt::bdecode_node resumeDataRoot = lt::bdecode(bencodedResumeData, ec, nullptr, bdecodeDepthLimit, bdecodeTokenLimit);
+    const lt::bdecode_node resumeDataRoot = lt::bdecode(bencodedResumeData.value(), ec, nullptr, bdecodeDepthLimit, bdecodeTokenLimit);
     if (ec)
         return nonstd::make_unexpected(tr("Cannot parse resume data: %1").arg(QString::fromStdString(ec.message())));
 
@@ -677,10 +882,15 @@ LoadResumeDataResult DBResumeDataStorage::parseQueryResultRow(const QSqlQuery &q
     if (ec)
         return nonstd::make_unexpected(tr("Cannot parse resume data: %1").arg(QString::fromStdString(ec.message())));
 
-    if (const QByteArray bencodedMetadata = query.value(DB_COLUMN_METADATA.name).toByteArray()
-            ; !bencodedMetadata.isEmpty())
+    if (const QByteArray storedMetadata = record.value(DB_COLUMN_METADATA.name).toByteArray()
+            ; !storedMetadata.isEmpty())
     {
-        const lt::bdecode_node torentInfoRoot = lt::bdecode(bencodedMetadata, ec
+        const auto bencodedMetadata = uncompressBlob(storedMetadata
+                , record.value(DB_COLUMN_METADATA_COMPRESSED.name).toInt());
+        if (!bencodedMetadata)
+            return nonstd::make_unexpected(tr("Cannot parse torrent info: %1").arg(bencodedMetadata.error()));
+
+        const lt::bdecode_node torentInfoRoot = lt::bdecode(bencodedMetadata.value(), ec
                 , nullptr, bdecodeDepthLimit, bdecodeTokenLimit);
         if (ec)
             return nonstd::make_unexpected(tr("Cannot parse torrent info: %1").arg(QString::fromStdString(ec.message())));
@@ -690,6 +900,18 @@ LoadResumeDataResult DBResumeDataStorage::parseQueryResultRow(const QSqlQuery &q
             return nonstd::make_unexpected(tr("Cannot parse torrent info: %1").arg(QString::fromStdString(ec.message())));
     }
 
+    // Counters could be updated after the resume data was stored
+    if (const QVariant totalUploaded = record.value(DB_COLUMN_TOTAL_UPLOADED.name); !totalUploaded.isNull())
+    {
+        p.total_uploaded = totalUploaded.toLongLong();
+        p.total_downloaded = record.value(DB_COLUMN_TOTAL_DOWNLOADED.name).toLongLong();
+        p.active_time = record.value(DB_COLUMN_ACTIVE_TIME.name).toInt();
+        p.finished_time = record.value(DB_COLUMN_FINISHED_TIME.name).toInt();
+        p.seeding_time = record.value(DB_COLUMN_SEEDING_TIME.name).toInt();
+        p.last_upload = record.value(DB_COLUMN_LAST_UPLOAD.name).toLongLong();
+        p.last_download = record.value(DB_COLUMN_LAST_DOWNLOAD.name).toLongLong();
+    }
+
     p.save_path = Profile::instance()->fromPortablePath(Path(fromLTString(p.save_path)))
             .toString().toStdString();
     if (p.save_path.empty())
@@ -713,54 +935,81 @@ BitTorrent::DBResumeDataStorage::Worker::Worker(const Path &dbPath, QReadWriteLo
 
 void BitTorrent::DBResumeDataStorage::Worker::run()
 {
+    Utils::Thread::applyWorkload(Utils::Thread::Workload::Bulk);
+
     {
         auto db = QSqlDatabase::addDatabase(u"QSQLITE"_s, m_connectionName);
         db.setDatabaseName(m_path.data());
         if (!db.open())
             throw RuntimeError(db.lastError().text());
 
-        int64_t transactedJobsCount = 0;
-        while (true)
         {
-            m_jobsMutex.lock();
-            if (m_jobs.empty())
+            QueryCache queryCache {db};
+
+            int transactedJobsCount = 0;
+            const auto commit = [this, &db, &transactedJobsCount]
             {
-                if (transactedJobsCount > 0)
-                {
-                    db.commit();
-                    m_dbLock.unlock();
+                const TraceSpan traceSpan {"DBResumeDataStorage::Worker::commit"};
 
-                    qDebug() << "Resume data changes are committed. Transacted jobs:" << transactedJobsCount;
-                    transactedJobsCount = 0;
-                }
+                db.commit();
+                m_dbLock.unlock();
+
+                qDebug() << "Resume data changes are committed. Transacted jobs:" << transactedJobsCount;
+                transactedJobsCount = 0;
+            };
 
-                if (isInterruptionRequested())
+            while (true)
+            {
+                m_jobsMutex.lock();
+                if (m_jobs.empty())
                 {
-                    m_jobsMutex.unlock();
-                    break;
+                    if (transactedJobsCount > 0)
+                    {
+                        // Don't keep producers waiting while the transaction is being committed
+                        m_jobsMutex.unlock();
+                        commit();
+                        m_jobsMutex.lock();
+                    }
+
+                    while (m_jobs.empty() && !isInterruptionRequested())
+                        m_waitCondition.wait(&m_jobsMutex);
+
+                    // Remaining jobs are performed before exiting
+                    if (m_jobs.empty())
+                    {
+                        m_jobsMutex.unlock();
+                        break;
+                    }
                 }
+                QueuedJob queuedJob = std::move(m_jobs.front());
+                m_jobs.pop();
+                if (queuedJob.storedTorrentID.isValid())
+                    m_pendingStoreJobs.remove(queuedJob.storedTorrentID);
+                m_jobsMutex.unlock();
 
-                m_waitCondition.wait(&m_jobsMutex);
-                if (isInterruptionRequested())
+                if (transactedJobsCount == 0)
                 {
-                    m_jobsMutex.unlock();
-                    break;
+                    m_dbLock.lockForWrite();
+                    if (!db.transaction())
+                    {
+                        LogMsg(tr("Couldn't begin transaction. Error: %1").arg(db.lastError().text()), Log::WARNING);
+                        m_dbLock.unlock();
+                        break;
+                    }
                 }
 
-                m_dbLock.lockForWrite();
-                if (!db.transaction())
                 {
-                    LogMsg(tr("Couldn't begin transaction. Error: %1").arg(db.lastError().text()), Log::WARNING);
-                    m_dbLock.unlock();
-                    break;
+                    const TraceSpan traceSpan {"DBResumeDataStorage::Worker::performJob"};
+                    queuedJob.job->perform(queryCache);
                 }
-            }
-            std::unique_ptr<Job> job = std::move(m_jobs.front());
-            m_jobs.pop();
-            m_jobsMutex.unlock();
+                ++transactedJobsCount;
 
-            job->perform(db);
-            ++transactedJobsCount;
+                // Commit large amounts of changes in several transactions
+                // so that the database isn't kept locked for too long
+                const int batchSize = m_batchSize.load(std::memory_order_relaxed);
+                if ((batchSize > 0) && (transactedJobsCount >= batchSize))
+                    commit();
+            }
         }
 
         db.close();
@@ -777,23 +1026,54 @@ void DBResumeDataStorage::Worker::requestInterruption()
 
 void BitTorrent::DBResumeDataStorage::Worker::store(const TorrentID &id, LoadTorrentParams resumeData)
 {
-    addJob(std::make_unique<StoreJob>(id, std::move(resumeData)));
+    const QMutexLocker locker {&m_jobsMutex};
+    if (StoreJob *pendingJob = m_pendingStoreJobs.value(id))
+    {
+        pendingJob->setResumeData(std::move(resumeData));
+        return;
+    }
+
+    auto job = std::make_unique<StoreJob>(id, std::move(resumeData), m_isCompressionEnabled.load(std::memory_order_relaxed));
+    m_pendingStoreJobs.insert(id, job.get());
+    m_jobs.push({.job = std::move(job), .storedTorrentID = id});
+    m_waitCondition.wakeAll();
 }
 
 void BitTorrent::DBResumeDataStorage::Worker::remove(const TorrentID &id)
 {
-    addJob(std::make_unique<RemoveJob>(id));
+    {
+        // Any resume data queued before removal must not be (re)stored after it
+        const QMutexLocker locker {&m_jobsMutex};
+        m_pendingStoreJobs.remove(id);
+    }
+
+    addJob({.job = std::make_unique<RemoveJob>(id, m_queuePositions)});
 }
 
 void BitTorrent::DBResumeDataStorage::Worker::storeQueue(const QList<TorrentID> &queue)
 {
-    addJob(std::make_unique<StoreQueueJob>(queue));
+    addJob({.job = std::make_unique<StoreQueueJob>(queue, m_queuePositions)});
+}
+
+void BitTorrent::DBResumeDataStorage::Worker::storeCounters(const TorrentID &id, const TorrentCounters &counters)
+{
+    addJob({.job = std::make_unique<StoreCountersJob>(id, counters)});
+}
+
+void BitTorrent::DBResumeDataStorage::Worker::setBatchSize(const int size)
+{
+    m_batchSize.store(size, std::memory_order_relaxed);
+}
+
+void BitTorrent::DBResumeDataStorage::Worker::setCompressionEnabled(const bool enabled)
+{
+    m_isCompressionEnabled.store(enabled, std::memory_order_relaxed);
 }
 
-void BitTorrent::DBResumeDataStorage::Worker::addJob(std::unique_ptr<Job> job)
+void BitTorrent::DBResumeDataStorage::Worker::addJob(QueuedJob queuedJob)
 {
     m_jobsMutex.lock();
-    m_jobs.push(std::move(job));
+    m_jobs.push(std::move(queuedJob));
     m_jobsMutex.unlock();
 
     m_waitCondition.wakeAll();
@@ -803,16 +1083,40 @@ namespace
 {
     using namespace BitTorrent;
 
-StoreJob::StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData)
+    QueryCache::QueryCache(const QSqlDatabase &db)
+        : m_db {db}
+    {
+    }
+
+    QSqlQuery &QueryCache::prepared(const QString &statement)
+    {
+        if (const auto iter = m_queries.find(statement); iter != m_queries.end())
+            return iter->second;
+
+        QSqlQuery query {m_db};
+        if (!query.prepare(statement))
+            throw RuntimeError(query.lastError().text());
+
+        return m_queries.emplace(statement, std::move(query)).first->second;
+    }
+
+    StoreJob::StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData, const bool compress)
         : m_torrentID {torrentID}
         , m_resumeData {std::move(resumeData)}
+        , m_compress {compress}
     {
     }
 
-    void StoreJob::perform(QSqlDatabase db)
+    void StoreJob::setResumeData(LoadTorrentParams resumeData)
     {
-        // We need to adjust native libtorrent resume data
-        lt::add_torrent_params p = m_resumeData.ltAddTorrentParams;
+        m_resumeData = std::move(resumeData);
+    }
+
+    void StoreJob::perform(QueryCache &queryCache)
+    {
+        // We need to adjust native libtorrent resume data,
+        // the job is performed once so it is done in place
+        lt::add_torrent_params &p = m_resumeData.ltAddTorrentParams;
         p.save_path = Profile::instance()->toPortablePath(Path(p.save_path))
                 .toString().toStdString();
         if (m_resumeData.stopped)
@@ -835,7 +1139,7 @@ StoreJob::StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData)
             }
         }
 
-        QList<Column> columns {
+        static const QList<Column> columns = QList<Column> {
             DB_COLUMN_TORRENT_ID,
             DB_COLUMN_NAME,
             DB_COLUMN_CATEGORY,
@@ -856,8 +1160,9 @@ StoreJob::StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData)
             DB_COLUMN_SSL_CERTIFICATE,
             DB_COLUMN_SSL_PRIVATE_KEY,
             DB_COLUMN_SSL_DH_PARAMS,
-            DB_COLUMN_RESUMEDATA
-        };
+            DB_COLUMN_RESUMEDATA,
+            DB_COLUMN_RESUMEDATA_COMPRESSED
+        } + DB_COUNTERS_COLUMNS;
 
         lt::entry data = lt::write_resume_data(p);
 
@@ -884,22 +1189,29 @@ StoreJob::StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData)
                         .arg(QString::fromLocal8Bit(err.what())), Log::CRITICAL);
                 return;
             }
-
-            columns.append(DB_COLUMN_METADATA);
         }
 
         QByteArray bencodedResumeData;
         bencodedResumeData.reserve(256 * 1024);
         lt::bencode(std::back_inserter(bencodedResumeData), data);
 
-        const QString insertTorrentStatement = makeInsertStatement(DB_TABLE_TORRENTS, columns)
-                + makeOnConflictUpdateStatement(DB_COLUMN_TORRENT_ID, columns);
-        QSqlQuery query {db};
+        const BlobCodec resumeDataCodec = m_compress ? compressBlob(bencodedResumeData) : BlobCodec::None;
+        const BlobCodec metadataCodec = (m_compress && !bencodedMetadata.isEmpty()) ? compressBlob(bencodedMetadata) : BlobCodec::None;
+
+        const auto makeUpsertStatement = [](const QList<Column> &columns)
+        {
+            return makeInsertStatement(DB_TABLE_TORRENTS, columns)
+                    + makeOnConflictUpdateStatement(DB_COLUMN_TORRENT_ID, columns);
+        };
+        static const QString upsertTorrentStatement = makeUpsertStatement(columns);
+        static const QString upsertTorrentWithMetadataStatement = makeUpsertStatement(columns + QList<Column> {DB_COLUMN_METADATA, DB_COLUMN_METADATA_COMPRESSED});
 
         try
         {
-            if (!query.prepare(insertTorrentStatement))
-                throw RuntimeError(query.lastError().text());
+            // Prepared query is reused so every placeholder must be bound each time
+            // to prevent values of previously stored torrent from leaking in
+            QSqlQuery &query = queryCache.prepared(bencodedMetadata.isEmpty()
+                    ? upsertTorrentStatement : upsertTorrentWithMetadataStatement);
 
             query.bindValue(DB_COLUMN_TORRENT_ID.placeholder, m_torrentID.toString());
             query.bindValue(DB_COLUMN_NAME.placeholder, m_resumeData.name);
@@ -926,10 +1238,28 @@ StoreJob::StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData)
                 query.bindValue(DB_COLUMN_TARGET_SAVE_PATH.placeholder, Profile::instance()->toPortablePath(m_resumeData.savePath).data());
                 query.bindValue(DB_COLUMN_DOWNLOAD_PATH.placeholder, Profile::instance()->toPortablePath(m_resumeData.downloadPath).data());
             }
+            else
+            {
+                query.bindValue(DB_COLUMN_TARGET_SAVE_PATH.placeholder, QVariant());
+                query.bindValue(DB_COLUMN_DOWNLOAD_PATH.placeholder, QVariant());
+            }
 
             query.bindValue(DB_COLUMN_RESUMEDATA.placeholder, bencodedResumeData);
+            query.bindValue(DB_COLUMN_RESUMEDATA_COMPRESSED.placeholder, static_cast<int>(resumeDataCodec));
+            bindCounters(query, {
+                .totalUploaded = p.total_uploaded,
+                .totalDownloaded = p.total_downloaded,
+                .activeTime = p.active_time,
+                .finishedTime = p.finished_time,
+                .seedingTime = p.seeding_time,
+                .lastUpload = p.last_upload,
+                .lastDownload = p.last_download
+            });
             if (!bencodedMetadata.isEmpty())
+            {
                 query.bindValue(DB_COLUMN_METADATA.placeholder, bencodedMetadata);
+                query.bindValue(DB_COLUMN_METADATA_COMPRESSED.placeholder, static_cast<int>(metadataCodec));
+            }
 
             if (!query.exec())
                 throw RuntimeError(query.lastError().text());
@@ -941,65 +1271,118 @@ StoreJob::StoreJob(const TorrentID &torrentID, LoadTorrentParams resumeData)
         }
     }
 
-    RemoveJob::RemoveJob(const TorrentID &torrentID)
+    RemoveJob::RemoveJob(const TorrentID &torrentID, std::optional<SparseQueuePositions> &queuePositions)
         : m_torrentID {torrentID}
+        , m_queuePositions {queuePositions}
     {
     }
 
-    void RemoveJob::perform(QSqlDatabase db)
+    void RemoveJob::perform(QueryCache &queryCache)
     {
-        const auto deleteTorrentStatement = u"DELETE FROM %1 WHERE %2 = %3;"_s
+        static const auto deleteTorrentStatement = u"DELETE FROM %1 WHERE %2 = %3;"_s
                 .arg(quoted(DB_TABLE_TORRENTS), quoted(DB_COLUMN_TORRENT_ID.name), DB_COLUMN_TORRENT_ID.placeholder);
 
-        QSqlQuery query {db};
         try
         {
-            if (!query.prepare(deleteTorrentStatement))
+            QSqlQuery &query = queryCache.prepared(deleteTorrentStatement);
+            query.bindValue(DB_COLUMN_TORRENT_ID.placeholder, m_torrentID.toString());
+
+            if (!query.exec())
                 throw RuntimeError(query.lastError().text());
 
+            // the torrent can be added again later, then its row is created without position
+            if (m_queuePositions)
+                m_queuePositions->remove(m_torrentID);
+        }
+        catch (const RuntimeError &err)
+        {
+            LogMsg(ResumeDataStorage::tr("Couldn't delete resume data of torrent '%1'. Error: %2")
+                    .arg(m_torrentID.toString(), err.message()), Log::CRITICAL);
+        }
+    }
+
+    StoreCountersJob::StoreCountersJob(const TorrentID &torrentID, const TorrentCounters &counters)
+        : m_torrentID {torrentID}
+        , m_counters {counters}
+    {
+    }
+
+    void StoreCountersJob::perform(QueryCache &queryCache)
+    {
+        static const QString updateCountersStatement = makeUpdateStatement(DB_TABLE_TORRENTS, DB_COUNTERS_COLUMNS)
+                + u" WHERE %1 = %2;"_s.arg(quoted(DB_COLUMN_TORRENT_ID.name), DB_COLUMN_TORRENT_ID.placeholder);
+
+        try
+        {
+            QSqlQuery &query = queryCache.prepared(updateCountersStatement);
             query.bindValue(DB_COLUMN_TORRENT_ID.placeholder, m_torrentID.toString());
+            bindCounters(query, m_counters);
 
             if (!query.exec())
                 throw RuntimeError(query.lastError().text());
         }
         catch (const RuntimeError &err)
         {
-            LogMsg(ResumeDataStorage::tr("Couldn't delete resume data of torrent '%1'. Error: %2")
+            LogMsg(ResumeDataStorage::tr("Couldn't store counters of torrent '%1'. Error: %2")
                     .arg(m_torrentID.toString(), err.message()), Log::CRITICAL);
         }
     }
 
-    StoreQueueJob::StoreQueueJob(const QList<TorrentID> &queue)
+    StoreQueueJob::StoreQueueJob(const QList<TorrentID> &queue, std::optional<SparseQueuePositions> &queuePositions)
         : m_queue {queue}
+        , m_queuePositions {queuePositions}
     {
     }
 
-    void StoreQueueJob::perform(QSqlDatabase db)
+    void StoreQueueJob::perform(QueryCache &queryCache)
     {
-        const auto updateQueuePosStatement = u"UPDATE %1 SET %2 = %3 WHERE %4 = %5;"_s
+        static const auto updateQueuePosStatement = u"UPDATE %1 SET %2 = %3 WHERE %4 = %5;"_s
                 .arg(quoted(DB_TABLE_TORRENTS), quoted(DB_COLUMN_QUEUE_POSITION.name), DB_COLUMN_QUEUE_POSITION.placeholder
                         , quoted(DB_COLUMN_TORRENT_ID.name), DB_COLUMN_TORRENT_ID.placeholder);
 
         try
         {
-            QSqlQuery query {db};
+            if (!m_queuePositions)
+                loadQueuePositions(queryCache);
 
-            if (!query.prepare(updateQueuePosStatement))
-                throw RuntimeError(query.lastError().text());
+            // Only the rows of the torrents which were moved (or added) are updated
+            const QList<std::pair<TorrentID, qint64>> changes = m_queuePositions->update(m_queue);
+            if (changes.isEmpty())
+                return;
 
-            int pos = 0;
-            for (const TorrentID &torrentID : m_queue)
+            QSqlQuery &query = queryCache.prepared(updateQueuePosStatement);
+            for (const auto &[torrentID, pos] : changes)
             {
                 query.bindValue(DB_COLUMN_TORRENT_ID.placeholder, torrentID.toString());
-                query.bindValue(DB_COLUMN_QUEUE_POSITION.placeholder, pos++);
+                query.bindValue(DB_COLUMN_QUEUE_POSITION.placeholder, pos);
                 if (!query.exec())
                     throw RuntimeError(query.lastError().text());
             }
         }
         catch (const RuntimeError &err)
         {
+            // the positions are reloaded next time since it's unknown which of them are stored
+            m_queuePositions.reset();
+
             LogMsg(ResumeDataStorage::tr("Couldn't store torrents queue positions. Error: %1")
                     .arg(err.message()), Log::CRITICAL);
         }
     }
+
+    void StoreQueueJob::loadQueuePositions(QueryCache &queryCache)
+    {
+        static const auto selectQueuePosStatement = u"SELECT %1, %2 FROM %3;"_s
+                .arg(quoted(DB_COLUMN_TORRENT_ID.name), quoted(DB_COLUMN_QUEUE_POSITION.name), quoted(DB_TABLE_TORRENTS));
+
+        QSqlQuery &query = queryCache.prepared(selectQueuePosStatement);
+        if (!query.exec())
+            throw RuntimeError(query.lastError().text());
+
+        QHash<TorrentID, qint64> positions;
+        while (query.next())
+            positions.insert(TorrentID::fromString(query.value(0).toString()), query.value(1).toLongLong());
+        query.finish();
+
+        m_queuePositions.emplace(positions);
+    }
 }
@@ -33,7 +33,7 @@
 #include "base/pathfwd.h"
 #include "resumedatastorage.h"
 
-class QSqlQuery;
+class QSqlRecord;
 
 namespace BitTorrent
 {
@@ -52,6 +52,13 @@ namespace BitTorrent
         void store(const TorrentID &id, LoadTorrentParams resumeData) const override;
         void remove(const TorrentID &id) const override;
         void storeQueue(const QList<TorrentID> &queue) const override;
+        bool canStoreCounters() const override;
+        void storeCounters(const TorrentID &id, const TorrentCounters &counters) const override;
+
+        // Maximum number of changes committed in a single transaction (0 means unlimited)
+        void setBatchSize(int size);
+        // Affects resume data stored afterwards, data stored either way can be loaded
+        void setCompressionEnabled(bool enabled);
 
     private:
         void doLoadAll() const override;
@@ -59,7 +66,7 @@ namespace BitTorrent
         void createDB() const;
         void updateDB(int fromVersion) const;
         void enableWALMode() const;
-        LoadResumeDataResult parseQueryResultRow(const QSqlQuery &query) const;
+        LoadResumeDataResult parseQueryResultRow(const QSqlRecord &record) const;
 
         class Worker;
         Worker *m_asyncWorker = nullptr;
@@ -0,0 +1,146 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "diskiostatistics.h"
+
+#include <algorithm>
+
+#include <QMutexLocker>
+
+#include "base/utils/fs.h"
+
+using namespace BitTorrent;
+
+void DiskIOOperationStatistics::add(const qint64 size, const qint64 latency)
+{
+    ++count;
+    bytes += size;
+    totalLatency += latency;
+    maxLatency = std::max(maxLatency, latency);
+
+    const auto bucketIter = std::ranges::lower_bound(DISK_IO_LATENCY_HISTOGRAM_BOUNDS, latency);
+    ++latencyHistogram[bucketIter - DISK_IO_LATENCY_HISTOGRAM_BOUNDS.cbegin()];
+}
+
+qint64 DiskIOOperationStatistics::latencyPercentile(const int percent) const
+{
+    if (count <= 0)
+        return 0;
+
+    // rank of the percentile sample, rounded up
+    const qint64 rank = std::max<qint64>(1, ((count * percent) + 99) / 100);
+    qint64 cumulativeCount = 0;
+    for (int i = 0; i < (DISK_IO_LATENCY_HISTOGRAM_SIZE - 1); ++i)
+    {
+        cumulativeCount += latencyHistogram[i];
+        if (cumulativeCount >= rank)
+            return std::min(DISK_IO_LATENCY_HISTOGRAM_BOUNDS[i], maxLatency);
+    }
+
+    return maxLatency;
+}
+
+DiskIOOperationStatistics &DiskIOStatistics::operator[](const DiskIOOperation operation)
+{
+    return operations[static_cast<int>(operation)];
+}
+
+const DiskIOOperationStatistics &DiskIOStatistics::operator[](const DiskIOOperation operation) const
+{
+    return operations[static_cast<int>(operation)];
+}
+
+QString DiskIOAccounting::volumeOf(const Path &path)
+{
+    const QMutexLocker locker {&m_volumesMutex};
+
+    // Looking up mount points is rather expensive while there are usually just a few save paths
+    const auto iter = m_volumes.constFind(path);
+    if (iter != m_volumes.cend())
+        return iter.value();
+
+    const QString volume = Utils::Fs::storageDevice(path);
+    m_volumes.insert(path, volume);
+    return volume;
+}
+
+void DiskIOAccounting::addOperation(const TorrentID &id, const QString &volume, const DiskIOOperation operation
+        , const qint64 size, const std::chrono::microseconds latency)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_torrentStatistics[id][operation].add(size, latency.count());
+    m_volumeStatistics[volume][operation].add(size, latency.count());
+}
+
+void DiskIOAccounting::removeTorrent(const TorrentID &id)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_torrentStatistics.remove(id);
+}
+
+void DiskIOAccounting::setMoveProgress(const TorrentID &id, const qint64 copiedBytes)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_moveProgress[id] = copiedBytes;
+}
+
+void DiskIOAccounting::removeMoveProgress(const TorrentID &id)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_moveProgress.remove(id);
+}
+
+qint64 DiskIOAccounting::moveProgress(const TorrentID &id) const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_moveProgress.value(id);
+}
+
+void DiskIOAccounting::addCheckedBytes(const qint64 size)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_checkedBytes += size;
+}
+
+qint64 DiskIOAccounting::checkedBytes() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_checkedBytes;
+}
+
+DiskIOStatistics DiskIOAccounting::torrentStatistics(const TorrentID &id) const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_torrentStatistics.value(id);
+}
+
+QHash<QString, DiskIOStatistics> DiskIOAccounting::volumeStatistics() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_volumeStatistics;
+}
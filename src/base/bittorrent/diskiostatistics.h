@@ -0,0 +1,118 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include <QHash>
+#include <QMutex>
+#include <QString>
+#include <QtTypes>
+
+#include "base/path.h"
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    enum class DiskIOOperation
+    {
+        Read,
+        Write,
+        Hash,
+        Move
+    };
+
+    inline constexpr int DISK_IO_OPERATION_COUNT = 4;
+
+    inline constexpr int DISK_IO_LATENCY_HISTOGRAM_SIZE = 10;
+    // Inclusive upper bounds of the histogram buckets, the last bucket counts all the greater values
+    inline constexpr std::array<qint64, (DISK_IO_LATENCY_HISTOGRAM_SIZE - 1)> DISK_IO_LATENCY_HISTOGRAM_BOUNDS
+            {100, 500, 1'000, 5'000, 10'000, 50'000, 100'000, 500'000, 1'000'000};  // microseconds
+
+    struct DiskIOOperationStatistics
+    {
+        qint64 count = 0;
+        qint64 bytes = 0;
+        // Latency in microseconds, it includes the time the job spent in the queue
+        qint64 totalLatency = 0;
+        qint64 maxLatency = 0;
+        std::array<qint64, DISK_IO_LATENCY_HISTOGRAM_SIZE> latencyHistogram {};
+
+        void add(qint64 size, qint64 latency);
+        // Returns the upper bound of the histogram bucket containing the percentile
+        // (or the max latency if it falls into the last bucket)
+        qint64 latencyPercentile(int percent) const;
+    };
+
+    struct DiskIOStatistics
+    {
+        // Indexed by DiskIOOperation
+        std::array<DiskIOOperationStatistics, DISK_IO_OPERATION_COUNT> operations {};
+
+        DiskIOOperationStatistics &operator[](DiskIOOperation operation);
+        const DiskIOOperationStatistics &operator[](DiskIOOperation operation) const;
+    };
+
+    // Collects the statistics of the jobs passed to the disk IO per torrent and per volume.
+    // It is fed by the network thread and can be queried from any thread.
+    class DiskIOAccounting
+    {
+        Q_DISABLE_COPY_MOVE(DiskIOAccounting)
+
+    public:
+        DiskIOAccounting() = default;
+
+        // Identifies the volume the path belongs to, see Utils::Fs::storageDevice()
+        QString volumeOf(const Path &path);
+
+        void addOperation(const TorrentID &id, const QString &volume, DiskIOOperation operation, qint64 size, std::chrono::microseconds latency);
+        void removeTorrent(const TorrentID &id);
+        // Amount of the data copied so far by the ongoing move of the torrent to another volume
+        void setMoveProgress(const TorrentID &id, qint64 copiedBytes);
+        void removeMoveProgress(const TorrentID &id);
+        qint64 moveProgress(const TorrentID &id) const;
+        // Amount of the data hashed by checking of the torrents since the session is started
+        void addCheckedBytes(qint64 size);
+        qint64 checkedBytes() const;
+
+        DiskIOStatistics torrentStatistics(const TorrentID &id) const;
+        QHash<QString, DiskIOStatistics> volumeStatistics() const;
+
+    private:
+        mutable QMutex m_mutex;
+        QHash<TorrentID, DiskIOStatistics> m_torrentStatistics;
+        QHash<QString, DiskIOStatistics> m_volumeStatistics;
+        QHash<TorrentID, qint64> m_moveProgress;
+        qint64 m_checkedBytes = 0;
+
+        QMutex m_volumesMutex;
+        QHash<Path, QString> m_volumes;
+    };
+}
@@ -0,0 +1,186 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "diskreadcache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QMutexLocker>
+
+namespace
+{
+    // Blocks are requested by peers in 16KiB chunks
+    const qint64 BLOCK_SIZE = 16 * 1024;
+    // Number of misses after which a block is admitted
+    const int ADMISSION_MISS_COUNT = 2;
+    const qint64 MIN_GHOST_BLOCK_COUNT = 1024;
+}
+
+DiskReadCache::DiskReadCache(const qint64 capacity)
+    : m_capacity {std::max<qint64>(capacity, 0)}
+{
+}
+
+qint64 DiskReadCache::capacity() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_capacity;
+}
+
+void DiskReadCache::setCapacity(const qint64 capacity)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    m_capacity = std::max<qint64>(capacity, 0);
+    evictBlocks();
+    evictGhostBlocks();
+}
+
+QByteArray DiskReadCache::find(const BlockKey &key)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if (m_capacity == 0)
+        return {};
+
+    if (const auto blockIter = m_blocks.find(key); blockIter != m_blocks.end())
+    {
+        ++m_hits;
+        CachedBlock &block = blockIter->second;
+        m_blocksLRU.splice(m_blocksLRU.begin(), m_blocksLRU, block.lruIter);
+        return block.data;
+    }
+
+    ++m_misses;
+    if (const auto ghostIter = m_ghostBlocks.find(key); ghostIter != m_ghostBlocks.end())
+    {
+        GhostBlock &ghost = ghostIter->second;
+        ++ghost.missCount;
+        m_ghostBlocksLRU.splice(m_ghostBlocksLRU.begin(), m_ghostBlocksLRU, ghost.lruIter);
+    }
+    else
+    {
+        m_ghostBlocksLRU.push_front(key);
+        m_ghostBlocks.emplace(key, GhostBlock {1, m_ghostBlocksLRU.begin()});
+        evictGhostBlocks();
+    }
+
+    return {};
+}
+
+QList<DiskReadCache::Block> DiskReadCache::offer(const BlockKey &key, const char *data)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if ((key.length <= 0) || (key.length > m_capacity))
+        return {};
+
+    const auto ghostIter = m_ghostBlocks.find(key);
+    if ((ghostIter == m_ghostBlocks.end()) || (ghostIter->second.missCount < ADMISSION_MISS_COUNT))
+        return {};
+
+    m_ghostBlocksLRU.erase(ghostIter->second.lruIter);
+    m_ghostBlocks.erase(ghostIter);
+
+    if (m_blocks.contains(key))
+        return {};
+
+    m_blocksLRU.push_front(key);
+    m_blocks.emplace(key, CachedBlock {QByteArray(data, key.length), m_blocksLRU.begin()});
+    m_size += key.length;
+
+    QList<Block> evictedBlocks;
+    evictBlocks(&evictedBlocks);
+    return evictedBlocks;
+}
+
+void DiskReadCache::removePiece(const int storage, const int piece)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    removeBlocks({storage, piece, std::numeric_limits<int>::min(), std::numeric_limits<int>::min()}
+            , {storage, piece, std::numeric_limits<int>::max(), std::numeric_limits<int>::max()});
+}
+
+void DiskReadCache::removeStorage(const int storage)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    removeBlocks({storage, std::numeric_limits<int>::min(), std::numeric_limits<int>::min(), std::numeric_limits<int>::min()}
+            , {storage, std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), std::numeric_limits<int>::max()});
+}
+
+DiskReadCache::Statistics DiskReadCache::statistics() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return {m_hits, m_misses, m_size, m_capacity};
+}
+
+void DiskReadCache::removeBlocks(const BlockKey &first, const BlockKey &last)
+{
+    const auto blocksBegin = m_blocks.lower_bound(first);
+    const auto blocksEnd = m_blocks.upper_bound(last);
+    for (auto iter = blocksBegin; iter != blocksEnd; ++iter)
+    {
+        m_size -= iter->second.data.size();
+        m_blocksLRU.erase(iter->second.lruIter);
+    }
+    m_blocks.erase(blocksBegin, blocksEnd);
+
+    const auto ghostsBegin = m_ghostBlocks.lower_bound(first);
+    const auto ghostsEnd = m_ghostBlocks.upper_bound(last);
+    for (auto iter = ghostsBegin; iter != ghostsEnd; ++iter)
+        m_ghostBlocksLRU.erase(iter->second.lruIter);
+    m_ghostBlocks.erase(ghostsBegin, ghostsEnd);
+}
+
+void DiskReadCache::evictBlocks(QList<Block> *evictedBlocks)
+{
+    while (m_size > m_capacity)
+    {
+        const auto blockIter = m_blocks.find(m_blocksLRU.back());
+        m_size -= blockIter->second.data.size();
+        if (evictedBlocks)
+            evictedBlocks->append({blockIter->first, blockIter->second.data});
+        m_blocks.erase(blockIter);
+        m_blocksLRU.pop_back();
+    }
+}
+
+void DiskReadCache::evictGhostBlocks()
+{
+    // Remember (at least) as many missed blocks as the cache can hold
+    const auto maxGhostCount = static_cast<std::size_t>((m_capacity > 0)
+            ? std::max((m_capacity / BLOCK_SIZE), MIN_GHOST_BLOCK_COUNT) : 0);
+    while (m_ghostBlocks.size() > maxGhostCount)
+    {
+        m_ghostBlocks.erase(m_ghostBlocksLRU.back());
+        m_ghostBlocksLRU.pop_back();
+    }
+}
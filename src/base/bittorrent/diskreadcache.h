@@ -0,0 +1,117 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+
+#include <QtTypes>
+#include <QByteArray>
+#include <QList>
+#include <QMutex>
+
+// Keeps the most frequently read blocks of torrent data in memory.
+// A block is admitted only when it was missed at least twice recently, so
+// data that is read just once (e.g. by a single downloading peer) doesn't
+// evict the blocks of popular torrents. The cached blocks are evicted in
+// least recently used order.
+class DiskReadCache
+{
+    Q_DISABLE_COPY_MOVE(DiskReadCache)
+
+public:
+    struct BlockKey
+    {
+        int storage = 0;
+        int piece = 0;
+        int offset = 0;
+        int length = 0;
+
+        friend auto operator<=>(const BlockKey &left, const BlockKey &right) = default;
+    };
+
+    struct Block
+    {
+        BlockKey key;
+        QByteArray data;
+    };
+
+    struct Statistics
+    {
+        qint64 hits = 0;
+        qint64 misses = 0;
+        qint64 size = 0;
+        qint64 capacity = 0;
+    };
+
+    explicit DiskReadCache(qint64 capacity = 0);
+
+    qint64 capacity() const;
+    void setCapacity(qint64 capacity);
+
+    // Returns null QByteArray if the block isn't cached
+    QByteArray find(const BlockKey &key);
+    // Passes the block read from the disk, it is copied if it should be admitted.
+    // Returns the blocks evicted to make room for it.
+    QList<Block> offer(const BlockKey &key, const char *data);
+
+    void removePiece(int storage, int piece);
+    void removeStorage(int storage);
+
+    Statistics statistics() const;
+
+private:
+    struct CachedBlock
+    {
+        QByteArray data;
+        std::list<BlockKey>::iterator lruIter;
+    };
+
+    struct GhostBlock
+    {
+        int missCount = 0;
+        std::list<BlockKey>::iterator lruIter;
+    };
+
+    void removeBlocks(const BlockKey &first, const BlockKey &last);
+    void evictBlocks(QList<Block> *evictedBlocks = nullptr);
+    void evictGhostBlocks();
+
+    mutable QMutex m_mutex;
+    qint64 m_capacity = 0;
+    qint64 m_size = 0;
+    qint64 m_hits = 0;
+    qint64 m_misses = 0;
+
+    std::map<BlockKey, CachedBlock> m_blocks;
+    std::list<BlockKey> m_blocksLRU;
+    // Recently missed blocks which are not cached
+    std::map<BlockKey, GhostBlock> m_ghostBlocks;
+    std::list<BlockKey> m_ghostBlocksLRU;
+};
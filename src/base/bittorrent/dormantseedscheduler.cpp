@@ -0,0 +1,162 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "dormantseedscheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+using namespace BitTorrent;
+
+DormantSeedScheduler::DormantSeedScheduler(const qint64 idleTime, const qint64 scrapeInterval)
+    : m_idleTime {std::max<qint64>(1, idleTime)}
+    , m_scrapeInterval {std::max<qint64>(1, scrapeInterval)}
+{
+}
+
+qint64 DormantSeedScheduler::idleTime() const
+{
+    return m_idleTime;
+}
+
+void DormantSeedScheduler::setIdleTime(const qint64 idleTime)
+{
+    m_idleTime = std::max<qint64>(1, idleTime);
+}
+
+qint64 DormantSeedScheduler::scrapeInterval() const
+{
+    return m_scrapeInterval;
+}
+
+void DormantSeedScheduler::setScrapeInterval(const qint64 scrapeInterval)
+{
+    // the scrapes already scheduled aren't moved, the new interval applies to the next ones
+    m_scrapeInterval = std::max<qint64>(1, scrapeInterval);
+}
+
+bool DormantSeedScheduler::isEmpty() const
+{
+    return m_seeds.isEmpty();
+}
+
+qsizetype DormantSeedScheduler::dormantCount() const
+{
+    return m_dormantCount;
+}
+
+bool DormantSeedScheduler::isDormant(const TorrentID &id) const
+{
+    const auto iter = m_seeds.constFind(id);
+    return (iter != m_seeds.cend()) && iter->isDormant;
+}
+
+void DormantSeedScheduler::updateAwake(const TorrentID &id, const bool hasDemand, const qint64 now)
+{
+    const auto iter = m_seeds.find(id);
+    if (iter == m_seeds.end())
+    {
+        m_seeds.insert(id, {.isDormant = false, .time = now});
+        return;
+    }
+
+    Q_ASSERT(!iter->isDormant);
+    if (hasDemand)
+        iter->time = now;
+}
+
+void DormantSeedScheduler::wake(const TorrentID &id, const qint64 now)
+{
+    Seed &seed = m_seeds[id];
+    if (seed.isDormant)
+        --m_dormantCount;
+
+    seed = {.isDormant = false, .time = now};
+}
+
+bool DormantSeedScheduler::remove(const TorrentID &id)
+{
+    const auto iter = m_seeds.constFind(id);
+    if (iter == m_seeds.cend())
+        return false;
+
+    if (iter->isDormant)
+        --m_dormantCount;
+    m_seeds.erase(iter);
+    return true;
+}
+
+void DormantSeedScheduler::clear()
+{
+    m_seeds.clear();
+    m_dormantCount = 0;
+}
+
+QList<TorrentID> DormantSeedScheduler::takeIdle(const qint64 now)
+{
+    QList<TorrentID> idle;
+    for (auto iter = m_seeds.begin(); iter != m_seeds.end(); ++iter)
+    {
+        Seed &seed = iter.value();
+        if (seed.isDormant || ((now - seed.time) < m_idleTime))
+            continue;
+
+        seed = {.isDormant = true, .time = (now + m_scrapeInterval)};
+        idle.append(iter.key());
+    }
+
+    m_dormantCount += idle.size();
+    return idle;
+}
+
+QList<TorrentID> DormantSeedScheduler::takeScrapeDue(const qint64 now, const qsizetype maxCount)
+{
+    QList<std::pair<qint64, TorrentID>> due;
+    for (auto iter = m_seeds.cbegin(); iter != m_seeds.cend(); ++iter)
+    {
+        if (iter->isDormant && (iter->time <= now))
+            due.emplaceBack(iter->time, iter.key());
+    }
+
+    const qsizetype count = std::clamp<qsizetype>(maxCount, 0, due.size());
+    std::ranges::partial_sort(due, (due.begin() + count), [](const auto &left, const auto &right)
+    {
+        return left.first < right.first;
+    });
+
+    QList<TorrentID> scraped;
+    scraped.reserve(count);
+    for (qsizetype i = 0; i < count; ++i)
+    {
+        const TorrentID &id = due[i].second;
+        m_seeds[id].time = now + m_scrapeInterval;
+        scraped.append(id);
+    }
+
+    return scraped;
+}
@@ -0,0 +1,89 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QtClassHelperMacros>
+#include <QHash>
+#include <QList>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    // Tracks the demand for the seeding torrents, so the ones nobody asks for can be kept dormant
+    // (i.e. paused) instead of holding file handles, peer connections and active slots.
+    // The awake seed becomes dormant once it has no demand for the idle time. The dormant seeds
+    // are scraped once per scrape interval to find out whether there are leechers to wake them for.
+    class DormantSeedScheduler final
+    {
+        Q_DISABLE_COPY_MOVE(DormantSeedScheduler)
+
+    public:
+        static constexpr qint64 DEFAULT_IDLE_TIME = 3600;  // seconds
+        static constexpr qint64 DEFAULT_SCRAPE_INTERVAL = 21600;  // seconds
+
+        explicit DormantSeedScheduler(qint64 idleTime = DEFAULT_IDLE_TIME, qint64 scrapeInterval = DEFAULT_SCRAPE_INTERVAL);
+
+        qint64 idleTime() const;
+        void setIdleTime(qint64 idleTime);
+        qint64 scrapeInterval() const;
+        void setScrapeInterval(qint64 scrapeInterval);
+
+        bool isEmpty() const;
+        qsizetype dormantCount() const;
+        bool isDormant(const TorrentID &id) const;
+
+        // `now` is the current time in seconds of any monotonic clock.
+        // Updates the awake seed, the seed which isn't known yet is considered to have demand now.
+        void updateAwake(const TorrentID &id, bool hasDemand, qint64 now);
+        // The seed is awake again, e.g. the scrape reported leechers or it was started by the user
+        void wake(const TorrentID &id, qint64 now);
+        bool remove(const TorrentID &id);
+        void clear();
+
+        // Returns the awake seeds having no demand for the idle time, they are considered dormant then
+        QList<TorrentID> takeIdle(qint64 now);
+        // Returns up to `maxCount` dormant seeds due to be scraped, the most overdue first.
+        // Their next scrapes are scheduled in the scrape interval.
+        QList<TorrentID> takeScrapeDue(qint64 now, qsizetype maxCount);
+
+    private:
+        struct Seed
+        {
+            bool isDormant = false;
+            // the last time it had demand if it is awake, otherwise the time of the next scrape
+            qint64 time = 0;
+        };
+
+        qint64 m_idleTime = 0;
+        qint64 m_scrapeInterval = 0;
+        QHash<TorrentID, Seed> m_seeds;
+        qsizetype m_dormantCount = 0;
+    };
+}
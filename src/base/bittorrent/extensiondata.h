@@ -28,11 +28,18 @@
 
 #pragma once
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include <libtorrent/address.hpp>
 #include <libtorrent/announce_entry.hpp>
+#include <libtorrent/socket.hpp>
 #include <libtorrent/torrent_status.hpp>
 
 #ifdef QBT_USES_LIBTORRENT2
@@ -42,9 +49,30 @@ using LTClientData = lt::client_data_t;
 using LTClientData = void *;
 #endif
 
+struct PeerTraffic
+{
+    std::int64_t downloaded = 0;
+    std::int64_t uploaded = 0;
+    std::int64_t connections = 0;
+};
+
+// Traffic of the torrent peers counted on the network thread since the main thread took it last time
+struct PeerTrafficData
+{
+    // Peers are keyed by the address and the client code from the peer ID
+    using Key = std::pair<lt::address, std::string>;
+
+    std::mutex mutex;
+    std::map<Key, PeerTraffic> peers;
+    // Listen endpoints of the connected peers the payload was exchanged with
+    std::set<lt::tcp::endpoint> usefulPeers;
+};
+
 struct ExtensionData
 {
     lt::torrent_status status;
     std::vector<lt::announce_entry> trackers;
     std::set<std::string> urlSeeds;
+    // shared with the peer plugins which may outlive the torrent one
+    std::shared_ptr<PeerTrafficData> peerTraffic = std::make_shared<PeerTrafficData>();
 };
@@ -0,0 +1,150 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "filenamefilter.h"
+
+#include <algorithm>
+
+#include <QList>
+#include <QStringList>
+
+#include "base/global.h"
+
+using namespace BitTorrent;
+
+namespace
+{
+    bool hasWildcards(const QString &pattern)
+    {
+        return std::ranges::any_of(pattern, [](const QChar c)
+        {
+            return (c == u'*') || (c == u'?') || (c == u'[') || (c == u'\\');
+        });
+    }
+}
+
+FileNameFilter::FileNameFilter(const QStringList &patterns)
+{
+    QStringList regexPatterns;
+    for (const QString &pattern : patterns)
+    {
+        if (pattern.isEmpty())
+            continue;
+
+        if (!hasWildcards(pattern))
+        {
+            m_names.insert(pattern.toCaseFolded());
+            continue;
+        }
+
+        // "*.<extension>" patterns are matched by the suffixes of the names
+        if (pattern.startsWith(u"*.") && !hasWildcards(pattern.sliced(1)))
+        {
+            m_extensions.insert(pattern.sliced(1).toCaseFolded());
+            continue;
+        }
+
+        const QString regexPattern = QRegularExpression::wildcardToRegularExpression(pattern);
+        // the invalid patterns never match, they shouldn't prevent the others from matching
+        if (QRegularExpression(regexPattern).isValid())
+            regexPatterns.append(u"(?:"_s + regexPattern + u')');
+    }
+
+    if (!regexPatterns.isEmpty())
+    {
+        m_regex = QRegularExpression(regexPatterns.join(u'|'), QRegularExpression::CaseInsensitiveOption);
+        m_regex.optimize();
+        m_hasRegex = true;
+    }
+}
+
+bool FileNameFilter::isEmpty() const
+{
+    return m_names.isEmpty() && m_extensions.isEmpty() && !m_hasRegex;
+}
+
+bool FileNameFilter::match(const Path &filePath) const
+{
+    QHash<Path, bool> matchedFolders;
+    return matchName(filePath.filename()) || matchFolder(filePath.parentPath(), matchedFolders);
+}
+
+QList<bool> FileNameFilter::match(const PathList &filePaths) const
+{
+    QList<bool> result;
+    result.reserve(filePaths.size());
+
+    if (isEmpty())
+    {
+        result.resize(filePaths.size(), false);
+        return result;
+    }
+
+    QHash<Path, bool> matchedFolders;
+    for (const Path &filePath : filePaths)
+        result.append(matchName(filePath.filename()) || matchFolder(filePath.parentPath(), matchedFolders));
+
+    return result;
+}
+
+bool FileNameFilter::matchName(const QString &name) const
+{
+    if (name.isEmpty())
+        return false;
+
+    if (!m_names.isEmpty() || !m_extensions.isEmpty())
+    {
+        const QString foldedName = name.toCaseFolded();
+        if (m_names.contains(foldedName))
+            return true;
+
+        if (!m_extensions.isEmpty())
+        {
+            // the extension can contain dots itself, e.g. "*.tar.gz"
+            for (qsizetype i = foldedName.indexOf(u'.'); i >= 0; i = foldedName.indexOf(u'.', (i + 1)))
+            {
+                if (m_extensions.contains(foldedName.sliced(i)))
+                    return true;
+            }
+        }
+    }
+
+    return m_hasRegex && m_regex.match(name).hasMatch();
+}
+
+bool FileNameFilter::matchFolder(const Path &folderPath, QHash<Path, bool> &matchedFolders) const
+{
+    if (folderPath.isEmpty())
+        return false;
+
+    if (const auto iter = matchedFolders.constFind(folderPath); iter != matchedFolders.cend())
+        return iter.value();
+
+    const bool isMatched = matchName(folderPath.filename()) || matchFolder(folderPath.parentPath(), matchedFolders);
+    matchedFolders.insert(folderPath, isMatched);
+    return isMatched;
+}
@@ -0,0 +1,164 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "filepreallocator.h"
+
+#include <algorithm>
+#include <chrono>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <QFile>
+#include <QTimer>
+
+#include "base/utils/fs.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Files are allocated in chunks so the progress is reported and the jobs can be cancelled in between
+    const qint64 CHUNK_SIZE = 1024LL * 1024 * 1024;
+}
+
+BitTorrent::FilePreallocator::FilePreallocator(QObject *parent)
+    : QObject(parent)
+    , m_timer {new QTimer(this)}
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &FilePreallocator::processJobs);
+}
+
+bool BitTorrent::FilePreallocator::isSupported()
+{
+#ifdef Q_OS_LINUX
+    return true;
+#else
+    // libtorrent makes the files sparse on Windows unless it allocates them itself
+    return false;
+#endif
+}
+
+void BitTorrent::FilePreallocator::preallocate(const TorrentID &torrentID, const QList<File> &files)
+{
+    Job job {.torrentID = torrentID, .files = files};
+    for (const File &file : files)
+        job.totalBytes += file.size;
+
+    m_jobs.enqueue(job);
+    if (!m_timer->isActive())
+        m_timer->start(0ms);
+}
+
+void BitTorrent::FilePreallocator::cancel(const TorrentID &torrentID)
+{
+    m_jobs.removeIf([&torrentID](const Job &job) { return job.torrentID == torrentID; });
+}
+
+void BitTorrent::FilePreallocator::processJobs()
+{
+    if (m_jobs.isEmpty())
+        return;
+
+    Job &job = m_jobs.head();
+    if (job.fileIndex >= job.files.size())
+    {
+        const TorrentID torrentID = m_jobs.dequeue().torrentID;
+        emit jobFinished(torrentID, {});
+    }
+    else if (const nonstd::expected<void, QString> result = allocateChunk(job); !result)
+    {
+        const TorrentID torrentID = job.torrentID;
+        m_jobs.dequeue();
+        emit jobFinished(torrentID, result.error());
+    }
+    else
+    {
+        emit jobProgress(job.torrentID, job.allocatedBytes, job.totalBytes);
+    }
+
+    if (!m_jobs.isEmpty())
+        m_timer->start(0ms);
+}
+
+nonstd::expected<void, QString> BitTorrent::FilePreallocator::allocateChunk(Job &job) const
+{
+    const File &file = job.files[job.fileIndex];
+    const qint64 length = std::min(CHUNK_SIZE, (file.size - job.fileOffset));
+
+#ifdef Q_OS_LINUX
+    if (length > 0)
+    {
+        if (!Utils::Fs::mkpath(file.path.parentPath()))
+            return nonstd::make_unexpected(tr("Couldn't create directory \"%1\"").arg(file.path.parentPath().toString()));
+
+        const int fd = ::open(QFile::encodeName(file.path.data()).constData(), (O_WRONLY | O_CREAT | O_CLOEXEC), 0666);
+        if (fd < 0)
+        {
+            return nonstd::make_unexpected(tr("Couldn't open \"%1\". Reason: \"%2\"")
+                    .arg(file.path.toString(), QString::fromLocal8Bit(std::strerror(errno))));
+        }
+
+        // The size of the file isn't changed so libtorrent doesn't consider it to have any data.
+        // Unlike posix_fallocate() it never falls back to writing the zeros over the blocks being downloaded.
+        const int result = ::fallocate(fd, FALLOC_FL_KEEP_SIZE, job.fileOffset, length);
+        const int errorCode = errno;
+        ::close(fd);
+
+        if (result != 0)
+        {
+            // the filesystem doesn't support it, the file stays sparse
+            if ((errorCode == EOPNOTSUPP) || (errorCode == ENOSYS))
+            {
+                job.allocatedBytes += (file.size - job.fileOffset);
+                job.fileOffset = 0;
+                ++job.fileIndex;
+                return {};
+            }
+
+            return nonstd::make_unexpected(tr("Couldn't allocate \"%1\". Reason: \"%2\"")
+                    .arg(file.path.toString(), QString::fromLocal8Bit(std::strerror(errorCode))));
+        }
+    }
+#endif
+
+    job.allocatedBytes += length;
+    job.fileOffset += length;
+    if (job.fileOffset >= file.size)
+    {
+        job.fileOffset = 0;
+        ++job.fileIndex;
+    }
+
+    return {};
+}
@@ -0,0 +1,90 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <QList>
+#include <QObject>
+#include <QQueue>
+#include <QString>
+
+#include "base/3rdparty/expected.hpp"
+#include "base/path.h"
+#include "infohash.h"
+
+class QTimer;
+
+namespace BitTorrent
+{
+    // Reserves the disk space of the torrent files in a background thread so libtorrent
+    // writes into already allocated extents without allocating them in its disk IO.
+    // The space is reserved without changing the file sizes, so it is safe to do it
+    // while the torrent is being downloaded.
+    class FilePreallocator final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(FilePreallocator)
+
+    public:
+        struct File
+        {
+            Path path;
+            qint64 size = 0;
+        };
+
+        explicit FilePreallocator(QObject *parent = nullptr);
+
+        // Otherwise the files should be preallocated by libtorrent
+        static bool isSupported();
+
+    public slots:
+        void preallocate(const TorrentID &torrentID, const QList<File> &files);
+        void cancel(const TorrentID &torrentID);
+
+    signals:
+        void jobProgress(const TorrentID &torrentID, qint64 allocatedBytes, qint64 totalBytes);
+        void jobFinished(const TorrentID &torrentID, const QString &errorMessage);
+
+    private:
+        struct Job
+        {
+            TorrentID torrentID;
+            QList<File> files;
+            qsizetype fileIndex = 0;
+            // Allocated part of the current file
+            qint64 fileOffset = 0;
+            qint64 allocatedBytes = 0;
+            qint64 totalBytes = 0;
+        };
+
+        void processJobs();
+        nonstd::expected<void, QString> allocateChunk(Job &job) const;
+
+        QQueue<Job> m_jobs;
+        QTimer *m_timer = nullptr;
+    };
+}
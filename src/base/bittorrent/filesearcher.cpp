@@ -28,51 +28,140 @@
 
 #include "filesearcher.h"
 
+#include <chrono>
+#include <memory>
+
+#include <QDir>
+#include <QFuture>
+#include <QMutexLocker>
 #include <QPromise>
+#include <QThreadPool>
 
+#include "base/algorithm.h"
 #include "base/bittorrent/common.h"
 
+using namespace std::chrono_literals;
+
 namespace
 {
-    bool findInDir(const Path &dirPath, PathList &fileNames, const bool forceAppendExt)
+    const int MAX_SEARCH_THREADS = 4;
+    const std::chrono::seconds DIRECTORY_LISTING_LIFETIME = 5s;
+
+    QString normalizedFileName(const QString &fileName)
     {
-        bool found = false;
-        for (Path &fileName : fileNames)
+#if defined(Q_OS_WIN)
+        return fileName.toCaseFolded();
+#else
+        return fileName;
+#endif
+    }
+}
+
+FileSearcher::FileSearcher(QObject *parent)
+    : QObject(parent)
+    , m_threadPool {new QThreadPool(this)}
+    , m_cachePurgeTimer {DIRECTORY_LISTING_LIFETIME}
+{
+    m_threadPool->setMaxThreadCount(MAX_SEARCH_THREADS);
+    m_threadPool->setObjectName("FileSearcher m_threadPool");
+}
+
+FileSearcher::~FileSearcher()
+{
+    // Running searches use the directory cache so they must be finished
+    // before it is destroyed
+    m_threadPool->clear();
+    m_threadPool->waitForDone();
+}
+
+QFuture<FileSearchResult> FileSearcher::search(const PathList &originalFileNames, const Path &savePath
+        , const Path &downloadPath, const bool forceAppendExt)
+{
+    const auto promise = std::make_shared<QPromise<FileSearchResult>>();
+    QFuture<FileSearchResult> future = promise->future();
+    promise->start();
+    m_threadPool->start([=, this]
+    {
+        promise->addResult(doSearch(originalFileNames, savePath, downloadPath, forceAppendExt));
+        promise->finish();
+    });
+
+    return future;
+}
+
+FileSearchResult FileSearcher::doSearch(const PathList &originalFileNames, const Path &savePath
+        , const Path &downloadPath, const bool forceAppendExt)
+{
+    Path usedPath = savePath;
+    PathList adjustedFileNames = originalFileNames;
+    const bool found = findInDir(usedPath, adjustedFileNames, (forceAppendExt && downloadPath.isEmpty()));
+    if (!found && !downloadPath.isEmpty())
+    {
+        usedPath = downloadPath;
+        findInDir(usedPath, adjustedFileNames, forceAppendExt);
+    }
+
+    return {.savePath = usedPath, .fileNames = adjustedFileNames};
+}
+
+bool FileSearcher::findInDir(const Path &dirPath, PathList &fileNames, const bool forceAppendExt)
+{
+    bool found = false;
+    for (Path &fileName : fileNames)
+    {
+        const QSet<QString> dirEntries = listDirectory((dirPath / fileName).parentPath());
+        if (dirEntries.contains(normalizedFileName(fileName.filename())))
         {
-            if ((dirPath / fileName).exists())
+            found = true;
+        }
+        else
+        {
+            const Path incompleteFilename = fileName + QB_EXT;
+            if (dirEntries.contains(normalizedFileName(incompleteFilename.filename())))
             {
                 found = true;
+                fileName = incompleteFilename;
             }
-            else
+            else if (forceAppendExt)
             {
-                const Path incompleteFilename = fileName + QB_EXT;
-                if ((dirPath / incompleteFilename).exists())
-                {
-                    found = true;
-                    fileName = incompleteFilename;
-                }
-                else if (forceAppendExt)
-                {
-                    fileName = incompleteFilename;
-                }
+                fileName = incompleteFilename;
             }
         }
-
-        return found;
     }
+
+    return found;
 }
 
-void FileSearcher::search(const PathList &originalFileNames, const Path &savePath
-        , const Path &downloadPath, const bool forceAppendExt, QPromise<FileSearchResult> &promise)
+QSet<QString> FileSearcher::listDirectory(const Path &dirPath)
 {
-    Path usedPath = savePath;
-    PathList adjustedFileNames = originalFileNames;
-    const bool found = findInDir(usedPath, adjustedFileNames, (forceAppendExt && downloadPath.isEmpty()));
-    if (!found && !downloadPath.isEmpty())
     {
-        usedPath = downloadPath;
-        findInDir(usedPath, adjustedFileNames, forceAppendExt);
+        const QMutexLocker locker {&m_cacheMutex};
+
+        if (m_cachePurgeTimer.hasExpired())
+        {
+            Algorithm::removeIf(m_directoryCache, [](const Path &, const DirectoryListing &listing)
+            {
+                return listing.expiration.hasExpired();
+            });
+            m_cachePurgeTimer.setRemainingTime(DIRECTORY_LISTING_LIFETIME);
+        }
+
+        if (const auto iter = m_directoryCache.constFind(dirPath);
+                (iter != m_directoryCache.cend()) && !iter->expiration.hasExpired())
+        {
+            return iter->entries;
+        }
     }
 
-    promise.addResult(FileSearchResult {.savePath = usedPath, .fileNames = adjustedFileNames});
+    // List the directory without holding the lock so that slow storage
+    // doesn't block searches in other directories
+    QSet<QString> entries;
+    const QStringList entryNames = QDir(dirPath.data()).entryList((QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot));
+    entries.reserve(entryNames.size());
+    for (const QString &entryName : entryNames)
+        entries.insert(normalizedFileName(entryName));
+
+    const QMutexLocker locker {&m_cacheMutex};
+    m_directoryCache.insert(dirPath, {.entries = entries, .expiration = QDeadlineTimer(DIRECTORY_LISTING_LIFETIME)});
+    return entries;
 }
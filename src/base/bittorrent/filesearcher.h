@@ -28,11 +28,17 @@
 
 #pragma once
 
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QMutex>
 #include <QObject>
+#include <QSet>
 
 #include "base/path.h"
 
-template <typename T> class QPromise;
+class QThreadPool;
+
+template <typename T> class QFuture;
 
 struct FileSearchResult
 {
@@ -46,8 +52,30 @@ class FileSearcher final : public QObject
     Q_DISABLE_COPY_MOVE(FileSearcher)
 
 public:
-    using QObject::QObject;
+    explicit FileSearcher(QObject *parent = nullptr);
+    ~FileSearcher() override;
+
+    QFuture<FileSearchResult> search(const PathList &originalFileNames, const Path &savePath
+            , const Path &downloadPath, bool forceAppendExt);
+
+private:
+    struct DirectoryListing
+    {
+        QSet<QString> entries;
+        QDeadlineTimer expiration;
+    };
+
+    FileSearchResult doSearch(const PathList &originalFileNames, const Path &savePath
+            , const Path &downloadPath, bool forceAppendExt);
+    bool findInDir(const Path &dirPath, PathList &fileNames, bool forceAppendExt);
+    QSet<QString> listDirectory(const Path &dirPath);
+
+    QThreadPool *m_threadPool = nullptr;
 
-    void search(const PathList &originalFileNames, const Path &savePath
-            , const Path &downloadPath, bool forceAppendExt, QPromise<FileSearchResult> &promise);
+    // Directories are listed at most once per expiration interval no matter
+    // how many torrents are searched in them, so bursts of added torrents
+    // don't issue a pair of `stat` calls for every single file
+    QMutex m_cacheMutex;
+    QHash<Path, DirectoryListing> m_directoryCache;
+    QDeadlineTimer m_cachePurgeTimer;
 };
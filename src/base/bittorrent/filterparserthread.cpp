@@ -28,413 +28,514 @@
 
 #include "filterparserthread.h"
 
+#include <algorithm>
+#include <array>
 #include <cctype>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string_view>
+#include <tuple>
+#include <vector>
 
 #include <libtorrent/error_code.hpp>
 
+#include <QCryptographicHash>
 #include <QDataStream>
 #include <QFile>
+#include <QFuture>
+#include <QPromise>
+#include <QThreadPool>
 
 #include "base/global.h"
 #include "base/logger.h"
+#include "base/profile.h"
+#include "base/utils/io.h"
+#include "base/utils/thread.h"
 
 namespace
 {
-    class IPv4Parser
+    const qsizetype MIN_CHUNK_SIZE = 1024 * 1024; // 1 MiB
+    const int MAX_LOGGED_ERRORS = 5;
+
+    enum class LineParseResult
+    {
+        Rule,
+        Skipped,
+        Malformed,
+        MalformedStartIP,
+        MalformedEndIP,
+        MixedIPVersions
+    };
+
+    struct IPv4Range
     {
-    public:
-        bool tryParse(const char *str)
+        quint32 first = 0;
+        quint32 last = 0;
+
+        friend bool operator<(const IPv4Range &left, const IPv4Range &right)
         {
-            unsigned char octetIndex = 0;
+            return (left.first < right.first);
+        }
+    };
 
-            const char *octetStart = str;
-            char *endptr = nullptr;
-            for (; *str; ++str)
-            {
-                if (*str == '.')
-                {
-                    const long int extractedNum = strtol(octetStart, &endptr, 10);
-                    if ((extractedNum >= 0L) && (extractedNum <= 255L))
-                        m_buf[octetIndex++] = static_cast<unsigned char>(extractedNum);
-                    else
-                        return false;
-
-                    if (endptr != str)
-                        return false;
-                    if (octetIndex == 4)
-                        return true;
-
-                    octetStart = str + 1;
-                }
-            }
+    struct IPv6Range
+    {
+        lt::address_v6::bytes_type first {};
+        lt::address_v6::bytes_type last {};
 
-            if (str != octetStart)
+        friend bool operator<(const IPv6Range &left, const IPv6Range &right)
+        {
+            return (left.first < right.first);
+        }
+    };
+
+    struct LineParseError
+    {
+        qsizetype line = 0;
+        LineParseResult result = LineParseResult::Malformed;
+    };
+
+    // Result of parsing a part of a text filter file, line numbers are relative to the part
+    struct ParsedChunk
+    {
+        std::vector<IPv4Range> v4Ranges;
+        std::vector<IPv6Range> v6Ranges;
+        std::vector<LineParseError> errors;
+        qsizetype errorCount = 0;
+        qsizetype lineCount = 0;
+    };
+
+    using LineParser = LineParseResult (*)(std::string_view line, ParsedChunk &chunk);
+
+    bool isSpace(const char c)
+    {
+        return (std::isspace(static_cast<unsigned char>(c)) != 0);
+    }
+
+    std::string_view trimmed(std::string_view str)
+    {
+        while (!str.empty() && isSpace(str.front()))
+            str.remove_prefix(1);
+        while (!str.empty() && isSpace(str.back()))
+            str.remove_suffix(1);
+        return str;
+    }
+
+    // Accepts octets with leading zeros (e.g. "001.009.096.105") that are common in filter files
+    bool parseIPv4Address(const std::string_view str, quint32 &address)
+    {
+        quint32 result = 0;
+        std::size_t pos = 0;
+        for (int octetIndex = 0; octetIndex < 4; ++octetIndex)
+        {
+            if ((octetIndex > 0) && ((pos >= str.size()) || (str[pos++] != '.')))
+                return false;
+
+            const std::size_t octetStart = pos;
+            quint32 octet = 0;
+            while ((pos < str.size()) && (str[pos] >= '0') && (str[pos] <= '9'))
             {
-                const long int extractedNum = strtol(octetStart, &endptr, 10);
-                if ((extractedNum >= 0L) && (extractedNum <= 255L))
-                    m_buf[octetIndex] = static_cast<unsigned char>(strtol(octetStart, &endptr, 10));
-                else
+                octet = (octet * 10) + static_cast<quint32>(str[pos++] - '0');
+                if (octet > 255)
                     return false;
-
-                if ((endptr == str) && (octetIndex == 3))
-                    return true;
             }
 
-            return false;
+            if (pos == octetStart)
+                return false;
+
+            result = (result << 8) | octet;
         }
 
-        lt::address_v4::bytes_type parsed() const
+        if (pos != str.size())
+            return false;
+
+        address = result;
+        return true;
+    }
+
+    bool parseIPAddress(const std::string_view str, lt::address &address)
+    {
+        if (quint32 v4Address = 0; parseIPv4Address(str, v4Address))
         {
-            return m_buf;
+            address = lt::address_v4(v4Address);
+            return true;
         }
 
-    private:
-        lt::address_v4::bytes_type m_buf {};
-    };
+        lt::error_code ec;
+        address = lt::make_address(std::string(str), ec);
+        return !ec;
+    }
 
-    bool parseIPAddress(const char *data, lt::address &address)
+    LineParseResult addRange(const std::string_view startStr, const std::string_view endStr, ParsedChunk &chunk)
     {
-        IPv4Parser parser;
-        lt::error_code ec;
+        quint32 v4Start = 0;
+        quint32 v4End = 0;
+        const bool isV4Start = parseIPv4Address(startStr, v4Start);
+        const bool isV4End = parseIPv4Address(endStr, v4End);
+        if (isV4Start && isV4End)
+        {
+            if (v4Start > v4End)
+                return LineParseResult::Malformed;
 
-        if (parser.tryParse(data))
-            address = lt::address_v4(parser.parsed());
-        else
-            address = lt::make_address(data, ec);
+            chunk.v4Ranges.push_back({.first = v4Start, .last = v4End});
+            return LineParseResult::Rule;
+        }
 
-        return !ec;
-    }
+        lt::address startAddr;
+        if (!parseIPAddress(startStr, startAddr))
+            return LineParseResult::MalformedStartIP;
 
-    const int BUFFER_SIZE = 2 * 1024 * 1024; // 2 MiB
-    const int MAX_LOGGED_ERRORS = 5;
-}
+        lt::address endAddr;
+        if (!parseIPAddress(endStr, endAddr))
+            return LineParseResult::MalformedEndIP;
 
-FilterParserThread::FilterParserThread(QObject *parent)
-    : QThread(parent)
-{
-}
+        if (startAddr.is_v4() != endAddr.is_v4())
+            return LineParseResult::MixedIPVersions;
 
-FilterParserThread::~FilterParserThread()
-{
-    m_abort = true;
-    wait();
-}
+        if (endAddr < startAddr)
+            return LineParseResult::Malformed;
 
-// Parser for eMule ip filter in DAT format
-int FilterParserThread::parseDATFilterFile()
-{
-    int ruleCount = 0;
-    QFile file {m_filePath.data()};
-    if (!file.exists()) return ruleCount;
+        if (startAddr.is_v4())
+            chunk.v4Ranges.push_back({.first = startAddr.to_v4().to_uint(), .last = endAddr.to_v4().to_uint()});
+        else
+            chunk.v6Ranges.push_back({.first = startAddr.to_v6().to_bytes(), .last = endAddr.to_v6().to_bytes()});
+        return LineParseResult::Rule;
+    }
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    bool isCommentLine(const std::string_view line)
     {
-        LogMsg(tr("I/O Error: Could not open IP filter file in read mode."), Log::CRITICAL);
-        return ruleCount;
+        return (line.starts_with('#') || line.starts_with("//"));
     }
 
-    std::vector<char> buffer(BUFFER_SIZE, 0); // seems a bit faster than QList
-    qint64 bytesRead = 0;
-    int offset = 0;
-    int start = 0;
-    int endOfLine = -1;
-    int nbLine = 0;
-    int parseErrorCount = 0;
-    const auto addLog = [&parseErrorCount](const QString &msg)
+    // eMule DAT format, each line should follow this format:
+    // 001.009.096.105 - 001.009.096.105 , 000 , Some organization
+    // The 2nd entry is access level and if above 127 the IP range isn't blocked.
+    LineParseResult parseDATLine(const std::string_view line, ParsedChunk &chunk)
     {
-        if (parseErrorCount <= MAX_LOGGED_ERRORS)
-            LogMsg(msg, Log::CRITICAL);
-    };
+        if (isCommentLine(line))
+            return LineParseResult::Skipped;
 
-    while (true)
+        std::string_view ipRange = line;
+        // Check if there is an access value (apparently not mandatory)
+        if (const std::size_t firstComma = line.find(','); firstComma != std::string_view::npos)
+        {
+            ipRange = line.substr(0, firstComma);
+
+            const std::string_view access = trimmed(line.substr((firstComma + 1), (line.find(',', (firstComma + 1)) - firstComma - 1)));
+            long nbAccess = 0;
+            std::from_chars(access.data(), (access.data() + access.size()), nbAccess);
+            // Ignoring this rule because access value is too high
+            if (nbAccess > 127L)
+                return LineParseResult::Skipped;
+        }
+
+        // IP Range should be split by a dash
+        const std::size_t delimIP = ipRange.find('-');
+        if (delimIP == std::string_view::npos)
+            return LineParseResult::Malformed;
+
+        return addRange(trimmed(ipRange.substr(0, delimIP)), trimmed(ipRange.substr(delimIP + 1)), chunk);
+    }
+
+    // PeerGuardian P2P format, each line should follow this format:
+    // Some organization:1.0.0.0-1.255.255.255
+    LineParseResult parseP2PLine(const std::string_view line, ParsedChunk &chunk)
     {
-        bytesRead = file.read(buffer.data() + offset, BUFFER_SIZE - offset - 1);
-        if (bytesRead < 0)
-            break;
-        const int dataSize = bytesRead + offset;
-        if ((bytesRead == 0) && (dataSize == 0))
-            break;
+        if (isCommentLine(line))
+            return LineParseResult::Skipped;
+
+        // The "Some organization" part might contain a ':' char itself so we find the last occurrence
+        const std::size_t partsDelimiter = line.rfind(':');
+        if (partsDelimiter == std::string_view::npos)
+            return LineParseResult::Malformed;
+
+        // IP Range should be split by a dash
+        const std::string_view ipRange = line.substr(partsDelimiter + 1);
+        const std::size_t delimIP = ipRange.find('-');
+        if (delimIP == std::string_view::npos)
+            return LineParseResult::Malformed;
+
+        return addRange(trimmed(ipRange.substr(0, delimIP)), trimmed(ipRange.substr(delimIP + 1)), chunk);
+    }
 
-        for (start = 0; start < dataSize; ++start)
+    // `std::string_view::find()` boils down to `memchr()`, which the C library implements with vector instructions,
+    // so lines are located without inspecting every byte in a loop of our own
+    ParsedChunk parseChunk(const std::string_view data, const LineParser lineParser, const bool &abort)
+    {
+        ParsedChunk chunk;
+        std::size_t start = 0;
+        while ((start < data.size()) && !abort)
         {
-            endOfLine = -1;
-            // The file might have ended without the last line having a newline
-            if (!((bytesRead == 0) && (dataSize > 0)))
-            {
-                for (int i = start; i < dataSize; ++i)
-                {
-                    if (buffer[i] == '\n')
-                    {
-                        endOfLine = i;
-                        // We need to NULL the newline in case the line has only an IP range.
-                        // In that case the parser won't work for the end IP, because it ends
-                        // with the newline and not with a number.
-                        buffer[i] = '\0';
-                        break;
-                    }
-                }
-            }
-            else
-            {
-                endOfLine = dataSize;
-                buffer[dataSize] = '\0';
-            }
+            std::size_t endOfLine = data.find('\n', start);
+            if (endOfLine == std::string_view::npos)
+                endOfLine = data.size();
 
-            if (endOfLine == -1)
-            {
-                // read the next chunk from file
-                // but first move(copy) the leftover data to the front of the buffer
-                offset = dataSize - start;
-                memmove(buffer.data(), buffer.data() + start, offset);
-                break;
-            }
+            const std::string_view line = data.substr(start, (endOfLine - start));
+            start = endOfLine + 1;
+            ++chunk.lineCount;
 
-            ++nbLine;
+            if (trimmed(line).empty())
+                continue;
 
-            if ((buffer[start] == '#')
-                || ((buffer[start] == '/') && ((start + 1 < dataSize) && (buffer[start + 1] == '/'))))
-                {
-                start = endOfLine;
+            const LineParseResult result = lineParser(line, chunk);
+            if ((result == LineParseResult::Rule) || (result == LineParseResult::Skipped))
                 continue;
-            }
 
-            // Each line should follow this format:
-            // 001.009.096.105 - 001.009.096.105 , 000 , Some organization
-            // The 3rd entry is access level and if above 127 the IP range isn't blocked.
-            const int firstComma = findAndNullDelimiter(buffer.data(), ',', start, endOfLine);
-            if (firstComma != -1)
-                findAndNullDelimiter(buffer.data(), ',', firstComma + 1, endOfLine);
+            ++chunk.errorCount;
+            if (chunk.errors.size() < static_cast<std::size_t>(MAX_LOGGED_ERRORS))
+                chunk.errors.push_back({.line = chunk.lineCount, .result = result});
+        }
 
-            // Check if there is an access value (apparently not mandatory)
-            if (firstComma != -1)
-            {
-                // There is possibly one
-                const long int nbAccess = strtol(buffer.data() + firstComma + 1, nullptr, 10);
-                // Ignoring this rule because access value is too high
-                if (nbAccess > 127L)
-                {
-                    start = endOfLine;
-                    continue;
-                }
-            }
+        return chunk;
+    }
 
-            // IP Range should be split by a dash
-            const int endOfIPRange = ((firstComma == -1) ? (endOfLine - 1) : (firstComma - 1));
-            const int delimIP = findAndNullDelimiter(buffer.data(), '-', start, endOfIPRange);
-            if (delimIP == -1)
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+    // Splits data into parts of approximately the same size, each part ends at a line boundary
+    std::vector<std::string_view> splitIntoChunks(const std::string_view data, const std::size_t chunkCount)
+    {
+        std::vector<std::string_view> chunks;
+        chunks.reserve(chunkCount);
 
-            lt::address startAddr;
-            int newStart = trim(buffer.data(), start, delimIP - 1);
-            if (!parseIPAddress(buffer.data() + newStart, startAddr))
+        const std::size_t chunkSize = data.size() / chunkCount;
+        std::size_t start = 0;
+        while (start < data.size())
+        {
+            std::size_t end = data.size();
+            if ((chunks.size() + 1) < chunkCount)
             {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. Start IP of the range is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
+                const std::size_t endOfLine = data.find('\n', std::min((start + chunkSize), data.size()));
+                if (endOfLine != std::string_view::npos)
+                    end = endOfLine + 1;
             }
 
-            lt::address endAddr;
-            newStart = trim(buffer.data(), delimIP + 1, endOfIPRange);
-            if (!parseIPAddress(buffer.data() + newStart, endAddr))
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. End IP of the range is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+            chunks.push_back(data.substr(start, (end - start)));
+            start = end;
+        }
 
-            if ((startAddr.is_v4() != endAddr.is_v4())
-                || (startAddr.is_v6() != endAddr.is_v6()))
-                {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. One IP is IPv4 and the other is IPv6!").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+        return chunks;
+    }
 
-            start = endOfLine;
+    // Sorts ranges and merges the overlapping ones, which keeps building the filter cheap
+    template <typename Range, typename AreMergeable>
+    void mergeRanges(std::vector<Range> &ranges, const AreMergeable &areMergeable)
+    {
+        if (ranges.empty())
+            return;
 
-            // Now Add to the filter
-            try
+        std::sort(ranges.begin(), ranges.end());
+
+        auto merged = ranges.begin();
+        for (auto it = std::next(ranges.begin()); it != ranges.end(); ++it)
+        {
+            if (areMergeable(*merged, *it))
             {
-                m_filter.add_rule(startAddr, endAddr, lt::ip_filter::blocked);
-                ++ruleCount;
+                merged->last = std::max(merged->last, it->last);
             }
-            catch (const std::exception &e)
+            else
             {
-                ++parseErrorCount;
-                addLog(tr("IP filter exception thrown for line %1. Exception is: %2")
-                       .arg(nbLine).arg(QString::fromLocal8Bit(e.what())));
+                ++merged;
+                *merged = *it;
             }
         }
-
-        if (start >= dataSize)
-            offset = 0;
+        ranges.erase(std::next(merged), ranges.end());
     }
 
-    if (parseErrorCount > MAX_LOGGED_ERRORS)
-        LogMsg(tr("%1 extra IP filter parsing errors occurred.", "513 extra IP filter parsing errors occurred.")
-               .arg(parseErrorCount - MAX_LOGGED_ERRORS), Log::CRITICAL);
-    return ruleCount;
-}
+    // The cache stores the merged ranges of the parsed filter in native byte order,
+    // so it can be applied directly from the mapped file.
+    // It is only valid for the machine that created it, `CACHE_MAGIC` also guards against byte order changes.
+    const quint32 CACHE_MAGIC = 0x46504251; // "QBPF"
+    const quint32 CACHE_VERSION = 1;
+    const Path CACHE_FILE_NAME {u"ipfilter.cache"_s};
 
-// Parser for PeerGuardian ip filter in p2p format
-int FilterParserThread::parseP2PFilterFile()
-{
-    int ruleCount = 0;
-    QFile file {m_filePath.data()};
-    if (!file.exists()) return ruleCount;
+    struct CacheHeader
+    {
+        quint32 magic = CACHE_MAGIC;
+        quint32 version = CACHE_VERSION;
+        std::array<char, 20> sourceHash {};
+        qint32 ruleCount = 0;
+        quint64 v4RangeCount = 0;
+        quint64 v6RangeCount = 0;
+    };
 
-    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    struct CachedV4Range
     {
-        LogMsg(tr("I/O Error: Could not open IP filter file in read mode."), Log::CRITICAL);
-        return ruleCount;
-    }
+        quint32 first = 0;
+        quint32 last = 0;
+        quint32 flags = 0;
+    };
 
-    std::vector<char> buffer(BUFFER_SIZE, 0); // seems a bit faster than QList
-    qint64 bytesRead = 0;
-    int offset = 0;
-    int start = 0;
-    int endOfLine = -1;
-    int nbLine = 0;
-    int parseErrorCount = 0;
-    const auto addLog = [&parseErrorCount](const QString &msg)
+    struct CachedV6Range
     {
-        if (parseErrorCount <= MAX_LOGGED_ERRORS)
-            LogMsg(msg, Log::CRITICAL);
+        lt::address_v6::bytes_type first {};
+        lt::address_v6::bytes_type last {};
+        quint32 flags = 0;
     };
 
-    while (true)
+    static_assert(sizeof(CacheHeader) == 48);
+    static_assert(sizeof(CachedV4Range) == 12);
+    static_assert(sizeof(CachedV6Range) == 36);
+
+    template <typename T>
+    T readCacheRecord(const uchar *data, const qsizetype index)
     {
-        bytesRead = file.read(buffer.data() + offset, BUFFER_SIZE - offset - 1);
-        if (bytesRead < 0)
-            break;
-        const int dataSize = bytesRead + offset;
-        if ((bytesRead == 0) && (dataSize == 0))
-            break;
+        T record;
+        std::memcpy(&record, (data + (index * sizeof(T))), sizeof(T));
+        return record;
+    }
 
-        for (start = 0; start < dataSize; ++start)
-        {
-            endOfLine = -1;
-            // The file might have ended without the last line having a newline
-            if (!((bytesRead == 0) && (dataSize > 0)))
-            {
-                for (int i = start; i < dataSize; ++i)
-                {
-                    if (buffer[i] == '\n')
-                    {
-                        endOfLine = i;
-                        // We need to NULL the newline in case the line has only an IP range.
-                        // In that case the parser won't work for the end IP, because it ends
-                        // with the newline and not with a number.
-                        buffer[i] = '\0';
-                        break;
-                    }
-                }
-            }
-            else
-            {
-                endOfLine = dataSize;
-                buffer[dataSize] = '\0';
-            }
+    template <typename T>
+    void writeCacheRecord(QByteArray &data, const T &record)
+    {
+        data.append(reinterpret_cast<const char *>(&record), sizeof(T));
+    }
+}
 
-            if (endOfLine == -1)
-            {
-                // read the next chunk from file
-                // but first move(copy) the leftover data to the front of the buffer
-                offset = dataSize - start;
-                memmove(buffer.data(), buffer.data() + start, offset);
-                break;
-            }
+FilterParserThread::FilterParserThread(QObject *parent)
+    : QThread(parent)
+{
+}
 
-            ++nbLine;
+FilterParserThread::~FilterParserThread()
+{
+    m_abort = true;
+    wait();
+}
 
-            if ((buffer[start] == '#')
-                || ((buffer[start] == '/') && ((start + 1 < dataSize) && (buffer[start + 1] == '/'))))
-                {
-                start = endOfLine;
-                continue;
-            }
+// Parser for text formats (eMule DAT and PeerGuardian P2P)
+// The file is split on line boundaries into parts that are parsed in parallel,
+// then the collected ranges are merged before they are added to the filter.
+int FilterParserThread::parseTextFilterFile(const TextFormat format)
+{
+    QFile file {m_filePath.data()};
+    if (!file.exists()) return 0;
 
-            // Each line should follow this format:
-            // Some organization:1.0.0.0-1.255.255.255
-            // The "Some organization" part might contain a ':' char itself so we find the last occurrence
-            const int partsDelimiter = findAndNullDelimiter(buffer.data(), ':', start, endOfLine, true);
-            if (partsDelimiter == -1)
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LogMsg(tr("I/O Error: Could not open IP filter file in read mode."), Log::CRITICAL);
+        return 0;
+    }
 
-            // IP Range should be split by a dash
-            const int delimIP = findAndNullDelimiter(buffer.data(), '-', partsDelimiter + 1, endOfLine);
-            if (delimIP == -1)
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+    const qint64 fileSize = file.size();
+    if (fileSize <= 0) return 0;
 
-            lt::address startAddr;
-            int newStart = trim(buffer.data(), partsDelimiter + 1, delimIP - 1);
-            if (!parseIPAddress(buffer.data() + newStart, startAddr))
-            {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. Start IP of the range is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+    QByteArray buffer;
+    std::string_view data;
+    if (const uchar *mappedData = file.map(0, fileSize))
+    {
+        data = {reinterpret_cast<const char *>(mappedData), static_cast<std::size_t>(fileSize)};
+    }
+    else
+    {
+        buffer = file.readAll();
+        data = {buffer.constData(), static_cast<std::size_t>(buffer.size())};
+    }
+
+    const LineParser lineParser = ((format == TextFormat::DAT) ? parseDATLine : parseP2PLine);
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    const qsizetype chunkCount = std::clamp<qsizetype>((fileSize / MIN_CHUNK_SIZE), 1, std::max(threadPool->maxThreadCount(), 1));
 
-            lt::address endAddr;
-            newStart = trim(buffer.data(), delimIP + 1, endOfLine);
-            if (!parseIPAddress(buffer.data() + newStart, endAddr))
+    std::vector<ParsedChunk> parsedChunks;
+    parsedChunks.reserve(chunkCount);
+    if (chunkCount == 1)
+    {
+        parsedChunks.push_back(parseChunk(data, lineParser, m_abort));
+    }
+    else
+    {
+        std::vector<QFuture<ParsedChunk>> jobs;
+        jobs.reserve(chunkCount);
+        for (const std::string_view chunk : splitIntoChunks(data, static_cast<std::size_t>(chunkCount)))
+        {
+            auto promise = std::make_shared<QPromise<ParsedChunk>>();
+            jobs.push_back(promise->future());
+            promise->start();
+            threadPool->start([this, promise, chunk, lineParser]
             {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. End IP of the range is malformed.").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+                promise->addResult(parseChunk(chunk, lineParser, m_abort));
+                promise->finish();
+            });
+        }
 
-            if ((startAddr.is_v4() != endAddr.is_v4())
-                || (startAddr.is_v6() != endAddr.is_v6()))
-                {
-                ++parseErrorCount;
-                addLog(tr("IP filter line %1 is malformed. One IP is IPv4 and the other is IPv6!").arg(nbLine));
-                start = endOfLine;
-                continue;
-            }
+        // Parsed data refers to the mapped file, so all jobs must be finished before it is unmapped
+        for (QFuture<ParsedChunk> &job : jobs)
+        {
+            job.waitForFinished();
+            parsedChunks.push_back(job.takeResult());
+        }
+    }
 
-            start = endOfLine;
+    if (m_abort) return 0;
 
-            try
-            {
-                m_filter.add_rule(startAddr, endAddr, lt::ip_filter::blocked);
-                ++ruleCount;
-            }
-            catch (const std::exception &e)
+    int ruleCount = 0;
+    qsizetype parseErrorCount = 0;
+    int loggedErrorCount = 0;
+    qsizetype lineOffset = 0;
+    std::vector<IPv4Range> v4Ranges;
+    std::vector<IPv6Range> v6Ranges;
+    for (ParsedChunk &chunk : parsedChunks)
+    {
+        for (const LineParseError &error : chunk.errors)
+        {
+            if (loggedErrorCount >= MAX_LOGGED_ERRORS)
+                break;
+            ++loggedErrorCount;
+
+            const qsizetype nbLine = lineOffset + error.line;
+            switch (error.result)
             {
-                ++parseErrorCount;
-                addLog(tr("IP filter exception thrown for line %1. Exception is: %2")
-                       .arg(nbLine).arg(QString::fromLocal8Bit(e.what())));
+            case LineParseResult::MalformedStartIP:
+                LogMsg(tr("IP filter line %1 is malformed. Start IP of the range is malformed.").arg(nbLine), Log::CRITICAL);
+                break;
+            case LineParseResult::MalformedEndIP:
+                LogMsg(tr("IP filter line %1 is malformed. End IP of the range is malformed.").arg(nbLine), Log::CRITICAL);
+                break;
+            case LineParseResult::MixedIPVersions:
+                LogMsg(tr("IP filter line %1 is malformed. One IP is IPv4 and the other is IPv6!").arg(nbLine), Log::CRITICAL);
+                break;
+            default:
+                LogMsg(tr("IP filter line %1 is malformed.").arg(nbLine), Log::CRITICAL);
+                break;
             }
         }
 
-        if (start >= dataSize)
-            offset = 0;
+        parseErrorCount += chunk.errorCount;
+        lineOffset += chunk.lineCount;
+        ruleCount += static_cast<int>(chunk.v4Ranges.size() + chunk.v6Ranges.size());
+
+        v4Ranges.insert(v4Ranges.end(), chunk.v4Ranges.cbegin(), chunk.v4Ranges.cend());
+        v6Ranges.insert(v6Ranges.end(), chunk.v6Ranges.cbegin(), chunk.v6Ranges.cend());
+        chunk = {};
     }
 
     if (parseErrorCount > MAX_LOGGED_ERRORS)
+    {
         LogMsg(tr("%1 extra IP filter parsing errors occurred.", "513 extra IP filter parsing errors occurred.")
                .arg(parseErrorCount - MAX_LOGGED_ERRORS), Log::CRITICAL);
+    }
+
+    // Adjacent IPv4 ranges are merged as well
+    mergeRanges(v4Ranges, [](const IPv4Range &merged, const IPv4Range &range)
+    {
+        return ((merged.last == std::numeric_limits<quint32>::max()) || (range.first <= (merged.last + 1)));
+    });
+    mergeRanges(v6Ranges, [](const IPv6Range &merged, const IPv6Range &range)
+    {
+        return (range.first <= merged.last);
+    });
+
+    try
+    {
+        for (const IPv4Range &range : v4Ranges)
+            m_filter.add_rule(lt::address_v4(range.first), lt::address_v4(range.last), lt::ip_filter::blocked);
+        for (const IPv6Range &range : v6Ranges)
+            m_filter.add_rule(lt::address_v6(range.first), lt::address_v6(range.last), lt::ip_filter::blocked);
+    }
+    catch (const std::exception &e)
+    {
+        LogMsg(tr("IP filter exception thrown. Exception is: %1").arg(QString::fromLocal8Bit(e.what())), Log::CRITICAL);
+    }
+
     return ruleCount;
 }
 
@@ -603,6 +704,7 @@ void FilterParserThread::processFilterFile(const Path &filePath)
 
     m_abort = false;
     m_filePath = filePath;
+    m_cacheFilePath = specialFolderLocation(SpecialFolder::Cache) / CACHE_FILE_NAME;
     m_filter = lt::ip_filter();
     // Run it
     start();
@@ -615,22 +717,39 @@ lt::ip_filter FilterParserThread::IPfilter()
 
 void FilterParserThread::run()
 {
+    Utils::Thread::applyWorkload(Utils::Thread::Workload::Bulk);
+
     qDebug("Processing filter file");
+    const QByteArray sourceHash = calculateSourceHash();
+    if (m_abort) return;
+
     int ruleCount = 0;
-    if (m_filePath.hasExtension(u".p2p"_s))
+    if (const std::optional<int> cachedRuleCount = (!sourceHash.isEmpty() ? loadCachedFilter(sourceHash) : std::nullopt))
     {
-        // PeerGuardian p2p file
-        ruleCount = parseP2PFilterFile();
+        ruleCount = *cachedRuleCount;
     }
-    else if (m_filePath.hasExtension(u".p2b"_s))
-    {
-        // PeerGuardian p2b file
-        ruleCount = parseP2BFilterFile();
-    }
-    else if (m_filePath.hasExtension(u".dat"_s))
+    else
     {
-        // eMule DAT format
-        ruleCount = parseDATFilterFile();
+        if (m_abort) return;
+
+        if (m_filePath.hasExtension(u".p2p"_s))
+        {
+            // PeerGuardian p2p file
+            ruleCount = parseTextFilterFile(TextFormat::P2P);
+        }
+        else if (m_filePath.hasExtension(u".p2b"_s))
+        {
+            // PeerGuardian p2b file
+            ruleCount = parseP2BFilterFile();
+        }
+        else if (m_filePath.hasExtension(u".dat"_s))
+        {
+            // eMule DAT format
+            ruleCount = parseTextFilterFile(TextFormat::DAT);
+        }
+
+        if (!m_abort && !sourceHash.isEmpty() && (ruleCount > 0))
+            storeCachedFilter(sourceHash, ruleCount);
     }
 
     if (m_abort) return;
@@ -647,59 +766,112 @@ void FilterParserThread::run()
     qDebug("IP Filter thread: finished parsing, filter applied");
 }
 
-int FilterParserThread::findAndNullDelimiter(char *const data, const char delimiter, const int start, const int end, const bool reverse)
+// The hash covers the file format too, since the same content is parsed differently depending on it
+QByteArray FilterParserThread::calculateSourceHash() const
 {
-    if (!reverse)
+    QFile file {m_filePath.data()};
+    if (!file.open(QIODevice::ReadOnly))
+        return {};
+
+    QCryptographicHash hash {QCryptographicHash::Sha1};
+    hash.addData(m_filePath.extension().toLower().toUtf8());
+    if (!hash.addData(&file))
+        return {};
+
+    return hash.result();
+}
+
+std::optional<int> FilterParserThread::loadCachedFilter(const QByteArray &sourceHash)
+{
+    QFile file {m_cacheFilePath.data()};
+    if (!file.open(QIODevice::ReadOnly))
+        return std::nullopt;
+
+    const qint64 fileSize = file.size();
+    if (fileSize < static_cast<qint64>(sizeof(CacheHeader)))
+        return std::nullopt;
+
+    const uchar *data = file.map(0, fileSize);
+    if (!data)
+        return std::nullopt;
+
+    CacheHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if ((header.magic != CACHE_MAGIC) || (header.version != CACHE_VERSION)
+        || (QByteArray::fromRawData(header.sourceHash.data(), header.sourceHash.size()) != sourceHash))
     {
-        for (int i = start; i <= end; ++i)
-        {
-            if (data[i] == delimiter)
-            {
-                data[i] = '\0';
-                return i;
-            }
-        }
+        return std::nullopt;
     }
-    else
+
+    const quint64 expectedSize = sizeof(CacheHeader) + (header.v4RangeCount * sizeof(CachedV4Range))
+        + (header.v6RangeCount * sizeof(CachedV6Range));
+    if (expectedSize != static_cast<quint64>(fileSize))
+        return std::nullopt;
+
+    lt::ip_filter filter;
+    try
     {
-        for (int i = end; i >= start; --i)
+        const uchar *v4Data = data + sizeof(CacheHeader);
+        for (quint64 i = 0; i < header.v4RangeCount; ++i)
         {
-            if (data[i] == delimiter)
-            {
-                data[i] = '\0';
-                return i;
-            }
+            if (m_abort) return std::nullopt;
+
+            const auto range = readCacheRecord<CachedV4Range>(v4Data, i);
+            filter.add_rule(lt::address_v4(range.first), lt::address_v4(range.last), range.flags);
+        }
+
+        const uchar *v6Data = v4Data + (header.v4RangeCount * sizeof(CachedV4Range));
+        for (quint64 i = 0; i < header.v6RangeCount; ++i)
+        {
+            if (m_abort) return std::nullopt;
+
+            const auto range = readCacheRecord<CachedV6Range>(v6Data, i);
+            filter.add_rule(lt::address_v6(range.first), lt::address_v6(range.last), range.flags);
         }
     }
+    catch (const std::exception &)
+    {
+        return std::nullopt;
+    }
 
-    return -1;
+    m_filter = filter;
+    return header.ruleCount;
 }
 
-int FilterParserThread::trim(char *const data, const int start, const int end)
+void FilterParserThread::storeCachedFilter(const QByteArray &sourceHash, const int ruleCount) const
 {
-    if (start >= end) return start;
-    int newStart = start;
+    const auto [v4Ranges, v6Ranges] = m_filter.export_filter();
+
+    CacheHeader header;
+    std::memcpy(header.sourceHash.data(), sourceHash.constData(), header.sourceHash.size());
+    header.ruleCount = ruleCount;
 
-    for (int i = start; i <= end; ++i)
+    QByteArray data;
+    data.reserve(sizeof(CacheHeader) + (v4Ranges.size() * sizeof(CachedV4Range)) + (v6Ranges.size() * sizeof(CachedV6Range)));
+    data.append(static_cast<qsizetype>(sizeof(CacheHeader)), '\0');
+
+    // Skip ranges with the default access, the filter allows everything that isn't covered by a rule
+    for (const lt::ip_range<lt::address_v4> &range : v4Ranges)
     {
-        if (isspace(data[i]) != 0)
-        {
-            data[i] = '\0';
-        }
-        else
-        {
-            newStart = i;
-            break;
-        }
+        if (range.flags == 0)
+            continue;
+
+        writeCacheRecord(data, CachedV4Range {.first = range.first.to_uint(), .last = range.last.to_uint(), .flags = range.flags});
+        ++header.v4RangeCount;
     }
 
-    for (int i = end; i >= start; --i)
+    for (const lt::ip_range<lt::address_v6> &range : v6Ranges)
     {
-        if (isspace(data[i]) != 0)
-            data[i] = '\0';
-        else
-            break;
+        if (range.flags == 0)
+            continue;
+
+        writeCacheRecord(data, CachedV6Range {.first = range.first.to_bytes(), .last = range.last.to_bytes(), .flags = range.flags});
+        ++header.v6RangeCount;
     }
 
-    return newStart;
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(m_cacheFilePath, data);
+    if (!result)
+        LogMsg(tr("Failed to save IP filter cache. File: \"%1\". Error: \"%2\"").arg(m_cacheFilePath.toString(), result.error()), Log::WARNING);
 }
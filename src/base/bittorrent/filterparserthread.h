@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <optional>
+
 #include <libtorrent/ip_filter.hpp>
 
 #include <QThread>
@@ -55,14 +57,22 @@ protected:
     void run() override;
 
 private:
-    int findAndNullDelimiter(char *data, char delimiter, int start, int end, bool reverse = false);
-    int trim(char *data, int start, int end);
-    int parseDATFilterFile();
-    int parseP2PFilterFile();
+    enum class TextFormat
+    {
+        DAT,
+        P2P
+    };
+
+    QByteArray calculateSourceHash() const;
+    std::optional<int> loadCachedFilter(const QByteArray &sourceHash);
+    void storeCachedFilter(const QByteArray &sourceHash, int ruleCount) const;
+
+    int parseTextFilterFile(TextFormat format);
     int getlineInStream(QDataStream &stream, std::string &name, char delim);
     int parseP2BFilterFile();
 
     bool m_abort = false;
     Path m_filePath;
+    Path m_cacheFilePath;
     lt::ip_filter m_filter;
 };
@@ -0,0 +1,387 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "iouringreader.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <boost/asio/post.hpp>
+
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+
+#include "base/global.h"
+
+namespace
+{
+    const unsigned int QUEUE_DEPTH = 256;
+    const int BUFFER_COUNT = 512;
+    const int BUFFER_SIZE = lt::default_block_size;
+    // Blocks spanning more files are read the usual way
+    const int MAX_READ_OPERATIONS = 16;
+}
+
+IOUringReader::FileHandle::FileHandle(const int fd)
+    : fd {fd}
+{
+}
+
+IOUringReader::FileHandle::~FileHandle()
+{
+    ::close(fd);
+}
+
+std::unique_ptr<IOUringReader> IOUringReader::create(lt::io_context &ioContext, const lt::settings_interface &settings)
+{
+    std::unique_ptr<IOUringReader> reader {new IOUringReader(ioContext, settings)};
+    if (!reader->initialize())
+        return nullptr;
+
+    return reader;
+}
+
+IOUringReader::IOUringReader(lt::io_context &ioContext, const lt::settings_interface &settings)
+    : m_ioContext {ioContext}
+    , m_settings {settings}
+{
+}
+
+IOUringReader::~IOUringReader()
+{
+    if (!m_isInitialized)
+        return;
+
+    waitForDone();
+
+    // The empty operation with no data tells the completion thread to stop
+    // (the submission queue can only run out of entries if the thread is already
+    // stopped because waiting for the completions failed)
+    if (io_uring_sqe *sqe = io_uring_get_sqe(&m_ring))
+    {
+        io_uring_prep_nop(sqe);
+        io_uring_sqe_set_data(sqe, nullptr);
+        io_uring_submit(&m_ring);
+    }
+    m_completionThread->wait();
+
+    io_uring_queue_exit(&m_ring);
+}
+
+bool IOUringReader::initialize()
+{
+    if (io_uring_queue_init(QUEUE_DEPTH, &m_ring, 0) < 0)
+        return false;
+
+    // IORING_OP_READ is available since Linux 5.6
+    io_uring_probe *probe = io_uring_get_probe_ring(&m_ring);
+    const bool isReadSupported = probe && io_uring_opcode_supported(probe, IORING_OP_READ);
+    io_uring_free_probe(probe);
+    if (!isReadSupported)
+    {
+        io_uring_queue_exit(&m_ring);
+        return false;
+    }
+
+    m_buffers.reset(new char[BUFFER_COUNT * BUFFER_SIZE]);
+    m_freeBuffers.reserve(BUFFER_COUNT);
+    for (int i = (BUFFER_COUNT - 1); i >= 0; --i)
+        m_freeBuffers.append(m_buffers.get() + (i * BUFFER_SIZE));
+
+    // Registration can fail if the process isn't allowed to lock that much memory,
+    // reading into unregistered buffers is a bit slower but works as well
+    const iovec bufferPool {m_buffers.get(), static_cast<std::size_t>(BUFFER_COUNT * BUFFER_SIZE)};
+    m_hasRegisteredBuffers = (io_uring_register_buffers(&m_ring, &bufferPool, 1) == 0);
+
+    m_completionThread.reset(QThread::create([this] { processCompletions(); }));
+    m_completionThread->setObjectName("IOUringReader m_completionThread");
+    m_completionThread->start();
+
+    m_isInitialized = true;
+    return true;
+}
+
+bool IOUringReader::read(const lt::storage_index_t storage, const lt::file_storage &files
+        , const lt::aux::vector<lt::download_priority_t, lt::file_index_t> &filePriorities, const Path &savePath
+        , const lt::peer_request &peerRequest, ReadHandler handler, FailureHandler failureHandler)
+{
+    if ((peerRequest.length <= 0) || (peerRequest.length > BUFFER_SIZE))
+        return false;
+
+    const std::vector<lt::file_slice> slices = files.map_block(peerRequest.piece, peerRequest.start, peerRequest.length);
+    if (slices.empty() || (slices.size() > MAX_READ_OPERATIONS))
+        return false;
+
+    std::vector<std::shared_ptr<FileHandle>> fileHandles;
+    fileHandles.reserve(slices.size());
+    for (const lt::file_slice &slice : slices)
+    {
+        if (files.pad_file_at(slice.file_index))
+        {
+            fileHandles.push_back(nullptr);
+            continue;
+        }
+
+        // the data of files that have priority 0 can be stored in the part file
+        if ((filePriorities.end_index() > slice.file_index) && (filePriorities[slice.file_index] == lt::dont_download))
+            return false;
+
+        std::shared_ptr<FileHandle> fileHandle = openFile(storage, slice.file_index, (savePath / Path(files.file_path(slice.file_index))));
+        if (!fileHandle)
+            return false;
+
+        fileHandles.push_back(std::move(fileHandle));
+    }
+
+    const auto requiredSQECount = static_cast<unsigned int>(std::count_if(fileHandles.cbegin(), fileHandles.cend()
+            , [](const std::shared_ptr<FileHandle> &fileHandle) { return static_cast<bool>(fileHandle); }));
+    if (io_uring_sq_space_left(&m_ring) < requiredSQECount)
+    {
+        submit();
+        if (io_uring_sq_space_left(&m_ring) < requiredSQECount)
+            return false;
+    }
+
+    char *buffer = allocateBuffer();
+    if (!buffer)
+        return false;
+
+    auto *job = new ReadJob;
+    job->handler = std::move(handler);
+    job->failureHandler = std::move(failureHandler);
+    job->buffer = buffer;
+    job->length = peerRequest.length;
+    job->pendingCount = static_cast<int>(requiredSQECount);
+    job->operations.reserve(requiredSQECount);
+
+    if (requiredSQECount == 0)
+    {
+        std::memset(buffer, 0, peerRequest.length);
+        finishJob(job);
+        return true;
+    }
+
+    qint64 bufferOffset = 0;
+    for (std::size_t i = 0; i < slices.size(); ++i)
+    {
+        const lt::file_slice &slice = slices[i];
+        char *sliceBuffer = buffer + bufferOffset;
+        const auto sliceSize = static_cast<int>(slice.size);
+        bufferOffset += slice.size;
+
+        const std::shared_ptr<FileHandle> &fileHandle = fileHandles[i];
+        if (!fileHandle)
+        {
+            std::memset(sliceBuffer, 0, sliceSize);
+            continue;
+        }
+
+        // the storage is reserved in advance so the operations aren't relocated
+        job->operations.push_back({job, sliceSize});
+        ReadOperation &operation = job->operations.back();
+        io_uring_sqe *sqe = io_uring_get_sqe(&m_ring);
+        if (m_hasRegisteredBuffers)
+            io_uring_prep_read_fixed(sqe, fileHandle->fd, sliceBuffer, sliceSize, slice.offset, 0);
+        else
+            io_uring_prep_read(sqe, fileHandle->fd, sliceBuffer, sliceSize, slice.offset);
+        io_uring_sqe_set_data(sqe, &operation);
+    }
+
+    job->files = std::move(fileHandles);
+
+    {
+        const QMutexLocker locker {&m_jobsMutex};
+        // the queued operations are never submitted once the completion thread is stopped
+        if (m_isRingFailed)
+        {
+            free_disk_buffer(buffer);
+            delete job;
+            return false;
+        }
+
+        m_pendingJobs.insert(job);
+    }
+
+    m_hasQueuedReads = true;
+    return true;
+}
+
+void IOUringReader::submit()
+{
+    if (!m_hasQueuedReads)
+        return;
+
+    m_hasQueuedReads = false;
+    io_uring_submit(&m_ring);
+}
+
+void IOUringReader::waitForDone()
+{
+    submit();
+
+    QMutexLocker locker {&m_jobsMutex};
+    while (!m_pendingJobs.isEmpty())
+        m_jobsFinished.wait(&m_jobsMutex);
+}
+
+void IOUringReader::closeFiles(const lt::storage_index_t storage)
+{
+    const auto iter = m_files.find(storage);
+    if (iter == m_files.end())
+        return;
+
+    // files are actually closed when the pending reads don't need them anymore
+    for (const OpenFile &openFile : asConst(*iter))
+        m_filesLRU.erase(openFile.lruIter);
+    m_files.erase(iter);
+}
+
+void IOUringReader::free_disk_buffer(char *buffer)
+{
+    const QMutexLocker locker {&m_buffersMutex};
+    m_freeBuffers.append(buffer);
+}
+
+void IOUringReader::processCompletions()
+{
+    while (true)
+    {
+        io_uring_cqe *cqe = nullptr;
+        const int ret = io_uring_wait_cqe(&m_ring, &cqe);
+        if (ret == -EINTR)
+            continue;
+        if (ret < 0)
+        {
+            failPendingJobs();
+            return;
+        }
+
+        auto *operation = static_cast<ReadOperation *>(io_uring_cqe_get_data(cqe));
+        const int result = cqe->res;
+        io_uring_cqe_seen(&m_ring, cqe);
+
+        if (!operation)
+            return;
+
+        ReadJob *job = operation->job;
+        // short read means that the file is shorter than expected in which case
+        // the usual read reports the error properly
+        if (result != operation->size)
+            job->isFailed = true;
+
+        if (--job->pendingCount == 0)
+            finishJob(job);
+    }
+}
+
+void IOUringReader::finishJob(ReadJob *job)
+{
+    if (job->isFailed)
+    {
+        free_disk_buffer(job->buffer);
+        boost::asio::post(m_ioContext, std::move(job->failureHandler));
+    }
+    else
+    {
+        boost::asio::post(m_ioContext, [handler = std::move(job->handler)
+                , bufferHolder = lt::disk_buffer_holder(*this, job->buffer, job->length)]() mutable
+        {
+            handler(std::move(bufferHolder));
+        });
+    }
+
+    const QMutexLocker locker {&m_jobsMutex};
+    m_pendingJobs.remove(job);
+    delete job;
+    if (m_pendingJobs.isEmpty())
+        m_jobsFinished.wakeAll();
+}
+
+void IOUringReader::failPendingJobs()
+{
+    const QMutexLocker locker {&m_jobsMutex};
+    m_isRingFailed = true;
+
+    for (ReadJob *job : asConst(m_pendingJobs))
+    {
+        // the buffer isn't reused since the kernel may still write to it
+        boost::asio::post(m_ioContext, std::move(job->failureHandler));
+        delete job;
+    }
+    m_pendingJobs.clear();
+    m_jobsFinished.wakeAll();
+}
+
+std::shared_ptr<IOUringReader::FileHandle> IOUringReader::openFile(const lt::storage_index_t storage
+        , const lt::file_index_t fileIndex, const Path &filePath)
+{
+    if (const auto storageIter = m_files.find(storage); storageIter != m_files.end())
+    {
+        if (const auto iter = storageIter->find(fileIndex); iter != storageIter->end())
+        {
+            m_filesLRU.splice(m_filesLRU.end(), m_filesLRU, iter->lruIter);
+            return iter->handle;
+        }
+    }
+
+    const int fd = ::open(QFile::encodeName(filePath.data()).constData(), (O_RDONLY | O_CLOEXEC));
+    if (fd < 0)
+        return nullptr;
+
+    const int maxOpenFiles = std::max(1, m_settings.get_int(lt::settings_pack::file_pool_size));
+    while (std::ssize(m_filesLRU) >= maxOpenFiles)
+        closeLeastRecentlyUsedFile();
+
+    const auto fileHandle = std::make_shared<FileHandle>(fd);
+    m_files[storage][fileIndex] = {fileHandle, m_filesLRU.insert(m_filesLRU.end(), {storage, fileIndex})};
+    return fileHandle;
+}
+
+void IOUringReader::closeLeastRecentlyUsedFile()
+{
+    const auto [storage, fileIndex] = m_filesLRU.front();
+    m_filesLRU.pop_front();
+
+    // the file is actually closed when the pending reads don't need it anymore
+    const auto storageIter = m_files.find(storage);
+    storageIter->remove(fileIndex);
+    if (storageIter->isEmpty())
+        m_files.erase(storageIter);
+}
+
+char *IOUringReader::allocateBuffer()
+{
+    const QMutexLocker locker {&m_buffersMutex};
+    return !m_freeBuffers.isEmpty() ? m_freeBuffers.takeLast() : nullptr;
+}
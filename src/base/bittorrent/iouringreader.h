@@ -0,0 +1,160 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <liburing.h>
+#include <libtorrent/aux_/vector.hpp>
+#include <libtorrent/disk_buffer_holder.hpp>
+#include <libtorrent/disk_interface.hpp>
+#include <libtorrent/download_priority.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/io_context.hpp>
+#include <libtorrent/peer_request.hpp>
+#include <libtorrent/settings_pack.hpp>
+#include <libtorrent/units.hpp>
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QSet>
+#include <QWaitCondition>
+
+#include "base/path.h"
+
+class QThread;
+
+// Reads torrent blocks using Linux io_uring: the reads are queued by the network
+// thread, submitted to the kernel in batches and completed by a dedicated thread,
+// so no thread is blocked waiting for the storage. The blocks are read into
+// buffers registered with the kernel when it is allowed to pin them in memory.
+// At most `file_pool_size` files are kept open, the least recently used ones are closed first.
+class IOUringReader final : public lt::buffer_allocator_interface
+{
+    Q_DISABLE_COPY_MOVE(IOUringReader)
+
+public:
+    using ReadHandler = std::function<void (lt::disk_buffer_holder bufferHolder)>;
+    using FailureHandler = std::function<void ()>;
+
+    // Returns nullptr if io_uring isn't supported
+    static std::unique_ptr<IOUringReader> create(lt::io_context &ioContext, const lt::settings_interface &settings);
+
+    ~IOUringReader();
+
+    // Queues reading of the block. Returns `false` if it can't be read using io_uring,
+    // otherwise one of the handlers is invoked in the network thread when it is done.
+    bool read(lt::storage_index_t storage, const lt::file_storage &files
+            , const lt::aux::vector<lt::download_priority_t, lt::file_index_t> &filePriorities, const Path &savePath
+            , const lt::peer_request &peerRequest, ReadHandler handler, FailureHandler failureHandler);
+    // Submits the queued reads
+    void submit();
+    // Waits for the submitted reads to be completed
+    void waitForDone();
+    // Files are reopened on the next read, e.g. after they are moved or renamed
+    void closeFiles(lt::storage_index_t storage);
+
+    void free_disk_buffer(char *buffer) override;
+
+private:
+    struct FileHandle
+    {
+        explicit FileHandle(int fd);
+        ~FileHandle();
+
+        const int fd;
+    };
+
+    using FileKey = std::pair<lt::storage_index_t, lt::file_index_t>;
+
+    struct OpenFile
+    {
+        std::shared_ptr<FileHandle> handle;
+        std::list<FileKey>::iterator lruIter;
+    };
+
+    struct ReadJob;
+
+    struct ReadOperation
+    {
+        ReadJob *job = nullptr;
+        int size = 0;
+    };
+
+    struct ReadJob
+    {
+        ReadHandler handler;
+        FailureHandler failureHandler;
+        char *buffer = nullptr;
+        int length = 0;
+        int pendingCount = 0;
+        bool isFailed = false;
+        std::vector<ReadOperation> operations;
+        // Keeps the files open until the reads are completed
+        std::vector<std::shared_ptr<FileHandle>> files;
+    };
+
+    IOUringReader(lt::io_context &ioContext, const lt::settings_interface &settings);
+
+    bool initialize();
+    void processCompletions();
+    void finishJob(ReadJob *job);
+    // Fails the jobs that won't be completed since the completion queue can't be waited anymore
+    void failPendingJobs();
+    std::shared_ptr<FileHandle> openFile(lt::storage_index_t storage, lt::file_index_t fileIndex, const Path &filePath);
+    void closeLeastRecentlyUsedFile();
+    char *allocateBuffer();
+
+    lt::io_context &m_ioContext;
+    const lt::settings_interface &m_settings;
+    io_uring m_ring;
+    bool m_isInitialized = false;
+    bool m_hasRegisteredBuffers = false;
+    bool m_hasQueuedReads = false;
+    std::unique_ptr<QThread> m_completionThread;
+
+    std::unique_ptr<char[]> m_buffers;
+    QMutex m_buffersMutex;
+    QList<char *> m_freeBuffers;
+
+    QMutex m_jobsMutex;
+    QWaitCondition m_jobsFinished;
+    QSet<ReadJob *> m_pendingJobs;
+    bool m_isRingFailed = false;
+
+    // accessed from the network thread only
+    QHash<lt::storage_index_t, QHash<lt::file_index_t, OpenFile>> m_files;
+    // the least recently used file first
+    std::list<FileKey> m_filesLRU;
+};
@@ -0,0 +1,696 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "journalresumedatastorage.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QDataStream>
+#include <QDebug>
+#include <QFile>
+#include <QMetaObject>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+
+#include "base/exceptions.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/path.h"
+#include "base/tracer.h"
+#include "base/utils/io.h"
+#include "bencoderesumedatastorage.h"
+#include "infohash.h"
+#include "loadtorrentparams.h"
+
+namespace
+{
+    using namespace BitTorrent;
+
+    const QByteArray JOURNAL_SIGNATURE = QByteArrayLiteral("qBittorrent resume data journal\n");
+    const quint32 JOURNAL_VERSION = 1;
+    const qint64 JOURNAL_HEADER_SIZE = JOURNAL_SIGNATURE.size() + sizeof(JOURNAL_VERSION);
+
+    const int TORRENT_ID_SIZE = TorrentID::length() * 2;
+    // payload size + payload checksum + record type + torrent ID
+    const qint64 RECORD_HEADER_SIZE = sizeof(quint32) + sizeof(quint16) + sizeof(quint8) + TORRENT_ID_SIZE;
+
+    // The journal is compacted when obsolete records take more space
+    // than both this threshold and the actual records
+    const qint64 MIN_COMPACTION_THRESHOLD = 16 * 1024 * 1024;
+
+    enum class RecordType : quint8
+    {
+        Store = 1,
+        Remove = 2,
+        Queue = 3
+    };
+
+    struct RecordHeader
+    {
+        quint32 payloadSize = 0;
+        quint16 payloadChecksum = 0;
+        quint8 type = 0;
+        TorrentID torrentID;
+    };
+
+    QByteArray makeJournalHeader()
+    {
+        QByteArray header;
+        QDataStream stream {&header, QIODevice::WriteOnly};
+        stream.writeRawData(JOURNAL_SIGNATURE.constData(), JOURNAL_SIGNATURE.size());
+        stream << JOURNAL_VERSION;
+        return header;
+    }
+
+    QByteArray makeRecord(const RecordType type, const TorrentID &torrentID, const QByteArray &payload)
+    {
+        QByteArray record;
+        record.reserve(RECORD_HEADER_SIZE + payload.size());
+        {
+            QDataStream stream {&record, QIODevice::WriteOnly};
+            stream << static_cast<quint32>(payload.size()) << qChecksum(payload) << static_cast<quint8>(type);
+        }
+        record.append(torrentID.isValid() ? torrentID.toString().toLatin1() : QByteArray(TORRENT_ID_SIZE, '0'));
+        record.append(payload);
+        return record;
+    }
+
+    RecordHeader parseRecordHeader(const QByteArray &data)
+    {
+        Q_ASSERT(data.size() >= RECORD_HEADER_SIZE);
+
+        RecordHeader header;
+        QDataStream stream {data};
+        stream >> header.payloadSize >> header.payloadChecksum >> header.type;
+        header.torrentID = TorrentID::fromString(QString::fromLatin1(
+                data.sliced((RECORD_HEADER_SIZE - TORRENT_ID_SIZE), TORRENT_ID_SIZE)));
+        return header;
+    }
+
+    QByteArray makeStorePayload(const BencodeResumeDataStorage::BencodedResumeData &resumeData)
+    {
+        QByteArray payload;
+        QDataStream stream {&payload, QIODevice::WriteOnly};
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream << resumeData.resumeData << resumeData.metadata;
+        return payload;
+    }
+
+    QByteArray makeQueuePayload(const QList<TorrentID> &queue)
+    {
+        QByteArray payload;
+        payload.reserve(TORRENT_ID_SIZE * queue.size());
+        for (const TorrentID &torrentID : queue)
+            payload.append(torrentID.toString().toLatin1());
+        return payload;
+    }
+
+    QList<TorrentID> parseQueuePayload(const QByteArray &payload)
+    {
+        QList<TorrentID> queue;
+        queue.reserve(payload.size() / TORRENT_ID_SIZE);
+        for (qsizetype pos = 0; (pos + TORRENT_ID_SIZE) <= payload.size(); pos += TORRENT_ID_SIZE)
+        {
+            if (const auto torrentID = TorrentID::fromString(QString::fromLatin1(payload.sliced(pos, TORRENT_ID_SIZE)))
+                    ; torrentID.isValid())
+            {
+                queue.append(torrentID);
+            }
+        }
+        return queue;
+    }
+
+    nonstd::expected<QByteArray, QString> readRecord(QFile &file, const qint64 offset, const qint64 size)
+    {
+        if (size == 0)
+            return nonstd::make_unexpected(JournalResumeDataStorage::tr("Not found."));
+
+        if (!file.seek(offset))
+            return nonstd::make_unexpected(file.errorString());
+
+        QByteArray record = file.read(size);
+        if (record.size() != size)
+            return nonstd::make_unexpected(JournalResumeDataStorage::tr("Journal record is truncated."));
+
+        return record;
+    }
+
+    LoadResumeDataResult parseStoreRecord(const QByteArray &record)
+    {
+        const RecordHeader header = parseRecordHeader(record);
+        const auto payload = QByteArrayView(record).sliced(RECORD_HEADER_SIZE);
+        if ((static_cast<RecordType>(header.type) != RecordType::Store)
+                || (payload.size() != static_cast<qsizetype>(header.payloadSize)) || (qChecksum(payload) != header.payloadChecksum))
+        {
+            return nonstd::make_unexpected(JournalResumeDataStorage::tr("Journal record is corrupted."));
+        }
+
+        QDataStream stream {record};
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream.skipRawData(RECORD_HEADER_SIZE);
+
+        QByteArray resumeData;
+        QByteArray metadata;
+        stream >> resumeData >> metadata;
+        if (stream.status() != QDataStream::Ok)
+            return nonstd::make_unexpected(JournalResumeDataStorage::tr("Journal record is corrupted."));
+
+        return BencodeResumeDataStorage::loadTorrentResumeData(resumeData, metadata);
+    }
+}
+
+namespace BitTorrent
+{
+    class JournalResumeDataStorage::Worker final : public QObject
+    {
+        Q_DISABLE_COPY_MOVE(Worker)
+
+    public:
+        // Reads the existing journal and initializes the index of the storage
+        explicit Worker(JournalResumeDataStorage *storage);
+        ~Worker() override;
+
+        void store(const TorrentID &id, LoadTorrentParams resumeData);
+        void remove(const TorrentID &id);
+        void storeQueue(const QList<TorrentID> &queue);
+
+    private:
+        void readJournal();
+        void append(const QByteArray &record);
+        void flush();
+        bool needCompaction() const;
+        void compact();
+
+        JournalResumeDataStorage *const m_storage;
+        const Path m_path;
+        QFile m_file;
+        // Size of the records that are actually written to the file
+        qint64 m_fileSize = 0;
+        // Records waiting to be written and synced at once
+        QByteArray m_buffer;
+        bool m_isFlushScheduled = false;
+
+        // Latest records including the ones that aren't written yet
+        QHash<TorrentID, RecordLocation> m_records;
+        qint64 m_liveRecordsSize = 0;
+        QList<TorrentID> m_queue;
+        qint64 m_queueRecordSize = 0;
+
+        // Changes to be applied to the storage index once written
+        QHash<TorrentID, RecordLocation> m_updatedRecords;
+        QSet<TorrentID> m_removedRecords;
+    };
+}
+
+BitTorrent::JournalResumeDataStorage::JournalResumeDataStorage(const Path &path, QObject *parent)
+    : ResumeDataStorage(path, parent)
+    , m_ioThread {new QThread}
+    , m_asyncWorker {new Worker(this)}
+{
+    Q_ASSERT(path.isAbsolute());
+
+    qDebug() << "Registered torrents count: " << m_registeredTorrents.size();
+
+    m_asyncWorker->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_asyncWorker, &QObject::deleteLater);
+    m_ioThread->setObjectName("JournalResumeDataStorage m_ioThread");
+    Utils::Thread::setWorkload(m_ioThread.get(), Utils::Thread::Workload::Bulk);
+    m_ioThread->start();
+}
+
+QList<BitTorrent::TorrentID> BitTorrent::JournalResumeDataStorage::registeredTorrents() const
+{
+    return m_registeredTorrents;
+}
+
+BitTorrent::LoadResumeDataResult BitTorrent::JournalResumeDataStorage::load(const TorrentID &id) const
+{
+    const TraceSpan traceSpan {"JournalResumeDataStorage::load"};
+
+    const QReadLocker locker {&m_journalLock};
+
+    QFile file {path().data()};
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return nonstd::make_unexpected(tr("Couldn't load resume data of torrent '%1'. Error: %2")
+                .arg(id.toString(), file.errorString()));
+    }
+
+    const RecordLocation location = recordLocation(id);
+    const auto record = readRecord(file, location.offset, location.size);
+    if (!record)
+    {
+        return nonstd::make_unexpected(tr("Couldn't load resume data of torrent '%1'. Error: %2")
+                .arg(id.toString(), record.error()));
+    }
+
+    return parseStoreRecord(record.value());
+}
+
+void BitTorrent::JournalResumeDataStorage::store(const TorrentID &id, LoadTorrentParams resumeData) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, id, resumeData = std::move(resumeData)]() mutable
+    {
+        m_asyncWorker->store(id, std::move(resumeData));
+    });
+}
+
+void BitTorrent::JournalResumeDataStorage::remove(const TorrentID &id) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, id]
+    {
+        m_asyncWorker->remove(id);
+    });
+}
+
+void BitTorrent::JournalResumeDataStorage::storeQueue(const QList<TorrentID> &queue) const
+{
+    QMetaObject::invokeMethod(m_asyncWorker, [this, queue]
+    {
+        m_asyncWorker->storeQueue(queue);
+    });
+}
+
+void BitTorrent::JournalResumeDataStorage::doLoadAll() const
+{
+    const TraceSpan traceSpan {"JournalResumeDataStorage::doLoadAll"};
+
+    qDebug() << "Loading torrents count: " << m_registeredTorrents.size();
+
+    // Prevent the journal from being compacted while it is being read
+    const QReadLocker locker {&m_journalLock};
+
+    emit const_cast<JournalResumeDataStorage *>(this)->loadStarted(m_registeredTorrents);
+
+    QFile file {path().data()};
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        LogMsg(tr("Couldn't read resume data journal '%1'. Error: %2")
+                .arg(path().toString(), file.errorString()), Log::CRITICAL);
+    }
+
+    // Records are read in the loading thread, so that the file is accessed
+    // sequentially, while the parsing is performed in parallel
+    for (const TorrentID &torrentID : asConst(m_registeredTorrents))
+    {
+        const RecordLocation location = recordLocation(torrentID);
+        parseResumeData(torrentID, [record = readRecord(file, location.offset, location.size)]() -> LoadResumeDataResult
+        {
+            if (!record)
+                return nonstd::make_unexpected(record.error());
+
+            return parseStoreRecord(record.value());
+        });
+    }
+}
+
+BitTorrent::JournalResumeDataStorage::RecordLocation BitTorrent::JournalResumeDataStorage::recordLocation(const TorrentID &id) const
+{
+    const QMutexLocker locker {&m_indexMutex};
+    return m_index.value(id);
+}
+
+void BitTorrent::JournalResumeDataStorage::updateIndex(const QHash<TorrentID, RecordLocation> &updatedRecords, const QSet<TorrentID> &removedRecords)
+{
+    const QMutexLocker locker {&m_indexMutex};
+    m_index.insert(updatedRecords);
+    for (const TorrentID &torrentID : removedRecords)
+        m_index.remove(torrentID);
+}
+
+void BitTorrent::JournalResumeDataStorage::resetIndex(QHash<TorrentID, RecordLocation> index)
+{
+    const QMutexLocker locker {&m_indexMutex};
+    m_index = std::move(index);
+}
+
+BitTorrent::JournalResumeDataStorage::Worker::Worker(JournalResumeDataStorage *storage)
+    : m_storage {storage}
+    , m_path {storage->path()}
+    , m_file {m_path.data()}
+{
+    readJournal();
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+    {
+        throw RuntimeError(JournalResumeDataStorage::tr("Couldn't open resume data journal '%1'. Error: %2")
+                .arg(m_path.toString(), m_file.errorString()));
+    }
+}
+
+BitTorrent::JournalResumeDataStorage::Worker::~Worker()
+{
+    flush();
+}
+
+void BitTorrent::JournalResumeDataStorage::Worker::readJournal()
+{
+    if (!m_path.exists())
+    {
+        if (const auto result = Utils::IO::saveToFile(m_path, makeJournalHeader()); !result)
+        {
+            throw RuntimeError(JournalResumeDataStorage::tr("Couldn't create resume data journal '%1'. Error: %2")
+                    .arg(m_path.toString(), result.error()));
+        }
+
+        m_fileSize = JOURNAL_HEADER_SIZE;
+        return;
+    }
+
+    QFile file {m_path.data()};
+    if (!file.open(QIODevice::ReadWrite))
+    {
+        throw RuntimeError(JournalResumeDataStorage::tr("Couldn't open resume data journal '%1'. Error: %2")
+                .arg(m_path.toString(), file.errorString()));
+    }
+
+    if (file.read(JOURNAL_HEADER_SIZE) != makeJournalHeader())
+    {
+        throw RuntimeError(JournalResumeDataStorage::tr("Resume data journal '%1' has unsupported format.")
+                .arg(m_path.toString()));
+    }
+
+    // Only the headers of stored resume data records are read here,
+    // their payload is verified when the resume data is loaded
+    const qint64 fileSize = file.size();
+    qint64 offset = JOURNAL_HEADER_SIZE;
+    while ((fileSize - offset) >= RECORD_HEADER_SIZE)
+    {
+        const QByteArray headerData = file.read(RECORD_HEADER_SIZE);
+        if (headerData.size() != RECORD_HEADER_SIZE)
+            break;
+
+        const RecordHeader header = parseRecordHeader(headerData);
+        const qint64 recordSize = RECORD_HEADER_SIZE + header.payloadSize;
+        if ((fileSize - offset) < recordSize)
+            break;
+
+        const auto recordType = static_cast<RecordType>(header.type);
+        if (recordType == RecordType::Store)
+        {
+            m_records.insert(header.torrentID, {.offset = offset, .size = recordSize});
+        }
+        else if ((recordType == RecordType::Remove) && (header.payloadSize == 0))
+        {
+            m_records.remove(header.torrentID);
+        }
+        else if (recordType == RecordType::Queue)
+        {
+            const QByteArray payload = file.read(header.payloadSize);
+            if ((payload.size() != static_cast<qsizetype>(header.payloadSize)) || (qChecksum(payload) != header.payloadChecksum))
+                break;
+
+            m_queue = parseQueuePayload(payload);
+            m_queueRecordSize = recordSize;
+        }
+        else
+        {
+            break;
+        }
+
+        offset += recordSize;
+        if (!file.seek(offset))
+            break;
+    }
+
+    if (offset < fileSize)
+    {
+        // Most likely the application was terminated while the last records were being written
+        LogMsg(JournalResumeDataStorage::tr("Resume data journal is damaged. Discarding its tail. Offset: %1. Discarded bytes: %2.")
+                .arg(QString::number(offset), QString::number(fileSize - offset)), Log::WARNING);
+        if (!file.resize(offset))
+        {
+            throw RuntimeError(JournalResumeDataStorage::tr("Couldn't repair resume data journal '%1'. Error: %2")
+                    .arg(m_path.toString(), file.errorString()));
+        }
+    }
+
+    m_fileSize = offset;
+    m_liveRecordsSize = m_queueRecordSize;
+    for (const RecordLocation &location : asConst(m_records))
+        m_liveRecordsSize += location.size;
+
+    // Queued torrents go first, the rest are sorted in order of their records
+    QList<TorrentID> registeredTorrents;
+    registeredTorrents.reserve(m_records.size());
+    QSet<TorrentID> queuedTorrents;
+    queuedTorrents.reserve(m_queue.size());
+    for (const TorrentID &torrentID : asConst(m_queue))
+    {
+        if (m_records.contains(torrentID) && !queuedTorrents.contains(torrentID))
+        {
+            registeredTorrents.append(torrentID);
+            queuedTorrents.insert(torrentID);
+        }
+    }
+    const qsizetype queuedTorrentsCount = registeredTorrents.size();
+    for (auto it = m_records.cbegin(); it != m_records.cend(); ++it)
+    {
+        if (!queuedTorrents.contains(it.key()))
+            registeredTorrents.append(it.key());
+    }
+    std::sort((registeredTorrents.begin() + queuedTorrentsCount), registeredTorrents.end()
+            , [this](const TorrentID &left, const TorrentID &right)
+    {
+        return (m_records.value(left).offset < m_records.value(right).offset);
+    });
+
+    m_storage->m_registeredTorrents = registeredTorrents;
+    m_storage->m_index = m_records;
+}
+
+void BitTorrent::JournalResumeDataStorage::Worker::store(const TorrentID &id, LoadTorrentParams resumeData)
+{
+    const TraceSpan traceSpan {"JournalResumeDataStorage::Worker::store"};
+
+    const auto bencodedResumeData = BencodeResumeDataStorage::bencodeResumeData(std::move(resumeData));
+    if (!bencodedResumeData)
+    {
+        LogMsg(JournalResumeDataStorage::tr("Couldn't save torrent resume data. Torrent: \"%1\". Error: %2.")
+                .arg(id.toString(), bencodedResumeData.error()), Log::CRITICAL);
+        return;
+    }
+
+    const QByteArray record = makeRecord(RecordType::Store, id, makeStorePayload(bencodedResumeData.value()));
+    const RecordLocation location {.offset = (m_fileSize + m_buffer.size()), .size = record.size()};
+
+    if (const auto iter = m_records.find(id); iter != m_records.end())
+    {
+        m_liveRecordsSize -= iter->size;
+        *iter = location;
+    }
+    else
+    {
+        m_records.insert(id, location);
+    }
+    m_liveRecordsSize += location.size;
+
+    m_updatedRecords.insert(id, location);
+    m_removedRecords.remove(id);
+
+    append(record);
+}
+
+void BitTorrent::JournalResumeDataStorage::Worker::remove(const TorrentID &id)
+{
+    const auto iter = m_records.find(id);
+    if (iter == m_records.end())
+        return;
+
+    m_liveRecordsSize -= iter->size;
+    m_records.erase(iter);
+
+    m_updatedRecords.remove(id);
+    m_removedRecords.insert(id);
+
+    append(makeRecord(RecordType::Remove, id, {}));
+}
+
+void BitTorrent::JournalResumeDataStorage::Worker::storeQueue(const QList<TorrentID> &queue)
+{
+    const QByteArray record = makeRecord(RecordType::Queue, {}, makeQueuePayload(queue));
+    m_liveRecordsSize += (record.size() - m_queueRecordSize);
+    m_queueRecordSize = record.size();
+    m_queue = queue;
+
+    append(record);
+}
+
+void BitTorrent::JournalResumeDataStorage::Worker::append(const QByteArray &record)
+{
+    m_buffer.append(record);
+
+    if (!m_isFlushScheduled)
+    {
+        // The changes received meanwhile are written and synced all together
+        QMetaObject::invokeMethod(this, &Worker::flush, Qt::QueuedConnection);
+        m_isFlushScheduled = true;
+    }
+}
+
+void BitTorrent::JournalResumeDataStorage::Worker::flush()
+{
+    const TraceSpan traceSpan {"JournalResumeDataStorage::Worker::flush"};
+
+    m_isFlushScheduled = false;
+
+    if (m_buffer.isEmpty())
+        return;
+
+    if (m_file.write(m_buffer) != m_buffer.size())
+    {
+        LogMsg(JournalResumeDataStorage::tr("Couldn't write resume data journal '%1'. Error: %2")
+                .arg(m_path.toString(), m_file.errorString()), Log::CRITICAL);
+
+        // Discard partially written records. Buffered ones will be written along with the next changes.
+        m_file.resize(m_fileSize);
+        return;
+    }
+
+    if (const auto result = Utils::IO::syncFile(m_file); !result)
+    {
+        LogMsg(JournalResumeDataStorage::tr("Couldn't sync resume data journal '%1'. Error: %2")
+                .arg(m_path.toString(), result.error()), Log::WARNING);
+    }
+
+    m_fileSize += m_buffer.size();
+    m_buffer.clear();
+
+    m_storage->updateIndex(std::exchange(m_updatedRecords, {}), std::exchange(m_removedRecords, {}));
+
+    if (needCompaction())
+        compact();
+}
+
+bool BitTorrent::JournalResumeDataStorage::Worker::needCompaction() const
+{
+    const qint64 obsoleteRecordsSize = m_fileSize - JOURNAL_HEADER_SIZE - m_liveRecordsSize;
+    return (obsoleteRecordsSize > std::max(MIN_COMPACTION_THRESHOLD, m_liveRecordsSize));
+}
+
+void BitTorrent::JournalResumeDataStorage::Worker::compact()
+{
+    const TraceSpan traceSpan {"JournalResumeDataStorage::Worker::compact"};
+
+    Q_ASSERT(m_buffer.isEmpty());
+
+    // Records are rewritten in queue order so that they are read sequentially at startup
+    QList<TorrentID> torrentIDs;
+    torrentIDs.reserve(m_records.size());
+    QSet<TorrentID> queuedTorrents;
+    for (const TorrentID &torrentID : asConst(m_queue))
+    {
+        if (m_records.contains(torrentID) && !queuedTorrents.contains(torrentID))
+        {
+            torrentIDs.append(torrentID);
+            queuedTorrents.insert(torrentID);
+        }
+    }
+    for (auto it = m_records.cbegin(); it != m_records.cend(); ++it)
+    {
+        if (!queuedTorrents.contains(it.key()))
+            torrentIDs.append(it.key());
+    }
+
+    const QWriteLocker locker {&m_storage->m_journalLock};
+
+    QHash<TorrentID, RecordLocation> compactedRecords;
+    compactedRecords.reserve(m_records.size());
+    qint64 compactedFileSize = 0;
+
+    try
+    {
+        QFile journalFile {m_path.data()};
+        if (!journalFile.open(QIODevice::ReadOnly))
+            throw RuntimeError(journalFile.errorString());
+
+        QSaveFile compactedFile {m_path.data()};
+        if (!compactedFile.open(QIODevice::WriteOnly))
+            throw RuntimeError(compactedFile.errorString());
+
+        const QByteArray journalHeader = makeJournalHeader();
+        if (compactedFile.write(journalHeader) != journalHeader.size())
+            throw RuntimeError(compactedFile.errorString());
+        compactedFileSize = journalHeader.size();
+
+        for (const TorrentID &torrentID : asConst(torrentIDs))
+        {
+            const RecordLocation location = m_records.value(torrentID);
+            const auto record = readRecord(journalFile, location.offset, location.size);
+            if (!record)
+                throw RuntimeError(record.error());
+
+            if (compactedFile.write(record.value()) != location.size)
+                throw RuntimeError(compactedFile.errorString());
+
+            compactedRecords.insert(torrentID, {.offset = compactedFileSize, .size = location.size});
+            compactedFileSize += location.size;
+        }
+
+        if (m_queueRecordSize > 0)
+        {
+            const QByteArray queueRecord = makeRecord(RecordType::Queue, {}, makeQueuePayload(m_queue));
+            if (compactedFile.write(queueRecord) != queueRecord.size())
+                throw RuntimeError(compactedFile.errorString());
+
+            compactedFileSize += queueRecord.size();
+        }
+
+        journalFile.close();
+        // The file is replaced on commit so it shouldn't be kept open
+        m_file.close();
+        if (!compactedFile.commit())
+            throw RuntimeError(compactedFile.errorString());
+    }
+    catch (const RuntimeError &err)
+    {
+        LogMsg(JournalResumeDataStorage::tr("Couldn't compact resume data journal '%1'. Error: %2")
+                .arg(m_path.toString(), err.message()), Log::WARNING);
+
+        if (!m_file.isOpen())
+            m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered);
+        return;
+    }
+
+    qDebug() << "Resume data journal is compacted. Size before:" << m_fileSize << "Size after:" << compactedFileSize;
+
+    m_fileSize = compactedFileSize;
+    m_liveRecordsSize = compactedFileSize - JOURNAL_HEADER_SIZE;
+    m_records = compactedRecords;
+    m_storage->resetIndex(std::move(compactedRecords));
+
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Append | QIODevice::Unbuffered))
+    {
+        LogMsg(JournalResumeDataStorage::tr("Couldn't open resume data journal '%1'. Error: %2")
+                .arg(m_path.toString(), m_file.errorString()), Log::CRITICAL);
+    }
+}
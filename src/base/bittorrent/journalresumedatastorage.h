@@ -0,0 +1,86 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QReadWriteLock>
+#include <QSet>
+
+#include "base/pathfwd.h"
+#include "base/utils/thread.h"
+#include "resumedatastorage.h"
+
+namespace BitTorrent
+{
+    // Keeps resume data of all torrents in a single append-only log file.
+    // Every change is appended as a separate record so the data is written
+    // sequentially and synced to disk once per batch of changes. Superseded
+    // records are dropped by rewriting the log when they take too much space.
+    class JournalResumeDataStorage final : public ResumeDataStorage
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(JournalResumeDataStorage)
+
+    public:
+        explicit JournalResumeDataStorage(const Path &path, QObject *parent = nullptr);
+
+        QList<TorrentID> registeredTorrents() const override;
+        LoadResumeDataResult load(const TorrentID &id) const override;
+        void store(const TorrentID &id, LoadTorrentParams resumeData) const override;
+        void remove(const TorrentID &id) const override;
+        void storeQueue(const QList<TorrentID> &queue) const override;
+
+    private:
+        struct RecordLocation
+        {
+            qint64 offset = 0;
+            qint64 size = 0;
+        };
+
+        void doLoadAll() const override;
+        RecordLocation recordLocation(const TorrentID &id) const;
+        void updateIndex(const QHash<TorrentID, RecordLocation> &updatedRecords, const QSet<TorrentID> &removedRecords);
+        void resetIndex(QHash<TorrentID, RecordLocation> index);
+
+        QList<TorrentID> m_registeredTorrents;
+        // Location of the latest record of each torrent in the journal file.
+        // It is shared with the worker that updates it once the records are written.
+        QHash<TorrentID, RecordLocation> m_index;
+        mutable QMutex m_indexMutex;
+        // Compaction rewrites the journal file so it is exclusive to reading
+        mutable QReadWriteLock m_journalLock;
+
+        Utils::Thread::UniquePtr m_ioThread;
+
+        class Worker;
+        Worker *m_asyncWorker = nullptr;
+    };
+}
@@ -28,6 +28,11 @@
 
 #include "ltqbitarray.h"
 
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
 #include <libtorrent/bitfield.hpp>
 
 #include <QBitArray>
@@ -50,6 +55,60 @@ namespace
         };
         return table[byte];
     }
+
+    // Reverses the bits of each byte of the word independently, so the result
+    // doesn't depend on the byte order the word was loaded with
+    std::uint64_t reverseBytesBits(std::uint64_t word)
+    {
+        word = ((word >> 1) & 0x5555'5555'5555'5555) | ((word & 0x5555'5555'5555'5555) << 1);
+        word = ((word >> 2) & 0x3333'3333'3333'3333) | ((word & 0x3333'3333'3333'3333) << 2);
+        word = ((word >> 4) & 0x0F0F'0F0F'0F0F'0F0F) | ((word & 0x0F0F'0F0F'0F0F'0F0F) << 4);
+        return word;
+    }
+
+    std::uint64_t loadWord(const char *data)
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, data, sizeof(word));
+        return word;
+    }
+
+    // Byte of libtorrent bitfield has its first bit in the most significant position while
+    // QBitArray has it in the least significant one, so QBitArray mask is reversed on the fly
+    template <bool isQBitArrayMask>
+    qsizetype countBitsNotInMask(const char *bitsData, const qsizetype bitCount, const char *maskData, qsizetype maskBitCount)
+    {
+        maskBitCount = std::min(maskBitCount, bitCount);
+        const qsizetype maskFullBytes = maskBitCount / 8;
+
+        qsizetype count = 0;
+        qsizetype i = 0;
+        for (; (i + 8) <= maskFullBytes; i += 8)
+        {
+            std::uint64_t maskWord = loadWord(maskData + i);
+            if constexpr (isQBitArrayMask)
+                maskWord = reverseBytesBits(maskWord);
+            count += std::popcount(loadWord(bitsData + i) & ~maskWord);
+        }
+        for (; i < maskFullBytes; ++i)
+        {
+            unsigned char maskByte = maskData[i];
+            if constexpr (isQBitArrayMask)
+                maskByte = reverseByte(maskByte);
+            count += std::popcount(static_cast<unsigned char>(bitsData[i] & ~maskByte));
+        }
+
+        if (const int maskByteBits = (maskBitCount % 8); maskByteBits > 0)
+        {
+            unsigned char maskByte = maskData[i];
+            if constexpr (isQBitArrayMask)
+                maskByte = reverseByte(maskByte);
+            const auto coveredBits = static_cast<unsigned char>(0xFF << (8 - maskByteBits));
+            count += std::popcount(static_cast<unsigned char>(bitsData[i] & ~maskByte & coveredBits));
+        }
+
+        return count;
+    }
 }
 
 namespace BitTorrent::LT
@@ -62,9 +121,25 @@ namespace BitTorrent::LT
         const int dataLength = (bits.size() + 7) / 8;
 
         QVarLengthArray<char, STACK_ALLOC_SIZE> tmp(dataLength);
-        for (int i = 0; i < dataLength; ++i)
+        int i = 0;
+        for (; (i + 8) <= dataLength; i += 8)
+        {
+            const std::uint64_t word = reverseBytesBits(loadWord(bitsData + i));
+            std::memcpy(tmp.data() + i, &word, sizeof(word));
+        }
+        for (; i < dataLength; ++i)
             tmp[i] = reverseByte(bitsData[i]);
 
         return QBitArray::fromBits(tmp.data(), bits.size());
     }
+
+    qsizetype countSetBitsNotIn(const lt::bitfield &bits, const QBitArray &mask)
+    {
+        return countBitsNotInMask<true>(bits.data(), bits.size(), mask.bits(), mask.size());
+    }
+
+    qsizetype countSetBitsNotIn(const lt::bitfield &bits, const lt::bitfield &mask)
+    {
+        return countBitsNotInMask<false>(bits.data(), bits.size(), mask.data(), mask.size());
+    }
 }
@@ -30,9 +30,15 @@
 
 #include <libtorrent/fwd.hpp>
 
+#include <QtTypes>
+
 class QBitArray;
 
 namespace BitTorrent::LT
 {
     QBitArray toQBitArray(const lt::bitfield &bits);
+    // Number of bits set in `bits` but not in `mask` (e.g. pieces the peer has that we lack),
+    // only the bits present in both of them are compared
+    qsizetype countSetBitsNotIn(const lt::bitfield &bits, const QBitArray &mask);
+    qsizetype countSetBitsNotIn(const lt::bitfield &bits, const lt::bitfield &mask);
 }
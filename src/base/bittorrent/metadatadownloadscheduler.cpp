@@ -0,0 +1,148 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "metadatadownloadscheduler.h"
+
+#include <algorithm>
+
+using namespace BitTorrent;
+
+MetadataDownloadScheduler::MetadataDownloadScheduler(const int maxActive, const qint64 ttl)
+    : m_maxActive {std::max(1, maxActive)}
+    , m_ttl {std::max<qint64>(1, ttl)}
+{
+}
+
+int MetadataDownloadScheduler::maxActive() const
+{
+    return m_maxActive;
+}
+
+void MetadataDownloadScheduler::setMaxActive(const int maxActive)
+{
+    // the downloads above the new limit aren't stopped, they just aren't replaced once finished
+    m_maxActive = std::max(1, maxActive);
+}
+
+qint64 MetadataDownloadScheduler::ttl() const
+{
+    return m_ttl;
+}
+
+bool MetadataDownloadScheduler::isEmpty() const
+{
+    return m_queued.isEmpty() && m_active.isEmpty();
+}
+
+qsizetype MetadataDownloadScheduler::activeCount() const
+{
+    return m_active.size();
+}
+
+qsizetype MetadataDownloadScheduler::queuedCount() const
+{
+    return m_queued.size();
+}
+
+bool MetadataDownloadScheduler::isActive(const TorrentID &id) const
+{
+    return m_active.contains(id);
+}
+
+bool MetadataDownloadScheduler::isQueued(const TorrentID &id) const
+{
+    return std::ranges::any_of(m_queued, [&id](const Download &download) { return download.id == id; });
+}
+
+bool MetadataDownloadScheduler::schedule(const TorrentID &id, const MetadataDownloadPriority priority, const qint64 now)
+{
+    if (isActive(id) || isQueued(id))
+        return false;
+
+    // the download goes after the ones having the same or higher priority
+    const auto iter = std::ranges::find_if(m_queued, [priority](const Download &download)
+    {
+        return download.priority < priority;
+    });
+    m_queued.insert(iter, Download {.id = id, .priority = priority, .time = now});
+    return true;
+}
+
+bool MetadataDownloadScheduler::remove(const TorrentID &id)
+{
+    if (m_active.remove(id))
+        return true;
+
+    return (m_queued.removeIf([&id](const Download &download) { return download.id == id; }) > 0);
+}
+
+QList<TorrentID> MetadataDownloadScheduler::takeStartable(const qint64 now)
+{
+    const qsizetype count = std::min(m_queued.size(), std::max<qsizetype>(0, (m_maxActive - m_active.size())));
+
+    QList<TorrentID> startable;
+    startable.reserve(count);
+    for (qsizetype i = 0; i < count; ++i)
+    {
+        Download &download = m_queued[i];
+        download.time = now;
+        startable.append(download.id);
+        m_active.insert(download.id, download);
+    }
+    m_queued.remove(0, count);
+
+    return startable;
+}
+
+QList<TorrentID> MetadataDownloadScheduler::takeExpired(const qint64 now)
+{
+    QList<TorrentID> expired;
+
+    m_active.removeIf([this, now, &expired](const QHash<TorrentID, Download>::iterator &iter)
+    {
+        if (!isExpired(iter.value(), now))
+            return false;
+
+        expired.append(iter.key());
+        return true;
+    });
+    m_queued.removeIf([this, now, &expired](const Download &download)
+    {
+        if (!isExpired(download, now))
+            return false;
+
+        expired.append(download.id);
+        return true;
+    });
+
+    return expired;
+}
+
+bool MetadataDownloadScheduler::isExpired(const Download &download, const qint64 now) const
+{
+    return (download.priority == MetadataDownloadPriority::Normal) && ((now - download.time) >= m_ttl);
+}
@@ -0,0 +1,95 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <QtClassHelperMacros>
+#include <QHash>
+#include <QList>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    enum class MetadataDownloadPriority
+    {
+        Normal,
+        // requested interactively, it isn't expired since the requester cancels it when it isn't needed
+        High
+    };
+
+    // Limits the number of the metadata downloads running at once, so the hidden torrents used to download
+    // the metadata don't compete for the connections with the real transfers. The queued downloads are
+    // started in the order of their priority and then in the order they were scheduled.
+    // The downloads of normal priority expire after the given time-to-live, both queued and active ones.
+    class MetadataDownloadScheduler final
+    {
+        Q_DISABLE_COPY_MOVE(MetadataDownloadScheduler)
+
+    public:
+        static constexpr int DEFAULT_MAX_ACTIVE = 20;
+        static constexpr qint64 DEFAULT_TTL = 600;  // seconds
+
+        explicit MetadataDownloadScheduler(int maxActive = DEFAULT_MAX_ACTIVE, qint64 ttl = DEFAULT_TTL);
+
+        int maxActive() const;
+        void setMaxActive(int maxActive);
+        qint64 ttl() const;
+
+        bool isEmpty() const;
+        qsizetype activeCount() const;
+        qsizetype queuedCount() const;
+        bool isActive(const TorrentID &id) const;
+        bool isQueued(const TorrentID &id) const;
+
+        // `now` is the current time in seconds of any monotonic clock.
+        // Returns false if the download is already scheduled.
+        bool schedule(const TorrentID &id, MetadataDownloadPriority priority, qint64 now);
+        bool remove(const TorrentID &id);
+        // Returns the queued downloads which can be started now, they are considered active then
+        QList<TorrentID> takeStartable(qint64 now);
+        // Returns the downloads which exceeded the time-to-live, they are removed from the scheduler
+        QList<TorrentID> takeExpired(qint64 now);
+
+    private:
+        struct Download
+        {
+            TorrentID id;
+            MetadataDownloadPriority priority = MetadataDownloadPriority::Normal;
+            // the time it was scheduled or started at
+            qint64 time = 0;
+        };
+
+        bool isExpired(const Download &download, qint64 now) const;
+
+        int m_maxActive = 0;
+        qint64 m_ttl = 0;
+        // ordered by the priority, then by the schedule time
+        QList<Download> m_queued;
+        QHash<TorrentID, Download> m_active;
+    };
+}
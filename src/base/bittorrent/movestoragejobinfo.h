@@ -0,0 +1,66 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QtTypes>
+#include <QString>
+
+#include "base/path.h"
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    enum class MoveStorageJobState
+    {
+        Queued,
+        Moving,
+        Finished,
+        Failed
+    };
+
+    struct MoveStorageJobInfo
+    {
+        TorrentID torrentID;
+        Path sourcePath;
+        Path destinationPath;
+        // Storage devices the data is moved between, jobs writing to
+        // the same device are performed one at a time
+        QString sourceVolume;
+        QString destinationVolume;
+        MoveStorageJobState state = MoveStorageJobState::Queued;
+        // Size of the torrent content being moved
+        qint64 size = 0;
+        // Amount of data copied so far while it is moved to another storage device
+        qint64 movedSize = 0;
+        // Time in milliseconds spent moving so far, or in total once the job is done
+        qint64 elapsedTime = 0;
+        // Average rate in bytes per second, it is known during the move only if the data is being copied
+        qint64 throughput = 0;
+    };
+}
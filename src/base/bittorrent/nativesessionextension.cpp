@@ -28,6 +28,8 @@
 
 #include "nativesessionextension.h"
 
+#include <cstddef>
+
 #include <libtorrent/alert_types.hpp>
 
 #include "extensiondata.h"
@@ -35,6 +37,9 @@
 
 namespace
 {
+    // limits the memory used when the connections are flooded from many different addresses
+    const std::size_t MAX_BLOCKED_PEERS = 1000;
+
     void handleFastresumeRejectedAlert(const lt::fastresume_rejected_alert *alert)
     {
         alert->handle.unset_flags(lt::torrent_flags::auto_managed);
@@ -48,6 +53,20 @@ bool NativeSessionExtension::isSessionListening() const
     return m_isSessionListening;
 }
 
+NativeSessionExtension::BlockedPeers NativeSessionExtension::takeBlockedPeers()
+{
+    const QMutexLocker locker {&m_blockedPeersMutex};
+
+    BlockedPeers result;
+    result.peers.reserve(static_cast<qsizetype>(m_blockedPeers.size()));
+    for (const auto &[key, blockedPeer] : m_blockedPeers)
+        result.peers.append(blockedPeer);
+    result.otherCount = std::exchange(m_otherBlockedPeersCount, 0);
+
+    m_blockedPeers.clear();
+    return result;
+}
+
 void NativeSessionExtension::added(const lt::session_handle &nativeSession)
 {
     m_nativeSession = nativeSession;
@@ -73,6 +92,9 @@ void NativeSessionExtension::on_alert(const lt::alert *alert)
     case lt::fastresume_rejected_alert::alert_type:
         handleFastresumeRejectedAlert(static_cast<const lt::fastresume_rejected_alert *>(alert));
         break;
+    case lt::peer_blocked_alert::alert_type:
+        handlePeerBlockedAlert(static_cast<const lt::peer_blocked_alert *>(alert));
+        break;
     default:
         break;
     }
@@ -83,3 +105,26 @@ void NativeSessionExtension::handleSessionStatsAlert([[maybe_unused]] const lt::
     const QWriteLocker locker {&m_lock};
     m_isSessionListening = m_nativeSession.is_listening();
 }
+
+void NativeSessionExtension::handlePeerBlockedAlert(const lt::peer_blocked_alert *alert)
+{
+    const lt::address address = alert->endpoint.address();
+    const int reason = alert->reason;
+
+    const QMutexLocker locker {&m_blockedPeersMutex};
+
+    auto iter = m_blockedPeers.find({address, reason});
+    if (iter == m_blockedPeers.end())
+    {
+        if (m_blockedPeers.size() >= MAX_BLOCKED_PEERS)
+        {
+            ++m_otherBlockedPeersCount;
+            return;
+        }
+
+        iter = m_blockedPeers.emplace(std::make_pair(address, reason), BlockedPeer {.address = address, .reason = reason}).first;
+    }
+
+    iter->second.port = alert->endpoint.port();
+    ++iter->second.count;
+}
@@ -28,19 +28,47 @@
 
 #pragma once
 
+#include <map>
+#include <utility>
+
+#include <libtorrent/address.hpp>
 #include <libtorrent/extensions.hpp>
 #include <libtorrent/fwd.hpp>
 #include <libtorrent/session_handle.hpp>
 
+#include <QtTypes>
+#include <QList>
+#include <QMutex>
 #include <QReadWriteLock>
 
 #include "extensiondata.h"
 
+// Handles some alerts right on the network thread.
+// The high-frequency alerts which are only of interest as a summary (such as the connections
+// refused because of the IP filter) are aggregated here, so the main thread doesn't handle them one by one.
 class NativeSessionExtension final : public lt::plugin
 {
 public:
+    struct BlockedPeer
+    {
+        lt::address address;
+        int reason = 0;  // lt::peer_blocked_alert::reason_t
+        quint16 port = 0;  // the port of the latest blocked connection
+        qint64 count = 0;
+    };
+
+    struct BlockedPeers
+    {
+        QList<BlockedPeer> peers;
+        // connections from the addresses exceeding the limit of the aggregated ones
+        qint64 otherCount = 0;
+    };
+
     bool isSessionListening() const;
 
+    // Returns the peers blocked since the previous call
+    BlockedPeers takeBlockedPeers();
+
 private:
     void added(const lt::session_handle &nativeSession) override;
     lt::feature_flags_t implemented_features() override;
@@ -48,9 +76,14 @@ private:
     void on_alert(const lt::alert *alert) override;
 
     void handleSessionStatsAlert(const lt::session_stats_alert *alert);
+    void handlePeerBlockedAlert(const lt::peer_blocked_alert *alert);
 
     lt::session_handle m_nativeSession;
 
     mutable QReadWriteLock m_lock;
     bool m_isSessionListening = false;
+
+    QMutex m_blockedPeersMutex;
+    std::map<std::pair<lt::address, int>, BlockedPeer> m_blockedPeers;
+    qint64 m_otherBlockedPeersCount = 0;
 };
@@ -28,8 +28,113 @@
 
 #include "nativetorrentextension.h"
 
+#include <cstddef>
+
+#include <libtorrent/peer_connection_handle.hpp>
 #include <libtorrent/torrent_status.hpp>
 
+namespace
+{
+    // limits the memory used until the main thread takes the counted traffic
+    const std::size_t MAX_PEER_TRAFFIC_ENTRIES = 4096;
+    const std::size_t MAX_USEFUL_PEER_ENTRIES = 256;
+
+    std::string clientCode(const lt::peer_id &peerId)
+    {
+        // Azureus-style peer ID: '-' <client code> <version> '-'
+        const auto isCodeChar = [](const char c) { return ((c >= '0') && (c <= '9')) || ((c >= 'A') && (c <= 'Z')) || ((c >= 'a') && (c <= 'z')); };
+        if ((peerId[0] == '-') && (peerId[7] == '-') && isCodeChar(static_cast<char>(peerId[1])) && isCodeChar(static_cast<char>(peerId[2])))
+            return {static_cast<char>(peerId[1]), static_cast<char>(peerId[2])};
+
+        return {};
+    }
+
+    // Counts the payload exchanged with the peer and adds it to the torrent traffic once a second,
+    // so the main thread doesn't need to fetch the peer list to collect the statistics
+    class NativePeerExtension final : public lt::peer_plugin
+    {
+    public:
+        NativePeerExtension(const lt::peer_connection_handle &peerConnection, std::shared_ptr<PeerTrafficData> data)
+            : m_peerConnection {peerConnection}
+            , m_data {std::move(data)}
+        {
+        }
+
+    private:
+        bool on_piece(const lt::peer_request &, const lt::span<const char> buffer) override
+        {
+            m_pending.downloaded += buffer.size();
+            return false;
+        }
+
+        void sent_payload(const int bytes) override
+        {
+            m_pending.uploaded += bytes;
+        }
+
+        void tick() override
+        {
+            flush();
+        }
+
+        void on_disconnect(const lt::error_code &) override
+        {
+            flush();
+        }
+
+        void flush()
+        {
+            if (!m_isIdentified)
+            {
+                // peer ID is unknown until the handshake is completed
+                const lt::peer_id peerId = m_peerConnection.pid();
+                if (peerId.is_all_zeros())
+                    return;
+
+                m_key = {m_peerConnection.remote().address(), clientCode(peerId)};
+                m_pending.connections = 1;
+                m_isIdentified = true;
+            }
+
+            if ((m_pending.downloaded == 0) && (m_pending.uploaded == 0) && (m_pending.connections == 0))
+                return;
+
+            // the listen port of the peer is known for the outgoing connections only
+            const bool isUseful = !m_isUsefulPeerRecorded && m_peerConnection.is_outgoing()
+                    && ((m_pending.downloaded > 0) || (m_pending.uploaded > 0));
+
+            const std::lock_guard lock {m_data->mutex};
+
+            if (isUseful && (m_data->usefulPeers.size() < MAX_USEFUL_PEER_ENTRIES))
+            {
+                m_data->usefulPeers.insert(m_peerConnection.remote());
+                m_isUsefulPeerRecorded = true;
+            }
+
+            auto iter = m_data->peers.find(m_key);
+            if (iter == m_data->peers.end())
+            {
+                // the traffic of the excess peers is left unattributed
+                const PeerTrafficData::Key key = (m_data->peers.size() < MAX_PEER_TRAFFIC_ENTRIES) ? m_key : PeerTrafficData::Key {};
+                iter = m_data->peers.try_emplace(key).first;
+            }
+
+            PeerTraffic &traffic = iter->second;
+            traffic.downloaded += m_pending.downloaded;
+            traffic.uploaded += m_pending.uploaded;
+            traffic.connections += m_pending.connections;
+            m_pending = {};
+        }
+
+        lt::peer_connection_handle m_peerConnection;
+        std::shared_ptr<PeerTrafficData> m_data;
+        PeerTrafficData::Key m_key;
+        PeerTraffic m_pending;
+        bool m_isIdentified = false;
+        bool m_isUsefulPeerRecorded = false;
+    };
+}
+
 NativeTorrentExtension::NativeTorrentExtension(const lt::torrent_handle &torrentHandle, ExtensionData *data)
     : m_torrentHandle {torrentHandle}
     , m_data {data}
@@ -51,6 +156,15 @@ NativeTorrentExtension::~NativeTorrentExtension()
     delete m_data;
 }
 
+std::shared_ptr<lt::peer_plugin> NativeTorrentExtension::new_connection(const lt::peer_connection_handle &peerConnection)
+{
+    // `data` doesn't exist if a torrent is added behind the scenes to download metadata
+    if (!m_data)
+        return {};
+
+    return std::make_shared<NativePeerExtension>(peerConnection, m_data->peerTraffic);
+}
+
 void NativeTorrentExtension::on_state(const lt::torrent_status::state_t state)
 {
     if ((m_state == lt::torrent_status::downloading_metadata)
@@ -28,9 +28,17 @@
 
 #include "peerinfo.h"
 
+#include <cstring>
+#include <string>
+#include <unordered_map>
+
 #include <QBitArray>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
 
 #include "base/bittorrent/ltqbitarray.h"
+#include "base/net/geoipdatabase.h"
 #include "base/net/geoipmanager.h"
 #include "base/unicodestrings.h"
 #include "base/utils/bytearray.h"
@@ -38,9 +46,88 @@
 
 using namespace BitTorrent;
 
+namespace
+{
+    // Peers usually report one of a few distinct clients, so the decoded names
+    // are shared between all the peers instead of being decoded for each of them
+    const int MAX_INTERNED_CLIENTS_COUNT = 10'000;
+
+    QString decodeClient(const std::string &nativeClient)
+    {
+        auto client = QString::fromStdString(nativeClient).simplified();
+
+        // remove non-printable characters
+        erase_if(client, [](const QChar &c) { return !c.isPrint(); });
+
+        return client;
+    }
+
+    QString decodePeerIdClient(const lt::peer_id &peerID)
+    {
+        // when peer ID is not known yet it contains only zero bytes,
+        // do not create string in such case, return empty string instead
+        if (peerID.is_all_zeros())
+            return {};
+
+        QString result;
+
+        // interesting part of a typical peer ID is first 8 chars
+        for (int i = 0; i < 8; ++i)
+        {
+            const std::uint8_t c = peerID[i];
+
+            // ensure that the peer ID slice consists only of printable ASCII characters,
+            // this should filter out most of the improper IDs
+            if ((c < 32) || (c > 126))
+                return PeerInfo::tr("Unknown");
+
+            result += QChar::fromLatin1(c);
+        }
+
+        return result;
+    }
+
+    QString internClient(const std::string &nativeClient)
+    {
+        // Peers are fetched in the worker threads
+        static QMutex mutex;
+        static std::unordered_map<std::string, QString> clients;
+
+        const QMutexLocker locker {&mutex};
+
+        if (const auto iter = clients.find(nativeClient); iter != clients.end())
+            return iter->second;
+
+        if (clients.size() >= static_cast<std::size_t>(MAX_INTERNED_CLIENTS_COUNT))
+            clients.clear();
+        return clients.emplace(nativeClient, decodeClient(nativeClient)).first->second;
+    }
+
+    QString internPeerIdClient(const lt::peer_id &peerID)
+    {
+        static QMutex mutex;
+        static QHash<quint64, QString> peerIdClients;
+
+        // only the first 8 chars of peer ID are decoded
+        quint64 prefix = 0;
+        std::memcpy(&prefix, peerID.data(), sizeof(prefix));
+
+        const QMutexLocker locker {&mutex};
+
+        if (const auto iter = peerIdClients.constFind(prefix); iter != peerIdClients.cend())
+            return iter.value();
+
+        if (peerIdClients.size() >= MAX_INTERNED_CLIENTS_COUNT)
+            peerIdClients.clear();
+        return peerIdClients.insert(prefix, decodePeerIdClient(peerID)).value();
+    }
+}
+
 PeerInfo::PeerInfo(const lt::peer_info &nativeInfo, const QBitArray &allPieces)
     : m_nativeInfo(nativeInfo)
     , m_relevance(calcRelevance(allPieces))
+    , m_client(internClient(nativeInfo.client))
+    , m_peerIdClient(internPeerIdClient(nativeInfo.pid))
 {
     determineFlags();
 }
@@ -62,9 +149,14 @@ bool PeerInfo::fromLSD() const
 
 QString PeerInfo::country() const
 {
-    if (m_country.isEmpty())
+    if (!m_country)
         m_country = Net::GeoIPManager::instance()->lookup(address().ip);
-    return m_country;
+    return *m_country;
+}
+
+void PeerInfo::resolveCountry(const GeoIPDatabase *geoIPDatabase)
+{
+    m_country = geoIPDatabase ? geoIPDatabase->lookup(address().ip) : QString();
 }
 
 bool PeerInfo::isInteresting() const
@@ -198,37 +290,12 @@ QString PeerInfo::I2PAddress() const
 
 QString PeerInfo::client() const
 {
-    auto client = QString::fromStdString(m_nativeInfo.client).simplified();
-
-    // remove non-printable characters
-    erase_if(client, [](const QChar &c) { return !c.isPrint(); });
-
-    return client;
+    return m_client;
 }
 
 QString PeerInfo::peerIdClient() const
 {
-    // when peer ID is not known yet it contains only zero bytes,
-    // do not create string in such case, return empty string instead
-    if (m_nativeInfo.pid.is_all_zeros())
-        return {};
-
-    QString result;
-
-    // interesting part of a typical peer ID is first 8 chars
-    for (int i = 0; i < 8; ++i)
-    {
-        const std::uint8_t c = m_nativeInfo.pid[i];
-
-        // ensure that the peer ID slice consists only of printable ASCII characters,
-        // this should filter out most of the improper IDs
-        if ((c < 32) || (c > 126))
-            return tr("Unknown");
-
-        result += QChar::fromLatin1(c);
-    }
-
-    return result;
+    return m_peerIdClient;
 }
 
 qreal PeerInfo::progress() const
@@ -277,8 +344,7 @@ qreal PeerInfo::calcRelevance(const QBitArray &allPieces) const
     if (localMissing <= 0)
         return 0;
 
-    const QBitArray peerPieces = pieces();
-    const qsizetype remoteHaves = (peerPieces & (~allPieces)).count(true);
+    const qsizetype remoteHaves = LT::countSetBitsNotIn(m_nativeInfo.pieces, allPieces);
     return static_cast<qreal>(remoteHaves) / localMissing;
 }
 
@@ -28,11 +28,14 @@
 
 #pragma once
 
+#include <optional>
+
 #include <libtorrent/peer_info.hpp>
 
 #include <QCoreApplication>
 
 class QBitArray;
+class GeoIPDatabase;
 
 namespace BitTorrent
 {
@@ -90,6 +93,9 @@ namespace BitTorrent
         QString flags() const;
         QString flagsDescription() const;
         QString country() const;
+        // Looks up the country in the given database instead of the one of GeoIPManager,
+        // so it can be done outside of the main thread
+        void resolveCountry(const GeoIPDatabase *geoIPDatabase);
         int downloadingPieceIndex() const;
 
     private:
@@ -98,10 +104,12 @@ namespace BitTorrent
 
         lt::peer_info m_nativeInfo = {};
         qreal m_relevance = 0;
+        QString m_client;
+        QString m_peerIdClient;
         QString m_flags;
         QString m_flagsDescription;
 
-        mutable QString m_country;
+        mutable std::optional<QString> m_country;
         mutable QString m_I2PAddress;
     };
 }
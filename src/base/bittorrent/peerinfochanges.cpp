@@ -0,0 +1,120 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "peerinfochanges.h"
+
+#include <QtTypes>
+
+using namespace BitTorrent;
+
+namespace
+{
+    struct PeerState
+    {
+        QString client;
+        QString flags;
+        qreal progress = 0;
+        qreal relevance = 0;
+        int payloadUpSpeed = 0;
+        int payloadDownSpeed = 0;
+        qlonglong totalUpload = 0;
+        qlonglong totalDownload = 0;
+        int downloadingPieceIndex = -1;
+
+        friend bool operator==(const PeerState &left, const PeerState &right) = default;
+    };
+
+    PeerState peerState(const PeerInfo &peer)
+    {
+        return {
+            .client = peer.client(),
+            .flags = peer.flags(),
+            .progress = peer.progress(),
+            .relevance = peer.relevance(),
+            .payloadUpSpeed = peer.payloadUpSpeed(),
+            .payloadDownSpeed = peer.payloadDownSpeed(),
+            .totalUpload = peer.totalUpload(),
+            .totalDownload = peer.totalDownload(),
+            .downloadingPieceIndex = peer.downloadingPieceIndex()
+        };
+    }
+}
+
+class BitTorrent::PeerInfoSnapshot
+{
+public:
+    QHash<PeerEndpoint, PeerState> peers;
+};
+
+PeerEndpoint PeerEndpoint::fromPeerInfo(const PeerInfo &peer)
+{
+    return {peer.address(), peer.I2PAddress(), peer.connectionType()};
+}
+
+std::size_t BitTorrent::qHash(const BitTorrent::PeerEndpoint &peerEndpoint, const std::size_t seed)
+{
+    return qHashMulti(seed, peerEndpoint.address, peerEndpoint.I2PAddress, peerEndpoint.connectionType);
+}
+
+PeerInfoChanges BitTorrent::calculatePeerInfoChanges(const QList<PeerInfo> &peers, const PeerInfoSnapshotPtr &previousSnapshot)
+{
+    auto snapshot = std::make_shared<PeerInfoSnapshot>();
+    snapshot->peers.reserve(peers.size());
+
+    const auto isUpdated = [&previousSnapshot](const PeerEndpoint &endpoint, const PeerState &state)
+    {
+        if (!previousSnapshot)
+            return true;
+
+        const auto iter = previousSnapshot->peers.constFind(endpoint);
+        return ((iter == previousSnapshot->peers.cend()) || (iter.value() != state));
+    };
+
+    PeerInfoChanges changes;
+    for (const PeerInfo &peer : peers)
+    {
+        const PeerEndpoint endpoint = PeerEndpoint::fromPeerInfo(peer);
+        const PeerState state = peerState(peer);
+        if (isUpdated(endpoint, state))
+            changes.updatedPeers.append(peer);
+
+        snapshot->peers.insert(endpoint, state);
+    }
+
+    if (previousSnapshot)
+    {
+        for (auto it = previousSnapshot->peers.cbegin(); it != previousSnapshot->peers.cend(); ++it)
+        {
+            if (!snapshot->peers.contains(it.key()))
+                changes.removedPeers.append(it.key());
+        }
+    }
+
+    changes.snapshot = std::move(snapshot);
+    return changes;
+}
@@ -0,0 +1,70 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "peeraddress.h"
+#include "peerinfo.h"
+
+namespace BitTorrent
+{
+    // Identifies the peer connection across the peer list refreshes
+    struct PeerEndpoint
+    {
+        PeerAddress address;
+        QString I2PAddress;
+        QString connectionType; // matches return type of `PeerInfo::connectionType()`
+
+        static PeerEndpoint fromPeerInfo(const PeerInfo &peer);
+
+        friend bool operator==(const PeerEndpoint &left, const PeerEndpoint &right) = default;
+    };
+
+    std::size_t qHash(const PeerEndpoint &peerEndpoint, std::size_t seed = 0);
+
+    // Opaque state of the peer list the changes are calculated against
+    class PeerInfoSnapshot;
+    using PeerInfoSnapshotPtr = std::shared_ptr<const PeerInfoSnapshot>;
+
+    struct PeerInfoChanges
+    {
+        // Peers which are added or whose displayed data is changed since the previous snapshot
+        QList<PeerInfo> updatedPeers;
+        QList<PeerEndpoint> removedPeers;
+        // Should be passed to get the changes since this state
+        PeerInfoSnapshotPtr snapshot;
+    };
+
+    PeerInfoChanges calculatePeerInfoChanges(const QList<PeerInfo> &peers, const PeerInfoSnapshotPtr &previousSnapshot);
+}
@@ -0,0 +1,104 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QHash>
+#include <QString>
+#include <QtTypes>
+
+namespace BitTorrent
+{
+    struct PeerTrafficStatistics
+    {
+        qint64 downloaded = 0;
+        qint64 uploaded = 0;
+        // Number of peer connections which completed the handshake
+        qint64 connections = 0;
+
+        PeerTrafficStatistics &operator+=(const PeerTrafficStatistics &other)
+        {
+            downloaded += other.downloaded;
+            uploaded += other.uploaded;
+            connections += other.connections;
+            return *this;
+        }
+
+        PeerTrafficStatistics &operator-=(const PeerTrafficStatistics &other)
+        {
+            downloaded -= other.downloaded;
+            uploaded -= other.uploaded;
+            connections -= other.connections;
+            return *this;
+        }
+
+        bool isEmpty() const
+        {
+            return (downloaded == 0) && (uploaded == 0) && (connections == 0);
+        }
+    };
+
+    // Payload exchanged with the peers, it is counted on the network thread as the data goes
+    struct PeerStatistics
+    {
+        // Keyed by the client code from the peer ID (e.g. "qB"), empty for unknown clients
+        QHash<QString, PeerTrafficStatistics> clients;
+        // Keyed by the country code, empty for unknown countries
+        QHash<QString, PeerTrafficStatistics> countries;
+
+        PeerStatistics &operator+=(const PeerStatistics &other)
+        {
+            for (auto it = other.clients.cbegin(); it != other.clients.cend(); ++it)
+                clients[it.key()] += it.value();
+            for (auto it = other.countries.cbegin(); it != other.countries.cend(); ++it)
+                countries[it.key()] += it.value();
+            return *this;
+        }
+
+        // The entries which become empty are removed
+        PeerStatistics &operator-=(const PeerStatistics &other)
+        {
+            const auto subtract = [](QHash<QString, PeerTrafficStatistics> &items, const QHash<QString, PeerTrafficStatistics> &otherItems)
+            {
+                for (auto it = otherItems.cbegin(); it != otherItems.cend(); ++it)
+                {
+                    const auto itemIter = items.find(it.key());
+                    if (itemIter == items.end())
+                        continue;
+
+                    if ((*itemIter -= it.value()).isEmpty())
+                        items.erase(itemIter);
+                }
+            };
+
+            subtract(clients, other.clients);
+            subtract(countries, other.countries);
+            return *this;
+        }
+    };
+}
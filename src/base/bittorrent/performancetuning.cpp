@@ -0,0 +1,244 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "performancetuning.h"
+
+#include <algorithm>
+#include <bit>
+#include <initializer_list>
+#include <limits>
+
+#include <QtSystemDetection>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_MACOS)
+#include <sys/resource.h>
+#include <sys/sysctl.h>
+#include <sys/types.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QString>
+#include <QStringList>
+#include <QThread>
+
+#include "base/global.h"
+#include "base/path.h"
+#include "base/utils/fs.h"
+
+namespace
+{
+    const qint64 MiB = 1024 * 1024;
+    const qint64 GiB = 1024 * MiB;
+
+    // The defaults serve slower links well
+    const qint64 FAST_LINK_RATE = 12'500'000; // 100 Mbit/s
+
+    qint64 detectPhysicalMemory()
+    {
+#if defined(Q_OS_WIN)
+        MEMORYSTATUSEX status {};
+        status.dwLength = sizeof(status);
+        if (!::GlobalMemoryStatusEx(&status))
+            return 0;
+        return static_cast<qint64>(status.ullTotalPhys);
+#elif defined(Q_OS_MACOS)
+        int64_t memSize = 0;
+        size_t len = sizeof(memSize);
+        if (::sysctlbyname("hw.memsize", &memSize, &len, nullptr, 0) != 0)
+            return 0;
+        return memSize;
+#elif defined(Q_OS_UNIX) && defined(_SC_PHYS_PAGES)
+        const long pages = ::sysconf(_SC_PHYS_PAGES);
+        const long pageSize = ::sysconf(_SC_PAGESIZE);
+        if ((pages <= 0) || (pageSize <= 0))
+            return 0;
+        return static_cast<qint64>(pages) * pageSize;
+#else
+        return 0;
+#endif
+    }
+
+    int detectOpenFilesLimit()
+    {
+#ifdef Q_OS_UNIX
+        rlimit limit {};
+        if ((::getrlimit(RLIMIT_NOFILE, &limit) != 0) || (limit.rlim_cur == RLIM_INFINITY))
+            return 0;
+        return static_cast<int>(std::min<rlim_t>(limit.rlim_cur, std::numeric_limits<int>::max()));
+#else
+        // Windows CRT limits don't apply to the file handles used by libtorrent
+        return 0;
+#endif
+    }
+
+#ifdef Q_OS_LINUX
+    QByteArray readSysFile(const QString &path)
+    {
+        QFile file {path};
+        if (!file.open(QIODevice::ReadOnly))
+            return {};
+        return file.readAll().trimmed();
+    }
+
+    qint64 detectLinkSpeed(const QString &networkInterface)
+    {
+        const QDir netDir {u"/sys/class/net"_s};
+        const QStringList interfaces = networkInterface.isEmpty()
+            ? netDir.entryList((QDir::Dirs | QDir::NoDotAndDotDot))
+            : QStringList {networkInterface};
+
+        qint64 linkSpeed = 0;
+        for (const QString &name : interfaces)
+        {
+            if (name == u"lo")
+                continue;
+
+            const QString interfacePath = netDir.filePath(name);
+            if (readSysFile(interfacePath + u"/operstate") != "up")
+                continue;
+
+            // In Mbit/s, it is -1 or can't be read if unknown (e.g. virtual interfaces)
+            bool ok = false;
+            const qint64 speed = readSysFile(interfacePath + u"/speed").toLongLong(&ok);
+            if (ok && (speed > 0))
+                linkSpeed = std::max(linkSpeed, (speed * 1000 * 1000 / 8));
+        }
+        return linkSpeed;
+    }
+
+    bool detectRotationalStorage(const Path &storagePath)
+    {
+        const QString device = Utils::Fs::storageDevice(storagePath);
+        if (!device.startsWith(u"/dev/"))
+            return false;
+
+        // Resolve links such as "/dev/mapper/*" to the actual block device
+        const QString deviceName = QFileInfo(QFileInfo(device).canonicalFilePath()).fileName();
+        QString blockPath = QFileInfo(u"/sys/class/block/"_s + deviceName).canonicalFilePath();
+        if (blockPath.isEmpty())
+            return false;
+
+        // Partitions have no queue attributes, they belong to the parent disk
+        if (QFileInfo::exists(blockPath + u"/partition"))
+            blockPath = QFileInfo(blockPath).path();
+
+        return (readSysFile(blockPath + u"/queue/rotational") == "1");
+    }
+#endif
+}
+
+BitTorrent::HostResources BitTorrent::detectHostResources([[maybe_unused]] const Path &storagePath
+        , [[maybe_unused]] const QString &networkInterface)
+{
+    HostResources resources;
+    resources.cpuCount = std::max(1, QThread::idealThreadCount());
+    resources.physicalMemory = detectPhysicalMemory();
+    resources.openFilesLimit = detectOpenFilesLimit();
+#ifdef Q_OS_LINUX
+    resources.linkSpeed = detectLinkSpeed(networkInterface);
+    resources.isRotationalStorage = detectRotationalStorage(storagePath);
+#endif
+    return resources;
+}
+
+BitTorrent::PerformanceSettings BitTorrent::autoTunedPerformanceSettings(const HostResources &resources, const qint64 observedRate)
+{
+    PerformanceSettings settings;
+
+    const int cpuCount = std::max(1, resources.cpuCount);
+    if (resources.isRotationalStorage)
+    {
+        // Concurrent requests make rotational disks seek, so more threads don't help them
+        settings.asyncIOThreads = 4;
+        settings.hashingThreads = 1;
+    }
+    else
+    {
+        settings.asyncIOThreads = std::clamp((cpuCount * 2), settings.asyncIOThreads, 64);
+        settings.hashingThreads = std::clamp((cpuCount / 2), settings.hashingThreads, 16);
+    }
+    settings.connectionSpeed = std::clamp((cpuCount * 10), settings.connectionSpeed, 200);
+
+    if (resources.physicalMemory > 0)
+    {
+        const auto memoryGiB = static_cast<int>(std::min<qint64>((resources.physicalMemory / GiB), 1024));
+        settings.filePoolSize = std::clamp((memoryGiB * 50), settings.filePoolSize, 2000);
+        // Up to 1/256 of the memory is used to read ahead while checking
+        settings.checkingMemUsage = static_cast<int>(std::clamp<qint64>((resources.physicalMemory / 256 / MiB)
+                , settings.checkingMemUsage, 1024));
+#ifndef QBT_APP_64BIT
+        settings.checkingMemUsage = std::min(settings.checkingMemUsage, 128);
+#endif
+    }
+
+    // Leave file descriptors for the sockets and the rest of the application
+    if (resources.openFilesLimit > 0)
+        settings.filePoolSize = std::clamp((resources.openFilesLimit / 4), 1, settings.filePoolSize);
+
+    // The rate is rounded down to a power of two, so that small fluctuations
+    // of the observed rate don't result in different settings
+    const qint64 rate = std::max(resources.linkSpeed, observedRate);
+    if (rate >= FAST_LINK_RATE)
+    {
+        const auto roundedRate = static_cast<qint64>(std::bit_floor(static_cast<quint64>(rate)));
+        // Buffer about 1/8 s of the transfer for each peer, so that fast peers
+        // don't wait for the disk between the send buffer refills
+        settings.sendBufferWatermark = static_cast<int>(std::clamp<qint64>((roundedRate / 8 / 1024)
+                , settings.sendBufferWatermark, (16 * 1024)));
+        settings.sendBufferLowWatermark = settings.sendBufferWatermark / 4;
+        settings.sendBufferWatermarkFactor = 150;
+        settings.socketSendBufferSize = static_cast<int>(std::min<qint64>((roundedRate / 16), (4 * MiB)));
+        settings.socketReceiveBufferSize = settings.socketSendBufferSize;
+    }
+
+    return settings;
+}
+
+BitTorrent::PerformanceSettings BitTorrent::applyPerformanceOverrides(const PerformanceSettings &autoTuned, const PerformanceSettings &manual)
+{
+    const PerformanceSettings defaults;
+    PerformanceSettings settings = autoTuned;
+    for (int PerformanceSettings::*value : {&PerformanceSettings::asyncIOThreads, &PerformanceSettings::hashingThreads
+            , &PerformanceSettings::filePoolSize, &PerformanceSettings::checkingMemUsage
+            , &PerformanceSettings::sendBufferWatermark, &PerformanceSettings::sendBufferLowWatermark
+            , &PerformanceSettings::sendBufferWatermarkFactor, &PerformanceSettings::connectionSpeed
+            , &PerformanceSettings::socketSendBufferSize, &PerformanceSettings::socketReceiveBufferSize})
+    {
+        if (manual.*value != defaults.*value)
+            settings.*value = manual.*value;
+    }
+    return settings;
+}
@@ -0,0 +1,81 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QtTypes>
+
+class QString;
+
+class Path;
+
+namespace BitTorrent
+{
+    struct HostResources
+    {
+        int cpuCount = 1;
+        // In bytes, 0 if unknown
+        qint64 physicalMemory = 0;
+        // In bytes per second, 0 if unknown
+        qint64 linkSpeed = 0;
+        // Maximum number of open file descriptors, 0 if unknown
+        int openFilesLimit = 0;
+        bool isRotationalStorage = false;
+    };
+
+    // Session settings sized by the automatic performance profile, in the units
+    // of the corresponding session settings. The defaults are the built-in values
+    // of the manual profile.
+    struct PerformanceSettings
+    {
+        int asyncIOThreads = 10;
+        int hashingThreads = 1;
+        int filePoolSize = 100;
+        int checkingMemUsage = 32; // MiB
+        int sendBufferWatermark = 500; // KiB
+        int sendBufferLowWatermark = 10; // KiB
+        int sendBufferWatermarkFactor = 50; // %
+        int connectionSpeed = 30;
+        int socketSendBufferSize = 0; // bytes, 0 for OS default
+        int socketReceiveBufferSize = 0; // bytes, 0 for OS default
+
+        friend bool operator==(const PerformanceSettings &left, const PerformanceSettings &right) = default;
+    };
+
+    // Detects the resources of the host, the storage type is determined for
+    // the device of `storagePath`, the link speed for `networkInterface`
+    // (or the fastest connected interface if it is empty)
+    HostResources detectHostResources(const Path &storagePath, const QString &networkInterface);
+
+    // `observedRate` is the peak transfer rate (in bytes per second) observed by
+    // the session, it is used instead of the link speed when that is unknown or lower
+    PerformanceSettings autoTunedPerformanceSettings(const HostResources &resources, qint64 observedRate);
+
+    // The values of `manual` which differ from the defaults override the ones of `autoTuned`
+    PerformanceSettings applyPerformanceOverrides(const PerformanceSettings &autoTuned, const PerformanceSettings &manual);
+}
@@ -0,0 +1,417 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "persistentreadcache.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMutexLocker>
+#include <QThreadPool>
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/utils/fs.h"
+#include "base/utils/io.h"
+
+namespace
+{
+    const QString INDEX_FILE_NAME = u"index"_s;
+    const qint32 INDEX_VERSION = 1;
+    const qint64 MAX_INDEX_FILE_SIZE = 1024 * 1024 * 1024;
+
+    bool isTorrentID(const QString &str)
+    {
+        return (str.size() == 40) && std::ranges::all_of(str, [](const QChar c)
+        {
+            return ((c >= u'0') && (c <= u'9')) || ((c >= u'a') && (c <= u'f'));
+        });
+    }
+
+    QByteArray readBlock(const Path &filePath, const qint64 position, const int length)
+    {
+        QFile file {filePath.data()};
+        if (!file.open(QIODevice::ReadOnly) || !file.seek(position))
+            return {};
+
+        const QByteArray data = file.read(length);
+        return (data.size() == length) ? data : QByteArray();
+    }
+
+    bool writeBlock(const Path &filePath, const qint64 position, const QByteArray &data)
+    {
+        if (!Utils::Fs::mkpath(filePath.parentPath()))
+            return false;
+
+        QFile file {filePath.data()};
+        return file.open(QIODevice::ReadWrite) && file.seek(position) && (file.write(data) == data.size());
+    }
+}
+
+PersistentReadCache::PersistentReadCache(const Path &dirPath, const qint64 capacity)
+    : m_dirPath {dirPath}
+    , m_threadPool {new QThreadPool}
+    , m_capacity {std::max<qint64>(capacity, 0)}
+{
+    // Jobs must be run in the order they are queued, e.g. a block must be
+    // written before it is read and a piece file removed before it is created again
+    m_threadPool->setMaxThreadCount(1);
+    m_threadPool->setObjectName("PersistentReadCache m_threadPool");
+    m_threadPool->start([this] { load(); });
+}
+
+PersistentReadCache::~PersistentReadCache()
+{
+    close();
+    delete m_threadPool;
+}
+
+Path PersistentReadCache::dirPath() const
+{
+    return m_dirPath;
+}
+
+qint64 PersistentReadCache::capacity() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_capacity;
+}
+
+void PersistentReadCache::setCapacity(const qint64 capacity)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    m_capacity = std::max<qint64>(capacity, 0);
+    if (m_isLoaded && !m_isClosed)
+        evictPieces();
+}
+
+bool PersistentReadCache::read(const BlockKey &key, ReadHandler handler)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if (!m_isLoaded || m_isClosed)
+        return false;
+
+    const auto pieceIter = m_pieces.find({key.torrentID, key.piece});
+    if (pieceIter == m_pieces.end())
+        return false;
+
+    CachedPiece &piece = pieceIter->second;
+    const auto blockIter = piece.blocks.constFind({key.offset, key.length});
+    if (blockIter == piece.blocks.cend())
+        return false;
+
+    ++m_hits;
+    m_piecesLRU.splice(m_piecesLRU.begin(), m_piecesLRU, piece.lruIter);
+
+    m_threadPool->start([filePath = piecePath(pieceIter->first), position = blockIter.value(), length = key.length, handler = std::move(handler)]
+    {
+        handler(readBlock(filePath, position, length));
+    });
+    return true;
+}
+
+void PersistentReadCache::store(const BlockKey &key, const QByteArray &data)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if (!m_isLoaded || m_isClosed || data.isEmpty() || (data.size() > m_capacity))
+        return;
+
+    const PieceKey pieceKey {key.torrentID, key.piece};
+    const auto [pieceIter, isNewPiece] = m_pieces.try_emplace(pieceKey);
+    CachedPiece &piece = pieceIter->second;
+    if (isNewPiece)
+    {
+        m_piecesLRU.push_front(pieceKey);
+        piece.lruIter = m_piecesLRU.begin();
+    }
+    else if (piece.blocks.contains({key.offset, key.length}))
+    {
+        return;
+    }
+    else
+    {
+        m_piecesLRU.splice(m_piecesLRU.begin(), m_piecesLRU, piece.lruIter);
+    }
+
+    // Blocks are appended to the piece file
+    const qint64 position = piece.fileSize;
+    piece.blocks.insert({key.offset, key.length}, position);
+    piece.fileSize += data.size();
+    m_size += data.size();
+
+    m_threadPool->start([this, pieceKey, filePath = piecePath(pieceKey), position, data]
+    {
+        if (writeBlock(filePath, position, data))
+            return;
+
+        const QMutexLocker locker {&m_mutex};
+        if (const auto iter = m_pieces.find(pieceKey); iter != m_pieces.end())
+            erasePiece(iter);
+    });
+
+    evictPieces();
+}
+
+void PersistentReadCache::removePiece(const QString &torrentID, const int piece)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if (m_isClosed)
+        return;
+
+    if (!m_isLoaded)
+    {
+        m_removedPieces.insert({torrentID, piece});
+        return;
+    }
+
+    if (const auto pieceIter = m_pieces.find({torrentID, piece}); pieceIter != m_pieces.end())
+        erasePiece(pieceIter);
+}
+
+void PersistentReadCache::removeTorrent(const QString &torrentID)
+{
+    const QMutexLocker locker {&m_mutex};
+
+    if (m_isClosed)
+        return;
+
+    if (!m_isLoaded)
+    {
+        m_removedTorrents.insert(torrentID);
+        return;
+    }
+
+    auto pieceIter = m_pieces.lower_bound({torrentID, std::numeric_limits<int>::min()});
+    while ((pieceIter != m_pieces.end()) && (pieceIter->first.torrentID == torrentID))
+        erasePiece(pieceIter++);
+}
+
+void PersistentReadCache::waitForDone()
+{
+    m_threadPool->waitForDone();
+}
+
+void PersistentReadCache::close()
+{
+    {
+        const QMutexLocker locker {&m_mutex};
+        if (m_isClosed)
+            return;
+
+        m_isClosed = true;
+    }
+
+    m_threadPool->waitForDone();
+
+    const QMutexLocker locker {&m_mutex};
+    if (!m_isLoaded)
+        return;
+
+    const Path indexPath = m_dirPath / Path(INDEX_FILE_NAME);
+    if (const auto result = Utils::IO::saveToFile(indexPath, serializeIndex()); !result)
+    {
+        LogMsg(QCoreApplication::translate("PersistentReadCache", "Failed to save persistent read cache index. File: \"%1\". Error: \"%2\"")
+            .arg(indexPath.toString(), result.error()), Log::WARNING);
+    }
+}
+
+PersistentReadCache::Statistics PersistentReadCache::statistics() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return {m_hits, m_size, m_capacity};
+}
+
+void PersistentReadCache::load()
+{
+    Pieces pieces;
+    std::list<PieceKey> piecesLRU;
+
+    const Path indexPath = m_dirPath / Path(INDEX_FILE_NAME);
+    if (const auto readResult = Utils::IO::readFile(indexPath, MAX_INDEX_FILE_SIZE))
+    {
+        QDataStream stream {readResult.value()};
+        qint32 version = 0;
+        qint64 pieceCount = 0;
+        stream >> version >> pieceCount;
+        if (version == INDEX_VERSION)
+        {
+            // pieces are stored in LRU order
+            for (qint64 i = 0; (i < pieceCount) && (stream.status() == QDataStream::Ok); ++i)
+            {
+                PieceKey pieceKey;
+                CachedPiece piece;
+                qint64 blockCount = 0;
+                stream >> pieceKey.torrentID >> pieceKey.piece >> piece.fileSize >> blockCount;
+                for (qint64 j = 0; (j < blockCount) && (stream.status() == QDataStream::Ok); ++j)
+                {
+                    qint32 offset = 0;
+                    qint32 length = 0;
+                    qint64 position = 0;
+                    stream >> offset >> length >> position;
+                    piece.blocks.insert({offset, length}, position);
+                }
+
+                if (const auto [pieceIter, isInserted] = pieces.try_emplace(pieceKey, std::move(piece)); isInserted)
+                {
+                    piecesLRU.push_back(pieceKey);
+                    pieceIter->second.lruIter = std::prev(piecesLRU.end());
+                }
+            }
+        }
+
+        if (stream.status() != QDataStream::Ok)
+        {
+            LogMsg(QCoreApplication::translate("PersistentReadCache", "Persistent read cache index is corrupted. File: \"%1\"")
+                .arg(indexPath.toString()), Log::WARNING);
+            pieces.clear();
+            piecesLRU.clear();
+        }
+    }
+
+    // The index is saved again when the cache is closed. If it is missing on the next start
+    // the cache wasn't closed properly so the content of the piece files can't be trusted.
+    Utils::Fs::removeFile(indexPath);
+
+    // Remove the piece files which the index doesn't refer to
+    std::set<PieceKey> foundPieces;
+    const QStringList torrentDirNames = QDir(m_dirPath.data()).entryList((QDir::Dirs | QDir::NoDotAndDotDot));
+    for (const QString &torrentDirName : torrentDirNames)
+    {
+        if (!isTorrentID(torrentDirName))
+            continue;
+
+        const Path torrentDirPath = m_dirPath / Path(torrentDirName);
+        const QFileInfoList pieceFiles = QDir(torrentDirPath.data()).entryInfoList(QDir::Files);
+        for (const QFileInfo &pieceFile : pieceFiles)
+        {
+            bool isPieceIndex = false;
+            const int pieceIndex = pieceFile.fileName().toInt(&isPieceIndex);
+            if (!isPieceIndex)
+                continue;
+
+            const PieceKey pieceKey {torrentDirName, pieceIndex};
+            const auto pieceIter = pieces.find(pieceKey);
+            if ((pieceIter != pieces.end()) && (pieceFile.size() >= pieceIter->second.fileSize))
+                foundPieces.insert(pieceKey);
+            else
+                Utils::Fs::removeFile(Path(pieceFile.filePath()));
+        }
+
+        Utils::Fs::smartRemoveEmptyFolderTree(torrentDirPath);
+    }
+
+    qint64 size = 0;
+    for (auto pieceIter = pieces.begin(); pieceIter != pieces.end();)
+    {
+        if (foundPieces.contains(pieceIter->first))
+        {
+            size += pieceIter->second.fileSize;
+            ++pieceIter;
+        }
+        else
+        {
+            piecesLRU.erase(pieceIter->second.lruIter);
+            pieceIter = pieces.erase(pieceIter);
+        }
+    }
+
+    const QMutexLocker locker {&m_mutex};
+
+    m_pieces = std::move(pieces);
+    m_piecesLRU = std::move(piecesLRU);
+    m_size = size;
+    m_isLoaded = true;
+
+    for (const PieceKey &pieceKey : m_removedPieces)
+    {
+        if (const auto pieceIter = m_pieces.find(pieceKey); pieceIter != m_pieces.end())
+            erasePiece(pieceIter);
+    }
+    m_removedPieces.clear();
+
+    for (const QString &torrentID : m_removedTorrents)
+    {
+        auto pieceIter = m_pieces.lower_bound({torrentID, std::numeric_limits<int>::min()});
+        while ((pieceIter != m_pieces.end()) && (pieceIter->first.torrentID == torrentID))
+            erasePiece(pieceIter++);
+    }
+    m_removedTorrents.clear();
+
+    evictPieces();
+}
+
+QByteArray PersistentReadCache::serializeIndex() const
+{
+    QByteArray data;
+    QDataStream stream {&data, QIODevice::WriteOnly};
+    stream << INDEX_VERSION << static_cast<qint64>(m_piecesLRU.size());
+    for (const PieceKey &pieceKey : m_piecesLRU)
+    {
+        const CachedPiece &piece = m_pieces.at(pieceKey);
+        stream << pieceKey.torrentID << static_cast<qint32>(pieceKey.piece) << piece.fileSize
+            << static_cast<qint64>(piece.blocks.size());
+        for (auto blockIter = piece.blocks.cbegin(); blockIter != piece.blocks.cend(); ++blockIter)
+        {
+            stream << static_cast<qint32>(blockIter.key().first) << static_cast<qint32>(blockIter.key().second)
+                << blockIter.value();
+        }
+    }
+
+    return data;
+}
+
+Path PersistentReadCache::piecePath(const PieceKey &key) const
+{
+    return m_dirPath / Path(key.torrentID) / Path(QString::number(key.piece));
+}
+
+void PersistentReadCache::erasePiece(const Pieces::iterator pieceIter)
+{
+    m_size -= pieceIter->second.fileSize;
+    m_piecesLRU.erase(pieceIter->second.lruIter);
+    m_threadPool->start([filePath = piecePath(pieceIter->first)]
+    {
+        Utils::Fs::removeFile(filePath);
+    });
+    m_pieces.erase(pieceIter);
+}
+
+void PersistentReadCache::evictPieces()
+{
+    while (m_size > m_capacity)
+        erasePiece(m_pieces.find(m_piecesLRU.back()));
+}
@@ -0,0 +1,140 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+#include <list>
+#include <map>
+#include <set>
+#include <tuple>
+#include <utility>
+
+#include <QtTypes>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+#include "base/path.h"
+
+class QThreadPool;
+
+// Keeps the blocks evicted from DiskReadCache in a cache directory (e.g. on an SSD)
+// so they can be read from there instead of the slow storage of the torrent content.
+// The cached blocks of a piece are appended to a single file and the pieces are
+// evicted as a whole in least recently used order. The files are read and written
+// by a worker thread. The index of cached blocks is saved when the cache is closed
+// and loaded back the next time, so it survives restarts.
+class PersistentReadCache
+{
+    Q_DISABLE_COPY_MOVE(PersistentReadCache)
+
+public:
+    struct BlockKey
+    {
+        QString torrentID;
+        int piece = 0;
+        int offset = 0;
+        int length = 0;
+    };
+
+    struct Statistics
+    {
+        qint64 hits = 0;
+        qint64 size = 0;
+        qint64 capacity = 0;
+    };
+
+    // Receives null QByteArray if the block couldn't be read
+    using ReadHandler = std::function<void (const QByteArray &data)>;
+
+    PersistentReadCache(const Path &dirPath, qint64 capacity);
+    ~PersistentReadCache();
+
+    Path dirPath() const;
+    qint64 capacity() const;
+    void setCapacity(qint64 capacity);
+
+    // Returns `false` if the block isn't cached,
+    // otherwise `handler` is invoked with its data in the worker thread
+    bool read(const BlockKey &key, ReadHandler handler);
+    void store(const BlockKey &key, const QByteArray &data);
+    void removePiece(const QString &torrentID, int piece);
+    void removeTorrent(const QString &torrentID);
+
+    // Waits for the pending reads and writes
+    void waitForDone();
+    // Finishes pending jobs and saves the index, the cache isn't used anymore
+    void close();
+
+    Statistics statistics() const;
+
+private:
+    struct PieceKey
+    {
+        QString torrentID;
+        int piece = 0;
+
+        friend bool operator<(const PieceKey &left, const PieceKey &right)
+        {
+            return std::tie(left.torrentID, left.piece) < std::tie(right.torrentID, right.piece);
+        }
+    };
+
+    struct CachedPiece
+    {
+        // (offset, length) of a block -> its position in the piece file
+        QHash<std::pair<int, int>, qint64> blocks;
+        qint64 fileSize = 0;
+        std::list<PieceKey>::iterator lruIter;
+    };
+
+    using Pieces = std::map<PieceKey, CachedPiece>;
+
+    void load();
+    QByteArray serializeIndex() const;
+    Path piecePath(const PieceKey &key) const;
+    void erasePiece(Pieces::iterator pieceIter);
+    void evictPieces();
+
+    const Path m_dirPath;
+    QThreadPool *m_threadPool = nullptr;
+
+    mutable QMutex m_mutex;
+    bool m_isLoaded = false;
+    bool m_isClosed = false;
+    // Removals requested while the index is being loaded
+    std::set<PieceKey> m_removedPieces;
+    std::set<QString> m_removedTorrents;
+    qint64 m_capacity = 0;
+    qint64 m_size = 0;
+    qint64 m_hits = 0;
+    Pieces m_pieces;
+    std::list<PieceKey> m_piecesLRU;
+};
@@ -28,15 +28,24 @@
 
 #include "resumedatastorage.h"
 
+#include <memory>
 #include <utility>
 
 #include <QList>
 #include <QMetaObject>
 #include <QMutexLocker>
+#include <QPromise>
 #include <QThread>
+#include <QThreadPool>
 
 const int TORRENTIDLIST_TYPEID = qRegisterMetaType<QList<BitTorrent::TorrentID>>();
 
+namespace
+{
+    // Limits the memory used by the resume data waiting to be reported in order
+    const int MAX_PARSING_JOBS_PER_THREAD = 16;
+}
+
 BitTorrent::ResumeDataStorage::ResumeDataStorage(const Path &path, QObject *parent)
     : QObject(parent)
     , m_path {path}
@@ -48,6 +57,16 @@ Path BitTorrent::ResumeDataStorage::path() const
     return m_path;
 }
 
+bool BitTorrent::ResumeDataStorage::canStoreCounters() const
+{
+    return false;
+}
+
+void BitTorrent::ResumeDataStorage::storeCounters([[maybe_unused]] const TorrentID &id, [[maybe_unused]] const TorrentCounters &counters) const
+{
+    // Counters are stored along with the rest of resume data
+}
+
 void BitTorrent::ResumeDataStorage::loadAll() const
 {
     m_loadedResumeData.reserve(1024);
@@ -55,6 +74,8 @@ void BitTorrent::ResumeDataStorage::loadAll() const
     auto *loadingThread = QThread::create([this]()
     {
         doLoadAll();
+        reportParsedResumeData(true);
+        emit const_cast<ResumeDataStorage *>(this)->loadFinished();
     });
     loadingThread->setObjectName("ResumeDataStorage::loadAll loadingThread");
     connect(loadingThread, &QThread::finished, loadingThread, &QObject::deleteLater);
@@ -63,16 +84,69 @@ void BitTorrent::ResumeDataStorage::loadAll() const
 
 QList<BitTorrent::LoadedResumeData> BitTorrent::ResumeDataStorage::fetchLoadedResumeData() const
 {
-    const QMutexLocker locker {&m_loadedResumeDataMutex};
-
-    const QList<BitTorrent::LoadedResumeData> loadedResumeData = m_loadedResumeData;
-    m_loadedResumeData.clear();
+    // the loaded resume data is handed over as is, the storage continues with another preallocated list
+    QList<BitTorrent::LoadedResumeData> loadedResumeData;
+    loadedResumeData.reserve(1024);
 
+    const QMutexLocker locker {&m_loadedResumeDataMutex};
+    m_loadedResumeData.swap(loadedResumeData);
     return loadedResumeData;
 }
 
 void BitTorrent::ResumeDataStorage::onResumeDataLoaded(const TorrentID &torrentID, LoadResumeDataResult loadResumeDataResult) const
 {
+    // keep the order if some resume data is still being parsed
+    reportParsedResumeData(true);
+
     const QMutexLocker locker {&m_loadedResumeDataMutex};
     m_loadedResumeData.append({.torrentID = torrentID, .result = std::move(loadResumeDataResult)});
 }
+
+void BitTorrent::ResumeDataStorage::parseResumeData(const TorrentID &torrentID, std::function<LoadResumeDataResult ()> parseFunc) const
+{
+    auto promise = std::make_shared<QPromise<LoadResumeDataResult>>();
+    m_parsingJobs.push_back({.torrentID = torrentID, .result = promise->future()});
+    promise->start();
+    QThreadPool::globalInstance()->start([promise, parseFunc = std::move(parseFunc)]
+    {
+        promise->addResult(parseFunc());
+        promise->finish();
+    });
+
+    const auto maxParsingJobsCount = static_cast<std::size_t>(QThreadPool::globalInstance()->maxThreadCount() * MAX_PARSING_JOBS_PER_THREAD);
+    while (m_parsingJobs.size() > maxParsingJobsCount)
+    {
+        m_parsingJobs.front().result.waitForFinished();
+        reportParsedResumeData(false);
+    }
+
+    reportParsedResumeData(false);
+}
+
+void BitTorrent::ResumeDataStorage::reportParsedResumeData(const bool wait) const
+{
+    if (m_parsingJobs.empty())
+        return;
+
+    QList<LoadedResumeData> parsedResumeData;
+    while (!m_parsingJobs.empty())
+    {
+        ParsingJob &job = m_parsingJobs.front();
+        if (!job.result.isFinished())
+        {
+            if (!wait)
+                break;
+
+            job.result.waitForFinished();
+        }
+
+        parsedResumeData.append({.torrentID = job.torrentID, .result = job.result.takeResult()});
+        m_parsingJobs.pop_front();
+    }
+
+    if (parsedResumeData.isEmpty())
+        return;
+
+    const QMutexLocker locker {&m_loadedResumeDataMutex};
+    m_loadedResumeData.append(std::move(parsedResumeData));
+}
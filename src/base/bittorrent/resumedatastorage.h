@@ -28,7 +28,11 @@
 
 #pragma once
 
+#include <deque>
+#include <functional>
+
 #include <QtContainerFwd>
+#include <QFuture>
 #include <QList>
 #include <QMutex>
 #include <QObject>
@@ -37,6 +41,7 @@
 #include "base/path.h"
 #include "infohash.h"
 #include "loadtorrentparams.h"
+#include "torrentcounters.h"
 
 namespace BitTorrent
 {
@@ -63,6 +68,10 @@ namespace BitTorrent
         virtual void store(const TorrentID &id, LoadTorrentParams resumeData) const = 0;
         virtual void remove(const TorrentID &id) const = 0;
         virtual void storeQueue(const QList<TorrentID> &queue) const = 0;
+        // Storage that is able to update torrent counters without rewriting
+        // entire resume data should override both of the following
+        virtual bool canStoreCounters() const;
+        virtual void storeCounters(const TorrentID &id, const TorrentCounters &counters) const;
 
         void loadAll() const;
         QList<LoadedResumeData> fetchLoadedResumeData() const;
@@ -73,12 +82,25 @@ namespace BitTorrent
 
     protected:
         void onResumeDataLoaded(const TorrentID &torrentID, LoadResumeDataResult loadResumeDataResult) const;
+        // Runs the parsing in the thread pool. Results are reported in the order of submission.
+        // Intended to be called by doLoadAll() implementations only.
+        void parseResumeData(const TorrentID &torrentID, std::function<LoadResumeDataResult ()> parseFunc) const;
 
     private:
+        struct ParsingJob
+        {
+            TorrentID torrentID;
+            QFuture<LoadResumeDataResult> result;
+        };
+
         virtual void doLoadAll() const = 0;
 
+        void reportParsedResumeData(bool wait) const;
+
         const Path m_path;
         mutable QList<LoadedResumeData> m_loadedResumeData;
         mutable QMutex m_loadedResumeDataMutex;
+        // Accessed by loading thread only
+        mutable std::deque<ParsingJob> m_parsingJobs;
     };
 }
@@ -37,8 +37,11 @@
 #include "addtorrenterror.h"
 #include "addtorrentparams.h"
 #include "categoryoptions.h"
+#include "metadatadownloadscheduler.h"
 #include "sharelimitaction.h"
+#include "storagevolumeinfo.h"
 #include "torrentcontentremoveoption.h"
+#include "torrentcontentremovingjobinfo.h"
 #include "trackerentry.h"
 #include "trackerentrystatus.h"
 
@@ -51,8 +54,15 @@ namespace BitTorrent
     class TorrentDescriptor;
     class TorrentID;
     class TorrentInfo;
+    class TorrentStatusTable;
+    struct AlertStatistics;
     struct CacheStatus;
+    struct DiskIOStatistics;
+    struct MoveStorageJobInfo;
+    struct PeerStatistics;
+    struct SessionMetric;
     struct SessionStatus;
+    struct TorrentSnapshot;
 
     enum class TorrentRemoveOption
     {
@@ -75,6 +85,14 @@ namespace BitTorrent
         };
         Q_ENUM_NS(BTProtocol)
 
+        enum class CheckingQueueOrder : int
+        {
+            QueuePosition = 0,
+            SmallestFirst = 1,
+            SavePath = 2
+        };
+        Q_ENUM_NS(CheckingQueueOrder)
+
         enum class ChokingAlgorithm : int
         {
             FixedSlots = 0,
@@ -94,7 +112,8 @@ namespace BitTorrent
             Default = 0,
             MMap = 1,
             Posix = 2,
-            SimplePreadPwrite = 3
+            SimplePreadPwrite = 3,
+            IOUring = 4
         };
         Q_ENUM_NS(DiskIOType)
 
@@ -115,6 +134,13 @@ namespace BitTorrent
         };
         Q_ENUM_NS(MixedModeAlgorithm)
 
+        enum class PerformanceProfile : int
+        {
+            Manual = 0,
+            Auto = 1
+        };
+        Q_ENUM_NS(PerformanceProfile)
+
         enum class SeedChokingAlgorithm : int
         {
             RoundRobin = 0,
@@ -126,7 +152,8 @@ namespace BitTorrent
         enum class ResumeDataStorageType
         {
             Legacy,
-            SQLite
+            SQLite,
+            Journal
         };
         Q_ENUM_NS(ResumeDataStorageType)
     }
@@ -141,6 +168,17 @@ namespace BitTorrent
         static void freeInstance();
         static Session *instance();
 
+        // Change notifications and resume data requests of torrents modified within the scope
+        // are deferred and merged until the outermost scope ends
+        class BulkUpdateScope
+        {
+            Q_DISABLE_COPY_MOVE(BulkUpdateScope)
+
+        public:
+            BulkUpdateScope();
+            ~BulkUpdateScope();
+        };
+
         using QObject::QObject;
 
         virtual Path savePath() const = 0;
@@ -231,6 +269,15 @@ namespace BitTorrent
         virtual void setUnwantedFolderEnabled(bool enabled) = 0;
         virtual int refreshInterval() const = 0;
         virtual void setRefreshInterval(int value) = 0;
+        // Refresh is performed at refresh interval while there are refresh subscribers or active transfers,
+        // otherwise it is gradually slowed down. Subscriber can tolerate the data older than refresh interval
+        // by passing longer interval. Subscriber must be removed before it is destroyed.
+        virtual void addRefreshSubscriber(const QObject *subscriber, int interval = 0) = 0;
+        virtual void removeRefreshSubscriber(const QObject *subscriber) = 0;
+        // Availability of the torrents is refreshed at refresh interval only for the torrents watched
+        // by subscribers (e.g. the ones visible in the list), other torrents are refreshed less frequently.
+        // Subscriber stops watching the torrents by passing empty set. It must do it before it is destroyed.
+        virtual void setWatchedTorrents(const QObject *subscriber, const QSet<TorrentID> &torrentIDs) = 0;
         virtual bool isPreallocationEnabled() const = 0;
         virtual void setPreallocationEnabled(bool enabled) = 0;
         virtual Path torrentExportDirectory() const = 0;
@@ -285,6 +332,16 @@ namespace BitTorrent
         virtual void setEncryption(int state) = 0;
         virtual int maxActiveCheckingTorrents() const = 0;
         virtual void setMaxActiveCheckingTorrents(int val) = 0;
+        // Checking torrents are scheduled per storage device, so that torrents stored
+        // on the same disk are checked one after another instead of simultaneously
+        virtual bool isDiskAwareCheckingEnabled() const = 0;
+        virtual void setDiskAwareCheckingEnabled(bool enabled) = 0;
+        virtual int maxActiveCheckingTorrentsPerVolume() const = 0;
+        virtual void setMaxActiveCheckingTorrentsPerVolume(int val) = 0;
+        virtual QHash<QString, int> checkingVolumeLimits() const = 0;
+        virtual void setCheckingVolumeLimits(const QHash<QString, int> &limits) = 0;
+        virtual CheckingQueueOrder checkingQueueOrder() const = 0;
+        virtual void setCheckingQueueOrder(CheckingQueueOrder order) = 0;
         virtual bool isI2PEnabled() const = 0;
         virtual void setI2PEnabled(bool enabled) = 0;
         virtual QString I2PAddress() const = 0;
@@ -327,6 +384,10 @@ namespace BitTorrent
         virtual void setPeerTurnoverInterval(int val) = 0;
         virtual int requestQueueSize() const = 0;
         virtual void setRequestQueueSize(int val) = 0;
+        // The automatic profile sizes disk, connection and buffer settings for the host,
+        // the settings changed from their defaults still override the sized values
+        virtual PerformanceProfile performanceProfile() const = 0;
+        virtual void setPerformanceProfile(PerformanceProfile profile) = 0;
         virtual int asyncIOThreads() const = 0;
         virtual void setAsyncIOThreads(int num) = 0;
         virtual int hashingThreads() const = 0;
@@ -339,10 +400,22 @@ namespace BitTorrent
         virtual void setDiskCacheSize(int size) = 0;
         virtual int diskCacheTTL() const = 0;
         virtual void setDiskCacheTTL(int ttl) = 0;
+        virtual int diskReadCacheSize() const = 0;
+        virtual void setDiskReadCacheSize(int size) = 0;
+        virtual Path persistentReadCachePath() const = 0;
+        virtual void setPersistentReadCachePath(const Path &path) = 0;
+        virtual int persistentReadCacheSize() const = 0;
+        virtual void setPersistentReadCacheSize(int size) = 0;
+        virtual int diskWriteCoalescingSize() const = 0;
+        virtual void setDiskWriteCoalescingSize(int size) = 0;
+        virtual int diskWriteCoalescingTime() const = 0;
+        virtual void setDiskWriteCoalescingTime(int time) = 0;
         virtual qint64 diskQueueSize() const = 0;
         virtual void setDiskQueueSize(qint64 size) = 0;
         virtual DiskIOType diskIOType() const = 0;
         virtual void setDiskIOType(DiskIOType type) = 0;
+        virtual int nativeSessionShards() const = 0;
+        virtual void setNativeSessionShards(int shards) = 0;
         virtual DiskIOReadMode diskIOReadMode() const = 0;
         virtual void setDiskIOReadMode(DiskIOReadMode mode) = 0;
         virtual DiskIOWriteMode diskIOWriteMode() const = 0;
@@ -399,7 +472,7 @@ namespace BitTorrent
         virtual void setMaxConcurrentHTTPAnnounces(int value) = 0;
         virtual bool isReannounceWhenAddressChangedEnabled() const = 0;
         virtual void setReannounceWhenAddressChangedEnabled(bool enabled) = 0;
-        virtual void reannounceToAllTrackers() const = 0;
+        virtual void reannounceToAllTrackers() = 0;
         virtual int stopTrackerTimeout() const = 0;
         virtual void setStopTrackerTimeout(int value) = 0;
         virtual int maxConnections() const = 0;
@@ -410,6 +483,17 @@ namespace BitTorrent
         virtual void setMaxUploads(int max) = 0;
         virtual int maxUploadsPerTorrent() const = 0;
         virtual void setMaxUploadsPerTorrent(int max) = 0;
+        // The global and per torrent upload slots limits are scaled to keep the uplink utilized
+        virtual bool isUnchokeSlotsTuningEnabled() const = 0;
+        virtual void setUnchokeSlotsTuningEnabled(bool enabled) = 0;
+        // Seeding torrents without demand are paused until a scrape finds leechers for them
+        virtual bool isDormantSeedsEnabled() const = 0;
+        virtual void setDormantSeedsEnabled(bool enabled) = 0;
+        // In minutes
+        virtual int dormantSeedIdleTime() const = 0;
+        virtual void setDormantSeedIdleTime(int minutes) = 0;
+        virtual int dormantSeedScrapeInterval() const = 0;
+        virtual void setDormantSeedScrapeInterval(int minutes) = 0;
         virtual int maxActiveDownloads() const = 0;
         virtual void setMaxActiveDownloads(int max) = 0;
         virtual int maxActiveUploads() const = 0;
@@ -445,14 +529,25 @@ namespace BitTorrent
         virtual void setBannedIPs(const QStringList &newList) = 0;
         virtual ResumeDataStorageType resumeDataStorageType() const = 0;
         virtual void setResumeDataStorageType(ResumeDataStorageType type) = 0;
+        virtual int resumeDataStorageBatchSize() const = 0;
+        virtual void setResumeDataStorageBatchSize(int size) = 0;
+        virtual bool isResumeDataStorageCompressionEnabled() const = 0;
+        virtual void setResumeDataStorageCompressionEnabled(bool enabled) = 0;
+        virtual bool isStoppedTorrentsColdModeEnabled() const = 0;
+        virtual void setStoppedTorrentsColdModeEnabled(bool enabled) = 0;
         virtual bool isMergeTrackersEnabled() const = 0;
         virtual void setMergeTrackersEnabled(bool enabled) = 0;
         virtual bool isStartPaused() const = 0;
         virtual void setStartPaused(bool value) = 0;
         virtual TorrentContentRemoveOption torrentContentRemoveOption() const = 0;
         virtual void setTorrentContentRemoveOption(TorrentContentRemoveOption option) = 0;
+        // Maximum number of files removed per second, 0 means unlimited
+        virtual int torrentContentRemovingRate() const = 0;
+        virtual void setTorrentContentRemovingRate(int filesPerSecond) = 0;
 
         virtual bool isRestored() const = 0;
+        // Torrents saved at last shutdown, available until the session is restored
+        virtual QList<TorrentSnapshot> startupSnapshots() const = 0;
 
         virtual bool isPaused() const = 0;
         virtual void pause() = 0;
@@ -460,10 +555,32 @@ namespace BitTorrent
 
         virtual Torrent *getTorrent(const TorrentID &id) const = 0;
         virtual Torrent *findTorrent(const InfoHash &infoHash) const = 0;
+        // Returns a copy of the list, torrentStatusTable().torrents() can be iterated without copying
+        // as long as the torrents aren't added or removed meanwhile
         virtual QList<Torrent *> torrents() const = 0;
+        // Status fields of all the torrents, which are cheaper to scan than the torrents themselves,
+        // along with the numbers of the torrents by state and by group (e.g. downloading)
+        virtual const TorrentStatusTable &torrentStatusTable() const = 0;
         virtual qsizetype torrentsCount() const = 0;
+        // Rough estimation of the memory used by the torrents data (not including libtorrent's own data)
+        virtual qint64 estimatedTorrentsMemoryUsage() const = 0;
         virtual const SessionStatus &status() const = 0;
         virtual const CacheStatus &cacheStatus() const = 0;
+        virtual const AlertStatistics &alertStatistics() const = 0;
+        // Traffic exchanged with the peers of all the torrents
+        virtual PeerStatistics peerStatistics() const = 0;
+        // Statistics of the disk IO jobs of the torrent (libtorrent 2 only)
+        virtual DiskIOStatistics torrentDiskIOStatistics(const TorrentID &id) const = 0;
+        // Statistics of the disk IO jobs by storage device (libtorrent 2 only)
+        virtual QHash<QString, DiskIOStatistics> volumeDiskIOStatistics() const = 0;
+        // All libtorrent session statistics counters as of the last refresh
+        virtual const QList<SessionMetric> &sessionMetrics() const = 0;
+        // Number of torrents whose resume data is being saved
+        virtual int pendingResumeDataCount() const = 0;
+        // Queued and running storage move jobs followed by the recently finished ones
+        virtual QList<MoveStorageJobInfo> moveStorageJobs() const = 0;
+        // Content of the removed torrents being deleted in the background, in queue order
+        virtual QList<TorrentContentRemovingJobInfo> torrentContentRemovingJobs() const = 0;
         virtual bool isListening() const = 0;
 
         virtual void banIP(const QString &ip) = 0;
@@ -471,7 +588,12 @@ namespace BitTorrent
         virtual bool isKnownTorrent(const InfoHash &infoHash) const = 0;
         virtual bool addTorrent(const TorrentDescriptor &torrentDescr, const AddTorrentParams &params = {}) = 0;
         virtual bool removeTorrent(const TorrentID &id, TorrentRemoveOption deleteOption = TorrentRemoveOption::KeepContent) = 0;
-        virtual bool downloadMetadata(const TorrentDescriptor &torrentDescr) = 0;
+        virtual int maxActiveMetadataDownloads() const = 0;
+        virtual void setMaxActiveMetadataDownloads(int val) = 0;
+        // The metadata downloads are queued above the limit of the active ones,
+        // the recently downloaded metadata is reported right away
+        virtual bool downloadMetadata(const TorrentDescriptor &torrentDescr
+                , MetadataDownloadPriority priority = MetadataDownloadPriority::Normal) = 0;
         virtual bool cancelDownloadMetadata(const TorrentID &id) = 0;
 
         virtual void increaseTorrentsQueuePos(const QList<TorrentID> &ids) = 0;
@@ -483,6 +605,14 @@ namespace BitTorrent
         virtual QString lastExternalIPv6Address() const = 0;
 
         virtual qint64 freeDiskSpace() const = 0;
+        // Storage devices the torrents and the default and category paths are located on
+        virtual QList<StorageVolumeInfo> storageVolumes() const = 0;
+        // Minimum free space in MiB of a volume to keep downloading to it, 0 disables the check
+        virtual int lowDiskSpaceThreshold() const = 0;
+        virtual void setLowDiskSpaceThreshold(int size) = 0;
+
+        virtual void beginBulkUpdate() = 0;
+        virtual void endBulkUpdate() = 0;
 
     signals:
         void startupProgressUpdated(int progress);
@@ -522,7 +652,11 @@ namespace BitTorrent
         void trackersRemoved(Torrent *torrent, const QStringList &trackers);
         void trackerSuccess(Torrent *torrent, const QString &tracker);
         void trackerWarning(Torrent *torrent, const QString &tracker);
-        void trackerEntryStatusesUpdated(Torrent *torrent, const QHash<QString, TrackerEntryStatus> &updatedTrackers);
+        // Statuses of all the torrents updated within a short period are reported at once
+        void trackerEntryStatusesUpdated(const QHash<Torrent *, QHash<QString, TrackerEntryStatus>> &updatedTrackers);
         void freeDiskSpaceChecked(qint64 result);
+        void storageVolumesChecked(const QList<StorageVolumeInfo> &volumes);
+        void torrentContentRemovingJobUpdated(const TorrentContentRemovingJobInfo &job);
+        void torrentContentRemovingJobFinished(const TorrentContentRemovingJobInfo &job);
     };
 }
@@ -33,8 +33,11 @@
 #include <concepts>
 #include <cstdint>
 #include <ctime>
+#include <numeric>
 #include <ranges>
 #include <string>
+#include <unordered_set>
+#include <utility>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -47,6 +50,8 @@
 #include <libtorrent/add_torrent_params.hpp>
 #include <libtorrent/address.hpp>
 #include <libtorrent/alert_types.hpp>
+#include <libtorrent/bdecode.hpp>
+#include <libtorrent/entry.hpp>
 #include <libtorrent/error_code.hpp>
 #include <libtorrent/extensions/smart_ban.hpp>
 #include <libtorrent/extensions/ut_metadata.hpp>
@@ -62,6 +67,7 @@
 #include <QDeadlineTimer>
 #include <QDebug>
 #include <QDir>
+#include <QElapsedTimer>
 #include <QFuture>
 #include <QHostAddress>
 #include <QJsonArray>
@@ -71,7 +77,6 @@
 #include <QMutexLocker>
 #include <QNetworkAddressEntry>
 #include <QNetworkInterface>
-#include <QPromise>
 #include <QRegularExpression>
 #include <QString>
 #include <QThread>
@@ -79,6 +84,7 @@
 #include <QUuid>
 
 #include "base/algorithm.h"
+#include "base/asyncfilestorage.h"
 #include "base/freediskspacechecker.h"
 #include "base/global.h"
 #include "base/logger.h"
@@ -86,6 +92,8 @@
 #include "base/net/proxyconfigurationmanager.h"
 #include "base/preferences.h"
 #include "base/profile.h"
+#include "base/tracer.h"
+#include "base/types.h"
 #include "base/unicodestrings.h"
 #include "base/utils/fs.h"
 #include "base/utils/io.h"
@@ -98,18 +106,25 @@
 #include "bencoderesumedatastorage.h"
 #include "customstorage.h"
 #include "dbresumedatastorage.h"
+#include "diskiostatistics.h"
+#include "diskreadcache.h"
 #include "speedprofile.h"
 #include "downloadpriority.h"
 #include "extensiondata.h"
+#include "filepreallocator.h"
 #include "filesearcher.h"
 #include "filterparserthread.h"
+#include "journalresumedatastorage.h"
 #include "loadtorrentparams.h"
 #include "lttypecast.h"
 #include "nativesessionextension.h"
+#include "peerstatistics.h"
+#include "persistentreadcache.h"
 #include "portforwarderimpl.h"
 #include "resumedatastorage.h"
 #include "torrentcontentremover.h"
 #include "torrentdescriptor.h"
+#include "torrentfileexporter.h"
 #include "torrentimpl.h"
 #include "tracker.h"
 #include "trackerentry.h"
@@ -119,8 +134,42 @@ using namespace std::chrono_literals;
 using namespace BitTorrent;
 
 const Path CATEGORIES_FILE_NAME {u"categories.json"_s};
-const int MAX_PROCESSING_RESUMEDATA_COUNT = 50;
+const Path DHT_STATE_FILE_NAME {u"dht.state"_s};
+const int MIN_PROCESSING_RESUMEDATA_COUNT = 50;
+const int MAX_PROCESSING_RESUMEDATA_COUNT = 1000;
 const std::chrono::seconds FREEDISKSPACE_CHECK_TIMEOUT = 30s;
+const std::chrono::minutes COLD_TORRENTS_CHECK_INTERVAL = 5min;
+const std::chrono::seconds SHARE_LIMITS_CHECK_INTERVAL = 10s;
+// Share limits of each torrent are re-evaluated at least this often regardless of its estimated deadline
+const std::chrono::minutes SHARE_LIMITS_MAX_CHECK_DELAY = 30min;
+const int MAX_IDLE_REFRESH_INTERVAL = 30000;  // ms
+const std::chrono::milliseconds BANNED_IPS_APPLY_DELAY = 500ms;
+const std::chrono::milliseconds TRACKER_ENTRY_STATUSES_UPDATE_DELAY = 500ms;
+const std::chrono::milliseconds CATEGORIES_STORING_DELAY = 5s;
+// Availability of the torrents which aren't watched is updated gradually within this interval
+const std::chrono::seconds AVAILABILITY_UPDATE_INTERVAL = 30s;
+const std::chrono::minutes PERFORMANCE_TUNING_INTERVAL = 1min;
+const std::chrono::seconds METADATA_DOWNLOADS_EXPIRY_CHECK_INTERVAL = 30s;
+const std::chrono::minutes DORMANT_SEEDS_CHECK_INTERVAL = 1min;
+// The dormant seeds due to be scraped all at once (e.g. after startup) are scraped gradually
+const int MAX_DORMANT_SEED_SCRAPES_PER_CHECK = 200;
+// The actual file paths of the torrents are updated in batches of about this number of files
+const int ACTUAL_FILE_PATHS_UPDATE_BATCH_SIZE = 5000;
+const std::chrono::milliseconds ACTUAL_FILE_PATHS_UPDATE_INTERVAL = 100ms;
+const int MAX_CACHED_METADATA = 100;
+// The DHT routing table is also saved on exit, it's saved periodically in case of crash
+const std::chrono::minutes DHT_STATE_SAVE_INTERVAL = 15min;
+const int MIN_ALERT_QUEUE_SIZE = 100'000;
+const int MAX_ALERT_QUEUE_SIZE = std::numeric_limits<int>::max() / 2;
+const int ALERT_QUEUE_SIZE_PER_TORRENT = 16;
+// The availability is expensive to query so it is queried separately for some of the torrents only
+const lt::status_flags_t REFRESH_STATUS_FLAGS = lt::status_flags_t::all() & ~(lt::torrent_handle::query_distributed_copies | lt::torrent_handle::query_verified_pieces);
+const int MAX_FINISHED_MOVE_STORAGE_JOBS = 20;
+const qsizetype MIN_TORRENT_PATHS_PRUNE_THRESHOLD = 256;
+const int MIN_CATEGORY_RATE_SHARE = 4096; // bytes per second
+// Changes that require entire resume data to be regenerated
+const lt::resume_data_flags_t SIGNIFICANT_RESUME_DATA_CHANGES = lt::torrent_handle::if_metadata_changed
+        | lt::torrent_handle::if_config_changed | lt::torrent_handle::if_state_changed | lt::torrent_handle::if_download_progress;
 
 namespace
 {
@@ -128,6 +177,18 @@ namespace
     const auto USER_AGENT = QStringLiteral("qBittorrent/" QBT_VERSION_2);
     const QString DEFAULT_DHT_BOOTSTRAP_NODES = u"dht.libtorrent.org:25401, dht.transmissionbt.com:6881, router.bittorrent.com:6881"_s;
 
+    // Makes heap algorithms keep the earliest deadline on top
+    const auto laterShareLimitsDeadline = [](const auto &left, const auto &right)
+    {
+        return (left.deadline > right.deadline);
+    };
+
+    void addToHistogram(AlertHistogram &histogram, const std::array<qint64, (ALERT_HISTOGRAM_SIZE - 1)> &bounds, const qint64 value)
+    {
+        const auto bucket = std::ranges::lower_bound(bounds, value) - bounds.begin();
+        ++histogram[bucket];
+    }
+
     void torrentQueuePositionUp(const lt::torrent_handle &handle)
     {
         try
@@ -152,11 +213,11 @@ namespace
         }
     }
 
-    void torrentQueuePositionTop(const lt::torrent_handle &handle)
+    void torrentQueuePositionBottom(const lt::torrent_handle &handle)
     {
         try
         {
-            handle.queue_position_top();
+            handle.queue_position_bottom();
         }
         catch (const std::exception &exc)
         {
@@ -164,11 +225,11 @@ namespace
         }
     }
 
-    void torrentQueuePositionBottom(const lt::torrent_handle &handle)
+    void torrentQueuePositionSet(const lt::torrent_handle &handle, const int position)
     {
         try
         {
-            handle.queue_position_bottom();
+            handle.queue_position_set(lt::queue_position_t {position});
         }
         catch (const std::exception &exc)
         {
@@ -302,6 +363,32 @@ namespace
     }
 #endif
 
+    // Max-min fair distribution of the limit among the demands,
+    // the part of the limit which nobody needs is split evenly
+    QList<int> shareLimit(const int limit, const QList<int> &demands)
+    {
+        const qsizetype count = demands.size();
+        QList<qsizetype> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::ranges::sort(order, {}, [&demands](const qsizetype index) { return demands[index]; });
+
+        QList<int> shares(count);
+        qint64 remaining = limit;
+        for (qsizetype i = 0; i < count; ++i)
+        {
+            const qsizetype index = order[i];
+            const auto share = static_cast<int>(std::min<qint64>(demands[index], (remaining / (count - i))));
+            shares[index] = share;
+            remaining -= share;
+        }
+
+        const qint64 extra = remaining / std::max<qsizetype>(1, count);
+        for (int &share : shares)
+            share = static_cast<int>(std::max<qint64>(1, (share + extra)));
+
+        return shares;
+    }
+
     constexpr lt::move_flags_t toNative(const MoveStorageMode mode)
     {
         switch (mode)
@@ -355,6 +442,39 @@ namespace
         return hasMetadata ? getInfoHash(*addTorrentParams.ti) : InfoHash(addTorrentParams.info_hash);
     }
  #endif
+
+    // Makes the settings of the whole client suitable for one of the sessions it is split into
+    void adjustShardSettings(lt::settings_pack &settingsPack, const qsizetype shard, const qsizetype shardCount)
+    {
+        if (shardCount <= 1)
+            return;
+
+        // The global limits are shared equally by the sessions
+        for (const int limitName : {lt::settings_pack::download_rate_limit, lt::settings_pack::upload_rate_limit
+                , lt::settings_pack::connections_limit, lt::settings_pack::unchoke_slots_limit})
+        {
+            if (settingsPack.has_val(limitName) && (settingsPack.get_int(limitName) > 0))
+                settingsPack.set_int(limitName, std::max(1, static_cast<int>(settingsPack.get_int(limitName) / shardCount)));
+        }
+
+        if (shard == 0)
+            return;
+
+        // Only the first session is discoverable, the other ones listen on any free port
+        for (const int featureName : {lt::settings_pack::enable_dht, lt::settings_pack::enable_lsd
+                , lt::settings_pack::enable_upnp, lt::settings_pack::enable_natpmp})
+        {
+            if (settingsPack.has_val(featureName))
+                settingsPack.set_bool(featureName, false);
+        }
+
+        if (settingsPack.has_val(lt::settings_pack::listen_interfaces))
+        {
+            QString listenInterfaces = QString::fromStdString(settingsPack.get_str(lt::settings_pack::listen_interfaces));
+            listenInterfaces.replace(QRegularExpression(u":\\d+(s?)(?=,|$)"_s), u":0\\1"_s);
+            settingsPack.set_str(lt::settings_pack::listen_interfaces, listenInterfaces.toStdString());
+        }
+    }
 }
 
 struct BitTorrent::SessionImpl::ResumeSessionContext final : public QObject
@@ -365,10 +485,12 @@ struct BitTorrent::SessionImpl::ResumeSessionContext final : public QObject
     ResumeDataStorageType currentStorageType = ResumeDataStorageType::Legacy;
     QList<LoadedResumeData> loadedResumeData;
     int processingResumeDataCount = 0;
+    int processingResumeDataLimit = MIN_PROCESSING_RESUMEDATA_COUNT;
     int64_t totalResumeDataCount = 0;
     int64_t finishedResumeDataCount = 0;
     bool isLoadFinished = false;
     bool isLoadedResumeDataHandlingEnqueued = false;
+    qint64 traceStartTime = -1;
     QSet<QString> recoveredCategories;
 #ifdef QBT_USES_LIBTORRENT2
     QSet<TorrentID> indexedTorrents;
@@ -397,6 +519,16 @@ Session *Session::instance()
     return SessionImpl::m_instance;
 }
 
+Session::BulkUpdateScope::BulkUpdateScope()
+{
+    Session::instance()->beginBulkUpdate();
+}
+
+Session::BulkUpdateScope::~BulkUpdateScope()
+{
+    Session::instance()->endBulkUpdate();
+}
+
 bool Session::isValidCategoryName(const QString &name)
 {
     const QRegularExpression re {uR"(^([^\\\/]|[^\\\/]([^\\\/]|\/(?=[^\/]))*[^\\\/])$)"_s};
@@ -449,14 +581,21 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_IPFilterFile(BITTORRENT_SESSION_KEY(u"IPFilter"_s))
     , m_announceToAllTrackers(BITTORRENT_SESSION_KEY(u"AnnounceToAllTrackers"_s), false)
     , m_announceToAllTiers(BITTORRENT_SESSION_KEY(u"AnnounceToAllTiers"_s), true)
-    , m_asyncIOThreads(BITTORRENT_SESSION_KEY(u"AsyncIOThreadsCount"_s), 10)
-    , m_hashingThreads(BITTORRENT_SESSION_KEY(u"HashingThreadsCount"_s), 1)
-    , m_filePoolSize(BITTORRENT_SESSION_KEY(u"FilePoolSize"_s), 100)
-    , m_checkingMemUsage(BITTORRENT_SESSION_KEY(u"CheckingMemUsageSize"_s), 32)
+    , m_performanceProfile(BITTORRENT_SESSION_KEY(u"PerformanceProfile"_s), PerformanceProfile::Manual)
+    , m_asyncIOThreads(BITTORRENT_SESSION_KEY(u"AsyncIOThreadsCount"_s), PerformanceSettings().asyncIOThreads)
+    , m_hashingThreads(BITTORRENT_SESSION_KEY(u"HashingThreadsCount"_s), PerformanceSettings().hashingThreads)
+    , m_filePoolSize(BITTORRENT_SESSION_KEY(u"FilePoolSize"_s), PerformanceSettings().filePoolSize)
+    , m_checkingMemUsage(BITTORRENT_SESSION_KEY(u"CheckingMemUsageSize"_s), PerformanceSettings().checkingMemUsage)
     , m_diskCacheSize(BITTORRENT_SESSION_KEY(u"DiskCacheSize"_s), -1)
     , m_diskCacheTTL(BITTORRENT_SESSION_KEY(u"DiskCacheTTL"_s), 60)
+    , m_diskReadCacheSize(BITTORRENT_SESSION_KEY(u"DiskReadCacheSize"_s), 0, lowerLimited(0))
+    , m_persistentReadCachePath(BITTORRENT_SESSION_KEY(u"PersistentReadCachePath"_s))
+    , m_persistentReadCacheSize(BITTORRENT_SESSION_KEY(u"PersistentReadCacheSize"_s), 0, lowerLimited(0))
+    , m_diskWriteCoalescingSize(BITTORRENT_SESSION_KEY(u"DiskWriteCoalescingSize"_s), 0, clampValue(0, 1024))
+    , m_diskWriteCoalescingTime(BITTORRENT_SESSION_KEY(u"DiskWriteCoalescingTime"_s), 500, clampValue(10, 10000))
     , m_diskQueueSize(BITTORRENT_SESSION_KEY(u"DiskQueueSize"_s), (1024 * 1024))
     , m_diskIOType(BITTORRENT_SESSION_KEY(u"DiskIOType"_s), DiskIOType::Default)
+    , m_nativeSessionShards(BITTORRENT_SESSION_KEY(u"NativeSessionShards"_s), 1, clampValue(1, 8))
     , m_diskIOReadMode(BITTORRENT_SESSION_KEY(u"DiskIOReadMode"_s), DiskIOReadMode::EnableOSCache)
     , m_diskIOWriteMode(BITTORRENT_SESSION_KEY(u"DiskIOWriteMode"_s), DiskIOWriteMode::EnableOSCache)
 #ifdef Q_OS_WIN
@@ -466,12 +605,12 @@ SessionImpl::SessionImpl(QObject *parent)
 #endif
     , m_usePieceExtentAffinity(BITTORRENT_SESSION_KEY(u"PieceExtentAffinity"_s), false)
     , m_isSuggestMode(BITTORRENT_SESSION_KEY(u"SuggestMode"_s), false)
-    , m_sendBufferWatermark(BITTORRENT_SESSION_KEY(u"SendBufferWatermark"_s), 500)
-    , m_sendBufferLowWatermark(BITTORRENT_SESSION_KEY(u"SendBufferLowWatermark"_s), 10)
-    , m_sendBufferWatermarkFactor(BITTORRENT_SESSION_KEY(u"SendBufferWatermarkFactor"_s), 50)
-    , m_connectionSpeed(BITTORRENT_SESSION_KEY(u"ConnectionSpeed"_s), 30)
-    , m_socketSendBufferSize(BITTORRENT_SESSION_KEY(u"SocketSendBufferSize"_s), 0)
-    , m_socketReceiveBufferSize(BITTORRENT_SESSION_KEY(u"SocketReceiveBufferSize"_s), 0)
+    , m_sendBufferWatermark(BITTORRENT_SESSION_KEY(u"SendBufferWatermark"_s), PerformanceSettings().sendBufferWatermark)
+    , m_sendBufferLowWatermark(BITTORRENT_SESSION_KEY(u"SendBufferLowWatermark"_s), PerformanceSettings().sendBufferLowWatermark)
+    , m_sendBufferWatermarkFactor(BITTORRENT_SESSION_KEY(u"SendBufferWatermarkFactor"_s), PerformanceSettings().sendBufferWatermarkFactor)
+    , m_connectionSpeed(BITTORRENT_SESSION_KEY(u"ConnectionSpeed"_s), PerformanceSettings().connectionSpeed)
+    , m_socketSendBufferSize(BITTORRENT_SESSION_KEY(u"SocketSendBufferSize"_s), PerformanceSettings().socketSendBufferSize)
+    , m_socketReceiveBufferSize(BITTORRENT_SESSION_KEY(u"SocketReceiveBufferSize"_s), PerformanceSettings().socketReceiveBufferSize)
     , m_socketBacklogSize(BITTORRENT_SESSION_KEY(u"SocketBacklogSize"_s), 30)
     , m_isAnonymousModeEnabled(BITTORRENT_SESSION_KEY(u"AnonymousModeEnabled"_s), false)
     , m_isQueueingEnabled(BITTORRENT_SESSION_KEY(u"QueueingSystemEnabled"_s), false)
@@ -497,6 +636,10 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_maxUploads(BITTORRENT_SESSION_KEY(u"MaxUploads"_s), 20, lowerLimited(0, -1))
     , m_maxConnectionsPerTorrent(BITTORRENT_SESSION_KEY(u"MaxConnectionsPerTorrent"_s), 100, lowerLimited(0, -1))
     , m_maxUploadsPerTorrent(BITTORRENT_SESSION_KEY(u"MaxUploadsPerTorrent"_s), 4, lowerLimited(0, -1))
+    , m_isUnchokeSlotsTuningEnabled(BITTORRENT_SESSION_KEY(u"UnchokeSlotsTuning"_s), false)
+    , m_isDormantSeedsEnabled(BITTORRENT_SESSION_KEY(u"DormantSeeds"_s), false)
+    , m_dormantSeedIdleTime(BITTORRENT_SESSION_KEY(u"DormantSeedIdleTime"_s), 60, lowerLimited(1))
+    , m_dormantSeedScrapeInterval(BITTORRENT_SESSION_KEY(u"DormantSeedScrapeInterval"_s), 360, lowerLimited(1))
     , m_btProtocol(BITTORRENT_SESSION_KEY(u"BTProtocol"_s), BTProtocol::Both
         , clampValue(BTProtocol::Both, BTProtocol::UTP))
     , m_isUTPRateLimited(BITTORRENT_SESSION_KEY(u"uTPRateLimited"_s), true)
@@ -545,6 +688,13 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_networkInterfaceAddress(BITTORRENT_SESSION_KEY(u"InterfaceAddress"_s))
     , m_encryption(BITTORRENT_SESSION_KEY(u"Encryption"_s), 0)
     , m_maxActiveCheckingTorrents(BITTORRENT_SESSION_KEY(u"MaxActiveCheckingTorrents"_s), 1)
+    , m_isDiskAwareCheckingEnabled(BITTORRENT_SESSION_KEY(u"DiskAwareChecking"_s), false)
+    , m_maxActiveCheckingTorrentsPerVolume(BITTORRENT_SESSION_KEY(u"MaxActiveCheckingTorrentsPerVolume"_s), 1, lowerLimited(1))
+    , m_checkingVolumeLimits(BITTORRENT_SESSION_KEY(u"CheckingVolumeLimits"_s))
+    , m_checkingQueueOrder(BITTORRENT_SESSION_KEY(u"CheckingQueueOrder"_s), CheckingQueueOrder::QueuePosition
+        , clampValue(CheckingQueueOrder::QueuePosition, CheckingQueueOrder::SavePath))
+    , m_maxActiveMetadataDownloads(BITTORRENT_SESSION_KEY(u"MaxActiveMetadataDownloads"_s)
+        , MetadataDownloadScheduler::DEFAULT_MAX_ACTIVE, lowerLimited(1))
     , m_isProxyPeerConnectionsEnabled(BITTORRENT_SESSION_KEY(u"ProxyPeerConnections"_s), false)
     , m_chokingAlgorithm(BITTORRENT_SESSION_KEY(u"ChokingAlgorithm"_s), ChokingAlgorithm::FixedSlots
         , clampValue(ChokingAlgorithm::FixedSlots, ChokingAlgorithm::RateBased))
@@ -571,6 +721,9 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_excludedFileNames(BITTORRENT_SESSION_KEY(u"ExcludedFileNames"_s))
     , m_bannedIPs(u"State/BannedIPs"_s, QStringList(), Algorithm::sorted<QStringList>)
     , m_resumeDataStorageType(BITTORRENT_SESSION_KEY(u"ResumeDataStorageType"_s), ResumeDataStorageType::Legacy)
+    , m_resumeDataStorageBatchSize(BITTORRENT_SESSION_KEY(u"ResumeDataStorageBatchSize"_s), 1000, lowerLimited(0))
+    , m_isResumeDataStorageCompressionEnabled(BITTORRENT_SESSION_KEY(u"ResumeDataStorageCompression"_s), false)
+    , m_isStoppedTorrentsColdModeEnabled(BITTORRENT_SESSION_KEY(u"StoppedTorrentsColdMode"_s), false)
     , m_isMergeTrackersEnabled(BITTORRENT_KEY(u"MergeTrackersEnabled"_s), false)
     , m_isI2PEnabled {BITTORRENT_SESSION_KEY(u"I2P/Enabled"_s), false}
     , m_I2PAddress {BITTORRENT_SESSION_KEY(u"I2P/Address"_s), u"127.0.0.1"_s}
@@ -581,19 +734,42 @@ SessionImpl::SessionImpl(QObject *parent)
     , m_I2PInboundLength {BITTORRENT_SESSION_KEY(u"I2P/InboundLength"_s), 3}
     , m_I2POutboundLength {BITTORRENT_SESSION_KEY(u"I2P/OutboundLength"_s), 3}
     , m_torrentContentRemoveOption {BITTORRENT_SESSION_KEY(u"TorrentContentRemoveOption"_s), TorrentContentRemoveOption::Delete}
+    , m_torrentContentRemovingRate {BITTORRENT_SESSION_KEY(u"TorrentContentRemovingRate"_s), 0, lowerLimited(0)}
+    , m_lowDiskSpaceThreshold {BITTORRENT_SESSION_KEY(u"LowDiskSpaceThreshold"_s), 0, lowerLimited(0)}
     , m_startPaused {BITTORRENT_SESSION_KEY(u"StartPaused"_s)}
+    , m_refreshTimer {new QTimer(this)}
     , m_seedingLimitTimer {new QTimer(this)}
     , m_resumeDataTimer {new QTimer(this)}
+    , m_bannedIPsTimer {new QTimer(this)}
+    , m_trackerEntryStatusesTimer {new QTimer(this)}
     , m_ioThread {new QThread}
+    , m_contentRemovingThread {new QThread}
+    , m_preallocationThread {new QThread}
     , m_asyncWorker {new QThreadPool(this)}
     , m_recentErroredTorrentsTimer {new QTimer(this)}
     , m_freeDiskSpaceChecker {new FreeDiskSpaceChecker(savePath())}
     , m_freeDiskSpaceCheckingTimer {new QTimer(this)}
+    , m_categoriesStorage {new AsyncFileStorage(specialFolderLocation(SpecialFolder::Config))}
+    , m_categoriesStoringTimer {new QTimer(this)}
 {
+    const TraceSpan traceSpan {"SessionImpl::SessionImpl"};
+
     // It is required to perform async access to libtorrent sequentially
     m_asyncWorker->setMaxThreadCount(1);
     m_asyncWorker->setObjectName("SessionImpl m_asyncWorker");
 
+    m_diskIOAccounting = std::make_shared<DiskIOAccounting>();
+#ifdef QBT_USES_LIBTORRENT2
+    m_diskReadCache = std::make_shared<DiskReadCache>(diskReadCacheSize() * 1024LL * 1024);
+    if (const Path cachePath = persistentReadCachePath(); !cachePath.isEmpty() && (persistentReadCacheSize() > 0))
+    {
+        if (Utils::Fs::mkpath(cachePath))
+            m_persistentReadCache = std::make_shared<PersistentReadCache>(cachePath, (persistentReadCacheSize() * 1024LL * 1024));
+        else
+            LogMsg(tr("Failed to create persistent read cache directory. Path: \"%1\"").arg(cachePath.toString()), Log::WARNING);
+    }
+#endif
+
     m_alerts.reserve(1024);
 
     if (port() < 0)
@@ -610,16 +786,71 @@ SessionImpl::SessionImpl(QObject *parent)
     connect(m_recentErroredTorrentsTimer, &QTimer::timeout
         , this, [this]() { m_recentErroredTorrents.clear(); });
 
-    m_seedingLimitTimer->setInterval(10s);
-    connect(m_seedingLimitTimer, &QTimer::timeout, this, [this]
+    m_bannedIPsTimer->setSingleShot(true);
+    m_bannedIPsTimer->setInterval(BANNED_IPS_APPLY_DELAY);
+    connect(m_bannedIPsTimer, &QTimer::timeout, this, &SessionImpl::applyPendingBannedIPs);
+
+    m_trackerEntryStatusesTimer->setSingleShot(true);
+    m_trackerEntryStatusesTimer->setInterval(TRACKER_ENTRY_STATUSES_UPDATE_DELAY);
+    connect(m_trackerEntryStatusesTimer, &QTimer::timeout, this, &SessionImpl::emitTrackerEntryStatusesUpdated);
+
+    m_categoriesStoringTimer->setSingleShot(true);
+    m_categoriesStoringTimer->setInterval(CATEGORIES_STORING_DELAY);
+    connect(m_categoriesStoringTimer, &QTimer::timeout, this, &SessionImpl::storeCategories);
+
+    m_categoriesStorage->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_categoriesStorage, &QObject::deleteLater);
+    connect(m_categoriesStorage, &AsyncFileStorage::failed, this, [](const Path &filePath, const QString &errorString)
     {
-        // We shouldn't iterate over `m_torrents` in the loop below
-        // since `deleteTorrent()` modifies it indirectly
-        const QHash<TorrentID, TorrentImpl *> torrents {m_torrents};
-        for (TorrentImpl *torrent : torrents)
-            processTorrentShareLimits(torrent);
+        LogMsg(tr("Failed to save Categories configuration. File: \"%1\". Error: \"%2\"")
+               .arg(filePath.toString(), errorString), Log::WARNING);
     });
 
+    m_refreshTimer->setSingleShot(true);
+    m_refreshTimer->setTimerType(Qt::CoarseTimer);
+    connect(m_refreshTimer, &QTimer::timeout, this, &SessionImpl::refresh);
+
+    m_shareLimitsClock.start();
+    m_seedingLimitTimer->setInterval(SHARE_LIMITS_CHECK_INTERVAL);
+    connect(m_seedingLimitTimer, &QTimer::timeout, this, &SessionImpl::processDueTorrentsShareLimits);
+
+    m_performanceTuningTimer = new QTimer(this);
+    m_performanceTuningTimer->setInterval(PERFORMANCE_TUNING_INTERVAL);
+    connect(m_performanceTuningTimer, &QTimer::timeout, this, &SessionImpl::updateAutoTunedPerformanceSettings);
+    if (performanceProfile() == PerformanceProfile::Auto)
+    {
+        m_autoTunedPerformanceSettings = autoTunedPerformanceSettings(detectHostResources(savePath(), networkInterface()), 0);
+        m_performanceTuningTimer->start();
+    }
+
+    m_unchokeSlotsController.setBaseLimits(maxUploads(), maxUploadsPerTorrent());
+
+    m_dormantSeedScheduler.setIdleTime(dormantSeedIdleTime() * 60);
+    m_dormantSeedScheduler.setScrapeInterval(dormantSeedScrapeInterval() * 60);
+    m_dormantSeedsClock.start();
+    m_dormantSeedsTimer = new QTimer(this);
+    m_dormantSeedsTimer->setInterval(DORMANT_SEEDS_CHECK_INTERVAL);
+    connect(m_dormantSeedsTimer, &QTimer::timeout, this, &SessionImpl::processDormantSeeds);
+    if (isDormantSeedsEnabled())
+        m_dormantSeedsTimer->start();
+
+    m_metadataDownloadScheduler.setMaxActive(maxActiveMetadataDownloads());
+    m_metadataDownloadClock.start();
+    m_metadataDownloadExpiryTimer = new QTimer(this);
+    m_metadataDownloadExpiryTimer->setInterval(METADATA_DOWNLOADS_EXPIRY_CHECK_INTERVAL);
+    connect(m_metadataDownloadExpiryTimer, &QTimer::timeout, this, &SessionImpl::expireMetadataDownloads);
+    m_downloadedMetadataCache.setMaxCost(MAX_CACHED_METADATA);
+
+    m_actualFilePathsUpdateTimer = new QTimer(this);
+    m_actualFilePathsUpdateTimer->setSingleShot(true);
+    m_actualFilePathsUpdateTimer->setInterval(ACTUAL_FILE_PATHS_UPDATE_INTERVAL);
+    connect(m_actualFilePathsUpdateTimer, &QTimer::timeout, this, &SessionImpl::processActualFilePathsUpdates);
+
+    m_dhtStateSavingTimer = new QTimer(this);
+    m_dhtStateSavingTimer->setInterval(DHT_STATE_SAVE_INTERVAL);
+    connect(m_dhtStateSavingTimer, &QTimer::timeout, this, &SessionImpl::saveDHTState);
+    m_dhtStateSavingTimer->start();
+
     initializeNativeSession();
     configureComponents();
 
@@ -631,6 +862,7 @@ SessionImpl::SessionImpl(QObject *parent)
     {
         // if subcategories support changed manually
         m_categories = expandCategories(m_categories);
+        invalidateCategoryPathsCache();
     }
 
     const QStringList storedTags = m_storedTags.get();
@@ -643,7 +875,7 @@ SessionImpl::SessionImpl(QObject *parent)
     updateSeedingLimitTimer();
     populateAdditionalTrackers();
     if (isExcludedFileNamesEnabled())
-        populateExcludedFileNamesRegExpList();
+        populateExcludedFileNamesFilter();
 
     connect(Net::ProxyConfigurationManager::instance()
         , &Net::ProxyConfigurationManager::proxyConfigurationChanged
@@ -653,7 +885,8 @@ SessionImpl::SessionImpl(QObject *parent)
     connect(m_ioThread.get(), &QThread::finished, m_freeDiskSpaceChecker, &QObject::deleteLater);
     m_freeDiskSpaceCheckingTimer->setInterval(FREEDISKSPACE_CHECK_TIMEOUT);
     m_freeDiskSpaceCheckingTimer->setSingleShot(true);
-    connect(m_freeDiskSpaceCheckingTimer, &QTimer::timeout, m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::check);
+    connect(m_freeDiskSpaceCheckingTimer, &QTimer::timeout, this, &SessionImpl::checkFreeDiskSpace);
+    connect(m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::volumesChecked, this, &SessionImpl::handleStorageVolumesChecked);
     connect(m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::checked, this, [this](const qint64 value)
     {
         m_freeDiskSpace = value;
@@ -661,20 +894,47 @@ SessionImpl::SessionImpl(QObject *parent)
         emit freeDiskSpaceChecked(m_freeDiskSpace);
     });
 
-    m_fileSearcher = new FileSearcher;
-    m_fileSearcher->moveToThread(m_ioThread.get());
-    connect(m_ioThread.get(), &QThread::finished, m_fileSearcher, &QObject::deleteLater);
+    m_fileSearcher = new FileSearcher(this);
 
     m_torrentContentRemover = new TorrentContentRemover;
-    m_torrentContentRemover->moveToThread(m_ioThread.get());
-    connect(m_ioThread.get(), &QThread::finished, m_torrentContentRemover, &QObject::deleteLater);
-    connect(m_torrentContentRemover, &TorrentContentRemover::jobFinished, this, &SessionImpl::torrentContentRemovingFinished);
+    m_torrentContentRemover->setRemovingRate(torrentContentRemovingRate());
+    m_torrentContentRemover->moveToThread(m_contentRemovingThread.get());
+    connect(m_contentRemovingThread.get(), &QThread::finished, m_torrentContentRemover, &QObject::deleteLater);
+    connect(m_torrentContentRemover, &TorrentContentRemover::jobProgress, this, &SessionImpl::handleTorrentContentRemovingProgress);
+    connect(m_torrentContentRemover, &TorrentContentRemover::jobFinished, this, &SessionImpl::handleTorrentContentRemovingFinished);
+
+    m_filePreallocator = new FilePreallocator;
+    m_filePreallocator->moveToThread(m_preallocationThread.get());
+    connect(m_preallocationThread.get(), &QThread::finished, m_filePreallocator, &QObject::deleteLater);
+    connect(m_filePreallocator, &FilePreallocator::jobProgress, this, &SessionImpl::handleFilePreallocationProgress);
+    connect(m_filePreallocator, &FilePreallocator::jobFinished, this, &SessionImpl::handleFilePreallocationFinished);
+
+    m_torrentFileExporter = new TorrentFileExporter;
+    m_torrentFileExporter->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_torrentFileExporter, &QObject::deleteLater);
+    connect(m_torrentFileExporter, &TorrentFileExporter::exportFailed, this
+            , [](const QString &torrentName, const Path &filePath, const QString &errorMessage)
+    {
+        LogMsg(tr("Failed to export torrent. Torrent: \"%1\". Destination: \"%2\". Reason: \"%3\"")
+               .arg(torrentName, filePath.toString(), errorMessage), Log::WARNING);
+    });
 
     m_ioThread->setObjectName("SessionImpl m_ioThread");
+    Utils::Thread::setWorkload(m_ioThread.get(), Utils::Thread::Workload::Bulk);
     m_ioThread->start();
+    m_contentRemovingThread->setObjectName("SessionImpl m_contentRemovingThread");
+    Utils::Thread::setWorkload(m_contentRemovingThread.get(), Utils::Thread::Workload::Bulk);
+    m_contentRemovingThread->start(QThread::LowPriority);
+    m_preallocationThread->setObjectName("SessionImpl m_preallocationThread");
+    Utils::Thread::setWorkload(m_preallocationThread.get(), Utils::Thread::Workload::Bulk);
+    m_preallocationThread->start(QThread::LowPriority);
 
     QMetaObject::invokeMethod(m_freeDiskSpaceChecker, &FreeDiskSpaceChecker::check);
 
+    m_alertStatistics.alertTypes.resize(lt::num_alert_types);
+    for (int alertType = 0; alertType < lt::num_alert_types; ++alertType)
+        m_alertStatistics.alertTypes[alertType].name = QString::fromLatin1(lt::alert_name(alertType));
+
     initMetrics();
     loadStatistics();
 
@@ -698,23 +958,33 @@ SessionImpl::SessionImpl(QObject *parent)
 
 SessionImpl::~SessionImpl()
 {
-    m_nativeSession->pause();
+    // Torrent states are saved before they are affected by pausing the session
+    saveTorrentSnapshots();
+
+    // it is written by IO thread which is stopped after all the other jobs are processed
+    if (m_categoriesStoringTimer->isActive())
+        storeCategories();
+
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
+        nativeSession->pause();
 
     const auto timeout = (m_shutdownTimeout >= 0) ? (static_cast<qint64>(m_shutdownTimeout) * 1000) : -1;
     const QDeadlineTimer shutdownDeadlineTimer {timeout};
 
     if (m_torrentsQueueChanged)
     {
-        m_nativeSession->post_torrent_updates({});
+        for (lt::session *nativeSession : asConst(m_nativeSessions))
+            nativeSession->post_torrent_updates({});
         m_torrentsQueueChanged = false;
         m_needSaveTorrentsQueue = true;
     }
 
     // Do some bittorrent related saving
     // After this, (ideally) no more important alerts will be generated/handled
-    saveResumeData();
+    saveResumeData(shutdownDeadlineTimer);
 
     saveStatistics();
+    saveDHTState();
 
     // We must delete FilterParserThread
     // before we delete lt::session
@@ -729,17 +999,29 @@ SessionImpl::~SessionImpl()
     m_asyncWorker->clear();
     m_asyncWorker->waitForDone();
 
-    auto *nativeSessionProxy = new lt::session_proxy(m_nativeSession->abort());
-    delete m_nativeSession;
+    auto *nativeSessionProxies = new std::vector<lt::session_proxy>;
+    nativeSessionProxies->reserve(m_nativeSessions.size());
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
+    {
+        nativeSessionProxies->push_back(nativeSession->abort());
+        delete nativeSession;
+    }
+    m_nativeSessions.clear();
+
+#ifdef QBT_USES_LIBTORRENT2
+    // Save its index while it's guaranteed we have time to do it
+    if (m_persistentReadCache)
+        m_persistentReadCache->close();
+#endif
 
     qDebug("Deleting resume data storage...");
     delete m_resumeDataStorage;
     LogMsg(tr("Saving resume data completed."));
 
-    auto *sessionTerminateThread = QThread::create([nativeSessionProxy]()
+    auto *sessionTerminateThread = QThread::create([nativeSessionProxies]()
     {
         qDebug("Deleting libtorrent session...");
-        delete nativeSessionProxy;
+        delete nativeSessionProxies;
     });
     sessionTerminateThread->setObjectName("~SessionImpl sessionTerminateThread");
     connect(sessionTerminateThread, &QThread::finished, sessionTerminateThread, &QObject::deleteLater);
@@ -818,6 +1100,7 @@ void SessionImpl::setDownloadPathEnabled(const bool enabled)
     if (enabled != isDownloadPathEnabled())
     {
         m_isDownloadPathEnabled = enabled;
+        invalidateCategoryPathsCache();
         for (TorrentImpl *const torrent : asConst(m_torrents))
             torrent->handleCategoryOptionsChanged();
     }
@@ -835,8 +1118,7 @@ void SessionImpl::setAppendExtensionEnabled(const bool enabled)
         m_isAppendExtensionEnabled = enabled;
 
         // append or remove .!qB extension for incomplete files
-        for (TorrentImpl *const torrent : asConst(m_torrents))
-            torrent->handleAppendExtensionToggled();
+        scheduleActualFilePathsUpdate();
     }
 }
 
@@ -851,9 +1133,8 @@ void SessionImpl::setUnwantedFolderEnabled(const bool enabled)
     {
         m_isUnwantedFolderEnabled = enabled;
 
-        // append or remove .!qB extension for incomplete files
-        for (TorrentImpl *const torrent : asConst(m_torrents))
-            torrent->handleUnwantedFolderToggled();
+        // move unwanted files to or from ".unwanted" folder
+        scheduleActualFilePathsUpdate();
     }
 }
 
@@ -870,6 +1151,33 @@ void SessionImpl::setRefreshInterval(const int value)
     }
 }
 
+void SessionImpl::addRefreshSubscriber(const QObject *subscriber, const int interval)
+{
+    Q_ASSERT(subscriber);
+
+    const int subscriberInterval = (interval > 0) ? interval : refreshInterval();
+    m_refreshSubscribers.insert(subscriber, subscriberInterval);
+
+    // don't let the subscriber wait for the refresh delayed due to inactivity
+    if (m_refreshTimer->isActive() && (m_refreshTimer->remainingTime() > std::max(subscriberInterval, refreshInterval())))
+        m_refreshTimer->start(std::max(subscriberInterval, refreshInterval()));
+}
+
+void SessionImpl::removeRefreshSubscriber(const QObject *subscriber)
+{
+    m_refreshSubscribers.remove(subscriber);
+}
+
+void SessionImpl::setWatchedTorrents(const QObject *subscriber, const QSet<TorrentID> &torrentIDs)
+{
+    Q_ASSERT(subscriber);
+
+    if (torrentIDs.isEmpty())
+        m_watchedTorrents.remove(subscriber);
+    else
+        m_watchedTorrents.insert(subscriber, torrentIDs);
+}
+
 bool SessionImpl::isPreallocationEnabled() const
 {
     return m_isPreallocationEnabled;
@@ -926,7 +1234,18 @@ CategoryOptions SessionImpl::categoryOptions(const QString &categoryName) const
 
 Path SessionImpl::categorySavePath(const QString &categoryName) const
 {
-    return categorySavePath(categoryName, categoryOptions(categoryName));
+    if (const auto it = m_categorySavePathsCache.constFind(categoryName); it != m_categorySavePathsCache.cend())
+        return it.value();
+
+    const auto categoryIter = m_categories.constFind(categoryName);
+    if (categoryName.isEmpty() || (categoryIter != m_categories.cend()))
+    {
+        const Path path = categorySavePath(categoryName, ((categoryIter != m_categories.cend()) ? categoryIter.value() : CategoryOptions()));
+        m_categorySavePathsCache.insert(categoryName, path);
+        return path;
+    }
+
+    return categorySavePath(categoryName, {});
 }
 
 Path SessionImpl::categorySavePath(const QString &categoryName, const CategoryOptions &options) const
@@ -955,7 +1274,18 @@ Path SessionImpl::categorySavePath(const QString &categoryName, const CategoryOp
 
 Path SessionImpl::categoryDownloadPath(const QString &categoryName) const
 {
-    return categoryDownloadPath(categoryName, categoryOptions(categoryName));
+    if (const auto it = m_categoryDownloadPathsCache.constFind(categoryName); it != m_categoryDownloadPathsCache.cend())
+        return it.value();
+
+    const auto categoryIter = m_categories.constFind(categoryName);
+    if (categoryName.isEmpty() || (categoryIter != m_categories.cend()))
+    {
+        const Path path = categoryDownloadPath(categoryName, ((categoryIter != m_categories.cend()) ? categoryIter.value() : CategoryOptions()));
+        m_categoryDownloadPathsCache.insert(categoryName, path);
+        return path;
+    }
+
+    return categoryDownloadPath(categoryName, {});
 }
 
 Path SessionImpl::categoryDownloadPath(const QString &categoryName, const CategoryOptions &options) const
@@ -999,6 +1329,12 @@ DownloadPathOption SessionImpl::resolveCategoryDownloadPathOption(const QString
     return resolveCategoryDownloadPathOption(parentName, categoryOptions(parentName).downloadPath);
 }
 
+void SessionImpl::invalidateCategoryPathsCache()
+{
+    m_categorySavePathsCache.clear();
+    m_categoryDownloadPathsCache.clear();
+}
+
 bool SessionImpl::addCategory(const QString &name, const CategoryOptions &options)
 {
     if (name.isEmpty())
@@ -1020,7 +1356,8 @@ bool SessionImpl::addCategory(const QString &name, const CategoryOptions &option
     }
 
     m_categories[name] = options;
-    storeCategories();
+    invalidateCategoryPathsCache();
+    storeCategoriesDeferred();
     emit categoryAdded(name);
 
     return true;
@@ -1049,7 +1386,8 @@ bool SessionImpl::editCategory(const QString &name, const CategoryOptions &optio
     }
 
     currentOptions = options;
-    storeCategories();
+    invalidateCategoryPathsCache();
+    storeCategoriesDeferred();
 
     for (TorrentImpl *const torrent : asConst(m_torrents))
     {
@@ -1091,8 +1429,9 @@ bool SessionImpl::removeCategory(const QString &name)
 
     if (result)
     {
+        invalidateCategoryPathsCache();
         // update stored categories
-        storeCategories();
+        storeCategoriesDeferred();
         emit categoryRemoved(name);
     }
 
@@ -1113,15 +1452,11 @@ void SessionImpl::setSubcategoriesEnabled(const bool value)
         // expand categories to include all parent categories
         m_categories = expandCategories(m_categories);
         // update stored categories
-        storeCategories();
-    }
-    else
-    {
-        // reload categories
-        loadCategories();
+        storeCategoriesDeferred();
     }
 
     m_isSubcategoriesEnabled = value;
+    invalidateCategoryPathsCache();
     emit subcategoriesSupportChanged();
 }
 
@@ -1288,6 +1623,7 @@ void SessionImpl::setGlobalMaxRatio(qreal ratio)
     {
         m_globalMaxRatio = ratio;
         updateSeedingLimitTimer();
+        scheduleAllTorrentsShareLimitsCheck();
     }
 }
 
@@ -1304,6 +1640,7 @@ void SessionImpl::setGlobalMaxSeedingMinutes(int minutes)
     {
         m_globalMaxSeedingMinutes = minutes;
         updateSeedingLimitTimer();
+        scheduleAllTorrentsShareLimitsCheck();
     }
 }
 
@@ -1320,6 +1657,7 @@ void SessionImpl::setGlobalMaxInactiveSeedingMinutes(int minutes)
     {
         m_globalMaxInactiveSeedingMinutes = minutes;
         updateSeedingLimitTimer();
+        scheduleAllTorrentsShareLimitsCheck();
     }
 }
 
@@ -1328,12 +1666,12 @@ void SessionImpl::applyBandwidthLimits()
     lt::settings_pack settingsPack;
     settingsPack.set_int(lt::settings_pack::download_rate_limit, downloadSpeedLimit());
     settingsPack.set_int(lt::settings_pack::upload_rate_limit, uploadSpeedLimit());
-    m_nativeSession->apply_settings(std::move(settingsPack));
+    applyNativeSettings(std::move(settingsPack));
 }
 
 void SessionImpl::configure()
 {
-    m_nativeSession->apply_settings(loadLTSettings());
+    applyNativeSettings(loadLTSettings());
     configureComponents();
 
     m_deferredConfigureScheduled = false;
@@ -1359,17 +1697,28 @@ void SessionImpl::configureComponents()
 
 void SessionImpl::prepareStartup()
 {
+    const TraceSpan traceSpan {"SessionImpl::prepareStartup"};
+
+    loadTorrentSnapshots();
+
     qDebug("Initializing torrents resume data storage...");
 
     const Path dbPath = specialFolderLocation(SpecialFolder::Data) / Path(u"torrents.db"_s);
     const bool dbStorageExists = dbPath.exists();
+    const Path journalPath = specialFolderLocation(SpecialFolder::Data) / Path(u"torrents.journal"_s);
+    const bool journalStorageExists = journalPath.exists();
 
     auto *context = new ResumeSessionContext(this);
     context->currentStorageType = resumeDataStorageType();
+    if (const Tracer *tracer = Tracer::instance())
+        context->traceStartTime = tracer->timestamp();
 
     if (context->currentStorageType == ResumeDataStorageType::SQLite)
     {
-        m_resumeDataStorage = new DBResumeDataStorage(dbPath, this);
+        auto *dbStorage = new DBResumeDataStorage(dbPath, this);
+        dbStorage->setBatchSize(resumeDataStorageBatchSize());
+        dbStorage->setCompressionEnabled(isResumeDataStorageCompressionEnabled());
+        m_resumeDataStorage = dbStorage;
 
         if (!dbStorageExists)
         {
@@ -1377,6 +1726,16 @@ void SessionImpl::prepareStartup()
             context->startupStorage = new BencodeResumeDataStorage(dataPath, this);
         }
     }
+    else if (context->currentStorageType == ResumeDataStorageType::Journal)
+    {
+        m_resumeDataStorage = new JournalResumeDataStorage(journalPath, this);
+
+        if (!journalStorageExists)
+        {
+            const Path dataPath = specialFolderLocation(SpecialFolder::Data) / Path(u"BT_backup"_s);
+            context->startupStorage = new BencodeResumeDataStorage(dataPath, this);
+        }
+    }
     else
     {
         const Path dataPath = specialFolderLocation(SpecialFolder::Data) / Path(u"BT_backup"_s);
@@ -1384,6 +1743,8 @@ void SessionImpl::prepareStartup()
 
         if (dbStorageExists)
             context->startupStorage = new DBResumeDataStorage(dbPath, this);
+        else if (journalStorageExists)
+            context->startupStorage = new JournalResumeDataStorage(journalPath, this);
     }
 
     if (!context->startupStorage)
@@ -1407,6 +1768,13 @@ void SessionImpl::prepareStartup()
 
     connect(this, &SessionImpl::addTorrentAlertsReceived, context, [this, context](const qsizetype alertsCount)
     {
+        // Adapt the number of torrents being added at once to the libtorrent throughput:
+        // if all of them are added within single alerts batch it is likely able to handle more
+        if (alertsCount >= context->processingResumeDataLimit)
+            context->processingResumeDataLimit = std::min((context->processingResumeDataLimit * 2), MAX_PROCESSING_RESUMEDATA_COUNT);
+        else if ((alertsCount * 4) < context->processingResumeDataLimit)
+            context->processingResumeDataLimit = std::max((context->processingResumeDataLimit / 2), MIN_PROCESSING_RESUMEDATA_COUNT);
+
         context->processingResumeDataCount -= alertsCount;
         context->finishedResumeDataCount += alertsCount;
         if (!context->isLoadedResumeDataHandlingEnqueued)
@@ -1417,7 +1785,8 @@ void SessionImpl::prepareStartup()
 
         if (!m_refreshEnqueued)
         {
-            m_nativeSession->post_torrent_updates();
+            for (lt::session *nativeSession : asConst(m_nativeSessions))
+                nativeSession->post_torrent_updates(REFRESH_STATUS_FLAGS);
             m_refreshEnqueued = true;
         }
 
@@ -1429,10 +1798,12 @@ void SessionImpl::prepareStartup()
 
 void SessionImpl::handleLoadedResumeData(ResumeSessionContext *context)
 {
+    const TraceSpan traceSpan {"SessionImpl::handleLoadedResumeData"};
+
     context->isLoadedResumeDataHandlingEnqueued = false;
 
     int count = context->processingResumeDataCount;
-    while (context->processingResumeDataCount < MAX_PROCESSING_RESUMEDATA_COUNT)
+    while (context->processingResumeDataCount < context->processingResumeDataLimit)
     {
         if (context->loadedResumeData.isEmpty())
             context->loadedResumeData = context->startupStorage->fetchLoadedResumeData();
@@ -1618,8 +1989,9 @@ void SessionImpl::processNextResumeData(ResumeSessionContext *context)
 #endif
 
     qDebug() << "Starting up torrent" << torrentID.toString() << "...";
-    m_nativeSession->async_add_torrent(resumeData.ltAddTorrentParams);
-    m_addTorrentAlertHandlers.append([this, resumeData = std::move(resumeData)](const lt::add_torrent_alert *alert) mutable
+    const qsizetype shard = nativeSessionIndexFor(resumeData.ltAddTorrentParams);
+    m_nativeSessions[shard]->async_add_torrent(resumeData.ltAddTorrentParams);
+    m_addTorrentAlertHandlers[shard].append([this, resumeData = std::move(resumeData)](const lt::add_torrent_alert *alert) mutable
     {
         if (alert->error)
         {
@@ -1640,6 +2012,8 @@ void SessionImpl::processNextResumeData(ResumeSessionContext *context)
 
 void SessionImpl::endStartup(ResumeSessionContext *context)
 {
+    const TraceSpan traceSpan {"SessionImpl::endStartup"};
+
     if (m_resumeDataStorage != context->startupStorage)
     {
         if (isQueueingSystemEnabled())
@@ -1658,10 +2032,13 @@ void SessionImpl::endStartup(ResumeSessionContext *context)
     }
 
     context->deleteLater();
-    connect(context, &QObject::destroyed, this, [this]
+    connect(context, &QObject::destroyed, this, [this, traceStartTime = context->traceStartTime]
     {
         if (!m_isPaused)
-            m_nativeSession->resume();
+        {
+            for (lt::session *nativeSession : asConst(m_nativeSessions))
+                nativeSession->resume();
+        }
 
         if (m_refreshEnqueued)
             m_refreshEnqueued = false;
@@ -1694,7 +2071,16 @@ void SessionImpl::endStartup(ResumeSessionContext *context)
         m_wakeupCheckTimestamp.start();
         wakeupCheckTimer->start(30s);
 
+        auto *coldTorrentsTimer = new QTimer(this);
+        connect(coldTorrentsTimer, &QTimer::timeout, this, &SessionImpl::releaseStoppedTorrentsMetadata);
+        coldTorrentsTimer->start(COLD_TORRENTS_CHECK_INTERVAL);
+
         m_isRestored = true;
+        m_startupSnapshots.clear();
+
+        if (Tracer *tracer = Tracer::instance(); tracer && (traceStartTime >= 0))
+            tracer->addSpan("SessionImpl::restoreTorrents", traceStartTime, tracer->timestamp());
+
         emit startupProgressUpdated(100);
         emit restored();
     });
@@ -1730,30 +2116,74 @@ void SessionImpl::initializeNativeSession()
     }
 #endif
 
-    lt::session_params sessionParams {std::move(pack), {}};
 #ifdef QBT_USES_LIBTORRENT2
-    switch (diskIOType())
+    const auto makeDiskIOConstructor = [this](const int shard) -> lt::disk_io_constructor_type
     {
-    case DiskIOType::Posix:
-        sessionParams.disk_io_constructor = customPosixDiskIOConstructor;
-        break;
-    case DiskIOType::MMap:
-    case DiskIOType::SimplePreadPwrite:
-        sessionParams.disk_io_constructor = customMMapDiskIOConstructor;
-        break;
-    default:
-        sessionParams.disk_io_constructor = customDiskIOConstructor;
-        break;
-    }
+        // The sessions share the read cache so each of them uses its own range of the storage keys
+        const CustomDiskIOParams diskIOParams {m_diskReadCache, m_persistentReadCache, m_diskIOAccounting
+                , (diskWriteCoalescingSize() * 1024LL * 1024), std::chrono::milliseconds(diskWriteCoalescingTime())
+                , (shard * READ_CACHE_STORAGE_RANGE)};
+        switch (diskIOType())
+        {
+        case DiskIOType::Posix:
+#ifndef QBT_USES_IO_URING
+        case DiskIOType::IOUring:
+#endif
+            return customPosixDiskIOConstructor(diskIOParams);
+        case DiskIOType::MMap:
+        case DiskIOType::SimplePreadPwrite:
+            return customMMapDiskIOConstructor(diskIOParams);
+#ifdef QBT_USES_IO_URING
+        case DiskIOType::IOUring:
+            return customIOUringDiskIOConstructor(diskIOParams);
+#endif
+        default:
+            return customDiskIOConstructor(diskIOParams);
+        }
+    };
+#endif
+
+    const int shardCount = nativeSessionShards();
+    m_nativeSessions.reserve(shardCount);
+    m_nativeSessionExtensions.reserve(shardCount);
+    m_addTorrentAlertHandlers.resize(shardCount);
+    for (int shard = 0; shard < shardCount; ++shard)
+    {
+        lt::settings_pack shardPack = pack;
+        adjustShardSettings(shardPack, shard, shardCount);
+        lt::session_params sessionParams {std::move(shardPack), {}};
+        // The stored routing table lets the DHT work right away instead of bootstrapping from scratch
+        if (shard == 0)
+            loadDHTState(sessionParams);
+#ifdef QBT_USES_LIBTORRENT2
+        sessionParams.disk_io_constructor = makeDiskIOConstructor(shard);
 #endif
 
 #if LIBTORRENT_VERSION_NUM < 20100
-    m_nativeSession = new lt::session(sessionParams, lt::session::paused);
+        auto *nativeSession = new lt::session(sessionParams, lt::session::paused);
 #else
-    m_nativeSession = new lt::session(sessionParams);
-    m_nativeSession->pause();
+        auto *nativeSession = new lt::session(sessionParams);
+        nativeSession->pause();
 #endif
 
+        nativeSession->set_alert_notify([this]()
+        {
+            QMetaObject::invokeMethod(this, &SessionImpl::readAlerts, Qt::QueuedConnection);
+        });
+
+        // Enabling plugins
+        nativeSession->add_extension(&lt::create_smart_ban_plugin);
+        nativeSession->add_extension(&lt::create_ut_metadata_plugin);
+        if (isPeXEnabled())
+            nativeSession->add_extension(&lt::create_ut_pex_plugin);
+
+        auto nativeSessionExtension = std::make_shared<NativeSessionExtension>();
+        nativeSession->add_extension(nativeSessionExtension);
+
+        m_nativeSessions.append(nativeSession);
+        m_nativeSessionExtensions.append(nativeSessionExtension.get());
+    }
+
     LogMsg(tr("Peer ID: \"%1\"").arg(QString::fromStdString(peerId)), Log::INFO);
     LogMsg(tr("HTTP User-Agent: \"%1\"").arg(USER_AGENT), Log::INFO);
     LogMsg(tr("Distributed Hash Table (DHT) support: %1").arg(isDHTEnabled() ? tr("ON") : tr("OFF")), Log::INFO);
@@ -1761,21 +2191,54 @@ void SessionImpl::initializeNativeSession()
     LogMsg(tr("Peer Exchange (PeX) support: %1").arg(isPeXEnabled() ? tr("ON") : tr("OFF")), Log::INFO);
     LogMsg(tr("Anonymous mode: %1").arg(isAnonymousModeEnabled() ? tr("ON") : tr("OFF")), Log::INFO);
     LogMsg(tr("Encryption support: %1").arg((encryption() == 0) ? tr("ON") : ((encryption() == 1) ? tr("FORCED") : tr("OFF"))), Log::INFO);
+    if (shardCount > 1)
+        LogMsg(tr("Torrents are distributed between %1 libtorrent sessions").arg(QString::number(shardCount)), Log::INFO);
+}
+
+lt::session *SessionImpl::primaryNativeSession() const
+{
+    return m_nativeSessions.first();
+}
+
+qsizetype SessionImpl::nativeSessionIndexFor(const lt::add_torrent_params &params) const
+{
+    if (m_nativeSessions.size() == 1)
+        return 0;
+
+    return static_cast<qsizetype>(qHash(getInfoHash(params).toTorrentID()) % static_cast<size_t>(m_nativeSessions.size()));
+}
+
+lt::session *SessionImpl::nativeSessionOf(const lt::torrent_handle &nativeHandle) const
+{
+    if (m_nativeSessions.size() == 1)
+        return primaryNativeSession();
 
-    m_nativeSession->set_alert_notify([this]()
+    // The torrent ID may change once the metadata is received so the sessions are asked directly.
+    // It blocks until the network threads respond but it is only done when torrents are removed.
+    const lt::sha1_hash hash = getInfoHash(nativeHandle).toTorrentID();
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
     {
-        QMetaObject::invokeMethod(this, &SessionImpl::readAlerts, Qt::QueuedConnection);
-    });
+        if (nativeSession->find_torrent(hash) == nativeHandle)
+            return nativeSession;
+    }
+
+    return primaryNativeSession();
+}
 
-    // Enabling plugins
-    m_nativeSession->add_extension(&lt::create_smart_ban_plugin);
-    m_nativeSession->add_extension(&lt::create_ut_metadata_plugin);
-    if (isPeXEnabled())
-        m_nativeSession->add_extension(&lt::create_ut_pex_plugin);
+void SessionImpl::applyNativeSettings(lt::settings_pack settingsPack) const
+{
+    if (m_nativeSessions.size() == 1)
+    {
+        primaryNativeSession()->apply_settings(std::move(settingsPack));
+        return;
+    }
 
-    auto nativeSessionExtension = std::make_shared<NativeSessionExtension>();
-    m_nativeSession->add_extension(nativeSessionExtension);
-    m_nativeSessionExtension = nativeSessionExtension.get();
+    for (qsizetype shard = 0; shard < m_nativeSessions.size(); ++shard)
+    {
+        lt::settings_pack shardPack = settingsPack;
+        adjustShardSettings(shardPack, shard, m_nativeSessions.size());
+        m_nativeSessions[shard]->apply_settings(std::move(shardPack));
+    }
 }
 
 void SessionImpl::processBannedIPs(lt::ip_filter &filter)
@@ -1791,6 +2254,39 @@ void SessionImpl::processBannedIPs(lt::ip_filter &filter)
     }
 }
 
+// Installs the filter loaded from the IP filter file combined with all banned IPs
+void SessionImpl::applyIPFilter()
+{
+    m_bannedIPsTimer->stop();
+    m_pendingBannedIPs.clear();
+    m_isIPFilterRebuildNeeded = false;
+
+    m_IPFilter = m_fileIPFilter;
+    processBannedIPs(m_IPFilter);
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
+        nativeSession->set_ip_filter(m_IPFilter);
+}
+
+// Bans are collected for a short time so that a burst of them is installed at once
+void SessionImpl::applyPendingBannedIPs()
+{
+    if (m_isIPFilterRebuildNeeded)
+    {
+        applyIPFilter();
+        return;
+    }
+
+    if (m_pendingBannedIPs.isEmpty())
+        return;
+
+    for (const lt::address &addr : asConst(m_pendingBannedIPs))
+        m_IPFilter.add_rule(addr, addr, lt::ip_filter::blocked);
+    m_pendingBannedIPs.clear();
+
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
+        nativeSession->set_ip_filter(m_IPFilter);
+}
+
 void SessionImpl::initMetrics()
 {
     const auto findMetricIndex = [](const char *name) -> int
@@ -1819,6 +2315,7 @@ void SessionImpl::initMetrics()
         .peer =
         {
             .numPeersConnected = findMetricIndex("peer.num_peers_connected"),
+            .numPeersUpUnchoked = findMetricIndex("peer.num_peers_up_unchoked_all"),
             .numPeersUpDisk = findMetricIndex("peer.num_peers_up_disk"),
             .numPeersDownDisk = findMetricIndex("peer.num_peers_down_disk")
         },
@@ -1842,6 +2339,16 @@ void SessionImpl::initMetrics()
             .diskJobTime = findMetricIndex("disk.disk_job_time")
         }
     };
+
+    // metrics are indexed by their positions in session_stats_alert counters
+    const std::vector<lt::stats_metric> nativeMetrics = lt::session_stats_metrics();
+    m_sessionMetrics.resize(nativeMetrics.size());
+    for (const lt::stats_metric &nativeMetric : nativeMetrics)
+    {
+        SessionMetric &metric = m_sessionMetrics[nativeMetric.value_index];
+        metric.name = QString::fromLatin1(nativeMetric.name);
+        metric.type = (nativeMetric.type == lt::metric_type_t::gauge) ? SessionMetric::Type::Gauge : SessionMetric::Type::Counter;
+    }
 }
 
 lt::settings_pack SessionImpl::loadLTSettings() const
@@ -1859,12 +2366,8 @@ lt::settings_pack SessionImpl::loadLTSettings() const
         | lt::alert::tracker_notification;
     settingsPack.set_int(lt::settings_pack::alert_mask, alertMask);
 
-    settingsPack.set_int(lt::settings_pack::connection_speed, connectionSpeed());
+    applyPerformanceSettings(settingsPack);
 
-    // from libtorrent doc:
-    // It will not take affect until the listen_interfaces settings is updated
-    settingsPack.set_int(lt::settings_pack::send_socket_buffer_size, socketSendBufferSize());
-    settingsPack.set_int(lt::settings_pack::recv_socket_buffer_size, socketReceiveBufferSize());
     settingsPack.set_int(lt::settings_pack::listen_queue_size, socketBacklogSize());
 
     applyNetworkInterfacesSettings(settingsPack);
@@ -1890,7 +2393,8 @@ lt::settings_pack SessionImpl::loadLTSettings() const
         settingsPack.set_int(lt::settings_pack::in_enc_policy, lt::settings_pack::pe_disabled);
     }
 
-    settingsPack.set_int(lt::settings_pack::active_checking, maxActiveCheckingTorrents());
+    // Checking torrents are started by the scheduler bypassing libtorrent's queue
+    settingsPack.set_int(lt::settings_pack::active_checking, (isDiskAwareCheckingEnabled() ? 0 : maxActiveCheckingTorrents()));
 
     // I2P
 #if defined(QBT_USES_LIBTORRENT2) && TORRENT_USE_I2P
@@ -1970,15 +2474,6 @@ lt::settings_pack SessionImpl::loadLTSettings() const
     settingsPack.set_int(lt::settings_pack::metadata_token_limit, Preferences::instance()->getBdecodeTokenLimit());
 #endif
 
-    settingsPack.set_int(lt::settings_pack::aio_threads, asyncIOThreads());
-#ifdef QBT_USES_LIBTORRENT2
-    settingsPack.set_int(lt::settings_pack::hashing_threads, hashingThreads());
-#endif
-    settingsPack.set_int(lt::settings_pack::file_pool_size, filePoolSize());
-
-    const int checkingMemUsageSize = checkingMemUsage() * 64;
-    settingsPack.set_int(lt::settings_pack::checking_mem_usage, checkingMemUsageSize);
-
 #ifndef QBT_USES_LIBTORRENT2
     const int cacheSize = (diskCacheSize() > -1) ? (diskCacheSize() * 64) : -1;
     settingsPack.set_int(lt::settings_pack::cache_size, cacheSize);
@@ -2024,10 +2519,6 @@ lt::settings_pack SessionImpl::loadLTSettings() const
     settingsPack.set_int(lt::settings_pack::suggest_mode, isSuggestModeEnabled()
                          ? lt::settings_pack::suggest_read_cache : lt::settings_pack::no_piece_suggestions);
 
-    settingsPack.set_int(lt::settings_pack::send_buffer_watermark, sendBufferWatermark() * 1024);
-    settingsPack.set_int(lt::settings_pack::send_buffer_low_watermark, sendBufferLowWatermark() * 1024);
-    settingsPack.set_int(lt::settings_pack::send_buffer_watermark_factor, sendBufferWatermarkFactor());
-
     settingsPack.set_bool(lt::settings_pack::anonymous_mode, isAnonymousModeEnabled());
 
     // Queueing System
@@ -2050,7 +2541,8 @@ lt::settings_pack SessionImpl::loadLTSettings() const
     settingsPack.set_int(lt::settings_pack::active_tracker_limit, -1);
     settingsPack.set_int(lt::settings_pack::active_dht_limit, -1);
     settingsPack.set_int(lt::settings_pack::active_lsd_limit, -1);
-    settingsPack.set_int(lt::settings_pack::alert_queue_size, std::numeric_limits<int>::max() / 2);
+    m_alertQueueSize = std::max(m_alertQueueSize, alertQueueSize());
+    settingsPack.set_int(lt::settings_pack::alert_queue_size, m_alertQueueSize);
 
     // Outgoing ports
     settingsPack.set_int(lt::settings_pack::outgoing_port, outgoingPortsMin());
@@ -2074,7 +2566,7 @@ lt::settings_pack SessionImpl::loadLTSettings() const
     // * Max connections limit
     settingsPack.set_int(lt::settings_pack::connections_limit, maxConnections());
     // * Global max upload slots
-    settingsPack.set_int(lt::settings_pack::unchoke_slots_limit, maxUploads());
+    settingsPack.set_int(lt::settings_pack::unchoke_slots_limit, m_unchokeSlotsController.globalSlots());
     // uTP
     switch (btProtocol())
     {
@@ -2158,6 +2650,66 @@ lt::settings_pack SessionImpl::loadLTSettings() const
     return settingsPack;
 }
 
+PerformanceSettings SessionImpl::performanceSettings() const
+{
+    const PerformanceSettings manualSettings {
+        .asyncIOThreads = asyncIOThreads(),
+        .hashingThreads = hashingThreads(),
+        .filePoolSize = filePoolSize(),
+        .checkingMemUsage = checkingMemUsage(),
+        .sendBufferWatermark = sendBufferWatermark(),
+        .sendBufferLowWatermark = sendBufferLowWatermark(),
+        .sendBufferWatermarkFactor = sendBufferWatermarkFactor(),
+        .connectionSpeed = connectionSpeed(),
+        .socketSendBufferSize = socketSendBufferSize(),
+        .socketReceiveBufferSize = socketReceiveBufferSize()
+    };
+
+    if (performanceProfile() != PerformanceProfile::Auto)
+        return manualSettings;
+
+    return applyPerformanceOverrides(m_autoTunedPerformanceSettings, manualSettings);
+}
+
+void SessionImpl::applyPerformanceSettings(lt::settings_pack &settingsPack) const
+{
+    const PerformanceSettings settings = performanceSettings();
+
+    settingsPack.set_int(lt::settings_pack::connection_speed, settings.connectionSpeed);
+
+    // from libtorrent doc:
+    // It will not take affect until the listen_interfaces settings is updated
+    settingsPack.set_int(lt::settings_pack::send_socket_buffer_size, settings.socketSendBufferSize);
+    settingsPack.set_int(lt::settings_pack::recv_socket_buffer_size, settings.socketReceiveBufferSize);
+
+    settingsPack.set_int(lt::settings_pack::aio_threads, settings.asyncIOThreads);
+#ifdef QBT_USES_LIBTORRENT2
+    settingsPack.set_int(lt::settings_pack::hashing_threads, settings.hashingThreads);
+#endif
+    settingsPack.set_int(lt::settings_pack::file_pool_size, settings.filePoolSize);
+
+    const int checkingMemUsageSize = settings.checkingMemUsage * 64;
+    settingsPack.set_int(lt::settings_pack::checking_mem_usage, checkingMemUsageSize);
+
+    settingsPack.set_int(lt::settings_pack::send_buffer_watermark, settings.sendBufferWatermark * 1024);
+    settingsPack.set_int(lt::settings_pack::send_buffer_low_watermark, settings.sendBufferLowWatermark * 1024);
+    settingsPack.set_int(lt::settings_pack::send_buffer_watermark_factor, settings.sendBufferWatermarkFactor);
+}
+
+void SessionImpl::updateAutoTunedPerformanceSettings()
+{
+    // Host resources are detected again since the link speed or the storage of the save path may change
+    const PerformanceSettings settings = autoTunedPerformanceSettings(detectHostResources(savePath(), networkInterface()), m_observedPeakRate);
+    if (settings == m_autoTunedPerformanceSettings)
+        return;
+
+    m_autoTunedPerformanceSettings = settings;
+
+    lt::settings_pack settingsPack;
+    applyPerformanceSettings(settingsPack);
+    applyNativeSettings(std::move(settingsPack));
+}
+
 void SessionImpl::applyNetworkInterfacesSettings(lt::settings_pack &settingsPack) const
 {
     if (m_listenInterfaceConfigured)
@@ -2289,7 +2841,8 @@ void SessionImpl::configurePeerClasses()
         }
         catch (const std::exception &) {}
     }
-    m_nativeSession->set_peer_class_filter(f);
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
+        nativeSession->set_peer_class_filter(f);
 
     lt::peer_class_type_filter peerClassTypeFilter;
     peerClassTypeFilter.add(lt::peer_class_type_filter::tcp_socket, lt::session::tcp_peer_class_id);
@@ -2302,7 +2855,8 @@ void SessionImpl::configurePeerClasses()
         peerClassTypeFilter.disallow(lt::peer_class_type_filter::ssl_utp_socket
             , lt::session::global_peer_class_id);
     }
-    m_nativeSession->set_peer_class_type_filter(peerClassTypeFilter);
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
+        nativeSession->set_peer_class_type_filter(peerClassTypeFilter);
 }
 
 void SessionImpl::enableTracker(const bool enable)
@@ -2356,8 +2910,19 @@ void SessionImpl::populateAdditionalTrackersFromURL()
 
 void SessionImpl::processTorrentShareLimits(TorrentImpl *torrent)
 {
-    if (!torrent->isFinished() || torrent->isForced())
+    // Unfinished torrents are re-evaluated when they get finished
+    if (!torrent->isFinished())
+    {
+        m_shareLimitsChecks.remove(torrent);
+        return;
+    }
+
+    // Operating mode change doesn't get notified so forced torrents are simply re-evaluated periodically
+    if (torrent->isForced())
+    {
+        scheduleTorrentShareLimitsCheck(torrent, std::chrono::milliseconds(SHARE_LIMITS_CHECK_INTERVAL).count());
         return;
+    }
 
     const auto effectiveLimit = []<typename T>(const T limit, const T useGlobalLimit, const T globalLimit) -> T
     {
@@ -2368,79 +2933,191 @@ void SessionImpl::processTorrentShareLimits(TorrentImpl *torrent)
     const int seedingTimeLimit = effectiveLimit(torrent->seedingTimeLimit(), Torrent::USE_GLOBAL_SEEDING_TIME, globalMaxSeedingMinutes());
     const int inactiveSeedingTimeLimit = effectiveLimit(torrent->inactiveSeedingTimeLimit(), Torrent::USE_GLOBAL_INACTIVE_SEEDING_TIME, globalMaxInactiveSeedingMinutes());
 
+    const qreal ratio = torrent->realRatio();
+    const qlonglong seedingTime = torrent->finishedTime();
+    const qlonglong inactiveSeedingTime = torrent->timeSinceActivity();
+
     bool reached = false;
     QString description;
 
-    if (const qreal ratio = torrent->realRatio();
-            (ratioLimit >= 0) && (ratio >= ratioLimit))
+    if ((ratioLimit >= 0) && (ratio >= ratioLimit))
     {
         reached = true;
         description = tr("Torrent reached the share ratio limit.");
     }
-    else if (const qlonglong seedingTimeInMinutes = torrent->finishedTime() / 60;
+    else if (const qlonglong seedingTimeInMinutes = seedingTime / 60;
             (seedingTimeLimit >= 0) && (seedingTimeInMinutes >= seedingTimeLimit))
     {
         reached = true;
         description = tr("Torrent reached the seeding time limit.");
     }
-    else if (const qlonglong inactiveSeedingTimeInMinutes = torrent->timeSinceActivity() / 60;
+    else if (const qlonglong inactiveSeedingTimeInMinutes = inactiveSeedingTime / 60;
             (inactiveSeedingTimeLimit >= 0) && (inactiveSeedingTimeInMinutes >= inactiveSeedingTimeLimit))
     {
         reached = true;
         description = tr("Torrent reached the inactive seeding time limit.");
     }
 
-    if (reached)
+    if (!reached)
     {
-        const QString torrentName = tr("Torrent: \"%1\".").arg(torrent->name());
-        const ShareLimitAction shareLimitAction = (torrent->shareLimitAction() == ShareLimitAction::Default) ? m_shareLimitAction : torrent->shareLimitAction();
+        // Neither seeding time nor inactive seeding time can grow faster than the wall clock
+        // so the torrent can't reach these limits earlier than they are estimated here
+        qint64 delay = std::chrono::milliseconds(SHARE_LIMITS_MAX_CHECK_DELAY).count();
+        if (seedingTimeLimit >= 0)
+            delay = std::min<qint64>(delay, ((seedingTimeLimit * 60LL) - seedingTime) * 1000);
+        if (inactiveSeedingTimeLimit >= 0)
+            delay = std::min<qint64>(delay, ((inactiveSeedingTimeLimit * 60LL) - std::max<qlonglong>(inactiveSeedingTime, 0)) * 1000);
 
-        if (shareLimitAction == ShareLimitAction::Remove)
-        {
-            LogMsg(u"%1 %2 %3"_s.arg(description, tr("Removing torrent."), torrentName));
-            removeTorrent(torrent->id(), TorrentRemoveOption::KeepContent);
-        }
-        else if (shareLimitAction == ShareLimitAction::RemoveWithContent)
-        {
-            LogMsg(u"%1 %2 %3"_s.arg(description, tr("Removing torrent and deleting its content."), torrentName));
-            removeTorrent(torrent->id(), TorrentRemoveOption::RemoveContent);
-        }
-        else if ((shareLimitAction == ShareLimitAction::Stop) && !torrent->isStopped())
-        {
-            torrent->stop();
-            LogMsg(u"%1 %2 %3"_s.arg(description, tr("Torrent stopped."), torrentName));
-        }
-        else if ((shareLimitAction == ShareLimitAction::EnableSuperSeeding) && !torrent->isStopped() && !torrent->superSeeding())
+        qint64 uploadThreshold = -1;
+        if (ratioLimit >= 0)
         {
-            torrent->setSuperSeeding(true);
-            LogMsg(u"%1 %2 %3"_s.arg(description, tr("Super seeding enabled."), torrentName));
+            const qint64 upload = torrent->totalUpload();
+            uploadThreshold = (ratio > 0) ? static_cast<qint64>(upload * (ratioLimit / ratio)) : (upload + 1);
         }
+
+        scheduleTorrentShareLimitsCheck(torrent, delay, uploadThreshold);
+        return;
     }
-}
 
-void SessionImpl::torrentContentRemovingFinished(const QString &torrentName, const QString &errorMessage)
-{
-    if (errorMessage.isEmpty())
+    const QString torrentName = tr("Torrent: \"%1\".").arg(torrent->name());
+    const ShareLimitAction shareLimitAction = (torrent->shareLimitAction() == ShareLimitAction::Default) ? m_shareLimitAction : torrent->shareLimitAction();
+
+    if (shareLimitAction == ShareLimitAction::Remove)
     {
-        LogMsg(tr("Torrent content removed. Torrent: \"%1\"").arg(torrentName));
+        LogMsg(u"%1 %2 %3"_s.arg(description, tr("Removing torrent."), torrentName));
+        removeTorrent(torrent->id(), TorrentRemoveOption::KeepContent);
+        return;
     }
-    else
+
+    if (shareLimitAction == ShareLimitAction::RemoveWithContent)
     {
-        LogMsg(tr("Failed to remove torrent content. Torrent: \"%1\". Error: \"%2\"")
-            .arg(torrentName, errorMessage), Log::WARNING);
+        LogMsg(u"%1 %2 %3"_s.arg(description, tr("Removing torrent and deleting its content."), torrentName));
+        removeTorrent(torrent->id(), TorrentRemoveOption::RemoveContent);
+        return;
     }
-}
 
-Torrent *SessionImpl::getTorrent(const TorrentID &id) const
-{
-    return m_torrents.value(id);
+    if ((shareLimitAction == ShareLimitAction::Stop) && !torrent->isStopped())
+    {
+        torrent->stop();
+        LogMsg(u"%1 %2 %3"_s.arg(description, tr("Torrent stopped."), torrentName));
+    }
+    else if ((shareLimitAction == ShareLimitAction::EnableSuperSeeding) && !torrent->isStopped() && !torrent->superSeeding())
+    {
+        torrent->setSuperSeeding(true);
+        LogMsg(u"%1 %2 %3"_s.arg(description, tr("Super seeding enabled."), torrentName));
+    }
+
+    // Stopped torrents are re-evaluated when they get started,
+    // running ones are re-evaluated periodically to reapply the action if it is reverted
+    if (torrent->isStopped())
+        m_shareLimitsChecks.remove(torrent);
+    else
+        scheduleTorrentShareLimitsCheck(torrent, std::chrono::milliseconds(SHARE_LIMITS_CHECK_INTERVAL).count());
 }
 
-Torrent *SessionImpl::findTorrent(const InfoHash &infoHash) const
+void SessionImpl::scheduleTorrentShareLimitsCheck(TorrentImpl *torrent, const qint64 delay, const qint64 uploadThreshold)
 {
-    const auto id = TorrentID::fromInfoHash(infoHash);
-    if (Torrent *torrent = m_torrents.value(id))
-        return torrent;
+    const qint64 deadline = m_shareLimitsClock.elapsed() + std::max<qint64>(delay, 0);
+    const quint64 serial = ++m_shareLimitsCheckSerial;
+    m_shareLimitsChecks[torrent] = {.serial = serial, .deadline = deadline, .uploadThreshold = uploadThreshold};
+
+    // Get rid of outdated entries once they take too much space
+    if (m_shareLimitsCheckQueue.size() > (static_cast<std::size_t>(m_shareLimitsChecks.size()) * 2 + 1024))
+    {
+        m_shareLimitsCheckQueue.clear();
+        m_shareLimitsCheckQueue.reserve(m_shareLimitsChecks.size());
+        for (auto it = m_shareLimitsChecks.cbegin(); it != m_shareLimitsChecks.cend(); ++it)
+        {
+            m_shareLimitsCheckQueue.push_back({.deadline = it->deadline, .serial = it->serial
+                , .torrent = it.key()});
+        }
+        std::ranges::make_heap(m_shareLimitsCheckQueue, laterShareLimitsDeadline);
+        return;
+    }
+
+    m_shareLimitsCheckQueue.push_back({.deadline = deadline, .serial = serial, .torrent = torrent});
+    std::ranges::push_heap(m_shareLimitsCheckQueue, laterShareLimitsDeadline);
+}
+
+void SessionImpl::scheduleAllTorrentsShareLimitsCheck()
+{
+    for (TorrentImpl *torrent : asConst(m_torrents))
+        scheduleTorrentShareLimitsCheck(torrent, 0);
+}
+
+void SessionImpl::processDueTorrentsShareLimits()
+{
+    const qint64 now = m_shareLimitsClock.elapsed();
+
+    // Collect due torrents first since processing them can modify the queue
+    QList<TorrentID> dueTorrents;
+    while (!m_shareLimitsCheckQueue.empty() && (m_shareLimitsCheckQueue.front().deadline <= now))
+    {
+        std::ranges::pop_heap(m_shareLimitsCheckQueue, laterShareLimitsDeadline);
+        const ShareLimitsCheckQueueEntry entry = m_shareLimitsCheckQueue.back();
+        m_shareLimitsCheckQueue.pop_back();
+
+        if (const auto iter = m_shareLimitsChecks.find(entry.torrent);
+                (iter != m_shareLimitsChecks.end()) && (iter->serial == entry.serial))
+        {
+            m_shareLimitsChecks.erase(iter);
+            dueTorrents.push_back(entry.torrent->id());
+        }
+    }
+
+    for (const TorrentID &id : asConst(dueTorrents))
+    {
+        // Torrent could be removed during processing of the previous ones
+        if (TorrentImpl *torrent = m_torrents.value(id))
+            processTorrentShareLimits(torrent);
+    }
+}
+
+void SessionImpl::handleTorrentContentRemovingProgress(const TorrentID &torrentID, const int removedFiles, const int totalFiles)
+{
+    const auto iter = std::ranges::find(m_contentRemovingJobs, torrentID, &TorrentContentRemovingJobInfo::torrentID);
+    if (iter == m_contentRemovingJobs.end())
+        return;
+
+    iter->state = TorrentContentRemovingJobState::Removing;
+    iter->removedFiles = removedFiles;
+    iter->totalFiles = totalFiles;
+    emit torrentContentRemovingJobUpdated(*iter);
+}
+
+void SessionImpl::handleTorrentContentRemovingFinished(const TorrentID &torrentID, const QString &torrentName, const QString &errorMessage)
+{
+    if (const auto iter = std::ranges::find(m_contentRemovingJobs, torrentID, &TorrentContentRemovingJobInfo::torrentID)
+            ; iter != m_contentRemovingJobs.end())
+    {
+        TorrentContentRemovingJobInfo job = *iter;
+        m_contentRemovingJobs.erase(iter);
+        job.removedFiles = job.totalFiles;
+        job.errorMessage = errorMessage;
+        emit torrentContentRemovingJobFinished(job);
+    }
+
+    if (errorMessage.isEmpty())
+    {
+        LogMsg(tr("Torrent content removed. Torrent: \"%1\"").arg(torrentName));
+    }
+    else
+    {
+        LogMsg(tr("Failed to remove torrent content. Torrent: \"%1\". Error: \"%2\"")
+            .arg(torrentName, errorMessage), Log::WARNING);
+    }
+}
+
+Torrent *SessionImpl::getTorrent(const TorrentID &id) const
+{
+    return m_torrents.value(id);
+}
+
+Torrent *SessionImpl::findTorrent(const InfoHash &infoHash) const
+{
+    const auto id = TorrentID::fromInfoHash(infoHash);
+    if (Torrent *torrent = m_torrents.value(id))
+        return torrent;
 
     if (!infoHash.isHybrid())
         return m_hybridTorrentsByAltID.value(id);
@@ -2462,17 +3139,14 @@ void SessionImpl::banIP(const QString &ip)
     if (ec)
         return;
 
-    invokeAsync([session = m_nativeSession, addr]
-    {
-        lt::ip_filter filter = session->get_ip_filter();
-        filter.add_rule(addr, addr, lt::ip_filter::blocked);
-        session->set_ip_filter(std::move(filter));
-    });
-
     QStringList bannedIPs = m_bannedIPs;
     bannedIPs.append(ip);
     bannedIPs.sort();
     m_bannedIPs = bannedIPs;
+
+    m_pendingBannedIPs.append(addr);
+    if (!m_bannedIPsTimer->isActive())
+        m_bannedIPsTimer->start();
 }
 
 // Delete a torrent from the session, given its hash
@@ -2483,10 +3157,23 @@ bool SessionImpl::removeTorrent(const TorrentID &id, const TorrentRemoveOption d
     if (!torrent)
         return false;
 
+    m_torrentStatusTable.remove(torrent);
+    m_pendingTrackerEntryStatuses.remove(torrent);
+    m_shareLimitsChecks.remove(torrent);
+    m_dormantSeedScheduler.remove(id);
+    cancelFilePreallocation(id);
+    if (m_checkingTorrents.remove(torrent))
+        scheduleTorrentChecks();
+    m_lowDiskSpaceStoppedTorrents.remove(id);
+    m_peerStatistics -= torrent->peerStatistics();
+
     const TorrentID torrentID = torrent->id();
     const QString torrentName = torrent->name();
 
     qDebug("Deleting torrent with ID: %s", qUtf8Printable(torrentID.toString()));
+    // let the observers see the torrent in the state they are notified about
+    if (m_bulkUpdateLevel > 0)
+        notifyBulkUpdateChanges(torrent);
     emit torrentAboutToBeRemoved(torrent);
 
     if (const InfoHash infoHash = torrent->infoHash(); infoHash.isHybrid())
@@ -2512,27 +3199,27 @@ bool SessionImpl::removeTorrent(const TorrentID &id, const TorrentRemoveOption d
         }
         else
         {
-            m_nativeSession->remove_torrent(nativeHandle, lt::session::delete_partfile);
+            nativeSessionOf(nativeHandle)->remove_torrent(nativeHandle, lt::session::delete_partfile);
         }
     }
     else
     {
         m_removingTorrents[torrentID] = {torrentName, torrent->actualStorageLocation(), torrent->actualFilePaths(), deleteOption};
 
-        if (m_moveStorageQueue.size() > 1)
+        // Delete "move storage job" for the deleted torrent
+        // (note: we shouldn't delete active job)
+        const auto iter = std::ranges::find_if(asConst(m_moveStorageQueue)
+            , [torrent](const MoveStorageJob &job)
         {
-            // Delete "move storage job" for the deleted torrent
-            // (note: we shouldn't delete active job)
-            const auto iter = std::ranges::find_if(std::views::drop(asConst(m_moveStorageQueue), 1)
-                , [torrent](const MoveStorageJob &job)
-            {
-                return job.torrentHandle == torrent->nativeHandle();
-            });
-            if (iter != m_moveStorageQueue.cend())
-                m_moveStorageQueue.erase(iter);
+            return !job.isActive && (job.torrentHandle == torrent->nativeHandle());
+        });
+        if (iter != m_moveStorageQueue.cend())
+        {
+            m_moveStorageQueue.erase(iter);
+            startMoveStorageJobs();
         }
 
-        m_nativeSession->remove_torrent(torrent->nativeHandle(), lt::session::delete_partfile);
+        nativeSessionOf(torrent->nativeHandle())->remove_torrent(torrent->nativeHandle(), lt::session::delete_partfile);
     }
 
     // Remove it from torrent resume directory
@@ -2545,12 +3232,21 @@ bool SessionImpl::removeTorrent(const TorrentID &id, const TorrentRemoveOption d
 
 bool SessionImpl::cancelDownloadMetadata(const TorrentID &id)
 {
+    if (m_queuedMetadataDownloads.remove(id))
+    {
+        m_metadataDownloadScheduler.remove(id);
+        return true;
+    }
+
     const auto downloadedMetadataIter = m_downloadedMetadata.constFind(id);
     if (downloadedMetadataIter == m_downloadedMetadata.cend())
         return false;
 
     const lt::torrent_handle nativeHandle = downloadedMetadataIter.value();
     m_downloadedMetadata.erase(downloadedMetadataIter);
+    m_metadataDownloadScheduler.remove(id);
+    // the freed slot is taken by the next queued download
+    invoke([this] { startQueuedMetadataDownloads(); });
 
     if (!nativeHandle.is_valid())
         return true;
@@ -2563,10 +3259,11 @@ bool SessionImpl::cancelDownloadMetadata(const TorrentID &id)
         // so we need to remove both entries
         const auto altID = TorrentID::fromSHA1Hash(infoHash.v1());
         m_downloadedMetadata.remove(altID);
+        m_metadataDownloadScheduler.remove(TorrentID::fromInfoHash(infoHash));
     }
 #endif
 
-    m_nativeSession->remove_torrent(nativeHandle);
+    nativeSessionOf(nativeHandle)->remove_torrent(nativeHandle);
     return true;
 }
 
@@ -2597,18 +3294,30 @@ void SessionImpl::topTorrentsQueuePos(const QList<TorrentID> &ids)
 {
     const QList<TorrentImpl *> queuedTorrents = getQueuedTorrentsByID(ids);
 
-    // Top torrents queue position (starting with the one in the lowest queue position)
-    for (const TorrentImpl *torrent : std::views::reverse(queuedTorrents))
-        torrentQueuePositionTop(torrent->nativeHandle());
+    // Each torrent is moved directly to its final position (starting with the one in the highest queue position).
+    // It shifts only the torrents between both positions, which doesn't affect the torrents not moved yet.
+    // So torrents which are near their final position are cheap to move, unlike moving each of them to the top.
+    for (qsizetype i = 0; i < queuedTorrents.size(); ++i)
+        torrentQueuePositionSet(queuedTorrents[i]->nativeHandle(), static_cast<int>(i));
 
     m_torrentsQueueChanged = true;
 }
 
 void SessionImpl::bottomTorrentsQueuePos(const QList<TorrentID> &ids)
 {
-    // Bottom torrents queue position (starting with the one in the highest queue position)
-    for (TorrentImpl *torrent : asConst(getQueuedTorrentsByID(ids)))
-        torrentQueuePositionBottom(torrent->nativeHandle());
+    const QList<TorrentImpl *> queuedTorrents = getQueuedTorrentsByID(ids);
+    const auto queueSize = static_cast<int>(std::ranges::count_if(m_torrents, [](const TorrentImpl *torrent)
+    {
+        return (torrent->queuePosition() >= 0);
+    }));
+
+    // Each torrent is moved directly to its final position (starting with the one in the lowest queue position),
+    // see topTorrentsQueuePos()
+    for (qsizetype i = 0; i < queuedTorrents.size(); ++i)
+    {
+        const TorrentImpl *torrent = queuedTorrents[queuedTorrents.size() - 1 - i];
+        torrentQueuePositionSet(torrent->nativeHandle(), (queueSize - 1 - static_cast<int>(i)));
+    }
 
     for (const lt::torrent_handle &torrentHandle : asConst(m_downloadedMetadata))
         torrentQueuePositionBottom(torrentHandle);
@@ -2616,6 +3325,91 @@ void SessionImpl::bottomTorrentsQueuePos(const QList<TorrentID> &ids)
     m_torrentsQueueChanged = true;
 }
 
+void SessionImpl::deferTorrentResumeDataRequest(TorrentImpl *torrent)
+{
+    m_deferredResumeDataRequests.append(torrent);
+    if (m_isDeferredResumeDataRequestsInvoked)
+        return;
+
+    m_isDeferredResumeDataRequestsInvoked = true;
+    invoke([this] { processDeferredResumeDataRequests(); });
+}
+
+void SessionImpl::processDeferredResumeDataRequests()
+{
+    m_isDeferredResumeDataRequestsInvoked = false;
+
+    const QList<QPointer<TorrentImpl>> torrents = std::exchange(m_deferredResumeDataRequests, {});
+    for (TorrentImpl *torrent : torrents)
+    {
+        if (torrent)
+            torrent->handleDeferredResumeDataRequest();
+    }
+}
+
+void SessionImpl::scheduleActualFilePathsUpdate()
+{
+    // The torrents are updated in the background, so that toggling the option doesn't freeze the application
+    // when there are lots of them. The files of the active torrents are the most likely to be accessed,
+    // so they are updated first, then the ones of the other running torrents.
+    m_actualFilePathsUpdateQueue.clear();
+    m_actualFilePathsUpdateQueue.reserve(m_torrents.size());
+    for (TorrentImpl *torrent : asConst(m_torrents))
+    {
+        if (torrent->hasMetadata())
+            m_actualFilePathsUpdateQueue.append(torrent);
+    }
+
+    std::ranges::stable_sort(m_actualFilePathsUpdateQueue, {}, [](const QPointer<TorrentImpl> &torrent)
+    {
+        return torrent->isActive() ? 0 : (!torrent->isStopped() ? 1 : 2);
+    });
+
+    m_actualFilePathsUpdateCount = m_actualFilePathsUpdateQueue.size();
+    m_actualFilePathsUpdateProgress = 0;
+
+    if (m_actualFilePathsUpdateQueue.isEmpty())
+    {
+        m_actualFilePathsUpdateTimer->stop();
+        return;
+    }
+
+    LogMsg(tr("Updating file names of %1 torrents on disk...").arg(m_actualFilePathsUpdateCount));
+    processActualFilePathsUpdates();
+}
+
+void SessionImpl::processActualFilePathsUpdates()
+{
+    int filesCount = 0;
+    while (!m_actualFilePathsUpdateQueue.isEmpty() && (filesCount < ACTUAL_FILE_PATHS_UPDATE_BATCH_SIZE))
+    {
+        const QPointer<TorrentImpl> torrent = m_actualFilePathsUpdateQueue.takeFirst();
+        if (!torrent)
+            continue;
+
+        torrent->handleActualFilePathsOptionsChanged();
+        filesCount += std::max(1, torrent->filesCount());
+    }
+
+    if (m_actualFilePathsUpdateQueue.isEmpty())
+    {
+        LogMsg(tr("File names of torrents are updated on disk"));
+        return;
+    }
+
+    // the progress is reported in steps of 10%
+    const qsizetype updatedCount = m_actualFilePathsUpdateCount - m_actualFilePathsUpdateQueue.size();
+    const int progress = static_cast<int>((updatedCount * 10) / m_actualFilePathsUpdateCount) * 10;
+    if (progress > m_actualFilePathsUpdateProgress)
+    {
+        m_actualFilePathsUpdateProgress = progress;
+        LogMsg(tr("Updating file names of torrents on disk. Progress: %1%. Torrents: %2/%3")
+                .arg(QString::number(progress), QString::number(updatedCount), QString::number(m_actualFilePathsUpdateCount)));
+    }
+
+    m_actualFilePathsUpdateTimer->start();
+}
+
 void SessionImpl::handleTorrentResumeDataRequested(const TorrentImpl *torrent)
 {
     qDebug("Saving resume data is requested for torrent '%s'...", qUtf8Printable(torrent->name()));
@@ -2632,11 +3426,25 @@ QList<Torrent *> SessionImpl::torrents() const
     return result;
 }
 
+const TorrentStatusTable &SessionImpl::torrentStatusTable() const
+{
+    return m_torrentStatusTable;
+}
+
 qsizetype SessionImpl::torrentsCount() const
 {
     return m_torrents.size();
 }
 
+qint64 SessionImpl::estimatedTorrentsMemoryUsage() const
+{
+    qint64 size = 0;
+    for (const TorrentImpl *torrent : asConst(m_torrents))
+        size += torrent->estimatedMemoryUsage();
+
+    return size;
+}
+
 bool SessionImpl::addTorrent(const TorrentDescriptor &torrentDescr, const AddTorrentParams &params)
 {
     if (!isRestored())
@@ -2651,7 +3459,7 @@ LoadTorrentParams SessionImpl::initLoadTorrentParams(const AddTorrentParams &add
 
     loadTorrentParams.name = addTorrentParams.name;
     loadTorrentParams.firstLastPiecePriority = addTorrentParams.firstLastPiecePriority;
-    loadTorrentParams.hasFinishedStatus = addTorrentParams.skipChecking; // do not react on 'torrent_finished_alert' when skipping
+    loadTorrentParams.hasFinishedStatus = (addTorrentParams.skipChecking || addTorrentParams.isContentVerified); // do not react on 'torrent_finished_alert' when skipping
     loadTorrentParams.contentLayout = addTorrentParams.contentLayout.value_or(torrentContentLayout());
     loadTorrentParams.operatingMode = (addTorrentParams.addForced ? TorrentOperatingMode::Forced : TorrentOperatingMode::AutoManaged);
     loadTorrentParams.stopped = addTorrentParams.addStopped.value_or(isAddTorrentStopped());
@@ -2892,7 +3700,11 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
     p.download_limit = addTorrentParams.downloadLimit;
 
     // Preallocation mode
-    p.storage_mode = isPreallocationEnabled() ? lt::storage_mode_allocate : lt::storage_mode_sparse;
+    // The files of the new torrents are preallocated in background (if it is supported)
+    // instead of letting libtorrent allocate them in its disk IO when they are opened
+    const bool preallocateInBackground = isPreallocationEnabled() && FilePreallocator::isSupported()
+            && !addTorrentParams.skipChecking;
+    p.storage_mode = (isPreallocationEnabled() && !preallocateInBackground) ? lt::storage_mode_allocate : lt::storage_mode_sparse;
 
     if (addTorrentParams.sequential)
         p.flags |= lt::torrent_flags::sequential_download;
@@ -2906,6 +3718,13 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
     else
         p.flags &= ~lt::torrent_flags::seed_mode;
 
+    // Start seeding verified content instantly, libtorrent only checks the sizes of the files
+    if (addTorrentParams.isContentVerified && hasMetadata)
+    {
+        p.flags &= ~lt::torrent_flags::seed_mode;
+        p.have_pieces.resize(p.ti->num_pieces(), true);
+    }
+
     if (loadTorrentParams.stopped || (loadTorrentParams.operatingMode == TorrentOperatingMode::AutoManaged))
         p.flags |= lt::torrent_flags::paused;
     else
@@ -2921,7 +3740,7 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
 
     // Limits
     p.max_connections = maxConnectionsPerTorrent();
-    p.max_uploads = maxUploadsPerTorrent();
+    p.max_uploads = m_unchokeSlotsController.torrentSlots();
 
     p.userdata = LTClientData(new ExtensionData);
 #ifndef QBT_USES_LIBTORRENT2
@@ -2938,7 +3757,7 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
         return findIncompleteFiles(actualSavePath, actualDownloadPath, filePaths);
     };
 
-    resolveFileNames().then(this, [this, id, loadTorrentParams = std::move(loadTorrentParams)](const FileSearchResult &result) mutable
+    resolveFileNames().then(this, [this, id, preallocateInBackground, loadTorrentParams = std::move(loadTorrentParams)](const FileSearchResult &result) mutable
     {
         lt::add_torrent_params &p = loadTorrentParams.ltAddTorrentParams;
 
@@ -2951,8 +3770,9 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
                 p.renamed_files[nativeIndexes[i]] = result.fileNames[i].toString().toStdString();
         }
 
-        m_nativeSession->async_add_torrent(p);
-        m_addTorrentAlertHandlers.append([this, loadTorrentParams = std::move(loadTorrentParams)](const lt::add_torrent_alert *alert) mutable
+        const qsizetype shard = nativeSessionIndexFor(p);
+        m_nativeSessions[shard]->async_add_torrent(p);
+        m_addTorrentAlertHandlers[shard].append([this, preallocateInBackground, loadTorrentParams = std::move(loadTorrentParams)](const lt::add_torrent_alert *alert) mutable
         {
             if (alert->error)
             {
@@ -2977,6 +3797,13 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
                 LogMsg(tr("Added new torrent. Torrent: \"%1\"").arg(torrent->name()));
                 emit torrentAdded(torrent);
 
+                if (preallocateInBackground)
+                {
+                    m_torrentsToPreallocate.insert(torrent->id());
+                    if (torrent->hasMetadata())
+                        preallocateFiles(torrent);
+                }
+
                 // The following is useless for newly added magnet
                 if (torrent->hasMetadata())
                 {
@@ -2992,16 +3819,7 @@ bool SessionImpl::addTorrent_impl(const TorrentDescriptor &source, const AddTorr
 
 QFuture<FileSearchResult> SessionImpl::findIncompleteFiles(const Path &savePath, const Path &downloadPath, const PathList &filePaths) const
 {
-    QPromise<FileSearchResult> promise;
-    QFuture<FileSearchResult> future = promise.future();
-    promise.start();
-    QMetaObject::invokeMethod(m_fileSearcher, [=, this, promise = std::move(promise)]() mutable
-    {
-        m_fileSearcher->search(filePaths, savePath, downloadPath, isAppendExtensionEnabled(), promise);
-        promise.finish();
-    });
-
-    return future;
+    return m_fileSearcher->search(filePaths, savePath, downloadPath, isAppendExtensionEnabled());
 }
 
 void SessionImpl::enablePortMapping()
@@ -3014,7 +3832,7 @@ void SessionImpl::enablePortMapping()
         lt::settings_pack settingsPack;
         settingsPack.set_bool(lt::settings_pack::enable_upnp, true);
         settingsPack.set_bool(lt::settings_pack::enable_natpmp, true);
-        m_nativeSession->apply_settings(std::move(settingsPack));
+        applyNativeSettings(std::move(settingsPack));
 
         m_isPortMappingEnabled = true;
 
@@ -3032,7 +3850,7 @@ void SessionImpl::disablePortMapping()
         lt::settings_pack settingsPack;
         settingsPack.set_bool(lt::settings_pack::enable_upnp, false);
         settingsPack.set_bool(lt::settings_pack::enable_natpmp, false);
-        m_nativeSession->apply_settings(std::move(settingsPack));
+        applyNativeSettings(std::move(settingsPack));
 
         m_mappedPorts.clear();
         m_isPortMappingEnabled = false;
@@ -3051,7 +3869,7 @@ void SessionImpl::addMappedPorts(const QSet<quint16> &ports)
         for (const quint16 port : ports)
         {
             if (!m_mappedPorts.contains(port))
-                m_mappedPorts.insert(port, m_nativeSession->add_port_mapping(lt::session::tcp, port, port));
+                m_mappedPorts.insert(port, primaryNativeSession()->add_port_mapping(lt::session::tcp, port, port));
         }
     });
 }
@@ -3069,16 +3887,31 @@ void SessionImpl::removeMappedPorts(const QSet<quint16> &ports)
                 return false;
 
             for (const lt::port_mapping_t &handle : handles)
-                m_nativeSession->delete_port_mapping(handle);
+                primaryNativeSession()->delete_port_mapping(handle);
 
             return true;
         });
     });
 }
 
+int SessionImpl::maxActiveMetadataDownloads() const
+{
+    return m_maxActiveMetadataDownloads;
+}
+
+void SessionImpl::setMaxActiveMetadataDownloads(const int val)
+{
+    if (val == m_maxActiveMetadataDownloads)
+        return;
+
+    m_maxActiveMetadataDownloads = std::max(1, val);
+    m_metadataDownloadScheduler.setMaxActive(m_maxActiveMetadataDownloads);
+    startQueuedMetadataDownloads();
+}
+
 // Add a torrent to libtorrent session in hidden mode
 // and force it to download its metadata
-bool SessionImpl::downloadMetadata(const TorrentDescriptor &torrentDescr)
+bool SessionImpl::downloadMetadata(const TorrentDescriptor &torrentDescr, const MetadataDownloadPriority priority)
 {
     Q_ASSERT(!torrentDescr.info().has_value());
     if (torrentDescr.info().has_value()) [[unlikely]]
@@ -3091,6 +3924,17 @@ bool SessionImpl::downloadMetadata(const TorrentDescriptor &torrentDescr)
     if (isKnownTorrent(infoHash))
         return false;
 
+    const auto id = TorrentID::fromInfoHash(infoHash);
+    const TorrentInfo *cachedMetadata = m_downloadedMetadataCache.object(id);
+    if (!cachedMetadata && infoHash.isHybrid())
+        cachedMetadata = m_downloadedMetadataCache.object(TorrentID::fromSHA1Hash(infoHash.v1()));
+    if (cachedMetadata)
+    {
+        // the requester expects the metadata to be reported asynchronously
+        invoke([this, metadata = *cachedMetadata] { emit metadataDownloaded(metadata); });
+        return true;
+    }
+
     lt::add_torrent_params p = torrentDescr.ltAddTorrentParams();
 
     if (isAddTrackersEnabled())
@@ -3119,9 +3963,8 @@ bool SessionImpl::downloadMetadata(const TorrentDescriptor &torrentDescr)
 
     // Limits
     p.max_connections = maxConnectionsPerTorrent();
-    p.max_uploads = maxUploadsPerTorrent();
+    p.max_uploads = m_unchokeSlotsController.torrentSlots();
 
-    const auto id = TorrentID::fromInfoHash(infoHash);
     const Path savePath = Utils::Fs::tempPath() / Path(id.toString());
     p.save_path = savePath.toString().toStdString();
 
@@ -3136,114 +3979,347 @@ bool SessionImpl::downloadMetadata(const TorrentDescriptor &torrentDescr)
     p.storage = customStorageConstructor;
 #endif
 
-    // Adding torrent to libtorrent session
-    m_nativeSession->async_add_torrent(p);
-    m_downloadedMetadata.insert(id, {});
-    m_addTorrentAlertHandlers.append([this](const lt::add_torrent_alert *alert)
-    {
-        if (alert->error)
-        {
-            const QString msg = QString::fromStdString(alert->message());
-            LogMsg(tr("Failed to download torrent metadata. Reason: \"%1\"").arg(msg), Log::WARNING);
+    const qint64 now = m_metadataDownloadClock.elapsed() / 1000;
+    m_metadataDownloadScheduler.schedule(id, priority, now);
+    m_queuedMetadataDownloads.insert(id, std::move(p));
+    if (!m_metadataDownloadExpiryTimer->isActive())
+        m_metadataDownloadExpiryTimer->start();
 
-            m_downloadedMetadata.remove(getInfoHash(alert->params).toTorrentID());
-        }
-        else
+    startQueuedMetadataDownloads();
+    return true;
+}
+
+void SessionImpl::startQueuedMetadataDownloads()
+{
+    const qint64 now = m_metadataDownloadClock.elapsed() / 1000;
+    for (const TorrentID &id : asConst(m_metadataDownloadScheduler.takeStartable(now)))
+    {
+        // Adding torrent to libtorrent session
+        lt::add_torrent_params p = m_queuedMetadataDownloads.take(id);
+        const qsizetype shard = nativeSessionIndexFor(p);
+        m_nativeSessions[shard]->async_add_torrent(std::move(p));
+        m_downloadedMetadata.insert(id, {});
+        m_addTorrentAlertHandlers[shard].append([this](const lt::add_torrent_alert *alert)
         {
-            const InfoHash infoHash = getInfoHash(alert->handle);
-            const auto torrentID = TorrentID::fromInfoHash(infoHash);
+            if (alert->error)
+            {
+                const QString msg = QString::fromStdString(alert->message());
+                LogMsg(tr("Failed to download torrent metadata. Reason: \"%1\"").arg(msg), Log::WARNING);
 
-            if (const auto downloadedMetadataIter = m_downloadedMetadata.find(torrentID)
-                ; downloadedMetadataIter != m_downloadedMetadata.end())
+                const TorrentID torrentID = getInfoHash(alert->params).toTorrentID();
+                m_downloadedMetadata.remove(torrentID);
+                m_metadataDownloadScheduler.remove(torrentID);
+                invoke([this] { startQueuedMetadataDownloads(); });
+            }
+            else
             {
-                downloadedMetadataIter.value() = alert->handle;
-                if (infoHash.isHybrid())
+                const InfoHash infoHash = getInfoHash(alert->handle);
+                const auto torrentID = TorrentID::fromInfoHash(infoHash);
+
+                if (const auto downloadedMetadataIter = m_downloadedMetadata.find(torrentID)
+                    ; downloadedMetadataIter != m_downloadedMetadata.end())
                 {
-                    // index hybrid magnet links by both v1 and v2 info hashes
-                    const auto altID = TorrentID::fromSHA1Hash(infoHash.v1());
-                    m_downloadedMetadata[altID] = alert->handle;
+                    downloadedMetadataIter.value() = alert->handle;
+                    if (infoHash.isHybrid())
+                    {
+                        // index hybrid magnet links by both v1 and v2 info hashes
+                        const auto altID = TorrentID::fromSHA1Hash(infoHash.v1());
+                        m_downloadedMetadata[altID] = alert->handle;
+                    }
                 }
             }
-        }
-    });
+        });
+    }
+}
 
-    return true;
+void SessionImpl::expireMetadataDownloads()
+{
+    const qint64 now = m_metadataDownloadClock.elapsed() / 1000;
+    for (const TorrentID &id : asConst(m_metadataDownloadScheduler.takeExpired(now)))
+    {
+        cancelDownloadMetadata(id);
+        LogMsg(tr("Metadata download timed out. Torrent infohash: %1").arg(id.toString()), Log::INFO);
+    }
+
+    if (m_metadataDownloadScheduler.isEmpty())
+        m_metadataDownloadExpiryTimer->stop();
+}
+
+void SessionImpl::handleMetadataDownloaded(const TorrentInfo &metadata)
+{
+    const InfoHash infoHash = metadata.infoHash();
+    m_downloadedMetadataCache.insert(infoHash.toTorrentID(), new TorrentInfo(metadata));
+    if (infoHash.isHybrid())
+        m_downloadedMetadataCache.insert(TorrentID::fromSHA1Hash(infoHash.v1()), new TorrentInfo(metadata));
+
+    emit metadataDownloaded(metadata);
 }
 
 void SessionImpl::exportTorrentFile(const Torrent *torrent, const Path &folderPath)
 {
-    if (!folderPath.exists() && !Utils::Fs::mkpath(folderPath))
+    // Only the bencoding is done here, the destination is prepared and written in the IO thread
+    const nonstd::expected<QByteArray, QString> exportResult = torrent->exportToBuffer();
+    if (!exportResult)
+    {
+        LogMsg(tr("Failed to export torrent. Torrent: \"%1\". Destination: \"%2\". Reason: \"%3\"")
+               .arg(torrent->name(), folderPath.toString(), exportResult.error()), Log::WARNING);
+        return;
+    }
+
+    QMetaObject::invokeMethod(m_torrentFileExporter
+            , [exporter = m_torrentFileExporter, torrentName = torrent->name(), folderPath
+                , fileName = Utils::Fs::toValidFileName(torrent->name()), data = exportResult.value()]
+    {
+        exporter->exportTorrent(torrentName, folderPath, fileName, data);
+    });
+}
+
+void SessionImpl::preallocateFiles(TorrentImpl *const torrent)
+{
+    if (!m_torrentsToPreallocate.contains(torrent->id()) || !torrent->hasMetadata())
         return;
 
-    const QString validName = Utils::Fs::toValidFileName(torrent->name());
-    QString torrentExportFilename = u"%1.torrent"_s.arg(validName);
-    Path newTorrentPath = folderPath / Path(torrentExportFilename);
-    int counter = 0;
-    while (newTorrentPath.exists())
+    const Path storageLocation = torrent->actualStorageLocation();
+    const QList<DownloadPriority> filePriorities = torrent->filePriorities();
+    QList<FilePreallocator::File> files;
+    for (int i = 0; i < torrent->filesCount(); ++i)
     {
-        // Append number to torrent name to make it unique
-        torrentExportFilename = u"%1 (%2).torrent"_s.arg(validName).arg(++counter);
-        newTorrentPath = folderPath / Path(torrentExportFilename);
+        if (filePriorities.value(i, DownloadPriority::Normal) != DownloadPriority::Ignored)
+            files.append({.path = (storageLocation / torrent->actualFilePath(i)), .size = torrent->fileSize(i)});
     }
 
-    const nonstd::expected<void, QString> result = torrent->exportToFile(newTorrentPath);
-    if (!result)
+    torrent->setPreallocationProgress(0);
+    QMetaObject::invokeMethod(m_filePreallocator, [preallocator = m_filePreallocator, torrentID = torrent->id(), files]
     {
-        LogMsg(tr("Failed to export torrent. Torrent: \"%1\". Destination: \"%2\". Reason: \"%3\"")
-               .arg(torrent->name(), newTorrentPath.toString(), result.error()), Log::WARNING);
+        preallocator->preallocate(torrentID, files);
+    });
+}
+
+void SessionImpl::cancelFilePreallocation(const TorrentID &id)
+{
+    if (!m_torrentsToPreallocate.remove(id))
+        return;
+
+    if (TorrentImpl *torrent = m_torrents.value(id))
+        torrent->setPreallocationProgress(1);
+    QMetaObject::invokeMethod(m_filePreallocator, [preallocator = m_filePreallocator, id]
+    {
+        preallocator->cancel(id);
+    });
+}
+
+void SessionImpl::handleFilePreallocationProgress(const TorrentID &torrentID, const qint64 allocatedBytes, const qint64 totalBytes)
+{
+    if (!m_torrentsToPreallocate.contains(torrentID))
+        return;
+
+    if (TorrentImpl *torrent = m_torrents.value(torrentID); torrent && (totalBytes > 0))
+        torrent->setPreallocationProgress(static_cast<qreal>(allocatedBytes) / totalBytes);
+}
+
+void SessionImpl::handleFilePreallocationFinished(const TorrentID &torrentID, const QString &errorMessage)
+{
+    // ignore the stale results of the cancelled jobs
+    if (!m_torrentsToPreallocate.remove(torrentID))
+        return;
+
+    TorrentImpl *torrent = m_torrents.value(torrentID);
+    if (!torrent)
+        return;
+
+    torrent->setPreallocationProgress(1);
+    if (!errorMessage.isEmpty())
+    {
+        LogMsg(tr("Failed to preallocate torrent files. Torrent: \"%1\". Reason: \"%2\"")
+               .arg(torrent->name(), errorMessage), Log::WARNING);
     }
 }
 
 void SessionImpl::generateResumeData()
 {
+    const TraceSpan traceSpan {"SessionImpl::generateResumeData"};
+
+    // If only counters are changed the request is rejected by libtorrent
+    // and the counters are stored separately (when supported by the storage)
+    const lt::resume_data_flags_t flags = m_resumeDataStorage->canStoreCounters()
+            ? SIGNIFICANT_RESUME_DATA_CHANGES : lt::resume_data_flags_t();
     for (TorrentImpl *const torrent : asConst(m_torrents))
     {
         if (torrent->needSaveResumeData())
-            torrent->requestResumeData();
+            torrent->requestResumeData(flags);
     }
 }
 
-// Called on exit
-void SessionImpl::saveResumeData()
+// Metadata of stopped torrents that haven't been accessed during the last check period
+// is released from memory, it is loaded again as soon as it is needed
+void SessionImpl::releaseStoppedTorrentsMetadata()
 {
-    for (TorrentImpl *torrent : asConst(m_torrents))
+    if (!isStoppedTorrentsColdModeEnabled())
+        return;
+
+    int releasedCount = 0;
+    for (TorrentImpl *const torrent : asConst(m_torrents))
     {
-        // When the session is terminated due to unrecoverable error
-        // some of the torrent handles can be corrupted
-        try
-        {
-            torrent->requestResumeData(lt::torrent_handle::only_if_modified);
-        }
-        catch (const std::exception &) {}
+        if (torrent->releaseMetadata())
+            ++releasedCount;
     }
 
-    // clear queued storage move jobs except the current ongoing one
-    if (m_moveStorageQueue.size() > 1)
-        m_moveStorageQueue.resize(1);
+    if (releasedCount > 0)
+        qDebug("Released metadata of %d stopped torrents", releasedCount);
+}
 
-    QElapsedTimer timer;
-    timer.start();
+// The seeding torrents without demand (i.e. not uploading and having no leechers known) for the idle time
+// are paused, the libtorrent doesn't tick them and they don't take any of the active torrents slots then.
+// They are scraped once per scrape interval and woken up when the scrape reports leechers.
+void SessionImpl::processDormantSeeds()
+{
+    const qint64 now = m_dormantSeedsClock.elapsed() / 1000;
 
-    while ((m_numResumeData > 0) || !m_moveStorageQueue.isEmpty() || m_needSaveTorrentsQueue)
+    for (TorrentImpl *const torrent : asConst(m_torrents))
     {
-        const lt::seconds waitTime {5};
-        const lt::seconds expireTime {30};
+        const TorrentID id = torrent->id();
+        if (!torrent->isFinished() || torrent->isStopped() || torrent->isForced())
+        {
+            // e.g. the dormant seed has got new files to download
+            torrent->setDormant(false);
+            m_dormantSeedScheduler.remove(id);
+            continue;
+        }
 
-        // only terminate when no storage is moving
-        if (timer.hasExpired(lt::total_milliseconds(expireTime)) && m_moveStorageQueue.isEmpty())
+        if (torrent->isDormant())
         {
-            LogMsg(tr("Aborted saving resume data. Number of outstanding torrents: %1").arg(QString::number(m_numResumeData))
-                , Log::CRITICAL);
-            break;
+            if (!m_dormantSeedScheduler.isDormant(id)) [[unlikely]]
+                wakeDormantSeed(torrent);
+            continue;
+        }
+
+        if (m_dormantSeedScheduler.isDormant(id))
+        {
+            // it was woken up otherwise, e.g. it was reloaded or rechecked
+            m_dormantSeedScheduler.wake(id, now);
+            continue;
         }
 
-        fetchPendingAlerts(waitTime);
+        const bool hasDemand = (torrent->uploadPayloadRate() > 0) || (torrent->leechsCount() > 0)
+                || (torrent->totalLeechersCount() > 0);
+        m_dormantSeedScheduler.updateAwake(id, hasDemand, now);
+    }
 
-        bool hasWantedAlert = false;
-        for (lt::alert *alert : m_alerts)
+    int dormantCount = 0;
+    for (const TorrentID &id : asConst(m_dormantSeedScheduler.takeIdle(now)))
+    {
+        TorrentImpl *const torrent = m_torrents.value(id);
+        if (!torrent) [[unlikely]]
         {
-            if (const int alertType = alert->type();
-                (alertType == lt::save_resume_data_alert::alert_type) || (alertType == lt::save_resume_data_failed_alert::alert_type)
+            m_dormantSeedScheduler.remove(id);
+            continue;
+        }
+
+        torrent->setDormant(true);
+        if (torrent->isDormant())
+            ++dormantCount;
+        else
+            m_dormantSeedScheduler.wake(id, now);  // it can't sleep now, e.g. it is queued or checked
+    }
+
+    if (dormantCount > 0)
+        qDebug("Put %d idle seeding torrents to sleep", dormantCount);
+
+    for (const TorrentID &id : asConst(m_dormantSeedScheduler.takeScrapeDue(now, MAX_DORMANT_SEED_SCRAPES_PER_CHECK)))
+    {
+        TorrentImpl *const torrent = m_torrents.value(id);
+        if (!torrent) [[unlikely]]
+        {
+            m_dormantSeedScheduler.remove(id);
+            continue;
+        }
+
+        // the torrent without trackers can't be scraped, it announces to DHT and the peers are looked for instead
+        if (torrent->trackers().isEmpty())
+            wakeDormantSeed(torrent);
+        else
+            torrent->nativeHandle().scrape_tracker();
+    }
+}
+
+void SessionImpl::wakeDormantSeed(TorrentImpl *torrent)
+{
+    torrent->setDormant(false);
+    m_dormantSeedScheduler.wake(torrent->id(), (m_dormantSeedsClock.elapsed() / 1000));
+}
+
+// Called on exit
+void SessionImpl::saveResumeData(const QDeadlineTimer &deadline)
+{
+    const TraceSpan traceSpan {"SessionImpl::saveResumeData"};
+
+    // Torrents having unsaved changes are requested first, the ones with the most outdated
+    // stored resume data go ahead, so the most valuable data is saved if the deadline is reached.
+    // The rest are requested anyway since their cached status may be outdated,
+    // libtorrent rejects the request if nothing has changed actually.
+    QList<TorrentImpl *> torrents = m_torrents.values();
+    std::ranges::sort(torrents, [](const TorrentImpl *left, const TorrentImpl *right)
+    {
+        if (left->needSaveResumeData() != right->needSaveResumeData())
+            return left->needSaveResumeData();
+        return (left->resumeDataAge() > right->resumeDataAge());
+    });
+
+    for (TorrentImpl *torrent : asConst(torrents))
+    {
+        // When the session is terminated due to unrecoverable error
+        // some of the torrent handles can be corrupted
+        try
+        {
+            torrent->requestResumeData(lt::torrent_handle::only_if_modified);
+        }
+        catch (const std::exception &) {}
+    }
+
+    // clear queued storage move jobs except the currently ongoing ones
+    m_moveStorageQueue.removeIf([](const MoveStorageJob &job) { return !job.isActive; });
+
+    const int numRequested = m_numResumeData;
+    int numReported = numRequested;
+
+    QElapsedTimer timer;
+    timer.start();
+    QElapsedTimer progressTimer;
+    progressTimer.start();
+
+    while ((m_numResumeData > 0) || !m_moveStorageQueue.isEmpty() || m_needSaveTorrentsQueue)
+    {
+        const lt::seconds waitTime {5};
+        const lt::seconds expireTime {30};
+        const lt::seconds progressInterval {2};
+
+        // only terminate when no storage is moving
+        if (m_moveStorageQueue.isEmpty())
+        {
+            if (deadline.hasExpired())
+            {
+                LogMsg(tr("Shutdown timeout is reached while saving resume data. Number of outstanding torrents: %1")
+                    .arg(QString::number(m_numResumeData)), Log::CRITICAL);
+                break;
+            }
+
+            if (timer.hasExpired(lt::total_milliseconds(expireTime)))
+            {
+                LogMsg(tr("Aborted saving resume data. Number of outstanding torrents: %1").arg(QString::number(m_numResumeData))
+                    , Log::CRITICAL);
+                break;
+            }
+        }
+
+        const qint64 remainingTime = deadline.remainingTime();
+        fetchPendingAlerts(((remainingTime >= 0) && (remainingTime < lt::total_milliseconds(waitTime)))
+                ? lt::time_duration(lt::milliseconds(remainingTime)) : lt::time_duration(waitTime));
+
+        bool hasWantedAlert = false;
+        for (lt::alert *alert : m_alerts)
+        {
+            if (const int alertType = alert->type();
+                (alertType == lt::save_resume_data_alert::alert_type) || (alertType == lt::save_resume_data_failed_alert::alert_type)
                 || (alertType == lt::storage_moved_alert::alert_type) || (alertType == lt::storage_moved_failed_alert::alert_type)
                 || (alertType == lt::state_update_alert::alert_type))
             {
@@ -3255,6 +4331,15 @@ void SessionImpl::saveResumeData()
 
         if (hasWantedAlert)
             timer.start();
+
+        if ((m_numResumeData > 0) && (m_numResumeData != numReported)
+            && progressTimer.hasExpired(lt::total_milliseconds(progressInterval)))
+        {
+            LogMsg(tr("Saving resume data. Processed torrents: %1/%2")
+                .arg(QString::number(numRequested - m_numResumeData), QString::number(numRequested)));
+            numReported = m_numResumeData;
+            progressTimer.start();
+        }
     }
 }
 
@@ -3310,6 +4395,7 @@ void SessionImpl::setSavePath(const Path &path)
     }
 
     m_savePath = newPath;
+    invalidateCategoryPathsCache();
     for (TorrentImpl *const torrent : asConst(m_torrents))
         torrent->handleCategoryOptionsChanged();
 
@@ -3352,6 +4438,7 @@ void SessionImpl::setDownloadPath(const Path &path)
     }
 
     m_downloadPath = newPath;
+    invalidateCategoryPathsCache();
     for (TorrentImpl *const torrent : asConst(m_torrents))
         torrent->handleCategoryOptionsChanged();
 }
@@ -3643,7 +4730,7 @@ void SessionImpl::applySpeedProfile(const QString &profileName)
     lt::settings_pack settingsPack;
     settingsPack.set_int(lt::settings_pack::download_rate_limit, profile.downloadLimit);
     settingsPack.set_int(lt::settings_pack::upload_rate_limit, profile.uploadLimit);
-    m_nativeSession->apply_settings(std::move(settingsPack));
+    applyNativeSettings(std::move(settingsPack));
 
     // Log the change
     const QString downloadStr = (profile.downloadLimit == -1) ? tr("unlimited") : tr("%1/s").arg(Utils::Number::friendlyUnit(profile.downloadLimit));
@@ -3827,6 +4914,84 @@ void SessionImpl::setMaxActiveCheckingTorrents(const int val)
 
     m_maxActiveCheckingTorrents = val;
     configureDeferred();
+    scheduleTorrentChecks();
+}
+
+bool SessionImpl::isDiskAwareCheckingEnabled() const
+{
+    return m_isDiskAwareCheckingEnabled;
+}
+
+void SessionImpl::setDiskAwareCheckingEnabled(const bool enabled)
+{
+    if (enabled == m_isDiskAwareCheckingEnabled)
+        return;
+
+    m_isDiskAwareCheckingEnabled = enabled;
+    configureDeferred();
+
+    // Torrents which are already allowed to be checked by the scheduler are
+    // returned to libtorrent's queue once their checking is finished
+    m_checkingTorrents.clear();
+    m_checkingVolumesCache.clear();
+    if (enabled)
+        loadCheckingTorrents();
+}
+
+int SessionImpl::maxActiveCheckingTorrentsPerVolume() const
+{
+    return m_maxActiveCheckingTorrentsPerVolume;
+}
+
+void SessionImpl::setMaxActiveCheckingTorrentsPerVolume(const int val)
+{
+    if (val == m_maxActiveCheckingTorrentsPerVolume)
+        return;
+
+    m_maxActiveCheckingTorrentsPerVolume = std::max(1, val);
+    scheduleTorrentChecks();
+}
+
+QHash<QString, int> SessionImpl::checkingVolumeLimits() const
+{
+    const QVariantHash storedLimits = m_checkingVolumeLimits;
+
+    QHash<QString, int> limits;
+    limits.reserve(storedLimits.size());
+    for (auto it = storedLimits.cbegin(); it != storedLimits.cend(); ++it)
+        limits.insert(it.key(), std::max(1, it.value().toInt()));
+    return limits;
+}
+
+void SessionImpl::setCheckingVolumeLimits(const QHash<QString, int> &limits)
+{
+    QVariantHash storedLimits;
+    storedLimits.reserve(limits.size());
+    for (auto it = limits.cbegin(); it != limits.cend(); ++it)
+    {
+        if (!it.key().isEmpty())
+            storedLimits.insert(it.key(), std::max(1, it.value()));
+    }
+
+    if (storedLimits == m_checkingVolumeLimits.get())
+        return;
+
+    m_checkingVolumeLimits = storedLimits;
+    scheduleTorrentChecks();
+}
+
+CheckingQueueOrder SessionImpl::checkingQueueOrder() const
+{
+    return m_checkingQueueOrder;
+}
+
+void SessionImpl::setCheckingQueueOrder(const CheckingQueueOrder order)
+{
+    if (order == m_checkingQueueOrder)
+        return;
+
+    m_checkingQueueOrder = order;
+    scheduleTorrentChecks();
 }
 
 bool SessionImpl::isI2PEnabled() const
@@ -4124,9 +5289,9 @@ void SessionImpl::setExcludedFileNamesEnabled(const bool enabled)
     m_isExcludedFileNamesEnabled = enabled;
 
     if (enabled)
-        populateExcludedFileNamesRegExpList();
+        populateExcludedFileNamesFilter();
     else
-        m_excludedFileNamesRegExpList.clear();
+        m_excludedFileNamesFilter = {};
 }
 
 QStringList SessionImpl::excludedFileNames() const
@@ -4139,23 +5304,13 @@ void SessionImpl::setExcludedFileNames(const QStringList &excludedFileNames)
     if (excludedFileNames != m_excludedFileNames)
     {
         m_excludedFileNames = excludedFileNames;
-        populateExcludedFileNamesRegExpList();
+        populateExcludedFileNamesFilter();
     }
 }
 
-void SessionImpl::populateExcludedFileNamesRegExpList()
+void SessionImpl::populateExcludedFileNamesFilter()
 {
-    const QStringList excludedNames = excludedFileNames();
-
-    m_excludedFileNamesRegExpList.clear();
-    m_excludedFileNamesRegExpList.reserve(excludedNames.size());
-
-    for (const QString &str : excludedNames)
-    {
-        const QString pattern = QRegularExpression::wildcardToRegularExpression(str);
-        const QRegularExpression re {pattern, QRegularExpression::CaseInsensitiveOption};
-        m_excludedFileNamesRegExpList.append(re);
-    }
+    m_excludedFileNamesFilter = FileNameFilter(excludedFileNames());
 }
 
 void SessionImpl::applyFilenameFilter(const PathList &files, QList<DownloadPriority> &priorities)
@@ -4163,28 +5318,14 @@ void SessionImpl::applyFilenameFilter(const PathList &files, QList<DownloadPrior
     if (!isExcludedFileNamesEnabled())
         return;
 
-    const auto isFilenameExcluded = [patterns = m_excludedFileNamesRegExpList](const Path &fileName)
-    {
-        return std::ranges::any_of(patterns, [&fileName](const QRegularExpression &re)
-        {
-            Path path = fileName;
-            while (!re.match(path.filename()).hasMatch())
-            {
-                path = path.parentPath();
-                if (path.isEmpty())
-                    return false;
-            }
-            return true;
-        });
-    };
-
     priorities.resize(files.count(), DownloadPriority::Normal);
+    if (m_excludedFileNamesFilter.isEmpty())
+        return;
+
+    const QList<bool> excludedFiles = m_excludedFileNamesFilter.match(files);
     for (qsizetype i = 0; i < priorities.size(); ++i)
     {
-        if (priorities[i] == BitTorrent::DownloadPriority::Ignored)
-            continue;
-
-        if (isFilenameExcluded(files.at(i)))
+        if (excludedFiles[i])
             priorities[i] = BitTorrent::DownloadPriority::Ignored;
     }
 }
@@ -4217,12 +5358,31 @@ void SessionImpl::setBannedIPs(const QStringList &newList)
     // Again ensure that the new list is different from the stored one.
     if (filteredList == m_bannedIPs)
         return; // do nothing
+    // New IPs can be added to the installed filter,
+    // otherwise it has to be rebuilt from the filter loaded from the IP filter file
+    const QStringList oldBannedIPs = m_bannedIPs;
+    if (std::ranges::includes(filteredList, oldBannedIPs))
+    {
+        for (const QString &ip : asConst(filteredList))
+        {
+            if (std::ranges::binary_search(oldBannedIPs, ip))
+                continue;
+
+            lt::error_code ec;
+            const lt::address addr = lt::make_address(ip.toLatin1().constData(), ec);
+            if (!ec)
+                m_pendingBannedIPs.append(addr);
+        }
+    }
+    else
+    {
+        m_isIPFilterRebuildNeeded = true;
+    }
+
     // store to session settings
-    // also here we have to recreate filter list including 3rd party ban file
-    // and install it again into m_session
     m_bannedIPs = filteredList;
-    m_IPFilteringConfigured = false;
-    configureDeferred();
+    if (!m_bannedIPsTimer->isActive())
+        m_bannedIPsTimer->start();
 }
 
 ResumeDataStorageType SessionImpl::resumeDataStorageType() const
@@ -4235,6 +5395,46 @@ void SessionImpl::setResumeDataStorageType(const ResumeDataStorageType type)
     m_resumeDataStorageType = type;
 }
 
+int SessionImpl::resumeDataStorageBatchSize() const
+{
+    return m_resumeDataStorageBatchSize;
+}
+
+void SessionImpl::setResumeDataStorageBatchSize(const int size)
+{
+    if (size == m_resumeDataStorageBatchSize)
+        return;
+
+    m_resumeDataStorageBatchSize = size;
+    if (auto *dbStorage = qobject_cast<DBResumeDataStorage *>(m_resumeDataStorage))
+        dbStorage->setBatchSize(m_resumeDataStorageBatchSize);
+}
+
+bool SessionImpl::isResumeDataStorageCompressionEnabled() const
+{
+    return m_isResumeDataStorageCompressionEnabled;
+}
+
+void SessionImpl::setResumeDataStorageCompressionEnabled(const bool enabled)
+{
+    if (enabled == m_isResumeDataStorageCompressionEnabled)
+        return;
+
+    m_isResumeDataStorageCompressionEnabled = enabled;
+    if (auto *dbStorage = qobject_cast<DBResumeDataStorage *>(m_resumeDataStorage))
+        dbStorage->setCompressionEnabled(enabled);
+}
+
+bool SessionImpl::isStoppedTorrentsColdModeEnabled() const
+{
+    return m_isStoppedTorrentsColdModeEnabled;
+}
+
+void SessionImpl::setStoppedTorrentsColdModeEnabled(const bool enabled)
+{
+    m_isStoppedTorrentsColdModeEnabled = enabled;
+}
+
 bool SessionImpl::isMergeTrackersEnabled() const
 {
     return m_isMergeTrackersEnabled;
@@ -4265,6 +5465,24 @@ void SessionImpl::setTorrentContentRemoveOption(const TorrentContentRemoveOption
     m_torrentContentRemoveOption = option;
 }
 
+int SessionImpl::torrentContentRemovingRate() const
+{
+    return m_torrentContentRemovingRate;
+}
+
+void SessionImpl::setTorrentContentRemovingRate(int filesPerSecond)
+{
+    filesPerSecond = std::max(0, filesPerSecond);
+    if (filesPerSecond == m_torrentContentRemovingRate)
+        return;
+
+    m_torrentContentRemovingRate = filesPerSecond;
+    QMetaObject::invokeMethod(m_torrentContentRemover, [remover = m_torrentContentRemover, filesPerSecond]
+    {
+        remover->setRemovingRate(filesPerSecond);
+    });
+}
+
 QStringList SessionImpl::bannedIPs() const
 {
     return m_bannedIPs;
@@ -4275,6 +5493,11 @@ bool SessionImpl::isRestored() const
     return m_isRestored;
 }
 
+QList<TorrentSnapshot> SessionImpl::startupSnapshots() const
+{
+    return m_startupSnapshots;
+}
+
 bool SessionImpl::isPaused() const
 {
     return m_isPaused;
@@ -4287,20 +5510,23 @@ void SessionImpl::pause()
 
     if (isRestored())
     {
-        m_nativeSession->pause();
+        for (lt::session *nativeSession : asConst(m_nativeSessions))
+            nativeSession->pause();
 
+        QHash<Torrent *, QHash<QString, TrackerEntryStatus>> updatedTrackers;
+        updatedTrackers.reserve(m_torrents.size());
         for (TorrentImpl *torrent : asConst(m_torrents))
         {
             torrent->resetTrackerEntryStatuses();
 
             const QList<TrackerEntryStatus> trackers = torrent->trackers();
-            QHash<QString, TrackerEntryStatus> updatedTrackers;
-            updatedTrackers.reserve(trackers.size());
+            QHash<QString, TrackerEntryStatus> &torrentTrackers = updatedTrackers[torrent];
+            torrentTrackers.reserve(trackers.size());
 
             for (const TrackerEntryStatus &status : trackers)
-                updatedTrackers.emplace(status.url, status);
-            emit trackerEntryStatusesUpdated(torrent, updatedTrackers);
+                torrentTrackers.emplace(status.url, status);
         }
+        enqueueTrackerEntryStatusesUpdate(updatedTrackers);
     }
 
     m_isPaused = true;
@@ -4312,7 +5538,10 @@ void SessionImpl::resume()
     if (m_isPaused)
     {
         if (isRestored())
-            m_nativeSession->resume();
+        {
+            for (lt::session *nativeSession : asConst(m_nativeSessions))
+                nativeSession->resume();
+        }
 
         m_isPaused = false;
         emit resumed();
@@ -4331,14 +5560,8 @@ void SessionImpl::setMaxConnectionsPerTorrent(int max)
     {
         m_maxConnectionsPerTorrent = max;
 
-        for (const TorrentImpl *torrent : asConst(m_torrents))
-        {
-            try
-            {
-                torrent->nativeHandle().set_max_connections(max);
-            }
-            catch (const std::exception &) {}
-        }
+        for (TorrentImpl *torrent : asConst(m_torrents))
+            torrent->applyConnectionsLimit();
     }
 }
 
@@ -4353,18 +5576,98 @@ void SessionImpl::setMaxUploadsPerTorrent(int max)
     if (max != maxUploadsPerTorrent())
     {
         m_maxUploadsPerTorrent = max;
+        m_unchokeSlotsController.setBaseLimits(maxUploads(), max);
 
+        const int torrentSlots = m_unchokeSlotsController.torrentSlots();
         for (const TorrentImpl *torrent : asConst(m_torrents))
         {
             try
             {
-                torrent->nativeHandle().set_max_uploads(max);
+                torrent->nativeHandle().set_max_uploads(torrentSlots);
             }
             catch (const std::exception &) {}
         }
     }
 }
 
+bool SessionImpl::isUnchokeSlotsTuningEnabled() const
+{
+    return m_isUnchokeSlotsTuningEnabled;
+}
+
+void SessionImpl::setUnchokeSlotsTuningEnabled(const bool enabled)
+{
+    if (enabled == m_isUnchokeSlotsTuningEnabled)
+        return;
+
+    m_isUnchokeSlotsTuningEnabled = enabled;
+    m_unchokeSlotsController.reset();
+    if (!enabled)
+        applyUnchokeSlotsLimits();
+}
+
+bool SessionImpl::isDormantSeedsEnabled() const
+{
+    return m_isDormantSeedsEnabled;
+}
+
+void SessionImpl::setDormantSeedsEnabled(const bool enabled)
+{
+    if (enabled == m_isDormantSeedsEnabled)
+        return;
+
+    m_isDormantSeedsEnabled = enabled;
+    if (enabled)
+    {
+        m_dormantSeedsTimer->start();
+        return;
+    }
+
+    m_dormantSeedsTimer->stop();
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+        torrent->setDormant(false);
+    m_dormantSeedScheduler.clear();
+}
+
+int SessionImpl::dormantSeedIdleTime() const
+{
+    return m_dormantSeedIdleTime;
+}
+
+void SessionImpl::setDormantSeedIdleTime(const int minutes)
+{
+    m_dormantSeedIdleTime = minutes;
+    m_dormantSeedScheduler.setIdleTime(dormantSeedIdleTime() * 60);
+}
+
+int SessionImpl::dormantSeedScrapeInterval() const
+{
+    return m_dormantSeedScrapeInterval;
+}
+
+void SessionImpl::setDormantSeedScrapeInterval(const int minutes)
+{
+    m_dormantSeedScrapeInterval = minutes;
+    m_dormantSeedScheduler.setScrapeInterval(dormantSeedScrapeInterval() * 60);
+}
+
+void SessionImpl::applyUnchokeSlotsLimits()
+{
+    lt::settings_pack settingsPack;
+    settingsPack.set_int(lt::settings_pack::unchoke_slots_limit, m_unchokeSlotsController.globalSlots());
+    applyNativeSettings(std::move(settingsPack));
+
+    const int torrentSlots = m_unchokeSlotsController.torrentSlots();
+    for (const TorrentImpl *torrent : asConst(m_torrents))
+    {
+        try
+        {
+            torrent->nativeHandle().set_max_uploads(torrentSlots);
+        }
+        catch (const std::exception &) {}
+    }
+}
+
 bool SessionImpl::announceToAllTrackers() const
 {
     return m_announceToAllTrackers;
@@ -4448,6 +5751,17 @@ void SessionImpl::setDiskIOType(const DiskIOType type)
     }
 }
 
+int SessionImpl::nativeSessionShards() const
+{
+    return m_nativeSessionShards;
+}
+
+void SessionImpl::setNativeSessionShards(const int shards)
+{
+    // It takes effect once the session is restarted
+    m_nativeSessionShards = std::clamp(shards, 1, 8);
+}
+
 int SessionImpl::requestQueueSize() const
 {
     return m_requestQueueSize;
@@ -4462,6 +5776,30 @@ void SessionImpl::setRequestQueueSize(const int val)
     configureDeferred();
 }
 
+PerformanceProfile SessionImpl::performanceProfile() const
+{
+    return m_performanceProfile;
+}
+
+void SessionImpl::setPerformanceProfile(const PerformanceProfile profile)
+{
+    if (profile == m_performanceProfile)
+        return;
+
+    m_performanceProfile = profile;
+    if (profile == PerformanceProfile::Auto)
+    {
+        m_autoTunedPerformanceSettings = autoTunedPerformanceSettings(detectHostResources(savePath(), networkInterface()), m_observedPeakRate);
+        m_performanceTuningTimer->start();
+    }
+    else
+    {
+        m_performanceTuningTimer->stop();
+        m_observedPeakRate = 0;
+    }
+    configureDeferred();
+}
+
 int SessionImpl::asyncIOThreads() const
 {
     return std::clamp(m_asyncIOThreads.get(), 1, 1024);
@@ -4546,19 +5884,97 @@ void SessionImpl::setDiskCacheSize(int size)
     }
 }
 
-int SessionImpl::diskCacheTTL() const
+int SessionImpl::diskReadCacheSize() const
 {
-    return m_diskCacheTTL;
+#ifdef QBT_APP_64BIT
+    return std::min(m_diskReadCacheSize.get(), 33554431);  // 32768GiB
+#else
+    // allocate 1536MiB and leave 512MiB to the rest of program data in RAM
+    return std::min(m_diskReadCacheSize.get(), 1536);
+#endif
 }
 
-void SessionImpl::setDiskCacheTTL(const int ttl)
+void SessionImpl::setDiskReadCacheSize(int size)
 {
-    if (ttl != m_diskCacheTTL)
-    {
-        m_diskCacheTTL = ttl;
-        configureDeferred();
-    }
-}
+#ifdef QBT_APP_64BIT
+    size = std::clamp(size, 0, 33554431);  // 32768GiB
+#else
+    size = std::clamp(size, 0, 1536);
+#endif
+    if (size == m_diskReadCacheSize)
+        return;
+
+    m_diskReadCacheSize = size;
+#ifdef QBT_USES_LIBTORRENT2
+    m_diskReadCache->setCapacity(size * 1024LL * 1024);
+#endif
+}
+
+Path SessionImpl::persistentReadCachePath() const
+{
+    return m_persistentReadCachePath;
+}
+
+void SessionImpl::setPersistentReadCachePath(const Path &path)
+{
+    // takes effect after restart
+    m_persistentReadCachePath = path;
+}
+
+int SessionImpl::persistentReadCacheSize() const
+{
+    return std::min(m_persistentReadCacheSize.get(), 33554431);  // 32768GiB
+}
+
+void SessionImpl::setPersistentReadCacheSize(int size)
+{
+    size = std::clamp(size, 0, 33554431);  // 32768GiB
+    if (size == m_persistentReadCacheSize)
+        return;
+
+    m_persistentReadCacheSize = size;
+#ifdef QBT_USES_LIBTORRENT2
+    // enabling the cache takes effect after restart
+    if (m_persistentReadCache)
+        m_persistentReadCache->setCapacity(size * 1024LL * 1024);
+#endif
+}
+
+int SessionImpl::diskWriteCoalescingSize() const
+{
+    return m_diskWriteCoalescingSize;
+}
+
+void SessionImpl::setDiskWriteCoalescingSize(const int size)
+{
+    // takes effect after restart
+    m_diskWriteCoalescingSize = std::clamp(size, 0, 1024);
+}
+
+int SessionImpl::diskWriteCoalescingTime() const
+{
+    return m_diskWriteCoalescingTime;
+}
+
+void SessionImpl::setDiskWriteCoalescingTime(const int time)
+{
+    // takes effect after restart
+    m_diskWriteCoalescingTime = std::clamp(time, 10, 10000);
+}
+
+int SessionImpl::diskCacheTTL() const
+{
+    return m_diskCacheTTL;
+}
+
+void SessionImpl::setDiskCacheTTL(const int ttl)
+{
+    if (ttl != m_diskCacheTTL)
+    {
+        m_diskCacheTTL = ttl;
+        configureDeferred();
+    }
+}
 
 qint64 SessionImpl::diskQueueSize() const
 {
@@ -5012,13 +6428,28 @@ void SessionImpl::setReannounceWhenAddressChangedEnabled(const bool enabled)
     m_isReannounceWhenAddressChangedEnabled = enabled;
 }
 
-void SessionImpl::reannounceToAllTrackers() const
+void SessionImpl::reannounceToAllTrackers()
 {
     for (const TorrentImpl *torrent : asConst(m_torrents))
+        reannounce(torrent, -1, lt::torrent_handle::ignore_min_interval);
+}
+
+void SessionImpl::reannounce(const TorrentImpl *torrent, const int index, const lt::reannounce_flags_t flags)
+{
+    const qint64 now = std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    const QList<TrackerEntryStatus> trackers = torrent->trackers();
+    for (int i = 0; i < trackers.size(); ++i)
     {
+        if ((index >= 0) && (i != index))
+            continue;
+
+        const std::optional<int> delay = m_announceScheduler.schedule(torrent->id(), trackers[i].url, now);
+        if (!delay)
+            continue;
+
         try
         {
-            torrent->nativeHandle().force_reannounce(0, -1, lt::torrent_handle::ignore_min_interval);
+            torrent->nativeHandle().force_reannounce(*delay, i, flags);
         }
         catch (const std::exception &) {}
     }
@@ -5064,6 +6495,7 @@ void SessionImpl::setMaxUploads(int max)
     if (max != m_maxUploads)
     {
         m_maxUploads = max;
+        m_unchokeSlotsController.setBaseLimits(max, maxUploadsPerTorrent());
         configureDeferred();
     }
 }
@@ -5219,9 +6651,200 @@ qint64 SessionImpl::freeDiskSpace() const
     return m_freeDiskSpace;
 }
 
+QList<StorageVolumeInfo> SessionImpl::storageVolumes() const
+{
+    return m_storageVolumes;
+}
+
+int SessionImpl::lowDiskSpaceThreshold() const
+{
+    return m_lowDiskSpaceThreshold;
+}
+
+void SessionImpl::setLowDiskSpaceThreshold(const int size)
+{
+    m_lowDiskSpaceThreshold = std::max(0, size);
+}
+
+void SessionImpl::checkFreeDiskSpace()
+{
+    QMetaObject::invokeMethod(m_freeDiskSpaceChecker, [checker = m_freeDiskSpaceChecker, paths = storageVolumePaths()]
+    {
+        checker->setVolumePathsToCheck(paths);
+        checker->check();
+    });
+}
+
+PathList SessionImpl::storageVolumePaths() const
+{
+    QSet<Path> paths {savePath()};
+    if (isDownloadPathEnabled())
+        paths.insert(downloadPath());
+
+    for (auto it = m_categories.cbegin(); it != m_categories.cend(); ++it)
+    {
+        paths.insert(categorySavePath(it.key(), it.value()));
+        if (const Path categoryDownloadPath = this->categoryDownloadPath(it.key(), it.value()); !categoryDownloadPath.isEmpty())
+            paths.insert(categoryDownloadPath);
+    }
+
+    for (const TorrentImpl *torrent : asConst(m_torrents))
+    {
+        paths.insert(torrent->savePath());
+        if (const Path torrentDownloadPath = torrent->downloadPath(); !torrentDownloadPath.isEmpty())
+            paths.insert(torrentDownloadPath);
+        paths.insert(torrent->actualStorageLocation());
+    }
+
+    paths.remove({});
+    return paths.values();
+}
+
+void SessionImpl::handleStorageVolumesChecked(const QHash<Path, QString> &pathVolumes, const QHash<QString, qint64> &volumeFreeSpace)
+{
+    const qint64 threshold = lowDiskSpaceThreshold() * 1024LL * 1024;
+
+    QHash<QString, StorageVolumeInfo> volumes;
+    volumes.reserve(volumeFreeSpace.size());
+    for (auto it = volumeFreeSpace.cbegin(); it != volumeFreeSpace.cend(); ++it)
+    {
+        const qint64 freeSpace = it.value();
+        volumes.insert(it.key(), {.device = it.key(), .freeSpace = freeSpace
+                , .isLowOnSpace = ((threshold > 0) && (freeSpace >= 0) && (freeSpace < threshold))});
+    }
+
+    for (TorrentImpl *const torrent : asConst(m_torrents))
+    {
+        // the torrent is counted on each volume it uses but only the current location affects it
+        QSet<QString> torrentVolumes {pathVolumes.value(torrent->savePath()), pathVolumes.value(torrent->downloadPath())};
+        const QString currentVolume = pathVolumes.value(torrent->actualStorageLocation());
+        torrentVolumes.insert(currentVolume);
+        for (const QString &volume : asConst(torrentVolumes))
+        {
+            if (const auto volumeIter = volumes.find(volume); volumeIter != volumes.end())
+                ++volumeIter->torrentCount;
+        }
+
+        const auto currentVolumeIter = volumes.constFind(currentVolume);
+        if (currentVolumeIter == volumes.cend())
+            continue;
+
+        if (currentVolumeIter->isLowOnSpace)
+        {
+            if (!torrent->isFinished() && !torrent->isStopped())
+            {
+                torrent->stop();
+                m_lowDiskSpaceStoppedTorrents.insert(torrent->id());
+                LogMsg(tr("Stopped torrent due to low free disk space. Torrent: \"%1\". Storage device: \"%2\". Free space: %3")
+                    .arg(torrent->name(), currentVolume, Utils::Number::friendlyUnit(currentVolumeIter->freeSpace)), Log::WARNING);
+            }
+        }
+        else if (m_lowDiskSpaceStoppedTorrents.remove(torrent->id()) && torrent->isStopped())
+        {
+            torrent->start();
+        }
+    }
+
+    m_storageVolumes = volumes.values();
+    std::ranges::sort(m_storageVolumes, {}, &StorageVolumeInfo::device);
+    emit storageVolumesChecked(m_storageVolumes);
+}
+
+void SessionImpl::beginBulkUpdate()
+{
+    ++m_bulkUpdateLevel;
+}
+
+void SessionImpl::endBulkUpdate()
+{
+    Q_ASSERT(m_bulkUpdateLevel > 0);
+
+    if (--m_bulkUpdateLevel == 0)
+        notifyBulkUpdateChanges();
+}
+
+void SessionImpl::notifyBulkUpdateChanges()
+{
+    QSet<TorrentImpl *> torrents = m_bulkUpdateChanges.savePaths + m_bulkUpdateChanges.savingModes
+            + m_bulkUpdateChanges.replacedTrackers;
+    for (auto it = m_bulkUpdateChanges.categories.cbegin(); it != m_bulkUpdateChanges.categories.cend(); ++it)
+        torrents.insert(it.key());
+    for (auto it = m_bulkUpdateChanges.tags.cbegin(); it != m_bulkUpdateChanges.tags.cend(); ++it)
+        torrents.insert(it.key());
+    for (auto it = m_bulkUpdateChanges.trackers.cbegin(); it != m_bulkUpdateChanges.trackers.cend(); ++it)
+        torrents.insert(it.key());
+
+    for (TorrentImpl *torrent : asConst(torrents))
+        notifyBulkUpdateChanges(torrent);
+}
+
+void SessionImpl::notifyBulkUpdateChanges(TorrentImpl *torrent)
+{
+    // only the resulting changes are notified, e.g. tag which is added and removed again is skipped
+    if (const auto categoryIter = m_bulkUpdateChanges.categories.constFind(torrent);
+        categoryIter != m_bulkUpdateChanges.categories.cend())
+    {
+        const QString oldCategory = categoryIter.value();
+        m_bulkUpdateChanges.categories.erase(categoryIter);
+        if (torrent->category() != oldCategory)
+            emit torrentCategoryChanged(torrent, oldCategory);
+    }
+
+    const QHash<Tag, bool> tags = m_bulkUpdateChanges.tags.take(torrent);
+    for (auto it = tags.cbegin(); it != tags.cend(); ++it)
+    {
+        const Tag &tag = it.key();
+        const bool hasTag = torrent->hasTag(tag);
+        if (hasTag == it.value())
+            continue;
+
+        if (hasTag)
+            emit torrentTagAdded(torrent, tag);
+        else
+            emit torrentTagRemoved(torrent, tag);
+    }
+
+    if (m_bulkUpdateChanges.savePaths.remove(torrent))
+        emit torrentSavePathChanged(torrent);
+    if (m_bulkUpdateChanges.savingModes.remove(torrent))
+        emit torrentSavingModeChanged(torrent);
+
+    const QHash<QString, bool> trackers = m_bulkUpdateChanges.trackers.take(torrent);
+    if (m_bulkUpdateChanges.replacedTrackers.remove(torrent))
+    {
+        emit trackersChanged(torrent);
+    }
+    else if (!trackers.isEmpty())
+    {
+        QHash<QString, int> currentTrackers;  // URL -> tier
+        for (const TrackerEntryStatus &status : asConst(torrent->trackers()))
+            currentTrackers.insert(status.url, status.tier);
+
+        QList<TrackerEntry> addedTrackers;
+        QStringList removedTrackers;
+        for (auto it = trackers.cbegin(); it != trackers.cend(); ++it)
+        {
+            const auto currentTrackerIter = currentTrackers.constFind(it.key());
+            const bool hasTracker = (currentTrackerIter != currentTrackers.cend());
+            if (hasTracker == it.value())
+                continue;
+
+            if (hasTracker)
+                addedTrackers.append({.url = it.key(), .tier = currentTrackerIter.value()});
+            else
+                removedTrackers.append(it.key());
+        }
+
+        if (!removedTrackers.isEmpty())
+            emit trackersRemoved(torrent, removedTrackers);
+        if (!addedTrackers.isEmpty())
+            emit trackersAdded(torrent, addedTrackers);
+    }
+}
+
 bool SessionImpl::isListening() const
 {
-    return m_nativeSessionExtension->isSessionListening();
+    return m_nativeSessionExtensions.first()->isSessionListening();
 }
 
 ShareLimitAction SessionImpl::shareLimitAction() const
@@ -5233,7 +6856,11 @@ void SessionImpl::setShareLimitAction(const ShareLimitAction act)
 {
     Q_ASSERT(act != ShareLimitAction::Default);
 
+    if (act == m_shareLimitAction)
+        return;
+
     m_shareLimitAction = act;
+    scheduleAllTorrentsShareLimitsCheck();
 }
 
 bool SessionImpl::isKnownTorrent(const InfoHash &infoHash) const
@@ -5246,6 +6873,8 @@ bool SessionImpl::isKnownTorrent(const InfoHash &infoHash) const
 
     if (m_downloadedMetadata.contains(id) || (isHybrid && m_downloadedMetadata.contains(altID)))
         return true;
+    if (m_queuedMetadataDownloads.contains(id) || (isHybrid && m_queuedMetadataDownloads.contains(altID)))
+        return true;
     return findTorrent(infoHash);
 }
 
@@ -5264,9 +6893,10 @@ void SessionImpl::updateSeedingLimitTimer()
     }
 }
 
-void SessionImpl::handleTorrentShareLimitChanged(TorrentImpl *const)
+void SessionImpl::handleTorrentShareLimitChanged(TorrentImpl *const torrent)
 {
     updateSeedingLimitTimer();
+    scheduleTorrentShareLimitsCheck(torrent, 0);
 }
 
 void SessionImpl::handleTorrentNameChanged(TorrentImpl *const)
@@ -5275,45 +6905,118 @@ void SessionImpl::handleTorrentNameChanged(TorrentImpl *const)
 
 void SessionImpl::handleTorrentSavePathChanged(TorrentImpl *const torrent)
 {
+    if (m_bulkUpdateLevel > 0)
+    {
+        m_bulkUpdateChanges.savePaths.insert(torrent);
+        return;
+    }
+
     emit torrentSavePathChanged(torrent);
 }
 
 void SessionImpl::handleTorrentCategoryChanged(TorrentImpl *const torrent, const QString &oldCategory)
 {
+    if (m_bulkUpdateLevel > 0)
+    {
+        if (!m_bulkUpdateChanges.categories.contains(torrent))
+            m_bulkUpdateChanges.categories.insert(torrent, oldCategory);
+        return;
+    }
+
     emit torrentCategoryChanged(torrent, oldCategory);
 }
 
 void SessionImpl::handleTorrentTagAdded(TorrentImpl *const torrent, const Tag &tag)
 {
+    if (m_bulkUpdateLevel > 0)
+    {
+        if (QHash<Tag, bool> &tags = m_bulkUpdateChanges.tags[torrent]; !tags.contains(tag))
+            tags.insert(tag, false);
+        return;
+    }
+
     emit torrentTagAdded(torrent, tag);
 }
 
 void SessionImpl::handleTorrentTagRemoved(TorrentImpl *const torrent, const Tag &tag)
 {
+    if (m_bulkUpdateLevel > 0)
+    {
+        if (QHash<Tag, bool> &tags = m_bulkUpdateChanges.tags[torrent]; !tags.contains(tag))
+            tags.insert(tag, true);
+        return;
+    }
+
     emit torrentTagRemoved(torrent, tag);
 }
 
 void SessionImpl::handleTorrentSavingModeChanged(TorrentImpl *const torrent)
 {
+    if (m_bulkUpdateLevel > 0)
+    {
+        m_bulkUpdateChanges.savingModes.insert(torrent);
+        return;
+    }
+
     emit torrentSavingModeChanged(torrent);
 }
 
 void SessionImpl::handleTorrentTrackersAdded(TorrentImpl *const torrent, const QList<TrackerEntry> &newTrackers)
 {
     for (const TrackerEntry &newTracker : newTrackers)
-        LogMsg(tr("Added tracker to torrent. Torrent: \"%1\". Tracker: \"%2\"").arg(torrent->name(), newTracker.url));
+    {
+        LogMsg(Log::Category::Trackers, Log::NORMAL, [torrent, &newTracker]
+        {
+            return tr("Added tracker to torrent. Torrent: \"%1\". Tracker: \"%2\"").arg(torrent->name(), newTracker.url);
+        });
+    }
+
+    if (m_bulkUpdateLevel > 0)
+    {
+        QHash<QString, bool> &trackers = m_bulkUpdateChanges.trackers[torrent];
+        for (const TrackerEntry &newTracker : newTrackers)
+        {
+            if (!trackers.contains(newTracker.url))
+                trackers.insert(newTracker.url, false);
+        }
+        return;
+    }
+
     emit trackersAdded(torrent, newTrackers);
 }
 
 void SessionImpl::handleTorrentTrackersRemoved(TorrentImpl *const torrent, const QStringList &deletedTrackers)
 {
     for (const QString &deletedTracker : deletedTrackers)
-        LogMsg(tr("Removed tracker from torrent. Torrent: \"%1\". Tracker: \"%2\"").arg(torrent->name(), deletedTracker));
+    {
+        LogMsg(Log::Category::Trackers, Log::NORMAL, [torrent, &deletedTracker]
+        {
+            return tr("Removed tracker from torrent. Torrent: \"%1\". Tracker: \"%2\"").arg(torrent->name(), deletedTracker);
+        });
+    }
+
+    if (m_bulkUpdateLevel > 0)
+    {
+        QHash<QString, bool> &trackers = m_bulkUpdateChanges.trackers[torrent];
+        for (const QString &deletedTracker : deletedTrackers)
+        {
+            if (!trackers.contains(deletedTracker))
+                trackers.insert(deletedTracker, true);
+        }
+        return;
+    }
+
     emit trackersRemoved(torrent, deletedTrackers);
 }
 
 void SessionImpl::handleTorrentTrackersChanged(TorrentImpl *const torrent)
 {
+    if (m_bulkUpdateLevel > 0)
+    {
+        m_bulkUpdateChanges.replacedTrackers.insert(torrent);
+        return;
+    }
+
     emit trackersChanged(torrent);
 }
 
@@ -5331,6 +7034,8 @@ void SessionImpl::handleTorrentUrlSeedsRemoved(TorrentImpl *const torrent, const
 
 void SessionImpl::handleTorrentMetadataReceived(TorrentImpl *const torrent)
 {
+    preallocateFiles(torrent);
+
     if (!torrentExportDirectory().isEmpty())
         exportTorrentFile(torrent, torrentExportDirectory());
 
@@ -5339,6 +7044,7 @@ void SessionImpl::handleTorrentMetadataReceived(TorrentImpl *const torrent)
 
 void SessionImpl::handleTorrentStopped(TorrentImpl *const torrent)
 {
+    m_torrentStatusTable.update(torrent);
     torrent->resetTrackerEntryStatuses();
 
     const QList<TrackerEntryStatus> trackers = torrent->trackers();
@@ -5347,7 +7053,7 @@ void SessionImpl::handleTorrentStopped(TorrentImpl *const torrent)
 
     for (const TrackerEntryStatus &status : trackers)
         updatedTrackers.emplace(status.url, status);
-    emit trackerEntryStatusesUpdated(torrent, updatedTrackers);
+    enqueueTrackerEntryStatusesUpdate({{torrent, updatedTrackers}});
 
     LogMsg(tr("Torrent stopped. Torrent: \"%1\"").arg(torrent->name()));
     emit torrentStopped(torrent);
@@ -5355,6 +7061,12 @@ void SessionImpl::handleTorrentStopped(TorrentImpl *const torrent)
 
 void SessionImpl::handleTorrentStarted(TorrentImpl *const torrent)
 {
+    m_torrentStatusTable.update(torrent);
+    m_lowDiskSpaceStoppedTorrents.remove(torrent->id());
+
+    // Share limit action could have been already applied to stopped torrent
+    scheduleTorrentShareLimitsCheck(torrent, 0);
+
     LogMsg(tr("Torrent resumed. Torrent: \"%1\"").arg(torrent->name()));
     emit torrentStarted(torrent);
 }
@@ -5380,6 +7092,17 @@ void SessionImpl::handleTorrentResumeDataReady(TorrentImpl *const torrent, LoadT
     }
 }
 
+void SessionImpl::handleTorrentCountersReady(const TorrentImpl *torrent, const TorrentCounters &counters)
+{
+    if (m_resumeDataStorage->canStoreCounters())
+        m_resumeDataStorage->storeCounters(torrent->id(), counters);
+}
+
+void SessionImpl::handleTorrentPeerStatisticsUpdated(const PeerStatistics &statistics)
+{
+    m_peerStatistics += statistics;
+}
+
 void SessionImpl::handleTorrentInfoHashChanged(TorrentImpl *torrent, const InfoHash &prevInfoHash)
 {
     Q_ASSERT(torrent->infoHash().isHybrid());
@@ -5392,44 +7115,56 @@ void SessionImpl::handleTorrentInfoHashChanged(TorrentImpl *torrent, const InfoH
     {
         m_torrents[torrent->id()] = m_torrents.take(prevID);
         m_changedTorrentIDs[torrent->id()] = prevID;
+        // the torrent is scheduled again with the new ID at the next check
+        m_dormantSeedScheduler.remove(prevID);
     }
 }
 
 void SessionImpl::handleTorrentStorageMovingStateChanged(TorrentImpl *torrent)
 {
+    m_torrentStatusTable.update(torrent);
     emit torrentsUpdated({torrent});
+    torrent->clearChangedFields();
 }
 
 bool SessionImpl::addMoveTorrentStorageJob(TorrentImpl *torrent, const Path &newPath, const MoveStorageMode mode, const MoveStorageContext context)
 {
     Q_ASSERT(torrent);
 
+    // the files would be created in the old location
+    cancelFilePreallocation(torrent->id());
+
     const lt::torrent_handle torrentHandle = torrent->nativeHandle();
     const Path currentLocation = torrent->actualStorageLocation();
-    const bool torrentHasActiveJob = !m_moveStorageQueue.isEmpty() && (m_moveStorageQueue.constFirst().torrentHandle == torrentHandle);
+    const auto activeJobIter = std::ranges::find_if(asConst(m_moveStorageQueue)
+            , [&torrentHandle](const MoveStorageJob &job)
+    {
+        return job.isActive && (job.torrentHandle == torrentHandle);
+    });
+    const bool torrentHasActiveJob = (activeJobIter != m_moveStorageQueue.cend());
+    const Path activeJobPath = (torrentHasActiveJob ? activeJobIter->path : Path());
 
-    if (m_moveStorageQueue.size() > 1)
+    const auto iter = std::ranges::find_if(asConst(m_moveStorageQueue)
+            , [&torrentHandle](const MoveStorageJob &job)
     {
-        const auto iter = std::ranges::find_if(std::views::drop(asConst(m_moveStorageQueue), 1)
-                , [&torrentHandle](const MoveStorageJob &job)
-        {
-            return job.torrentHandle == torrentHandle;
-        });
+        return !job.isActive && (job.torrentHandle == torrentHandle);
+    });
 
-        if (iter != m_moveStorageQueue.cend())
-        {
-            // remove existing inactive job
-            torrent->handleMoveStorageJobFinished(currentLocation, iter->context, torrentHasActiveJob);
-            LogMsg(tr("Torrent move canceled. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\"").arg(torrent->name(), currentLocation.toString(), iter->path.toString()));
-            m_moveStorageQueue.erase(iter);
-        }
+    if (iter != m_moveStorageQueue.cend())
+    {
+        // remove existing inactive job
+        torrent->handleMoveStorageJobFinished(currentLocation, iter->context, torrentHasActiveJob);
+        LogMsg(tr("Torrent move canceled. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\"").arg(torrent->name(), currentLocation.toString(), iter->path.toString()));
+        m_moveStorageQueue.erase(iter);
+        // the removed job might have been holding back jobs of other torrents
+        startMoveStorageJobs();
     }
 
     if (torrentHasActiveJob)
     {
         // if there is active job for this torrent prevent creating meaningless
         // job that will move torrent to the same location as current one
-        if (m_moveStorageQueue.constFirst().path == newPath)
+        if (activeJobPath == newPath)
         {
             LogMsg(tr("Failed to enqueue torrent move. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\". Reason: torrent is currently moving to the destination")
                    .arg(torrent->name(), currentLocation.toString(), newPath.toString()));
@@ -5446,19 +7181,74 @@ bool SessionImpl::addMoveTorrentStorageJob(TorrentImpl *torrent, const Path &new
         }
     }
 
-    const MoveStorageJob moveStorageJob {torrentHandle, newPath, mode, context};
+    MoveStorageJob moveStorageJob {torrentHandle, newPath, mode, context};
+    // if the torrent is still moving, this job picks the data up where the active one puts it
+    moveStorageJob.sourcePath = (torrentHasActiveJob ? activeJobPath : currentLocation);
+    moveStorageJob.sourceVolume = Utils::Fs::storageDevice(moveStorageJob.sourcePath);
+    moveStorageJob.destinationVolume = Utils::Fs::storageDevice(newPath);
+    moveStorageJob.size = torrent->totalSize();
     m_moveStorageQueue << moveStorageJob;
     LogMsg(tr("Enqueued torrent move. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\"").arg(torrent->name(), currentLocation.toString(), newPath.toString()));
 
-    if (m_moveStorageQueue.size() == 1)
-        moveTorrentStorage(moveStorageJob);
+    startMoveStorageJobs();
 
     return true;
 }
 
+TrackerRegistry &SessionImpl::trackerRegistry()
+{
+    return m_trackerRegistry;
+}
+
+Path SessionImpl::internTorrentPath(const Path &path)
+{
+    if (path.isEmpty())
+        return path;
+
+    // the lookup is case sensitive on every platform, so the torrent gets exactly the path it was given
+    if (const auto iter = m_torrentPaths.constFind(path.data()); iter != m_torrentPaths.cend())
+        return iter.value();
+
+    // the paths which are no longer used by the torrents are removed once the pool has grown enough
+    if (m_torrentPaths.size() >= m_torrentPathsPruneThreshold)
+    {
+        QHash<QString, Path> usedPaths;
+        for (const TorrentImpl *torrent : asConst(m_torrents))
+        {
+            for (const Path &torrentPath : {torrent->savePath(), torrent->downloadPath()})
+            {
+                if (const auto iter = m_torrentPaths.constFind(torrentPath.data()); iter != m_torrentPaths.cend())
+                    usedPaths.insert(iter.key(), iter.value());
+            }
+        }
+
+        m_torrentPaths = std::move(usedPaths);
+        m_torrentPathsPruneThreshold = std::max(MIN_TORRENT_PATHS_PRUNE_THRESHOLD, (m_torrentPaths.size() * 2));
+    }
+
+    m_torrentPaths.insert(path.data(), path);
+    return path;
+}
+
+QString SessionImpl::internCategory(const QString &category) const
+{
+    if (const auto iter = m_categories.constFind(category); iter != m_categories.cend())
+        return iter.key();
+
+    return category;
+}
+
+Tag SessionImpl::internTag(const Tag &tag) const
+{
+    if (const auto iter = m_tags.find(tag); iter != m_tags.cend())
+        return *iter;
+
+    return tag;
+}
+
 lt::torrent_handle SessionImpl::reloadTorrent(const lt::torrent_handle &currentHandle, lt::add_torrent_params params)
 {
-    m_nativeSession->remove_torrent(currentHandle, lt::session::delete_partfile);
+    nativeSessionOf(currentHandle)->remove_torrent(currentHandle, lt::session::delete_partfile);
 
     auto *const extensionData = new ExtensionData;
     params.userdata = LTClientData(extensionData);
@@ -5467,12 +7257,42 @@ lt::torrent_handle SessionImpl::reloadTorrent(const lt::torrent_handle &currentH
 #endif
 
     // libtorrent will post an add_torrent_alert anyway, so we have to add an empty handler to ignore it.
-    m_addTorrentAlertHandlers.emplaceBack();
-    return m_nativeSession->add_torrent(std::move(params));
+    const qsizetype shard = nativeSessionIndexFor(params);
+    m_addTorrentAlertHandlers[shard].emplaceBack();
+    return m_nativeSessions[shard]->add_torrent(std::move(params));
+}
+
+void SessionImpl::startMoveStorageJobs()
+{
+    // Moves between independent volumes run in parallel. A volume is written
+    // by one job at a time and isn't read while it is being written, so moves
+    // sharing a disk don't compete for it. Jobs waiting in the queue reserve
+    // their volumes too, so later jobs can't overtake them.
+    std::unordered_set<lt::torrent_handle> busyTorrents;
+    QSet<QString> writtenVolumes;
+    QSet<QString> readVolumes;
+
+    for (MoveStorageJob &job : m_moveStorageQueue)
+    {
+        const bool canStart = !job.isActive
+                && !busyTorrents.contains(job.torrentHandle)
+                && !writtenVolumes.contains(job.destinationVolume)
+                && !readVolumes.contains(job.destinationVolume)
+                && !writtenVolumes.contains(job.sourceVolume);
+        if (canStart)
+            moveTorrentStorage(job);
+
+        busyTorrents.insert(job.torrentHandle);
+        writtenVolumes.insert(job.destinationVolume);
+        readVolumes.insert(job.sourceVolume);
+    }
 }
 
-void SessionImpl::moveTorrentStorage(const MoveStorageJob &job) const
+void SessionImpl::moveTorrentStorage(MoveStorageJob &job) const
 {
+    job.isActive = true;
+    job.timer.start();
+
     const TorrentImpl *torrent = getTorrent(job.torrentHandle);
     const QString torrentName = (torrent ? torrent->name() : getInfoHash(job.torrentHandle).toTorrentID().toString());
     LogMsg(tr("Start moving torrent. Torrent: \"%1\". Destination: \"%2\"").arg(torrentName, job.path.toString()));
@@ -5480,11 +7300,26 @@ void SessionImpl::moveTorrentStorage(const MoveStorageJob &job) const
     job.torrentHandle.move_storage(job.path.toString().toStdString(), toNative(job.mode));
 }
 
-void SessionImpl::handleMoveTorrentStorageJobFinished(const Path &newPath)
+void SessionImpl::handleMoveTorrentStorageJobFinished(const lt::torrent_handle &torrentHandle, const Path &newPath, const bool isSucceeded)
 {
-    const MoveStorageJob finishedJob = m_moveStorageQueue.takeFirst();
-    if (!m_moveStorageQueue.isEmpty())
-        moveTorrentStorage(m_moveStorageQueue.constFirst());
+    const auto finishedJobIter = std::ranges::find_if(asConst(m_moveStorageQueue)
+            , [&torrentHandle](const MoveStorageJob &job)
+    {
+        return job.isActive && (job.torrentHandle == torrentHandle);
+    });
+    Q_ASSERT(finishedJobIter != m_moveStorageQueue.cend());
+    if (finishedJobIter == m_moveStorageQueue.cend()) [[unlikely]]
+        return;
+
+    const MoveStorageJob finishedJob = *finishedJobIter;
+    m_moveStorageQueue.erase(finishedJobIter);
+
+    m_finishedMoveStorageJobs.append(toMoveStorageJobInfo(finishedJob
+            , (isSucceeded ? MoveStorageJobState::Finished : MoveStorageJobState::Failed)));
+    if (m_finishedMoveStorageJobs.size() > MAX_FINISHED_MOVE_STORAGE_JOBS)
+        m_finishedMoveStorageJobs.removeFirst();
+
+    startMoveStorageJobs();
 
     const auto iter = std::ranges::find_if(asConst(m_moveStorageQueue)
             , [&finishedJob](const MoveStorageJob &job)
@@ -5506,19 +7341,152 @@ void SessionImpl::handleMoveTorrentStorageJobFinished(const Path &newPath)
         const TorrentID torrentID = getInfoHash(nativeHandle).toTorrentID();
         const RemovingTorrentData &removingTorrentData = m_removingTorrents[torrentID];
         if (removingTorrentData.removeOption == TorrentRemoveOption::KeepContent)
-            m_nativeSession->remove_torrent(nativeHandle, lt::session::delete_partfile);
+            nativeSessionOf(nativeHandle)->remove_torrent(nativeHandle, lt::session::delete_partfile);
     }
 }
 
-void SessionImpl::processPendingFinishedTorrents()
+bool SessionImpl::updateCheckingTorrent(TorrentImpl *torrent)
 {
-    if (m_pendingFinishedTorrents.isEmpty())
-        return;
+    const TorrentState state = torrent->state();
+    if ((state != TorrentState::CheckingDownloading) && (state != TorrentState::CheckingUploading))
+        return m_checkingTorrents.remove(torrent);
 
-    for (TorrentImpl *torrent : asConst(m_pendingFinishedTorrents))
+    auto iter = m_checkingTorrents.find(torrent);
+    if (iter == m_checkingTorrents.end())
     {
-        LogMsg(tr("Torrent download finished. Torrent: \"%1\"").arg(torrent->name()));
-        emit torrentFinished(torrent);
+        const Path savePath = torrent->actualStorageLocation();
+        auto volumeIter = m_checkingVolumesCache.find(savePath);
+        if (volumeIter == m_checkingVolumesCache.end())
+            volumeIter = m_checkingVolumesCache.insert(savePath, Utils::Fs::storageDevice(savePath));
+        iter = m_checkingTorrents.insert(torrent, {volumeIter.value()});
+    }
+
+    const bool isWaiting = torrent->isQueued();
+    if (isWaiting == iter->isWaiting)
+        return false;
+
+    iter->isWaiting = isWaiting;
+    // The torrent is queued again (e.g. it was stopped and started), so it has to wait for its turn
+    if (isWaiting)
+        iter->isScheduled = false;
+    return true;
+}
+
+void SessionImpl::updateCheckingStatus()
+{
+    qint64 checkingTorrentsCount = 0;
+    qint64 checkingRemaining = 0;
+    for (const TorrentImpl *torrent : asConst(m_torrents))
+    {
+        const TorrentState state = torrent->state();
+        if ((state != TorrentState::CheckingDownloading) && (state != TorrentState::CheckingUploading))
+            continue;
+
+        ++checkingTorrentsCount;
+        checkingRemaining += static_cast<qint64>(torrent->totalSize() * (1 - torrent->progress()));
+    }
+
+    m_status.checkingTorrentsCount = checkingTorrentsCount;
+    m_status.checkingRemaining = checkingRemaining;
+    m_status.checkingETA = ((checkingTorrentsCount > 0) && (m_status.checkingRate > 0))
+        ? std::min<qint64>((checkingRemaining / m_status.checkingRate), MAX_ETA)
+        : MAX_ETA;
+}
+
+void SessionImpl::loadCheckingTorrents()
+{
+    for (TorrentImpl *torrent : asConst(m_torrents))
+        updateCheckingTorrent(torrent);
+
+    scheduleTorrentChecks();
+}
+
+void SessionImpl::scheduleTorrentChecks()
+{
+    if (!isDiskAwareCheckingEnabled())
+        return;
+
+    if (m_checkingTorrents.isEmpty())
+    {
+        m_checkingVolumesCache.clear();
+        return;
+    }
+
+    // Torrents stored on the same device are checked one after another (or a few at a time
+    // if configured so) since simultaneous checks make the disk seek between them and slow
+    // down all of them, while torrents stored on different devices are checked in parallel.
+    // Torrents that are checked bypassing the queue (e.g. forced ones) are counted as well.
+    QHash<QString, int> activeChecks;
+    int activeChecksCount = 0;
+    QList<TorrentImpl *> waitingTorrents;
+    for (auto it = m_checkingTorrents.cbegin(); it != m_checkingTorrents.cend(); ++it)
+    {
+        if (it->isScheduled || !it->isWaiting)
+        {
+            ++activeChecks[it->volume];
+            ++activeChecksCount;
+        }
+        else
+        {
+            waitingTorrents.append(it.key());
+        }
+    }
+
+    const int maxActiveChecks = maxActiveCheckingTorrents();
+    if (waitingTorrents.isEmpty() || ((maxActiveChecks >= 0) && (activeChecksCount >= maxActiveChecks)))
+        return;
+
+    switch (checkingQueueOrder())
+    {
+    case CheckingQueueOrder::SmallestFirst:
+        std::ranges::sort(waitingTorrents, {}, &TorrentImpl::totalSize);
+        break;
+    case CheckingQueueOrder::SavePath:
+        // neighbouring content is likely stored close to each other on the disk
+        std::ranges::sort(waitingTorrents, {}, [](const TorrentImpl *torrent) { return torrent->contentPath().data(); });
+        break;
+    default:
+        // torrents which are not in the queue (i.e. seeding ones) are checked last
+        std::ranges::sort(waitingTorrents, {}, [](const TorrentImpl *torrent)
+        {
+            return static_cast<quint32>(torrent->queuePosition());
+        });
+        break;
+    }
+
+    const QHash<QString, int> volumeLimits = checkingVolumeLimits();
+    const int defaultVolumeLimit = maxActiveCheckingTorrentsPerVolume();
+    for (TorrentImpl *torrent : asConst(waitingTorrents))
+    {
+        CheckingTorrentData &data = m_checkingTorrents[torrent];
+        int &volumeActiveChecks = activeChecks[data.volume];
+        if (volumeActiveChecks >= volumeLimits.value(data.volume, defaultVolumeLimit))
+            continue;
+
+        // The torrent is checked immediately since libtorrent doesn't limit the torrents
+        // which aren't auto managed. When the checking is finished, the torrent restores
+        // its operating mode by itself.
+        const lt::torrent_handle nativeHandle = torrent->nativeHandle();
+        nativeHandle.unset_flags(lt::torrent_flags::auto_managed);
+        nativeHandle.resume();
+        data.isScheduled = true;
+
+        ++volumeActiveChecks;
+        ++activeChecksCount;
+        if ((maxActiveChecks >= 0) && (activeChecksCount >= maxActiveChecks))
+            break;
+    }
+}
+
+void SessionImpl::processPendingFinishedTorrents()
+{
+    if (m_pendingFinishedTorrents.isEmpty())
+        return;
+
+    for (TorrentImpl *torrent : asConst(m_pendingFinishedTorrents))
+    {
+        LogMsg(tr("Torrent download finished. Torrent: \"%1\"").arg(torrent->name()));
+        emit torrentFinished(torrent);
 
         if (const Path exportPath = finishedTorrentExportDirectory(); !exportPath.isEmpty())
             exportTorrentFile(torrent, exportPath);
@@ -5536,8 +7504,16 @@ void SessionImpl::processPendingFinishedTorrents()
         emit allTorrentsFinished();
 }
 
-void SessionImpl::storeCategories() const
+void SessionImpl::storeCategoriesDeferred()
+{
+    if (!m_categoriesStoringTimer->isActive())
+        m_categoriesStoringTimer->start();
+}
+
+void SessionImpl::storeCategories()
 {
+    m_categoriesStoringTimer->stop();
+
     QJsonObject jsonObj;
     for (auto it = m_categories.cbegin(); it != m_categories.cend(); ++it)
     {
@@ -5546,14 +7522,7 @@ void SessionImpl::storeCategories() const
         jsonObj[categoryName] = categoryOptions.toJSON();
     }
 
-    const Path path = specialFolderLocation(SpecialFolder::Config) / CATEGORIES_FILE_NAME;
-    const QByteArray data = QJsonDocument(jsonObj).toJson();
-    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(path, data);
-    if (!result)
-    {
-        LogMsg(tr("Failed to save Categories configuration. File: \"%1\". Error: \"%2\"")
-               .arg(path.toString(), result.error()), Log::WARNING);
-    }
+    m_categoriesStorage->store(CATEGORIES_FILE_NAME, QJsonDocument(jsonObj).toJson());
 }
 
 void SessionImpl::upgradeCategories()
@@ -5567,12 +7536,14 @@ void SessionImpl::upgradeCategories()
         m_categories[categoryName] = categoryOptions;
     }
 
-    storeCategories();
+    invalidateCategoryPathsCache();
+    storeCategoriesDeferred();
 }
 
 void SessionImpl::loadCategories()
 {
     m_categories.clear();
+    invalidateCategoryPathsCache();
 
     const Path path = specialFolderLocation(SpecialFolder::Config) / CATEGORIES_FILE_NAME;
     if (!path.exists())
@@ -5583,7 +7554,8 @@ void SessionImpl::loadCategories()
         m_needUpgradeDownloadPath = true;
         // == END UPGRADE CODE ==
 
-//        return;
+        // the categories are stored with delay, so the file isn't written yet
+        return;
     }
 
     const int fileMaxSize = 1024 * 1024;
@@ -5617,6 +7589,8 @@ void SessionImpl::loadCategories()
         const auto categoryOptions = CategoryOptions::fromJSON(it.value().toObject());
         m_categories[categoryName] = categoryOptions;
     }
+
+    invalidateCategoryPathsCache();
 }
 
 bool SessionImpl::hasPerTorrentRatioLimit() const
@@ -5683,9 +7657,8 @@ void SessionImpl::disableIPFilter()
     // Add the banned IPs after the IPFilter disabling
     // which creates an empty filter and overrides all previously
     // applied bans.
-    lt::ip_filter filter;
-    processBannedIPs(filter);
-    m_nativeSession->set_ip_filter(filter);
+    m_fileIPFilter = {};
+    applyIPFilter();
 }
 
 const SessionStatus &SessionImpl::status() const
@@ -5698,32 +7671,121 @@ const CacheStatus &SessionImpl::cacheStatus() const
     return m_cacheStatus;
 }
 
+const AlertStatistics &SessionImpl::alertStatistics() const
+{
+    return m_alertStatistics;
+}
+
+PeerStatistics SessionImpl::peerStatistics() const
+{
+    return m_peerStatistics;
+}
+
+DiskIOStatistics SessionImpl::torrentDiskIOStatistics(const TorrentID &id) const
+{
+    return m_diskIOAccounting->torrentStatistics(id);
+}
+
+QHash<QString, DiskIOStatistics> SessionImpl::volumeDiskIOStatistics() const
+{
+    return m_diskIOAccounting->volumeStatistics();
+}
+
+const QList<SessionMetric> &SessionImpl::sessionMetrics() const
+{
+    return m_sessionMetrics;
+}
+
+int SessionImpl::pendingResumeDataCount() const
+{
+    return m_numResumeData;
+}
+
+QList<TorrentContentRemovingJobInfo> SessionImpl::torrentContentRemovingJobs() const
+{
+    return m_contentRemovingJobs;
+}
+
+QList<MoveStorageJobInfo> SessionImpl::moveStorageJobs() const
+{
+    QList<MoveStorageJobInfo> jobs = m_finishedMoveStorageJobs;
+    jobs.reserve(jobs.size() + m_moveStorageQueue.size());
+    for (const MoveStorageJob &job : m_moveStorageQueue)
+        jobs.append(toMoveStorageJobInfo(job, (job.isActive ? MoveStorageJobState::Moving : MoveStorageJobState::Queued)));
+    return jobs;
+}
+
+MoveStorageJobInfo SessionImpl::toMoveStorageJobInfo(const MoveStorageJob &job, const MoveStorageJobState state) const
+{
+    MoveStorageJobInfo info;
+    info.torrentID = getInfoHash(job.torrentHandle).toTorrentID();
+    info.sourcePath = job.sourcePath;
+    info.destinationPath = job.path;
+    info.sourceVolume = job.sourceVolume;
+    info.destinationVolume = job.destinationVolume;
+    info.state = state;
+    info.size = job.size;
+    info.elapsedTime = (job.timer.isValid() ? job.timer.elapsed() : 0);
+    // libtorrent doesn't report the progress of the move, it is only known
+    // when the data is copied to another volume by the custom disk IO
+    if (state == MoveStorageJobState::Moving)
+        info.movedSize = m_diskIOAccounting->moveProgress(info.torrentID);
+    if (info.elapsedTime > 0)
+    {
+        if (state == MoveStorageJobState::Finished)
+            info.throughput = (job.size * 1000) / info.elapsedTime;
+        else if (state == MoveStorageJobState::Moving)
+            info.throughput = (info.movedSize * 1000) / info.elapsedTime;
+    }
+    return info;
+}
+
 void SessionImpl::enqueueRefresh()
 {
     Q_ASSERT(!m_refreshEnqueued);
 
-    QTimer::singleShot(refreshInterval(), Qt::CoarseTimer, this, [this]
+    int interval = refreshInterval();
+    if (!m_refreshSubscribers.isEmpty())
     {
-        m_nativeSession->post_torrent_updates();
-        m_nativeSession->post_session_stats();
-
-        if (m_torrentsQueueChanged)
-        {
-            m_torrentsQueueChanged = false;
-            m_needSaveTorrentsQueue = true;
-        }
-    });
+        m_idleRefreshInterval = 0;
+        interval = std::max(interval, *std::ranges::min_element(m_refreshSubscribers));
+    }
+    else if ((m_status.payloadDownloadRate > 0) || (m_status.payloadUploadRate > 0))
+    {
+        m_idleRefreshInterval = 0;
+    }
+    else
+    {
+        // nobody is interested in the data and nothing is transferred so it isn't likely to change
+        m_idleRefreshInterval = (m_idleRefreshInterval > 0)
+            ? std::min((m_idleRefreshInterval * 2), MAX_IDLE_REFRESH_INTERVAL) : interval;
+        interval = std::max(interval, m_idleRefreshInterval);
+    }
 
+    m_refreshTimer->start(interval);
     m_refreshEnqueued = true;
 }
 
+void SessionImpl::refresh()
+{
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
+        nativeSession->post_torrent_updates(REFRESH_STATUS_FLAGS);
+    primaryNativeSession()->post_session_stats();
+    updateTorrentsAvailability();
+
+    if (m_torrentsQueueChanged)
+    {
+        m_torrentsQueueChanged = false;
+        m_needSaveTorrentsQueue = true;
+    }
+}
+
 void SessionImpl::handleIPFilterParsed(const int ruleCount)
 {
     if (m_filterParser)
     {
-        lt::ip_filter filter = m_filterParser->IPfilter();
-        processBannedIPs(filter);
-        m_nativeSession->set_ip_filter(filter);
+        m_fileIPFilter = m_filterParser->IPfilter();
+        applyIPFilter();
     }
     LogMsg(tr("Successfully parsed the IP filter file. Number of rules applied: %1").arg(ruleCount));
     emit IPFilterParsed(false, ruleCount);
@@ -5731,9 +7793,8 @@ void SessionImpl::handleIPFilterParsed(const int ruleCount)
 
 void SessionImpl::handleIPFilterError()
 {
-    lt::ip_filter filter;
-    processBannedIPs(filter);
-    m_nativeSession->set_ip_filter(filter);
+    m_fileIPFilter = {};
+    applyIPFilter();
 
     LogMsg(tr("Failed to parse the IP filter file"), Log::WARNING);
     emit IPFilterParsed(true, 0);
@@ -5742,10 +7803,21 @@ void SessionImpl::handleIPFilterError()
 void SessionImpl::fetchPendingAlerts(const lt::time_duration time)
 {
     if (time > lt::time_duration::zero())
-        m_nativeSession->wait_for_alert(time);
+        primaryNativeSession()->wait_for_alert(time);
 
     m_alerts.clear();
-    m_nativeSession->pop_alerts(&m_alerts);
+    if (m_nativeSessions.size() == 1)
+    {
+        primaryNativeSession()->pop_alerts(&m_alerts);
+        return;
+    }
+
+    // The alerts of each session stay valid until the next time they are popped from it
+    for (lt::session *nativeSession : asConst(m_nativeSessions))
+    {
+        nativeSession->pop_alerts(&m_shardAlerts);
+        m_alerts.insert(m_alerts.end(), m_shardAlerts.cbegin(), m_shardAlerts.cend());
+    }
 }
 
 void SessionImpl::endAlertSequence(const int alertType, const qsizetype alertCount)
@@ -5780,6 +7852,8 @@ void SessionImpl::setTorrentContentLayout(const TorrentContentLayout value)
 // Read alerts sent by libtorrent session
 void SessionImpl::readAlerts()
 {
+    const TraceSpan traceSpan {"SessionImpl::readAlerts"};
+
     fetchPendingAlerts();
 
     Q_ASSERT(m_loadedTorrents.isEmpty());
@@ -5787,6 +7861,10 @@ void SessionImpl::readAlerts()
     if (!isRestored())
         m_loadedTorrents.reserve(MAX_PROCESSING_RESUMEDATA_COUNT);
 
+    QElapsedTimer batchTimer;
+    batchTimer.start();
+    QElapsedTimer alertTimer;
+
     int previousAlertType = -1;
     qsizetype alertSequenceSize = 0;
     for (lt::alert *a : m_alerts)
@@ -5798,23 +7876,60 @@ void SessionImpl::readAlerts()
             alertSequenceSize = 0;
         }
 
+        alertTimer.start();
         handleAlert(a);
+        if ((alertType >= 0) && (alertType < m_alertStatistics.alertTypes.size())) [[likely]]
+        {
+            AlertTypeStatistics &alertTypeStatistics = m_alertStatistics.alertTypes[alertType];
+            const qint64 elapsed = alertTimer.nsecsElapsed() / 1000;
+            ++alertTypeStatistics.count;
+            alertTypeStatistics.totalTime += elapsed;
+            alertTypeStatistics.maxTime = std::max(alertTypeStatistics.maxTime, elapsed);
+            addToHistogram(alertTypeStatistics.timeHistogram, ALERT_TIME_HISTOGRAM_BOUNDS, elapsed);
+        }
+
         ++alertSequenceSize;
         previousAlertType = alertType;
     }
     endAlertSequence(previousAlertType, alertSequenceSize);
 
+    // Tracker alerts usually come in large bunches (e.g. when many torrents are started at once)
+    // so their statuses are retrieved for all the affected torrents together
+    if (!m_pendingTrackerStatusesUpdates.isEmpty())
+        updateTrackerEntryStatuses(std::exchange(m_pendingTrackerStatusesUpdates, {}));
+
     // Some torrents may become "finished" after different alerts handling.
     processPendingFinishedTorrents();
+
+    // Blocked peers alerts are aggregated by the session extension on the network thread
+    processBlockedPeers();
+
+    applyAlertQueueSize(alertQueueSize());
+
+    if (!m_alerts.empty())
+    {
+        const auto batchSize = static_cast<qint64>(m_alerts.size());
+        m_alertStatistics.alertCount += batchSize;
+        ++m_alertStatistics.batchCount;
+        m_alertStatistics.maxBatchSize = std::max(m_alertStatistics.maxBatchSize, batchSize);
+        addToHistogram(m_alertStatistics.batchSizeHistogram, ALERT_BATCH_SIZE_HISTOGRAM_BOUNDS, batchSize);
+
+        const qint64 stallTime = batchTimer.nsecsElapsed() / 1000;
+        m_alertStatistics.totalStallTime += stallTime;
+        m_alertStatistics.maxStallTime = std::max(m_alertStatistics.maxStallTime, stallTime);
+        addToHistogram(m_alertStatistics.stallTimeHistogram, ALERT_TIME_HISTOGRAM_BOUNDS, stallTime);
+    }
 }
 
 void SessionImpl::handleAddTorrentAlert(const lt::add_torrent_alert *alert)
 {
-    Q_ASSERT(!m_addTorrentAlertHandlers.isEmpty());
-    if (m_addTorrentAlertHandlers.isEmpty()) [[unlikely]]
+    // The alerts of each session come in the order its torrents were added
+    QList<AddTorrentAlertHandler> &handlers = m_addTorrentAlertHandlers[nativeSessionIndexFor(alert->params)];
+    Q_ASSERT(!handlers.isEmpty());
+    if (handlers.isEmpty()) [[unlikely]]
         return;
 
-    if (const AddTorrentAlertHandler handleAlert = m_addTorrentAlertHandlers.takeFirst())
+    if (const AddTorrentAlertHandler handleAlert = handlers.takeFirst())
         handleAlert(alert);
 }
 
@@ -5841,6 +7956,9 @@ void SessionImpl::handleAlert(lt::alert *alert)
         case lt::file_error_alert::alert_type:
             handleFileErrorAlert(static_cast<const lt::file_error_alert *>(alert));
             break;
+        case lt::read_piece_alert::alert_type:
+            handleReadPieceAlert(static_cast<const lt::read_piece_alert *>(alert));
+            break;
         case lt::torrent_finished_alert::alert_type:
             handleTorrentFinishedAlert(static_cast<const lt::torrent_finished_alert *>(alert));
             break;
@@ -5877,6 +7995,12 @@ void SessionImpl::handleAlert(lt::alert *alert)
         case lt::tracker_warning_alert::alert_type:
             handleTrackerAlert(static_cast<const lt::tracker_alert *>(alert));
             break;
+        case lt::scrape_reply_alert::alert_type:
+            handleScrapeReplyAlert(static_cast<const lt::scrape_reply_alert *>(alert));
+            break;
+        case lt::scrape_failed_alert::alert_type:
+            handleScrapeFailedAlert(static_cast<const lt::scrape_failed_alert *>(alert));
+            break;
         case lt::add_torrent_alert::alert_type:
             handleAddTorrentAlert(static_cast<const lt::add_torrent_alert *>(alert));
             break;
@@ -5898,9 +8022,6 @@ void SessionImpl::handleAlert(lt::alert *alert)
         case lt::portmap_alert::alert_type:
             handlePortmapAlert(static_cast<const lt::portmap_alert *>(alert));
             break;
-        case lt::peer_blocked_alert::alert_type:
-            handlePeerBlockedAlert(static_cast<const lt::peer_blocked_alert *>(alert));
-            break;
         case lt::peer_ban_alert::alert_type:
             handlePeerBanAlert(static_cast<const lt::peer_ban_alert *>(alert));
             break;
@@ -5948,6 +8069,7 @@ TorrentImpl *SessionImpl::createTorrent(const lt::torrent_handle &nativeHandle,
 {
     auto *const torrent = new TorrentImpl(this, nativeHandle, std::move(params));
     m_torrents.insert(torrent->id(), torrent);
+    m_torrentStatusTable.update(torrent);
     if (const InfoHash infoHash = torrent->infoHash(); infoHash.isHybrid())
         m_hybridTorrentsByAltID.insert(TorrentID::fromSHA1Hash(infoHash.v1()), torrent);
 
@@ -5956,6 +8078,7 @@ TorrentImpl *SessionImpl::createTorrent(const lt::torrent_handle &nativeHandle,
     {
         m_seedingLimitTimer->start();
     }
+    scheduleTorrentShareLimitsCheck(torrent, 0);
 
     // Torrent could have error just after adding to libtorrent
     if (torrent->hasError())
@@ -6053,10 +8176,13 @@ void SessionImpl::handleMetadataReceivedAlert(const lt::metadata_received_alert
 #endif
     if (found)
     {
+        m_metadataDownloadScheduler.remove(torrentID);
+        startQueuedMetadataDownloads();
+
         const TorrentInfo metadata {*alert->handle.torrent_file()};
-        m_nativeSession->remove_torrent(alert->handle, lt::session::delete_files);
+        nativeSessionOf(alert->handle)->remove_torrent(alert->handle, lt::session::delete_files);
 
-        emit metadataDownloaded(metadata);
+        handleMetadataDownloaded(metadata);
     }
 }
 
@@ -6074,9 +8200,11 @@ void SessionImpl::handleFileErrorAlert(const lt::file_error_alert *alert)
         m_recentErroredTorrents.insert(id);
 
         const QString msg = QString::fromStdString(alert->message());
-        LogMsg(tr("File error alert. Torrent: \"%1\". File: \"%2\". Reason: \"%3\"")
-                .arg(torrent->name(), QString::fromUtf8(alert->filename()), msg)
-            , Log::WARNING);
+        LogMsg(Log::Category::Storage, Log::WARNING, [&]
+        {
+            return tr("File error alert. Torrent: \"%1\". File: \"%2\". Reason: \"%3\"")
+                    .arg(torrent->name(), QString::fromUtf8(alert->filename()), msg);
+        });
         emit fullDiskError(torrent, msg);
     }
 
@@ -6085,50 +8213,86 @@ void SessionImpl::handleFileErrorAlert(const lt::file_error_alert *alert)
 
 void SessionImpl::handlePortmapWarningAlert(const lt::portmap_error_alert *alert)
 {
-    LogMsg(tr("UPnP/NAT-PMP port mapping failed. Message: \"%1\"").arg(QString::fromStdString(alert->message())), Log::WARNING);
+    LogMsg(Log::Category::Network, Log::WARNING, [alert]
+    {
+        return tr("UPnP/NAT-PMP port mapping failed. Message: \"%1\"").arg(QString::fromStdString(alert->message()));
+    });
 }
 
 void SessionImpl::handlePortmapAlert(const lt::portmap_alert *alert)
 {
     qDebug("UPnP Success, msg: %s", alert->message().c_str());
-    LogMsg(tr("UPnP/NAT-PMP port mapping succeeded. Message: \"%1\"").arg(QString::fromStdString(alert->message())), Log::INFO);
+    LogMsg(Log::Category::Network, Log::INFO, [alert]
+    {
+        return tr("UPnP/NAT-PMP port mapping succeeded. Message: \"%1\"").arg(QString::fromStdString(alert->message()));
+    });
 }
 
-void SessionImpl::handlePeerBlockedAlert(const lt::peer_blocked_alert *alert)
+void SessionImpl::processBlockedPeers()
 {
-    QString reason;
-    switch (alert->reason)
+    NativeSessionExtension::BlockedPeers blockedPeers;
+    for (NativeSessionExtension *nativeSessionExtension : asConst(m_nativeSessionExtensions))
     {
-    case lt::peer_blocked_alert::ip_filter:
-        reason = tr("IP filter", "this peer was blocked. Reason: IP filter.");
-        break;
-    case lt::peer_blocked_alert::port_filter:
-        reason = tr("filtered port (%1)", "this peer was blocked. Reason: filtered port (8899).").arg(QString::number(alert->endpoint.port()));
-        break;
-    case lt::peer_blocked_alert::i2p_mixed:
-        reason = tr("%1 mixed mode restrictions", "this peer was blocked. Reason: I2P mixed mode restrictions.").arg(u"I2P"_s); // don't translate I2P
-        break;
-    case lt::peer_blocked_alert::privileged_ports:
-        reason = tr("privileged port (%1)", "this peer was blocked. Reason: privileged port (80).").arg(QString::number(alert->endpoint.port()));
-        break;
-    case lt::peer_blocked_alert::utp_disabled:
-        reason = tr("%1 is disabled", "this peer was blocked. Reason: uTP is disabled.").arg(C_UTP); // don't translate μTP
-        break;
-    case lt::peer_blocked_alert::tcp_disabled:
-        reason = tr("%1 is disabled", "this peer was blocked. Reason: TCP is disabled.").arg(u"TCP"_s); // don't translate TCP
-        break;
+        NativeSessionExtension::BlockedPeers shardBlockedPeers = nativeSessionExtension->takeBlockedPeers();
+        blockedPeers.peers.append(std::move(shardBlockedPeers.peers));
+        blockedPeers.otherCount += shardBlockedPeers.otherCount;
     }
 
-    const QString ip {toString(alert->endpoint.address())};
-    if (!ip.isEmpty())
-        Logger::instance()->addPeer(ip, true, reason);
+    // peer log entries are recorded as the normal messages of the "peers" category
+    if (!Logger::instance()->isEnabled(Log::Category::Peers, Log::NORMAL))
+        return;
+
+    for (const NativeSessionExtension::BlockedPeer &blockedPeer : blockedPeers.peers)
+    {
+        QString reason;
+        switch (blockedPeer.reason)
+        {
+        case lt::peer_blocked_alert::ip_filter:
+            reason = tr("IP filter", "this peer was blocked. Reason: IP filter.");
+            break;
+        case lt::peer_blocked_alert::port_filter:
+            reason = tr("filtered port (%1)", "this peer was blocked. Reason: filtered port (8899).").arg(QString::number(blockedPeer.port));
+            break;
+        case lt::peer_blocked_alert::i2p_mixed:
+            reason = tr("%1 mixed mode restrictions", "this peer was blocked. Reason: I2P mixed mode restrictions.").arg(u"I2P"_s); // don't translate I2P
+            break;
+        case lt::peer_blocked_alert::privileged_ports:
+            reason = tr("privileged port (%1)", "this peer was blocked. Reason: privileged port (80).").arg(QString::number(blockedPeer.port));
+            break;
+        case lt::peer_blocked_alert::utp_disabled:
+            reason = tr("%1 is disabled", "this peer was blocked. Reason: uTP is disabled.").arg(C_UTP); // don't translate μTP
+            break;
+        case lt::peer_blocked_alert::tcp_disabled:
+            reason = tr("%1 is disabled", "this peer was blocked. Reason: TCP is disabled.").arg(u"TCP"_s); // don't translate TCP
+            break;
+        }
+
+        if (blockedPeer.count > 1)
+            reason = tr("%1 (%2 connections)", "IP filter (5 connections)").arg(reason, QString::number(blockedPeer.count));
+
+        const QString ip {toString(blockedPeer.address)};
+        if (!ip.isEmpty())
+            Logger::instance()->addPeer(ip, true, reason);
+    }
+
+    if (blockedPeers.otherCount > 0)
+    {
+        LogMsg(Log::Category::Peers, Log::INFO, [&blockedPeers]
+        {
+            return tr("Blocked %1 more connections from other peers").arg(blockedPeers.otherCount);
+        });
+    }
 }
 
 void SessionImpl::handlePeerBanAlert(const lt::peer_ban_alert *alert)
 {
+    Logger *logger = Logger::instance();
+    if (!logger->isEnabled(Log::Category::Peers, Log::NORMAL))
+        return;
+
     const QString ip {toString(alert->endpoint.address())};
     if (!ip.isEmpty())
-        Logger::instance()->addPeer(ip, false);
+        logger->addPeer(ip, false);
 }
 
 void SessionImpl::handleUrlSeedAlert(const lt::url_seed_alert *alert)
@@ -6137,18 +8301,17 @@ void SessionImpl::handleUrlSeedAlert(const lt::url_seed_alert *alert)
     if (!torrent)
         return;
 
-    if (alert->error)
+    LogMsg(Log::Category::Network, Log::WARNING, [torrent, alert]
     {
-        LogMsg(tr("URL seed connection failed. Torrent: \"%1\". URL: \"%2\". Error: \"%3\"")
-            .arg(torrent->name(), QString::fromUtf8(alert->server_url()), QString::fromStdString(alert->message()))
-            , Log::WARNING);
-    }
-    else
-    {
-        LogMsg(tr("Received error message from URL seed. Torrent: \"%1\". URL: \"%2\". Message: \"%3\"")
-            .arg(torrent->name(), QString::fromUtf8(alert->server_url()), QString::fromUtf8(alert->error_message()))
-            , Log::WARNING);
-    }
+        if (alert->error)
+        {
+            return tr("URL seed connection failed. Torrent: \"%1\". URL: \"%2\". Error: \"%3\"")
+                .arg(torrent->name(), QString::fromUtf8(alert->server_url()), QString::fromStdString(alert->message()));
+        }
+
+        return tr("Received error message from URL seed. Torrent: \"%1\". URL: \"%2\". Message: \"%3\"")
+            .arg(torrent->name(), QString::fromUtf8(alert->server_url()), QString::fromUtf8(alert->error_message()));
+    });
 }
 
 void SessionImpl::handleListenSucceededAlert(const lt::listen_succeeded_alert *alert)
@@ -6209,6 +8372,10 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
 
     const auto stats = alert->counters();
 
+    const auto metricsCount = std::min<qsizetype>(m_sessionMetrics.size(), stats.size());
+    for (qsizetype i = 0; i < metricsCount; ++i)
+        m_sessionMetrics[i].value = stats[i];
+
     m_status.hasIncomingConnections = static_cast<bool>(stats[m_metricIndices.net.hasIncomingConnections]);
 
     const int64_t ipOverheadDownload = stats[m_metricIndices.net.recvIPOverheadBytes];
@@ -6240,6 +8407,25 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
     m_status.trackerDownloadRate = calcRate(m_status.trackerDownload, trackerDownload);
     m_status.trackerUploadRate = calcRate(m_status.trackerUpload, trackerUpload);
 
+    const qint64 totalChecked = m_diskIOAccounting->checkedBytes();
+    m_status.checkingRate = calcRate(m_status.totalChecked, totalChecked);
+    m_status.totalChecked = totalChecked;
+    updateCheckingStatus();
+
+    if (performanceProfile() == PerformanceProfile::Auto)
+    {
+        // The peak decays by 0.1% per update, so that the settings follow a lasting change of the load
+        const qint64 rate = std::max(m_status.downloadRate, m_status.uploadRate);
+        m_observedPeakRate = std::max(rate, (m_observedPeakRate - (m_observedPeakRate / 1000)));
+    }
+
+    if (isUnchokeSlotsTuningEnabled()
+        && m_unchokeSlotsController.update(m_status.uploadRate, uploadSpeedLimit(), static_cast<int>(stats[m_metricIndices.peer.numPeersUpUnchoked])
+            , lt::total_milliseconds(alert->timestamp().time_since_epoch())))
+    {
+        applyUnchokeSlotsLimits();
+    }
+
     m_status.totalPayloadDownload = totalPayloadDownload;
     m_status.totalPayloadUpload = totalPayloadUpload;
     m_status.ipOverheadDownload = ipOverheadDownload;
@@ -6282,7 +8468,22 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
     m_cacheStatus.totalUsedBuffers = stats[m_metricIndices.disk.diskBlocksInUse];
     m_cacheStatus.jobQueueLength = stats[m_metricIndices.disk.queuedDiskJobs];
 
-#ifndef QBT_USES_LIBTORRENT2
+#ifdef QBT_USES_LIBTORRENT2
+    const DiskReadCache::Statistics readCacheStats = m_diskReadCache->statistics();
+    m_cacheStatus.readCacheHits = readCacheStats.hits;
+    m_cacheStatus.readCacheMisses = readCacheStats.misses;
+    m_cacheStatus.readCacheSize = readCacheStats.size;
+    // blocks missed in memory can still be read from the persistent cache
+    qint64 readCacheHits = readCacheStats.hits;
+    if (m_persistentReadCache)
+    {
+        const PersistentReadCache::Statistics persistentReadCacheStats = m_persistentReadCache->statistics();
+        m_cacheStatus.persistentReadCacheHits = persistentReadCacheStats.hits;
+        m_cacheStatus.persistentReadCacheSize = persistentReadCacheStats.size;
+        readCacheHits += persistentReadCacheStats.hits;
+    }
+    m_cacheStatus.readRatio = static_cast<qreal>(readCacheHits) / std::max<qint64>((readCacheStats.hits + readCacheStats.misses), 1);
+#else
     const int64_t numBlocksRead = stats[m_metricIndices.disk.numBlocksRead];
     const int64_t numBlocksCacheHits = stats[m_metricIndices.disk.numBlocksCacheHits];
     m_cacheStatus.readRatio = static_cast<qreal>(numBlocksCacheHits) / std::max<int64_t>((numBlocksCacheHits + numBlocksRead), 1);
@@ -6296,36 +8497,82 @@ void SessionImpl::handleSessionStatsAlert(const lt::session_stats_alert *alert)
     emit statsUpdated();
 }
 
-void SessionImpl::handleAlertsDroppedAlert(const lt::alerts_dropped_alert *alert) const
+void SessionImpl::handleAlertsDroppedAlert(const lt::alerts_dropped_alert *alert)
 {
+    ++m_alertStatistics.droppedAlertsCount;
+
     LogMsg(tr("Error: Internal alert queue is full and alerts are dropped, you might see degraded performance. Dropped alert type: \"%1\". Message: \"%2\"")
         .arg(QString::fromStdString(alert->dropped_alerts.to_string()), QString::fromStdString(alert->message())), Log::CRITICAL);
+
+    // The burst which caused the drop didn't fit in the queue
+    applyAlertQueueSize(static_cast<int>(std::min<qint64>((m_alertQueueSize * 2LL), MAX_ALERT_QUEUE_SIZE)));
+
+    // The state which is kept up to date by the dropped alerts is requested again
+    const auto isDropped = [alert](const int alertType) { return alert->dropped_alerts.test(static_cast<std::size_t>(alertType)); };
+
+    if (isDropped(lt::save_resume_data_alert::alert_type) || isDropped(lt::save_resume_data_failed_alert::alert_type))
+    {
+        m_numResumeData = 0;
+        for (TorrentImpl *torrent : asConst(m_torrents))
+            torrent->resendResumeDataRequest();
+    }
+
+    if (isDropped(lt::state_update_alert::alert_type))
+    {
+        // Torrents updated by the dropped alert aren't reported by post_torrent_updates() again
+        for (const TorrentImpl *torrent : asConst(m_torrents))
+            torrent->nativeHandle().post_status(REFRESH_STATUS_FLAGS);
+    }
+
+    // The session refreshing waits for the statistics
+    if (isDropped(lt::session_stats_alert::alert_type))
+        primaryNativeSession()->post_session_stats();
 }
 
-void SessionImpl::handleStorageMovedAlert(const lt::storage_moved_alert *alert)
+int SessionImpl::alertQueueSize() const
+{
+    // Most alerts are posted in bursts for many torrents at once (e.g. on startup or when resume data
+    // is saved for all the torrents), the queue has to hold the largest such burst
+    const qint64 size = std::max({static_cast<qint64>(MIN_ALERT_QUEUE_SIZE), (static_cast<qint64>(m_torrents.size()) * ALERT_QUEUE_SIZE_PER_TORRENT)
+        , (m_alertStatistics.maxBatchSize * 2)});
+    return static_cast<int>(std::min<qint64>(size, MAX_ALERT_QUEUE_SIZE));
+}
+
+void SessionImpl::applyAlertQueueSize(const int size)
 {
-    Q_ASSERT(!m_moveStorageQueue.isEmpty());
+    // The queue is only grown, libtorrent allocates the memory as the alerts are posted anyway
+    if (size <= m_alertQueueSize)
+        return;
 
-    const MoveStorageJob &currentJob = m_moveStorageQueue.constFirst();
-    Q_ASSERT(currentJob.torrentHandle == alert->handle);
+    lt::settings_pack settingsPack;
+    settingsPack.set_int(lt::settings_pack::alert_queue_size, size);
+    applyNativeSettings(std::move(settingsPack));
+    m_alertQueueSize = size;
+}
 
+void SessionImpl::handleStorageMovedAlert(const lt::storage_moved_alert *alert)
+{
     const Path newPath {QString::fromUtf8(alert->storage_path())};
-    Q_ASSERT(newPath == currentJob.path);
 
-    TorrentImpl *torrent = getTorrent(currentJob.torrentHandle);
-    const QString torrentName = (torrent ? torrent->name() : getInfoHash(currentJob.torrentHandle).toTorrentID().toString());
+    TorrentImpl *torrent = getTorrent(alert->handle);
+    const QString torrentName = (torrent ? torrent->name() : getInfoHash(alert->handle).toTorrentID().toString());
     LogMsg(tr("Moved torrent successfully. Torrent: \"%1\". Destination: \"%2\"").arg(torrentName, newPath.toString()));
 
-    handleMoveTorrentStorageJobFinished(newPath);
+    handleMoveTorrentStorageJobFinished(alert->handle, newPath, true);
 }
 
 void SessionImpl::handleStorageMovedFailedAlert(const lt::storage_moved_failed_alert *alert)
 {
-    Q_ASSERT(!m_moveStorageQueue.isEmpty());
-
-    const MoveStorageJob &currentJob = m_moveStorageQueue.constFirst();
-    Q_ASSERT(currentJob.torrentHandle == alert->handle);
+    const auto currentJobIter = std::ranges::find_if(asConst(m_moveStorageQueue)
+            , [alert](const MoveStorageJob &job)
+    {
+        return job.isActive && (job.torrentHandle == alert->handle);
+    });
+    Q_ASSERT(currentJobIter != m_moveStorageQueue.cend());
+    if (currentJobIter == m_moveStorageQueue.cend()) [[unlikely]]
+        return;
 
+    const MoveStorageJob &currentJob = *currentJobIter;
     TorrentImpl *torrent = getTorrent(currentJob.torrentHandle);
     const QString torrentName = (torrent ? torrent->name() : getInfoHash(currentJob.torrentHandle).toTorrentID().toString());
     const Path currentLocation = (torrent ? torrent->actualStorageLocation()
@@ -6334,13 +8581,16 @@ void SessionImpl::handleStorageMovedFailedAlert(const lt::storage_moved_failed_a
     LogMsg(tr("Failed to move torrent. Torrent: \"%1\". Source: \"%2\". Destination: \"%3\". Reason: \"%4\"")
            .arg(torrentName, currentLocation.toString(), currentJob.path.toString(), errorMessage), Log::WARNING);
 
-    handleMoveTorrentStorageJobFinished(currentLocation);
+    handleMoveTorrentStorageJobFinished(alert->handle, currentLocation, false);
 }
 
 void SessionImpl::handleStateUpdateAlert(const lt::state_update_alert *alert)
 {
     QList<Torrent *> updatedTorrents;
     updatedTorrents.reserve(static_cast<decltype(updatedTorrents)::size_type>(alert->status.size()));
+    // Torrents which can reach the ratio limit are re-evaluated as soon as they upload enough
+    QList<TorrentImpl *> ratioLimitTorrents;
+    bool isCheckingQueueChanged = false;
 
     for (const lt::torrent_status &status : alert->status)
     {
@@ -6349,11 +8599,33 @@ void SessionImpl::handleStateUpdateAlert(const lt::state_update_alert *alert)
             continue;
 
         torrent->handleStateUpdate(status);
+        m_torrentStatusTable.update(torrent);
         updatedTorrents.push_back(torrent);
+
+        if (isDiskAwareCheckingEnabled() && updateCheckingTorrent(torrent))
+            isCheckingQueueChanged = true;
+
+        if (const auto iter = m_shareLimitsChecks.constFind(torrent); iter != m_shareLimitsChecks.cend())
+        {
+            if ((iter->uploadThreshold >= 0) && (torrent->totalUpload() >= iter->uploadThreshold))
+                ratioLimitTorrents.push_back(torrent);
+        }
     }
 
     if (!updatedTorrents.isEmpty())
+    {
         emit torrentsUpdated(updatedTorrents);
+        for (Torrent *torrent : asConst(updatedTorrents))
+            static_cast<TorrentImpl *>(torrent)->clearChangedFields();
+    }
+
+    for (TorrentImpl *torrent : asConst(ratioLimitTorrents))
+        processTorrentShareLimits(torrent);
+
+    if (isCheckingQueueChanged)
+        scheduleTorrentChecks();
+
+    applyCategoryLimits();
 
     if (m_needSaveTorrentsQueue)
         saveTorrentsQueue();
@@ -6364,6 +8636,60 @@ void SessionImpl::handleStateUpdateAlert(const lt::state_update_alert *alert)
         enqueueRefresh();
 }
 
+void SessionImpl::applyCategoryLimits()
+{
+    const bool hasCategoryLimits = std::any_of(m_categories.cbegin(), m_categories.cend()
+            , [](const CategoryOptions &options) { return options.hasLimits(); });
+    if (!hasCategoryLimits && !m_categoryLimitsApplied)
+        return;
+
+    m_categoryLimitsApplied = hasCategoryLimits;
+
+    QHash<QString, QList<TorrentImpl *>> limitedTorrents;
+    for (TorrentImpl *torrent : asConst(m_torrents))
+    {
+        const auto categoryIter = m_categories.constFind(torrent->category());
+        if (torrent->isStopped() || (categoryIter == m_categories.cend()) || !categoryIter->hasLimits())
+            torrent->setCategoryLimits(0, 0, 0);
+        else
+            limitedTorrents[categoryIter.key()].append(torrent);
+    }
+
+    for (auto iter = limitedTorrents.cbegin(); iter != limitedTorrents.cend(); ++iter)
+    {
+        const CategoryOptions options = m_categories.value(iter.key());
+        const QList<TorrentImpl *> &torrents = iter.value();
+
+        // Every torrent is allowed to grow a bit above its current rate,
+        // so the shares follow the torrents which can transfer faster
+        const auto shareRateLimit = [&torrents](const int limit, int (TorrentImpl::*rate)() const, int (TorrentImpl::*ownLimit)() const)
+        {
+            if (limit <= 0)
+                return QList<int>(torrents.size(), 0);
+
+            const int minDemand = std::min(MIN_CATEGORY_RATE_SHARE, limit);
+            QList<int> demands;
+            demands.reserve(torrents.size());
+            for (const TorrentImpl *torrent : torrents)
+            {
+                const auto demand = static_cast<int>(std::min<qint64>(limit, std::max<qint64>(minDemand, ((static_cast<qint64>((torrent->*rate)()) * 5) / 4))));
+                const int torrentLimit = (torrent->*ownLimit)();
+                demands.append((torrentLimit > 0) ? std::min(demand, torrentLimit) : demand);
+            }
+
+            return shareLimit(limit, demands);
+        };
+
+        const QList<int> downloadShares = shareRateLimit(options.downloadLimit, &TorrentImpl::downloadPayloadRate, &TorrentImpl::downloadLimit);
+        const QList<int> uploadShares = shareRateLimit(options.uploadLimit, &TorrentImpl::uploadPayloadRate, &TorrentImpl::uploadLimit);
+        const int connectionsShare = (options.connectionsLimit > 0)
+                ? std::max(2, static_cast<int>(options.connectionsLimit / torrents.size())) : 0;
+
+        for (qsizetype i = 0; i < torrents.size(); ++i)
+            torrents[i]->setCategoryLimits(downloadShares[i], uploadShares[i], connectionsShare);
+    }
+}
+
 void SessionImpl::handleSocks5Alert(const lt::socks5_alert *alert) const
 {
     if (alert->error)
@@ -6397,7 +8723,7 @@ void SessionImpl::handleTrackerAlert(const lt::tracker_alert *alert)
     const auto prevSize = m_updatedTrackerStatuses.size();
     QMap<int, int> &updateInfo = m_updatedTrackerStatuses[torrent->nativeHandle()][std::string(alert->tracker_url())][alert->local_endpoint];
     if (prevSize < m_updatedTrackerStatuses.size())
-        updateTrackerEntryStatuses(torrent->nativeHandle());
+        m_pendingTrackerStatusesUpdates.append(torrent->nativeHandle());
 
     if (alert->type() == lt::tracker_reply_alert::alert_type)
     {
@@ -6411,6 +8737,27 @@ void SessionImpl::handleTrackerAlert(const lt::tracker_alert *alert)
     }
 }
 
+void SessionImpl::handleScrapeReplyAlert(const lt::scrape_reply_alert *alert)
+{
+    TorrentImpl *torrent = getTorrent(alert->handle);
+    if (!torrent || !torrent->isDormant())
+        return;
+
+    if (alert->incomplete > 0)
+        wakeDormantSeed(torrent);
+}
+
+void SessionImpl::handleScrapeFailedAlert(const lt::scrape_failed_alert *alert)
+{
+    TorrentImpl *torrent = getTorrent(alert->handle);
+    if (!torrent || !torrent->isDormant())
+        return;
+
+    // the demand is unknown (e.g. the tracker doesn't support scrapes) so the torrent announces instead,
+    // it goes dormant again if there is still no demand after the idle time
+    wakeDormantSeed(torrent);
+}
+
 #ifdef QBT_USES_LIBTORRENT2
 void SessionImpl::handleTorrentConflictAlert(const lt::torrent_conflict_alert *alert)
 {
@@ -6456,7 +8803,7 @@ void SessionImpl::handleTorrentConflictAlert(const lt::torrent_conflict_alert *a
     }
 
     if (!torrent1 || !torrent2)
-        emit metadataDownloaded(TorrentInfo(*alert->metadata));
+        handleMetadataDownloaded(TorrentInfo(*alert->metadata));
 }
 
 void SessionImpl::handleFilePrioAlert(const lt::file_prio_alert *alert)
@@ -6480,33 +8827,44 @@ void SessionImpl::handleTorrentFinishedAlert([[maybe_unused]] const lt::torrent_
 
 void SessionImpl::handleSaveResumeDataAlert(lt::save_resume_data_alert *alert)
 {
-    // The torrent can be deleted between the time the resume data was requested and
-    // the time we received the appropriate alert. We have to decrease `m_numResumeData` anyway,
-    // so we do this before checking for an existing torrent.
-    --m_numResumeData;
+    const TraceSpan traceSpan {"SessionImpl::handleSaveResumeDataAlert"};
 
-    if (TorrentImpl *torrent = getTorrent(alert->handle)) [[likely]]
+    TorrentImpl *torrent = getTorrent(alert->handle);
+    handleResumeDataReceived(torrent);
+    if (torrent) [[likely]]
         torrent->handleSaveResumeData(std::move(alert->params));
 }
 
 void SessionImpl::handleSaveResumeDataFailedAlert(const lt::save_resume_data_failed_alert *alert)
 {
-    // The torrent can be deleted between the time the resume data was requested and
-    // the time we received the appropriate alert. We have to decrease `m_numResumeData` anyway,
-    // so we do this before checking for an existing torrent.
-    --m_numResumeData;
-
     TorrentImpl *torrent = getTorrent(alert->handle);
+    handleResumeDataReceived(torrent);
     if (!torrent) [[unlikely]]
         return;
 
-    if (alert->error != lt::errors::resume_data_not_modified)
+    if (alert->error == lt::errors::resume_data_not_modified)
+    {
+        torrent->handleSaveResumeDataNotModified();
+    }
+    else
     {
         LogMsg(tr("Generate resume data failed. Torrent: \"%1\". Reason: \"%2\"")
                 .arg(torrent->name(), Utils::String::fromLocal8Bit(alert->error.message())), Log::CRITICAL);
     }
 }
 
+void SessionImpl::handleResumeDataReceived(TorrentImpl *torrent)
+{
+    // The torrent can be deleted between the time the resume data was requested and
+    // the time we received the appropriate alert. We have to decrease `m_numResumeData` anyway.
+    // The resent requests (see handleAlertsDroppedAlert()) are answered only once.
+    if (torrent && !torrent->takeResumeDataRequest())
+        return;
+
+    if (m_numResumeData > 0)
+        --m_numResumeData;
+}
+
 void SessionImpl::handleFastResumeRejectedAlert(const lt::fastresume_rejected_alert *alert)
 {
     TorrentImpl *torrent = getTorrent(alert->handle);
@@ -6514,8 +8872,11 @@ void SessionImpl::handleFastResumeRejectedAlert(const lt::fastresume_rejected_al
         return;
 
     torrent->handleFastResumeRejected();
-    LogMsg(tr("Failed to restore torrent. Files were probably moved or storage isn't accessible. Torrent: \"%1\". Reason: \"%2\"")
-            .arg(torrent->name(), QString::fromStdString(alert->message())), Log::WARNING);
+    LogMsg(Log::Category::Storage, Log::WARNING, [torrent, alert]
+    {
+        return tr("Failed to restore torrent. Files were probably moved or storage isn't accessible. Torrent: \"%1\". Reason: \"%2\"")
+                .arg(torrent->name(), QString::fromStdString(alert->message()));
+    });
 }
 
 void SessionImpl::handleFileRenamedAlert(const lt::file_renamed_alert *alert)
@@ -6541,9 +8902,12 @@ void SessionImpl::handleFileRenameFailedAlert(const lt::file_rename_failed_alert
 
     torrent->handleFileRenameFailed(alert->index);
 
-    LogMsg(tr("File rename failed. Torrent: \"%1\", file: \"%2\", reason: \"%3\"")
-            .arg(torrent->name(), torrent->filePath(torrent->fileIndexFromNative(alert->index)).toString()
-                    , Utils::String::fromLocal8Bit(alert->error.message())), Log::WARNING);
+    LogMsg(Log::Category::Storage, Log::WARNING, [torrent, alert]
+    {
+        return tr("File rename failed. Torrent: \"%1\", file: \"%2\", reason: \"%3\"")
+                .arg(torrent->name(), torrent->filePath(torrent->fileIndexFromNative(alert->index)).toString()
+                        , Utils::String::fromLocal8Bit(alert->error.message()));
+    });
 }
 
 void SessionImpl::handleFileCompletedAlert(const lt::file_completed_alert *alert)
@@ -6552,10 +8916,24 @@ void SessionImpl::handleFileCompletedAlert(const lt::file_completed_alert *alert
         torrent->handleFileCompleted(alert->index);
 }
 
+void SessionImpl::handleReadPieceAlert(const lt::read_piece_alert *alert)
+{
+    TorrentImpl *const torrent = getTorrent(alert->handle);
+    if (!torrent) [[unlikely]]
+        return;
+
+    // the data is left empty if the piece can't be read, e.g. its deadline was reset before it was downloaded
+    const QByteArray data = alert->error ? QByteArray() : QByteArray(alert->buffer.get(), alert->size);
+    torrent->handlePieceRead(alert->piece, data);
+}
+
 void SessionImpl::handlePerformanceAlert(const lt::performance_alert *alert) const
 {
-    LogMsg((tr("Performance alert: %1. More info: %2").arg(QString::fromStdString(alert->message())
-            , u"https://libtorrent.org/reference-Alerts.html#enum-performance-warning-t"_s)), Log::INFO);
+    LogMsg(Log::Category::Performance, Log::INFO, [alert]
+    {
+        return tr("Performance alert: %1. More info: %2").arg(QString::fromStdString(alert->message())
+                , u"https://libtorrent.org/reference-Alerts.html#enum-performance-warning-t"_s);
+    });
 }
 
 void SessionImpl::saveStatistics() const
@@ -6582,27 +8960,138 @@ void SessionImpl::loadStatistics()
     m_previouslyUploaded = value[u"AlltimeUL"_s].toLongLong();
 }
 
-void SessionImpl::updateTrackerEntryStatuses(lt::torrent_handle torrentHandle)
+void SessionImpl::saveDHTState() const
+{
+    if (!isDHTEnabled())
+        return;
+
+#ifdef QBT_USES_LIBTORRENT2
+    const lt::session_params sessionState = primaryNativeSession()->session_state(lt::session::save_dht_state);
+    // The routing table is empty until the DHT is bootstrapped, the stored one is more useful in this case
+    if (sessionState.dht_state.nodes.empty() && sessionState.dht_state.nodes6.empty())
+        return;
+
+    const lt::entry state = lt::write_session_params(sessionState, lt::session::save_dht_state);
+#else
+    lt::entry state;
+    primaryNativeSession()->save_state(state, lt::session::save_dht_state);
+    // The routing table is empty until the DHT is bootstrapped, the stored one is more useful in this case
+    const lt::entry *dhtState = state.find_key("dht state");
+    if (!dhtState || (!dhtState->find_key("nodes") && !dhtState->find_key("nodes6")))
+        return;
+#endif
+
+    const Path path = specialFolderLocation(SpecialFolder::Data) / DHT_STATE_FILE_NAME;
+    if (const auto result = Utils::IO::saveToFile(path, state); !result)
+    {
+        LogMsg(tr("Failed to save DHT state. File: \"%1\". Error: \"%2\"")
+               .arg(path.toString(), result.error()), Log::WARNING);
+    }
+}
+
+void SessionImpl::loadDHTState(lt::session_params &sessionParams) const
 {
-    invokeAsync([this, torrentHandle = std::move(torrentHandle)]
+    const Path path = specialFolderLocation(SpecialFolder::Data) / DHT_STATE_FILE_NAME;
+    if (!path.exists())
+        return;
+
+    const int fileMaxSize = 4 * 1024 * 1024;
+    const auto readResult = Utils::IO::readFile(path, fileMaxSize);
+    if (!readResult)
     {
-        try
+        LogMsg(tr("Failed to load DHT state. %1").arg(readResult.error().message), Log::WARNING);
+        return;
+    }
+
+    const QByteArray &data = readResult.value();
+    lt::error_code ec;
+    const lt::bdecode_node root = lt::bdecode(lt::span<const char>(data.data(), data.size()), ec);
+    if (ec)
+    {
+        LogMsg(tr("Failed to parse DHT state. File: \"%1\". Error: \"%2\"")
+               .arg(path.toString(), QString::fromStdString(ec.message())), Log::WARNING);
+        return;
+    }
+
+    sessionParams.dht_state = lt::read_session_params(root, lt::session::save_dht_state).dht_state;
+}
+
+void SessionImpl::saveTorrentSnapshots() const
+{
+    // Snapshot of the previous session remains actual until all the torrents are loaded
+    if (!isRestored())
+        return;
+
+    QList<TorrentSnapshot> snapshots;
+    snapshots.reserve(m_torrents.size());
+    for (const TorrentImpl *torrent : asConst(m_torrents))
+        snapshots.append(makeTorrentSnapshot(torrent));
+
+    const Path path = specialFolderLocation(SpecialFolder::Data) / Path(u"torrents.snapshot"_s);
+    if (const auto result = BitTorrent::saveTorrentSnapshots(path, snapshots); !result)
+        LogMsg(tr("Failed to save torrents snapshot. Error: \"%1\"").arg(result.error()), Log::WARNING);
+}
+
+void SessionImpl::loadTorrentSnapshots()
+{
+    const Path path = specialFolderLocation(SpecialFolder::Data) / Path(u"torrents.snapshot"_s);
+    if (!path.exists())
+        return;
+
+    auto result = BitTorrent::loadTorrentSnapshots(path);
+    if (!result)
+    {
+        LogMsg(tr("Failed to load torrents snapshot. Error: \"%1\"").arg(result.error()), Log::WARNING);
+        return;
+    }
+
+    m_startupSnapshots = std::move(result.value());
+}
+
+void SessionImpl::updateTrackerEntryStatuses(QList<lt::torrent_handle> torrentHandles)
+{
+    invokeAsync([this, torrentHandles = std::move(torrentHandles)]
+    {
+        struct TorrentTrackersInfo
         {
-            std::vector<lt::announce_entry> nativeTrackers = torrentHandle.trackers();
+            TorrentID torrentID;
+            std::vector<lt::announce_entry> nativeTrackers;
+            QHash<std::string, QHash<lt::tcp::endpoint, QMap<int, int>>> updatedTrackers;
+        };
 
-            QMutexLocker updatedTrackerStatusesLocker {&m_updatedTrackerStatusesMutex};
-            QHash<std::string, QHash<lt::tcp::endpoint, QMap<int, int>>> updatedTrackers = m_updatedTrackerStatuses.take(torrentHandle);
-            updatedTrackerStatusesLocker.unlock();
+        std::vector<TorrentTrackersInfo> torrentsTrackersInfo;
+        torrentsTrackersInfo.reserve(torrentHandles.size());
+        for (const lt::torrent_handle &torrentHandle : torrentHandles)
+        {
+            try
+            {
+                torrentsTrackersInfo.push_back({.torrentID = torrentHandle.info_hash(), .nativeTrackers = torrentHandle.trackers(), .updatedTrackers = {}});
+            }
+            catch (const std::exception &)
+            {
+                torrentsTrackersInfo.push_back({});
+            }
+        }
 
-            invoke([this, infoHash = torrentHandle.info_hash(), nativeTrackers = std::move(nativeTrackers), updatedTrackers = std::move(updatedTrackers)]
+        QMutexLocker updatedTrackerStatusesLocker {&m_updatedTrackerStatusesMutex};
+        for (qsizetype i = 0; i < torrentHandles.size(); ++i)
+            torrentsTrackersInfo[i].updatedTrackers = m_updatedTrackerStatuses.take(torrentHandles[i]);
+        updatedTrackerStatusesLocker.unlock();
+
+        invoke([this, torrentsTrackersInfo = std::move(torrentsTrackersInfo)]
+        {
+            QHash<Torrent *, QHash<QString, TrackerEntryStatus>> updatedTorrentsTrackers;
+            updatedTorrentsTrackers.reserve(torrentsTrackersInfo.size());
+            for (const TorrentTrackersInfo &torrentTrackersInfo : torrentsTrackersInfo)
             {
-                TorrentImpl *torrent = m_torrents.value(infoHash);
+                TorrentImpl *torrent = m_torrents.value(torrentTrackersInfo.torrentID);
                 if (!torrent || torrent->isStopped())
-                    return;
+                    continue;
 
-                QHash<QString, TrackerEntryStatus> trackers;
+                const auto &updatedTrackers = torrentTrackersInfo.updatedTrackers;
+                QHash<QString, TrackerEntryStatus> &trackers = updatedTorrentsTrackers[torrent];
                 trackers.reserve(updatedTrackers.size());
-                for (const lt::announce_entry &announceEntry : nativeTrackers)
+                for (const lt::announce_entry &announceEntry : torrentTrackersInfo.nativeTrackers)
                 {
                     const auto updatedTrackersIter = updatedTrackers.find(announceEntry.url);
                     if (updatedTrackersIter == updatedTrackers.end())
@@ -6613,16 +9102,98 @@ void SessionImpl::updateTrackerEntryStatuses(lt::torrent_handle torrentHandle)
                     const QString url = status.url;
                     trackers.emplace(url, std::move(status));
                 }
+            }
 
-                emit trackerEntryStatusesUpdated(torrent, trackers);
-            });
-        }
-        catch (const std::exception &)
+            if (!updatedTorrentsTrackers.isEmpty())
+                enqueueTrackerEntryStatusesUpdate(updatedTorrentsTrackers);
+        });
+    });
+}
+
+void SessionImpl::updateTorrentsAvailability()
+{
+    QSet<TorrentID> torrentIDs;
+    for (const QSet<TorrentID> &watchedTorrentIDs : asConst(m_watchedTorrents))
+        torrentIDs.unite(watchedTorrentIDs);
+
+    // other torrents are updated in turns so that each of them is updated within the interval
+    if (m_availabilityUpdateQueue.isEmpty())
+        m_availabilityUpdateQueue = m_torrents.keys();
+    const qsizetype turnSize = std::min<qsizetype>(m_availabilityUpdateQueue.size()
+            , (((m_torrents.size() * refreshInterval()) / std::chrono::milliseconds(AVAILABILITY_UPDATE_INTERVAL).count()) + 1));
+    for (qsizetype i = 0; i < turnSize; ++i)
+        torrentIDs.insert(m_availabilityUpdateQueue.takeLast());
+
+    std::vector<lt::torrent_handle> torrentHandles;
+    torrentHandles.reserve(torrentIDs.size());
+    for (const TorrentID &torrentID : asConst(torrentIDs))
+    {
+        if (const TorrentImpl *torrent = m_torrents.value(torrentID); torrent && !torrent->isStopped())
+            torrentHandles.push_back(torrent->nativeHandle());
+    }
+
+    if (torrentHandles.empty())
+        return;
+
+    invokeAsync([this, torrentHandles = std::move(torrentHandles)]
+    {
+        std::vector<lt::torrent_status> statuses;
+        statuses.reserve(torrentHandles.size());
+        for (const lt::torrent_handle &torrentHandle : torrentHandles)
         {
+            try
+            {
+                statuses.push_back(torrentHandle.status(lt::torrent_handle::query_distributed_copies));
+            }
+            catch (const std::exception &) {}
         }
+
+        invoke([this, statuses = std::move(statuses)]
+        {
+            QList<Torrent *> updatedTorrents;
+            for (const lt::torrent_status &status : statuses)
+            {
+                TorrentImpl *torrent = getTorrent(status.handle);
+                if (torrent && torrent->updateAvailability(status))
+                    updatedTorrents.append(torrent);
+            }
+
+            if (!updatedTorrents.isEmpty())
+            {
+                emit torrentsUpdated(updatedTorrents);
+                for (Torrent *torrent : asConst(updatedTorrents))
+                    static_cast<TorrentImpl *>(torrent)->clearChangedFields();
+            }
+        });
     });
 }
 
+void SessionImpl::enqueueTrackerEntryStatusesUpdate(const QHash<Torrent *, QHash<QString, TrackerEntryStatus>> &updatedTrackers)
+{
+    for (auto iter = updatedTrackers.cbegin(); iter != updatedTrackers.cend(); ++iter)
+    {
+        QHash<QString, TrackerEntryStatus> &pendingTrackers = m_pendingTrackerEntryStatuses[iter.key()];
+        if (pendingTrackers.isEmpty())
+        {
+            pendingTrackers = iter.value();
+            continue;
+        }
+
+        // newer statuses replace the pending ones of the same trackers
+        for (auto trackersIter = iter->cbegin(); trackersIter != iter->cend(); ++trackersIter)
+            pendingTrackers.insert(trackersIter.key(), trackersIter.value());
+    }
+
+    if (!m_trackerEntryStatusesTimer->isActive())
+        m_trackerEntryStatusesTimer->start();
+}
+
+void SessionImpl::emitTrackerEntryStatusesUpdated()
+{
+    if (!m_pendingTrackerEntryStatuses.isEmpty())
+        emit trackerEntryStatusesUpdated(std::exchange(m_pendingTrackerEntryStatuses, {}));
+}
+
 void SessionImpl::handleRemovedTorrent(const TorrentID &torrentID, const QString &partfileRemoveError)
 {
     const auto removingTorrentDataIter = m_removingTorrents.constFind(torrentID);
@@ -6639,11 +9210,22 @@ void SessionImpl::handleRemovedTorrent(const TorrentID &torrentID, const QString
     if ((removingTorrentDataIter->removeOption == TorrentRemoveOption::RemoveContent)
             && !removingTorrentDataIter->contentStoragePath.isEmpty())
     {
-        QMetaObject::invokeMethod(m_torrentContentRemover, [this, jobData = *removingTorrentDataIter]
+        const TorrentContentRemovingJobInfo job {
+            .torrentID = torrentID,
+            .name = removingTorrentDataIter->name,
+            .path = removingTorrentDataIter->contentStoragePath,
+            .option = m_torrentContentRemoveOption,
+            .totalFiles = static_cast<int>(removingTorrentDataIter->fileNames.size())
+        };
+        m_contentRemovingJobs.append(job);
+
+        QMetaObject::invokeMethod(m_torrentContentRemover, [remover = m_torrentContentRemover, torrentID, jobData = *removingTorrentDataIter
+                , option = job.option]
         {
-            m_torrentContentRemover->performJob(jobData.name, jobData.contentStoragePath
-                    , jobData.fileNames, m_torrentContentRemoveOption);
+            remover->performJob(torrentID, jobData.name, jobData.contentStoragePath, jobData.fileNames, option);
         });
+
+        emit torrentContentRemovingJobUpdated(job);
     }
 
     m_removingTorrents.erase(removingTorrentDataIter);
@@ -31,14 +31,19 @@
 
 #include <chrono>
 #include <functional>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include <libtorrent/add_torrent_params.hpp>
+#include <libtorrent/address.hpp>
 #include <libtorrent/fwd.hpp>
+#include <libtorrent/ip_filter.hpp>
 #include <libtorrent/portmap.hpp>
 #include <libtorrent/torrent_handle.hpp>
 
 #include <QtContainerFwd>
+#include <QCache>
 #include <QElapsedTimer>
 #include <QHash>
 #include <QList>
@@ -52,23 +57,40 @@
 #include "base/settingvalue.h"
 #include "base/utils/thread.h"
 #include "addtorrentparams.h"
+#include "alertstatistics.h"
+#include "announcescheduler.h"
 #include "cachestatus.h"
 #include "categoryoptions.h"
+#include "dormantseedscheduler.h"
+#include "filenamefilter.h"
+#include "metadatadownloadscheduler.h"
+#include "movestoragejobinfo.h"
+#include "peerstatistics.h"
+#include "performancetuning.h"
 #include "session.h"
+#include "sessionmetric.h"
 #include "sessionstatus.h"
 #include "torrentinfo.h"
+#include "torrentsnapshot.h"
+#include "torrentstatustable.h"
+#include "trackerregistry.h"
+#include "unchokeslotscontroller.h"
 
+class QDeadlineTimer;
 class QString;
 class QTimer;
 class QUrl;
 
 template <typename T> class QFuture;
 
+class AsyncFileStorage;
 class BandwidthScheduler;
+class DiskReadCache;
 class FileSearcher;
 class FilterParserThread;
 class FreeDiskSpaceChecker;
 class NativeSessionExtension;
+class PersistentReadCache;
 
 struct FileSearchResult;
 
@@ -77,15 +99,19 @@ namespace BitTorrent
     enum class MoveStorageMode;
     enum class MoveStorageContext;
 
+    class DiskIOAccounting;
     class InfoHash;
     class ResumeDataStorage;
     class Torrent;
+    class FilePreallocator;
     class TorrentContentRemover;
+    class TorrentFileExporter;
     class TorrentDescriptor;
     class TorrentImpl;
     class Tracker;
 
     struct LoadTorrentParams;
+    struct TorrentCounters;
     struct TrackerEntry;
 
     struct SessionMetricIndices
@@ -108,6 +134,7 @@ namespace BitTorrent
         struct
         {
             int numPeersConnected = -1;
+            int numPeersUpUnchoked = -1;
             int numPeersUpDisk = -1;
             int numPeersDownDisk = -1;
         } peer;
@@ -211,6 +238,9 @@ namespace BitTorrent
         void setUnwantedFolderEnabled(bool enabled) override;
         int refreshInterval() const override;
         void setRefreshInterval(int value) override;
+        void addRefreshSubscriber(const QObject *subscriber, int interval = 0) override;
+        void removeRefreshSubscriber(const QObject *subscriber) override;
+        void setWatchedTorrents(const QObject *subscriber, const QSet<TorrentID> &torrentIDs) override;
         bool isPreallocationEnabled() const override;
         void setPreallocationEnabled(bool enabled) override;
         Path torrentExportDirectory() const override;
@@ -259,6 +289,14 @@ namespace BitTorrent
         void setEncryption(int state) override;
         int maxActiveCheckingTorrents() const override;
         void setMaxActiveCheckingTorrents(int val) override;
+        bool isDiskAwareCheckingEnabled() const override;
+        void setDiskAwareCheckingEnabled(bool enabled) override;
+        int maxActiveCheckingTorrentsPerVolume() const override;
+        void setMaxActiveCheckingTorrentsPerVolume(int val) override;
+        QHash<QString, int> checkingVolumeLimits() const override;
+        void setCheckingVolumeLimits(const QHash<QString, int> &limits) override;
+        CheckingQueueOrder checkingQueueOrder() const override;
+        void setCheckingQueueOrder(CheckingQueueOrder order) override;
         bool isI2PEnabled() const override;
         void setI2PEnabled(bool enabled) override;
         QString I2PAddress() const override;
@@ -301,6 +339,8 @@ namespace BitTorrent
         void setPeerTurnoverInterval(int val) override;
         int requestQueueSize() const override;
         void setRequestQueueSize(int val) override;
+        PerformanceProfile performanceProfile() const override;
+        void setPerformanceProfile(PerformanceProfile profile) override;
         int asyncIOThreads() const override;
         void setAsyncIOThreads(int num) override;
         int hashingThreads() const override;
@@ -313,10 +353,22 @@ namespace BitTorrent
         void setDiskCacheSize(int size) override;
         int diskCacheTTL() const override;
         void setDiskCacheTTL(int ttl) override;
+        int diskReadCacheSize() const override;
+        void setDiskReadCacheSize(int size) override;
+        Path persistentReadCachePath() const override;
+        void setPersistentReadCachePath(const Path &path) override;
+        int persistentReadCacheSize() const override;
+        void setPersistentReadCacheSize(int size) override;
+        int diskWriteCoalescingSize() const override;
+        void setDiskWriteCoalescingSize(int size) override;
+        int diskWriteCoalescingTime() const override;
+        void setDiskWriteCoalescingTime(int time) override;
         qint64 diskQueueSize() const override;
         void setDiskQueueSize(qint64 size) override;
         DiskIOType diskIOType() const override;
         void setDiskIOType(DiskIOType type) override;
+        int nativeSessionShards() const override;
+        void setNativeSessionShards(int shards) override;
         DiskIOReadMode diskIOReadMode() const override;
         void setDiskIOReadMode(DiskIOReadMode mode) override;
         DiskIOWriteMode diskIOWriteMode() const override;
@@ -373,7 +425,7 @@ namespace BitTorrent
         void setMaxConcurrentHTTPAnnounces(int value) override;
         bool isReannounceWhenAddressChangedEnabled() const override;
         void setReannounceWhenAddressChangedEnabled(bool enabled) override;
-        void reannounceToAllTrackers() const override;
+        void reannounceToAllTrackers() override;
         int stopTrackerTimeout() const override;
         void setStopTrackerTimeout(int value) override;
         int maxConnections() const override;
@@ -384,6 +436,14 @@ namespace BitTorrent
         void setMaxUploads(int max) override;
         int maxUploadsPerTorrent() const override;
         void setMaxUploadsPerTorrent(int max) override;
+        bool isUnchokeSlotsTuningEnabled() const override;
+        void setUnchokeSlotsTuningEnabled(bool enabled) override;
+        bool isDormantSeedsEnabled() const override;
+        void setDormantSeedsEnabled(bool enabled) override;
+        int dormantSeedIdleTime() const override;
+        void setDormantSeedIdleTime(int minutes) override;
+        int dormantSeedScrapeInterval() const override;
+        void setDormantSeedScrapeInterval(int minutes) override;
         int maxActiveDownloads() const override;
         void setMaxActiveDownloads(int max) override;
         int maxActiveUploads() const override;
@@ -419,14 +479,23 @@ namespace BitTorrent
         void setBannedIPs(const QStringList &newList) override;
         ResumeDataStorageType resumeDataStorageType() const override;
         void setResumeDataStorageType(ResumeDataStorageType type) override;
+        int resumeDataStorageBatchSize() const override;
+        void setResumeDataStorageBatchSize(int size) override;
+        bool isResumeDataStorageCompressionEnabled() const override;
+        void setResumeDataStorageCompressionEnabled(bool enabled) override;
+        bool isStoppedTorrentsColdModeEnabled() const override;
+        void setStoppedTorrentsColdModeEnabled(bool enabled) override;
         bool isMergeTrackersEnabled() const override;
         void setMergeTrackersEnabled(bool enabled) override;
         bool isStartPaused() const override;
         void setStartPaused(bool value) override;
         TorrentContentRemoveOption torrentContentRemoveOption() const override;
         void setTorrentContentRemoveOption(TorrentContentRemoveOption option) override;
+        int torrentContentRemovingRate() const override;
+        void setTorrentContentRemovingRate(int filesPerSecond) override;
 
         bool isRestored() const override;
+        QList<TorrentSnapshot> startupSnapshots() const override;
 
         bool isPaused() const override;
         void pause() override;
@@ -435,9 +504,19 @@ namespace BitTorrent
         Torrent *getTorrent(const TorrentID &id) const override;
         Torrent *findTorrent(const InfoHash &infoHash) const override;
         QList<Torrent *> torrents() const override;
+        const TorrentStatusTable &torrentStatusTable() const override;
         qsizetype torrentsCount() const override;
+        qint64 estimatedTorrentsMemoryUsage() const override;
         const SessionStatus &status() const override;
         const CacheStatus &cacheStatus() const override;
+        const AlertStatistics &alertStatistics() const override;
+        PeerStatistics peerStatistics() const override;
+        DiskIOStatistics torrentDiskIOStatistics(const TorrentID &id) const override;
+        QHash<QString, DiskIOStatistics> volumeDiskIOStatistics() const override;
+        const QList<SessionMetric> &sessionMetrics() const override;
+        int pendingResumeDataCount() const override;
+        QList<MoveStorageJobInfo> moveStorageJobs() const override;
+        QList<TorrentContentRemovingJobInfo> torrentContentRemovingJobs() const override;
         bool isListening() const override;
 
         void banIP(const QString &ip) override;
@@ -445,7 +524,10 @@ namespace BitTorrent
         bool isKnownTorrent(const InfoHash &infoHash) const override;
         bool addTorrent(const TorrentDescriptor &torrentDescr, const AddTorrentParams &params = {}) override;
         bool removeTorrent(const TorrentID &id, TorrentRemoveOption deleteOption = TorrentRemoveOption::KeepContent) override;
-        bool downloadMetadata(const TorrentDescriptor &torrentDescr) override;
+        int maxActiveMetadataDownloads() const override;
+        void setMaxActiveMetadataDownloads(int val) override;
+        bool downloadMetadata(const TorrentDescriptor &torrentDescr
+                , MetadataDownloadPriority priority = MetadataDownloadPriority::Normal) override;
         bool cancelDownloadMetadata(const TorrentID &id) override;
 
         void increaseTorrentsQueuePos(const QList<TorrentID> &ids) override;
@@ -457,8 +539,15 @@ namespace BitTorrent
         QString lastExternalIPv6Address() const override;
 
         qint64 freeDiskSpace() const override;
+        QList<StorageVolumeInfo> storageVolumes() const override;
+        int lowDiskSpaceThreshold() const override;
+        void setLowDiskSpaceThreshold(int size) override;
+
+        void beginBulkUpdate() override;
+        void endBulkUpdate() override;
 
         // Torrent interface
+        void deferTorrentResumeDataRequest(TorrentImpl *torrent);
         void handleTorrentResumeDataRequested(const TorrentImpl *torrent);
         void handleTorrentShareLimitChanged(TorrentImpl *torrent);
         void handleTorrentNameChanged(TorrentImpl *torrent);
@@ -478,6 +567,8 @@ namespace BitTorrent
         void handleTorrentUrlSeedsAdded(TorrentImpl *torrent, const QList<QUrl> &newUrlSeeds);
         void handleTorrentUrlSeedsRemoved(TorrentImpl *torrent, const QList<QUrl> &urlSeeds);
         void handleTorrentResumeDataReady(TorrentImpl *torrent, LoadTorrentParams data);
+        void handleTorrentCountersReady(const TorrentImpl *torrent, const TorrentCounters &counters);
+        void handleTorrentPeerStatisticsUpdated(const PeerStatistics &statistics);
         void handleTorrentInfoHashChanged(TorrentImpl *torrent, const InfoHash &prevInfoHash);
         void handleTorrentStorageMovingStateChanged(TorrentImpl *torrent);
 
@@ -485,6 +576,17 @@ namespace BitTorrent
 
         lt::torrent_handle reloadTorrent(const lt::torrent_handle &currentHandle, lt::add_torrent_params params);
 
+        // Tracker URLs and messages shared by the torrents, it is accessed from the main thread only
+        TrackerRegistry &trackerRegistry();
+        // Forced announces of all the torrents are paced per tracker host
+        void reannounce(const TorrentImpl *torrent, int index, lt::reannounce_flags_t flags = {});
+
+        // Return the values sharing their data with the equal ones already used in the session,
+        // so the torrents don't keep separate copies of the same paths, categories and tags
+        Path internTorrentPath(const Path &path);
+        QString internCategory(const QString &category) const;
+        Tag internTag(const Tag &tag) const;
+
         QFuture<FileSearchResult> findIncompleteFiles(const Path &savePath, const Path &downloadPath, const PathList &filePaths = {}) const;
 
         void enablePortMapping();
@@ -517,10 +619,14 @@ namespace BitTorrent
         void configureDeferred();
         void readAlerts();
         void enqueueRefresh();
+        void refresh();
         void generateResumeData();
         void handleIPFilterParsed(int ruleCount);
         void handleIPFilterError();
-        void torrentContentRemovingFinished(const QString &torrentName, const QString &errorMessage);
+        void handleTorrentContentRemovingProgress(const TorrentID &torrentID, int removedFiles, int totalFiles);
+        void handleTorrentContentRemovingFinished(const TorrentID &torrentID, const QString &torrentName, const QString &errorMessage);
+        void handleFilePreallocationProgress(const TorrentID &torrentID, qint64 allocatedBytes, qint64 totalBytes);
+        void handleFilePreallocationFinished(const TorrentID &torrentID, const QString &errorMessage);
         void applySpeedProfile(const QString &profileName);
 
     private:
@@ -532,6 +638,21 @@ namespace BitTorrent
             Path path;
             MoveStorageMode mode {};
             MoveStorageContext context {};
+            Path sourcePath;
+            QString sourceVolume;
+            QString destinationVolume;
+            qint64 size = 0;
+            QElapsedTimer timer;
+            bool isActive = false;
+        };
+
+        struct CheckingTorrentData
+        {
+            QString volume;
+            // waits for its turn in the queue of libtorrent
+            bool isWaiting = false;
+            // is allowed to be checked by the scheduler
+            bool isScheduled = false;
         };
 
         struct RemovingTorrentData
@@ -542,6 +663,32 @@ namespace BitTorrent
             TorrentRemoveOption removeOption {};
         };
 
+        struct ShareLimitsCheck
+        {
+            quint64 serial = 0;
+            qint64 deadline = 0;
+            // Total upload at which the ratio limit can be reached, or -1 if there is no ratio limit
+            qint64 uploadThreshold = -1;
+        };
+
+        struct ShareLimitsCheckQueueEntry
+        {
+            qint64 deadline = 0;
+            quint64 serial = 0;
+            TorrentImpl *torrent = nullptr;
+        };
+
+        // Changes made within bulk update, they are notified at its end
+        struct BulkUpdateChanges
+        {
+            QHash<TorrentImpl *, QString> categories;  // with category before the first change
+            QHash<TorrentImpl *, QHash<Tag, bool>> tags;  // with presence of the tag before the first change
+            QSet<TorrentImpl *> savePaths;
+            QSet<TorrentImpl *> savingModes;
+            QHash<TorrentImpl *, QHash<QString, bool>> trackers;  // with presence of the tracker before the first change
+            QSet<TorrentImpl *> replacedTrackers;  // it supersedes the individual tracker changes
+        };
+
         explicit SessionImpl(QObject *parent = nullptr);
         ~SessionImpl();
 
@@ -555,10 +702,20 @@ namespace BitTorrent
         void initializeNativeSession();
         lt::settings_pack loadLTSettings() const;
         void applyNetworkInterfacesSettings(lt::settings_pack &settingsPack) const;
+        PerformanceSettings performanceSettings() const;
+        void applyPerformanceSettings(lt::settings_pack &settingsPack) const;
+        void updateAutoTunedPerformanceSettings();
+        void applyUnchokeSlotsLimits();
+        int alertQueueSize() const;
+        void applyAlertQueueSize(int size);
         void configurePeerClasses();
         void initMetrics();
         void applyBandwidthLimits();
         void processBannedIPs(lt::ip_filter &filter);
+        void applyIPFilter();
+        void applyPendingBannedIPs();
+        void enqueueTrackerEntryStatusesUpdate(const QHash<Torrent *, QHash<QString, TrackerEntryStatus>> &updatedTrackers);
+        void emitTrackerEntryStatusesUpdated();
         QStringList getListeningIPs() const;
         void configureListeningInterface();
         void enableTracker(bool enable);
@@ -567,7 +724,10 @@ namespace BitTorrent
         void enableIPFilter();
         void disableIPFilter();
         void processTorrentShareLimits(TorrentImpl *torrent);
-        void populateExcludedFileNamesRegExpList();
+        void scheduleTorrentShareLimitsCheck(TorrentImpl *torrent, qint64 delay, qint64 uploadThreshold = -1);
+        void scheduleAllTorrentsShareLimitsCheck();
+        void processDueTorrentsShareLimits();
+        void populateExcludedFileNamesFilter();
         void prepareStartup();
         void handleLoadedResumeData(ResumeSessionContext *context);
         void processNextResumeData(ResumeSessionContext *context);
@@ -578,10 +738,13 @@ namespace BitTorrent
 
         void updateSeedingLimitTimer();
         void exportTorrentFile(const Torrent *torrent, const Path &folderPath);
+        void preallocateFiles(TorrentImpl *torrent);
+        void cancelFilePreallocation(const TorrentID &id);
 
         void handleAlert(lt::alert *alert);
         void handleAddTorrentAlert(const lt::add_torrent_alert *alert);
         void handleStateUpdateAlert(const lt::state_update_alert *alert);
+        void applyCategoryLimits();
         void handleMetadataReceivedAlert(const lt::metadata_received_alert *alert);
         void handleFileErrorAlert(const lt::file_error_alert *alert);
         void handleTorrentRemovedAlert(const lt::torrent_removed_alert *alert);
@@ -590,7 +753,6 @@ namespace BitTorrent
         void handleTorrentNeedCertAlert(const lt::torrent_need_cert_alert *alert);
         void handlePortmapWarningAlert(const lt::portmap_error_alert *alert);
         void handlePortmapAlert(const lt::portmap_alert *alert);
-        void handlePeerBlockedAlert(const lt::peer_blocked_alert *alert);
         void handlePeerBanAlert(const lt::peer_ban_alert *alert);
         void handleUrlSeedAlert(const lt::url_seed_alert *alert);
         void handleListenSucceededAlert(const lt::listen_succeeded_alert *alert);
@@ -598,23 +760,27 @@ namespace BitTorrent
         void handleExternalIPAlert(const lt::external_ip_alert *alert);
         void handleSessionErrorAlert(const lt::session_error_alert *alert) const;
         void handleSessionStatsAlert(const lt::session_stats_alert *alert);
-        void handleAlertsDroppedAlert(const lt::alerts_dropped_alert *alert) const;
+        void handleAlertsDroppedAlert(const lt::alerts_dropped_alert *alert);
         void handleStorageMovedAlert(const lt::storage_moved_alert *alert);
         void handleStorageMovedFailedAlert(const lt::storage_moved_failed_alert *alert);
         void handleSocks5Alert(const lt::socks5_alert *alert) const;
         void handleI2PAlert(const lt::i2p_alert *alert) const;
         void handleTrackerAlert(const lt::tracker_alert *alert);
+        void handleScrapeReplyAlert(const lt::scrape_reply_alert *alert);
+        void handleScrapeFailedAlert(const lt::scrape_failed_alert *alert);
 #ifdef QBT_USES_LIBTORRENT2
         void handleTorrentConflictAlert(const lt::torrent_conflict_alert *alert);
         void handleFilePrioAlert(const lt::file_prio_alert *alert);
 #endif
         void handleFastResumeRejectedAlert(const lt::fastresume_rejected_alert *alert);
         void handleFileCompletedAlert(const lt::file_completed_alert *alert);
+        void handleReadPieceAlert(const lt::read_piece_alert *alert);
         void handleFileRenamedAlert(const lt::file_renamed_alert *alert);
         void handleFileRenameFailedAlert(const lt::file_rename_failed_alert *alert);
         void handlePerformanceAlert(const lt::performance_alert *alert) const;
         void handleSaveResumeDataAlert(lt::save_resume_data_alert *alert);
         void handleSaveResumeDataFailedAlert(const lt::save_resume_data_failed_alert *alert);
+        void handleResumeDataReceived(TorrentImpl *torrent);
         void handleTorrentCheckedAlert(const lt::torrent_checked_alert *alert);
         void handleTorrentFinishedAlert(const lt::torrent_finished_alert *alert);
 
@@ -622,31 +788,65 @@ namespace BitTorrent
         TorrentImpl *getTorrent(const lt::torrent_handle &nativeHandle) const;
         QList<TorrentImpl *> getQueuedTorrentsByID(const QList<TorrentID> &torrentIDs) const;
 
-        void saveResumeData();
+        void saveResumeData(const QDeadlineTimer &deadline);
+        void releaseStoppedTorrentsMetadata();
+        void processDormantSeeds();
+        void wakeDormantSeed(TorrentImpl *torrent);
         void saveTorrentsQueue();
+        void processDeferredResumeDataRequests();
+        void scheduleActualFilePathsUpdate();
+        void processActualFilePathsUpdates();
+        void notifyBulkUpdateChanges();
+        void notifyBulkUpdateChanges(TorrentImpl *torrent);
         void removeTorrentsQueue();
 
         void populateAdditionalTrackersFromURL();
 
+        lt::session *primaryNativeSession() const;
+        qsizetype nativeSessionIndexFor(const lt::add_torrent_params &params) const;
+        lt::session *nativeSessionOf(const lt::torrent_handle &nativeHandle) const;
+        void applyNativeSettings(lt::settings_pack settingsPack) const;
+
         void fetchPendingAlerts(lt::time_duration time = lt::time_duration::zero());
         void endAlertSequence(int alertType, qsizetype alertCount);
 
-        void moveTorrentStorage(const MoveStorageJob &job) const;
-        void handleMoveTorrentStorageJobFinished(const Path &newPath);
+        void moveTorrentStorage(MoveStorageJob &job) const;
+        void startMoveStorageJobs();
+        MoveStorageJobInfo toMoveStorageJobInfo(const MoveStorageJob &job, MoveStorageJobState state) const;
+        void handleMoveTorrentStorageJobFinished(const lt::torrent_handle &torrentHandle, const Path &newPath, bool isSucceeded);
+        bool updateCheckingTorrent(TorrentImpl *torrent);
+        void updateCheckingStatus();
+        void loadCheckingTorrents();
+        void scheduleTorrentChecks();
         void processPendingFinishedTorrents();
+        void processBlockedPeers();
 
         void loadCategories();
-        void storeCategories() const;
+        void storeCategories();
+        void storeCategoriesDeferred();
         void upgradeCategories();
         DownloadPathOption resolveCategoryDownloadPathOption(const QString &categoryName, const std::optional<DownloadPathOption> &option) const;
+        void invalidateCategoryPathsCache();
 
         void saveStatistics() const;
         void loadStatistics();
+        void startQueuedMetadataDownloads();
+        void expireMetadataDownloads();
+        void handleMetadataDownloaded(const TorrentInfo &metadata);
+        void saveDHTState() const;
+        void loadDHTState(lt::session_params &sessionParams) const;
+        void saveTorrentSnapshots() const;
+        void loadTorrentSnapshots();
 
-        void updateTrackerEntryStatuses(lt::torrent_handle torrentHandle);
+        void updateTrackerEntryStatuses(QList<lt::torrent_handle> torrentHandles);
+        void updateTorrentsAvailability();
 
         void handleRemovedTorrent(const TorrentID &torrentID, const QString &partfileRemoveError = {});
 
+        void checkFreeDiskSpace();
+        PathList storageVolumePaths() const;
+        void handleStorageVolumesChecked(const QHash<Path, QString> &pathVolumes, const QHash<QString, qint64> &volumeFreeSpace);
+
         void setAdditionalTrackersFromURL(const QString &trackers);
         void updateTrackersFromURL();
 
@@ -659,14 +859,21 @@ namespace BitTorrent
         CachedSettingValue<Path> m_IPFilterFile;
         CachedSettingValue<bool> m_announceToAllTrackers;
         CachedSettingValue<bool> m_announceToAllTiers;
+        CachedSettingValue<PerformanceProfile> m_performanceProfile;
         CachedSettingValue<int> m_asyncIOThreads;
         CachedSettingValue<int> m_hashingThreads;
         CachedSettingValue<int> m_filePoolSize;
         CachedSettingValue<int> m_checkingMemUsage;
         CachedSettingValue<int> m_diskCacheSize;
         CachedSettingValue<int> m_diskCacheTTL;
+        CachedSettingValue<int> m_diskReadCacheSize;
+        CachedSettingValue<Path> m_persistentReadCachePath;
+        CachedSettingValue<int> m_persistentReadCacheSize;
+        CachedSettingValue<int> m_diskWriteCoalescingSize;
+        CachedSettingValue<int> m_diskWriteCoalescingTime;
         CachedSettingValue<qint64> m_diskQueueSize;
         CachedSettingValue<DiskIOType> m_diskIOType;
+        CachedSettingValue<int> m_nativeSessionShards;
         CachedSettingValue<DiskIOReadMode> m_diskIOReadMode;
         CachedSettingValue<DiskIOWriteMode> m_diskIOWriteMode;
         CachedSettingValue<bool> m_coalesceReadWriteEnabled;
@@ -703,6 +910,10 @@ namespace BitTorrent
         CachedSettingValue<int> m_maxUploads;
         CachedSettingValue<int> m_maxConnectionsPerTorrent;
         CachedSettingValue<int> m_maxUploadsPerTorrent;
+        CachedSettingValue<bool> m_isUnchokeSlotsTuningEnabled;
+        CachedSettingValue<bool> m_isDormantSeedsEnabled;
+        CachedSettingValue<int> m_dormantSeedIdleTime;
+        CachedSettingValue<int> m_dormantSeedScrapeInterval;
         CachedSettingValue<BTProtocol> m_btProtocol;
         CachedSettingValue<bool> m_isUTPRateLimited;
         CachedSettingValue<MixedModeAlgorithm> m_utpMixedMode;
@@ -747,6 +958,11 @@ namespace BitTorrent
         CachedSettingValue<QString> m_networkInterfaceAddress;
         CachedSettingValue<int> m_encryption;
         CachedSettingValue<int> m_maxActiveCheckingTorrents;
+        CachedSettingValue<bool> m_isDiskAwareCheckingEnabled;
+        CachedSettingValue<int> m_maxActiveCheckingTorrentsPerVolume;
+        CachedSettingValue<QVariantHash> m_checkingVolumeLimits;
+        CachedSettingValue<CheckingQueueOrder> m_checkingQueueOrder;
+        CachedSettingValue<int> m_maxActiveMetadataDownloads;
         CachedSettingValue<bool> m_isProxyPeerConnectionsEnabled;
         CachedSettingValue<ChokingAlgorithm> m_chokingAlgorithm;
         CachedSettingValue<SeedChokingAlgorithm> m_seedChokingAlgorithm;
@@ -770,6 +986,9 @@ namespace BitTorrent
         CachedSettingValue<QStringList> m_excludedFileNames;
         CachedSettingValue<QStringList> m_bannedIPs;
         CachedSettingValue<ResumeDataStorageType> m_resumeDataStorageType;
+        CachedSettingValue<int> m_resumeDataStorageBatchSize;
+        CachedSettingValue<bool> m_isResumeDataStorageCompressionEnabled;
+        CachedSettingValue<bool> m_isStoppedTorrentsColdModeEnabled;
         CachedSettingValue<bool> m_isMergeTrackersEnabled;
         CachedSettingValue<bool> m_isI2PEnabled;
         CachedSettingValue<QString> m_I2PAddress;
@@ -780,10 +999,13 @@ namespace BitTorrent
         CachedSettingValue<int> m_I2PInboundLength;
         CachedSettingValue<int> m_I2POutboundLength;
         CachedSettingValue<TorrentContentRemoveOption> m_torrentContentRemoveOption;
+        CachedSettingValue<int> m_torrentContentRemovingRate;
+        CachedSettingValue<int> m_lowDiskSpaceThreshold;
         SettingValue<bool> m_startPaused;
 
-        lt::session *m_nativeSession = nullptr;
-        NativeSessionExtension *m_nativeSessionExtension = nullptr;
+        // The torrents are distributed between the sessions, the first one also serves DHT and port mapping
+        QList<lt::session *> m_nativeSessions;
+        QList<NativeSessionExtension *> m_nativeSessionExtensions;
 
         bool m_deferredConfigureScheduled = false;
         bool m_IPFilteringConfigured = false;
@@ -793,6 +1015,7 @@ namespace BitTorrent
         QTimer *m_updateTrackersFromURLTimer = nullptr;
 
         bool m_isRestored = false;
+        QList<TorrentSnapshot> m_startupSnapshots;
         bool m_isPaused = isStartPaused();
 
         // Order is important. This needs to be declared after its CachedSettingsValue
@@ -801,9 +1024,10 @@ namespace BitTorrent
         const bool m_wasPexEnabled = m_isPeXEnabled;
 
         int m_numResumeData = 0;
+        mutable int m_alertQueueSize = 0;
         QList<TrackerEntry> m_additionalTrackerEntries;
         QList<TrackerEntry> m_additionalTrackerEntriesFromURL;
-        QList<QRegularExpression> m_excludedFileNamesRegExpList;
+        FileNameFilter m_excludedFileNamesFilter;
 
         // Statistics
         mutable QElapsedTimer m_statisticsLastUpdateTimer;
@@ -813,34 +1037,93 @@ namespace BitTorrent
 
         bool m_torrentsQueueChanged = false;
         bool m_needSaveTorrentsQueue = false;
+
+        QList<QPointer<TorrentImpl>> m_deferredResumeDataRequests;
+        bool m_isDeferredResumeDataRequestsInvoked = false;
+
+        // Torrents which actual file paths don't follow the changed options yet
+        QList<QPointer<TorrentImpl>> m_actualFilePathsUpdateQueue;
+        qsizetype m_actualFilePathsUpdateCount = 0;
+        int m_actualFilePathsUpdateProgress = 0;
+        QTimer *m_actualFilePathsUpdateTimer = nullptr;
+
+        int m_bulkUpdateLevel = 0;
+        BulkUpdateChanges m_bulkUpdateChanges;
         bool m_refreshEnqueued = false;
+        QTimer *m_refreshTimer = nullptr;
+        QHash<const QObject *, int> m_refreshSubscribers;
+        QHash<const QObject *, QSet<TorrentID>> m_watchedTorrents;
+        QList<TorrentID> m_availabilityUpdateQueue;
+        int m_idleRefreshInterval = 0;
         QTimer *m_seedingLimitTimer = nullptr;
+        // Torrents are only re-evaluated against their share limits when they can reach them
+        QHash<TorrentImpl *, ShareLimitsCheck> m_shareLimitsChecks;
+        // Min-heap of share limits check deadlines. It can contain outdated entries which are skipped.
+        std::vector<ShareLimitsCheckQueueEntry> m_shareLimitsCheckQueue;
+        quint64 m_shareLimitsCheckSerial = 0;
+        QElapsedTimer m_shareLimitsClock;
         QTimer *m_resumeDataTimer = nullptr;
         // IP filtering
         QPointer<FilterParserThread> m_filterParser;
+        // The filter loaded from the IP filter file and the one installed in the session (i.e. combined with
+        // banned IPs) are kept separately, so banned IPs can be added without rebuilding the whole filter
+        lt::ip_filter m_fileIPFilter;
+        lt::ip_filter m_IPFilter;
+        QList<lt::address> m_pendingBannedIPs;
+        bool m_isIPFilterRebuildNeeded = false;
+        QTimer *m_bannedIPsTimer = nullptr;
+        // Tracker entry statuses are reported to the consumers in batches
+        QHash<Torrent *, QHash<QString, TrackerEntryStatus>> m_pendingTrackerEntryStatuses;
+        QTimer *m_trackerEntryStatusesTimer = nullptr;
         QPointer<BandwidthScheduler> m_bwScheduler;
         // Tracker
         QPointer<Tracker> m_tracker;
 
         Utils::Thread::UniquePtr m_ioThread;
+        // Removing the content may take long so it doesn't delay the other IO jobs
+        Utils::Thread::UniquePtr m_contentRemovingThread;
+        // Preallocating the files may take long so it doesn't delay the other IO jobs
+        Utils::Thread::UniquePtr m_preallocationThread;
         QThreadPool *m_asyncWorker = nullptr;
         ResumeDataStorage *m_resumeDataStorage = nullptr;
         FileSearcher *m_fileSearcher = nullptr;
         TorrentContentRemover *m_torrentContentRemover = nullptr;
+        TorrentFileExporter *m_torrentFileExporter = nullptr;
+        FilePreallocator *m_filePreallocator = nullptr;
+        // New torrents whose files are preallocated in background once they have the metadata
+        QSet<TorrentID> m_torrentsToPreallocate;
+        std::shared_ptr<DiskIOAccounting> m_diskIOAccounting;
+#ifdef QBT_USES_LIBTORRENT2
+        std::shared_ptr<DiskReadCache> m_diskReadCache;
+        std::shared_ptr<PersistentReadCache> m_persistentReadCache;
+#endif
 
         using AddTorrentAlertHandler = std::function<void (const lt::add_torrent_alert *alert)>;
-        QList<AddTorrentAlertHandler> m_addTorrentAlertHandlers;
+        QList<QList<AddTorrentAlertHandler>> m_addTorrentAlertHandlers;
 
         QHash<TorrentID, lt::torrent_handle> m_downloadedMetadata;
+        // Metadata downloads waiting for a slot of the scheduler
+        QHash<TorrentID, lt::add_torrent_params> m_queuedMetadataDownloads;
+        MetadataDownloadScheduler m_metadataDownloadScheduler;
+        QElapsedTimer m_metadataDownloadClock;
+        QTimer *m_metadataDownloadExpiryTimer = nullptr;
+        // Recently downloaded metadata, so repeated requests are answered right away
+        QCache<TorrentID, TorrentInfo> m_downloadedMetadataCache;
 
         QHash<TorrentID, TorrentImpl *> m_torrents;
+        TorrentStatusTable m_torrentStatusTable;
         QHash<TorrentID, TorrentImpl *> m_hybridTorrentsByAltID;
         QHash<TorrentID, RemovingTorrentData> m_removingTorrents;
+        QList<TorrentContentRemovingJobInfo> m_contentRemovingJobs;
         QHash<TorrentID, TorrentID> m_changedTorrentIDs;
         QMap<QString, CategoryOptions> m_categories;
+        // Resolved paths of the existing categories, they are cleared when the categories or default paths are changed
+        mutable QHash<QString, Path> m_categorySavePathsCache;
+        mutable QHash<QString, Path> m_categoryDownloadPathsCache;
         TagSet m_tags;
 
         std::vector<lt::alert *> m_alerts;  // make it a class variable so it can preserve its allocated `capacity`
+        std::vector<lt::alert *> m_shardAlerts;
         qsizetype m_receivedAddTorrentAlertsCount = 0;
         QList<Torrent *> m_loadedTorrents;
 
@@ -848,18 +1131,46 @@ namespace BitTorrent
         // (torrent.tracker_name.tracker_local_endpoint.protocol_version.num_peers)
         QHash<lt::torrent_handle, QHash<std::string, QHash<lt::tcp::endpoint, QMap<int, int>>>> m_updatedTrackerStatuses;
         QMutex m_updatedTrackerStatusesMutex;
+        // Torrents whose tracker statuses should be updated after current alerts batch is handled
+        QList<lt::torrent_handle> m_pendingTrackerStatusesUpdates;
+        TrackerRegistry m_trackerRegistry;
+        AnnounceScheduler m_announceScheduler;
+        QHash<QString, Path> m_torrentPaths;
+        qsizetype m_torrentPathsPruneThreshold = 0;
+        bool m_categoryLimitsApplied = false;
 
         // I/O errored torrents
         QSet<TorrentID> m_recentErroredTorrents;
         QTimer *m_recentErroredTorrentsTimer = nullptr;
 
         SessionMetricIndices m_metricIndices;
+        QList<SessionMetric> m_sessionMetrics;
         lt::time_point m_statsLastTimestamp = lt::clock_type::now();
 
+        PerformanceSettings m_autoTunedPerformanceSettings;
+        // Peak of the observed transfer rate, it decays slowly to follow the load
+        qint64 m_observedPeakRate = 0;
+        QTimer *m_performanceTuningTimer = nullptr;
+        QTimer *m_dhtStateSavingTimer = nullptr;
+
+        UnchokeSlotsController m_unchokeSlotsController;
+
+        DormantSeedScheduler m_dormantSeedScheduler;
+        QElapsedTimer m_dormantSeedsClock;
+        QTimer *m_dormantSeedsTimer = nullptr;
+
         SessionStatus m_status;
         CacheStatus m_cacheStatus;
+        AlertStatistics m_alertStatistics;
+        // Totals of the peer statistics of all the torrents
+        PeerStatistics m_peerStatistics;
 
         QList<MoveStorageJob> m_moveStorageQueue;
+        QList<MoveStorageJobInfo> m_finishedMoveStorageJobs;
+        QHash<TorrentImpl *, CheckingTorrentData> m_checkingTorrents;
+        // Torrents usually share a few save paths, so their volumes are resolved once
+        // per checking session (i.e. until there are no more checking torrents)
+        QHash<Path, QString> m_checkingVolumesCache;
 
         QString m_lastExternalIPv4Address;
         QString m_lastExternalIPv6Address;
@@ -879,6 +1190,13 @@ namespace BitTorrent
         FreeDiskSpaceChecker *m_freeDiskSpaceChecker = nullptr;
         QTimer *m_freeDiskSpaceCheckingTimer = nullptr;
         qint64 m_freeDiskSpace = -1;
+        QList<StorageVolumeInfo> m_storageVolumes;
+        // Stopped due to low free space, they are started again once there is enough of it
+        QSet<TorrentID> m_lowDiskSpaceStoppedTorrents;
+
+        // Categories are stored with delay so that the bulk changes are written at once
+        AsyncFileStorage *m_categoriesStorage = nullptr;
+        QTimer *m_categoriesStoringTimer = nullptr;
 
         friend void Session::initInstance();
         friend void Session::freeInstance();
@@ -73,5 +73,13 @@ namespace BitTorrent
         qint64 diskWriteQueue = 0;
         qint64 dhtNodes = 0;
         qint64 peersCount = 0;
+
+        // Aggregate of the torrents being checked (including the ones waiting to be checked).
+        // The amount of checked data (so the rate) is known with libtorrent 2 only.
+        qint64 checkingTorrentsCount = 0;
+        qint64 totalChecked = 0;
+        qint64 checkingRate = 0;
+        qint64 checkingRemaining = 0;
+        qint64 checkingETA = 0;
     };
 }
@@ -0,0 +1,178 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "sparsequeuepositions.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+namespace
+{
+    const qint64 NO_POSITION = -1;
+}
+
+using namespace BitTorrent;
+
+SparseQueuePositions::SparseQueuePositions(const QHash<TorrentID, qint64> &positions)
+{
+    m_positions.reserve(positions.size());
+    for (auto it = positions.cbegin(); it != positions.cend(); ++it)
+    {
+        if (it.value() >= 0)
+            m_positions.insert(it.key(), it.value());
+    }
+}
+
+qint64 SparseQueuePositions::position(const TorrentID &id) const
+{
+    return m_positions.value(id, NO_POSITION);
+}
+
+void SparseQueuePositions::remove(const TorrentID &id)
+{
+    m_positions.remove(id);
+}
+
+QList<std::pair<TorrentID, qint64>> SparseQueuePositions::update(const QList<TorrentID> &queue)
+{
+    QList<TorrentID> ids;
+    ids.reserve(queue.size());
+    for (const TorrentID &id : queue)
+    {
+        if (id.isValid())
+            ids.append(id);
+    }
+
+    const auto count = static_cast<std::size_t>(ids.size());
+    std::vector<qint64> keys;
+    keys.reserve(count);
+    for (const TorrentID &id : ids)
+        keys.push_back(position(id));
+
+    // Find the longest sequence of the torrents which keys are already increasing.
+    // `tails` contains the indexes of the last items of the sequences of each length found so far.
+    std::vector<std::size_t> tails;
+    std::vector<std::ptrdiff_t> predecessors(count, -1);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (keys[i] < 0)
+            continue;
+
+        const auto it = std::ranges::lower_bound(tails, keys[i], {}, [&keys](const std::size_t index) { return keys[index]; });
+        if (it != tails.begin())
+            predecessors[i] = static_cast<std::ptrdiff_t>(*(it - 1));
+        if (it == tails.end())
+            tails.push_back(i);
+        else
+            *it = i;
+    }
+
+    std::vector<bool> isKept(count, false);
+    for (auto i = (tails.empty() ? -1 : static_cast<std::ptrdiff_t>(tails.back())); i >= 0; i = predecessors[i])
+        isKept[i] = true;
+
+    // Assign the keys to the other torrents between the keys of their kept neighbors
+    std::vector<qint64> newKeys = keys;
+    bool needRenumber = false;
+    qint64 lowerKey = NO_POSITION;
+    for (std::size_t i = 0; (i < count) && !needRenumber;)
+    {
+        if (isKept[i])
+        {
+            lowerKey = keys[i];
+            ++i;
+            continue;
+        }
+
+        std::size_t end = i;
+        while ((end < count) && !isKept[end])
+            ++end;
+        const auto runLength = static_cast<qint64>(end - i);
+
+        qint64 firstKey = 0;
+        qint64 step = KEY_GAP;
+        if (end == count)
+        {
+            if (lowerKey < 0)
+            {
+                firstKey = BASE_KEY;
+            }
+            else if (lowerKey <= (std::numeric_limits<qint64>::max() - (runLength * KEY_GAP)))
+            {
+                firstKey = lowerKey + KEY_GAP;
+            }
+            else
+            {
+                needRenumber = true;
+                break;
+            }
+        }
+        else
+        {
+            const qint64 upperKey = keys[end];
+            if ((lowerKey < 0) && (upperKey >= (runLength * KEY_GAP)))
+            {
+                firstKey = upperKey - (runLength * KEY_GAP);
+            }
+            else
+            {
+                // spread them evenly to leave as much room around them as possible
+                step = (upperKey - lowerKey) / (runLength + 1);
+                if (step < 1)
+                {
+                    needRenumber = true;
+                    break;
+                }
+                firstKey = lowerKey + step;
+            }
+        }
+
+        for (qint64 j = 0; j < runLength; ++i, ++j)
+            newKeys[i] = firstKey + (j * step);
+    }
+
+    if (needRenumber)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            newKeys[i] = BASE_KEY + (static_cast<qint64>(i) * KEY_GAP);
+    }
+
+    QList<std::pair<TorrentID, qint64>> changes;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (newKeys[i] == keys[i])
+            continue;
+
+        const TorrentID &id = ids[static_cast<qsizetype>(i)];
+        m_positions[id] = newKeys[i];
+        changes.append({id, newKeys[i]});
+    }
+
+    return changes;
+}
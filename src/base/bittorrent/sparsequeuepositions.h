@@ -0,0 +1,66 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <utility>
+
+#include <QtClassHelperMacros>
+#include <QHash>
+#include <QList>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    // Keeps the sort keys which define the order of the stored torrents queue. The keys are spaced apart,
+    // so when a torrent is moved or inserted only its own key needs to be changed in most cases,
+    // instead of the positions of all the torrents following it.
+    class SparseQueuePositions final
+    {
+        Q_DISABLE_COPY_MOVE(SparseQueuePositions)
+
+    public:
+        // the key the torrents are renumbered from, so that there is still room before the first one
+        static constexpr qint64 BASE_KEY = qint64(1) << 40;
+        static constexpr qint64 KEY_GAP = qint64(1) << 20;
+
+        // `positions` are the keys currently stored, negative ones are ignored
+        explicit SparseQueuePositions(const QHash<TorrentID, qint64> &positions = {});
+
+        qint64 position(const TorrentID &id) const;
+        void remove(const TorrentID &id);
+
+        // Returns the torrents which keys have to be changed (and their new keys) to order them as in `queue`.
+        // The torrents forming the longest sequence which is already ordered keep their keys.
+        QList<std::pair<TorrentID, qint64>> update(const QList<TorrentID> &queue);
+
+    private:
+        QHash<TorrentID, qint64> m_positions;
+    };
+}
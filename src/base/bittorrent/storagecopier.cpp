@@ -0,0 +1,318 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "storagecopier.h"
+
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#ifdef Q_OS_LINUX
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <filesystem>
+#include <system_error>
+#endif
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutexLocker>
+
+#include "base/global.h"
+#include "base/utils/fs.h"
+
+namespace
+{
+#ifdef Q_OS_LINUX
+    // Amount of data copied at once, the cancellation and the progress are checked in between
+    const qint64 CHUNK_SIZE = 16 * 1024 * 1024;
+
+    QString errorString(const int errorCode)
+    {
+        return QString::fromLocal8Bit(std::strerror(errorCode));
+    }
+
+    class FileDescriptor
+    {
+        Q_DISABLE_COPY_MOVE(FileDescriptor)
+
+    public:
+        explicit FileDescriptor(const int fd)
+            : m_fd {fd}
+        {
+        }
+
+        ~FileDescriptor()
+        {
+            if (m_fd >= 0)
+                ::close(m_fd);
+        }
+
+        int get() const
+        {
+            return m_fd;
+        }
+
+    private:
+        int m_fd = -1;
+    };
+
+    bool isUnsupportedCopyError(const int errorCode)
+    {
+        return (errorCode == EXDEV) || (errorCode == ENOSYS) || (errorCode == EINVAL)
+                || (errorCode == EOPNOTSUPP) || (errorCode == EPERM);
+    }
+#endif
+}
+
+StorageCopier::StorageCopier(QList<File> files, ProgressHandler progressHandler)
+    : m_files {std::move(files)}
+    , m_progressHandler {std::move(progressHandler)}
+{
+}
+
+nonstd::expected<void, QString> StorageCopier::copyFiles(const int threadCount)
+{
+    const auto copyNextFiles = [this]
+    {
+        for (qsizetype index = m_nextFileIndex++; index < m_files.size(); index = m_nextFileIndex++)
+        {
+            if (isCancelled())
+                return;
+
+            if (const nonstd::expected<void, QString> result = copyFile(m_files[index]); !result)
+            {
+                const QMutexLocker locker {&m_mutex};
+                if (m_errorMessage.isEmpty())
+                    m_errorMessage = result.error();
+                m_isCancelled = true;
+                return;
+            }
+        }
+    };
+
+    // The files are taken one by one so a single big file doesn't keep the other threads idle
+    const qsizetype workerCount = std::min<qsizetype>(threadCount, m_files.size()) - 1;
+    std::vector<std::thread> workers;
+    workers.reserve(std::max<qsizetype>(workerCount, 0));
+    for (qsizetype i = 0; i < workerCount; ++i)
+        workers.emplace_back(copyNextFiles);
+    copyNextFiles();
+    for (std::thread &worker : workers)
+        worker.join();
+
+    if (!isCancelled())
+        return {};
+
+    for (const Path &copiedFile : asConst(m_copiedFiles))
+        Utils::Fs::removeFile(copiedFile);
+    m_copiedFiles.clear();
+
+    return nonstd::make_unexpected(m_errorMessage.isEmpty() ? tr("The operation was cancelled") : m_errorMessage);
+}
+
+void StorageCopier::removeSourceFiles() const
+{
+    for (const File &file : m_files)
+        Utils::Fs::removeFile(file.source);
+}
+
+void StorageCopier::cancel()
+{
+    m_isCancelled = true;
+}
+
+qint64 StorageCopier::copiedBytes() const
+{
+    return m_copiedBytes;
+}
+
+void StorageCopier::addCopiedBytes(const qint64 bytes)
+{
+    const qint64 copiedBytes = (m_copiedBytes += bytes);
+    if (m_progressHandler)
+        m_progressHandler(copiedBytes);
+}
+
+bool StorageCopier::isCancelled() const
+{
+    return m_isCancelled;
+}
+
+#ifdef Q_OS_LINUX
+nonstd::expected<void, QString> StorageCopier::copyFile(const File &file)
+{
+    const FileDescriptor sourceFD {::open(QFile::encodeName(file.source.data()).constData(), (O_RDONLY | O_CLOEXEC))};
+    if (sourceFD.get() < 0)
+    {
+        // the file isn't created yet (e.g. it isn't downloaded at all)
+        if (errno == ENOENT)
+            return {};
+        return nonstd::make_unexpected(tr("Couldn't open \"%1\". Reason: \"%2\"").arg(file.source.toString(), errorString(errno)));
+    }
+
+    struct stat sourceStat {};
+    if (::fstat(sourceFD.get(), &sourceStat) != 0)
+        return nonstd::make_unexpected(tr("Couldn't read \"%1\". Reason: \"%2\"").arg(file.source.toString(), errorString(errno)));
+
+    if (!Utils::Fs::mkpath(file.destination.parentPath()))
+        return nonstd::make_unexpected(tr("Couldn't create directory \"%1\"").arg(file.destination.parentPath().toString()));
+
+    const FileDescriptor destinationFD {::open(QFile::encodeName(file.destination.data()).constData()
+            , (O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC), (sourceStat.st_mode & 0777))};
+    if (destinationFD.get() < 0)
+        return nonstd::make_unexpected(tr("Couldn't create \"%1\". Reason: \"%2\"").arg(file.destination.toString(), errorString(errno)));
+
+    {
+        const QMutexLocker locker {&m_mutex};
+        m_copiedFiles.append(file.destination);
+    }
+
+    const auto fail = [&file](const int errorCode)
+    {
+        return nonstd::make_unexpected(tr("Couldn't copy \"%1\" to \"%2\". Reason: \"%3\"")
+                .arg(file.source.toString(), file.destination.toString(), errorString(errorCode)));
+    };
+
+    bool isCopied = false;
+#ifdef FICLONE
+    // the data is shared until it is modified, it is only possible within the same filesystem
+    if (::ioctl(destinationFD.get(), FICLONE, sourceFD.get()) == 0)
+    {
+        addCopiedBytes(sourceStat.st_size);
+        isCopied = true;
+    }
+#endif
+
+    bool canUseCopyFileRange = true;
+    bool canUseSendFile = true;
+    qint64 offset = 0;
+    while (!isCopied && (offset < sourceStat.st_size))
+    {
+        if (isCancelled())
+            return nonstd::make_unexpected(tr("The operation was cancelled"));
+
+        const auto size = static_cast<size_t>(std::min((sourceStat.st_size - offset), CHUNK_SIZE));
+        ssize_t copied = -1;
+        if (canUseCopyFileRange)
+        {
+            copied = ::copy_file_range(sourceFD.get(), nullptr, destinationFD.get(), nullptr, size, 0);
+            if ((copied < 0) && isUnsupportedCopyError(errno) && (offset == 0))
+            {
+                canUseCopyFileRange = false;
+                continue;
+            }
+        }
+        else if (canUseSendFile)
+        {
+            copied = ::sendfile(destinationFD.get(), sourceFD.get(), nullptr, size);
+            if ((copied < 0) && isUnsupportedCopyError(errno) && (offset == 0))
+            {
+                canUseSendFile = false;
+                continue;
+            }
+        }
+        else
+        {
+            QByteArray buffer {static_cast<qsizetype>(size), Qt::Uninitialized};
+            copied = ::read(sourceFD.get(), buffer.data(), size);
+            for (ssize_t written = 0; (copied > 0) && (written < copied);)
+            {
+                const ssize_t result = ::write(destinationFD.get(), (buffer.constData() + written), (copied - written));
+                if (result < 0)
+                {
+                    if (errno != EINTR)
+                        return fail(errno);
+                    continue;
+                }
+                written += result;
+            }
+        }
+
+        if (copied < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return fail(errno);
+        }
+
+        // the file was truncated meanwhile
+        if (copied == 0)
+            break;
+
+        offset += copied;
+        addCopiedBytes(copied);
+    }
+
+    // keep the modification time like renaming the file does
+    const struct timespec times[2] = {sourceStat.st_atim, sourceStat.st_mtim};
+    ::futimens(destinationFD.get(), times);
+
+    return {};
+}
+#else
+nonstd::expected<void, QString> StorageCopier::copyFile(const File &file)
+{
+    if (isCancelled())
+        return nonstd::make_unexpected(tr("The operation was cancelled"));
+
+    const std::filesystem::path sourcePath = file.source.toStdFsPath();
+    std::error_code error;
+    const auto fileSize = std::filesystem::file_size(sourcePath, error);
+    // the file isn't created yet (e.g. it isn't downloaded at all)
+    if (error == std::errc::no_such_file_or_directory)
+        return {};
+
+    if (!Utils::Fs::mkpath(file.destination.parentPath()))
+        return nonstd::make_unexpected(tr("Couldn't create directory \"%1\"").arg(file.destination.parentPath().toString()));
+
+    {
+        const QMutexLocker locker {&m_mutex};
+        m_copiedFiles.append(file.destination);
+    }
+
+    // the standard library uses the native copying of the system (e.g. CopyFile() on Windows)
+    std::filesystem::copy_file(sourcePath, file.destination.toStdFsPath(), std::filesystem::copy_options::overwrite_existing, error);
+    if (error)
+    {
+        return nonstd::make_unexpected(tr("Couldn't copy \"%1\" to \"%2\". Reason: \"%3\"")
+                .arg(file.source.toString(), file.destination.toString(), QString::fromLocal8Bit(error.message())));
+    }
+
+    addCopiedBytes(static_cast<qint64>(fileSize));
+    return {};
+}
+#endif
@@ -0,0 +1,87 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+#include <QCoreApplication>
+#include <QList>
+#include <QMutex>
+#include <QString>
+#include <QtTypes>
+
+#include "base/3rdparty/expected.hpp"
+#include "base/path.h"
+
+// Copies the torrent files to another storage device using the fastest way the filesystems
+// support: reflink clones, then in-kernel copies (copy_file_range(), sendfile()) and the
+// buffered copies as the last resort. The independent files are copied in parallel.
+class StorageCopier
+{
+    Q_DISABLE_COPY_MOVE(StorageCopier)
+    Q_DECLARE_TR_FUNCTIONS(StorageCopier)
+
+public:
+    struct File
+    {
+        Path source;
+        Path destination;
+    };
+
+    // It is invoked from the copying threads with the total amount of the data copied so far
+    using ProgressHandler = std::function<void (qint64 copiedBytes)>;
+
+    StorageCopier(QList<File> files, ProgressHandler progressHandler);
+
+    // Blocks until all the files are copied using up to `threadCount` threads. The files missing
+    // in the source are skipped. On failure the files copied so far are removed.
+    nonstd::expected<void, QString> copyFiles(int threadCount);
+    // Removes the source files once they are copied
+    void removeSourceFiles() const;
+    // Can be called from any thread, the ongoing copying fails as soon as possible
+    void cancel();
+
+    qint64 copiedBytes() const;
+
+private:
+    nonstd::expected<void, QString> copyFile(const File &file);
+    void addCopiedBytes(qint64 bytes);
+    bool isCancelled() const;
+
+    const QList<File> m_files;
+    const ProgressHandler m_progressHandler;
+
+    std::atomic<qsizetype> m_nextFileIndex = 0;
+    std::atomic<qint64> m_copiedBytes = 0;
+    std::atomic<bool> m_isCancelled = false;
+
+    mutable QMutex m_mutex;
+    QString m_errorMessage;
+    QList<Path> m_copiedFiles;
+};
@@ -29,8 +29,11 @@
 
 #pragma once
 
+#include <memory>
+
 #include <QtContainerFwd>
 #include <QtTypes>
+#include <QFlags>
 #include <QMetaType>
 #include <QString>
 
@@ -53,11 +56,14 @@ namespace BitTorrent
 
     class InfoHash;
     class PeerInfo;
+    class PeerInfoSnapshot;
     class Session;
     class TorrentID;
     class TorrentInfo;
 
     struct PeerAddress;
+    struct PeerInfoChanges;
+    struct PeerStatistics;
     struct SSLParameters;
     struct TrackerEntry;
     struct TrackerEntryStatus;
@@ -124,6 +130,24 @@ namespace BitTorrent
         };
         Q_ENUM(StopCondition)
 
+        // Groups of torrent properties for reporting which of them were changed
+        enum class ChangedField
+        {
+            State = 0x1,
+            QueuePosition = 0x2,
+            Progress = 0x4,
+            Peers = 0x8,
+            Speed = 0x10,
+            Transfer = 0x20,
+            Activity = 0x40,
+            Availability = 0x80,
+            Trackers = 0x100,
+            Dates = 0x200,
+            // Properties that aren't reported by libtorrent (e.g. name, category, limits)
+            Configuration = 0x400
+        };
+        Q_DECLARE_FLAGS(ChangedFields, ChangedField)
+
         static const qreal USE_GLOBAL_RATIO;
         static const qreal NO_RATIO_LIMIT;
 
@@ -216,6 +240,8 @@ namespace BitTorrent
         virtual int piecesCount() const = 0;
         virtual int piecesHave() const = 0;
         virtual qreal progress() const = 0;
+        // Progress of reserving the disk space of the files in background, it is 1 unless it is ongoing
+        virtual qreal preallocationProgress() const = 0;
 
         virtual QDateTime addedTime() const = 0;
         virtual QDateTime completedTime() const = 0;
@@ -255,6 +281,8 @@ namespace BitTorrent
         virtual bool isSequentialDownload() const = 0;
         virtual bool hasFirstLastPiecePriority() const = 0;
         virtual TorrentState state() const = 0;
+        // Properties changed since the previous Session::torrentsUpdated() notification about this torrent
+        virtual ChangedFields changedFields() const = 0;
         virtual bool hasMissingFiles() const = 0;
         virtual bool hasError() const = 0;
         virtual int queuePosition() const = 0;
@@ -294,6 +322,12 @@ namespace BitTorrent
         virtual void setName(const QString &name) = 0;
         virtual void setSequentialDownload(bool enable) = 0;
         virtual void setFirstLastPiecePriority(bool enabled) = 0;
+        // Requests the pieces of the file following the given position with increasing deadlines,
+        // so it can be read from there without waiting for the rest of the file (e.g. to play a media)
+        virtual void setStreamingPosition(int fileIndex, qint64 position) = 0;
+        virtual void stopStreaming(int fileIndex) = 0;
+        // The data is fetched once the piece is downloaded, it is empty if the piece can't be read
+        virtual QFuture<QByteArray> fetchPieceData(int pieceIndex) = 0;
         virtual void stop() = 0;
         virtual void start(TorrentOperatingMode mode = TorrentOperatingMode::AutoManaged) = 0;
         virtual void forceReannounce(int index = -1) = 0;
@@ -323,7 +357,9 @@ namespace BitTorrent
         virtual nonstd::expected<QByteArray, QString> exportToBuffer() const = 0;
         virtual nonstd::expected<void, QString> exportToFile(const Path &path) const = 0;
 
+        virtual PeerStatistics peerStatistics() const = 0;
         virtual QFuture<QList<PeerInfo>> fetchPeerInfo() const = 0;
+        virtual QFuture<PeerInfoChanges> fetchPeerInfoChanges(std::shared_ptr<const PeerInfoSnapshot> snapshot) const = 0;
         virtual QFuture<QList<QUrl>> fetchURLSeeds() const = 0;
         virtual QFuture<QList<int>> fetchPieceAvailability() const = 0;
         virtual QFuture<QBitArray> fetchDownloadingPieces() const = 0;
@@ -337,4 +373,5 @@ namespace BitTorrent
     };
 }
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(BitTorrent::Torrent::ChangedFields)
 Q_DECLARE_METATYPE(BitTorrent::TorrentState)
@@ -42,7 +42,9 @@ namespace BitTorrent
         enum class TorrentContentRemoveOption
         {
             Delete,
-            MoveToTrash
+            MoveToTrash,
+            // Moves the content folder into a hidden folder next to it and deletes it from there
+            MoveAsideAndDelete
         };
 
         Q_ENUM_NS(TorrentContentRemoveOption)
@@ -28,34 +28,179 @@
 
 #include "torrentcontentremover.h"
 
+#include <algorithm>
+#include <chrono>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include <QDir>
+#include <QFile>
+#include <QTimer>
+
+#include "base/global.h"
 #include "base/utils/fs.h"
 
-void BitTorrent::TorrentContentRemover::performJob(const QString &torrentName, const Path &basePath
-        , const PathList &fileNames, const TorrentContentRemoveOption option)
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Files are removed in batches so the queued jobs and the rate changes are handled in between
+    const int UNLIMITED_BATCH_SIZE = 256;
+    const std::chrono::milliseconds MIN_BATCH_INTERVAL = 100ms;
+    const QString MOVED_ASIDE_FOLDER_NAME = u".qBittorrent-removing"_s;
+}
+
+BitTorrent::TorrentContentRemover::TorrentContentRemover(QObject *parent)
+    : QObject(parent)
+    , m_timer {new QTimer(this)}
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &TorrentContentRemover::processJobs);
+}
+
+void BitTorrent::TorrentContentRemover::performJob(const TorrentID &torrentID, const QString &torrentName
+        , const Path &basePath, const PathList &fileNames, const TorrentContentRemoveOption option)
 {
-    QString errorMessage;
+    Job job {.torrentID = torrentID, .torrentName = torrentName, .basePath = basePath, .fileNames = fileNames, .option = option};
+    // keep the files of the same folder together
+    std::ranges::sort(job.fileNames, {}, &Path::data);
+
+    if ((option == TorrentContentRemoveOption::MoveAsideAndDelete) && !moveAside(job))
+        job.option = TorrentContentRemoveOption::Delete;
+
+    m_jobs.enqueue(job);
+    if (!m_timer->isActive())
+        m_timer->start(0ms);
+}
 
-    if (!fileNames.isEmpty())
+void BitTorrent::TorrentContentRemover::setRemovingRate(const int filesPerSecond)
+{
+    m_removingRate = std::max(0, filesPerSecond);
+}
+
+void BitTorrent::TorrentContentRemover::processJobs()
+{
+    int batchSize = UNLIMITED_BATCH_SIZE;
+    std::chrono::milliseconds batchInterval = 0ms;
+    if (m_removingRate > 0)
     {
-        const auto removeFileFn = [&option](const Path &filePath)
-        {
-            return ((option == TorrentContentRemoveOption::MoveToTrash)
-                    ? Utils::Fs::moveFileToTrash : Utils::Fs::removeFile)(filePath);
-        };
+        batchSize = std::max(1, static_cast<int>((m_removingRate * MIN_BATCH_INTERVAL) / 1s));
+        batchInterval = (batchSize * 1000ms) / m_removingRate;
+    }
 
-        for (const Path &fileName : fileNames)
+    while ((batchSize > 0) && !m_jobs.isEmpty())
+    {
+        Job &job = m_jobs.head();
+        const int count = std::min(batchSize, static_cast<int>(job.fileNames.size() - job.removedFiles));
+        removeFiles(job, count);
+        batchSize -= count;
+
+        if (job.removedFiles < job.fileNames.size())
+            emit jobProgress(job.torrentID, job.removedFiles, static_cast<int>(job.fileNames.size()));
+        else
+            finishJob(m_jobs.dequeue());
+    }
+
+    if (!m_jobs.isEmpty())
+        m_timer->start(batchInterval);
+}
+
+void BitTorrent::TorrentContentRemover::removeFiles(Job &job, const int count)
+{
+    const int endIndex = job.removedFiles + count;
+
+#ifdef Q_OS_UNIX
+    if (job.option != TorrentContentRemoveOption::MoveToTrash)
+    {
+        // Files of the same folder are unlinked relative to its descriptor
+        // so the folder path is resolved only once for all of them
+        Path folderPath;
+        int folderFD = -1;
+        for (; job.removedFiles < endIndex; ++job.removedFiles)
         {
-            if (const auto result = removeFileFn(basePath / fileName)
-                    ; !result && errorMessage.isEmpty())
+            const Path filePath = job.basePath / job.fileNames[job.removedFiles];
+            if (const Path parentPath = filePath.parentPath(); parentPath != folderPath)
             {
-                errorMessage = result.error();
+                if (folderFD >= 0)
+                    ::close(folderFD);
+                folderPath = parentPath;
+                folderFD = ::open(QFile::encodeName(folderPath.data()).constData(), (O_RDONLY | O_DIRECTORY | O_CLOEXEC));
             }
+
+            if ((folderFD >= 0)
+                    && ((::unlinkat(folderFD, QFile::encodeName(filePath.filename()).constData(), 0) == 0) || (errno == ENOENT)))
+            {
+                continue;
+            }
+
+            if (const auto result = Utils::Fs::removeFile(filePath); !result && job.errorMessage.isEmpty())
+                job.errorMessage = result.error();
         }
 
-        const Path rootPath = Path::findRootFolder(fileNames);
-        if (!rootPath.isEmpty())
-            Utils::Fs::smartRemoveEmptyFolderTree(basePath / rootPath);
+        if (folderFD >= 0)
+            ::close(folderFD);
+        return;
+    }
+#endif
+
+    const auto removeFileFn = (job.option == TorrentContentRemoveOption::MoveToTrash)
+            ? Utils::Fs::moveFileToTrash : Utils::Fs::removeFile;
+    for (; job.removedFiles < endIndex; ++job.removedFiles)
+    {
+        if (const auto result = removeFileFn(job.basePath / job.fileNames[job.removedFiles])
+                ; !result && job.errorMessage.isEmpty())
+        {
+            job.errorMessage = result.error();
+        }
+    }
+}
+
+void BitTorrent::TorrentContentRemover::finishJob(const Job &job)
+{
+    const Path rootPath = Path::findRootFolder(job.fileNames);
+    if (!rootPath.isEmpty())
+        Utils::Fs::smartRemoveEmptyFolderTree(job.basePath / rootPath);
+
+    if (!job.originalBasePath.isEmpty())
+    {
+        // put back the files that don't belong to the torrent
+        const Path movedAsideRootPath = job.basePath / rootPath;
+        const Path originalRootPath = job.originalBasePath / rootPath;
+        if (movedAsideRootPath.exists() && !originalRootPath.exists())
+            QDir().rename(movedAsideRootPath.data(), originalRootPath.data());
+
+        Utils::Fs::rmdir(job.basePath);
+        Utils::Fs::rmdir(job.basePath.parentPath());
+    }
+
+    emit jobFinished(job.torrentID, job.torrentName, job.errorMessage);
+}
+
+bool BitTorrent::TorrentContentRemover::moveAside(Job &job) const
+{
+    // a single file is removed as fast as it could be renamed
+    const Path rootPath = Path::findRootFolder(job.fileNames);
+    if (rootPath.isEmpty())
+        return false;
+
+    const Path movedAsidePath = job.basePath / Path(MOVED_ASIDE_FOLDER_NAME) / Path(job.torrentID.toString());
+    if (!Utils::Fs::mkpath(movedAsidePath))
+        return false;
+
+    // renaming fails if the folder is on another storage device
+    if (!QDir().rename((job.basePath / rootPath).data(), (movedAsidePath / rootPath).data()))
+    {
+        Utils::Fs::rmdir(movedAsidePath);
+        Utils::Fs::rmdir(movedAsidePath.parentPath());
+        return false;
     }
 
-    emit jobFinished(torrentName, errorMessage);
+    job.originalBasePath = job.basePath;
+    job.basePath = movedAsidePath;
+    return true;
 }
@@ -29,10 +29,14 @@
 #pragma once
 
 #include <QObject>
+#include <QQueue>
 
 #include "base/path.h"
+#include "infohash.h"
 #include "torrentcontentremoveoption.h"
 
+class QTimer;
+
 namespace BitTorrent
 {
     class TorrentContentRemover final : public QObject
@@ -41,13 +45,39 @@ namespace BitTorrent
         Q_DISABLE_COPY_MOVE(TorrentContentRemover)
 
     public:
-        using QObject::QObject;
+        explicit TorrentContentRemover(QObject *parent = nullptr);
 
     public slots:
-        void performJob(const QString &torrentName, const Path &basePath
+        void performJob(const TorrentID &torrentID, const QString &torrentName, const Path &basePath
                 , const PathList &fileNames, TorrentContentRemoveOption option);
+        // Maximum number of files removed per second, 0 means unlimited
+        void setRemovingRate(int filesPerSecond);
 
     signals:
-        void jobFinished(const QString &torrentName, const QString &errorMessage);
+        void jobProgress(const TorrentID &torrentID, int removedFiles, int totalFiles);
+        void jobFinished(const TorrentID &torrentID, const QString &torrentName, const QString &errorMessage);
+
+    private:
+        struct Job
+        {
+            TorrentID torrentID;
+            QString torrentName;
+            Path basePath;
+            // Original location of the content moved aside to be deleted
+            Path originalBasePath;
+            PathList fileNames;
+            TorrentContentRemoveOption option = TorrentContentRemoveOption::Delete;
+            int removedFiles = 0;
+            QString errorMessage;
+        };
+
+        void processJobs();
+        void removeFiles(Job &job, int count);
+        void finishJob(const Job &job);
+        bool moveAside(Job &job) const;
+
+        QQueue<Job> m_jobs;
+        QTimer *m_timer = nullptr;
+        int m_removingRate = 0;
     };
 }
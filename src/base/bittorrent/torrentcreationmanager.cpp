@@ -29,6 +29,8 @@
 
 #include "torrentcreationmanager.h"
 
+#include <algorithm>
+#include <functional>
 #include <utility>
 
 #include <boost/multi_index_container.hpp>
@@ -39,6 +41,8 @@
 
 #include <QUuid>
 
+#include "base/utils/fs.h"
+
 #define SETTINGS_KEY(name) u"TorrentCreator/Manager/" name
 
 namespace BitTorrent
@@ -61,13 +65,19 @@ BitTorrent::TorrentCreationManager::TorrentCreationManager(IApplication *app, QO
     : ApplicationComponent(app, parent)
     , m_maxTasks {SETTINGS_KEY(u"MaxTasks"_s), 256}
     , m_numThreads {SETTINGS_KEY(u"NumThreads"_s), 1}
+    , m_maxTasksPerDevice {SETTINGS_KEY(u"MaxTasksPerDevice"_s), 1}
+    , m_readRateLimit {SETTINGS_KEY(u"ReadRateLimit"_s), 0}
     , m_tasks {std::make_unique<TaskSet>()}
+    , m_rateLimiter {std::make_shared<TorrentCreatorRateLimiter>()}
     , m_threadPool(this)
 {
     m_threadPool.setObjectName("TorrentCreationManager m_threadPool");
 
     if (m_numThreads > 0)
         m_threadPool.setMaxThreadCount(m_numThreads);
+
+    // in KiB/s
+    m_rateLimiter->setLimit(static_cast<qint64>(m_readRateLimit) * 1024);
 }
 
 BitTorrent::TorrentCreationManager::~TorrentCreationManager() = default;
@@ -90,15 +100,64 @@ std::shared_ptr<BitTorrent::TorrentCreationTask> BitTorrent::TorrentCreationMana
     const QString taskID = generateTaskID();
 
     auto *torrentCreator = new TorrentCreator(params, this);
+    torrentCreator->setRateLimiter(m_rateLimiter);
     auto creationTask = std::make_shared<TorrentCreationTask>(app(), taskID, torrentCreator, startSeeding);
     connect(creationTask.get(), &QObject::destroyed, torrentCreator, &BitTorrent::TorrentCreator::requestInterruption);
 
+    // Tasks reading from the same device are limited, so that they don't
+    // compete for the disk with each other (and with active transfers)
+    const QString device = Utils::Fs::storageDevice(params.sourcePath);
+    const auto onTaskFinished = [this, device] { handleTaskFinished(device); };
+    connect(torrentCreator, &BitTorrent::TorrentCreator::creationSuccess, this, onTaskFinished);
+    connect(torrentCreator, &BitTorrent::TorrentCreator::creationFailure, this, onTaskFinished);
+
     m_tasks->get<ByID>().insert(creationTask);
-    m_threadPool.start(torrentCreator);
+
+    // keep tasks of the same priority in the order they were added
+    const auto pos = std::ranges::upper_bound(m_queuedTasks, params.priority, std::greater<int>()
+            , [](const QueuedTask &queuedTask) { return queuedTask.torrentCreator->params().priority; });
+    m_queuedTasks.insert(pos, {creationTask, torrentCreator, device});
+    startQueuedTasks();
 
     return creationTask;
 }
 
+void BitTorrent::TorrentCreationManager::startQueuedTasks()
+{
+    for (auto iter = m_queuedTasks.begin(); iter != m_queuedTasks.end();)
+    {
+        if (iter->task.expired())
+        {
+            // the task was deleted before it was started
+            delete iter->torrentCreator;
+            iter = m_queuedTasks.erase(iter);
+            continue;
+        }
+
+        int &runningTasks = m_runningTasksPerDevice[iter->device];
+        if ((m_maxTasksPerDevice > 0) && (runningTasks >= m_maxTasksPerDevice))
+        {
+            ++iter;
+            continue;
+        }
+
+        ++runningTasks;
+        m_threadPool.start(iter->torrentCreator, iter->torrentCreator->params().priority);
+        iter = m_queuedTasks.erase(iter);
+    }
+}
+
+void BitTorrent::TorrentCreationManager::handleTaskFinished(const QString &device)
+{
+    if (const auto iter = m_runningTasksPerDevice.find(device); iter != m_runningTasksPerDevice.end())
+    {
+        if (--iter.value() <= 0)
+            m_runningTasksPerDevice.erase(iter);
+    }
+
+    startQueuedTasks();
+}
+
 QString BitTorrent::TorrentCreationManager::generateTaskID() const
 {
     const auto &tasksByID = m_tasks->get<ByID>();
@@ -133,5 +192,7 @@ bool BitTorrent::TorrentCreationManager::deleteTask(const QString &id)
         return false;
 
     tasksByID.erase(iter);
+    // drop the torrent creator of the task if it was still queued
+    startQueuedTasks();
     return true;
 }
@@ -32,6 +32,8 @@
 #include <memory>
 
 #include <QtContainerFwd>
+#include <QHash>
+#include <QList>
 #include <QObject>
 #include <QThreadPool>
 
@@ -57,14 +59,30 @@ namespace BitTorrent
         bool deleteTask(const QString &id);
 
     private:
+        struct QueuedTask
+        {
+            std::weak_ptr<TorrentCreationTask> task;
+            TorrentCreator *torrentCreator = nullptr;
+            QString device;
+        };
+
         QString generateTaskID() const;
+        void startQueuedTasks();
+        void handleTaskFinished(const QString &device);
 
         CachedSettingValue<qint32> m_maxTasks;
         CachedSettingValue<qint32> m_numThreads;
+        CachedSettingValue<qint32> m_maxTasksPerDevice;
+        CachedSettingValue<qint32> m_readRateLimit;
 
         class TaskSet;
         std::unique_ptr<TaskSet> m_tasks;
 
+        // Tasks waiting for a free slot of their source device, ordered by priority
+        QList<QueuedTask> m_queuedTasks;
+        QHash<QString, int> m_runningTasksPerDevice;
+        std::shared_ptr<TorrentCreatorRateLimiter> m_rateLimiter;
+
         QThreadPool m_threadPool;
     };
 }
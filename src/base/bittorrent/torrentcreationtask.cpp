@@ -64,7 +64,8 @@ BitTorrent::TorrentCreationTask::TorrentCreationTask(IApplication *app, const QS
 
         BitTorrent::AddTorrentParams params;
         params.savePath = result.savePath;
-        params.skipChecking = true;
+        // the content was hashed just now, it is checked again only if it was modified since then
+        params.isContentVerified = TorrentCreator::isContentUnchanged(result);
         params.useAutoTMM = false;  // otherwise if it is on by default, it will overwrite `savePath` to the default save path
 
         if (!app->addTorrentManager()->addTorrent(result.torrentFilePath.data(), params))
@@ -30,21 +30,27 @@
 
 #include "torrentcreator.h"
 
+#include <algorithm>
 #include <functional>
+#include <utility>
 
 #include <libtorrent/create_torrent.hpp>
 #include <libtorrent/file_storage.hpp>
+#include <libtorrent/settings_pack.hpp>
 #include <libtorrent/torrent_info.hpp>
 
 #include <QtSystemDetection>
 #include <QDirIterator>
 #include <QFileInfo>
 #include <QHash>
+#include <QThread>
 
 #include "base/exceptions.h"
 #include "base/global.h"
 #include "base/utils/compare.h"
 #include "base/utils/io.h"
+#include "base/utils/string.h"
+#include "base/utils/thread.h"
 #include "base/version.h"
 #include "lttypecast.h"
 
@@ -75,6 +81,34 @@ namespace
 }
 
 using namespace BitTorrent;
+using namespace std::chrono_literals;
+
+qint64 TorrentCreatorRateLimiter::limit() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_limit;
+}
+
+void TorrentCreatorRateLimiter::setLimit(const qint64 limit)
+{
+    const QMutexLocker locker {&m_mutex};
+    m_limit = std::max<qint64>(0, limit);
+}
+
+std::chrono::nanoseconds TorrentCreatorRateLimiter::reserve(const qint64 bytes)
+{
+    const QMutexLocker locker {&m_mutex};
+    if (m_limit <= 0)
+        return 0ns;
+
+    // Every reader gets the next free time slot, so the readers are served in turns.
+    // The time which wasn't used by anyone isn't accumulated, so there are no bursts.
+    const auto now = std::chrono::steady_clock::now();
+    m_nextReadTime = std::max(m_nextReadTime, now);
+    const std::chrono::nanoseconds waitTime = m_nextReadTime - now;
+    m_nextReadTime += std::chrono::nanoseconds(static_cast<qint64>((bytes * 1'000'000'000.0) / m_limit));
+    return waitTime;
+}
 
 TorrentCreator::TorrentCreator(const TorrentCreatorParams &params, QObject *parent)
     : QObject(parent)
@@ -93,6 +127,22 @@ void TorrentCreator::checkInterruptionRequested() const
         throw RuntimeError(tr("Operation aborted"));
 }
 
+void TorrentCreator::throttle(const qint64 bytes) const
+{
+    if (!m_rateLimiter)
+        return;
+
+    std::chrono::nanoseconds waitTime = m_rateLimiter->reserve(bytes);
+    while (waitTime > 0ns)
+    {
+        checkInterruptionRequested();
+
+        const std::chrono::nanoseconds sleepTime = std::min<std::chrono::nanoseconds>(waitTime, 100ms);
+        QThread::sleep(sleepTime);
+        waitTime -= sleepTime;
+    }
+}
+
 void TorrentCreator::requestInterruption()
 {
     m_interruptionRequested.store(true, std::memory_order_relaxed);
@@ -105,6 +155,9 @@ bool TorrentCreator::isInterruptionRequested() const
 
 void TorrentCreator::run()
 {
+    // It runs in the dedicated thread pools, so the scheduling policy doesn't leak to the other work
+    Utils::Thread::applyWorkload(Utils::Thread::Workload::Bulk);
+
     emit started();
     emit progressUpdated(0);
 
@@ -207,13 +260,43 @@ void TorrentCreator::run()
                 newTorrent.add_tracker(tracker.trimmed().toStdString(), tier);
         }
 
+        // remember the content files to detect whether they are modified
+        // during or after hashing when the torrent is going to be seeded
+        const lt::file_storage &torrentFiles = newTorrent.files();
+        QList<TorrentCreatorFileStamp> contentFiles;
+        contentFiles.reserve(torrentFiles.num_files());
+        for (const lt::file_index_t index : torrentFiles.file_range())
+        {
+            if (torrentFiles.pad_file_at(index))
+                continue;
+
+            const Path filePath = parentPath / Path(torrentFiles.file_path(index));
+            contentFiles.append({filePath, torrentFiles.file_size(index), QFileInfo(filePath.data()).lastModified()});
+        }
+
         // calculate the hash for all pieces
-        lt::set_piece_hashes(newTorrent, parentPath.toString().toStdString()
-            , [this, &newTorrent](const lt::piece_index_t n)
+        const auto progressHandler = [this, &newTorrent](const lt::piece_index_t n)
         {
             checkInterruptionRequested();
             sendProgressSignal(LT::toUnderlyingType(n), newTorrent.num_pieces());
-        });
+            // hashing is held back while reading is over the limit
+            throttle(newTorrent.piece_size(n));
+        };
+#ifdef QBT_USES_LIBTORRENT2
+        // Pieces are read by libtorrent's default (memory mapped) disk I/O and hashed
+        // by its hashing threads, a few pieces per thread are kept in flight and their
+        // hashes are assembled in piece order
+        lt::settings_pack hashingSettings;
+        hashingSettings.set_int(lt::settings_pack::hashing_threads
+            , ((m_params.hashingThreads > 0) ? m_params.hashingThreads : QThread::idealThreadCount()));
+
+        lt::error_code ec;
+        lt::set_piece_hashes(newTorrent, parentPath.toString().toStdString(), hashingSettings, progressHandler, ec);
+        if (ec)
+            throw RuntimeError(Utils::String::fromLocal8Bit(ec.message()));
+#else
+        lt::set_piece_hashes(newTorrent, parentPath.toString().toStdString(), progressHandler);
+#endif
 
         // Set qBittorrent as creator and add user comment to
         // torrent_info structure
@@ -250,7 +333,8 @@ void TorrentCreator::run()
         {
             .torrentFilePath = result.value(),
             .savePath = parentPath,
-            .pieceSize = newTorrent.piece_length()
+            .pieceSize = newTorrent.piece_length(),
+            .contentFiles = contentFiles
         };
 
         emit progressUpdated(100);
@@ -271,6 +355,23 @@ const TorrentCreatorParams &TorrentCreator::params() const
     return m_params;
 }
 
+void TorrentCreator::setRateLimiter(std::shared_ptr<TorrentCreatorRateLimiter> rateLimiter)
+{
+    m_rateLimiter = std::move(rateLimiter);
+}
+
+bool TorrentCreator::isContentUnchanged(const TorrentCreatorResult &result)
+{
+    if (result.contentFiles.isEmpty())
+        return false;
+
+    return std::ranges::all_of(result.contentFiles, [](const TorrentCreatorFileStamp &file)
+    {
+        const QFileInfo fileInfo {file.path.data()};
+        return fileInfo.isFile() && (fileInfo.size() == file.size) && (fileInfo.lastModified() == file.lastModified);
+    });
+}
+
 #ifdef QBT_USES_LIBTORRENT2
 int TorrentCreator::calculateTotalPieces(const Path &inputPath, const int pieceSize, const TorrentFormat torrentFormat)
 #else
@@ -31,7 +31,12 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
+#include <memory>
 
+#include <QDateTime>
+#include <QList>
+#include <QMutex>
 #include <QObject>
 #include <QRunnable>
 #include <QStringList>
@@ -54,6 +59,8 @@ namespace BitTorrent
         bool isPrivate = false;
 #ifdef QBT_USES_LIBTORRENT2
         TorrentFormat torrentFormat = TorrentFormat::Hybrid;
+        // Number of threads hashing the pieces, 0 means one per CPU core
+        int hashingThreads = 0;
 #else
         bool isAlignmentOptimized = false;
         int paddedFileSizeLimit = 0;
@@ -65,6 +72,15 @@ namespace BitTorrent
         QString source;
         QStringList trackers;
         QStringList urlSeeds;
+        // Queued tasks with higher priority are started first
+        int priority = 0;
+    };
+
+    struct TorrentCreatorFileStamp
+    {
+        Path path;
+        qint64 size = 0;
+        QDateTime lastModified;
     };
 
     struct TorrentCreatorResult
@@ -72,6 +88,30 @@ namespace BitTorrent
         Path torrentFilePath;
         Path savePath;
         int pieceSize;
+        // Content files as they were before hashing
+        QList<TorrentCreatorFileStamp> contentFiles;
+    };
+
+    // Limits the total rate of reading source files by the torrent creators sharing it
+    class TorrentCreatorRateLimiter
+    {
+        Q_DISABLE_COPY_MOVE(TorrentCreatorRateLimiter)
+
+    public:
+        TorrentCreatorRateLimiter() = default;
+
+        // in bytes per second, 0 means unlimited
+        qint64 limit() const;
+        void setLimit(qint64 limit);
+
+        // Reserves the bandwidth for reading the given amount of data,
+        // returns the time to wait before reading it
+        std::chrono::nanoseconds reserve(qint64 bytes);
+
+    private:
+        mutable QMutex m_mutex;
+        qint64 m_limit = 0;
+        std::chrono::steady_clock::time_point m_nextReadTime;
     };
 
     class TorrentCreator final : public QObject, public QRunnable
@@ -84,6 +124,7 @@ namespace BitTorrent
 
         const TorrentCreatorParams &params() const;
         bool isInterruptionRequested() const;
+        void setRateLimiter(std::shared_ptr<TorrentCreatorRateLimiter> rateLimiter);
 
         void run() override;
 
@@ -94,6 +135,10 @@ namespace BitTorrent
                 , const bool isAlignmentOptimized, int paddedFileSizeLimit);
 #endif
 
+        // Checks whether the content still looks the same as it was when the torrent was created,
+        // so the torrent can be seeded without verifying the content again
+        static bool isContentUnchanged(const TorrentCreatorResult &result);
+
     public slots:
         void requestInterruption();
 
@@ -106,8 +151,10 @@ namespace BitTorrent
     private:
         void sendProgressSignal(int currentPieceIdx, int totalPieces);
         void checkInterruptionRequested() const;
+        void throttle(qint64 bytes) const;
 
         TorrentCreatorParams m_params;
+        std::shared_ptr<TorrentCreatorRateLimiter> m_rateLimiter;
         std::atomic_bool m_interruptionRequested;
     };
 }
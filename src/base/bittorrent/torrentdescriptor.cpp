@@ -28,6 +28,9 @@
 
 #include "torrentdescriptor.h"
 
+#include <libtorrent/bdecode.hpp>
+#include <libtorrent/error_code.hpp>
+#include <libtorrent/hasher.hpp>
 #include <libtorrent/load_torrent.hpp>
 #include <libtorrent/magnet_uri.hpp>
 #include <libtorrent/torrent_info.hpp>
@@ -41,7 +44,6 @@
 #include "base/global.h"
 #include "base/preferences.h"
 #include "base/utils/io.h"
-#include "infohash.h"
 #include "trackerentry.h"
 
 namespace
@@ -84,6 +86,32 @@ namespace
 
         return limits;
     }
+
+    QString errorMessage(const lt::error_code &ec)
+    {
+        return QString::fromLocal8Bit(ec.message());
+    }
+
+    // BEP52: files are the leaves of the tree with empty names
+    void summarizeFileTree(const lt::bdecode_node &fileTree, BitTorrent::TorrentDescriptor::Summary &summary)
+    {
+        for (int i = 0; i < fileTree.dict_size(); ++i)
+        {
+            const auto [name, node] = fileTree.dict_at(i);
+            if (node.type() != lt::bdecode_node::dict_t)
+                continue;
+
+            if (name.empty())
+            {
+                summary.totalSize += node.dict_find_int_value("length");
+                ++summary.filesCount;
+            }
+            else
+            {
+                summarizeFileTree(node, summary);
+            }
+        }
+    }
 }
 
 const int TORRENTDESCRIPTOR_TYPEID = qRegisterMetaType<BitTorrent::TorrentDescriptor>();
@@ -110,6 +138,92 @@ catch (const lt::system_error &err)
     return nonstd::make_unexpected(QString::fromLocal8Bit(err.what()));
 }
 
+nonstd::expected<BitTorrent::TorrentDescriptor::Summary, QString>
+BitTorrent::TorrentDescriptor::peek(const QByteArray &data) noexcept
+try
+{
+    const lt::load_torrent_limits limits = loadTorrentLimits();
+    if (data.size() > limits.max_buffer_size)
+        return nonstd::make_unexpected(errorMessage(lt::errors::metadata_too_large));
+
+    lt::error_code ec;
+    const lt::bdecode_node root = lt::bdecode(lt::span<const char>(data.data(), data.size())
+            , ec, nullptr, limits.max_decode_depth, limits.max_decode_tokens);
+    if (ec)
+        return nonstd::make_unexpected(errorMessage(ec));
+    if (root.type() != lt::bdecode_node::dict_t)
+        return nonstd::make_unexpected(errorMessage(lt::errors::torrent_is_no_dict));
+
+    const lt::bdecode_node info = root.dict_find_dict("info");
+    if (!info)
+        return nonstd::make_unexpected(errorMessage(lt::errors::torrent_missing_info));
+
+    Summary summary;
+
+    const lt::span<const char> infoSection = info.data_section();
+    const bool hasV1 = static_cast<bool>(info.dict_find_string("pieces"));
+#ifdef QBT_USES_LIBTORRENT2
+    lt::info_hash_t nativeHashes;
+    if (hasV1)
+        nativeHashes.v1 = lt::hasher(infoSection).final();
+    if (info.dict_find_int_value("meta version") == 2)
+        nativeHashes.v2 = lt::hasher256(infoSection).final();
+    if (!nativeHashes.has_v1() && !nativeHashes.has_v2())
+        return nonstd::make_unexpected(errorMessage(lt::errors::torrent_missing_pieces));
+    summary.infoHash = nativeHashes;
+#else
+    if (!hasV1)
+        return nonstd::make_unexpected(errorMessage(lt::errors::torrent_missing_pieces));
+    summary.infoHash = lt::hasher(infoSection).final();
+#endif
+
+    std::string_view name = info.dict_find_string_value("name.utf-8");
+    if (name.empty())
+        name = info.dict_find_string_value("name");
+    summary.name = QString::fromUtf8(name.data(), static_cast<qsizetype>(name.size()));
+
+    summary.isPrivate = (info.dict_find_int_value("private") == 1);
+
+    if (const lt::bdecode_node files = info.dict_find_list("files"))
+    {
+        for (int i = 0; i < files.list_size(); ++i)
+        {
+            const lt::bdecode_node file = files.list_at(i);
+            if (file.type() != lt::bdecode_node::dict_t)
+                continue;
+
+            summary.totalSize += file.dict_find_int_value("length");
+            if (file.dict_find_string_value("attr").find('p') == std::string_view::npos)
+                ++summary.filesCount;
+        }
+    }
+    else if (const lt::bdecode_node length = info.dict_find_int("length"))
+    {
+        summary.totalSize = length.int_value();
+        summary.filesCount = 1;
+    }
+    else if (const lt::bdecode_node fileTree = info.dict_find_dict("file tree"))
+    {
+        summarizeFileTree(fileTree, summary);
+    }
+
+    return summary;
+}
+catch (const lt::system_error &err)
+{
+    return nonstd::make_unexpected(QString::fromLocal8Bit(err.what()));
+}
+
+nonstd::expected<BitTorrent::TorrentDescriptor::Summary, QString>
+BitTorrent::TorrentDescriptor::peekFile(const Path &path) noexcept
+{
+    const auto readResult = Utils::IO::readFile(path, Preferences::instance()->getTorrentFileSizeLimit());
+    if (!readResult)
+        return nonstd::make_unexpected(readResult.error().message);
+
+    return peek(readResult.value());
+}
+
 nonstd::expected<BitTorrent::TorrentDescriptor, QString>
 BitTorrent::TorrentDescriptor::parse(const QString &str) noexcept
 try
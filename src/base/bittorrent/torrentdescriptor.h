@@ -39,6 +39,7 @@
 
 #include "base/3rdparty/expected.hpp"
 #include "base/path.h"
+#include "infohash.h"
 #include "torrentinfo.h"
 
 class QByteArray;
@@ -46,12 +47,22 @@ class QUrl;
 
 namespace BitTorrent
 {
-    class InfoHash;
     struct TrackerEntry;
 
     class TorrentDescriptor
     {
     public:
+        // The basic properties of a torrent file which can be obtained
+        // without loading the whole metadata
+        struct Summary
+        {
+            InfoHash infoHash;
+            QString name;
+            qlonglong totalSize = 0; // including .pad files, same as TorrentInfo::totalSize()
+            int filesCount = 0; // excluding .pad files, same as TorrentInfo::filesCount()
+            bool isPrivate = false;
+        };
+
         TorrentDescriptor() = default;
 
         InfoHash infoHash() const;
@@ -68,6 +79,10 @@ namespace BitTorrent
         static nonstd::expected<TorrentDescriptor, QString> load(const QByteArray &data) noexcept;
         static nonstd::expected<TorrentDescriptor, QString> loadFromFile(const Path &path) noexcept;
         static nonstd::expected<TorrentDescriptor, QString> parse(const QString &str) noexcept;
+        // Only decodes the data and hashes its info dictionary, so it is much cheaper than load()
+        // for big torrents. It doesn't validate the metadata, so load() can still fail afterwards.
+        static nonstd::expected<Summary, QString> peek(const QByteArray &data) noexcept;
+        static nonstd::expected<Summary, QString> peekFile(const Path &path) noexcept;
         nonstd::expected<void, QString> saveToFile(const Path &path) const;
         nonstd::expected<QByteArray, QString> saveToBuffer() const;
 
@@ -0,0 +1,160 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "torrentfileexporter.h"
+
+#include <chrono>
+#include <utility>
+
+#include <QDir>
+#include <QStringList>
+#include <QTimer>
+
+#include "base/global.h"
+#include "base/utils/fs.h"
+#include "base/utils/io.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // The exports requested in a quick succession (e.g. when adding many torrents) are written together
+    const std::chrono::milliseconds BATCH_DELAY = 100ms;
+    // The listing of the folder is reloaded when it wasn't used for a while to notice the external changes
+    const std::chrono::milliseconds FOLDER_CACHE_LIFETIME = 5min;
+
+    QString fileNameKey(const QString &fileName)
+    {
+#ifdef Q_OS_WIN
+        return fileName.toLower();
+#else
+        return fileName;
+#endif
+    }
+}
+
+BitTorrent::TorrentFileExporter::TorrentFileExporter(QObject *parent)
+    : QObject(parent)
+    , m_timer {new QTimer(this)}
+{
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &TorrentFileExporter::processJobs);
+}
+
+BitTorrent::TorrentFileExporter::~TorrentFileExporter()
+{
+    // the pending batch is written when the IO thread is stopped on shutdown
+    if (!m_jobs.isEmpty())
+        processJobs();
+}
+
+void BitTorrent::TorrentFileExporter::exportTorrent(const QString &torrentName, const Path &folderPath
+        , const QString &fileName, const QByteArray &data)
+{
+    m_jobs.append({.torrentName = torrentName, .folderPath = folderPath, .fileName = fileName, .data = data});
+    if (!m_timer->isActive())
+        m_timer->start(BATCH_DELAY);
+}
+
+void BitTorrent::TorrentFileExporter::processJobs()
+{
+    m_folderCaches.removeIf([](const QHash<Path, FolderCache>::iterator it)
+    {
+        return it.value().lastUsed.hasExpired(FOLDER_CACHE_LIFETIME.count());
+    });
+
+    // keep the jobs of the same folder together so each folder is prepared only once per batch
+    QHash<Path, QList<Job>> jobsByFolder;
+    for (Job &job : std::exchange(m_jobs, {}))
+        jobsByFolder[job.folderPath].append(std::move(job));
+
+    for (auto it = jobsByFolder.cbegin(); it != jobsByFolder.cend(); ++it)
+    {
+        const Path &folderPath = it.key();
+        FolderCache *cache = folderCache(folderPath);
+        for (const Job &job : it.value())
+        {
+            if (!cache)
+            {
+                emit exportFailed(job.torrentName, (folderPath / Path(job.fileName + u".torrent"))
+                        , tr("Couldn't create directory \"%1\"").arg(folderPath.toString()));
+                continue;
+            }
+
+            const Path filePath = reserveFilePath(*cache, folderPath, job.fileName);
+            const nonstd::expected<void, QString> result = Utils::IO::saveToFile(filePath, job.data);
+            if (!result)
+            {
+                cache->fileNames.remove(fileNameKey(filePath.filename()));
+                emit exportFailed(job.torrentName, filePath, result.error());
+            }
+        }
+
+        if (cache)
+            cache->lastUsed.start();
+    }
+}
+
+BitTorrent::TorrentFileExporter::FolderCache *BitTorrent::TorrentFileExporter::folderCache(const Path &folderPath)
+{
+    if (const auto it = m_folderCaches.find(folderPath); it != m_folderCaches.end())
+        return &it.value();
+
+    if (!Utils::Fs::mkpath(folderPath))
+        return nullptr;
+
+    // list the existing files once instead of probing every candidate name
+    FolderCache cache;
+    const QStringList existingNames = QDir(folderPath.data()).entryList({u"*.torrent"_s}
+            , (QDir::AllEntries | QDir::Hidden | QDir::System | QDir::NoDotAndDotDot));
+    for (const QString &name : existingNames)
+        cache.fileNames.insert(fileNameKey(name));
+    cache.lastUsed.start();
+
+    return &m_folderCaches.insert(folderPath, cache).value();
+}
+
+Path BitTorrent::TorrentFileExporter::reserveFilePath(FolderCache &cache, const Path &folderPath, const QString &fileName) const
+{
+    QString candidateName = u"%1.torrent"_s.arg(fileName);
+    int counter = 0;
+    while (true)
+    {
+        if (!cache.fileNames.contains(fileNameKey(candidateName)))
+        {
+            cache.fileNames.insert(fileNameKey(candidateName));
+
+            // The cached listing may be stale so the chosen name is verified once
+            const Path candidatePath = folderPath / Path(candidateName);
+            if (!candidatePath.exists())
+                return candidatePath;
+        }
+
+        // Append number to torrent name to make it unique
+        candidateName = u"%1 (%2).torrent"_s.arg(fileName).arg(++counter);
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QSet>
+
+#include "base/path.h"
+
+class QTimer;
+
+namespace BitTorrent
+{
+    // Writes the exported .torrent files in a worker thread so the slow destinations
+    // (e.g. the network mounts) don't block the session
+    class TorrentFileExporter final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(TorrentFileExporter)
+
+    public:
+        explicit TorrentFileExporter(QObject *parent = nullptr);
+        ~TorrentFileExporter() override;
+
+    public slots:
+        // Stores the data as "<fileName>.torrent" in the folder, making the file name unique if needed
+        void exportTorrent(const QString &torrentName, const Path &folderPath, const QString &fileName, const QByteArray &data);
+
+    signals:
+        void exportFailed(const QString &torrentName, const Path &filePath, const QString &errorMessage);
+
+    private:
+        struct Job
+        {
+            QString torrentName;
+            Path folderPath;
+            QString fileName;
+            QByteArray data;
+        };
+
+        struct FolderCache
+        {
+            QSet<QString> fileNames;
+            QElapsedTimer lastUsed;
+        };
+
+        void processJobs();
+        FolderCache *folderCache(const Path &folderPath);
+        Path reserveFilePath(FolderCache &cache, const Path &folderPath, const QString &fileName) const;
+
+        QList<Job> m_jobs;
+        QHash<Path, FolderCache> m_folderCaches;
+        QTimer *m_timer = nullptr;
+    };
+}
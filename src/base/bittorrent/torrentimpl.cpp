@@ -30,7 +30,10 @@
 #include "torrentimpl.h"
 
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <set>
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -50,7 +53,9 @@
 #include <QByteArray>
 #include <QCache>
 #include <QDebug>
+#include <QDir>
 #include <QFuture>
+#include <QHostAddress>
 #include <QPointer>
 #include <QPromise>
 #include <QSet>
@@ -60,10 +65,12 @@
 #include "base/exceptions.h"
 #include "base/global.h"
 #include "base/logger.h"
+#include "base/net/geoipmanager.h"
 #include "base/preferences.h"
 #include "base/types.h"
 #include "base/utils/fs.h"
 #include "base/utils/io.h"
+#include "base/utils/memory.h"
 #include "base/utils/string.h"
 #include "common.h"
 #include "downloadpriority.h"
@@ -74,8 +81,11 @@
 #include "lttypecast.h"
 #include "peeraddress.h"
 #include "peerinfo.h"
+#include "peerinfochanges.h"
+#include "peerstatistics.h"
 #include "sessionimpl.h"
 #include "trackerentry.h"
+#include "trackerregistry.h"
 
 #if defined(Q_OS_MACOS) || defined(Q_OS_WIN)
 #include "base/utils/os.h"
@@ -89,6 +99,13 @@ using namespace BitTorrent;
 
 namespace
 {
+    // Size of the data following the streaming position which is requested with deadlines
+    const qint64 STREAMING_WINDOW_SIZE = 16 * 1024 * 1024;
+    // Each next piece of the streaming window is requested with the deadline later by this interval
+    const int STREAMING_PIECE_DEADLINE_INTERVAL = 500;  // ms
+    // Number of the recently useful peers stored with the resume data
+    const std::size_t MAX_RECENT_PEERS = 50;
+
     lt::announce_entry makeNativeAnnounceEntry(const QString &url, const int tier)
     {
         lt::announce_entry entry {url.toStdString()};
@@ -109,7 +126,8 @@ namespace
     }
 
     void updateTrackerEntryStatus(TrackerEntryStatus &trackerEntryStatus, const lt::announce_entry &nativeEntry
-            , const QSet<int> &btProtocols, const QHash<lt::tcp::endpoint, QMap<int, int>> &updateInfo)
+            , const QSet<int> &btProtocols, const QHash<lt::tcp::endpoint, QMap<int, int>> &updateInfo
+            , TrackerRegistry &trackerRegistry)
     {
         Q_ASSERT(trackerEntryStatus.url == QString::fromStdString(nativeEntry.url));
 
@@ -189,11 +207,11 @@ namespace
 
                 if (!ltAnnounceInfo.message.empty())
                 {
-                    trackerEndpointStatus.message = QString::fromStdString(ltAnnounceInfo.message);
+                    trackerEndpointStatus.message = trackerRegistry.message(ltAnnounceInfo.message);
                 }
                 else if (ltAnnounceInfo.last_error)
                 {
-                    trackerEndpointStatus.message = QString::fromLocal8Bit(ltAnnounceInfo.last_error.message());
+                    trackerEndpointStatus.message = trackerRegistry.errorMessage(ltAnnounceInfo.last_error.message());
                 }
                 else
                 {
@@ -295,6 +313,50 @@ namespace
     {
         return ((value < 0) || (value == std::numeric_limits<int>::max())) ? 0 : value;
     }
+
+    // 0 means unlimited
+    int effectiveLimit(const int ownLimit, const int categoryLimit)
+    {
+        if (ownLimit <= 0)
+            return categoryLimit;
+        if (categoryLimit <= 0)
+            return ownLimit;
+        return std::min(ownLimit, categoryLimit);
+    }
+
+    qint64 toSecsSinceEpoch(const lt::time_point &timePoint)
+    {
+        if (timePoint.time_since_epoch().count() == 0)
+            return 0;
+
+        return (QDateTime::currentSecsSinceEpoch() - lt::total_seconds(lt::clock_type::now() - timePoint));
+    }
+
+    TorrentCounters makeCounters(const lt::add_torrent_params &params)
+    {
+        return {
+            .totalUploaded = params.total_uploaded,
+            .totalDownloaded = params.total_downloaded,
+            .activeTime = params.active_time,
+            .finishedTime = params.finished_time,
+            .seedingTime = params.seeding_time,
+            .lastUpload = params.last_upload,
+            .lastDownload = params.last_download
+        };
+    }
+
+    TorrentCounters makeCounters(const lt::torrent_status &status)
+    {
+        return {
+            .totalUploaded = status.all_time_upload,
+            .totalDownloaded = status.all_time_download,
+            .activeTime = static_cast<int>(lt::total_seconds(status.active_duration)),
+            .finishedTime = static_cast<int>(lt::total_seconds(status.finished_duration)),
+            .seedingTime = static_cast<int>(lt::total_seconds(status.seeding_duration)),
+            .lastUpload = toSecsSinceEpoch(status.last_upload),
+            .lastDownload = toSecsSinceEpoch(status.last_download)
+        };
+    }
 }
 
 // TorrentImpl
@@ -309,10 +371,9 @@ TorrentImpl::TorrentImpl(SessionImpl *session, const lt::torrent_handle &nativeH
     , m_infoHash(m_nativeHandle.info_hash())
 #endif
     , m_name(params.name)
-    , m_savePath(params.savePath)
-    , m_downloadPath(params.downloadPath)
-    , m_category(params.category)
-    , m_tags(params.tags)
+    , m_savePath(session->internTorrentPath(params.savePath))
+    , m_downloadPath(session->internTorrentPath(params.downloadPath))
+    , m_category(session->internCategory(params.category))
     , m_ratioLimit(params.ratioLimit)
     , m_seedingTimeLimit(params.seedingTimeLimit)
     , m_inactiveSeedingTimeLimit(params.inactiveSeedingTimeLimit)
@@ -349,7 +410,11 @@ TorrentImpl::TorrentImpl(SessionImpl *session, const lt::torrent_handle &nativeH
                 resized(m_ltAddTorrentParams.file_priorities, m_ltAddTorrentParams.ti->num_files()
                         , LT::toNative(m_ltAddTorrentParams.file_priorities.empty() ? DownloadPriority::Normal : DownloadPriority::Ignored));
 
-        m_completedFiles.fill(static_cast<bool>(m_ltAddTorrentParams.flags & lt::torrent_flags::seed_mode), filesCount);
+        // the files of verified content must not get the extension of incomplete files
+        const bool hasAllPieces = (m_ltAddTorrentParams.flags & lt::torrent_flags::seed_mode)
+                || (!m_ltAddTorrentParams.have_pieces.empty() && m_ltAddTorrentParams.have_pieces.all_set()
+                    && (m_ltAddTorrentParams.have_pieces.size() == m_ltAddTorrentParams.ti->num_pieces()));
+        m_completedFiles.fill(hasAllPieces, filesCount);
         m_filesProgress.resize(filesCount);
 
         for (int i = 0; i < filesCount; ++i)
@@ -370,16 +435,22 @@ TorrentImpl::TorrentImpl(SessionImpl *session, const lt::torrent_handle &nativeH
     if (!params.comment.isEmpty())
         m_comment = params.comment;
 
+    for (const Tag &tag : asConst(params.tags))
+        m_tags.insert(m_session->internTag(tag));
+
     setStopCondition(params.stopCondition);
 
     const auto *extensionData = static_cast<ExtensionData *>(m_ltAddTorrentParams.userdata);
     m_trackerEntryStatuses.reserve(static_cast<decltype(m_trackerEntryStatuses)::size_type>(extensionData->trackers.size()));
     for (const lt::announce_entry &announceEntry : extensionData->trackers)
-        m_trackerEntryStatuses.append({QString::fromStdString(announceEntry.url), announceEntry.tier});
+        m_trackerEntryStatuses.append({m_session->trackerRegistry().url(announceEntry.url), announceEntry.tier});
     m_urlSeeds.reserve(static_cast<decltype(m_urlSeeds)::size_type>(extensionData->urlSeeds.size()));
     for (const std::string &urlSeed : extensionData->urlSeeds)
         m_urlSeeds.append(QString::fromStdString(urlSeed));
     m_nativeStatus = extensionData->status;
+    m_peerTraffic = extensionData->peerTraffic;
+    // Resume data the torrent was loaded from is up to date at this point
+    m_resumeDataSaveTimer.start();
 
     m_addedTime = QDateTime::fromSecsSinceEpoch(m_nativeStatus.added_time);
     if (m_nativeStatus.completed_time > 0)
@@ -418,6 +489,9 @@ QString TorrentImpl::name() const
     if (!m_name.isEmpty())
         return m_name;
 
+    if (m_releasedMetadata)
+        return m_releasedMetadata->name;
+
     if (hasMetadata())
         return m_torrentInfo.name();
 
@@ -454,11 +528,17 @@ void TorrentImpl::setComment(const QString &comment)
 
 bool TorrentImpl::isPrivate() const
 {
+    if (m_releasedMetadata)
+        return m_releasedMetadata->isPrivate;
+
     return m_torrentInfo.isPrivate();
 }
 
 qlonglong TorrentImpl::totalSize() const
 {
+    if (m_releasedMetadata)
+        return m_releasedMetadata->totalSize;
+
     return m_torrentInfo.totalSize();
 }
 
@@ -475,6 +555,9 @@ qlonglong TorrentImpl::completedSize() const
 
 qlonglong TorrentImpl::pieceLength() const
 {
+    if (m_releasedMetadata)
+        return m_releasedMetadata->pieceLength;
+
     return m_torrentInfo.pieceLength();
 }
 
@@ -517,7 +600,7 @@ void TorrentImpl::setSavePath(const Path &path)
     }
     else
     {
-        m_savePath = resolvedPath;
+        m_savePath = m_session->internTorrentPath(resolvedPath);
         m_session->handleTorrentSavePathChanged(this);
         deferredRequestResumeData();
     }
@@ -547,7 +630,7 @@ void TorrentImpl::setDownloadPath(const Path &path)
     }
     else
     {
-        m_downloadPath = resolvedPath;
+        m_downloadPath = m_session->internTorrentPath(resolvedPath);
         m_session->handleTorrentSavePathChanged(this);
         deferredRequestResumeData();
     }
@@ -590,8 +673,8 @@ void TorrentImpl::setAutoTMMEnabled(bool enabled)
     m_useAutoTMM = enabled;
     if (!m_useAutoTMM)
     {
-        m_savePath = m_session->categorySavePath(category());
-        m_downloadPath = m_session->categoryDownloadPath(category());
+        m_savePath = m_session->internTorrentPath(m_session->categorySavePath(category()));
+        m_downloadPath = m_session->internTorrentPath(m_session->categoryDownloadPath(category()));
     }
 
     deferredRequestResumeData();
@@ -674,7 +757,7 @@ void TorrentImpl::addTrackers(QList<TrackerEntry> trackers)
     for (const TrackerEntry &tracker : asConst(trackers))
     {
         m_nativeHandle.add_tracker(makeNativeAnnounceEntry(tracker.url, tracker.tier));
-        m_trackerEntryStatuses.append({tracker.url, tracker.tier});
+        m_trackerEntryStatuses.append({m_session->trackerRegistry().url(tracker.url), tracker.tier});
     }
     std::ranges::sort(m_trackerEntryStatuses
         , [](const TrackerEntryStatus &left, const TrackerEntryStatus &right) { return left.tier < right.tier; });
@@ -723,7 +806,7 @@ void TorrentImpl::replaceTrackers(QList<TrackerEntry> trackers)
     for (const TrackerEntry &tracker : trackers)
     {
         nativeTrackers.emplace_back(makeNativeAnnounceEntry(tracker.url, tracker.tier));
-        m_trackerEntryStatuses.append({tracker.url, tracker.tier});
+        m_trackerEntryStatuses.append({m_session->trackerRegistry().url(tracker.url), tracker.tier});
     }
 
     m_nativeHandle.replace_trackers(nativeTrackers);
@@ -848,12 +931,18 @@ bool TorrentImpl::connectPeer(const PeerAddress &peerAddress)
     }
     catch (const lt::system_error &err)
     {
-        LogMsg(tr("Failed to add peer \"%1\" to torrent \"%2\". Reason: %3")
-            .arg(peerAddress.toString(), name(), QString::fromLocal8Bit(err.what())), Log::WARNING);
+        LogMsg(Log::Category::Peers, Log::WARNING, [this, &peerAddress, &err]
+        {
+            return tr("Failed to add peer \"%1\" to torrent \"%2\". Reason: %3")
+                .arg(peerAddress.toString(), name(), QString::fromLocal8Bit(err.what()));
+        });
         return false;
     }
 
-    LogMsg(tr("Peer \"%1\" is added to torrent \"%2\"").arg(peerAddress.toString(), name()));
+    LogMsg(Log::Category::Peers, Log::NORMAL, [this, &peerAddress]
+    {
+        return tr("Peer \"%1\" is added to torrent \"%2\"").arg(peerAddress.toString(), name());
+    });
     return true;
 }
 
@@ -862,35 +951,151 @@ bool TorrentImpl::needSaveResumeData() const
     return m_nativeStatus.need_save_resume;
 }
 
-void TorrentImpl::requestResumeData(const lt::resume_data_flags_t flags)
+qint64 TorrentImpl::resumeDataAge() const
 {
+    return m_resumeDataSaveTimer.elapsed();
+}
+
+bool TorrentImpl::releaseMetadata()
+{
+    if (m_releasedMetadata || !m_torrentInfo.isValid())
+        return false;
+
+    if (std::exchange(m_isMetadataAccessed, false))
+        return false;
+
+    if (!m_isStopped || isMoveInProgress() || (m_maintenanceJob != MaintenanceJob::None)
+            || (m_state == TorrentState::CheckingUploading) || (m_state == TorrentState::CheckingDownloading)
+            || (m_state == TorrentState::CheckingResumeData))
+    {
+        return false;
+    }
+
+    m_releasedMetadata = MetadataSummary {
+        .name = m_torrentInfo.name(),
+        .totalSize = m_torrentInfo.totalSize(),
+        .pieceLength = m_torrentInfo.pieceLength(),
+        .filesCount = m_torrentInfo.filesCount(),
+        .piecesCount = m_torrentInfo.piecesCount(),
+        .isPrivate = m_torrentInfo.isPrivate()
+    };
+    m_torrentInfo = {};
+    return true;
+}
+
+qint64 TorrentImpl::estimatedMemoryUsage() const
+{
+    // Approximate size of the libtorrent data kept per file in addition to the info section
+    const qint64 nativeFileEntrySize = 48;
+
+    qint64 size = sizeof(TorrentImpl);
+
+    if (m_torrentInfo.isValid())
+    {
+        // The copy owned by libtorrent has the same size
+        const std::shared_ptr<const lt::torrent_info> nativeInfo = nativeTorrentInfo();
+        size += nativeInfo->metadata_size() + (nativeInfo->num_files() * nativeFileEntrySize)
+            + (m_torrentInfo.nativeIndexes().size() * static_cast<qint64>(sizeof(lt::file_index_t)));
+    }
+    else if (m_releasedMetadata)
+    {
+        size += sizeof(MetadataSummary) + Utils::Memory::estimateHeapSize(m_releasedMetadata->name);
+    }
+
+    size += static_cast<qint64>((m_filePaths.size() * sizeof(Path))
+        + (m_filePriorities.size() * sizeof(DownloadPriority))
+        + (m_filesProgress.size() * sizeof(std::int64_t))
+        + (m_indexMap.size() * (sizeof(lt::file_index_t) + sizeof(int))))
+        + ((m_pieces.size() + m_completedFiles.size()) / 8);
+    for (const Path &filePath : m_filePaths)
+        size += Utils::Memory::estimateHeapSize(filePath.data());
+
+    for (const TrackerEntryStatus &status : m_trackerEntryStatuses)
+    {
+        // the URLs and messages are mostly shared with other torrents
+        size += static_cast<qint64>(sizeof(TrackerEntryStatus) + (status.endpoints.size() * sizeof(TrackerEndpointStatus)))
+            + (status.url.isDetached() ? Utils::Memory::estimateHeapSize(status.url) : 0)
+            + (status.message.isDetached() ? Utils::Memory::estimateHeapSize(status.message) : 0);
+    }
+    size += static_cast<qint64>(m_urlSeeds.size() * sizeof(QUrl));
+
+    size += Utils::Memory::estimateHeapSize(m_name) + Utils::Memory::estimateHeapSize(m_comment)
+        + Utils::Memory::estimateHeapSize(m_creator) + Utils::Memory::estimateHeapSize(m_savePath.data())
+        + Utils::Memory::estimateHeapSize(m_downloadPath.data())
+        + (m_category.isDetached() ? Utils::Memory::estimateHeapSize(m_category) : 0);
+
+    return size;
+}
+
+void TorrentImpl::requestResumeData(lt::resume_data_flags_t flags)
+{
+    // libtorrent doesn't consider the peers as the modification of the torrent
+    if (m_recentPeersChanged)
+        flags &= ~lt::torrent_handle::only_if_modified;
+
     m_nativeHandle.save_resume_data(flags);
     m_deferredRequestResumeDataInvoked = false;
+    ++m_pendingResumeDataRequests;
 
     m_session->handleTorrentResumeDataRequested(this);
 }
 
 void TorrentImpl::deferredRequestResumeData()
 {
+    // Resume data is requested whenever any of the persistent torrent properties is changed
+    m_changedFields |= ChangedField::Configuration;
+
     if (!m_deferredRequestResumeDataInvoked)
     {
-        QMetaObject::invokeMethod(this, [this]
-        {
-            requestResumeData((m_maintenanceJob == MaintenanceJob::HandleMetadata)
-                    ? lt::torrent_handle::save_info_dict : lt::resume_data_flags_t());
-        }, Qt::QueuedConnection);
-
+        // the requests of all torrents changed at once are handled together
+        m_session->deferTorrentResumeDataRequest(this);
         m_deferredRequestResumeDataInvoked = true;
     }
 }
 
+void TorrentImpl::handleDeferredResumeDataRequest()
+{
+    // resume data may be already requested in the meantime
+    if (!m_deferredRequestResumeDataInvoked)
+        return;
+
+    requestResumeData((m_maintenanceJob == MaintenanceJob::HandleMetadata)
+            ? lt::torrent_handle::save_info_dict : lt::resume_data_flags_t());
+}
+
+bool TorrentImpl::takeResumeDataRequest()
+{
+    if (m_pendingResumeDataRequests <= 0)
+        return false;
+
+    --m_pendingResumeDataRequests;
+    return true;
+}
+
+void TorrentImpl::resendResumeDataRequest()
+{
+    if (m_pendingResumeDataRequests <= 0)
+        return;
+
+    // The answers to the previous requests that are still received are counted for the resent one
+    m_pendingResumeDataRequests = 0;
+    requestResumeData((m_maintenanceJob == MaintenanceJob::HandleMetadata)
+            ? lt::torrent_handle::save_info_dict : lt::resume_data_flags_t());
+}
+
 int TorrentImpl::filesCount() const
 {
+    if (m_releasedMetadata)
+        return m_releasedMetadata->filesCount;
+
     return m_torrentInfo.filesCount();
 }
 
 int TorrentImpl::piecesCount() const
 {
+    if (m_releasedMetadata)
+        return m_releasedMetadata->piecesCount;
+
     return m_torrentInfo.piecesCount();
 }
 
@@ -959,7 +1164,7 @@ bool TorrentImpl::addTag(const Tag &tag)
         if (!m_session->addTag(tag))
             return false;
     }
-    m_tags.insert(tag);
+    m_tags.insert(m_session->internTag(tag));
     deferredRequestResumeData();
     m_session->handleTorrentTagAdded(this, tag);
     return true;
@@ -982,6 +1187,16 @@ void TorrentImpl::removeAllTags()
         removeTag(tag);
 }
 
+qreal TorrentImpl::preallocationProgress() const
+{
+    return m_preallocationProgress;
+}
+
+void TorrentImpl::setPreallocationProgress(const qreal progress)
+{
+    m_preallocationProgress = progress;
+}
+
 QDateTime TorrentImpl::addedTime() const
 {
     return m_addedTime;
@@ -1057,7 +1272,7 @@ Path TorrentImpl::filePath(const int index) const
 
 Path TorrentImpl::actualFilePath(const int index) const
 {
-    const QList<lt::file_index_t> nativeIndexes = m_torrentInfo.nativeIndexes();
+    const QList<lt::file_index_t> nativeIndexes = loadedTorrentInfo().nativeIndexes();
 
     Q_ASSERT(index >= 0);
     Q_ASSERT(index < nativeIndexes.size());
@@ -1069,7 +1284,7 @@ Path TorrentImpl::actualFilePath(const int index) const
 
 qlonglong TorrentImpl::fileSize(const int index) const
 {
-    return m_torrentInfo.fileSize(index);
+    return loadedTorrentInfo().fileSize(index);
 }
 
 PathList TorrentImpl::filePaths() const
@@ -1086,7 +1301,7 @@ PathList TorrentImpl::actualFilePaths() const
     paths.reserve(filesCount());
 
     const lt::file_storage files = nativeTorrentInfo()->files();
-    for (const lt::file_index_t &nativeIndex : asConst(m_torrentInfo.nativeIndexes()))
+    for (const lt::file_index_t &nativeIndex : asConst(loadedTorrentInfo().nativeIndexes()))
         paths.emplaceBack(files.file_path(nativeIndex));
 
     return paths;
@@ -1099,7 +1314,10 @@ QList<DownloadPriority> TorrentImpl::filePriorities() const
 
 TorrentInfo TorrentImpl::info() const
 {
-    return m_torrentInfo;
+    if (!hasMetadata())
+        return {};
+
+    return loadedTorrentInfo();
 }
 
 bool TorrentImpl::isStopped() const
@@ -1244,8 +1462,20 @@ TorrentState TorrentImpl::state() const
     return m_state;
 }
 
+Torrent::ChangedFields TorrentImpl::changedFields() const
+{
+    return m_changedFields;
+}
+
+void TorrentImpl::clearChangedFields()
+{
+    m_changedFields = {};
+}
+
 void TorrentImpl::updateState()
 {
+    const TorrentState prevState = m_state;
+
     if (m_nativeStatus.state == lt::torrent_status::checking_resume_data)
     {
         m_state = TorrentState::CheckingResumeData;
@@ -1302,11 +1532,14 @@ void TorrentImpl::updateState()
         else
             m_state = TorrentState::StalledDownloading;
     }
+
+    if (m_state != prevState)
+        m_changedFields |= ChangedField::State;
 }
 
 bool TorrentImpl::hasMetadata() const
 {
-    return m_torrentInfo.isValid();
+    return (m_releasedMetadata || m_torrentInfo.isValid());
 }
 
 bool TorrentImpl::hasMissingFiles() const
@@ -1609,7 +1842,7 @@ bool TorrentImpl::setCategory(const QString &category)
         }
 
         const QString oldCategory = m_category;
-        m_category = category;
+        m_category = m_session->internCategory(category);
         deferredRequestResumeData();
         m_session->handleTorrentCategoryChanged(this, oldCategory);
 
@@ -1622,7 +1855,7 @@ bool TorrentImpl::setCategory(const QString &category)
 
 void TorrentImpl::forceReannounce(const int index)
 {
-    m_nativeHandle.force_reannounce(0, index);
+    m_session->reannounce(this, index);
 }
 
 void TorrentImpl::forceDHTAnnounce()
@@ -1635,6 +1868,8 @@ void TorrentImpl::forceRecheck()
     if (!hasMetadata())
         return;
 
+    // the files aren't checked while the torrent is paused
+    setDormant(false);
     m_nativeHandle.force_recheck();
 
     // We have to force update the cached state, otherwise someone will be able to get
@@ -1706,7 +1941,7 @@ void TorrentImpl::applyFirstLastPiecePriority(const bool enabled)
 
     // Download first and last pieces first for every file in the torrent
 
-    auto piecePriorities = std::vector<lt::download_priority_t>(m_torrentInfo.piecesCount(), LT::toNative(DownloadPriority::Ignored));
+    auto piecePriorities = std::vector<lt::download_priority_t>(loadedTorrentInfo().piecesCount(), LT::toNative(DownloadPriority::Ignored));
 
     // Updating file priorities is an async operation in libtorrent, when we just updated it and immediately query it
     // we might get the old/wrong values, so we rely on `updatedFilePrio` in this case.
@@ -1718,7 +1953,7 @@ void TorrentImpl::applyFirstLastPiecePriority(const bool enabled)
 
         // Determine the priority to set
         const lt::download_priority_t piecePrio = LT::toNative(enabled ? DownloadPriority::Maximum : filePrio);
-        const TorrentInfo::PieceRange pieceRange = m_torrentInfo.filePieces(fileIndex);
+        const TorrentInfo::PieceRange pieceRange = loadedTorrentInfo().filePieces(fileIndex);
 
         // worst case: AVI index = 1% of total file size (at the end of the file)
         const int numPieces = std::ceil(fileSize(fileIndex) * 0.01 / pieceLength());
@@ -1737,12 +1972,89 @@ void TorrentImpl::applyFirstLastPiecePriority(const bool enabled)
     m_nativeHandle.prioritize_pieces(piecePriorities);
 }
 
+void TorrentImpl::setStreamingPosition(const int fileIndex, const qint64 position)
+{
+    if (!hasMetadata() || (fileIndex < 0) || (fileIndex >= filesCount()))
+        return;
+
+    const TorrentInfo &torrentInfo = loadedTorrentInfo();
+    const TorrentInfo::PieceRange filePieces = torrentInfo.filePieces(fileIndex);
+    if (filePieces.isEmpty())
+        return;
+
+    const qint64 pieceSize = torrentInfo.pieceLength();
+    const qint64 offset = torrentInfo.fileOffset(fileIndex) + std::clamp<qint64>(position, 0, (fileSize(fileIndex) - 1));
+    const auto firstPiece = static_cast<int>(offset / pieceSize);
+    const auto windowPiecesCount = static_cast<int>(std::max<qint64>((STREAMING_WINDOW_SIZE / pieceSize), 1));
+    const TorrentInfo::PieceRange window = makeInterval(firstPiece, std::min((firstPiece + windowPiecesCount - 1), filePieces.last()));
+
+    if (const auto windowIter = m_streamingWindows.constFind(fileIndex); windowIter != m_streamingWindows.cend())
+    {
+        const TorrentInfo::PieceRange oldWindow = windowIter.value();
+        if ((oldWindow.first() == window.first()) && (oldWindow.size() == window.size()))
+            return;
+
+        // the pieces behind the position aren't needed urgently anymore
+        for (const int pieceIndex : oldWindow)
+        {
+            if (((pieceIndex < window.first()) || (pieceIndex > window.last())) && !m_pendingPieceReads.contains(pieceIndex))
+                m_nativeHandle.reset_piece_deadline(lt::piece_index_t {pieceIndex});
+        }
+    }
+    m_streamingWindows.insert(fileIndex, window);
+
+    for (const int pieceIndex : window)
+    {
+        if (m_pieces.at(pieceIndex))
+            continue;
+
+        // changing the deadline of the piece being read must not cancel the reading
+        const lt::deadline_flags_t flags = m_pendingPieceReads.contains(pieceIndex)
+                ? lt::torrent_handle::alert_when_available : lt::deadline_flags_t {};
+        m_nativeHandle.set_piece_deadline(lt::piece_index_t {pieceIndex}
+                , ((pieceIndex - window.first()) * STREAMING_PIECE_DEADLINE_INTERVAL), flags);
+    }
+}
+
+void TorrentImpl::stopStreaming(const int fileIndex)
+{
+    const auto windowIter = m_streamingWindows.find(fileIndex);
+    if (windowIter == m_streamingWindows.end())
+        return;
+
+    for (const int pieceIndex : windowIter.value())
+    {
+        if (!m_pendingPieceReads.contains(pieceIndex))
+            m_nativeHandle.reset_piece_deadline(lt::piece_index_t {pieceIndex});
+    }
+    m_streamingWindows.erase(windowIter);
+}
+
+QFuture<QByteArray> TorrentImpl::fetchPieceData(const int pieceIndex)
+{
+    if (!hasMetadata() || (pieceIndex < 0) || (pieceIndex >= piecesCount()))
+        return QtFuture::makeReadyValueFuture(QByteArray());
+
+    if (const auto iter = m_pendingPieceReads.find(pieceIndex); iter != m_pendingPieceReads.end())
+        return iter->second.future();
+
+    QPromise<QByteArray> promise;
+    promise.start();
+    QFuture<QByteArray> future = promise.future();
+    m_pendingPieceReads.emplace(pieceIndex, std::move(promise));
+
+    // the piece is read as soon as it is downloaded, or right away if it is already available
+    m_nativeHandle.set_piece_deadline(lt::piece_index_t {pieceIndex}, 0, lt::torrent_handle::alert_when_available);
+    return future;
+}
+
 TrackerEntryStatus TorrentImpl::updateTrackerEntryStatus(const lt::announce_entry &announceEntry, const QHash<lt::tcp::endpoint, QMap<int, int>> &updateInfo)
 {
+    const QString url = m_session->trackerRegistry().url(announceEntry.url);
     const auto it = std::ranges::find_if(m_trackerEntryStatuses
-            , [&announceEntry](const TrackerEntryStatus &trackerEntryStatus)
+            , [&url](const TrackerEntryStatus &trackerEntryStatus)
     {
-        return (trackerEntryStatus.url == QString::fromStdString(announceEntry.url));
+        return (trackerEntryStatus.url == url);
     });
 
     Q_ASSERT(it != m_trackerEntryStatuses.end());
@@ -1760,7 +2072,7 @@ TrackerEntryStatus TorrentImpl::updateTrackerEntryStatus(const lt::announce_entr
     const QSet<int> btProtocols {1};
 #endif
 
-    ::updateTrackerEntryStatus(*it, announceEntry, btProtocols, updateInfo);
+    ::updateTrackerEntryStatus(*it, announceEntry, btProtocols, updateInfo, m_session->trackerRegistry());
 
     return *it;
 }
@@ -1785,6 +2097,19 @@ std::shared_ptr<const libtorrent::torrent_info> TorrentImpl::nativeTorrentInfo()
     return m_nativeStatus.torrent_file.lock();
 }
 
+const TorrentInfo &TorrentImpl::loadedTorrentInfo() const
+{
+    if (m_releasedMetadata) [[unlikely]]
+    {
+        // libtorrent keeps its own copy of the metadata, so it is restored from there
+        m_torrentInfo = TorrentInfo(*nativeTorrentInfo());
+        m_releasedMetadata.reset();
+    }
+
+    m_isMetadataAccessed = true;
+    return m_torrentInfo;
+}
+
 void TorrentImpl::endReceivedMetadataHandling(const Path &savePath, const PathList &fileNames)
 {
     Q_ASSERT(m_maintenanceJob == MaintenanceJob::HandleMetadata);
@@ -1861,6 +2186,9 @@ void TorrentImpl::reload()
                 | lt::torrent_flags::override_trackers
                 | lt::torrent_flags::override_web_seeds;
 
+        // the reloaded torrent runs normally, it is put to sleep again if it is still idle
+        m_isDormant = false;
+
         if (m_isStopped)
         {
             p.flags |= lt::torrent_flags::paused;
@@ -1878,7 +2206,10 @@ void TorrentImpl::reload()
         const auto queuePos = m_nativeHandle.queue_position();
 
         m_nativeHandle = m_session->reloadTorrent(m_nativeHandle, std::move(p));
-        m_nativeStatus = static_cast<ExtensionData *>(m_nativeHandle.userdata())->status;
+        const auto *extensionData = static_cast<ExtensionData *>(m_nativeHandle.userdata());
+        m_nativeStatus = extensionData->status;
+        // the traffic counted but not taken yet is dropped along with the old peers
+        m_peerTraffic = extensionData->peerTraffic;
 
         if (queuePos >= lt::queue_position_t {})
             m_nativeHandle.queue_position_set(queuePos);
@@ -1901,6 +2232,7 @@ void TorrentImpl::reload()
 
 void TorrentImpl::stop()
 {
+    m_isDormant = false;
     if (!m_isStopped)
     {
         m_stopCondition = StopCondition::None;
@@ -1927,6 +2259,7 @@ void TorrentImpl::start(const TorrentOperatingMode mode)
     }
 
     m_operatingMode = mode;
+    m_isDormant = false;
 
     if (m_hasMissingFiles)
     {
@@ -1952,18 +2285,53 @@ void TorrentImpl::start(const TorrentOperatingMode mode)
     }
 }
 
+bool TorrentImpl::isDormant() const
+{
+    return m_isDormant;
+}
+
+void TorrentImpl::setDormant(const bool dormant)
+{
+    if (dormant == m_isDormant)
+        return;
+
+    if (dormant)
+    {
+        // only the seeds running on their own are put to sleep, e.g. not the forced or queued ones
+        if (isStopped() || isForced() || isQueued() || !isFinished() || isChecking()
+                || hasError() || isMoveInProgress() || (m_maintenanceJob != MaintenanceJob::None))
+        {
+            return;
+        }
+
+        m_isDormant = true;
+        setAutoManaged(false);
+        m_nativeHandle.pause();
+        m_payloadRateMonitor.reset();
+        return;
+    }
+
+    m_isDormant = false;
+    if (!isStopped() && (m_maintenanceJob == MaintenanceJob::None))
+    {
+        setAutoManaged(m_operatingMode == TorrentOperatingMode::AutoManaged);
+        if (m_operatingMode == TorrentOperatingMode::Forced)
+            m_nativeHandle.resume();
+    }
+}
+
 void TorrentImpl::moveStorage(const Path &newPath, const MoveStorageContext context)
 {
     if (!hasMetadata())
     {
         if (context == MoveStorageContext::ChangeSavePath)
         {
-            m_savePath = newPath;
+            m_savePath = m_session->internTorrentPath(newPath);
             m_session->handleTorrentSavePathChanged(this);
         }
         else if (context == MoveStorageContext::ChangeDownloadPath)
         {
-            m_downloadPath = newPath;
+            m_downloadPath = m_session->internTorrentPath(newPath);
             m_session->handleTorrentSavePathChanged(this);
         }
 
@@ -1998,6 +2366,67 @@ void TorrentImpl::handleStateUpdate(const lt::torrent_status &nativeStatus)
     updateStatus(nativeStatus);
 }
 
+void TorrentImpl::updatePeerStatistics()
+{
+    std::map<PeerTrafficData::Key, PeerTraffic> peers;
+    std::set<lt::tcp::endpoint> usefulPeers;
+    {
+        const std::lock_guard lock {m_peerTraffic->mutex};
+        peers.swap(m_peerTraffic->peers);
+        usefulPeers.swap(m_peerTraffic->usefulPeers);
+    }
+
+    if (!usefulPeers.empty())
+        updateRecentPeers(usefulPeers);
+
+    if (peers.empty())
+        return;
+
+    PeerStatistics statistics;
+    const Net::GeoIPManager *geoIPManager = Net::GeoIPManager::instance();
+    for (const auto &[key, traffic] : peers)
+    {
+        const auto &[address, client] = key;
+        const PeerTrafficStatistics trafficStatistics {.downloaded = traffic.downloaded, .uploaded = traffic.uploaded, .connections = traffic.connections};
+
+        statistics.clients[QString::fromStdString(client)] += trafficStatistics;
+
+        const lt::tcp::endpoint endpoint {address, 0};
+        const QString country = (geoIPManager && !address.is_unspecified())
+            ? geoIPManager->lookup(QHostAddress(endpoint.data())) : QString();
+        statistics.countries[country] += trafficStatistics;
+    }
+
+    m_peerStatistics += statistics;
+    // the session keeps the totals of all the torrents so they aren't summed up on each query
+    m_session->handleTorrentPeerStatisticsUpdated(statistics);
+}
+
+void TorrentImpl::updateRecentPeers(const std::set<lt::tcp::endpoint> &usefulPeers)
+{
+    std::erase_if(m_recentPeers, [&usefulPeers](const lt::tcp::endpoint &endpoint)
+    {
+        return usefulPeers.contains(endpoint);
+    });
+    m_recentPeers.insert(m_recentPeers.begin(), usefulPeers.cbegin(), usefulPeers.cend());
+    if (m_recentPeers.size() > MAX_RECENT_PEERS)
+        m_recentPeers.resize(MAX_RECENT_PEERS);
+
+    m_recentPeersChanged = true;
+}
+
+bool TorrentImpl::updateAvailability(const lt::torrent_status &nativeStatus)
+{
+    if ((nativeStatus.handle != m_nativeHandle) || (nativeStatus.distributed_copies == m_nativeStatus.distributed_copies))
+        return false;
+
+    m_nativeStatus.distributed_full_copies = nativeStatus.distributed_full_copies;
+    m_nativeStatus.distributed_fraction = nativeStatus.distributed_fraction;
+    m_nativeStatus.distributed_copies = nativeStatus.distributed_copies;
+    m_changedFields |= ChangedField::Availability;
+    return true;
+}
+
 void TorrentImpl::handleQueueingModeChanged()
 {
     updateState();
@@ -2006,9 +2435,9 @@ void TorrentImpl::handleQueueingModeChanged()
 void TorrentImpl::handleMoveStorageJobFinished(const Path &path, const MoveStorageContext context, const bool hasOutstandingJob)
 {
     if (context == MoveStorageContext::ChangeSavePath)
-        m_savePath = path;
+        m_savePath = m_session->internTorrentPath(path);
     else if (context == MoveStorageContext::ChangeDownloadPath)
-        m_downloadPath = path;
+        m_downloadPath = m_session->internTorrentPath(path);
     m_storageIsMoving = hasOutstandingJob;
     m_nativeStatus.save_path = path.toString().toStdString();
 
@@ -2064,6 +2493,7 @@ void TorrentImpl::handleTorrentChecked()
             {
                 // torrent is internally paused using NativeTorrentExtension after files checked
                 // so we need to resume it if there is no corresponding "stop condition" set
+                m_isDormant = false;
                 setAutoManaged(m_operatingMode == TorrentOperatingMode::AutoManaged);
                 if (m_operatingMode == TorrentOperatingMode::Forced)
                     m_nativeHandle.resume();
@@ -2174,6 +2604,18 @@ void TorrentImpl::handleSaveResumeData(lt::add_torrent_params params)
     }
 }
 
+void TorrentImpl::handleSaveResumeDataNotModified()
+{
+    // Resume data could be requested ignoring the changes of counters,
+    // so they should be stored separately if they have been changed
+    const TorrentCounters counters = makeCounters(m_nativeStatus);
+    if (counters == m_storedCounters)
+        return;
+
+    m_storedCounters = counters;
+    m_session->handleTorrentCountersReady(this, counters);
+}
+
 void TorrentImpl::prepareResumeData(lt::add_torrent_params params)
 {
     {
@@ -2211,8 +2653,25 @@ void TorrentImpl::prepareResumeData(lt::add_torrent_params params)
             m_ltAddTorrentParams.flags |= lt::torrent_flags::seed_mode;
     }
 
+    if (!m_recentPeers.empty())
+    {
+        // The peers recently exchanged the payload with go ahead of the ones libtorrent has chosen
+        std::vector<lt::tcp::endpoint> &peers = m_ltAddTorrentParams.peers;
+        std::erase_if(peers, [this](const lt::tcp::endpoint &endpoint)
+        {
+            return (std::ranges::find(m_recentPeers, endpoint) != m_recentPeers.cend());
+        });
+        peers.insert(peers.begin(), m_recentPeers.cbegin(), m_recentPeers.cend());
+    }
+    m_recentPeersChanged = false;
+
     // We shouldn't save upload_mode flag to allow torrent operate normally on next run
     m_ltAddTorrentParams.flags &= ~lt::torrent_flags::upload_mode;
+    // The native limits can be lowered by the category limits, only the own limits of the torrent are saved
+    m_ltAddTorrentParams.download_limit = m_downloadLimit;
+    m_ltAddTorrentParams.upload_limit = m_uploadLimit;
+
+    m_storedCounters = makeCounters(m_ltAddTorrentParams);
 
     LoadTorrentParams resumeData
     {
@@ -2238,6 +2697,7 @@ void TorrentImpl::prepareResumeData(lt::add_torrent_params params)
         .sslParameters = m_sslParams
     };
 
+    m_resumeDataSaveTimer.start();
     m_session->handleTorrentResumeDataReady(this, std::move(resumeData));
 }
 
@@ -2254,6 +2714,7 @@ void TorrentImpl::handleFileRenamed(const lt::file_index_t nativeFileIndex, cons
 
     const Path oldFilePath = m_filePaths.at(fileIndex);
     const Path newFilePath = makeUserPath(newActualFilePath);
+    const bool isRenamedWithFolder = m_folderRenamedFiles.remove(fileIndex);
 
     // Check if ".!qB" extension or ".unwanted" folder was just added or removed
     // We should compare path in a case sensitive manner even on case insensitive
@@ -2287,6 +2748,11 @@ void TorrentImpl::handleFileRenamed(const lt::file_index_t nativeFileIndex, cons
         }
 #endif
     }
+    else if (isRenamedWithFolder)
+    {
+        // the leftover folders are already removed along with renaming the folder
+        m_filePaths[fileIndex] = newFilePath;
+    }
     else
     {
         m_filePaths[fileIndex] = newFilePath;
@@ -2307,7 +2773,9 @@ void TorrentImpl::handleFileRenamed(const lt::file_index_t nativeFileIndex, cons
     while (!isMoveInProgress() && (m_renameCount == 0) && !m_moveFinishedTriggers.isEmpty())
         m_moveFinishedTriggers.takeFirst()();
 
-    deferredRequestResumeData();
+    // the file paths renamed together are saved at once
+    if (m_renameCount == 0)
+        deferredRequestResumeData();
 }
 
 void TorrentImpl::handleFileRenameFailed(const lt::file_index_t nativeFileIndex)
@@ -2315,11 +2783,26 @@ void TorrentImpl::handleFileRenameFailed(const lt::file_index_t nativeFileIndex)
     const int fileIndex = fileIndexFromNative(nativeFileIndex);
     Q_ASSERT(fileIndex >= 0);
 
+    m_folderRenamedFiles.remove(fileIndex);
+
     --m_renameCount;
     while (!isMoveInProgress() && (m_renameCount == 0) && !m_moveFinishedTriggers.isEmpty())
         m_moveFinishedTriggers.takeFirst()();
 
-    deferredRequestResumeData();
+    if (m_renameCount == 0)
+        deferredRequestResumeData();
+}
+
+void TorrentImpl::handlePieceRead(const lt::piece_index_t nativePieceIndex, const QByteArray &data)
+{
+    const auto iter = m_pendingPieceReads.find(LT::toUnderlyingType(nativePieceIndex));
+    if (iter == m_pendingPieceReads.end())
+        return;
+
+    QPromise<QByteArray> promise = std::move(iter->second);
+    m_pendingPieceReads.erase(iter);
+    promise.addResult(data);
+    promise.finish();
 }
 
 void TorrentImpl::handleFileCompleted(const lt::file_index_t nativeFileIndex)
@@ -2379,15 +2862,7 @@ void TorrentImpl::handleCategoryOptionsChanged()
         adjustStorageLocation();
 }
 
-void TorrentImpl::handleAppendExtensionToggled()
-{
-    if (!hasMetadata())
-        return;
-
-    manageActualFilePaths();
-}
-
-void TorrentImpl::handleUnwantedFolderToggled()
+void TorrentImpl::handleActualFilePathsOptionsChanged()
 {
     if (!hasMetadata())
         return;
@@ -2404,7 +2879,7 @@ void TorrentImpl::manageActualFilePaths()
     {
         const Path path = filePath(i);
 
-        const auto nativeIndex = m_torrentInfo.nativeIndexes().at(i);
+        const auto nativeIndex = loadedTorrentInfo().nativeIndexes().at(i);
         const Path actualPath {nativeFiles.file_path(nativeIndex)};
         const Path targetActualPath = makeActualPath(i, path);
         if (actualPath != targetActualPath)
@@ -2426,7 +2901,7 @@ void TorrentImpl::adjustStorageLocation()
 
 void TorrentImpl::doRenameFile(const int index, const Path &path)
 {
-    const QList<lt::file_index_t> nativeIndexes = m_torrentInfo.nativeIndexes();
+    const QList<lt::file_index_t> nativeIndexes = loadedTorrentInfo().nativeIndexes();
 
     Q_ASSERT(index >= 0);
     Q_ASSERT(index < nativeIndexes.size());
@@ -2437,6 +2912,62 @@ void TorrentImpl::doRenameFile(const int index, const Path &path)
     m_nativeHandle.rename_file(nativeIndexes[index], path.toString().toStdString());
 }
 
+void TorrentImpl::renameFolderFiles(const QList<int> &fileIndexes, const Path &oldFolderPath, const Path &newFolderPath)
+{
+    if (!renameFolderDirectory(fileIndexes, oldFolderPath, newFolderPath))
+        TorrentContentHandler::renameFolderFiles(fileIndexes, oldFolderPath, newFolderPath);
+}
+
+bool TorrentImpl::renameFolderDirectory(const QList<int> &fileIndexes, const Path &oldFolderPath, const Path &newFolderPath)
+{
+    // The folder can be renamed on disk at once only while libtorrent doesn't access its files.
+    // Then libtorrent just updates the file names, since the files don't exist at the old paths anymore,
+    // instead of renaming each file on disk.
+    if (!hasMetadata() || !m_isStopped || isChecking() || isMoveInProgress() || (m_renameCount > 0))
+        return false;
+
+    QList<Path> newActualFilePaths;
+    newActualFilePaths.reserve(fileIndexes.size());
+    for (const int index : fileIndexes)
+    {
+        const Path actualPath = actualFilePath(index);
+        if (!actualPath.hasAncestor(oldFolderPath))
+            return false;
+
+        newActualFilePaths.append(newFolderPath / oldFolderPath.relativePathOf(actualPath));
+    }
+
+    const Path storageLocation = actualStorageLocation();
+    const Path oldActualFolderPath = storageLocation / oldFolderPath;
+    const Path newActualFolderPath = storageLocation / newFolderPath;
+    if (oldActualFolderPath.exists())
+    {
+        // the folder may contain files of other torrents
+        if (newActualFolderPath.exists() || !Utils::Fs::mkpath(newActualFolderPath.parentPath())
+                || !QDir().rename(oldActualFolderPath.data(), newActualFolderPath.data()))
+        {
+            return false;
+        }
+
+        // Remove empty leftover folders, see handleFileRenamed()
+        Path oldParentPath = oldFolderPath.parentPath();
+        const Path commonBasePath = Path::commonPath(oldParentPath, newFolderPath.parentPath());
+        while (oldParentPath != commonBasePath)
+        {
+            Utils::Fs::rmdir(storageLocation / oldParentPath);
+            oldParentPath = oldParentPath.parentPath();
+        }
+    }
+
+    for (qsizetype i = 0; i < fileIndexes.size(); ++i)
+    {
+        m_folderRenamedFiles.insert(fileIndexes[i]);
+        doRenameFile(fileIndexes[i], newActualFilePaths[i]);
+    }
+
+    return true;
+}
+
 lt::torrent_handle TorrentImpl::nativeHandle() const
 {
     return m_nativeHandle;
@@ -2528,7 +3059,48 @@ void TorrentImpl::updateStatus(const lt::torrent_status &nativeStatus)
     if (nativeStatus.handle != m_nativeHandle) [[unlikely]]
         return;
 
+    updatePeerStatistics();
+
     const lt::torrent_status oldStatus = std::exchange(m_nativeStatus, nativeStatus);
+    // The availability isn't queried with the status updates, it is updated separately
+    m_nativeStatus.distributed_full_copies = oldStatus.distributed_full_copies;
+    m_nativeStatus.distributed_fraction = oldStatus.distributed_fraction;
+    m_nativeStatus.distributed_copies = oldStatus.distributed_copies;
+
+    const auto markChanged = [this](const ChangedField field, const bool isChanged)
+    {
+        if (isChanged)
+            m_changedFields |= field;
+    };
+
+    markChanged(ChangedField::State, ((m_nativeStatus.errc != oldStatus.errc)
+            || (m_nativeStatus.flags != oldStatus.flags)));
+    markChanged(ChangedField::QueuePosition, (m_nativeStatus.queue_position != oldStatus.queue_position));
+    markChanged(ChangedField::Progress, ((m_nativeStatus.num_pieces != oldStatus.num_pieces)
+            || (m_nativeStatus.progress != oldStatus.progress)
+            || (m_nativeStatus.total_done != oldStatus.total_done)
+            || (m_nativeStatus.total_wanted != oldStatus.total_wanted)
+            || (m_nativeStatus.total_wanted_done != oldStatus.total_wanted_done)));
+    markChanged(ChangedField::Peers, ((m_nativeStatus.num_seeds != oldStatus.num_seeds)
+            || (m_nativeStatus.num_peers != oldStatus.num_peers)
+            || (m_nativeStatus.num_complete != oldStatus.num_complete)
+            || (m_nativeStatus.num_incomplete != oldStatus.num_incomplete)
+            || (m_nativeStatus.list_seeds != oldStatus.list_seeds)
+            || (m_nativeStatus.list_peers != oldStatus.list_peers)));
+    markChanged(ChangedField::Speed, ((m_nativeStatus.download_payload_rate != oldStatus.download_payload_rate)
+            || (m_nativeStatus.upload_payload_rate != oldStatus.upload_payload_rate)));
+    markChanged(ChangedField::Transfer, ((m_nativeStatus.all_time_download != oldStatus.all_time_download)
+            || (m_nativeStatus.all_time_upload != oldStatus.all_time_upload)
+            || (m_nativeStatus.total_payload_download != oldStatus.total_payload_download)
+            || (m_nativeStatus.total_payload_upload != oldStatus.total_payload_upload)));
+    markChanged(ChangedField::Activity, ((m_nativeStatus.active_duration != oldStatus.active_duration)
+            || (m_nativeStatus.finished_duration != oldStatus.finished_duration)
+            || (m_nativeStatus.last_upload != oldStatus.last_upload)
+            || (m_nativeStatus.last_download != oldStatus.last_download)));
+    markChanged(ChangedField::Trackers, ((m_nativeStatus.current_tracker != oldStatus.current_tracker)
+            || (m_nativeStatus.next_announce != oldStatus.next_announce)));
+    markChanged(ChangedField::Dates, ((m_nativeStatus.completed_time != oldStatus.completed_time)
+            || (m_nativeStatus.last_seen_complete != oldStatus.last_seen_complete)));
 
     if (m_nativeStatus.num_pieces != oldStatus.num_pieces)
         updateProgress();
@@ -2570,20 +3142,23 @@ void TorrentImpl::updateProgress()
 
     const QBitArray oldPieces = std::exchange(m_pieces, LT::toQBitArray(m_nativeStatus.pieces));
     const QBitArray newPieces = m_pieces ^ oldPieces;
+    if (newPieces.count(true) == 0)
+        return;
 
-    const int64_t pieceSize = m_torrentInfo.pieceLength();
+    const TorrentInfo &torrentInfo = loadedTorrentInfo();
+    const int64_t pieceSize = torrentInfo.pieceLength();
     for (qsizetype index = 0; index < newPieces.size(); ++index)
     {
         if (!newPieces.at(index))
             continue;
 
-        int64_t size = m_torrentInfo.pieceLength(index);
+        int64_t size = torrentInfo.pieceLength(index);
         int64_t pieceOffset = index * pieceSize;
 
-        for (const int fileIndex : asConst(m_torrentInfo.fileIndicesForPiece(index)))
+        for (const int fileIndex : asConst(torrentInfo.fileIndicesForPiece(index)))
         {
-            const int64_t fileOffsetInPiece = pieceOffset - m_torrentInfo.fileOffset(fileIndex);
-            const int64_t add = std::min<int64_t>((m_torrentInfo.fileSize(fileIndex) - fileOffsetInPiece), size);
+            const int64_t fileOffsetInPiece = pieceOffset - torrentInfo.fileOffset(fileIndex);
+            const int64_t add = std::min<int64_t>((torrentInfo.fileSize(fileIndex) - fileOffsetInPiece), size);
 
             m_filesProgress[fileIndex] += add;
 
@@ -2657,7 +3232,7 @@ void TorrentImpl::setUploadLimit(const int limit)
         return;
 
     m_uploadLimit = cleanValue;
-    m_nativeHandle.set_upload_limit(m_uploadLimit);
+    m_nativeHandle.set_upload_limit(effectiveLimit(m_uploadLimit, m_categoryUploadLimit));
     deferredRequestResumeData();
 }
 
@@ -2668,10 +3243,45 @@ void TorrentImpl::setDownloadLimit(const int limit)
         return;
 
     m_downloadLimit = cleanValue;
-    m_nativeHandle.set_download_limit(m_downloadLimit);
+    m_nativeHandle.set_download_limit(effectiveLimit(m_downloadLimit, m_categoryDownloadLimit));
     deferredRequestResumeData();
 }
 
+void TorrentImpl::setCategoryLimits(const int downloadLimit, const int uploadLimit, const int connectionsLimit)
+{
+    if (downloadLimit != m_categoryDownloadLimit)
+    {
+        const int prevNativeLimit = effectiveLimit(m_downloadLimit, m_categoryDownloadLimit);
+        m_categoryDownloadLimit = downloadLimit;
+        if (const int nativeLimit = effectiveLimit(m_downloadLimit, m_categoryDownloadLimit); nativeLimit != prevNativeLimit)
+            m_nativeHandle.set_download_limit(nativeLimit);
+    }
+
+    if (uploadLimit != m_categoryUploadLimit)
+    {
+        const int prevNativeLimit = effectiveLimit(m_uploadLimit, m_categoryUploadLimit);
+        m_categoryUploadLimit = uploadLimit;
+        if (const int nativeLimit = effectiveLimit(m_uploadLimit, m_categoryUploadLimit); nativeLimit != prevNativeLimit)
+            m_nativeHandle.set_upload_limit(nativeLimit);
+    }
+
+    if (connectionsLimit != m_categoryConnectionsLimit)
+    {
+        m_categoryConnectionsLimit = connectionsLimit;
+        applyConnectionsLimit();
+    }
+}
+
+void TorrentImpl::applyConnectionsLimit()
+{
+    const int limit = effectiveLimit(m_session->maxConnectionsPerTorrent(), m_categoryConnectionsLimit);
+    try
+    {
+        m_nativeHandle.set_max_connections((limit > 0) ? limit : -1);
+    }
+    catch (const std::exception &) {}
+}
+
 void TorrentImpl::setSuperSeeding(const bool enable)
 {
     if (enable == superSeeding())
@@ -2803,9 +3413,15 @@ nonstd::expected<void, QString> TorrentImpl::exportToFile(const Path &path) cons
     return {};
 }
 
+PeerStatistics TorrentImpl::peerStatistics() const
+{
+    return m_peerStatistics;
+}
+
 QFuture<QList<PeerInfo>> TorrentImpl::fetchPeerInfo() const
 {
-    return invokeAsync([nativeHandle = m_nativeHandle, allPieces = pieces()]() -> QList<PeerInfo>
+    return invokeAsync([nativeHandle = m_nativeHandle, allPieces = pieces()
+            , geoIPDatabase = Net::GeoIPManager::instance()->database()]() -> QList<PeerInfo>
     {
         try
         {
@@ -2814,7 +3430,10 @@ QFuture<QList<PeerInfo>> TorrentImpl::fetchPeerInfo() const
             QList<PeerInfo> peers;
             peers.reserve(static_cast<decltype(peers)::size_type>(nativePeers.size()));
             for (const lt::peer_info &peer : nativePeers)
-                peers.append(PeerInfo(peer, allPieces));
+            {
+                PeerInfo &peerInfo = peers.emplaceBack(peer, allPieces);
+                peerInfo.resolveCountry(geoIPDatabase.get());
+            }
             return peers;
         }
         catch (const std::exception &) {}
@@ -2823,6 +3442,34 @@ QFuture<QList<PeerInfo>> TorrentImpl::fetchPeerInfo() const
     });
 }
 
+QFuture<PeerInfoChanges> TorrentImpl::fetchPeerInfoChanges(std::shared_ptr<const PeerInfoSnapshot> snapshot) const
+{
+    // The relevance and the country of the peers as well as the changes are calculated
+    // in the worker thread so the caller has to handle the changed peers only
+    return invokeAsync([nativeHandle = m_nativeHandle, allPieces = pieces(), snapshot = std::move(snapshot)
+            , geoIPDatabase = Net::GeoIPManager::instance()->database()]() -> PeerInfoChanges
+    {
+        try
+        {
+            std::vector<lt::peer_info> nativePeers;
+            nativeHandle.get_peer_info(nativePeers);
+            QList<PeerInfo> peers;
+            peers.reserve(static_cast<decltype(peers)::size_type>(nativePeers.size()));
+            for (const lt::peer_info &peer : nativePeers)
+                peers.append(PeerInfo(peer, allPieces));
+
+            PeerInfoChanges changes = calculatePeerInfoChanges(peers, snapshot);
+            for (PeerInfo &peer : changes.updatedPeers)
+                peer.resolveCountry(geoIPDatabase.get());
+            return changes;
+        }
+        catch (const std::exception &) {}
+
+        // Keep the previous state so the next changes are still calculated against it
+        return {.snapshot = snapshot};
+    });
+}
+
 QFuture<QList<QUrl>> TorrentImpl::fetchURLSeeds() const
 {
     return invokeAsync([nativeHandle = m_nativeHandle]() -> QList<QUrl>
@@ -2860,7 +3507,7 @@ QFuture<QList<int>> TorrentImpl::fetchPieceAvailability() const
 
 QFuture<QBitArray> TorrentImpl::fetchDownloadingPieces() const
 {
-    return invokeAsync([nativeHandle = m_nativeHandle, torrentInfo = m_torrentInfo]() -> QBitArray
+    return invokeAsync([nativeHandle = m_nativeHandle, torrentInfo = loadedTorrentInfo()]() -> QBitArray
     {
         try
         {
@@ -2884,7 +3531,7 @@ QFuture<QBitArray> TorrentImpl::fetchDownloadingPieces() const
 
 QFuture<QList<qreal>> TorrentImpl::fetchAvailableFileFractions() const
 {
-    return invokeAsync([nativeHandle = m_nativeHandle, torrentInfo = m_torrentInfo]() -> QList<qreal>
+    return invokeAsync([nativeHandle = m_nativeHandle, torrentInfo = loadedTorrentInfo()]() -> QList<qreal>
     {
         if (!torrentInfo.isValid() || (torrentInfo.filesCount() <= 0))
             return {};
@@ -2942,9 +3589,9 @@ void TorrentImpl::prioritizeFiles(const QList<DownloadPriority> &priorities)
         }
     }
 
-    const int internalFilesCount = m_torrentInfo.nativeInfo()->files().num_files(); // including .pad files
+    const int internalFilesCount = loadedTorrentInfo().nativeInfo()->files().num_files(); // including .pad files
     auto nativePriorities = std::vector<lt::download_priority_t>(internalFilesCount, LT::toNative(DownloadPriority::Normal));
-    const auto nativeIndexes = m_torrentInfo.nativeIndexes();
+    const auto nativeIndexes = loadedTorrentInfo().nativeIndexes();
     for (qsizetype i = 0; i < priorities.size(); ++i)
         nativePriorities[LT::toUnderlyingType(nativeIndexes[i])] = LT::toNative(priorities[i]);
 
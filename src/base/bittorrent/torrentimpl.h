@@ -31,6 +31,10 @@
 
 #include <functional>
 #include <memory>
+#include <optional>
+#include <set>
+#include <unordered_map>
+#include <vector>
 
 #include <libtorrent/add_torrent_params.hpp>
 #include <libtorrent/fwd.hpp>
@@ -40,23 +44,30 @@
 
 #include <QBitArray>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QHash>
 #include <QList>
 #include <QMap>
 #include <QObject>
+#include <QPromise>
 #include <QQueue>
+#include <QSet>
 #include <QString>
 
 #include "base/path.h"
 #include "base/tagset.h"
 #include "infohash.h"
+#include "peerstatistics.h"
 #include "speedmonitor.h"
 #include "sslparameters.h"
 #include "torrent.h"
 #include "torrentcontentlayout.h"
+#include "torrentcounters.h"
 #include "torrentinfo.h"
 #include "trackerentrystatus.h"
 
+struct PeerTrafficData;
+
 namespace BitTorrent
 {
     class SessionImpl;
@@ -138,6 +149,7 @@ namespace BitTorrent
         int piecesCount() const override;
         int piecesHave() const override;
         qreal progress() const override;
+        qreal preallocationProgress() const override;
 
         QDateTime addedTime() const override;
         QDateTime completedTime() const override;
@@ -180,6 +192,7 @@ namespace BitTorrent
         bool isSequentialDownload() const override;
         bool hasFirstLastPiecePriority() const override;
         TorrentState state() const override;
+        ChangedFields changedFields() const override;
         bool hasMetadata() const override;
         bool hasMissingFiles() const override;
         bool hasError() const override;
@@ -221,6 +234,9 @@ namespace BitTorrent
         void setName(const QString &name) override;
         void setSequentialDownload(bool enable) override;
         void setFirstLastPiecePriority(bool enabled) override;
+        void setStreamingPosition(int fileIndex, qint64 position) override;
+        void stopStreaming(int fileIndex) override;
+        QFuture<QByteArray> fetchPieceData(int pieceIndex) override;
         void stop() override;
         void start(TorrentOperatingMode mode = TorrentOperatingMode::AutoManaged) override;
         void forceReannounce(int index = -1) override;
@@ -254,13 +270,27 @@ namespace BitTorrent
         nonstd::expected<QByteArray, QString> exportToBuffer() const override;
         nonstd::expected<void, QString> exportToFile(const Path &path) const override;
 
+        PeerStatistics peerStatistics() const override;
         QFuture<QList<PeerInfo>> fetchPeerInfo() const override;
+        QFuture<PeerInfoChanges> fetchPeerInfoChanges(std::shared_ptr<const PeerInfoSnapshot> snapshot) const override;
         QFuture<QList<QUrl>> fetchURLSeeds() const override;
         QFuture<QList<int>> fetchPieceAvailability() const override;
         QFuture<QBitArray> fetchDownloadingPieces() const override;
         QFuture<QList<qreal>> fetchAvailableFileFractions() const override;
 
+        void clearChangedFields();
         bool needSaveResumeData() const;
+        // Time (in ms) elapsed since the resume data was last handed over to the storage
+        qint64 resumeDataAge() const;
+        // Releases the metadata of the stopped torrent that has not been accessed since the previous call,
+        // it is loaded again on demand
+        bool releaseMetadata();
+        // Rough estimation of the memory used by the torrent data (not including libtorrent's own data)
+        qint64 estimatedMemoryUsage() const;
+        // Share of the limits of the torrent category, 0 means unlimited.
+        // The own limits of the torrent are applied instead when they are lower
+        void setCategoryLimits(int downloadLimit, int uploadLimit, int connectionsLimit);
+        void applyConnectionsLimit();
 
         // Session interface
         lt::torrent_handle nativeHandle() const;
@@ -268,31 +298,58 @@ namespace BitTorrent
         int fileIndexFromNative(lt::file_index_t nativeFileIndex) const;
 
         void handleStateUpdate(const lt::torrent_status &nativeStatus);
+        // Updates the availability only, returns true if it is changed
+        bool updateAvailability(const lt::torrent_status &nativeStatus);
         void handleFastResumeRejected();
         void handleFileCompleted(lt::file_index_t nativeFileIndex);
+        void handlePieceRead(lt::piece_index_t nativePieceIndex, const QByteArray &data);
         void handleFileError(FileErrorInfo fileError);
         void handleFileRenamed(lt::file_index_t nativeFileIndex, const Path &newActualFilePath, const Path &oldActualFilePath);
         void handleFileRenameFailed(lt::file_index_t nativeFileIndex);
         void handleMetadataReceived();
         void handleSaveResumeData(lt::add_torrent_params params);
+        void handleSaveResumeDataNotModified();
+        void handleDeferredResumeDataRequest();
+        // Returns false if there is no outstanding request, e.g. it was already answered
+        // after the request was resent
+        bool takeResumeDataRequest();
+        // Resends the outstanding request, its answer may have been dropped with the alerts
+        void resendResumeDataRequest();
         void handleTorrentChecked();
         void handleTorrentFinished();
         void handleQueueingModeChanged();
         void handleCategoryOptionsChanged();
-        void handleAppendExtensionToggled();
-        void handleUnwantedFolderToggled();
+        void handleActualFilePathsOptionsChanged();
         void requestResumeData(lt::resume_data_flags_t flags = {});
         void deferredRequestResumeData();
         void handleMoveStorageJobFinished(const Path &path, MoveStorageContext context, bool hasOutstandingJob);
         TrackerEntryStatus updateTrackerEntryStatus(const lt::announce_entry &announceEntry, const QHash<lt::tcp::endpoint, QMap<int, int>> &updateInfo);
         void resetTrackerEntryStatuses();
+        // The dormant seed is paused internally without being stopped while nobody asks for it.
+        // Starting, stopping, reloading or checking the torrent wakes it up.
+        bool isDormant() const;
+        void setDormant(bool dormant);
+        void setPreallocationProgress(qreal progress);
 
     private:
         using EventTrigger = std::function<void ()>;
 
+        struct MetadataSummary
+        {
+            QString name;
+            qlonglong totalSize = 0;
+            int pieceLength = 0;
+            int filesCount = 0;
+            int piecesCount = 0;
+            bool isPrivate = false;
+        };
+
         std::shared_ptr<const lt::torrent_info> nativeTorrentInfo() const;
+        const TorrentInfo &loadedTorrentInfo() const;
 
         void updateStatus(const lt::torrent_status &nativeStatus);
+        void updatePeerStatistics();
+        void updateRecentPeers(const std::set<lt::tcp::endpoint> &usefulPeers);
         void updateProgress();
         void updateState();
 
@@ -304,6 +361,8 @@ namespace BitTorrent
         Path makeUserPath(const Path &path) const;
         void adjustStorageLocation();
         void doRenameFile(int index, const Path &path);
+        void renameFolderFiles(const QList<int> &fileIndexes, const Path &oldFolderPath, const Path &newFolderPath) override;
+        bool renameFolderDirectory(const QList<int> &fileIndexes, const Path &oldFolderPath, const Path &newFolderPath);
         void moveStorage(const Path &newPath, MoveStorageContext context);
         void manageActualFilePaths();
         void applyFirstLastPiecePriority(bool enabled);
@@ -321,7 +380,11 @@ namespace BitTorrent
         lt::torrent_handle m_nativeHandle;
         mutable lt::torrent_status m_nativeStatus;
         TorrentState m_state = TorrentState::Unknown;
-        TorrentInfo m_torrentInfo;
+        ChangedFields m_changedFields;
+        mutable TorrentInfo m_torrentInfo;
+        // Keeps the most used properties while the metadata is released
+        mutable std::optional<MetadataSummary> m_releasedMetadata;
+        mutable bool m_isMetadataAccessed = false;
         PathList m_filePaths;
         QHash<lt::file_index_t, int> m_indexMap;
         QList<DownloadPriority> m_filePriorities;
@@ -342,6 +405,8 @@ namespace BitTorrent
         // all file rename jobs complete, all file move jobs complete
         QQueue<EventTrigger> m_moveFinishedTriggers;
         int m_renameCount = 0;
+        // Files renamed along with their folder renamed on disk at once
+        QSet<int> m_folderRenamedFiles;
         bool m_storageIsMoving = false;
 
         QQueue<EventTrigger> m_statusUpdatedTriggers;
@@ -352,6 +417,14 @@ namespace BitTorrent
         QList<QUrl> m_urlSeeds;
         FileErrorInfo m_lastFileError;
 
+        // Traffic counted by the peer plugins is taken from here along with the status updates
+        std::shared_ptr<PeerTrafficData> m_peerTraffic;
+        PeerStatistics m_peerStatistics;
+        // Peers recently exchanged the payload with, the most recent go first.
+        // They're stored with the resume data to be reconnected quickly on the next run.
+        std::vector<lt::tcp::endpoint> m_recentPeers;
+        bool m_recentPeersChanged = false;
+
         // Persistent data
         QString m_name;
         Path m_savePath;
@@ -369,6 +442,8 @@ namespace BitTorrent
         bool m_hasFirstLastPiecePriority = false;
         bool m_useAutoTMM = false;
         bool m_isStopped = false;
+        bool m_isDormant = false;
+        qreal m_preallocationProgress = 1;
         StopCondition m_stopCondition = StopCondition::None;
         SSLParameters m_sslParams;
 
@@ -378,10 +453,21 @@ namespace BitTorrent
 
         int m_downloadLimit = 0;
         int m_uploadLimit = 0;
+        int m_categoryDownloadLimit = 0;
+        int m_categoryUploadLimit = 0;
+        int m_categoryConnectionsLimit = 0;
 
         QBitArray m_pieces;
         QList<std::int64_t> m_filesProgress;
 
+        // Pieces requested with deadlines for the streamed files
+        QHash<int, TorrentInfo::PieceRange> m_streamingWindows;
+        std::unordered_map<int, QPromise<QByteArray>> m_pendingPieceReads;
+
         bool m_deferredRequestResumeDataInvoked = false;
+        int m_pendingResumeDataRequests = 0;
+        QElapsedTimer m_resumeDataSaveTimer;
+        // Counters contained in the most recently stored resume data
+        TorrentCounters m_storedCounters;
     };
 }
@@ -28,6 +28,8 @@
 
 #include "torrentinfo.h"
 
+#include <algorithm>
+
 #include <libtorrent/version.hpp>
 
 #include <QByteArray>
@@ -51,10 +53,14 @@ TorrentInfo::TorrentInfo(const lt::torrent_info &nativeInfo)
 
     const lt::file_storage &fileStorage = m_nativeInfo->orig_files();
     m_nativeIndexes.reserve(fileStorage.num_files());
+    m_filePaths.reserve(fileStorage.num_files());
     for (const lt::file_index_t nativeIndex : fileStorage.file_range())
     {
         if (!fileStorage.pad_file_at(nativeIndex))
+        {
             m_nativeIndexes.append(nativeIndex);
+            m_filePaths.append(Path(fileStorage.file_path(nativeIndex)));
+        }
     }
 }
 
@@ -64,6 +70,7 @@ TorrentInfo &TorrentInfo::operator=(const TorrentInfo &other)
     {
         m_nativeInfo = other.m_nativeInfo;
         m_nativeIndexes = other.m_nativeIndexes;
+        m_filePaths = other.m_filePaths;
     }
     return *this;
 }
@@ -142,17 +149,12 @@ Path TorrentInfo::filePath(const int index) const
     if ((index < 0) || (index >= m_nativeIndexes.size()))
         return {};
 
-    return Path(m_nativeInfo->orig_files().file_path(m_nativeIndexes[index]));
+    return m_filePaths[index];
 }
 
 PathList TorrentInfo::filePaths() const
 {
-    PathList list;
-    list.reserve(filesCount());
-    for (int i = 0; i < filesCount(); ++i)
-        list << filePath(i);
-
-    return list;
+    return m_filePaths;
 }
 
 qlonglong TorrentInfo::fileSize(const int index) const
@@ -198,7 +200,7 @@ PathList TorrentInfo::filesForPiece(const int pieceIndex) const
     PathList res;
     res.reserve(fileIndices.size());
     for (const int i : fileIndices)
-        res.push_back(filePath(i));
+        res.push_back(m_filePaths[i]);
 
     return res;
 }
@@ -208,15 +210,23 @@ QList<int> TorrentInfo::fileIndicesForPiece(const int pieceIndex) const
     if (!isValid() || (pieceIndex < 0) || (pieceIndex >= piecesCount()))
         return {};
 
-    const std::vector<lt::file_slice> files = m_nativeInfo->map_block(
-                lt::piece_index_t {pieceIndex}, 0, m_nativeInfo->piece_size(lt::piece_index_t {pieceIndex}));
+    const lt::file_storage &files = m_nativeInfo->orig_files();
+    const qint64 pieceOffset = static_cast<qint64>(pieceIndex) * pieceLength();
+    const qint64 pieceEnd = pieceOffset + pieceLength(pieceIndex);
+
+    // The files follow each other in the order of their indexes, so the ones
+    // overlapping the piece are contiguous and the first of them can be searched
+    const auto firstIter = std::ranges::partition_point(m_nativeIndexes, [&files, pieceOffset](const lt::file_index_t nativeIndex)
+    {
+        return ((files.file_offset(nativeIndex) + files.file_size(nativeIndex)) <= pieceOffset);
+    });
+
     QList<int> res;
-    res.reserve(static_cast<decltype(res)::size_type>(files.size()));
-    for (const lt::file_slice &fileSlice : files)
+    for (auto iter = firstIter; (iter != m_nativeIndexes.cend()) && (files.file_offset(*iter) < pieceEnd); ++iter)
     {
-        const qsizetype index = m_nativeIndexes.indexOf(fileSlice.file_index);
-        if (index >= 0)
-            res.append(index);
+        // empty files don't occupy any part of the piece
+        if (files.file_size(*iter) > 0)
+            res.append(static_cast<int>(iter - m_nativeIndexes.cbegin()));
     }
 
     return res;
@@ -293,14 +303,8 @@ bool TorrentInfo::matchesInfoHash(const InfoHash &otherInfoHash) const
 int TorrentInfo::fileIndex(const Path &filePath) const
 {
     // the check whether the object is valid is not needed here
-    // because if filesCount() returns -1 the loop exits immediately
-    for (int i = 0; i < filesCount(); ++i)
-    {
-        if (filePath == this->filePath(i))
-            return i;
-    }
-
-    return -1;
+    // because the list of the file paths is empty then
+    return m_filePaths.indexOf(filePath);
 }
 
 std::shared_ptr<lt::torrent_info> TorrentInfo::nativeInfo() const
@@ -35,7 +35,7 @@
 #include <QList>
 
 #include "base/indexrange.h"
-#include "base/pathfwd.h"
+#include "base/path.h"
 
 class QByteArray;
 class QDateTime;
@@ -96,6 +96,8 @@ namespace BitTorrent
         // internal indexes of files (payload only, excluding any .pad files)
         // by which they are addressed in libtorrent
         QList<lt::file_index_t> m_nativeIndexes;
+        // built once, the copies of TorrentInfo (and the lists returned by filePaths()) share it
+        PathList m_filePaths;
     };
 }
 
@@ -0,0 +1,123 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentsnapshot.h"
+
+#include <algorithm>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QDataStream>
+#include <QList>
+
+#include "base/path.h"
+#include "base/utils/io.h"
+
+namespace
+{
+    const QByteArray SNAPSHOT_SIGNATURE = QByteArrayLiteral("qBittorrent torrents snapshot\n");
+    const quint32 SNAPSHOT_VERSION = 1;
+    // Snapshot is only a placeholder, so it isn't worth loading when it is unexpectedly large
+    const qint64 SNAPSHOT_SIZE_LIMIT = 100 * 1024 * 1024;
+}
+
+BitTorrent::TorrentSnapshot BitTorrent::makeTorrentSnapshot(const Torrent *torrent)
+{
+    return {
+        .id = torrent->id(),
+        .name = torrent->name(),
+        .wantedSize = torrent->wantedSize(),
+        .progress = torrent->progress(),
+        .state = torrent->state(),
+        .category = torrent->category(),
+        .tags = torrent->tags(),
+        .ratio = torrent->realRatio()
+    };
+}
+
+nonstd::expected<QList<BitTorrent::TorrentSnapshot>, QString> BitTorrent::loadTorrentSnapshots(const Path &path)
+{
+    const auto readResult = Utils::IO::readFile(path, SNAPSHOT_SIZE_LIMIT);
+    if (!readResult)
+        return nonstd::make_unexpected(readResult.error().message);
+
+    const QByteArray &data = readResult.value();
+    if (!data.startsWith(SNAPSHOT_SIGNATURE))
+        return nonstd::make_unexpected(QCoreApplication::translate("BitTorrent::TorrentSnapshot", "Unsupported file format."));
+
+    QDataStream stream {data};
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.skipRawData(SNAPSHOT_SIGNATURE.size());
+
+    quint32 version = 0;
+    quint32 count = 0;
+    stream >> version >> count;
+    if (version != SNAPSHOT_VERSION)
+        return nonstd::make_unexpected(QCoreApplication::translate("BitTorrent::TorrentSnapshot", "Unsupported file format."));
+
+    QList<TorrentSnapshot> snapshots;
+    snapshots.reserve(std::min<qsizetype>(count, (data.size() / TorrentID::length())));
+    for (quint32 i = 0; (i < count) && (stream.status() == QDataStream::Ok); ++i)
+    {
+        QByteArray torrentID;
+        TorrentSnapshot snapshot;
+        qint32 state = 0;
+        QList<Tag> tags;
+        stream >> torrentID >> snapshot.name >> snapshot.wantedSize >> snapshot.progress
+                >> state >> snapshot.category >> tags >> snapshot.ratio;
+
+        snapshot.id = TorrentID::fromString(QString::fromLatin1(torrentID));
+        snapshot.state = static_cast<TorrentState>(state);
+        snapshot.tags = TagSet(tags.cbegin(), tags.cend());
+        snapshots.append(snapshot);
+    }
+
+    if (stream.status() != QDataStream::Ok)
+        return nonstd::make_unexpected(QCoreApplication::translate("BitTorrent::TorrentSnapshot", "File is corrupted."));
+
+    return snapshots;
+}
+
+nonstd::expected<void, QString> BitTorrent::saveTorrentSnapshots(const Path &path, const QList<TorrentSnapshot> &snapshots)
+{
+    QByteArray data;
+    {
+        QDataStream stream {&data, QIODevice::WriteOnly};
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream.writeRawData(SNAPSHOT_SIGNATURE.constData(), SNAPSHOT_SIGNATURE.size());
+        stream << SNAPSHOT_VERSION << static_cast<quint32>(snapshots.size());
+        for (const TorrentSnapshot &snapshot : snapshots)
+        {
+            stream << snapshot.id.toString().toLatin1() << snapshot.name << snapshot.wantedSize << snapshot.progress
+                    << static_cast<qint32>(snapshot.state) << snapshot.category
+                    << QList<Tag>(snapshot.tags.cbegin(), snapshot.tags.cend()) << snapshot.ratio;
+        }
+    }
+
+    return Utils::IO::saveToFile(path, data);
+}
@@ -0,0 +1,310 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentstatustable.h"
+
+#include <bit>
+
+#include <QDateTime>
+
+using namespace BitTorrent;
+
+namespace
+{
+    template <typename T>
+    void takeLast(QList<T> &column, const qsizetype index)
+    {
+        // the row is replaced with the last one so the other rows aren't shifted
+        column.swapItemsAt(index, (column.size() - 1));
+        column.removeLast();
+    }
+
+    int groupIndex(const TorrentStatusTable::Group group)
+    {
+        return std::countr_zero(static_cast<unsigned int>(group));
+    }
+
+    int stateIndex(const TorrentState state)
+    {
+        return static_cast<int>(state) + 1;
+    }
+}
+
+qsizetype TorrentStatusTable::size() const
+{
+    return m_torrents.size();
+}
+
+bool TorrentStatusTable::isEmpty() const
+{
+    return m_torrents.isEmpty();
+}
+
+qsizetype TorrentStatusTable::indexOf(const Torrent *torrent) const
+{
+    return m_indexes.value(torrent, -1);
+}
+
+void TorrentStatusTable::update(Torrent *torrent)
+{
+    qsizetype index = indexOf(torrent);
+    if (index >= 0)
+    {
+        changeCounts(index, -1);
+    }
+    else
+    {
+        index = m_torrents.size();
+        m_indexes.insert(torrent, index);
+
+        const qsizetype newSize = index + 1;
+        m_torrents.append(torrent);
+        m_states.resize(newSize);
+        m_statusFlags.resize(newSize);
+        m_downloadPayloadRates.resize(newSize);
+        m_uploadPayloadRates.resize(newSize);
+        m_progresses.resize(newSize);
+        m_ratios.resize(newSize);
+        m_wantedSizes.resize(newSize);
+        m_completedSizes.resize(newSize);
+        m_totalDownloads.resize(newSize);
+        m_totalUploads.resize(newSize);
+        m_addedTimes.resize(newSize);
+        m_completedTimes.resize(newSize);
+        m_timesSinceActivity.resize(newSize);
+    }
+
+    StatusFlags flags;
+    flags.setFlag(StatusFlag::Finished, torrent->isFinished());
+    flags.setFlag(StatusFlag::Stopped, torrent->isStopped());
+    flags.setFlag(StatusFlag::HasMetadata, torrent->hasMetadata());
+
+    const QDateTime completedTime = torrent->completedTime();
+
+    m_states[index] = torrent->state();
+    m_statusFlags[index] = flags;
+    m_downloadPayloadRates[index] = torrent->downloadPayloadRate();
+    m_uploadPayloadRates[index] = torrent->uploadPayloadRate();
+    m_progresses[index] = torrent->progress();
+    m_ratios[index] = torrent->realRatio();
+    m_wantedSizes[index] = torrent->wantedSize();
+    m_completedSizes[index] = torrent->completedSize();
+    m_totalDownloads[index] = torrent->totalDownload();
+    m_totalUploads[index] = torrent->totalUpload();
+    m_addedTimes[index] = torrent->addedTime().toSecsSinceEpoch();
+    m_completedTimes[index] = (completedTime.isValid() ? completedTime.toSecsSinceEpoch() : -1);
+    m_timesSinceActivity[index] = torrent->timeSinceActivity();
+
+    changeCounts(index, 1);
+}
+
+void TorrentStatusTable::remove(const Torrent *torrent)
+{
+    const auto indexIter = m_indexes.constFind(torrent);
+    if (indexIter == m_indexes.cend())
+        return;
+
+    const qsizetype index = indexIter.value();
+    m_indexes.erase(indexIter);
+    changeCounts(index, -1);
+
+    const qsizetype lastIndex = m_torrents.size() - 1;
+    if (index != lastIndex)
+        m_indexes[m_torrents.at(lastIndex)] = index;
+
+    takeLast(m_torrents, index);
+    takeLast(m_states, index);
+    takeLast(m_statusFlags, index);
+    takeLast(m_downloadPayloadRates, index);
+    takeLast(m_uploadPayloadRates, index);
+    takeLast(m_progresses, index);
+    takeLast(m_ratios, index);
+    takeLast(m_wantedSizes, index);
+    takeLast(m_completedSizes, index);
+    takeLast(m_totalDownloads, index);
+    takeLast(m_totalUploads, index);
+    takeLast(m_addedTimes, index);
+    takeLast(m_completedTimes, index);
+    takeLast(m_timesSinceActivity, index);
+}
+
+void TorrentStatusTable::clear()
+{
+    m_indexes.clear();
+    m_groupCounts.fill(0);
+    m_stateCounts.fill(0);
+    m_torrents.clear();
+    m_states.clear();
+    m_statusFlags.clear();
+    m_downloadPayloadRates.clear();
+    m_uploadPayloadRates.clear();
+    m_progresses.clear();
+    m_ratios.clear();
+    m_wantedSizes.clear();
+    m_completedSizes.clear();
+    m_totalDownloads.clear();
+    m_totalUploads.clear();
+    m_addedTimes.clear();
+    m_completedTimes.clear();
+    m_timesSinceActivity.clear();
+}
+
+const QList<Torrent *> &TorrentStatusTable::torrents() const
+{
+    return m_torrents;
+}
+
+const QList<TorrentState> &TorrentStatusTable::states() const
+{
+    return m_states;
+}
+
+const QList<TorrentStatusTable::StatusFlags> &TorrentStatusTable::statusFlags() const
+{
+    return m_statusFlags;
+}
+
+const QList<int> &TorrentStatusTable::downloadPayloadRates() const
+{
+    return m_downloadPayloadRates;
+}
+
+const QList<int> &TorrentStatusTable::uploadPayloadRates() const
+{
+    return m_uploadPayloadRates;
+}
+
+const QList<qreal> &TorrentStatusTable::progresses() const
+{
+    return m_progresses;
+}
+
+const QList<qreal> &TorrentStatusTable::ratios() const
+{
+    return m_ratios;
+}
+
+const QList<qint64> &TorrentStatusTable::wantedSizes() const
+{
+    return m_wantedSizes;
+}
+
+const QList<qint64> &TorrentStatusTable::completedSizes() const
+{
+    return m_completedSizes;
+}
+
+const QList<qint64> &TorrentStatusTable::totalDownloads() const
+{
+    return m_totalDownloads;
+}
+
+const QList<qint64> &TorrentStatusTable::totalUploads() const
+{
+    return m_totalUploads;
+}
+
+const QList<qint64> &TorrentStatusTable::addedTimes() const
+{
+    return m_addedTimes;
+}
+
+const QList<qint64> &TorrentStatusTable::completedTimes() const
+{
+    return m_completedTimes;
+}
+
+const QList<qint64> &TorrentStatusTable::timesSinceActivity() const
+{
+    return m_timesSinceActivity;
+}
+
+bool TorrentStatusTable::isActive(const qsizetype index) const
+{
+    // it must be kept in sync with TorrentImpl::isActive()
+    switch (m_states.at(index))
+    {
+    case TorrentState::StalledDownloading:
+        return (m_uploadPayloadRates.at(index) > 0);
+
+    case TorrentState::DownloadingMetadata:
+    case TorrentState::ForcedDownloadingMetadata:
+    case TorrentState::Downloading:
+    case TorrentState::ForcedDownloading:
+    case TorrentState::Uploading:
+    case TorrentState::ForcedUploading:
+    case TorrentState::Moving:
+        return true;
+
+    default:
+        break;
+    }
+
+    return false;
+}
+
+qsizetype TorrentStatusTable::count(const Group group) const
+{
+    return m_groupCounts[groupIndex(group)];
+}
+
+qsizetype TorrentStatusTable::count(const TorrentState state) const
+{
+    return m_stateCounts[stateIndex(state)];
+}
+
+TorrentStatusTable::Groups TorrentStatusTable::groupsAt(const qsizetype index) const
+{
+    const TorrentState state = m_states.at(index);
+    const StatusFlags flags = m_statusFlags.at(index);
+    const bool isFinished = flags.testFlag(StatusFlag::Finished);
+    const bool isStopped = flags.testFlag(StatusFlag::Stopped);
+    const bool isErrored = ((state == TorrentState::MissingFiles) || (state == TorrentState::Error));
+
+    Groups groups;
+    groups.setFlag(Group::Downloading, (!isFinished && !isStopped && !isErrored && flags.testFlag(StatusFlag::HasMetadata)));
+    groups.setFlag(Group::Seeding, (isFinished && !isStopped));
+    groups.setFlag(Group::Active, isActive(index));
+    groups.setFlag(Group::Moving, (state == TorrentState::Moving));
+    groups.setFlag(Group::Checking, ((state == TorrentState::CheckingDownloading)
+            || (state == TorrentState::CheckingUploading) || (state == TorrentState::CheckingResumeData)));
+    groups.setFlag(Group::Errored, isErrored);
+    return groups;
+}
+
+void TorrentStatusTable::changeCounts(const qsizetype index, const int delta)
+{
+    const Groups groups = groupsAt(index);
+    for (int i = 0; i < GROUPS_COUNT; ++i)
+    {
+        if (groups.testFlag(static_cast<Group>(1 << i)))
+            m_groupCounts[i] += delta;
+    }
+
+    m_stateCounts[stateIndex(m_states.at(index))] += delta;
+}
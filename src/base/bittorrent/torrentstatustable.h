@@ -0,0 +1,136 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <QtClassHelperMacros>
+#include <QFlags>
+#include <QHash>
+#include <QList>
+
+#include "torrent.h"
+
+namespace BitTorrent
+{
+    // Frequently used status fields of all the torrents stored column by column,
+    // so the code which scans all the torrents can read them sequentially
+    // instead of calling the getters of each torrent.
+    // It is updated by the session in the main thread when the torrent statuses are updated.
+    class TorrentStatusTable final
+    {
+        Q_DISABLE_COPY_MOVE(TorrentStatusTable)
+
+    public:
+        enum class StatusFlag
+        {
+            Finished = 1,
+            Stopped = 2,
+            HasMetadata = 4
+        };
+        Q_DECLARE_FLAGS(StatusFlags, StatusFlag)
+
+        // Groups of the torrents which are counted as the table is updated,
+        // so questions like "is anything downloading?" don't need to scan the table
+        enum class Group
+        {
+            // not finished, not stopped and not errored torrents having metadata
+            Downloading = 1,
+            // finished and not stopped torrents
+            Seeding = 2,
+            Active = 4,
+            Moving = 8,
+            Checking = 16,
+            Errored = 32
+        };
+        Q_DECLARE_FLAGS(Groups, Group)
+
+        TorrentStatusTable() = default;
+
+        qsizetype size() const;
+        bool isEmpty() const;
+        // Returns -1 if the torrent isn't in the table
+        qsizetype indexOf(const Torrent *torrent) const;
+
+        void update(Torrent *torrent);
+        void remove(const Torrent *torrent);
+        void clear();
+
+        const QList<Torrent *> &torrents() const;
+        const QList<TorrentState> &states() const;
+        const QList<StatusFlags> &statusFlags() const;
+        const QList<int> &downloadPayloadRates() const;
+        const QList<int> &uploadPayloadRates() const;
+        const QList<qreal> &progresses() const;
+        const QList<qreal> &ratios() const;
+        const QList<qint64> &wantedSizes() const;
+        const QList<qint64> &completedSizes() const;
+        const QList<qint64> &totalDownloads() const;
+        const QList<qint64> &totalUploads() const;
+        // Seconds since epoch
+        const QList<qint64> &addedTimes() const;
+        // Seconds since epoch, -1 if the torrent isn't completed
+        const QList<qint64> &completedTimes() const;
+        const QList<qint64> &timesSinceActivity() const;
+
+        bool isActive(qsizetype index) const;
+        qsizetype count(Group group) const;
+        qsizetype count(TorrentState state) const;
+
+    private:
+        static constexpr int GROUPS_COUNT = 6;
+        // TorrentState::Unknown is -1, so the states are counted with offset
+        static constexpr int STATES_COUNT = static_cast<int>(TorrentState::Error) + 2;
+
+        Groups groupsAt(qsizetype index) const;
+        void changeCounts(qsizetype index, int delta);
+
+        QHash<const Torrent *, qsizetype> m_indexes;
+        std::array<qsizetype, GROUPS_COUNT> m_groupCounts {};
+        std::array<qsizetype, STATES_COUNT> m_stateCounts {};
+
+        QList<Torrent *> m_torrents;
+        QList<TorrentState> m_states;
+        QList<StatusFlags> m_statusFlags;
+        QList<int> m_downloadPayloadRates;
+        QList<int> m_uploadPayloadRates;
+        QList<qreal> m_progresses;
+        QList<qreal> m_ratios;
+        QList<qint64> m_wantedSizes;
+        QList<qint64> m_completedSizes;
+        QList<qint64> m_totalDownloads;
+        QList<qint64> m_totalUploads;
+        QList<qint64> m_addedTimes;
+        QList<qint64> m_completedTimes;
+        QList<qint64> m_timesSinceActivity;
+    };
+}
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(BitTorrent::TorrentStatusTable::StatusFlags)
+Q_DECLARE_OPERATORS_FOR_FLAGS(BitTorrent::TorrentStatusTable::Groups)
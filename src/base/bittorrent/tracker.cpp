@@ -26,14 +26,21 @@
  * modify file(s), you may extend this exception to your version of the file(s),
  * but you are not obligated to do so. If you do not wish to do so, delete this
  * exception statement from your version.
- */
 
 #include "tracker.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include <libtorrent/bencode.hpp>
 #include <libtorrent/entry.hpp>
 
+#include <QtEndian>
 #include <QHostAddress>
+#include <QNetworkDatagram>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <QUdpSocket>
 
 #include "base/exceptions.h"
 #include "base/global.h"
@@ -43,15 +50,21 @@
 #include "base/logger.h"
 #include "base/preferences.h"
 
+using namespace std::chrono_literals;
+
 namespace
 {
     // static limits
     const int MAX_TORRENTS = 10000;
     const int MAX_PEERS_PER_TORRENT = 200;
     const int ANNOUNCE_INTERVAL = 1800;  // 30min
+    // peers which don't announce for two intervals are considered gone
+    const int PEER_TIMEOUT = 2 * ANNOUNCE_INTERVAL;
+    const std::chrono::milliseconds EXPIRY_CHECK_INTERVAL = 5min;
 
     // constants
     const int PEER_ID_SIZE = 20;
+    const int DEFAULT_NUM_WANT = 50;
 
     const QString ANNOUNCE_REQUEST_PATH = u"/announce"_s;
 
@@ -83,12 +96,32 @@ namespace
     const char ANNOUNCE_RESPONSE_PEERS_PEER_ID[] = "peer id";
     const char ANNOUNCE_RESPONSE_PEERS_PORT[] = "port";
 
+    // [BEP-15] UDP Tracker Protocol
+    const quint64 UDP_PROTOCOL_ID = 0x41727101980;
+    const quint32 UDP_ACTION_CONNECT = 0;
+    const quint32 UDP_ACTION_ANNOUNCE = 1;
+    const quint32 UDP_ACTION_SCRAPE = 2;
+    const quint32 UDP_ACTION_ERROR = 3;
+    const quint32 UDP_EVENT_COMPLETED = 1;
+    const quint32 UDP_EVENT_STARTED = 2;
+    const quint32 UDP_EVENT_STOPPED = 3;
+    const int UDP_REQUEST_HEADER_SIZE = 16;
+    const int UDP_ANNOUNCE_REQUEST_SIZE = 98;
+    const int UDP_SCRAPE_MAX_TORRENTS = 74;
+    // the connection ID is accepted during the current and the previous epoch, i.e. for one to two minutes
+    const qint64 UDP_CONNECTION_ID_EPOCH = 60;
+
     class TrackerError : public RuntimeError
     {
     public:
         using RuntimeError::RuntimeError;
     };
 
+    qint64 now()
+    {
+        return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
     QByteArray toBigEndianByteArray(const QHostAddress &addr)
     {
         // translate IP address to a sequence of bytes in big-endian order
@@ -120,24 +153,53 @@ namespace
             return {};
         };
     }
-}
 
-namespace BitTorrent
-{
-    // Peer
-    QByteArray Peer::uniqueID() const
+    QByteArray toEndpoint(const QHostAddress &addr, const quint16 port)
+    {
+        return toBigEndianByteArray(addr)
+            .append(static_cast<char>((port >> 8) & 0xFF))
+            .append(static_cast<char>(port & 0xFF));
+    }
+
+    // Enforce using IPv4 if address is indeed IPv4 or if it is an IPv4-mapped IPv6 address
+    QHostAddress normalizedAddress(const QHostAddress &addr)
+    {
+        bool ok = false;
+        const quint32 ipv4 = addr.toIPv4Address(&ok);
+        return ok ? QHostAddress(ipv4) : addr;
+    }
+
+    template <typename T>
+    T readBigEndian(const QByteArray &data, const qsizetype pos)
+    {
+        return qFromBigEndian<T>(data.constData() + pos);
+    }
+
+    template <typename T>
+    void appendBigEndian(QByteArray &data, const T value)
+    {
+        const qsizetype pos = data.size();
+        data.resize(pos + sizeof(T));
+        qToBigEndian<T>(value, (data.data() + pos));
+    }
+
+    void appendBencodedString(QByteArray &data, const QByteArrayView str)
     {
-        return (QByteArray::fromStdString(address) + ':' + QByteArray::number(port));
+        data.append(QByteArray::number(str.size())).append(':').append(str);
     }
 
-    bool operator==(const Peer &left, const Peer &right)
+    void appendBencodedInteger(QByteArray &data, const qint64 value)
     {
-        return (left.uniqueID() == right.uniqueID());
+        data.append('i').append(QByteArray::number(value)).append('e');
     }
 
-    std::size_t qHash(const Peer &key, const std::size_t seed)
+    QByteArray udpErrorReply(const quint32 transactionID, const QByteArrayView message)
     {
-        return qHash(key.uniqueID(), seed);
+        QByteArray reply;
+        appendBigEndian(reply, UDP_ACTION_ERROR);
+        appendBigEndian(reply, transactionID);
+        reply.append(message);
+        return reply;
     }
 }
 
@@ -150,51 +212,51 @@ struct Tracker::TrackerAnnounceRequest
     QByteArray claimedAddress;  // self claimed by peer
     TorrentID torrentID;
     QString event;
-    Peer peer;
-    int numwant = 50;
+    QByteArray endpoint;
+    TrackerPeerStore::Peer peer;
+    int numwant = DEFAULT_NUM_WANT;
     bool compact = true;
     bool noPeerId = false;
 };
 
-// Tracker::TorrentStats
-void Tracker::TorrentStats::setPeer(const Peer &peer)
-{
-    // always replace existing peer
-    if (!removePeer(peer))
-    {
-        // Too many peers, remove a random one
-        if (peers.size() >= MAX_PEERS_PER_TORRENT)
-            removePeer(*peers.begin());
-    }
-
-    // add peer
-    if (peer.isSeeder)
-        ++seeders;
-    peers.insert(peer);
-}
-
-bool Tracker::TorrentStats::removePeer(const Peer &peer)
-{
-    const auto iter = peers.find(peer);
-    if (iter == peers.end())
-        return false;
-
-    if (iter->isSeeder)
-        --seeders;
-    peers.remove(*iter);
-    return true;
-}
-
 // Tracker
 Tracker::Tracker(QObject *parent)
     : QObject(parent)
     , m_server(new Http::Server(this, this))
+    , m_udpSocket {new QUdpSocket(this)}
+    , m_udpSecret {static_cast<std::size_t>(QRandomGenerator::system()->generate64())}
+    , m_peerStore {MAX_TORRENTS, MAX_PEERS_PER_TORRENT, PEER_TIMEOUT}
+    , m_expiryTimer {new QTimer(this)}
 {
+    connect(m_udpSocket, &QUdpSocket::readyRead, this, &Tracker::processUdpDatagrams);
+
+    m_expiryTimer->setInterval(EXPIRY_CHECK_INTERVAL);
+    connect(m_expiryTimer, &QTimer::timeout, this, [this] { m_peerStore.expire(now()); });
 }
 
 bool Tracker::start()
 {
     const int port = Preferences::instance()->getTrackerPort();
+    const QHostAddress ip = QHostAddress::Any;
+
+    if (!m_expiryTimer->isActive())
+        m_expiryTimer->start();
+
+    if ((m_udpSocket->state() != QAbstractSocket::BoundState) || (m_udpSocket->localPort() != port))
+    {
+        m_udpSocket->close();
+        if (m_udpSocket->bind(ip, port))
+        {
+            LogMsg(tr("Embedded Tracker: Now listening for UDP announces on IP: %1, port: %2")
+                .arg(ip.toString(), QString::number(port)), Log::INFO);
+        }
+        else
+        {
+            LogMsg(tr("Embedded Tracker: Unable to bind UDP socket to IP: %1, port: %2. Reason: %3")
+                    .arg(ip.toString(), QString::number(port), m_udpSocket->errorString())
+                , Log::WARNING);
+        }
+    }
 
     if (m_server->isListening())
     {
@@ -210,7 +272,6 @@ bool Tracker::start()
     }
 
     // Listen on port
-    const QHostAddress ip = QHostAddress::Any;
     const bool listenSuccess = m_server->listen(ip, port);
     if (listenSuccess)
     {
@@ -276,15 +337,9 @@ void Tracker::processAnnounceRequest()
     TrackerAnnounceRequest announceReq;
 
     // ip address
-    announceReq.socketAddress = m_env.clientAddress;
+    announceReq.socketAddress = normalizedAddress(m_env.clientAddress);
     announceReq.claimedAddress = queryParams.value(ANNOUNCE_REQUEST_IP);
 
-    // Enforce using IPv4 if address is indeed IPv4 or if it is an IPv4-mapped IPv6 address
-    bool ok = false;
-    const qint32 decimalIPv4 = announceReq.socketAddress.toIPv4Address(&ok);
-    if (ok)
-        announceReq.socketAddress = QHostAddress(decimalIPv4);
-
     // 1. info_hash
     const auto infoHashIter = queryParams.find(ANNOUNCE_REQUEST_INFO_HASH);
     if (infoHashIter == queryParams.end())
@@ -339,15 +394,12 @@ void Tracker::processAnnounceRequest()
 
     // 8. cache `peers` field so we don't recompute when sending response
     const QHostAddress claimedIPAddress {QString::fromLatin1(announceReq.claimedAddress)};
-    announceReq.peer.endpoint = toBigEndianByteArray(!claimedIPAddress.isNull() ? claimedIPAddress : announceReq.socketAddress)
-        .append(static_cast<char>((announceReq.peer.port >> 8) & 0xFF))
-        .append(static_cast<char>(announceReq.peer.port & 0xFF))
-        .toStdString();
+    announceReq.endpoint = toEndpoint((!claimedIPAddress.isNull() ? claimedIPAddress : announceReq.socketAddress), announceReq.peer.port);
 
     // 9. cache `address` field so we don't recompute when sending response
     announceReq.peer.address = !announceReq.claimedAddress.isEmpty()
-        ? announceReq.claimedAddress.constData()
-        : announceReq.socketAddress.toString().toLatin1().constData(),
+        ? announceReq.claimedAddress
+        : announceReq.socketAddress.toString().toLatin1();
 
     // 10. event
     announceReq.event = QString::fromLatin1(queryParams.value(ANNOUNCE_REQUEST_EVENT));
@@ -374,98 +426,236 @@ void Tracker::processAnnounceRequest()
     prepareAnnounceResponse(announceReq);
 }
 
-void Tracker::registerPeer(const TrackerAnnounceRequest &announceReq)
+void Tracker::processUdpDatagrams()
 {
-    if (!m_torrents.contains(announceReq.torrentID))
+    while (m_udpSocket->hasPendingDatagrams())
     {
-        // Reached max size, remove a random torrent
-        if (m_torrents.size() >= MAX_TORRENTS)
-            m_torrents.erase(m_torrents.cbegin());
+        const QNetworkDatagram datagram = m_udpSocket->receiveDatagram();
+        const QByteArray reply = processUdpRequest(datagram.data(), datagram.senderAddress(), static_cast<quint16>(datagram.senderPort()));
+        if (!reply.isEmpty())
+            m_udpSocket->writeDatagram(datagram.makeReply(reply));
     }
+}
 
-    m_torrents[announceReq.torrentID].setPeer(announceReq.peer);
+QByteArray Tracker::processUdpRequest(const QByteArray &data, const QHostAddress &senderAddress, const quint16 senderPort)
+{
+    if (data.size() < UDP_REQUEST_HEADER_SIZE)
+        return {};
+
+    const auto connectionID = readBigEndian<quint64>(data, 0);
+    const auto action = readBigEndian<quint32>(data, 8);
+    const auto transactionID = readBigEndian<quint32>(data, 12);
+    const QHostAddress address = normalizedAddress(senderAddress);
+    const qint64 epoch = now() / UDP_CONNECTION_ID_EPOCH;
+
+    if (action == UDP_ACTION_CONNECT)
+    {
+        if (connectionID != UDP_PROTOCOL_ID)
+            return {};
+
+        QByteArray reply;
+        appendBigEndian(reply, UDP_ACTION_CONNECT);
+        appendBigEndian(reply, transactionID);
+        appendBigEndian(reply, udpConnectionID(address, senderPort, epoch));
+        return reply;
+    }
+
+    // Requests with unknown connection ID are dropped silently so the tracker can't be used
+    // to flood the spoofed addresses
+    if ((connectionID != udpConnectionID(address, senderPort, epoch))
+        && (connectionID != udpConnectionID(address, senderPort, (epoch - 1))))
+    {
+        return {};
+    }
+
+    switch (action)
+    {
+    case UDP_ACTION_ANNOUNCE:
+        return processUdpAnnounceRequest(data, address, transactionID);
+    case UDP_ACTION_SCRAPE:
+        return processUdpScrapeRequest(data, transactionID);
+    default:
+        return udpErrorReply(transactionID, "Invalid action");
+    }
 }
 
-void Tracker::unregisterPeer(const TrackerAnnounceRequest &announceReq)
+QByteArray Tracker::processUdpAnnounceRequest(const QByteArray &data, const QHostAddress &senderAddress, const quint32 transactionID)
 {
-    const auto torrentStatsIter = m_torrents.find(announceReq.torrentID);
-    if (torrentStatsIter == m_torrents.end())
-        return;
+    if (data.size() < UDP_ANNOUNCE_REQUEST_SIZE)
+        return udpErrorReply(transactionID, "Invalid announce request");
 
-    torrentStatsIter->removePeer(announceReq.peer);
+    TrackerAnnounceRequest announceReq;
+    announceReq.socketAddress = senderAddress;
+    announceReq.torrentID = TorrentID(lt::sha1_hash(data.constData() + 16));
+    announceReq.peer.peerId = data.sliced(36, PEER_ID_SIZE);
+    announceReq.peer.isSeeder = (readBigEndian<qint64>(data, 64) == 0);
+
+    switch (readBigEndian<quint32>(data, 80))
+    {
+    case UDP_EVENT_COMPLETED:
+        announceReq.event = ANNOUNCE_REQUEST_EVENT_COMPLETED;
+        break;
+    case UDP_EVENT_STARTED:
+        announceReq.event = ANNOUNCE_REQUEST_EVENT_STARTED;
+        break;
+    case UDP_EVENT_STOPPED:
+        announceReq.event = ANNOUNCE_REQUEST_EVENT_STOPPED;
+        break;
+    default:
+        break;
+    }
+
+    // the claimed IP address is only applicable to IPv4
+    QHostAddress peerAddress = senderAddress;
+    if (const auto claimedIPv4 = readBigEndian<quint32>(data, 84)
+        ; (claimedIPv4 != 0) && (senderAddress.protocol() == QAbstractSocket::IPv4Protocol))
+    {
+        peerAddress = QHostAddress(claimedIPv4);
+    }
+
+    if (const auto numWant = readBigEndian<qint32>(data, 92); numWant >= 0)
+        announceReq.numwant = numWant;
 
-    if (torrentStatsIter->peers.isEmpty())
-        m_torrents.erase(torrentStatsIter);
+    announceReq.peer.port = readBigEndian<quint16>(data, 96);
+    if (announceReq.peer.port == 0)
+        return udpErrorReply(transactionID, "Invalid port");
+
+    announceReq.endpoint = toEndpoint(peerAddress, announceReq.peer.port);
+    announceReq.peer.address = peerAddress.toString().toLatin1();
+
+    if (announceReq.event == ANNOUNCE_REQUEST_EVENT_STOPPED)
+        unregisterPeer(announceReq);
+    else
+        registerPeer(announceReq);
+
+    const TrackerPeerStore::SwarmStats stats = m_peerStore.stats(announceReq.torrentID);
+
+    QByteArray peers;
+    if (announceReq.event != ANNOUNCE_REQUEST_EVENT_STOPPED)
+    {
+        // the peers of the same address family as the one the request is received over
+        TrackerPeerStore::CompactPeers compactPeers = m_peerStore.compactPeers(announceReq.torrentID, announceReq.numwant);
+        peers = (senderAddress.protocol() == QAbstractSocket::IPv6Protocol)
+            ? std::move(compactPeers.peers6) : std::move(compactPeers.peers);
+    }
+
+    QByteArray reply;
+    reply.reserve(20 + peers.size());
+    appendBigEndian(reply, UDP_ACTION_ANNOUNCE);
+    appendBigEndian(reply, transactionID);
+    appendBigEndian<qint32>(reply, ANNOUNCE_INTERVAL);
+    appendBigEndian(reply, static_cast<qint32>(stats.leechers));
+    appendBigEndian(reply, static_cast<qint32>(stats.seeders));
+    reply.append(peers);
+    return reply;
 }
 
-void Tracker::prepareAnnounceResponse(const TrackerAnnounceRequest &announceReq)
+QByteArray Tracker::processUdpScrapeRequest(const QByteArray &data, const quint32 transactionID) const
 {
-    const TorrentStats &torrentStats = m_torrents[announceReq.torrentID];
+    const qsizetype torrentsCount = std::min<qsizetype>(((data.size() - UDP_REQUEST_HEADER_SIZE) / TorrentID::length()), UDP_SCRAPE_MAX_TORRENTS);
 
-    lt::entry::dictionary_type replyDict
+    QByteArray reply;
+    reply.reserve(8 + (torrentsCount * 12));
+    appendBigEndian(reply, UDP_ACTION_SCRAPE);
+    appendBigEndian(reply, transactionID);
+    for (qsizetype i = 0; i < torrentsCount; ++i)
     {
-        {ANNOUNCE_RESPONSE_INTERVAL, ANNOUNCE_INTERVAL},
-        {ANNOUNCE_RESPONSE_COMPLETE, torrentStats.seeders},
-        {ANNOUNCE_RESPONSE_INCOMPLETE, (torrentStats.peers.size() - torrentStats.seeders)},
+        const auto torrentID = TorrentID(lt::sha1_hash(data.constData() + UDP_REQUEST_HEADER_SIZE + (i * TorrentID::length())));
+        const TrackerPeerStore::SwarmStats stats = m_peerStore.stats(torrentID);
+        appendBigEndian(reply, static_cast<qint32>(stats.seeders));
+        appendBigEndian(reply, static_cast<qint32>(stats.completed));
+        appendBigEndian(reply, static_cast<qint32>(stats.leechers));
+    }
 
-        // [BEP-24] Tracker Returns External IP (partial support - might not work properly for all IPv6 cases)
-        {ANNOUNCE_RESPONSE_EXTERNAL_IP, toBigEndianByteArray(announceReq.socketAddress).toStdString()}
-    };
+    return reply;
+}
+
+quint64 Tracker::udpConnectionID(const QHostAddress &address, const quint16 port, const qint64 epoch) const
+{
+    return qHashMulti(m_udpSecret, address, port, epoch);
+}
+
+void Tracker::registerPeer(const TrackerAnnounceRequest &announceReq)
+{
+    m_peerStore.announce(announceReq.torrentID, announceReq.endpoint, announceReq.peer, now());
+    if (announceReq.event == ANNOUNCE_REQUEST_EVENT_COMPLETED)
+        m_peerStore.addCompleted(announceReq.torrentID);
+}
+
+void Tracker::unregisterPeer(const TrackerAnnounceRequest &announceReq)
+{
+    m_peerStore.remove(announceReq.torrentID, announceReq.endpoint);
+}
+
+void Tracker::prepareAnnounceResponse(const TrackerAnnounceRequest &announceReq)
+{
+    const TrackerPeerStore::SwarmStats stats = m_peerStore.stats(announceReq.torrentID);
+    const QByteArray externalIP = toBigEndianByteArray(announceReq.socketAddress);
 
     // peer list
     // [BEP-7] IPv6 Tracker Extension (partial support - only the part that concerns BEP-23)
     // [BEP-23] Tracker Returns Compact Peer Lists
     if (announceReq.compact)
     {
-        lt::entry::string_type peers;
-        lt::entry::string_type peers6;
-
+        TrackerPeerStore::CompactPeers compactPeers;
         if (announceReq.event != ANNOUNCE_REQUEST_EVENT_STOPPED)
-        {
-            int counter = 0;
-            for (const Peer &peer : asConst(torrentStats.peers))
-            {
-                if (counter++ >= announceReq.numwant)
-                    break;
+            compactPeers = m_peerStore.compactPeers(announceReq.torrentID, announceReq.numwant);
 
-                if (peer.endpoint.size() == 6)  // IPv4 + port
-                    peers.append(peer.endpoint);
-                else if (peer.endpoint.size() == 18)  // IPv6 + port
-                    peers6.append(peer.endpoint);
-            }
+        // the peer lists are already packed, so the reply is bencoded directly instead of building `lt::entry`
+        // the dictionary keys must be in lexicographical order
+        QByteArray reply;
+        reply.reserve(128 + compactPeers.peers.size() + compactPeers.peers6.size());
+        reply.append('d');
+        appendBencodedString(reply, ANNOUNCE_RESPONSE_COMPLETE);
+        appendBencodedInteger(reply, stats.seeders);
+        // [BEP-24] Tracker Returns External IP (partial support - might not work properly for all IPv6 cases)
+        appendBencodedString(reply, ANNOUNCE_RESPONSE_EXTERNAL_IP);
+        appendBencodedString(reply, externalIP);
+        appendBencodedString(reply, ANNOUNCE_RESPONSE_INCOMPLETE);
+        appendBencodedInteger(reply, stats.leechers);
+        appendBencodedString(reply, ANNOUNCE_RESPONSE_INTERVAL);
+        appendBencodedInteger(reply, ANNOUNCE_INTERVAL);
+        appendBencodedString(reply, ANNOUNCE_RESPONSE_PEERS);
+        appendBencodedString(reply, compactPeers.peers);  // required, even it's empty
+        if (!compactPeers.peers6.isEmpty())
+        {
+            appendBencodedString(reply, ANNOUNCE_RESPONSE_PEERS6);
+            appendBencodedString(reply, compactPeers.peers6);
         }
+        reply.append('e');
 
-        replyDict[ANNOUNCE_RESPONSE_PEERS] = peers;  // required, even it's empty
-        if (!peers6.empty())
-            replyDict[ANNOUNCE_RESPONSE_PEERS6] = peers6;
+        print(reply, Http::CONTENT_TYPE_TXT);
+        return;
     }
-    else
+
+    lt::entry::dictionary_type replyDict
     {
-        lt::entry::list_type peerList;
+        {ANNOUNCE_RESPONSE_INTERVAL, ANNOUNCE_INTERVAL},
+        {ANNOUNCE_RESPONSE_COMPLETE, stats.seeders},
+        {ANNOUNCE_RESPONSE_INCOMPLETE, stats.leechers},
 
-        if (announceReq.event != ANNOUNCE_REQUEST_EVENT_STOPPED)
+        // [BEP-24] Tracker Returns External IP (partial support - might not work properly for all IPv6 cases)
+        {ANNOUNCE_RESPONSE_EXTERNAL_IP, externalIP.toStdString()}
+    };
+
+    lt::entry::list_type peerList;
+    if (announceReq.event != ANNOUNCE_REQUEST_EVENT_STOPPED)
+    {
+        for (const TrackerPeerStore::Peer &peer : asConst(m_peerStore.peers(announceReq.torrentID, announceReq.numwant)))
         {
-            int counter = 0;
-            for (const Peer &peer : torrentStats.peers)
+            lt::entry::dictionary_type peerDict =
             {
-                if (counter++ >= announceReq.numwant)
-                    break;
+                {ANNOUNCE_RESPONSE_PEERS_IP, peer.address.toStdString()},
+                {ANNOUNCE_RESPONSE_PEERS_PORT, peer.port}
+            };
 
-                lt::entry::dictionary_type peerDict =
-                {
-                    {ANNOUNCE_RESPONSE_PEERS_IP, peer.address},
-                    {ANNOUNCE_RESPONSE_PEERS_PORT, peer.port}
-                };
+            if (!announceReq.noPeerId)
+                peerDict[ANNOUNCE_RESPONSE_PEERS_PEER_ID] = peer.peerId.toStdString();
 
-                if (!announceReq.noPeerId)
-                    peerDict[ANNOUNCE_RESPONSE_PEERS_PEER_ID] = peer.peerId.constData();
-
-                peerList.emplace_back(peerDict);
-            }
+            peerList.emplace_back(peerDict);
         }
-
-        replyDict[ANNOUNCE_RESPONSE_PEERS] = peerList;
     }
+    replyDict[ANNOUNCE_RESPONSE_PEERS] = peerList;
 
     // bencode
     QByteArray reply;
@@ -30,19 +30,20 @@
 
 #pragma once
 
-#include <string>
-
-#include <libtorrent/entry.hpp>
+#include <cstddef>
 
 #include <QtTypes>
-#include <QHash>
 #include <QObject>
-#include <QSet>
 
 #include "base/bittorrent/infohash.h"
+#include "base/bittorrent/trackerpeerstore.h"
 #include "base/http/irequesthandler.h"
 #include "base/http/responsebuilder.h"
 
+class QHostAddress;
+class QTimer;
+class QUdpSocket;
+
 namespace Http
 {
     class Server;
@@ -50,25 +51,10 @@ namespace Http
 
 namespace BitTorrent
 {
-    struct Peer
-    {
-        QByteArray peerId;
-        ushort port = 0;  // self-claimed by peer, might not be the same as socket port
-        bool isSeeder = false;
-
-        // caching precomputed values
-        lt::entry::string_type address;
-        lt::entry::string_type endpoint;
-
-        QByteArray uniqueID() const;
-    };
-
-    bool operator==(const Peer &left, const Peer &right);
-    std::size_t qHash(const Peer &key, std::size_t seed = 0);
-
     // *Basic* Bittorrent tracker implementation
     // [BEP-3] The BitTorrent Protocol Specification
     // also see: https://wiki.theory.org/index.php/BitTorrentSpecification#Tracker_HTTP.2FHTTPS_Protocol
+    // [BEP-15] UDP Tracker Protocol for BitTorrent
     class Tracker final : public QObject, public Http::IRequestHandler, private Http::ResponseBuilder
     {
         Q_OBJECT
@@ -76,15 +62,6 @@ namespace BitTorrent
 
         struct TrackerAnnounceRequest;
 
-        struct TorrentStats
-        {
-            qint64 seeders = 0;
-            QSet<Peer> peers;
-
-            void setPeer(const Peer &peer);
-            bool removePeer(const Peer &peer);
-        };
-
     public:
         explicit Tracker(QObject *parent = nullptr);
 
@@ -94,6 +71,12 @@ namespace BitTorrent
         Http::Response processRequest(const Http::Request &request, const Http::Environment &env) override;
         void processAnnounceRequest();
 
+        void processUdpDatagrams();
+        QByteArray processUdpRequest(const QByteArray &data, const QHostAddress &senderAddress, quint16 senderPort);
+        QByteArray processUdpAnnounceRequest(const QByteArray &data, const QHostAddress &senderAddress, quint32 transactionID);
+        QByteArray processUdpScrapeRequest(const QByteArray &data, quint32 transactionID) const;
+        quint64 udpConnectionID(const QHostAddress &address, quint16 port, qint64 epoch) const;
+
         void registerPeer(const TrackerAnnounceRequest &announceReq);
         void unregisterPeer(const TrackerAnnounceRequest &announceReq);
         void prepareAnnounceResponse(const TrackerAnnounceRequest &announceReq);
@@ -102,6 +85,10 @@ namespace BitTorrent
         Http::Request m_request;
         Http::Environment m_env;
 
-        QHash<TorrentID, TorrentStats> m_torrents;
+        QUdpSocket *m_udpSocket = nullptr;
+        std::size_t m_udpSecret = 0;
+
+        TrackerPeerStore m_peerStore;
+        QTimer *m_expiryTimer = nullptr;
     };
 }
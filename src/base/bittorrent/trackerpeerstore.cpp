@@ -0,0 +1,273 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "trackerpeerstore.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <QtAssert>
+
+namespace
+{
+    const int EXPIRY_BUCKETS = 8;
+}
+
+using namespace BitTorrent;
+
+TrackerPeerStore::TrackerPeerStore(const int maxTorrents, const int maxPeersPerTorrent, const int peerTimeout)
+    : m_maxTorrents {maxTorrents}
+    , m_maxPeersPerTorrent {maxPeersPerTorrent}
+    , m_peerTimeout {peerTimeout}
+    , m_bucketLength {std::max(1, (peerTimeout / EXPIRY_BUCKETS))}
+{
+    Q_ASSERT(m_maxTorrents > 0);
+    Q_ASSERT(m_maxPeersPerTorrent > 0);
+}
+
+bool TrackerPeerStore::announce(const TorrentID &id, const QByteArray &endpoint, const Peer &peer, const qint64 now)
+{
+    const qsizetype endpointSize = endpoint.size();
+    if ((endpointSize != IPV4_ENDPOINT_SIZE) && (endpointSize != IPV6_ENDPOINT_SIZE))
+        return false;
+
+    auto iter = m_torrents.find(id);
+    if (iter == m_torrents.end())
+    {
+        // Reached max size, remove a random torrent
+        if (m_torrents.size() >= m_maxTorrents)
+            m_torrents.erase(m_torrents.cbegin());
+
+        iter = m_torrents.emplace(id);
+    }
+
+    TorrentData &torrent = *iter;
+    PeerList &list = torrent.peerList(endpointSize);
+    const qint64 peerBucket = bucket(now);
+
+    if (const auto indexIter = torrent.index.constFind(endpoint); indexIter != torrent.index.cend())
+    {
+        // always replace existing peer
+        PeerEntry &entry = list.entries[*indexIter];
+        torrent.seeders += (static_cast<int>(peer.isSeeder) - static_cast<int>(entry.peer.isSeeder));
+        entry = {peer, peerBucket};
+    }
+    else
+    {
+        if (torrent.peersCount() >= m_maxPeersPerTorrent)
+        {
+            // Too many peers, replace the one which announced least recently
+            PeerList &victimList = !list.entries.empty() ? list : torrent.peerList(IPV4_ENDPOINT_SIZE + IPV6_ENDPOINT_SIZE - endpointSize);
+            const auto victimIter = std::ranges::min_element(victimList.entries, {}, &PeerEntry::bucket);
+            torrent.removeAt(victimList, std::distance(victimList.entries.begin(), victimIter));
+        }
+
+        torrent.index.insert(endpoint, static_cast<qsizetype>(list.entries.size()));
+        list.endpoints.append(endpoint);
+        list.entries.push_back({peer, peerBucket});
+        if (peer.isSeeder)
+            ++torrent.seeders;
+    }
+
+    m_expiryBuckets[peerBucket].insert(id);
+    return true;
+}
+
+void TrackerPeerStore::remove(const TorrentID &id, const QByteArray &endpoint)
+{
+    const auto iter = m_torrents.find(id);
+    if (iter == m_torrents.end())
+        return;
+
+    TorrentData &torrent = *iter;
+    const auto indexIter = torrent.index.constFind(endpoint);
+    if (indexIter == torrent.index.cend())
+        return;
+
+    torrent.removeAt(torrent.peerList(endpoint.size()), *indexIter);
+    if (torrent.peersCount() == 0)
+        m_torrents.erase(iter);
+}
+
+void TrackerPeerStore::addCompleted(const TorrentID &id)
+{
+    if (const auto iter = m_torrents.find(id); iter != m_torrents.end())
+        ++iter->completed;
+}
+
+void TrackerPeerStore::expire(const qint64 now)
+{
+    const qint64 expiredBucket = bucket(now - m_peerTimeout);
+    while (!m_expiryBuckets.isEmpty() && (m_expiryBuckets.firstKey() < expiredBucket))
+    {
+        const QSet<TorrentID> ids = m_expiryBuckets.take(m_expiryBuckets.firstKey());
+        for (const TorrentID &id : ids)
+        {
+            // the torrent could have been removed after it was announced during the bucket
+            const auto iter = m_torrents.find(id);
+            if (iter == m_torrents.end())
+                continue;
+
+            iter->removeExpired(iter->peers, expiredBucket);
+            iter->removeExpired(iter->peers6, expiredBucket);
+            if (iter->peersCount() == 0)
+                m_torrents.erase(iter);
+        }
+    }
+}
+
+void TrackerPeerStore::clear()
+{
+    m_torrents.clear();
+    m_expiryBuckets.clear();
+}
+
+qsizetype TrackerPeerStore::torrentsCount() const
+{
+    return m_torrents.size();
+}
+
+qsizetype TrackerPeerStore::peersCount(const TorrentID &id) const
+{
+    const auto iter = m_torrents.constFind(id);
+    return (iter != m_torrents.cend()) ? iter->peersCount() : 0;
+}
+
+TrackerPeerStore::SwarmStats TrackerPeerStore::stats(const TorrentID &id) const
+{
+    const auto iter = m_torrents.constFind(id);
+    if (iter == m_torrents.cend())
+        return {};
+
+    return {iter->seeders, (iter->peersCount() - iter->seeders), iter->completed};
+}
+
+TrackerPeerStore::CompactPeers TrackerPeerStore::compactPeers(const TorrentID &id, const int numWant)
+{
+    const auto iter = m_torrents.find(id);
+    if ((iter == m_torrents.end()) || (numWant <= 0))
+        return {};
+
+    TorrentData &torrent = *iter;
+    const qsizetype peersCount = torrent.peersCount();
+    if (numWant >= peersCount)
+        return {torrent.peers.endpoints, torrent.peers6.endpoints};
+
+    // share the requested number of peers between the address families proportionally
+    const auto ipv4Count = static_cast<qsizetype>(torrent.peers.entries.size());
+    const qsizetype wantedIPv4Count = std::min(ipv4Count, ((numWant * ipv4Count + (peersCount / 2)) / peersCount));
+
+    const auto takePeers = [](PeerList &list, const qsizetype count, const qsizetype endpointSize) -> QByteArray
+    {
+        const auto listSize = static_cast<qsizetype>(list.entries.size());
+        if (count <= 0)
+            return {};
+        if (count >= listSize)
+            return list.endpoints;
+
+        const qsizetype offset = list.offset % listSize;
+        list.offset = (offset + count) % listSize;
+
+        const qsizetype headCount = std::min(count, (listSize - offset));
+        QByteArray result = list.endpoints.sliced((offset * endpointSize), (headCount * endpointSize));
+        if (headCount < count)
+            result.append(list.endpoints.first((count - headCount) * endpointSize));
+        return result;
+    };
+
+    return {takePeers(torrent.peers, wantedIPv4Count, IPV4_ENDPOINT_SIZE)
+        , takePeers(torrent.peers6, (numWant - wantedIPv4Count), IPV6_ENDPOINT_SIZE)};
+}
+
+QList<TrackerPeerStore::Peer> TrackerPeerStore::peers(const TorrentID &id, const int numWant) const
+{
+    const auto iter = m_torrents.constFind(id);
+    if ((iter == m_torrents.cend()) || (numWant <= 0))
+        return {};
+
+    QList<Peer> result;
+    result.reserve(std::min<qsizetype>(numWant, iter->peersCount()));
+    for (const PeerList *list : {&iter->peers, &iter->peers6})
+    {
+        for (const PeerEntry &entry : list->entries)
+        {
+            if (result.size() >= numWant)
+                return result;
+            result.append(entry.peer);
+        }
+    }
+
+    return result;
+}
+
+qint64 TrackerPeerStore::bucket(const qint64 time) const
+{
+    return (time / m_bucketLength);
+}
+
+TrackerPeerStore::PeerList &TrackerPeerStore::TorrentData::peerList(const qsizetype endpointSize)
+{
+    return (endpointSize == IPV4_ENDPOINT_SIZE) ? peers : peers6;
+}
+
+qsizetype TrackerPeerStore::TorrentData::peersCount() const
+{
+    return static_cast<qsizetype>(peers.entries.size() + peers6.entries.size());
+}
+
+void TrackerPeerStore::TorrentData::removeAt(PeerList &list, const qsizetype pos)
+{
+    const qsizetype endpointSize = (&list == &peers) ? IPV4_ENDPOINT_SIZE : IPV6_ENDPOINT_SIZE;
+    const auto lastPos = static_cast<qsizetype>(list.entries.size() - 1);
+
+    index.remove(list.endpoints.sliced((pos * endpointSize), endpointSize));
+    if (list.entries[pos].peer.isSeeder)
+        --seeders;
+
+    // move the last peer in place of the removed one to keep the lists packed
+    if (pos != lastPos)
+    {
+        const QByteArray lastEndpoint = list.endpoints.sliced((lastPos * endpointSize), endpointSize);
+        list.endpoints.replace((pos * endpointSize), endpointSize, lastEndpoint);
+        list.entries[pos] = std::move(list.entries[lastPos]);
+        index[lastEndpoint] = pos;
+    }
+
+    list.endpoints.truncate(lastPos * endpointSize);
+    list.entries.pop_back();
+}
+
+void TrackerPeerStore::TorrentData::removeExpired(PeerList &list, const qint64 bucket)
+{
+    // going backwards, so the peer moved in place of the removed one is already checked
+    for (auto pos = static_cast<qsizetype>(list.entries.size()); pos-- > 0;)
+    {
+        if (list.entries[pos].bucket < bucket)
+            removeAt(list, pos);
+    }
+}
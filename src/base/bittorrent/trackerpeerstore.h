@@ -0,0 +1,136 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include <QtClassHelperMacros>
+#include <QtTypes>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QMap>
+#include <QSet>
+
+#include "infohash.h"
+
+namespace BitTorrent
+{
+    // Peers announced to the embedded tracker.
+    // The peers of each torrent are kept in packed arrays per address family, so the compact peer lists
+    // (BEP-23, BEP-7) are ready to be sent as is. The peers which don't announce again within the timeout
+    // are expired in time buckets, so that only the torrents announced during the expired bucket are visited.
+    class TrackerPeerStore final
+    {
+        Q_DISABLE_COPY_MOVE(TrackerPeerStore)
+
+    public:
+        static constexpr int IPV4_ENDPOINT_SIZE = 6;
+        static constexpr int IPV6_ENDPOINT_SIZE = 18;
+
+        struct Peer
+        {
+            QByteArray peerId;
+            QByteArray address;  // as told to the peers requesting non-compact list
+            quint16 port = 0;  // self-claimed by peer, might not be the same as socket port
+            bool isSeeder = false;
+        };
+
+        struct SwarmStats
+        {
+            qint64 seeders = 0;
+            qint64 leechers = 0;
+            qint64 completed = 0;
+        };
+
+        struct CompactPeers
+        {
+            QByteArray peers;
+            QByteArray peers6;
+        };
+
+        // `peerTimeout` is in seconds, the peer is expired in at most 1/8 of it after the timeout
+        TrackerPeerStore(int maxTorrents, int maxPeersPerTorrent, int peerTimeout);
+
+        // `endpoint` is the IP address and port in network byte order, it identifies the peer within the torrent.
+        // `now` is the current time in seconds of any monotonic clock.
+        // Returns false if the endpoint size is invalid.
+        bool announce(const TorrentID &id, const QByteArray &endpoint, const Peer &peer, qint64 now);
+        void remove(const TorrentID &id, const QByteArray &endpoint);
+        void addCompleted(const TorrentID &id);
+        void expire(qint64 now);
+        void clear();
+
+        qsizetype torrentsCount() const;
+        qsizetype peersCount(const TorrentID &id) const;
+        SwarmStats stats(const TorrentID &id) const;
+
+        // Returns up to `numWant` peers, the partial lists are rotated between the calls
+        // so the different peers are handed out to the subsequent requests
+        CompactPeers compactPeers(const TorrentID &id, int numWant);
+        QList<Peer> peers(const TorrentID &id, int numWant) const;
+
+    private:
+        struct PeerEntry
+        {
+            Peer peer;
+            qint64 bucket = 0;
+        };
+
+        struct PeerList
+        {
+            QByteArray endpoints;
+            std::vector<PeerEntry> entries;
+            qsizetype offset = 0;
+        };
+
+        struct TorrentData
+        {
+            PeerList peers;
+            PeerList peers6;
+            QHash<QByteArray, qsizetype> index;
+            qint64 seeders = 0;
+            qint64 completed = 0;
+
+            PeerList &peerList(qsizetype endpointSize);
+            qsizetype peersCount() const;
+            void removeAt(PeerList &list, qsizetype pos);
+            void removeExpired(PeerList &list, qint64 bucket);
+        };
+
+        qint64 bucket(qint64 time) const;
+
+        int m_maxTorrents = 0;
+        int m_maxPeersPerTorrent = 0;
+        int m_peerTimeout = 0;
+        int m_bucketLength = 0;
+        QHash<TorrentID, TorrentData> m_torrents;
+        QMap<qint64, QSet<TorrentID>> m_expiryBuckets;
+    };
+}
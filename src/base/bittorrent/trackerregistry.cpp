@@ -0,0 +1,103 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "trackerregistry.h"
+
+#include <algorithm>
+
+namespace
+{
+    const qsizetype MIN_PRUNE_THRESHOLD = 256;
+
+    void pruneUnreferenced(QHash<std::string, QString> &pool)
+    {
+        // the string is referenced only by the pool if its data isn't shared
+        pool.removeIf([](const QHash<std::string, QString>::iterator &iter)
+        {
+            return iter.value().isDetached();
+        });
+    }
+}
+
+using namespace BitTorrent;
+
+QString TrackerRegistry::url(const std::string &nativeURL)
+{
+    return intern(m_urls, nativeURL, [](const std::string &str) { return QString::fromStdString(str); });
+}
+
+QString TrackerRegistry::url(const QString &url)
+{
+    if (url.isEmpty())
+        return {};
+
+    const std::string nativeURL = url.toStdString();
+    return intern(m_urls, nativeURL, [&url](const std::string &) { return url; });
+}
+
+QString TrackerRegistry::message(const std::string &nativeMessage)
+{
+    return intern(m_messages, nativeMessage, [](const std::string &str) { return QString::fromStdString(str); });
+}
+
+QString TrackerRegistry::errorMessage(const std::string &nativeMessage)
+{
+    return intern(m_errorMessages, nativeMessage, [](const std::string &str) { return QString::fromLocal8Bit(str); });
+}
+
+qsizetype TrackerRegistry::count() const
+{
+    return m_urls.size() + m_messages.size() + m_errorMessages.size();
+}
+
+void TrackerRegistry::prune()
+{
+    pruneUnreferenced(m_urls);
+    pruneUnreferenced(m_messages);
+    pruneUnreferenced(m_errorMessages);
+
+    m_pruneThreshold = std::max(MIN_PRUNE_THRESHOLD, (count() * 2));
+}
+
+template <typename Converter>
+QString TrackerRegistry::intern(Pool &pool, const std::string &str, Converter converter)
+{
+    if (str.empty())
+        return {};
+
+    if (const auto iter = pool.constFind(str); iter != pool.cend())
+        return iter.value();
+
+    // the strings are removed once the pools have grown enough since the last pruning
+    if (count() >= m_pruneThreshold)
+        prune();
+
+    const QString value = converter(str);
+    pool.insert(str, value);
+    return value;
+}
@@ -0,0 +1,70 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <string>
+
+#include <QtClassHelperMacros>
+#include <QHash>
+#include <QString>
+
+namespace BitTorrent
+{
+    // Session-wide storage of the strings reported for the trackers, such as their URLs and messages.
+    // The same trackers are usually used by many torrents, so the equal strings share a single copy
+    // instead of being converted from libtorrent strings for each of the torrents.
+    // The strings which aren't referenced anymore are removed from time to time.
+    class TrackerRegistry final
+    {
+        Q_DISABLE_COPY_MOVE(TrackerRegistry)
+
+    public:
+        TrackerRegistry() = default;
+
+        QString url(const std::string &nativeURL);
+        QString url(const QString &url);
+        QString message(const std::string &nativeMessage);
+        // Message of system error, it is encoded using local 8-bit encoding
+        QString errorMessage(const std::string &nativeMessage);
+
+        qsizetype count() const;
+        void prune();
+
+    private:
+        using Pool = QHash<std::string, QString>;
+
+        template <typename Converter>
+        QString intern(Pool &pool, const std::string &str, Converter converter);
+
+        Pool m_urls;
+        Pool m_messages;
+        Pool m_errorMessages;
+        qsizetype m_pruneThreshold = 0;
+    };
+}
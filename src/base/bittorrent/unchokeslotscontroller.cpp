@@ -0,0 +1,128 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "unchokeslotscontroller.h"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace BitTorrent;
+
+namespace
+{
+    const double LOW_UTILIZATION = 0.80;
+    const double HIGH_UTILIZATION = 0.95;
+    // Each step scales the configured limits by SCALE_FACTOR
+    const double SCALE_FACTOR = 1.25;
+    const int MIN_SCALE_STEP = -6;
+    const int MAX_SCALE_STEP = 6;
+    // in milliseconds
+    const qint64 SUSTAIN_TIME = 10'000;
+    // libtorrent recalculates the unchoked peers every 15 seconds by default
+    const qint64 SETTLE_TIME = 30'000;
+    const qint64 PEAK_DECAY_TIME = 600'000;
+}
+
+void UnchokeSlotsController::setBaseLimits(const int globalSlots, const int torrentSlots)
+{
+    m_baseGlobalSlots = (globalSlots > 0) ? globalSlots : -1;
+    m_baseTorrentSlots = (torrentSlots > 0) ? torrentSlots : -1;
+}
+
+void UnchokeSlotsController::reset()
+{
+    m_scaleStep = 0;
+    m_state = State::Stable;
+    m_updateTime.reset();
+    m_peakUploadRate = 0;
+}
+
+int UnchokeSlotsController::globalSlots() const
+{
+    return scaled(m_baseGlobalSlots);
+}
+
+int UnchokeSlotsController::torrentSlots() const
+{
+    return scaled(m_baseTorrentSlots);
+}
+
+bool UnchokeSlotsController::update(const qint64 uploadRate, const qint64 uploadLimit, const int unchokedPeers, const qint64 now)
+{
+    if (!m_updateTime)
+    {
+        m_stateTime = now;
+        m_changeTime = now;
+    }
+
+    const qint64 elapsed = now - m_updateTime.value_or(now);
+    m_updateTime = now;
+    m_peakUploadRate = std::max(uploadRate, (m_peakUploadRate - ((m_peakUploadRate * std::min(elapsed, PEAK_DECAY_TIME)) / PEAK_DECAY_TIME)));
+
+    const qint64 capacity = (uploadLimit > 0) ? uploadLimit : m_peakUploadRate;
+    const double utilization = (capacity > 0) ? (static_cast<double>(uploadRate) / capacity) : 1;
+    // More slots can't help while some of them are free for lack of interested peers
+    const bool areSlotsInUse = (globalSlots() < 0) || (unchokedPeers >= globalSlots());
+
+    State state = State::Stable;
+    if (utilization >= HIGH_UTILIZATION)
+        state = State::Saturated;
+    else if ((utilization < LOW_UTILIZATION) && areSlotsInUse)
+        state = State::UnderUtilized;
+
+    if (state != m_state)
+    {
+        m_state = state;
+        m_stateTime = now;
+    }
+
+    if ((state == State::Stable) || ((now - m_stateTime) < SUSTAIN_TIME) || ((now - m_changeTime) < SETTLE_TIME))
+        return false;
+
+    // The uplink capacity isn't known if the upload rate is unlimited, so the peak rate being
+    // reached means only that the added slots are no longer useful
+    const int minScaleStep = (uploadLimit > 0) ? MIN_SCALE_STEP : 0;
+    const int scaleStep = std::clamp((m_scaleStep + ((state == State::UnderUtilized) ? 1 : -1)), minScaleStep, MAX_SCALE_STEP);
+    if (scaleStep == m_scaleStep)
+        return false;
+
+    const int oldGlobalSlots = globalSlots();
+    const int oldTorrentSlots = torrentSlots();
+    m_scaleStep = scaleStep;
+    m_stateTime = now;
+    m_changeTime = now;
+    return (globalSlots() != oldGlobalSlots) || (torrentSlots() != oldTorrentSlots);
+}
+
+int UnchokeSlotsController::scaled(const int baseSlots) const
+{
+    if (baseSlots < 0)
+        return -1;
+
+    return std::max(1, static_cast<int>(std::lround(baseSlots * std::pow(SCALE_FACTOR, m_scaleStep))));
+}
@@ -0,0 +1,83 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <QtClassHelperMacros>
+#include <QtTypes>
+
+namespace BitTorrent
+{
+    // Scales the configured upload slots limits to keep the uplink utilized: the slots are
+    // added while the uplink is under-utilized with all the slots in use, and removed while
+    // it is saturated, so that the bandwidth isn't spread thin across too many peers.
+    // The utilization has to stay out of the dead band for a while before the limits are
+    // changed, and they aren't changed again until the unchoker has applied the previous change.
+    class UnchokeSlotsController final
+    {
+        Q_DISABLE_COPY_MOVE(UnchokeSlotsController)
+
+    public:
+        UnchokeSlotsController() = default;
+
+        // Configured limits, -1 for unlimited, unlimited ones aren't scaled
+        void setBaseLimits(int globalSlots, int torrentSlots);
+        // Restores the configured limits
+        void reset();
+
+        int globalSlots() const;
+        int torrentSlots() const;
+
+        // `uploadRate` and `uploadLimit` are in bytes per second, `uploadLimit` is 0 if unlimited,
+        // in which case the decaying peak of the upload rate is used as the uplink capacity and the
+        // limits aren't reduced below the configured ones. `now` is the current time in milliseconds
+        // of any monotonic clock. Returns true if the scaled limits are changed.
+        bool update(qint64 uploadRate, qint64 uploadLimit, int unchokedPeers, qint64 now);
+
+    private:
+        enum class State
+        {
+            Stable,
+            UnderUtilized,
+            Saturated
+        };
+
+        int scaled(int baseSlots) const;
+
+        int m_baseGlobalSlots = -1;
+        int m_baseTorrentSlots = -1;
+        int m_scaleStep = 0;
+        State m_state = State::Stable;
+        qint64 m_stateTime = 0;
+        qint64 m_changeTime = 0;
+        std::optional<qint64> m_updateTime;
+        qint64 m_peakUploadRate = 0;
+    };
+}
@@ -29,10 +29,30 @@
 
 #include "freediskspacechecker.h"
 
+#include <chrono>
+
 #include "base/utils/fs.h"
 
+using namespace std::chrono_literals;
+
+namespace
+{
+    const std::chrono::minutes PATH_VOLUMES_EXPIRATION_TIME = 10min;
+
+    qint64 freeDiskSpaceOnVolume(const Path &path)
+    {
+        // the path may be not created yet
+        Path existingPath = path;
+        while (!existingPath.isEmpty() && !existingPath.exists())
+            existingPath = existingPath.parentPath();
+
+        return Utils::Fs::freeDiskSpaceOnPath(existingPath.isEmpty() ? path : existingPath);
+    }
+}
+
 FreeDiskSpaceChecker::FreeDiskSpaceChecker(const Path &pathToCheck)
     : m_pathToCheck {pathToCheck}
+    , m_pathVolumesExpiration {PATH_VOLUMES_EXPIRATION_TIME}
 {
 }
 
@@ -46,7 +66,41 @@ void FreeDiskSpaceChecker::setPathToCheck(const Path &newPathToCheck)
     m_pathToCheck = newPathToCheck;
 }
 
+void FreeDiskSpaceChecker::setVolumePathsToCheck(const PathList &paths)
+{
+    m_volumePathsToCheck = paths;
+}
+
 void FreeDiskSpaceChecker::check()
 {
     emit checked(Utils::Fs::freeDiskSpaceOnPath(m_pathToCheck));
+
+    if (m_volumePathsToCheck.isEmpty())
+        return;
+
+    if (m_pathVolumesExpiration.hasExpired())
+    {
+        m_pathVolumes.clear();
+        m_pathVolumesExpiration.setRemainingTime(PATH_VOLUMES_EXPIRATION_TIME);
+    }
+
+    QHash<Path, QString> pathVolumes;
+    pathVolumes.reserve(m_volumePathsToCheck.size());
+    QHash<QString, qint64> volumeFreeSpace;
+    for (const Path &path : m_volumePathsToCheck)
+    {
+        auto cachedVolumeIter = m_pathVolumes.find(path);
+        if (cachedVolumeIter == m_pathVolumes.end())
+            cachedVolumeIter = m_pathVolumes.insert(path, Utils::Fs::storageDevice(path));
+
+        const QString &volume = cachedVolumeIter.value();
+        pathVolumes.insert(path, volume);
+        if (!volumeFreeSpace.contains(volume))
+            volumeFreeSpace.insert(volume, freeDiskSpaceOnVolume(path));
+    }
+
+    // forget the paths that aren't checked anymore
+    m_pathVolumes.removeIf([&pathVolumes](const auto &item) { return !pathVolumes.contains(item.key()); });
+
+    emit volumesChecked(pathVolumes, volumeFreeSpace);
 }
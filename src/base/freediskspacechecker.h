@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <QDeadlineTimer>
+#include <QHash>
 #include <QObject>
 
 #include "base/path.h"
@@ -43,13 +45,21 @@ public:
 
     Path pathToCheck() const;
     void setPathToCheck(const Path &newPathToCheck);
+    // Paths whose volumes are checked in addition to the one of `pathToCheck`
+    void setVolumePathsToCheck(const PathList &paths);
 
 public slots:
     void check();
 
 signals:
     void checked(qint64 freeSpaceSize);
+    // `pathVolumes` maps the paths to their storage devices, each device is checked once
+    void volumesChecked(const QHash<Path, QString> &pathVolumes, const QHash<QString, qint64> &volumeFreeSpace);
 
 private:
     Path m_pathToCheck;
+    PathList m_volumePathsToCheck;
+    // Storage devices of the paths are looked up again from time to time since mount points may change
+    QHash<Path, QString> m_pathVolumes;
+    QDeadlineTimer m_pathVolumesExpiration;
 };
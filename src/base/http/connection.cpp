@@ -30,21 +30,63 @@
 
 #include "connection.h"
 
+#include <algorithm>
+#include <utility>
+
+#include <QLocalSocket>
+#include <QScopeGuard>
 #include <QTcpSocket>
 
+#include "contentproducer.h"
+#include "deferredresponse.h"
+#include "eventstream.h"
+#include "http2session.h"
 #include "irequesthandler.h"
 #include "requestparser.h"
 #include "responsegenerator.h"
 
 using namespace Http;
 
+namespace
+{
+    // produced content is taken only when the socket is about to run out of data
+    const qint64 PRODUCED_CONTENT_WRITE_THRESHOLD = 256 * 1024;
+
+    Connection::RequestDispatcher directDispatcher(IRequestHandler *requestHandler)
+    {
+        return [requestHandler](Connection *connection, const quint32 streamID, const Request &request, const Environment &env)
+        {
+            connection->processResponse(requestHandler->processRequest(request, env), streamID);
+        };
+    }
+}
+
 Connection::Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObject *parent)
+    : Connection(socket, directDispatcher(requestHandler), parent)
+{
+}
+
+Connection::Connection(QTcpSocket *socket, RequestDispatcher requestDispatcher, QObject *parent)
+    : Connection(socket, {socket->localAddress(), socket->localPort(), socket->peerAddress(), socket->peerPort()}
+        , std::move(requestDispatcher), parent)
+{
+    connect(socket, &QAbstractSocket::disconnected, this, &Connection::closed);
+}
+
+Connection::Connection(QLocalSocket *socket, IRequestHandler *requestHandler, QObject *parent)
+    : Connection(socket, {.localAddress = QHostAddress::LocalHost, .clientAddress = QHostAddress::LocalHost, .isLocalSocket = true}
+        , directDispatcher(requestHandler), parent)
+{
+    connect(socket, &QLocalSocket::disconnected, this, &Connection::closed);
+}
+
+Connection::Connection(QIODevice *socket, const Environment &env, RequestDispatcher requestDispatcher, QObject *parent)
     : QObject(parent)
     , m_socket(socket)
-    , m_requestHandler(requestHandler)
+    , m_env(env)
+    , m_requestDispatcher(std::move(requestDispatcher))
 {
     m_socket->setParent(this);
-    connect(m_socket, &QAbstractSocket::disconnected, this, &Connection::closed);
 
     // reserve common size for requests, don't use the max allowed size which is too big for
     // memory constrained platforms
@@ -60,11 +102,42 @@ Connection::Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObj
     connect(m_socket, &QIODevice::bytesWritten, this, [this]()
     {
         m_idleTimer.start();
+        if (m_contentProducer)
+            writeProducedContent();
     });
 }
 
+Connection::~Connection()
+{
+    // the objects created in another thread can't be owned as a child
+    if (m_eventStream && (m_eventStream->thread() != thread()))
+        m_eventStream->deleteLater();
+    if (m_contentProducer && (m_contentProducer->thread() != thread()))
+        m_contentProducer->deleteLater();
+    if (m_deferredResponse && (m_deferredResponse->deferredResponse->thread() != thread()))
+        m_deferredResponse->deferredResponse->deleteLater();
+}
+
+void Connection::setHTTP2Enabled(const bool enabled)
+{
+    m_isHTTP2Enabled = enabled;
+}
+
 void Connection::read()
 {
+    if (m_http2Session)
+    {
+        m_http2Session->processData(m_socket->readAll());
+        return;
+    }
+
+    // client isn't expected to send anything while receiving event stream
+    if (m_eventStream)
+    {
+        m_socket->readAll();
+        return;
+    }
+
     // reuse existing buffer and avoid unnecessary memory allocation/relocation
     const qsizetype previousSize = m_receivedData.size();
     const qint64 bytesAvailable = m_socket->bytesAvailable();
@@ -78,9 +151,51 @@ void Connection::read()
     if (bytesRead < bytesAvailable) [[unlikely]]
         m_receivedData.chop(bytesAvailable - bytesRead);
 
-    while (!m_receivedData.isEmpty())
+    if (detectHTTP2())
+        return;
+
+    // pipelined requests are parsed once the response to the current one is sent
+    if (!m_isProcessingRequest && !m_contentProducer)
+        parseReceivedData();
+}
+
+bool Connection::detectHTTP2()
+{
+    if (!m_isHTTP2Enabled || m_isProtocolDetected)
+        return false;
+
+    // [rfc9113] 3.4. HTTP/2 Connection Preface
+    // the client which knows that the server supports HTTP/2 (e.g. by TLS ALPN) starts with the preface
+    const QByteArrayView preface = Http2Session::CONNECTION_PREFACE;
+    const qsizetype size = std::min(m_receivedData.size(), preface.size());
+    if (QByteArrayView(m_receivedData).first(size) != preface.first(size))
     {
-        const RequestParser::ParseResult result = RequestParser::parse(m_receivedData);
+        m_isProtocolDetected = true;
+        return false;
+    }
+
+    // wait for the rest of the preface
+    if (size < preface.size())
+        return true;
+
+    m_isProtocolDetected = true;
+
+    m_http2Session = new Http2Session(m_socket, m_env.clientAddress, [this](const quint32 streamID, const Request &request)
+    {
+        m_requestDispatcher(this, streamID, request, m_env);
+    }, this);
+    m_http2Session->processData(std::exchange(m_receivedData, {}));
+    return true;
+}
+
+void Connection::parseReceivedData()
+{
+    m_isParsing = true;
+    const auto parsingGuard = qScopeGuard([this] { m_isParsing = false; });
+
+    while (!m_receivedData.isEmpty() && !m_isProcessingRequest && !m_eventStream && !m_contentProducer)
+    {
+        const RequestParser::ParseResult result = m_requestParser.parse(m_receivedData);
 
         switch (result.status)
         {
@@ -90,21 +205,26 @@ void Connection::read()
                 if (m_receivedData.size() > bufferLimit)
                 {
                     qWarning("%s", qUtf8Printable(tr("Http request size exceeds limitation, closing socket. Limit: %1, IP: %2")
-                        .arg(QString::number(bufferLimit), m_socket->peerAddress().toString())));
+                        .arg(QString::number(bufferLimit), m_env.clientAddress.toString())));
 
                     Response resp(413, u"Payload Too Large"_s);
                     resp.headers[HEADER_CONNECTION] = u"close"_s;
 
                     sendResponse(resp);
                     m_socket->close();
+                    return;
                 }
+
+                // avoid relocating the buffer while receiving large request body
+                if (const qsizetype frameSize = m_requestParser.expectedFrameSize(); frameSize > m_receivedData.capacity())
+                    m_receivedData.reserve(frameSize);
             }
             return;
 
         case RequestParser::ParseStatus::BadMethod:
             {
                 qWarning("%s", qUtf8Printable(tr("Bad Http request method, closing socket. IP: %1. Method: \"%2\"")
-                    .arg(m_socket->peerAddress().toString(), result.request.method)));
+                    .arg(m_env.clientAddress.toString(), result.request.method)));
 
                 Response resp(501, u"Not Implemented"_s);
                 resp.headers[HEADER_CONNECTION] = u"close"_s;
@@ -117,7 +237,7 @@ void Connection::read()
         case RequestParser::ParseStatus::BadRequest:
             {
                 qWarning("%s", qUtf8Printable(tr("Bad Http request, closing socket. IP: %1")
-                    .arg(m_socket->peerAddress().toString())));
+                    .arg(m_env.clientAddress.toString())));
 
                 Response resp(400, u"Bad Request"_s);
                 resp.headers[HEADER_CONNECTION] = u"close"_s;
@@ -129,37 +249,25 @@ void Connection::read()
 
         case RequestParser::ParseStatus::OK:
             {
-                const Environment env {m_socket->localAddress(), m_socket->localPort(), m_socket->peerAddress(), m_socket->peerPort()};
+#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
+                m_receivedData.slice(result.frameSize);
+#else
+                m_receivedData.remove(0, result.frameSize);
+#endif
+
+                m_pendingRequest = result.request;
+                m_isProcessingRequest = true;
 
                 if (result.request.method == HEADER_REQUEST_METHOD_HEAD)
                 {
                     Request getRequest = result.request;
                     getRequest.method = HEADER_REQUEST_METHOD_GET;
-
-                    Response resp = m_requestHandler->processRequest(getRequest, env);
-
-                    resp.headers[HEADER_CONNECTION] = u"keep-alive"_s;
-                    resp.headers[HEADER_CONTENT_LENGTH] = QString::number(resp.content.length());
-                    resp.content.clear();
-
-                    sendResponse(resp);
+                    m_requestDispatcher(this, 0, getRequest, m_env);
                 }
                 else
                 {
-                    Response resp = m_requestHandler->processRequest(result.request, env);
-
-                    if (acceptsGzipEncoding(result.request.headers.value(u"accept-encoding"_s)))
-                        resp.headers[HEADER_CONTENT_ENCODING] = u"gzip"_s;
-                    resp.headers[HEADER_CONNECTION] = u"keep-alive"_s;
-
-                    sendResponse(resp);
+                    m_requestDispatcher(this, 0, result.request, m_env);
                 }
-
-#if QT_VERSION >= QT_VERSION_CHECK(6, 8, 0)
-                m_receivedData.slice(result.frameSize);
-#else
-                m_receivedData.remove(0, result.frameSize);
-#endif
             }
             break;
 
@@ -170,57 +278,204 @@ void Connection::read()
     }
 }
 
+void Connection::processResponse(Response response, const quint32 streamID)
+{
+    if (m_http2Session)
+    {
+        m_http2Session->processResponse(streamID, std::move(response));
+        return;
+    }
+
+    Q_ASSERT(m_isProcessingRequest);
+
+    // the request is still being processed until the response is resolved
+    if (response.deferredResponse)
+    {
+        waitForDeferredResponse(std::move(response));
+        return;
+    }
+
+    m_isProcessingRequest = false;
+    const Request request = std::exchange(m_pendingRequest, {});
+
+    if (request.method == HEADER_REQUEST_METHOD_HEAD)
+    {
+        if (response.eventStream)
+            std::exchange(response.eventStream, nullptr)->deleteLater();
+        if (response.contentProducer)
+            std::exchange(response.contentProducer, nullptr)->deleteLater();
+
+        response.headers[HEADER_CONNECTION] = u"keep-alive"_s;
+        response.headers[HEADER_CONTENT_LENGTH] = QString::number(response.content.length());
+        response.content.clear();
+
+        sendResponse(response);
+    }
+    else if (response.eventStream)
+    {
+        // the connection is dedicated to the stream until it is closed
+        response.headers[HEADER_CONNECTION] = u"close"_s;
+
+        sendResponse(response);
+        startEventStream(response.eventStream);
+        m_receivedData.clear();
+        return;
+    }
+    else if (response.contentProducer)
+    {
+        response.headers[HEADER_TRANSFER_ENCODING] = u"chunked"_s;
+        const ContentCoding coding = negotiateContentCoding(request.headers.value(HEADER_ACCEPT_ENCODING));
+        // byte ranges refer to the content as it is, so it must not be encoded
+        if ((coding != ContentCoding::Identity) && !response.headers.contains(HEADER_ACCEPT_RANGES))
+        {
+            // the size of the produced content isn't known in advance
+            const int level = compressionLevel(coding, response.headers.value(HEADER_CONTENT_TYPE), -1);
+            m_contentCompressor = std::make_unique<ContentCompressor>(coding, level);
+            response.headers[HEADER_CONTENT_ENCODING] = contentCodingName(coding);
+        }
+        response.headers[HEADER_CONNECTION] = u"keep-alive"_s;
+
+        sendResponse(response);
+        startContentProduction(response.contentProducer);
+        return;
+    }
+    else
+    {
+        // the content may be already encoded by the request handler
+        if (!response.headers.contains(HEADER_CONTENT_ENCODING))
+            compressContent(response, negotiateContentCoding(request.headers.value(HEADER_ACCEPT_ENCODING)));
+        response.headers[HEADER_CONNECTION] = u"keep-alive"_s;
+
+        sendResponse(response);
+    }
+
+    // continue with the pipelined requests if the response was received asynchronously
+    if (!m_isParsing)
+        parseReceivedData();
+}
+
 void Connection::sendResponse(const Response &response) const
 {
     m_socket->write(toByteArray(response));
 }
 
-bool Connection::hasExpired(const qint64 timeout) const
+void Connection::waitForDeferredResponse(Response response)
 {
-    return (m_socket->bytesAvailable() == 0)
-        && (m_socket->bytesToWrite() == 0)
-        && m_idleTimer.hasExpired(timeout);
+    Q_ASSERT(!m_deferredResponse);
+
+    DeferredResponse *deferredResponse = response.deferredResponse;
+    if (deferredResponse->thread() == thread())
+        deferredResponse->setParent(this);
+
+    m_deferredResponse = std::move(response);
+
+    const auto processResolvedResponse = [this]
+    {
+        // signal of already processed response may be queued
+        if (!m_deferredResponse || !m_deferredResponse->deferredResponse->isResolved())
+            return;
+
+        Response keptResponse = *std::exchange(m_deferredResponse, std::nullopt);
+        DeferredResponse *resolvedDeferredResponse = std::exchange(keptResponse.deferredResponse, nullptr);
+        const Response resolvedResponse = resolvedDeferredResponse->takeResponse();
+        // it may be the sender of the signal being handled
+        resolvedDeferredResponse->disconnect(this);
+        resolvedDeferredResponse->deleteLater();
+
+        keptResponse.status = resolvedResponse.status;
+        for (auto iter = resolvedResponse.headers.cbegin(); iter != resolvedResponse.headers.cend(); ++iter)
+            keptResponse.headers[iter.key()] = iter.value();
+        keptResponse.content = resolvedResponse.content;
+
+        processResponse(std::move(keptResponse));
+    };
+
+    connect(deferredResponse, &DeferredResponse::resolved, this, processResolvedResponse);
+    // it could be resolved before the connection is subscribed to it
+    processResolvedResponse();
 }
 
-bool Connection::acceptsGzipEncoding(QString codings)
+void Connection::startEventStream(EventStream *eventStream)
 {
-    // [rfc7231] 5.3.4. Accept-Encoding
+    Q_ASSERT(!m_eventStream);
+
+    m_eventStream = eventStream;
+    if (m_eventStream->thread() == thread())
+        m_eventStream->setParent(this);
 
-    const auto isCodingAvailable = [](const QList<QStringView> &list, const QStringView encoding) -> bool
+    const auto writeData = [this]
     {
-        for (const QStringView &str : list)
-        {
-            if (!str.startsWith(encoding))
-                continue;
+        if (const QByteArray data = m_eventStream->takeData(); !data.isEmpty())
+            m_socket->write(data);
+    };
 
-            // without quality values
-            if (str == encoding)
-                return true;
+    writeData();
+    if (m_eventStream->isClosed())
+    {
+        m_socket->close();
+        return;
+    }
 
-            // [rfc7231] 5.3.1. Quality Values
-            const QStringView substr = str.mid(encoding.size() + 3);  // ex. skip over "gzip;q="
+    connect(m_eventStream, &EventStream::readyRead, this, writeData);
+    connect(m_eventStream, &EventStream::closed, m_socket, &QIODevice::close);
+}
 
-            bool ok = false;
-            const double qvalue = substr.toDouble(&ok);
-            if (!ok || (qvalue <= 0))
-                return false;
+void Connection::startContentProduction(ContentProducer *contentProducer)
+{
+    Q_ASSERT(!m_contentProducer);
 
-            return true;
-        }
-        return false;
-    };
+    m_contentProducer = contentProducer;
+    if (m_contentProducer->thread() == thread())
+        m_contentProducer->setParent(this);
 
-    const QList<QStringView> list = QStringView(codings.remove(u' ').remove(u'\t')).split(u',', Qt::SkipEmptyParts);
-    if (list.isEmpty())
-        return false;
+    connect(m_contentProducer, &ContentProducer::readyRead, this, &Connection::writeProducedContent);
+    writeProducedContent();
+}
 
-    const bool canGzip = isCodingAvailable(list, u"gzip"_s);
-    if (canGzip)
-        return true;
+void Connection::writeProducedContent()
+{
+    // signal of finished producer may be queued
+    if (!m_contentProducer)
+        return;
 
-    const bool canAny = isCodingAvailable(list, u"*"_s);
-    if (canAny)
-        return true;
+    // keep the socket buffer short, so the content is produced only as fast as it is sent
+    if (m_socket->bytesToWrite() > PRODUCED_CONTENT_WRITE_THRESHOLD)
+        return;
+
+    const bool isFinished = m_contentProducer->isFinished();
+    QByteArray data = m_contentProducer->takeData();
+    if (m_contentCompressor)
+        data = m_contentCompressor->compress(data, isFinished);
+
+    // [rfc9112] 7.1. Chunked Transfer Coding
+    if (!data.isEmpty())
+        m_socket->write(QByteArray::number(data.size(), 16).append(CRLF).append(data).append(CRLF));
+
+    if (!isFinished)
+        return;
+
+    m_socket->write(QByteArray("0").append(CRLF).append(CRLF));
+
+    if (m_contentProducer->parent() == this)
+        delete m_contentProducer;
+    else
+        m_contentProducer->deleteLater();
+    m_contentProducer = nullptr;
+    m_contentCompressor.reset();
+
+    if (!m_isParsing)
+        parseReceivedData();
+}
 
-    return false;
+bool Connection::hasExpired(const qint64 timeout) const
+{
+    // event stream connection can be idle as long as the stream is open
+    if (m_eventStream || m_contentProducer || m_isProcessingRequest)
+        return false;
+    if (m_http2Session && !m_http2Session->isIdle())
+        return false;
+
+    return (m_socket->bytesAvailable() == 0)
+        && (m_socket->bytesToWrite() == 0)
+        && m_idleTimer.hasExpired(timeout);
 }
@@ -30,15 +30,28 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+#include <optional>
+
 #include <QElapsedTimer>
 #include <QObject>
 
+#include "requestparser.h"
+#include "types.h"
+
+class QIODevice;
+class QLocalSocket;
 class QTcpSocket;
 
 namespace Http
 {
+    class ContentCompressor;
+    class ContentProducer;
+    class DeferredResponse;
+    class EventStream;
+    class Http2Session;
     class IRequestHandler;
-    struct Response;
 
     class Connection : public QObject
     {
@@ -46,21 +59,54 @@ namespace Http
         Q_DISABLE_COPY_MOVE(Connection)
 
     public:
+        // Passes the request to the request handler and the response back to processResponse() along with `streamID`.
+        // It may be done asynchronously, the next HTTP/1.1 request isn't parsed until the response is received.
+        // HTTP/2 requests are processed concurrently, each one in its own stream.
+        using RequestDispatcher = std::function<void (Connection *connection, quint32 streamID, const Request &request, const Environment &env)>;
+
         Connection(QTcpSocket *socket, IRequestHandler *requestHandler, QObject *parent = nullptr);
+        Connection(QTcpSocket *socket, RequestDispatcher requestDispatcher, QObject *parent = nullptr);
+        // The requests received on the local socket are marked in their environment
+        Connection(QLocalSocket *socket, IRequestHandler *requestHandler, QObject *parent = nullptr);
+        ~Connection() override;
+
+        // The client may use HTTP/2 if it starts the connection with HTTP/2 preface
+        void setHTTP2Enabled(bool enabled);
 
         bool hasExpired(qint64 timeout) const;
+        // `streamID` is 0 for HTTP/1.1 requests
+        void processResponse(Response response, quint32 streamID = 0);
 
     signals:
         void closed();
 
     private:
-        static bool acceptsGzipEncoding(QString codings);
+        Connection(QIODevice *socket, const Environment &env, RequestDispatcher requestDispatcher, QObject *parent);
+
         void read();
+        bool detectHTTP2();
+        void parseReceivedData();
         void sendResponse(const Response &response) const;
+        void startEventStream(EventStream *eventStream);
+        void startContentProduction(ContentProducer *contentProducer);
+        void waitForDeferredResponse(Response response);
+        void writeProducedContent();
 
-        QTcpSocket *m_socket = nullptr;
-        IRequestHandler *m_requestHandler = nullptr;
+        QIODevice *m_socket = nullptr;
+        Environment m_env;
+        RequestDispatcher m_requestDispatcher;
         QByteArray m_receivedData;
+        RequestParser m_requestParser;
         QElapsedTimer m_idleTimer;
+        EventStream *m_eventStream = nullptr;
+        ContentProducer *m_contentProducer = nullptr;
+        std::optional<Response> m_deferredResponse;
+        std::unique_ptr<ContentCompressor> m_contentCompressor;
+        Request m_pendingRequest;
+        bool m_isProcessingRequest = false;
+        bool m_isParsing = false;
+        bool m_isHTTP2Enabled = false;
+        bool m_isProtocolDetected = false;
+        Http2Session *m_http2Session = nullptr;
     };
 }
@@ -0,0 +1,97 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "contentproducer.h"
+
+#include <utility>
+
+#include <QMetaObject>
+#include <QMutexLocker>
+
+using namespace Http;
+
+ContentProducer::ContentProducer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+bool ContentProducer::isFinished() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_isFinished && m_buffer.isEmpty();
+}
+
+QByteArray ContentProducer::takeData()
+{
+    QMutexLocker locker {&m_mutex};
+    QByteArray data = std::exchange(m_buffer, {});
+    if (m_isFinished || m_isProduceRequested)
+        return data;
+
+    m_isProduceRequested = true;
+    locker.unlock();
+
+    QMetaObject::invokeMethod(this, [this]
+    {
+        {
+            const QMutexLocker locker {&m_mutex};
+            m_isProduceRequested = false;
+        }
+
+        produce();
+    }, Qt::QueuedConnection);
+
+    return data;
+}
+
+void ContentProducer::write(const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+
+    QMutexLocker locker {&m_mutex};
+    if (m_isFinished)
+        return;
+
+    m_buffer.append(data);
+    locker.unlock();
+
+    emit readyRead();
+}
+
+void ContentProducer::finish()
+{
+    QMutexLocker locker {&m_mutex};
+    if (m_isFinished)
+        return;
+
+    m_isFinished = true;
+    locker.unlock();
+
+    emit readyRead();
+}
@@ -0,0 +1,69 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+
+namespace Http
+{
+    // Body of response which is produced in parts while it is sent (i.e. "chunked" transfer coding),
+    // so the whole content doesn't need to be kept in memory.
+    // The connection takes the data, possibly from another thread, and each take requests
+    // the next part to be produced in the thread of the producer.
+    class ContentProducer : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(ContentProducer)
+
+    public:
+        explicit ContentProducer(QObject *parent = nullptr);
+
+        // Whether all the content is produced and taken
+        bool isFinished() const;
+        QByteArray takeData();
+
+    signals:
+        void readyRead();
+
+    protected:
+        // Should write the next part of the content or finish it
+        virtual void produce() = 0;
+
+        void write(const QByteArray &data);
+        void finish();
+
+    private:
+        mutable QMutex m_mutex;
+        QByteArray m_buffer;
+        bool m_isFinished = false;
+        bool m_isProduceRequested = false;
+    };
+}
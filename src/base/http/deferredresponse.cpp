@@ -1,6 +1,6 @@
 /*
  * Bittorrent Client using Qt and libtorrent.
- * Copyright (C) 2019  sledgehammer999 <hammered999@gmail.com>
+ * Copyright (C) 2026  qBittorrent project
  *
  * This program is free software; you can redistribute it and/or
  * modify it under the terms of the GNU General Public License
@@ -26,35 +26,40 @@
  * exception statement from your version.
  */
 
-#include "logfiltermodel.h"
+#include "deferredresponse.h"
 
-#include <QtVersionChecks>
+#include <utility>
 
-#include "logmodel.h"
+#include <QMutexLocker>
 
-LogFilterModel::LogFilterModel(const Log::MsgTypes types, QObject *parent)
-    : QSortFilterProxyModel(parent)
-    , m_types(types)
+using namespace Http;
+
+DeferredResponse::DeferredResponse(QObject *parent)
+    : QObject(parent)
 {
 }
 
-void LogFilterModel::setMessageTypes(const Log::MsgTypes types)
+void DeferredResponse::resolve(const Response &response)
 {
-#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
-    beginFilterChange();
-    m_types = types;
-    endFilterChange(Direction::Rows);
-#else
-    m_types = types;
-    invalidateRowsFilter();
-#endif
+    QMutexLocker locker {&m_mutex};
+    if (m_isResolved)
+        return;
+
+    m_response = response;
+    m_isResolved = true;
+    locker.unlock();
+
+    emit resolved();
 }
 
-bool LogFilterModel::filterAcceptsRow(const int sourceRow, const QModelIndex &sourceParent) const
+bool DeferredResponse::isResolved() const
 {
-    const QAbstractItemModel *const sourceModel = this->sourceModel();
-    const QModelIndex index = sourceModel->index(sourceRow, 0, sourceParent);
-    const Log::MsgType type = static_cast<Log::MsgType>(sourceModel->data(index, BaseLogModel::TypeRole).toInt());
+    const QMutexLocker locker {&m_mutex};
+    return m_isResolved;
+}
 
-    return m_types.testFlag(type);
+Response DeferredResponse::takeResponse()
+{
+    const QMutexLocker locker {&m_mutex};
+    return std::exchange(m_response, std::nullopt).value_or(Response());
 }
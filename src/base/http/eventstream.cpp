@@ -0,0 +1,87 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "eventstream.h"
+
+#include <utility>
+
+#include <QList>
+#include <QMutexLocker>
+#include <QString>
+
+#include "base/global.h"
+
+using namespace Http;
+
+EventStream::EventStream(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void EventStream::sendEvent(const QByteArray &data, const QString &eventName, const QString &eventID)
+{
+    QMutexLocker locker {&m_mutex};
+    if (m_isClosed)
+        return;
+
+    // [WHATWG HTML] 9.2.5 Parsing an event stream
+    if (!eventName.isEmpty())
+        m_buffer.append("event: ").append(eventName.toUtf8()).append('\n');
+    if (!eventID.isEmpty())
+        m_buffer.append("id: ").append(eventID.toUtf8()).append('\n');
+    for (const QByteArray &line : asConst(data.split('\n')))
+        m_buffer.append("data: ").append(line).append('\n');
+    m_buffer.append('\n');
+    locker.unlock();
+
+    emit readyRead();
+}
+
+void EventStream::close()
+{
+    QMutexLocker locker {&m_mutex};
+    if (m_isClosed)
+        return;
+
+    m_isClosed = true;
+    locker.unlock();
+
+    emit closed();
+}
+
+bool EventStream::isClosed() const
+{
+    const QMutexLocker locker {&m_mutex};
+    return m_isClosed;
+}
+
+QByteArray EventStream::takeData()
+{
+    const QMutexLocker locker {&m_mutex};
+    return std::exchange(m_buffer, {});
+}
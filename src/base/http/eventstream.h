@@ -0,0 +1,66 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QMutex>
+#include <QObject>
+
+class QString;
+
+namespace Http
+{
+    // Body of "text/event-stream" response (i.e. Server-Sent Events).
+    // The events are buffered until the connection takes them
+    // so they can be sent even before the response is written.
+    // The connection may take the data from another thread.
+    class EventStream final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(EventStream)
+
+    public:
+        explicit EventStream(QObject *parent = nullptr);
+
+        void sendEvent(const QByteArray &data, const QString &eventName = {}, const QString &eventID = {});
+        void close();
+
+        bool isClosed() const;
+        QByteArray takeData();
+
+    signals:
+        void readyRead();
+        void closed();
+
+    private:
+        mutable QMutex m_mutex;
+        QByteArray m_buffer;
+        bool m_isClosed = false;
+    };
+}
@@ -0,0 +1,626 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "hpack.h"
+
+#include <algorithm>
+#include <array>
+#include <utility>
+#include <vector>
+
+#include "base/global.h"
+
+using namespace Http::HPack;
+
+namespace
+{
+    // Header field sizes include a fixed overhead of the entry ([rfc7541] 4.1.)
+    const qsizetype ENTRY_OVERHEAD = 32;
+
+    struct HuffmanCode
+    {
+        quint32 code;
+        int length;
+    };
+
+    // [rfc7541] Appendix B. Huffman Code, the last one is EOS
+    const std::array<HuffmanCode, 257> HUFFMAN_CODES
+    {{
+        {0x1ff8, 13}, {0x7fffd8, 23}, {0xfffffe2, 28}, {0xfffffe3, 28},
+        {0xfffffe4, 28}, {0xfffffe5, 28}, {0xfffffe6, 28}, {0xfffffe7, 28},
+        {0xfffffe8, 28}, {0xffffea, 24}, {0x3ffffffc, 30}, {0xfffffe9, 28},
+        {0xfffffea, 28}, {0x3ffffffd, 30}, {0xfffffeb, 28}, {0xfffffec, 28},
+        {0xfffffed, 28}, {0xfffffee, 28}, {0xfffffef, 28}, {0xffffff0, 28},
+        {0xffffff1, 28}, {0xffffff2, 28}, {0x3ffffffe, 30}, {0xffffff3, 28},
+        {0xffffff4, 28}, {0xffffff5, 28}, {0xffffff6, 28}, {0xffffff7, 28},
+        {0xffffff8, 28}, {0xffffff9, 28}, {0xffffffa, 28}, {0xffffffb, 28},
+        {0x14, 6}, {0x3f8, 10}, {0x3f9, 10}, {0xffa, 12},
+        {0x1ff9, 13}, {0x15, 6}, {0xf8, 8}, {0x7fa, 11},
+        {0x3fa, 10}, {0x3fb, 10}, {0xf9, 8}, {0x7fb, 11},
+        {0xfa, 8}, {0x16, 6}, {0x17, 6}, {0x18, 6},
+        {0x0, 5}, {0x1, 5}, {0x2, 5}, {0x19, 6},
+        {0x1a, 6}, {0x1b, 6}, {0x1c, 6}, {0x1d, 6},
+        {0x1e, 6}, {0x1f, 6}, {0x5c, 7}, {0xfb, 8},
+        {0x7ffc, 15}, {0x20, 6}, {0xffb, 12}, {0x3fc, 10},
+        {0x1ffa, 13}, {0x21, 6}, {0x5d, 7}, {0x5e, 7},
+        {0x5f, 7}, {0x60, 7}, {0x61, 7}, {0x62, 7},
+        {0x63, 7}, {0x64, 7}, {0x65, 7}, {0x66, 7},
+        {0x67, 7}, {0x68, 7}, {0x69, 7}, {0x6a, 7},
+        {0x6b, 7}, {0x6c, 7}, {0x6d, 7}, {0x6e, 7},
+        {0x6f, 7}, {0x70, 7}, {0x71, 7}, {0x72, 7},
+        {0xfc, 8}, {0x73, 7}, {0xfd, 8}, {0x1ffb, 13},
+        {0x7fff0, 19}, {0x1ffc, 13}, {0x3ffc, 14}, {0x22, 6},
+        {0x7ffd, 15}, {0x3, 5}, {0x23, 6}, {0x4, 5},
+        {0x24, 6}, {0x5, 5}, {0x25, 6}, {0x26, 6},
+        {0x27, 6}, {0x6, 5}, {0x74, 7}, {0x75, 7},
+        {0x28, 6}, {0x29, 6}, {0x2a, 6}, {0x7, 5},
+        {0x2b, 6}, {0x76, 7}, {0x2c, 6}, {0x8, 5},
+        {0x9, 5}, {0x2d, 6}, {0x77, 7}, {0x78, 7},
+        {0x79, 7}, {0x7a, 7}, {0x7b, 7}, {0x7ffe, 15},
+        {0x7fc, 11}, {0x3ffd, 14}, {0x1ffd, 13}, {0xffffffc, 28},
+        {0xfffe6, 20}, {0x3fffd2, 22}, {0xfffe7, 20}, {0xfffe8, 20},
+        {0x3fffd3, 22}, {0x3fffd4, 22}, {0x3fffd5, 22}, {0x7fffd9, 23},
+        {0x3fffd6, 22}, {0x7fffda, 23}, {0x7fffdb, 23}, {0x7fffdc, 23},
+        {0x7fffdd, 23}, {0x7fffde, 23}, {0xffffeb, 24}, {0x7fffdf, 23},
+        {0xffffec, 24}, {0xffffed, 24}, {0x3fffd7, 22}, {0x7fffe0, 23},
+        {0xffffee, 24}, {0x7fffe1, 23}, {0x7fffe2, 23}, {0x7fffe3, 23},
+        {0x7fffe4, 23}, {0x1fffdc, 21}, {0x3fffd8, 22}, {0x7fffe5, 23},
+        {0x3fffd9, 22}, {0x7fffe6, 23}, {0x7fffe7, 23}, {0xffffef, 24},
+        {0x3fffda, 22}, {0x1fffdd, 21}, {0xfffe9, 20}, {0x3fffdb, 22},
+        {0x3fffdc, 22}, {0x7fffe8, 23}, {0x7fffe9, 23}, {0x1fffde, 21},
+        {0x7fffea, 23}, {0x3fffdd, 22}, {0x3fffde, 22}, {0xfffff0, 24},
+        {0x1fffdf, 21}, {0x3fffdf, 22}, {0x7fffeb, 23}, {0x7fffec, 23},
+        {0x1fffe0, 21}, {0x1fffe1, 21}, {0x3fffe0, 22}, {0x1fffe2, 21},
+        {0x7fffed, 23}, {0x3fffe1, 22}, {0x7fffee, 23}, {0x7fffef, 23},
+        {0xfffea, 20}, {0x3fffe2, 22}, {0x3fffe3, 22}, {0x3fffe4, 22},
+        {0x7ffff0, 23}, {0x3fffe5, 22}, {0x3fffe6, 22}, {0x7ffff1, 23},
+        {0x3ffffe0, 26}, {0x3ffffe1, 26}, {0xfffeb, 20}, {0x7fff1, 19},
+        {0x3fffe7, 22}, {0x7ffff2, 23}, {0x3fffe8, 22}, {0x1ffffec, 25},
+        {0x3ffffe2, 26}, {0x3ffffe3, 26}, {0x3ffffe4, 26}, {0x7ffffde, 27},
+        {0x7ffffdf, 27}, {0x3ffffe5, 26}, {0xfffff1, 24}, {0x1ffffed, 25},
+        {0x7fff2, 19}, {0x1fffe3, 21}, {0x3ffffe6, 26}, {0x7ffffe0, 27},
+        {0x7ffffe1, 27}, {0x3ffffe7, 26}, {0x7ffffe2, 27}, {0xfffff2, 24},
+        {0x1fffe4, 21}, {0x1fffe5, 21}, {0x3ffffe8, 26}, {0x3ffffe9, 26},
+        {0xffffffd, 28}, {0x7ffffe3, 27}, {0x7ffffe4, 27}, {0x7ffffe5, 27},
+        {0xfffec, 20}, {0xfffff3, 24}, {0xfffed, 20}, {0x1fffe6, 21},
+        {0x3fffe9, 22}, {0x1fffe7, 21}, {0x1fffe8, 21}, {0x7ffff3, 23},
+        {0x3fffea, 22}, {0x3fffeb, 22}, {0x1ffffee, 25}, {0x1ffffef, 25},
+        {0xfffff4, 24}, {0xfffff5, 24}, {0x3ffffea, 26}, {0x7ffff4, 23},
+        {0x3ffffeb, 26}, {0x7ffffe6, 27}, {0x3ffffec, 26}, {0x3ffffed, 26},
+        {0x7ffffe7, 27}, {0x7ffffe8, 27}, {0x7ffffe9, 27}, {0x7ffffea, 27},
+        {0x7ffffeb, 27}, {0xffffffe, 28}, {0x7ffffec, 27}, {0x7ffffed, 27},
+        {0x7ffffee, 27}, {0x7ffffef, 27}, {0x7fffff0, 27}, {0x3ffffee, 26},
+        {0x3fffffff, 30},
+    }};
+
+    const int HUFFMAN_EOS = 256;
+
+    // [rfc7541] Appendix A. Static Table Definition
+    const std::array<HeaderField, 61> STATIC_TABLE
+    {{
+        {":authority"_ba, ""_ba},
+        {":method"_ba, "GET"_ba},
+        {":method"_ba, "POST"_ba},
+        {":path"_ba, "/"_ba},
+        {":path"_ba, "/index.html"_ba},
+        {":scheme"_ba, "http"_ba},
+        {":scheme"_ba, "https"_ba},
+        {":status"_ba, "200"_ba},
+        {":status"_ba, "204"_ba},
+        {":status"_ba, "206"_ba},
+        {":status"_ba, "304"_ba},
+        {":status"_ba, "400"_ba},
+        {":status"_ba, "404"_ba},
+        {":status"_ba, "500"_ba},
+        {"accept-charset"_ba, ""_ba},
+        {"accept-encoding"_ba, "gzip, deflate"_ba},
+        {"accept-language"_ba, ""_ba},
+        {"accept-ranges"_ba, ""_ba},
+        {"accept"_ba, ""_ba},
+        {"access-control-allow-origin"_ba, ""_ba},
+        {"age"_ba, ""_ba},
+        {"allow"_ba, ""_ba},
+        {"authorization"_ba, ""_ba},
+        {"cache-control"_ba, ""_ba},
+        {"content-disposition"_ba, ""_ba},
+        {"content-encoding"_ba, ""_ba},
+        {"content-language"_ba, ""_ba},
+        {"content-length"_ba, ""_ba},
+        {"content-location"_ba, ""_ba},
+        {"content-range"_ba, ""_ba},
+        {"content-type"_ba, ""_ba},
+        {"cookie"_ba, ""_ba},
+        {"date"_ba, ""_ba},
+        {"etag"_ba, ""_ba},
+        {"expect"_ba, ""_ba},
+        {"expires"_ba, ""_ba},
+        {"from"_ba, ""_ba},
+        {"host"_ba, ""_ba},
+        {"if-match"_ba, ""_ba},
+        {"if-modified-since"_ba, ""_ba},
+        {"if-none-match"_ba, ""_ba},
+        {"if-range"_ba, ""_ba},
+        {"if-unmodified-since"_ba, ""_ba},
+        {"last-modified"_ba, ""_ba},
+        {"link"_ba, ""_ba},
+        {"location"_ba, ""_ba},
+        {"max-forwards"_ba, ""_ba},
+        {"proxy-authenticate"_ba, ""_ba},
+        {"proxy-authorization"_ba, ""_ba},
+        {"range"_ba, ""_ba},
+        {"referer"_ba, ""_ba},
+        {"refresh"_ba, ""_ba},
+        {"retry-after"_ba, ""_ba},
+        {"server"_ba, ""_ba},
+        {"set-cookie"_ba, ""_ba},
+        {"strict-transport-security"_ba, ""_ba},
+        {"transfer-encoding"_ba, ""_ba},
+        {"user-agent"_ba, ""_ba},
+        {"vary"_ba, ""_ba},
+        {"via"_ba, ""_ba},
+        {"www-authenticate"_ba, ""_ba}
+    }};
+
+    struct HuffmanNode
+    {
+        std::array<int, 2> children {-1, -1};
+        int symbol = -1;
+    };
+
+    // Binary tree of the codes, the symbols are found by walking it bit by bit
+    const std::vector<HuffmanNode> &huffmanTree()
+    {
+        static const std::vector<HuffmanNode> tree = []
+        {
+            std::vector<HuffmanNode> nodes(1);
+            for (int symbol = 0; symbol < static_cast<int>(HUFFMAN_CODES.size()); ++symbol)
+            {
+                const auto [code, length] = HUFFMAN_CODES[symbol];
+                int node = 0;
+                for (int i = (length - 1); i >= 0; --i)
+                {
+                    const int bit = (code >> i) & 1;
+                    if (nodes[node].children[bit] < 0)
+                    {
+                        nodes[node].children[bit] = static_cast<int>(nodes.size());
+                        nodes.emplace_back();
+                    }
+                    node = nodes[node].children[bit];
+                }
+                nodes[node].symbol = symbol;
+            }
+            return nodes;
+        }();
+
+        return tree;
+    }
+
+    qsizetype entrySize(const HeaderField &field)
+    {
+        return field.name.size() + field.value.size() + ENTRY_OVERHEAD;
+    }
+
+    // [rfc7541] 5.1. Integer Representation
+    void encodeInteger(QByteArray &out, const quint8 prefixBits, const int prefixLength, qsizetype value)
+    {
+        const qsizetype maxPrefixValue = (1 << prefixLength) - 1;
+        if (value < maxPrefixValue)
+        {
+            out.append(static_cast<char>(prefixBits | value));
+            return;
+        }
+
+        out.append(static_cast<char>(prefixBits | maxPrefixValue));
+        value -= maxPrefixValue;
+        while (value >= 128)
+        {
+            out.append(static_cast<char>((value % 128) + 128));
+            value /= 128;
+        }
+        out.append(static_cast<char>(value));
+    }
+
+    std::optional<qsizetype> decodeInteger(const QByteArrayView data, qsizetype &pos, const int prefixLength)
+    {
+        if (pos >= data.size())
+            return std::nullopt;
+
+        const qsizetype maxPrefixValue = (1 << prefixLength) - 1;
+        qsizetype value = static_cast<quint8>(data[pos++]) & maxPrefixValue;
+        if (value < maxPrefixValue)
+            return value;
+
+        // larger values than it aren't used by any sane peer
+        const int maxShift = 21;
+        for (int shift = 0; shift <= maxShift; shift += 7)
+        {
+            if (pos >= data.size())
+                return std::nullopt;
+
+            const auto byte = static_cast<quint8>(data[pos++]);
+            value += static_cast<qsizetype>(byte & 127) << shift;
+            if ((byte & 128) == 0)
+                return value;
+        }
+
+        return std::nullopt;
+    }
+
+    // [rfc7541] 5.2. String Literal Representation
+    void encodeString(QByteArray &out, const QByteArrayView str)
+    {
+        if (const QByteArray encoded = encodeHuffman(str); encoded.size() < str.size())
+        {
+            encodeInteger(out, 0x80, 7, encoded.size());
+            out.append(encoded);
+        }
+        else
+        {
+            encodeInteger(out, 0x00, 7, str.size());
+            out.append(str);
+        }
+    }
+
+    std::optional<QByteArray> decodeString(const QByteArrayView data, qsizetype &pos)
+    {
+        if (pos >= data.size())
+            return std::nullopt;
+
+        const bool isHuffmanEncoded = (static_cast<quint8>(data[pos]) & 0x80) != 0;
+        const std::optional<qsizetype> length = decodeInteger(data, pos, 7);
+        if (!length || (*length > (data.size() - pos)))
+            return std::nullopt;
+
+        const QByteArrayView str = data.sliced(pos, *length);
+        pos += *length;
+        return isHuffmanEncoded ? decodeHuffman(str) : str.toByteArray();
+    }
+
+    std::optional<HeaderField> lookupField(const DynamicTable &table, const qsizetype index)
+    {
+        if (index <= 0)
+            return std::nullopt;
+        if (index <= static_cast<qsizetype>(STATIC_TABLE.size()))
+            return STATIC_TABLE[index - 1];
+        return table.field(index);
+    }
+
+    // The values of these fields differ in almost every response, so they would only push the other fields out of the table
+    bool isWorthIndexing(const QByteArrayView name)
+    {
+        return (name != "content-length") && (name != "date") && (name != "etag")
+            && (name != "last-modified") && (name != "content-range");
+    }
+
+    // [rfc7541] 7.1.3. Never-Indexed Literals
+    bool isSensitive(const QByteArrayView name)
+    {
+        return (name == "set-cookie") || (name == "authorization");
+    }
+}
+
+std::optional<QByteArray> Http::HPack::decodeHuffman(const QByteArrayView data)
+{
+    const std::vector<HuffmanNode> &tree = huffmanTree();
+
+    QByteArray decoded;
+    decoded.reserve(data.size() * 8 / 5);
+
+    int node = 0;
+    int paddingLength = 0;  // bits read since the last symbol
+    bool isPaddingValid = true;  // padding must be the most significant bits of EOS code, i.e. all ones
+    for (const char c : data)
+    {
+        const auto byte = static_cast<quint8>(c);
+        for (int i = 7; i >= 0; --i)
+        {
+            const int bit = (byte >> i) & 1;
+            node = tree[node].children[bit];
+            if (node < 0)
+                return std::nullopt;
+
+            ++paddingLength;
+            if (bit == 0)
+                isPaddingValid = false;
+
+            if (const int symbol = tree[node].symbol; symbol >= 0)
+            {
+                if (symbol == HUFFMAN_EOS)
+                    return std::nullopt;
+
+                decoded.append(static_cast<char>(symbol));
+                node = 0;
+                paddingLength = 0;
+                isPaddingValid = true;
+            }
+        }
+    }
+
+    if ((paddingLength > 7) || !isPaddingValid)
+        return std::nullopt;
+
+    return decoded;
+}
+
+QByteArray Http::HPack::encodeHuffman(const QByteArrayView data)
+{
+    QByteArray encoded;
+    encoded.reserve(data.size());
+
+    quint64 bits = 0;
+    int bitCount = 0;
+    for (const char c : data)
+    {
+        const auto [code, length] = HUFFMAN_CODES[static_cast<quint8>(c)];
+        bits = (bits << length) | code;
+        bitCount += length;
+        while (bitCount >= 8)
+        {
+            bitCount -= 8;
+            encoded.append(static_cast<char>(bits >> bitCount));
+        }
+    }
+
+    if (bitCount > 0)
+    {
+        // pad with the most significant bits of EOS code
+        const int paddingLength = 8 - bitCount;
+        encoded.append(static_cast<char>((bits << paddingLength) | ((1 << paddingLength) - 1)));
+    }
+
+    return encoded;
+}
+
+// DynamicTable
+
+DynamicTable::DynamicTable(const qsizetype maxSize)
+    : m_maxSize {maxSize}
+{
+}
+
+qsizetype DynamicTable::maxSize() const
+{
+    return m_maxSize;
+}
+
+void DynamicTable::setMaxSize(const qsizetype maxSize)
+{
+    m_maxSize = maxSize;
+    evict(m_maxSize);
+}
+
+std::optional<HeaderField> DynamicTable::field(const qsizetype index) const
+{
+    const qsizetype i = index - static_cast<qsizetype>(STATIC_TABLE.size()) - 1;
+    if ((i < 0) || (i >= m_fields.size()))
+        return std::nullopt;
+
+    return m_fields[i];
+}
+
+void DynamicTable::add(const HeaderField &field)
+{
+    // [rfc7541] 4.4. Entry Eviction When Adding New Entries
+    const qsizetype size = entrySize(field);
+    evict(m_maxSize - size);
+    if (size > m_maxSize)
+        return;
+
+    m_fields.prepend(field);
+    m_size += size;
+}
+
+qsizetype DynamicTable::find(const HeaderField &field, bool *isValueMatched) const
+{
+    qsizetype nameIndex = 0;
+
+    for (qsizetype i = 0; i < static_cast<qsizetype>(STATIC_TABLE.size()); ++i)
+    {
+        const HeaderField &staticField = STATIC_TABLE[i];
+        if (staticField.name != field.name)
+            continue;
+
+        if (staticField.value == field.value)
+        {
+            *isValueMatched = true;
+            return (i + 1);
+        }
+
+        if (nameIndex == 0)
+            nameIndex = i + 1;
+    }
+
+    for (qsizetype i = 0; i < m_fields.size(); ++i)
+    {
+        const HeaderField &dynamicField = m_fields[i];
+        if (dynamicField.name != field.name)
+            continue;
+
+        const qsizetype index = static_cast<qsizetype>(STATIC_TABLE.size()) + i + 1;
+        if (dynamicField.value == field.value)
+        {
+            *isValueMatched = true;
+            return index;
+        }
+
+        if (nameIndex == 0)
+            nameIndex = index;
+    }
+
+    *isValueMatched = false;
+    return nameIndex;
+}
+
+void DynamicTable::evict(const qsizetype maxSize)
+{
+    while (!m_fields.isEmpty() && (m_size > maxSize))
+        m_size -= entrySize(m_fields.takeLast());
+}
+
+// Decoder
+
+Decoder::Decoder(const qsizetype maxHeaderListSize)
+    : m_maxHeaderListSize {maxHeaderListSize}
+{
+}
+
+std::optional<HeaderList> Decoder::decode(const QByteArrayView block)
+{
+    HeaderList headers;
+    qsizetype headerListSize = 0;
+    qsizetype pos = 0;
+    while (pos < block.size())
+    {
+        const auto firstByte = static_cast<quint8>(block[pos]);
+
+        // [rfc7541] 6.3. Dynamic Table Size Update
+        if ((firstByte & 0xE0) == 0x20)
+        {
+            // it is only allowed at the beginning of the block
+            if (!headers.isEmpty())
+                return std::nullopt;
+
+            const std::optional<qsizetype> size = decodeInteger(block, pos, 5);
+            if (!size || (*size > DEFAULT_TABLE_SIZE))
+                return std::nullopt;
+
+            m_table.setMaxSize(*size);
+            continue;
+        }
+
+        HeaderField field;
+
+        if ((firstByte & 0x80) != 0)
+        {
+            // [rfc7541] 6.1. Indexed Header Field Representation
+            const std::optional<qsizetype> index = decodeInteger(block, pos, 7);
+            if (!index)
+                return std::nullopt;
+
+            std::optional<HeaderField> indexedField = lookupField(m_table, *index);
+            if (!indexedField)
+                return std::nullopt;
+
+            field = std::move(*indexedField);
+        }
+        else
+        {
+            // [rfc7541] 6.2. Literal Header Field Representation
+            const bool isIndexed = (firstByte & 0xC0) == 0x40;
+            const std::optional<qsizetype> nameIndex = decodeInteger(block, pos, (isIndexed ? 6 : 4));
+            if (!nameIndex)
+                return std::nullopt;
+
+            if (*nameIndex > 0)
+            {
+                std::optional<HeaderField> indexedField = lookupField(m_table, *nameIndex);
+                if (!indexedField)
+                    return std::nullopt;
+
+                field.name = std::move(indexedField->name);
+            }
+            else
+            {
+                std::optional<QByteArray> name = decodeString(block, pos);
+                if (!name)
+                    return std::nullopt;
+
+                field.name = std::move(*name);
+            }
+
+            std::optional<QByteArray> value = decodeString(block, pos);
+            if (!value)
+                return std::nullopt;
+
+            field.value = std::move(*value);
+
+            if (isIndexed)
+                m_table.add(field);
+        }
+
+        // [rfc9113] 6.5.2. SETTINGS_MAX_HEADER_LIST_SIZE
+        headerListSize += entrySize(field);
+        if (headerListSize > m_maxHeaderListSize)
+            return std::nullopt;
+
+        headers.append(std::move(field));
+    }
+
+    return headers;
+}
+
+// Encoder
+
+void Encoder::setMaxTableSize(qsizetype size)
+{
+    // there is no use of larger table for the responses
+    size = std::min(size, DEFAULT_TABLE_SIZE);
+    if (size == m_table.maxSize())
+        return;
+
+    m_table.setMaxSize(size);
+    m_pendingTableSizeUpdate = size;
+}
+
+QByteArray Encoder::encode(const HeaderList &headers)
+{
+    QByteArray block;
+    block.reserve(512);
+
+    if (m_pendingTableSizeUpdate)
+        encodeInteger(block, 0x20, 5, *std::exchange(m_pendingTableSizeUpdate, std::nullopt));
+
+    for (const HeaderField &field : headers)
+    {
+        bool isValueMatched = false;
+        const qsizetype index = m_table.find(field, &isValueMatched);
+        if (isValueMatched)
+        {
+            // [rfc7541] 6.1. Indexed Header Field Representation
+            encodeInteger(block, 0x80, 7, index);
+            continue;
+        }
+
+        // [rfc7541] 6.2. Literal Header Field Representation
+        if (isSensitive(field.name))
+            encodeInteger(block, 0x10, 4, index);
+        else if (isWorthIndexing(field.name))
+            encodeInteger(block, 0x40, 6, index);
+        else
+            encodeInteger(block, 0x00, 4, index);
+
+        if (index == 0)
+            encodeString(block, field.name);
+        encodeString(block, field.value);
+
+        if (!isSensitive(field.name) && isWorthIndexing(field.name))
+            m_table.add(field);
+    }
+
+    return block;
+}
@@ -0,0 +1,109 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <optional>
+
+#include <QtTypes>
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+
+namespace Http::HPack
+{
+    // [rfc7541] HPACK: Header Compression for HTTP/2
+
+    struct HeaderField
+    {
+        QByteArray name;
+        QByteArray value;
+
+        friend bool operator==(const HeaderField &left, const HeaderField &right) = default;
+    };
+
+    using HeaderList = QList<HeaderField>;
+
+    inline const qsizetype DEFAULT_TABLE_SIZE = 4096;
+
+    // Nothing is returned if the data isn't a valid Huffman encoded string
+    std::optional<QByteArray> decodeHuffman(QByteArrayView data);
+    QByteArray encodeHuffman(QByteArrayView data);
+
+    class DynamicTable
+    {
+    public:
+        explicit DynamicTable(qsizetype maxSize = DEFAULT_TABLE_SIZE);
+
+        qsizetype maxSize() const;
+        void setMaxSize(qsizetype maxSize);
+
+        // Fields are indexed starting from the static table, i.e. the first index is 62
+        std::optional<HeaderField> field(qsizetype index) const;
+        void add(const HeaderField &field);
+        // Returns the index of the field matching both the name and the value if there is one,
+        // otherwise the index of the field with the same name, 0 if there is none
+        qsizetype find(const HeaderField &field, bool *isValueMatched) const;
+
+    private:
+        void evict(qsizetype maxSize);
+
+        QList<HeaderField> m_fields;  // the newest field first
+        qsizetype m_size = 0;
+        qsizetype m_maxSize = 0;
+    };
+
+    class Decoder
+    {
+    public:
+        // The decoded header list is limited, since a small block may refer to large table entries many times
+        explicit Decoder(qsizetype maxHeaderListSize);
+
+        // Nothing is returned if the header block is malformed, it is a connection error then
+        // and the decoder can't be used anymore
+        std::optional<HeaderList> decode(QByteArrayView block);
+
+    private:
+        DynamicTable m_table;
+        qsizetype m_maxHeaderListSize = 0;
+    };
+
+    class Encoder
+    {
+    public:
+        // The peer may allow the encoder to use a smaller table,
+        // the new size is signaled at the beginning of the next header block
+        void setMaxTableSize(qsizetype size);
+
+        QByteArray encode(const HeaderList &headers);
+
+    private:
+        DynamicTable m_table;
+        std::optional<qsizetype> m_pendingTableSizeUpdate;
+    };
+}
@@ -0,0 +1,1167 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "http2session.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QIODevice>
+#include <QList>
+#include <QtEndian>
+
+#include "contentproducer.h"
+#include "deferredresponse.h"
+#include "eventstream.h"
+#include "responsegenerator.h"
+
+using namespace Http;
+
+// [rfc9113] 6. Frame Definitions
+enum class Http2Session::FrameType : quint8
+{
+    Data = 0x0,
+    Headers = 0x1,
+    Priority = 0x2,
+    ResetStream = 0x3,
+    Settings = 0x4,
+    PushPromise = 0x5,
+    Ping = 0x6,
+    GoAway = 0x7,
+    WindowUpdate = 0x8,
+    Continuation = 0x9
+};
+
+// [rfc9113] 7. Error Codes
+enum class Http2Session::ErrorCode : quint32
+{
+    NoError = 0x0,
+    ProtocolError = 0x1,
+    InternalError = 0x2,
+    FlowControlError = 0x3,
+    SettingsTimeout = 0x4,
+    StreamClosed = 0x5,
+    FrameSizeError = 0x6,
+    RefusedStream = 0x7,
+    Cancel = 0x8,
+    CompressionError = 0x9,
+    ConnectError = 0xA,
+    EnhanceYourCalm = 0xB,
+    InadequateSecurity = 0xC,
+    HTTP11Required = 0xD
+};
+
+namespace
+{
+    // [rfc9113] 6.5.2. Defined Settings
+    enum class SettingID : quint16
+    {
+        HeaderTableSize = 0x1,
+        EnablePush = 0x2,
+        MaxConcurrentStreams = 0x3,
+        InitialWindowSize = 0x4,
+        MaxFrameSize = 0x5,
+        MaxHeaderListSize = 0x6
+    };
+
+    namespace FrameFlag
+    {
+        const quint8 EndStream = 0x1;
+        const quint8 Ack = 0x1;
+        const quint8 EndHeaders = 0x4;
+        const quint8 Padded = 0x8;
+        const quint8 Priority = 0x20;
+    }
+
+    const qsizetype FRAME_HEADER_SIZE = 9;
+    const qint64 DEFAULT_WINDOW_SIZE = 65'535;
+    const qint64 MAX_WINDOW_SIZE = 0x7FFF'FFFF;
+    // it is also the size of the largest frame accepted from the client
+    const qsizetype DEFAULT_MAX_FRAME_SIZE = 16'384;
+    const qsizetype MAX_ALLOWED_FRAME_SIZE = 0xFF'FFFF;
+
+    const quint32 MAX_CONCURRENT_STREAMS = 100;
+    const quint32 MAX_HEADER_LIST_SIZE = 64 * 1024;
+    // large enough for the client to upload files without waiting for the window updates
+    const quint32 RECEIVE_WINDOW_SIZE = 1024 * 1024;
+    // request bodies of all the streams together, so the concurrent uploads of the client
+    // don't take more memory than a single request of HTTP/1.1 connection
+    const qint64 MAX_BUFFERED_BODY_SIZE = RequestParser::MAX_CONTENT_SIZE;
+    // data frames are written only when the socket is about to run out of data,
+    // so the streams share the connection in turns
+    const qint64 SOCKET_WRITE_THRESHOLD = 256 * 1024;
+    // produced content is taken only when its stream is about to run out of data
+    const qsizetype PRODUCED_CONTENT_WRITE_THRESHOLD = 256 * 1024;
+
+    struct RequestHead
+    {
+        QString method;
+        QByteArray target;
+        HeaderMap headers;
+    };
+
+    quint32 readUInt32(const QByteArrayView data)
+    {
+        return qFromBigEndian<quint32>(data.data());
+    }
+
+    void appendUInt32(QByteArray &data, const quint32 value)
+    {
+        char buffer[sizeof(value)];
+        qToBigEndian(value, buffer);
+        data.append(buffer, sizeof(buffer));
+    }
+
+    void appendSetting(QByteArray &data, const SettingID id, const quint32 value)
+    {
+        char buffer[sizeof(id)];
+        qToBigEndian(static_cast<quint16>(id), buffer);
+        data.append(buffer, sizeof(buffer));
+        appendUInt32(data, value);
+    }
+
+    bool isUpper(const char c)
+    {
+        return (c >= 'A') && (c <= 'Z');
+    }
+
+    bool isConnectionSpecificHeader(const QByteArray &name)
+    {
+        // [rfc9113] 8.2.2. Connection-Specific Header Fields
+        return (name == "connection") || (name == "keep-alive") || (name == "proxy-connection")
+            || (name == "transfer-encoding") || (name == "upgrade");
+    }
+
+    // Nothing is returned if the padding is malformed
+    std::optional<QByteArrayView> removePadding(const QByteArrayView payload, const quint8 flags)
+    {
+        // [rfc9113] 6.1. DATA
+        if (!(flags & FrameFlag::Padded))
+            return payload;
+        if (payload.isEmpty())
+            return std::nullopt;
+
+        const qsizetype padLength = static_cast<uchar>(payload[0]);
+        if (padLength >= payload.size())
+            return std::nullopt;
+
+        return payload.sliced(1, (payload.size() - 1 - padLength));
+    }
+
+    // Nothing is returned if the request is malformed
+    std::optional<RequestHead> parseRequestHead(const HPack::HeaderList &fields)
+    {
+        // [rfc9113] 8.3.1. Request Pseudo-Header Fields
+        RequestHead head;
+        QByteArray scheme;
+        QByteArray authority;
+        bool isPseudoHeaderAllowed = true;
+
+        for (const HPack::HeaderField &field : fields)
+        {
+            if (field.name.isEmpty())
+                return std::nullopt;
+
+            if (field.name.startsWith(':'))
+            {
+                // pseudo-header fields precede the regular ones
+                if (!isPseudoHeaderAllowed)
+                    return std::nullopt;
+
+                if (field.name == ":method")
+                    head.method = QString::fromLatin1(field.value);
+                else if (field.name == ":path")
+                    head.target = field.value;
+                else if (field.name == ":scheme")
+                    scheme = field.value;
+                else if (field.name == ":authority")
+                    authority = field.value;
+                else
+                    return std::nullopt;
+                continue;
+            }
+            isPseudoHeaderAllowed = false;
+
+            // [rfc9113] 8.2. HTTP Fields
+            if (std::ranges::any_of(field.name, isUpper) || isConnectionSpecificHeader(field.name)
+                || ((field.name == "te") && (field.value != "trailers")))
+            {
+                return std::nullopt;
+            }
+
+            // [rfc9113] 8.2.3. Compressing the Cookie Header Field
+            const QString name = QString::fromLatin1(field.name);
+            QString &value = head.headers[name];
+            if (!value.isEmpty())
+                value += ((name == HEADER_COOKIE) ? u"; "_s : u", "_s);
+            value += QString::fromLatin1(field.value);
+        }
+
+        if (head.method.isEmpty() || head.target.isEmpty() || scheme.isEmpty())
+            return std::nullopt;
+
+        // it has the same meaning as "Host" header of HTTP/1.1
+        if (!authority.isEmpty())
+            head.headers[HEADER_HOST] = QString::fromLatin1(authority);
+
+        return head;
+    }
+
+    // The objects created in another thread can't be owned as a child,
+    // and the object may be the sender of the signal being handled
+    void releaseObject(QObject *object, const QObject *owner)
+    {
+        if (!object)
+            return;
+
+        object->disconnect(owner);
+        object->deleteLater();
+    }
+}
+
+Http2Session::Stream::Stream() = default;
+Http2Session::Stream::Stream(Stream &&other) noexcept = default;
+Http2Session::Stream &Http2Session::Stream::operator=(Stream &&other) noexcept = default;
+Http2Session::Stream::~Stream() = default;
+
+Http2Session::Http2Session(QIODevice *socket, const QHostAddress &clientAddress, RequestDispatcher requestDispatcher, QObject *parent)
+    : QObject(parent)
+    , m_socket(socket)
+    , m_clientAddress(clientAddress)
+    , m_requestDispatcher(std::move(requestDispatcher))
+    , m_decoder(MAX_HEADER_LIST_SIZE)
+{
+    connect(m_socket, &QIODevice::bytesWritten, this, [this]
+    {
+        sendPendingData();
+
+        // the producers are resumed once the data of their streams is sent
+        QList<quint32> producingStreamIDs;
+        for (const auto &[streamID, stream] : m_streams)
+        {
+            if (stream.contentProducer)
+                producingStreamIDs.append(streamID);
+        }
+        for (const quint32 streamID : producingStreamIDs)
+            writeProducedContent(streamID);
+    });
+
+    // [rfc9113] 3.4. HTTP/2 Connection Preface
+    QByteArray settings;
+    appendSetting(settings, SettingID::EnablePush, 0);
+    appendSetting(settings, SettingID::MaxConcurrentStreams, MAX_CONCURRENT_STREAMS);
+    appendSetting(settings, SettingID::InitialWindowSize, RECEIVE_WINDOW_SIZE);
+    appendSetting(settings, SettingID::MaxHeaderListSize, MAX_HEADER_LIST_SIZE);
+    writeFrame(FrameType::Settings, 0, 0, settings);
+    // the window of the connection isn't changed by the settings
+    writeWindowUpdate(0, (RECEIVE_WINDOW_SIZE - DEFAULT_WINDOW_SIZE));
+}
+
+Http2Session::~Http2Session()
+{
+    for (auto &[streamID, stream] : m_streams)
+        releaseStreamObjects(stream);
+}
+
+bool Http2Session::isIdle() const
+{
+    return m_streams.empty();
+}
+
+void Http2Session::processData(const QByteArrayView data)
+{
+    if (m_isClosed)
+        return;
+
+    m_receivedData.append(data);
+
+    qsizetype position = 0;
+    if (!m_isPrefaceReceived)
+    {
+        if (m_receivedData.size() < CONNECTION_PREFACE.size())
+            return;
+
+        if (!m_receivedData.startsWith(CONNECTION_PREFACE))
+        {
+            closeWithError(ErrorCode::ProtocolError);
+            return;
+        }
+
+        m_isPrefaceReceived = true;
+        position = CONNECTION_PREFACE.size();
+    }
+
+    // [rfc9113] 4.1. Frame Format
+    while (!m_isClosed && ((m_receivedData.size() - position) >= FRAME_HEADER_SIZE))
+    {
+        const QByteArrayView header = QByteArrayView(m_receivedData).sliced(position, FRAME_HEADER_SIZE);
+        const qsizetype length = (static_cast<uchar>(header[0]) << 16) | (static_cast<uchar>(header[1]) << 8)
+            | static_cast<uchar>(header[2]);
+        if (length > DEFAULT_MAX_FRAME_SIZE)
+        {
+            closeWithError(ErrorCode::FrameSizeError);
+            return;
+        }
+
+        if ((m_receivedData.size() - position - FRAME_HEADER_SIZE) < length)
+            break;
+
+        const Frame frame
+        {
+            .type = static_cast<FrameType>(static_cast<quint8>(header[3])),
+            .flags = static_cast<quint8>(header[4]),
+            .streamID = (readUInt32(header.sliced(5)) & 0x7FFF'FFFF),
+            .payload = QByteArrayView(m_receivedData).sliced((position + FRAME_HEADER_SIZE), length)
+        };
+        processFrame(frame);
+
+        position += FRAME_HEADER_SIZE + length;
+    }
+
+    if (m_isClosed)
+        return;
+
+    m_receivedData.remove(0, position);
+    sendPendingData();
+}
+
+void Http2Session::processFrame(const Frame &frame)
+{
+    // [rfc9113] 3.4. the client preface ends with SETTINGS frame
+    if (!m_isSettingsReceived && (frame.type != FrameType::Settings))
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    // [rfc9113] 6.10. no other frame may come until the header block is complete
+    if (m_isHeaderBlockContinued && ((frame.type != FrameType::Continuation) || (frame.streamID != m_headerBlockStreamID)))
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    switch (frame.type)
+    {
+    case FrameType::Data:
+        processDataFrame(frame);
+        break;
+    case FrameType::Headers:
+        processHeadersFrame(frame);
+        break;
+    case FrameType::Priority:
+        // the streams are scheduled in turns regardless of their priorities ([rfc9113] 5.3.2.)
+        if (frame.streamID == 0)
+            closeWithError(ErrorCode::ProtocolError);
+        break;
+    case FrameType::ResetStream:
+        processResetStreamFrame(frame);
+        break;
+    case FrameType::Settings:
+        processSettingsFrame(frame);
+        break;
+    case FrameType::PushPromise:
+        // only the server may push ([rfc9113] 8.4.)
+        closeWithError(ErrorCode::ProtocolError);
+        break;
+    case FrameType::Ping:
+        processPingFrame(frame);
+        break;
+    case FrameType::GoAway:
+        processGoAwayFrame(frame);
+        break;
+    case FrameType::WindowUpdate:
+        processWindowUpdateFrame(frame);
+        break;
+    case FrameType::Continuation:
+        processContinuationFrame(frame);
+        break;
+    default:
+        // unknown frames are ignored ([rfc9113] 4.1.)
+        break;
+    }
+}
+
+void Http2Session::processDataFrame(const Frame &frame)
+{
+    if (frame.streamID == 0)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    const std::optional<QByteArrayView> data = removePadding(frame.payload, frame.flags);
+    if (!data)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    // the whole payload counts toward the flow-control window ([rfc9113] 6.9.1.),
+    // data is consumed as soon as it is received
+    if (!frame.payload.isEmpty())
+        writeWindowUpdate(0, frame.payload.size());
+
+    const auto streamIter = m_streams.find(frame.streamID);
+    if (streamIter == m_streams.end())
+    {
+        // frames of the streams which are already closed may still be in flight
+        if (frame.streamID > m_lastStreamID)
+            closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    Stream &stream = streamIter->second;
+    if (stream.isRequestReceived)
+    {
+        resetStream(frame.streamID, ErrorCode::StreamClosed);
+        return;
+    }
+
+    // the rest of the rejected request is ignored until its stream is closed
+    if (stream.isResponseStarted)
+        return;
+
+    if ((stream.body.size() + data->size()) > RequestParser::MAX_CONTENT_SIZE)
+    {
+        qWarning("%s", qUtf8Printable(tr("Http request size exceeds limitation, resetting stream. Limit: %1, IP: %2")
+            .arg(QString::number(RequestParser::MAX_CONTENT_SIZE), m_clientAddress.toString())));
+
+        discardBody(stream);
+        processResponse(frame.streamID, Response(413, u"Payload Too Large"_s));
+        return;
+    }
+
+    if ((m_bufferedBodySize + data->size()) > MAX_BUFFERED_BODY_SIZE)
+    {
+        qWarning("%s", qUtf8Printable(tr("Size of Http requests received at once exceeds limitation, resetting stream. Limit: %1, IP: %2")
+            .arg(QString::number(MAX_BUFFERED_BODY_SIZE), m_clientAddress.toString())));
+
+        discardBody(stream);
+        processResponse(frame.streamID, Response(413, u"Payload Too Large"_s));
+        return;
+    }
+
+    stream.body.append(*data);
+    m_bufferedBodySize += data->size();
+
+    if (frame.flags & FrameFlag::EndStream)
+    {
+        finishRequest(frame.streamID);
+        return;
+    }
+
+    if (!frame.payload.isEmpty())
+        writeWindowUpdate(frame.streamID, frame.payload.size());
+}
+
+void Http2Session::processHeadersFrame(const Frame &frame)
+{
+    if (frame.streamID == 0)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    // [rfc9113] 6.2. HEADERS
+    std::optional<QByteArrayView> fragment = removePadding(frame.payload, frame.flags);
+    if (!fragment)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    if (frame.flags & FrameFlag::Priority)
+    {
+        // the priorities are ignored
+        if (fragment->size() < 5)
+        {
+            closeWithError(ErrorCode::FrameSizeError);
+            return;
+        }
+
+        fragment = fragment->sliced(5);
+    }
+
+    m_headerBlockStreamID = frame.streamID;
+    m_headerBlock = fragment->toByteArray();
+    m_isHeaderBlockEndingStream = (frame.flags & FrameFlag::EndStream);
+    m_isHeaderBlockContinued = !(frame.flags & FrameFlag::EndHeaders);
+
+    if (!m_isHeaderBlockContinued)
+        processHeaderBlock();
+}
+
+void Http2Session::processContinuationFrame(const Frame &frame)
+{
+    // [rfc9113] 6.10. CONTINUATION
+    if (!m_isHeaderBlockContinued)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    if ((m_headerBlock.size() + frame.payload.size()) > MAX_HEADER_LIST_SIZE)
+    {
+        closeWithError(ErrorCode::EnhanceYourCalm);
+        return;
+    }
+
+    m_headerBlock.append(frame.payload);
+
+    if (frame.flags & FrameFlag::EndHeaders)
+    {
+        m_isHeaderBlockContinued = false;
+        processHeaderBlock();
+    }
+}
+
+void Http2Session::processResetStreamFrame(const Frame &frame)
+{
+    // [rfc9113] 6.4. RST_STREAM
+    if (frame.streamID == 0)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    if (frame.payload.size() != 4)
+    {
+        closeWithError(ErrorCode::FrameSizeError);
+        return;
+    }
+
+    if (frame.streamID > m_lastStreamID)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    closeStream(frame.streamID);
+}
+
+void Http2Session::processSettingsFrame(const Frame &frame)
+{
+    // [rfc9113] 6.5. SETTINGS
+    if (frame.streamID != 0)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    if (frame.flags & FrameFlag::Ack)
+    {
+        if (!frame.payload.isEmpty())
+            closeWithError(ErrorCode::FrameSizeError);
+        return;
+    }
+
+    if ((frame.payload.size() % 6) != 0)
+    {
+        closeWithError(ErrorCode::FrameSizeError);
+        return;
+    }
+
+    for (qsizetype i = 0; i < frame.payload.size(); i += 6)
+    {
+        const auto id = static_cast<SettingID>(qFromBigEndian<quint16>(frame.payload.data() + i));
+        const quint32 value = readUInt32(frame.payload.sliced(i + 2));
+
+        switch (id)
+        {
+        case SettingID::HeaderTableSize:
+            m_encoder.setMaxTableSize(value);
+            break;
+        case SettingID::EnablePush:
+            if (value > 1)
+            {
+                closeWithError(ErrorCode::ProtocolError);
+                return;
+            }
+            break;
+        case SettingID::InitialWindowSize:
+            if (value > MAX_WINDOW_SIZE)
+            {
+                closeWithError(ErrorCode::FlowControlError);
+                return;
+            }
+            // the windows of the open streams are adjusted by the difference ([rfc9113] 6.9.2.)
+            for (auto &[streamID, stream] : m_streams)
+                stream.sendWindowSize += (value - m_initialWindowSize);
+            m_initialWindowSize = value;
+            break;
+        case SettingID::MaxFrameSize:
+            if ((value < DEFAULT_MAX_FRAME_SIZE) || (value > MAX_ALLOWED_FRAME_SIZE))
+            {
+                closeWithError(ErrorCode::ProtocolError);
+                return;
+            }
+            m_maxFrameSize = value;
+            break;
+        default:
+            // unknown settings are ignored, the server doesn't use the other ones
+            break;
+        }
+    }
+
+    m_isSettingsReceived = true;
+    writeFrame(FrameType::Settings, FrameFlag::Ack, 0);
+}
+
+void Http2Session::processPingFrame(const Frame &frame)
+{
+    // [rfc9113] 6.7. PING
+    if (frame.streamID != 0)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    if (frame.payload.size() != 8)
+    {
+        closeWithError(ErrorCode::FrameSizeError);
+        return;
+    }
+
+    if (!(frame.flags & FrameFlag::Ack))
+        writeFrame(FrameType::Ping, FrameFlag::Ack, 0, frame.payload);
+}
+
+void Http2Session::processGoAwayFrame(const Frame &frame)
+{
+    // [rfc9113] 6.8. GOAWAY
+    if (frame.streamID != 0)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    // the streams which are already open are still served
+    m_isGoAwayReceived = true;
+    if (m_streams.empty())
+        m_socket->close();
+}
+
+void Http2Session::processWindowUpdateFrame(const Frame &frame)
+{
+    // [rfc9113] 6.9. WINDOW_UPDATE
+    if (frame.payload.size() != 4)
+    {
+        closeWithError(ErrorCode::FrameSizeError);
+        return;
+    }
+
+    const quint32 increment = readUInt32(frame.payload) & 0x7FFF'FFFF;
+
+    if (frame.streamID == 0)
+    {
+        if (increment == 0)
+        {
+            closeWithError(ErrorCode::ProtocolError);
+            return;
+        }
+
+        m_sendWindowSize += increment;
+        if (m_sendWindowSize > MAX_WINDOW_SIZE)
+            closeWithError(ErrorCode::FlowControlError);
+        return;
+    }
+
+    // the stream may be closed already
+    const auto streamIter = m_streams.find(frame.streamID);
+    if (streamIter == m_streams.end())
+        return;
+
+    if (increment == 0)
+    {
+        resetStream(frame.streamID, ErrorCode::ProtocolError);
+        return;
+    }
+
+    Stream &stream = streamIter->second;
+    stream.sendWindowSize += increment;
+    if (stream.sendWindowSize > MAX_WINDOW_SIZE)
+        resetStream(frame.streamID, ErrorCode::FlowControlError);
+}
+
+void Http2Session::processHeaderBlock()
+{
+    const quint32 streamID = m_headerBlockStreamID;
+
+    // the block is decoded even if the stream is refused since it may change the table
+    const std::optional<HPack::HeaderList> fields = m_decoder.decode(std::exchange(m_headerBlock, {}));
+    if (!fields)
+    {
+        closeWithError(ErrorCode::CompressionError);
+        return;
+    }
+
+    if (const auto streamIter = m_streams.find(streamID); streamIter != m_streams.end())
+    {
+        // trailer fields end the request, they aren't used
+        if (streamIter->second.isRequestReceived)
+            resetStream(streamID, ErrorCode::StreamClosed);
+        else if (!m_isHeaderBlockEndingStream)
+            resetStream(streamID, ErrorCode::ProtocolError);
+        else if (!streamIter->second.isResponseStarted)
+            finishRequest(streamID);
+        return;
+    }
+
+    // [rfc9113] 5.1.1. Stream Identifiers
+    if ((streamID % 2) == 0)
+    {
+        closeWithError(ErrorCode::ProtocolError);
+        return;
+    }
+
+    // frames of the streams which are already closed may still be in flight
+    if (streamID <= m_lastStreamID)
+        return;
+
+    m_lastStreamID = streamID;
+
+    // [rfc9113] 5.1.2. Stream Concurrency
+    if (m_streams.size() >= MAX_CONCURRENT_STREAMS)
+    {
+        resetStream(streamID, ErrorCode::RefusedStream);
+        return;
+    }
+
+    std::optional<RequestHead> head = parseRequestHead(*fields);
+    if (!head)
+    {
+        qWarning("%s", qUtf8Printable(tr("Bad Http request, resetting stream. IP: %1")
+            .arg(m_clientAddress.toString())));
+
+        // [rfc9113] 8.1.1. Malformed Messages
+        resetStream(streamID, ErrorCode::ProtocolError);
+        return;
+    }
+
+    Stream stream;
+    stream.method = std::move(head->method);
+    stream.target = std::move(head->target);
+    stream.headers = std::move(head->headers);
+    stream.isHeadRequest = (stream.method == HEADER_REQUEST_METHOD_HEAD);
+    stream.sendWindowSize = m_initialWindowSize;
+    m_streams.emplace(streamID, std::move(stream));
+
+    if (m_isHeaderBlockEndingStream)
+        finishRequest(streamID);
+}
+
+void Http2Session::finishRequest(const quint32 streamID)
+{
+    Stream &stream = m_streams.at(streamID);
+    stream.isRequestReceived = true;
+
+    RequestParser::ParseResult result = m_requestParser.parse(stream.method, stream.target, stream.headers, stream.body);
+    discardBody(stream);
+
+    switch (result.status)
+    {
+    case RequestParser::ParseStatus::OK:
+        {
+            Request &request = result.request;
+            request.version = u"2"_s;
+            if (request.method == HEADER_REQUEST_METHOD_HEAD)
+                request.method = HEADER_REQUEST_METHOD_GET;
+
+            m_requestDispatcher(streamID, request);
+        }
+        break;
+
+    case RequestParser::ParseStatus::BadMethod:
+        qWarning("%s", qUtf8Printable(tr("Bad Http request method, resetting stream. IP: %1. Method: \"%2\"")
+            .arg(m_clientAddress.toString(), result.request.method)));
+        processResponse(streamID, Response(501, u"Not Implemented"_s));
+        break;
+
+    case RequestParser::ParseStatus::BadRequest:
+        qWarning("%s", qUtf8Printable(tr("Bad Http request, resetting stream. IP: %1")
+            .arg(m_clientAddress.toString())));
+        processResponse(streamID, Response(400, u"Bad Request"_s));
+        break;
+
+    default:
+        Q_UNREACHABLE();
+        break;
+    }
+}
+
+void Http2Session::processResponse(const quint32 streamID, Response response)
+{
+    // the stream may be reset by the client meanwhile
+    const auto streamIter = m_streams.find(streamID);
+    if (m_isClosed || (streamIter == m_streams.end()))
+    {
+        releaseObject(response.eventStream, this);
+        releaseObject(response.contentProducer, this);
+        releaseObject(response.deferredResponse, this);
+        return;
+    }
+
+    if (response.deferredResponse)
+    {
+        waitForDeferredResponse(streamID, std::move(response));
+        return;
+    }
+
+    Stream &stream = streamIter->second;
+    Q_ASSERT(!stream.isResponseStarted);
+
+    if (stream.isHeadRequest)
+    {
+        if (response.eventStream)
+            std::exchange(response.eventStream, nullptr)->deleteLater();
+        if (response.contentProducer)
+            std::exchange(response.contentProducer, nullptr)->deleteLater();
+
+        response.headers[HEADER_CONTENT_LENGTH] = QString::number(response.content.length());
+
+        sendHeaders(streamID, response, true);
+    }
+    else if (response.eventStream)
+    {
+        // the stream lasts until the event stream is closed
+        sendHeaders(streamID, response, false);
+        startEventStream(streamID, response.eventStream);
+    }
+    else if (response.contentProducer)
+    {
+        const ContentCoding coding = negotiateContentCoding(stream.headers.value(HEADER_ACCEPT_ENCODING));
+        // byte ranges refer to the content as it is, so it must not be encoded
+        if ((coding != ContentCoding::Identity) && !response.headers.contains(HEADER_ACCEPT_RANGES))
+        {
+            // the size of the produced content isn't known in advance
+            const int level = compressionLevel(coding, response.headers.value(HEADER_CONTENT_TYPE), -1);
+            stream.contentCompressor = std::make_unique<ContentCompressor>(coding, level);
+            response.headers[HEADER_CONTENT_ENCODING] = contentCodingName(coding);
+        }
+
+        sendHeaders(streamID, response, false);
+        startContentProduction(streamID, response.contentProducer);
+    }
+    else
+    {
+        // the content may be already encoded by the request handler
+        if (!response.headers.contains(HEADER_CONTENT_ENCODING))
+            compressContent(response, negotiateContentCoding(stream.headers.value(HEADER_ACCEPT_ENCODING)));
+        if (QString &value = response.headers[HEADER_CONTENT_LENGTH]; value.isEmpty())
+            value = QString::number(response.content.length());
+
+        const bool hasContent = !response.content.isEmpty();
+        sendHeaders(streamID, response, !hasContent);
+        if (hasContent)
+            queueData(streamID, response.content, true);
+    }
+
+    sendPendingData();
+}
+
+void Http2Session::sendHeaders(const quint32 streamID, const Response &response, const bool endStream)
+{
+    Stream &stream = m_streams.at(streamID);
+    stream.isResponseStarted = true;
+
+    // [rfc9113] 8.3.2. Response Pseudo-Header Fields
+    HPack::HeaderList fields;
+    fields.reserve(response.headers.size() + 2);
+    fields.append({":status"_ba, QByteArray::number(response.status.code)});
+    fields.append({HEADER_DATE.toLatin1(), httpDate().toLatin1()});
+    for (auto iter = response.headers.cbegin(); iter != response.headers.cend(); ++iter)
+    {
+        const QByteArray name = iter.key().toLatin1().toLower();
+        if ((name == HEADER_DATE.toLatin1()) || isConnectionSpecificHeader(name))
+            continue;
+
+        fields.append({name, iter.value().toLatin1()});
+    }
+
+    // [rfc9113] 6.10. the block which doesn't fit in the frame is continued in CONTINUATION frames
+    const QByteArray block = m_encoder.encode(fields);
+    QByteArrayView remaining = block;
+    FrameType type = FrameType::Headers;
+    quint8 flags = (endStream ? FrameFlag::EndStream : 0);
+    do
+    {
+        const QByteArrayView fragment = remaining.first(std::min(remaining.size(), m_maxFrameSize));
+        remaining = remaining.sliced(fragment.size());
+        if (remaining.isEmpty())
+            flags |= FrameFlag::EndHeaders;
+
+        writeFrame(type, flags, streamID, fragment);
+
+        type = FrameType::Continuation;
+        flags = 0;
+    } while (!remaining.isEmpty());
+
+    if (endStream)
+        finishResponse(streamID);
+}
+
+void Http2Session::queueData(const quint32 streamID, const QByteArray &data, const bool endStream)
+{
+    Stream &stream = m_streams.at(streamID);
+    stream.pendingData.append(data);
+    stream.isResponseFinished = endStream;
+}
+
+void Http2Session::sendPendingData()
+{
+    if (m_isClosed)
+        return;
+
+    // the streams are sent in turns, a frame at a time
+    bool isSending = true;
+    while (isSending && (m_socket->bytesToWrite() < SOCKET_WRITE_THRESHOLD))
+    {
+        isSending = false;
+
+        for (auto streamIter = m_streams.begin(); streamIter != m_streams.end();)
+        {
+            const quint32 streamID = streamIter->first;
+            Stream &stream = streamIter->second;
+            // the stream may be closed once its data is sent
+            ++streamIter;
+
+            // [rfc9113] 6.9. Flow Control
+            const qsizetype size = std::max<qint64>(0, std::min<qint64>({stream.pendingData.size()
+                , m_maxFrameSize, stream.sendWindowSize, m_sendWindowSize}));
+            const bool isLastFrame = stream.isResponseFinished && (size == stream.pendingData.size());
+            if ((size == 0) && !isLastFrame)
+                continue;
+
+            writeFrame(FrameType::Data, (isLastFrame ? FrameFlag::EndStream : 0), streamID
+                , QByteArrayView(stream.pendingData).first(size));
+            stream.pendingData.remove(0, size);
+            stream.sendWindowSize -= size;
+            m_sendWindowSize -= size;
+            isSending = true;
+
+            if (isLastFrame)
+                finishResponse(streamID);
+        }
+    }
+}
+
+void Http2Session::finishResponse(const quint32 streamID)
+{
+    // the client is asked to stop sending the request which isn't needed anymore ([rfc9113] 8.1.)
+    if (!m_streams.at(streamID).isRequestReceived)
+        resetStream(streamID, ErrorCode::NoError);
+    else
+        closeStream(streamID);
+}
+
+void Http2Session::waitForDeferredResponse(const quint32 streamID, Response response)
+{
+    Stream &stream = m_streams.at(streamID);
+    Q_ASSERT(!stream.deferredResponse);
+
+    DeferredResponse *deferredResponse = response.deferredResponse;
+    if (deferredResponse->thread() == thread())
+        deferredResponse->setParent(this);
+
+    stream.deferredResponse = std::move(response);
+
+    const auto processResolvedResponse = [this, streamID]
+    {
+        // signal of already processed response may be queued
+        const auto streamIter = m_streams.find(streamID);
+        if (streamIter == m_streams.end())
+            return;
+
+        std::optional<Response> &pendingResponse = streamIter->second.deferredResponse;
+        if (!pendingResponse || !pendingResponse->deferredResponse->isResolved())
+            return;
+
+        Response keptResponse = *std::exchange(pendingResponse, std::nullopt);
+        DeferredResponse *resolvedDeferredResponse = std::exchange(keptResponse.deferredResponse, nullptr);
+        const Response resolvedResponse = resolvedDeferredResponse->takeResponse();
+        releaseObject(resolvedDeferredResponse, this);
+
+        keptResponse.status = resolvedResponse.status;
+        for (auto iter = resolvedResponse.headers.cbegin(); iter != resolvedResponse.headers.cend(); ++iter)
+            keptResponse.headers[iter.key()] = iter.value();
+        keptResponse.content = resolvedResponse.content;
+
+        processResponse(streamID, std::move(keptResponse));
+    };
+
+    connect(deferredResponse, &DeferredResponse::resolved, this, processResolvedResponse);
+    // it could be resolved before the session is subscribed to it
+    processResolvedResponse();
+}
+
+void Http2Session::startEventStream(const quint32 streamID, EventStream *eventStream)
+{
+    Stream &stream = m_streams.at(streamID);
+    Q_ASSERT(!stream.eventStream);
+
+    stream.eventStream = eventStream;
+    if (eventStream->thread() == thread())
+        eventStream->setParent(this);
+
+    connect(eventStream, &EventStream::readyRead, this, [this, streamID] { writeEventStreamData(streamID); });
+    connect(eventStream, &EventStream::closed, this, [this, streamID] { writeEventStreamData(streamID); });
+    writeEventStreamData(streamID);
+}
+
+void Http2Session::writeEventStreamData(const quint32 streamID)
+{
+    // signal of the closed stream may be queued
+    const auto streamIter = m_streams.find(streamID);
+    if ((streamIter == m_streams.end()) || !streamIter->second.eventStream)
+        return;
+
+    Stream &stream = streamIter->second;
+    // the data sent before the event stream is closed is taken along
+    const bool isClosed = stream.eventStream->isClosed();
+    queueData(streamID, stream.eventStream->takeData(), isClosed);
+    if (isClosed)
+        releaseObject(std::exchange(stream.eventStream, nullptr), this);
+
+    sendPendingData();
+}
+
+void Http2Session::startContentProduction(const quint32 streamID, ContentProducer *contentProducer)
+{
+    Stream &stream = m_streams.at(streamID);
+    Q_ASSERT(!stream.contentProducer);
+
+    stream.contentProducer = contentProducer;
+    if (contentProducer->thread() == thread())
+        contentProducer->setParent(this);
+
+    connect(contentProducer, &ContentProducer::readyRead, this, [this, streamID] { writeProducedContent(streamID); });
+    writeProducedContent(streamID);
+}
+
+void Http2Session::writeProducedContent(const quint32 streamID)
+{
+    // signal of finished producer may be queued
+    const auto streamIter = m_streams.find(streamID);
+    if ((streamIter == m_streams.end()) || !streamIter->second.contentProducer)
+        return;
+
+    Stream &stream = streamIter->second;
+    // keep the pending data short, so the content is produced only as fast as it is sent
+    if (stream.pendingData.size() > PRODUCED_CONTENT_WRITE_THRESHOLD)
+        return;
+
+    const bool isFinished = stream.contentProducer->isFinished();
+    QByteArray data = stream.contentProducer->takeData();
+    if (stream.contentCompressor)
+        data = stream.contentCompressor->compress(data, isFinished);
+
+    queueData(streamID, data, isFinished);
+    if (isFinished)
+    {
+        releaseObject(std::exchange(stream.contentProducer, nullptr), this);
+        stream.contentCompressor.reset();
+    }
+
+    sendPendingData();
+}
+
+void Http2Session::writeFrame(const FrameType type, const quint8 flags, const quint32 streamID, const QByteArrayView payload)
+{
+    // [rfc9113] 4.1. Frame Format
+    const auto length = static_cast<quint32>(payload.size());
+
+    QByteArray frame;
+    frame.reserve(FRAME_HEADER_SIZE + payload.size());
+    frame.append(static_cast<char>(length >> 16))
+        .append(static_cast<char>(length >> 8))
+        .append(static_cast<char>(length))
+        .append(static_cast<char>(type))
+        .append(static_cast<char>(flags));
+    appendUInt32(frame, streamID);
+    frame.append(payload);
+
+    m_socket->write(frame);
+}
+
+void Http2Session::writeWindowUpdate(const quint32 streamID, const quint32 increment)
+{
+    QByteArray payload;
+    appendUInt32(payload, increment);
+    writeFrame(FrameType::WindowUpdate, 0, streamID, payload);
+}
+
+void Http2Session::resetStream(const quint32 streamID, const ErrorCode errorCode)
+{
+    QByteArray payload;
+    appendUInt32(payload, static_cast<quint32>(errorCode));
+    writeFrame(FrameType::ResetStream, 0, streamID, payload);
+
+    closeStream(streamID);
+}
+
+void Http2Session::closeStream(const quint32 streamID)
+{
+    const auto streamIter = m_streams.find(streamID);
+    if (streamIter == m_streams.end())
+        return;
+
+    discardBody(streamIter->second);
+    releaseStreamObjects(streamIter->second);
+    m_streams.erase(streamIter);
+
+    // the client which has gone away waits only for the streams which are already open
+    if (m_isGoAwayReceived && m_streams.empty())
+        m_socket->close();
+}
+
+void Http2Session::discardBody(Stream &stream)
+{
+    m_bufferedBodySize -= stream.body.size();
+    stream.body.clear();
+}
+
+void Http2Session::releaseStreamObjects(Stream &stream)
+{
+    releaseObject(std::exchange(stream.eventStream, nullptr), this);
+    releaseObject(std::exchange(stream.contentProducer, nullptr), this);
+    if (stream.deferredResponse)
+        releaseObject(std::exchange(stream.deferredResponse, std::nullopt)->deferredResponse, this);
+}
+
+void Http2Session::closeWithError(const ErrorCode errorCode)
+{
+    // [rfc9113] 5.4.1. Connection Error Handling
+    QByteArray payload;
+    appendUInt32(payload, m_lastStreamID);
+    appendUInt32(payload, static_cast<quint32>(errorCode));
+    writeFrame(FrameType::GoAway, 0, 0, payload);
+
+    m_isClosed = true;
+    m_socket->close();
+}
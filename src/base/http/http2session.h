@@ -0,0 +1,169 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <optional>
+
+#include <QByteArray>
+#include <QHostAddress>
+#include <QObject>
+
+#include "hpack.h"
+#include "requestparser.h"
+#include "types.h"
+
+class QIODevice;
+
+namespace Http
+{
+    class ContentCompressor;
+
+    // [rfc9113] HTTP/2
+    // Serves the requests multiplexed on the connection once the client has sent the connection preface.
+    // The requests are processed concurrently, each one in its own stream.
+    class Http2Session final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(Http2Session)
+
+    public:
+        // Passes the request to the request handler and the response back to processResponse()
+        using RequestDispatcher = std::function<void (quint32 streamID, const Request &request)>;
+
+        inline static const QByteArray CONNECTION_PREFACE = QByteArrayLiteral("PRI * HTTP/2.0\r\n\r\nSM\r\n\r\n");
+
+        Http2Session(QIODevice *socket, const QHostAddress &clientAddress, RequestDispatcher requestDispatcher, QObject *parent = nullptr);
+        ~Http2Session() override;
+
+        // Whether no stream is open
+        bool isIdle() const;
+
+        // `data` is the data received from the client starting with the connection preface
+        void processData(QByteArrayView data);
+        void processResponse(quint32 streamID, Response response);
+
+    private:
+        enum class ErrorCode : quint32;
+        enum class FrameType : quint8;
+
+        struct Frame
+        {
+            FrameType type;
+            quint8 flags = 0;
+            quint32 streamID = 0;
+            QByteArrayView payload;
+        };
+
+        struct Stream
+        {
+            Stream();
+            Stream(Stream &&other) noexcept;
+            Stream &operator=(Stream &&other) noexcept;
+            ~Stream();
+
+            QString method;
+            QByteArray target;
+            HeaderMap headers;
+            QByteArray body;
+            bool isRequestReceived = false;
+            bool isHeadRequest = false;
+
+            qint64 sendWindowSize = 0;
+            QByteArray pendingData;  // waiting for the flow-control window
+            bool isResponseStarted = false;
+            bool isResponseFinished = false;  // the end of the stream is sent once the pending data is sent
+            EventStream *eventStream = nullptr;
+            ContentProducer *contentProducer = nullptr;
+            std::unique_ptr<ContentCompressor> contentCompressor;
+            std::optional<Response> deferredResponse;
+        };
+
+        void processFrame(const Frame &frame);
+        void processDataFrame(const Frame &frame);
+        void processHeadersFrame(const Frame &frame);
+        void processContinuationFrame(const Frame &frame);
+        void processResetStreamFrame(const Frame &frame);
+        void processSettingsFrame(const Frame &frame);
+        void processPingFrame(const Frame &frame);
+        void processGoAwayFrame(const Frame &frame);
+        void processWindowUpdateFrame(const Frame &frame);
+        void processHeaderBlock();
+        void finishRequest(quint32 streamID);
+
+        void sendHeaders(quint32 streamID, const Response &response, bool endStream);
+        void queueData(quint32 streamID, const QByteArray &data, bool endStream);
+        void sendPendingData();
+        void finishResponse(quint32 streamID);
+        void waitForDeferredResponse(quint32 streamID, Response response);
+        void startEventStream(quint32 streamID, EventStream *eventStream);
+        void writeEventStreamData(quint32 streamID);
+        void startContentProduction(quint32 streamID, ContentProducer *contentProducer);
+        void writeProducedContent(quint32 streamID);
+
+        void writeFrame(FrameType type, quint8 flags, quint32 streamID, QByteArrayView payload = {});
+        void writeWindowUpdate(quint32 streamID, quint32 increment);
+        void resetStream(quint32 streamID, ErrorCode errorCode);
+        void closeStream(quint32 streamID);
+        void discardBody(Stream &stream);
+        void releaseStreamObjects(Stream &stream);
+        void closeWithError(ErrorCode errorCode);
+
+        QIODevice *m_socket = nullptr;
+        QHostAddress m_clientAddress;
+        RequestDispatcher m_requestDispatcher;
+        RequestParser m_requestParser;
+        HPack::Decoder m_decoder;
+        HPack::Encoder m_encoder;
+        QByteArray m_receivedData;
+        bool m_isPrefaceReceived = false;
+        bool m_isSettingsReceived = false;
+        bool m_isGoAwayReceived = false;
+        bool m_isClosed = false;
+
+        std::map<quint32, Stream> m_streams;
+        quint32 m_lastStreamID = 0;
+        // request bodies of the streams which are still being received
+        qint64 m_bufferedBodySize = 0;
+
+        // header block which is continued in the following frames
+        quint32 m_headerBlockStreamID = 0;
+        QByteArray m_headerBlock;
+        bool m_isHeaderBlockEndingStream = false;
+        bool m_isHeaderBlockContinued = false;
+
+        // flow control and the frame size of the data sent to the client, the initial values are used
+        // until the client changes them ([rfc9113] 6.5.2.)
+        qint64 m_sendWindowSize = 65'535;
+        qint64 m_initialWindowSize = 65'535;
+        qsizetype m_maxFrameSize = 16'384;
+    };
+}
@@ -82,6 +82,16 @@ UnsupportedMediaTypeHTTPError::UnsupportedMediaTypeHTTPError(const QString &mess
 {
 }
 
+RangeNotSatisfiableHTTPError::RangeNotSatisfiableHTTPError(const QString &message)
+    : HTTPError(416, u"Range Not Satisfiable"_s, message)
+{
+}
+
+TooManyRequestsHTTPError::TooManyRequestsHTTPError(const QString &message)
+    : HTTPError(429, u"Too Many Requests"_s, message)
+{
+}
+
 InternalServerErrorHTTPError::InternalServerErrorHTTPError(const QString &message)
     : HTTPError(500, u"Internal Server Error"_s, message)
 {
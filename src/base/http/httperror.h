@@ -85,6 +85,18 @@ public:
     explicit UnsupportedMediaTypeHTTPError(const QString &message = {});
 };
 
+class RangeNotSatisfiableHTTPError : public HTTPError
+{
+public:
+    explicit RangeNotSatisfiableHTTPError(const QString &message = {});
+};
+
+class TooManyRequestsHTTPError : public HTTPError
+{
+public:
+    explicit TooManyRequestsHTTPError(const QString &message = {});
+};
+
 class InternalServerErrorHTTPError : public HTTPError
 {
 public:
@@ -86,19 +86,56 @@ namespace
     }
 }
 
-RequestParser::ParseResult RequestParser::parse(const QByteArray &data)
+RequestParser::ParseResult RequestParser::parse(const QByteArrayView data)
 {
     // Warning! Header names are converted to lowercase
-    return RequestParser().doParse(data);
+    return (m_state == State::Headers) ? parseHeaders(data) : parseBody(data);
 }
 
-RequestParser::ParseResult RequestParser::doParse(const QByteArrayView data)
+RequestParser::ParseResult RequestParser::parse(const QString &method, const QByteArrayView target
+    , const HeaderMap &headers, const QByteArrayView body)
+{
+    m_request.method = method;
+    m_request.headers = headers;
+    parseRequestTarget(target);
+
+    if ((method == HEADER_REQUEST_METHOD_GET) || (method == HEADER_REQUEST_METHOD_HEAD))
+        return finish(ParseStatus::OK, body.size());
+
+    if (method == HEADER_REQUEST_METHOD_POST)
+    {
+        if (body.size() > MAX_CONTENT_SIZE)
+        {
+            qWarning() << Q_FUNC_INFO << "bad request: message too long";
+            return finish(ParseStatus::BadRequest);
+        }
+
+        if (!body.isEmpty() && !parsePostMessage(body))
+        {
+            qWarning() << Q_FUNC_INFO << "message body parsing error";
+            return finish(ParseStatus::BadRequest);
+        }
+
+        return finish(ParseStatus::OK, body.size());
+    }
+
+    return finish(ParseStatus::BadMethod);
+}
+
+qsizetype RequestParser::expectedFrameSize() const
+{
+    return (m_state == State::Body) ? (m_headerLength + m_contentLength) : -1;
+}
+
+RequestParser::ParseResult RequestParser::parseHeaders(const QByteArrayView data)
 {
     // we don't handle malformed requests which use double `LF` as delimiter
-    const qsizetype headerEnd = data.indexOf(EOH);
+    // resume the search, the delimiter may be split between the reads
+    const qsizetype headerEnd = data.indexOf(EOH, std::max<qsizetype>(0, (m_scannedSize - (EOH.size() - 1))));
     if (headerEnd < 0)
     {
         qDebug() << Q_FUNC_INFO << "incomplete request";
+        m_scannedSize = data.size();
         return {ParseStatus::Incomplete, Request(), 0};
     }
 
@@ -106,14 +143,14 @@ RequestParser::ParseResult RequestParser::doParse(const QByteArrayView data)
     if (!parseStartLines(httpHeaders))
     {
         qWarning() << Q_FUNC_INFO << "header parsing error";
-        return {ParseStatus::BadRequest, Request(), 0};
+        return finish(ParseStatus::BadRequest);
     }
 
-    const qsizetype headerLength = headerEnd + EOH.length();
+    m_headerLength = headerEnd + EOH.length();
 
     // handle supported methods
     if ((m_request.method == HEADER_REQUEST_METHOD_GET) || (m_request.method == HEADER_REQUEST_METHOD_HEAD))
-        return {ParseStatus::OK, m_request, headerLength};
+        return finish(ParseStatus::OK, m_headerLength);
 
     if (m_request.method == HEADER_REQUEST_METHOD_POST)
     {
@@ -131,34 +168,51 @@ RequestParser::ParseResult RequestParser::doParse(const QByteArrayView data)
         if (contentLength < 0)
         {
             qWarning() << Q_FUNC_INFO << "bad request: content-length invalid";
-            return {ParseStatus::BadRequest, Request(), 0};
+            return finish(ParseStatus::BadRequest);
         }
         if (contentLength > MAX_CONTENT_SIZE)
         {
             qWarning() << Q_FUNC_INFO << "bad request: message too long";
-            return {ParseStatus::BadRequest, Request(), 0};
+            return finish(ParseStatus::BadRequest);
         }
 
-        if (contentLength > 0)
-        {
-            const QByteArrayView httpBodyView = data.mid(headerLength, contentLength);
-            if (httpBodyView.length() < contentLength)
-            {
-                qDebug() << Q_FUNC_INFO << "incomplete request";
-                return {ParseStatus::Incomplete, Request(), 0};
-            }
+        // the body is parsed only once it is complete, so the headers aren't parsed again meanwhile
+        m_contentLength = contentLength;
+        m_state = State::Body;
+        return parseBody(data);
+    }
 
-            if (!parsePostMessage(httpBodyView))
-            {
-                qWarning() << Q_FUNC_INFO << "message body parsing error";
-                return {ParseStatus::BadRequest, Request(), 0};
-            }
-        }
+    return finish(ParseStatus::BadMethod);
+}
 
-        return {ParseStatus::OK, m_request, (headerLength + contentLength)};
+RequestParser::ParseResult RequestParser::parseBody(const QByteArrayView data)
+{
+    const qsizetype frameSize = m_headerLength + m_contentLength;
+    if (data.size() < frameSize)
+    {
+        qDebug() << Q_FUNC_INFO << "incomplete request";
+        return {ParseStatus::Incomplete, Request(), 0};
     }
 
-    return {ParseStatus::BadMethod, m_request, 0};
+    if ((m_contentLength > 0) && !parsePostMessage(data.sliced(m_headerLength, m_contentLength)))
+    {
+        qWarning() << Q_FUNC_INFO << "message body parsing error";
+        return finish(ParseStatus::BadRequest);
+    }
+
+    return finish(ParseStatus::OK, frameSize);
+}
+
+RequestParser::ParseResult RequestParser::finish(const ParseStatus status, const qsizetype frameSize)
+{
+    ParseResult result {status, std::exchange(m_request, {}), frameSize};
+
+    m_state = State::Headers;
+    m_scannedSize = 0;
+    m_headerLength = 0;
+    m_contentLength = 0;
+
+    return result;
 }
 
 bool RequestParser::parseStartLines(const QByteArrayView data)
@@ -221,15 +275,33 @@ bool RequestParser::parseRequestLine(const QByteArrayView line)
     m_request.method = QString::fromLatin1(method);
 
     // Request Target
-    const QByteArrayView url = parts[1];
-    const qsizetype sepPos = url.indexOf('?');
-    const QByteArrayView pathComponent = ((sepPos == -1) ? url : url.first(sepPos));
+    parseRequestTarget(parts[1]);
+
+    // HTTP-version
+    const QByteArrayView version = parts[2];
+    const QByteArray prefix = "HTTP/"_ba;
+    if ((version.length() != 8) || !version.startsWith(prefix)
+        || !isDigit(version[5]) || (version[6] != '.') || !isDigit(version[7]))
+    {
+        qWarning() << Q_FUNC_INFO << "invalid http version:" << version;
+        return false;
+    }
+    m_request.version = QString::fromLatin1(version.sliced(prefix.length()));
+
+    return true;
+}
+
+void RequestParser::parseRequestTarget(const QByteArrayView target)
+{
+    // [rfc7230] 5.3. Request Target
+    const qsizetype sepPos = target.indexOf('?');
+    const QByteArrayView pathComponent = ((sepPos == -1) ? target : target.first(sepPos));
 
     m_request.path = QString::fromUtf8(QByteArray::fromPercentEncoding(asQByteArray(pathComponent)));
 
     if (sepPos >= 0)
     {
-        const QByteArrayView query = url.sliced(sepPos + 1);
+        const QByteArrayView query = target.sliced(sepPos + 1);
 
         // [rfc3986] 2.4 When to Encode or Decode
         // URL components should be separated before percent-decoding
@@ -248,19 +320,6 @@ bool RequestParser::parseRequestLine(const QByteArrayView line)
             m_request.query[paramName] = paramValue;
         }
     }
-
-    // HTTP-version
-    const QByteArrayView version = parts[2];
-    const QByteArray prefix = "HTTP/"_ba;
-    if ((version.length() != 8) || !version.startsWith(prefix)
-        || !isDigit(version[5]) || (version[6] != '.') || !isDigit(version[7]))
-    {
-        qWarning() << Q_FUNC_INFO << "invalid http version:" << version;
-        return false;
-    }
-    m_request.version = QString::fromLatin1(version.sliced(prefix.length()));
-
-    return true;
 }
 
 bool RequestParser::parsePostMessage(const QByteArrayView data)
@@ -53,20 +53,38 @@ namespace Http
             qsizetype frameSize = 0;  // http request frame size (bytes)
         };
 
-        static ParseResult parse(const QByteArray &data);
+        // The parser keeps its progress while the request is incomplete, so `data` must only be
+        // appended to until another status is returned. Then the parser is ready for the next request.
+        ParseResult parse(QByteArrayView data);
+        // Parses the request which parts are received separately (i.e. in HTTP/2 frames),
+        // the header names must be already in lowercase
+        ParseResult parse(const QString &method, QByteArrayView target, const HeaderMap &headers, QByteArrayView body);
+        // Size of the incomplete request frame once its headers are parsed, -1 otherwise
+        qsizetype expectedFrameSize() const;
 
         static const long MAX_CONTENT_SIZE = 64 * 1024 * 1024;  // 64 MB
 
     private:
-        RequestParser() = default;
+        enum class State
+        {
+            Headers,
+            Body
+        };
 
-        ParseResult doParse(QByteArrayView data);
+        ParseResult parseHeaders(QByteArrayView data);
+        ParseResult parseBody(QByteArrayView data);
+        ParseResult finish(ParseStatus status, qsizetype frameSize = 0);
         bool parseStartLines(QByteArrayView data);
         bool parseRequestLine(QByteArrayView line);
+        void parseRequestTarget(QByteArrayView target);
 
         bool parsePostMessage(QByteArrayView data);
         bool parseFormData(QByteArrayView data);
 
         Request m_request;
+        State m_state = State::Headers;
+        qsizetype m_scannedSize = 0;  // searched for the end of headers
+        qsizetype m_headerLength = 0;
+        qsizetype m_contentLength = 0;
     };
 }
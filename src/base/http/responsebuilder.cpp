@@ -50,6 +50,27 @@ void ResponseBuilder::print(const QByteArray &data, const QString &type)
     print_impl(data, type);
 }
 
+void ResponseBuilder::stream(EventStream *eventStream)
+{
+    m_response.headers[HEADER_CONTENT_TYPE] = CONTENT_TYPE_EVENT_STREAM;
+    m_response.headers[HEADER_CACHE_CONTROL] = u"no-cache"_s;
+    m_response.content.clear();
+    m_response.eventStream = eventStream;
+}
+
+void ResponseBuilder::stream(ContentProducer *contentProducer, const QString &type)
+{
+    m_response.headers[HEADER_CONTENT_TYPE] = type;
+    m_response.content.clear();
+    m_response.contentProducer = contentProducer;
+}
+
+void ResponseBuilder::defer(DeferredResponse *deferredResponse)
+{
+    m_response.content.clear();
+    m_response.deferredResponse = deferredResponse;
+}
+
 void ResponseBuilder::clear()
 {
     m_response = Response();
@@ -42,6 +42,9 @@ namespace Http
         void setHeader(const Header &header);
         void print(const QString &text, const QString &type = CONTENT_TYPE_HTML);
         void print(const QByteArray &data, const QString &type = CONTENT_TYPE_HTML);
+        void stream(EventStream *eventStream);
+        void stream(ContentProducer *contentProducer, const QString &type);
+        void defer(DeferredResponse *deferredResponse);
         void clear();
 
         Response response() const;
@@ -29,18 +29,94 @@
 
 #include "responsegenerator.h"
 
+#include <algorithm>
+#include <span>
+
+#include <QByteArrayView>
 #include <QDateTime>
+#include <QList>
+#include <QStringView>
 
 #include "base/http/types.h"
 #include "base/utils/gzip.h"
 
-QByteArray Http::toByteArray(Response response)
+#ifdef QBT_USES_ZSTD
+#include "base/utils/zstd.h"
+#endif
+
+namespace
 {
-    compressContent(response);
+    struct CompressionLevels
+    {
+        qsizetype maxContentSize = 0;
+        int gzipLevel = 0;
+        int zstdLevel = 0;
+    };
+
+    // Levels per size bucket, the last bucket is also used when the size isn't known.
+    // API responses are regenerated on each request, so large ones favor speed over ratio.
+    const CompressionLevels JSON_COMPRESSION_LEVELS[] =
+    {
+        {.maxContentSize = (64 * 1024), .gzipLevel = 6, .zstdLevel = 6},
+        {.maxContentSize = (1024 * 1024), .gzipLevel = 4, .zstdLevel = 3},
+        {.maxContentSize = -1, .gzipLevel = 1, .zstdLevel = 1}
+    };
+
+    // Text resources are mostly static, so a better ratio is worth the extra time
+    const CompressionLevels TEXT_COMPRESSION_LEVELS[] =
+    {
+        {.maxContentSize = (64 * 1024), .gzipLevel = 6, .zstdLevel = 9},
+        {.maxContentSize = (1024 * 1024), .gzipLevel = 6, .zstdLevel = 6},
+        {.maxContentSize = -1, .gzipLevel = 4, .zstdLevel = 3}
+    };
+
+    const CompressionLevels OTHER_COMPRESSION_LEVELS[] =
+    {
+        {.maxContentSize = (1024 * 1024), .gzipLevel = 6, .zstdLevel = 3},
+        {.maxContentSize = -1, .gzipLevel = 1, .zstdLevel = 1}
+    };
+
+    // [rfc7231] 5.3.1. Quality Values
+    // Returns the quality value of the coding, 0 if it isn't accepted
+    double codingQuality(const QList<QStringView> &list, const QStringView coding)
+    {
+        for (const QStringView &str : list)
+        {
+            if (!str.startsWith(coding))
+                continue;
+
+            // without quality values
+            if (str == coding)
+                return 1;
+
+            const QStringView substr = str.mid(coding.size() + 3);  // ex. skip over "gzip;q="
+
+            bool ok = false;
+            const double qvalue = substr.toDouble(&ok);
+            if (!ok || (qvalue <= 0))
+                return 0;
+
+            return qvalue;
+        }
+        return 0;
+    }
+
+    QList<QStringView> splitCodings(QString &codings)
+    {
+        // [rfc7231] 5.3.4. Accept-Encoding
+        return QStringView(codings.remove(u' ').remove(u'\t')).split(u',', Qt::SkipEmptyParts);
+    }
+}
 
+QByteArray Http::toByteArray(Response response)
+{
     response.headers[HEADER_DATE] = httpDate();
-    if (QString &value = response.headers[HEADER_CONTENT_LENGTH]; value.isEmpty())
-        value = QString::number(response.content.length());
+    // event stream body lasts until the connection is closed, produced content is sent in chunks
+    if (!response.eventStream && !response.contentProducer)
+    {
+        if (QString &value = response.headers[HEADER_CONTENT_LENGTH]; value.isEmpty())
+            value = QString::number(response.content.length());
+    }
 
     QByteArray buf;
     buf.reserve(1024 + response.content.length());
@@ -79,13 +155,11 @@ QString Http::httpDate()
         .append(u" GMT");
 }
 
-void Http::compressContent(Response &response)
+void Http::compressContent(Response &response, const ContentCoding coding)
 {
-    if (response.headers.value(HEADER_CONTENT_ENCODING) != u"gzip")
+    if (coding == ContentCoding::Identity)
         return;
 
-    response.headers.remove(HEADER_CONTENT_ENCODING);
-
     // for very small files, compressing them only wastes cpu cycles
     const qsizetype contentSize = response.content.size();
     if (contentSize <= 1024)  // 1 kb
@@ -97,15 +171,201 @@ void Http::compressContent(Response &response)
         return;
 
     // try compressing
+    const int level = compressionLevel(coding, contentType, contentSize);
     bool ok = false;
-    const QByteArray compressedData = Utils::Gzip::compress(response.content, 6, &ok);
+    QByteArray compressedData;
+    switch (coding)
+    {
+    case ContentCoding::Gzip:
+        compressedData = Utils::Gzip::compress(response.content, level, &ok);
+        break;
+#ifdef QBT_USES_ZSTD
+    case ContentCoding::Zstd:
+        compressedData = Utils::Zstd::compress(response.content, level, &ok);
+        break;
+#endif
+    default:
+        break;
+    }
     if (!ok)
         return;
 
-    // "Content-Encoding: gzip\r\n" is 24 bytes long
-    if ((compressedData.size() + 24) >= contentSize)
+    // e.g. "Content-Encoding: gzip\r\n" is 24 bytes long
+    const QString codingName = contentCodingName(coding);
+    if ((compressedData.size() + 20 + codingName.size()) >= contentSize)
         return;
 
     response.content = compressedData;
-    response.headers[HEADER_CONTENT_ENCODING] = u"gzip"_s;
+    response.headers[HEADER_CONTENT_ENCODING] = codingName;
+}
+
+bool Http::acceptsGzipEncoding(QString codings)
+{
+    const QList<QStringView> list = splitCodings(codings);
+    if (list.isEmpty())
+        return false;
+
+    const bool canGzip = (codingQuality(list, u"gzip"_s) > 0);
+    if (canGzip)
+        return true;
+
+    const bool canAny = (codingQuality(list, u"*"_s) > 0);
+    if (canAny)
+        return true;
+
+    return false;
+}
+
+Http::ContentCoding Http::negotiateContentCoding(QString codings)
+{
+#ifdef QBT_USES_ZSTD
+    const QList<QStringView> list = splitCodings(codings);
+    // zstd is faster at a better ratio, so it is chosen unless gzip is preferred explicitly.
+    // Its support isn't assumed from "*" since it is much less common than gzip.
+    if (const double zstdQuality = codingQuality(list, u"zstd"_s); (zstdQuality > 0)
+        && (zstdQuality >= codingQuality(list, u"gzip"_s)))
+    {
+        return ContentCoding::Zstd;
+    }
+#endif
+
+    return acceptsGzipEncoding(codings) ? ContentCoding::Gzip : ContentCoding::Identity;
+}
+
+QString Http::contentCodingName(const ContentCoding coding)
+{
+    switch (coding)
+    {
+    case ContentCoding::Gzip:
+        return u"gzip"_s;
+    case ContentCoding::Zstd:
+        return u"zstd"_s;
+    default:
+        return u"identity"_s;
+    }
+}
+
+double Http::mediaTypeQuality(const QStringView mediaRanges, const QStringView mediaType)
+{
+    // [RFC 9110] 12.5.1. Accept
+    const QList<QStringView> ranges = mediaRanges.split(u',', Qt::SkipEmptyParts);
+    for (const QStringView range : ranges)
+    {
+        const QList<QStringView> parts = range.split(u';');
+        if (parts.first().trimmed().compare(mediaType, Qt::CaseInsensitive) != 0)
+            continue;
+
+        for (const QStringView param : parts.sliced(1))
+        {
+            const QStringView trimmedParam = param.trimmed();
+            if (!trimmedParam.startsWith(u"q=", Qt::CaseInsensitive))
+                continue;
+
+            bool ok = false;
+            const double qvalue = trimmedParam.sliced(2).toDouble(&ok);
+            return (ok && (qvalue > 0)) ? qvalue : 0;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+int Http::compressionLevel(const ContentCoding coding, const QString &contentType, const qsizetype contentSize)
+{
+    const auto levelsFor = [](const QString &type) -> std::span<const CompressionLevels>
+    {
+        if (type.startsWith(CONTENT_TYPE_JSON) || (type == CONTENT_TYPE_CBOR))
+            return JSON_COMPRESSION_LEVELS;
+        if (type.startsWith(u"text/") || (type == CONTENT_TYPE_JS))
+            return TEXT_COMPRESSION_LEVELS;
+        return OTHER_COMPRESSION_LEVELS;
+    };
+
+    const std::span<const CompressionLevels> levels = levelsFor(contentType);
+    const CompressionLevels *bucket = &levels.back();
+    if (contentSize >= 0)
+    {
+        for (const CompressionLevels &item : levels)
+        {
+            if ((item.maxContentSize < 0) || (contentSize <= item.maxContentSize))
+            {
+                bucket = &item;
+                break;
+            }
+        }
+    }
+
+    return (coding == ContentCoding::Zstd) ? bucket->zstdLevel : bucket->gzipLevel;
+}
+
+std::optional<Http::ByteRange> Http::parseByteRange(const QStringView value, const qint64 contentSize)
+{
+    // [rfc9110] 14.1.2. Byte Ranges
+    // examples: "bytes=0-499", "bytes=500-", "bytes=-500"
+    const QStringView prefix = u"bytes=";
+    const QStringView rangeSpec = value.trimmed();
+    if (!rangeSpec.startsWith(prefix, Qt::CaseInsensitive) || (contentSize <= 0))
+        return std::nullopt;
+
+    const QStringView range = rangeSpec.mid(prefix.size()).trimmed();
+    const qsizetype separatorPos = range.indexOf(u'-');
+    if ((separatorPos < 0) || range.contains(u','))
+        return std::nullopt;
+
+    const QStringView firstPosStr = range.left(separatorPos).trimmed();
+    const QStringView lastPosStr = range.mid(separatorPos + 1).trimmed();
+
+    bool ok = false;
+    if (firstPosStr.isEmpty())
+    {
+        // suffix range, i.e. the last N bytes
+        const qint64 suffixLength = lastPosStr.toLongLong(&ok);
+        if (!ok || (suffixLength <= 0))
+            return std::nullopt;
+
+        return ByteRange {.first = std::max<qint64>((contentSize - suffixLength), 0), .last = (contentSize - 1)};
+    }
+
+    const qint64 firstPos = firstPosStr.toLongLong(&ok);
+    if (!ok || (firstPos < 0) || (firstPos >= contentSize))
+        return std::nullopt;
+
+    if (lastPosStr.isEmpty())
+        return ByteRange {.first = firstPos, .last = (contentSize - 1)};
+
+    const qint64 lastPos = lastPosStr.toLongLong(&ok);
+    if (!ok || (lastPos < firstPos))
+        return std::nullopt;
+
+    return ByteRange {.first = firstPos, .last = std::min(lastPos, (contentSize - 1))};
+}
+
+Http::ContentCompressor::ContentCompressor(const ContentCoding coding, const int level)
+{
+    switch (coding)
+    {
+    case ContentCoding::Gzip:
+        m_gzipCompressor = std::make_unique<Utils::Gzip::StreamCompressor>(level);
+        break;
+#ifdef QBT_USES_ZSTD
+    case ContentCoding::Zstd:
+        m_zstdCompressor = std::make_unique<Utils::Zstd::StreamCompressor>(level);
+        break;
+#endif
+    default:
+        break;
+    }
+}
+
+Http::ContentCompressor::~ContentCompressor() = default;
+
+QByteArray Http::ContentCompressor::compress(const QByteArrayView data, const bool finish)
+{
+    if (m_gzipCompressor)
+        return m_gzipCompressor->compress(data, finish);
+#ifdef QBT_USES_ZSTD
+    if (m_zstdCompressor)
+        return m_zstdCompressor->compress(data, finish);
+#endif
+    return data.toByteArray();
 }
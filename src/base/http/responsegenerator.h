@@ -30,14 +30,82 @@
 
 #pragma once
 
+#include <memory>
+#include <optional>
+
+#include <QtClassHelperMacros>
+#include <QtTypes>
+
 class QByteArray;
+class QByteArrayView;
 class QString;
+class QStringView;
+
+namespace Utils::Gzip
+{
+    class StreamCompressor;
+}
+
+namespace Utils::Zstd
+{
+    class StreamCompressor;
+}
 
 namespace Http
 {
     struct Response;
 
+    // Bytes of the content in [first;last] interval
+    struct ByteRange
+    {
+        qint64 first = 0;
+        qint64 last = 0;
+
+        friend bool operator==(const ByteRange &left, const ByteRange &right) = default;
+    };
+
+    enum class ContentCoding
+    {
+        Identity,
+        Gzip,
+        Zstd
+    };
+
     QByteArray toByteArray(Response response);
     QString httpDate();
-    void compressContent(Response &response);
+    // Compresses the content with the given coding if it is worth it
+    void compressContent(Response &response, ContentCoding coding = ContentCoding::Gzip);
+    bool acceptsGzipEncoding(QString codings);
+    // Returns the most suitable of the supported codings accepted by the client
+    ContentCoding negotiateContentCoding(QString codings);
+    QString contentCodingName(ContentCoding coding);
+    // Returns the quality value of the media type listed explicitly in the value of "Accept" header,
+    // 0 if it isn't listed or isn't accepted
+    double mediaTypeQuality(QStringView mediaRanges, QStringView mediaType);
+    // Returns the compression level for the content of the given type and size,
+    // the size is negative when it isn't known in advance (e.g. streamed content)
+    int compressionLevel(ContentCoding coding, const QString &contentType, qsizetype contentSize);
+    // Returns the bytes of the content of the given size requested by the value of "Range" header,
+    // or nothing if it doesn't request a single satisfiable range
+    std::optional<ByteRange> parseByteRange(QStringView value, qint64 contentSize);
+
+    // Compresses the content passed in parts with the given coding
+    class ContentCompressor
+    {
+        Q_DISABLE_COPY_MOVE(ContentCompressor)
+
+    public:
+        ContentCompressor(ContentCoding coding, int level);
+        ~ContentCompressor();
+
+        // Returns the compressed data available so far,
+        // the content is completed when `finish` is set
+        QByteArray compress(QByteArrayView data, bool finish = false);
+
+    private:
+        std::unique_ptr<Utils::Gzip::StreamCompressor> m_gzipCompressor;
+#ifdef QBT_USES_ZSTD
+        std::unique_ptr<Utils::Zstd::StreamCompressor> m_zstdCompressor;
+#endif
+    };
 }
@@ -34,20 +34,29 @@
 #include <chrono>
 #include <memory>
 #include <new>
+#include <optional>
 
 #include <QtLogging>
+#include <QHash>
+#include <QLocalServer>
+#include <QLocalSocket>
 #include <QNetworkProxy>
 #include <QSslCertificate>
 #include <QSslCipher>
 #include <QSslKey>
 #include <QSslSocket>
 #include <QStringList>
+#include <QThread>
 #include <QTimer>
 
 #include "base/global.h"
 #include "base/utils/net.h"
 #include "base/utils/sslkey.h"
 #include "connection.h"
+#include "contentproducer.h"
+#include "deferredresponse.h"
+#include "eventstream.h"
+#include "irequesthandler.h"
 
 using namespace std::chrono_literals;
 
@@ -56,6 +65,7 @@ namespace
     const int KEEP_ALIVE_DURATION = std::chrono::milliseconds(7s).count();
     const int CONNECTIONS_LIMIT = 500;
     const std::chrono::seconds CONNECTIONS_SCAN_INTERVAL {2};
+    const int MAX_WORKER_THREADS = 16;
 
     QList<QSslCipher> safeCipherList()
     {
@@ -98,6 +108,131 @@ namespace
 
 using namespace Http;
 
+class Server::Worker final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(Worker)
+
+public:
+    Worker(IRequestHandler *requestHandler, QObject *requestContext, std::atomic_int &connectionsCount);
+    ~Worker() override;
+
+    void addConnection(qintptr socketDescriptor, const std::optional<QSslConfiguration> &sslConfig, bool isHTTP2Enabled);
+
+private:
+    void dispatchRequest(quint64 connectionID, quint32 streamID, const Request &request, const Environment &env);
+    void processResponse(quint64 connectionID, quint32 streamID, const Response &response);
+    void removeConnection(quint64 connectionID);
+    void dropTimedOutConnections();
+
+    IRequestHandler *m_requestHandler = nullptr;
+    QObject *m_requestContext = nullptr;
+    std::atomic_int &m_connectionsCount;
+    // responses refer to connections by ID since they may be closed in the meantime
+    QHash<quint64, Connection *> m_connections;
+    quint64 m_lastConnectionID = 0;
+};
+
+Server::Worker::Worker(IRequestHandler *requestHandler, QObject *requestContext, std::atomic_int &connectionsCount)
+    : m_requestHandler {requestHandler}
+    , m_requestContext {requestContext}
+    , m_connectionsCount {connectionsCount}
+{
+    auto *dropConnectionTimer = new QTimer(this);
+    connect(dropConnectionTimer, &QTimer::timeout, this, &Worker::dropTimedOutConnections);
+    dropConnectionTimer->start(CONNECTIONS_SCAN_INTERVAL);
+}
+
+Server::Worker::~Worker()
+{
+    m_connectionsCount -= m_connections.size();
+}
+
+void Server::Worker::addConnection(const qintptr socketDescriptor, const std::optional<QSslConfiguration> &sslConfig
+    , const bool isHTTP2Enabled)
+{
+    std::unique_ptr<QTcpSocket> serverSocket = sslConfig ? std::make_unique<QSslSocket>(this) : std::make_unique<QTcpSocket>(this);
+    if (!serverSocket->setSocketDescriptor(socketDescriptor))
+    {
+        --m_connectionsCount;
+        return;
+    }
+
+    try
+    {
+        if (sslConfig)
+        {
+            auto *sslSocket = static_cast<QSslSocket *>(serverSocket.get());
+            sslSocket->setSslConfiguration(*sslConfig);
+            sslSocket->startServerEncryption();
+        }
+
+        const quint64 connectionID = ++m_lastConnectionID;
+        auto *connection = new Connection(serverSocket.release()
+            , [this, connectionID](Connection *, const quint32 streamID, const Request &request, const Environment &env)
+        {
+            dispatchRequest(connectionID, streamID, request, env);
+        }, this);
+        connection->setHTTP2Enabled(isHTTP2Enabled);
+        m_connections.insert(connectionID, connection);
+        connect(connection, &Connection::closed, this, [this, connectionID] { removeConnection(connectionID); });
+    }
+    catch (const std::bad_alloc &exception)
+    {
+        // drop the connection instead of throwing exception and crash
+        qWarning("Failed to allocate memory for HTTP connection. Connection closed.");
+        --m_connectionsCount;
+        return;
+    }
+}
+
+void Server::Worker::dispatchRequest(const quint64 connectionID, const quint32 streamID, const Request &request, const Environment &env)
+{
+    QMetaObject::invokeMethod(m_requestContext, [this, connectionID, streamID, request, env]
+    {
+        const Response response = m_requestHandler->processRequest(request, env);
+        QMetaObject::invokeMethod(this, [this, connectionID, streamID, response]
+        {
+            processResponse(connectionID, streamID, response);
+        });
+    });
+}
+
+void Server::Worker::processResponse(const quint64 connectionID, const quint32 streamID, const Response &response)
+{
+    if (Connection *connection = m_connections.value(connectionID))
+        connection->processResponse(response, streamID);
+    else if (response.eventStream)
+        response.eventStream->deleteLater();
+    else if (response.contentProducer)
+        response.contentProducer->deleteLater();
+    else if (response.deferredResponse)
+        response.deferredResponse->deleteLater();
+}
+
+void Server::Worker::removeConnection(const quint64 connectionID)
+{
+    if (Connection *connection = m_connections.take(connectionID))
+    {
+        --m_connectionsCount;
+        connection->deleteLater();
+    }
+}
+
+void Server::Worker::dropTimedOutConnections()
+{
+    m_connections.removeIf([this](const QHash<quint64, Connection *>::iterator &iter)
+    {
+        Connection *connection = iter.value();
+        if (!connection->hasExpired(KEEP_ALIVE_DURATION))
+            return false;
+
+        --m_connectionsCount;
+        connection->deleteLater();
+        return true;
+    });
+}
+
 Server::Server(IRequestHandler *requestHandler, QObject *parent)
     : QTcpServer(parent)
     , m_requestHandler(requestHandler)
@@ -113,13 +248,72 @@ Server::Server(IRequestHandler *requestHandler, QObject *parent)
     dropConnectionTimer->start(CONNECTIONS_SCAN_INTERVAL);
 }
 
+Server::~Server()
+{
+    // stop the workers while the shared state is still valid
+    m_workerThreads.clear();
+}
+
+int Server::workerThreadCount() const
+{
+    return static_cast<int>(m_workerThreads.size());
+}
+
+void Server::setWorkerThreadCount(const int count)
+{
+    const auto newCount = static_cast<std::size_t>(std::clamp(count, 0, MAX_WORKER_THREADS));
+    if (newCount == m_workerThreads.size())
+        return;
+
+    m_workerThreads.clear();
+    m_nextWorkerIndex = 0;
+
+    m_workerThreads.reserve(newCount);
+    for (std::size_t i = 0; i < newCount; ++i)
+    {
+        WorkerThread &workerThread = m_workerThreads.emplace_back();
+        workerThread.requestContext = std::make_unique<QObject>();
+        workerThread.thread.reset(new QThread);
+        workerThread.thread->setObjectName(u"Http::Server worker thread %1"_s.arg(i + 1));
+        workerThread.worker = new Worker(m_requestHandler, workerThread.requestContext.get(), m_workerConnectionsCount);
+        workerThread.worker->moveToThread(workerThread.thread.get());
+        connect(workerThread.thread.get(), &QThread::finished, workerThread.worker, &QObject::deleteLater);
+        Utils::Thread::setWorkload(workerThread.thread.get(), Utils::Thread::Workload::LatencySensitive);
+        workerThread.thread->start();
+    }
+}
+
 void Server::incomingConnection(const qintptr socketDescriptor)
 {
+    if (!m_workerThreads.empty())
+    {
+        if ((m_connections.size() + m_workerConnectionsCount) >= CONNECTIONS_LIMIT)
+        {
+            // let the socket close the descriptor
+            QTcpSocket socket;
+            socket.setSocketDescriptor(socketDescriptor);
+            qWarning("Too many connections. Exceeded CONNECTIONS_LIMIT (%d). Connection closed.", CONNECTIONS_LIMIT);
+            return;
+        }
+
+        ++m_workerConnectionsCount;
+
+        Worker *worker = m_workerThreads[m_nextWorkerIndex].worker;
+        m_nextWorkerIndex = (m_nextWorkerIndex + 1) % m_workerThreads.size();
+
+        const std::optional<QSslConfiguration> sslConfig = isHttps() ? std::optional(m_sslConfig) : std::nullopt;
+        QMetaObject::invokeMethod(worker, [worker, socketDescriptor, sslConfig, isHTTP2Enabled = m_isHTTP2Enabled]
+        {
+            worker->addConnection(socketDescriptor, sslConfig, isHTTP2Enabled);
+        });
+        return;
+    }
+
     std::unique_ptr<QTcpSocket> serverSocket = isHttps() ? std::make_unique<QSslSocket>(this) : std::make_unique<QTcpSocket>(this);
     if (!serverSocket->setSocketDescriptor(socketDescriptor))
         return;
 
-    if (m_connections.size() >= CONNECTIONS_LIMIT)
+    if ((m_connections.size() + m_workerConnectionsCount) >= CONNECTIONS_LIMIT)
     {
         qWarning("Too many connections. Exceeded CONNECTIONS_LIMIT (%d). Connection closed.", CONNECTIONS_LIMIT);
         return;
@@ -135,6 +329,7 @@ void Server::incomingConnection(const qintptr socketDescriptor)
         }
 
         auto *connection = new Connection(serverSocket.release(), m_requestHandler, this);
+        connection->setHTTP2Enabled(m_isHTTP2Enabled);
         m_connections.insert(connection);
         connect(connection, &Connection::closed, this, [this, connection] { removeConnection(connection); });
     }
@@ -146,6 +341,34 @@ void Server::incomingConnection(const qintptr socketDescriptor)
     }
 }
 
+void Server::handleLocalConnection()
+{
+    while (m_localServer->hasPendingConnections())
+    {
+        std::unique_ptr<QLocalSocket> serverSocket {m_localServer->nextPendingConnection()};
+
+        if ((m_connections.size() + m_workerConnectionsCount) >= CONNECTIONS_LIMIT)
+        {
+            qWarning("Too many connections. Exceeded CONNECTIONS_LIMIT (%d). Connection closed.", CONNECTIONS_LIMIT);
+            continue;
+        }
+
+        try
+        {
+            auto *connection = new Connection(serverSocket.release(), m_requestHandler, this);
+            connection->setHTTP2Enabled(m_isHTTP2Enabled);
+            m_connections.insert(connection);
+            connect(connection, &Connection::closed, this, [this, connection] { removeConnection(connection); });
+        }
+        catch (const std::bad_alloc &exception)
+        {
+            // drop the connection instead of throwing exception and crash
+            qWarning("Failed to allocate memory for HTTP connection. Connection closed.");
+            continue;
+        }
+    }
+}
+
 void Server::removeConnection(Connection *connection)
 {
     m_connections.remove(connection);
@@ -192,3 +415,52 @@ bool Server::isHttps() const
 {
     return m_https;
 }
+
+bool Server::isHTTP2Enabled() const
+{
+    return m_isHTTP2Enabled;
+}
+
+bool Server::listenLocal(const QString &name)
+{
+    if (!m_localServer)
+    {
+        m_localServer = new QLocalServer(this);
+        m_localServer->setSocketOptions(QLocalServer::UserAccessOption);
+        connect(m_localServer, &QLocalServer::newConnection, this, &Server::handleLocalConnection);
+    }
+
+    m_localServer->close();
+    // the socket file may be left by the instance which has crashed
+    QLocalServer::removeServer(name);
+    return m_localServer->listen(name);
+}
+
+void Server::closeLocal()
+{
+    if (m_localServer)
+        m_localServer->close();
+}
+
+QString Server::localServerName() const
+{
+    return m_localServer ? m_localServer->serverName() : QString();
+}
+
+QString Server::localServerErrorString() const
+{
+    return m_localServer ? m_localServer->errorString() : QString();
+}
+
+void Server::setHTTP2Enabled(const bool enabled)
+{
+    m_isHTTP2Enabled = enabled;
+
+    // the browsers use HTTP/2 only if it is negotiated by TLS ALPN
+    if (enabled)
+        m_sslConfig.setAllowedNextProtocols({QSslConfiguration::ALPNProtocolHTTP2, QSslConfiguration::NextProtocolHttp1_1});
+    else
+        m_sslConfig.setAllowedNextProtocols({});
+}
+
+#include "server.moc"
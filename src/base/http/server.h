@@ -30,10 +30,18 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
+#include <vector>
+
 #include <QSet>
 #include <QSslConfiguration>
 #include <QTcpServer>
 
+#include "base/utils/thread.h"
+
+class QLocalServer;
+
 namespace Http
 {
     class IRequestHandler;
@@ -46,22 +54,60 @@ namespace Http
 
     public:
         explicit Server(IRequestHandler *requestHandler, QObject *parent = nullptr);
+        ~Server() override;
 
         bool setupHttps(const QByteArray &certificates, const QByteArray &privateKey);
         void disableHttps();
         bool isHttps() const;
 
+        // Applies to the new connections, HTTP/2 is negotiated by TLS ALPN
+        // or used by the client which starts the connection with HTTP/2 preface
+        bool isHTTP2Enabled() const;
+        void setHTTP2Enabled(bool enabled);
+
+        // Also serves the clients connected to the local socket (i.e. Unix domain socket or Windows named pipe)
+        // in the server thread. Only the user running the application can connect to the socket,
+        // so its requests don't need to be authenticated.
+        bool listenLocal(const QString &name);
+        void closeLocal();
+        // Empty if the server isn't listening on the local socket
+        QString localServerName() const;
+        QString localServerErrorString() const;
+
+        // With non-zero count, new connections are served by worker threads which own the sockets
+        // and perform TLS and compression. Only the requests are processed in the server thread.
+        // Changing the count closes the connections served by the previous workers.
+        int workerThreadCount() const;
+        void setWorkerThreadCount(int count);
+
     private slots:
         void dropTimedOutConnection();
 
     private:
+        class Worker;
+
+        struct WorkerThread
+        {
+            Utils::Thread::UniquePtr thread;
+            Worker *worker = nullptr;
+            std::unique_ptr<QObject> requestContext;  // drops queued requests of the removed worker
+        };
+
         void incomingConnection(qintptr socketDescriptor) override;
+        void handleLocalConnection();
         void removeConnection(Connection *connection);
 
         IRequestHandler *m_requestHandler = nullptr;
         QSet<Connection *> m_connections;  // for tracking persistent connections
 
         bool m_https = false;
+        bool m_isHTTP2Enabled = false;
         QSslConfiguration m_sslConfig;
+
+        QLocalServer *m_localServer = nullptr;
+
+        std::atomic_int m_workerConnectionsCount = 0;
+        std::vector<WorkerThread> m_workerThreads;
+        std::size_t m_nextWorkerIndex = 0;
     };
 }
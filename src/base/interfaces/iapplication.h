@@ -83,6 +83,12 @@ public:
     virtual int memoryWorkingSetLimit() const = 0;
     virtual void setMemoryWorkingSetLimit(int size) = 0;
 
+    // Thread scheduling policy, it is applied on startup
+    virtual bool isBulkWorkPriorityLowered() const = 0;
+    virtual void setBulkWorkPriorityLowered(bool value) = 0;
+    virtual QString latencySensitiveThreadsCPUAffinity() const = 0;
+    virtual void setLatencySensitiveThreadsCPUAffinity(const QString &cpus) = 0;
+
     virtual void sendTestEmail() const = 0;
 
 #ifdef Q_OS_WIN
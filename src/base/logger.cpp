@@ -29,29 +29,72 @@
 #include "logger.h"
 
 #include <algorithm>
-#include <ranges>
 
 #include <QDateTime>
-#include <QList>
 
-namespace
+#include "base/utils/memory.h"
+
+template <typename T>
+T Logger::Buffer<T>::push(T entry)
 {
-    template <typename T>
-    QList<T> loadFromBuffer(const boost::circular_buffer_space_optimized<T> &src, const int offset = 0)
+    const QMutexLocker pushLocker {&m_pushMutex};
+
+    const int id = m_nextID.load(std::memory_order_relaxed);
+    const int index = id % CHUNK_SIZE;
+    if (index == 0)
     {
-        QList<T> ret;
-        ret.reserve(static_cast<typename decltype(ret)::size_type>(src.size()) - offset);
-        std::ranges::copy(std::views::drop(src, offset), std::back_inserter(ret));
-        return ret;
+        auto chunk = std::make_shared<Chunk>();
+        m_currentChunk = chunk.get();
+
+        const QMutexLocker chunksLocker {&m_chunksMutex};
+        m_chunks.append(std::move(chunk));
+        // drop the chunks containing only the entries that are out of the capacity
+        while ((m_firstID + CHUNK_SIZE) <= (id + 1 - MAX_LOG_MESSAGES))
+        {
+            m_chunks.removeFirst();
+            m_firstID += CHUNK_SIZE;
+        }
     }
+
+    entry.id = id;
+    (*m_currentChunk)[index] = entry;
+    // publish the entry to the readers
+    m_nextID.store((id + 1), std::memory_order_release);
+
+    return entry;
+}
+
+template <typename T>
+QList<T> Logger::Buffer<T>::entries(const int lastKnownId) const
+{
+    const Log::Snapshot<T> entriesSnapshot = snapshot();
+    const int beginID = std::max(entriesSnapshot.beginID(), (lastKnownId + 1));
+    const int endID = entriesSnapshot.endID();
+    if (beginID >= endID)
+        return {};
+
+    QList<T> ret;
+    ret.reserve(endID - beginID);
+    for (int id = beginID; id < endID; ++id)
+        ret.append(entriesSnapshot.at(id));
+    return ret;
+}
+
+template <typename T>
+Log::Snapshot<T> Logger::Buffer<T>::snapshot() const
+{
+    const QMutexLocker locker {&m_chunksMutex};
+    const int nextID = m_nextID.load(std::memory_order_acquire);
+    const int beginID = std::max(m_firstID, (nextID - MAX_LOG_MESSAGES));
+    return {m_chunks, m_firstID, beginID, nextID};
 }
 
 Logger *Logger::m_instance = nullptr;
 
 Logger::Logger()
-    : m_messages(MAX_LOG_MESSAGES)
-    , m_peers(MAX_LOG_MESSAGES)
 {
+    for (std::atomic_int &types : m_categoryMessageTypes)
+        types.store(Log::ALL, std::memory_order_relaxed);
 }
 
 Logger *Logger::instance()
@@ -73,57 +116,64 @@ void Logger::freeInstance()
 
 void Logger::addMessage(const QString &message, const Log::MsgType &type)
 {
-    QWriteLocker locker(&m_lock);
-    const Log::Msg msg = {m_msgCounter++, type, QDateTime::currentSecsSinceEpoch(), message};
-    m_messages.push_back(msg);
-    locker.unlock();
-
+    const Log::Msg msg = m_messages.push({.type = type, .timestamp = QDateTime::currentSecsSinceEpoch(), .message = message});
     emit newLogMessage(msg);
 }
 
 void Logger::addPeer(const QString &ip, const bool blocked, const QString &reason)
 {
-    QWriteLocker locker(&m_lock);
-    const Log::Peer msg = {m_peerCounter++, blocked, QDateTime::currentSecsSinceEpoch(), ip, reason};
-    m_peers.push_back(msg);
-    locker.unlock();
-
+    const Log::Peer msg = m_peers.push({.blocked = blocked, .timestamp = QDateTime::currentSecsSinceEpoch(), .ip = ip, .reason = reason});
     emit newLogPeer(msg);
 }
 
 QList<Log::Msg> Logger::getMessages(const int lastKnownId) const
 {
-    const QReadLocker locker(&m_lock);
-
-    const int diff = m_msgCounter - lastKnownId - 1;
-    const int size = static_cast<int>(m_messages.size());
+    return m_messages.entries(lastKnownId);
+}
 
-    if ((lastKnownId == -1) || (diff >= size))
-        return loadFromBuffer(m_messages);
+QList<Log::Peer> Logger::getPeers(const int lastKnownId) const
+{
+    return m_peers.entries(lastKnownId);
+}
 
-    if (diff <= 0)
-        return {};
+Log::Snapshot<Log::Msg> Logger::messagesSnapshot() const
+{
+    return m_messages.snapshot();
+}
 
-    return loadFromBuffer(m_messages, (size - diff));
+Log::Snapshot<Log::Peer> Logger::peersSnapshot() const
+{
+    return m_peers.snapshot();
 }
 
-QList<Log::Peer> Logger::getPeers(const int lastKnownId) const
+qint64 Logger::estimatedMemoryUsage() const
 {
-    const QReadLocker locker(&m_lock);
+    const QList<Log::Msg> messages = getMessages();
+    const QList<Log::Peer> peers = getPeers();
 
-    const int diff = m_peerCounter - lastKnownId - 1;
-    const int size = static_cast<int>(m_peers.size());
+    // Buffers allocate their memory by chunks as they grow
+    qint64 size = static_cast<qint64>((messages.size() * sizeof(Log::Msg)) + (peers.size() * sizeof(Log::Peer)));
+    for (const Log::Msg &msg : messages)
+        size += Utils::Memory::estimateHeapSize(msg.message);
+    for (const Log::Peer &peer : peers)
+        size += Utils::Memory::estimateHeapSize(peer.ip) + Utils::Memory::estimateHeapSize(peer.reason);
 
-    if ((lastKnownId == -1) || (diff >= size))
-        return loadFromBuffer(m_peers);
+    return size;
+}
 
-    if (diff <= 0)
-        return {};
+Log::MsgTypes Logger::messageTypes(const Log::Category category) const
+{
+    return Log::MsgTypes::fromInt(m_categoryMessageTypes[static_cast<int>(category)].load(std::memory_order_relaxed));
+}
 
-    return loadFromBuffer(m_peers, (size - diff));
+void Logger::setMessageTypes(const Log::Category category, const Log::MsgTypes types)
+{
+    m_categoryMessageTypes[static_cast<int>(category)].store(types.toInt(), std::memory_order_relaxed);
 }
 
 void LogMsg(const QString &message, const Log::MsgType &type)
 {
-    Logger::instance()->addMessage(message, type);
+    Logger *logger = Logger::instance();
+    if (logger->isEnabled(Log::Category::General, type))
+        logger->addMessage(message, type);
 }
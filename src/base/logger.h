@@ -28,12 +28,17 @@
 
 #pragma once
 
-#include <boost/circular_buffer.hpp>
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <functional>
+#include <memory>
+#include <utility>
 
+#include <QList>
+#include <QMutex>
 #include <QObject>
-#include <QReadWriteLock>
 #include <QString>
-#include <QtContainerFwd>
 
 inline const int MAX_LOG_MESSAGES = 20000;
 
@@ -49,6 +54,18 @@ namespace Log
     };
     Q_DECLARE_FLAGS(MsgTypes, MsgType)
 
+    // Subsystems the messages come from, each of them has its own verbosity
+    enum class Category
+    {
+        General,
+        Peers,
+        Trackers,
+        Network,
+        Storage,
+        Performance
+    };
+    inline constexpr int CATEGORY_COUNT = 6;
+
     struct Msg
     {
         int id = -1;
@@ -65,6 +82,48 @@ namespace Log
         QString ip;
         QString reason;
     };
+
+    // Entries kept by the logger at some moment. It shares the chunks of the logger
+    // buffer instead of copying the entries, so it is cheap to obtain and to keep.
+    template <typename T>
+    class Snapshot
+    {
+    public:
+        static constexpr int CHUNK_SIZE = 256;
+        using Chunk = std::array<T, CHUNK_SIZE>;
+
+        Snapshot() = default;
+        Snapshot(QList<std::shared_ptr<const Chunk>> chunks, const int chunksFirstID, const int beginID, const int endID)
+            : m_chunks {std::move(chunks)}
+            , m_chunksFirstID {chunksFirstID}
+            , m_beginID {beginID}
+            , m_endID {endID}
+        {
+        }
+
+        // IDs of the entries are in [beginID, endID) range
+        int beginID() const
+        {
+            return m_beginID;
+        }
+
+        int endID() const
+        {
+            return m_endID;
+        }
+
+        const T &at(const int id) const
+        {
+            Q_ASSERT((id >= m_beginID) && (id < m_endID));
+            return (*m_chunks[(id - m_chunksFirstID) / CHUNK_SIZE])[id % CHUNK_SIZE];
+        }
+
+    private:
+        QList<std::shared_ptr<const Chunk>> m_chunks;
+        int m_chunksFirstID = 0;
+        int m_beginID = 0;
+        int m_endID = 0;
+    };
 }
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Log::MsgTypes)
@@ -83,22 +142,68 @@ public:
     void addPeer(const QString &ip, bool blocked, const QString &reason = {});
     QList<Log::Msg> getMessages(int lastKnownId = -1) const;
     QList<Log::Peer> getPeers(int lastKnownId = -1) const;
+    Log::Snapshot<Log::Msg> messagesSnapshot() const;
+    Log::Snapshot<Log::Peer> peersSnapshot() const;
+    // Rough estimation of the memory used by the buffered messages
+    qint64 estimatedMemoryUsage() const;
+
+    // Message types recorded for the category, the other ones are dropped
+    Log::MsgTypes messageTypes(Log::Category category) const;
+    void setMessageTypes(Log::Category category, Log::MsgTypes types);
+    // It is cheap, so it can be checked before the message is even formatted
+    bool isEnabled(Log::Category category, Log::MsgType type) const
+    {
+        return (m_categoryMessageTypes[static_cast<int>(category)].load(std::memory_order_relaxed) & type) != 0;
+    }
 
 signals:
     void newLogMessage(const Log::Msg &message);
     void newLogPeer(const Log::Peer &peer);
 
 private:
+    // Keeps last MAX_LOG_MESSAGES entries in fixed size chunks. Entries are never modified
+    // once their ID is published, so readers copy them without holding any lock,
+    // only the list of chunks is guarded and it is changed once per chunk.
+    template <typename T>
+    class Buffer
+    {
+    public:
+        // Assigns the ID to the entry and returns it
+        T push(T entry);
+        QList<T> entries(int lastKnownId = -1) const;
+        Log::Snapshot<T> snapshot() const;
+
+    private:
+        static constexpr int CHUNK_SIZE = Log::Snapshot<T>::CHUNK_SIZE;
+        using Chunk = typename Log::Snapshot<T>::Chunk;
+
+        // Serializes the writers, readers never take it
+        QMutex m_pushMutex;
+        mutable QMutex m_chunksMutex;
+        QList<std::shared_ptr<const Chunk>> m_chunks;
+        int m_firstID = 0;
+        Chunk *m_currentChunk = nullptr;
+        std::atomic_int m_nextID = 0;
+    };
+
     Logger();
     ~Logger() = default;
 
     static Logger *m_instance;
-    boost::circular_buffer_space_optimized<Log::Msg> m_messages;
-    boost::circular_buffer_space_optimized<Log::Peer> m_peers;
-    mutable QReadWriteLock m_lock;
-    int m_msgCounter = 0;
-    int m_peerCounter = 0;
+    Buffer<Log::Msg> m_messages;
+    Buffer<Log::Peer> m_peers;
+    std::array<std::atomic_int, Log::CATEGORY_COUNT> m_categoryMessageTypes;
 };
 
 // Helper function
 void LogMsg(const QString &message, const Log::MsgType &type = Log::NORMAL);
+
+// Invokes `formatter` to get the message only if the category and type of the message are enabled,
+// so the translation lookup and formatting are skipped for the messages nobody is going to see
+template <std::invocable Formatter>
+void LogMsg(const Log::Category category, const Log::MsgType type, Formatter &&formatter)
+{
+    Logger *logger = Logger::instance();
+    if (logger->isEnabled(category, type))
+        logger->addMessage(std::invoke(std::forward<Formatter>(formatter)), type);
+}
@@ -0,0 +1,145 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include "downloadfilewriter.h"
+
+#include <QByteArray>
+#include <QSaveFile>
+#include <QTemporaryFile>
+
+#include "base/global.h"
+#include "base/utils/fs.h"
+#include "base/utils/gzip.h"
+
+Net::DownloadFileWriter::DownloadFileWriter(const Path &destinationPath, const bool decompress
+        , const std::optional<QCryptographicHash::Algorithm> hashAlgorithm, QObject *parent)
+    : QObject(parent)
+    , m_destinationPath {destinationPath}
+{
+    if (decompress)
+        m_decompressor = std::make_unique<Utils::Gzip::StreamDecompressor>();
+    if (hashAlgorithm)
+        m_hash = std::make_unique<QCryptographicHash>(*hashAlgorithm);
+}
+
+// Unfinished file is discarded
+Net::DownloadFileWriter::~DownloadFileWriter() = default;
+
+void Net::DownloadFileWriter::write(const QByteArray &data)
+{
+    if (!m_errorString.isEmpty() || data.isEmpty())
+        return;
+
+    m_hasData = true;
+    if (!m_file && !open())
+        return;
+
+    const QByteArray content = m_decompressor ? m_decompressor->decompress(data) : data;
+    if (m_decompressor && !m_decompressor->isValid())
+    {
+        m_errorString = tr("Couldn't decompress the downloaded data");
+        return;
+    }
+
+    if (m_hash)
+        m_hash->addData(content);
+
+    if (m_file->write(content) != content.size())
+        m_errorString = m_file->errorString();
+}
+
+void Net::DownloadFileWriter::finish()
+{
+    // the response may have no body, so the file isn't open yet
+    if (m_errorString.isEmpty() && !m_file)
+        open();
+
+    if (m_errorString.isEmpty() && m_hasData && m_decompressor && !m_decompressor->isFinished())
+        m_errorString = tr("Couldn't decompress the downloaded data");
+
+    if (m_errorString.isEmpty() && !m_file->flush())
+        m_errorString = m_file->errorString();
+
+    if (!m_errorString.isEmpty())
+    {
+        m_file.reset();
+        emit finished({}, {}, m_errorString);
+        return;
+    }
+
+    Path filePath = m_destinationPath;
+    if (auto *saveFile = qobject_cast<QSaveFile *>(m_file.get()))
+    {
+        if (!saveFile->commit())
+        {
+            const QString errorString = saveFile->errorString();
+            m_file.reset();
+            emit finished({}, {}, errorString);
+            return;
+        }
+    }
+    else
+    {
+        auto *tempFile = static_cast<QTemporaryFile *>(m_file.get());
+        tempFile->setAutoRemove(false);
+        filePath = Path(tempFile->fileName());
+    }
+
+    m_file.reset();
+    emit finished(filePath, (m_hash ? m_hash->result() : QByteArray()), {});
+}
+
+bool Net::DownloadFileWriter::open()
+{
+    if (m_destinationPath.isEmpty())
+    {
+        auto tempFile = std::make_unique<QTemporaryFile>((Utils::Fs::tempPath() / Path(u"file_"_s)).data());
+        if (!tempFile->open())
+        {
+            m_errorString = tempFile->errorString();
+            return false;
+        }
+
+        m_file = std::move(tempFile);
+    }
+    else
+    {
+        if (const Path parentPath = m_destinationPath.parentPath(); !parentPath.isEmpty())
+            Utils::Fs::mkpath(parentPath);
+
+        auto saveFile = std::make_unique<QSaveFile>(m_destinationPath.data());
+        if (!saveFile->open(QIODevice::WriteOnly))
+        {
+            m_errorString = saveFile->errorString();
+            return false;
+        }
+
+        m_file = std::move(saveFile);
+    }
+
+    return true;
+}
@@ -0,0 +1,78 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <QCryptographicHash>
+#include <QObject>
+
+#include "base/path.h"
+
+class QByteArray;
+class QFileDevice;
+
+namespace Utils::Gzip
+{
+    class StreamDecompressor;
+}
+
+namespace Net
+{
+    // Writes the downloaded data to file as it arrives, so it doesn't need to be kept in memory.
+    // It is supposed to live in a worker thread, so its methods are invoked asynchronously.
+    class DownloadFileWriter final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(DownloadFileWriter)
+
+    public:
+        // if destination path is empty, the data is written to a temporary file
+        DownloadFileWriter(const Path &destinationPath, bool decompress
+                , std::optional<QCryptographicHash::Algorithm> hashAlgorithm, QObject *parent = nullptr);
+        ~DownloadFileWriter() override;
+
+        void write(const QByteArray &data);
+        void finish();
+
+    signals:
+        // `hash` is calculated from the written (i.e. decompressed) data, `errorString` is empty on success
+        void finished(const Path &filePath, const QByteArray &hash, const QString &errorString);
+
+    private:
+        bool open();
+
+        const Path m_destinationPath;
+        std::unique_ptr<QFileDevice> m_file;
+        std::unique_ptr<Utils::Gzip::StreamDecompressor> m_decompressor;
+        std::unique_ptr<QCryptographicHash> m_hash;
+        QString m_errorString;
+        bool m_hasData = false;
+    };
+}
@@ -30,16 +30,16 @@
 #include "downloadhandlerimpl.h"
 
 #include <QtSystemDetection>
+#include <QCryptographicHash>
+#include <QThread>
 #include <QUrl>
 
 #include "base/3rdparty/expected.hpp"
 #include "base/utils/fs.h"
+#include "base/utils/gzip.h"
 #include "base/utils/io.h"
 #include "base/utils/misc.h"
-
-#ifdef QT_NO_COMPRESS
-#include "base/utils/gzip.h"
-#endif
+#include "downloadfilewriter.h"
 
 #if defined(Q_OS_MACOS) || defined(Q_OS_WIN)
 #include "base/preferences.h"
@@ -48,10 +48,23 @@
 
 const int MAX_REDIRECTIONS = 20;  // the common value for web browsers
 
+namespace
+{
+    void applyMarkOfTheWeb([[maybe_unused]] const Path &filePath, [[maybe_unused]] const QString &url)
+    {
+#if defined(Q_OS_MACOS) || defined(Q_OS_WIN)
+        if (Preferences::instance()->isMarkOfTheWebEnabled())
+            Utils::OS::applyMarkOfTheWeb(filePath, url);
+#endif // Q_OS_MACOS || Q_OS_WIN
+    }
+}
+
 Net::DownloadHandlerImpl::DownloadHandlerImpl(DownloadManager *manager
-        , const DownloadRequest &downloadRequest, const bool useProxy)
+        , const DownloadRequest &downloadRequest, const bool useProxy, QThread *fileWritingThread)
     : DownloadHandler {manager}
     , m_manager {manager}
+    , m_fileWritingThread {fileWritingThread}
+    , m_canStreamToFile {downloadRequest.saveToFile() && downloadRequest.streamToFile()}
     , m_downloadRequest {downloadRequest}
     , m_useProxy {useProxy}
 {
@@ -89,6 +102,8 @@ void Net::DownloadHandlerImpl::assignNetworkReply(QNetworkReply *reply)
     m_reply->setParent(this);
     if (m_downloadRequest.limit() > 0)
         connect(m_reply, &QNetworkReply::downloadProgress, this, &DownloadHandlerImpl::checkDownloadSize);
+    if (m_canStreamToFile)
+        connect(m_reply, &QIODevice::readyRead, this, &DownloadHandlerImpl::processReceivedData);
     connect(m_reply, &QNetworkReply::finished, this, &DownloadHandlerImpl::processFinishedDownload);
 }
 
@@ -113,6 +128,51 @@ bool Net::DownloadHandlerImpl::useProxy() const
     return m_useProxy;
 }
 
+void Net::DownloadHandlerImpl::processReceivedData()
+{
+    if (!m_fileWriter)
+    {
+        if (!m_canStreamToFile)
+            return;
+
+        // Only the content of successful response is streamed, the other ones
+        // (e.g. redirections) are left to be processed when the reply is finished
+        const QVariant httpStatusCode = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+        if ((m_reply->error() != QNetworkReply::NoError)
+                || m_reply->attribute(QNetworkRequest::RedirectionTargetAttribute).isValid()
+                || (httpStatusCode.isValid() && ((httpStatusCode.toInt() < 200) || (httpStatusCode.toInt() >= 300))))
+        {
+            m_canStreamToFile = false;
+            return;
+        }
+
+        bool decompress = m_downloadRequest.decompress();
+#ifdef QT_NO_COMPRESS
+        if (m_reply->rawHeader("Content-Encoding") == "gzip")
+        {
+            // Content requested to be decompressed is compressed twice then, so leave it to in-memory processing
+            if (decompress)
+            {
+                m_canStreamToFile = false;
+                return;
+            }
+
+            decompress = true;
+        }
+#endif
+
+        m_fileWriter = new DownloadFileWriter(m_downloadRequest.destFileName(), decompress, m_downloadRequest.hashAlgorithm());
+        m_fileWriter->moveToThread(m_fileWritingThread);
+        connect(m_fileWritingThread, &QThread::finished, m_fileWriter, &QObject::deleteLater);
+        connect(m_fileWriter, &DownloadFileWriter::finished, this, &DownloadHandlerImpl::processWrittenFile);
+    }
+
+    QMetaObject::invokeMethod(m_fileWriter, [fileWriter = m_fileWriter, data = m_reply->readAll()]
+    {
+        fileWriter->write(data);
+    });
+}
+
 void Net::DownloadHandlerImpl::processFinishedDownload()
 {
     qDebug("Download finished: %s", qUtf8Printable(url()));
@@ -136,6 +196,22 @@ void Net::DownloadHandlerImpl::processFinishedDownload()
     }
 
     // Success
+    // Conditional requests may get "304 Not Modified" which has no body
+    m_result.httpStatusCode = m_reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    for (const QNetworkReply::RawHeaderPair &header : m_reply->rawHeaderPairs())
+        m_result.rawHeaders[header.first.toLower()] = header.second;
+
+    if (m_canStreamToFile)
+    {
+        // Write the rest of the data (if the body is empty, the file is created here)
+        processReceivedData();
+        if (m_fileWriter)
+        {
+            QMetaObject::invokeMethod(m_fileWriter, &DownloadFileWriter::finish);
+            return;
+        }
+    }
+
 #ifdef QT_NO_COMPRESS
     m_result.data = (m_reply->rawHeader("Content-Encoding") == "gzip")
                     ? Utils::Gzip::decompress(m_reply->readAll())
@@ -144,46 +220,91 @@ void Net::DownloadHandlerImpl::processFinishedDownload()
     m_result.data = m_reply->readAll();
 #endif
 
-    if (m_downloadRequest.saveToFile())
+    // Conditional requests may get "304 Not Modified" which has no body
+    if (m_downloadRequest.decompress() && !m_result.data.isEmpty())
     {
-        const Path destinationPath = m_downloadRequest.destFileName();
-        if (destinationPath.isEmpty())
+        bool ok = false;
+        m_result.data = Utils::Gzip::decompress(m_result.data, &ok);
+        if (!ok)
         {
-            const nonstd::expected<Path, QString> result = Utils::IO::saveToTempFile(m_result.data);
-            if (result)
-            {
-                m_result.filePath = result.value();
+            setError(tr("Couldn't decompress the downloaded data"));
+            finish();
+            return;
+        }
+    }
 
-#if defined(Q_OS_MACOS) || defined(Q_OS_WIN)
-                if (Preferences::instance()->isMarkOfTheWebEnabled())
-                    Utils::OS::applyMarkOfTheWeb(m_result.filePath, m_result.url);
-#endif // Q_OS_MACOS || Q_OS_WIN
-            }
-            else
-            {
-                setError(tr("I/O Error: %1").arg(result.error()));
-            }
+    if (const std::optional<QCryptographicHash::Algorithm> hashAlgorithm = m_downloadRequest.hashAlgorithm())
+        m_result.hash = QCryptographicHash::hash(m_result.data, *hashAlgorithm);
+
+    if (m_downloadRequest.saveToFile())
+        saveFile();
+
+    finish();
+}
+
+void Net::DownloadHandlerImpl::processWrittenFile(const Path &filePath, const QByteArray &hash, const QString &errorString)
+{
+    // the handler may be canceled while the file is being written
+    if (m_isFinished)
+        return;
+
+    m_fileWriter->deleteLater();
+    m_fileWriter = nullptr;
+
+    if (errorString.isEmpty())
+    {
+        m_result.filePath = filePath;
+        m_result.hash = hash;
+        applyMarkOfTheWeb(m_result.filePath, m_result.url);
+    }
+    else
+    {
+        setError(tr("I/O Error: %1").arg(errorString));
+    }
+
+    finish();
+}
+
+void Net::DownloadHandlerImpl::saveFile()
+{
+    const Path destinationPath = m_downloadRequest.destFileName();
+    if (destinationPath.isEmpty())
+    {
+        const nonstd::expected<Path, QString> result = Utils::IO::saveToTempFile(m_result.data);
+        if (result)
+        {
+            m_result.filePath = result.value();
+            applyMarkOfTheWeb(m_result.filePath, m_result.url);
         }
         else
         {
-            const nonstd::expected<void, QString> result = Utils::IO::saveToFile(destinationPath, m_result.data);
-            if (result)
-            {
-                m_result.filePath = destinationPath;
-
-#if defined(Q_OS_MACOS) || defined(Q_OS_WIN)
-                if (Preferences::instance()->isMarkOfTheWebEnabled())
-                    Utils::OS::applyMarkOfTheWeb(m_result.filePath, m_result.url);
-#endif // Q_OS_MACOS || Q_OS_WIN
-            }
-            else
-            {
-                setError(tr("I/O Error: %1").arg(result.error()));
-            }
+            setError(tr("I/O Error: %1").arg(result.error()));
+        }
+    }
+    else
+    {
+        const nonstd::expected<void, QString> result = Utils::IO::saveToFile(destinationPath, m_result.data);
+        if (result)
+        {
+            m_result.filePath = destinationPath;
+            applyMarkOfTheWeb(m_result.filePath, m_result.url);
+        }
+        else
+        {
+            setError(tr("I/O Error: %1").arg(result.error()));
         }
     }
+}
 
-    finish();
+void Net::DownloadHandlerImpl::discardFileWriter()
+{
+    if (!m_fileWriter)
+        return;
+
+    // the unfinished file is removed by the writer once it is destroyed
+    disconnect(m_fileWriter, nullptr, this, nullptr);
+    m_fileWriter->deleteLater();
+    m_fileWriter = nullptr;
 }
 
 void Net::DownloadHandlerImpl::checkDownloadSize(const qint64 bytesReceived, const qint64 bytesTotal)
@@ -248,6 +369,7 @@ void Net::DownloadHandlerImpl::setError(const QString &error)
 
 void Net::DownloadHandlerImpl::finish()
 {
+    discardFileWriter();
     m_isFinished = true;
     emit finished(m_result);
 }
@@ -34,17 +34,21 @@
 #include "base/net/downloadmanager.h"
 
 class QObject;
+class QThread;
 class QUrl;
 
 namespace Net
 {
+    class DownloadFileWriter;
+
     class DownloadHandlerImpl final : public DownloadHandler
     {
         Q_OBJECT
         Q_DISABLE_COPY_MOVE(DownloadHandlerImpl)
 
     public:
-        DownloadHandlerImpl(DownloadManager *manager, const DownloadRequest &downloadRequest, bool useProxy);
+        DownloadHandlerImpl(DownloadManager *manager, const DownloadRequest &downloadRequest, bool useProxy
+                , QThread *fileWritingThread);
 
         void cancel() override;
 
@@ -56,7 +60,11 @@ namespace Net
         QNetworkReply *assignedNetworkReply() const;
 
     private:
+        void processReceivedData();
         void processFinishedDownload();
+        void processWrittenFile(const Path &filePath, const QByteArray &hash, const QString &errorString);
+        void saveFile();
+        void discardFileWriter();
         void checkDownloadSize(qint64 bytesReceived, qint64 bytesTotal);
         void handleRedirection(const QUrl &newUrl);
         void setError(const QString &error);
@@ -65,7 +73,10 @@ namespace Net
         static QString errorCodeToString(QNetworkReply::NetworkError status);
 
         DownloadManager *m_manager = nullptr;
+        QThread *m_fileWritingThread = nullptr;
         QNetworkReply *m_reply = nullptr;
+        DownloadFileWriter *m_fileWriter = nullptr;
+        bool m_canStreamToFile = false;
         DownloadHandlerImpl *m_redirectionHandler = nullptr;
         const DownloadRequest m_downloadRequest;
         const bool m_useProxy = false;
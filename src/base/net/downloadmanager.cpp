@@ -42,6 +42,7 @@
 #include <QNetworkReply>
 #include <QNetworkRequest>
 #include <QSslError>
+#include <QThread>
 #include <QTimer>
 #include <QUrl>
 
@@ -140,7 +141,12 @@ Net::DownloadManager::DownloadManager(QObject *parent)
     : QObject(parent)
     , m_networkCookieJar {new NetworkCookieJar(this)}
     , m_networkManager {new QNetworkAccessManager(this)}
+    , m_fileWritingThread {new QThread}
 {
+    m_fileWritingThread->setObjectName("DownloadManager m_fileWritingThread");
+    Utils::Thread::setWorkload(m_fileWritingThread.get(), Utils::Thread::Workload::Bulk);
+    m_fileWritingThread->start();
+
     m_networkManager->setCookieJar(m_networkCookieJar);
     connect(m_networkManager, &QNetworkAccessManager::sslErrors, this
             , [](QNetworkReply *reply, const QList<QSslError> &errors)
@@ -167,7 +173,9 @@ Net::DownloadManager::DownloadManager(QObject *parent)
     connect(ProxyConfigurationManager::instance(), &ProxyConfigurationManager::proxyConfigurationChanged
             , this, &DownloadManager::applyProxySettings);
     connect(Preferences::instance(), &Preferences::changed, this, &DownloadManager::applyProxySettings);
+    connect(Preferences::instance(), &Preferences::changed, this, &DownloadManager::applyMaxDownloadsPerService);
     applyProxySettings();
+    applyMaxDownloadsPerService();
 }
 
 void Net::DownloadManager::initInstance()
@@ -191,32 +199,35 @@ Net::DownloadHandler *Net::DownloadManager::download(const DownloadRequest &down
 {
     // Process download request
     const auto serviceID = ServiceID::fromURL(downloadRequest.url());
-    const bool isSequentialService = m_sequentialServices.contains(serviceID);
 
-    auto *downloadHandler = new DownloadHandlerImpl(this, downloadRequest, useProxy);
+    auto *downloadHandler = new DownloadHandlerImpl(this, downloadRequest, useProxy, m_fileWritingThread.get());
     connect(downloadHandler, &DownloadHandler::finished, this, [this, serviceID, downloadHandler]
     {
         if (!downloadHandler->assignedNetworkReply())
         {
             // DownloadHandler was finished (canceled) before QNetworkReply was assigned,
             // so it's still in the queue. Just remove it from there.
-            m_waitingJobs[serviceID].removeOne(downloadHandler);
+            if (const auto waitingJobsIter = m_waitingJobs.find(serviceID); waitingJobsIter != m_waitingJobs.end())
+            {
+                waitingJobsIter.value().removeOne(downloadHandler);
+                if (waitingJobsIter.value().isEmpty())
+                    m_waitingJobs.erase(waitingJobsIter);
+            }
         }
 
         downloadHandler->deleteLater();
     });
 
-    if (isSequentialService && m_busyServices.contains(serviceID))
+    // Put the request after the waiting requests of the same or higher priority
+    QQueue<DownloadHandlerImpl *> &waitingJobs = m_waitingJobs[serviceID];
+    const DownloadPriority priority = downloadRequest.priority();
+    const auto pos = std::ranges::find_if(waitingJobs, [priority](const DownloadHandlerImpl *job)
     {
-        m_waitingJobs[serviceID].enqueue(downloadHandler);
-    }
-    else
-    {
-        qDebug("Downloading %s...", qUtf8Printable(downloadRequest.url()));
-        if (isSequentialService)
-            m_busyServices.insert(serviceID);
-        processRequest(downloadHandler);
-    }
+        return (job->downloadRequest().priority() < priority);
+    });
+    waitingJobs.insert(pos, downloadHandler);
+
+    processWaitingJobs(serviceID);
 
     return downloadHandler;
 }
@@ -298,19 +309,47 @@ void Net::DownloadManager::applyProxySettings()
     };
 }
 
+void Net::DownloadManager::applyMaxDownloadsPerService()
+{
+    const int maxDownloadsPerService = Preferences::instance()->maxDownloadsPerHost();
+    if (maxDownloadsPerService == m_maxDownloadsPerService)
+        return;
+
+    m_maxDownloadsPerService = maxDownloadsPerService;
+    for (const ServiceID &serviceID : asConst(m_waitingJobs.keys()))
+        processWaitingJobs(serviceID);
+}
+
+// Requests are limited per service so that the excess ones wait here instead of timing out
+// while they are queued inside QNetworkAccessManager
 void Net::DownloadManager::processWaitingJobs(const ServiceID &serviceID)
 {
-    const auto waitingJobsIter = m_waitingJobs.find(serviceID);
-    if ((waitingJobsIter == m_waitingJobs.end()) || waitingJobsIter.value().isEmpty())
+    const int maxActiveDownloads = m_sequentialServices.contains(serviceID) ? 1 : m_maxDownloadsPerService;
+    while (m_activeDownloads.value(serviceID) < maxActiveDownloads)
     {
-        // No more waiting jobs for given ServiceID
-        m_busyServices.remove(serviceID);
-        return;
+        const auto waitingJobsIter = m_waitingJobs.find(serviceID);
+        if (waitingJobsIter == m_waitingJobs.end())
+            break;
+
+        auto *handler = waitingJobsIter.value().dequeue();
+        if (waitingJobsIter.value().isEmpty())
+            m_waitingJobs.erase(waitingJobsIter);
+
+        ++m_activeDownloads[serviceID];
+        qDebug("Downloading %s...", qUtf8Printable(handler->url()));
+        processRequest(handler);
+    }
+}
+
+void Net::DownloadManager::handleRequestFinished(const ServiceID &serviceID)
+{
+    if (const auto activeDownloadsIter = m_activeDownloads.find(serviceID); activeDownloadsIter != m_activeDownloads.end())
+    {
+        if (--activeDownloadsIter.value() <= 0)
+            m_activeDownloads.erase(activeDownloadsIter);
     }
 
-    auto *handler = waitingJobsIter.value().dequeue();
-    qDebug("Downloading %s...", qUtf8Printable(handler->url()));
-    processRequest(handler);
+    processWaitingJobs(serviceID);
 }
 
 void Net::DownloadManager::processRequest(DownloadHandlerImpl *downloadHandler)
@@ -330,15 +369,30 @@ void Net::DownloadManager::processRequest(DownloadHandlerImpl *downloadHandler)
     // gzip encoding and manually decompress the reply data.
     request.setRawHeader("Accept-Encoding", "gzip");
 #endif
+    const QHash<QByteArray, QByteArray> rawHeaders = downloadRequest.rawHeaders();
+    for (auto it = rawHeaders.cbegin(); it != rawHeaders.cend(); ++it)
+        request.setRawHeader(it.key(), it.value());
     // Qt doesn't support Magnet protocol so we need to handle redirections manually
     request.setAttribute(QNetworkRequest::RedirectPolicyAttribute, QNetworkRequest::ManualRedirectPolicy);
 
     request.setTransferTimeout();
+    // Allows multiplexing requests to the same host over a single connection if the server supports it
+    request.setAttribute(QNetworkRequest::Http2AllowedAttribute, true);
 
-    QNetworkReply *reply = m_networkManager->get(request);
+    QNetworkReply *reply = nullptr;
+    if (const QByteArray postData = downloadRequest.postData(); !postData.isNull())
+    {
+        if (!rawHeaders.contains("Content-Type"))
+            request.setHeader(QNetworkRequest::ContentTypeHeader, u"application/x-www-form-urlencoded"_s);
+        reply = m_networkManager->post(request, postData);
+    }
+    else
+    {
+        reply = m_networkManager->get(request);
+    }
     connect(reply, &QNetworkReply::finished, this, [this, serviceID = ServiceID::fromURL(downloadHandler->url())]
     {
-        QTimer::singleShot(m_sequentialServices.value(serviceID, 0s), this, [this, serviceID] { processWaitingJobs(serviceID); });
+        QTimer::singleShot(m_sequentialServices.value(serviceID, 0s), this, [this, serviceID] { handleRequestFinished(serviceID); });
     });
     downloadHandler->assignNetworkReply(reply);
 }
@@ -403,6 +457,72 @@ Net::DownloadRequest &Net::DownloadRequest::destFileName(const Path &value)
     return *this;
 }
 
+bool Net::DownloadRequest::streamToFile() const
+{
+    return m_streamToFile;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::streamToFile(const bool value)
+{
+    m_streamToFile = value;
+    return *this;
+}
+
+bool Net::DownloadRequest::decompress() const
+{
+    return m_decompress;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::decompress(const bool value)
+{
+    m_decompress = value;
+    return *this;
+}
+
+std::optional<QCryptographicHash::Algorithm> Net::DownloadRequest::hashAlgorithm() const
+{
+    return m_hashAlgorithm;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::hashAlgorithm(const QCryptographicHash::Algorithm value)
+{
+    m_hashAlgorithm = value;
+    return *this;
+}
+
+Net::DownloadPriority Net::DownloadRequest::priority() const
+{
+    return m_priority;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::priority(const DownloadPriority value)
+{
+    m_priority = value;
+    return *this;
+}
+
+QHash<QByteArray, QByteArray> Net::DownloadRequest::rawHeaders() const
+{
+    return m_rawHeaders;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::rawHeader(const QByteArray &name, const QByteArray &value)
+{
+    m_rawHeaders[name] = value;
+    return *this;
+}
+
+QByteArray Net::DownloadRequest::postData() const
+{
+    return m_postData;
+}
+
+Net::DownloadRequest &Net::DownloadRequest::postData(const QByteArray &value)
+{
+    m_postData = value;
+    return *this;
+}
+
 Net::ServiceID Net::ServiceID::fromURL(const QUrl &url)
 {
     return {url.host(), url.port(80)};
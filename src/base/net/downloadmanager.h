@@ -31,8 +31,10 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
 
 #include <QtTypes>
+#include <QCryptographicHash>
 #include <QHash>
 #include <QNetworkProxy>
 #include <QObject>
@@ -40,6 +42,7 @@
 #include <QSet>
 
 #include "base/path.h"
+#include "base/utils/thread.h"
 
 class QNetworkAccessManager;
 class QNetworkCookie;
@@ -67,6 +70,14 @@ namespace Net
         Failed
     };
 
+    // Waiting requests of the same service are started in order of their priority
+    enum class DownloadPriority
+    {
+        Low,
+        Normal,
+        High
+    };
+
     class DownloadRequest
     {
     public:
@@ -91,12 +102,42 @@ namespace Net
         Path destFileName() const;
         DownloadRequest &destFileName(const Path &value);
 
+        // if it is set along with saveToFile, the data is written to the file in a worker thread
+        // as it arrives instead of being accumulated in memory (DownloadResult::data is left empty)
+        bool streamToFile() const;
+        DownloadRequest &streamToFile(bool value);
+
+        // if it is set, the gzip (or zlib) compressed content is decompressed
+        bool decompress() const;
+        DownloadRequest &decompress(bool value);
+
+        // if it is set, the hash of the (decompressed) content is provided in DownloadResult::hash
+        std::optional<QCryptographicHash::Algorithm> hashAlgorithm() const;
+        DownloadRequest &hashAlgorithm(QCryptographicHash::Algorithm value);
+
+        DownloadPriority priority() const;
+        DownloadRequest &priority(DownloadPriority value);
+
+        // additional headers to send with the request (e.g. conditional request validators)
+        QHash<QByteArray, QByteArray> rawHeaders() const;
+        DownloadRequest &rawHeader(const QByteArray &name, const QByteArray &value);
+
+        // if it isn't null, the request is sent using POST method with the data as form parameters
+        QByteArray postData() const;
+        DownloadRequest &postData(const QByteArray &value);
+
     private:
         QString m_url;
         QString m_userAgent;
         qint64 m_limit = 0;
         bool m_saveToFile = false;
         Path m_destFileName;
+        bool m_streamToFile = false;
+        bool m_decompress = false;
+        std::optional<QCryptographicHash::Algorithm> m_hashAlgorithm;
+        DownloadPriority m_priority = DownloadPriority::Normal;
+        QHash<QByteArray, QByteArray> m_rawHeaders;
+        QByteArray m_postData;
     };
 
     struct DownloadResult
@@ -106,7 +147,11 @@ namespace Net
         QString errorString;
         QByteArray data;
         Path filePath;
+        QByteArray hash;
         QString magnetURI;
+        int httpStatusCode = 0;
+        // response header names are lowercase
+        QHash<QByteArray, QByteArray> rawHeaders;
     };
 
     class DownloadHandler : public QObject
@@ -156,17 +201,22 @@ namespace Net
         explicit DownloadManager(QObject *parent = nullptr);
 
         void applyProxySettings();
+        void applyMaxDownloadsPerService();
         void processWaitingJobs(const ServiceID &serviceID);
         void processRequest(DownloadHandlerImpl *downloadHandler);
+        void handleRequestFinished(const ServiceID &serviceID);
 
         static DownloadManager *m_instance;
         NetworkCookieJar *m_networkCookieJar = nullptr;
         QNetworkAccessManager *m_networkManager = nullptr;
         QNetworkProxy m_proxy;
+        Utils::Thread::UniquePtr m_fileWritingThread;
 
         // m_sequentialServices value is delay for same host requests
         QHash<ServiceID, std::chrono::seconds> m_sequentialServices;
-        QSet<ServiceID> m_busyServices;
+        // Number of requests that can be processed simultaneously for the same host (sequential services allow one)
+        int m_maxDownloadsPerService = 0;
+        QHash<ServiceID, int> m_activeDownloads;
         QHash<ServiceID, QQueue<DownloadHandlerImpl *>> m_waitingJobs;
     };
 
@@ -0,0 +1,395 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "faviconcache.h"
+
+#include <algorithm>
+#include <optional>
+
+#include <QCryptographicHash>
+#include <QHostAddress>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
+#include <QThread>
+#include <QTimer>
+
+#include "base/asyncfilestorage.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/preferences.h"
+#include "base/profile.h"
+#include "base/utils/fs.h"
+#include "base/utils/io.h"
+#include "downloadmanager.h"
+
+using namespace std::chrono_literals;
+
+const QString FAVICONS_FOLDER = u"favicons"_s;
+const QString INDEX_FILE_NAME = u"index.json"_s;
+const int MAX_INDEX_FILE_SIZE = 10 * 1024 * 1024;
+const std::chrono::seconds STORING_DELAY {5};
+
+const std::chrono::seconds DEFAULT_LIFETIME = 7 * 24h;
+const std::chrono::seconds MIN_LIFETIME = 24h;
+const std::chrono::seconds MAX_LIFETIME = 30 * 24h;
+// The hosts that have no icon (or couldn't be reached) are asked again after it
+const std::chrono::seconds RETRY_INTERVAL = 24h;
+// The icons of the hosts that aren't used by any torrent for so long are discarded
+const int UNUSED_ENTRY_LIFETIME_DAYS = 90;
+
+const QString KEY_FILE_NAME = u"file_name"_s;
+const QString KEY_URL = u"url"_s;
+const QString KEY_ETAG = u"etag"_s;
+const QString KEY_LAST_MODIFIED = u"last_modified"_s;
+const QString KEY_EXPIRATION_TIME = u"expiration_time"_s;
+const QString KEY_ACCESS_TIME = u"access_time"_s;
+
+using namespace Net;
+
+namespace
+{
+    Path cacheFolderPath()
+    {
+        return specialFolderLocation(SpecialFolder::Cache) / Path(FAVICONS_FOLDER);
+    }
+
+    QString makeFileName(const QString &host)
+    {
+        return QString::fromLatin1(QCryptographicHash::hash(host.toUtf8(), QCryptographicHash::Sha1).toHex());
+    }
+}
+
+FaviconCache *FaviconCache::m_instance = nullptr;
+
+void FaviconCache::initInstance()
+{
+    if (!m_instance)
+        m_instance = new FaviconCache;
+}
+
+void FaviconCache::freeInstance()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+FaviconCache *FaviconCache::instance()
+{
+    return m_instance;
+}
+
+FaviconCache::FaviconCache()
+    : m_ioThread {new QThread}
+    , m_fileStorage {new AsyncFileStorage(cacheFolderPath())}
+    , m_storingTimer {new QTimer(this)}
+{
+    m_storingTimer->setSingleShot(true);
+    m_storingTimer->setInterval(STORING_DELAY);
+    connect(m_storingTimer, &QTimer::timeout, this, &FaviconCache::store);
+
+    m_fileStorage->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_fileStorage, &QObject::deleteLater);
+    connect(m_fileStorage, &AsyncFileStorage::failed, this, [](const Path &filePath, const QString &errorString)
+    {
+        LogMsg(tr("Couldn't store favicon cache data to %1. Error: %2")
+            .arg(filePath.toString(), errorString), Log::WARNING);
+    });
+
+    m_ioThread->setObjectName("FaviconCache m_ioThread");
+    Utils::Thread::setWorkload(m_ioThread.get(), Utils::Thread::Workload::Bulk);
+    m_ioThread->start();
+
+    load();
+}
+
+FaviconCache::~FaviconCache()
+{
+    // it is written by IO thread which is stopped after all the other jobs are processed
+    if (m_storingTimer->isActive())
+        store();
+}
+
+Path FaviconCache::iconPath(const QString &host) const
+{
+    const auto entryIter = m_entries.constFind(host);
+    if ((entryIter == m_entries.cend()) || entryIter->fileName.isEmpty())
+        return {};
+
+    return m_fileStorage->storageDir() / Path(entryIter->fileName);
+}
+
+void FaviconCache::fetchIcon(const QString &host, const QString &scheme)
+{
+    if (host.isEmpty())
+        return;
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    if (const auto entryIter = m_entries.find(host); entryIter != m_entries.end())
+    {
+        if (entryIter->accessTime.daysTo(now) > 0)
+        {
+            entryIter->accessTime = now;
+            storeDeferred();
+        }
+
+        if (entryIter->expirationTime > now)
+            return;
+    }
+
+    if (m_downloadingHosts.contains(host))
+        return;
+
+    m_downloadingHosts.insert(host);
+
+    // Start from the URL the icon was provided by last time
+    const QString knownURL = m_entries.value(host).url;
+    download(host, (!knownURL.isEmpty()
+            ? knownURL : u"%1://%2/favicon.ico"_s.arg((scheme.startsWith(u"http") ? scheme : u"http"_s), host)));
+}
+
+QString FaviconCache::faviconHost(const QString &trackerHost)
+{
+    if (!QHostAddress(trackerHost).isNull())
+        return trackerHost;
+
+    return trackerHost.section(u'.', -2, -1);
+}
+
+QString FaviconCache::imageMimeType(const QByteArray &data)
+{
+    if (data.startsWith(QByteArrayView("\x00\x00\x01\x00", 4)))
+        return u"image/x-icon"_s;
+    if (data.startsWith("\x89PNG\r\n\x1A\n"))
+        return u"image/png"_s;
+    if (data.startsWith("GIF87a") || data.startsWith("GIF89a"))
+        return u"image/gif"_s;
+    if (data.startsWith("\xFF\xD8\xFF"))
+        return u"image/jpeg"_s;
+    if (data.startsWith("BM"))
+        return u"image/bmp"_s;
+    if ((data.size() >= 12) && data.startsWith("RIFF") && (data.sliced(8, 4) == "WEBP"))
+        return u"image/webp"_s;
+
+    // Servers often reply with an HTML page instead of the missing icon
+    return {};
+}
+
+std::chrono::seconds FaviconCache::lifetime(const QHash<QByteArray, QByteArray> &headers, const QDateTime &now)
+{
+    std::optional<std::chrono::seconds> serverLifetime;
+
+    const QList<QByteArray> directives = headers.value("cache-control").split(',');
+    for (const QByteArray &directive : directives)
+    {
+        const QByteArray trimmedDirective = directive.trimmed().toLower();
+        if ((trimmedDirective == "no-cache") || (trimmedDirective == "no-store"))
+        {
+            serverLifetime = 0s;
+            break;
+        }
+
+        if (trimmedDirective.startsWith("max-age="))
+        {
+            bool ok = false;
+            const qint64 maxAge = trimmedDirective.sliced(8).toLongLong(&ok);
+            if (ok && (maxAge >= 0))
+                serverLifetime = std::chrono::seconds(maxAge);
+        }
+    }
+
+    if (!serverLifetime)
+    {
+        // HTTP dates are always in GMT which Qt expects to be written as an offset
+        QString expires = QString::fromLatin1(headers.value("expires")).trimmed();
+        if (expires.endsWith(u" GMT"))
+            expires = expires.chopped(4) + u" +0000";
+
+        if (const QDateTime expirationTime = QDateTime::fromString(expires, Qt::RFC2822Date); expirationTime.isValid())
+            serverLifetime = std::chrono::seconds(std::max<qint64>(0, now.secsTo(expirationTime)));
+    }
+
+    // The icons rarely change so they aren't revalidated too frequently even if the server asks for it
+    return std::clamp(serverLifetime.value_or(DEFAULT_LIFETIME), MIN_LIFETIME, MAX_LIFETIME);
+}
+
+void FaviconCache::download(const QString &host, const QString &url)
+{
+    DownloadRequest request {url};
+    request.limit(MAX_FAVICON_SIZE).priority(DownloadPriority::Low);
+
+    // Ask the server to send the icon only if it was changed since it was cached
+    if (const auto entryIter = m_entries.constFind(host)
+            ; (entryIter != m_entries.cend()) && !entryIter->fileName.isEmpty() && (entryIter->url == url))
+    {
+        if (!entryIter->eTag.isEmpty())
+            request.rawHeader("If-None-Match", entryIter->eTag.toLatin1());
+        if (!entryIter->lastModified.isEmpty())
+            request.rawHeader("If-Modified-Since", entryIter->lastModified.toLatin1());
+    }
+
+    DownloadManager::instance()->download(request, Preferences::instance()->useProxyForGeneralPurposes()
+            , this, [this, host](const DownloadResult &result)
+    {
+        handleDownloadFinished(host, result);
+    });
+}
+
+void FaviconCache::handleDownloadFinished(const QString &host, const DownloadResult &result)
+{
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    CacheEntry &entry = m_entries[host];
+    if (!entry.accessTime.isValid())
+        entry.accessTime = now;
+
+    if (result.status == DownloadStatus::Success)
+    {
+        if ((result.httpStatusCode == 304) && !entry.fileName.isEmpty())
+        {
+            m_downloadingHosts.remove(host);
+            entry.expirationTime = now.addSecs(lifetime(result.rawHeaders, now).count());
+            storeDeferred();
+            return;
+        }
+
+        if (!imageMimeType(result.data).isEmpty())
+        {
+            m_downloadingHosts.remove(host);
+            entry.fileName = makeFileName(host);
+            entry.url = result.url;
+            entry.eTag = QString::fromLatin1(result.rawHeaders.value("etag"));
+            entry.lastModified = QString::fromLatin1(result.rawHeaders.value("last-modified"));
+            entry.expirationTime = now.addSecs(lifetime(result.rawHeaders, now).count());
+            m_fileStorage->store(Path(entry.fileName), result.data);
+            storeDeferred();
+
+            emit iconUpdated(host, result.data);
+            return;
+        }
+    }
+
+    // Some hosts provide PNG icon only
+    if (result.url.endsWith(u".ico", Qt::CaseInsensitive))
+    {
+        download(host, (QStringView(result.url).chopped(4) + u".png"));
+        return;
+    }
+
+    // The icon that is already cached (if any) is still used,
+    // the next attempt starts from the default URL again
+    m_downloadingHosts.remove(host);
+    entry.url.clear();
+    entry.eTag.clear();
+    entry.lastModified.clear();
+    entry.expirationTime = now.addSecs(RETRY_INTERVAL.count());
+    storeDeferred();
+}
+
+void FaviconCache::load()
+{
+    const Path path = m_fileStorage->storageDir() / Path(INDEX_FILE_NAME);
+
+    const auto readResult = Utils::IO::readFile(path, MAX_INDEX_FILE_SIZE);
+    if (!readResult)
+    {
+        if (readResult.error().status != Utils::IO::ReadError::NotExist)
+            LogMsg(tr("Failed to load favicon cache. %1").arg(readResult.error().message), Log::WARNING);
+        return;
+    }
+
+    QJsonParseError jsonError;
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(readResult.value(), &jsonError);
+    if ((jsonError.error != QJsonParseError::NoError) || !jsonDoc.isObject())
+    {
+        LogMsg(tr("Failed to parse favicon cache from %1. The cache is discarded.").arg(path.toString()), Log::WARNING);
+        return;
+    }
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    PathList unusedFiles;
+    const QJsonObject jsonObj = jsonDoc.object();
+    for (auto it = jsonObj.constBegin(); it != jsonObj.constEnd(); ++it)
+    {
+        const QJsonObject entryObj = it.value().toObject();
+        const CacheEntry entry
+        {
+            .fileName = entryObj.value(KEY_FILE_NAME).toString(),
+            .url = entryObj.value(KEY_URL).toString(),
+            .eTag = entryObj.value(KEY_ETAG).toString(),
+            .lastModified = entryObj.value(KEY_LAST_MODIFIED).toString(),
+            .expirationTime = QDateTime::fromSecsSinceEpoch(entryObj.value(KEY_EXPIRATION_TIME).toInteger()),
+            .accessTime = QDateTime::fromSecsSinceEpoch(entryObj.value(KEY_ACCESS_TIME).toInteger())
+        };
+
+        if (entry.accessTime.daysTo(now) > UNUSED_ENTRY_LIFETIME_DAYS)
+        {
+            if (!entry.fileName.isEmpty())
+                unusedFiles.append(m_fileStorage->storageDir() / Path(entry.fileName));
+            continue;
+        }
+
+        m_entries.insert(it.key(), entry);
+    }
+
+    if (m_entries.size() < jsonObj.size())
+    {
+        QMetaObject::invokeMethod(m_fileStorage, [unusedFiles]
+        {
+            for (const Path &filePath : unusedFiles)
+                Utils::Fs::removeFile(filePath);
+        });
+        storeDeferred();
+    }
+}
+
+void FaviconCache::store()
+{
+    m_storingTimer->stop();
+
+    QJsonObject jsonObj;
+    for (auto it = m_entries.cbegin(); it != m_entries.cend(); ++it)
+    {
+        const CacheEntry &entry = it.value();
+        jsonObj[it.key()] = QJsonObject {
+            {KEY_FILE_NAME, entry.fileName},
+            {KEY_URL, entry.url},
+            {KEY_ETAG, entry.eTag},
+            {KEY_LAST_MODIFIED, entry.lastModified},
+            {KEY_EXPIRATION_TIME, entry.expirationTime.toSecsSinceEpoch()},
+            {KEY_ACCESS_TIME, entry.accessTime.toSecsSinceEpoch()}
+        };
+    }
+
+    m_fileStorage->store(Path(INDEX_FILE_NAME), QJsonDocument(jsonObj).toJson(QJsonDocument::Compact));
+}
+
+void FaviconCache::storeDeferred()
+{
+    if (!m_storingTimer->isActive())
+        m_storingTimer->start();
+}
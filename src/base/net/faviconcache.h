@@ -0,0 +1,109 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include <QtContainerFwd>
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QSet>
+#include <QString>
+
+#include "base/path.h"
+#include "base/utils/thread.h"
+
+class QTimer;
+
+class AsyncFileStorage;
+
+namespace Net
+{
+    struct DownloadResult;
+
+    inline const int MAX_FAVICON_SIZE = 1024 * 1024;
+
+    // Keeps the favicons of the tracker hosts on disk, so they aren't downloaded again on each start.
+    // The cached icons are revalidated using conditional requests once they are expired.
+    class FaviconCache final : public QObject
+    {
+        Q_OBJECT
+        Q_DISABLE_COPY_MOVE(FaviconCache)
+
+    public:
+        static void initInstance();
+        static void freeInstance();
+        static FaviconCache *instance();
+
+        // It is empty if there is no icon cached for the host
+        Path iconPath(const QString &host) const;
+        // Downloads the icon of the host if it isn't cached yet or the cached one is expired,
+        // `iconUpdated()` is emitted once the new icon is available
+        void fetchIcon(const QString &host, const QString &scheme);
+
+        // The icon is usually shared by all the subdomains, so it is cached for the registered domain
+        static QString faviconHost(const QString &trackerHost);
+        // It is empty if the data isn't in one of the image formats used for favicons
+        static QString imageMimeType(const QByteArray &data);
+        // How long a downloaded icon can be used before it is revalidated, `headers` names are lowercase
+        static std::chrono::seconds lifetime(const QHash<QByteArray, QByteArray> &headers, const QDateTime &now);
+
+    signals:
+        void iconUpdated(const QString &host, const QByteArray &data);
+
+    private:
+        struct CacheEntry
+        {
+            QString fileName;  // it is empty if the host has no icon
+            QString url;
+            QString eTag;
+            QString lastModified;
+            QDateTime expirationTime;
+            QDateTime accessTime;
+        };
+
+        FaviconCache();
+        ~FaviconCache() override;
+
+        void download(const QString &host, const QString &url);
+        void handleDownloadFinished(const QString &host, const DownloadResult &result);
+        void load();
+        void store();
+        void storeDeferred();
+
+        static FaviconCache *m_instance;
+
+        Utils::Thread::UniquePtr m_ioThread;
+        AsyncFileStorage *m_fileStorage = nullptr;
+        QTimer *m_storingTimer = nullptr;
+        QHash<QString, CacheEntry> m_entries;  // <host, cache entry>
+        QSet<QString> m_downloadingHosts;
+    };
+}
@@ -33,10 +33,12 @@
 #include <QDebug>
 #include <QFile>
 #include <QHostAddress>
+#include <QMutexLocker>
 #include <QVariant>
 
 #include "base/global.h"
 #include "base/path.h"
+#include "base/utils/memory.h"
 
 namespace
 {
@@ -44,6 +46,7 @@ namespace
     const quint32 MAX_METADATA_SIZE = 131072; // 128KB
     const QByteArray METADATA_BEGIN_MARK = QByteArrayLiteral("\xab\xcd\xefMaxMind.com");
     const char DATA_SECTION_SEPARATOR[16] = {0};
+    const quint32 IPV4_RECORDS_COUNT = 65536; // one record per /16 network
 
     enum class DataType
     {
@@ -76,44 +79,43 @@ struct DataFieldDescriptor
     };
 };
 
-GeoIPDatabase::GeoIPDatabase(const quint32 size)
-    : m_size(size)
-    , m_data(new uchar[size])
-{
-}
-
 GeoIPDatabase *GeoIPDatabase::load(const Path &filename, QString &error)
 {
-    QFile file {filename.data()};
-    if (file.size() > MAX_FILE_SIZE)
+    auto file = std::make_unique<QFile>(filename.data());
+    if (file->size() > MAX_FILE_SIZE)
     {
         error = tr("Unsupported database file size.");
         return nullptr;
     }
 
-    if (!file.open(QFile::ReadOnly))
+    if (!file->open(QFile::ReadOnly))
     {
-        error = file.errorString();
+        error = file->errorString();
         return nullptr;
     }
 
-    auto *db = new GeoIPDatabase(file.size());
-
-    if (file.read(reinterpret_cast<char *>(db->m_data), db->m_size) != db->m_size)
+    auto db = std::unique_ptr<GeoIPDatabase>(new GeoIPDatabase);
+    db->m_size = file->size();
+    // The database is read-only, so it can be used directly from the mapped file
+    // and its pages are shared with the system file cache
+    if (const uchar *data = file->map(0, db->m_size))
     {
-        error = file.errorString();
-        delete db;
-        return nullptr;
+        db->m_data = data;
+        db->m_file = std::move(file);
     }
-
-
-    if (!db->parseMetadata(db->readMetadata(), error) || !db->loadDB(error))
+    else
     {
-        delete db;
-        return nullptr;
+        db->m_buffer = file->readAll();
+        if (db->m_buffer.size() != static_cast<qsizetype>(db->m_size))
+        {
+            error = file->errorString();
+            return nullptr;
+        }
+
+        db->m_data = reinterpret_cast<const uchar *>(db->m_buffer.constData());
     }
 
-    return db;
+    return create(std::move(db), error);
 }
 
 GeoIPDatabase *GeoIPDatabase::load(const QByteArray &data, QString &error)
@@ -124,23 +126,23 @@ GeoIPDatabase *GeoIPDatabase::load(const QByteArray &data, QString &error)
         return nullptr;
     }
 
-    auto *db = new GeoIPDatabase(data.size());
+    auto db = std::unique_ptr<GeoIPDatabase>(new GeoIPDatabase);
+    db->m_buffer = data;
+    db->m_size = data.size();
+    db->m_data = reinterpret_cast<const uchar *>(db->m_buffer.constData());
 
-    memcpy(reinterpret_cast<char *>(db->m_data), data.constData(), db->m_size);
+    return create(std::move(db), error);
+}
 
+GeoIPDatabase *GeoIPDatabase::create(std::unique_ptr<GeoIPDatabase> db, QString &error)
+{
     if (!db->parseMetadata(db->readMetadata(), error) || !db->loadDB(error))
-    {
-        delete db;
         return nullptr;
-    }
 
-    return db;
+    return db.release();
 }
 
-GeoIPDatabase::~GeoIPDatabase()
-{
-    delete [] m_data;
-}
+GeoIPDatabase::~GeoIPDatabase() = default;
 
 QString GeoIPDatabase::type() const
 {
@@ -157,52 +159,79 @@ QDateTime GeoIPDatabase::buildEpoch() const
     return m_buildEpoch;
 }
 
+qint64 GeoIPDatabase::estimatedMemoryUsage() const
+{
+    const QMutexLocker locker {&m_countriesMutex};
+
+    qint64 size = m_size + static_cast<qint64>(m_ipv4Records.size() * sizeof(quint32))
+        + static_cast<qint64>(m_countries.size() * (sizeof(quint32) + sizeof(QString)));
+    for (const QString &country : asConst(m_countries))
+        size += Utils::Memory::estimateHeapSize(country);
+
+    return size;
+}
+
 QString GeoIPDatabase::lookup(const QHostAddress &hostAddr) const
 {
-    Q_IPV6ADDR addr = hostAddr.toIPv6Address();
+    bool isIPv4 = false;
+    const quint32 ipv4Addr = hostAddr.toIPv4Address(&isIPv4);
+    if (isIPv4)
+    {
+        const uchar addr[4] {static_cast<uchar>(ipv4Addr >> 24), static_cast<uchar>(ipv4Addr >> 16)
+            , static_cast<uchar>(ipv4Addr >> 8), static_cast<uchar>(ipv4Addr)};
+        return countryFromRecord(findRecord(m_ipv4Records[ipv4Addr >> 16], addr, 16, 32));
+    }
+
+    const Q_IPV6ADDR addr = hostAddr.toIPv6Address();
+    return countryFromRecord(findRecord(0, addr.c, 0, 128));
+}
+
+quint32 GeoIPDatabase::readRecord(const quint32 node, const bool right) const
+{
+    // Interpret the left/right record as number
+    const uchar *ptr = m_data + (node * m_nodeSize) + (right ? m_recordBytes : 0);
+
+    quint32 id = 0;
+    auto *idPtr = reinterpret_cast<uchar *>(&id);
+    memcpy(&idPtr[4 - m_recordBytes], ptr, m_recordBytes);
+    fromBigEndian(idPtr, 4);
+    return id;
+}
+
+// Walks the search tree along the given bits of the address starting from the given record
+// until a record that isn't a node is reached
+quint32 GeoIPDatabase::findRecord(quint32 record, const uchar *addr, const int firstBit, const int lastBit) const
+{
+    for (int bit = firstBit; (bit < lastBit) && (record < m_nodeCount); ++bit)
+    {
+        const bool right = static_cast<bool>((addr[bit / 8] >> (7 - (bit % 8))) & 1);
+        record = readRecord(record, right);
+    }
 
-    const uchar *ptr = m_data;
+    return record;
+}
+
+QString GeoIPDatabase::countryFromRecord(const quint32 record) const
+{
+    // The record is either a node (address wasn't found) or it is an empty record
+    if (record <= m_nodeCount)
+        return {};
+
+    const QMutexLocker locker {&m_countriesMutex};
 
-    for (int i = 0; i < 16; ++i)
+    QString country = m_countries.value(record);
+    if (country.isEmpty())
     {
-        for (int j = 0; j < 8; ++j)
+        const quint32 offset = record - m_nodeCount - sizeof(DATA_SECTION_SEPARATOR);
+        quint32 tmp = offset + m_indexSize + sizeof(DATA_SECTION_SEPARATOR);
+        const QVariant val = readDataField(tmp);
+        if (val.userType() == QMetaType::QVariantHash)
         {
-            const bool right = static_cast<bool>((addr[i] >> (7 - j)) & 1);
-            // Interpret the left/right record as number
-            if (right)
-                ptr += m_recordBytes;
-
-            quint32 id = 0;
-            auto *idPtr = reinterpret_cast<uchar *>(&id);
-            memcpy(&idPtr[4 - m_recordBytes], ptr, m_recordBytes);
-            fromBigEndian(idPtr, 4);
-
-            if (id == m_nodeCount)
-            {
-                return {};
-            }
-            if (id > m_nodeCount)
-            {
-                QString country = m_countries.value(id);
-                if (country.isEmpty())
-                {
-                    const quint32 offset = id - m_nodeCount - sizeof(DATA_SECTION_SEPARATOR);
-                    quint32 tmp = offset + m_indexSize + sizeof(DATA_SECTION_SEPARATOR);
-                    const QVariant val = readDataField(tmp);
-                    if (val.userType() == QMetaType::QVariantHash)
-                    {
-                        country = val.toHash()[u"country"_s].toHash()[u"iso_code"_s].toString();
-                        m_countries[id] = country;
-                    }
-                }
-                return country;
-            }
-
-            ptr = m_data + (id * m_nodeSize);
+            country = val.toHash()[u"country"_s].toHash()[u"iso_code"_s].toString();
+            m_countries[record] = country;
         }
     }
-
-    return {};
+    return country;
 }
 
 #define CHECK_METADATA_REQ(key, type) \
@@ -278,7 +307,7 @@ bool GeoIPDatabase::parseMetadata(const QVariantHash &metadata, QString &error)
     return true;
 }
 
-bool GeoIPDatabase::loadDB(QString &error) const
+bool GeoIPDatabase::loadDB(QString &error)
 {
     qDebug() << "Parsing IP geolocation database index tree...";
 
@@ -291,6 +320,17 @@ bool GeoIPDatabase::loadDB(QString &error) const
         return false;
     }
 
+    // IPv4 addresses are looked up as IPv4-mapped IPv6 addresses (i.e. ::ffff:0:0/96)
+    const uchar ipv4MappedPrefix[12] {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0xFF, 0xFF};
+    const quint32 ipv4Root = findRecord(0, ipv4MappedPrefix, 0, 96);
+
+    m_ipv4Records.resize(IPV4_RECORDS_COUNT);
+    for (quint32 prefix = 0; prefix < IPV4_RECORDS_COUNT; ++prefix)
+    {
+        const uchar addr[2] {static_cast<uchar>(prefix >> 8), static_cast<uchar>(prefix)};
+        m_ipv4Records[prefix] = findRecord(ipv4Root, addr, 0, 16);
+    }
+
     return true;
 }
 
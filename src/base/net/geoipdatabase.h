@@ -28,15 +28,20 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include <QtTypes>
+#include <QByteArray>
 #include <QCoreApplication>
 #include <QDateTime>
 #include <QHash>
+#include <QMutex>
 #include <QVariant>
 
 #include "base/pathfwd.h"
 
-class QByteArray;
+class QFile;
 class QHostAddress;
 class QString;
 
@@ -57,14 +62,22 @@ public:
     quint16 ipVersion() const;
     QDateTime buildEpoch() const;
     QString lookup(const QHostAddress &hostAddr) const;
+    // Rough estimation of the memory used by the database and the cache of looked up countries
+    qint64 estimatedMemoryUsage() const;
 
 private:
-    explicit GeoIPDatabase(quint32 size);
+    GeoIPDatabase() = default;
+
+    static GeoIPDatabase *create(std::unique_ptr<GeoIPDatabase> db, QString &error);
 
     bool parseMetadata(const QVariantHash &metadata, QString &error);
-    bool loadDB(QString &error) const;
+    bool loadDB(QString &error);
     QVariantHash readMetadata() const;
 
+    quint32 readRecord(quint32 node, bool right) const;
+    quint32 findRecord(quint32 record, const uchar *addr, int firstBit, int lastBit) const;
+    QString countryFromRecord(quint32 record) const;
+
     QVariant readDataField(quint32 &offset) const;
     bool readDataFieldDescriptor(quint32 &offset, DataFieldDescriptor &out) const;
     void fromBigEndian(uchar *buf, quint32 len) const;
@@ -83,7 +96,15 @@ private:
     QDateTime m_buildEpoch;
     QString m_dbType;
     // Search data
+    // Records reached by the first 16 bits of IPv4 addresses, so IPv4 lookups
+    // don't need to walk the IPv4-mapped prefix and the top of IPv4 subtree
+    std::vector<quint32> m_ipv4Records;
+    // Lookups may be performed from several threads so the cache is guarded
+    mutable QMutex m_countriesMutex;
     mutable QHash<quint32, QString> m_countries;
+    // Database data is either mapped from the file or shared with the buffer it was loaded from
+    std::unique_ptr<QFile> m_file;
+    QByteArray m_buffer;
     quint32 m_size = 0;
-    uchar *m_data = nullptr;
+    const uchar *m_data = nullptr;
 };
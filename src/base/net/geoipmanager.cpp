@@ -29,9 +29,14 @@
 
 #include "geoipmanager.h"
 
+#include <optional>
+
 #include <QDateTime>
+#include <QFuture>
 #include <QHostAddress>
 #include <QLocale>
+#include <QPromise>
+#include <QThreadPool>
 
 #include "base/global.h"
 #include "base/logger.h"
@@ -49,6 +54,49 @@ const QString GEODB_FILENAME = u"dbip-country-lite.mmdb"_s;
 
 using namespace Net;
 
+namespace
+{
+    struct DatabaseUpdateResult
+    {
+        // `nullptr` if the downloaded database isn't newer than the current one or it is invalid
+        std::shared_ptr<const GeoIPDatabase> database;
+        QString error;
+        std::optional<QString> saveError;
+    };
+
+    // It is a few MB of data to be decompressed and parsed, so it is done in a worker thread
+    DatabaseUpdateResult updateDatabase(const QByteArray &downloadedData, const QDateTime &currentBuildEpoch)
+    {
+        bool ok = false;
+        const QByteArray data = Utils::Gzip::decompress(downloadedData, &ok);
+        if (!ok)
+            return {.error = GeoIPManager::tr("Could not decompress IP geolocation database file.")};
+
+        QString error;
+        std::shared_ptr<const GeoIPDatabase> geoIPDatabase {GeoIPDatabase::load(data, error)};
+        if (!geoIPDatabase)
+            return {.error = GeoIPManager::tr("Couldn't load IP geolocation database. Reason: %1").arg(error)};
+
+        if (currentBuildEpoch.isValid() && (geoIPDatabase->buildEpoch() <= currentBuildEpoch))
+            return {};
+
+        const Path targetPath = specialFolderLocation(SpecialFolder::Data) / Path(GEODB_FOLDER);
+        if (!targetPath.exists())
+            Utils::Fs::mkpath(targetPath);
+
+        const auto path = targetPath / Path(GEODB_FILENAME);
+        const nonstd::expected<void, QString> saveResult = Utils::IO::saveToFile(path, data);
+        if (!saveResult)
+            return {.database = std::move(geoIPDatabase), .saveError = saveResult.error()};
+
+        // Prefer the database mapped from the saved file, so the downloaded data doesn't need to be kept in memory
+        if (std::shared_ptr<const GeoIPDatabase> mappedDatabase {GeoIPDatabase::load(path, error)}; mappedDatabase)
+            geoIPDatabase = std::move(mappedDatabase);
+
+        return {.database = std::move(geoIPDatabase), .saveError = std::nullopt};
+    }
+}
+
 // GeoIPManager
 
 GeoIPManager *GeoIPManager::m_instance = nullptr;
@@ -59,10 +107,7 @@ GeoIPManager::GeoIPManager()
     connect(Preferences::instance(), &Preferences::changed, this, &GeoIPManager::configure);
 }
 
-GeoIPManager::~GeoIPManager()
-{
-    delete m_geoIPDatabase;
-}
+GeoIPManager::~GeoIPManager() = default;
 
 void GeoIPManager::initInstance()
 {
@@ -83,14 +128,13 @@ GeoIPManager *GeoIPManager::instance()
 
 void GeoIPManager::loadDatabase()
 {
-    delete m_geoIPDatabase;
-    m_geoIPDatabase = nullptr;
+    m_geoIPDatabase.reset();
 
     const Path filepath = specialFolderLocation(SpecialFolder::Data)
             / Path(GEODB_FOLDER) / Path(GEODB_FILENAME);
 
     QString error;
-    m_geoIPDatabase = GeoIPDatabase::load(filepath, error);
+    m_geoIPDatabase.reset(GeoIPDatabase::load(filepath, error));
     if (m_geoIPDatabase)
     {
         LogMsg(tr("IP geolocation database loaded. Type: %1. Build time: %2.")
@@ -142,6 +186,16 @@ QString GeoIPManager::lookup(const QHostAddress &hostAddr) const
     return {};
 }
 
+std::shared_ptr<const GeoIPDatabase> GeoIPManager::database() const
+{
+    return m_enabled ? m_geoIPDatabase : nullptr;
+}
+
+qint64 GeoIPManager::estimatedMemoryUsage() const
+{
+    return m_geoIPDatabase ? m_geoIPDatabase->estimatedMemoryUsage() : 0;
+}
+
 QString GeoIPManager::CountryName(const QString &countryISOCode)
 {
     static const QHash<QString, QString> countries =
@@ -418,8 +472,7 @@ void GeoIPManager::configure()
         }
         else if (!m_enabled)
         {
-            delete m_geoIPDatabase;
-            m_geoIPDatabase = nullptr;
+            m_geoIPDatabase.reset();
         }
     }
 }
@@ -432,48 +485,44 @@ void GeoIPManager::downloadFinished(const DownloadResult &result)
         return;
     }
 
-    bool ok = false;
-    const QByteArray data = Utils::Gzip::decompress(result.data, &ok);
-    if (!ok)
+    auto promise = std::make_shared<QPromise<DatabaseUpdateResult>>();
+    promise->start();
+    promise->future().then(this, [this](const DatabaseUpdateResult &updateResult)
     {
-        LogMsg(tr("Could not decompress IP geolocation database file."), Log::WARNING);
-        return;
-    }
+        if (!updateResult.error.isEmpty())
+        {
+            LogMsg(updateResult.error, Log::WARNING);
+            return;
+        }
 
-    QString error;
-    GeoIPDatabase *geoIPDatabase = GeoIPDatabase::load(data, error);
-    if (geoIPDatabase)
-    {
-        if (!m_geoIPDatabase || (geoIPDatabase->buildEpoch() > m_geoIPDatabase->buildEpoch()))
+        if (!updateResult.database)
+            return;
+
+        // the database could be reloaded meanwhile, or the resolution could be disabled
+        if (m_enabled && (!m_geoIPDatabase || (updateResult.database->buildEpoch() > m_geoIPDatabase->buildEpoch())))
         {
-            delete m_geoIPDatabase;
-            m_geoIPDatabase = geoIPDatabase;
+            // The previous database is destroyed when it is no longer used by the pending lookups
+            m_geoIPDatabase = updateResult.database;
             LogMsg(tr("IP geolocation database loaded. Type: %1. Build time: %2.")
                 .arg(m_geoIPDatabase->type(), m_geoIPDatabase->buildEpoch().toString())
                    , Log::INFO);
-            const Path targetPath = specialFolderLocation(SpecialFolder::Data) / Path(GEODB_FOLDER);
-            if (!targetPath.exists())
-                Utils::Fs::mkpath(targetPath);
-
-            const auto path = targetPath / Path(GEODB_FILENAME);
-            const nonstd::expected<void, QString> saveResult = Utils::IO::saveToFile(path, data);
-            if (saveResult)
-            {
-                LogMsg(tr("Successfully updated IP geolocation database."), Log::INFO);
-            }
-            else
-            {
-                LogMsg(tr("Couldn't save downloaded IP geolocation database file. Reason: %1")
-                    .arg(saveResult.error()), Log::WARNING);
-            }
+        }
+
+        if (!updateResult.saveError)
+        {
+            LogMsg(tr("Successfully updated IP geolocation database."), Log::INFO);
         }
         else
         {
-            delete geoIPDatabase;
+            LogMsg(tr("Couldn't save downloaded IP geolocation database file. Reason: %1")
+                .arg(*updateResult.saveError), Log::WARNING);
         }
-    }
-    else
+    });
+
+    const QDateTime currentBuildEpoch = m_geoIPDatabase ? m_geoIPDatabase->buildEpoch() : QDateTime();
+    QThreadPool::globalInstance()->start([promise, data = result.data, currentBuildEpoch]
     {
-        LogMsg(tr("Couldn't load IP geolocation database. Reason: %1").arg(error), Log::WARNING);
-    }
+        promise->addResult(updateDatabase(data, currentBuildEpoch));
+        promise->finish();
+    });
 }
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <QObject>
 
 class QHostAddress;
@@ -51,6 +53,10 @@ namespace Net
         static GeoIPManager *instance();
 
         QString lookup(const QHostAddress &hostAddr) const;
+        // Database that can be used for lookups from other threads, `nullptr` if resolution is disabled
+        std::shared_ptr<const GeoIPDatabase> database() const;
+        // Rough estimation of the memory used by the loaded database
+        qint64 estimatedMemoryUsage() const;
 
         static QString CountryName(const QString &countryISOCode);
 
@@ -67,7 +73,7 @@ namespace Net
         void downloadDatabaseFile();
 
         bool m_enabled = false;
-        GeoIPDatabase *m_geoIPDatabase = nullptr;
+        std::shared_ptr<const GeoIPDatabase> m_geoIPDatabase;
 
         static GeoIPManager *m_instance;
     };
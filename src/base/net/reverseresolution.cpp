@@ -28,10 +28,32 @@
 
 #include "reverseresolution.h"
 
+#include <chrono>
+
+#include <QDateTime>
 #include <QHostInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QString>
 
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/utils/io.h"
+
+using namespace std::chrono_literals;
+
 const int CACHE_SIZE = 2048;
+const int MAX_CACHE_FILE_SIZE = 1024 * 1024;
+// Limits the number of simultaneous lookups so that the DNS resolver isn't flooded
+const int MAX_CONCURRENT_LOOKUPS = 8;
+const std::chrono::seconds RESOLVED_TTL = 24h;
+// Used when the IP doesn't have a host name
+const std::chrono::seconds UNRESOLVED_TTL = 1h;
+// Used when the lookup itself failed (e.g. resolver is not available)
+const std::chrono::seconds FAILED_LOOKUP_TTL = 5min;
+
+const QString KEY_HOSTNAME = u"hostname"_s;
+const QString KEY_EXPIRATION_TIME = u"expiration_time"_s;
 
 using namespace Net;
 
@@ -44,9 +66,18 @@ namespace
 }
 
 ReverseResolution::ReverseResolution(QObject *parent)
+    : ReverseResolution(Path(), parent)
+{
+}
+
+ReverseResolution::ReverseResolution(const Path &cacheFilePath, QObject *parent)
     : QObject(parent)
+    , m_cacheFilePath {cacheFilePath}
 {
     m_cache.setMaxCost(CACHE_SIZE);
+
+    if (!m_cacheFilePath.isEmpty())
+        loadCache();
 }
 
 ReverseResolution::~ReverseResolution()
@@ -54,35 +85,112 @@ ReverseResolution::~ReverseResolution()
     // abort on-going lookups instead of waiting them
     for (auto iter = m_lookups.cbegin(); iter != m_lookups.cend(); ++iter)
         QHostInfo::abortHostLookup(iter.key());
+
+    if (!m_cacheFilePath.isEmpty())
+        saveCache();
 }
 
 void ReverseResolution::resolve(const QHostAddress &ip)
 {
-    const QString *hostname = m_cache.object(ip);
-    if (hostname)
+    if (const CachedHostName *cached = m_cache.object(ip))
     {
-        emit ipResolved(ip, *hostname);
-        return;
+        if (cached->expirationTime > QDateTime::currentSecsSinceEpoch())
+        {
+            emit ipResolved(ip, cached->hostName);
+            return;
+        }
+
+        m_cache.remove(ip);
     }
 
-    // do reverse lookup: IP -> hostname
-    const int lookupId = QHostInfo::lookupHost(ip.toString(), this, &ReverseResolution::hostResolved);
-    m_lookups.insert(lookupId, ip);
+    // the result of pending lookup will be reported for all requests of the same IP
+    if (m_requestedIPs.contains(ip))
+        return;
+
+    m_requestedIPs.insert(ip);
+    m_queuedIPs.append(ip);
+    startLookups();
+}
+
+void ReverseResolution::startLookups()
+{
+    while ((m_lookups.size() < MAX_CONCURRENT_LOOKUPS) && !m_queuedIPs.isEmpty())
+    {
+        const QHostAddress ip = m_queuedIPs.takeFirst();
+        // do reverse lookup: IP -> hostname
+        const int lookupId = QHostInfo::lookupHost(ip.toString(), this, &ReverseResolution::hostResolved);
+        m_lookups.insert(lookupId, ip);
+    }
 }
 
 void ReverseResolution::hostResolved(const QHostInfo &host)
 {
     const QHostAddress ip = m_lookups.take(host.lookupId());
+    m_requestedIPs.remove(ip);
 
-    if (host.error() != QHostInfo::NoError)
+    QString hostname;
+    std::chrono::seconds ttl = FAILED_LOOKUP_TTL;
+    if (host.error() == QHostInfo::NoError)
     {
-        emit ipResolved(ip, {});
-        return;
+        if (isUsefulHostName(host.hostName(), ip))
+            hostname = host.hostName();
+        ttl = (hostname.isEmpty() ? UNRESOLVED_TTL : RESOLVED_TTL);
+    }
+    else if (host.error() == QHostInfo::HostNotFound)
+    {
+        ttl = UNRESOLVED_TTL;
     }
 
-    const QString hostname = isUsefulHostName(host.hostName(), ip)
-        ? host.hostName()
-        : QString();
-    m_cache.insert(ip, new QString(hostname));
+    m_cache.insert(ip, new CachedHostName {.hostName = hostname, .expirationTime = (QDateTime::currentSecsSinceEpoch() + ttl.count())});
     emit ipResolved(ip, hostname);
+
+    startLookups();
+}
+
+void ReverseResolution::loadCache()
+{
+    const auto readResult = Utils::IO::readFile(m_cacheFilePath, MAX_CACHE_FILE_SIZE);
+    if (!readResult)
+        return;
+
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(readResult.value());
+    if (!jsonDoc.isObject())
+        return;
+
+    const qint64 currentTime = QDateTime::currentSecsSinceEpoch();
+    const QJsonObject jsonObj = jsonDoc.object();
+    for (auto it = jsonObj.constBegin(); it != jsonObj.constEnd(); ++it)
+    {
+        const QHostAddress ip {it.key()};
+        const QJsonObject entryObj = it.value().toObject();
+        const auto expirationTime = static_cast<qint64>(entryObj.value(KEY_EXPIRATION_TIME).toDouble());
+        if (ip.isNull() || (expirationTime <= currentTime))
+            continue;
+
+        m_cache.insert(ip, new CachedHostName {.hostName = entryObj.value(KEY_HOSTNAME).toString(), .expirationTime = expirationTime});
+    }
+}
+
+void ReverseResolution::saveCache() const
+{
+    const qint64 currentTime = QDateTime::currentSecsSinceEpoch();
+    QJsonObject jsonObj;
+    for (const QHostAddress &ip : asConst(m_cache.keys()))
+    {
+        const CachedHostName *cached = m_cache.object(ip);
+        if (cached->expirationTime <= currentTime)
+            continue;
+
+        jsonObj[ip.toString()] = QJsonObject {
+            {KEY_HOSTNAME, cached->hostName},
+            {KEY_EXPIRATION_TIME, cached->expirationTime}
+        };
+    }
+
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(m_cacheFilePath, QJsonDocument(jsonObj).toJson(QJsonDocument::Compact));
+    if (!result)
+    {
+        LogMsg(tr("Failed to save peer host names cache. File: \"%1\". Error: \"%2\"")
+            .arg(m_cacheFilePath.toString(), result.error()), Log::WARNING);
+    }
 }
@@ -29,11 +29,16 @@
 #pragma once
 
 #include <QCache>
+#include <QHash>
 #include <QHostAddress>
+#include <QList>
 #include <QObject>
+#include <QSet>
+#include <QString>
+
+#include "base/path.h"
 
 class QHostInfo;
-class QString;
 
 namespace Net
 {
@@ -44,6 +49,8 @@ namespace Net
 
     public:
         explicit ReverseResolution(QObject *parent = nullptr);
+        // Resolved host names are loaded from `cacheFilePath` and saved back to it on destruction
+        explicit ReverseResolution(const Path &cacheFilePath, QObject *parent = nullptr);
         ~ReverseResolution();
 
         void resolve(const QHostAddress &ip);
@@ -55,7 +62,22 @@ namespace Net
         void hostResolved(const QHostInfo &host);
 
     private:
+        struct CachedHostName
+        {
+            QString hostName;
+            qint64 expirationTime = 0;  // seconds since epoch
+        };
+
+        void startLookups();
+        void loadCache();
+        void saveCache() const;
+
+        Path m_cacheFilePath;
         QHash<int, QHostAddress> m_lookups;  // <LookupID, IP>
-        QCache<QHostAddress, QString> m_cache;  // <IP, HostName>
+        // IPs waiting for a free lookup slot, in the order they were requested
+        QList<QHostAddress> m_queuedIPs;
+        // Queued IPs and IPs being looked up, so each of them is looked up only once
+        QSet<QHostAddress> m_requestedIPs;
+        QCache<QHostAddress, CachedHostName> m_cache;  // <IP, HostName>
     };
 }
@@ -66,6 +66,28 @@ namespace
         SettingsStorage::instance()->storeValue(key, value);
     }
 
+    QString logMessageTypesKey(const Log::Category category)
+    {
+        const QString keyTemplate = u"Application/Logging/MessageTypes/%1"_s;
+        switch (category)
+        {
+        case Log::Category::General:
+            return keyTemplate.arg(u"General"_s);
+        case Log::Category::Peers:
+            return keyTemplate.arg(u"Peers"_s);
+        case Log::Category::Trackers:
+            return keyTemplate.arg(u"Trackers"_s);
+        case Log::Category::Network:
+            return keyTemplate.arg(u"Network"_s);
+        case Log::Category::Storage:
+            return keyTemplate.arg(u"Storage"_s);
+        case Log::Category::Performance:
+            return keyTemplate.arg(u"Performance"_s);
+        }
+
+        Q_UNREACHABLE();
+    }
+
 #ifdef Q_OS_WIN
     QString makeProfileID(const Path &profilePath, const QString &profileName)
     {
@@ -78,7 +100,24 @@ namespace
 
 Preferences *Preferences::m_instance = nullptr;
 
-Preferences::Preferences() = default;
+Preferences::Preferences()
+    : m_useAlternatingRowColors {u"Preferences/General/AlternatingRowColors"_s, true}
+    , m_useTorrentStatesColors {u"GUI/TransferList/UseTorrentStatesColors"_s, true}
+    , m_progressBarFollowsTextColor {u"GUI/TransferList/ProgressBarFollowsTextColor"_s, false}
+    , m_hideZeroValues {u"Preferences/General/HideZeroValues"_s, false}
+    , m_hideZeroComboValues {u"Preferences/General/HideZeroComboValues"_s, 0}
+    , m_torrentFileSizeLimit {u"BitTorrent/TorrentFileSizeLimit"_s, (100 * 1024 * 1024)}
+    , m_bdecodeDepthLimit {u"BitTorrent/BdecodeDepthLimit"_s, 100}
+    , m_bdecodeTokenLimit {u"BitTorrent/BdecodeTokenLimit"_s, 10'000'000}
+    , m_resolvePeerCountries {u"Preferences/Connection/ResolvePeerCountries"_s, true}
+    , m_resolvePeerHostNames {u"Preferences/Connection/ResolvePeerHostNames"_s, false}
+    , m_isMarkOfTheWebEnabled {u"Preferences/Advanced/markOfTheWeb"_s, true}
+    , m_isIgnoreSSLErrors {u"Preferences/Advanced/IgnoreSSLErrors"_s, false}
+    , m_useProxyForBT {u"Network/Proxy/Profiles/BitTorrent"_s, false}
+    , m_useProxyForRSS {u"Network/Proxy/Profiles/RSS"_s, false}
+    , m_useProxyForGeneralPurposes {u"Network/Proxy/Profiles/Misc"_s, false}
+{
+}
 
 Preferences *Preferences::instance()
 {
@@ -179,7 +218,7 @@ void Preferences::showSpeedInTitleBar(const bool show)
 
 bool Preferences::useAlternatingRowColors() const
 {
-    return value(u"Preferences/General/AlternatingRowColors"_s, true);
+    return m_useAlternatingRowColors;
 }
 
 void Preferences::setAlternatingRowColors(const bool b)
@@ -187,12 +226,12 @@ void Preferences::setAlternatingRowColors(const bool b)
     if (b == useAlternatingRowColors())
         return;
 
-    setValue(u"Preferences/General/AlternatingRowColors"_s, b);
+    m_useAlternatingRowColors = b;
 }
 
 bool Preferences::useTorrentStatesColors() const
 {
-    return value(u"GUI/TransferList/UseTorrentStatesColors"_s, true);
+    return m_useTorrentStatesColors;
 }
 
 void Preferences::setUseTorrentStatesColors(const bool value)
@@ -200,12 +239,12 @@ void Preferences::setUseTorrentStatesColors(const bool value)
     if (value == useTorrentStatesColors())
         return;
 
-    setValue(u"GUI/TransferList/UseTorrentStatesColors"_s, value);
+    m_useTorrentStatesColors = value;
 }
 
 bool Preferences::getProgressBarFollowsTextColor() const
 {
-    return value(u"GUI/TransferList/ProgressBarFollowsTextColor"_s, false);
+    return m_progressBarFollowsTextColor;
 }
 
 void Preferences::setProgressBarFollowsTextColor(const bool value)
@@ -213,12 +252,12 @@ void Preferences::setProgressBarFollowsTextColor(const bool value)
     if (value == getProgressBarFollowsTextColor())
         return;
 
-    setValue(u"GUI/TransferList/ProgressBarFollowsTextColor"_s, value);
+    m_progressBarFollowsTextColor = value;
 }
 
 bool Preferences::getHideZeroValues() const
 {
-    return value(u"Preferences/General/HideZeroValues"_s, false);
+    return m_hideZeroValues;
 }
 
 void Preferences::setHideZeroValues(const bool b)
@@ -226,12 +265,12 @@ void Preferences::setHideZeroValues(const bool b)
     if (b == getHideZeroValues())
         return;
 
-    setValue(u"Preferences/General/HideZeroValues"_s, b);
+    m_hideZeroValues = b;
 }
 
 int Preferences::getHideZeroComboValues() const
 {
-    return value<int>(u"Preferences/General/HideZeroComboValues"_s, 0);
+    return m_hideZeroComboValues;
 }
 
 void Preferences::setHideZeroComboValues(const int n)
@@ -239,7 +278,7 @@ void Preferences::setHideZeroComboValues(const int n)
     if (n == getHideZeroComboValues())
         return;
 
-    setValue(u"Preferences/General/HideZeroComboValues"_s, n);
+    m_hideZeroComboValues = n;
 }
 
 // In Mac OS X the dock is sufficient for our needs so we disable the sys tray functionality.
@@ -326,7 +365,7 @@ void Preferences::setIconsInMenusEnabled(const bool enable)
 
 qint64 Preferences::getTorrentFileSizeLimit() const
 {
-    return value(u"BitTorrent/TorrentFileSizeLimit"_s, (100 * 1024 * 1024));
+    return m_torrentFileSizeLimit;
 }
 
 void Preferences::setTorrentFileSizeLimit(const qint64 value)
@@ -334,12 +373,12 @@ void Preferences::setTorrentFileSizeLimit(const qint64 value)
     if (value == getTorrentFileSizeLimit())
         return;
 
-    setValue(u"BitTorrent/TorrentFileSizeLimit"_s, value);
+    m_torrentFileSizeLimit = value;
 }
 
 int Preferences::getBdecodeDepthLimit() const
 {
-    return value(u"BitTorrent/BdecodeDepthLimit"_s, 100);
+    return m_bdecodeDepthLimit;
 }
 
 void Preferences::setBdecodeDepthLimit(const int value)
@@ -347,12 +386,12 @@ void Preferences::setBdecodeDepthLimit(const int value)
     if (value == getBdecodeDepthLimit())
         return;
 
-    setValue(u"BitTorrent/BdecodeDepthLimit"_s, value);
+    m_bdecodeDepthLimit = value;
 }
 
 int Preferences::getBdecodeTokenLimit() const
 {
-    return value(u"BitTorrent/BdecodeTokenLimit"_s, 10'000'000);
+    return m_bdecodeTokenLimit;
 }
 
 void Preferences::setBdecodeTokenLimit(const int value)
@@ -360,7 +399,20 @@ void Preferences::setBdecodeTokenLimit(const int value)
     if (value == getBdecodeTokenLimit())
         return;
 
-    setValue(u"BitTorrent/BdecodeTokenLimit"_s, value);
+    m_bdecodeTokenLimit = value;
+}
+
+Log::MsgTypes Preferences::getLogMessageTypes(const Log::Category category) const
+{
+    return Log::MsgTypes::fromInt(value<int>(logMessageTypesKey(category), Log::ALL));
+}
+
+void Preferences::setLogMessageTypes(const Log::Category category, const Log::MsgTypes types)
+{
+    if (types == getLogMessageTypes(category))
+        return;
+
+    setValue(logMessageTypesKey(category), types.toInt());
 }
 
 bool Preferences::isToolbarDisplayed() const
@@ -1103,6 +1155,71 @@ void Preferences::setWebUISessionTimeout(const int timeout)
     setValue(u"Preferences/WebUI/SessionTimeout"_s, timeout);
 }
 
+bool Preferences::isWebUIRequestBudgetEnabled() const
+{
+    return value(u"Preferences/WebUI/RequestBudget/Enabled"_s, false);
+}
+
+void Preferences::setWebUIRequestBudgetEnabled(const bool enabled)
+{
+    if (enabled == isWebUIRequestBudgetEnabled())
+        return;
+
+    setValue(u"Preferences/WebUI/RequestBudget/Enabled"_s, enabled);
+}
+
+int Preferences::getWebUIRequestBudgetRate() const
+{
+    return std::max(value<int>(u"Preferences/WebUI/RequestBudget/Rate"_s, 20), 1);
+}
+
+void Preferences::setWebUIRequestBudgetRate(const int rate)
+{
+    if (rate == getWebUIRequestBudgetRate())
+        return;
+
+    setValue(u"Preferences/WebUI/RequestBudget/Rate"_s, rate);
+}
+
+int Preferences::getWebUIRequestBudgetBurst() const
+{
+    return std::max(value<int>(u"Preferences/WebUI/RequestBudget/Burst"_s, 100), 2);
+}
+
+void Preferences::setWebUIRequestBudgetBurst(const int burst)
+{
+    if (burst == getWebUIRequestBudgetBurst())
+        return;
+
+    setValue(u"Preferences/WebUI/RequestBudget/Burst"_s, burst);
+}
+
+int Preferences::getWebUIWorkerThreadCount() const
+{
+    return std::clamp(value<int>(u"Preferences/WebUI/WorkerThreads"_s, 0), 0, 16);
+}
+
+void Preferences::setWebUIWorkerThreadCount(const int count)
+{
+    if (count == getWebUIWorkerThreadCount())
+        return;
+
+    setValue(u"Preferences/WebUI/WorkerThreads"_s, std::clamp(count, 0, 16));
+}
+
+bool Preferences::isWebUIHTTP2Enabled() const
+{
+    return value(u"Preferences/WebUI/HTTP2Enabled"_s, false);
+}
+
+void Preferences::setWebUIHTTP2Enabled(const bool enabled)
+{
+    if (enabled == isWebUIHTTP2Enabled())
+        return;
+
+    setValue(u"Preferences/WebUI/HTTP2Enabled"_s, enabled);
+}
+
 bool Preferences::isWebUIClickjackingProtectionEnabled() const
 {
     return value(u"Preferences/WebUI/ClickjackingProtection"_s, true);
@@ -1194,6 +1311,32 @@ void Preferences::setWebUIHttpsKeyPath(const Path &path)
     setValue(u"Preferences/WebUI/HTTPS/KeyPath"_s, path);
 }
 
+bool Preferences::isWebUILocalSocketEnabled() const
+{
+    return value(u"Preferences/WebUI/LocalSocket/Enabled"_s, false);
+}
+
+void Preferences::setWebUILocalSocketEnabled(const bool enabled)
+{
+    if (enabled == isWebUILocalSocketEnabled())
+        return;
+
+    setValue(u"Preferences/WebUI/LocalSocket/Enabled"_s, enabled);
+}
+
+QString Preferences::getWebUILocalSocketName() const
+{
+    return value<QString>(u"Preferences/WebUI/LocalSocket/Name"_s);
+}
+
+void Preferences::setWebUILocalSocketName(const QString &name)
+{
+    if (name == getWebUILocalSocketName())
+        return;
+
+    setValue(u"Preferences/WebUI/LocalSocket/Name"_s, name);
+}
+
 bool Preferences::isAltWebUIEnabled() const
 {
     return value(u"Preferences/WebUI/AlternativeUIEnabled"_s, false);
@@ -1272,6 +1415,32 @@ void Preferences::setWebUITrustedReverseProxiesList(const QString &addr)
     setValue(u"Preferences/WebUI/TrustedReverseProxiesList"_s, addr);
 }
 
+bool Preferences::isWebUIMetricsEnabled() const
+{
+    return value(u"Preferences/WebUI/MetricsEnabled"_s, false);
+}
+
+void Preferences::setWebUIMetricsEnabled(const bool enabled)
+{
+    if (enabled == isWebUIMetricsEnabled())
+        return;
+
+    setValue(u"Preferences/WebUI/MetricsEnabled"_s, enabled);
+}
+
+QString Preferences::getWebUIFederationNodes() const
+{
+    return value<QString>(u"Preferences/WebUI/FederationNodes"_s);
+}
+
+void Preferences::setWebUIFederationNodes(const QString &nodes)
+{
+    if (nodes == getWebUIFederationNodes())
+        return;
+
+    setValue(u"Preferences/WebUI/FederationNodes"_s, nodes);
+}
+
 bool Preferences::isDynDNSEnabled() const
 {
     return value(u"Preferences/DynDNS/Enabled"_s, false);
@@ -1416,6 +1585,45 @@ void Preferences::setAutoRunOnTorrentFinishedProgram(const QString &program)
     setValue(u"AutoRun/program"_s, program);
 }
 
+int Preferences::getAutoRunMaxProcesses() const
+{
+    return std::max(1, value<int>(u"AutoRun/MaxProcesses"_s, 4));
+}
+
+void Preferences::setAutoRunMaxProcesses(const int count)
+{
+    if (count == getAutoRunMaxProcesses())
+        return;
+
+    setValue(u"AutoRun/MaxProcesses"_s, std::max(1, count));
+}
+
+int Preferences::getAutoRunTimeout() const
+{
+    return std::max(0, value<int>(u"AutoRun/Timeout"_s, 0));
+}
+
+void Preferences::setAutoRunTimeout(const int seconds)
+{
+    if (seconds == getAutoRunTimeout())
+        return;
+
+    setValue(u"AutoRun/Timeout"_s, std::max(0, seconds));
+}
+
+bool Preferences::isAutoRunBatchingEnabled() const
+{
+    return value(u"AutoRun/BatchingEnabled"_s, false);
+}
+
+void Preferences::setAutoRunBatchingEnabled(const bool enabled)
+{
+    if (enabled == isAutoRunBatchingEnabled())
+        return;
+
+    setValue(u"AutoRun/BatchingEnabled"_s, enabled);
+}
+
 #if defined(Q_OS_WIN)
 bool Preferences::isAutoRunConsoleEnabled() const
 {
@@ -1511,7 +1719,7 @@ void Preferences::recheckTorrentsOnCompletion(const bool recheck)
 
 bool Preferences::resolvePeerCountries() const
 {
-    return value(u"Preferences/Connection/ResolvePeerCountries"_s, true);
+    return m_resolvePeerCountries;
 }
 
 void Preferences::resolvePeerCountries(const bool resolve)
@@ -1519,12 +1727,12 @@ void Preferences::resolvePeerCountries(const bool resolve)
     if (resolve == resolvePeerCountries())
         return;
 
-    setValue(u"Preferences/Connection/ResolvePeerCountries"_s, resolve);
+    m_resolvePeerCountries = resolve;
 }
 
 bool Preferences::resolvePeerHostNames() const
 {
-    return value(u"Preferences/Connection/ResolvePeerHostNames"_s, false);
+    return m_resolvePeerHostNames;
 }
 
 void Preferences::resolvePeerHostNames(const bool resolve)
@@ -1532,7 +1740,7 @@ void Preferences::resolvePeerHostNames(const bool resolve)
     if (resolve == resolvePeerHostNames())
         return;
 
-    setValue(u"Preferences/Connection/ResolvePeerHostNames"_s, resolve);
+    m_resolvePeerHostNames = resolve;
 }
 
 #if (defined(Q_OS_UNIX) && !defined(Q_OS_MACOS))
@@ -1591,7 +1799,7 @@ void Preferences::setTrackerPortForwardingEnabled(const bool enabled)
 
 bool Preferences::isMarkOfTheWebEnabled() const
 {
-    return value(u"Preferences/Advanced/markOfTheWeb"_s, true);
+    return m_isMarkOfTheWebEnabled;
 }
 
 void Preferences::setMarkOfTheWebEnabled(const bool enabled)
@@ -1599,12 +1807,12 @@ void Preferences::setMarkOfTheWebEnabled(const bool enabled)
     if (enabled == isMarkOfTheWebEnabled())
         return;
 
-    setValue(u"Preferences/Advanced/markOfTheWeb"_s, enabled);
+    m_isMarkOfTheWebEnabled = enabled;
 }
 
 bool Preferences::isIgnoreSSLErrors() const
 {
-    return value(u"Preferences/Advanced/IgnoreSSLErrors"_s, false);
+    return m_isIgnoreSSLErrors;
 }
 
 void Preferences::setIgnoreSSLErrors(const bool enabled)
@@ -1612,7 +1820,20 @@ void Preferences::setIgnoreSSLErrors(const bool enabled)
     if (enabled == isIgnoreSSLErrors())
         return;
 
-    setValue(u"Preferences/Advanced/IgnoreSSLErrors"_s, enabled);
+    m_isIgnoreSSLErrors = enabled;
+}
+
+int Preferences::maxDownloadsPerHost() const
+{
+    return std::clamp(value(u"Preferences/Advanced/MaxDownloadsPerHost"_s, 6), 1, 32);
+}
+
+void Preferences::setMaxDownloadsPerHost(const int value)
+{
+    if (value == maxDownloadsPerHost())
+        return;
+
+    setValue(u"Preferences/Advanced/MaxDownloadsPerHost"_s, std::clamp(value, 1, 32));
 }
 
 Path Preferences::getPythonExecutablePath() const
@@ -2138,7 +2359,7 @@ void Preferences::setNetworkCookies(const QList<QNetworkCookie> &cookies)
 
 bool Preferences::useProxyForBT() const
 {
-    return value<bool>(u"Network/Proxy/Profiles/BitTorrent"_s);
+    return m_useProxyForBT;
 }
 
 void Preferences::setUseProxyForBT(const bool value)
@@ -2146,12 +2367,12 @@ void Preferences::setUseProxyForBT(const bool value)
     if (value == useProxyForBT())
         return;
 
-    setValue(u"Network/Proxy/Profiles/BitTorrent"_s, value);
+    m_useProxyForBT = value;
 }
 
 bool Preferences::useProxyForRSS() const
 {
-    return value<bool>(u"Network/Proxy/Profiles/RSS"_s);
+    return m_useProxyForRSS;
 }
 
 void Preferences::setUseProxyForRSS(const bool value)
@@ -2159,12 +2380,12 @@ void Preferences::setUseProxyForRSS(const bool value)
     if (value == useProxyForRSS())
         return;
 
-    setValue(u"Network/Proxy/Profiles/RSS"_s, value);
+    m_useProxyForRSS = value;
 }
 
 bool Preferences::useProxyForGeneralPurposes() const
 {
-    return value<bool>(u"Network/Proxy/Profiles/Misc"_s);
+    return m_useProxyForGeneralPurposes;
 }
 
 void Preferences::setUseProxyForGeneralPurposes(const bool value)
@@ -2172,7 +2393,7 @@ void Preferences::setUseProxyForGeneralPurposes(const bool value)
     if (value == useProxyForGeneralPurposes())
         return;
 
-    setValue(u"Network/Proxy/Profiles/Misc"_s, value);
+    m_useProxyForGeneralPurposes = value;
 }
 
 bool Preferences::isSpeedWidgetEnabled() const
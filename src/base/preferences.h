@@ -33,7 +33,9 @@
 #include <QtSystemDetection>
 #include <QObject>
 
+#include "base/logger.h"
 #include "base/pathfwd.h"
+#include "base/settingvalue.h"
 #include "base/utils/net.h"
 
 class QDateTime;
@@ -233,6 +235,17 @@ public:
     void setWebUIBanDuration(std::chrono::seconds duration);
     int getWebUISessionTimeout() const;
     void setWebUISessionTimeout(int timeout);
+    // Limits the API requests of each client, in requests per second and the allowed burst size
+    bool isWebUIRequestBudgetEnabled() const;
+    void setWebUIRequestBudgetEnabled(bool enabled);
+    int getWebUIRequestBudgetRate() const;
+    void setWebUIRequestBudgetRate(int rate);
+    int getWebUIRequestBudgetBurst() const;
+    void setWebUIRequestBudgetBurst(int burst);
+    int getWebUIWorkerThreadCount() const;
+    void setWebUIWorkerThreadCount(int count);
+    bool isWebUIHTTP2Enabled() const;
+    void setWebUIHTTP2Enabled(bool enabled);
 
     // WebUI security
     bool isWebUIClickjackingProtectionEnabled() const;
@@ -251,6 +264,10 @@ public:
     void setWebUIHttpsCertificatePath(const Path &path);
     Path getWebUIHttpsKeyPath() const;
     void setWebUIHttpsKeyPath(const Path &path);
+    bool isWebUILocalSocketEnabled() const;
+    void setWebUILocalSocketEnabled(bool enabled);
+    QString getWebUILocalSocketName() const;
+    void setWebUILocalSocketName(const QString &name);
     bool isAltWebUIEnabled() const;
     void setAltWebUIEnabled(bool enabled);
     Path getWebUIRootFolder() const;
@@ -268,6 +285,13 @@ public:
     QString getWebUITrustedReverseProxiesList() const;
     void setWebUITrustedReverseProxiesList(const QString &addr);
 
+    // Metrics
+    bool isWebUIMetricsEnabled() const;
+    void setWebUIMetricsEnabled(bool enabled);
+    // Federation, one "<URL> <API key>" entry per line
+    QString getWebUIFederationNodes() const;
+    void setWebUIFederationNodes(const QString &nodes);
+
     // Dynamic DNS
     bool isDynDNSEnabled() const;
     void setDynDNSEnabled(bool enabled);
@@ -294,6 +318,13 @@ public:
     void setAutoRunOnTorrentFinishedEnabled(bool enabled);
     QString getAutoRunOnTorrentFinishedProgram() const;
     void setAutoRunOnTorrentFinishedProgram(const QString &program);
+    int getAutoRunMaxProcesses() const;
+    void setAutoRunMaxProcesses(int count);
+    // in seconds, 0 means no timeout
+    int getAutoRunTimeout() const;
+    void setAutoRunTimeout(int seconds);
+    bool isAutoRunBatchingEnabled() const;
+    void setAutoRunBatchingEnabled(bool enabled);
 #if defined(Q_OS_WIN)
     bool isAutoRunConsoleEnabled() const;
     void setAutoRunConsoleEnabled(bool enabled);
@@ -329,6 +360,8 @@ public:
     void setMarkOfTheWebEnabled(bool enabled);
     bool isIgnoreSSLErrors() const;
     void setIgnoreSSLErrors(bool enabled);
+    int maxDownloadsPerHost() const;
+    void setMaxDownloadsPerHost(int value);
     Path getPythonExecutablePath() const;
     void setPythonExecutablePath(const Path &path);
 #if defined(Q_OS_WIN) || defined(Q_OS_MACOS)
@@ -367,6 +400,8 @@ public:
     void setBdecodeDepthLimit(int value);
     int getBdecodeTokenLimit() const;
     void setBdecodeTokenLimit(int value);
+    Log::MsgTypes getLogMessageTypes(Log::Category category) const;
+    void setLogMessageTypes(Log::Category category, Log::MsgTypes types);
 
     // Stuff that don't appear in the Options GUI but are saved
     // in the same file.
@@ -471,4 +506,21 @@ signals:
 
 private:
     static Preferences *m_instance;
+
+    // Settings read on hot paths (e.g. while painting or handling requests)
+    AtomicCachedSettingValue<bool> m_useAlternatingRowColors;
+    AtomicCachedSettingValue<bool> m_useTorrentStatesColors;
+    AtomicCachedSettingValue<bool> m_progressBarFollowsTextColor;
+    AtomicCachedSettingValue<bool> m_hideZeroValues;
+    AtomicCachedSettingValue<int> m_hideZeroComboValues;
+    AtomicCachedSettingValue<qint64> m_torrentFileSizeLimit;
+    AtomicCachedSettingValue<int> m_bdecodeDepthLimit;
+    AtomicCachedSettingValue<int> m_bdecodeTokenLimit;
+    AtomicCachedSettingValue<bool> m_resolvePeerCountries;
+    AtomicCachedSettingValue<bool> m_resolvePeerHostNames;
+    AtomicCachedSettingValue<bool> m_isMarkOfTheWebEnabled;
+    AtomicCachedSettingValue<bool> m_isIgnoreSSLErrors;
+    AtomicCachedSettingValue<bool> m_useProxyForBT;
+    AtomicCachedSettingValue<bool> m_useProxyForRSS;
+    AtomicCachedSettingValue<bool> m_useProxyForGeneralPurposes;
 };
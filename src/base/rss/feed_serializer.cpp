@@ -31,57 +31,336 @@
 
 #include "feed_serializer.h"
 
+#include <QDataStream>
+#include <QFile>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QList>
+#include <QSet>
 
+#include "base/global.h"
 #include "base/logger.h"
 #include "base/path.h"
+#include "base/utils/fs.h"
 #include "base/utils/io.h"
 #include "rss_article.h"
 
-const int ARTICLEDATALIST_TYPEID = qRegisterMetaType<QList<QVariantHash>>();
+const int ARTICLEDATALIST_TYPEID = qRegisterMetaType<QList<RSS::ArticleData>>();
 
-void RSS::Private::FeedSerializer::load(const Path &dataFileName, const QString &url)
+const int MAX_VALIDATORS_FILE_SIZE = 64 * 1024;
+
+const QString KEY_ETAG = u"etag"_s;
+const QString KEY_LASTMODIFIED = u"last_modified"_s;
+
+const quint32 ARTICLES_LOG_MAGIC = 0x53525141; // "AQRS"
+const quint32 ARTICLES_LOG_VERSION = 1;
+const QDataStream::Version ARTICLES_LOG_STREAM_VERSION = QDataStream::Qt_6_0;
+// The log is compacted when it contains more obsolete records than the actual ones
+const qsizetype MIN_COMPACTION_RECORD_COUNT = 64;
+
+namespace
+{
+    enum class RecordType : quint8
+    {
+        AddArticle = 1,
+        MarkArticleRead = 2,
+        RemoveArticle = 3
+    };
+
+    void writeHeader(QDataStream &stream)
+    {
+        stream << ARTICLES_LOG_MAGIC << ARTICLES_LOG_VERSION;
+    }
+
+    void writeAddArticleRecord(QDataStream &stream, const RSS::ArticleData &article)
+    {
+        stream << static_cast<quint8>(RecordType::AddArticle)
+            << article.id << article.date << article.title << article.author << article.description
+            << article.torrentURL << article.link << article.isRead << article.extraData;
+    }
+
+    void writeArticleIDRecord(QDataStream &stream, const RecordType type, const QString &articleID)
+    {
+        stream << static_cast<quint8>(type) << articleID;
+    }
+
+    void readArticle(QDataStream &stream, RSS::ArticleData &article)
+    {
+        stream >> article.id >> article.date >> article.title >> article.author >> article.description
+            >> article.torrentURL >> article.link >> article.isRead >> article.extraData;
+    }
+}
+
+void RSS::Private::FeedSerializer::load(const Path &dataFileName, const Path &legacyDataFileName, const QString &url)
 {
+    m_storedArticles.clear();
+    m_storedRecordCount = 0;
+    m_isRewriteNeeded = false;
+    m_legacyDataFileName.clear();
+
     const auto readResult = Utils::IO::readFile(dataFileName, -1);
-    if (!readResult)
+    if (readResult)
+    {
+        emit loadingFinished(loadArticlesLog(readResult.value(), url));
+        return;
+    }
+
+    if (readResult.error().status != Utils::IO::ReadError::NotExist)
+    {
+        LogMsg(tr("Failed to read RSS session data. %1").arg(readResult.error().message), Log::WARNING);
+        return;
+    }
+
+    // The log will be created from scratch on the next store
+    m_isRewriteNeeded = true;
+
+    const auto legacyReadResult = Utils::IO::readFile(legacyDataFileName, -1);
+    if (!legacyReadResult)
     {
-        if (readResult.error().status == Utils::IO::ReadError::NotExist)
+        if (legacyReadResult.error().status == Utils::IO::ReadError::NotExist)
         {
             emit loadingFinished({});
             return;
         }
 
-        LogMsg(tr("Failed to read RSS session data. %1").arg(readResult.error().message), Log::WARNING);
+        LogMsg(tr("Failed to read RSS session data. %1").arg(legacyReadResult.error().message), Log::WARNING);
         return;
     }
 
-    emit loadingFinished(loadArticles(readResult.value(), url));
+    m_legacyDataFileName = legacyDataFileName;
+    emit loadingFinished(loadArticles(legacyReadResult.value(), url));
 }
 
-void RSS::Private::FeedSerializer::store(const Path &dataFileName, const QList<QVariantHash> &articlesData)
+void RSS::Private::FeedSerializer::store(const Path &dataFileName, const QList<ArticleData> &articlesData)
 {
-    QJsonArray arr;
-    for (const QVariantHash &data : articlesData)
+    if (m_isRewriteNeeded)
     {
-        auto jsonObj = QJsonObject::fromVariantHash(data);
-        // JSON object doesn't support DateTime so we need to convert it
-        jsonObj[Article::KeyDate] = data[Article::KeyDate].toDateTime().toString(Qt::RFC2822Date);
+        rewriteArticlesLog(dataFileName, articlesData);
+        return;
+    }
+
+    QByteArray records;
+    QDataStream stream {&records, QIODevice::WriteOnly};
+    stream.setVersion(ARTICLES_LOG_STREAM_VERSION);
+
+    qsizetype recordCount = m_storedRecordCount;
+    QHash<QString, bool> storedArticles = m_storedArticles;
+    QSet<QString> articleIDs;
+    articleIDs.reserve(articlesData.size());
+    for (const ArticleData &article : articlesData)
+    {
+        articleIDs.insert(article.id);
+
+        const auto storedArticleIter = storedArticles.find(article.id);
+        if (storedArticleIter == storedArticles.end())
+        {
+            writeAddArticleRecord(stream, article);
+            storedArticles.insert(article.id, article.isRead);
+            ++recordCount;
+        }
+        else if (article.isRead && !storedArticleIter.value())
+        {
+            writeArticleIDRecord(stream, RecordType::MarkArticleRead, article.id);
+            storedArticleIter.value() = true;
+            ++recordCount;
+        }
+    }
+
+    for (auto it = storedArticles.begin(); it != storedArticles.end();)
+    {
+        if (articleIDs.contains(it.key()))
+        {
+            ++it;
+            continue;
+        }
 
-        arr << jsonObj;
+        writeArticleIDRecord(stream, RecordType::RemoveArticle, it.key());
+        it = storedArticles.erase(it);
+        ++recordCount;
     }
 
-    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(dataFileName, QJsonDocument(arr).toJson(QJsonDocument::Compact));
+    if (records.isEmpty())
+        return;
+
+    const qsizetype obsoleteRecordCount = recordCount - storedArticles.size();
+    if ((obsoleteRecordCount > MIN_COMPACTION_RECORD_COUNT) && (obsoleteRecordCount > storedArticles.size()))
+    {
+        rewriteArticlesLog(dataFileName, articlesData);
+        return;
+    }
+
+    if (!appendToArticlesLog(dataFileName, records))
+    {
+        // The file may be damaged, so recreate it on the next store
+        m_isRewriteNeeded = true;
+        return;
+    }
+
+    m_storedArticles = storedArticles;
+    m_storedRecordCount = recordCount;
+}
+
+QList<RSS::ArticleData> RSS::Private::FeedSerializer::loadArticlesLog(const QByteArray &data, const QString &url)
+{
+    QDataStream stream {data};
+    stream.setVersion(ARTICLES_LOG_STREAM_VERSION);
+
+    quint32 magic = 0;
+    quint32 version = 0;
+    stream >> magic >> version;
+    if ((stream.status() != QDataStream::Ok) || (magic != ARTICLES_LOG_MAGIC) || (version != ARTICLES_LOG_VERSION))
+    {
+        LogMsg(tr("Couldn't load RSS articles of '%1'. Invalid data format.").arg(url), Log::WARNING);
+        m_isRewriteNeeded = true;
+        return {};
+    }
+
+    QHash<QString, ArticleData> articles;
+    qsizetype recordCount = 0;
+    while (!stream.atEnd())
+    {
+        quint8 type = 0;
+        stream >> type;
+
+        ArticleData article;
+        QString articleID;
+        switch (static_cast<RecordType>(type))
+        {
+        case RecordType::AddArticle:
+            readArticle(stream, article);
+            break;
+        case RecordType::MarkArticleRead:
+        case RecordType::RemoveArticle:
+            stream >> articleID;
+            break;
+        default:
+            stream.setStatus(QDataStream::ReadCorruptData);
+            break;
+        }
+
+        // Incomplete record can be left after crash while appending to the file
+        if (stream.status() != QDataStream::Ok)
+        {
+            LogMsg(tr("Couldn't load some of RSS articles of '%1'. Invalid data format.").arg(url), Log::WARNING);
+            m_isRewriteNeeded = true;
+            break;
+        }
+
+        switch (static_cast<RecordType>(type))
+        {
+        case RecordType::AddArticle:
+            articles.insert(article.id, article);
+            break;
+        case RecordType::MarkArticleRead:
+            if (const auto iter = articles.find(articleID); iter != articles.end())
+                iter->isRead = true;
+            break;
+        case RecordType::RemoveArticle:
+            articles.remove(articleID);
+            break;
+        }
+
+        ++recordCount;
+    }
+
+    QList<ArticleData> result = articles.values();
+    std::ranges::sort(result, [](const ArticleData &left, const ArticleData &right)
+    {
+        return (left.date > right.date);
+    });
+
+    for (const ArticleData &article : asConst(result))
+        m_storedArticles.insert(article.id, article.isRead);
+    m_storedRecordCount = recordCount;
+
+    return result;
+}
+
+void RSS::Private::FeedSerializer::rewriteArticlesLog(const Path &dataFileName, const QList<ArticleData> &articlesData)
+{
+    QByteArray data;
+    QDataStream stream {&data, QIODevice::WriteOnly};
+    stream.setVersion(ARTICLES_LOG_STREAM_VERSION);
+
+    writeHeader(stream);
+    for (const ArticleData &article : articlesData)
+        writeAddArticleRecord(stream, article);
+
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(dataFileName, data);
+    if (!result)
+    {
+        LogMsg(tr("Failed to save RSS feed in '%1', Reason: %2").arg(dataFileName.toString(), result.error())
+               , Log::WARNING);
+        m_isRewriteNeeded = true;
+        return;
+    }
+
+    m_storedArticles.clear();
+    m_storedArticles.reserve(articlesData.size());
+    for (const ArticleData &article : articlesData)
+        m_storedArticles.insert(article.id, article.isRead);
+    m_storedRecordCount = m_storedArticles.size();
+    m_isRewriteNeeded = false;
+
+    if (!m_legacyDataFileName.isEmpty())
+    {
+        Utils::Fs::removeFile(m_legacyDataFileName);
+        m_legacyDataFileName.clear();
+    }
+}
+
+bool RSS::Private::FeedSerializer::appendToArticlesLog(const Path &dataFileName, const QByteArray &records)
+{
+    QFile file {dataFileName.data()};
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Append) || (file.write(records) != records.size()) || !file.flush())
+    {
+        LogMsg(tr("Failed to save RSS feed in '%1', Reason: %2").arg(dataFileName.toString(), file.errorString())
+               , Log::WARNING);
+        return false;
+    }
+
+    return true;
+}
+
+void RSS::Private::FeedSerializer::loadValidators(const Path &fileName)
+{
+    const auto readResult = Utils::IO::readFile(fileName, MAX_VALIDATORS_FILE_SIZE);
+    if (!readResult)
+    {
+        if (readResult.error().status != Utils::IO::ReadError::NotExist)
+        {
+            LogMsg(tr("Failed to read RSS feed validators. %1").arg(readResult.error().message), Log::WARNING);
+        }
+        return;
+    }
+
+    const QJsonObject jsonObj = QJsonDocument::fromJson(readResult.value()).object();
+    emit validatorsLoaded(jsonObj.value(KEY_ETAG).toString(), jsonObj.value(KEY_LASTMODIFIED).toString());
+}
+
+void RSS::Private::FeedSerializer::storeValidators(const Path &fileName, const QString &eTag, const QString &lastModified)
+{
+    if (eTag.isEmpty() && lastModified.isEmpty())
+    {
+        Utils::Fs::removeFile(fileName);
+        return;
+    }
+
+    const QJsonObject jsonObj {
+        {KEY_ETAG, eTag},
+        {KEY_LASTMODIFIED, lastModified}
+    };
+
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(fileName, QJsonDocument(jsonObj).toJson(QJsonDocument::Compact));
     if (!result)
     {
-       LogMsg(tr("Failed to save RSS feed in '%1', Reason: %2").arg(dataFileName.toString(), result.error())
-              , Log::WARNING);
+        LogMsg(tr("Failed to save RSS feed validators in '%1', Reason: %2").arg(fileName.toString(), result.error())
+               , Log::WARNING);
     }
 }
 
-QList<QVariantHash> RSS::Private::FeedSerializer::loadArticles(const QByteArray &data, const QString &url)
+QList<RSS::ArticleData> RSS::Private::FeedSerializer::loadArticles(const QByteArray &data, const QString &url)
 {
     QJsonParseError jsonError;
     const QJsonDocument jsonDoc = QJsonDocument::fromJson(data, &jsonError);
@@ -98,7 +377,7 @@ QList<QVariantHash> RSS::Private::FeedSerializer::loadArticles(const QByteArray
         return {};
     }
 
-    QList<QVariantHash> result;
+    QList<ArticleData> result;
     const QJsonArray jsonArr = jsonDoc.array();
     result.reserve(jsonArr.size());
     for (qsizetype i = 0; i < jsonArr.size(); ++i)
@@ -111,18 +390,12 @@ QList<QVariantHash> RSS::Private::FeedSerializer::loadArticles(const QByteArray
             continue;
         }
 
-        const auto jsonObj = jsonVal.toObject();
-        auto varHash = jsonObj.toVariantHash();
-        // JSON object store DateTime as string so we need to convert it
-        varHash[Article::KeyDate] =
-                QDateTime::fromString(jsonObj.value(Article::KeyDate).toString(), Qt::RFC2822Date);
-
-        result.push_back(varHash);
+        result.push_back(ArticleData::fromJsonObject(jsonVal.toObject()));
     }
 
-    std::ranges::sort(result, [](const QVariantHash &left, const QVariantHash &right)
+    std::ranges::sort(result, [](const ArticleData &left, const ArticleData &right)
     {
-        return (left.value(Article::KeyDate).toDateTime() > right.value(Article::KeyDate).toDateTime());
+        return (left.date > right.date);
     });
 
     return result;
@@ -32,11 +32,12 @@
 #pragma once
 
 #include <QtContainerFwd>
+#include <QHash>
 #include <QObject>
 #include <QString>
-#include <QVariantHash>
 
-#include "base/pathfwd.h"
+#include "base/path.h"
+#include "rss_article.h"
 
 namespace RSS::Private
 {
@@ -48,13 +49,27 @@ namespace RSS::Private
     public:
         using QObject::QObject;
 
-        void load(const Path &dataFileName, const QString &url);
-        void store(const Path &dataFileName, const QList<QVariantHash> &articlesData);
+        // Articles are stored in a binary log of changes which is compacted from time to time,
+        // the legacy JSON file is only read if the log doesn't exist yet
+        void load(const Path &dataFileName, const Path &legacyDataFileName, const QString &url);
+        void store(const Path &dataFileName, const QList<ArticleData> &articlesData);
+        void loadValidators(const Path &fileName);
+        void storeValidators(const Path &fileName, const QString &eTag, const QString &lastModified);
 
     signals:
-        void loadingFinished(const QList<QVariantHash> &articles);
+        void loadingFinished(const QList<ArticleData> &articles);
+        void validatorsLoaded(const QString &eTag, const QString &lastModified);
 
     private:
-        QList<QVariantHash> loadArticles(const QByteArray &data, const QString &url);
+        QList<ArticleData> loadArticles(const QByteArray &data, const QString &url);
+        QList<ArticleData> loadArticlesLog(const QByteArray &data, const QString &url);
+        void rewriteArticlesLog(const Path &dataFileName, const QList<ArticleData> &articlesData);
+        bool appendToArticlesLog(const Path &dataFileName, const QByteArray &records);
+
+        // Articles in the log file, it allows to append only the changes when storing articles
+        QHash<QString, bool> m_storedArticles; // article ID -> "is read" flag
+        qsizetype m_storedRecordCount = 0;
+        bool m_isRewriteNeeded = false;
+        Path m_legacyDataFileName;
     };
 }
@@ -30,9 +30,12 @@
 
 #include "rss_article.h"
 
+#include <QJsonObject>
+#include <QJsonValue>
 #include <QVariant>
 
 #include "base/global.h"
+#include "base/utils/memory.h"
 #include "rss_feed.h"
 
 using namespace RSS;
@@ -46,72 +49,133 @@ const QString Article::KeyTorrentURL = u"torrentURL"_s;
 const QString Article::KeyLink = u"link"_s;
 const QString Article::KeyIsRead = u"isRead"_s;
 
-Article::Article(Feed *feed, const QVariantHash &varHash)
+void ArticleData::setValue(const QString &key, const QVariant &value)
+{
+    if (key == Article::KeyId)
+        id = value.toString();
+    else if (key == Article::KeyDate)
+        date = value.toDateTime();
+    else if (key == Article::KeyTitle)
+        title = value.toString();
+    else if (key == Article::KeyAuthor)
+        author = value.toString();
+    else if (key == Article::KeyDescription)
+        description = value.toString();
+    else if (key == Article::KeyTorrentURL)
+        torrentURL = value.toString();
+    else if (key == Article::KeyLink)
+        link = value.toString();
+    else if (key == Article::KeyIsRead)
+        isRead = value.toBool();
+    else
+        extraData[key] = value;
+}
+
+qint64 ArticleData::estimatedHeapSize() const
+{
+    return Utils::Memory::estimateHeapSize(id) + Utils::Memory::estimateHeapSize(title)
+        + Utils::Memory::estimateHeapSize(author) + Utils::Memory::estimateHeapSize(description)
+        + Utils::Memory::estimateHeapSize(torrentURL) + Utils::Memory::estimateHeapSize(link)
+        + Utils::Memory::estimateHeapSize(extraData);
+}
+
+QJsonObject ArticleData::toJsonObject() const
+{
+    QJsonObject jsonObj = QJsonObject::fromVariantHash(extraData);
+
+    // Empty fields are omitted, as they are when the tag is missing in the feed
+    const auto insertString = [&jsonObj](const QString &key, const QString &value)
+    {
+        if (!value.isEmpty())
+            jsonObj[key] = value;
+    };
+
+    insertString(Article::KeyId, id);
+    insertString(Article::KeyTitle, title);
+    insertString(Article::KeyAuthor, author);
+    insertString(Article::KeyDescription, description);
+    insertString(Article::KeyTorrentURL, torrentURL);
+    insertString(Article::KeyLink, link);
+    // JSON object doesn't support DateTime so we need to convert it
+    jsonObj[Article::KeyDate] = date.toString(Qt::RFC2822Date);
+    if (isRead)
+        jsonObj[Article::KeyIsRead] = true;
+
+    return jsonObj;
+}
+
+ArticleData ArticleData::fromJsonObject(const QJsonObject &jsonObj)
+{
+    ArticleData data;
+    for (auto it = jsonObj.constBegin(); it != jsonObj.constEnd(); ++it)
+    {
+        // JSON object store DateTime as string so we need to convert it
+        if (it.key() == Article::KeyDate)
+            data.date = QDateTime::fromString(it.value().toString(), Qt::RFC2822Date);
+        else
+            data.setValue(it.key(), it.value().toVariant());
+    }
+
+    return data;
+}
+
+Article::Article(Feed *feed, const ArticleData &data)
     : QObject(feed)
     , m_feed {feed}
-    , m_guid {varHash.value(KeyId).toString()}
-    , m_date {varHash.value(KeyDate).toDateTime()}
-    , m_title {varHash.value(KeyTitle).toString()}
-    , m_author {varHash.value(KeyAuthor).toString()}
-    , m_description {varHash.value(KeyDescription).toString()}
-    , m_torrentURL {varHash.value(KeyTorrentURL).toString()}
-    , m_link {varHash.value(KeyLink).toString()}
-    , m_isRead {varHash.value(KeyIsRead, false).toBool()}
-    , m_data {varHash}
+    , m_data {data}
 {
 }
 
 QString Article::guid() const
 {
-    return m_guid;
+    return m_data.id;
 }
 
 QDateTime Article::date() const
 {
-    return m_date;
+    return m_data.date;
 }
 
 QString Article::title() const
 {
-    return m_title;
+    return m_data.title;
 }
 
 QString Article::author() const
 {
-    return m_author;
+    return m_data.author;
 }
 
 QString Article::description() const
 {
-    return m_description;
+    return m_data.description;
 }
 
 QString Article::torrentUrl() const
 {
-    return (m_torrentURL.isEmpty() ? m_link : m_torrentURL);
+    return (m_data.torrentURL.isEmpty() ? m_data.link : m_data.torrentURL);
 }
 
 QString Article::link() const
 {
-    return m_link;
+    return m_data.link;
 }
 
 bool Article::isRead() const
 {
-    return m_isRead;
+    return m_data.isRead;
 }
 
-QVariantHash Article::data() const
+const ArticleData &Article::data() const
 {
     return m_data;
 }
 
 void Article::markAsRead()
 {
-    if (!m_isRead)
+    if (!m_data.isRead)
     {
-        m_isRead = true;
-        m_data[KeyIsRead] = m_isRead;
+        m_data.isRead = true;
         emit read(this);
     }
 }
@@ -35,10 +35,33 @@
 #include <QString>
 #include <QVariantHash>
 
+class QJsonObject;
+
 namespace RSS
 {
     class Feed;
 
+    // Values of the tags the application knows about are kept in typed fields,
+    // values of any other tags found in the feed go to `extraData`
+    struct ArticleData
+    {
+        QString id;
+        QDateTime date;
+        QString title;
+        QString author;
+        QString description;
+        QString torrentURL;
+        QString link;
+        bool isRead = false;
+        QVariantHash extraData;
+
+        void setValue(const QString &key, const QVariant &value);
+        qint64 estimatedHeapSize() const;
+
+        QJsonObject toJsonObject() const;
+        static ArticleData fromJsonObject(const QJsonObject &jsonObj);
+    };
+
     class Article final : public QObject
     {
         Q_OBJECT
@@ -46,7 +69,7 @@ namespace RSS
 
         friend class Feed;
 
-        Article(Feed *feed, const QVariantHash &varHash);
+        Article(Feed *feed, const ArticleData &data);
 
     public:
         static const QString KeyId;
@@ -67,7 +90,7 @@ namespace RSS
         QString torrentUrl() const;
         QString link() const;
         bool isRead() const;
-        QVariantHash data() const;
+        const ArticleData &data() const;
 
         void markAsRead();
 
@@ -78,14 +101,6 @@ namespace RSS
 
     private:
         Feed *m_feed = nullptr;
-        QString m_guid;
-        QDateTime m_date;
-        QString m_title;
-        QString m_author;
-        QString m_description;
-        QString m_torrentURL;
-        QString m_link;
-        bool m_isRead = false;
-        QVariantHash m_data;
+        ArticleData m_data;
     };
 }
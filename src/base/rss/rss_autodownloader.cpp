@@ -50,6 +50,7 @@
 #include "base/interfaces/iapplication.h"
 #include "base/logger.h"
 #include "base/profile.h"
+#include "base/tracer.h"
 #include "base/utils/fs.h"
 #include "base/utils/io.h"
 #include "rss_article.h"
@@ -61,7 +62,7 @@
 struct ProcessingJob
 {
     QString feedURL;
-    QVariantHash articleData;
+    RSS::ArticleData articleData;
 };
 
 const QString CONF_FOLDER_NAME = u"rss"_s;
@@ -111,6 +112,8 @@ AutoDownloader::AutoDownloader(IApplication *app)
     , m_processingTimer {new QTimer(this)}
     , m_ioThread {new QThread}
 {
+    const TraceSpan traceSpan {"RSS::AutoDownloader::AutoDownloader"};
+
     Q_ASSERT(!m_instance); // only one instance is allowed
     m_instance = this;
 
@@ -125,6 +128,7 @@ AutoDownloader::AutoDownloader(IApplication *app)
     });
 
     m_ioThread->setObjectName("RSS::AutoDownloader m_ioThread");
+    Utils::Thread::setWorkload(m_ioThread.get(), Utils::Thread::Workload::Bulk);
     m_ioThread->start();
 
     connect(app->addTorrentManager(), &AddTorrentManager::torrentAdded
@@ -240,6 +244,7 @@ void AutoDownloader::removeRule(const QString &ruleName)
         const AutoDownloadRule &rule = m_rules[i];
         m_rulesByName[rule.name()] = i;
     }
+    m_isRuleIndexOutdated = true;
 
     m_dirty = true;
     store();
@@ -371,7 +376,7 @@ void AutoDownloader::handleTorrentAdded(const QString &source)
 
     if (Feed *feed = Session::instance()->feedByURL(job->feedURL))
     {
-        if (Article *article = feed->articleByGUID(job->articleData.value(Article::KeyId).toString()))
+        if (Article *article = feed->articleByGUID(job->articleData.id))
             article->markAsRead();
     }
 }
@@ -386,7 +391,7 @@ void AutoDownloader::handleAddTorrentFailed(const QString &source, const BitTorr
     {
         if (Feed *feed = Session::instance()->feedByURL(job->feedURL))
         {
-            if (Article *article = feed->articleByGUID(job->articleData.value(Article::KeyId).toString()))
+            if (Article *article = feed->articleByGUID(job->articleData.id))
                 article->markAsRead();
         }
     }
@@ -412,6 +417,7 @@ void AutoDownloader::handleFeedURLChanged(Feed *feed, const QString &oldURL)
             feedURLs.replace(i, feed->url());
             rule.setFeedURLs(feedURLs);
             m_dirty = true;
+            m_isRuleIndexOutdated = true;
         }
     }
 
@@ -443,6 +449,8 @@ void AutoDownloader::setRule_impl(const AutoDownloadRule &rule)
     {
         m_rules[index] = rule;
     }
+
+    m_isRuleIndexOutdated = true;
 }
 
 void AutoDownloader::sortRules()
@@ -457,6 +465,8 @@ void AutoDownloader::sortRules()
         const AutoDownloadRule &rule = m_rules[i];
         m_rulesByName[rule.name()] = i;
     }
+
+    m_isRuleIndexOutdated = true;
 }
 
 void AutoDownloader::addJobForArticle(const Article *article)
@@ -475,12 +485,16 @@ void AutoDownloader::addJobForArticle(const Article *article)
 
 void AutoDownloader::processJob(const QSharedPointer<ProcessingJob> &job)
 {
-    for (AutoDownloadRule &rule : m_rules)
+    if (m_isRuleIndexOutdated)
     {
-        if (!rule.isEnabled())
-            continue;
-        if (!rule.feedURLs().contains(job->feedURL))
-            continue;
+        m_ruleIndex.rebuild(m_rules);
+        m_isRuleIndexOutdated = false;
+    }
+
+    // Only the rules which may accept the article need to evaluate their expressions
+    for (const qsizetype ruleIndex : asConst(m_ruleIndex.candidateRules(job->feedURL, job->articleData.title)))
+    {
+        AutoDownloadRule &rule = m_rules[ruleIndex];
         if (!rule.accepts(job->articleData))
             continue;
 
@@ -488,16 +502,16 @@ void AutoDownloader::processJob(const QSharedPointer<ProcessingJob> &job)
         storeDeferred();
 
         LogMsg(tr("RSS article '%1' is accepted by rule '%2'. Trying to add torrent...")
-                .arg(job->articleData.value(Article::KeyTitle).toString(), rule.name()));
+                .arg(job->articleData.title, rule.name()));
 
-        const auto torrentURL = job->articleData.value(Article::KeyTorrentURL).toString();
+        const auto torrentURL = job->articleData.torrentURL;
         app()->addTorrentManager()->addTorrent(torrentURL, rule.addTorrentParams());
 
         if (BitTorrent::TorrentDescriptor::parse(torrentURL))
         {
             if (Feed *feed = Session::instance()->feedByURL(job->feedURL))
             {
-                if (Article *article = feed->articleByGUID(job->articleData.value(Article::KeyId).toString()))
+                if (Article *article = feed->articleByGUID(job->articleData.id))
                     article->markAsRead();
             }
         }
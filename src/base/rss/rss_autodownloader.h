@@ -40,6 +40,7 @@
 #include "base/exceptions.h"
 #include "base/settingvalue.h"
 #include "base/utils/thread.h"
+#include "rss_autodownloadruleindex.h"
 
 class QTimer;
 
@@ -149,6 +150,8 @@ namespace RSS
         AsyncFileStorage *m_fileStorage = nullptr;
         QList<AutoDownloadRule> m_rules;
         QHash<QString, qsizetype> m_rulesByName;
+        Private::AutoDownloadRuleIndex m_ruleIndex;
+        bool m_isRuleIndexOutdated = true;
         QList<QSharedPointer<ProcessingJob>> m_processingQueue;
         QHash<QString, QSharedPointer<ProcessingJob>> m_waitingJobs;
         bool m_dirty = false;
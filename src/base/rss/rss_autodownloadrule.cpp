@@ -44,9 +44,11 @@
 #include "base/path.h"
 #include "base/preferences.h"
 #include "base/utils/fs.h"
+#include "base/utils/regex.h"
 #include "base/utils/string.h"
 #include "rss_article.h"
 #include "rss_autodownloader.h"
+#include "rss_episodehistory.h"
 #include "rss_feed.h"
 
 namespace
@@ -140,10 +142,9 @@ namespace RSS
         BitTorrent::AddTorrentParams addTorrentParams;
 
         bool smartFilter = false;
-        QStringList previouslyMatchedEpisodes;
+        EpisodeHistory previouslyMatchedEpisodes;
 
         mutable QStringList lastComputedEpisodes;
-        mutable QHash<QString, QRegularExpression> cachedRegexes;
 
         friend bool operator==(const AutoDownloadRuleData &left, const AutoDownloadRuleData &right)
         {
@@ -205,23 +206,16 @@ AutoDownloadRule::~AutoDownloadRule() = default;
 QRegularExpression AutoDownloadRule::cachedRegex(const QString &expression, const bool isRegex) const
 {
     // Use a cache of regexes so we don't have to continually recompile - big performance increase.
-    // The cache is cleared whenever the regex/wildcard, must or must not contain fields or
-    // episode filter are modified.
+    // The cache is shared by all the rules, so rules with the same expressions reuse the compiled regexes.
     Q_ASSERT(!expression.isEmpty());
 
-    QRegularExpression &regex = m_dataPtr->cachedRegexes[expression];
-    if (regex.pattern().isEmpty())
-    {
-        const QString pattern = (isRegex ? expression : Utils::String::wildcardToRegexPattern(expression));
-        regex = QRegularExpression {pattern, QRegularExpression::CaseInsensitiveOption};
-    }
-
-    return regex;
+    const QString pattern = (isRegex ? expression : Utils::String::wildcardToRegexPattern(expression));
+    return Utils::Regex::cached(pattern, QRegularExpression::CaseInsensitiveOption);
 }
 
 bool AutoDownloadRule::matchesExpression(const QString &articleTitle, const QString &expression) const
 {
-    const QRegularExpression whitespace {u"\\s+"_s};
+    const QRegularExpression whitespace = Utils::Regex::cached(u"\\s+"_s);
 
     if (expression.isEmpty())
     {
@@ -407,16 +401,16 @@ bool AutoDownloadRule::matchesSmartEpisodeFilter(const QString &articleTitle) co
     return true;
 }
 
-bool AutoDownloadRule::matches(const QVariantHash &articleData) const
+bool AutoDownloadRule::matches(const ArticleData &articleData) const
 {
-    const QDateTime articleDate {articleData[Article::KeyDate].toDateTime()};
+    const QDateTime &articleDate = articleData.date;
     if (ignoreDays() > 0)
     {
         if (lastMatch().isValid() && (articleDate < lastMatch().addDays(ignoreDays())))
             return false;
     }
 
-    const QString articleTitle {articleData[Article::KeyTitle].toString()};
+    const QString &articleTitle = articleData.title;
     if (!matchesMustContainExpression(articleTitle))
         return false;
     if (!matchesMustNotContainExpression(articleTitle))
@@ -429,17 +423,18 @@ bool AutoDownloadRule::matches(const QVariantHash &articleData) const
     return true;
 }
 
-bool AutoDownloadRule::accepts(const QVariantHash &articleData)
+bool AutoDownloadRule::accepts(const ArticleData &articleData)
 {
     if (!matches(articleData))
         return false;
 
-    setLastMatch(articleData[Article::KeyDate].toDateTime());
+    setLastMatch(articleData.date);
 
     // If there's a matched episode string, add that to the previously matched list
     if (!m_dataPtr->lastComputedEpisodes.isEmpty())
     {
-        m_dataPtr->previouslyMatchedEpisodes.append(m_dataPtr->lastComputedEpisodes);
+        for (const QString &episode : asConst(m_dataPtr->lastComputedEpisodes))
+            m_dataPtr->previouslyMatchedEpisodes.insert(episode);
         m_dataPtr->lastComputedEpisodes.clear();
     }
 
@@ -605,8 +600,6 @@ AutoDownloadRule AutoDownloadRule::fromLegacyDict(const QVariantHash &dict)
 
 void AutoDownloadRule::setMustContain(const QString &tokens)
 {
-    m_dataPtr->cachedRegexes.clear();
-
     if (m_dataPtr->useRegex)
         m_dataPtr->mustContain = QStringList() << tokens;
     else
@@ -619,8 +612,6 @@ void AutoDownloadRule::setMustContain(const QString &tokens)
 
 void AutoDownloadRule::setMustNotContain(const QString &tokens)
 {
-    m_dataPtr->cachedRegexes.clear();
-
     if (m_dataPtr->useRegex)
         m_dataPtr->mustNotContain = QStringList() << tokens;
     else
@@ -729,17 +720,16 @@ bool AutoDownloadRule::useRegex() const
 void AutoDownloadRule::setUseRegex(const bool enabled)
 {
     m_dataPtr->useRegex = enabled;
-    m_dataPtr->cachedRegexes.clear();
 }
 
 QStringList AutoDownloadRule::previouslyMatchedEpisodes() const
 {
-    return m_dataPtr->previouslyMatchedEpisodes;
+    return m_dataPtr->previouslyMatchedEpisodes.toStringList();
 }
 
 void AutoDownloadRule::setPreviouslyMatchedEpisodes(const QStringList &previouslyMatchedEpisodes)
 {
-    m_dataPtr->previouslyMatchedEpisodes = previouslyMatchedEpisodes;
+    m_dataPtr->previouslyMatchedEpisodes = EpisodeHistory(previouslyMatchedEpisodes);
 }
 
 QString AutoDownloadRule::episodeFilter() const
@@ -750,5 +740,4 @@ QString AutoDownloadRule::episodeFilter() const
 void AutoDownloadRule::setEpisodeFilter(const QString &e)
 {
     m_dataPtr->episodeFilter = e;
-    m_dataPtr->cachedRegexes.clear();
 }
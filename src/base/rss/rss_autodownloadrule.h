@@ -44,6 +44,7 @@ class QRegularExpression;
 
 namespace RSS
 {
+    struct ArticleData;
     struct AutoDownloadRuleData;
 
     class AutoDownloadRule
@@ -81,14 +82,15 @@ namespace RSS
         QString episodeFilter() const;
         void setEpisodeFilter(const QString &e);
 
+        // The consecutive episodes of a season are listed as ranges, e.g. "01x01-24"
         QStringList previouslyMatchedEpisodes() const;
         void setPreviouslyMatchedEpisodes(const QStringList &previouslyMatchedEpisodes);
 
         BitTorrent::AddTorrentParams addTorrentParams() const;
         void setAddTorrentParams(BitTorrent::AddTorrentParams addTorrentParams);
 
-        bool matches(const QVariantHash &articleData) const;
-        bool accepts(const QVariantHash &articleData);
+        bool matches(const ArticleData &articleData) const;
+        bool accepts(const ArticleData &articleData);
 
         friend bool operator==(const AutoDownloadRule &left, const AutoDownloadRule &right);
 
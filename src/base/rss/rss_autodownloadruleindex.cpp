@@ -0,0 +1,285 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "rss_autodownloadruleindex.h"
+
+#include <algorithm>
+#include <queue>
+
+#include <QList>
+#include <QRegularExpression>
+#include <QStringList>
+
+#include "base/global.h"
+#include "base/utils/regex.h"
+#include "rss_autodownloadrule.h"
+
+namespace
+{
+    char toLowerASCII(const QChar ch)
+    {
+        const char16_t code = ch.unicode();
+        if ((code >= u'A') && (code <= u'Z'))
+            return static_cast<char>(code - u'A' + 'a');
+        return static_cast<char>(code);
+    }
+
+    // Characters that are certainly matched only by themselves (ignoring ASCII case).
+    // Non-ASCII characters and the letters 'k' and 's' are excluded since they can
+    // be matched case-insensitively by some non-ASCII characters (e.g. KELVIN SIGN).
+    bool isLiteralChar(const QChar ch)
+    {
+        const char16_t code = ch.unicode();
+        if ((code <= u' ') || (code >= 0x7F))
+            return false;
+
+        switch (toLowerASCII(ch))
+        {
+        case '*':
+        case '?':
+        case '/':
+        case '\\':
+        case 'k':
+        case 's':
+            return false;
+        default:
+            return true;
+        }
+    }
+
+    // Longest sequence of characters which must be present in the text matched by the wildcard
+    QByteArray longestLiteral(const QString &wildcard)
+    {
+        QByteArray longest;
+        QByteArray current;
+        for (const QChar ch : wildcard)
+        {
+            // Don't try to interpret character sets
+            if ((ch == u'[') || (ch == u']'))
+                break;
+
+            if (isLiteralChar(ch))
+            {
+                current.append(toLowerASCII(ch));
+            }
+            else
+            {
+                if (current.size() > longest.size())
+                    longest = current;
+                current.clear();
+            }
+        }
+
+        return (current.size() > longest.size()) ? current : longest;
+    }
+}
+
+void RSS::Private::AutoDownloadRuleIndex::rebuild(const QList<AutoDownloadRule> &rules)
+{
+    clear();
+
+    const QRegularExpression whitespace = Utils::Regex::cached(u"\\s+"_s);
+
+    m_ruleFilters.resize(rules.size());
+    for (qsizetype i = 0; i < rules.size(); ++i)
+    {
+        const AutoDownloadRule &rule = rules[i];
+        if (!rule.isEnabled())
+            continue;
+
+        for (const QString &feedURL : asConst(rule.feedURLs()))
+        {
+            QList<qsizetype> &feedRules = m_rulesByFeedURL[feedURL];
+            if (feedRules.isEmpty() || (feedRules.last() != i))
+                feedRules.append(i);
+        }
+
+        // Regular expressions aren't analyzed
+        if (rule.useRegex())
+            continue;
+
+        const QString mustContain = rule.mustContain();
+        if (mustContain.isEmpty())
+            continue;
+
+        RuleFilter filter;
+        bool isFilterable = true;
+        for (const QString &expression : asConst(mustContain.split(u'|')))
+        {
+            std::vector<int> literals;
+            for (const QString &wildcard : asConst(expression.split(whitespace, Qt::SkipEmptyParts)))
+            {
+                const QByteArray literal = longestLiteral(wildcard);
+                if (!literal.isEmpty())
+                    literals.push_back(addLiteral(literal));
+            }
+
+            // Expression without literals can match any title
+            if (literals.empty())
+            {
+                isFilterable = false;
+                break;
+            }
+
+            filter.push_back(std::move(literals));
+        }
+
+        if (isFilterable)
+            m_ruleFilters[i] = std::move(filter);
+    }
+
+    buildFailureLinks();
+}
+
+void RSS::Private::AutoDownloadRuleIndex::clear()
+{
+    m_rulesByFeedURL.clear();
+    m_ruleFilters.clear();
+    m_nodes.assign(1, {});
+    m_literalIDs.clear();
+}
+
+QList<qsizetype> RSS::Private::AutoDownloadRuleIndex::candidateRules(const QString &feedURL, const QString &articleTitle) const
+{
+    const QList<qsizetype> feedRules = m_rulesByFeedURL.value(feedURL);
+    if (feedRules.isEmpty())
+        return {};
+
+    std::vector<char> foundLiterals;
+    if (!m_literalIDs.isEmpty())
+    {
+        foundLiterals.resize(m_literalIDs.size(), false);
+
+        int node = 0;
+        for (const QChar ch : articleTitle)
+        {
+            if (!isLiteralChar(ch))
+            {
+                node = 0;
+                continue;
+            }
+
+            const char lowerCh = toLowerASCII(ch);
+            int child = findChild(node, lowerCh);
+            while ((child < 0) && (node != 0))
+            {
+                node = m_nodes[node].failure;
+                child = findChild(node, lowerCh);
+            }
+            node = std::max(child, 0);
+
+            for (const int literalID : m_nodes[node].literals)
+                foundLiterals[literalID] = true;
+        }
+    }
+
+    QList<qsizetype> candidates;
+    candidates.reserve(feedRules.size());
+    for (const qsizetype ruleIndex : feedRules)
+    {
+        const RuleFilter &filter = m_ruleFilters[ruleIndex];
+        const bool isCandidate = filter.empty() || std::ranges::any_of(filter, [&foundLiterals](const std::vector<int> &literals)
+        {
+            return std::ranges::all_of(literals, [&foundLiterals](const int literalID) { return foundLiterals[literalID]; });
+        });
+
+        if (isCandidate)
+            candidates.append(ruleIndex);
+    }
+
+    return candidates;
+}
+
+int RSS::Private::AutoDownloadRuleIndex::addLiteral(const QByteArray &literal)
+{
+    if (const auto iter = m_literalIDs.constFind(literal); iter != m_literalIDs.cend())
+        return iter.value();
+
+    int node = 0;
+    for (const char ch : literal)
+    {
+        int child = findChild(node, ch);
+        if (child < 0)
+        {
+            child = static_cast<int>(m_nodes.size());
+            m_nodes.emplace_back();
+
+            std::vector<std::pair<char, int>> &children = m_nodes[node].children;
+            const auto pos = std::ranges::lower_bound(children, ch, {}, &std::pair<char, int>::first);
+            children.insert(pos, {ch, child});
+        }
+        node = child;
+    }
+
+    const int literalID = static_cast<int>(m_literalIDs.size());
+    m_literalIDs.insert(literal, literalID);
+    m_nodes[node].literals.push_back(literalID);
+    return literalID;
+}
+
+int RSS::Private::AutoDownloadRuleIndex::findChild(const int node, const char ch) const
+{
+    const std::vector<std::pair<char, int>> &children = m_nodes[node].children;
+    const auto iter = std::ranges::lower_bound(children, ch, {}, &std::pair<char, int>::first);
+    return ((iter != children.cend()) && (iter->first == ch)) ? iter->second : -1;
+}
+
+void RSS::Private::AutoDownloadRuleIndex::buildFailureLinks()
+{
+    std::queue<int> nodes;
+    for (const auto &[ch, child] : m_nodes[0].children)
+    {
+        m_nodes[child].failure = 0;
+        nodes.push(child);
+    }
+
+    // Breadth-first traversal guarantees that failure links of the shallower nodes are ready
+    while (!nodes.empty())
+    {
+        const int node = nodes.front();
+        nodes.pop();
+
+        for (const auto &[ch, child] : m_nodes[node].children)
+        {
+            int failure = m_nodes[node].failure;
+            int failureChild = findChild(failure, ch);
+            while ((failureChild < 0) && (failure != 0))
+            {
+                failure = m_nodes[failure].failure;
+                failureChild = findChild(failure, ch);
+            }
+
+            m_nodes[child].failure = std::max(failureChild, 0);
+            // Literals that are suffixes of the current one are found together with it
+            const std::vector<int> &suffixLiterals = m_nodes[m_nodes[child].failure].literals;
+            m_nodes[child].literals.insert(m_nodes[child].literals.end(), suffixLiterals.cbegin(), suffixLiterals.cend());
+
+            nodes.push(child);
+        }
+    }
+}
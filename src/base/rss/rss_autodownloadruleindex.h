@@ -0,0 +1,81 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include <QtTypes>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+namespace RSS
+{
+    class AutoDownloadRule;
+}
+
+namespace RSS::Private
+{
+    // Selects the rules that may accept an article without evaluating their regular expressions.
+    // Rules are looked up by feed URL, then the literal parts of their "must contain" wildcards
+    // are searched in the article title all at once using Aho-Corasick automaton.
+    class AutoDownloadRuleIndex
+    {
+    public:
+        void rebuild(const QList<AutoDownloadRule> &rules);
+        void clear();
+
+        // Indexes of the enabled rules affecting the feed in the original order of the rules,
+        // the rules still need to be checked whether they accept the article
+        QList<qsizetype> candidateRules(const QString &feedURL, const QString &articleTitle) const;
+
+    private:
+        struct Node
+        {
+            std::vector<std::pair<char, int>> children; // sorted by character
+            int failure = 0;
+            std::vector<int> literals; // literals ending at this node
+        };
+
+        // Rule can match if all the literals of any of the alternatives are found in the title,
+        // the rule without alternatives is always a candidate
+        using RuleFilter = std::vector<std::vector<int>>;
+
+        int addLiteral(const QByteArray &literal);
+        int findChild(int node, char ch) const;
+        void buildFailureLinks();
+
+        QHash<QString, QList<qsizetype>> m_rulesByFeedURL;
+        std::vector<RuleFilter> m_ruleFilters;
+        std::vector<Node> m_nodes;
+        QHash<QByteArray, int> m_literalIDs;
+    };
+}
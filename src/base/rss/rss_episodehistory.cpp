@@ -0,0 +1,134 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "rss_episodehistory.h"
+
+#include <algorithm>
+#include <optional>
+
+#include <QList>
+#include <QStringView>
+
+#include "base/global.h"
+
+namespace
+{
+    struct Episode
+    {
+        int season = 0;
+        int number = 0;
+    };
+
+    std::optional<int> parseNumber(const QStringView str)
+    {
+        if (str.isEmpty() || !std::ranges::all_of(str, [](const QChar ch) { return ch.isDigit() && (ch.unicode() < 128); }))
+            return std::nullopt;
+
+        bool ok = false;
+        const int number = str.toInt(&ok);
+        return ok ? std::optional<int>(number) : std::nullopt;
+    }
+
+    // Parses "<season>x<episode>"
+    std::optional<Episode> parseEpisode(const QStringView entry)
+    {
+        const qsizetype separatorPos = entry.indexOf(u'x');
+        if (separatorPos < 0)
+            return std::nullopt;
+
+        const std::optional<int> season = parseNumber(entry.first(separatorPos));
+        const std::optional<int> number = parseNumber(entry.sliced(separatorPos + 1));
+        if (!season || !number)
+            return std::nullopt;
+
+        return Episode {.season = *season, .number = *number};
+    }
+
+    QString formatEpisodeNumber(const int number)
+    {
+        return u"%1"_s.arg(number, 2, 10, u'0');
+    }
+}
+
+RSS::EpisodeHistory::EpisodeHistory(const QStringList &entries)
+{
+    for (const QString &entry : entries)
+        insert(entry);
+}
+
+bool RSS::EpisodeHistory::isEmpty() const
+{
+    return m_seasons.isEmpty() && m_otherEntries.isEmpty();
+}
+
+bool RSS::EpisodeHistory::contains(const QString &episode) const
+{
+    if (const std::optional<Episode> parsedEpisode = parseEpisode(episode))
+    {
+        const auto seasonIter = m_seasons.constFind(parsedEpisode->season);
+        return (seasonIter != m_seasons.cend()) && seasonIter->contains(parsedEpisode->number);
+    }
+
+    return m_otherEntries.contains(episode);
+}
+
+void RSS::EpisodeHistory::insert(const QString &episode)
+{
+    if (const std::optional<Episode> parsedEpisode = parseEpisode(episode))
+        m_seasons[parsedEpisode->season].insert(parsedEpisode->number);
+    else
+        m_otherEntries.insert(episode);
+}
+
+void RSS::EpisodeHistory::clear()
+{
+    m_seasons.clear();
+    m_otherEntries.clear();
+}
+
+QStringList RSS::EpisodeHistory::toStringList() const
+{
+    QList<int> seasons = m_seasons.keys();
+    std::ranges::sort(seasons);
+
+    QStringList entries;
+    for (const int season : asConst(seasons))
+    {
+        QList<int> episodes = m_seasons.constFind(season)->values();
+        std::ranges::sort(episodes);
+
+        const QString seasonStr = formatEpisodeNumber(season);
+        for (const int episode : asConst(episodes))
+            entries.append(u"%1x%2"_s.arg(seasonStr, formatEpisodeNumber(episode)));
+    }
+
+    QStringList otherEntries = m_otherEntries.values();
+    otherEntries.sort();
+    entries.append(otherEntries);
+    return entries;
+}
@@ -41,6 +41,7 @@
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QList>
+#include <QThread>
 #include <QUrl>
 
 #include "base/asyncfilestorage.h"
@@ -75,24 +76,30 @@ Feed::Feed(Session *session, const QUuid &uid, const QString &url, const QString
     , m_refreshInterval {refreshInterval}
 {
     const auto uidHex = QString::fromLatin1(m_uid.toRfc4122().toHex());
-    m_dataFileName = Path(uidHex + u".json");
+    m_dataFileName = Path(uidHex + u".dat");
+    m_legacyDataFileName = Path(uidHex + u".json");
+    m_validatorsFileName = Path(uidHex + u".validators.json");
 
     // Move to new file naming scheme (since v4.1.2)
     const QString legacyFilename = Utils::Fs::toValidFileName(m_url, u"_"_s) + u".json";
     const Path storageDir = m_session->dataFileStorage()->storageDir();
-    const Path dataFilePath = storageDir / m_dataFileName;
-    if (!dataFilePath.exists())
-        Utils::Fs::renameFile((storageDir / Path(legacyFilename)), dataFilePath);
+    const Path legacyDataFilePath = storageDir / m_legacyDataFileName;
+    if (!legacyDataFilePath.exists() && !(storageDir / m_dataFileName).exists())
+        Utils::Fs::renameFile((storageDir / Path(legacyFilename)), legacyDataFilePath);
 
     m_iconPath = storageDir / Path(uidHex + u".ico");
 
+    // Both serializer and parser live in the same thread so the jobs of this feed are processed in order
+    QThread *workingThread = m_session->nextFeedWorkingThread();
+
     m_serializer = new Private::FeedSerializer;
-    m_serializer->moveToThread(m_session->workingThread());
+    m_serializer->moveToThread(workingThread);
     connect(this, &Feed::destroyed, m_serializer, &Private::FeedSerializer::deleteLater);
     connect(m_serializer, &Private::FeedSerializer::loadingFinished, this, &Feed::handleArticleLoadFinished);
+    connect(m_serializer, &Private::FeedSerializer::validatorsLoaded, this, &Feed::handleValidatorsLoaded);
 
     m_parser = new Private::Parser(m_lastBuildDate);
-    m_parser->moveToThread(m_session->workingThread());
+    m_parser->moveToThread(workingThread);
     connect(this, &Feed::destroyed, m_parser, &Private::Parser::deleteLater);
     connect(m_parser, &Private::Parser::finished, this, &Feed::handleParsingFinished);
 
@@ -154,7 +161,14 @@ void Feed::refresh()
 
     // NOTE: Should we allow manually refreshing for disabled session?
 
-    m_downloadHandler = Net::DownloadManager::instance()->download(m_url, Preferences::instance()->useProxyForRSS());
+    // Ask the server to send the feed content only if it was changed since the last update
+    Net::DownloadRequest request {m_url};
+    if (!m_eTag.isEmpty())
+        request.rawHeader("If-None-Match", m_eTag.toLatin1());
+    if (!m_lastModified.isEmpty())
+        request.rawHeader("If-Modified-Since", m_lastModified.toLatin1());
+
+    m_downloadHandler = Net::DownloadManager::instance()->download(request, Preferences::instance()->useProxyForRSS());
     connect(m_downloadHandler, &Net::DownloadHandler::finished, this, &Feed::handleDownloadFinished);
 
     if (!m_iconPath.exists())
@@ -231,6 +245,20 @@ void Feed::handleDownloadFinished(const Net::DownloadResult &result)
 
     if (result.status == Net::DownloadStatus::Success)
     {
+        if (result.httpStatusCode == 304)
+        {
+            m_isLoading = false;
+            m_hasError = false;
+
+            LogMsg(tr("RSS feed at '%1' is not modified since the last update.").arg(result.url));
+
+            emit stateChanged(this);
+            return;
+        }
+
+        m_pendingETag = QString::fromLatin1(result.rawHeaders.value("etag"));
+        m_pendingLastModified = QString::fromLatin1(result.rawHeaders.value("last-modified"));
+
         LogMsg(tr("RSS feed at '%1' is successfully downloaded. Starting to parse it.")
                 .arg(result.url));
         // Parse the download RSS
@@ -273,6 +301,19 @@ void Feed::handleParsingFinished(const RSS::Private::ParsingResult &result)
     // as possible until we encounter corrupted data. So we can have some articles here
     // even in case of parsing error.
     const int newArticlesCount = updateArticles(result.articles);
+
+    // Drop the validators of content that was not parsed successfully so it is downloaded again next time
+    const QString eTag = m_hasError ? QString() : m_pendingETag;
+    const QString lastModified = m_hasError ? QString() : m_pendingLastModified;
+    m_pendingETag.clear();
+    m_pendingLastModified.clear();
+    if ((eTag != m_eTag) || (lastModified != m_lastModified))
+    {
+        m_eTag = eTag;
+        m_lastModified = lastModified;
+        m_dirty = true;
+    }
+
     store();
 
     if (m_hasError)
@@ -289,33 +330,40 @@ void Feed::handleParsingFinished(const RSS::Private::ParsingResult &result)
 
 void Feed::load()
 {
+    const Path storageDir = m_session->dataFileStorage()->storageDir();
     QMetaObject::invokeMethod(m_serializer
             , [serializer = m_serializer, url = m_url
-                , path = (m_session->dataFileStorage()->storageDir() / m_dataFileName)]
+                , path = (storageDir / m_dataFileName), legacyPath = (storageDir / m_legacyDataFileName)
+                , validatorsPath = (storageDir / m_validatorsFileName)]
     {
-        serializer->load(path, url);
+        // Validators must be loaded before articles since the feed is allowed to be refreshed once articles are loaded
+        serializer->loadValidators(validatorsPath);
+        serializer->load(path, legacyPath, url);
     });
 }
 
 void Feed::store()
 {
-    if (!m_dirty)
+    // Stored articles are replaced with the current ones so they must be loaded first
+    if (!m_dirty || !m_isInitialized)
         return;
 
     m_dirty = false;
     m_savingTimer.stop();
 
-    QList<QVariantHash> articlesData;
+    QList<ArticleData> articlesData;
     articlesData.reserve(m_articles.size());
 
     for (Article *article :asConst(m_articles))
         articlesData.push_back(article->data());
 
+    const Path storageDir = m_session->dataFileStorage()->storageDir();
     QMetaObject::invokeMethod(m_serializer
-            , [articlesData, serializer = m_serializer
-                , path = (m_session->dataFileStorage()->storageDir() / m_dataFileName)]
+            , [articlesData, serializer = m_serializer, eTag = m_eTag, lastModified = m_lastModified
+                , path = (storageDir / m_dataFileName), validatorsPath = (storageDir / m_validatorsFileName)]
     {
         serializer->store(path, articlesData);
+        serializer->storeValidators(validatorsPath, eTag, lastModified);
     });
 }
 
@@ -325,14 +373,14 @@ void Feed::storeDeferred()
         m_savingTimer.start(5 * 1000, this);
 }
 
-bool Feed::addArticle(const QVariantHash &articleData)
+bool Feed::addArticle(const ArticleData &articleData)
 {
-    Q_ASSERT(!m_articles.contains(articleData.value(Article::KeyId).toString()));
+    Q_ASSERT(!m_articles.contains(articleData.id));
 
     // Insertion sort
     const int maxArticles = m_session->maxArticlesPerFeed();
     const auto lowerBound = std::lower_bound(m_articlesByDate.cbegin(), m_articlesByDate.cend()
-        , articleData.value(Article::KeyDate).toDateTime(), Article::articleDateRecentThan);
+        , articleData.date, Article::articleDateRecentThan);
     if ((lowerBound - m_articlesByDate.cbegin()) >= maxArticles)
         return false; // we reach max articles
 
@@ -389,33 +437,32 @@ void Feed::downloadIcon()
     const QUrl url(m_url);
     const auto iconUrl = u"%1://%2/favicon.ico"_s.arg(url.scheme(), url.host());
     Net::DownloadManager::instance()->download(
-            Net::DownloadRequest(iconUrl).saveToFile(true).destFileName(m_iconPath)
+            Net::DownloadRequest(iconUrl).saveToFile(true).destFileName(m_iconPath).priority(Net::DownloadPriority::Low)
             , Preferences::instance()->useProxyForRSS(), this, &Feed::handleIconDownloadFinished);
 }
 
-int Feed::updateArticles(const QList<QVariantHash> &loadedArticles)
+int Feed::updateArticles(const QList<ArticleData> &loadedArticles)
 {
     if (loadedArticles.empty())
         return 0;
 
     QDateTime dummyPubDate {QDateTime::currentDateTime()};
-    QList<QVariantHash> newArticles;
+    QList<ArticleData> newArticles;
     newArticles.reserve(loadedArticles.size());
-    for (QVariantHash article : loadedArticles)
+    for (ArticleData article : loadedArticles)
     {
         // If article has no publication date we use feed update time as a fallback.
         // To prevent processing of "out-of-limit" articles we must not assign dates
         // that are earlier than the dates of existing articles.
-        const Article *existingArticle = articleByGUID(article[Article::KeyId].toString());
+        const Article *existingArticle = articleByGUID(article.id);
         if (existingArticle)
         {
             dummyPubDate = existingArticle->date().addMSecs(-1);
             continue;
         }
 
-        QVariant &articleDate = article[Article::KeyDate];
-        if (!articleDate.toDateTime().isValid())
-            articleDate = dummyPubDate;
+        if (!article.date.isValid())
+            article.date = dummyPubDate;
 
         newArticles.append(article);
     }
@@ -423,14 +470,14 @@ int Feed::updateArticles(const QList<QVariantHash> &loadedArticles)
     if (newArticles.empty())
         return 0;
 
-    using ArticleSortAdaptor = std::pair<QDateTime, const QVariantHash *>;
+    using ArticleSortAdaptor = std::pair<QDateTime, const ArticleData *>;
     std::vector<ArticleSortAdaptor> sortData;
     const QList<Article *> existingArticles = articles();
     sortData.reserve(existingArticles.size() + newArticles.size());
     for (const Article *article : existingArticles)
         sortData.push_back(std::make_pair(article->date(), nullptr));
-    for (const QVariantHash &article : asConst(newArticles))
-        sortData.push_back(std::make_pair(article[Article::KeyDate].toDateTime(), &article));
+    for (const ArticleData &article : asConst(newArticles))
+        sortData.push_back(std::make_pair(article.date, &article));
 
     // Sort article list in reverse chronological order
     std::ranges::sort(sortData, [](const ArticleSortAdaptor &a1, const ArticleSortAdaptor &a2)
@@ -477,6 +524,14 @@ void Feed::setURL(const QString &url)
 {
     const QString oldURL = m_url;
     m_url = url;
+    // Validators of the old URL are meaningless for the new one
+    if (!m_eTag.isEmpty() || !m_lastModified.isEmpty())
+    {
+        m_eTag.clear();
+        m_lastModified.clear();
+        m_dirty = true;
+        storeDeferred();
+    }
     emit urlChanged(oldURL);
 }
 
@@ -497,12 +552,7 @@ QJsonValue Feed::toJsonValue(const bool withData) const
 
         QJsonArray jsonArr;
         for (Article *article : asConst(m_articles))
-        {
-            auto articleObj = QJsonObject::fromVariantHash(article->data());
-            // JSON object doesn't support DateTime so we need to convert it
-            articleObj[Article::KeyDate] = article->date().toString(Qt::RFC2822Date);
-            jsonArr.append(articleObj);
-        }
+            jsonArr.append(article->data().toJsonObject());
         jsonObj.insert(KEY_ARTICLES, jsonArr);
     }
 
@@ -529,7 +579,13 @@ void Feed::handleArticleRead(Article *article)
     storeDeferred();
 }
 
-void Feed::handleArticleLoadFinished(QList<QVariantHash> articles)
+void Feed::handleValidatorsLoaded(const QString &eTag, const QString &lastModified)
+{
+    m_eTag = eTag;
+    m_lastModified = lastModified;
+}
+
+void Feed::handleArticleLoadFinished(QList<ArticleData> articles)
 {
     Q_ASSERT(m_articles.isEmpty());
     Q_ASSERT(m_unreadCount == 0);
@@ -541,9 +597,9 @@ void Feed::handleArticleLoadFinished(QList<QVariantHash> articles)
     m_articles.reserve(articles.size());
     m_articlesByDate.reserve(articles.size());
 
-    for (const QVariantHash &articleData : articles)
+    for (const ArticleData &articleData : articles)
     {
-        const auto articleID = articleData.value(Article::KeyId).toString();
+        const QString &articleID = articleData.id;
         if (m_articles.contains(articleID)) [[unlikely]]
             continue;
 
@@ -562,6 +618,13 @@ void Feed::handleArticleLoadFinished(QList<QVariantHash> articles)
     if (m_unreadCount > 0)
         emit unreadCountChanged(this);
 
+    // Don't let the server skip sending the content if we have nothing stored
+    if (m_articles.isEmpty())
+    {
+        m_eTag.clear();
+        m_lastModified.clear();
+    }
+
     m_isInitialized = true;
     emit stateChanged(this);
 
@@ -577,6 +640,8 @@ void Feed::cleanup()
     m_dirty = false;
     m_savingTimer.stop();
     Utils::Fs::removeFile(m_session->dataFileStorage()->storageDir() / m_dataFileName);
+    Utils::Fs::removeFile(m_session->dataFileStorage()->storageDir() / m_legacyDataFileName);
+    Utils::Fs::removeFile(m_session->dataFileStorage()->storageDir() / m_validatorsFileName);
     Utils::Fs::removeFile(m_iconPath);
 }
 
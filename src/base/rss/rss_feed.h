@@ -38,9 +38,9 @@
 #include <QHash>
 #include <QList>
 #include <QUuid>
-#include <QVariantHash>
 
 #include "base/path.h"
+#include "rss_article.h"
 #include "rss_item.h"
 
 class AsyncFileStorage;
@@ -53,7 +53,6 @@ namespace Net
 
 namespace RSS
 {
-    class Article;
     class Session;
 
     namespace Private
@@ -108,7 +107,8 @@ namespace RSS
         void handleDownloadFinished(const Net::DownloadResult &result);
         void handleParsingFinished(const Private::ParsingResult &result);
         void handleArticleRead(Article *article);
-        void handleArticleLoadFinished(QList<QVariantHash> articles);
+        void handleArticleLoadFinished(QList<ArticleData> articles);
+        void handleValidatorsLoaded(const QString &eTag, const QString &lastModified);
 
     private:
         void timerEvent(QTimerEvent *event) override;
@@ -116,12 +116,12 @@ namespace RSS
         void load();
         void store();
         void storeDeferred();
-        bool addArticle(const QVariantHash &articleData);
+        bool addArticle(const ArticleData &articleData);
         void removeOldestArticle();
         void increaseUnreadCount();
         void decreaseUnreadCount();
         void downloadIcon();
-        int updateArticles(const QList<QVariantHash> &loadedArticles);
+        int updateArticles(const QList<ArticleData> &loadedArticles);
         void setURL(const QString &url);
 
         Session *m_session = nullptr;
@@ -141,6 +141,13 @@ namespace RSS
         int m_unreadCount = 0;
         Path m_iconPath;
         Path m_dataFileName;
+        Path m_legacyDataFileName;
+        Path m_validatorsFileName;
+        // HTTP validators of the last successfully parsed feed content
+        QString m_eTag;
+        QString m_lastModified;
+        QString m_pendingETag;
+        QString m_pendingLastModified;
         QBasicTimer m_savingTimer;
         bool m_dirty = false;
         Net::DownloadHandler *m_downloadHandler = nullptr;
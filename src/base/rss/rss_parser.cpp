@@ -602,7 +602,7 @@ void RSS::Private::Parser::parse(const QByteArray &feedData)
 
 void RSS::Private::Parser::parseRssArticle(QXmlStreamReader &xml)
 {
-    QVariantHash article;
+    ArticleData article;
     QString altTorrentUrl;
 
     while (!xml.atEnd())
@@ -617,12 +617,12 @@ void RSS::Private::Parser::parseRssArticle(QXmlStreamReader &xml)
         {
             if (name == u"title")
             {
-                article[Article::KeyTitle] = xml.readElementText().trimmed();
+                article.title = xml.readElementText().trimmed();
             }
             else if (name == u"enclosure")
             {
                 if (xml.attributes().value(u"type"_s) == u"application/x-bittorrent")
-                    article[Article::KeyTorrentURL] = xml.attributes().value(u"url"_s).toString();
+                    article.torrentURL = xml.attributes().value(u"url"_s).toString();
                 else if (xml.attributes().value(u"type"_s).isEmpty())
                     altTorrentUrl = xml.attributes().value(u"url"_s).toString();
             }
@@ -630,35 +630,35 @@ void RSS::Private::Parser::parseRssArticle(QXmlStreamReader &xml)
             {
                 const QString text {xml.readElementText().trimmed()};
                 if (text.startsWith(u"magnet:", Qt::CaseInsensitive))
-                    article[Article::KeyTorrentURL] = text; // magnet link instead of a news URL
+                    article.torrentURL = text; // magnet link instead of a news URL
                 else
-                    article[Article::KeyLink] = text;
+                    article.link = text;
             }
             else if (name == u"description")
             {
-                article[Article::KeyDescription] = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+                article.description = xml.readElementText(QXmlStreamReader::IncludeChildElements);
             }
             else if (name == u"pubDate")
             {
-                article[Article::KeyDate] = parseDate(xml.readElementText().trimmed(), m_fallbackDate);
+                article.date = parseDate(xml.readElementText().trimmed(), m_fallbackDate);
             }
             else if (name == u"author")
             {
-                article[Article::KeyAuthor] = xml.readElementText().trimmed();
+                article.author = xml.readElementText().trimmed();
             }
             else if (name == u"guid")
             {
-                article[Article::KeyId] = xml.readElementText().trimmed();
+                article.id = xml.readElementText().trimmed();
             }
             else
             {
-                article[name] = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+                article.setValue(name, xml.readElementText(QXmlStreamReader::IncludeChildElements));
             }
         }
     }
 
-    if (article[Article::KeyTorrentURL].toString().isEmpty())
-        article[Article::KeyTorrentURL] = altTorrentUrl;
+    if (article.torrentURL.isEmpty())
+        article.torrentURL = altTorrentUrl;
 
     addArticle(article);
 }
@@ -698,7 +698,7 @@ void RSS::Private::Parser::parseRSSChannel(QXmlStreamReader &xml)
 
 void RSS::Private::Parser::parseAtomArticle(QXmlStreamReader &xml)
 {
-    QVariantHash article;
+    ArticleData article;
     bool doubleContent = false;
 
     while (!xml.atEnd())
@@ -713,7 +713,7 @@ void RSS::Private::Parser::parseAtomArticle(QXmlStreamReader &xml)
         {
             if (name == u"title")
             {
-                article[Article::KeyTitle] = xml.readElementText().trimmed();
+                article.title = xml.readElementText().trimmed();
             }
             else if (name == u"link")
             {
@@ -723,14 +723,14 @@ void RSS::Private::Parser::parseAtomArticle(QXmlStreamReader &xml)
 
                 if (link.startsWith(u"magnet:", Qt::CaseInsensitive))
                 {
-                    article[Article::KeyTorrentURL] = link; // magnet link instead of a news URL
+                    article.torrentURL = link; // magnet link instead of a news URL
                 }
                 else
                 {
                     // Atom feeds can have relative links, work around this and
                     // take the stress of figuring article full URI from UI
                     // Assemble full URI
-                    article[Article::KeyLink] = (m_baseUrl.isEmpty() ? link : m_baseUrl + link);
+                    article.link = (m_baseUrl.isEmpty() ? link : m_baseUrl + link);
                 }
             }
             else if ((name == u"summary") || (name == u"content"))
@@ -746,7 +746,7 @@ void RSS::Private::Parser::parseAtomArticle(QXmlStreamReader &xml)
                 const QString feedText = xml.readElementText(QXmlStreamReader::IncludeChildElements).trimmed();
                 if (!feedText.isEmpty())
                 {
-                    article[Article::KeyDescription] = feedText;
+                    article.description = feedText;
                     doubleContent = true;
                 }
             }
@@ -754,25 +754,25 @@ void RSS::Private::Parser::parseAtomArticle(QXmlStreamReader &xml)
             {
                 // ATOM uses standard compliant date, don't do fancy stuff
                 const QDateTime articleDate = QDateTime::fromString(xml.readElementText().trimmed(), Qt::ISODate);
-                article[Article::KeyDate] = (articleDate.isValid() ? articleDate : m_fallbackDate);
+                article.date = (articleDate.isValid() ? articleDate : m_fallbackDate);
             }
             else if (name == u"author")
             {
                 while (xml.readNextStartElement())
                 {
                     if (xml.name() == u"name")
-                        article[Article::KeyAuthor] = xml.readElementText().trimmed();
+                        article.author = xml.readElementText().trimmed();
                     else
                         xml.skipCurrentElement();
                 }
             }
             else if (name == u"id")
             {
-                article[Article::KeyId] = xml.readElementText().trimmed();
+                article.id = xml.readElementText().trimmed();
             }
             else
             {
-                article[name] = xml.readElementText(QXmlStreamReader::IncludeChildElements);
+                article.setValue(name, xml.readElementText(QXmlStreamReader::IncludeChildElements));
             }
         }
     }
@@ -815,21 +815,20 @@ void RSS::Private::Parser::parseAtomChannel(QXmlStreamReader &xml)
     }
 }
 
-void RSS::Private::Parser::addArticle(QVariantHash article)
+void RSS::Private::Parser::addArticle(ArticleData article)
 {
-    QVariant &torrentURL = article[Article::KeyTorrentURL];
-    if (torrentURL.toString().isEmpty())
-        torrentURL = article.value(Article::KeyLink);
+    if (article.torrentURL.isEmpty())
+        article.torrentURL = article.link;
 
     // If item does not have an ID, fall back to some other identifier.
-    QVariant &localId = article[Article::KeyId];
-    if (localId.toString().isEmpty())
+    QString &localId = article.id;
+    if (localId.isEmpty())
     {
-        localId = article.value(Article::KeyTorrentURL);
-        if (localId.toString().isEmpty())
+        localId = article.torrentURL;
+        if (localId.isEmpty())
         {
-            localId = article.value(Article::KeyTitle);
-            if (localId.toString().isEmpty())
+            localId = article.title;
+            if (localId.isEmpty())
             {
                 // The article could not be uniquely identified
                 // since it has no appropriate data.
@@ -839,7 +838,7 @@ void RSS::Private::Parser::addArticle(QVariantHash article)
         }
     }
 
-    if (m_articleIDs.contains(localId.toString()))
+    if (m_articleIDs.contains(localId))
     {
         // The article could not be uniquely identified
         // since the Feed has duplicate identifiers.
@@ -847,6 +846,6 @@ void RSS::Private::Parser::addArticle(QVariantHash article)
         return;
     }
 
-    m_articleIDs.insert(localId.toString());
+    m_articleIDs.insert(localId);
     m_result.articles.prepend(article);
 }
@@ -34,7 +34,8 @@
 #include <QObject>
 #include <QSet>
 #include <QString>
-#include <QVariantHash>
+
+#include "rss_article.h"
 
 class QXmlStreamReader;
 
@@ -45,7 +46,7 @@ namespace RSS::Private
         QString error;
         QString lastBuildDate;
         QString title;
-        QList<QVariantHash> articles;
+        QList<ArticleData> articles;
     };
 
     class Parser final : public QObject
@@ -65,7 +66,7 @@ namespace RSS::Private
         void parseRSSChannel(QXmlStreamReader &xml);
         void parseAtomArticle(QXmlStreamReader &xml);
         void parseAtomChannel(QXmlStreamReader &xml);
-        void addArticle(QVariantHash article);
+        void addArticle(ArticleData article);
 
         QDateTime m_fallbackDate;
         QString m_baseUrl;
@@ -31,8 +31,12 @@
 
 #include "rss_session.h"
 
+#include <algorithm>
 #include <chrono>
+#include <optional>
+#include <vector>
 
+#include <QDateTime>
 #include <QDebug>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -45,8 +49,10 @@
 #include "../logger.h"
 #include "../profile.h"
 #include "../settingsstorage.h"
+#include "../tracer.h"
 #include "../utils/fs.h"
 #include "../utils/io.h"
+#include "../utils/random.h"
 #include "rss_article.h"
 #include "rss_feed.h"
 #include "rss_folder.h"
@@ -55,6 +61,13 @@
 const QString CONF_FOLDER_NAME = u"rss"_s;
 const QString DATA_FOLDER_NAME = u"rss/articles"_s;
 const QString FEEDS_FILE_NAME = u"feeds.json"_s;
+const int MAX_FEED_WORKING_THREADS = 8;
+// Limits the number of feeds refreshed by the scheduler at the same time so they don't all spike at once
+const int MAX_CONCURRENT_FEED_REFRESHES = 10;
+// Scheduled refresh time is randomly shifted by up to 1/REFRESH_JITTER_DIVISOR of the refresh interval
+const int REFRESH_JITTER_DIVISOR = 10;
+const int MAX_REFRESH_BACKOFF_FACTOR = 4;
+const qsizetype ARRIVAL_RATE_SAMPLE_SIZE = 10;
 
 using namespace std::chrono_literals;
 using namespace RSS;
@@ -68,6 +81,8 @@ Session::Session()
     , m_storeMaxArticlesPerFeed(u"RSS/Session/MaxArticlesPerFeed"_s, 50)
     , m_workingThread(new QThread)
 {
+    const TraceSpan traceSpan {"RSS::Session::Session"};
+
     Q_ASSERT(!m_instance); // only one instance is allowed
     m_instance = this;
 
@@ -92,7 +107,19 @@ Session::Session()
     m_itemsByPath.insert(u""_s, new Folder); // root folder
 
     m_workingThread->setObjectName("RSS::Session m_workingThread");
+    Utils::Thread::setWorkload(m_workingThread.get(), Utils::Thread::Workload::Bulk);
     m_workingThread->start();
+
+    const int feedWorkingThreadCount = std::clamp(QThread::idealThreadCount(), 1, MAX_FEED_WORKING_THREADS);
+    m_feedWorkingThreads.reserve(feedWorkingThreadCount);
+    for (int i = 0; i < feedWorkingThreadCount; ++i)
+    {
+        auto &thread = m_feedWorkingThreads.emplace_back(new QThread);
+        thread->setObjectName("RSS::Session m_feedWorkingThreads");
+        Utils::Thread::setWorkload(thread.get(), Utils::Thread::Workload::Bulk);
+        thread->start();
+    }
+
     load();
 
     m_refreshTimer.setSingleShot(true);
@@ -462,6 +489,11 @@ void Session::addItem(Item *item, Folder *destFolder)
         connect(feed, &Feed::titleChanged, this, &Session::handleFeedTitleChanged);
         connect(feed, &Feed::iconLoaded, this, &Session::feedIconLoaded);
         connect(feed, &Feed::stateChanged, this, &Session::feedStateChanged);
+        connect(feed, &Feed::stateChanged, this, [this, feed]
+        {
+            if (!feed->isLoading())
+                handleFeedRefreshFinished(feed);
+        });
         connect(feed, &Feed::urlChanged, this, [this, feed](const QString &oldURL)
         {
             if (feed->name() == oldURL)
@@ -539,6 +571,19 @@ QList<Feed *> Session::feeds() const
     return m_feedsByURL.values();
 }
 
+qint64 Session::estimatedArticlesMemoryUsage() const
+{
+    qint64 size = 0;
+    for (const Feed *feed : asConst(m_feedsByURL))
+    {
+        const QList<Article *> articles = feed->articles();
+        for (const Article *article : articles)
+            size += sizeof(Article) + article->data().estimatedHeapSize();
+    }
+
+    return size;
+}
+
 Feed *Session::feedByURL(const QString &url) const
 {
     return m_feedsByURL.value(url);
@@ -576,6 +621,13 @@ QThread *Session::workingThread() const
     return m_workingThread.get();
 }
 
+QThread *Session::nextFeedWorkingThread()
+{
+    QThread *thread = m_feedWorkingThreads[m_nextFeedWorkingThreadIndex].get();
+    m_nextFeedWorkingThreadIndex = (m_nextFeedWorkingThreadIndex + 1) % m_feedWorkingThreads.size();
+    return thread;
+}
+
 void Session::handleItemAboutToBeDestroyed(Item *item)
 {
     m_itemsByPath.remove(item->path());
@@ -585,6 +637,7 @@ void Session::handleItemAboutToBeDestroyed(Item *item)
         m_feedsByUID.remove(feed->uid());
         m_feedsByURL.remove(feed->url());
         m_refreshTimepoints.remove(feed);
+        m_refreshingFeeds.remove(feed);
     }
 }
 
@@ -623,28 +676,88 @@ void Session::setMaxArticlesPerFeed(const int n)
 
 void Session::refresh()
 {
+    m_hasDelayedRefreshes = false;
+
     const auto currentTimepoint = std::chrono::system_clock::now();
-    std::chrono::seconds nextRefreshInterval = 0s;
-    for (auto it = m_refreshTimepoints.begin(); it != m_refreshTimepoints.end(); ++it)
+
+    // The feeds that wait longer are refreshed first
+    std::vector<Feed *> dueFeeds;
+    for (auto it = m_refreshTimepoints.cbegin(); it != m_refreshTimepoints.cend(); ++it)
     {
-        Feed *feed = it.key();
-        std::chrono::system_clock::time_point &timepoint = it.value();
+        if (it.value() <= currentTimepoint)
+            dueFeeds.push_back(it.key());
+    }
+    std::ranges::sort(dueFeeds, {}, [this](Feed *feed) { return m_refreshTimepoints.value(feed); });
 
-        if (timepoint <= currentTimepoint)
-            timepoint = refreshFeed(feed, currentTimepoint);
+    for (Feed *feed : dueFeeds)
+    {
+        // Remaining feeds are refreshed once some of the running refreshes are finished
+        if (m_refreshingFeeds.size() >= MAX_CONCURRENT_FEED_REFRESHES)
+        {
+            m_hasDelayedRefreshes = true;
+            break;
+        }
 
-        const auto interval = std::chrono::duration_cast<std::chrono::seconds>(timepoint - currentTimepoint);
-        if ((interval < nextRefreshInterval) || (nextRefreshInterval == 0s))
-            nextRefreshInterval = interval;
+        m_refreshTimepoints[feed] = refreshFeed(feed, currentTimepoint);
     }
 
-    m_refreshTimer.start(nextRefreshInterval);
+    std::optional<std::chrono::system_clock::time_point> nextTimepoint;
+    for (const std::chrono::system_clock::time_point &timepoint : asConst(m_refreshTimepoints))
+    {
+        if ((timepoint > currentTimepoint) && (!nextTimepoint || (timepoint < *nextTimepoint)))
+            nextTimepoint = timepoint;
+    }
+
+    if (nextTimepoint)
+        m_refreshTimer.start(std::chrono::duration_cast<std::chrono::milliseconds>(*nextTimepoint - currentTimepoint));
+    else
+        m_refreshTimer.stop();
 }
 
 std::chrono::system_clock::time_point Session::refreshFeed(Feed *feed, const std::chrono::system_clock::time_point &currentTimepoint)
 {
     feed->refresh();
-    const std::chrono::seconds feedRefreshInterval = feed->refreshInterval();
-    const std::chrono::seconds effectiveRefreshInterval = (feedRefreshInterval > 0s) ? feedRefreshInterval : std::chrono::minutes(refreshInterval());
-    return currentTimepoint + effectiveRefreshInterval;
+    if (feed->isLoading())
+        m_refreshingFeeds.insert(feed);
+
+    return currentTimepoint + nextRefreshDelay(feed);
+}
+
+std::chrono::seconds Session::nextRefreshDelay(const Feed *feed) const
+{
+    std::chrono::seconds delay = feed->refreshInterval();
+    if (delay <= 0s)
+    {
+        const std::chrono::seconds globalRefreshInterval = std::chrono::minutes(refreshInterval());
+        delay = globalRefreshInterval;
+
+        // Feeds using the global refresh interval are refreshed less often if they rarely get new articles.
+        // The arrival interval is estimated from the dates of the most recent articles.
+        const QList<Article *> articles = feed->articles();
+        const qsizetype sampleSize = std::min(articles.size(), ARRIVAL_RATE_SAMPLE_SIZE);
+        if (sampleSize >= 2)
+        {
+            const QDateTime newestDate = articles.first()->date();
+            const QDateTime oldestDate = articles[sampleSize - 1]->date();
+            const std::chrono::seconds averageArrivalInterval {oldestDate.secsTo(newestDate) / (sampleSize - 1)};
+            const std::chrono::seconds idleTime {newestDate.secsTo(QDateTime::currentDateTime())};
+            const std::chrono::seconds expectedArrivalInterval = std::max(averageArrivalInterval, idleTime);
+            delay = std::clamp((expectedArrivalInterval / 2), globalRefreshInterval, (globalRefreshInterval * MAX_REFRESH_BACKOFF_FACTOR));
+        }
+    }
+
+    const qint64 maxJitter = delay.count() / REFRESH_JITTER_DIVISOR;
+    if (maxJitter > 0)
+        delay += std::chrono::seconds(static_cast<qint64>(Utils::Random::rand(0, static_cast<uint32_t>(2 * maxJitter))) - maxJitter);
+
+    return delay;
+}
+
+void Session::handleFeedRefreshFinished(Feed *feed)
+{
+    if (!m_refreshingFeeds.remove(feed))
+        return;
+
+    if (m_hasDelayedRefreshes && isProcessingEnabled())
+        refresh();
 }
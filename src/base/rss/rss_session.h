@@ -64,10 +64,12 @@
  */
 
 #include <chrono>
+#include <vector>
 
 #include <QHash>
 #include <QObject>
 #include <QPointer>
+#include <QSet>
 #include <QTimer>
 
 #include "base/3rdparty/expected.hpp"
@@ -102,6 +104,9 @@ namespace RSS
         void setProcessingEnabled(bool enabled);
 
         QThread *workingThread() const;
+        // Feeds are distributed across several threads so that different feeds are processed concurrently,
+        // while all the jobs of a feed are still processed in order by the thread it is assigned to
+        QThread *nextFeedWorkingThread();
         AsyncFileStorage *confFileStorage() const;
         AsyncFileStorage *dataFileStorage() const;
 
@@ -125,6 +130,8 @@ namespace RSS
         QList<Item *> items() const;
         Item *itemByPath(const QString &path) const;
         QList<Feed *> feeds() const;
+        // Rough estimation of the memory used by the articles of all feeds
+        qint64 estimatedArticlesMemoryUsage() const;
         Feed *feedByURL(const QString &url) const;
 
         Folder *rootFolder() const;
@@ -155,6 +162,8 @@ namespace RSS
         void addItem(Item *item, Folder *destFolder);
         void refresh();
         std::chrono::system_clock::time_point refreshFeed(Feed *feed, const std::chrono::system_clock::time_point &currentTimepoint);
+        std::chrono::seconds nextRefreshDelay(const Feed *feed) const;
+        void handleFeedRefreshFinished(Feed *feed);
 
         static QPointer<Session> m_instance;
 
@@ -163,6 +172,8 @@ namespace RSS
         CachedSettingValue<qint64> m_storeFetchDelay;
         CachedSettingValue<int> m_storeMaxArticlesPerFeed;
         Utils::Thread::UniquePtr m_workingThread;
+        std::vector<Utils::Thread::UniquePtr> m_feedWorkingThreads;
+        std::size_t m_nextFeedWorkingThreadIndex = 0;
         AsyncFileStorage *m_confFileStorage = nullptr;
         AsyncFileStorage *m_dataFileStorage = nullptr;
         QTimer m_refreshTimer;
@@ -170,5 +181,7 @@ namespace RSS
         QHash<QUuid, Feed *> m_feedsByUID;
         QHash<QString, Feed *> m_feedsByURL;
         QHash<Feed *, std::chrono::system_clock::time_point> m_refreshTimepoints;
+        QSet<Feed *> m_refreshingFeeds;
+        bool m_hasDelayedRefreshes = false;
     };
 }
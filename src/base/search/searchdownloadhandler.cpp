@@ -29,11 +29,14 @@
 #include "searchdownloadhandler.h"
 
 #include <QtLogging>
+#include <QMetaObject>
 #include <QProcess>
 
 #include "base/global.h"
 #include "base/logger.h"
+#include "base/net/downloadmanager.h"
 #include "base/path.h"
+#include "base/preferences.h"
 #include "base/utils/foreignapps.h"
 #include "base/utils/fs.h"
 #include "searchpluginmanager.h"
@@ -43,8 +46,30 @@ SearchDownloadHandler::SearchDownloadHandler(const QString &pluginName, const QS
     , m_pluginName {pluginName}
     , m_url {url}
     , m_manager {manager}
-    , m_downloadProcess {new QProcess(this)}
 {
+    // The result is reported asynchronously in any case, so the caller is able to connect to the signal
+    if (url.startsWith(u"magnet:", Qt::CaseInsensitive))
+    {
+        QMetaObject::invokeMethod(this, [this] { emit downloadFinished(m_url, {}); }, Qt::QueuedConnection);
+        return;
+    }
+
+    // Starting Python interpreter is only needed when the plugin has its own download code,
+    // otherwise it would just download the URL the way it can be done here
+    const PluginInfo *plugin = m_manager->pluginInfo(pluginName);
+    if (plugin && !plugin->hasCustomDownload && Net::DownloadManager::hasSupportedScheme(url))
+    {
+        Net::DownloadManager::instance()->download(Net::DownloadRequest(url).saveToFile(true)
+            , Preferences::instance()->useProxyForGeneralPurposes(), this, &SearchDownloadHandler::handleDownloadFinished);
+        return;
+    }
+
+    startDownloadProcess();
+}
+
+void SearchDownloadHandler::startDownloadProcess()
+{
+    m_downloadProcess = new QProcess(this);
     m_downloadProcess->setProcessEnvironment(m_manager->proxyEnvironment());
 #ifdef Q_OS_UNIX
     m_downloadProcess->setUnixProcessParameters(QProcess::UnixProcessFlag::CloseFileDescriptors);
@@ -55,8 +80,8 @@ SearchDownloadHandler::SearchDownloadHandler(const QString &pluginName, const QS
     {
         Utils::ForeignApps::PYTHON_ISOLATE_MODE_FLAG,
         (SearchPluginManager::engineLocation() / Path(u"nova2dl.py"_s)).toString(),
-        pluginName,
-        url
+        m_pluginName,
+        m_url
     };
     // Launch search
     m_downloadProcess->start(Utils::ForeignApps::pythonInfo().executablePath.data(), params, QIODevice::ReadOnly);
@@ -66,11 +91,7 @@ void SearchDownloadHandler::downloadProcessFinished(const int exitcode)
 {
     const auto errMsg = QString::fromUtf8(m_downloadProcess->readAllStandardError()).trimmed();
     if (!errMsg.isEmpty())
-    {
-        qWarning("%s", qUtf8Printable(errMsg));
-        LogMsg(tr("Error occurred when downloading torrent via search engine. Engine: \"%1\". URL: \"%2\". Error: \"%3\".")
-            .arg(m_pluginName, m_url, errMsg), Log::WARNING);
-    }
+        logError(errMsg);
 
     QString path;
     if ((exitcode == 0) && (m_downloadProcess->exitStatus() == QProcess::NormalExit))
@@ -83,3 +104,27 @@ void SearchDownloadHandler::downloadProcessFinished(const int exitcode)
 
     emit downloadFinished(path, errMsg);
 }
+
+void SearchDownloadHandler::handleDownloadFinished(const Net::DownloadResult &result)
+{
+    switch (result.status)
+    {
+    case Net::DownloadStatus::Success:
+        emit downloadFinished(result.filePath.toString(), {});
+        break;
+    case Net::DownloadStatus::RedirectedToMagnet:
+        emit downloadFinished(result.magnetURI, {});
+        break;
+    default:
+        logError(result.errorString);
+        emit downloadFinished({}, result.errorString);
+        break;
+    }
+}
+
+void SearchDownloadHandler::logError(const QString &errorMessage) const
+{
+    qWarning("%s", qUtf8Printable(errorMessage));
+    LogMsg(tr("Error occurred when downloading torrent via search engine. Engine: \"%1\". URL: \"%2\". Error: \"%3\".")
+        .arg(m_pluginName, m_url, errorMessage), Log::WARNING);
+}
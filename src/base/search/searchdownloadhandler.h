@@ -35,6 +35,11 @@ class QProcess;
 
 class SearchPluginManager;
 
+namespace Net
+{
+    struct DownloadResult;
+}
+
 class SearchDownloadHandler : public QObject
 {
     Q_OBJECT
@@ -48,7 +53,10 @@ signals:
     void downloadFinished(const QString &path, const QString &errorMessage);
 
 private:
+    void startDownloadProcess();
     void downloadProcessFinished(int exitcode);
+    void handleDownloadFinished(const Net::DownloadResult &result);
+    void logError(const QString &errorMessage) const;
 
     QString m_pluginName;
     QString m_url;
@@ -34,16 +34,13 @@
 #include <QtLogging>
 #include <QList>
 #include <QMetaObject>
-#include <QProcess>
 #include <QTimer>
 
 #include "base/global.h"
 #include "base/logger.h"
-#include "base/path.h"
 #include "base/utils/bytearray.h"
-#include "base/utils/foreignapps.h"
-#include "base/utils/fs.h"
 #include "searchpluginmanager.h"
+#include "searchresultcache.h"
 
 using namespace std::chrono_literals;
 
@@ -61,66 +58,22 @@ namespace
         PL_PUB_DATE,
         NB_PLUGIN_COLUMNS
     };
-
-    QString toString(const QProcess::ProcessError error)
-    {
-        switch (error)
-        {
-        case QProcess::FailedToStart:
-            return SearchHandler::tr("Process failed to start");
-        case QProcess::Crashed:
-            return SearchHandler::tr("Process crashed");
-        case QProcess::Timedout:
-            return SearchHandler::tr("Process timed out");
-        case QProcess::WriteError:
-            return SearchHandler::tr("Process write error");
-        case QProcess::ReadError:
-            return SearchHandler::tr("Process read error");
-        case QProcess::UnknownError:
-            return SearchHandler::tr("Process unknown error");
-        }
-        return {};
-    };
 }
 
-SearchHandler::SearchHandler(const QString &pattern, const QString &category, const QStringList &usedPlugins, SearchPluginManager *manager)
+SearchHandler::SearchHandler(const QString &pattern, const QString &category, const QStringList &usedPlugins
+        , SearchWorkerPool *workerPool, SearchResultCache *resultCache, SearchPluginManager *manager)
     : QObject(manager)
     , m_pattern {pattern}
     , m_category {category}
     , m_usedPlugins {usedPlugins}
     , m_manager {manager}
-    , m_searchProcess {new QProcess(this)}
+    , m_workerPool {workerPool}
+    , m_resultCache {resultCache}
     , m_searchTimeout {new QTimer(this)}
 {
-    // Load environment variables (proxy)
-    m_searchProcess->setProcessEnvironment(m_manager->proxyEnvironment());
-    m_searchProcess->setProgram(Utils::ForeignApps::pythonInfo().executablePath.data());
-#ifdef Q_OS_UNIX
-    m_searchProcess->setUnixProcessParameters(QProcess::UnixProcessFlag::CloseFileDescriptors);
-#endif
-
-    const QStringList params
-    {
-        Utils::ForeignApps::PYTHON_ISOLATE_MODE_FLAG,
-        (SearchPluginManager::engineLocation() / Path(u"nova2.py"_s)).toString(),
-        m_usedPlugins.join(u','),
-        m_category
-    };
-    m_searchProcess->setArguments(params + m_pattern.split(u' '));
-
-    connect(m_searchProcess, &QProcess::errorOccurred, this, [this](const QProcess::ProcessError error)
-    {
-        if (!m_searchCancelled)
-        {
-            const auto errMsg = toString(error);
-            LogMsg(tr("Search process failed. Search query: \"%1\". Category: \"%2\". Engines: \"%3\". Error: \"%4\".")
-                .arg(m_pattern, m_category, m_usedPlugins.join(u", "), errMsg), Log::WARNING);
-            emit searchFailed(errMsg);
-        }
-    });
-    connect(m_searchProcess, &QProcess::readyReadStandardOutput, this, &SearchHandler::readSearchOutput);
-    connect(m_searchProcess, qOverload<int, QProcess::ExitStatus>(&QProcess::finished)
-            , this, &SearchHandler::processFinished);
+    connect(workerPool, &SearchWorkerPool::queryResultsReceived, this, &SearchHandler::handleQueryResults);
+    connect(workerPool, &SearchWorkerPool::queryErrorReceived, this, &SearchHandler::handleQueryError);
+    connect(workerPool, &SearchWorkerPool::queryFinished, this, &SearchHandler::handleQueryFinished);
 
     m_searchTimeout->setSingleShot(true);
     connect(m_searchTimeout, &QTimer::timeout, this, &SearchHandler::cancelSearch);
@@ -128,37 +81,66 @@ SearchHandler::SearchHandler(const QString &pattern, const QString &category, co
 
     // Launch search
     // deferred start allows clients to handle starting-related signals
-    QMetaObject::invokeMethod(this, [this]() { m_searchProcess->start(QIODevice::ReadOnly); }
-        , Qt::QueuedConnection);
+    QMetaObject::invokeMethod(this, &SearchHandler::start, Qt::QueuedConnection);
+}
+
+SearchHandler::~SearchHandler()
+{
+    if (m_isActive && m_workerPool)
+        m_workerPool->cancelQuery(m_queryID);
+}
+
+void SearchHandler::start()
+{
+    if (m_resultCache)
+    {
+        if (const auto cachedResults = m_resultCache->find(m_pattern, m_category, m_usedPlugins))
+        {
+            addResults(cachedResults->results);
+
+            if (cachedResults->isFresh)
+            {
+                m_searchTimeout->stop();
+                emit searchFinished(false);
+                return;
+            }
+
+            // stale results are refreshed, only the changes are reported
+        }
+    }
+
+    if (!m_workerPool)
+        return;
+
+    m_queryID = m_workerPool->startQuery(m_usedPlugins, m_category, m_pattern);
+    m_isActive = true;
 }
 
 bool SearchHandler::isActive() const
 {
-    return (m_searchProcess->state() != QProcess::NotRunning);
+    return m_isActive;
 }
 
 void SearchHandler::cancelSearch()
 {
-    if ((m_searchProcess->state() == QProcess::NotRunning) || m_searchCancelled)
+    if (!m_isActive || m_searchCancelled)
         return;
 
-#ifdef Q_OS_WIN
-    m_searchProcess->kill();
-#else
-    m_searchProcess->terminate();
-#endif
+    if (m_workerPool)
+        m_workerPool->cancelQuery(m_queryID);
     m_searchCancelled = true;
     m_searchTimeout->stop();
 }
 
-// Slot called when QProcess is Finished
-// QProcess can be finished for 3 reasons:
-// Error | Stopped by user | Finished normally
-void SearchHandler::processFinished(const int exitcode)
+void SearchHandler::handleQueryFinished(const quint64 queryID, const SearchWorkerPool::QueryStatus status)
 {
+    if (!m_isActive || (queryID != m_queryID))
+        return;
+
+    m_isActive = false;
     m_searchTimeout->stop();
 
-    const auto errMsg = QString::fromUtf8(m_searchProcess->readAllStandardError()).trimmed();
+    const QString errMsg = m_errorMessages.join(u'\n');
     if (!errMsg.isEmpty())
     {
         qWarning("%s", qUtf8Printable(errMsg));
@@ -166,38 +148,55 @@ void SearchHandler::processFinished(const int exitcode)
             .arg(m_pattern, m_category, m_usedPlugins.join(u", "), errMsg), Log::WARNING);
     }
 
-    if (m_searchCancelled)
+    if (m_searchCancelled || (status == SearchWorkerPool::QueryStatus::Cancelled))
         emit searchFinished(true);
-    else if ((m_searchProcess->exitStatus() == QProcess::NormalExit) && (exitcode == 0))
+    else if (status == SearchWorkerPool::QueryStatus::Succeeded)
+    {
+        if (m_resultCache)
+            m_resultCache->insert(m_pattern, m_category, m_usedPlugins, m_resultStore.results());
         emit searchFinished(false);
+    }
     else
         emit searchFailed(errMsg);
 }
 
-// search QProcess return output as soon as it gets new
-// stuff to read. We split it into lines and parse each
-// line to SearchResult calling parseSearchResult().
-void SearchHandler::readSearchOutput()
+void SearchHandler::handleQueryError(const quint64 queryID, const QString &message)
 {
-    const QByteArray output = m_searchResultLineTruncated + m_searchProcess->readAllStandardOutput();
-    QList<QByteArrayView> lines = Utils::ByteArray::splitToViews(output, "\n", Qt::KeepEmptyParts);
+    if (!m_isActive || (queryID != m_queryID))
+        return;
+
+    m_errorMessages.append(message);
+}
 
-    m_searchResultLineTruncated = lines.takeLast().trimmed().toByteArray();
+// Search worker reports the results as soon as it gets them.
+// Each line is parsed to SearchResult calling parseSearchResult().
+void SearchHandler::handleQueryResults(const quint64 queryID, const QByteArrayList &results)
+{
+    if (!m_isActive || (queryID != m_queryID))
+        return;
 
     QList<SearchResult> searchResultList;
-    searchResultList.reserve(lines.size());
+    searchResultList.reserve(results.size());
 
-    for (const QByteArrayView &line : asConst(lines))
+    for (const QByteArray &line : results)
     {
         if (SearchResult searchResult; parseSearchResult(line, searchResult))
             searchResultList.append(std::move(searchResult));
     }
 
-    if (!searchResultList.isEmpty())
-    {
-        m_results.append(searchResultList);
-        emit newSearchResults(searchResultList);
-    }
+    addResults(searchResultList);
+}
+
+void SearchHandler::addResults(const QList<SearchResult> &results)
+{
+    if (results.isEmpty())
+        return;
+
+    const SearchResultStore::Changes changes = m_resultStore.append(results);
+    if (!changes.added.isEmpty())
+        emit newSearchResults(changes.added);
+    if (!changes.updated.isEmpty())
+        emit searchResultsUpdated(changes.updated);
 }
 
 // Parse one line of search results list
@@ -249,7 +248,17 @@ SearchPluginManager *SearchHandler::manager() const
 
 QList<SearchResult> SearchHandler::results() const
 {
-    return m_results;
+    return m_resultStore.results();
+}
+
+const SearchResultStore &SearchHandler::resultStore() const
+{
+    return m_resultStore;
+}
+
+qint64 SearchHandler::estimatedResultsMemoryUsage() const
+{
+    return m_resultStore.estimatedMemoryUsage();
 }
 
 QString SearchHandler::pattern() const
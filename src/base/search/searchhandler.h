@@ -30,27 +30,19 @@
 #pragma once
 
 #include <QByteArray>
-#include <QDateTime>
 #include <QList>
 #include <QObject>
+#include <QPointer>
 #include <QString>
+#include <QStringList>
 #include <QtContainerFwd>
 
-class QProcess;
+#include "searchresultstore.h"
+#include "searchworkerpool.h"
+
 class QTimer;
 
-struct SearchResult
-{
-    QString fileName;
-    QString fileUrl;
-    qlonglong fileSize = 0;
-    qlonglong nbSeeders = 0;
-    qlonglong nbLeechers = 0;
-    QString engineName;
-    QString siteUrl;
-    QString descrLink;
-    QDateTime pubDate;
-};
+class SearchResultCache;
 
 class SearchPluginManager;
 
@@ -61,14 +53,19 @@ class SearchHandler : public QObject
 
     friend class SearchPluginManager;
 
-    SearchHandler(const QString &pattern, const QString &category
-                  , const QStringList &usedPlugins, SearchPluginManager *manager);
+    SearchHandler(const QString &pattern, const QString &category, const QStringList &usedPlugins
+                  , SearchWorkerPool *workerPool, SearchResultCache *resultCache, SearchPluginManager *manager);
 
 public:
+    ~SearchHandler() override;
+
     bool isActive() const;
     QString pattern() const;
     SearchPluginManager *manager() const;
     QList<SearchResult> results() const;
+    const SearchResultStore &resultStore() const;
+    // Rough estimation of the memory used by the results
+    qint64 estimatedResultsMemoryUsage() const;
 
     void cancelSearch();
 
@@ -76,19 +73,27 @@ signals:
     void searchFinished(bool cancelled = false);
     void searchFailed(const QString &errorMessage);
     void newSearchResults(const QList<SearchResult> &results);
+    // Existing results were merged with the same ones reported by other engines
+    void searchResultsUpdated(const QList<qsizetype> &indexes);
 
 private:
-    void readSearchOutput();
-    void processFinished(int exitcode);
+    void start();
+    void addResults(const QList<SearchResult> &results);
+    void handleQueryResults(quint64 queryID, const QByteArrayList &results);
+    void handleQueryError(quint64 queryID, const QString &message);
+    void handleQueryFinished(quint64 queryID, SearchWorkerPool::QueryStatus status);
     bool parseSearchResult(QByteArrayView line, SearchResult &searchResult);
 
     const QString m_pattern;
     const QString m_category;
     const QStringList m_usedPlugins;
     SearchPluginManager *m_manager = nullptr;
-    QProcess *m_searchProcess = nullptr;
+    QPointer<SearchWorkerPool> m_workerPool;
+    SearchResultCache *m_resultCache = nullptr;
     QTimer *m_searchTimeout = nullptr;
-    QByteArray m_searchResultLineTruncated;
+    quint64 m_queryID = 0;
+    bool m_isActive = false;
     bool m_searchCancelled = false;
-    QList<SearchResult> m_results;
+    QStringList m_errorMessages;
+    SearchResultStore m_resultStore;
 };
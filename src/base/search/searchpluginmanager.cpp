@@ -30,16 +30,23 @@
 #include "searchpluginmanager.h"
 
 #include <memory>
+#include <utility>
 
 #include <QtLogging>
+#include <QCryptographicHash>
 #include <QDir>
 #include <QDirIterator>
 #include <QDomDocument>
 #include <QDomElement>
 #include <QDomNode>
 #include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonParseError>
 #include <QPointer>
 #include <QProcess>
+#include <QSet>
 #include <QUrl>
 
 #include "base/global.h"
@@ -51,11 +58,40 @@
 #include "base/utils/bytearray.h"
 #include "base/utils/foreignapps.h"
 #include "base/utils/fs.h"
+#include "base/utils/io.h"
 #include "searchdownloadhandler.h"
 #include "searchhandler.h"
+#include "searchresultcache.h"
+#include "searchworkerpool.h"
 
 namespace
 {
+    const QString CAPABILITIES_CACHE_FILE_NAME = u"searchcapabilities.json"_s;
+    const qint64 MAX_CAPABILITIES_CACHE_FILE_SIZE = 10 * 1024 * 1024;
+    const qint64 MAX_PLUGIN_FILE_SIZE = 10 * 1024 * 1024;
+
+    const QString KEY_NOVA_VERSION = u"nova_version"_s;
+    const QString KEY_PLUGINS = u"plugins"_s;
+    const QString KEY_HASH = u"hash"_s;
+    const QString KEY_NAME = u"name"_s;
+    const QString KEY_URL = u"url"_s;
+    const QString KEY_CATEGORIES = u"categories"_s;
+    const QString KEY_CUSTOM_DOWNLOAD = u"custom_download"_s;
+
+    Path capabilitiesCachePath()
+    {
+        return specialFolderLocation(SpecialFolder::Cache) / Path(CAPABILITIES_CACHE_FILE_NAME);
+    }
+
+    QByteArray pluginFileHash(const Path &path)
+    {
+        const auto readResult = Utils::IO::readFile(path, MAX_PLUGIN_FILE_SIZE);
+        if (!readResult)
+            return {};
+
+        return QCryptographicHash::hash(readResult.value(), QCryptographicHash::Sha256).toHex();
+    }
+
     void clearPythonCache(const Path &path)
     {
         // remove python cache artifacts in `path` and subdirs
@@ -90,10 +126,20 @@ QPointer<SearchPluginManager> SearchPluginManager::m_instance = nullptr;
 SearchPluginManager::SearchPluginManager()
     : m_updateUrl(u"https://raw.githubusercontent.com/qbittorrent/search-plugins/refs/heads/master/nova3/engines/"_s)
     , m_proxyEnv {QProcessEnvironment::systemEnvironment()}
+    , m_searchWorkerPool {new SearchWorkerPool(this)}
+    , m_searchResultCache {std::make_unique<SearchResultCache>()}
 {
     Q_ASSERT(!m_instance); // only one instance is allowed
     m_instance = this;
 
+    // running search workers have to reimport the engines
+    connect(this, &SearchPluginManager::pluginInstalled, m_searchWorkerPool, &SearchWorkerPool::restart);
+    connect(this, &SearchPluginManager::pluginUninstalled, m_searchWorkerPool, &SearchWorkerPool::restart);
+    connect(this, &SearchPluginManager::pluginUpdated, m_searchWorkerPool, &SearchWorkerPool::restart);
+    // cached results could come from the plugins that are gone or changed
+    connect(this, &SearchPluginManager::pluginUninstalled, this, [this] { m_searchResultCache->clear(); });
+    connect(this, &SearchPluginManager::pluginUpdated, this, [this] { m_searchResultCache->clear(); });
+
     connect(Net::ProxyConfigurationManager::instance(), &Net::ProxyConfigurationManager::proxyConfigurationChanged
             , this, &SearchPluginManager::applyProxySettings);
     connect(Preferences::instance(), &Preferences::changed
@@ -101,11 +147,19 @@ SearchPluginManager::SearchPluginManager()
     applyProxySettings();
 
     updateNova();
+    loadCapabilitiesCache();
     update();
 }
 
 SearchPluginManager::~SearchPluginManager()
 {
+    if (m_capabilitiesProbe)
+    {
+        m_capabilitiesProbe->disconnect(this);
+        m_capabilitiesProbe->kill();
+        m_capabilitiesProbe->waitForFinished();
+    }
+
     qDeleteAll(m_plugins);
 }
 
@@ -273,36 +327,38 @@ void SearchPluginManager::installPlugin_impl(const QString &name, const Path &pa
     // Copy the plugin
     Utils::Fs::copyFile(path, destPath);
     // Update supported plugins
-    update();
-    // Check if this was correctly installed
-    if (!m_plugins.contains(name))
+    update([this, name, destPath, backupPath, updated]
     {
-        // Remove broken file
-        Utils::Fs::removeFile(destPath);
-        LogMsg(tr("Plugin %1 is not supported.").arg(name), Log::INFO);
-        if (updated)
+        // Check if this was correctly installed
+        if (!m_plugins.contains(name))
         {
-            // restore backup
-            Utils::Fs::copyFile(backupPath, destPath);
-            Utils::Fs::removeFile(backupPath);
-            // Update supported plugins
-            update();
-            emit pluginUpdateFailed(name, tr("Plugin is not supported."));
+            // Remove broken file
+            Utils::Fs::removeFile(destPath);
+            LogMsg(tr("Plugin %1 is not supported.").arg(name), Log::INFO);
+            if (updated)
+            {
+                // restore backup
+                Utils::Fs::copyFile(backupPath, destPath);
+                Utils::Fs::removeFile(backupPath);
+                // Update supported plugins
+                update();
+                emit pluginUpdateFailed(name, tr("Plugin is not supported."));
+            }
+            else
+            {
+                emit pluginInstallationFailed(name, tr("Plugin is not supported."));
+            }
         }
         else
         {
-            emit pluginInstallationFailed(name, tr("Plugin is not supported."));
-        }
-    }
-    else
-    {
-        // Install was successful, remove backup
-        if (updated)
-        {
-            LogMsg(tr("Plugin %1 has been successfully updated.").arg(name), Log::INFO);
-            Utils::Fs::removeFile(backupPath);
+            // Install was successful, remove backup
+            if (updated)
+            {
+                LogMsg(tr("Plugin %1 has been successfully updated.").arg(name), Log::INFO);
+                Utils::Fs::removeFile(backupPath);
+            }
         }
-    }
+    });
 }
 
 bool SearchPluginManager::uninstallPlugin(const QString &name)
@@ -361,7 +417,7 @@ SearchHandler *SearchPluginManager::startSearch(const QString &pattern, const QS
     // No search pattern entered
     Q_ASSERT(!pattern.isEmpty());
 
-    return new SearchHandler(pattern, category, usedPlugins, this);
+    return new SearchHandler(pattern, category, usedPlugins, m_searchWorkerPool, m_searchResultCache.get(), this);
 }
 
 QProcessEnvironment SearchPluginManager::proxyEnvironment() const
@@ -409,6 +465,16 @@ Path SearchPluginManager::engineLocation()
 }
 
 void SearchPluginManager::applyProxySettings()
+{
+    const QProcessEnvironment oldProxyEnv = m_proxyEnv;
+    updateProxyEnvironment();
+
+    // the environment of the running search workers can't be changed
+    if (m_proxyEnv != oldProxyEnv)
+        m_searchWorkerPool->restart();
+}
+
+void SearchPluginManager::updateProxyEnvironment()
 {
     // for python `urllib`: https://docs.python.org/3/library/urllib.request.html#urllib.request.ProxyHandler
     const QString HTTP_PROXY = u"http_proxy"_s;
@@ -539,40 +605,128 @@ void SearchPluginManager::updateNova()
     updateFile(Path(u"helpers.py"_s));
     updateFile(Path(u"nova2.py"_s));
     updateFile(Path(u"nova2dl.py"_s));
+    updateFile(Path(u"nova2server.py"_s));
     updateFile(Path(u"novaprinter.py"_s));
     updateFile(Path(u"socks.py"_s));
 }
 
-void SearchPluginManager::update()
+void SearchPluginManager::update(std::function<void ()> callback)
+{
+    if (callback)
+        m_pendingUpdateCallbacks.append(std::move(callback));
+
+    // plugin files could be changed after the running probe was started,
+    // so update is repeated once it is finished
+    if (m_capabilitiesProbe)
+    {
+        m_isUpdatePending = true;
+        return;
+    }
+
+    startUpdate();
+}
+
+void SearchPluginManager::startUpdate()
 {
-    QProcess nova;
-    nova.setProcessEnvironment(proxyEnvironment());
+    m_updateCallbacks = std::exchange(m_pendingUpdateCallbacks, {});
+    m_isUpdatePending = false;
+
+    QSet<QString> foundPlugins;
+    QDirIterator iter {pluginsLocation().data(), {u"*.py"_s}, QDir::Files};
+    while (iter.hasNext())
+    {
+        const Path filePath {iter.next()};
+        // mimic engine module name detection of `nova2.py`
+        const QString pluginName = filePath.filename().section(u'.', 0, 0).trimmed();
+        if (pluginName.isEmpty() || pluginName.startsWith(u'_'))
+            continue;
+
+        foundPlugins.insert(pluginName);
+
+        const QByteArray fileHash = pluginFileHash(filePath);
+        const auto cacheIter = m_capabilitiesCache.constFind(pluginName);
+        if (!fileHash.isEmpty() && (cacheIter != m_capabilitiesCache.cend()) && (cacheIter->fileHash == fileHash))
+            applyPluginCapabilities(pluginName, cacheIter.value());
+        else
+            m_probedPluginHashes.insert(pluginName, fileHash);
+    }
+
+    // forget removed plugins
+    const bool isCacheChanged = m_capabilitiesCache.removeIf([&foundPlugins](const auto &item)
+    {
+        return !foundPlugins.contains(item.key());
+    }) > 0;
+
+    if (m_probedPluginHashes.isEmpty())
+    {
+        if (isCacheChanged)
+            storeCapabilitiesCache();
+        finishUpdate();
+        return;
+    }
+
+    m_capabilitiesProbe = new QProcess(this);
+    m_capabilitiesProbe->setProcessEnvironment(proxyEnvironment());
 #ifdef Q_OS_UNIX
-    nova.setUnixProcessParameters(QProcess::UnixProcessFlag::CloseFileDescriptors);
+    m_capabilitiesProbe->setUnixProcessParameters(QProcess::UnixProcessFlag::CloseFileDescriptors);
 #endif
+    connect(m_capabilitiesProbe, qOverload<int, QProcess::ExitStatus>(&QProcess::finished)
+            , this, &SearchPluginManager::handleCapabilitiesProbeFinished);
+    connect(m_capabilitiesProbe, &QProcess::errorOccurred, this, [this](const QProcess::ProcessError error)
+    {
+        if (error != QProcess::FailedToStart)
+            return; // other errors are followed by `finished` signal
+
+        LogMsg(tr("Error occurred when fetching search engine capabilities. Error: \"%1\".")
+            .arg(m_capabilitiesProbe->errorString()), Log::WARNING);
+
+        m_capabilitiesProbe->deleteLater();
+        m_capabilitiesProbe = nullptr;
+        m_probedPluginHashes.clear();
+        finishUpdate();
+    }, Qt::QueuedConnection);
 
     const QStringList params
     {
         Utils::ForeignApps::PYTHON_ISOLATE_MODE_FLAG,
         (engineLocation() / Path(u"/nova2.py"_s)).toString(),
-        u"--capabilities"_s
+        u"--capabilities"_s,
+        (u"--engines="_s + m_probedPluginHashes.keys().join(u','))
     };
-    nova.start(Utils::ForeignApps::pythonInfo().executablePath.data(), params, QIODevice::ReadOnly);
-    nova.waitForFinished();
+    m_capabilitiesProbe->start(Utils::ForeignApps::pythonInfo().executablePath.data(), params, QIODevice::ReadOnly);
+}
+
+void SearchPluginManager::finishUpdate()
+{
+    const QList<std::function<void ()>> callbacks = std::exchange(m_updateCallbacks, {});
+    for (const std::function<void ()> &callback : callbacks)
+        callback();
+
+    if (m_isUpdatePending && !m_capabilitiesProbe)
+        startUpdate();
+}
+
+void SearchPluginManager::handleCapabilitiesProbeFinished(const int exitCode, const QProcess::ExitStatus exitStatus)
+{
+    const QByteArray output = m_capabilitiesProbe->readAllStandardOutput();
+    const auto errMsg = QString::fromUtf8(m_capabilitiesProbe->readAllStandardError()).trimmed();
+    m_capabilitiesProbe->deleteLater();
+    m_capabilitiesProbe = nullptr;
+
+    const QHash<QString, QByteArray> probedPluginHashes = std::exchange(m_probedPluginHashes, {});
 
-    if (const auto errMsg = QString::fromUtf8(nova.readAllStandardError()).trimmed()
-        ; !errMsg.isEmpty())
+    if (!errMsg.isEmpty())
     {
         qWarning("%s", qUtf8Printable(errMsg));
         LogMsg(tr("Error occurred when fetching search engine capabilities. Error: \"%1\".").arg(errMsg), Log::WARNING);
     }
 
-    const auto capabilities = QString::fromUtf8(nova.readAllStandardOutput());
+    const auto capabilities = QString::fromUtf8(output);
     QDomDocument xmlDoc;
-    if (!xmlDoc.setContent(capabilities))
+    if ((exitStatus != QProcess::NormalExit) || (exitCode != 0) || !xmlDoc.setContent(capabilities))
     {
         qWarning() << "Could not parse Nova search engine capabilities, msg: " << capabilities.toLocal8Bit().data();
-        qWarning() << "Error: " << nova.readAllStandardError().constData();
+        finishUpdate();
         return;
     }
 
@@ -580,47 +734,146 @@ void SearchPluginManager::update()
     if (root.tagName() != u"capabilities")
     {
         qWarning() << "Invalid XML file for Nova search engine capabilities, msg: " << capabilities.toLocal8Bit().data();
+        finishUpdate();
         return;
     }
 
     for (QDomNode engineNode = root.firstChild(); !engineNode.isNull(); engineNode = engineNode.nextSibling())
     {
         const QDomElement engineElem = engineNode.toElement();
-        if (!engineElem.isNull())
+        if (engineElem.isNull())
+            continue;
+
+        const QString pluginName = engineElem.tagName();
+        // plugin could be uninstalled while it was probed
+        if (!probedPluginHashes.contains(pluginName) || !pluginPath(pluginName).exists())
+            continue;
+
+        PluginCapabilities pluginCapabilities;
+        pluginCapabilities.fileHash = probedPluginHashes[pluginName];
+        pluginCapabilities.fullName = engineElem.elementsByTagName(u"name"_s).at(0).toElement().text();
+        pluginCapabilities.url = engineElem.elementsByTagName(u"url"_s).at(0).toElement().text();
+
+        const QStringList categories = engineElem.elementsByTagName(u"categories"_s).at(0).toElement().text().split(u' ');
+        for (QString cat : categories)
         {
-            const QString pluginName = engineElem.tagName();
+            cat = cat.trimmed();
+            if (!cat.isEmpty())
+                pluginCapabilities.supportedCategories << cat;
+        }
 
-            auto plugin = std::make_unique<PluginInfo>();
-            plugin->name = pluginName;
-            plugin->version = getPluginVersion(pluginPath(pluginName));
-            plugin->fullName = engineElem.elementsByTagName(u"name"_s).at(0).toElement().text();
-            plugin->url = engineElem.elementsByTagName(u"url"_s).at(0).toElement().text();
+        pluginCapabilities.hasCustomDownload = (engineElem.elementsByTagName(u"custom_download"_s).at(0).toElement().text() != u"no");
 
-            const QStringList categories = engineElem.elementsByTagName(u"categories"_s).at(0).toElement().text().split(u' ');
-            for (QString cat : categories)
-            {
-                cat = cat.trimmed();
-                if (!cat.isEmpty())
-                    plugin->supportedCategories << cat;
-            }
+        // unsupported plugins aren't cached so they are probed again next time
+        m_capabilitiesCache[pluginName] = pluginCapabilities;
+        applyPluginCapabilities(pluginName, pluginCapabilities);
+    }
 
-            const QStringList disabledEngines = Preferences::instance()->getSearchEngDisabled();
-            plugin->enabled = !disabledEngines.contains(pluginName);
+    storeCapabilitiesCache();
+    finishUpdate();
+}
 
-            updateIconPath(plugin.get());
+void SearchPluginManager::applyPluginCapabilities(const QString &pluginName, const PluginCapabilities &capabilities)
+{
+    auto plugin = std::make_unique<PluginInfo>();
+    plugin->name = pluginName;
+    plugin->version = getPluginVersion(pluginPath(pluginName));
+    plugin->fullName = capabilities.fullName;
+    plugin->url = capabilities.url;
+    plugin->supportedCategories = capabilities.supportedCategories;
+    plugin->hasCustomDownload = capabilities.hasCustomDownload;
 
-            if (!m_plugins.contains(pluginName))
-            {
-                m_plugins[pluginName] = plugin.release();
-                emit pluginInstalled(pluginName);
-            }
-            else if (m_plugins[pluginName]->version != plugin->version)
-            {
-                delete m_plugins.take(pluginName);
-                m_plugins[pluginName] = plugin.release();
-                emit pluginUpdated(pluginName);
-            }
+    const QStringList disabledEngines = Preferences::instance()->getSearchEngDisabled();
+    plugin->enabled = !disabledEngines.contains(pluginName);
+
+    updateIconPath(plugin.get());
+
+    if (!m_plugins.contains(pluginName))
+    {
+        m_plugins[pluginName] = plugin.release();
+        emit pluginInstalled(pluginName);
+    }
+    else if (m_plugins[pluginName]->version != plugin->version)
+    {
+        delete m_plugins.take(pluginName);
+        m_plugins[pluginName] = plugin.release();
+        emit pluginUpdated(pluginName);
+    }
+}
+
+void SearchPluginManager::loadCapabilitiesCache()
+{
+    const auto readResult = Utils::IO::readFile(capabilitiesCachePath(), MAX_CAPABILITIES_CACHE_FILE_SIZE);
+    if (!readResult)
+    {
+        if (readResult.error().status != Utils::IO::ReadError::NotExist)
+        {
+            LogMsg(tr("Failed to load search engine capabilities cache. Error: \"%1\".")
+                .arg(readResult.error().message), Log::WARNING);
         }
+        return;
+    }
+
+    QJsonParseError jsonError;
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(readResult.value(), &jsonError);
+    if (jsonError.error != QJsonParseError::NoError)
+    {
+        LogMsg(tr("Failed to parse search engine capabilities cache. Error: \"%1\".")
+            .arg(jsonError.errorString()), Log::WARNING);
+        return;
+    }
+
+    const QJsonObject jsonObj = jsonDoc.object();
+    // capabilities format is defined by `nova2.py`, so they are probed again when it is changed
+    const PluginVersion novaVersion = getPluginVersion(engineLocation() / Path(u"nova2.py"_s));
+    if (jsonObj.value(KEY_NOVA_VERSION).toString() != novaVersion.toString())
+        return;
+
+    const QJsonObject pluginsObj = jsonObj.value(KEY_PLUGINS).toObject();
+    for (auto iter = pluginsObj.constBegin(); iter != pluginsObj.constEnd(); ++iter)
+    {
+        const QJsonObject pluginObj = iter.value().toObject();
+
+        PluginCapabilities pluginCapabilities;
+        pluginCapabilities.fileHash = pluginObj.value(KEY_HASH).toString().toLatin1();
+        pluginCapabilities.fullName = pluginObj.value(KEY_NAME).toString();
+        pluginCapabilities.url = pluginObj.value(KEY_URL).toString();
+        for (const QJsonValue &category : asConst(pluginObj.value(KEY_CATEGORIES).toArray()))
+            pluginCapabilities.supportedCategories.append(category.toString());
+        pluginCapabilities.hasCustomDownload = pluginObj.value(KEY_CUSTOM_DOWNLOAD).toBool(true);
+
+        if (!pluginCapabilities.fileHash.isEmpty())
+            m_capabilitiesCache.insert(iter.key(), pluginCapabilities);
+    }
+}
+
+void SearchPluginManager::storeCapabilitiesCache() const
+{
+    QJsonObject pluginsObj;
+    for (auto iter = m_capabilitiesCache.cbegin(); iter != m_capabilitiesCache.cend(); ++iter)
+    {
+        const PluginCapabilities &pluginCapabilities = iter.value();
+        pluginsObj.insert(iter.key(), QJsonObject {
+            {KEY_HASH, QString::fromLatin1(pluginCapabilities.fileHash)},
+            {KEY_NAME, pluginCapabilities.fullName},
+            {KEY_URL, pluginCapabilities.url},
+            {KEY_CATEGORIES, QJsonArray::fromStringList(pluginCapabilities.supportedCategories)},
+            {KEY_CUSTOM_DOWNLOAD, pluginCapabilities.hasCustomDownload}
+        });
+    }
+
+    const QJsonObject jsonObj
+    {
+        {KEY_NOVA_VERSION, getPluginVersion(engineLocation() / Path(u"nova2.py"_s)).toString()},
+        {KEY_PLUGINS, pluginsObj}
+    };
+
+    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(capabilitiesCachePath()
+        , QJsonDocument(jsonObj).toJson(QJsonDocument::Compact));
+    if (!result)
+    {
+        LogMsg(tr("Failed to save search engine capabilities cache. Error: \"%1\".")
+            .arg(result.error()), Log::WARNING);
     }
 }
 
@@ -29,9 +29,15 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
+
+#include <QByteArray>
 #include <QHash>
+#include <QList>
 #include <QMetaType>
 #include <QObject>
+#include <QProcess>
 #include <QProcessEnvironment>
 
 #include "base/path.h"
@@ -53,11 +59,15 @@ struct PluginInfo
     QString url;
     QStringList supportedCategories;
     Path iconPath;
+    // the plugin downloads torrents by its own code instead of `helpers.download_file()`
+    bool hasCustomDownload = true;
     bool enabled = false;
 };
 
 class SearchDownloadHandler;
 class SearchHandler;
+class SearchResultCache;
+class SearchWorkerPool;
 
 class SearchPluginManager final : public QObject
 {
@@ -108,8 +118,25 @@ signals:
     void checkForUpdatesFailed(const QString &reason);
 
 private:
+    struct PluginCapabilities
+    {
+        QByteArray fileHash;
+        QString fullName;
+        QString url;
+        QStringList supportedCategories;
+        bool hasCustomDownload = true;
+    };
+
     void applyProxySettings();
-    void update();
+    void updateProxyEnvironment();
+    // Refreshes the plugin list asynchronously, `callback` is invoked once it is done
+    void update(std::function<void ()> callback = {});
+    void startUpdate();
+    void finishUpdate();
+    void handleCapabilitiesProbeFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void applyPluginCapabilities(const QString &pluginName, const PluginCapabilities &capabilities);
+    void loadCapabilitiesCache();
+    void storeCapabilitiesCache() const;
     void updateNova();
     void parseVersionInfo(const QByteArray &info);
     void installPlugin_impl(const QString &name, const Path &path);
@@ -126,4 +153,15 @@ private:
 
     QHash<QString, PluginInfo*> m_plugins;
     QProcessEnvironment m_proxyEnv;
+    SearchWorkerPool *m_searchWorkerPool = nullptr;
+    std::unique_ptr<SearchResultCache> m_searchResultCache;
+
+    // Capabilities of the plugins keyed by plugin name, they are only
+    // probed again when the plugin file hash changes
+    QHash<QString, PluginCapabilities> m_capabilitiesCache;
+    QHash<QString, QByteArray> m_probedPluginHashes;
+    QProcess *m_capabilitiesProbe = nullptr;
+    QList<std::function<void ()>> m_updateCallbacks;
+    QList<std::function<void ()>> m_pendingUpdateCallbacks;
+    bool m_isUpdatePending = false;
 };
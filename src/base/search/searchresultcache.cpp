@@ -0,0 +1,91 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "searchresultcache.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "base/global.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    const std::chrono::milliseconds FRESH_RESULTS_TTL = 5min;
+    const std::chrono::milliseconds STALE_RESULTS_TTL = 30min;
+    // Total number of the cached results
+    const qsizetype MAX_CACHED_RESULTS = 20'000;
+}
+
+SearchResultCache::SearchResultCache()
+    : m_entries {MAX_CACHED_RESULTS}
+{
+}
+
+std::optional<SearchResultCache::CachedResults> SearchResultCache::find(const QString &pattern
+        , const QString &category, const QStringList &plugins)
+{
+    const QString key = makeKey(pattern, category, plugins);
+    const Entry *entry = m_entries.object(key);
+    if (!entry)
+        return std::nullopt;
+
+    const std::chrono::milliseconds age {entry->age.elapsed()};
+    if (age >= STALE_RESULTS_TTL)
+    {
+        m_entries.remove(key);
+        return std::nullopt;
+    }
+
+    return CachedResults {entry->results, (age < FRESH_RESULTS_TTL)};
+}
+
+void SearchResultCache::insert(const QString &pattern, const QString &category, const QStringList &plugins
+        , const QList<SearchResult> &results)
+{
+    auto *entry = new Entry;
+    entry->results = results;
+    entry->age.start();
+    // empty results are cached as well, they also cost a search
+    m_entries.insert(makeKey(pattern, category, plugins), entry, std::max<qsizetype>(results.size(), 1));
+}
+
+void SearchResultCache::clear()
+{
+    m_entries.clear();
+}
+
+QString SearchResultCache::makeKey(const QString &pattern, const QString &category, const QStringList &plugins)
+{
+    QStringList normalizedPlugins = plugins;
+    normalizedPlugins.sort();
+    normalizedPlugins.removeDuplicates();
+
+    return category.toLower() + u'\n' + normalizedPlugins.join(u',') + u'\n' + pattern.simplified().toLower();
+}
@@ -0,0 +1,263 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "searchresultstore.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include <QSet>
+#include <QUrlQuery>
+
+#include "base/global.h"
+#include "base/utils/compare.h"
+#include "base/utils/memory.h"
+
+namespace
+{
+    bool merge(SearchResult &existing, const SearchResult &other)
+    {
+        bool isChanged = false;
+
+        // the same torrent is reported by several engines, their peer counts are
+        // retrieved from the same swarm so the largest ones are the most recent
+        if (other.nbSeeders > existing.nbSeeders)
+        {
+            existing.nbSeeders = other.nbSeeders;
+            isChanged = true;
+        }
+        if (other.nbLeechers > existing.nbLeechers)
+        {
+            existing.nbLeechers = other.nbLeechers;
+            isChanged = true;
+        }
+
+        // fill in the data missing in the result received first
+        if ((existing.fileSize <= 0) && (other.fileSize > 0))
+        {
+            existing.fileSize = other.fileSize;
+            isChanged = true;
+        }
+        if (existing.descrLink.isEmpty() && !other.descrLink.isEmpty())
+        {
+            existing.descrLink = other.descrLink;
+            isChanged = true;
+        }
+        if (!existing.pubDate.isValid() && other.pubDate.isValid())
+        {
+            existing.pubDate = other.pubDate;
+            isChanged = true;
+        }
+
+        return isChanged;
+    }
+}
+
+SearchResultStore::Changes SearchResultStore::append(const QList<SearchResult> &results)
+{
+    Changes changes;
+    changes.firstAddedIndex = m_results.size();
+
+    QSet<qsizetype> updatedIndexes;
+    for (const SearchResult &result : results)
+    {
+        const QString key = deduplicationKey(result);
+        if (!key.isEmpty())
+        {
+            if (const auto iter = m_indexesByKey.constFind(key); iter != m_indexesByKey.cend())
+            {
+                const qsizetype index = iter.value();
+                if (merge(m_results[index], result) && (index < changes.firstAddedIndex))
+                    updatedIndexes.insert(index);
+                continue;
+            }
+
+            m_indexesByKey.insert(key, m_results.size());
+        }
+
+        m_results.append(result);
+    }
+
+    changes.added = m_results.mid(changes.firstAddedIndex);
+    changes.updated = {updatedIndexes.cbegin(), updatedIndexes.cend()};
+    std::sort(changes.updated.begin(), changes.updated.end());
+
+    if (!changes.added.isEmpty() || !changes.updated.isEmpty())
+    {
+        for (QList<qsizetype> &sortIndex : m_sortIndexes)
+            sortIndex.clear();
+    }
+
+    return changes;
+}
+
+void SearchResultStore::clear()
+{
+    m_results.clear();
+    m_indexesByKey.clear();
+    for (QList<qsizetype> &sortIndex : m_sortIndexes)
+        sortIndex.clear();
+}
+
+qsizetype SearchResultStore::size() const
+{
+    return m_results.size();
+}
+
+bool SearchResultStore::isEmpty() const
+{
+    return m_results.isEmpty();
+}
+
+const SearchResult &SearchResultStore::at(const qsizetype index) const
+{
+    return m_results.at(index);
+}
+
+QList<SearchResult> SearchResultStore::results() const
+{
+    return m_results;
+}
+
+QList<SearchResult> SearchResultStore::window(const qsizetype offset, const qsizetype limit
+        , const SortKey sortKey, const Qt::SortOrder sortOrder) const
+{
+    const qsizetype size = m_results.size();
+    if ((offset < 0) || (offset >= size))
+        return {};
+
+    const qsizetype count = ((limit < 0) || (limit > (size - offset))) ? (size - offset) : limit;
+    if (sortKey == SortKey::None)
+        return m_results.mid(offset, count);
+
+    const QList<qsizetype> &index = sortIndex(sortKey);
+
+    QList<SearchResult> windowResults;
+    windowResults.reserve(count);
+    for (qsizetype i = offset; i < (offset + count); ++i)
+    {
+        const qsizetype sortedPos = (sortOrder == Qt::AscendingOrder) ? i : (size - i - 1);
+        windowResults.append(m_results.at(index.at(sortedPos)));
+    }
+
+    return windowResults;
+}
+
+qint64 SearchResultStore::estimatedMemoryUsage() const
+{
+    qint64 size = static_cast<qint64>(m_results.capacity() * sizeof(SearchResult));
+    for (const SearchResult &result : asConst(m_results))
+    {
+        size += Utils::Memory::estimateHeapSize(result.fileName) + Utils::Memory::estimateHeapSize(result.fileUrl)
+            + Utils::Memory::estimateHeapSize(result.engineName) + Utils::Memory::estimateHeapSize(result.siteUrl)
+            + Utils::Memory::estimateHeapSize(result.descrLink);
+    }
+
+    size += static_cast<qint64>(m_indexesByKey.capacity() * (sizeof(QString) + sizeof(qsizetype)));
+    for (auto iter = m_indexesByKey.cbegin(); iter != m_indexesByKey.cend(); ++iter)
+        size += Utils::Memory::estimateHeapSize(iter.key());
+    for (const QList<qsizetype> &sortIndex : m_sortIndexes)
+        size += static_cast<qint64>(sortIndex.capacity() * sizeof(qsizetype));
+
+    return size;
+}
+
+QString SearchResultStore::deduplicationKey(const SearchResult &result)
+{
+    const QString fileUrl = result.fileUrl.trimmed();
+    if (!fileUrl.startsWith(u"magnet:", Qt::CaseInsensitive))
+        return fileUrl;
+
+    const QUrlQuery query {fileUrl.sliced(fileUrl.indexOf(u'?') + 1)};
+    for (const QString &exactTopic : asConst(query.allQueryItemValues(u"xt"_s)))
+    {
+        // info hashes are either hex or base32 encoded, both are case insensitive
+        if (exactTopic.startsWith(u"urn:btih:", Qt::CaseInsensitive))
+            return u"btih:" + exactTopic.sliced(9).toLower();
+        if (exactTopic.startsWith(u"urn:btmh:", Qt::CaseInsensitive))
+            return u"btmh:" + exactTopic.sliced(9).toLower();
+    }
+
+    return fileUrl;
+}
+
+const QList<qsizetype> &SearchResultStore::sortIndex(const SortKey sortKey) const
+{
+    QList<qsizetype> &index = m_sortIndexes[static_cast<std::size_t>(sortKey)];
+    if (index.size() == m_results.size())
+        return index;
+
+    index.resize(m_results.size());
+    std::iota(index.begin(), index.end(), 0);
+
+    const auto sortBy = [this, &index](const auto &lessThan)
+    {
+        std::stable_sort(index.begin(), index.end(), [this, &lessThan](const qsizetype left, const qsizetype right)
+        {
+            return lessThan(m_results[left], m_results[right]);
+        });
+    };
+
+    switch (sortKey)
+    {
+    case SortKey::Name:
+        {
+            // Each name takes part in many comparisons so its natural-order key is obtained once
+            const Utils::Compare::NaturalCompare<Qt::CaseInsensitive> naturalCompare;
+            QList<Utils::Compare::NaturalSortKey> nameKeys;
+            nameKeys.reserve(m_results.size());
+            for (const SearchResult &result : asConst(m_results))
+                nameKeys.append(naturalCompare.sortKey(result.fileName));
+
+            std::stable_sort(index.begin(), index.end(), [&nameKeys](const qsizetype left, const qsizetype right)
+            {
+                return (nameKeys[left].compare(nameKeys[right]) < 0);
+            });
+        }
+        break;
+    case SortKey::Size:
+        sortBy([](const SearchResult &left, const SearchResult &right) { return (left.fileSize < right.fileSize); });
+        break;
+    case SortKey::Seeders:
+        sortBy([](const SearchResult &left, const SearchResult &right) { return (left.nbSeeders < right.nbSeeders); });
+        break;
+    case SortKey::Leechers:
+        sortBy([](const SearchResult &left, const SearchResult &right) { return (left.nbLeechers < right.nbLeechers); });
+        break;
+    case SortKey::EngineName:
+        sortBy([](const SearchResult &left, const SearchResult &right) { return (left.engineName < right.engineName); });
+        break;
+    case SortKey::PubDate:
+        sortBy([](const SearchResult &left, const SearchResult &right) { return (left.pubDate < right.pubDate); });
+        break;
+    default:
+        break;
+    }
+
+    return index;
+}
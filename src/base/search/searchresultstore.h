@@ -0,0 +1,103 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <QtTypes>
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+struct SearchResult
+{
+    QString fileName;
+    QString fileUrl;
+    qlonglong fileSize = 0;
+    qlonglong nbSeeders = 0;
+    qlonglong nbLeechers = 0;
+    QString engineName;
+    QString siteUrl;
+    QString descrLink;
+    QDateTime pubDate;
+};
+
+// Keeps the results of a search, merging the ones that refer to the same torrent
+// (i.e. having the same info hash or download link) reported by several engines.
+class SearchResultStore
+{
+public:
+    enum class SortKey
+    {
+        None,
+        Name,
+        Size,
+        Seeders,
+        Leechers,
+        EngineName,
+        PubDate,
+
+        NB_SORT_KEYS
+    };
+
+    struct Changes
+    {
+        // Indexes of the results appended to the store
+        qsizetype firstAddedIndex = 0;
+        QList<SearchResult> added;
+        // Indexes of the existing results updated with the merged data
+        QList<qsizetype> updated;
+    };
+
+    Changes append(const QList<SearchResult> &results);
+    void clear();
+
+    qsizetype size() const;
+    bool isEmpty() const;
+    const SearchResult &at(qsizetype index) const;
+    QList<SearchResult> results() const;
+    // Returns `limit` results (all remaining if negative) starting at `offset`
+    // in the order specified by `sortKey`, or in the order they were added
+    QList<SearchResult> window(qsizetype offset, qsizetype limit
+            , SortKey sortKey = SortKey::None, Qt::SortOrder sortOrder = Qt::AscendingOrder) const;
+
+    // Rough estimation of the memory used by the results
+    qint64 estimatedMemoryUsage() const;
+
+    static QString deduplicationKey(const SearchResult &result);
+
+private:
+    const QList<qsizetype> &sortIndex(SortKey sortKey) const;
+
+    QList<SearchResult> m_results;
+    QHash<QString, qsizetype> m_indexesByKey;
+    // Sort indexes are built on demand and dropped once the results are changed
+    mutable std::array<QList<qsizetype>, static_cast<std::size_t>(SortKey::NB_SORT_KEYS)> m_sortIndexes;
+};
@@ -0,0 +1,320 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "searchworkerpool.h"
+
+#include <algorithm>
+
+#include <QtLogging>
+#include <QByteArrayView>
+#include <QMetaObject>
+#include <QProcess>
+#include <QThread>
+
+#include "base/global.h"
+#include "base/path.h"
+#include "base/utils/bytearray.h"
+#include "base/utils/foreignapps.h"
+#include "searchpluginmanager.h"
+
+namespace
+{
+    // Each worker runs the engines of its queries on its own threads,
+    // so there is no point in having a lot of them
+    const int MAX_SEARCH_WORKERS = 4;
+
+    QString toString(const QProcess::ProcessError error)
+    {
+        switch (error)
+        {
+        case QProcess::FailedToStart:
+            return SearchWorkerPool::tr("Process failed to start");
+        case QProcess::Crashed:
+            return SearchWorkerPool::tr("Process crashed");
+        case QProcess::Timedout:
+            return SearchWorkerPool::tr("Process timed out");
+        case QProcess::WriteError:
+            return SearchWorkerPool::tr("Process write error");
+        case QProcess::ReadError:
+            return SearchWorkerPool::tr("Process read error");
+        case QProcess::UnknownError:
+            return SearchWorkerPool::tr("Process unknown error");
+        }
+        return {};
+    }
+
+    // Command fields are separated by TAB and commands by line feed
+    QByteArray toCommandField(QString value)
+    {
+        value.replace(u'\t', u' ').replace(u'\n', u' ').replace(u'\r', u' ');
+        return value.toUtf8();
+    }
+}
+
+SearchWorkerPool::SearchWorkerPool(SearchPluginManager *manager)
+    : QObject(manager)
+    , m_manager {manager}
+    , m_maxWorkers {std::clamp(QThread::idealThreadCount(), 1, MAX_SEARCH_WORKERS)}
+{
+}
+
+SearchWorkerPool::~SearchWorkerPool()
+{
+    for (Worker *worker : asConst(m_workers))
+    {
+        worker->process->disconnect(this);
+        worker->process->kill();
+        worker->process->waitForFinished();
+        delete worker->process;
+    }
+    qDeleteAll(m_workers);
+}
+
+quint64 SearchWorkerPool::startQuery(const QStringList &plugins, const QString &category, const QString &pattern)
+{
+    const quint64 queryID = ++m_lastQueryID;
+
+    Worker *worker = nullptr;
+    int activeWorkerCount = 0;
+    for (Worker *candidate : asConst(m_workers))
+    {
+        if (candidate->isRetired)
+            continue;
+
+        ++activeWorkerCount;
+        if (!worker || (candidate->queries.size() < worker->queries.size()))
+            worker = candidate;
+    }
+
+    if (!worker || (!worker->queries.isEmpty() && (activeWorkerCount < m_maxWorkers)))
+        worker = spawnWorker();
+
+    worker->queries.append(queryID);
+    m_queryWorkers.insert(queryID, worker);
+
+    writeCommand(worker, "search\t" + QByteArray::number(queryID) + '\t' + toCommandField(plugins.join(u','))
+        + '\t' + toCommandField(category) + '\t' + toCommandField(pattern) + '\n');
+
+    return queryID;
+}
+
+void SearchWorkerPool::cancelQuery(const quint64 queryID)
+{
+    Worker *worker = m_queryWorkers.value(queryID);
+    if (!worker)
+        return;
+
+    writeCommand(worker, "cancel\t" + QByteArray::number(queryID) + '\n');
+}
+
+void SearchWorkerPool::restart()
+{
+    for (Worker *worker : asConst(m_workers))
+    {
+        worker->isRetired = true;
+        closeIfIdle(worker);
+    }
+}
+
+SearchWorkerPool::Worker *SearchWorkerPool::spawnWorker()
+{
+    auto *process = new QProcess(this);
+    // Load environment variables (proxy)
+    process->setProcessEnvironment(m_manager->proxyEnvironment());
+    process->setProgram(Utils::ForeignApps::pythonInfo().executablePath.data());
+#ifdef Q_OS_UNIX
+    process->setUnixProcessParameters(QProcess::UnixProcessFlag::CloseFileDescriptors);
+#endif
+    process->setArguments({Utils::ForeignApps::PYTHON_ISOLATE_MODE_FLAG
+        , (SearchPluginManager::engineLocation() / Path(u"nova2server.py"_s)).toString()});
+
+    auto *worker = new Worker;
+    worker->process = process;
+    m_workers.append(worker);
+
+    // Worker lookup guards against the signals delivered after the worker was removed
+    connect(process, &QProcess::readyReadStandardOutput, this, [this, process]
+    {
+        if (Worker *worker = findWorker(process))
+            readWorkerOutput(worker);
+    });
+    connect(process, &QProcess::readyReadStandardError, this, [this, process]
+    {
+        if (Worker *worker = findWorker(process))
+            readWorkerErrors(worker);
+    });
+    // Queued connection prevents the queries from being failed from within startQuery()
+    connect(process, &QProcess::errorOccurred, this, [this, process](const QProcess::ProcessError error)
+    {
+        if (error != QProcess::FailedToStart)
+            return; // other errors are followed by `finished` signal
+
+        if (Worker *worker = findWorker(process))
+            handleWorkerFailure(worker, toString(error));
+    }, Qt::QueuedConnection);
+    connect(process, qOverload<int, QProcess::ExitStatus>(&QProcess::finished)
+            , this, [this, process](const int exitCode, const QProcess::ExitStatus exitStatus)
+    {
+        Worker *worker = findWorker(process);
+        if (!worker)
+            return;
+
+        readWorkerOutput(worker);
+        readWorkerErrors(worker);
+
+        if (worker->queries.isEmpty())
+        {
+            removeWorker(worker);
+            return;
+        }
+
+        const QString errorMessage = (exitStatus == QProcess::CrashExit)
+            ? toString(QProcess::Crashed)
+            : tr("Process exited unexpectedly. Exit code: %1").arg(exitCode);
+        handleWorkerFailure(worker, errorMessage);
+    });
+
+    process->start();
+    return worker;
+}
+
+SearchWorkerPool::Worker *SearchWorkerPool::findWorker(const QProcess *process) const
+{
+    const auto iter = std::find_if(m_workers.cbegin(), m_workers.cend()
+        , [process](const Worker *worker) { return (worker->process == process); });
+    return (iter != m_workers.cend()) ? *iter : nullptr;
+}
+
+// Worker replies are in the form:
+// result|error|finished <TAB> query ID <TAB> payload
+void SearchWorkerPool::readWorkerOutput(Worker *worker)
+{
+    const QByteArray output = worker->truncatedOutput + worker->process->readAllStandardOutput();
+    QList<QByteArrayView> lines = Utils::ByteArray::splitToViews(output, "\n", Qt::KeepEmptyParts);
+
+    worker->truncatedOutput = lines.takeLast().toByteArray();
+
+    QHash<quint64, QByteArrayList> results;
+    for (const QByteArrayView line : asConst(lines))
+    {
+        const qsizetype kindEnd = line.indexOf('\t');
+        if (kindEnd < 0)
+            continue;
+
+        const qsizetype idEnd = line.indexOf('\t', (kindEnd + 1));
+        const QByteArrayView kind = line.first(kindEnd);
+        const QByteArrayView id = (idEnd < 0) ? line.sliced(kindEnd + 1) : line.sliced((kindEnd + 1), (idEnd - kindEnd - 1));
+        const QByteArrayView payload = (idEnd < 0) ? QByteArrayView() : line.sliced(idEnd + 1).trimmed();
+
+        bool ok = false;
+        const quint64 queryID = id.toULongLong(&ok);
+        if (!ok || !m_queryWorkers.contains(queryID))
+            continue;
+
+        if (kind == "result")
+        {
+            results[queryID].append(payload.toByteArray());
+        }
+        else if (kind == "error")
+        {
+            emit queryErrorReceived(queryID, QString::fromUtf8(payload));
+        }
+        else if (kind == "finished")
+        {
+            if (const QByteArrayList queryResults = results.take(queryID); !queryResults.isEmpty())
+                emit queryResultsReceived(queryID, queryResults);
+
+            worker->queries.removeOne(queryID);
+            m_queryWorkers.remove(queryID);
+
+            const QueryStatus status = (payload == "0")
+                ? QueryStatus::Succeeded
+                : ((payload == "2") ? QueryStatus::Cancelled : QueryStatus::Failed);
+            emit queryFinished(queryID, status);
+        }
+    }
+
+    for (auto iter = results.cbegin(); iter != results.cend(); ++iter)
+        emit queryResultsReceived(iter.key(), iter.value());
+
+    closeIfIdle(worker);
+}
+
+void SearchWorkerPool::readWorkerErrors(Worker *worker)
+{
+    // Engine tracebacks are reported per query, so here is only some stray output of the plugins
+    const QString errMsg = QString::fromUtf8(worker->process->readAllStandardError()).trimmed();
+    if (!errMsg.isEmpty())
+        qWarning("%s", qUtf8Printable(errMsg));
+}
+
+void SearchWorkerPool::handleWorkerFailure(Worker *worker, const QString &errorMessage)
+{
+    // Remove the worker first so that the queries started by
+    // the signal handlers aren't assigned to it
+    const QList<quint64> queries = worker->queries;
+    for (const quint64 queryID : queries)
+        m_queryWorkers.remove(queryID);
+    removeWorker(worker);
+
+    for (const quint64 queryID : queries)
+    {
+        emit queryErrorReceived(queryID, errorMessage);
+        emit queryFinished(queryID, QueryStatus::Failed);
+    }
+}
+
+void SearchWorkerPool::closeIfIdle(Worker *worker)
+{
+    // The worker exits once its input is closed
+    if (worker->isRetired && worker->queries.isEmpty())
+        worker->process->closeWriteChannel();
+}
+
+void SearchWorkerPool::removeWorker(Worker *worker)
+{
+    m_workers.removeOne(worker);
+    worker->process->disconnect(this);
+    if (worker->process->state() != QProcess::NotRunning)
+        worker->process->kill();
+    worker->process->deleteLater();
+    delete worker;
+}
+
+void SearchWorkerPool::writeCommand(Worker *worker, const QByteArray &command)
+{
+    if (worker->process->write(command) == command.size())
+        return;
+
+    QProcess *process = worker->process;
+    QMetaObject::invokeMethod(this, [this, process]
+    {
+        if (Worker *worker = findWorker(process))
+            handleWorkerFailure(worker, toString(QProcess::WriteError));
+    }, Qt::QueuedConnection);
+}
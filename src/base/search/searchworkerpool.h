@@ -0,0 +1,98 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QtTypes>
+#include <QByteArrayList>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+
+class QProcess;
+
+class SearchPluginManager;
+
+// Keeps a few long-lived search engine processes (nova2server.py) running
+// and multiplexes the search queries over them, so that Python interpreter
+// startup and engine imports aren't paid for every search.
+class SearchWorkerPool final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(SearchWorkerPool)
+
+public:
+    enum class QueryStatus
+    {
+        Succeeded,
+        Failed,
+        Cancelled
+    };
+
+    explicit SearchWorkerPool(SearchPluginManager *manager);
+    ~SearchWorkerPool() override;
+
+    quint64 startQuery(const QStringList &plugins, const QString &category, const QString &pattern);
+    void cancelQuery(quint64 queryID);
+
+    // Retires the running workers, so that the subsequent queries are served
+    // by freshly started ones (e.g. to pick up changed plugins or proxy settings).
+    // The queries in progress are allowed to complete.
+    void restart();
+
+signals:
+    void queryResultsReceived(quint64 queryID, const QByteArrayList &results);
+    void queryErrorReceived(quint64 queryID, const QString &message);
+    void queryFinished(quint64 queryID, SearchWorkerPool::QueryStatus status);
+
+private:
+    struct Worker
+    {
+        QProcess *process = nullptr;
+        QList<quint64> queries;
+        QByteArray truncatedOutput;
+        bool isRetired = false;
+    };
+
+    Worker *spawnWorker();
+    Worker *findWorker(const QProcess *process) const;
+    void readWorkerOutput(Worker *worker);
+    void readWorkerErrors(Worker *worker);
+    void handleWorkerFailure(Worker *worker, const QString &errorMessage);
+    void closeIfIdle(Worker *worker);
+    void removeWorker(Worker *worker);
+    void writeCommand(Worker *worker, const QByteArray &command);
+
+    SearchPluginManager *m_manager = nullptr;
+    QList<Worker *> m_workers;
+    QHash<quint64, Worker *> m_queryWorkers;
+    quint64 m_lastQueryID = 0;
+    int m_maxWorkers = 1;
+};
@@ -31,9 +31,12 @@
 
 #include <chrono>
 #include <memory>
+#include <utility>
 
 #include <QFile>
 #include <QHash>
+#include <QMetaObject>
+#include <QThread>
 
 #include "global.h"
 #include "logger.h"
@@ -47,17 +50,28 @@ SettingsStorage *SettingsStorage::m_instance = nullptr;
 
 SettingsStorage::SettingsStorage()
     : m_nativeSettingsName {u"qBittorrent"_s}
+    , m_ioThread {new QThread}
+    , m_ioContext {new QObject}
 {
     readNativeSettings();
 
     m_timer.setSingleShot(true);
     m_timer.setInterval(5s);
     connect(&m_timer, &QTimer::timeout, this, &SettingsStorage::save);
+
+    m_ioContext->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_ioContext, &QObject::deleteLater);
+    m_ioThread->setObjectName("SettingsStorage m_ioThread");
+    m_ioThread->start();
 }
 
 SettingsStorage::~SettingsStorage()
 {
-    save();
+    // The write in progress is completed, while the pending one may be dropped,
+    // so all the unsaved changes are written here
+    m_ioThread.reset();
+    if (m_savedRevision.load() != m_revision.load())
+        writeNativeSettings(m_data);
 }
 
 void SettingsStorage::initInstance()
@@ -79,21 +93,54 @@ SettingsStorage *SettingsStorage::instance()
 
 bool SettingsStorage::save()
 {
-    // return `true` only when settings is different AND is saved successfully
+    // return `true` only when settings is different
 
     const QWriteLocker locker(&m_lock);  // guard for `m_dirty` too
     if (!m_dirty) return false;
 
-    if (!writeNativeSettings())
+    m_dirty = false;
+    m_timer.stop();
+
+    bool isWriteScheduled = false;
     {
-        m_timer.start();
-        return false;
+        const QMutexLocker pendingDataLocker {&m_pendingDataMutex};
+        isWriteScheduled = m_pendingData.has_value();
+        // the data is implicitly shared, so it is cheap to take its snapshot
+        m_pendingData = PendingData {.data = m_data, .revision = m_revision.load()};
     }
 
-    m_dirty = false;
+    if (!isWriteScheduled)
+        QMetaObject::invokeMethod(m_ioContext, [this] { writePendingData(); }, Qt::QueuedConnection);
+
     return true;
 }
 
+void SettingsStorage::writePendingData()
+{
+    std::optional<PendingData> pendingData;
+    {
+        const QMutexLocker pendingDataLocker {&m_pendingDataMutex};
+        pendingData = std::exchange(m_pendingData, std::nullopt);
+    }
+
+    if (!pendingData)
+        return;
+
+    if (writeNativeSettings(pendingData->data))
+    {
+        m_savedRevision.store(pendingData->revision);
+        return;
+    }
+
+    // try again later
+    QMetaObject::invokeMethod(this, [this]
+    {
+        const QWriteLocker locker(&m_lock);
+        m_dirty = true;
+        m_timer.start();
+    }, Qt::QueuedConnection);
+}
+
 QVariant SettingsStorage::loadValueImpl(const QString &key, const QVariant &defaultValue) const
 {
     const QReadLocker locker(&m_lock);
@@ -108,6 +155,7 @@ void SettingsStorage::storeValueImpl(const QString &key, const QVariant &value)
     {
         m_dirty = true;
         currentValue = value;
+        m_revision.fetch_add(1, std::memory_order_release);
         m_timer.start();
     }
 }
@@ -136,14 +184,19 @@ void SettingsStorage::readNativeSettings()
         return Path(nativeSettings->fileName());
     };
 
+    // The main file is replaced atomically, so it is complete if it exists.
+    // "_new" file may be an incomplete one left by an interrupted write then.
+    if (!deserialize(m_data, m_nativeSettingsName).isEmpty())
+        return;
+
     const Path newPath = deserialize(m_data, (m_nativeSettingsName + u"_new"));
     if (!newPath.isEmpty())
     {
-        // "_new" file is NOT empty
+        // "_new" file is NOT empty while the main file is missing
         // This means that the PC closed either due to power outage
-        // or because the disk was full. In any case the settings weren't transferred
-        // in their final position. So assume that qbittorrent_new.ini/qbittorrent_new.conf
-        // contains the most recent settings.
+        // or because the disk was full before the settings were transferred
+        // in their final position (e.g. by older versions that removed the main file first).
+        // So assume that qbittorrent_new.ini/qbittorrent_new.conf contains the most recent settings.
         LogMsg(tr("Detected unclean program exit. Using fallback file to restore settings: %1")
                .arg(newPath.toString()), Log::WARNING);
 
@@ -152,16 +205,11 @@ void SettingsStorage::readNativeSettings()
         finalPathStr.remove(index, 4);
 
         const Path finalPath {finalPathStr};
-        Utils::Fs::removeFile(finalPath);
-        Utils::Fs::renameFile(newPath, finalPath);
-    }
-    else
-    {
-        deserialize(m_data, m_nativeSettingsName);
+        Utils::Fs::replaceFile(newPath, finalPath);
     }
 }
 
-bool SettingsStorage::writeNativeSettings() const
+bool SettingsStorage::writeNativeSettings(const QVariantHash &data) const
 {
     std::unique_ptr<QSettings> nativeSettings = Profile::instance()->applicationSettings(m_nativeSettingsName + u"_new");
 
@@ -170,7 +218,9 @@ bool SettingsStorage::writeNativeSettings() const
     // between deleting the file and recreating it. This is a safety measure.
     // Write everything to qBittorrent_new.ini/qBittorrent_new.conf and if it succeeds
     // replace qBittorrent.ini/qBittorrent.conf with it.
-    for (auto i = m_data.cbegin(); i != m_data.cend(); ++i)
+    // The fallback file may be left by an interrupted write, so its content is discarded.
+    nativeSettings->clear();
+    for (auto i = data.cbegin(); i != data.cend(); ++i)
         nativeSettings->setValue(i.key(), i.value());
 
     nativeSettings->sync(); // Important to get error status
@@ -204,9 +254,9 @@ bool SettingsStorage::writeNativeSettings() const
     const qsizetype index = finalPathStr.lastIndexOf(u"_new", -1, Qt::CaseInsensitive);
     finalPathStr.remove(index, 4);
 
+    // the file is replaced atomically, so there is always a complete one in place
     const Path finalPath {finalPathStr};
-    Utils::Fs::removeFile(finalPath);
-    return Utils::Fs::renameFile(newPath, finalPath);
+    return Utils::Fs::replaceFile(newPath, finalPath);
 }
 
 void SettingsStorage::removeValue(const QString &key)
@@ -215,10 +265,16 @@ void SettingsStorage::removeValue(const QString &key)
     if (m_data.remove(key))
     {
         m_dirty = true;
+        m_revision.fetch_add(1, std::memory_order_release);
         m_timer.start();
     }
 }
 
+quint64 SettingsStorage::revision() const
+{
+    return m_revision.load(std::memory_order_acquire);
+}
+
 bool SettingsStorage::hasKey(const QString &key) const
 {
     const QReadLocker locker {&m_lock};
@@ -30,8 +30,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <optional>
 #include <type_traits>
 
+#include <QMutex>
 #include <QObject>
 #include <QReadWriteLock>
 #include <QTimer>
@@ -40,6 +43,7 @@
 
 #include "base/concepts/stringable.h"
 #include "utils/string.h"
+#include "utils/thread.h"
 
 template <typename T>
 concept IsQFlags = std::same_as<T, QFlags<typename T::enum_type>>;
@@ -110,21 +114,41 @@ public:
     void removeValue(const QString &key);
     bool hasKey(const QString &key) const;
     bool isEmpty() const;
+    // It is changed whenever any value is stored or removed
+    quint64 revision() const;
 
 public slots:
+    // Schedules writing of the changed settings in background,
+    // returns `false` if there is nothing to write
     bool save();
 
 private:
+    struct PendingData
+    {
+        QVariantHash data;
+        quint64 revision = 0;
+    };
+
     QVariant loadValueImpl(const QString &key, const QVariant &defaultValue = {}) const;
     void storeValueImpl(const QString &key, const QVariant &value);
     void readNativeSettings();
-    bool writeNativeSettings() const;
+    bool writeNativeSettings(const QVariantHash &data) const;
+    void writePendingData();
 
     static SettingsStorage *m_instance;
 
     const QString m_nativeSettingsName;
     bool m_dirty = false;
     QVariantHash m_data;
+    std::atomic<quint64> m_revision = 0;
     QTimer m_timer;
     mutable QReadWriteLock m_lock;
+
+    // Settings are written in a dedicated thread. Only the most recent data is kept waiting
+    // for it, so the changes saved while the previous data is being written are coalesced.
+    Utils::Thread::UniquePtr m_ioThread;
+    QObject *m_ioContext = nullptr;
+    std::optional<PendingData> m_pendingData;
+    QMutex m_pendingDataMutex;
+    std::atomic<quint64> m_savedRevision = 0;
 };
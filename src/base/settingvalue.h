@@ -28,6 +28,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <type_traits>
+
+#include <QMutex>
 #include <QString>
 
 #include "settingsstorage.h"
@@ -106,3 +110,63 @@ private:
     SettingValue<T> m_setting;
     T m_cache;
 };
+
+// Like `CachedSettingValue`, but the cached value can be read from any thread without locking,
+// so it suits the settings that are read on hot paths. The cache is reloaded after any value
+// is changed in `SettingsStorage`, so it doesn't get stale even if the setting is stored elsewhere.
+template <typename T>
+requires std::is_trivially_copyable_v<T>
+class AtomicCachedSettingValue
+{
+public:
+    explicit AtomicCachedSettingValue(const QString &keyName, const T &defaultValue = {})
+        : m_setting {keyName}
+        , m_defaultValue {defaultValue}
+    {
+        reload();
+    }
+
+    T get() const
+    {
+        if (m_revision.load(std::memory_order_acquire) != SettingsStorage::instance()->revision())
+            reload();
+        return m_cache.load(std::memory_order_relaxed);
+    }
+
+    operator T() const
+    {
+        return get();
+    }
+
+    AtomicCachedSettingValue<T> &operator=(const T &value)
+    {
+        if (get() == value)
+            return *this;
+
+        // the cache is reloaded on next access since the storage revision is changed
+        m_setting = value;
+        return *this;
+    }
+
+private:
+    void reload() const
+    {
+        const QMutexLocker locker {&m_reloadMutex};
+
+        // the revision is obtained first so the loaded value is at least as recent as it
+        const quint64 revision = SettingsStorage::instance()->revision();
+        if (m_isLoaded && (m_revision.load(std::memory_order_relaxed) == revision))
+            return;
+
+        m_cache.store(m_setting.get(m_defaultValue), std::memory_order_relaxed);
+        m_revision.store(revision, std::memory_order_release);
+        m_isLoaded = true;
+    }
+
+    SettingValue<T> m_setting;
+    const T m_defaultValue;
+    mutable std::atomic<T> m_cache {};
+    mutable std::atomic<quint64> m_revision = 0;
+    mutable bool m_isLoaded = false;
+    mutable QMutex m_reloadMutex;
+};
@@ -0,0 +1,349 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "speedhistory.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <QByteArray>
+#include <QDataStream>
+#include <QDateTime>
+#include <QList>
+#include <QTimer>
+
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/sessionstatus.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/path.h"
+#include "base/profile.h"
+#include "base/utils/io.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    const QByteArray HISTORY_SIGNATURE = QByteArrayLiteral("qBittorrent speed history\n");
+    const quint32 HISTORY_VERSION = 1;
+    const qint64 HISTORY_SIZE_LIMIT = 10 * 1024 * 1024;
+    const auto SAVE_INTERVAL = 10min;
+
+    const SpeedHistory::Resolution RESOLUTIONS[] =
+    {
+        SpeedHistory::Resolution::Second,
+        SpeedHistory::Resolution::Minute,
+        SpeedHistory::Resolution::Hour
+    };
+
+    Path historyFilePath()
+    {
+        return specialFolderLocation(SpecialFolder::Data) / Path(u"speedhistory.dat"_s);
+    }
+}
+
+SpeedHistory *SpeedHistory::m_instance = nullptr;
+
+void SpeedHistory::initInstance()
+{
+    if (!m_instance)
+        m_instance = new SpeedHistory;
+}
+
+void SpeedHistory::freeInstance()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+SpeedHistory *SpeedHistory::instance()
+{
+    return m_instance;
+}
+
+qint64 SpeedHistory::interval(const Resolution resolution)
+{
+    switch (resolution)
+    {
+    case Resolution::Second:
+        return 1;
+    case Resolution::Minute:
+        return 60;
+    case Resolution::Hour:
+        return 60 * 60;
+    }
+
+    Q_UNREACHABLE();
+}
+
+int SpeedHistory::capacity(const Resolution resolution)
+{
+    switch (resolution)
+    {
+    case Resolution::Second:
+        return 30 * 60; // 30 minutes
+    case Resolution::Minute:
+        return 24 * 60; // 24 hours
+    case Resolution::Hour:
+        return 30 * 24; // 30 days
+    }
+
+    Q_UNREACHABLE();
+}
+
+void SpeedHistory::Accumulator::add(const std::array<quint64, SeriesCount> &sample)
+{
+    for (int i = 0; i < SeriesCount; ++i)
+    {
+        sum[i] += sample[i];
+        min[i] = (count > 0) ? std::min(min[i], sample[i]) : sample[i];
+        max[i] = (count > 0) ? std::max(max[i], sample[i]) : sample[i];
+    }
+    ++count;
+}
+
+SpeedHistory::Bucket SpeedHistory::Accumulator::toBucket() const
+{
+    Q_ASSERT(count > 0);
+
+    Bucket bucket {.timestamp = timestamp};
+    for (int i = 0; i < SeriesCount; ++i)
+        bucket.values[i] = {.min = min[i], .max = max[i], .avg = (sum[i] / count)};
+    return bucket;
+}
+
+SpeedHistory::Tier::Tier(const Resolution resolution)
+    : interval {SpeedHistory::interval(resolution)}
+    , buckets {static_cast<boost::circular_buffer<Bucket>::size_type>(SpeedHistory::capacity(resolution))}
+{
+}
+
+void SpeedHistory::Tier::add(const qint64 time, const std::array<quint64, SeriesCount> &sample)
+{
+    const qint64 bucketStart = time - (time % interval);
+    // the samples received after the clock was set back are added to the current bucket
+    if (bucketStart > current.timestamp)
+    {
+        if (current.count > 0)
+            buckets.push_back(current.toBucket());
+
+        // keep the buckets ordered even if the clock was set back while the history wasn't being recorded
+        while (!buckets.empty() && (buckets.back().timestamp >= bucketStart))
+            buckets.pop_back();
+
+        current = {.timestamp = bucketStart};
+    }
+
+    current.add(sample);
+}
+
+SpeedHistory::SpeedHistory(QObject *parent)
+    : QObject(parent)
+    , m_tiers {Tier(Resolution::Second), Tier(Resolution::Minute), Tier(Resolution::Hour)}
+    , m_saveTimer {new QTimer(this)}
+{
+    load();
+
+    connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated, this, &SpeedHistory::handleStatsUpdated);
+
+    m_saveTimer->setInterval(SAVE_INTERVAL);
+    connect(m_saveTimer, &QTimer::timeout, this, &SpeedHistory::save);
+    m_saveTimer->start();
+}
+
+SpeedHistory::~SpeedHistory()
+{
+    save();
+}
+
+QList<SpeedHistory::Bucket> SpeedHistory::buckets(const Resolution resolution, const qint64 since) const
+{
+    const Tier &t = tier(resolution);
+
+    const auto first = std::ranges::lower_bound(t.buckets, since, {}, &Bucket::timestamp);
+
+    QList<Bucket> result;
+    result.reserve(std::distance(first, t.buckets.end()) + 1);
+    std::copy(first, t.buckets.end(), std::back_inserter(result));
+    if ((t.current.count > 0) && (t.current.timestamp >= since))
+        result.append(t.current.toBucket());
+    return result;
+}
+
+const SpeedHistory::Tier &SpeedHistory::tier(const Resolution resolution) const
+{
+    return m_tiers[static_cast<int>(resolution)];
+}
+
+void SpeedHistory::handleStatsUpdated()
+{
+    const BitTorrent::SessionStatus &status = BitTorrent::Session::instance()->status();
+
+    std::array<quint64, SeriesCount> sample;
+    sample[Upload] = status.uploadRate;
+    sample[Download] = status.downloadRate;
+    sample[PayloadUpload] = status.payloadUploadRate;
+    sample[PayloadDownload] = status.payloadDownloadRate;
+    sample[OverheadUpload] = status.ipOverheadUploadRate;
+    sample[OverheadDownload] = status.ipOverheadDownloadRate;
+    sample[DHTUpload] = status.dhtUploadRate;
+    sample[DHTDownload] = status.dhtDownloadRate;
+    sample[TrackerUpload] = status.trackerUploadRate;
+    sample[TrackerDownload] = status.trackerDownloadRate;
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    for (Tier &t : m_tiers)
+        t.add(now, sample);
+
+    emit sampleAdded();
+}
+
+void SpeedHistory::load()
+{
+    const Path path = historyFilePath();
+    const auto readResult = Utils::IO::readFile(path, HISTORY_SIZE_LIMIT);
+    if (!readResult)
+    {
+        if (readResult.error().status != Utils::IO::ReadError::NotExist)
+        {
+            LogMsg(tr("Failed to load speed history. File: \"%1\". Error: \"%2\"")
+                .arg(path.toString(), readResult.error().message), Log::WARNING);
+        }
+        return;
+    }
+
+    const QByteArray &data = readResult.value();
+    if (!data.startsWith(HISTORY_SIGNATURE))
+    {
+        LogMsg(tr("Failed to load speed history. File: \"%1\". Error: \"%2\"")
+            .arg(path.toString(), tr("Unsupported file format.")), Log::WARNING);
+        return;
+    }
+
+    QDataStream stream {data};
+    stream.setVersion(QDataStream::Qt_6_0);
+    stream.skipRawData(HISTORY_SIGNATURE.size());
+
+    quint32 version = 0;
+    quint32 tierCount = 0;
+    stream >> version >> tierCount;
+    if (version != HISTORY_VERSION)
+    {
+        LogMsg(tr("Failed to load speed history. File: \"%1\". Error: \"%2\"")
+            .arg(path.toString(), tr("Unsupported file format.")), Log::WARNING);
+        return;
+    }
+
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    for (quint32 i = 0; (i < tierCount) && (stream.status() == QDataStream::Ok); ++i)
+    {
+        qint64 tierInterval = 0;
+        quint32 bucketCount = 0;
+        stream >> tierInterval >> bucketCount;
+
+        const auto tierIter = std::ranges::find(m_tiers, tierInterval, &Tier::interval);
+        for (quint32 j = 0; (j < bucketCount) && (stream.status() == QDataStream::Ok); ++j)
+        {
+            // only non-zero values are stored, the mask tells which series they belong to
+            Bucket bucket;
+            quint16 mask = 0;
+            stream >> bucket.timestamp >> mask;
+            for (int series = 0; series < SeriesCount; ++series)
+            {
+                if (mask & (1 << series))
+                {
+                    Value &value = bucket.values[series];
+                    stream >> value.min >> value.max >> value.avg;
+                }
+            }
+
+            if (tierIter == m_tiers.end())
+                continue;
+
+            // skip unordered buckets and the ones that can still be accumulated
+            boost::circular_buffer<Bucket> &buckets = tierIter->buckets;
+            if ((!buckets.empty() && (bucket.timestamp <= buckets.back().timestamp))
+                    || ((bucket.timestamp + tierInterval) > now))
+            {
+                continue;
+            }
+
+            buckets.push_back(bucket);
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok)
+    {
+        LogMsg(tr("Failed to load speed history. File: \"%1\". Error: \"%2\"")
+            .arg(path.toString(), tr("File is corrupted.")), Log::WARNING);
+        for (Tier &t : m_tiers)
+            t.buckets.clear();
+    }
+}
+
+void SpeedHistory::save() const
+{
+    QByteArray data;
+    {
+        QDataStream stream {&data, QIODevice::WriteOnly};
+        stream.setVersion(QDataStream::Qt_6_0);
+        stream.writeRawData(HISTORY_SIGNATURE.constData(), HISTORY_SIGNATURE.size());
+        stream << HISTORY_VERSION << static_cast<quint32>(m_tiers.size());
+        for (const Resolution resolution : RESOLUTIONS)
+        {
+            const QList<Bucket> tierBuckets = buckets(resolution);
+            stream << interval(resolution) << static_cast<quint32>(tierBuckets.size());
+            for (const Bucket &bucket : tierBuckets)
+            {
+                quint16 mask = 0;
+                for (int series = 0; series < SeriesCount; ++series)
+                {
+                    if (bucket.values[series].max > 0)
+                        mask |= (1 << series);
+                }
+
+                stream << bucket.timestamp << mask;
+                for (int series = 0; series < SeriesCount; ++series)
+                {
+                    if (mask & (1 << series))
+                    {
+                        const Value &value = bucket.values[series];
+                        stream << value.min << value.max << value.avg;
+                    }
+                }
+            }
+        }
+    }
+
+    const Path path = historyFilePath();
+    if (const auto result = Utils::IO::saveToFile(path, data); !result)
+    {
+        LogMsg(tr("Failed to save speed history. File: \"%1\". Error: \"%2\"")
+            .arg(path.toString(), result.error()), Log::WARNING);
+    }
+}
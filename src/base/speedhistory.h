@@ -0,0 +1,140 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+
+#include <boost/circular_buffer.hpp>
+
+#include <QtContainerFwd>
+#include <QObject>
+
+class QTimer;
+
+// Keeps the history of session transfer rates at several resolutions.
+// Each resolution has a fixed number of buckets holding the minimum, maximum and
+// average rate of each series during the bucket interval, so the memory used doesn't
+// grow over time. The history is saved on exit and periodically, and loaded on start.
+class SpeedHistory final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(SpeedHistory)
+
+public:
+    enum Series
+    {
+        Upload,
+        Download,
+        PayloadUpload,
+        PayloadDownload,
+        OverheadUpload,
+        OverheadDownload,
+        DHTUpload,
+        DHTDownload,
+        TrackerUpload,
+        TrackerDownload,
+
+        SeriesCount
+    };
+
+    enum class Resolution
+    {
+        Second,
+        Minute,
+        Hour
+    };
+
+    struct Value
+    {
+        quint64 min = 0;
+        quint64 max = 0;
+        quint64 avg = 0;
+    };
+
+    struct Bucket
+    {
+        // Start of the bucket interval, in seconds since epoch
+        qint64 timestamp = 0;
+        std::array<Value, SeriesCount> values {};
+    };
+
+    static void initInstance();
+    static void freeInstance();
+    static SpeedHistory *instance();
+
+    // Bucket interval in seconds
+    static qint64 interval(Resolution resolution);
+    // Maximum number of stored buckets
+    static int capacity(Resolution resolution);
+
+    // Buckets starting at or after `since` (seconds since epoch) in chronological order.
+    // The last one is the current bucket which is still being accumulated.
+    QList<Bucket> buckets(Resolution resolution, qint64 since = 0) const;
+
+signals:
+    void sampleAdded();
+
+private:
+    struct Accumulator
+    {
+        qint64 timestamp = -1;
+        int count = 0;
+        std::array<quint64, SeriesCount> sum {};
+        std::array<quint64, SeriesCount> min {};
+        std::array<quint64, SeriesCount> max {};
+
+        void add(const std::array<quint64, SeriesCount> &sample);
+        Bucket toBucket() const;
+    };
+
+    struct Tier
+    {
+        explicit Tier(Resolution resolution);
+
+        void add(qint64 time, const std::array<quint64, SeriesCount> &sample);
+
+        const qint64 interval;
+        boost::circular_buffer<Bucket> buckets;
+        Accumulator current;
+    };
+
+    explicit SpeedHistory(QObject *parent = nullptr);
+    ~SpeedHistory() override;
+
+    void handleStatsUpdated();
+    void load();
+    void save() const;
+
+    const Tier &tier(Resolution resolution) const;
+
+    static SpeedHistory *m_instance;
+
+    std::array<Tier, 3> m_tiers;
+    QTimer *m_saveTimer = nullptr;
+};
@@ -30,20 +30,27 @@
 #include "torrentfileswatcher.h"
 
 #include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
 
 #include <QtAssert>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
 #include <QFileSystemWatcher>
+#include <QFuture>
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QPromise>
 #include <QSet>
 #include <QThread>
+#include <QThreadPool>
 #include <QTimer>
 #include <QVariant>
 
 #include "base/algorithm.h"
+#include "base/asyncfilestorage.h"
 #include "base/bittorrent/torrentcontentlayout.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
@@ -60,7 +67,11 @@
 using namespace std::chrono_literals;
 
 const std::chrono::seconds WATCH_INTERVAL {10};
+const std::chrono::seconds PROCESSING_DELAY {2};
 const int MAX_FAILED_RETRIES = 5;
+// Torrent files are loaded in parallel and the found torrents are added in batches of this size
+const qsizetype TORRENTS_BATCH_SIZE = 64;
+const std::chrono::seconds STORING_DELAY {5};
 const QString CONF_FILE_NAME = u"watched_folders.json"_s;
 
 const QString OPTION_ADDTORRENTPARAMS = u"add_torrent_params"_s;
@@ -82,6 +93,28 @@ namespace
         return {{OPTION_ADDTORRENTPARAMS, BitTorrent::serializeAddTorrentParams(options.addTorrentParams)},
                 {OPTION_RECURSIVE, options.recursive}};
     }
+
+    BitTorrent::AddTorrentParams makeAddTorrentParams(const Path &folderPath, const Path &watchedFolderPath
+            , const TorrentFilesWatcher::WatchedFolderOptions &options)
+    {
+        BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
+        if (folderPath != watchedFolderPath)
+        {
+            const Path subdirPath = watchedFolderPath.relativePathOf(folderPath);
+            const bool useAutoTMM = addTorrentParams.useAutoTMM.value_or(!BitTorrent::Session::instance()->isAutoTMMDisabledByDefault());
+            if (useAutoTMM)
+            {
+                addTorrentParams.category = addTorrentParams.category.isEmpty()
+                        ? subdirPath.data() : (addTorrentParams.category + u'/' + subdirPath.data());
+            }
+            else
+            {
+                addTorrentParams.savePath = addTorrentParams.savePath / subdirPath;
+            }
+        }
+
+        return addTorrentParams;
+    }
 }
 
 class TorrentFilesWatcher::Worker final : public QObject
@@ -97,21 +130,41 @@ public slots:
     void removeWatchedFolder(const Path &path);
 
 signals:
-    void torrentFound(const BitTorrent::TorrentDescriptor &torrentDescr, const BitTorrent::AddTorrentParams &addTorrentParams);
+    void torrentsFound(const QList<TorrentFilesWatcher::FoundTorrent> &torrents);
 
 private:
+    struct TorrentFile
+    {
+        Path path;
+        Path watchedFolderPath;
+        BitTorrent::AddTorrentParams addTorrentParams;
+    };
+
     void onTimeout();
+    void onDirectoryChanged(const Path &path);
     void scheduleWatchedFolderProcessing(const Path &path);
+    void processPendingFolders();
     void processWatchedFolder(const Path &path);
-    void processFolder(const Path &path, const Path &watchedFolderPath, const TorrentFilesWatcher::WatchedFolderOptions &options);
+    void processFolder(const Path &path, const Path &watchedFolderPath, const TorrentFilesWatcher::WatchedFolderOptions &options
+            , QList<TorrentFile> &torrentFiles);
+    void processMagnetFile(const Path &filePath, const BitTorrent::AddTorrentParams &addTorrentParams, QList<TorrentFilesWatcher::FoundTorrent> &foundTorrents);
+    void loadTorrentFiles(const QList<TorrentFile> &torrentFiles);
     void processFailedTorrents();
     void addWatchedFolder(const Path &path, const TorrentFilesWatcher::WatchedFolderOptions &options);
     void updateWatchedFolder(const Path &path, const TorrentFilesWatcher::WatchedFolderOptions &options);
+    void watchFolder(const Path &path);
+    void unwatchFolder(const Path &path);
+    void updateWatchedSubfolders(const Path &path);
 
     QFileSystemWatcher *m_watcher = nullptr;
     QTimer *m_watchTimer = nullptr;
     QHash<Path, TorrentFilesWatcher::WatchedFolderOptions> m_watchedFolders;
     QSet<Path> m_watchedByTimeoutFolders;
+    // Subfolders of the recursively watched folders which are watched for the file system events
+    QHash<Path, Path> m_watchedSubfolders;
+    // Folders are processed with delay so that the events of the files being copied are coalesced
+    QTimer *m_processingTimer = nullptr;
+    QSet<Path> m_pendingFolders;
 
     // Failed torrents
     QTimer *m_retryTorrentTimer = nullptr;
@@ -140,18 +193,40 @@ TorrentFilesWatcher *TorrentFilesWatcher::instance()
 TorrentFilesWatcher::TorrentFilesWatcher(QObject *parent)
     : QObject(parent)
     , m_ioThread {new QThread}
+    , m_fileStorage {new AsyncFileStorage(specialFolderLocation(SpecialFolder::Config))}
+    , m_storingTimer {new QTimer(this)}
     , m_asyncWorker {new TorrentFilesWatcher::Worker(new QFileSystemWatcher(this))}
 {
-    connect(m_asyncWorker, &TorrentFilesWatcher::Worker::torrentFound, this, &TorrentFilesWatcher::onTorrentFound);
+    connect(m_asyncWorker, &TorrentFilesWatcher::Worker::torrentsFound, this, &TorrentFilesWatcher::onTorrentsFound);
+
+    m_storingTimer->setSingleShot(true);
+    m_storingTimer->setInterval(STORING_DELAY);
+    connect(m_storingTimer, &QTimer::timeout, this, &TorrentFilesWatcher::store);
+
+    m_fileStorage->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_fileStorage, &QObject::deleteLater);
+    connect(m_fileStorage, &AsyncFileStorage::failed, this, [](const Path &filePath, const QString &errorString)
+    {
+        LogMsg(tr("Couldn't store Watched Folders configuration to %1. Error: %2")
+            .arg(filePath.toString(), errorString), Log::WARNING);
+    });
 
     m_asyncWorker->moveToThread(m_ioThread.get());
     connect(m_ioThread.get(), &QThread::finished, m_asyncWorker, &QObject::deleteLater);
     m_ioThread->setObjectName("TorrentFilesWatcher m_ioThread");
+    Utils::Thread::setWorkload(m_ioThread.get(), Utils::Thread::Workload::Bulk);
     m_ioThread->start();
 
     load();
 }
 
+TorrentFilesWatcher::~TorrentFilesWatcher()
+{
+    // it is written by IO thread which is stopped after all the other jobs are processed
+    if (m_storingTimer->isActive())
+        store();
+}
+
 void TorrentFilesWatcher::load()
 {
     const int fileMaxSize = 10 * 1024 * 1024;
@@ -239,8 +314,16 @@ void TorrentFilesWatcher::loadLegacy()
     SettingsStorage::instance()->removeValue(u"Preferences/Downloads/ScanDirsV2"_s);
 }
 
-void TorrentFilesWatcher::store() const
+void TorrentFilesWatcher::storeDeferred()
 {
+    if (!m_storingTimer->isActive())
+        m_storingTimer->start();
+}
+
+void TorrentFilesWatcher::store()
+{
+    m_storingTimer->stop();
+
     QJsonObject jsonObj;
     for (auto it = m_watchedFolders.cbegin(); it != m_watchedFolders.cend(); ++it)
     {
@@ -249,14 +332,7 @@ void TorrentFilesWatcher::store() const
         jsonObj[watchedFolder.data()] = serializeWatchedFolderOptions(options);
     }
 
-    const Path path = specialFolderLocation(SpecialFolder::Config) / Path(CONF_FILE_NAME);
-    const QByteArray data = QJsonDocument(jsonObj).toJson();
-    const nonstd::expected<void, QString> result = Utils::IO::saveToFile(path, data);
-    if (!result)
-    {
-        LogMsg(tr("Couldn't store Watched Folders configuration to %1. Error: %2")
-            .arg(path.toString(), result.error()), Log::WARNING);
-    }
+    m_fileStorage->store(Path(CONF_FILE_NAME), QJsonDocument(jsonObj).toJson());
 }
 
 QHash<Path, TorrentFilesWatcher::WatchedFolderOptions> TorrentFilesWatcher::folders() const
@@ -267,7 +343,7 @@ QHash<Path, TorrentFilesWatcher::WatchedFolderOptions> TorrentFilesWatcher::fold
 void TorrentFilesWatcher::setWatchedFolder(const Path &path, const WatchedFolderOptions &options)
 {
     doSetWatchedFolder(path, options);
-    store();
+    storeDeferred();
 }
 
 void TorrentFilesWatcher::doSetWatchedFolder(const Path &path, const WatchedFolderOptions &options)
@@ -302,27 +378,34 @@ void TorrentFilesWatcher::removeWatchedFolder(const Path &path)
 
         emit watchedFolderRemoved(path);
 
-        store();
+        storeDeferred();
     }
 }
 
-void TorrentFilesWatcher::onTorrentFound(const BitTorrent::TorrentDescriptor &torrentDescr
-        , const BitTorrent::AddTorrentParams &addTorrentParams)
+void TorrentFilesWatcher::onTorrentsFound(const QList<FoundTorrent> &torrents)
 {
-    BitTorrent::Session::instance()->addTorrent(torrentDescr, addTorrentParams);
+    auto *session = BitTorrent::Session::instance();
+    for (const FoundTorrent &torrent : torrents)
+        session->addTorrent(torrent.torrentDescr, torrent.addTorrentParams);
 }
 
 TorrentFilesWatcher::Worker::Worker(QFileSystemWatcher *watcher)
     : m_watcher {watcher}
     , m_watchTimer {new QTimer(this)}
+    , m_processingTimer {new QTimer(this)}
     , m_retryTorrentTimer {new QTimer(this)}
 {
     connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, [this](const QString &path)
     {
-        scheduleWatchedFolderProcessing(Path(path));
+        onDirectoryChanged(Path(path));
     });
     connect(m_watchTimer, &QTimer::timeout, this, &Worker::onTimeout);
 
+    m_processingTimer->setSingleShot(true);
+    m_processingTimer->setTimerType(Qt::CoarseTimer);
+    m_processingTimer->setInterval(PROCESSING_DELAY);
+    connect(m_processingTimer, &QTimer::timeout, this, &Worker::processPendingFolders);
+
     connect(m_retryTorrentTimer, &QTimer::timeout, this, &Worker::processFailedTorrents);
 }
 
@@ -332,6 +415,12 @@ void TorrentFilesWatcher::Worker::onTimeout()
         processWatchedFolder(path);
 }
 
+void TorrentFilesWatcher::Worker::onDirectoryChanged(const Path &path)
+{
+    // changes in the subfolders cause processing of the whole watched folder
+    scheduleWatchedFolderProcessing(m_watchedSubfolders.value(path, path));
+}
+
 void TorrentFilesWatcher::Worker::setWatchedFolder(const Path &path, const TorrentFilesWatcher::WatchedFolderOptions &options)
 {
     if (m_watchedFolders.contains(path))
@@ -344,10 +433,11 @@ void TorrentFilesWatcher::Worker::removeWatchedFolder(const Path &path)
 {
     m_watchedFolders.remove(path);
 
-    m_watcher->removePath(path.data());
+    unwatchFolder(path);
     m_watchedByTimeoutFolders.remove(path);
     if (m_watchedByTimeoutFolders.isEmpty())
         m_watchTimer->stop();
+    m_pendingFolders.remove(path);
 
     m_failedTorrents.remove(path);
     if (m_failedTorrents.isEmpty())
@@ -356,135 +446,164 @@ void TorrentFilesWatcher::Worker::removeWatchedFolder(const Path &path)
 
 void TorrentFilesWatcher::Worker::scheduleWatchedFolderProcessing(const Path &path)
 {
-    QTimer::singleShot(2s, Qt::CoarseTimer, this, [this, path]
+    m_pendingFolders.insert(path);
+    if (!m_processingTimer->isActive())
+        m_processingTimer->start();
+}
+
+void TorrentFilesWatcher::Worker::processPendingFolders()
+{
+    const QSet<Path> pendingFolders = std::exchange(m_pendingFolders, {});
+    for (const Path &path : pendingFolders)
     {
-        processWatchedFolder(path);
-    });
+        if (m_watchedFolders.contains(path))
+            processWatchedFolder(path);
+    }
 }
 
 void TorrentFilesWatcher::Worker::processWatchedFolder(const Path &path)
 {
     const TorrentFilesWatcher::WatchedFolderOptions options = m_watchedFolders.value(path);
-    processFolder(path, path, options);
+    QList<TorrentFile> torrentFiles;
+    processFolder(path, path, options, torrentFiles);
+    loadTorrentFiles(torrentFiles);
+
+    // new subfolders could be created since the folder was processed last time
+    if (options.recursive && !m_watchedByTimeoutFolders.contains(path))
+        updateWatchedSubfolders(path);
 
     if (!m_failedTorrents.empty() && !m_retryTorrentTimer->isActive())
         m_retryTorrentTimer->start(WATCH_INTERVAL);
 }
 
 void TorrentFilesWatcher::Worker::processFolder(const Path &path, const Path &watchedFolderPath
-                                              , const TorrentFilesWatcher::WatchedFolderOptions &options)
+        , const TorrentFilesWatcher::WatchedFolderOptions &options, QList<TorrentFile> &torrentFiles)
 {
+    const BitTorrent::AddTorrentParams addTorrentParams = makeAddTorrentParams(path, watchedFolderPath, options);
+
+    QList<TorrentFilesWatcher::FoundTorrent> foundTorrents;
     QDirIterator dirIter {path.data(), {u"*.torrent"_s, u"*.magnet"_s}, QDir::Files};
     while (dirIter.hasNext())
     {
         const Path filePath {dirIter.next()};
-        BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
-        if (path != watchedFolderPath)
+        if (filePath.hasExtension(u".magnet"_s))
+            processMagnetFile(filePath, addTorrentParams, foundTorrents);
+        else
+            torrentFiles.append({.path = filePath, .watchedFolderPath = watchedFolderPath, .addTorrentParams = addTorrentParams});
+    }
+
+    if (!foundTorrents.isEmpty())
+        emit torrentsFound(foundTorrents);
+
+    if (options.recursive)
+    {
+        QDirIterator iter {path.data(), (QDir::Dirs | QDir::NoDotAndDotDot)};
+        while (iter.hasNext())
         {
-            const Path subdirPath = watchedFolderPath.relativePathOf(path);
-            const bool useAutoTMM = addTorrentParams.useAutoTMM.value_or(!BitTorrent::Session::instance()->isAutoTMMDisabledByDefault());
-            if (useAutoTMM)
-            {
-                addTorrentParams.category = addTorrentParams.category.isEmpty()
-                        ? subdirPath.data() : (addTorrentParams.category + u'/' + subdirPath.data());
-            }
-            else
-            {
-                addTorrentParams.savePath = addTorrentParams.savePath / subdirPath;
-            }
+            const Path folderPath {iter.next()};
+            // Skip processing of subdirectory that is explicitly set as watched folder
+            if (!m_watchedFolders.contains(folderPath))
+                processFolder(folderPath, watchedFolderPath, options, torrentFiles);
         }
+    }
+}
 
-        if (filePath.hasExtension(u".magnet"_s))
-        {
-            const int fileMaxSize = 100 * 1024 * 1024;
+void TorrentFilesWatcher::Worker::processMagnetFile(const Path &filePath, const BitTorrent::AddTorrentParams &addTorrentParams
+        , QList<TorrentFilesWatcher::FoundTorrent> &foundTorrents)
+{
+    const int fileMaxSize = 100 * 1024 * 1024;
 
-            QFile file {filePath.data()};
-            if (file.open(QIODevice::ReadOnly | QIODevice::Text))
-            {
-                if (file.size() <= fileMaxSize)
-                {
-                    while (!file.atEnd())
-                    {
-                        const auto line = QString::fromLatin1(file.readLine()).trimmed();
-                        if (const auto parseResult = BitTorrent::TorrentDescriptor::parse(line))
-                            emit torrentFound(parseResult.value(), addTorrentParams);
-                        else
-                            LogMsg(tr("Invalid Magnet URI. URI: %1. Reason: %2").arg(line, parseResult.error()), Log::WARNING);
-                    }
-
-                    file.close();
-                    Utils::Fs::removeFile(filePath);
-                }
-                else
-                {
-                    LogMsg(tr("Magnet file too big. File: %1").arg(file.errorString()), Log::WARNING);
-                }
-            }
-            else
+    QFile file {filePath.data()};
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        LogMsg(tr("Failed to open magnet file: %1").arg(file.errorString()));
+        return;
+    }
+
+    if (file.size() > fileMaxSize)
+    {
+        LogMsg(tr("Magnet file too big. File: %1").arg(file.errorString()), Log::WARNING);
+        return;
+    }
+
+    while (!file.atEnd())
+    {
+        const auto line = QString::fromLatin1(file.readLine()).trimmed();
+        if (const auto parseResult = BitTorrent::TorrentDescriptor::parse(line))
+            foundTorrents.append({.torrentDescr = parseResult.value(), .addTorrentParams = addTorrentParams});
+        else
+            LogMsg(tr("Invalid Magnet URI. URI: %1. Reason: %2").arg(line, parseResult.error()), Log::WARNING);
+    }
+
+    file.close();
+    Utils::Fs::removeFile(filePath);
+}
+
+void TorrentFilesWatcher::Worker::loadTorrentFiles(const QList<TorrentFile> &torrentFiles)
+{
+    using LoadResult = nonstd::expected<BitTorrent::TorrentDescriptor, QString>;
+
+    QThreadPool *threadPool = QThreadPool::globalInstance();
+    for (qsizetype batchStart = 0; batchStart < torrentFiles.size(); batchStart += TORRENTS_BATCH_SIZE)
+    {
+        const QList<TorrentFile> batch = torrentFiles.mid(batchStart, TORRENTS_BATCH_SIZE);
+
+        std::vector<QFuture<LoadResult>> jobs;
+        jobs.reserve(batch.size());
+        for (const TorrentFile &torrentFile : batch)
+        {
+            auto promise = std::make_shared<QPromise<LoadResult>>();
+            jobs.push_back(promise->future());
+            promise->start();
+            threadPool->start([promise, path = torrentFile.path]
             {
-                LogMsg(tr("Failed to open magnet file: %1").arg(file.errorString()));
-            }
+                promise->addResult(BitTorrent::TorrentDescriptor::loadFromFile(path));
+                promise->finish();
+            });
         }
-        else
+
+        QList<TorrentFilesWatcher::FoundTorrent> foundTorrents;
+        foundTorrents.reserve(batch.size());
+        for (qsizetype i = 0; i < batch.size(); ++i)
         {
-            if (const auto loadResult = BitTorrent::TorrentDescriptor::loadFromFile(filePath))
+            const TorrentFile &torrentFile = batch[i];
+            const LoadResult loadResult = jobs[i].result();
+            if (loadResult)
             {
-                emit torrentFound(loadResult.value(), addTorrentParams);
-                Utils::Fs::removeFile(filePath);
+                foundTorrents.append({.torrentDescr = loadResult.value(), .addTorrentParams = torrentFile.addTorrentParams});
+                Utils::Fs::removeFile(torrentFile.path);
             }
             else
             {
-                if (!m_failedTorrents.value(path).contains(filePath))
-                {
-                    m_failedTorrents[path][filePath] = 0;
-                }
+                // the file can be still being written so it is retried later
+                QHash<Path, int> &failedTorrents = m_failedTorrents[torrentFile.watchedFolderPath];
+                if (!failedTorrents.contains(torrentFile.path))
+                    failedTorrents[torrentFile.path] = 0;
             }
         }
-    }
 
-    if (options.recursive)
-    {
-        QDirIterator iter {path.data(), (QDir::Dirs | QDir::NoDotAndDotDot)};
-        while (iter.hasNext())
-        {
-            const Path folderPath {iter.next()};
-            // Skip processing of subdirectory that is explicitly set as watched folder
-            if (!m_watchedFolders.contains(folderPath))
-                processFolder(folderPath, watchedFolderPath, options);
-        }
+        if (!foundTorrents.isEmpty())
+            emit torrentsFound(foundTorrents);
     }
 }
 
 void TorrentFilesWatcher::Worker::processFailedTorrents()
 {
+    QList<TorrentFilesWatcher::FoundTorrent> foundTorrents;
+
     // Check which torrents are still partial
-    Algorithm::removeIf(m_failedTorrents, [this](const Path &watchedFolderPath, QHash<Path, int> &partialTorrents)
+    Algorithm::removeIf(m_failedTorrents, [this, &foundTorrents](const Path &watchedFolderPath, QHash<Path, int> &partialTorrents)
     {
         const TorrentFilesWatcher::WatchedFolderOptions options = m_watchedFolders.value(watchedFolderPath);
-        Algorithm::removeIf(partialTorrents, [this, &watchedFolderPath, &options](const Path &torrentPath, int &value)
+        Algorithm::removeIf(partialTorrents, [&watchedFolderPath, &options, &foundTorrents](const Path &torrentPath, int &value)
         {
             if (!torrentPath.exists())
                 return true;
 
             if (const auto loadResult = BitTorrent::TorrentDescriptor::loadFromFile(torrentPath))
             {
-                BitTorrent::AddTorrentParams addTorrentParams = options.addTorrentParams;
-                if (torrentPath != watchedFolderPath)
-                {
-                    const Path subdirPath = watchedFolderPath.relativePathOf(torrentPath);
-                    const bool useAutoTMM = addTorrentParams.useAutoTMM.value_or(!BitTorrent::Session::instance()->isAutoTMMDisabledByDefault());
-                    if (useAutoTMM)
-                    {
-                        addTorrentParams.category = addTorrentParams.category.isEmpty()
-                                ? subdirPath.data() : (addTorrentParams.category + u'/' + subdirPath.data());
-                    }
-                    else
-                    {
-                        addTorrentParams.savePath = addTorrentParams.savePath / subdirPath;
-                    }
-                }
-
-                emit torrentFound(loadResult.value(), addTorrentParams);
+                foundTorrents.append({.torrentDescr = loadResult.value()
+                        , .addTorrentParams = makeAddTorrentParams(torrentPath.parentPath(), watchedFolderPath, options)});
                 Utils::Fs::removeFile(torrentPath);
 
                 return true;
@@ -507,6 +626,9 @@ void TorrentFilesWatcher::Worker::processFailedTorrents()
         return false;
     });
 
+    if (!foundTorrents.isEmpty())
+        emit torrentsFound(foundTorrents);
+
     // Stop the partial timer if necessary
     if (m_failedTorrents.empty())
         m_retryTorrentTimer->stop();
@@ -516,8 +638,10 @@ void TorrentFilesWatcher::Worker::processFailedTorrents()
 
 void TorrentFilesWatcher::Worker::addWatchedFolder(const Path &path, const TorrentFilesWatcher::WatchedFolderOptions &options)
 {
+    m_watchedFolders[path] = options;
+
     // Check if the `path` points to a network file system or not
-    if (Utils::Fs::isNetworkFileSystem(path) || options.recursive)
+    if (Utils::Fs::isNetworkFileSystem(path))
     {
         m_watchedByTimeoutFolders.insert(path);
         if (!m_watchTimer->isActive())
@@ -525,40 +649,74 @@ void TorrentFilesWatcher::Worker::addWatchedFolder(const Path &path, const Torre
     }
     else
     {
-        m_watcher->addPath(path.data());
+        watchFolder(path);
         scheduleWatchedFolderProcessing(path);
     }
 
-    m_watchedFolders[path] = options;
-
     LogMsg(tr("Watching folder: \"%1\"").arg(path.toString()));
 }
 
 void TorrentFilesWatcher::Worker::updateWatchedFolder(const Path &path, const TorrentFilesWatcher::WatchedFolderOptions &options)
 {
     const bool recursiveModeChanged = (m_watchedFolders[path].recursive != options.recursive);
-    if (recursiveModeChanged && !Utils::Fs::isNetworkFileSystem(path))
+    m_watchedFolders[path] = options;
+
+    if (recursiveModeChanged && !m_watchedByTimeoutFolders.contains(path))
     {
-        if (options.recursive)
-        {
-            m_watcher->removePath(path.data());
+        unwatchFolder(path);
+        watchFolder(path);
+        scheduleWatchedFolderProcessing(path);
+    }
+}
 
-            m_watchedByTimeoutFolders.insert(path);
-            if (!m_watchTimer->isActive())
-                m_watchTimer->start(WATCH_INTERVAL);
-        }
-        else
-        {
-            m_watchedByTimeoutFolders.remove(path);
-            if (m_watchedByTimeoutFolders.isEmpty())
-                m_watchTimer->stop();
+void TorrentFilesWatcher::Worker::watchFolder(const Path &path)
+{
+    m_watcher->addPath(path.data());
+    if (m_watchedFolders.value(path).recursive)
+        updateWatchedSubfolders(path);
+}
 
-            m_watcher->addPath(path.data());
-            scheduleWatchedFolderProcessing(path);
-        }
+void TorrentFilesWatcher::Worker::unwatchFolder(const Path &path)
+{
+    m_watcher->removePath(path.data());
+
+    QStringList subfolders;
+    for (auto iter = m_watchedSubfolders.cbegin(); iter != m_watchedSubfolders.cend(); ++iter)
+    {
+        if (iter.value() == path)
+            subfolders.append(iter.key().data());
     }
 
-    m_watchedFolders[path] = options;
+    if (!subfolders.isEmpty())
+    {
+        m_watcher->removePaths(subfolders);
+        m_watchedSubfolders.removeIf([&path](const QHash<Path, Path>::iterator &iter) { return iter.value() == path; });
+    }
+}
+
+void TorrentFilesWatcher::Worker::updateWatchedSubfolders(const Path &path)
+{
+    // deleted folders are removed from the file system watcher automatically
+    m_watchedSubfolders.removeIf([&path](const QHash<Path, Path>::iterator &iter)
+    {
+        return (iter.value() == path) && !iter.key().exists();
+    });
+
+    QStringList newSubfolders;
+    QDirIterator iter {path.data(), (QDir::Dirs | QDir::NoDotAndDotDot), QDirIterator::Subdirectories};
+    while (iter.hasNext())
+    {
+        const Path folderPath {iter.next()};
+        // subdirectories explicitly set as watched folders are watched separately
+        if (m_watchedFolders.contains(folderPath) || m_watchedSubfolders.contains(folderPath))
+            continue;
+
+        m_watchedSubfolders.insert(folderPath, path);
+        newSubfolders.append(folderPath.data());
+    }
+
+    if (!newSubfolders.isEmpty())
+        m_watcher->addPaths(newSubfolders);
 }
 
 #include "torrentfileswatcher.moc"
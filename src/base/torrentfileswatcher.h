@@ -30,16 +30,23 @@
 #pragma once
 
 #include <QHash>
+#include <QList>
 
 #include "base/bittorrent/addtorrentparams.h"
 #include "base/bittorrent/torrentdescriptor.h"
 #include "base/path.h"
 #include "base/utils/thread.h"
 
+class QTimer;
+
+class AsyncFileStorage;
+
 /*
  * Watches the configured directories for new .torrent files in order
- * to add torrents to BitTorrent session. Supports Network File System
- * watching (NFS, CIFS) on Linux and Mac OS.
+ * to add torrents to BitTorrent session. The local directories (including
+ * the subdirectories of the recursively watched ones) are watched for
+ * the file system events, Network File System directories (NFS, CIFS)
+ * are scanned periodically.
  */
 class TorrentFilesWatcher final : public QObject
 {
@@ -53,6 +60,12 @@ public:
         bool recursive = false;
     };
 
+    struct FoundTorrent
+    {
+        BitTorrent::TorrentDescriptor torrentDescr;
+        BitTorrent::AddTorrentParams addTorrentParams;
+    };
+
     static void initInstance();
     static void freeInstance();
     static TorrentFilesWatcher *instance();
@@ -66,14 +79,16 @@ signals:
     void watchedFolderRemoved(const Path &path);
 
 private slots:
-    void onTorrentFound(const BitTorrent::TorrentDescriptor &torrentDescr, const BitTorrent::AddTorrentParams &addTorrentParams);
+    void onTorrentsFound(const QList<FoundTorrent> &torrents);
 
 private:
     explicit TorrentFilesWatcher(QObject *parent = nullptr);
+    ~TorrentFilesWatcher() override;
 
     void load();
     void loadLegacy();
-    void store() const;
+    void store();
+    void storeDeferred();
 
     void doSetWatchedFolder(const Path &path, const WatchedFolderOptions &options);
 
@@ -82,6 +97,9 @@ private:
     QHash<Path, WatchedFolderOptions> m_watchedFolders;
 
     Utils::Thread::UniquePtr m_ioThread;
+    AsyncFileStorage *m_fileStorage = nullptr;
+    // Configuration is stored with delay so that the bulk changes are written at once
+    QTimer *m_storingTimer = nullptr;
 
     class Worker;
     Worker *m_asyncWorker = nullptr;
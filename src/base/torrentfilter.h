@@ -106,6 +106,11 @@ public:
     bool setTag(const std::optional<Tag> &tag);
     bool setPrivate(std::optional<bool> isPrivate);
 
+    Type type() const;
+    const std::optional<QString> &category() const;
+    const std::optional<Tag> &tag() const;
+    const std::optional<TorrentIDSet> &torrentIDSet() const;
+
     bool match(const BitTorrent::Torrent *torrent) const;
 
 private:
@@ -0,0 +1,402 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentfilterindex.h"
+
+#include <algorithm>
+#include <iterator>
+
+#include <QList>
+
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrent.h"
+#include "base/global.h"
+
+namespace
+{
+    const int TRIGRAM_SIZE = 3;
+
+    // Returns the sorted unique trigrams of the text
+    QList<quint64> trigrams(const QString &text)
+    {
+        QList<quint64> result;
+        if (text.size() < TRIGRAM_SIZE)
+            return result;
+
+        result.reserve(text.size() - TRIGRAM_SIZE + 1);
+        for (qsizetype i = 0; i <= (text.size() - TRIGRAM_SIZE); ++i)
+        {
+            result.append((static_cast<quint64>(text[i].unicode()) << 32)
+                | (static_cast<quint64>(text[i + 1].unicode()) << 16)
+                | static_cast<quint64>(text[i + 2].unicode()));
+        }
+
+        std::ranges::sort(result);
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+}
+
+TorrentFilterIndex *TorrentFilterIndex::m_instance = nullptr;
+
+void TorrentFilterIndex::initInstance()
+{
+    if (!m_instance)
+        m_instance = new TorrentFilterIndex;
+}
+
+void TorrentFilterIndex::freeInstance()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+TorrentFilterIndex *TorrentFilterIndex::instance()
+{
+    return m_instance;
+}
+
+TorrentFilterIndex::TorrentFilterIndex(QObject *parent)
+    : QObject(parent)
+{
+    // It should be created before any other consumer of these signals
+    // so the index is already up to date when they are handling them
+    const auto *session = BitTorrent::Session::instance();
+    connect(session, &BitTorrent::Session::torrentsLoaded, this, &TorrentFilterIndex::handleTorrentsLoaded);
+    connect(session, &BitTorrent::Session::torrentAboutToBeRemoved, this, &TorrentFilterIndex::handleTorrentAboutToBeRemoved);
+    connect(session, &BitTorrent::Session::torrentsUpdated, this, &TorrentFilterIndex::handleTorrentsUpdated);
+    connect(session, &BitTorrent::Session::torrentCategoryChanged, this, &TorrentFilterIndex::handleTorrentCategoryChanged);
+    connect(session, &BitTorrent::Session::torrentTagAdded, this, &TorrentFilterIndex::handleTorrentTagAdded);
+    connect(session, &BitTorrent::Session::torrentTagRemoved, this, &TorrentFilterIndex::handleTorrentTagRemoved);
+
+    handleTorrentsLoaded(session->torrents());
+}
+
+quint64 TorrentFilterIndex::revision() const
+{
+    return m_revision;
+}
+
+int TorrentFilterIndex::torrentSlot(const BitTorrent::Torrent *torrent) const
+{
+    return m_torrentSlots.value(torrent, -1);
+}
+
+int TorrentFilterIndex::statusTorrentsCount(const TorrentFilter::Type status) const
+{
+    return m_statusGroups[status].count;
+}
+
+int TorrentFilterIndex::categoryTorrentsCount(const QString &category) const
+{
+    const auto iter = m_categoryGroups.constFind(category);
+    return (iter != m_categoryGroups.cend()) ? iter->count : 0;
+}
+
+int TorrentFilterIndex::tagTorrentsCount(const Tag &tag) const
+{
+    const auto iter = m_tagGroups.constFind(tag);
+    return (iter != m_tagGroups.cend()) ? iter->count : 0;
+}
+
+QBitArray TorrentFilterIndex::matchingTorrents(const TorrentFilter::Type status, const std::optional<QString> &category
+        , const std::optional<Tag> &tag) const
+{
+    // Bitsets can have different sizes, the missing bits are treated as unset ones
+    QBitArray result = m_statusGroups[status].members;
+
+    if (category)
+    {
+        if (category->isEmpty() || !BitTorrent::Session::instance()->isSubcategoriesEnabled())
+        {
+            result &= m_categoryGroups.value(*category).members;
+        }
+        else
+        {
+            const QString subcategoryPrefix = *category + u'/';
+            QBitArray categoryMembers;
+            for (auto it = m_categoryGroups.cbegin(); it != m_categoryGroups.cend(); ++it)
+            {
+                if ((it.key() == *category) || it.key().startsWith(subcategoryPrefix))
+                    categoryMembers |= it->members;
+            }
+            result &= categoryMembers;
+        }
+    }
+
+    if (tag)
+        result &= m_tagGroups.value(*tag).members;
+
+    return result;
+}
+
+QBitArray TorrentFilterIndex::matchingNameTorrents(const QString &text) const
+{
+    if (text.isEmpty())
+        return m_statusGroups[TorrentFilter::All].members;
+
+    const QString foldedText = text.toCaseFolded();
+    QBitArray result {m_names.size()};
+    const auto matchSlot = [this, &foldedText, &result](const int slot)
+    {
+        if (m_names[slot].contains(foldedText))
+            result.setBit(slot);
+    };
+
+    if (foldedText.size() < TRIGRAM_SIZE)
+    {
+        for (const int slot : asConst(m_torrentSlots))
+            matchSlot(slot);
+        return result;
+    }
+
+    // The candidates are the torrents having all the trigrams of the text,
+    // the slot lists are intersected starting from the shortest one
+    const QList<quint64> textTrigrams = trigrams(foldedText);
+    QList<const QList<int> *> trigramSlots;
+    for (const quint64 trigram : textTrigrams)
+    {
+        const auto iter = m_nameTrigramSlots.constFind(trigram);
+        if (iter == m_nameTrigramSlots.cend())
+            return result;
+
+        trigramSlots.append(&iter.value());
+    }
+    std::ranges::sort(trigramSlots, {}, [](const QList<int> *slotList) { return slotList->size(); });
+
+    QList<int> candidates = *trigramSlots.first();
+    for (qsizetype i = 1; (i < trigramSlots.size()) && !candidates.isEmpty(); ++i)
+    {
+        QList<int> intersection;
+        std::ranges::set_intersection(candidates, *trigramSlots[i], std::back_inserter(intersection));
+        candidates = std::move(intersection);
+    }
+
+    for (const int slot : asConst(candidates))
+        matchSlot(slot);
+    return result;
+}
+
+void TorrentFilterIndex::handleTorrentsLoaded(const QList<BitTorrent::Torrent *> &torrents)
+{
+    for (const BitTorrent::Torrent *torrent : torrents)
+    {
+        if (m_torrentSlots.contains(torrent))
+            continue;
+
+        const int slot = !m_freeSlots.isEmpty() ? m_freeSlots.takeLast() : static_cast<int>(m_torrentSlots.size());
+        m_torrentSlots.insert(torrent, slot);
+
+        setMember(m_statusGroups[TorrentFilter::All], slot, true);
+        updateStatuses(torrent, slot);
+        updateName(slot, torrent->name());
+        setMember(m_categoryGroups, torrent->category(), slot, true);
+
+        const TagSet tags = torrent->tags();
+        if (tags.isEmpty())
+        {
+            setMember(m_tagGroups, Tag(), slot, true);
+        }
+        else
+        {
+            for (const Tag &tag : tags)
+                setMember(m_tagGroups, tag, slot, true);
+        }
+    }
+
+    ++m_revision;
+}
+
+void TorrentFilterIndex::handleTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent)
+{
+    const auto slotIter = m_torrentSlots.find(torrent);
+    if (slotIter == m_torrentSlots.end())
+        return;
+
+    const int slot = slotIter.value();
+    m_torrentSlots.erase(slotIter);
+
+    for (Group &group : m_statusGroups)
+        setMember(group, slot, false);
+    updateName(slot, {});
+
+    setMember(m_categoryGroups, torrent->category(), slot, false);
+
+    const TagSet tags = torrent->tags();
+    if (tags.isEmpty())
+    {
+        setMember(m_tagGroups, Tag(), slot, false);
+    }
+    else
+    {
+        for (const Tag &tag : tags)
+            setMember(m_tagGroups, tag, slot, false);
+    }
+
+    m_freeSlots.append(slot);
+    ++m_revision;
+}
+
+void TorrentFilterIndex::handleTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents)
+{
+    bool isChanged = false;
+    for (const BitTorrent::Torrent *torrent : torrents)
+    {
+        if (const int slot = torrentSlot(torrent); slot >= 0)
+        {
+            isChanged |= updateStatuses(torrent, slot);
+            // the name is changed by the user or when the metadata is received
+            isChanged |= updateName(slot, torrent->name());
+        }
+    }
+
+    if (isChanged)
+        ++m_revision;
+}
+
+void TorrentFilterIndex::handleTorrentCategoryChanged(BitTorrent::Torrent *torrent, const QString &oldCategory)
+{
+    const int slot = torrentSlot(torrent);
+    if (slot < 0)
+        return;
+
+    setMember(m_categoryGroups, oldCategory, slot, false);
+    setMember(m_categoryGroups, torrent->category(), slot, true);
+    ++m_revision;
+}
+
+void TorrentFilterIndex::handleTorrentTagAdded(BitTorrent::Torrent *torrent, const Tag &tag)
+{
+    const int slot = torrentSlot(torrent);
+    if (slot < 0)
+        return;
+
+    if (torrent->tags().size() == 1)
+        setMember(m_tagGroups, Tag(), slot, false);
+    setMember(m_tagGroups, tag, slot, true);
+    ++m_revision;
+}
+
+void TorrentFilterIndex::handleTorrentTagRemoved(BitTorrent::Torrent *torrent, const Tag &tag)
+{
+    const int slot = torrentSlot(torrent);
+    if (slot < 0)
+        return;
+
+    setMember(m_tagGroups, tag, slot, false);
+    if (torrent->tags().isEmpty())
+        setMember(m_tagGroups, Tag(), slot, true);
+    ++m_revision;
+}
+
+bool TorrentFilterIndex::updateStatuses(const BitTorrent::Torrent *torrent, const int slot)
+{
+    bool isChanged = false;
+    for (int status = (TorrentFilter::All + 1); status < TorrentFilter::_Count; ++status)
+    {
+        const auto type = static_cast<TorrentFilter::Type>(status);
+        isChanged |= setMember(m_statusGroups[type], slot, TorrentFilter(type).match(torrent));
+    }
+
+    return isChanged;
+}
+
+bool TorrentFilterIndex::updateName(const int slot, const QString &name)
+{
+    if (slot >= m_names.size())
+    {
+        if (name.isEmpty())
+            return false;
+
+        m_names.resize(slot + 1);
+    }
+
+    const QString foldedName = name.toCaseFolded();
+    if (m_names[slot] == foldedName)
+        return false;
+
+    const QList<quint64> oldTrigrams = trigrams(m_names[slot]);
+    for (const quint64 trigram : oldTrigrams)
+    {
+        const auto iter = m_nameTrigramSlots.find(trigram);
+        if (iter == m_nameTrigramSlots.end())
+            continue;
+
+        QList<int> &slotList = iter.value();
+        if (const auto slotIter = std::ranges::lower_bound(slotList, slot); (slotIter != slotList.end()) && (*slotIter == slot))
+            slotList.erase(slotIter);
+        if (slotList.isEmpty())
+            m_nameTrigramSlots.erase(iter);
+    }
+
+    const QList<quint64> newTrigrams = trigrams(foldedName);
+    for (const quint64 trigram : newTrigrams)
+    {
+        QList<int> &slotList = m_nameTrigramSlots[trigram];
+        if (const auto slotIter = std::ranges::lower_bound(slotList, slot); (slotIter == slotList.end()) || (*slotIter != slot))
+            slotList.insert(slotIter, slot);
+    }
+
+    m_names[slot] = foldedName;
+    return true;
+}
+
+bool TorrentFilterIndex::setMember(Group &group, const int slot, const bool isMember)
+{
+    if (slot >= group.members.size())
+    {
+        if (!isMember)
+            return false;
+
+        // Grow in advance to avoid resizing the bitset for each new torrent
+        group.members.resize(std::max<qsizetype>((slot + 1), (group.members.size() * 2)));
+    }
+
+    if (group.members.testBit(slot) == isMember)
+        return false;
+
+    group.members.setBit(slot, isMember);
+    group.count += (isMember ? 1 : -1);
+    return true;
+}
+
+template <typename Key>
+bool TorrentFilterIndex::setMember(QHash<Key, Group> &groups, const Key &key, const int slot, const bool isMember)
+{
+    if (isMember)
+        return setMember(groups[key], slot, true);
+
+    const auto iter = groups.find(key);
+    if (iter == groups.end())
+        return false;
+
+    const bool isChanged = setMember(iter.value(), slot, false);
+    if (iter->count == 0)
+        groups.erase(iter);
+    return isChanged;
+}
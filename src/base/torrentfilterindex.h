@@ -0,0 +1,114 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+#include <optional>
+
+#include <QBitArray>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QString>
+
+#include "base/tag.h"
+#include "base/torrentfilter.h"
+
+namespace BitTorrent
+{
+    class Torrent;
+}
+
+// Keeps track of the torrents belonging to each status, category and tag.
+// Each torrent gets a bit position, so the torrents matching a filter are found
+// by intersecting bitsets and the number of torrents in each group is known at once.
+// Torrent names are indexed by their trigrams so the name search checks only a few candidates.
+class TorrentFilterIndex final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TorrentFilterIndex)
+
+public:
+    static void initInstance();
+    static void freeInstance();
+    static TorrentFilterIndex *instance();
+
+    // Changed whenever any torrent joins or leaves any group
+    quint64 revision() const;
+    // Bit position of the torrent, or -1 if the torrent is unknown
+    int torrentSlot(const BitTorrent::Torrent *torrent) const;
+
+    int statusTorrentsCount(TorrentFilter::Type status) const;
+    // Number of torrents having exactly the given category, pass empty string for uncategorized torrents
+    int categoryTorrentsCount(const QString &category) const;
+    // Pass empty tag for untagged torrents
+    int tagTorrentsCount(const Tag &tag) const;
+
+    QBitArray matchingTorrents(TorrentFilter::Type status, const std::optional<QString> &category
+            , const std::optional<Tag> &tag) const;
+    // Torrents whose name contains the given text (case insensitive)
+    QBitArray matchingNameTorrents(const QString &text) const;
+
+private:
+    struct Group
+    {
+        QBitArray members;
+        int count = 0;
+    };
+
+    explicit TorrentFilterIndex(QObject *parent = nullptr);
+
+    void handleTorrentsLoaded(const QList<BitTorrent::Torrent *> &torrents);
+    void handleTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent);
+    void handleTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents);
+    void handleTorrentCategoryChanged(BitTorrent::Torrent *torrent, const QString &oldCategory);
+    void handleTorrentTagAdded(BitTorrent::Torrent *torrent, const Tag &tag);
+    void handleTorrentTagRemoved(BitTorrent::Torrent *torrent, const Tag &tag);
+
+    bool updateStatuses(const BitTorrent::Torrent *torrent, int slot);
+    // Pass empty name to remove the torrent from the name index
+    bool updateName(int slot, const QString &name);
+    static bool setMember(Group &group, int slot, bool isMember);
+    // Groups without members are discarded
+    template <typename Key>
+    static bool setMember(QHash<Key, Group> &groups, const Key &key, int slot, bool isMember);
+
+    static TorrentFilterIndex *m_instance;
+
+    QHash<const BitTorrent::Torrent *, int> m_torrentSlots;
+    QList<int> m_freeSlots;
+    std::array<Group, TorrentFilter::_Count> m_statusGroups;
+    QHash<QString, Group> m_categoryGroups;
+    QHash<Tag, Group> m_tagGroups;
+    // Case folded names by slot
+    QList<QString> m_names;
+    // Sorted slots of the torrents by the trigrams of their names
+    QHash<quint64, QList<int>> m_nameTrigramSlots;
+    quint64 m_revision = 0;
+};
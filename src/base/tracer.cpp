@@ -0,0 +1,169 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "tracer.h"
+
+#include <atomic>
+
+#include <QByteArray>
+#include <QCoreApplication>
+#include <QThread>
+
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/utils/io.h"
+
+namespace
+{
+    // keeps the memory used by the trace bounded (about 32 MiB)
+    const qsizetype MAX_SPANS_COUNT = 1'000'000;
+
+    int currentThreadID()
+    {
+        static std::atomic_int lastThreadID = 0;
+        thread_local const int threadID = ++lastThreadID;
+        return threadID;
+    }
+
+    QString currentThreadName(const int threadID)
+    {
+        const QThread *thread = QThread::currentThread();
+        if (const QString threadName = thread->objectName(); !threadName.isEmpty())
+            return threadName;
+
+        if (const QCoreApplication *app = QCoreApplication::instance(); app && (thread == app->thread()))
+            return u"Main thread"_s;
+
+        return u"Thread %1"_s.arg(threadID);
+    }
+
+    QByteArray toJSONString(const QString &str)
+    {
+        QByteArray result = str.toUtf8();
+        result.replace('\\', "\\\\").replace('"', "\\\"");
+        return '"' + result + '"';
+    }
+}
+
+Tracer *Tracer::m_instance = nullptr;
+
+Tracer *Tracer::instance()
+{
+    return m_instance;
+}
+
+void Tracer::initInstance(const Path &filePath)
+{
+    if (!m_instance)
+        m_instance = new Tracer(filePath);
+}
+
+void Tracer::freeInstance()
+{
+    delete m_instance;
+    m_instance = nullptr;
+}
+
+Tracer::Tracer(const Path &filePath)
+    : m_filePath {filePath}
+{
+    m_spans.reserve(4096);
+    m_elapsedTimer.start();
+}
+
+Tracer::~Tracer()
+{
+    save();
+}
+
+qint64 Tracer::timestamp() const
+{
+    return m_elapsedTimer.nsecsElapsed() / 1000;
+}
+
+void Tracer::addSpan(const char *name, const qint64 startTime, const qint64 endTime)
+{
+    const int threadID = currentThreadID();
+
+    const QMutexLocker locker {&m_mutex};
+
+    if (m_spans.size() >= MAX_SPANS_COUNT) [[unlikely]]
+    {
+        ++m_droppedSpansCount;
+        return;
+    }
+
+    m_spans.append({.name = name, .startTime = startTime, .duration = (endTime - startTime), .threadID = threadID});
+    if (!m_threadNames.contains(threadID)) [[unlikely]]
+        m_threadNames.insert(threadID, currentThreadName(threadID));
+}
+
+void Tracer::save() const
+{
+    const QMutexLocker locker {&m_mutex};
+
+    const QByteArray pid = QByteArray::number(QCoreApplication::applicationPid());
+
+    QByteArray data;
+    data.reserve((m_spans.size() + 1) * 96);
+    data += R"({"displayTimeUnit":"ms","otherData":{"droppedSpans":)" + QByteArray::number(m_droppedSpansCount) + R"(},"traceEvents":[)";
+
+    bool isFirstEvent = true;
+    const auto appendEvent = [&data, &isFirstEvent](const QByteArray &event)
+    {
+        if (!isFirstEvent)
+            data += ",\n";
+        data += event;
+        isFirstEvent = false;
+    };
+
+    for (auto it = m_threadNames.cbegin(); it != m_threadNames.cend(); ++it)
+    {
+        appendEvent(R"({"name":"thread_name","ph":"M","pid":)" + pid + R"(,"tid":)" + QByteArray::number(it.key())
+                + R"(,"args":{"name":)" + toJSONString(it.value()) + "}}");
+    }
+
+    for (const Span &span : m_spans)
+    {
+        appendEvent(R"({"name":")" + QByteArray(span.name) + R"(","cat":"qbt","ph":"X","ts":)" + QByteArray::number(span.startTime)
+                + R"(,"dur":)" + QByteArray::number(span.duration) + R"(,"pid":)" + pid + R"(,"tid":)" + QByteArray::number(span.threadID) + "}");
+    }
+
+    data += "]}\n";
+
+    if (const auto result = Utils::IO::saveToFile(m_filePath, data); !result)
+    {
+        LogMsg(QCoreApplication::translate("Tracer", "Failed to save the trace. File: \"%1\". Error: \"%2\"")
+                .arg(m_filePath.toString(), result.error()), Log::WARNING);
+    }
+    else
+    {
+        LogMsg(QCoreApplication::translate("Tracer", "Saved the trace. File: \"%1\". Spans: %2. Dropped spans: %3")
+                .arg(m_filePath.toString(), QString::number(m_spans.size()), QString::number(m_droppedSpansCount)));
+    }
+}
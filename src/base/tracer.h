@@ -0,0 +1,105 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QString>
+
+#include "base/path.h"
+
+// Records the time spans of the operations which are interesting for profiling
+// and writes them in Chrome Trace Event format when the tracer is destroyed.
+// The file can be opened in chrome://tracing or in Perfetto UI.
+class Tracer final
+{
+    Q_DISABLE_COPY_MOVE(Tracer)
+
+public:
+    static void initInstance(const Path &filePath);
+    static void freeInstance();
+    static Tracer *instance();
+
+    // microseconds elapsed since the tracer was created
+    qint64 timestamp() const;
+    // `name` must be a string literal since it is only stored as a pointer
+    void addSpan(const char *name, qint64 startTime, qint64 endTime);
+
+private:
+    struct Span
+    {
+        const char *name = nullptr;
+        qint64 startTime = 0;
+        qint64 duration = 0;
+        int threadID = 0;
+    };
+
+    explicit Tracer(const Path &filePath);
+    ~Tracer();
+
+    void save() const;
+
+    static Tracer *m_instance;
+
+    Path m_filePath;
+    QElapsedTimer m_elapsedTimer;
+    mutable QMutex m_mutex;
+    QList<Span> m_spans;
+    QHash<int, QString> m_threadNames;
+    qint64 m_droppedSpansCount = 0;
+};
+
+// Adds the span of the enclosing scope to the trace if tracing is enabled
+class TraceSpan final
+{
+    Q_DISABLE_COPY_MOVE(TraceSpan)
+
+public:
+    explicit TraceSpan(const char *name)
+        : m_name {name}
+    {
+        if (const Tracer *tracer = Tracer::instance()) [[unlikely]]
+            m_startTime = tracer->timestamp();
+    }
+
+    ~TraceSpan()
+    {
+        if (m_startTime < 0) [[likely]]
+            return;
+
+        if (Tracer *tracer = Tracer::instance())
+            tracer->addSpan(m_name, m_startTime, tracer->timestamp());
+    }
+
+private:
+    const char *m_name = nullptr;
+    qint64 m_startTime = -1;
+};
@@ -92,3 +92,70 @@ int Utils::Compare::naturalCompare(const QString &left, const QString &right, co
         }
     }
 }
+
+#if (QBT_USE_QCOLLATOR == 0)
+QByteArray Utils::Compare::naturalSortKey(const QString &str, const Qt::CaseSensitivity caseSensitivity)
+{
+    // The key is a sequence of big-endian UTF-16 code units so it can be compared bytewise.
+    // Characters are case folded and, in case sensitive mode, followed by a byte that puts
+    // lower case letters before upper case ones, like `naturalCompare()` does in English locale.
+    // Each run of digits is prefixed by its length so that numbers are ordered by their length first.
+    // Other characters are ordered by their code points.
+
+    QByteArray key;
+    key.reserve(str.size() * ((caseSensitivity == Qt::CaseSensitive) ? 3 : 2));
+
+    const auto appendCodeUnit = [&key](const char16_t codeUnit)
+    {
+        key.append(static_cast<char>(codeUnit >> 8));
+        key.append(static_cast<char>(codeUnit & 0xFF));
+    };
+
+    const auto isDigit = [](const QChar ch)
+    {
+        // fast path for ASCII characters
+        const char16_t codeUnit = ch.unicode();
+        if (codeUnit < 0x80)
+            return ((codeUnit >= u'0') && (codeUnit <= u'9'));
+        return ch.isDigit();
+    };
+
+    const auto appendChar = [caseSensitivity, &key, &appendCodeUnit](const QChar ch)
+    {
+        // fast path for ASCII characters
+        const char16_t codeUnit = ch.unicode();
+        const bool isUpper = (codeUnit < 0x80) ? ((codeUnit >= u'A') && (codeUnit <= u'Z')) : ch.isUpper();
+        if (codeUnit < 0x80)
+            appendCodeUnit(isUpper ? static_cast<char16_t>(codeUnit | 0x20) : codeUnit);
+        else
+            appendCodeUnit(ch.toCaseFolded().unicode());
+
+        if (caseSensitivity == Qt::CaseSensitive)
+            key.append(static_cast<char>(isUpper ? 1 : 0));
+    };
+
+    qsizetype pos = 0;
+    while (pos < str.size())
+    {
+        if (!isDigit(str[pos]))
+        {
+            appendChar(str[pos]);
+            ++pos;
+            continue;
+        }
+
+        const qsizetype start = pos;
+        while ((pos < str.size()) && isDigit(str[pos]))
+            ++pos;
+
+        const auto length = static_cast<quint32>(pos - start);
+        appendCodeUnit(u'0');
+        appendCodeUnit(static_cast<char16_t>(length >> 16));
+        appendCodeUnit(static_cast<char16_t>(length & 0xFFFF));
+        for (qsizetype i = start; i < pos; ++i)
+            appendCodeUnit(str[i].unicode());
+    }
+
+    return key;
+}
+#endif
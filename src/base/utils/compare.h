@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <utility>
+
 #include <Qt>
 #include <QtSystemDetection>
 
@@ -44,6 +46,7 @@
 #include <QCollator>
 #else
 #define QBT_USE_QCOLLATOR 0
+#include <QByteArray>
 #endif
 #endif
 
@@ -52,6 +55,45 @@ class QString;
 namespace Utils::Compare
 {
     int naturalCompare(const QString &left, const QString &right, Qt::CaseSensitivity caseSensitivity);
+#if (QBT_USE_QCOLLATOR == 0)
+    QByteArray naturalSortKey(const QString &str, Qt::CaseSensitivity caseSensitivity);
+#endif
+
+    template <Qt::CaseSensitivity caseSensitivity>
+    class NaturalCompare;
+
+    // Precomputed form of a string for natural-order comparisons.
+    // Comparing two keys is a plain binary comparison, so it pays off
+    // when the same strings are compared many times, e.g. while sorting.
+    // Only keys obtained from comparators of the same type are comparable.
+    class NaturalSortKey
+    {
+    public:
+        int compare(const NaturalSortKey &other) const
+        {
+            return m_key.compare(other.m_key);
+        }
+
+    private:
+        template <Qt::CaseSensitivity>
+        friend class NaturalCompare;
+
+#if (QBT_USE_QCOLLATOR == 0)
+        explicit NaturalSortKey(QByteArray key)
+            : m_key {std::move(key)}
+        {
+        }
+
+        QByteArray m_key;
+#else
+        explicit NaturalSortKey(QCollatorSortKey key)
+            : m_key {std::move(key)}
+        {
+        }
+
+        QCollatorSortKey m_key;
+#endif
+    };
 
     template <Qt::CaseSensitivity caseSensitivity>
     class NaturalCompare
@@ -62,6 +104,11 @@ namespace Utils::Compare
         {
             return naturalCompare(left, right, caseSensitivity);
         }
+
+        NaturalSortKey sortKey(const QString &str) const
+        {
+            return NaturalSortKey(naturalSortKey(str, caseSensitivity));
+        }
 #else
         NaturalCompare()
         {
@@ -74,6 +121,11 @@ namespace Utils::Compare
             return m_collator.compare(left, right);
         }
 
+        NaturalSortKey sortKey(const QString &str) const
+        {
+            return NaturalSortKey(m_collator.sortKey(str));
+        }
+
     private:
         QCollator m_collator;
 #endif
@@ -211,6 +211,21 @@ qint64 Utils::Fs::freeDiskSpaceOnPath(const Path &path)
     return QStorageInfo(path.data()).bytesAvailable();
 }
 
+// Identifies the storage device holding the given path (or the location it will be created at)
+QString Utils::Fs::storageDevice(const Path &path)
+{
+    Path existingPath = path;
+    while (!existingPath.isEmpty() && !existingPath.exists())
+        existingPath = existingPath.parentPath();
+
+    const QStorageInfo storageInfo {(existingPath.isEmpty() ? path : existingPath).data()};
+    if (!storageInfo.isValid())
+        return path.rootItem().data();
+
+    const QString device = QString::fromLocal8Bit(storageInfo.device());
+    return device.isEmpty() ? storageInfo.rootPath() : device;
+}
+
 Path Utils::Fs::tempPath()
 {
     static const Path path = Path(QDir::tempPath()) / Path(u".qBittorrent"_s);
@@ -357,6 +372,19 @@ bool Utils::Fs::renameFile(const Path &from, const Path &to)
     return QFile::rename(from.data(), to.data());
 }
 
+/**
+ * Renames the file replacing the existing one.
+ *
+ * Unlike removing the existing file before renaming, it leaves no moment without a file at `to`
+ * since the replacement is atomic on the file systems that support it.
+ */
+bool Utils::Fs::replaceFile(const Path &from, const Path &to)
+{
+    std::error_code ec;
+    std::filesystem::rename(from.toStdFsPath(), to.toStdFsPath(), ec);
+    return !ec;
+}
+
 /**
  * Removes the file with the given filePath.
  *
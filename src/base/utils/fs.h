@@ -45,6 +45,7 @@ namespace Utils::Fs
 {
     qint64 computePathSize(const Path &path);
     qint64 freeDiskSpaceOnPath(const Path &path);
+    QString storageDevice(const Path &path);
 
     bool isValidName(const QString &name);
     bool isRegularFile(const Path &path);
@@ -62,6 +63,7 @@ namespace Utils::Fs
 
     bool copyFile(const Path &from, const Path &to);
     bool renameFile(const Path &from, const Path &to);
+    bool replaceFile(const Path &from, const Path &to);
     nonstd::expected<void, QString> removeFile(const Path &path);
     nonstd::expected<void, QString> moveFileToTrash(const Path &path);
     bool mkdir(const Path &dirPath);
@@ -29,10 +29,54 @@
 
 #pragma once
 
+#include <memory>
+
+#include <QtClassHelperMacros>
+
 class QByteArray;
+class QByteArrayView;
 
 namespace Utils::Gzip
 {
     QByteArray compress(const QByteArray &data, int level = 6, bool *ok = nullptr);
     QByteArray decompress(const QByteArray &data, bool *ok = nullptr);
+
+    // Compresses the data passed in parts into a single gzip stream
+    class StreamCompressor
+    {
+        Q_DISABLE_COPY_MOVE(StreamCompressor)
+
+    public:
+        explicit StreamCompressor(int level = 6);
+        ~StreamCompressor();
+
+        bool isValid() const;
+        // Returns the compressed data available so far,
+        // the stream is completed when `finish` is set
+        QByteArray compress(QByteArrayView data, bool finish = false);
+
+    private:
+        struct Stream;
+        std::unique_ptr<Stream> m_stream;
+    };
+
+    // Decompresses the gzip (or zlib) stream passed in parts
+    class StreamDecompressor
+    {
+        Q_DISABLE_COPY_MOVE(StreamDecompressor)
+
+    public:
+        StreamDecompressor();
+        ~StreamDecompressor();
+
+        bool isValid() const;
+        // Returns `true` when the end of the stream is reached, the data following it is ignored
+        bool isFinished() const;
+        // Returns the data decompressed from the passed part of the stream
+        QByteArray decompress(QByteArrayView data);
+
+    private:
+        struct Stream;
+        std::unique_ptr<Stream> m_stream;
+    };
 }
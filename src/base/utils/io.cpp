@@ -31,6 +31,13 @@
 #include <limits>
 #include <utility>
 
+#if defined(Q_OS_WIN)
+#include <io.h>
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
 #include <libtorrent/bencode.hpp>
 #include <libtorrent/entry.hpp>
 
@@ -174,3 +181,20 @@ nonstd::expected<Path, QString> Utils::IO::saveToTempFile(const lt::entry &data)
     file.setAutoRemove(false);
     return Path(file.fileName());
 }
+
+nonstd::expected<void, QString> Utils::IO::syncFile(QFileDevice &file)
+{
+    if (!file.flush())
+        return nonstd::make_unexpected(file.errorString());
+
+#if defined(Q_OS_WIN)
+    const auto handle = reinterpret_cast<HANDLE>(::_get_osfhandle(file.handle()));
+    if (!::FlushFileBuffers(handle))
+        return nonstd::make_unexpected(qt_error_string());
+#else
+    if (::fsync(file.handle()) != 0)
+        return nonstd::make_unexpected(qt_error_string());
+#endif
+
+    return {};
+}
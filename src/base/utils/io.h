@@ -105,4 +105,7 @@ namespace Utils::IO
     nonstd::expected<void, QString> saveToFile(const Path &path, const lt::entry &data);
     nonstd::expected<Path, QString> saveToTempFile(const QByteArray &data);
     nonstd::expected<Path, QString> saveToTempFile(const lt::entry &data);
+
+    // Flushes buffered data and makes sure it is physically written to the storage device
+    nonstd::expected<void, QString> syncFile(QFileDevice &file);
 }
@@ -0,0 +1,334 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "jsonwriter.h"
+
+#include <cmath>
+#include <utility>
+
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QLocale>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include "base/global.h"
+
+Utils::JsonWriter::JsonWriter(const qsizetype reserveSize)
+{
+    if (reserveSize > 0)
+        m_data.reserve(reserveSize);
+}
+
+Utils::JsonWriter &Utils::JsonWriter::beginObject()
+{
+    beginValue();
+    m_data.append('{');
+    m_hasElements.push_back(false);
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::endObject()
+{
+    Q_ASSERT(!m_hasElements.empty());
+    Q_ASSERT(!m_isAfterKey);
+
+    m_hasElements.pop_back();
+    m_data.append('}');
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::beginArray()
+{
+    beginValue();
+    m_data.append('[');
+    m_hasElements.push_back(false);
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::endArray()
+{
+    Q_ASSERT(!m_hasElements.empty());
+
+    m_hasElements.pop_back();
+    m_data.append(']');
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::key(const QString &key)
+{
+    Q_ASSERT(!m_hasElements.empty());
+    Q_ASSERT(!m_isAfterKey);
+
+    if (m_hasElements.back())
+        m_data.append(',');
+    m_hasElements.back() = true;
+
+    writeString(key);
+    m_data.append(':');
+    m_isAfterKey = true;
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::value(const QString &value)
+{
+    beginValue();
+    writeString(value);
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::value(const bool value)
+{
+    beginValue();
+    m_data.append(value ? "true" : "false");
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::value(const double value)
+{
+    if (!std::isfinite(value))
+        return nullValue();
+
+    beginValue();
+    m_data.append(QByteArray::number(value, 'g', QLocale::FloatingPointShortest));
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::value(const QStringList &value)
+{
+    beginArray();
+    for (const QString &str : value)
+        this->value(str);
+    return endArray();
+}
+
+Utils::JsonWriter &Utils::JsonWriter::value(const QJsonValue &value)
+{
+    switch (value.type())
+    {
+    case QJsonValue::Bool:
+        return this->value(value.toBool());
+    case QJsonValue::Double:
+        {
+            // integers are kept as is, while QJsonValue::toDouble() may lose their precision
+            const qint64 integer = value.toInteger();
+            if ((integer != 0) || (value.toDouble() == 0))
+                return integerValue(integer);
+            return this->value(value.toDouble());
+        }
+    case QJsonValue::String:
+        return this->value(value.toString());
+    case QJsonValue::Array:
+        return this->value(value.toArray());
+    case QJsonValue::Object:
+        return this->value(value.toObject());
+    default:
+        return nullValue();
+    }
+}
+
+Utils::JsonWriter &Utils::JsonWriter::value(const QJsonArray &value)
+{
+    beginArray();
+    for (const QJsonValue &item : value)
+        this->value(item);
+    return endArray();
+}
+
+Utils::JsonWriter &Utils::JsonWriter::value(const QJsonObject &value)
+{
+    beginObject();
+    for (auto iter = value.constBegin(); iter != value.constEnd(); ++iter)
+        key(iter.key()).value(iter.value());
+    return endObject();
+}
+
+Utils::JsonWriter &Utils::JsonWriter::value(const QVariant &value)
+{
+    switch (value.userType())
+    {
+    case QMetaType::UnknownType:
+    case QMetaType::Nullptr:
+        return nullValue();
+    case QMetaType::Bool:
+        return this->value(value.toBool());
+    case QMetaType::Short:
+    case QMetaType::UShort:
+    case QMetaType::Int:
+    case QMetaType::UInt:
+    case QMetaType::Long:
+    case QMetaType::LongLong:
+        return integerValue(value.toLongLong());
+    case QMetaType::Float:
+    case QMetaType::Double:
+        return this->value(value.toDouble());
+    case QMetaType::QString:
+        return this->value(value.toString());
+    case QMetaType::QStringList:
+        return this->value(value.toStringList());
+    case QMetaType::QVariantList:
+        {
+            beginArray();
+            for (const QVariant &item : asConst(value.toList()))
+                this->value(item);
+            return endArray();
+        }
+    case QMetaType::QVariantMap:
+        {
+            beginObject();
+            const QVariantMap map = value.toMap();
+            for (auto iter = map.constBegin(); iter != map.constEnd(); ++iter)
+                key(iter.key()).value(iter.value());
+            return endObject();
+        }
+    case QMetaType::QVariantHash:
+        {
+            // keep the keys sorted like QJsonObject does
+            const QVariantHash hash = value.toHash();
+            QStringList keys = hash.keys();
+            keys.sort();
+
+            beginObject();
+            for (const QString &itemKey : asConst(keys))
+                key(itemKey).value(hash[itemKey]);
+            return endObject();
+        }
+    default:
+        // the rest of the types are converted the same way as QJsonDocument does
+        return this->value(QJsonValue::fromVariant(value));
+    }
+}
+
+Utils::JsonWriter &Utils::JsonWriter::nullValue()
+{
+    beginValue();
+    m_data.append("null");
+    return *this;
+}
+
+Utils::JsonWriter &Utils::JsonWriter::rawValue(const QByteArrayView json)
+{
+    beginValue();
+    m_data.append(json);
+    return *this;
+}
+
+const QByteArray &Utils::JsonWriter::data() const
+{
+    return m_data;
+}
+
+QByteArray Utils::JsonWriter::takeData()
+{
+    m_hasElements.clear();
+    m_isAfterKey = false;
+    return std::exchange(m_data, {});
+}
+
+Utils::JsonWriter &Utils::JsonWriter::integerValue(const qint64 value)
+{
+    beginValue();
+    m_data.append(QByteArray::number(value));
+    return *this;
+}
+
+void Utils::JsonWriter::beginValue()
+{
+    if (m_isAfterKey)
+    {
+        m_isAfterKey = false;
+        return;
+    }
+
+    if (!m_hasElements.empty())
+    {
+        if (m_hasElements.back())
+            m_data.append(',');
+        m_hasElements.back() = true;
+    }
+}
+
+void Utils::JsonWriter::writeString(const QString &str)
+{
+    const QByteArray utf8 = str.toUtf8();
+
+    m_data.reserve(m_data.size() + utf8.size() + 2);
+    m_data.append('"');
+
+    // the bytes of multibyte UTF-8 sequences are never escaped, so the string is processed byte by byte
+    qsizetype unescapedBegin = 0;
+    for (qsizetype i = 0; i < utf8.size(); ++i)
+    {
+        const auto ch = static_cast<uchar>(utf8[i]);
+        if ((ch >= 0x20) && (ch != '"') && (ch != '\\'))
+            continue;
+
+        m_data.append(QByteArrayView(utf8).sliced(unescapedBegin, (i - unescapedBegin)));
+        unescapedBegin = i + 1;
+
+        switch (ch)
+        {
+        case '"':
+            m_data.append("\\\"");
+            break;
+        case '\\':
+            m_data.append("\\\\");
+            break;
+        case '\b':
+            m_data.append("\\b");
+            break;
+        case '\f':
+            m_data.append("\\f");
+            break;
+        case '\n':
+            m_data.append("\\n");
+            break;
+        case '\r':
+            m_data.append("\\r");
+            break;
+        case '\t':
+            m_data.append("\\t");
+            break;
+        default:
+            {
+                const char hexDigits[] = "0123456789abcdef";
+                m_data.append("\\u00");
+                m_data.append(hexDigits[ch >> 4]);
+                m_data.append(hexDigits[ch & 0xF]);
+            }
+            break;
+        }
+    }
+
+    m_data.append(QByteArrayView(utf8).sliced(unescapedBegin));
+    m_data.append('"');
+}
@@ -0,0 +1,91 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <concepts>
+#include <vector>
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QtContainerFwd>
+#include <QtTypes>
+
+class QJsonArray;
+class QJsonObject;
+class QJsonValue;
+class QString;
+class QVariant;
+
+namespace Utils
+{
+    // Writes compact JSON (the same as QJsonDocument::toJson(QJsonDocument::Compact)) straight into
+    // a buffer, so large responses don't need to be built as QJsonObject/QJsonArray first.
+    // The caller is responsible for the correct nesting, e.g. each value in an object must follow a key.
+    class JsonWriter
+    {
+    public:
+        explicit JsonWriter(qsizetype reserveSize = 0);
+
+        JsonWriter &beginObject();
+        JsonWriter &endObject();
+        JsonWriter &beginArray();
+        JsonWriter &endArray();
+        JsonWriter &key(const QString &key);
+
+        JsonWriter &value(const QString &value);
+        JsonWriter &value(bool value);
+        JsonWriter &value(double value);
+        template <std::integral T>
+        JsonWriter &value(const T value) requires (!std::same_as<T, bool>)
+        {
+            return integerValue(static_cast<qint64>(value));
+        }
+        JsonWriter &value(const QStringList &value);
+        JsonWriter &value(const QJsonValue &value);
+        JsonWriter &value(const QJsonArray &value);
+        JsonWriter &value(const QJsonObject &value);
+        JsonWriter &value(const QVariant &value);
+        JsonWriter &nullValue();
+        // Writes already serialized JSON value as is
+        JsonWriter &rawValue(QByteArrayView json);
+
+        const QByteArray &data() const;
+        QByteArray takeData();
+
+    private:
+        JsonWriter &integerValue(qint64 value);
+        void beginValue();
+        void writeString(const QString &str);
+
+        QByteArray m_data;
+        // whether each of the open objects/arrays already has any element
+        std::vector<bool> m_hasElements;
+        bool m_isAfterKey = false;
+    };
+}
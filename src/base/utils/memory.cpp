@@ -0,0 +1,149 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "memory.h"
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantHash>
+#include <QVariantList>
+#include <QVariantMap>
+
+namespace
+{
+    // Approximate overhead of a single heap allocation of container data (header and allocator bookkeeping)
+    const qint64 ALLOCATION_OVERHEAD = 32;
+    // Approximate overhead of a single node of node based containers (e.g. QMap) or per entry in QHash
+    const qint64 NODE_OVERHEAD = 32;
+
+    template <typename Map>
+    qint64 estimateMapHeapSize(const Map &map)
+    {
+        if (map.isEmpty())
+            return 0;
+
+        qint64 size = ALLOCATION_OVERHEAD;
+        for (auto it = map.cbegin(); it != map.cend(); ++it)
+        {
+            size += NODE_OVERHEAD + sizeof(typename Map::key_type) + sizeof(typename Map::mapped_type)
+                + Utils::Memory::estimateHeapSize(it.key()) + Utils::Memory::estimateHeapSize(it.value());
+        }
+        return size;
+    }
+
+    template <typename List>
+    qint64 estimateListHeapSize(const List &list)
+    {
+        if (list.capacity() == 0)
+            return 0;
+
+        return ALLOCATION_OVERHEAD + (list.capacity() * static_cast<qint64>(sizeof(typename List::value_type)))
+            + Utils::Memory::estimateElementsHeapSize(list);
+    }
+}
+
+qint64 Utils::Memory::estimateHeapSize(const QString &str)
+{
+    // Static data (e.g. string literals) has zero capacity
+    if (str.capacity() == 0)
+        return 0;
+
+    return ALLOCATION_OVERHEAD + ((str.capacity() + 1) * static_cast<qint64>(sizeof(QChar)));
+}
+
+qint64 Utils::Memory::estimateHeapSize(const QByteArray &data)
+{
+    if (data.capacity() == 0)
+        return 0;
+
+    return ALLOCATION_OVERHEAD + data.capacity() + 1;
+}
+
+qint64 Utils::Memory::estimateHeapSize(const QVariant &value)
+{
+    // Values of the types below are stored inside QVariant itself
+    switch (value.typeId())
+    {
+    case QMetaType::QString:
+        return estimateHeapSize(value.toString());
+    case QMetaType::QByteArray:
+        return estimateHeapSize(value.toByteArray());
+    case QMetaType::QStringList:
+        return estimateListHeapSize(value.toStringList());
+    case QMetaType::QVariantList:
+        return estimateListHeapSize(value.toList());
+    case QMetaType::QVariantMap:
+        return estimateHeapSize(value.toMap());
+    case QMetaType::QVariantHash:
+        return estimateHeapSize(value.toHash());
+    default:
+        return 0;
+    }
+}
+
+qint64 Utils::Memory::estimateHeapSize(const QVariantMap &map)
+{
+    return estimateMapHeapSize(map);
+}
+
+qint64 Utils::Memory::estimateHeapSize(const QVariantHash &hash)
+{
+    return estimateMapHeapSize(hash);
+}
+
+qint64 Utils::Memory::estimateHeapSize(const QJsonValue &value)
+{
+    switch (value.type())
+    {
+    case QJsonValue::String:
+        return estimateHeapSize(value.toString());
+    case QJsonValue::Array:
+        {
+            const QJsonArray array = value.toArray();
+            qint64 size = array.isEmpty() ? 0 : ALLOCATION_OVERHEAD;
+            for (const QJsonValue &element : array)
+                size += sizeof(QJsonValue) + estimateHeapSize(element);
+            return size;
+        }
+    case QJsonValue::Object:
+        {
+            const QJsonObject object = value.toObject();
+            qint64 size = object.isEmpty() ? 0 : ALLOCATION_OVERHEAD;
+            for (auto it = object.constBegin(); it != object.constEnd(); ++it)
+                size += (2 * sizeof(QJsonValue)) + estimateHeapSize(it.key()) + estimateHeapSize(QJsonValue(it.value()));
+            return size;
+        }
+    default:
+        return 0;
+    }
+}
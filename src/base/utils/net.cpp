@@ -28,6 +28,8 @@
 
 #include "net.h"
 
+#include <algorithm>
+
 #include <QList>
 #include <QNetworkInterface>
 #include <QSslCertificate>
@@ -128,5 +130,70 @@ namespace Utils
         {
             return !loadSSLCertificate(data).isEmpty();
         }
+
+        SubnetMatcher::SubnetMatcher(const QList<Subnet> &subnets)
+        {
+            for (const Subnet &subnet : subnets)
+                insert(subnet);
+        }
+
+        bool SubnetMatcher::isEmpty() const
+        {
+            return m_nodes.empty();
+        }
+
+        bool SubnetMatcher::contains(const QHostAddress &addr) const
+        {
+            if (m_nodes.empty() || ((addr.protocol() != QAbstractSocket::IPv4Protocol) && (addr.protocol() != QAbstractSocket::IPv6Protocol)))
+                return false;
+
+            const Q_IPV6ADDR bytes = addr.toIPv6Address();
+            int nodeIndex = 0;
+            for (int bit = 0; bit < 128; ++bit)
+            {
+                const Node &node = m_nodes[nodeIndex];
+                if (node.isSubnet)
+                    return true;
+
+                nodeIndex = node.children[(bytes[bit / 8] >> (7 - (bit % 8))) & 1];
+                if (nodeIndex < 0)
+                    return false;
+            }
+
+            return m_nodes[nodeIndex].isSubnet;
+        }
+
+        void SubnetMatcher::insert(const Subnet &subnet)
+        {
+            const QHostAddress &addr = subnet.first;
+            int prefixLength = subnet.second;
+            if (addr.protocol() == QAbstractSocket::IPv4Protocol)
+                prefixLength += 96;
+            else if (addr.protocol() != QAbstractSocket::IPv6Protocol)
+                return;
+            prefixLength = std::clamp(prefixLength, 0, 128);
+
+            if (m_nodes.empty())
+                m_nodes.emplace_back();
+
+            const Q_IPV6ADDR bytes = addr.toIPv6Address();
+            int nodeIndex = 0;
+            for (int bit = 0; bit < prefixLength; ++bit)
+            {
+                // the address is already contained in a shorter subnet
+                if (m_nodes[nodeIndex].isSubnet)
+                    return;
+
+                const int branch = (bytes[bit / 8] >> (7 - (bit % 8))) & 1;
+                if (m_nodes[nodeIndex].children[branch] < 0)
+                {
+                    m_nodes[nodeIndex].children[branch] = static_cast<int>(m_nodes.size());
+                    m_nodes.emplace_back();
+                }
+                nodeIndex = m_nodes[nodeIndex].children[branch];
+            }
+
+            m_nodes[nodeIndex].isSubnet = true;
+        }
     }
 }
@@ -0,0 +1,72 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "regex.h"
+
+#include <QCache>
+#include <QHashFunctions>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+namespace
+{
+    const int MAX_CACHED_REGEXES = 1024;
+
+    struct CacheKey
+    {
+        QString pattern;
+        QRegularExpression::PatternOptions options;
+
+        friend bool operator==(const CacheKey &left, const CacheKey &right) = default;
+    };
+
+    std::size_t qHash(const CacheKey &key, const std::size_t seed = 0)
+    {
+        return qHashMulti(seed, key.pattern, key.options.toInt());
+    }
+
+    QMutex cacheMutex;
+    QCache<CacheKey, QRegularExpression> cache {MAX_CACHED_REGEXES};
+}
+
+QRegularExpression Utils::Regex::cached(const QString &pattern, const QRegularExpression::PatternOptions options)
+{
+    const CacheKey key {pattern, options};
+
+    const QMutexLocker locker {&cacheMutex};
+
+    if (const QRegularExpression *regex = cache.object(key))
+        return *regex;
+
+    // Copies share the compiled pattern so it is compiled only once
+    QRegularExpression regex {pattern, options};
+    regex.optimize();
+    cache.insert(key, new QRegularExpression(regex));
+    return regex;
+}
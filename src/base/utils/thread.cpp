@@ -28,11 +28,196 @@
 
 #include "thread.h"
 
+#include <QtSystemDetection>
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#elif defined(Q_OS_MACOS)
+#include <pthread.h>
+#include <sys/qos.h>
+#elif defined(Q_OS_LINUX)
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+#include <QStringView>
 #include <QThread>
 
+namespace
+{
+#ifdef Q_OS_LINUX
+    const int BULK_NICE_INCREMENT = 10;
+    // IOPRIO_PRIO_VALUE(IOPRIO_CLASS_IDLE, 0), glibc provides no wrapper for it
+    const int IOPRIO_WHO_PROCESS = 1;
+    const int IOPRIO_IDLE_CLASS_VALUE = (3 << 13);
+#endif
+
+    // Upper bound of CPU indexes, it guards against the ranges like "0-100000000"
+    const int MAX_CPU_INDEX = 4095;
+
+    QMutex policyMutex;
+    Utils::Thread::SchedulingPolicy policy;
+#ifdef Q_OS_LINUX
+    // Threads inherit the affinity of the creating one, so it is captured before any thread is pinned
+    cpu_set_t processCPUSet;
+    bool isProcessCPUSetValid = false;
+#endif
+
+    void lowerPriority()
+    {
+#if defined(Q_OS_WIN)
+        ::SetThreadPriority(::GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+#elif defined(Q_OS_MACOS)
+        ::pthread_set_qos_class_self_np(QOS_CLASS_BACKGROUND, 0);
+#elif defined(Q_OS_LINUX)
+        // On Linux the nice value and IO priority are per thread
+        const auto tid = static_cast<id_t>(::syscall(SYS_gettid));
+        ::setpriority(PRIO_PROCESS, tid, (::getpriority(PRIO_PROCESS, tid) + BULK_NICE_INCREMENT));
+        ::syscall(SYS_ioprio_set, IOPRIO_WHO_PROCESS, 0, IOPRIO_IDLE_CLASS_VALUE);
+#else
+        if (QThread *thread = QThread::currentThread())
+            thread->setPriority(QThread::LowestPriority);
+#endif
+    }
+
+    void setAffinity([[maybe_unused]] const QList<int> &cpus, [[maybe_unused]] const bool exclude)
+    {
+        if (cpus.isEmpty())
+            return;
+
+#if defined(Q_OS_WIN)
+        DWORD_PTR processMask = 0;
+        DWORD_PTR systemMask = 0;
+        if (!::GetProcessAffinityMask(::GetCurrentProcess(), &processMask, &systemMask))
+            return;
+
+        DWORD_PTR mask = 0;
+        for (const int cpu : cpus)
+        {
+            if (cpu < static_cast<int>(sizeof(DWORD_PTR) * 8))
+                mask |= (static_cast<DWORD_PTR>(1) << cpu);
+        }
+        mask = (exclude ? (processMask & ~mask) : (processMask & mask));
+        if (mask != 0)
+            ::SetThreadAffinityMask(::GetCurrentThread(), mask);
+#elif defined(Q_OS_LINUX)
+        cpu_set_t processSet;
+        {
+            const QMutexLocker locker {&policyMutex};
+            if (!isProcessCPUSetValid)
+                return;
+            processSet = processCPUSet;
+        }
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (exclude)
+        {
+            set = processSet;
+            for (const int cpu : cpus)
+            {
+                if (cpu < CPU_SETSIZE)
+                    CPU_CLR(cpu, &set);
+            }
+        }
+        else
+        {
+            for (const int cpu : cpus)
+            {
+                if ((cpu < CPU_SETSIZE) && CPU_ISSET(cpu, &processSet))
+                    CPU_SET(cpu, &set);
+            }
+        }
+        if (CPU_COUNT(&set) > 0)
+            ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+#endif
+        // macOS doesn't allow binding threads to CPUs
+    }
+}
+
 void Utils::Thread::GracefulDeleter::operator()(QThread *thread) const
 {
     thread->quit();
     thread->wait();
     delete thread;
 }
+
+Utils::Thread::SchedulingPolicy Utils::Thread::schedulingPolicy()
+{
+    const QMutexLocker locker {&policyMutex};
+    return policy;
+}
+
+void Utils::Thread::setSchedulingPolicy(const SchedulingPolicy &newPolicy)
+{
+    const QMutexLocker locker {&policyMutex};
+    policy = newPolicy;
+#ifdef Q_OS_LINUX
+    if (!isProcessCPUSetValid)
+    {
+        CPU_ZERO(&processCPUSet);
+        isProcessCPUSetValid = (::sched_getaffinity(0, sizeof(processCPUSet), &processCPUSet) == 0);
+    }
+#endif
+}
+
+void Utils::Thread::applyWorkload(const Workload workload)
+{
+    const SchedulingPolicy currentPolicy = schedulingPolicy();
+
+    switch (workload)
+    {
+    case Workload::Bulk:
+        if (currentPolicy.lowerBulkPriority)
+            lowerPriority();
+        setAffinity(currentPolicy.latencySensitiveCPUs, true);
+        break;
+    case Workload::LatencySensitive:
+        setAffinity(currentPolicy.latencySensitiveCPUs, false);
+        break;
+    }
+}
+
+void Utils::Thread::setWorkload(QThread *thread, const Workload workload)
+{
+    QObject::connect(thread, &QThread::started, thread, [workload]
+    {
+        applyWorkload(workload);
+    }, Qt::DirectConnection);
+}
+
+QList<int> Utils::Thread::parseCPUList(const QString &str)
+{
+    QList<int> cpus;
+
+    const QString trimmed = str.trimmed();
+    if (trimmed.isEmpty())
+        return cpus;
+
+    for (const QStringView item : QStringView(trimmed).split(u','))
+    {
+        const QStringView range = item.trimmed();
+        const qsizetype separatorPos = range.indexOf(u'-');
+
+        bool firstOk = false;
+        bool lastOk = false;
+        const int first = range.left(separatorPos).trimmed().toInt(&firstOk);
+        const int last = (separatorPos < 0) ? first : range.mid(separatorPos + 1).trimmed().toInt(&lastOk);
+        if (!firstOk || ((separatorPos >= 0) && !lastOk) || (first < 0) || (last < first) || (last > MAX_CPU_INDEX))
+            return {};
+
+        for (int cpu = first; cpu <= last; ++cpu)
+        {
+            if (!cpus.contains(cpu))
+                cpus.append(cpu);
+        }
+    }
+
+    return cpus;
+}
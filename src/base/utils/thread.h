@@ -30,6 +30,9 @@
 
 #include <memory>
 
+#include <QList>
+
+class QString;
 class QThread;
 
 namespace Utils::Thread
@@ -40,4 +43,32 @@ namespace Utils::Thread
     };
 
     using UniquePtr = std::unique_ptr<QThread, GracefulDeleter>;
+
+    enum class Workload
+    {
+        // Throughput oriented work that shouldn't compete with the rest (e.g. checking, moving, saving)
+        Bulk,
+        // Work the responsiveness depends on (e.g. the event loop, serving the requests)
+        LatencySensitive
+    };
+
+    // Process wide, it affects the threads started afterwards
+    struct SchedulingPolicy
+    {
+        // Bulk work runs with the lower CPU priority and the idle IO class
+        bool lowerBulkPriority = false;
+        // CPUs the latency sensitive threads are pinned to, the bulk work runs on the other ones
+        QList<int> latencySensitiveCPUs;
+    };
+
+    SchedulingPolicy schedulingPolicy();
+    void setSchedulingPolicy(const SchedulingPolicy &policy);
+
+    // Applies the scheduling policy of the workload to the calling thread
+    void applyWorkload(Workload workload);
+    // Applies it to the thread once it is started (it should be called before the thread is started)
+    void setWorkload(QThread *thread, Workload workload);
+
+    // Parses the list like "0-3,6", returns empty list if it is invalid
+    QList<int> parseCPUList(const QString &str);
 }
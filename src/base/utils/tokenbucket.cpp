@@ -0,0 +1,84 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "tokenbucket.h"
+
+#include <algorithm>
+#include <cmath>
+
+Utils::TokenBucket::TokenBucket(const double rate, const double capacity, const Clock::time_point now)
+    : m_rate {std::max(rate, 0.0)}
+    , m_capacity {std::max(capacity, 0.0)}
+    , m_tokens {m_capacity}
+    , m_lastUpdate {now}
+{
+}
+
+double Utils::TokenBucket::rate() const
+{
+    return m_rate;
+}
+
+double Utils::TokenBucket::capacity() const
+{
+    return m_capacity;
+}
+
+double Utils::TokenBucket::availableTokens(const Clock::time_point now) const
+{
+    if (now <= m_lastUpdate)
+        return m_tokens;
+
+    const double elapsedSecs = std::chrono::duration<double>(now - m_lastUpdate).count();
+    return std::min(m_capacity, (m_tokens + (elapsedSecs * m_rate)));
+}
+
+bool Utils::TokenBucket::isFull(const Clock::time_point now) const
+{
+    return availableTokens(now) >= m_capacity;
+}
+
+std::chrono::milliseconds Utils::TokenBucket::waitTime(const double tokens, const double reserve, const Clock::time_point now) const
+{
+    using namespace std::chrono_literals;
+
+    const double required = tokens + std::max(reserve, 0.0);
+    const double missing = required - availableTokens(now);
+    if (missing <= 0)
+        return 0ms;
+    if ((required > m_capacity) || (m_rate <= 0))
+        return std::chrono::milliseconds::max();
+
+    return std::chrono::milliseconds(static_cast<std::chrono::milliseconds::rep>(std::ceil((missing * 1000) / m_rate)));
+}
+
+void Utils::TokenBucket::consume(const double tokens, const Clock::time_point now)
+{
+    m_tokens = availableTokens(now) - tokens;
+    m_lastUpdate = std::max(now, m_lastUpdate);
+}
@@ -0,0 +1,62 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <chrono>
+
+namespace Utils
+{
+    // Limits the rate of the operations: the bucket holds up to `capacity` tokens which are
+    // refilled at `rate` per second, each operation takes some tokens out of it.
+    // The refill is calculated lazily from the time passed since the last use.
+    class TokenBucket
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        TokenBucket(double rate, double capacity, Clock::time_point now = Clock::now());
+
+        double rate() const;
+        double capacity() const;
+        double availableTokens(Clock::time_point now = Clock::now()) const;
+        bool isFull(Clock::time_point now = Clock::now()) const;
+
+        // Returns the time after which the tokens can be taken leaving at least `reserve` tokens in the bucket,
+        // zero if they can be taken now. The tokens exceeding the capacity can never be taken.
+        std::chrono::milliseconds waitTime(double tokens, double reserve = 0, Clock::time_point now = Clock::now()) const;
+        // The bucket may go into debt if more tokens than available are taken
+        void consume(double tokens, Clock::time_point now = Clock::now());
+
+    private:
+        double m_rate = 0;
+        double m_capacity = 0;
+        double m_tokens = 0;
+        Clock::time_point m_lastUpdate;
+    };
+}
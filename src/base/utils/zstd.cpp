@@ -0,0 +1,181 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "zstd.h"
+
+#include <limits>
+
+#include <QByteArray>
+#include <QByteArrayView>
+
+#include <zstd.h>
+
+QByteArray Utils::Zstd::compress(const QByteArray &data, const int level, bool *ok)
+{
+    if (ok)
+        *ok = false;
+
+    if (data.isEmpty())
+        return {};
+
+    QByteArray ret {static_cast<qsizetype>(ZSTD_compressBound(static_cast<std::size_t>(data.size()))), Qt::Uninitialized};
+    const std::size_t result = ZSTD_compress(ret.data(), static_cast<std::size_t>(ret.size())
+        , data.constData(), static_cast<std::size_t>(data.size()), level);
+    if (ZSTD_isError(result))
+        return {};
+
+    ret.truncate(static_cast<qsizetype>(result));
+
+    if (ok)
+        *ok = true;
+    return ret;
+}
+
+QByteArray Utils::Zstd::decompress(const QByteArray &data, bool *ok)
+{
+    if (ok)
+        *ok = false;
+
+    if (data.isEmpty())
+        return {};
+
+    const unsigned long long contentSize = ZSTD_getFrameContentSize(data.constData(), static_cast<std::size_t>(data.size()));
+    if (contentSize == ZSTD_CONTENTSIZE_ERROR)
+        return {};
+
+    QByteArray ret;
+    if (contentSize != ZSTD_CONTENTSIZE_UNKNOWN)
+    {
+        // the frames made by compress() know the size of their content
+        if (contentSize > static_cast<unsigned long long>(std::numeric_limits<qsizetype>::max()))
+            return {};
+
+        ret.resize(static_cast<qsizetype>(contentSize));
+        const std::size_t result = ZSTD_decompress(ret.data(), static_cast<std::size_t>(ret.size())
+            , data.constData(), static_cast<std::size_t>(data.size()));
+        if (ZSTD_isError(result) || (result != contentSize))
+            return {};
+    }
+    else
+    {
+        // the frames made by StreamCompressor don't
+        const std::unique_ptr<ZSTD_DCtx, decltype(&ZSTD_freeDCtx)> context {ZSTD_createDCtx(), &ZSTD_freeDCtx};
+        if (!context)
+            return {};
+
+        ZSTD_inBuffer input {data.constData(), static_cast<std::size_t>(data.size()), 0};
+        while (true)
+        {
+            const qsizetype outputSize = ret.size();
+            const auto bufferSize = static_cast<qsizetype>(ZSTD_DStreamOutSize());
+            ret.resize(outputSize + bufferSize);
+            ZSTD_outBuffer output {(ret.data() + outputSize), static_cast<std::size_t>(bufferSize), 0};
+
+            const std::size_t remaining = ZSTD_decompressStream(context.get(), &output, &input);
+            ret.truncate(outputSize + static_cast<qsizetype>(output.pos));
+
+            if (ZSTD_isError(remaining))
+                return {};
+
+            // the frame is completed and flushed
+            if (remaining == 0)
+                break;
+
+            // the frame is truncated if there is no more input while the output buffer isn't full
+            if ((input.pos == input.size) && (output.pos < output.size))
+                return {};
+        }
+    }
+
+    if (ok)
+        *ok = true;
+    return ret;
+}
+
+struct Utils::Zstd::StreamCompressor::Stream
+{
+    ZSTD_CCtx *context = nullptr;
+    bool isFinished = false;
+};
+
+Utils::Zstd::StreamCompressor::StreamCompressor(const int level)
+    : m_stream {std::make_unique<Stream>()}
+{
+    m_stream->context = ZSTD_createCCtx();
+    if (m_stream->context && ZSTD_isError(ZSTD_CCtx_setParameter(m_stream->context, ZSTD_c_compressionLevel, level)))
+    {
+        ZSTD_freeCCtx(m_stream->context);
+        m_stream->context = nullptr;
+    }
+}
+
+Utils::Zstd::StreamCompressor::~StreamCompressor()
+{
+    ZSTD_freeCCtx(m_stream->context);
+}
+
+bool Utils::Zstd::StreamCompressor::isValid() const
+{
+    return (m_stream->context != nullptr);
+}
+
+QByteArray Utils::Zstd::StreamCompressor::compress(const QByteArrayView data, const bool finish)
+{
+    if (!m_stream->context || m_stream->isFinished)
+        return {};
+
+    ZSTD_inBuffer input {data.data(), static_cast<std::size_t>(data.size()), 0};
+    // the data passed so far is flushed, so the receiver can decompress it without waiting for the rest
+    const ZSTD_EndDirective directive = finish ? ZSTD_e_end : ZSTD_e_flush;
+    QByteArray ret;
+    while (true)
+    {
+        const qsizetype outputSize = ret.size();
+        const auto bufferSize = static_cast<qsizetype>(ZSTD_CStreamOutSize());
+        ret.resize(outputSize + bufferSize);
+        ZSTD_outBuffer output {(ret.data() + outputSize), static_cast<std::size_t>(bufferSize), 0};
+
+        const std::size_t remaining = ZSTD_compressStream2(m_stream->context, &output, &input, directive);
+        ret.truncate(outputSize + static_cast<qsizetype>(output.pos));
+
+        if (ZSTD_isError(remaining))
+        {
+            ZSTD_freeCCtx(m_stream->context);
+            m_stream->context = nullptr;
+            return {};
+        }
+
+        // all the input is consumed and flushed when nothing remains
+        if (remaining == 0)
+            break;
+    }
+
+    if (finish)
+        m_stream->isFinished = true;
+    return ret;
+}
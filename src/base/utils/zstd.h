@@ -0,0 +1,62 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include <QtClassHelperMacros>
+
+class QByteArray;
+class QByteArrayView;
+
+namespace Utils::Zstd
+{
+    QByteArray compress(const QByteArray &data, int level = 3, bool *ok = nullptr);
+    // Decompresses a single zstd frame
+    QByteArray decompress(const QByteArray &data, bool *ok = nullptr);
+
+    // Compresses the data passed in parts into a single zstd frame
+    class StreamCompressor
+    {
+        Q_DISABLE_COPY_MOVE(StreamCompressor)
+
+    public:
+        explicit StreamCompressor(int level = 3);
+        ~StreamCompressor();
+
+        bool isValid() const;
+        // Returns the compressed data available so far,
+        // the frame is completed when `finish` is set
+        QByteArray compress(QByteArrayView data, bool finish = false);
+
+    private:
+        struct Stream;
+        std::unique_ptr<Stream> m_stream;
+    };
+}
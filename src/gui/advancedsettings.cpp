@@ -63,13 +63,27 @@ namespace
         // qBittorrent section
         QBITTORRENT_HEADER,
         RESUME_DATA_STORAGE,
+        RESUME_DATA_STORAGE_BATCH_SIZE,
+        RESUME_DATA_STORAGE_COMPRESSION,
+        STOPPED_TORRENTS_COLD_MODE,
+        DISK_AWARE_CHECKING,
+        MAX_ACTIVE_CHECKING_TORRENTS_PER_VOLUME,
+        CHECKING_QUEUE_ORDER,
+        MAX_ACTIVE_METADATA_DOWNLOADS,
         TORRENT_CONTENT_REMOVE_OPTION,
+        TORRENT_CONTENT_REMOVING_RATE,
+        LOW_DISK_SPACE_THRESHOLD,
 #if defined(QBT_USES_LIBTORRENT2) && !defined(Q_OS_LINUX) && !defined(Q_OS_MACOS)
         MEMORY_WORKING_SET_LIMIT,
 #endif
 #if defined(Q_OS_WIN)
         OS_MEMORY_PRIORITY,
 #endif
+        LOWER_BULK_WORK_PRIORITY,
+        LATENCY_SENSITIVE_THREADS_CPU_AFFINITY,
+        // log verbosity, a row per category
+        LOG_MESSAGE_TYPES,
+        LOG_MESSAGE_TYPES_LAST = (LOG_MESSAGE_TYPES + Log::CATEGORY_COUNT - 1),
         // network interface
         NETWORK_IFACE,
         //Optional network address
@@ -108,7 +122,11 @@ namespace
         ENABLE_MARK_OF_THE_WEB,
 #endif // Q_OS_MACOS || Q_OS_WIN
         IGNORE_SSL_ERRORS,
+        MAX_DOWNLOADS_PER_HOST,
         PYTHON_EXECUTABLE_PATH,
+        AUTORUN_MAX_PROCESSES,
+        AUTORUN_TIMEOUT,
+        AUTORUN_BATCHING,
         START_SESSION_PAUSED,
         SESSION_SHUTDOWN_TIMEOUT,
 
@@ -116,6 +134,7 @@ namespace
         LIBTORRENT_HEADER,
         BDECODE_DEPTH_LIMIT,
         BDECODE_TOKEN_LIMIT,
+        PERFORMANCE_PROFILE,
         ASYNC_IO_THREADS,
 #ifdef QBT_USES_LIBTORRENT2
         HASHING_THREADS,
@@ -126,6 +145,12 @@ namespace
         // cache
         DISK_CACHE,
         DISK_CACHE_TTL,
+#else
+        DISK_READ_CACHE,
+        PERSISTENT_READ_CACHE_PATH,
+        PERSISTENT_READ_CACHE_SIZE,
+        DISK_WRITE_COALESCING_SIZE,
+        DISK_WRITE_COALESCING_TIME,
 #endif
         DISK_QUEUE_SIZE,
 #ifdef QBT_USES_LIBTORRENT2
@@ -133,6 +158,7 @@ namespace
 #endif
         DISK_IO_READ_MODE,
         DISK_IO_WRITE_MODE,
+        NATIVE_SESSION_SHARDS,
 #ifndef QBT_USES_LIBTORRENT2
         COALESCE_RW,
 #endif
@@ -160,6 +186,10 @@ namespace
         // seeding
         CHOKING_ALGORITHM,
         SEED_CHOKING_ALGORITHM,
+        UNCHOKE_SLOTS_TUNING,
+        DORMANT_SEEDS,
+        DORMANT_SEED_IDLE_TIME,
+        DORMANT_SEED_SCRAPE_INTERVAL,
         // tracker
         ANNOUNCE_ALL_TRACKERS,
         ANNOUNCE_ALL_TIERS,
@@ -209,6 +239,15 @@ void AdvancedSettings::saveAdvancedSettings() const
     BitTorrent::Session *const session = BitTorrent::Session::instance();
 
     session->setResumeDataStorageType(m_comboBoxResumeDataStorage.currentData().value<BitTorrent::ResumeDataStorageType>());
+    session->setResumeDataStorageBatchSize(m_spinBoxResumeDataStorageBatchSize.value());
+    session->setResumeDataStorageCompressionEnabled(m_checkBoxResumeDataStorageCompression.isChecked());
+    session->setStoppedTorrentsColdModeEnabled(m_checkBoxStoppedTorrentsColdMode.isChecked());
+    // Disk-aware checking
+    session->setDiskAwareCheckingEnabled(m_checkBoxDiskAwareChecking.isChecked());
+    session->setMaxActiveCheckingTorrentsPerVolume(m_spinBoxMaxActiveCheckingTorrentsPerVolume.value());
+    session->setCheckingQueueOrder(m_comboBoxCheckingQueueOrder.currentData().value<BitTorrent::CheckingQueueOrder>());
+    // Metadata downloads
+    session->setMaxActiveMetadataDownloads(m_spinBoxMaxActiveMetadataDownloads.value());
 #if defined(QBT_USES_LIBTORRENT2) && !defined(Q_OS_LINUX) && !defined(Q_OS_MACOS)
     // Physical memory (RAM) usage limit
     app()->setMemoryWorkingSetLimit(m_spinBoxMemoryWorkingSetLimit.value());
@@ -216,11 +255,23 @@ void AdvancedSettings::saveAdvancedSettings() const
 #if defined(Q_OS_WIN)
     app()->setProcessMemoryPriority(m_comboBoxOSMemoryPriority.currentData().value<MemoryPriority>());
 #endif
+    // Thread scheduling
+    app()->setBulkWorkPriorityLowered(m_checkBoxLowerBulkWorkPriority.isChecked());
+    app()->setLatencySensitiveThreadsCPUAffinity(m_lineEditLatencySensitiveThreadsCPUAffinity.text());
+    // Log verbosity
+    for (int i = 0; i < Log::CATEGORY_COUNT; ++i)
+    {
+        // the value set through WebAPI may have no matching item, it is kept as is then
+        const QComboBox &comboBox = m_comboBoxLogMessageTypes[i];
+        if (comboBox.currentIndex() >= 0)
+            pref->setLogMessageTypes(static_cast<Log::Category>(i), Log::MsgTypes::fromInt(comboBox.currentData().toInt()));
+    }
     // Bdecode depth limit
     pref->setBdecodeDepthLimit(m_spinBoxBdecodeDepthLimit.value());
     // Bdecode token limit
     pref->setBdecodeTokenLimit(m_spinBoxBdecodeTokenLimit.value());
     // Async IO threads
+    session->setPerformanceProfile(m_comboBoxPerformanceProfile.currentData().value<BitTorrent::PerformanceProfile>());
     session->setAsyncIOThreads(m_spinBoxAsyncIOThreads.value());
 #ifdef QBT_USES_LIBTORRENT2
     // Hashing threads
@@ -234,6 +285,15 @@ void AdvancedSettings::saveAdvancedSettings() const
     // Disk write cache
     session->setDiskCacheSize(m_spinBoxCache.value());
     session->setDiskCacheTTL(m_spinBoxCacheTTL.value());
+#else
+    // Disk read cache
+    session->setDiskReadCacheSize(m_spinBoxReadCache.value());
+    // Persistent read cache
+    session->setPersistentReadCachePath(Path(m_lineEditPersistentReadCachePath.text().trimmed()));
+    session->setPersistentReadCacheSize(m_spinBoxPersistentReadCache.value());
+    // Write coalescing
+    session->setDiskWriteCoalescingSize(m_spinBoxWriteCoalescingSize.value());
+    session->setDiskWriteCoalescingTime(m_spinBoxWriteCoalescingTime.value());
 #endif
     // Disk queue size
     session->setDiskQueueSize(m_spinBoxDiskQueueSize.value() * 1024);
@@ -244,6 +304,8 @@ void AdvancedSettings::saveAdvancedSettings() const
     session->setDiskIOReadMode(m_comboBoxDiskIOReadMode.currentData().value<BitTorrent::DiskIOReadMode>());
     // Disk IO write mode
     session->setDiskIOWriteMode(m_comboBoxDiskIOWriteMode.currentData().value<BitTorrent::DiskIOWriteMode>());
+    // Native session shards
+    session->setNativeSessionShards(m_spinBoxNativeSessionShards.value());
 #ifndef QBT_USES_LIBTORRENT2
     // Coalesce reads & writes
     session->setCoalesceReadWriteEnabled(m_checkBoxCoalesceRW.isChecked());
@@ -346,8 +408,14 @@ void AdvancedSettings::saveAdvancedSettings() const
 #endif // Q_OS_MACOS || Q_OS_WIN
     // Ignore SSL errors
     pref->setIgnoreSSLErrors(m_checkBoxIgnoreSSLErrors.isChecked());
+    // Max downloads per host
+    pref->setMaxDownloadsPerHost(m_spinBoxMaxDownloadsPerHost.value());
     // Python executable path
     pref->setPythonExecutablePath(Path(m_pythonExecutablePath.text().trimmed()));
+    // External programs
+    pref->setAutoRunMaxProcesses(m_spinBoxAutoRunMaxProcesses.value());
+    pref->setAutoRunTimeout(m_spinBoxAutoRunTimeout.value());
+    pref->setAutoRunBatchingEnabled(m_checkBoxAutoRunBatching.isChecked());
     // Start session paused
     session->setStartPaused(m_checkBoxStartSessionPaused.isChecked());
     // Session shutdown timeout
@@ -356,6 +424,12 @@ void AdvancedSettings::saveAdvancedSettings() const
     session->setChokingAlgorithm(m_comboBoxChokingAlgorithm.currentData().value<BitTorrent::ChokingAlgorithm>());
     // Seed choking algorithm
     session->setSeedChokingAlgorithm(m_comboBoxSeedChokingAlgorithm.currentData().value<BitTorrent::SeedChokingAlgorithm>());
+    // Upload slots tuning
+    session->setUnchokeSlotsTuningEnabled(m_checkBoxUnchokeSlotsTuning.isChecked());
+    // Dormant seeds
+    session->setDormantSeedsEnabled(m_checkBoxDormantSeeds.isChecked());
+    session->setDormantSeedIdleTime(m_spinBoxDormantSeedIdleTime.value());
+    session->setDormantSeedScrapeInterval(m_spinBoxDormantSeedScrapeInterval.value());
 
     pref->setConfirmTorrentRecheck(m_checkBoxConfirmTorrentRecheck.isChecked());
 
@@ -381,6 +455,8 @@ void AdvancedSettings::saveAdvancedSettings() const
 #endif
 
     session->setTorrentContentRemoveOption(m_comboBoxTorrentContentRemoveOption.currentData().value<BitTorrent::TorrentContentRemoveOption>());
+    session->setTorrentContentRemovingRate(m_spinBoxTorrentContentRemovingRate.value());
+    session->setLowDiskSpaceThreshold(m_spinBoxLowDiskSpaceThreshold.value());
 }
 
 #ifndef QBT_USES_LIBTORRENT2
@@ -486,13 +562,56 @@ void AdvancedSettings::loadAdvancedSettings()
 
     m_comboBoxResumeDataStorage.addItem(tr("Fastresume files"), QVariant::fromValue(BitTorrent::ResumeDataStorageType::Legacy));
     m_comboBoxResumeDataStorage.addItem(tr("SQLite database (experimental)"), QVariant::fromValue(BitTorrent::ResumeDataStorageType::SQLite));
+    m_comboBoxResumeDataStorage.addItem(tr("Append-only journal (experimental)"), QVariant::fromValue(BitTorrent::ResumeDataStorageType::Journal));
     m_comboBoxResumeDataStorage.setCurrentIndex(m_comboBoxResumeDataStorage.findData(QVariant::fromValue(session->resumeDataStorageType())));
     addRow(RESUME_DATA_STORAGE, tr("Resume data storage type (requires restart)"), &m_comboBoxResumeDataStorage);
 
+    m_spinBoxResumeDataStorageBatchSize.setMinimum(0);
+    m_spinBoxResumeDataStorageBatchSize.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxResumeDataStorageBatchSize.setValue(session->resumeDataStorageBatchSize());
+    m_spinBoxResumeDataStorageBatchSize.setSpecialValueText(tr("0 (unlimited)"));
+    addRow(RESUME_DATA_STORAGE_BATCH_SIZE, tr("SQLite database transaction size [0: unlimited]", "Maximum number of resume data changes committed at once."), &m_spinBoxResumeDataStorageBatchSize);
+    m_checkBoxResumeDataStorageCompression.setChecked(session->isResumeDataStorageCompressionEnabled());
+    addRow(RESUME_DATA_STORAGE_COMPRESSION, tr("Compress resume data stored in SQLite database"), &m_checkBoxResumeDataStorageCompression);
+    // Release metadata of inactive stopped torrents
+    m_checkBoxStoppedTorrentsColdMode.setChecked(session->isStoppedTorrentsColdModeEnabled());
+    addRow(STOPPED_TORRENTS_COLD_MODE, tr("Release metadata of inactive stopped torrents from memory"), &m_checkBoxStoppedTorrentsColdMode);
+    // Disk-aware checking
+    m_checkBoxDiskAwareChecking.setChecked(session->isDiskAwareCheckingEnabled());
+    addRow(DISK_AWARE_CHECKING, tr("Schedule checking torrents per storage device"), &m_checkBoxDiskAwareChecking);
+    m_spinBoxMaxActiveCheckingTorrentsPerVolume.setMinimum(1);
+    m_spinBoxMaxActiveCheckingTorrentsPerVolume.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxMaxActiveCheckingTorrentsPerVolume.setValue(session->maxActiveCheckingTorrentsPerVolume());
+    addRow(MAX_ACTIVE_CHECKING_TORRENTS_PER_VOLUME, tr("Maximum active checking torrents per storage device"), &m_spinBoxMaxActiveCheckingTorrentsPerVolume);
+    m_comboBoxCheckingQueueOrder.addItem(tr("Queue position"), QVariant::fromValue(BitTorrent::CheckingQueueOrder::QueuePosition));
+    m_comboBoxCheckingQueueOrder.addItem(tr("Smallest first"), QVariant::fromValue(BitTorrent::CheckingQueueOrder::SmallestFirst));
+    m_comboBoxCheckingQueueOrder.addItem(tr("Content path"), QVariant::fromValue(BitTorrent::CheckingQueueOrder::SavePath));
+    m_comboBoxCheckingQueueOrder.setCurrentIndex(m_comboBoxCheckingQueueOrder.findData(QVariant::fromValue(session->checkingQueueOrder())));
+    addRow(CHECKING_QUEUE_ORDER, tr("Checking order of torrents on the same storage device"), &m_comboBoxCheckingQueueOrder);
+    // Metadata downloads
+    m_spinBoxMaxActiveMetadataDownloads.setMinimum(1);
+    m_spinBoxMaxActiveMetadataDownloads.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxMaxActiveMetadataDownloads.setValue(session->maxActiveMetadataDownloads());
+    addRow(MAX_ACTIVE_METADATA_DOWNLOADS, tr("Maximum active metadata downloads of magnet links"), &m_spinBoxMaxActiveMetadataDownloads);
+
     m_comboBoxTorrentContentRemoveOption.addItem(tr("Delete files permanently"), QVariant::fromValue(BitTorrent::TorrentContentRemoveOption::Delete));
     m_comboBoxTorrentContentRemoveOption.addItem(tr("Move files to trash (if possible)"), QVariant::fromValue(BitTorrent::TorrentContentRemoveOption::MoveToTrash));
+    m_comboBoxTorrentContentRemoveOption.addItem(tr("Move files aside and delete them in background"), QVariant::fromValue(BitTorrent::TorrentContentRemoveOption::MoveAsideAndDelete));
     m_comboBoxTorrentContentRemoveOption.setCurrentIndex(m_comboBoxTorrentContentRemoveOption.findData(QVariant::fromValue(session->torrentContentRemoveOption())));
     addRow(TORRENT_CONTENT_REMOVE_OPTION, tr("Torrent content removing mode"), &m_comboBoxTorrentContentRemoveOption);
+    m_spinBoxTorrentContentRemovingRate.setMinimum(0);
+    m_spinBoxTorrentContentRemovingRate.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxTorrentContentRemovingRate.setValue(session->torrentContentRemovingRate());
+    m_spinBoxTorrentContentRemovingRate.setSuffix(tr(" files/s"));
+    m_spinBoxTorrentContentRemovingRate.setSpecialValueText(tr("0 (unlimited)"));
+    addRow(TORRENT_CONTENT_REMOVING_RATE, tr("Torrent content removing rate limit"), &m_spinBoxTorrentContentRemovingRate);
+    m_spinBoxLowDiskSpaceThreshold.setMinimum(0);
+    m_spinBoxLowDiskSpaceThreshold.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxLowDiskSpaceThreshold.setValue(session->lowDiskSpaceThreshold());
+    m_spinBoxLowDiskSpaceThreshold.setSuffix(tr(" MiB"));
+    m_spinBoxLowDiskSpaceThreshold.setSpecialValueText(tr("0 (disabled)"));
+    m_spinBoxLowDiskSpaceThreshold.setToolTip(tr("Downloading torrents are stopped while the free space of their storage device is below this value"));
+    addRow(LOW_DISK_SPACE_THRESHOLD, tr("Stop downloading when free disk space is below"), &m_spinBoxLowDiskSpaceThreshold);
 
 #if defined(QBT_USES_LIBTORRENT2) && !defined(Q_OS_LINUX) && !defined(Q_OS_MACOS)
     // Physical memory (RAM) usage limit
@@ -514,6 +633,28 @@ void AdvancedSettings::loadAdvancedSettings()
         + u' ' + makeLink(u"https://docs.microsoft.com/en-us/windows/win32/api/processthreadsapi/ns-processthreadsapi-memory_priority_information", u"(?)"))
         , &m_comboBoxOSMemoryPriority);
 #endif
+    // Thread scheduling
+    m_checkBoxLowerBulkWorkPriority.setChecked(app()->isBulkWorkPriorityLowered());
+    m_checkBoxLowerBulkWorkPriority.setToolTip(tr("Run checking, moving, creating torrents and saving resume data with lower CPU and I/O priority"));
+    addRow(LOWER_BULK_WORK_PRIORITY, tr("Lower priority of background work (requires restart)"), &m_checkBoxLowerBulkWorkPriority);
+    m_lineEditLatencySensitiveThreadsCPUAffinity.setText(app()->latencySensitiveThreadsCPUAffinity());
+    m_lineEditLatencySensitiveThreadsCPUAffinity.setPlaceholderText(tr("e.g. 0-1,4"));
+    m_lineEditLatencySensitiveThreadsCPUAffinity.setToolTip(tr("CPUs the main and WebUI threads are pinned to, the background work runs on the other ones. Leave empty to disable."));
+    addRow(LATENCY_SENSITIVE_THREADS_CPU_AFFINITY, tr("CPU affinity of latency sensitive threads (requires restart)")
+        , &m_lineEditLatencySensitiveThreadsCPUAffinity);
+    // Log verbosity
+    const QString logCategoryNames[Log::CATEGORY_COUNT] = {tr("General"), tr("Peers"), tr("Trackers")
+            , tr("Network"), tr("Storage"), tr("Performance")};
+    for (int i = 0; i < Log::CATEGORY_COUNT; ++i)
+    {
+        QComboBox &comboBox = m_comboBoxLogMessageTypes[i];
+        comboBox.addItem(tr("All"), Log::MsgTypes(Log::ALL).toInt());
+        comboBox.addItem(tr("Warnings and errors"), (Log::WARNING | Log::CRITICAL).toInt());
+        comboBox.addItem(tr("Errors only"), Log::MsgTypes(Log::CRITICAL).toInt());
+        comboBox.addItem(tr("None"), 0);
+        comboBox.setCurrentIndex(comboBox.findData(pref->getLogMessageTypes(static_cast<Log::Category>(i)).toInt()));
+        addRow((LOG_MESSAGE_TYPES + i), tr("Log messages: %1").arg(logCategoryNames[i]), &comboBox);
+    }
     // Bdecode depth limit
     m_spinBoxBdecodeDepthLimit.setMinimum(0);
     m_spinBoxBdecodeDepthLimit.setMaximum(std::numeric_limits<int>::max());
@@ -526,6 +667,12 @@ void AdvancedSettings::loadAdvancedSettings()
     m_spinBoxBdecodeTokenLimit.setValue(pref->getBdecodeTokenLimit());
     addRow(BDECODE_TOKEN_LIMIT, (tr("Bdecode token limit") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Bdecoding.html#bdecode()", u"(?)"))
             , &m_spinBoxBdecodeTokenLimit);
+    // Performance profile
+    m_comboBoxPerformanceProfile.addItem(tr("Manual"), QVariant::fromValue(BitTorrent::PerformanceProfile::Manual));
+    m_comboBoxPerformanceProfile.addItem(tr("Automatic"), QVariant::fromValue(BitTorrent::PerformanceProfile::Auto));
+    m_comboBoxPerformanceProfile.setCurrentIndex(m_comboBoxPerformanceProfile.findData(QVariant::fromValue(session->performanceProfile())));
+    m_comboBoxPerformanceProfile.setToolTip(tr("Sizes I/O threads, file pool, buffers and connection speed for the hardware and the load of this computer, the settings changed from their defaults override it"));
+    addRow(PERFORMANCE_PROFILE, tr("Performance profile"), &m_comboBoxPerformanceProfile);
     // Async IO threads
     m_spinBoxAsyncIOThreads.setMinimum(1);
     m_spinBoxAsyncIOThreads.setMaximum(1024);
@@ -585,6 +732,41 @@ void AdvancedSettings::loadAdvancedSettings()
     m_spinBoxCacheTTL.setSuffix(tr(" s", " seconds"));
     addRow(DISK_CACHE_TTL, (tr("Disk cache expiry interval") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#cache_expiry", u"(?)"))
             , &m_spinBoxCacheTTL);
+#else
+    // Disk read cache
+    m_spinBoxReadCache.setMinimum(0);
+#ifdef QBT_APP_64BIT
+    m_spinBoxReadCache.setMaximum(33554431);  // 32768GiB
+#else
+    // allocate 1536MiB and leave 512MiB to the rest of program data in RAM
+    m_spinBoxReadCache.setMaximum(1536);
+#endif
+    m_spinBoxReadCache.setValue(session->diskReadCacheSize());
+    m_spinBoxReadCache.setSuffix(tr(" MiB"));
+    m_spinBoxReadCache.setSpecialValueText(tr("0 (disabled)"));
+    addRow(DISK_READ_CACHE, tr("Disk read cache"), &m_spinBoxReadCache);
+    // Persistent read cache
+    m_lineEditPersistentReadCachePath.setPlaceholderText(tr("(Disabled if empty)"));
+    m_lineEditPersistentReadCachePath.setText(session->persistentReadCachePath().toString());
+    addRow(PERSISTENT_READ_CACHE_PATH, tr("Persistent read cache directory (requires restart)"), &m_lineEditPersistentReadCachePath);
+    m_spinBoxPersistentReadCache.setMinimum(0);
+    m_spinBoxPersistentReadCache.setMaximum(33554431);  // 32768GiB
+    m_spinBoxPersistentReadCache.setValue(session->persistentReadCacheSize());
+    m_spinBoxPersistentReadCache.setSuffix(tr(" MiB"));
+    m_spinBoxPersistentReadCache.setSpecialValueText(tr("0 (disabled)"));
+    addRow(PERSISTENT_READ_CACHE_SIZE, tr("Persistent read cache size (uses disk read cache)"), &m_spinBoxPersistentReadCache);
+    // Write coalescing
+    m_spinBoxWriteCoalescingSize.setMinimum(0);
+    m_spinBoxWriteCoalescingSize.setMaximum(1024);
+    m_spinBoxWriteCoalescingSize.setValue(session->diskWriteCoalescingSize());
+    m_spinBoxWriteCoalescingSize.setSuffix(tr(" MiB"));
+    m_spinBoxWriteCoalescingSize.setSpecialValueText(tr("0 (disabled)"));
+    addRow(DISK_WRITE_COALESCING_SIZE, tr("Disk write coalescing buffer (requires restart)"), &m_spinBoxWriteCoalescingSize);
+    m_spinBoxWriteCoalescingTime.setMinimum(10);
+    m_spinBoxWriteCoalescingTime.setMaximum(10000);
+    m_spinBoxWriteCoalescingTime.setValue(session->diskWriteCoalescingTime());
+    m_spinBoxWriteCoalescingTime.setSuffix(tr(" ms", " milliseconds"));
+    addRow(DISK_WRITE_COALESCING_TIME, tr("Disk write coalescing interval (requires restart)"), &m_spinBoxWriteCoalescingTime);
 #endif
     // Disk queue size
     m_spinBoxDiskQueueSize.setMinimum(1);
@@ -599,6 +781,9 @@ void AdvancedSettings::loadAdvancedSettings()
     m_comboBoxDiskIOType.addItem(tr("Memory mapped files"), QVariant::fromValue(BitTorrent::DiskIOType::MMap));
     m_comboBoxDiskIOType.addItem(tr("POSIX-compliant"), QVariant::fromValue(BitTorrent::DiskIOType::Posix));
     m_comboBoxDiskIOType.addItem(tr("Simple pread/pwrite"), QVariant::fromValue(BitTorrent::DiskIOType::SimplePreadPwrite));
+#ifdef QBT_USES_IO_URING
+    m_comboBoxDiskIOType.addItem(tr("io_uring"), QVariant::fromValue(BitTorrent::DiskIOType::IOUring));
+#endif
     m_comboBoxDiskIOType.setCurrentIndex(m_comboBoxDiskIOType.findData(QVariant::fromValue(session->diskIOType())));
     addRow(DISK_IO_TYPE, tr("Disk IO type (requires restart)") + u' ' + makeLink(u"https://www.libtorrent.org/single-page-ref.html#default-disk-io-constructor", u"(?)")
            , &m_comboBoxDiskIOType);
@@ -618,6 +803,11 @@ void AdvancedSettings::loadAdvancedSettings()
     m_comboBoxDiskIOWriteMode.setCurrentIndex(m_comboBoxDiskIOWriteMode.findData(QVariant::fromValue(session->diskIOWriteMode())));
     addRow(DISK_IO_WRITE_MODE, (tr("Disk IO write mode") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#disk_io_write_mode", u"(?)"))
             , &m_comboBoxDiskIOWriteMode);
+    // Native session shards
+    m_spinBoxNativeSessionShards.setMinimum(1);
+    m_spinBoxNativeSessionShards.setMaximum(8);
+    m_spinBoxNativeSessionShards.setValue(session->nativeSessionShards());
+    addRow(NATIVE_SESSION_SHARDS, tr("Number of libtorrent sessions (experimental, requires restart)"), &m_spinBoxNativeSessionShards);
 #ifndef QBT_USES_LIBTORRENT2
     // Coalesce reads & writes
     m_checkBoxCoalesceRW.setChecked(session->isCoalesceReadWriteEnabled());
@@ -896,10 +1086,32 @@ void AdvancedSettings::loadAdvancedSettings()
     m_checkBoxIgnoreSSLErrors.setChecked(pref->isIgnoreSSLErrors());
     m_checkBoxIgnoreSSLErrors.setToolTip(tr("Affects certificate validation and non-torrent protocol activities (e.g. RSS feeds, program updates, torrent files, geoip db, etc)"));
     addRow(IGNORE_SSL_ERRORS, tr("Ignore SSL errors"), &m_checkBoxIgnoreSSLErrors);
+    // Max downloads per host
+    m_spinBoxMaxDownloadsPerHost.setMinimum(1);
+    m_spinBoxMaxDownloadsPerHost.setMaximum(32);
+    m_spinBoxMaxDownloadsPerHost.setValue(pref->maxDownloadsPerHost());
+    m_spinBoxMaxDownloadsPerHost.setToolTip(tr("Limits simultaneous non-torrent downloads (e.g. RSS feeds, torrent files, favicons) from the same host"));
+    addRow(MAX_DOWNLOADS_PER_HOST, tr("Max concurrent downloads per host"), &m_spinBoxMaxDownloadsPerHost);
     // Python executable path
     m_pythonExecutablePath.setPlaceholderText(tr("(Auto detect if empty)"));
     m_pythonExecutablePath.setText(pref->getPythonExecutablePath().toString());
     addRow(PYTHON_EXECUTABLE_PATH, tr("Python executable path (may require restart)"), &m_pythonExecutablePath);
+    // External programs
+    m_spinBoxAutoRunMaxProcesses.setMinimum(1);
+    m_spinBoxAutoRunMaxProcesses.setMaximum(64);
+    m_spinBoxAutoRunMaxProcesses.setValue(pref->getAutoRunMaxProcesses());
+    m_spinBoxAutoRunMaxProcesses.setToolTip(tr("The other invocations of \"Run external program\" wait until one of the running programs exits"));
+    addRow(AUTORUN_MAX_PROCESSES, tr("Max concurrent external programs"), &m_spinBoxAutoRunMaxProcesses);
+    m_spinBoxAutoRunTimeout.setMinimum(0);
+    m_spinBoxAutoRunTimeout.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxAutoRunTimeout.setSuffix(tr(" s", " seconds"));
+    m_spinBoxAutoRunTimeout.setSpecialValueText(tr("0 (disabled)"));
+    m_spinBoxAutoRunTimeout.setValue(pref->getAutoRunTimeout());
+    addRow(AUTORUN_TIMEOUT, tr("External program timeout"), &m_spinBoxAutoRunTimeout);
+    m_checkBoxAutoRunBatching.setChecked(pref->isAutoRunBatchingEnabled());
+    m_checkBoxAutoRunBatching.setToolTip(tr("The program is run once for the torrents added or finished at nearly the same time."
+        " It gets the arguments of the first torrent, the arguments of every torrent are passed through standard input, one tab separated line per torrent."));
+    addRow(AUTORUN_BATCHING, tr("Run external program once for multiple torrents"), &m_checkBoxAutoRunBatching);
     // Start session paused
     m_checkBoxStartSessionPaused.setChecked(session->isStartPaused());
     addRow(START_SESSION_PAUSED, tr("Start BitTorrent session in paused state"), &m_checkBoxStartSessionPaused);
@@ -924,6 +1136,24 @@ void AdvancedSettings::loadAdvancedSettings()
     m_comboBoxSeedChokingAlgorithm.setCurrentIndex(m_comboBoxSeedChokingAlgorithm.findData(QVariant::fromValue(session->seedChokingAlgorithm())));
     addRow(SEED_CHOKING_ALGORITHM, (tr("Upload choking algorithm") + u' ' + makeLink(u"https://www.libtorrent.org/reference-Settings.html#seed_choking_algorithm", u"(?)"))
             , &m_comboBoxSeedChokingAlgorithm);
+    // Upload slots tuning
+    m_checkBoxUnchokeSlotsTuning.setChecked(session->isUnchokeSlotsTuningEnabled());
+    m_checkBoxUnchokeSlotsTuning.setToolTip(tr("Scales the global and per torrent upload slots limits to keep the upload bandwidth utilized, it has no effect with rate based choking algorithm"));
+    addRow(UNCHOKE_SLOTS_TUNING, tr("Adjust upload slots to the upload utilization"), &m_checkBoxUnchokeSlotsTuning);
+    // Dormant seeds
+    m_checkBoxDormantSeeds.setChecked(session->isDormantSeedsEnabled());
+    m_checkBoxDormantSeeds.setToolTip(tr("Seeding torrents that have no leechers and don't upload are paused, they are scraped from time to time and resumed once leechers appear"));
+    addRow(DORMANT_SEEDS, tr("Pause idle seeding torrents until they are in demand"), &m_checkBoxDormantSeeds);
+    m_spinBoxDormantSeedIdleTime.setMinimum(1);
+    m_spinBoxDormantSeedIdleTime.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxDormantSeedIdleTime.setValue(session->dormantSeedIdleTime());
+    m_spinBoxDormantSeedIdleTime.setSuffix(tr(" min", " minutes"));
+    addRow(DORMANT_SEED_IDLE_TIME, tr("Idle seeding time before pausing"), &m_spinBoxDormantSeedIdleTime);
+    m_spinBoxDormantSeedScrapeInterval.setMinimum(1);
+    m_spinBoxDormantSeedScrapeInterval.setMaximum(std::numeric_limits<int>::max());
+    m_spinBoxDormantSeedScrapeInterval.setValue(session->dormantSeedScrapeInterval());
+    m_spinBoxDormantSeedScrapeInterval.setSuffix(tr(" min", " minutes"));
+    addRow(DORMANT_SEED_SCRAPE_INTERVAL, tr("Paused idle seeding torrents scrape interval"), &m_spinBoxDormantSeedScrapeInterval);
 
     // Torrent recheck confirmation
     m_checkBoxConfirmTorrentRecheck.setChecked(pref->confirmTorrentRecheck());
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <array>
+
 #include <libtorrent/config.hpp>
 
 #include <QtSystemDetection>
@@ -37,6 +39,7 @@
 #include <QSpinBox>
 #include <QTableWidget>
 
+#include "base/logger.h"
 #include "guiapplicationcomponent.h"
 
 class AdvancedSettings final : public GUIApplicationComponent<QTableWidget>
@@ -68,29 +71,39 @@ private:
     void loadAdvancedSettings();
     template <typename T> void addRow(int row, const QString &text, T *widget);
 
-    QSpinBox m_spinBoxSaveResumeDataInterval, m_spinBoxSaveStatisticsInterval, m_spinBoxTorrentFileSizeLimit, m_spinBoxBdecodeDepthLimit, m_spinBoxBdecodeTokenLimit,
+    QSpinBox m_spinBoxResumeDataStorageBatchSize, m_spinBoxSaveResumeDataInterval, m_spinBoxSaveStatisticsInterval, m_spinBoxTorrentFileSizeLimit, m_spinBoxBdecodeDepthLimit, m_spinBoxBdecodeTokenLimit,
              m_spinBoxAsyncIOThreads, m_spinBoxFilePoolSize, m_spinBoxCheckingMemUsage, m_spinBoxDiskQueueSize,
              m_spinBoxOutgoingPortsMin, m_spinBoxOutgoingPortsMax, m_spinBoxUPnPLeaseDuration, m_spinBoxPeerToS, m_spinBoxHostnameCacheTTL,
              m_spinBoxListRefresh, m_spinBoxTrackerPort, m_spinBoxSendBufferWatermark, m_spinBoxSendBufferLowWatermark,
              m_spinBoxSendBufferWatermarkFactor, m_spinBoxConnectionSpeed, m_spinBoxSocketSendBufferSize, m_spinBoxSocketReceiveBufferSize, m_spinBoxSocketBacklogSize,
              m_spinBoxAnnouncePort, m_spinBoxMaxConcurrentHTTPAnnounces, m_spinBoxStopTrackerTimeout, m_spinBoxSessionShutdownTimeout,
-             m_spinBoxSavePathHistoryLength, m_spinBoxPeerTurnover, m_spinBoxPeerTurnoverCutoff, m_spinBoxPeerTurnoverInterval, m_spinBoxRequestQueueSize;
+             m_spinBoxSavePathHistoryLength, m_spinBoxPeerTurnover, m_spinBoxPeerTurnoverCutoff, m_spinBoxPeerTurnoverInterval, m_spinBoxRequestQueueSize,
+             m_spinBoxMaxDownloadsPerHost, m_spinBoxMaxActiveCheckingTorrentsPerVolume, m_spinBoxMaxActiveMetadataDownloads, m_spinBoxTorrentContentRemovingRate,
+             m_spinBoxLowDiskSpaceThreshold, m_spinBoxAutoRunMaxProcesses, m_spinBoxAutoRunTimeout,
+             m_spinBoxDormantSeedIdleTime, m_spinBoxDormantSeedScrapeInterval, m_spinBoxNativeSessionShards;
     QCheckBox m_checkBoxOsCache, m_checkBoxRecheckCompleted, m_checkBoxResolveCountries, m_checkBoxResolveHosts,
               m_checkBoxProgramNotifications, m_checkBoxTorrentAddedNotifications, m_checkBoxReannounceWhenAddressChanged, m_checkBoxTrackerFavicon, m_checkBoxTrackerStatus,
               m_checkBoxTrackerPortForwarding, m_checkBoxIgnoreSSLErrors, m_checkBoxConfirmTorrentRecheck, m_checkBoxConfirmRemoveAllTags, m_checkBoxAnnounceAllTrackers,
               m_checkBoxAnnounceAllTiers, m_checkBoxMultiConnectionsPerIp, m_checkBoxValidateHTTPSTrackerCertificate, m_checkBoxSSRFMitigation, m_checkBoxBlockPeersOnPrivilegedPorts,
               m_checkBoxPieceExtentAffinity, m_checkBoxSuggestMode, m_checkBoxSpeedWidgetEnabled, m_checkBoxIDNSupport, m_checkBoxConfirmRemoveTrackerFromAllTorrents,
-              m_checkBoxStartSessionPaused;
+              m_checkBoxStartSessionPaused, m_checkBoxResumeDataStorageCompression,
+              m_checkBoxStoppedTorrentsColdMode, m_checkBoxDiskAwareChecking, m_checkBoxUnchokeSlotsTuning, m_checkBoxAutoRunBatching,
+              m_checkBoxDormantSeeds, m_checkBoxLowerBulkWorkPriority;
     QComboBox m_comboBoxInterface, m_comboBoxInterfaceAddress, m_comboBoxDiskIOReadMode, m_comboBoxDiskIOWriteMode, m_comboBoxUtpMixedMode, m_comboBoxChokingAlgorithm,
-              m_comboBoxSeedChokingAlgorithm, m_comboBoxResumeDataStorage, m_comboBoxTorrentContentRemoveOption;
-    QLineEdit m_lineEditAppInstanceName, m_pythonExecutablePath, m_lineEditAnnounceIP, m_lineEditDHTBootstrapNodes;
+              m_comboBoxSeedChokingAlgorithm, m_comboBoxResumeDataStorage, m_comboBoxTorrentContentRemoveOption,
+              m_comboBoxCheckingQueueOrder, m_comboBoxPerformanceProfile;
+    QLineEdit m_lineEditAppInstanceName, m_pythonExecutablePath, m_lineEditAnnounceIP, m_lineEditDHTBootstrapNodes,
+              m_lineEditLatencySensitiveThreadsCPUAffinity;
+    std::array<QComboBox, Log::CATEGORY_COUNT> m_comboBoxLogMessageTypes;
 
 #ifndef QBT_USES_LIBTORRENT2
     QSpinBox m_spinBoxCache, m_spinBoxCacheTTL;
     QCheckBox m_checkBoxCoalesceRW;
 #else
     QComboBox m_comboBoxDiskIOType;
-    QSpinBox m_spinBoxHashingThreads;
+    QSpinBox m_spinBoxHashingThreads, m_spinBoxReadCache, m_spinBoxPersistentReadCache;
+    QSpinBox m_spinBoxWriteCoalescingSize, m_spinBoxWriteCoalescingTime;
+    QLineEdit m_lineEditPersistentReadCachePath;
 #endif
 
 #if defined(QBT_USES_LIBTORRENT2) && !defined(Q_OS_LINUX) && !defined(Q_OS_MACOS)
@@ -33,7 +33,6 @@
 #include <QPalette>
 
 #include "base/global.h"
-#include "log/logfiltermodel.h"
 #include "log/loglistview.h"
 #include "log/logmodel.h"
 #include "ui_executionlogwidget.h"
@@ -42,18 +41,16 @@
 ExecutionLogWidget::ExecutionLogWidget(const Log::MsgTypes types, QWidget *parent)
     : QWidget(parent)
     , m_ui(new Ui::ExecutionLogWidget)
-    , m_messageFilterModel(new LogFilterModel(types, this))
+    , m_messageModel(new LogMessageModel(types, this))
 {
     m_ui->setupUi(this);
 
-    LogMessageModel *messageModel = new LogMessageModel(this);
-    m_messageFilterModel->setSourceModel(messageModel);
     LogListView *messageView = new LogListView(this);
-    messageView->setModel(m_messageFilterModel);
+    messageView->setModel(m_messageModel);
     messageView->setContextMenuPolicy(Qt::CustomContextMenu);
-    connect(messageView, &LogListView::customContextMenuRequested, this, [this, messageView, messageModel]()
+    connect(messageView, &LogListView::customContextMenuRequested, this, [this, messageView]()
     {
-        displayContextMenu(messageView, messageModel);
+        displayContextMenu(messageView, m_messageModel);
     });
 
     LogPeerModel *peerModel = new LogPeerModel(this);
@@ -81,7 +78,7 @@ ExecutionLogWidget::~ExecutionLogWidget()
 
 void ExecutionLogWidget::setMessageTypes(const Log::MsgTypes types)
 {
-    m_messageFilterModel->setMessageTypes(types);
+    m_messageModel->setMessageTypes(types);
 }
 
 void ExecutionLogWidget::displayContextMenu(const LogListView *view, const BaseLogModel *model) const
@@ -38,8 +38,8 @@ namespace Ui
 }
 
 class BaseLogModel;
-class LogFilterModel;
 class LogListView;
+class LogMessageModel;
 
 class ExecutionLogWidget : public QWidget
 {
@@ -56,5 +56,5 @@ private:
     void displayContextMenu(const LogListView *view, const BaseLogModel *model) const;
 
     Ui::ExecutionLogWidget *m_ui = nullptr;
-    LogFilterModel *m_messageFilterModel = nullptr;
+    LogMessageModel *m_messageModel = nullptr;
 };
@@ -109,7 +109,7 @@ bool GUIAddTorrentManager::addTorrent(const QString &source, const BitTorrent::A
     {
         LogMsg(tr("Downloading torrent... Source: \"%1\"").arg(source));
         // Launch downloader
-        Net::DownloadManager::instance()->download(Net::DownloadRequest(source).limit(pref->getTorrentFileSizeLimit())
+        Net::DownloadManager::instance()->download(Net::DownloadRequest(source).limit(pref->getTorrentFileSizeLimit()).priority(Net::DownloadPriority::High)
                 , pref->useProxyForGeneralPurposes(), this, &GUIAddTorrentManager::onDownloadFinished);
         m_downloadedTorrents[source] = params;
 
@@ -231,7 +231,7 @@ bool GUIAddTorrentManager::processTorrent(const QString &source
     }
 
     if (!hasMetadata)
-        btSession()->downloadMetadata(torrentDescr);
+        btSession()->downloadMetadata(torrentDescr, BitTorrent::MetadataDownloadPriority::High);
 
 #ifdef Q_OS_MACOS
     const bool attached = false;
@@ -30,40 +30,19 @@
 
 #include "logmodel.h"
 
+#include <algorithm>
+#include <iterator>
+
 #include <QApplication>
-#include <QDateTime>
 #include <QColor>
+#include <QDateTime>
+#include <QLocale>
 
 #include "base/global.h"
 #include "gui/uithememanager.h"
 
-const int MAX_VISIBLE_MESSAGES = 20000;
-
-BaseLogModel::Message::Message(const QString &time, const QString &message, const Log::MsgType type)
-    : m_time {time}
-    , m_message {message}
-    , m_type {type}
-{
-}
-
-QString BaseLogModel::Message::time() const
-{
-    return m_time;
-}
-
-QString BaseLogModel::Message::message() const
-{
-    return m_message;
-}
-
-Log::MsgType BaseLogModel::Message::type() const
-{
-    return m_type;
-}
-
 BaseLogModel::BaseLogModel(QObject *parent)
     : QAbstractListModel(parent)
-    , m_messages(MAX_VISIBLE_MESSAGES)
 {
     loadColors();
     connect(UIThemeManager::instance(), &UIThemeManager::themeChanged, this, &BaseLogModel::onUIThemeChanged);
@@ -71,7 +50,7 @@ BaseLogModel::BaseLogModel(QObject *parent)
 
 int BaseLogModel::rowCount(const QModelIndex &) const
 {
-    return static_cast<int>(m_messages.size());
+    return static_cast<int>(m_ids.size());
 }
 
 int BaseLogModel::columnCount(const QModelIndex &) const
@@ -84,43 +63,86 @@ QVariant BaseLogModel::data(const QModelIndex &index, const int role) const
     if (!index.isValid())
         return {};
 
-    const int messageIndex = index.row();
-    if ((messageIndex < 0) || (messageIndex >= static_cast<int>(m_messages.size())))
+    const int row = index.row();
+    if ((row < 0) || (row >= rowCount()))
         return {};
 
-    const Message &message = m_messages[messageIndex];
+    const int id = m_ids[rowCount() - 1 - row];
     switch (role)
     {
     case TimeRole:
-        return message.time();
+        return QLocale::system().toString(QDateTime::fromSecsSinceEpoch(entryTimestamp(id)), QLocale::ShortFormat);
     case MessageRole:
-        return message.message();
+        return entryMessage(id);
     case TimeForegroundRole:
         return m_timeForeground;
     case MessageForegroundRole:
-        return messageForeground(message);
+        return entryForeground(id);
     case TypeRole:
-        return message.type();
+        return entryType(id);
     default:
         return {};
     }
 }
 
-void BaseLogModel::addNewMessage(const BaseLogModel::Message &message)
+bool BaseLogModel::isEntryAccepted([[maybe_unused]] const int id) const
+{
+    return true;
+}
+
+int BaseLogModel::firstID() const
+{
+    return m_firstID;
+}
+
+void BaseLogModel::updateEntries(const int beginID, const int endID)
 {
-    // if row is inserted on filled up buffer, the size will not change
-    // but because of calling of beginInsertRows function we'll have ghost rows.
-    if (m_messages.size() == MAX_VISIBLE_MESSAGES)
+    m_firstID = std::max(m_firstID, beginID);
+
+    // the oldest entries are displayed in the last rows
+    const auto staleCount = static_cast<int>(std::distance(m_ids.cbegin(), std::ranges::lower_bound(m_ids, m_firstID)));
+    if (staleCount > 0)
     {
-        const int lastMessage = static_cast<int>(m_messages.size()) - 1;
-        beginRemoveRows(QModelIndex(), lastMessage, lastMessage);
-        m_messages.pop_back();
+        const int rows = rowCount();
+        beginRemoveRows({}, (rows - staleCount), (rows - 1));
+        m_ids.remove(0, staleCount);
         endRemoveRows();
     }
 
-    beginInsertRows(QModelIndex(), 0, 0);
-    m_messages.push_front(message);
-    endInsertRows();
+    QList<int> newIDs;
+    for (int id = std::max(m_nextID, m_firstID); id < endID; ++id)
+    {
+        if (isEntryAccepted(id))
+            newIDs.append(id);
+    }
+    m_nextID = std::max(m_nextID, endID);
+
+    if (!newIDs.isEmpty())
+    {
+        beginInsertRows({}, 0, static_cast<int>(newIDs.size() - 1));
+        m_ids.append(newIDs);
+        endInsertRows();
+    }
+}
+
+void BaseLogModel::setEntries(const QList<int> &ids)
+{
+    beginResetModel();
+    m_ids = ids;
+    endResetModel();
+}
+
+void BaseLogModel::scheduleRefresh()
+{
+    if (m_isRefreshScheduled)
+        return;
+
+    m_isRefreshScheduled = true;
+    QMetaObject::invokeMethod(this, [this]
+    {
+        m_isRefreshScheduled = false;
+        refresh();
+    }, Qt::QueuedConnection);
 }
 
 void BaseLogModel::onUIThemeChanged()
@@ -137,29 +159,84 @@ void BaseLogModel::loadColors()
 void BaseLogModel::reset()
 {
     beginResetModel();
-    m_messages.clear();
+    m_ids.clear();
+    m_firstID = m_nextID;
     endResetModel();
 }
 
-LogMessageModel::LogMessageModel(QObject *parent)
+LogMessageModel::LogMessageModel(const Log::MsgTypes types, QObject *parent)
     : BaseLogModel(parent)
+    , m_types {types}
 {
     loadColors();
 
-    for (const Log::Msg &msg : asConst(Logger::instance()->getMessages()))
-        handleNewMessage(msg);
-    connect(Logger::instance(), &Logger::newLogMessage, this, &LogMessageModel::handleNewMessage);
+    refresh();
+    connect(Logger::instance(), &Logger::newLogMessage, this, &LogMessageModel::scheduleRefresh);
+}
+
+void LogMessageModel::setMessageTypes(const Log::MsgTypes types)
+{
+    if (types == m_types)
+        return;
+
+    m_types = types;
+
+    // merge the indexes of accepted types instead of checking every message
+    QList<int> ids;
+    for (auto it = m_typeIndexes.cbegin(); it != m_typeIndexes.cend(); ++it)
+    {
+        if (!m_types.testFlag(static_cast<Log::MsgType>(it.key())))
+            continue;
+
+        const QList<int> &typeIDs = it.value();
+        QList<int> mergedIDs;
+        mergedIDs.reserve(ids.size() + typeIDs.size());
+        std::merge(ids.cbegin(), ids.cend(), std::ranges::lower_bound(typeIDs, firstID()), typeIDs.cend()
+            , std::back_inserter(mergedIDs));
+        ids = std::move(mergedIDs);
+    }
+
+    setEntries(ids);
+}
+
+qint64 LogMessageModel::entryTimestamp(const int id) const
+{
+    return m_snapshot.at(id).timestamp;
+}
+
+QString LogMessageModel::entryMessage(const int id) const
+{
+    return m_snapshot.at(id).message;
 }
 
-void LogMessageModel::handleNewMessage(const Log::Msg &message)
+Log::MsgType LogMessageModel::entryType(const int id) const
 {
-    const QString time = QLocale::system().toString(QDateTime::fromSecsSinceEpoch(message.timestamp), QLocale::ShortFormat);
-    addNewMessage({time, message.message, message.type});
+    return m_snapshot.at(id).type;
 }
 
-QColor LogMessageModel::messageForeground(const Message &message) const
+QColor LogMessageModel::entryForeground(const int id) const
 {
-    return m_foregroundForMessageTypes.value(message.type());
+    return m_foregroundForMessageTypes.value(entryType(id));
+}
+
+bool LogMessageModel::isEntryAccepted(const int id) const
+{
+    return m_types.testFlag(entryType(id));
+}
+
+void LogMessageModel::refresh()
+{
+    m_snapshot = Logger::instance()->messagesSnapshot();
+
+    const int beginID = m_snapshot.beginID();
+    const int endID = m_snapshot.endID();
+    for (QList<int> &typeIDs : m_typeIndexes)
+        typeIDs.remove(0, std::distance(typeIDs.cbegin(), std::ranges::lower_bound(typeIDs, beginID)));
+    for (int id = std::max(m_indexedEndID, beginID); id < endID; ++id)
+        m_typeIndexes[entryType(id)].append(id);
+    m_indexedEndID = endID;
+
+    updateEntries(beginID, endID);
 }
 
 void LogMessageModel::onUIThemeChanged()
@@ -186,26 +263,39 @@ LogPeerModel::LogPeerModel(QObject *parent)
 {
     loadColors();
 
-    for (const Log::Peer &peer : asConst(Logger::instance()->getPeers()))
-        handleNewMessage(peer);
-    connect(Logger::instance(), &Logger::newLogPeer, this, &LogPeerModel::handleNewMessage);
+    refresh();
+    connect(Logger::instance(), &Logger::newLogPeer, this, &LogPeerModel::scheduleRefresh);
 }
 
-void LogPeerModel::handleNewMessage(const Log::Peer &peer)
+qint64 LogPeerModel::entryTimestamp(const int id) const
 {
-    const QString time = QLocale::system().toString(QDateTime::fromSecsSinceEpoch(peer.timestamp), QLocale::ShortFormat);
-    const QString message = peer.blocked
+    return m_snapshot.at(id).timestamp;
+}
+
+QString LogPeerModel::entryMessage(const int id) const
+{
+    const Log::Peer &peer = m_snapshot.at(id);
+    return peer.blocked
             ? tr("%1 was blocked. Reason: %2.", "0.0.0.0 was blocked. Reason: reason for blocking.").arg(peer.ip, peer.reason)
             : tr("%1 was banned", "0.0.0.0 was banned").arg(peer.ip);
+}
 
-    addNewMessage({time, message, Log::NORMAL});
+Log::MsgType LogPeerModel::entryType([[maybe_unused]] const int id) const
+{
+    return Log::NORMAL;
 }
 
-QColor LogPeerModel::messageForeground([[maybe_unused]] const Message &message) const
+QColor LogPeerModel::entryForeground([[maybe_unused]] const int id) const
 {
     return m_bannedPeerForeground;
 }
 
+void LogPeerModel::refresh()
+{
+    m_snapshot = Logger::instance()->peersSnapshot();
+    updateEntries(m_snapshot.beginID(), m_snapshot.endID());
+}
+
 void LogPeerModel::onUIThemeChanged()
 {
     loadColors();
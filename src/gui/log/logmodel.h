@@ -30,14 +30,16 @@
 
 #pragma once
 
-#include <boost/circular_buffer.hpp>
-
 #include <QAbstractListModel>
 #include <QColor>
 #include <QHash>
+#include <QList>
 
 #include "base/logger.h"
 
+// Displays the entries of the logger buffer, the newest entry is in the first row.
+// Only the IDs of the displayed entries are kept, the entries are read
+// from the logger buffer snapshot when they are displayed.
 class BaseLogModel : public QAbstractListModel
 {
     Q_DISABLE_COPY_MOVE(BaseLogModel)
@@ -60,29 +62,31 @@ public:
     void reset();
 
 protected:
-    class Message
-    {
-    public:
-        Message(const QString &time, const QString &message, Log::MsgType type);
-
-        QString time() const;
-        QString message() const;
-        Log::MsgType type() const;
-
-    private:
-        QString m_time;
-        QString m_message;
-        Log::MsgType m_type;
-    };
-
-    void addNewMessage(const Message &message);
-    virtual QColor messageForeground(const Message &message) const = 0;
+    virtual qint64 entryTimestamp(int id) const = 0;
+    virtual QString entryMessage(int id) const = 0;
+    virtual Log::MsgType entryType(int id) const = 0;
+    virtual QColor entryForeground(int id) const = 0;
+    virtual bool isEntryAccepted(int id) const;
+    virtual void refresh() = 0;
     virtual void onUIThemeChanged();
 
+    // Entries having lower ID were cleared or dropped from the logger buffer
+    int firstID() const;
+    // Removes the entries having ID lower than `beginID` and adds the accepted new entries up to `endID`
+    void updateEntries(int beginID, int endID);
+    // Replaces the displayed entries, IDs must be sorted
+    void setEntries(const QList<int> &ids);
+    // Refreshes the model once the pending events are processed so a burst of entries is added at once
+    void scheduleRefresh();
+
 private:
     void loadColors();
 
-    boost::circular_buffer_space_optimized<Message> m_messages;
+    // Sorted from oldest to newest
+    QList<int> m_ids;
+    int m_firstID = 0;
+    int m_nextID = 0;
+    bool m_isRefreshScheduled = false;
     QColor m_timeForeground;
 };
 
@@ -92,16 +96,25 @@ class LogMessageModel : public BaseLogModel
     Q_DISABLE_COPY_MOVE(LogMessageModel)
 
 public:
-    explicit LogMessageModel(QObject *parent = nullptr);
+    explicit LogMessageModel(Log::MsgTypes types = Log::ALL, QObject *parent = nullptr);
 
-private slots:
-    void handleNewMessage(const Log::Msg &message);
+    void setMessageTypes(Log::MsgTypes types);
 
 private:
-    QColor messageForeground(const Message &message) const override;
+    qint64 entryTimestamp(int id) const override;
+    QString entryMessage(int id) const override;
+    Log::MsgType entryType(int id) const override;
+    QColor entryForeground(int id) const override;
+    bool isEntryAccepted(int id) const override;
+    void refresh() override;
     void onUIThemeChanged() override;
     void loadColors();
 
+    Log::Snapshot<Log::Msg> m_snapshot;
+    Log::MsgTypes m_types;
+    // IDs of the messages of each type, so the messages aren't visited when the types are changed
+    QHash<int, QList<int>> m_typeIndexes;
+    int m_indexedEndID = 0;
     QHash<int, QColor> m_foregroundForMessageTypes;
 };
 
@@ -113,13 +126,15 @@ class LogPeerModel : public BaseLogModel
 public:
     explicit LogPeerModel(QObject *parent = nullptr);
 
-private slots:
-    void handleNewMessage(const Log::Peer &peer);
-
 private:
-    QColor messageForeground(const Message &message) const override;
+    qint64 entryTimestamp(int id) const override;
+    QString entryMessage(int id) const override;
+    Log::MsgType entryType(int id) const override;
+    QColor entryForeground(int id) const override;
+    void refresh() override;
     void onUIThemeChanged() override;
     void loadColors();
 
+    Log::Snapshot<Log::Peer> m_snapshot;
     QColor m_bannedPeerForeground;
 };
@@ -43,6 +43,7 @@
 #include <QDesktopServices>
 #include <QFileDialog>
 #include <QFileSystemWatcher>
+#include <QHideEvent>
 #include <QLabel>
 #include <QMenu>
 #include <QMessageBox>
@@ -63,12 +64,14 @@
 
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
+#include "base/bittorrent/torrentstatustable.h"
 #include "base/global.h"
 #include "base/net/downloadmanager.h"
 #include "base/path.h"
 #include "base/preferences.h"
 #include "base/rss/rss_folder.h"
 #include "base/rss/rss_session.h"
+#include "base/tracer.h"
 #include "base/utils/foreignapps.h"
 #include "base/utils/fs.h"
 #include "base/utils/misc.h"
@@ -142,6 +145,8 @@ MainWindow::MainWindow(IGUIApplication *app, const WindowState initialState, con
     , m_statusItem {std::make_unique<MacUtils::StatusItem>()}
 #endif // Q_OS_MACOS
 {
+    const TraceSpan traceSpan {"MainWindow::MainWindow"};
+
     m_ui->setupUi(this);
 
     Preferences *const pref = Preferences::instance();
@@ -837,6 +842,8 @@ void MainWindow::cleanup()
     // handleRSSUnreadCountUpdated() at application shutdown
     delete m_rssWidget;
 
+    BitTorrent::Session::instance()->removeRefreshSubscriber(this);
+
     delete m_executableWatcher;
 
     m_preventTimer->stop();
@@ -1110,6 +1117,8 @@ void MainWindow::showEvent(QShowEvent *e)
     {
         // preparations before showing the window
 
+        BitTorrent::Session::instance()->addRefreshSubscriber(this);
+
         if (m_neverShown)
         {
             m_propertiesWidget->readSettings();
@@ -1133,6 +1142,14 @@ void MainWindow::showEvent(QShowEvent *e)
     }
 }
 
+void MainWindow::hideEvent(QHideEvent *e)
+{
+    // displayed data doesn't need to be kept up to date while the window is hidden
+    BitTorrent::Session::instance()->removeRefreshSubscriber(this);
+
+    QMainWindow::hideEvent(e);
+}
+
 void MainWindow::keyPressEvent(QKeyEvent *event)
 {
     if (event->matches(QKeySequence::Paste))
@@ -1183,11 +1200,8 @@ void MainWindow::closeEvent(QCloseEvent *e)
     }
 #endif // Q_OS_MACOS
 
-    const QList<BitTorrent::Torrent *> allTorrents = BitTorrent::Session::instance()->torrents();
-    const bool hasActiveTorrents = std::ranges::any_of(allTorrents, [](const BitTorrent::Torrent *torrent)
-    {
-        return torrent->isActive();
-    });
+    const BitTorrent::TorrentStatusTable &statusTable = BitTorrent::Session::instance()->torrentStatusTable();
+    const bool hasActiveTorrents = (statusTable.count(BitTorrent::TorrentStatusTable::Group::Active) > 0);
     if (pref->confirmOnExit() && hasActiveTorrents)
     {
         if (e->spontaneous() || m_forceExit)
@@ -1461,17 +1475,27 @@ void MainWindow::loadSessionStats()
 {
     const auto *btSession = BitTorrent::Session::instance();
     const BitTorrent::SessionStatus &status = btSession->status();
-    m_downloadRate = Utils::Misc::friendlyUnit(status.payloadDownloadRate, true);
-    m_uploadRate = Utils::Misc::friendlyUnit(status.payloadUploadRate, true);
 
     // update global information
 #ifdef Q_OS_MACOS
     m_badger->updateSpeed(status.payloadDownloadRate, status.payloadUploadRate);
     m_statusItem->updateSpeed(status.payloadDownloadRate, status.payloadUploadRate);
-#else
-    refreshTrayIconTooltip();
 #endif  // Q_OS_MACOS
 
+    // Window title and tray icon tooltip display the rounded rates only,
+    // so they don't need to be updated while these stay the same
+    const QString downloadRate = Utils::Misc::friendlyUnit(status.payloadDownloadRate, true);
+    const QString uploadRate = Utils::Misc::friendlyUnit(status.payloadUploadRate, true);
+    if ((downloadRate == m_downloadRate) && (uploadRate == m_uploadRate))
+        return;
+
+    m_downloadRate = downloadRate;
+    m_uploadRate = uploadRate;
+
+#ifndef Q_OS_MACOS
+    refreshTrayIconTooltip();
+#endif
+
     refreshWindowTitle();
 }
 
@@ -1820,17 +1844,11 @@ void MainWindow::updatePowerManagementState() const
     const bool preventFromSuspendWhenDownloading = pref->preventFromSuspendWhenDownloading();
     const bool preventFromSuspendWhenSeeding = pref->preventFromSuspendWhenSeeding();
 
-    const QList<BitTorrent::Torrent *> allTorrents = BitTorrent::Session::instance()->torrents();
-    const bool inhibitSuspend = std::ranges::any_of(allTorrents, [&](const BitTorrent::Torrent *torrent)
-    {
-        if (preventFromSuspendWhenDownloading && (!torrent->isFinished() && !torrent->isStopped() && !torrent->isErrored() && torrent->hasMetadata()))
-            return true;
-
-        if (preventFromSuspendWhenSeeding && (torrent->isFinished() && !torrent->isStopped()))
-            return true;
-
-        return torrent->isMoving();
-    });
+    using Group = BitTorrent::TorrentStatusTable::Group;
+    const BitTorrent::TorrentStatusTable &statusTable = BitTorrent::Session::instance()->torrentStatusTable();
+    const bool inhibitSuspend = (preventFromSuspendWhenDownloading && (statusTable.count(Group::Downloading) > 0))
+        || (preventFromSuspendWhenSeeding && (statusTable.count(Group::Seeding) > 0))
+        || (statusTable.count(Group::Moving) > 0);
     m_pwr->setActivityState(inhibitSuspend ? PowerManagement::ActivityState::Busy : PowerManagement::ActivityState::Idle);
 
     m_preventTimer->start(PREVENT_SUSPEND_INTERVAL);
@@ -1908,7 +1926,7 @@ void MainWindow::installPython()
     setCursor(Qt::WaitCursor);
     // Download python
     Net::DownloadManager::instance()->download(
-            Net::DownloadRequest(PYTHON_INSTALLER_URL).saveToFile(true)
+            Net::DownloadRequest(PYTHON_INSTALLER_URL).saveToFile(true).streamToFile(true)
             , Preferences::instance()->useProxyForGeneralPurposes()
             , this, &MainWindow::pythonDownloadFinished);
 }
@@ -191,6 +191,7 @@ private:
 
     void closeEvent(QCloseEvent *) override;
     void showEvent(QShowEvent *) override;
+    void hideEvent(QHideEvent *) override;
     void keyPressEvent(QKeyEvent *event) override;
     bool event(QEvent *e) override;
     void displayRSSTab(bool enable);
@@ -31,6 +31,8 @@
 
 #include <QPainter>
 #include <QPalette>
+#include <QPixmap>
+#include <QPixmapCache>
 #include <QStyleOptionProgressBar>
 #include <QStyleOptionViewItem>
 
@@ -84,11 +86,46 @@ void ProgressBarPainter::paint(QPainter *painter, const QStyleOptionViewItem &op
     painter->save();
     const QStyle *style = m_dummyProgressBar.style();
     style->drawPrimitive(QStyle::PE_PanelItemViewItem, &option, painter, option.widget);
-    style->drawControl(QStyle::CE_ProgressBar, &styleOption, painter, &m_dummyProgressBar);
+
+    // The same as CE_ProgressBar, except the groove and contents are rendered once
+    // for each size, progress, color and state, and are reused by all the rows and repaints
+    const QSize barSize = styleOption.rect.size();
+    const qreal pixelRatio = painter->device()->devicePixelRatio();
+    const QString cacheKey = u"qBittorrent/ProgressBarPainter/%1/%2/%3x%4@%5/%6/%7/%8"_s
+        .arg(QString::number(reinterpret_cast<quintptr>(this), 16), QString::number(m_cacheGeneration)
+            , QString::number(barSize.width()), QString::number(barSize.height()), QString::number(pixelRatio)
+            , QString::number(progress), QString::number(styleOption.palette.color(QPalette::Highlight).rgba(), 16)
+            , QString::number(styleOption.state.toInt(), 16));
+    QPixmap barPixmap;
+    if (!QPixmapCache::find(cacheKey, &barPixmap))
+    {
+        barPixmap = QPixmap(barSize * pixelRatio);
+        barPixmap.setDevicePixelRatio(pixelRatio);
+        barPixmap.fill(Qt::transparent);
+
+        QStyleOptionProgressBar barOption = styleOption;
+        barOption.rect = QRect({0, 0}, barSize);
+        QStyleOptionProgressBar subOption = barOption;
+
+        QPainter barPainter {&barPixmap};
+        subOption.rect = style->subElementRect(QStyle::SE_ProgressBarGroove, &barOption, &m_dummyProgressBar);
+        style->drawControl(QStyle::CE_ProgressBarGroove, &subOption, &barPainter, &m_dummyProgressBar);
+        subOption.rect = style->subElementRect(QStyle::SE_ProgressBarContents, &barOption, &m_dummyProgressBar);
+        style->drawControl(QStyle::CE_ProgressBarContents, &subOption, &barPainter, &m_dummyProgressBar);
+        barPainter.end();
+
+        QPixmapCache::insert(cacheKey, barPixmap);
+    }
+    painter->drawPixmap(styleOption.rect.topLeft(), barPixmap);
+
+    QStyleOptionProgressBar labelOption = styleOption;
+    labelOption.rect = style->subElementRect(QStyle::SE_ProgressBarLabel, &styleOption, &m_dummyProgressBar);
+    style->drawControl(QStyle::CE_ProgressBarLabel, &labelOption, painter, &m_dummyProgressBar);
     painter->restore();
 }
 
 void ProgressBarPainter::applyUITheme()
 {
     m_chunkColor = UIThemeManager::instance()->getColor(u"ProgressBar"_s);
+    ++m_cacheGeneration;
 }
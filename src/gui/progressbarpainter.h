@@ -49,6 +49,8 @@ private:
     void applyUITheme();
 
     QColor m_chunkColor;
+    // Changed with UI theme so the cached progress bars of the previous theme aren't used
+    int m_cacheGeneration = 0;
     // for painting progressbar with stylesheet option, a dummy progress bar is required
     QProgressBar m_dummyProgressBar;
 };
@@ -30,7 +30,6 @@
 #include "downloadedpiecesbar.h"
 
 #include <algorithm>
-#include <cmath>
 
 #include <QDebug>
 #include <QList>
@@ -57,83 +56,6 @@ DownloadedPiecesBar::DownloadedPiecesBar(QWidget *parent)
     updateColorsImpl();
 }
 
-QList<float> DownloadedPiecesBar::bitfieldToFloatVector(const QBitArray &vecin, int reqSize)
-{
-    QList<float> result(reqSize, 0.0);
-    if (vecin.isEmpty()) return result;
-
-    const float ratio = vecin.size() / static_cast<float>(reqSize);
-
-    // simple linear transformation algorithm
-    // for example:
-    // image.x(0) = pieces.x(0.0 >= x < 1.7)
-    // image.x(1) = pieces.x(1.7 >= x < 3.4)
-
-    for (int x = 0; x < reqSize; ++x)
-    {
-        // R - real
-        const float fromR = x * ratio;
-        const float toR = (x + 1) * ratio;
-
-        // C - integer
-        int fromC = fromR; // std::floor not needed
-        int toC = std::ceil(toR);
-        if (toC > vecin.size())
-            --toC;
-
-        // position in pieces table
-        int x2 = fromC;
-
-        // little speed up for really big pieces table, 10K+ size
-        const int toCMinusOne = toC - 1;
-
-        // value in returned vector
-        float value = 0;
-
-        // case when calculated range is (15.2 >= x < 15.7)
-        if (x2 == toCMinusOne)
-        {
-            if (vecin[x2])
-                value += ratio;
-            ++x2;
-        }
-        // case when (15.2 >= x < 17.8)
-        else
-        {
-            // subcase (15.2 >= x < 16)
-            if (x2 != fromR)
-            {
-                if (vecin[x2])
-                    value += 1.0 - (fromR - fromC);
-                ++x2;
-            }
-
-            // subcase (16 >= x < 17)
-            for (; x2 < toCMinusOne; ++x2)
-                if (vecin[x2])
-                    value += 1.0;
-
-            // subcase (17 >= x < 17.8)
-            if (x2 == toCMinusOne)
-            {
-                if (vecin[x2])
-                    value += 1.0 - (toC - toR);
-                ++x2;
-            }
-        }
-
-        // normalization <0, 1>
-        value /= ratio;
-
-        // float precision sometimes gives > 1, because it's not possible to store irrational numbers
-        value = std::min(value, 1.0f);
-
-        result[x] = value;
-    }
-
-    return result;
-}
-
 QImage DownloadedPiecesBar::renderImage()
 {
     //  qDebug() << "updateImage";
@@ -150,14 +72,15 @@ QImage DownloadedPiecesBar::renderImage()
         return image;
     }
 
-    QList<float> scaledPieces = bitfieldToFloatVector(m_pieces, image.width());
-    QList<float> scaledPiecesDl = bitfieldToFloatVector(m_downloadedPieces, image.width());
+    const QList<float> scaledPieces = m_pieces.scaled(image.width());
+    const QList<float> scaledPiecesDl = m_downloadedPieces.scaled(image.width());
 
     // filling image
     for (qsizetype x = 0; x < scaledPieces.size(); ++x)
     {
-        float piecesToValue = scaledPieces.at(x);
-        float piecesToValueDl = scaledPiecesDl.at(x);
+        // float precision sometimes gives > 1, because it's not possible to store irrational numbers
+        const float piecesToValue = std::min(scaledPieces.at(x), 1.0f);
+        const float piecesToValueDl = std::min(scaledPiecesDl.at(x), 1.0f);
         if (piecesToValueDl != 0)
         {
             float fillRatio = piecesToValue + piecesToValueDl;
@@ -179,8 +102,8 @@ QImage DownloadedPiecesBar::renderImage()
 
 void DownloadedPiecesBar::setProgress(const QBitArray &pieces, const QBitArray &downloadedPieces)
 {
-    m_pieces = pieces;
-    m_downloadedPieces = downloadedPieces;
+    m_pieces.update(pieces);
+    m_downloadedPieces.update(downloadedPieces);
 
     redraw();
 }
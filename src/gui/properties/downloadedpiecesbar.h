@@ -29,11 +29,10 @@
 
 #pragma once
 
-#include <QBitArray>
-#include <QtContainerFwd>
-
 #include "piecesbar.h"
+#include "piecessummary.h"
 
+class QBitArray;
 class QWidget;
 
 class DownloadedPiecesBar final : public PiecesBar
@@ -51,8 +50,6 @@ public:
     void clear() override;
 
 private:
-    // scale bitfield vector to float vector
-    QList<float> bitfieldToFloatVector(const QBitArray &vecin, int reqSize);
     QImage renderImage() override;
     QString simpleToolTipText() const override;
     void updateColors() override;
@@ -60,8 +57,7 @@ private:
 
     // incomplete piece color
     QColor m_dlPieceColor;
-    // last used bitfields, uses to better resize redraw
-    // TODO: make a diff pieces to new pieces and update only changed pixels, speedup when update > 20x faster
-    QBitArray m_pieces;
-    QBitArray m_downloadedPieces;
+    // last used bitfields, updated incrementally and used to better resize redraw
+    PiecesSummary m_pieces;
+    PiecesSummary m_downloadedPieces;
 };
@@ -0,0 +1,422 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "peerlistmodel.h"
+
+#include <algorithm>
+
+#include <QIcon>
+
+#include "base/bittorrent/peeraddress.h"
+#include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrentinfo.h"
+#include "base/global.h"
+#include "base/net/geoipmanager.h"
+#include "base/path.h"
+#include "base/utils/misc.h"
+#include "base/utils/string.h"
+#include "gui/uithememanager.h"
+
+PeerListModel::PeerListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int PeerListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_items.size();
+}
+
+int PeerListModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : COL_COUNT;
+}
+
+QVariant PeerListModel::headerData(const int section, const Qt::Orientation orientation, const int role) const
+{
+    if (orientation != Qt::Horizontal)
+        return {};
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        switch (section)
+        {
+        case COUNTRY:
+            return tr("Country/Region"); // Country flag column
+        case IP:
+            return tr("IP/Address");
+        case PORT:
+            return tr("Port");
+        case FLAGS:
+            return tr("Flags");
+        case CONNECTION:
+            return tr("Connection");
+        case CLIENT:
+            return tr("Client", "i.e.: Client application");
+        case PEERID_CLIENT:
+            return tr("Peer ID Client", "i.e.: Client resolved from Peer ID");
+        case PROGRESS:
+            return tr("Progress", "i.e: % downloaded");
+        case DOWN_SPEED:
+            return tr("Down Speed", "i.e: Download speed");
+        case UP_SPEED:
+            return tr("Up Speed", "i.e: Upload speed");
+        case TOT_DOWN:
+            return tr("Downloaded", "i.e: total data downloaded");
+        case TOT_UP:
+            return tr("Uploaded", "i.e: total data uploaded");
+        case RELEVANCE:
+            return tr("Relevance", "i.e: How relevant this peer is to us. How many pieces it has that we don't.");
+        case DOWNLOADING_PIECE:
+            return tr("Files", "i.e. files that are being downloaded right now");
+        default:
+            return {};
+        }
+
+    case Qt::TextAlignmentRole:
+        switch (section)
+        {
+        case PORT:
+        case PROGRESS:
+        case DOWN_SPEED:
+        case UP_SPEED:
+        case TOT_DOWN:
+        case TOT_UP:
+        case RELEVANCE:
+            return QVariant {Qt::AlignRight | Qt::AlignVCenter};
+        default:
+            return {};
+        }
+
+    default:
+        return {};
+    }
+}
+
+QVariant PeerListModel::data(const QModelIndex &index, const int role) const
+{
+    if (!index.isValid() || (index.row() >= m_items.size()))
+        return {};
+
+    const PeerItem &item = m_items[index.row()];
+    const BitTorrent::PeerInfo &peer = item.peer;
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return displayValue(item, index.column());
+
+    case UnderlyingDataRole:
+        return underlyingValue(item, index.column());
+
+    case Qt::TextAlignmentRole:
+        switch (index.column())
+        {
+        case PORT:
+        case PROGRESS:
+        case DOWN_SPEED:
+        case UP_SPEED:
+        case TOT_DOWN:
+        case TOT_UP:
+        case RELEVANCE:
+            return QVariant {Qt::AlignRight | Qt::AlignVCenter};
+        default:
+            return {};
+        }
+
+    case Qt::ToolTipRole:
+        switch (index.column())
+        {
+        case COUNTRY:
+            if (m_areCountriesDisplayed && !UIThemeManager::instance()->getFlagIcon(peer.country()).isNull())
+                return Net::GeoIPManager::CountryName(peer.country());
+            return {};
+        case IP:
+            return underlyingValue(item, IP);
+        case CLIENT:
+            return displayValue(item, CLIENT);
+        case FLAGS:
+            return peer.flagsDescription();
+        case DOWNLOADING_PIECE:
+            return item.downloadingFiles.join(u'\n');
+        default:
+            return {};
+        }
+
+    case Qt::DecorationRole:
+        if ((index.column() == COUNTRY) && m_areCountriesDisplayed)
+        {
+            const QIcon icon = UIThemeManager::instance()->getFlagIcon(peer.country());
+            if (!icon.isNull())
+                return icon;
+        }
+        return {};
+
+    default:
+        return {};
+    }
+}
+
+QString PeerListModel::displayValue(const PeerItem &item, const int column) const
+{
+    const BitTorrent::PeerInfo &peer = item.peer;
+
+    const auto unitString = [this](const qint64 value, const bool isSpeed = false) -> QString
+    {
+        return (m_hideZeroValues && (value <= 0)) ? QString() : Utils::Misc::friendlyUnit(value, isSpeed);
+    };
+
+    switch (column)
+    {
+    case IP:
+        if (!peer.useI2PSocket())
+        {
+            if (const QString hostName = m_hostNames.value(item.endpoint.address.ip); !hostName.isEmpty())
+                return hostName;
+        }
+        return underlyingValue(item, IP).toString();
+    case PORT:
+        return peer.useI2PSocket() ? tr("N/A") : QString::number(peer.address().port);
+    case CONNECTION:
+        return peer.connectionType();
+    case FLAGS:
+        return peer.flags();
+    case CLIENT:
+        return peer.client().toHtmlEscaped();
+    case PEERID_CLIENT:
+        return peer.peerIdClient().toHtmlEscaped();
+    case PROGRESS:
+        return (Utils::String::fromDouble(peer.progress() * 100, 1) + u'%');
+    case DOWN_SPEED:
+        return unitString(peer.payloadDownSpeed(), true);
+    case UP_SPEED:
+        return unitString(peer.payloadUpSpeed(), true);
+    case TOT_DOWN:
+        return unitString(peer.totalDownload());
+    case TOT_UP:
+        return unitString(peer.totalUpload());
+    case RELEVANCE:
+        return (Utils::String::fromDouble(peer.relevance() * 100, 1) + u'%');
+    case DOWNLOADING_PIECE:
+        return item.downloadingFiles.join(u';');
+    case IP_HIDDEN:
+        return peer.useI2PSocket() ? QString() : item.endpoint.address.ip.toString();
+    default:
+        return {};
+    }
+}
+
+QVariant PeerListModel::underlyingValue(const PeerItem &item, const int column) const
+{
+    const BitTorrent::PeerInfo &peer = item.peer;
+
+    switch (column)
+    {
+    case IP:
+        return peer.useI2PSocket() ? peer.I2PAddress() : item.endpoint.address.ip.toString();
+    case PORT:
+        return peer.address().port;
+    case CONNECTION:
+        return peer.connectionType();
+    case FLAGS:
+        return peer.flags();
+    case CLIENT:
+        return peer.client().toHtmlEscaped();
+    case PEERID_CLIENT:
+        return peer.peerIdClient().toHtmlEscaped();
+    case PROGRESS:
+        return peer.progress();
+    case DOWN_SPEED:
+        return peer.payloadDownSpeed();
+    case UP_SPEED:
+        return peer.payloadUpSpeed();
+    case TOT_DOWN:
+        return peer.totalDownload();
+    case TOT_UP:
+        return peer.totalUpload();
+    case RELEVANCE:
+        return peer.relevance();
+    case DOWNLOADING_PIECE:
+    case IP_HIDDEN:
+        return displayValue(item, column);
+    default:
+        return {};
+    }
+}
+
+void PeerListModel::applyChanges(const BitTorrent::Torrent *torrent, const BitTorrent::PeerInfoChanges &changes)
+{
+    Q_ASSERT(torrent);
+
+    QList<int> removedRows;
+    removedRows.reserve(changes.removedPeers.size());
+    for (const BitTorrent::PeerEndpoint &peerEndpoint : changes.removedPeers)
+    {
+        if (const int row = m_rowByEndpoint.value(peerEndpoint, -1); row >= 0) [[likely]]
+            removedRows.append(row);
+    }
+    removeRows(std::move(removedRows));
+
+    QList<int> updatedRows;
+    QList<PeerItem> newItems;
+    for (const BitTorrent::PeerInfo &peer : changes.updatedPeers)
+    {
+        const auto peerEndpoint = BitTorrent::PeerEndpoint::fromPeerInfo(peer);
+        if (const int row = m_rowByEndpoint.value(peerEndpoint, -1); row >= 0)
+        {
+            updateItem(m_items[row], torrent, peer);
+            updatedRows.append(row);
+        }
+        else
+        {
+            PeerItem &item = newItems.emplaceBack(PeerItem {.endpoint = peerEndpoint});
+            updateItem(item, torrent, peer);
+        }
+    }
+    notifyRowsChanged(std::move(updatedRows));
+
+    if (!newItems.isEmpty())
+    {
+        const int firstRow = m_items.size();
+        beginInsertRows({}, firstRow, (firstRow + newItems.size() - 1));
+        for (PeerItem &item : newItems)
+        {
+            m_rowByEndpoint.insert(item.endpoint, m_items.size());
+            m_items.append(std::move(item));
+        }
+        endInsertRows();
+    }
+}
+
+void PeerListModel::clear()
+{
+    beginResetModel();
+    m_items.clear();
+    m_rowByEndpoint.clear();
+    m_hostNames.clear();
+    endResetModel();
+}
+
+void PeerListModel::setHideZeroValues(const bool hide)
+{
+    if (hide == m_hideZeroValues)
+        return;
+
+    m_hideZeroValues = hide;
+    if (!m_items.isEmpty())
+        emit dataChanged(index(0, DOWN_SPEED), index((m_items.size() - 1), TOT_UP), {Qt::DisplayRole});
+}
+
+void PeerListModel::setCountriesDisplayed(const bool displayed)
+{
+    if (displayed == m_areCountriesDisplayed)
+        return;
+
+    m_areCountriesDisplayed = displayed;
+    if (!m_items.isEmpty())
+        emit dataChanged(index(0, COUNTRY), index((m_items.size() - 1), COUNTRY));
+}
+
+void PeerListModel::setHostName(const QHostAddress &ip, const QString &hostName)
+{
+    if (hostName.isEmpty())
+        return;
+
+    QString &storedHostName = m_hostNames[ip];
+    if (storedHostName == hostName)
+        return;
+
+    storedHostName = hostName;
+    for (int row = 0; row < m_items.size(); ++row)
+    {
+        const PeerItem &item = m_items[row];
+        if (!item.peer.useI2PSocket() && (item.endpoint.address.ip == ip))
+            emit dataChanged(index(row, IP), index(row, IP), {Qt::DisplayRole});
+    }
+}
+
+void PeerListModel::updateItem(PeerItem &item, const BitTorrent::Torrent *torrent, const BitTorrent::PeerInfo &peer) const
+{
+    const bool isDownloadingPieceChanged = item.downloadingFiles.isEmpty()
+        || (item.peer.downloadingPieceIndex() != peer.downloadingPieceIndex());
+    item.peer = peer;
+    if (!isDownloadingPieceChanged)
+        return;
+
+    const PathList filePaths = torrent->info().filesForPiece(peer.downloadingPieceIndex());
+    item.downloadingFiles.clear();
+    item.downloadingFiles.reserve(filePaths.size());
+    for (const Path &filePath : filePaths)
+        item.downloadingFiles.append(filePath.toString());
+}
+
+void PeerListModel::removeRows(QList<int> rows)
+{
+    if (rows.isEmpty())
+        return;
+
+    // Remove the rows from the end so the positions of the remaining ones are not shifted
+    std::sort(rows.begin(), rows.end(), std::greater<int>());
+    for (qsizetype i = 0; i < rows.size();)
+    {
+        const int lastRow = rows[i];
+        int firstRow = lastRow;
+        while ((++i < rows.size()) && (rows[i] == (firstRow - 1)))
+            --firstRow;
+
+        beginRemoveRows({}, firstRow, lastRow);
+        m_items.remove(firstRow, (lastRow - firstRow + 1));
+        endRemoveRows();
+    }
+
+    rebuildRowIndex();
+}
+
+void PeerListModel::notifyRowsChanged(QList<int> rows)
+{
+    // Adjacent rows are notified at once
+    std::sort(rows.begin(), rows.end());
+    for (qsizetype i = 0; i < rows.size();)
+    {
+        const int firstRow = rows[i];
+        int lastRow = firstRow;
+        while ((++i < rows.size()) && (rows[i] == (lastRow + 1)))
+            ++lastRow;
+
+        emit dataChanged(index(firstRow, 0), index(lastRow, (COL_COUNT - 1)));
+    }
+}
+
+void PeerListModel::rebuildRowIndex()
+{
+    m_rowByEndpoint.clear();
+    m_rowByEndpoint.reserve(m_items.size());
+    for (int row = 0; row < m_items.size(); ++row)
+        m_rowByEndpoint.insert(m_items[row].endpoint, row);
+}
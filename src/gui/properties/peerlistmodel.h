@@ -0,0 +1,114 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QHostAddress>
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+#include "base/bittorrent/peerinfo.h"
+#include "base/bittorrent/peerinfochanges.h"
+
+namespace BitTorrent
+{
+    class Torrent;
+}
+
+// Peers of the torrent, updated from the changes calculated against the previous peer list snapshot.
+// The displayed values are formatted only when they are requested by the view.
+class PeerListModel final : public QAbstractListModel
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(PeerListModel)
+
+public:
+    enum Column
+    {
+        COUNTRY,
+        IP,
+        PORT,
+        CONNECTION,
+        FLAGS,
+        CLIENT,
+        PEERID_CLIENT,
+        PROGRESS,
+        DOWN_SPEED,
+        UP_SPEED,
+        TOT_DOWN,
+        TOT_UP,
+        RELEVANCE,
+        DOWNLOADING_PIECE,
+        IP_HIDDEN,
+
+        COL_COUNT
+    };
+
+    enum DataRole
+    {
+        UnderlyingDataRole = Qt::UserRole
+    };
+
+    explicit PeerListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = {}) const override;
+    int columnCount(const QModelIndex &parent = {}) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const override;
+
+    void applyChanges(const BitTorrent::Torrent *torrent, const BitTorrent::PeerInfoChanges &changes);
+    void clear();
+
+    void setHideZeroValues(bool hide);
+    void setCountriesDisplayed(bool displayed);
+    void setHostName(const QHostAddress &ip, const QString &hostName);
+
+private:
+    struct PeerItem
+    {
+        BitTorrent::PeerInfo peer;
+        BitTorrent::PeerEndpoint endpoint;
+        QStringList downloadingFiles;
+    };
+
+    QString displayValue(const PeerItem &item, int column) const;
+    QVariant underlyingValue(const PeerItem &item, int column) const;
+    void updateItem(PeerItem &item, const BitTorrent::Torrent *torrent, const BitTorrent::PeerInfo &peer) const;
+    void removeRows(QList<int> rows);
+    void notifyRowsChanged(QList<int> rows);
+    void rebuildRowIndex();
+
+    QList<PeerItem> m_items;
+    QHash<BitTorrent::PeerEndpoint, int> m_rowByEndpoint;  // must be kept in sync with `m_items`
+    QHash<QHostAddress, QString> m_hostNames;
+    bool m_hideZeroValues = false;
+    bool m_areCountriesDisplayed = true;
+};
@@ -28,23 +28,23 @@
 
 #include "peerlistsortmodel.h"
 
-#include "peerlistwidget.h"
+#include "peerlistmodel.h"
 
 PeerListSortModel::PeerListSortModel(QObject *parent)
     : QSortFilterProxyModel(parent)
 {
-    setSortRole(UnderlyingDataRole);
+    setSortRole(PeerListModel::UnderlyingDataRole);
 }
 
 bool PeerListSortModel::lessThan(const QModelIndex &left, const QModelIndex &right) const
 {
     switch (sortColumn())
     {
-    case PeerListWidget::IP:
-    case PeerListWidget::CLIENT:
+    case PeerListModel::IP:
+    case PeerListModel::CLIENT:
         {
-            const QString strL = left.data(UnderlyingDataRole).toString();
-            const QString strR = right.data(UnderlyingDataRole).toString();
+            const QString strL = left.data(PeerListModel::UnderlyingDataRole).toString();
+            const QString strR = right.data(PeerListModel::UnderlyingDataRole).toString();
             return m_naturalLessThan(strL, strR);
         }
         break;
@@ -38,11 +38,6 @@ class PeerListSortModel final : public QSortFilterProxyModel
     Q_DISABLE_COPY_MOVE(PeerListSortModel)
 
 public:
-    enum
-    {
-        UnderlyingDataRole = Qt::UserRole
-    };
-
     explicit PeerListSortModel(QObject *parent = nullptr);
 
 private:
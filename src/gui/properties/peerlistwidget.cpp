@@ -40,58 +40,28 @@
 #include <QMenu>
 #include <QMessageBox>
 #include <QPointer>
-#include <QSet>
 #include <QShortcut>
 #include <QSortFilterProxyModel>
-#include <QStandardItemModel>
 #include <QWheelEvent>
 
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
+#include "base/bittorrent/peerinfochanges.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
-#include "base/bittorrent/torrentinfo.h"
 #include "base/global.h"
 #include "base/logger.h"
-#include "base/net/geoipmanager.h"
 #include "base/net/reverseresolution.h"
+#include "base/path.h"
 #include "base/preferences.h"
-#include "base/utils/misc.h"
-#include "base/utils/string.h"
+#include "base/profile.h"
 #include "gui/uithememanager.h"
 #include "gui/utils/keysequence.h"
+#include "peerlistmodel.h"
 #include "peerlistsortmodel.h"
 #include "peersadditiondialog.h"
 #include "propertieswidget.h"
 
-struct PeerEndpoint
-{
-    BitTorrent::PeerAddress address;
-    QString connectionType; // matches return type of `PeerInfo::connectionType()`
-
-    friend bool operator==(const PeerEndpoint &left, const PeerEndpoint &right) = default;
-};
-
-std::size_t qHash(const PeerEndpoint &peerEndpoint, const std::size_t seed = 0)
-{
-    return qHashMulti(seed, peerEndpoint.address, peerEndpoint.connectionType);
-}
-
-namespace
-{
-    void setModelData(QStandardItemModel *model, const int row, const int column, const QString &displayData
-            , const QVariant &underlyingData, const Qt::Alignment textAlignmentData = {}, const QString &toolTip = {})
-    {
-        const QMap<int, QVariant> data = {
-            {Qt::DisplayRole, displayData},
-            {PeerListSortModel::UnderlyingDataRole, underlyingData},
-            {Qt::TextAlignmentRole, QVariant {textAlignmentData}},
-            {Qt::ToolTipRole, toolTip}};
-
-        model->setItemData(model->index(row, column), data);
-    }
-}
-
 PeerListWidget::PeerListWidget(PropertiesWidget *parent)
     : QTreeView(parent)
     , m_properties(parent)
@@ -110,29 +80,7 @@ PeerListWidget::PeerListWidget(PropertiesWidget *parent)
     header()->setTextElideMode(Qt::ElideRight);
 
     // List Model
-    m_listModel = new QStandardItemModel(0, PeerListColumns::COL_COUNT, this);
-    m_listModel->setHeaderData(PeerListColumns::COUNTRY, Qt::Horizontal, tr("Country/Region")); // Country flag column
-    m_listModel->setHeaderData(PeerListColumns::IP, Qt::Horizontal, tr("IP/Address"));
-    m_listModel->setHeaderData(PeerListColumns::PORT, Qt::Horizontal, tr("Port"));
-    m_listModel->setHeaderData(PeerListColumns::FLAGS, Qt::Horizontal, tr("Flags"));
-    m_listModel->setHeaderData(PeerListColumns::CONNECTION, Qt::Horizontal, tr("Connection"));
-    m_listModel->setHeaderData(PeerListColumns::CLIENT, Qt::Horizontal, tr("Client", "i.e.: Client application"));
-    m_listModel->setHeaderData(PeerListColumns::PEERID_CLIENT, Qt::Horizontal, tr("Peer ID Client", "i.e.: Client resolved from Peer ID"));
-    m_listModel->setHeaderData(PeerListColumns::PROGRESS, Qt::Horizontal, tr("Progress", "i.e: % downloaded"));
-    m_listModel->setHeaderData(PeerListColumns::DOWN_SPEED, Qt::Horizontal, tr("Down Speed", "i.e: Download speed"));
-    m_listModel->setHeaderData(PeerListColumns::UP_SPEED, Qt::Horizontal, tr("Up Speed", "i.e: Upload speed"));
-    m_listModel->setHeaderData(PeerListColumns::TOT_DOWN, Qt::Horizontal, tr("Downloaded", "i.e: total data downloaded"));
-    m_listModel->setHeaderData(PeerListColumns::TOT_UP, Qt::Horizontal, tr("Uploaded", "i.e: total data uploaded"));
-    m_listModel->setHeaderData(PeerListColumns::RELEVANCE, Qt::Horizontal, tr("Relevance", "i.e: How relevant this peer is to us. How many pieces it has that we don't."));
-    m_listModel->setHeaderData(PeerListColumns::DOWNLOADING_PIECE, Qt::Horizontal, tr("Files", "i.e. files that are being downloaded right now"));
-    // Set header text alignment
-    m_listModel->setHeaderData(PeerListColumns::PORT, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
-    m_listModel->setHeaderData(PeerListColumns::PROGRESS, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
-    m_listModel->setHeaderData(PeerListColumns::DOWN_SPEED, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
-    m_listModel->setHeaderData(PeerListColumns::UP_SPEED, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
-    m_listModel->setHeaderData(PeerListColumns::TOT_DOWN, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
-    m_listModel->setHeaderData(PeerListColumns::TOT_UP, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
-    m_listModel->setHeaderData(PeerListColumns::RELEVANCE, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
+    m_listModel = new PeerListModel(this);
     // Proxy model to support sorting without actually altering the underlying model
     m_proxyModel = new PeerListSortModel(this);
     m_proxyModel->setDynamicSortFilter(true);
@@ -140,21 +88,22 @@ PeerListWidget::PeerListWidget(PropertiesWidget *parent)
     m_proxyModel->setSortCaseSensitivity(Qt::CaseInsensitive);
     setModel(m_proxyModel);
 
-    hideColumn(PeerListColumns::IP_HIDDEN);
-    hideColumn(PeerListColumns::COL_COUNT);
+    hideColumn(PeerListModel::IP_HIDDEN);
+    hideColumn(PeerListModel::COL_COUNT);
 
     // Default hidden columns
     if (!columnLoaded)
     {
-        hideColumn(PeerListColumns::PEERID_CLIENT);
+        hideColumn(PeerListModel::PEERID_CLIENT);
     }
 
     m_resolveCountries = Preferences::instance()->resolvePeerCountries();
+    m_listModel->setCountriesDisplayed(m_resolveCountries);
     if (!m_resolveCountries)
-        hideColumn(PeerListColumns::COUNTRY);
+        hideColumn(PeerListModel::COUNTRY);
     // Ensure that at least one column is visible at all times
     bool atLeastOne = false;
-    for (int i = 0; i < PeerListColumns::IP_HIDDEN; ++i)
+    for (int i = 0; i < PeerListModel::IP_HIDDEN; ++i)
     {
         if (!isColumnHidden(i))
         {
@@ -163,11 +112,11 @@ PeerListWidget::PeerListWidget(PropertiesWidget *parent)
         }
     }
     if (!atLeastOne)
-        setColumnHidden(PeerListColumns::IP, false);
+        setColumnHidden(PeerListModel::IP, false);
     // To also mitigate the above issue, we have to resize each column when
     // its size is 0, because explicitly 'showing' the column isn't enough
     // in the above scenario.
-    for (int i = 0; i < PeerListColumns::IP_HIDDEN; ++i)
+    for (int i = 0; i < PeerListModel::IP_HIDDEN; ++i)
     {
         if ((columnWidth(i) <= 0) && !isColumnHidden(i))
             resizeColumnToContents(i);
@@ -205,9 +154,9 @@ void PeerListWidget::displayColumnHeaderMenu()
     menu->setTitle(tr("Column visibility"));
     menu->setToolTipsVisible(true);
 
-    for (int i = 0; i < PeerListColumns::IP_HIDDEN; ++i)
+    for (int i = 0; i < PeerListModel::IP_HIDDEN; ++i)
     {
-        if ((i == PeerListColumns::COUNTRY) && !Preferences::instance()->resolvePeerCountries())
+        if ((i == PeerListModel::COUNTRY) && !Preferences::instance()->resolvePeerCountries())
             continue;
 
         const auto columnName = m_listModel->headerData(i, Qt::Horizontal, Qt::DisplayRole).toString();
@@ -248,7 +197,8 @@ void PeerListWidget::updatePeerHostNameResolutionState()
     {
         if (!m_resolver)
         {
-            m_resolver = new Net::ReverseResolution(this);
+            const Path cacheFilePath = specialFolderLocation(SpecialFolder::Cache) / Path(u"peerhostnames.json"_s);
+            m_resolver = new Net::ReverseResolution(cacheFilePath, this);
             connect(m_resolver, &Net::ReverseResolution::ipResolved, this, &PeerListWidget::handleResolved);
             loadPeers(m_properties->getCurrentTorrent());
         }
@@ -267,16 +217,19 @@ void PeerListWidget::updatePeerCountryResolutionState()
         return;
 
     m_resolveCountries = resolveCountries;
+    m_listModel->setCountriesDisplayed(m_resolveCountries);
     if (m_resolveCountries)
     {
+        // Countries of the listed peers were not resolved while the lookup was disabled
+        clear();
         loadPeers(m_properties->getCurrentTorrent());
-        showColumn(PeerListColumns::COUNTRY);
-        if (columnWidth(PeerListColumns::COUNTRY) <= 0)
-            resizeColumnToContents(PeerListColumns::COUNTRY);
+        showColumn(PeerListModel::COUNTRY);
+        if (columnWidth(PeerListModel::COUNTRY) <= 0)
+            resizeColumnToContents(PeerListModel::COUNTRY);
     }
     else
     {
-        hideColumn(PeerListColumns::COUNTRY);
+        hideColumn(PeerListModel::COUNTRY);
     }
 }
 
@@ -343,7 +296,7 @@ void PeerListWidget::banSelectedPeers()
     for (const QModelIndex &index : selectedIndexes)
     {
         const int row = m_proxyModel->mapToSource(index).row();
-        const QString ip = m_listModel->item(row, PeerListColumns::IP_HIDDEN)->text();
+        const QString ip = m_listModel->index(row, PeerListModel::IP_HIDDEN).data().toString();
         selectedIPs += ip;
     }
 
@@ -369,8 +322,8 @@ void PeerListWidget::copySelectedPeers()
     for (const QModelIndex &index : selectedIndexes)
     {
         const int row = m_proxyModel->mapToSource(index).row();
-        const QString ip = m_listModel->item(row, PeerListColumns::IP_HIDDEN)->text();
-        const QString port = m_listModel->item(row, PeerListColumns::PORT)->text();
+        const QString ip = m_listModel->index(row, PeerListModel::IP_HIDDEN).data().toString();
+        const QString port = m_listModel->index(row, PeerListModel::PORT).data().toString();
 
         if (!ip.contains(u'.'))  // IPv6
             selectedPeers << (u'[' + ip + u"]:" + port);
@@ -383,12 +336,10 @@ void PeerListWidget::copySelectedPeers()
 
 void PeerListWidget::clear()
 {
-    m_peerItems.clear();
-    m_I2PPeerItems.clear();
-    m_itemsByIP.clear();
-    const int nbrows = m_listModel->rowCount();
-    if (nbrows > 0)
-        m_listModel->removeRows(0, nbrows);
+    m_peersSnapshot.reset();
+    m_isLoadingPeers = false;
+    ++m_peersGeneration;
+    m_listModel->clear();
 }
 
 bool PeerListWidget::loadSettings()
@@ -406,144 +357,44 @@ void PeerListWidget::loadPeers(const BitTorrent::Torrent *torrent)
     if (!torrent)
         return;
 
+    // Changes have to be chained to the snapshot of the previous ones
+    if (m_isLoadingPeers)
+        return;
+
+    m_isLoadingPeers = true;
     using TorrentPtr = QPointer<const BitTorrent::Torrent>;
-    torrent->fetchPeerInfo().then(this, [this, torrent = TorrentPtr(torrent)](const QList<BitTorrent::PeerInfo> &peers)
+    torrent->fetchPeerInfoChanges(m_peersSnapshot).then(this
+            , [this, torrent = TorrentPtr(torrent), generation = m_peersGeneration](const BitTorrent::PeerInfoChanges &changes)
     {
+        // The list was cleared while the changes were calculated against the discarded snapshot
+        if (generation != m_peersGeneration)
+            return;
+
+        m_isLoadingPeers = false;
+
         if (const BitTorrent::Torrent *currentTorrent = m_properties->getCurrentTorrent();
             !currentTorrent || (currentTorrent != torrent))
         {
             return;
         }
 
-        // Remove I2P peers since they will be completely reloaded.
-        for (const QStandardItem *item : asConst(m_I2PPeerItems))
-            m_listModel->removeRow(item->row());
-        m_I2PPeerItems.clear();
-
-        QSet<PeerEndpoint> existingPeers;
-        existingPeers.reserve(m_peerItems.size());
-        for (auto i = m_peerItems.cbegin(); i != m_peerItems.cend(); ++i)
-            existingPeers.insert(i.key());
+        m_peersSnapshot = changes.snapshot;
 
         const Preferences *pref = Preferences::instance();
-        const bool hideZeroValues = (pref->getHideZeroValues() && (pref->getHideZeroComboValues() == 0));
-        for (const BitTorrent::PeerInfo &peer : peers)
-        {
-            const PeerEndpoint peerEndpoint {peer.address(), peer.connectionType()};
-
-            auto itemIter = m_peerItems.find(peerEndpoint);
-            const bool isNewPeer = (itemIter == m_peerItems.end());
-            const int row = isNewPeer ? m_listModel->rowCount() : (*itemIter)->row();
-            if (isNewPeer)
-            {
-                m_listModel->insertRow(row);
+        m_listModel->setHideZeroValues(pref->getHideZeroValues() && (pref->getHideZeroComboValues() == 0));
+        m_listModel->applyChanges(torrent, changes);
 
-                const bool useI2PSocket = peer.useI2PSocket();
-
-                const QString peerIPString = useI2PSocket ? peer.I2PAddress() : peerEndpoint.address.ip.toString();
-                setModelData(m_listModel, row, PeerListColumns::IP, peerIPString, peerIPString, {}, peerIPString);
-
-                const QString peerIPHiddenString = useI2PSocket ? QString() : peerEndpoint.address.ip.toString();
-                setModelData(m_listModel, row, PeerListColumns::IP_HIDDEN, peerIPHiddenString, peerIPHiddenString);
-
-                const QString peerPortString = useI2PSocket ? tr("N/A") : QString::number(peer.address().port);
-                setModelData(m_listModel, row, PeerListColumns::PORT, peerPortString, peer.address().port, (Qt::AlignRight | Qt::AlignVCenter));
-
-                if (useI2PSocket)
-                {
-                    m_I2PPeerItems.append(m_listModel->item(row, PeerListColumns::IP));
-                }
-                else
-                {
-                    itemIter = m_peerItems.insert(peerEndpoint, m_listModel->item(row, PeerListColumns::IP));
-                    m_itemsByIP[peerEndpoint.address.ip].insert(itemIter.value());
-                }
-            }
-            else
+        if (m_resolver)
+        {
+            for (const BitTorrent::PeerInfo &peer : changes.updatedPeers)
             {
-                existingPeers.remove(peerEndpoint);
+                if (!peer.useI2PSocket())
+                    m_resolver->resolve(peer.address().ip);
             }
-
-            updatePeer(row, torrent, peer, hideZeroValues);
-        }
-
-        // Remove peers that are gone
-        for (const PeerEndpoint &peerEndpoint : asConst(existingPeers))
-        {
-            QStandardItem *item = m_peerItems.take(peerEndpoint);
-
-            const auto items = m_itemsByIP.find(peerEndpoint.address.ip);
-            Q_ASSERT(items != m_itemsByIP.end());
-            if (items == m_itemsByIP.end()) [[unlikely]]
-                continue;
-
-            items->remove(item);
-            if (items->isEmpty())
-                m_itemsByIP.erase(items);
-
-            m_listModel->removeRow(item->row());
         }
     });
 }
 
-void PeerListWidget::updatePeer(const int row, const BitTorrent::Torrent *torrent, const BitTorrent::PeerInfo &peer, const bool hideZeroValues)
-{
-    const Qt::Alignment intDataTextAlignment = Qt::AlignRight | Qt::AlignVCenter;
-
-    const QString client = peer.client().toHtmlEscaped();
-    setModelData(m_listModel, row, PeerListColumns::CLIENT, client, client, {}, client);
-
-    const QString peerIdClient = peer.peerIdClient().toHtmlEscaped();
-    setModelData(m_listModel, row, PeerListColumns::PEERID_CLIENT, peerIdClient, peerIdClient);
-
-    const QString downSpeed = (hideZeroValues && (peer.payloadDownSpeed() <= 0))
-            ? QString() : Utils::Misc::friendlyUnit(peer.payloadDownSpeed(), true);
-    setModelData(m_listModel, row, PeerListColumns::DOWN_SPEED, downSpeed, peer.payloadDownSpeed(), intDataTextAlignment);
-
-    const QString upSpeed = (hideZeroValues && (peer.payloadUpSpeed() <= 0))
-            ? QString() : Utils::Misc::friendlyUnit(peer.payloadUpSpeed(), true);
-    setModelData(m_listModel, row, PeerListColumns::UP_SPEED, upSpeed, peer.payloadUpSpeed(), intDataTextAlignment);
-
-    const QString totalDown = (hideZeroValues && (peer.totalDownload() <= 0))
-            ? QString() : Utils::Misc::friendlyUnit(peer.totalDownload());
-    setModelData(m_listModel, row, PeerListColumns::TOT_DOWN, totalDown, peer.totalDownload(), intDataTextAlignment);
-
-    const QString totalUp = (hideZeroValues && (peer.totalUpload() <= 0))
-            ? QString() : Utils::Misc::friendlyUnit(peer.totalUpload());
-    setModelData(m_listModel, row, PeerListColumns::TOT_UP, totalUp, peer.totalUpload(), intDataTextAlignment);
-
-    setModelData(m_listModel, row, PeerListColumns::CONNECTION, peer.connectionType(), peer.connectionType());
-    setModelData(m_listModel, row, PeerListColumns::FLAGS, peer.flags(), peer.flags(), {}, peer.flagsDescription());
-    setModelData(m_listModel, row, PeerListColumns::PROGRESS, (Utils::String::fromDouble(peer.progress() * 100, 1) + u'%')
-            , peer.progress(), intDataTextAlignment);
-    setModelData(m_listModel, row, PeerListColumns::RELEVANCE, (Utils::String::fromDouble(peer.relevance() * 100, 1) + u'%')
-            , peer.relevance(), intDataTextAlignment);
-
-    const PathList filePaths = torrent->info().filesForPiece(peer.downloadingPieceIndex());
-    QStringList downloadingFiles;
-    downloadingFiles.reserve(filePaths.size());
-    for (const Path &filePath : filePaths)
-        downloadingFiles.append(filePath.toString());
-
-    const QString downloadingFilesDisplayValue = downloadingFiles.join(u';');
-    setModelData(m_listModel, row, PeerListColumns::DOWNLOADING_PIECE, downloadingFilesDisplayValue
-            , downloadingFilesDisplayValue, {}, downloadingFiles.join(u'\n'));
-
-    if (!peer.useI2PSocket() && m_resolver)
-        m_resolver->resolve(peer.address().ip);
-
-    if (m_resolveCountries)
-    {
-        const QIcon icon = UIThemeManager::instance()->getFlagIcon(peer.country());
-        if (!icon.isNull())
-        {
-            m_listModel->setData(m_listModel->index(row, PeerListColumns::COUNTRY), icon, Qt::DecorationRole);
-            const QString countryName = Net::GeoIPManager::CountryName(peer.country());
-            m_listModel->setData(m_listModel->index(row, PeerListColumns::COUNTRY), countryName, Qt::ToolTipRole);
-        }
-    }
-}
-
 int PeerListWidget::visibleColumnsCount() const
 {
     int count = 0;
@@ -556,22 +407,17 @@ int PeerListWidget::visibleColumnsCount() const
     return count;
 }
 
-void PeerListWidget::handleResolved(const QHostAddress &ip, const QString &hostname) const
+void PeerListWidget::handleResolved(const QHostAddress &ip, const QString &hostname)
 {
-    if (hostname.isEmpty())
-        return;
-
-    const QSet<QStandardItem *> items = m_itemsByIP.value(ip);
-    for (QStandardItem *item : items)
-        item->setData(hostname, Qt::DisplayRole);
+    m_listModel->setHostName(ip, hostname);
 }
 
 void PeerListWidget::handleSortColumnChanged(const int col)
 {
-    if (col == PeerListColumns::COUNTRY)
+    if (col == PeerListModel::COUNTRY)
         m_proxyModel->setSortRole(Qt::ToolTipRole);
     else
-        m_proxyModel->setSortRole(PeerListSortModel::UnderlyingDataRole);
+        m_proxyModel->setSortRole(PeerListModel::UnderlyingDataRole);
 }
 
 void PeerListWidget::wheelEvent(QWheelEvent *event)
@@ -28,23 +28,20 @@
 
 #pragma once
 
-#include <QHash>
-#include <QSet>
+#include <memory>
+
 #include <QTreeView>
 
 class QHostAddress;
-class QStandardItem;
-class QStandardItemModel;
 
+class PeerListModel;
 class PeerListSortModel;
 class PropertiesWidget;
 
-struct PeerEndpoint;
-
 namespace BitTorrent
 {
     class Torrent;
-    class PeerInfo;
+    class PeerInfoSnapshot;
 }
 
 namespace Net
@@ -58,27 +55,6 @@ class PeerListWidget final : public QTreeView
     Q_DISABLE_COPY_MOVE(PeerListWidget)
 
 public:
-    enum PeerListColumns
-    {
-        COUNTRY,
-        IP,
-        PORT,
-        CONNECTION,
-        FLAGS,
-        CLIENT,
-        PEERID_CLIENT,
-        PROGRESS,
-        DOWN_SPEED,
-        UP_SPEED,
-        TOT_DOWN,
-        TOT_UP,
-        RELEVANCE,
-        DOWNLOADING_PIECE,
-        IP_HIDDEN,
-
-        COL_COUNT
-    };
-
     explicit PeerListWidget(PropertiesWidget *parent);
     ~PeerListWidget() override;
 
@@ -95,20 +71,19 @@ private slots:
     void banSelectedPeers();
     void copySelectedPeers();
     void handleSortColumnChanged(int col);
-    void handleResolved(const QHostAddress &ip, const QString &hostname) const;
+    void handleResolved(const QHostAddress &ip, const QString &hostname);
 
 private:
-    void updatePeer(int row, const BitTorrent::Torrent *torrent, const BitTorrent::PeerInfo &peer, bool hideZeroValues);
     int visibleColumnsCount() const;
 
     void wheelEvent(QWheelEvent *event) override;
 
-    QStandardItemModel *m_listModel = nullptr;
+    PeerListModel *m_listModel = nullptr;
     PeerListSortModel *m_proxyModel = nullptr;
     PropertiesWidget *m_properties = nullptr;
     Net::ReverseResolution *m_resolver = nullptr;
-    QHash<PeerEndpoint, QStandardItem *> m_peerItems;
-    QList<QStandardItem *> m_I2PPeerItems;
-    QHash<QHostAddress, QSet<QStandardItem *>> m_itemsByIP;  // must be kept in sync with `m_peerItems`
+    std::shared_ptr<const BitTorrent::PeerInfoSnapshot> m_peersSnapshot;
+    bool m_isLoadingPeers = false;
+    quint64 m_peersGeneration = 0;
     bool m_resolveCountries;
 };
@@ -30,7 +30,6 @@
 #include "pieceavailabilitybar.h"
 
 #include <algorithm>
-#include <cmath>
 
 #include <QDebug>
 
@@ -41,92 +40,6 @@ PieceAvailabilityBar::PieceAvailabilityBar(QWidget *parent)
 {
 }
 
-QList<float> PieceAvailabilityBar::intToFloatVector(const QList<int> &vecin, int reqSize)
-{
-    QList<float> result(reqSize, 0.0);
-    if (vecin.isEmpty()) return result;
-
-    const float ratio = static_cast<float>(vecin.size()) / reqSize;
-
-    const int maxElement = *std::ranges::max_element(vecin);
-
-    // std::max because in normalization we don't want divide by 0
-    // if maxElement == 0 check will be disabled please enable this line:
-    // const int maxElement = std::max(*std::ranges::max_element(avail), 1);
-
-    if (maxElement == 0)
-        return result;
-
-    // simple linear transformation algorithm
-    // for example:
-    // image.x(0) = pieces.x(0.0 >= x < 1.7)
-    // image.x(1) = pieces.x(1.7 >= x < 3.4)
-
-    for (int x = 0; x < reqSize; ++x)
-    {
-        // R - real
-        const float fromR = x * ratio;
-        const float toR = (x + 1) * ratio;
-
-        // C - integer
-        int fromC = fromR;// std::floor not needed
-        int toC = std::ceil(toR);
-        if (toC > vecin.size())
-            --toC;
-
-        // position in pieces table
-        int x2 = fromC;
-
-        // little speed up for really big pieces table, 10K+ size
-        const int toCMinusOne = toC - 1;
-
-        // value in returned vector
-        float value = 0;
-
-        // case when calculated range is (15.2 >= x < 15.7)
-        if (x2 == toCMinusOne)
-        {
-            if (vecin[x2])
-                value += ratio * vecin[x2];
-            ++x2;
-        }
-        // case when (15.2 >= x < 17.8)
-        else
-        {
-            // subcase (15.2 >= x < 16)
-            if (x2 != fromR)
-            {
-                if (vecin[x2])
-                    value += (1.0 - (fromR - fromC)) * vecin[x2];
-                ++x2;
-            }
-
-            // subcase (16 >= x < 17)
-            for (; x2 < toCMinusOne; ++x2)
-                if (vecin[x2])
-                    value += vecin[x2];
-
-            // subcase (17 >= x < 17.8)
-            if (x2 == toCMinusOne)
-            {
-                if (vecin[x2])
-                    value += (1.0 - (toC - toR)) * vecin[x2];
-                ++x2;
-            }
-        }
-
-        // normalization <0, 1>
-        value /= ratio * maxElement;
-
-        // float precision sometimes gives > 1, because it's not possible to store irrational numbers
-        value = std::min(value, 1.0f);
-
-        result[x] = value;
-    }
-
-    return result;
-}
-
 QImage PieceAvailabilityBar::renderImage()
 {
     QImage image {width() - 2 * borderWidth, 1, QImage::Format_RGB888};
@@ -136,18 +49,21 @@ QImage PieceAvailabilityBar::renderImage()
         return image;
     }
 
-    if (m_pieces.empty())
+    if (m_pieces.isEmpty())
     {
         image.fill(backgroundColor());
         return image;
     }
 
-    QList<float> scaledPieces = intToFloatVector(m_pieces, image.width());
+    const QList<float> scaledPieces = m_pieces.scaled(image.width());
+    const int maxElement = m_pieces.maxValue();
 
     // filling image
     for (qsizetype x = 0; x < scaledPieces.size(); ++x)
     {
-        float piecesToValue = scaledPieces.at(x);
+        // normalization <0, 1>
+        // float precision sometimes gives > 1, because it's not possible to store irrational numbers
+        const float piecesToValue = (maxElement > 0) ? std::min((scaledPieces.at(x) / maxElement), 1.0f) : 0.0f;
         image.setPixel(x, 0, pieceColors()[piecesToValue * 255]);
     }
 
@@ -156,7 +72,7 @@ QImage PieceAvailabilityBar::renderImage()
 
 void PieceAvailabilityBar::setAvailability(const QList<int> &avail)
 {
-    m_pieces = avail;
+    m_pieces.update(avail);
 
     redraw();
 }
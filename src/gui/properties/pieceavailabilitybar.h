@@ -30,6 +30,7 @@
 #pragma once
 
 #include "piecesbar.h"
+#include "piecessummary.h"
 
 class PieceAvailabilityBar final : public PiecesBar
 {
@@ -50,10 +51,6 @@ private:
     QImage renderImage() override;
     QString simpleToolTipText() const override;
 
-    // last used int vector, uses to better resize redraw
-    // TODO: make a diff pieces to new pieces and update only changed pixels, speedup when update > 20x faster
-    QList<int> m_pieces;
-
-    // scale int vector to float vector
-    QList<float> intToFloatVector(const QList<int> &vecin, int reqSize);
+    // last used int vector, updated incrementally and used to better resize redraw
+    PiecesSummary m_pieces;
 };
@@ -0,0 +1,170 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "piecessummary.h"
+
+#include <algorithm>
+
+#include <QBitArray>
+
+qsizetype PiecesSummary::size() const
+{
+    return m_values.size();
+}
+
+bool PiecesSummary::isEmpty() const
+{
+    return m_values.isEmpty();
+}
+
+void PiecesSummary::clear()
+{
+    m_values.clear();
+    m_partialSums.clear();
+    m_maxValue = 0;
+    m_isMaxValueOutdated = false;
+}
+
+void PiecesSummary::update(const QList<int> &values)
+{
+    if (values.size() != m_values.size())
+    {
+        m_values = values;
+        rebuild();
+        return;
+    }
+
+    for (qsizetype i = 0; i < values.size(); ++i)
+    {
+        if (values[i] != m_values[i])
+            setValue(i, values[i]);
+    }
+}
+
+void PiecesSummary::update(const QBitArray &values)
+{
+    if (values.size() != m_values.size())
+    {
+        m_values = QList<int>(values.size(), 0);
+        for (qsizetype i = 0; i < values.size(); ++i)
+            m_values[i] = values.testBit(i) ? 1 : 0;
+        rebuild();
+        return;
+    }
+
+    for (qsizetype i = 0; i < values.size(); ++i)
+    {
+        if (const int value = values.testBit(i) ? 1 : 0; value != m_values[i])
+            setValue(i, value);
+    }
+}
+
+int PiecesSummary::maxValue() const
+{
+    if (m_isMaxValueOutdated)
+    {
+        m_maxValue = m_values.isEmpty() ? 0 : *std::ranges::max_element(m_values);
+        m_isMaxValueOutdated = false;
+    }
+
+    return m_maxValue;
+}
+
+QList<float> PiecesSummary::scaled(const int reqSize) const
+{
+    QList<float> result(reqSize, 0.0);
+    if (m_values.isEmpty() || (reqSize <= 0))
+        return result;
+
+    const qreal ratio = static_cast<qreal>(m_values.size()) / reqSize;
+
+    // The value of a pixel is the integral of the pieces values over its range
+    // (the edge pieces are taken partially) divided by the range length, e.g.
+    // image.x(0) = pieces.x(0.0 >= x < 1.7)
+    // image.x(1) = pieces.x(1.7 >= x < 3.4)
+    qreal from = integral(0);
+    for (int x = 0; x < reqSize; ++x)
+    {
+        const qreal to = integral((x + 1) * ratio);
+        result[x] = static_cast<float>((to - from) / ratio);
+        from = to;
+    }
+
+    return result;
+}
+
+void PiecesSummary::rebuild()
+{
+    // Each node holds the sum of the values in the range of the size of its lowest set bit
+    m_partialSums = QList<qint64>((m_values.size() + 1), 0);
+    for (qsizetype i = 1; i <= m_values.size(); ++i)
+    {
+        m_partialSums[i] += m_values[i - 1];
+        if (const qsizetype parent = i + (i & -i); parent <= m_values.size())
+            m_partialSums[parent] += m_partialSums[i];
+    }
+
+    m_maxValue = m_values.isEmpty() ? 0 : *std::ranges::max_element(m_values);
+    m_isMaxValueOutdated = false;
+}
+
+void PiecesSummary::setValue(const qsizetype index, const int value)
+{
+    const int oldValue = m_values[index];
+    m_values[index] = value;
+
+    const qint64 delta = value - oldValue;
+    for (qsizetype i = index + 1; i <= m_values.size(); i += (i & -i))
+        m_partialSums[i] += delta;
+
+    if (value > m_maxValue)
+    {
+        m_maxValue = value;
+        m_isMaxValueOutdated = false;
+    }
+    else if (oldValue == m_maxValue)
+        m_isMaxValueOutdated = true;
+}
+
+qint64 PiecesSummary::prefixSum(const qsizetype count) const
+{
+    qint64 sum = 0;
+    for (qsizetype i = count; i > 0; i -= (i & -i))
+        sum += m_partialSums[i];
+    return sum;
+}
+
+qreal PiecesSummary::integral(const qreal pos) const
+{
+    const auto count = std::min(static_cast<qsizetype>(pos), m_values.size());
+    const qreal fraction = pos - count;
+    qreal result = prefixSum(count);
+    if ((count < m_values.size()) && (fraction > 0))
+        result += fraction * m_values[count];
+    return result;
+}
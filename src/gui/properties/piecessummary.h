@@ -0,0 +1,66 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QtTypes>
+#include <QList>
+
+class QBitArray;
+
+// Keeps the per-piece values along with their partial sums at power-of-two resolutions
+// (binary indexed tree) so the values can be scaled to any width in time proportional
+// to the width rather than to the pieces count, and single pieces can be updated in place
+class PiecesSummary
+{
+public:
+    qsizetype size() const;
+    bool isEmpty() const;
+    void clear();
+
+    // Only the changed values are updated if the pieces count is the same,
+    // otherwise the summary is rebuilt
+    void update(const QList<int> &values);
+    void update(const QBitArray &values);
+
+    int maxValue() const;
+
+    // Average values of `reqSize` equal (possibly fractional) piece ranges
+    QList<float> scaled(int reqSize) const;
+
+private:
+    void rebuild();
+    void setValue(qsizetype index, int value);
+    qint64 prefixSum(qsizetype count) const;
+    qreal integral(qreal pos) const;
+
+    QList<int> m_values;
+    QList<qint64> m_partialSums;
+    mutable int m_maxValue = 0;
+    mutable bool m_isMaxValueOutdated = false;
+};
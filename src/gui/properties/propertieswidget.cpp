@@ -42,6 +42,7 @@
 #include <QStackedWidget>
 #include <QUrl>
 
+#include "base/bittorrent/diskiostatistics.h"
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrent.h"
@@ -228,6 +229,7 @@ void PropertiesWidget::clear()
     m_ui->labelReannounceInVal->clear();
     m_ui->labelShareRatioVal->clear();
     m_ui->labelPopularityVal->clear();
+    m_ui->labelDiskIOVal->clear();
     m_ui->listWebSeeds->clear();
     m_ui->labelETAVal->clear();
     m_ui->labelSeedsVal->clear();
@@ -447,6 +449,13 @@ void PropertiesWidget::loadDynamicData()
             const qreal popularity = m_torrent->popularity();
             m_ui->labelPopularityVal->setText(popularity >= BitTorrent::Torrent::MAX_RATIO ? C_INFINITY : Utils::String::fromDouble(popularity, 2));
 
+            const BitTorrent::DiskIOStatistics diskIOStats = BitTorrent::Session::instance()->torrentDiskIOStatistics(m_torrent->id());
+            const BitTorrent::DiskIOOperationStatistics &readStats = diskIOStats[BitTorrent::DiskIOOperation::Read];
+            const BitTorrent::DiskIOOperationStatistics &writeStats = diskIOStats[BitTorrent::DiskIOOperation::Write];
+            m_ui->labelDiskIOVal->setText(tr("%1 read (%2 ms), %3 written (%4 ms)", "%1 and %3 are data sizes, %2 and %4 are 95th percentile latencies, e.g. 1.2 GiB read (2.5 ms), 300 MiB written (10 ms)")
+                .arg(Utils::Misc::friendlyUnit(readStats.bytes), Utils::String::fromDouble((readStats.latencyPercentile(95) / 1000.), 1)
+                    , Utils::Misc::friendlyUnit(writeStats.bytes), Utils::String::fromDouble((writeStats.latencyPercentile(95) / 1000.), 1)));
+
             m_ui->labelSeedsVal->setText(tr("%1 (%2 total)", "%1 and %2 are numbers, e.g. 3 (10 total)")
                 .arg(QString::number(m_torrent->seedsCount())
                     , QString::number(m_torrent->totalSeedsCount())));
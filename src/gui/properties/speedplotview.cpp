@@ -29,17 +29,21 @@
 
 #include "speedplotview.h"
 
+#include <algorithm>
 #include <cmath>
 
+#include <QDateTime>
+#include <QList>
 #include <QLocale>
 #include <QPainter>
 #include <QPen>
 
-#include "base/bittorrent/session.h"
 #include "base/global.h"
 #include "base/unicodestrings.h"
 #include "base/utils/misc.h"
 
+static_assert(static_cast<int>(SpeedPlotView::NB_GRAPHS) == static_cast<int>(SpeedHistory::SeriesCount));
+
 namespace
 {
     // table of supposed nice steps for grid marks to get nice looking quarters of scale
@@ -98,67 +102,6 @@ namespace
     }
 }
 
-SpeedPlotView::Averager::Averager(const milliseconds duration, const milliseconds resolution)
-    : m_resolution {resolution}
-    , m_maxDuration {duration}
-    , m_sink {static_cast<DataCircularBuffer::size_type>(duration / resolution)}
-{
-    m_lastSampleTime.start();
-}
-
-bool SpeedPlotView::Averager::push(const SampleData &sampleData)
-{
-    // Accumulator overflow will be hit in worst case on longest used averaging span,
-    // defined by resolution. Maximum resolution is 144 seconds
-    // Using int32 for accumulator we get overflow when transfer speed reaches 2^31/144 ~~ 14.2 MBytes/s.
-    // With quint64 this speed limit is 2^64/144 ~~ 114 PBytes/s.
-    // This speed is inaccessible to an ordinary user.
-    ++m_counter;
-    for (int id = UP; id < NB_GRAPHS; ++id)
-        m_accumulator[id] += sampleData[id];
-
-    // system may go to sleep, that can cause very big elapsed interval
-    const milliseconds updateInterval {static_cast<int64_t>(BitTorrent::Session::instance()->refreshInterval() * 1.25)};
-    const milliseconds maxElapsed {std::max(updateInterval, m_resolution)};
-    const milliseconds elapsed {std::min(milliseconds {m_lastSampleTime.elapsed()}, maxElapsed)};
-    if (elapsed < m_resolution)
-        return false; // still accumulating
-
-    // it is time final averaging calculations
-    for (int id = UP; id < NB_GRAPHS; ++id)
-        m_accumulator[id] /= m_counter;
-
-    m_currentDuration += elapsed;
-
-    // remove extra data from front if we reached max duration
-    if (m_currentDuration > m_maxDuration)
-    {
-        // once we go above the max duration never go below that
-        // otherwise it will cause empty space in graphs
-        while (!m_sink.empty()
-               && ((m_currentDuration - m_sink.front().duration) >= m_maxDuration))
-        {
-            m_currentDuration -= m_sink.front().duration;
-            m_sink.pop_front();
-        }
-    }
-
-    // now flush out averaged data
-    Q_ASSERT(m_sink.size() < m_sink.capacity());
-    m_sink.push_back({elapsed, m_accumulator});
-
-    // reset
-    m_accumulator = {};
-    m_counter = 0;
-    m_lastSampleTime.restart();
-    return true;
-}
-
-const SpeedPlotView::DataCircularBuffer &SpeedPlotView::Averager::data() const
-{
-    return m_sink;
-}
-
 SpeedPlotView::SpeedPlotView(QWidget *parent)
     : QGraphicsView {parent}
 {
@@ -191,6 +134,8 @@ SpeedPlotView::SpeedPlotView(QWidget *parent)
     greenPen.setStyle(Qt::DotLine);
     m_properties[TRACKER_UP] = GraphProperties(tr("Tracker Upload"), bluePen);
     m_properties[TRACKER_DOWN] = GraphProperties(tr("Tracker Download"), greenPen);
+
+    connect(SpeedHistory::instance(), &SpeedHistory::sampleAdded, viewport(), qOverload<>(&QWidget::update));
 }
 
 void SpeedPlotView::setGraphEnable(GraphID id, bool enable)
@@ -199,81 +144,61 @@ void SpeedPlotView::setGraphEnable(GraphID id, bool enable)
     viewport()->update();
 }
 
-void SpeedPlotView::pushPoint(const SpeedPlotView::SampleData &point)
-{
-    for (Averager *averager : {&m_averager5Min, &m_averager30Min
-                                , &m_averager6Hour, &m_averager12Hour
-                                , &m_averager24Hour})
-    {
-        if (averager->push(point))
-        {
-            if (m_currentAverager == averager)
-                viewport()->update();
-        }
-    }
-}
-
 void SpeedPlotView::setPeriod(const TimePeriod period)
 {
     switch (period)
     {
     case SpeedPlotView::MIN1:
-        m_currentMaxDuration = 1min;
-        m_currentAverager = &m_averager5Min;
+        m_currentMaxDuration = 60;
+        m_currentResolution = SpeedHistory::Resolution::Second;
         break;
     case SpeedPlotView::MIN5:
-        m_currentMaxDuration = 5min;
-        m_currentAverager = &m_averager5Min;
+        m_currentMaxDuration = 5 * 60;
+        m_currentResolution = SpeedHistory::Resolution::Second;
         break;
     case SpeedPlotView::MIN30:
-        m_currentMaxDuration = 30min;
-        m_currentAverager = &m_averager30Min;
+        m_currentMaxDuration = 30 * 60;
+        m_currentResolution = SpeedHistory::Resolution::Second;
         break;
     case SpeedPlotView::HOUR3:
-        m_currentMaxDuration = 3h;
-        m_currentAverager = &m_averager6Hour;
+        m_currentMaxDuration = 3 * 60 * 60;
+        m_currentResolution = SpeedHistory::Resolution::Minute;
         break;
     case SpeedPlotView::HOUR6:
-        m_currentMaxDuration = 6h;
-        m_currentAverager = &m_averager6Hour;
+        m_currentMaxDuration = 6 * 60 * 60;
+        m_currentResolution = SpeedHistory::Resolution::Minute;
         break;
     case SpeedPlotView::HOUR12:
-        m_currentMaxDuration = 12h;
-        m_currentAverager = &m_averager12Hour;
+        m_currentMaxDuration = 12 * 60 * 60;
+        m_currentResolution = SpeedHistory::Resolution::Minute;
         break;
     case SpeedPlotView::HOUR24:
-        m_currentMaxDuration = 24h;
-        m_currentAverager = &m_averager24Hour;
+        m_currentMaxDuration = 24 * 60 * 60;
+        m_currentResolution = SpeedHistory::Resolution::Minute;
+        break;
+    case SpeedPlotView::DAY7:
+        m_currentMaxDuration = 7 * 24 * 60 * 60;
+        m_currentResolution = SpeedHistory::Resolution::Hour;
+        break;
+    case SpeedPlotView::DAY30:
+        m_currentMaxDuration = 30 * 24 * 60 * 60;
+        m_currentResolution = SpeedHistory::Resolution::Hour;
         break;
     }
 
     viewport()->update();
 }
 
-const SpeedPlotView::DataCircularBuffer &SpeedPlotView::currentData() const
-{
-    return m_currentAverager->data();
-}
-
-quint64 SpeedPlotView::maxYValue() const
+quint64 SpeedPlotView::maxYValue(const QList<SpeedHistory::Bucket> &buckets) const
 {
-    const DataCircularBuffer &queue = currentData();
-
     quint64 maxYValue = 0;
     for (int id = UP; id < NB_GRAPHS; ++id)
     {
-
         if (!m_properties[static_cast<GraphID>(id)].enable)
             continue;
 
-        milliseconds duration {0};
-        for (int i = static_cast<int>(queue.size()) - 1; i >= 0; --i)
-        {
-            maxYValue = std::max(maxYValue, queue[i].data[id]);
-            duration += queue[i].duration;
-            if (duration >= m_currentMaxDuration)
-                break;
-        }
+        for (const SpeedHistory::Bucket &bucket : buckets)
+            maxYValue = std::max(maxYValue, bucket.values[id].avg);
     }
 
     return maxYValue;
@@ -287,8 +212,11 @@ void SpeedPlotView::paintEvent(QPaintEvent *)
     QRect rect = viewport()->rect();
     QFontMetrics fontMetrics = painter.fontMetrics();
 
+    const qint64 now = QDateTime::currentSecsSinceEpoch();
+    const QList<SpeedHistory::Bucket> buckets = SpeedHistory::instance()->buckets(m_currentResolution, (now - m_currentMaxDuration));
+
     rect.adjust(4, 4, 0, -4); // Add padding
-    const SplitValue niceScale = getRoundedYScale(maxYValue());
+    const SplitValue niceScale = getRoundedYScale(maxYValue(buckets));
     rect.adjust(0, fontMetrics.height(), 0, 0); // Add top padding for top speed text
 
     // draw Y axis speed labels
@@ -342,37 +270,39 @@ void SpeedPlotView::paintEvent(QPaintEvent *)
     painter.setRenderHints(QPainter::Antialiasing);
 
     // draw graphs
-    // averager is duration based, it may go little above the maxDuration
     painter.setClipping(true);
     painter.setClipRect(rect);
 
-    const DataCircularBuffer &queue = currentData();
-
-    // last point will be drawn at x=0, so we don't need it in the calculation of xTickSize
-    const milliseconds lastDuration {queue.empty() ? 0ms : queue.back().duration};
-    const qreal xTickSize = static_cast<qreal>(rect.width()) / (m_currentMaxDuration - lastDuration).count();
+    const qreal xTickSize = static_cast<qreal>(rect.width()) / m_currentMaxDuration;
     const qreal yMultiplier = (niceScale.arg == 0) ? 0 : (static_cast<qreal>(rect.height()) / niceScale.sizeInBytes());
+    // the history has no data for the time the application wasn't running,
+    // refresh may also be slowed down in idle state so nearby buckets are still connected
+    const qint64 maxGap = std::max<qint64>((2 * SpeedHistory::interval(m_currentResolution)), 60);
 
     for (int id = UP; id < NB_GRAPHS; ++id)
     {
         if (!m_properties[static_cast<GraphID>(id)].enable)
             continue;
 
-        QList<QPoint> points;
-        milliseconds duration {0};
+        painter.setPen(m_properties[static_cast<GraphID>(id)].pen);
 
-        for (int i = static_cast<int>(queue.size()) - 1; i >= 0; --i)
+        QList<QPointF> points;
+        points.reserve(buckets.size());
+        qint64 prevTimestamp = 0;
+        for (const SpeedHistory::Bucket &bucket : buckets)
         {
-            const int newX = rect.right() - (duration.count() * xTickSize);
-            const int newY = rect.bottom() - (queue[i].data[id] * yMultiplier);
-            points.push_back(QPoint(newX, newY));
-
-            duration += queue[i].duration;
-            if (duration >= m_currentMaxDuration)
-                break;
+            if (!points.isEmpty() && ((bucket.timestamp - prevTimestamp) > maxGap))
+            {
+                painter.drawPolyline(points.data(), points.size());
+                points.clear();
+            }
+
+            const qreal newX = rect.right() - ((now - bucket.timestamp) * xTickSize);
+            const qreal newY = rect.bottom() - (bucket.values[id].avg * yMultiplier);
+            points.append({newX, newY});
+            prevTimestamp = bucket.timestamp;
         }
 
-        painter.setPen(m_properties[static_cast<GraphID>(id)].pen);
         painter.drawPolyline(points.data(), points.size());
     }
     painter.setClipping(false);
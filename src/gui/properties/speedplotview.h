@@ -29,21 +29,13 @@
 
 #pragma once
 
-#include <array>
-#include <chrono>
-
-#ifndef Q_MOC_RUN
-#include <boost/circular_buffer.hpp>
-#endif
-
-#include <QElapsedTimer>
+#include <QtContainerFwd>
 #include <QGraphicsView>
 #include <QMap>
 
-class QPen;
+#include "base/speedhistory.h"
 
-using std::chrono::milliseconds;
-using namespace std::chrono_literals;
+class QPen;
 
 class SpeedPlotView final : public QGraphicsView
 {
@@ -51,6 +43,7 @@ class SpeedPlotView final : public QGraphicsView
     Q_DISABLE_COPY_MOVE(SpeedPlotView)
 
 public:
+    // Must be in the same order as SpeedHistory::Series
     enum GraphID
     {
         UP = 0,
@@ -75,49 +68,20 @@ public:
         HOUR3,
         HOUR6,
         HOUR12,
-        HOUR24
+        HOUR24,
+        DAY7,
+        DAY30
     };
 
-    using SampleData = std::array<quint64, NB_GRAPHS>;
-
     explicit SpeedPlotView(QWidget *parent = nullptr);
 
     void setGraphEnable(GraphID id, bool enable);
     void setPeriod(TimePeriod period);
 
-    void pushPoint(const SampleData &point);
-
 protected:
     void paintEvent(QPaintEvent *event) override;
 
 private:
-    struct Sample
-    {
-        milliseconds duration;
-        SampleData data;
-    };
-
-    using DataCircularBuffer = boost::circular_buffer<Sample>;
-
-    class Averager
-    {
-    public:
-        Averager(milliseconds duration, milliseconds resolution);
-
-        bool push(const SampleData &sampleData); // returns true if there is new data to display
-
-        const DataCircularBuffer &data() const;
-
-    private:
-        const milliseconds m_resolution;
-        const milliseconds m_maxDuration;
-        milliseconds m_currentDuration {0};
-        int m_counter = 0;
-        SampleData m_accumulator {};
-        DataCircularBuffer m_sink {};
-        QElapsedTimer m_lastSampleTime;
-    };
-
     struct GraphProperties
     {
         GraphProperties();
@@ -128,16 +92,9 @@ private:
         bool enable;
     };
 
-    quint64 maxYValue() const;
-    const DataCircularBuffer &currentData() const;
-
-    Averager m_averager5Min {5min, 1s};
-    Averager m_averager30Min {30min, 6s};
-    Averager m_averager6Hour {6h, 36s};
-    Averager m_averager12Hour {12h, 72s};
-    Averager m_averager24Hour {24h, 144s};
-    Averager *m_currentAverager {&m_averager5Min};
+    quint64 maxYValue(const QList<SpeedHistory::Bucket> &buckets) const;
 
     QMap<GraphID, GraphProperties> m_properties;
-    milliseconds m_currentMaxDuration {0};
+    qint64 m_currentMaxDuration = 5 * 60; // seconds
+    SpeedHistory::Resolution m_currentResolution = SpeedHistory::Resolution::Second;
 };
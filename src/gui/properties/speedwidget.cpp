@@ -34,8 +34,6 @@
 #include <QMenu>
 #include <QVBoxLayout>
 
-#include "base/bittorrent/session.h"
-#include "base/bittorrent/sessionstatus.h"
 #include "base/preferences.h"
 #include "propertieswidget.h"
 #include "speedplotview.h"
@@ -74,6 +72,8 @@ SpeedWidget::SpeedWidget(PropertiesWidget *parent)
     m_periodCombobox->addItem(tr("6 Hours"));
     m_periodCombobox->addItem(tr("12 Hours"));
     m_periodCombobox->addItem(tr("24 Hours"));
+    m_periodCombobox->addItem(tr("7 Days"));
+    m_periodCombobox->addItem(tr("30 Days"));
 
     connect(m_periodCombobox, qOverload<int>(&QComboBox::currentIndexChanged)
         , this, &SpeedWidget::onPeriodChange);
@@ -109,7 +109,6 @@ SpeedWidget::SpeedWidget(PropertiesWidget *parent)
     m_hlayout->addWidget(m_graphsButton);
 
     m_plot = new SpeedPlotView(this);
-    connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated, this, &SpeedWidget::update);
 
     m_layout->addLayout(m_hlayout);
     m_layout->addWidget(m_plot);
@@ -126,25 +125,6 @@ SpeedWidget::~SpeedWidget()
     qDebug("SpeedWidget::~SpeedWidget() EXIT");
 }
 
-void SpeedWidget::update()
-{
-    const BitTorrent::SessionStatus &btStatus = BitTorrent::Session::instance()->status();
-
-    SpeedPlotView::SampleData sampleData;
-    sampleData[SpeedPlotView::UP] = btStatus.uploadRate;
-    sampleData[SpeedPlotView::DOWN] = btStatus.downloadRate;
-    sampleData[SpeedPlotView::PAYLOAD_UP] = btStatus.payloadUploadRate;
-    sampleData[SpeedPlotView::PAYLOAD_DOWN] = btStatus.payloadDownloadRate;
-    sampleData[SpeedPlotView::OVERHEAD_UP] = btStatus.ipOverheadUploadRate;
-    sampleData[SpeedPlotView::OVERHEAD_DOWN] = btStatus.ipOverheadDownloadRate;
-    sampleData[SpeedPlotView::DHT_UP] = btStatus.dhtUploadRate;
-    sampleData[SpeedPlotView::DHT_DOWN] = btStatus.dhtDownloadRate;
-    sampleData[SpeedPlotView::TRACKER_UP] = btStatus.trackerUploadRate;
-    sampleData[SpeedPlotView::TRACKER_DOWN] = btStatus.trackerDownloadRate;
-
-    m_plot->pushPoint(sampleData);
-}
-
 void SpeedWidget::onPeriodChange(int period)
 {
     m_plot->setPeriod(static_cast<SpeedPlotView::TimePeriod>(period));
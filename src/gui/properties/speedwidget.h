@@ -65,7 +65,6 @@ public:
 private slots:
     void onPeriodChange(int period);
     void onGraphChange(int id);
-    void update();
 
 private:
     void loadSettings();
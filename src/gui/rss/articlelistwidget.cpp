@@ -30,6 +30,7 @@
 
 #include <QApplication>
 #include <QListWidgetItem>
+#include <QScrollBar>
 
 #include "base/global.h"
 #include "base/rss/rss_article.h"
@@ -37,6 +38,13 @@
 #include "gui/uithememanager.h"
 #include "gui/utils.h"
 
+namespace
+{
+    // Number of articles added to the list at once,
+    // more are added when the list is scrolled to its end
+    const int ARTICLES_BATCH_SIZE = 200;
+}
+
 ArticleListWidget::ArticleListWidget(QWidget *parent)
     : QListWidget(parent)
 {
@@ -51,6 +59,12 @@ ArticleListWidget::ArticleListWidget(QWidget *parent)
         for (int row = 0; row < count(); ++row)
             applyUITheme(item(row));
     });
+
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, [this](const int value)
+    {
+        if (value == verticalScrollBar()->maximum())
+            loadPendingArticles();
+    });
 }
 
 RSS::Article *ArticleListWidget::getRSSArticle(QListWidgetItem *item) const
@@ -69,10 +83,12 @@ void ArticleListWidget::setRSSItem(RSS::Item *rssItem, bool unreadOnly, const QS
     // Clear the list first
     clear();
     m_rssArticleToListItemMapping.clear();
+    m_pendingArticles.clear();
     if (m_rssItem)
         m_rssItem->disconnect(this);
 
     m_unreadOnly = unreadOnly;
+    m_filter = filter;
     m_rssItem = rssItem;
     if (m_rssItem)
     {
@@ -80,17 +96,34 @@ void ArticleListWidget::setRSSItem(RSS::Item *rssItem, bool unreadOnly, const QS
         connect(m_rssItem, &RSS::Item::articleRead, this, &ArticleListWidget::handleArticleRead);
         connect(m_rssItem, &RSS::Item::articleAboutToBeRemoved, this, &ArticleListWidget::handleArticleAboutToBeRemoved);
 
-        for (auto *article : asConst(rssItem->articles()))
+        m_pendingArticles = rssItem->articles();
+        loadPendingArticles();
+    }
+
+    checkInvariant();
+}
+
+void ArticleListWidget::loadPendingArticles()
+{
+    qsizetype checkedCount = 0;
+    int addedCount = 0;
+    for (RSS::Article *article : asConst(m_pendingArticles))
+    {
+        if (addedCount >= ARTICLES_BATCH_SIZE)
+            break;
+
+        ++checkedCount;
+        if (!(m_unreadOnly && article->isRead()) && (m_filter.isEmpty() || article->title().contains(m_filter, Qt::CaseInsensitive)))
         {
-            if (!(m_unreadOnly && article->isRead()) && (filter.isEmpty() || article->title().contains(filter, Qt::CaseInsensitive)))
-            {
-                auto *item = createItem(article);
-                addItem(item);
-                m_rssArticleToListItemMapping.insert(article, item);
-            }
+            auto *item = createItem(article);
+            addItem(item);
+            m_rssArticleToListItemMapping.insert(article, item);
+            ++addedCount;
         }
     }
 
+    m_pendingArticles.remove(0, checkedCount);
+
     checkInvariant();
 }
 
@@ -119,6 +152,10 @@ void ArticleListWidget::handleArticleRead(RSS::Article *rssArticle)
 
 void ArticleListWidget::handleArticleAboutToBeRemoved(RSS::Article *rssArticle)
 {
+    // the oldest articles are removed usually, so they are searched from the end
+    if (const qsizetype index = m_pendingArticles.lastIndexOf(rssArticle); index >= 0)
+        m_pendingArticles.removeAt(index);
+
     delete m_rssArticleToListItemMapping.take(rssArticle);
     checkInvariant();
 }
@@ -29,7 +29,9 @@
 #pragma once
 
 #include <QHash>
+#include <QList>
 #include <QListWidget>
+#include <QString>
 
 namespace RSS
 {
@@ -57,10 +59,14 @@ private slots:
 
 private:
     void checkInvariant() const;
+    void loadPendingArticles();
     QListWidgetItem *createItem(RSS::Article *article) const;
     void applyUITheme(QListWidgetItem *item) const;
 
     RSS::Item *m_rssItem = nullptr;
     bool m_unreadOnly = false;
+    QString m_filter;
+    // Articles of the current RSS item that aren't checked against the filter and added to the list yet
+    QList<RSS::Article *> m_pendingArticles;
     QHash<RSS::Article *, QListWidgetItem *> m_rssArticleToListItemMapping;
 };
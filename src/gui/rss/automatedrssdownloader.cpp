@@ -49,6 +49,7 @@
 #include "base/rss/rss_session.h"
 #include "base/utils/compare.h"
 #include "base/utils/io.h"
+#include "base/utils/regex.h"
 #include "base/utils/string.h"
 #include "gui/addtorrentparamswidget.h"
 #include "gui/autoexpandabledialog.h"
@@ -728,7 +729,7 @@ void AutomatedRssDownloader::updateMustLineValidity()
 
         for (const QString &token : asConst(tokens))
         {
-            QRegularExpression reg(token, QRegularExpression::CaseInsensitiveOption);
+            const QRegularExpression reg = Utils::Regex::cached(token, QRegularExpression::CaseInsensitiveOption);
             if (!reg.isValid())
             {
                 if (isRegex)
@@ -775,7 +776,7 @@ void AutomatedRssDownloader::updateMustNotLineValidity()
 
         for (const QString &token : asConst(tokens))
         {
-            QRegularExpression reg(token, QRegularExpression::CaseInsensitiveOption);
+            const QRegularExpression reg = Utils::Regex::cached(token, QRegularExpression::CaseInsensitiveOption);
             if (!reg.isValid())
             {
                 if (isRegex)
@@ -312,7 +312,7 @@ void PluginSelectDialog::addNewPlugin(const QString &pluginName)
         // Icon is missing, we must download it
         using namespace Net;
         DownloadManager::instance()->download(
-                DownloadRequest(plugin->url + u"/favicon.ico").saveToFile(true)
+                DownloadRequest(plugin->url + u"/favicon.ico").saveToFile(true).priority(DownloadPriority::Low)
                 , Preferences::instance()->useProxyForGeneralPurposes(), this, &PluginSelectDialog::iconDownloadFinished);
     }
     item->setText(PLUGIN_VERSION, plugin->version.toString());
@@ -29,6 +29,8 @@
 
 #include "searchjobwidget.h"
 
+#include <chrono>
+
 #include <QApplication>
 #include <QClipboard>
 #include <QDesktopServices>
@@ -38,6 +40,7 @@
 #include <QMessageBox>
 #include <QPalette>
 #include <QStandardItemModel>
+#include <QTimer>
 #include <QUrl>
 
 #include "base/logger.h"
@@ -59,6 +62,9 @@ namespace
         LinkVisitedRole = Qt::UserRole + 100
     };
 
+    // Results received meanwhile are added to the model at once
+    const std::chrono::milliseconds PENDING_RESULTS_ADD_DELAY {100};
+
     QColor visitedRowColor()
     {
         return QApplication::palette().color(QPalette::Disabled, QPalette::WindowText);
@@ -117,6 +123,11 @@ SearchJobWidget::SearchJobWidget(const QString &id, IGUIApplication *app, QWidge
     m_searchListModel->setHeaderData(SearchSortModel::SEEDS, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
     m_searchListModel->setHeaderData(SearchSortModel::LEECHES, Qt::Horizontal, QVariant(Qt::AlignRight | Qt::AlignVCenter), Qt::TextAlignmentRole);
 
+    m_pendingResultsTimer = new QTimer(this);
+    m_pendingResultsTimer->setSingleShot(true);
+    m_pendingResultsTimer->setInterval(PENDING_RESULTS_ADD_DELAY);
+    connect(m_pendingResultsTimer, &QTimer::timeout, this, &SearchJobWidget::addPendingSearchResults);
+
     m_proxyModel = new SearchSortModel(this);
     m_proxyModel->setDynamicSortFilter(true);
     m_proxyModel->setSourceModel(m_searchListModel);
@@ -196,7 +207,9 @@ SearchJobWidget::SearchJobWidget(const QString &id, const QString &searchPattern
     m_searchPattern = searchPattern;
     m_proxyModel->setNameFilter(m_searchPattern);
 
+    m_searchResults = searchResults;
     appendSearchResults(searchResults);
+    addPendingSearchResults();
 }
 
 SearchJobWidget::SearchJobWidget(const QString &id, SearchHandler *searchHandler, IGUIApplication *app, QWidget *parent)
@@ -223,7 +236,7 @@ QString SearchJobWidget::searchPattern() const
 
 QList<SearchResult> SearchJobWidget::searchResults() const
 {
-    return m_searchResults;
+    return m_searchHandler ? m_searchHandler->results() : m_searchResults;
 }
 
 void SearchJobWidget::onItemDoubleClicked(const QModelIndex &index)
@@ -290,12 +303,15 @@ void SearchJobWidget::assignSearchHandler(SearchHandler *searchHandler)
         return;
 
     m_searchResults.clear();
+    m_pendingResults.clear();
+    m_pendingResultsTimer->stop();
     m_searchListModel->removeRows(0, m_searchListModel->rowCount());
     delete m_searchHandler;
 
     m_searchHandler = searchHandler;
     m_searchHandler->setParent(this);
     connect(m_searchHandler, &SearchHandler::newSearchResults, this, &SearchJobWidget::appendSearchResults);
+    connect(m_searchHandler, &SearchHandler::searchResultsUpdated, this, &SearchJobWidget::updateSearchResults);
     connect(m_searchHandler, &SearchHandler::searchFinished, this, &SearchJobWidget::searchFinished);
     connect(m_searchHandler, &SearchHandler::searchFailed, this, &SearchJobWidget::searchFailed);
 
@@ -630,6 +646,8 @@ void SearchJobWidget::displayColumnHeaderMenu()
 
 void SearchJobWidget::searchFinished(bool cancelled)
 {
+    addPendingSearchResults();
+
     if (cancelled)
         setStatus(Status::Aborted);
     else if (m_noSearchResults)
@@ -645,37 +663,81 @@ void SearchJobWidget::searchFailed([[maybe_unused]] const QString &errorMessage)
 
 void SearchJobWidget::appendSearchResults(const QList<SearchResult> &results)
 {
-    for (const SearchResult &result : results)
+    m_pendingResults.append(results);
+    if (!m_pendingResultsTimer->isActive())
+        m_pendingResultsTimer->start();
+}
+
+void SearchJobWidget::addPendingSearchResults()
+{
+    m_pendingResultsTimer->stop();
+    if (m_pendingResults.isEmpty())
+        return;
+
+    // The rows are filled before they are added so the proxy model filters and sorts
+    // each of them once instead of handling the change of each cell
+    for (const SearchResult &result : asConst(m_pendingResults))
+        m_searchListModel->appendRow(createRowItems(result));
+    m_pendingResults.clear();
+
+    updateResultsCount();
+}
+
+// Model rows are added in the same order as the results are stored by the search handler
+void SearchJobWidget::updateSearchResults(const QList<qsizetype> &indexes)
+{
+    const SearchResultStore &resultStore = m_searchHandler->resultStore();
+    const int rowCount = m_searchListModel->rowCount();
+    for (const qsizetype index : indexes)
     {
-        // Add item to search result list
-        int row = m_searchListModel->rowCount();
-        m_searchListModel->insertRow(row);
+        if (index >= rowCount)
+        {
+            // the result isn't added to the model yet
+            if (const qsizetype pendingIndex = index - rowCount; pendingIndex < m_pendingResults.size())
+                m_pendingResults[pendingIndex] = resultStore.at(index);
+            continue;
+        }
 
-        const auto setModelData = [this, row] (const int column, const QString &displayData
-                , const QVariant &underlyingData, const Qt::Alignment textAlignmentData = {})
+        // only the merged fields are updated so that the rest of item data (e.g. "visited" color) is preserved
+        const int row = static_cast<int>(index);
+        const auto updateModelData = [this, row](const int column, const QString &displayData, const QVariant &underlyingData)
         {
-            const QMap<int, QVariant> data =
-            {
-                {Qt::DisplayRole, displayData},
-                {SearchSortModel::UnderlyingDataRole, underlyingData},
-                {Qt::TextAlignmentRole, QVariant {textAlignmentData}}
-            };
-            m_searchListModel->setItemData(m_searchListModel->index(row, column), data);
+            const QModelIndex modelIndex = m_searchListModel->index(row, column);
+            m_searchListModel->setData(modelIndex, displayData, Qt::DisplayRole);
+            m_searchListModel->setData(modelIndex, underlyingData, SearchSortModel::UnderlyingDataRole);
         };
 
-        setModelData(SearchSortModel::NAME, result.fileName, result.fileName);
-        setModelData(SearchSortModel::DL_LINK, result.fileUrl, result.fileUrl);
-        setModelData(SearchSortModel::ENGINE_NAME, result.engineName, result.engineName);
-        setModelData(SearchSortModel::ENGINE_URL, result.siteUrl, result.siteUrl);
-        setModelData(SearchSortModel::DESC_LINK, result.descrLink, result.descrLink);
-        setModelData(SearchSortModel::SIZE, Utils::Misc::friendlyUnit(result.fileSize), result.fileSize, (Qt::AlignRight | Qt::AlignVCenter));
-        setModelData(SearchSortModel::SEEDS, QString::number(result.nbSeeders), result.nbSeeders, (Qt::AlignRight | Qt::AlignVCenter));
-        setModelData(SearchSortModel::LEECHES, QString::number(result.nbLeechers), result.nbLeechers, (Qt::AlignRight | Qt::AlignVCenter));
-        setModelData(SearchSortModel::PUB_DATE, QLocale().toString(result.pubDate.toLocalTime(), QLocale::ShortFormat), result.pubDate);
+        const SearchResult &result = resultStore.at(index);
+        updateModelData(SearchSortModel::DESC_LINK, result.descrLink, result.descrLink);
+        updateModelData(SearchSortModel::SIZE, Utils::Misc::friendlyUnit(result.fileSize), result.fileSize);
+        updateModelData(SearchSortModel::SEEDS, QString::number(result.nbSeeders), result.nbSeeders);
+        updateModelData(SearchSortModel::LEECHES, QString::number(result.nbLeechers), result.nbLeechers);
+        updateModelData(SearchSortModel::PUB_DATE, QLocale().toString(result.pubDate.toLocalTime(), QLocale::ShortFormat), result.pubDate);
     }
+}
 
-    m_searchResults.append(results);
-    updateResultsCount();
+QList<QStandardItem *> SearchJobWidget::createRowItems(const SearchResult &result) const
+{
+    QList<QStandardItem *> items(SearchSortModel::NB_SEARCH_COLUMNS);
+    const auto setItemData = [&items](const int column, const QString &displayData
+            , const QVariant &underlyingData, const Qt::Alignment textAlignmentData = {})
+    {
+        auto *item = new QStandardItem(displayData);
+        item->setData(underlyingData, SearchSortModel::UnderlyingDataRole);
+        item->setData(QVariant {textAlignmentData}, Qt::TextAlignmentRole);
+        items[column] = item;
+    };
+
+    setItemData(SearchSortModel::NAME, result.fileName, result.fileName);
+    setItemData(SearchSortModel::DL_LINK, result.fileUrl, result.fileUrl);
+    setItemData(SearchSortModel::ENGINE_NAME, result.engineName, result.engineName);
+    setItemData(SearchSortModel::ENGINE_URL, result.siteUrl, result.siteUrl);
+    setItemData(SearchSortModel::DESC_LINK, result.descrLink, result.descrLink);
+    setItemData(SearchSortModel::SIZE, Utils::Misc::friendlyUnit(result.fileSize), result.fileSize, (Qt::AlignRight | Qt::AlignVCenter));
+    setItemData(SearchSortModel::SEEDS, QString::number(result.nbSeeders), result.nbSeeders, (Qt::AlignRight | Qt::AlignVCenter));
+    setItemData(SearchSortModel::LEECHES, QString::number(result.nbLeechers), result.nbLeechers, (Qt::AlignRight | Qt::AlignVCenter));
+    setItemData(SearchSortModel::PUB_DATE, QLocale().toString(result.pubDate.toLocalTime(), QLocale::ShortFormat), result.pubDate);
+    return items;
 }
 
 void SearchJobWidget::keyPressEvent(QKeyEvent *event)
@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <QList>
 #include <QWidget>
 
 #include "base/settingvalue.h"
@@ -40,7 +41,9 @@
 
 class QHeaderView;
 class QModelIndex;
+class QStandardItem;
 class QStandardItemModel;
+class QTimer;
 
 class LineEdit;
 class SearchHandler;
@@ -116,6 +119,9 @@ private:
     void searchFinished(bool cancelled);
     void searchFailed(const QString &errorMessage);
     void appendSearchResults(const QList<SearchResult> &results);
+    void addPendingSearchResults();
+    void updateSearchResults(const QList<qsizetype> &indexes);
+    QList<QStandardItem *> createRowItems(const SearchResult &result) const;
     void updateResultsCount();
     void setStatus(Status value);
     void downloadTorrent(const QModelIndex &rowIndex, AddTorrentOption option = AddTorrentOption::Default);
@@ -138,7 +144,11 @@ private:
 
     QString m_id;
     QString m_searchPattern;
+    // Results of the restored search, otherwise they are kept by the search handler
     QList<SearchResult> m_searchResults;
+    // Results which aren't added to the model yet, they are added in batches while the search is ongoing
+    QList<SearchResult> m_pendingResults;
+    QTimer *m_pendingResultsTimer = nullptr;
     Ui::SearchJobWidget *m_ui = nullptr;
     SearchHandler *m_searchHandler = nullptr;
     QStandardItemModel *m_searchListModel = nullptr;
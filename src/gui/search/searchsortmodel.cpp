@@ -29,6 +29,8 @@
 
 #include "searchsortmodel.h"
 
+#include <algorithm>
+
 #include "base/global.h"
 
 SearchSortModel::SearchSortModel(QObject *parent)
@@ -38,6 +40,30 @@ SearchSortModel::SearchSortModel(QObject *parent)
     setFilterRole(UnderlyingDataRole);
 }
 
+void SearchSortModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    for (const QMetaObject::Connection &connection : asConst(m_sourceModelConnections))
+        disconnect(connection);
+    m_sourceModelConnections.clear();
+    clearFilterData();
+
+    // Must be connected before the base class connects to the same signals
+    // so the outdated filter data is dropped before the affected rows are filtered
+    if (sourceModel)
+    {
+        m_sourceModelConnections = {
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &SearchSortModel::invalidateFilterData),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &SearchSortModel::handleSourceRowsInserted),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &SearchSortModel::clearFilterData),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &SearchSortModel::clearFilterData),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &SearchSortModel::clearFilterData),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &SearchSortModel::clearFilterData)
+        };
+    }
+
+    base::setSourceModel(sourceModel);
+}
+
 void SearchSortModel::enableNameFilter(const bool enabled)
 {
     if (m_isNameFilterEnabled == enabled)
@@ -188,41 +214,95 @@ bool SearchSortModel::lessThan(const QModelIndex &left, const QModelIndex &right
 
 bool SearchSortModel::filterAcceptsRow(const int sourceRow, const QModelIndex &sourceParent) const
 {
-    const QAbstractItemModel *const sourceModel = this->sourceModel();
+    const FilterData data = filterData(sourceRow, sourceParent);
 
     if (m_isNameFilterEnabled && !m_searchTerm.isEmpty())
     {
-        const QString name = sourceModel->data(sourceModel->index(sourceRow, NAME, sourceParent), UnderlyingDataRole).toString();
         for (const QString &word : asConst(m_searchTermWords))
         {
-            if (!name.contains(word, Qt::CaseInsensitive))
+            if (!data.name.contains(word, Qt::CaseInsensitive))
                 return false;
         }
     }
 
     if ((m_minSize > 0) || (m_maxSize >= 0))
     {
-        const qlonglong size = sourceModel->data(sourceModel->index(sourceRow, SIZE, sourceParent), UnderlyingDataRole).toLongLong();
-        if (((m_minSize > 0) && (size < m_minSize))
-            || ((m_maxSize > 0) && (size > m_maxSize)))
+        if (((m_minSize > 0) && (data.size < m_minSize))
+            || ((m_maxSize > 0) && (data.size > m_maxSize)))
             return false;
     }
 
     if ((m_minSeeds > 0) || (m_maxSeeds >= 0))
     {
-        const int seeds = sourceModel->data(sourceModel->index(sourceRow, SEEDS, sourceParent), UnderlyingDataRole).toInt();
-        if (((m_minSeeds > 0) && (seeds < m_minSeeds))
-            || ((m_maxSeeds > 0) && (seeds > m_maxSeeds)))
+        if (((m_minSeeds > 0) && (data.seeds < m_minSeeds))
+            || ((m_maxSeeds > 0) && (data.seeds > m_maxSeeds)))
             return false;
     }
 
     if ((m_minLeeches > 0) || (m_maxLeeches >= 0))
     {
-        const int leeches = sourceModel->data(sourceModel->index(sourceRow, LEECHES, sourceParent), UnderlyingDataRole).toInt();
-        if (((m_minLeeches > 0) && (leeches < m_minLeeches))
-            || ((m_maxLeeches > 0) && (leeches > m_maxLeeches)))
+        if (((m_minLeeches > 0) && (data.leeches < m_minLeeches))
+            || ((m_maxLeeches > 0) && (data.leeches > m_maxLeeches)))
             return false;
     }
 
     return base::filterAcceptsRow(sourceRow, sourceParent);
 }
+
+SearchSortModel::FilterData SearchSortModel::filterData(const int sourceRow, const QModelIndex &sourceParent) const
+{
+    const QAbstractItemModel *const sourceModel = this->sourceModel();
+    const auto readFilterData = [sourceModel, sourceRow, &sourceParent]() -> FilterData
+    {
+        const auto columnData = [sourceModel, sourceRow, &sourceParent](const int column)
+        {
+            return sourceModel->data(sourceModel->index(sourceRow, column, sourceParent), UnderlyingDataRole);
+        };
+
+        return {.name = columnData(NAME).toString()
+            , .size = columnData(SIZE).toLongLong()
+            , .seeds = columnData(SEEDS).toInt()
+            , .leeches = columnData(LEECHES).toInt()};
+    };
+
+    if (sourceParent.isValid())
+        return readFilterData();
+
+    if (sourceRow >= m_filterData.size())
+        m_filterData.resize(sourceModel->rowCount());
+
+    std::optional<FilterData> &data = m_filterData[sourceRow];
+    if (!data)
+        data = readFilterData();
+    return *data;
+}
+
+void SearchSortModel::invalidateFilterData(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid())
+    {
+        clearFilterData();
+        return;
+    }
+
+    if (topLeft.parent().isValid())
+        return;
+
+    const int lastRow = std::min<int>(bottomRight.row(), (m_filterData.size() - 1));
+    for (int row = topLeft.row(); row <= lastRow; ++row)
+        m_filterData[row].reset();
+}
+
+void SearchSortModel::handleSourceRowsInserted(const QModelIndex &parent, const int first)
+{
+    // the rows appended to the end don't shift the cached data
+    if (parent.isValid() || (first >= m_filterData.size()))
+        return;
+
+    clearFilterData();
+}
+
+void SearchSortModel::clearFilterData()
+{
+    m_filterData.clear();
+}
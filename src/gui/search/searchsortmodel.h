@@ -29,6 +29,10 @@
 
 #pragma once
 
+#include <optional>
+
+#include <QList>
+#include <QMetaObject>
 #include <QSortFilterProxyModel>
 #include <QStringList>
 
@@ -60,6 +64,8 @@ public:
 
     explicit SearchSortModel(QObject *parent = nullptr);
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
+
     void enableNameFilter(bool enabled);
     void setNameFilter(const QString &searchTerm = {});
 
@@ -93,6 +99,21 @@ protected:
     bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
 
 private:
+    // Values of the filtered columns of the source row, so they aren't queried from the model
+    // each time the filter is changed
+    struct FilterData
+    {
+        QString name;
+        qint64 size = 0;
+        int seeds = 0;
+        int leeches = 0;
+    };
+
+    FilterData filterData(int sourceRow, const QModelIndex &sourceParent) const;
+    void invalidateFilterData(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void handleSourceRowsInserted(const QModelIndex &parent, int first);
+    void clearFilterData();
+
     bool m_isNameFilterEnabled = false;
     QString m_searchTerm;
     QStringList m_searchTermWords;
@@ -101,4 +122,8 @@ private:
     qint64 m_minSize = 0, m_maxSize = -1;
 
     Utils::Compare::NaturalLessThan<Qt::CaseInsensitive> m_naturalLessThan;
+
+    // Filter data of the source rows (only the top level ones are cached)
+    mutable QList<std::optional<FilterData>> m_filterData;
+    QList<QMetaObject::Connection> m_sourceModelConnections;
 };
@@ -29,12 +29,22 @@
 #include "statsdialog.h"
 
 #include <algorithm>
+#include <chrono>
+#include <utility>
 
+#include <QList>
+#include <QStringList>
+
+#include "base/bittorrent/alertstatistics.h"
 #include "base/bittorrent/cachestatus.h"
+#include "base/bittorrent/peerstatistics.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
 #include "base/bittorrent/torrent.h"
 #include "base/global.h"
+#include "base/logger.h"
+#include "base/net/geoipmanager.h"
+#include "base/rss/rss_session.h"
 #include "base/utils/misc.h"
 #include "base/utils/string.h"
 #include "ui_statsdialog.h"
@@ -42,6 +52,17 @@
 
 #define SETTINGS_KEY(name) u"StatisticsDialog/" name
 
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Estimating memory usage requires to walk through all the data, so it isn't updated on every refresh
+    const std::chrono::seconds MEMORY_USAGE_UPDATE_INTERVAL = 10s;
+    // Peer statistics are merged from all the torrents
+    const std::chrono::seconds PEER_STATISTICS_UPDATE_INTERVAL = 5s;
+    const int TOP_PEER_TRAFFIC_COUNT = 3;
+}
+
 StatsDialog::StatsDialog(QWidget *parent)
     : QDialog(parent)
     , m_ui(new Ui::StatsDialog)
@@ -55,11 +76,6 @@ StatsDialog::StatsDialog(QWidget *parent)
     connect(BitTorrent::Session::instance(), &BitTorrent::Session::statsUpdated
             , this, &StatsDialog::update);
 
-#ifdef QBT_USES_LIBTORRENT2
-    m_ui->labelCacheHitsText->hide();
-    m_ui->labelCacheHits->hide();
-#endif
-
     if (const QSize dialogSize = m_storeDialogSize; dialogSize.isValid())
         resize(dialogSize);
 }
@@ -87,13 +103,11 @@ void StatsDialog::update()
                 ((atd > 0) && (atu > 0))
                 ? Utils::String::fromDouble(static_cast<qreal>(atu) / atd, 2)
                 : u"-"_s);
-#ifndef QBT_USES_LIBTORRENT2
     // Cache hits
     const qreal readRatio = cs.readRatio;
     m_ui->labelCacheHits->setText(u"%1%"_s.arg((readRatio > 0)
         ? Utils::String::fromDouble((100 * readRatio), 2)
         : u"0"_s));
-#endif
     // Buffers size
     m_ui->labelTotalBuf->setText(Utils::Misc::friendlyUnit(cs.totalUsedBuffers * 16 * 1024));
     // Disk overload (100%) equivalent
@@ -114,4 +128,71 @@ void StatsDialog::update()
 
     // Total connected peers
     m_ui->labelPeers->setText(QString::number(ss.peersCount));
+
+    // Alert handling
+    const BitTorrent::AlertStatistics &as = BitTorrent::Session::instance()->alertStatistics();
+    m_ui->labelAlertCount->setText(QString::number(as.alertCount));
+    m_ui->labelBatchSize->setText(tr("%1 (max %2)", "12.5 (max 1000)")
+        .arg(((as.batchCount > 0) ? Utils::String::fromDouble((static_cast<qreal>(as.alertCount) / as.batchCount), 1) : u"0"_s)
+            , QString::number(as.maxBatchSize)));
+    m_ui->labelStallTime->setText(tr("%1 ms (max %2 ms)", "0.25 ms (max 18 ms)")
+        .arg(((as.batchCount > 0) ? Utils::String::fromDouble((as.totalStallTime / 1000. / as.batchCount), 2) : u"0"_s)
+            , Utils::String::fromDouble((as.maxStallTime / 1000.), 2)));
+    m_ui->labelDroppedAlerts->setText(QString::number(as.droppedAlertsCount));
+
+    const auto slowestAlertTypeIter = std::ranges::max_element(as.alertTypes, {}, &BitTorrent::AlertTypeStatistics::totalTime);
+    m_ui->labelSlowestAlertType->setText(((slowestAlertTypeIter != as.alertTypes.cend()) && (slowestAlertTypeIter->count > 0))
+        ? tr("%1 (%2 ms in total)", "state_update (1250 ms in total)")
+            .arg(slowestAlertTypeIter->name, Utils::String::fromDouble((slowestAlertTypeIter->totalTime / 1000.), 0))
+        : u"-"_s);
+
+    if (!m_memoryUsageUpdateTimer.isValid() || (m_memoryUsageUpdateTimer.durationElapsed() >= MEMORY_USAGE_UPDATE_INTERVAL))
+    {
+        updateMemoryUsage();
+        m_memoryUsageUpdateTimer.start();
+    }
+
+    if (!m_peerStatisticsUpdateTimer.isValid() || (m_peerStatisticsUpdateTimer.durationElapsed() >= PEER_STATISTICS_UPDATE_INTERVAL))
+    {
+        updatePeerStatistics();
+        m_peerStatisticsUpdateTimer.start();
+    }
+}
+
+void StatsDialog::updateMemoryUsage()
+{
+    const Net::GeoIPManager *geoIPManager = Net::GeoIPManager::instance();
+
+    m_ui->labelMemoryTorrents->setText(Utils::Misc::friendlyUnit(BitTorrent::Session::instance()->estimatedTorrentsMemoryUsage()));
+    m_ui->labelMemoryLog->setText(Utils::Misc::friendlyUnit(Logger::instance()->estimatedMemoryUsage()));
+    m_ui->labelMemoryRSS->setText(Utils::Misc::friendlyUnit(RSS::Session::instance()->estimatedArticlesMemoryUsage()));
+    m_ui->labelMemoryGeoIP->setText(Utils::Misc::friendlyUnit(geoIPManager ? geoIPManager->estimatedMemoryUsage() : 0));
+}
+
+void StatsDialog::updatePeerStatistics()
+{
+    const auto formatTopTraffic = [](const QHash<QString, BitTorrent::PeerTrafficStatistics> &traffic) -> QString
+    {
+        QList<std::pair<QString, qint64>> items;
+        items.reserve(traffic.size());
+        for (auto it = traffic.cbegin(); it != traffic.cend(); ++it)
+            items.emplaceBack(it.key(), (it->downloaded + it->uploaded));
+        std::ranges::sort(items, std::ranges::greater(), &std::pair<QString, qint64>::second);
+
+        QStringList topItems;
+        for (const auto &[name, bytes] : asConst(items))
+        {
+            if ((topItems.size() >= TOP_PEER_TRAFFIC_COUNT) || (bytes <= 0))
+                break;
+
+            topItems.append(tr("%1 (%2)", "qB (1.5 GiB)")
+                .arg((name.isEmpty() ? tr("Unknown") : name), Utils::Misc::friendlyUnit(bytes)));
+        }
+
+        return !topItems.isEmpty() ? topItems.join(u", ") : u"-"_s;
+    };
+
+    const BitTorrent::PeerStatistics peerStatistics = BitTorrent::Session::instance()->peerStatistics();
+    m_ui->labelTopClients->setText(formatTopTraffic(peerStatistics.clients));
+    m_ui->labelTopCountries->setText(formatTopTraffic(peerStatistics.countries));
 }
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <QDialog>
+#include <QElapsedTimer>
 
 #include "base/settingvalue.h"
 
@@ -50,6 +51,11 @@ private slots:
     void update();
 
 private:
+    void updateMemoryUsage();
+    void updatePeerStatistics();
+
     Ui::StatsDialog *m_ui = nullptr;
     SettingValue<QSize> m_storeDialogSize;
+    QElapsedTimer m_memoryUsageUpdateTimer;
+    QElapsedTimer m_peerStatisticsUpdateTimer;
 };
@@ -39,6 +39,7 @@
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
 #include "base/preferences.h"
+#include "base/types.h"
 #include "base/utils/misc.h"
 #include "speedlimitdialog.h"
 #include "uithememanager.h"
@@ -100,6 +101,10 @@ StatusBar::StatusBar(QWidget *parent)
     m_upSpeedLbl->setStyleSheet(u"text-align:left;"_s);
     m_upSpeedLbl->setMinimumWidth(200);
 
+    m_checkingLbl = new QLabel(this);
+    m_checkingLbl->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Preferred);
+    m_checkingSeparator = createSeparator(m_checkingLbl);
+
     m_freeDiskSpaceLbl = new QLabel(tr("Free space: N/A"));
     m_freeDiskSpaceLbl->setSizePolicy(QSizePolicy::Maximum, QSizePolicy::Preferred);
     m_freeDiskSpaceSeparator = createSeparator(m_freeDiskSpaceLbl);
@@ -132,6 +137,9 @@ StatusBar::StatusBar(QWidget *parent)
     m_connecStatusLblIcon->setMaximumWidth(Utils::Gui::largeIconSize().width());
     m_altSpeedsBtn->setMaximumWidth(Utils::Gui::largeIconSize().width());
 
+    layout->addWidget(m_checkingLbl);
+    layout->addWidget(m_checkingSeparator);
+
     layout->addWidget(m_freeDiskSpaceLbl);
     layout->addWidget(m_freeDiskSpaceSeparator);
 
@@ -164,9 +172,16 @@ StatusBar::StatusBar(QWidget *parent)
     m_DHTSeparator->setVisible(isDHTVisible);
     refresh();
     connect(session, &BitTorrent::Session::statsUpdated, this, &StatusBar::refresh);
+    connect(UIThemeManager::instance(), &UIThemeManager::themeChanged, this, [this]
+    {
+        m_connectionStatus = ConnectionStatus::Unknown;
+        updateConnectionStatus();
+    });
 
     updateFreeDiskSpaceLabel(session->freeDiskSpace());
     connect(session, &BitTorrent::Session::freeDiskSpaceChecked, this, &StatusBar::updateFreeDiskSpaceLabel);
+    updateFreeDiskSpaceToolTip(session->storageVolumes());
+    connect(session, &BitTorrent::Session::storageVolumesChecked, this, &StatusBar::updateFreeDiskSpaceToolTip);
 
     connect(Preferences::instance(), &Preferences::changed, this, &StatusBar::optionsSaved);
 }
@@ -194,29 +209,41 @@ void StatusBar::showRestartRequired()
 
 void StatusBar::updateConnectionStatus()
 {
-    const BitTorrent::SessionStatus &sessionStatus = BitTorrent::Session::instance()->status();
+    const auto *session = BitTorrent::Session::instance();
+    const ConnectionStatus connectionStatus = !session->isListening()
+        ? ConnectionStatus::Offline
+        : (session->status().hasIncomingConnections ? ConnectionStatus::Online : ConnectionStatus::Firewalled);
+    // Icon and tooltip are only updated when the status is changed
+    if (connectionStatus == m_connectionStatus)
+        return;
 
-    if (!BitTorrent::Session::instance()->isListening())
-    {
-        m_connecStatusLblIcon->setIcon(UIThemeManager::instance()->getIcon(u"disconnected"_s));
-        const QString tooltip = u"<b>%1</b><br>%2"_s.arg(tr("Connection Status:"), tr("Offline. This usually means that qBittorrent failed to listen on the selected port for incoming connections."));
-        m_connecStatusLblIcon->setToolTip(tooltip);
-    }
-    else
+    m_connectionStatus = connectionStatus;
+
+    switch (connectionStatus)
     {
-        if (sessionStatus.hasIncomingConnections)
+    case ConnectionStatus::Offline:
+        {
+            m_connecStatusLblIcon->setIcon(UIThemeManager::instance()->getIcon(u"disconnected"_s));
+            const QString tooltip = u"<b>%1</b><br>%2"_s.arg(tr("Connection Status:"), tr("Offline. This usually means that qBittorrent failed to listen on the selected port for incoming connections."));
+            m_connecStatusLblIcon->setToolTip(tooltip);
+        }
+        break;
+    case ConnectionStatus::Online:
         {
             // Connection OK
             m_connecStatusLblIcon->setIcon(UIThemeManager::instance()->getIcon(u"connected"_s));
             const QString tooltip = u"<b>%1</b><br>%2"_s.arg(tr("Connection Status:"), tr("Online"));
             m_connecStatusLblIcon->setToolTip(tooltip);
         }
-        else
+        break;
+    case ConnectionStatus::Firewalled:
+    case ConnectionStatus::Unknown:
         {
             m_connecStatusLblIcon->setIcon(UIThemeManager::instance()->getIcon(u"firewalled"_s));
             const QString tooltip = u"<b>%1</b><br><i>%2</i>"_s.arg(tr("Connection Status:"), tr("No direct connections. This may indicate network configuration problems."));
             m_connecStatusLblIcon->setToolTip(tooltip);
         }
+        break;
     }
 }
 
@@ -235,11 +262,40 @@ void StatusBar::updateDHTNodesNumber()
     }
 }
 
+void StatusBar::updateCheckingLabel()
+{
+    const BitTorrent::SessionStatus &sessionStatus = BitTorrent::Session::instance()->status();
+    const bool isVisible = (sessionStatus.checkingTorrentsCount > 0);
+    m_checkingLbl->setVisible(isVisible);
+    m_checkingSeparator->setVisible(isVisible);
+    if (!isVisible)
+        return;
+
+    m_checkingLbl->setText(tr("Checking: %1, ETA: %2", "Checking: 200 MiB/s, ETA: 5m")
+        .arg(Utils::Misc::friendlyUnit(sessionStatus.checkingRate, true)
+            , Utils::Misc::userFriendlyDuration(sessionStatus.checkingETA, MAX_ETA)));
+    m_checkingLbl->setToolTip(tr("%n torrent(s) being checked, %1 left to check", "", sessionStatus.checkingTorrentsCount)
+        .arg(Utils::Misc::friendlyUnit(sessionStatus.checkingRemaining)));
+}
+
 void StatusBar::updateFreeDiskSpaceLabel(const qint64 value)
 {
     m_freeDiskSpaceLbl->setText(tr("Free space: ") + Utils::Misc::friendlyUnit(value));
 }
 
+void StatusBar::updateFreeDiskSpaceToolTip(const QList<BitTorrent::StorageVolumeInfo> &volumes)
+{
+    QStringList lines;
+    lines.reserve(volumes.size());
+    for (const BitTorrent::StorageVolumeInfo &volume : volumes)
+    {
+        const QString line = tr("%1: %2 (%n torrent(s))", "/dev/sda1: 10 GiB (5 torrents)", volume.torrentCount)
+            .arg(volume.device, Utils::Misc::friendlyUnit(volume.freeSpace));
+        lines.append(volume.isLowOnSpace ? (u"<b>" + line.toHtmlEscaped() + u"</b>") : line.toHtmlEscaped());
+    }
+    m_freeDiskSpaceLbl->setToolTip(lines.join(u"<br>"));
+}
+
 void StatusBar::updateFreeDiskSpaceVisibility()
 {
     const bool isVisible = Preferences::instance()->isStatusbarFreeDiskSpaceDisplayed();
@@ -294,6 +350,7 @@ void StatusBar::refresh()
 {
     updateConnectionStatus();
     updateDHTNodesNumber();
+    updateCheckingLabel();
     updateExternalAddressesLabel();
     updateSpeedLabels();
 }
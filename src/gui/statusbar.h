@@ -36,6 +36,7 @@ class QPushButton;
 namespace BitTorrent
 {
     struct SessionStatus;
+    struct StorageVolumeInfo;
 }
 
 class StatusBar final : public QStatusBar
@@ -61,9 +62,19 @@ private slots:
     void optionsSaved();
 
 private:
+    enum class ConnectionStatus
+    {
+        Unknown,
+        Offline,
+        Online,
+        Firewalled
+    };
+
     void updateConnectionStatus();
     void updateDHTNodesNumber();
+    void updateCheckingLabel();
     void updateFreeDiskSpaceLabel(qint64 value);
+    void updateFreeDiskSpaceToolTip(const QList<BitTorrent::StorageVolumeInfo> &volumes);
     void updateFreeDiskSpaceVisibility();
     void updateExternalAddressesLabel();
     void updateExternalAddressesVisibility();
@@ -71,6 +82,8 @@ private:
 
     QPushButton *m_dlSpeedLbl = nullptr;
     QPushButton *m_upSpeedLbl = nullptr;
+    QLabel *m_checkingLbl = nullptr;
+    QWidget *m_checkingSeparator = nullptr;
     QLabel *m_freeDiskSpaceLbl = nullptr;
     QWidget *m_freeDiskSpaceSeparator = nullptr;
     QLabel *m_lastExternalIPsLbl = nullptr;
@@ -79,4 +92,6 @@ private:
     QWidget *m_DHTSeparator = nullptr;
     QPushButton *m_connecStatusLblIcon = nullptr;
     QPushButton *m_altSpeedsBtn = nullptr;
+
+    ConnectionStatus m_connectionStatus = ConnectionStatus::Unknown;
 };
@@ -148,6 +148,9 @@ BitTorrent::CategoryOptions TorrentCategoryDialog::categoryOptions() const
         categoryOptions.downloadPath = {true, m_ui->comboDownloadPath->selectedPath()};
     else if (m_ui->comboUseDownloadPath->currentIndex() == 2)
         categoryOptions.downloadPath = {false, {}};
+    categoryOptions.downloadLimit = m_ui->spinDownloadLimit->value() * 1024;
+    categoryOptions.uploadLimit = m_ui->spinUploadLimit->value() * 1024;
+    categoryOptions.connectionsLimit = m_ui->spinConnectionsLimit->value();
 
     return categoryOptions;
 }
@@ -165,6 +168,10 @@ void TorrentCategoryDialog::setCategoryOptions(const BitTorrent::CategoryOptions
         m_ui->comboUseDownloadPath->setCurrentIndex(0);
         m_ui->comboDownloadPath->setSelectedPath({});
     }
+
+    m_ui->spinDownloadLimit->setValue(categoryOptions.downloadLimit / 1024);
+    m_ui->spinUploadLimit->setValue(categoryOptions.uploadLimit / 1024);
+    m_ui->spinConnectionsLimit->setValue(categoryOptions.connectionsLimit);
 }
 
 void TorrentCategoryDialog::categoryNameChanged(const QString &categoryName)
@@ -113,26 +113,7 @@ bool TorrentContentFilterModel::lessThan(const QModelIndex &left, const QModelIn
 bool TorrentContentFilterModel::hasFiltered(const QModelIndex &folder) const
 {
     // this should be called only with folders
-    // check if the folder name itself matches the filter string
-    QString name = folder.data().toString();
-    if (name.contains(filterRegularExpression()))
-        return true;
-
-    for (int child = 0; child < m_model->rowCount(folder); ++child)
-    {
-        QModelIndex childIndex = m_model->index(child, 0, folder);
-        if (m_model->hasChildren(childIndex))
-        {
-            if (hasFiltered(childIndex))
-                return true;
-
-            continue;
-        }
-
-        name = childIndex.data().toString();
-        if (name.contains(filterRegularExpression()))
-            return true;
-    }
-
-    return false;
+    // check if the folder name itself or any of its descendants matches the filter string,
+    // folder children can be not fetched yet so they are checked by the model directly
+    return m_model->hasMatchingItem(folder, filterRegularExpression());
 }
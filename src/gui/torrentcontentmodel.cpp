@@ -30,6 +30,7 @@
 #include "torrentcontentmodel.h"
 
 #include <algorithm>
+#include <memory>
 
 #include <QFileIconProvider>
 #include <QFileInfo>
@@ -37,7 +38,10 @@
 #include <QIcon>
 #include <QMimeData>
 #include <QPointer>
+#include <QPromise>
+#include <QRegularExpression>
 #include <QScopeGuard>
+#include <QThreadPool>
 #include <QUrl>
 
 #if defined(Q_OS_MACOS)
@@ -65,6 +69,15 @@
 
 namespace
 {
+    // Content trees of torrents with more files are built in background
+    const int ASYNC_POPULATE_MIN_FILES_COUNT = 10'000;
+
+    QList<QString> headerLabels()
+    {
+        return {TorrentContentModel::tr("Name"), TorrentContentModel::tr("Total Size"), TorrentContentModel::tr("Progress")
+            , TorrentContentModel::tr("Download Priority"), TorrentContentModel::tr("Remaining"), TorrentContentModel::tr("Availability")};
+    }
+
     class UnifiedFileIconProvider : public QFileIconProvider
     {
     public:
@@ -162,11 +175,25 @@ namespace
         }
     };
 #endif // Q_OS_WIN
+
+    bool hasMatchingName(const TorrentContentModelFolder *folder, const QRegularExpression &regex)
+    {
+        if (folder->name().contains(regex))
+            return true;
+
+        return std::ranges::any_of(folder->children(), [&regex](const TorrentContentModelItem *child)
+        {
+            if (child->itemType() == TorrentContentModelItem::FolderType)
+                return hasMatchingName(static_cast<const TorrentContentModelFolder *>(child), regex);
+
+            return child->name().contains(regex);
+        });
+    }
 }
 
 TorrentContentModel::TorrentContentModel(QObject *parent)
     : QAbstractItemModel(parent)
-    , m_rootItem(new TorrentContentModelFolder(QList<QString>({ tr("Name"), tr("Total Size"), tr("Progress"), tr("Download Priority"), tr("Remaining"), tr("Availability") })))
+    , m_rootItem(new TorrentContentModelFolder(headerLabels()))
 #if defined(Q_OS_WIN)
     , m_fileIconProvider {new QFileIconProvider}
 #elif defined(Q_OS_MACOS)
@@ -194,14 +221,12 @@ void TorrentContentModel::updateFilesProgress()
     if (m_filesIndex.size() != filesProgress.size()) [[unlikely]]
         return;
 
+    // Folders progress in the tree is updated incrementally by the changed files
     for (qsizetype i = 0; i < filesProgress.size(); ++i)
         m_filesIndex[i]->setProgress(filesProgress[i]);
-    // Update folders progress in the tree
-    m_rootItem->recalculateProgress();
-    m_rootItem->recalculateAvailability();
 }
 
-void TorrentContentModel::updateFilesPriorities()
+bool TorrentContentModel::updateFilesPriorities()
 {
     Q_ASSERT(m_contentHandler && m_contentHandler->hasMetadata());
 
@@ -209,10 +234,25 @@ void TorrentContentModel::updateFilesPriorities()
     Q_ASSERT(m_filesIndex.size() == fprio.size());
     // XXX: Why is this necessary?
     if (m_filesIndex.size() != fprio.size())
-        return;
+        return false;
 
+    bool isChanged = false;
     for (qsizetype i = 0; i < fprio.size(); ++i)
-        m_filesIndex[i]->setPriority(static_cast<BitTorrent::DownloadPriority>(fprio[i]));
+    {
+        TorrentContentModelFile *file = m_filesIndex[i];
+        if (file->priority() == fprio[i])
+            continue;
+
+        // Updating the parents for each changed file is quadratic in folder size,
+        // so folders priorities are recalculated at once afterwards
+        file->setPriority(fprio[i], false);
+        isChanged = true;
+    }
+
+    if (isChanged)
+        m_rootItem->recalculatePriority();
+
+    return isChanged;
 }
 
 void TorrentContentModel::updateFilesAvailability()
@@ -226,13 +266,18 @@ void TorrentContentModel::updateFilesAvailability()
         if (!m_contentHandler || (m_contentHandler != handler))
             return;
 
+        // Folders availability in the tree is updated incrementally by the changed files
         for (qsizetype i = 0; i < m_filesIndex.size(); ++i)
             m_filesIndex[i]->setAvailability(availableFileFractions.value(i, 0));
-        // Update folders progress in the tree
-        m_rootItem->recalculateProgress();
     });
 }
 
+void TorrentContentModel::recalculateFolders()
+{
+    m_rootItem->recalculateProgress();
+    m_rootItem->recalculateAvailability();
+}
+
 bool TorrentContentModel::setItemPriority(const QModelIndex &index, BitTorrent::DownloadPriority priority)
 {
     Q_ASSERT(index.isValid());
@@ -246,8 +291,7 @@ bool TorrentContentModel::setItemPriority(const QModelIndex &index, BitTorrent::
     m_contentHandler->prioritizeFiles(getFilePriorities());
 
     // Update folders progress in the tree
-    m_rootItem->recalculateProgress();
-    m_rootItem->recalculateAvailability();
+    recalculateFolders();
 
     const QList<ColumnInterval> columns =
     {
@@ -370,6 +414,13 @@ Path TorrentContentModel::getItemPath(const QModelIndex &index) const
     return path;
 }
 
+bool TorrentContentModel::hasMatchingItem(const QModelIndex &folderIndex, const QRegularExpression &regex) const
+{
+    // Not yet fetched items are checked as well so that folders can be filtered before they are expanded
+    const TorrentContentModelFolder *folder = folderItem(folderIndex);
+    return folder && hasMatchingName(folder, regex);
+}
+
 QVariant TorrentContentModel::data(const QModelIndex &index, const int role) const
 {
     if (!index.isValid())
@@ -485,7 +536,7 @@ QModelIndex TorrentContentModel::index(const int row, const int column, const QM
         : m_rootItem;
     Q_ASSERT(parentItem);
 
-    if (row >= parentItem->childCount())
+    if (!parentItem->areChildrenFetched() || (row >= parentItem->childCount()))
         return {};
 
     TorrentContentModelItem *childItem = parentItem->child(row);
@@ -517,10 +568,40 @@ QModelIndex TorrentContentModel::parent(const QModelIndex &index) const
 
 int TorrentContentModel::rowCount(const QModelIndex &parent) const
 {
-    const TorrentContentModelFolder *parentItem = parent.isValid()
-        ? dynamic_cast<TorrentContentModelFolder *>(static_cast<TorrentContentModelItem *>(parent.internalPointer()))
+    const TorrentContentModelFolder *parentItem = folderItem(parent);
+    return (parentItem && parentItem->areChildrenFetched()) ? parentItem->childCount() : 0;
+}
+
+bool TorrentContentModel::hasChildren(const QModelIndex &parent) const
+{
+    const TorrentContentModelFolder *parentItem = folderItem(parent);
+    return parentItem && (parentItem->childCount() > 0);
+}
+
+bool TorrentContentModel::canFetchMore(const QModelIndex &parent) const
+{
+    const TorrentContentModelFolder *parentItem = folderItem(parent);
+    return parentItem && !parentItem->areChildrenFetched() && (parentItem->childCount() > 0);
+}
+
+void TorrentContentModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+        return;
+
+    // Folder items are kept up to date regardless of whether they are fetched,
+    // so the fetched children are exposed to the views as is
+    TorrentContentModelFolder *parentItem = folderItem(parent);
+    beginInsertRows(parent, 0, (parentItem->childCount() - 1));
+    parentItem->setChildrenFetched();
+    endInsertRows();
+}
+
+TorrentContentModelFolder *TorrentContentModel::folderItem(const QModelIndex &index) const
+{
+    return index.isValid()
+        ? dynamic_cast<TorrentContentModelFolder *>(static_cast<TorrentContentModelItem *>(index.internalPointer()))
         : m_rootItem;
-    return parentItem ? parentItem->childCount() : 0;
 }
 
 QMimeData *TorrentContentModel::mimeData(const QModelIndexList &indexes) const
@@ -564,20 +645,22 @@ QStringList TorrentContentModel::mimeTypes() const
     return {u"text/uri-list"_s};
 }
 
-void TorrentContentModel::populate()
+TorrentContentModel::ContentTree TorrentContentModel::buildContentTree(const PathList &filePaths, const QList<qint64> &fileSizes)
 {
-    Q_ASSERT(m_contentHandler && m_contentHandler->hasMetadata());
+    Q_ASSERT(filePaths.size() == fileSizes.size());
 
-    const int filesCount = m_contentHandler->filesCount();
-    m_filesIndex.reserve(filesCount);
+    ContentTree contentTree;
+    contentTree.rootItem = std::make_unique<TorrentContentModelFolder>(headerLabels());
+    contentTree.filesIndex.reserve(filePaths.size());
 
+    TorrentContentModelFolder *rootItem = contentTree.rootItem.get();
     QHash<TorrentContentModelFolder *, QHash<QString, TorrentContentModelFolder *>> folderMap;
     QList<QString> lastParentPath;
-    TorrentContentModelFolder *lastParent = m_rootItem;
+    TorrentContentModelFolder *lastParent = rootItem;
     // Iterate over files
-    for (int i = 0; i < filesCount; ++i)
+    for (int i = 0; i < filePaths.size(); ++i)
     {
-        const QString path = m_contentHandler->filePath(i).data();
+        const QString path = filePaths[i].data();
 
         // Iterate of parts of the path to create necessary folders
         QList<QStringView> pathFolders = QStringView(path).split(u'/', Qt::SkipEmptyParts);
@@ -589,7 +672,7 @@ void TorrentContentModel::populate()
             lastParentPath.reserve(pathFolders.size());
 
             // rebuild the path from the root
-            lastParent = m_rootItem;
+            lastParent = rootItem;
             for (const QStringView pathPart : asConst(pathFolders))
             {
                 const QString folderName = pathPart.toString();
@@ -607,13 +690,77 @@ void TorrentContentModel::populate()
         }
 
         // Actually create the file
-        auto *fileItem = new TorrentContentModelFile(fileName, m_contentHandler->fileSize(i), lastParent, i);
+        auto *fileItem = new TorrentContentModelFile(fileName, fileSizes[i], lastParent, i);
         lastParent->appendChild(fileItem);
-        m_filesIndex.push_back(fileItem);
+        contentTree.filesIndex.push_back(fileItem);
     }
 
-    updateFilesProgress();
+    return contentTree;
+}
+
+void TorrentContentModel::populate()
+{
+    Q_ASSERT(m_contentHandler && m_contentHandler->hasMetadata());
+
+    const int filesCount = m_contentHandler->filesCount();
+    PathList filePaths;
+    filePaths.reserve(filesCount);
+    QList<qint64> fileSizes;
+    fileSizes.reserve(filesCount);
+    for (int i = 0; i < filesCount; ++i)
+    {
+        filePaths.append(m_contentHandler->filePath(i));
+        fileSizes.append(m_contentHandler->fileSize(i));
+    }
+
+    if (filesCount < ASYNC_POPULATE_MIN_FILES_COUNT)
+    {
+        applyContentTree(buildContentTree(filePaths, fileSizes));
+        return;
+    }
+
+    // Building the tree of a huge torrent takes noticeable time so the model stays empty
+    // until it is built in background, then it is reset with the built tree
+    m_isPopulating = true;
+
+    auto promise = std::make_shared<QPromise<ContentTree>>();
+    promise->start();
+    promise->future().then(this, [this, populateID = m_populateID](QFuture<ContentTree> future)
+    {
+        // Content handler is changed or reset while the tree was being built
+        if (populateID != m_populateID)
+            return;
+
+        beginResetModel();
+        applyContentTree(future.takeResult());
+        m_isPopulating = false;
+        endResetModel();
+    });
+
+    QThreadPool::globalInstance()->start([promise, filePaths = std::move(filePaths), fileSizes = std::move(fileSizes)]
+    {
+        promise->addResult(buildContentTree(filePaths, fileSizes));
+        promise->finish();
+    });
+}
+
+void TorrentContentModel::applyContentTree(ContentTree contentTree)
+{
+    Q_ASSERT(m_contentHandler && m_contentHandler->hasMetadata());
+    Q_ASSERT(contentTree.rootItem);
+
+    delete m_rootItem;
+    m_rootItem = contentTree.rootItem.release();
+    m_filesIndex = std::move(contentTree.filesIndex);
+
+    // Set initial values without propagating them up the tree file by file
+    // and calculate the folders values at once
     updateFilesPriorities();
+    const QList<qreal> filesProgress = m_contentHandler->filesProgress();
+    for (qsizetype i = 0; i < std::min(filesProgress.size(), m_filesIndex.size()); ++i)
+        m_filesIndex[i]->setProgress(filesProgress[i], false);
+    recalculateFolders();
+
     updateFilesAvailability();
 }
 
@@ -629,6 +776,9 @@ void TorrentContentModel::setContentHandler(BitTorrent::TorrentContentHandler *c
     }
 
     m_contentHandler = contentHandler;
+    // Discard the content tree that is being built for the previous content handler
+    ++m_populateID;
+    m_isPopulating = false;
 
     if (m_contentHandler && m_contentHandler->hasMetadata())
         populate();
@@ -641,13 +791,16 @@ BitTorrent::TorrentContentHandler *TorrentContentModel::contentHandler() const
 
 void TorrentContentModel::refresh()
 {
-    if (!m_contentHandler || !m_contentHandler->hasMetadata())
+    if (!m_contentHandler || !m_contentHandler->hasMetadata() || m_isPopulating)
         return;
 
     if (!m_filesIndex.isEmpty())
     {
+        // Changed priorities affect all the folders values so they are recalculated
+        // before the files progress is applied incrementally
+        if (updateFilesPriorities())
+            recalculateFolders();
         updateFilesProgress();
-        updateFilesPriorities();
         updateFilesAvailability();
 
         const QList<ColumnInterval> columns =
@@ -686,10 +839,10 @@ void TorrentContentModel::notifySubtreeUpdated(const QModelIndex &index, const Q
         parentIndex = parent(parentIndex);
     }
 
-    // propagate down the model
+    // propagate down the model, only fetched items are known by the views
     QList<QModelIndex> parentIndexes;
 
-    if (hasChildren(index))
+    if (rowCount(index) > 0)
         parentIndexes.push_back(index);
 
     while (!parentIndexes.isEmpty())
@@ -712,7 +865,7 @@ void TorrentContentModel::notifySubtreeUpdated(const QModelIndex &index, const Q
         for (int i = 0; i < childCount; ++i)
         {
             const QModelIndex sibling = child.siblingAtRow(i);
-            if (hasChildren(sibling))
+            if (rowCount(sibling) > 0)
                 parentIndexes.push_back(sibling);
         }
     }
@@ -29,6 +29,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include <QAbstractItemModel>
 #include <QList>
 
@@ -39,6 +41,7 @@
 class QFileIconProvider;
 class QMimeData;
 class QModelIndex;
+class QRegularExpression;
 class QVariant;
 
 class TorrentContentModelFile;
@@ -71,6 +74,7 @@ public:
     TorrentContentModelItem::ItemType itemType(const QModelIndex &index) const;
     int getFileIndex(const QModelIndex &index) const;
     Path getItemPath(const QModelIndex &index) const;
+    bool hasMatchingItem(const QModelIndex &folderIndex, const QRegularExpression &regex) const;
 
     int columnCount(const QModelIndex &parent = {}) const override;
     bool setData(const QModelIndex &index, const QVariant &value, int role = Qt::EditRole) override;
@@ -80,6 +84,9 @@ public:
     QModelIndex index(int row, int column, const QModelIndex &parent = {}) const override;
     QModelIndex parent(const QModelIndex &index) const override;
     int rowCount(const QModelIndex &parent = {}) const override;
+    bool hasChildren(const QModelIndex &parent = {}) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
 
 signals:
     void renameFailed(const QString &errorMessage);
@@ -87,12 +94,23 @@ signals:
 private:
     using ColumnInterval = IndexInterval<int>;
 
+    struct ContentTree
+    {
+        std::unique_ptr<TorrentContentModelFolder> rootItem;
+        QList<TorrentContentModelFile *> filesIndex;
+    };
+
+    static ContentTree buildContentTree(const PathList &filePaths, const QList<qint64> &fileSizes);
+
     QMimeData *mimeData(const QModelIndexList &indexes) const override;
     QStringList mimeTypes() const override;
     void populate();
+    void applyContentTree(ContentTree contentTree);
+    TorrentContentModelFolder *folderItem(const QModelIndex &index) const;
     void updateFilesProgress();
-    void updateFilesPriorities();
+    bool updateFilesPriorities();
     void updateFilesAvailability();
+    void recalculateFolders();
     bool setItemPriority(const QModelIndex &index, BitTorrent::DownloadPriority priority);
     void notifySubtreeUpdated(const QModelIndex &index, const QList<ColumnInterval> &columns);
 
@@ -100,4 +118,7 @@ private:
     TorrentContentModelFolder *m_rootItem = nullptr;
     QList<TorrentContentModelFile *> m_filesIndex;
     QFileIconProvider *m_fileIconProvider = nullptr;
+    // Content tree of huge torrent is being built in background
+    bool m_isPopulating = false;
+    quint64 m_populateID = 0;
 };
@@ -60,17 +60,39 @@ void TorrentContentModelFile::setPriority(BitTorrent::DownloadPriority newPriori
         m_parentItem->updatePriority();
 }
 
-void TorrentContentModelFile::setProgress(qreal progress)
+void TorrentContentModelFile::setProgress(const qreal progress, const bool updateParent)
 {
+    if (m_progress == progress)
+        return;
+
+    const qreal oldProgress = this->progress();
+    const qulonglong oldRemaining = m_remaining;
+
     m_progress = progress;
     m_remaining = static_cast<qulonglong>(m_size * (1.0 - m_progress));
     Q_ASSERT(m_progress <= 1.);
+
+    // Ignored files aren't taken into account by the parent
+    if (updateParent && (m_priority != BitTorrent::DownloadPriority::Ignored))
+    {
+        m_parentItem->handleChildProgressChanged(((this->progress() - oldProgress) * m_size)
+                , (static_cast<qint64>(m_remaining) - static_cast<qint64>(oldRemaining)));
+    }
 }
 
-void TorrentContentModelFile::setAvailability(const qreal availability)
+void TorrentContentModelFile::setAvailability(const qreal availability, const bool updateParent)
 {
+    if (m_availability == availability)
+        return;
+
+    const qreal oldAvailability = this->availability();
+
     m_availability = availability;
     Q_ASSERT(m_availability <= 1.);
+
+    // Ignored files aren't taken into account by the parent
+    if (updateParent && (m_priority != BitTorrent::DownloadPriority::Ignored))
+        m_parentItem->handleChildAvailabilityChanged(oldAvailability, this->availability(), m_size);
 }
 
 TorrentContentModelItem::ItemType TorrentContentModelFile::itemType() const
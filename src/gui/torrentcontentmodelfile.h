@@ -43,8 +43,8 @@ public:
 
     int fileIndex() const;
     void setPriority(BitTorrent::DownloadPriority newPriority, bool updateParent = true) override;
-    void setProgress(qreal progress);
-    void setAvailability(qreal availability);
+    void setProgress(qreal progress, bool updateParent = true);
+    void setAvailability(qreal availability, bool updateParent = true);
     ItemType itemType() const override;
 
 private:
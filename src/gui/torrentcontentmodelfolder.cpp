@@ -28,6 +28,8 @@
 
 #include "torrentcontentmodelfolder.h"
 
+#include <algorithm>
+
 #include <QVariant>
 
 #include "base/global.h"
@@ -61,6 +63,11 @@ void TorrentContentModelFolder::deleteAllChildren()
     Q_ASSERT(isRootItem());
     qDeleteAll(m_childItems);
     m_childItems.clear();
+
+    m_wantedSize = 0;
+    m_weightedProgress = 0;
+    m_weightedAvailability = 0;
+    m_availableChildrenCount = 0;
 }
 
 const QList<TorrentContentModelItem *> &TorrentContentModelFolder::children() const
@@ -86,6 +93,37 @@ int TorrentContentModelFolder::childCount() const
     return m_childItems.count();
 }
 
+bool TorrentContentModelFolder::areChildrenFetched() const
+{
+    return isRootItem() || m_areChildrenFetched;
+}
+
+void TorrentContentModelFolder::setChildrenFetched()
+{
+    m_areChildrenFetched = true;
+}
+
+// Calculates priorities of all the subfolders at once, bottom-up,
+// it is used instead of updatePriority() when priorities of many files are changed
+void TorrentContentModelFolder::recalculatePriority()
+{
+    for (TorrentContentModelItem *child : asConst(m_childItems))
+    {
+        if (child->itemType() == FolderType)
+            static_cast<TorrentContentModelFolder *>(child)->recalculatePriority();
+    }
+
+    if (isRootItem())
+        return;
+
+    Q_ASSERT(!m_childItems.isEmpty());
+
+    const BitTorrent::DownloadPriority prio = m_childItems.constFirst()->priority();
+    const bool isSamePriority = std::all_of((m_childItems.cbegin() + 1), m_childItems.cend()
+            , [prio](const TorrentContentModelItem *child) { return (child->priority() == prio); });
+    m_priority = isSamePriority ? prio : BitTorrent::DownloadPriority::Mixed;
+}
+
 // Only non-root folders use this function
 void TorrentContentModelFolder::updatePriority()
 {
@@ -147,6 +185,9 @@ void TorrentContentModelFolder::recalculateProgress()
         tRemaining += child->remaining();
     }
 
+    m_wantedSize = tSize;
+    m_weightedProgress = tProgress;
+
     if (!isRootItem())
     {
         if (tSize > 0)
@@ -168,7 +209,7 @@ void TorrentContentModelFolder::recalculateAvailability()
 {
     qreal tAvailability = 0;
     qulonglong tSize = 0;
-    bool foundAnyData = false;
+    int availableChildrenCount = 0;
     for (TorrentContentModelItem *child : asConst(m_childItems))
     {
         if (child->priority() == BitTorrent::DownloadPriority::Ignored)
@@ -180,12 +221,16 @@ void TorrentContentModelFolder::recalculateAvailability()
         if (childAvailability >= 0)
         { // -1 means "no data"
             tAvailability += childAvailability * child->size();
-            foundAnyData = true;
+            ++availableChildrenCount;
         }
         tSize += child->size();
     }
 
-    if (!isRootItem() && (tSize > 0) && foundAnyData)
+    m_wantedSize = tSize;
+    m_weightedAvailability = tAvailability;
+    m_availableChildrenCount = availableChildrenCount;
+
+    if (!isRootItem() && (tSize > 0) && (availableChildrenCount > 0))
     {
         m_availability = tAvailability / tSize;
         Q_ASSERT(m_availability <= 1.);
@@ -204,3 +249,43 @@ void TorrentContentModelFolder::increaseSize(qulonglong delta)
     m_size += delta;
     m_parentItem->increaseSize(delta);
 }
+
+void TorrentContentModelFolder::handleChildProgressChanged(const qreal weightedProgressDelta, const qint64 remainingDelta)
+{
+    m_weightedProgress += weightedProgressDelta;
+    m_remaining = static_cast<qulonglong>(static_cast<qint64>(m_remaining) + remainingDelta);
+
+    if (isRootItem())
+        return;
+
+    const qreal oldProgress = progress();
+    m_progress = (m_wantedSize > 0) ? std::clamp((m_weightedProgress / m_wantedSize), 0.0, 1.0) : 1.0;
+
+    m_parentItem->handleChildProgressChanged(((progress() - oldProgress) * m_size), remainingDelta);
+}
+
+void TorrentContentModelFolder::handleChildAvailabilityChanged(const qreal oldAvailability, const qreal newAvailability
+        , const qulonglong childSize)
+{
+    // -1 means "no data"
+    if (oldAvailability >= 0)
+    {
+        m_weightedAvailability -= oldAvailability * childSize;
+        --m_availableChildrenCount;
+    }
+    if (newAvailability >= 0)
+    {
+        m_weightedAvailability += newAvailability * childSize;
+        ++m_availableChildrenCount;
+    }
+
+    if (isRootItem())
+        return;
+
+    const qreal oldOwnAvailability = availability();
+    m_availability = ((m_wantedSize > 0) && (m_availableChildrenCount > 0))
+        ? std::clamp((m_weightedAvailability / m_wantedSize), 0.0, 1.0)
+        : -1.;
+
+    m_parentItem->handleChildAvailabilityChanged(oldOwnAvailability, availability(), m_size);
+}
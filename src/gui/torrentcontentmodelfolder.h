@@ -51,8 +51,13 @@ public:
     void increaseSize(qulonglong delta);
     void recalculateProgress();
     void recalculateAvailability();
+    void recalculatePriority();
     void updatePriority();
 
+    // Incrementally update own values when values of not ignored child are changed
+    void handleChildProgressChanged(qreal weightedProgressDelta, qint64 remainingDelta);
+    void handleChildAvailabilityChanged(qreal oldAvailability, qreal newAvailability, qulonglong childSize);
+
     void setPriority(BitTorrent::DownloadPriority newPriority, bool updateParent = true) override;
 
     void deleteAllChildren();
@@ -61,6 +66,17 @@ public:
     TorrentContentModelItem *child(int row) const;
     int childCount() const;
 
+    // Children of non-root folders are exposed to the model only when they are fetched,
+    // i.e. when the folder is expanded for the first time
+    bool areChildrenFetched() const;
+    void setChildrenFetched();
+
 private:
     QList<TorrentContentModelItem *> m_childItems;
+    bool m_areChildrenFetched = false;
+    // Aggregated values of not ignored children
+    qulonglong m_wantedSize = 0;
+    qreal m_weightedProgress = 0;
+    qreal m_weightedAvailability = 0;
+    int m_availableChildrenCount = 0;
 };
@@ -534,8 +534,14 @@ void TorrentContentWidget::onItemDoubleClicked(const QModelIndex &index)
 void TorrentContentWidget::expandRecursively()
 {
     QModelIndex currentIndex;
-    while (model()->rowCount(currentIndex) == 1)
+    while (true)
     {
+        // Folder children are populated lazily by the model
+        if (model()->canFetchMore(currentIndex))
+            model()->fetchMore(currentIndex);
+        if (model()->rowCount(currentIndex) != 1)
+            break;
+
         currentIndex = model()->index(0, 0, currentIndex);
         setExpanded(currentIndex, true);
     }
@@ -274,7 +274,8 @@ void TorrentCreatorDialog::handleCreationSuccess(const BitTorrent::TorrentCreato
         {
             BitTorrent::AddTorrentParams params;
             params.savePath = result.savePath;
-            params.skipChecking = true;
+            // the content was hashed just now, it is checked again only if it was modified since then
+            params.isContentVerified = BitTorrent::TorrentCreator::isContentUnchanged(result);
             if (m_ui->checkIgnoreShareLimits->isChecked())
             {
                 params.ratioLimit = BitTorrent::Torrent::NO_RATIO_LIMIT;
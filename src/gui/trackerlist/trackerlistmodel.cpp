@@ -31,6 +31,7 @@
 
 #include <algorithm>
 #include <chrono>
+#include <tuple>
 
 #include <boost/multi_index_container.hpp>
 #include <boost/multi_index/composite_key.hpp>
@@ -46,7 +47,6 @@
 #include <QList>
 #include <QPointer>
 #include <QScopeGuard>
-#include <QTimer>
 
 #include "base/bittorrent/announcetimepoint.h"
 #include "base/bittorrent/peerinfo.h"
@@ -56,18 +56,21 @@
 #include "base/global.h"
 #include "base/utils/misc.h"
 
-using namespace std::chrono_literals;
 using namespace boost::multi_index;
 
 namespace
 {
-    const std::chrono::milliseconds ANNOUNCE_TIME_REFRESH_INTERVAL = 4s;
-
     const char STR_WORKING[] = QT_TRANSLATE_NOOP("TrackerListModel", "Working");
     const char STR_DISABLED[] = QT_TRANSLATE_NOOP("TrackerListModel", "Disabled");
     const char STR_TORRENT_DISABLED[] = QT_TRANSLATE_NOOP("TrackerListModel", "Disabled for this torrent");
     const char STR_PRIVATE_MSG[] = QT_TRANSLATE_NOOP("TrackerListModel", "This torrent is private");
 
+    qint64 secondsUntil(const BitTorrent::AnnounceTimePoint &timePoint)
+    {
+        const auto timeLeft = std::chrono::duration_cast<std::chrono::seconds>(timePoint - BitTorrent::AnnounceTimePoint::clock::now());
+        return std::max<qint64>(0, timeLeft.count());
+    }
+
     QString prettyCount(const int val)
     {
         return (val > -1) ? QString::number(val) : TrackerListModel::tr("N/A");
@@ -129,10 +132,6 @@ struct TrackerListModel::Item final
     BitTorrent::AnnounceTimePoint nextAnnounceTime;
     BitTorrent::AnnounceTimePoint minAnnounceTime;
 
-    qint64 secsToNextAnnounce = 0;
-    qint64 secsToMinAnnounce = 0;
-    BitTorrent::AnnounceTimePoint announceTimestamp;
-
     std::weak_ptr<Item> parentItem {};
 
     multi_index_container<std::shared_ptr<Item>, indexed_by<
@@ -148,8 +147,9 @@ struct TrackerListModel::Item final
     explicit Item(const BitTorrent::TrackerEntryStatus &trackerEntryStatus);
     Item(const std::shared_ptr<Item> &parentItem, const BitTorrent::TrackerEndpointStatus &endpointStatus);
 
-    void fillFrom(const BitTorrent::TrackerEntryStatus &trackerEntryStatus);
-    void fillFrom(const BitTorrent::TrackerEndpointStatus &endpointStatus);
+    // Return `true` if any of the item data is changed
+    bool fillFrom(const BitTorrent::TrackerEntryStatus &trackerEntryStatus);
+    bool fillFrom(const BitTorrent::TrackerEndpointStatus &endpointStatus);
 
     QString statusText() const;
 };
@@ -182,44 +182,39 @@ TrackerListModel::Item::Item(const std::shared_ptr<Item> &parentItem, const BitT
     fillFrom(endpointStatus);
 }
 
-void TrackerListModel::Item::fillFrom(const BitTorrent::TrackerEntryStatus &trackerEntryStatus)
+bool TrackerListModel::Item::fillFrom(const BitTorrent::TrackerEntryStatus &trackerEntryStatus)
 {
     Q_ASSERT(parentItem.expired());
     Q_ASSERT(trackerEntryStatus.url == name);
 
-    tier = trackerEntryStatus.tier;
-    isUpdating = trackerEntryStatus.isUpdating;
-    status = trackerEntryStatus.state;
-    message = trackerEntryStatus.message;
-    numPeers = trackerEntryStatus.numPeers;
-    numSeeds = trackerEntryStatus.numSeeds;
-    numLeeches = trackerEntryStatus.numLeeches;
-    numDownloaded = trackerEntryStatus.numDownloaded;
-    nextAnnounceTime = trackerEntryStatus.nextAnnounceTime;
-    minAnnounceTime = trackerEntryStatus.minAnnounceTime;
-    secsToNextAnnounce = 0;
-    secsToMinAnnounce = 0;
-    announceTimestamp = {};
+    const auto newData = std::tie(trackerEntryStatus.tier, trackerEntryStatus.isUpdating, trackerEntryStatus.state
+            , trackerEntryStatus.message, trackerEntryStatus.numPeers, trackerEntryStatus.numSeeds, trackerEntryStatus.numLeeches
+            , trackerEntryStatus.numDownloaded, trackerEntryStatus.nextAnnounceTime, trackerEntryStatus.minAnnounceTime);
+    auto data = std::tie(tier, isUpdating, status, message, numPeers, numSeeds, numLeeches, numDownloaded
+            , nextAnnounceTime, minAnnounceTime);
+    if (data == newData)
+        return false;
+
+    data = newData;
+    return true;
 }
 
-void TrackerListModel::Item::fillFrom(const BitTorrent::TrackerEndpointStatus &endpointStatus)
+bool TrackerListModel::Item::fillFrom(const BitTorrent::TrackerEndpointStatus &endpointStatus)
 {
     Q_ASSERT(!parentItem.expired());
     Q_ASSERT(endpointStatus.name == name);
     Q_ASSERT(endpointStatus.btVersion == btVersion);
 
-    isUpdating = endpointStatus.isUpdating;
-    status = endpointStatus.state;
-    message = endpointStatus.message;
-    numPeers = endpointStatus.numPeers;
-    numSeeds = endpointStatus.numSeeds;
-    numLeeches = endpointStatus.numLeeches;
-    numDownloaded = endpointStatus.numDownloaded;
-    nextAnnounceTime = endpointStatus.nextAnnounceTime;
-    minAnnounceTime = endpointStatus.minAnnounceTime;
-    secsToNextAnnounce = 0;
-    secsToMinAnnounce = 0;
-    announceTimestamp = {};
+    const auto newData = std::tie(endpointStatus.isUpdating, endpointStatus.state, endpointStatus.message
+            , endpointStatus.numPeers, endpointStatus.numSeeds, endpointStatus.numLeeches, endpointStatus.numDownloaded
+            , endpointStatus.nextAnnounceTime, endpointStatus.minAnnounceTime);
+    auto data = std::tie(isUpdating, status, message, numPeers, numSeeds, numLeeches, numDownloaded
+            , nextAnnounceTime, minAnnounceTime);
+    if (data == newData)
+        return false;
+
+    data = newData;
+    return true;
 }
 
 QString TrackerListModel::Item::statusText() const
@@ -248,13 +243,9 @@ TrackerListModel::TrackerListModel(BitTorrent::Session *btSession, QObject *pare
     : QAbstractItemModel(parent)
     , m_btSession {btSession}
     , m_items {std::make_unique<Items>()}
-    , m_announceRefreshTimer {new QTimer(this)}
 {
     Q_ASSERT(m_btSession);
 
-    m_announceRefreshTimer->setSingleShot(true);
-    connect(m_announceRefreshTimer, &QTimer::timeout, this, &TrackerListModel::refreshAnnounceTimes);
-
     connect(m_btSession, &BitTorrent::Session::trackersAdded, this
             , [this](BitTorrent::Torrent *torrent, const QList<BitTorrent::TrackerEntry> &newTrackers)
     {
@@ -274,10 +265,13 @@ TrackerListModel::TrackerListModel(BitTorrent::Session *btSession, QObject *pare
             onTrackersChanged();
     });
     connect(m_btSession, &BitTorrent::Session::trackerEntryStatusesUpdated, this
-            , [this](BitTorrent::Torrent *torrent, const QHash<QString, BitTorrent::TrackerEntryStatus> &updatedTrackers)
+            , [this](const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntryStatus>> &updatedTrackers)
     {
-        if (torrent == m_torrent)
-            onTrackersUpdated(updatedTrackers);
+        if (!m_torrent)
+            return;
+
+        if (const auto iter = updatedTrackers.constFind(m_torrent); iter != updatedTrackers.cend())
+            onTrackersUpdated(iter.value());
     });
 }
 
@@ -295,8 +289,6 @@ void TrackerListModel::setTorrent(BitTorrent::Torrent *torrent)
 
     if (m_torrent)
         populate();
-    else
-        m_announceRefreshTimer->stop();
 }
 
 BitTorrent::Torrent *TrackerListModel::torrent() const
@@ -379,9 +371,6 @@ void TrackerListModel::populate()
 
     for (const BitTorrent::TrackerEntryStatus &status : trackers)
         addTrackerItem(status);
-
-    m_announceTimestamp = BitTorrent::AnnounceTimePoint::clock::now();
-    m_announceRefreshTimer->start(ANNOUNCE_TIME_REFRESH_INTERVAL);
 }
 
 std::shared_ptr<TrackerListModel::Item> TrackerListModel::createTrackerItem(const BitTorrent::TrackerEntryStatus &trackerEntryStatus)
@@ -401,7 +390,12 @@ void TrackerListModel::addTrackerItem(const BitTorrent::TrackerEntryStatus &trac
 
 void TrackerListModel::updateTrackerItem(const std::shared_ptr<Item> &item, const BitTorrent::TrackerEntryStatus &trackerEntryStatus)
 {
+    const auto &itemsByPos = m_items->get<0>();
+    const auto trackerRow = std::distance(itemsByPos.begin(), itemsByPos.iterator_to(item));
+    const auto trackerIndex = index(trackerRow, 0);
+
     QSet<std::pair<QString, int>> endpointItemIDs;
+    QList<int> changedEndpointRows;
     QList<std::shared_ptr<Item>> newEndpointItems;
     for (const auto &[id, endpointStatus] : trackerEntryStatus.endpoints.asKeyValueRange())
     {
@@ -410,7 +404,11 @@ void TrackerListModel::updateTrackerItem(const std::shared_ptr<Item> &item, cons
         auto &itemsByID = item->childItems.get<ByID>();
         if (const auto &iter = itemsByID.find(std::make_tuple(id.first, id.second)); iter != itemsByID.end())
         {
-            (*iter)->fillFrom(endpointStatus);
+            if ((*iter)->fillFrom(endpointStatus))
+            {
+                const auto &iterByPos = item->childItems.project<0>(iter);
+                changedEndpointRows.append(std::distance(item->childItems.get<0>().begin(), iterByPos));
+            }
         }
         else
         {
@@ -418,9 +416,17 @@ void TrackerListModel::updateTrackerItem(const std::shared_ptr<Item> &item, cons
         }
     }
 
-    const auto &itemsByPos = m_items->get<0>();
-    const auto trackerRow = std::distance(itemsByPos.begin(), itemsByPos.iterator_to(item));
-    const auto trackerIndex = index(trackerRow, 0);
+    // Notify about the changed endpoint rows only, joining the adjacent ones into single range
+    std::sort(changedEndpointRows.begin(), changedEndpointRows.end());
+    for (qsizetype i = 0; i < changedEndpointRows.size();)
+    {
+        const int firstRow = changedEndpointRows[i];
+        int lastRow = firstRow;
+        while ((++i < changedEndpointRows.size()) && (changedEndpointRows[i] == (lastRow + 1)))
+            ++lastRow;
+
+        emit dataChanged(index(firstRow, 0, trackerIndex), index(lastRow, (columnCount(trackerIndex) - 1), trackerIndex));
+    }
 
     auto it = item->childItems.begin();
     while (it != item->childItems.end())
@@ -439,35 +445,17 @@ void TrackerListModel::updateTrackerItem(const std::shared_ptr<Item> &item, cons
         }
     }
 
-    const int numRows = rowCount(trackerIndex);
-    emit dataChanged(index(0, 0, trackerIndex), index((numRows - 1), (columnCount(trackerIndex) - 1), trackerIndex));
-
     if (!newEndpointItems.isEmpty())
     {
+        const int numRows = rowCount(trackerIndex);
         beginInsertRows(trackerIndex, numRows, (numRows + newEndpointItems.size() - 1));
         for (const auto &newEndpointItem : asConst(newEndpointItems))
             item->childItems.get<0>().push_back(newEndpointItem);
         endInsertRows();
     }
 
-    item->fillFrom(trackerEntryStatus);
-    emit dataChanged(trackerIndex, index(trackerRow, (columnCount() - 1)));
-}
-
-void TrackerListModel::refreshAnnounceTimes()
-{
-    if (!m_torrent)
-        return;
-
-    m_announceTimestamp = BitTorrent::AnnounceTimePoint::clock::now();
-    emit dataChanged(index(0, COL_NEXT_ANNOUNCE), index((rowCount() - 1), COL_MIN_ANNOUNCE));
-    for (int i = 0; i < rowCount(); ++i)
-    {
-        const QModelIndex parentIndex = index(i, 0);
-        emit dataChanged(index(0, COL_NEXT_ANNOUNCE, parentIndex), index((rowCount(parentIndex) - 1), COL_MIN_ANNOUNCE, parentIndex));
-    }
-
-    m_announceRefreshTimer->start(ANNOUNCE_TIME_REFRESH_INTERVAL);
+    if (item->fillFrom(trackerEntryStatus))
+        emit dataChanged(trackerIndex, index(trackerRow, (columnCount() - 1)));
 }
 
 int TrackerListModel::columnCount([[maybe_unused]] const QModelIndex &parent) const
@@ -549,22 +537,11 @@ QVariant TrackerListModel::data(const QModelIndex &index, const int role) const
     if (!index.isValid())
         return {};
 
-    auto *itemPtr = static_cast<Item *>(index.internalPointer());
+    const auto *itemPtr = static_cast<const Item *>(index.internalPointer());
     Q_ASSERT(itemPtr);
     if (!itemPtr) [[unlikely]]
         return {};
 
-    if (itemPtr->announceTimestamp != m_announceTimestamp)
-    {
-        const auto timeToNextAnnounce = std::chrono::duration_cast<std::chrono::seconds>(itemPtr->nextAnnounceTime - m_announceTimestamp);
-        itemPtr->secsToNextAnnounce = std::max<qint64>(0, timeToNextAnnounce.count());
-
-        const auto timeToMinAnnounce = std::chrono::duration_cast<std::chrono::seconds>(itemPtr->minAnnounceTime - m_announceTimestamp);
-        itemPtr->secsToMinAnnounce = std::max<qint64>(0, timeToMinAnnounce.count());
-
-        itemPtr->announceTimestamp = m_announceTimestamp;
-    }
-
     const bool isEndpoint = !itemPtr->parentItem.expired();
 
     switch (role)
@@ -622,9 +599,9 @@ QVariant TrackerListModel::data(const QModelIndex &index, const int role) const
         case COL_MSG:
             return itemPtr->message;
         case COL_NEXT_ANNOUNCE:
-            return Utils::Misc::userFriendlyDuration(itemPtr->secsToNextAnnounce, -1, Utils::Misc::TimeResolution::Seconds);
+            return Utils::Misc::userFriendlyDuration(secondsUntil(itemPtr->nextAnnounceTime), -1, Utils::Misc::TimeResolution::Seconds);
         case COL_MIN_ANNOUNCE:
-            return Utils::Misc::userFriendlyDuration(itemPtr->secsToMinAnnounce, -1, Utils::Misc::TimeResolution::Seconds);
+            return Utils::Misc::userFriendlyDuration(secondsUntil(itemPtr->minAnnounceTime), -1, Utils::Misc::TimeResolution::Seconds);
         default:
             return {};
         }
@@ -651,9 +628,9 @@ QVariant TrackerListModel::data(const QModelIndex &index, const int role) const
         case COL_MSG:
             return itemPtr->message;
         case COL_NEXT_ANNOUNCE:
-            return itemPtr->secsToNextAnnounce;
+            return secondsUntil(itemPtr->nextAnnounceTime);
         case COL_MIN_ANNOUNCE:
-            return itemPtr->secsToMinAnnounce;
+            return secondsUntil(itemPtr->minAnnounceTime);
         default:
             return {};
         }
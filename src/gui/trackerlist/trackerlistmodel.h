@@ -34,11 +34,8 @@
 #include <QtContainerFwd>
 #include <QAbstractItemModel>
 
-#include "base/bittorrent/announcetimepoint.h"
 #include "base/bittorrent/trackerentrystatus.h"
 
-class QTimer;
-
 namespace BitTorrent
 {
     class Session;
@@ -103,7 +100,6 @@ private:
     std::shared_ptr<Item> createTrackerItem(const BitTorrent::TrackerEntryStatus &trackerEntryStatus);
     void addTrackerItem(const BitTorrent::TrackerEntryStatus &trackerEntryStatus);
     void updateTrackerItem(const std::shared_ptr<Item> &item, const BitTorrent::TrackerEntryStatus &trackerEntryStatus);
-    void refreshAnnounceTimes();
     void onTrackersAdded(const QList<BitTorrent::TrackerEntry> &newTrackers);
     void onTrackersRemoved(const QStringList &deletedTrackers);
     void onTrackersChanged();
@@ -114,7 +110,4 @@ private:
 
     class Items;
     std::unique_ptr<Items> m_items;
-
-    BitTorrent::AnnounceTimePoint m_announceTimestamp;
-    QTimer *m_announceRefreshTimer = nullptr;
 };
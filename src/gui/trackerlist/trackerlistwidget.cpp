@@ -29,6 +29,8 @@
 
 #include "trackerlistwidget.h"
 
+#include <chrono>
+
 #include <QAction>
 #include <QApplication>
 #include <QClipboard>
@@ -41,6 +43,7 @@
 #include <QMessageBox>
 #include <QShortcut>
 #include <QStringList>
+#include <QTimer>
 #include <QTreeWidgetItem>
 #include <QUrl>
 #include <QWheelEvent>
@@ -58,8 +61,16 @@
 #include "trackerlistmodel.h"
 #include "trackerlistsortmodel.h"
 
+using namespace std::chrono_literals;
+
+namespace
+{
+    const std::chrono::milliseconds ANNOUNCE_TIME_REFRESH_INTERVAL = 4s;
+}
+
 TrackerListWidget::TrackerListWidget(QWidget *parent)
     : QTreeView(parent)
+    , m_announceRefreshTimer {new QTimer(this)}
 {
 #ifdef QBT_USES_LIBTORRENT2
     setColumnHidden(TrackerListModel::COL_PROTOCOL, true); // Must be set before calling loadSettings()
@@ -113,6 +124,10 @@ TrackerListWidget::TrackerListWidget(QWidget *parent)
     connect(copyHotkey, &QShortcut::activated, this, &TrackerListWidget::copyTrackerUrl);
 
     connect(this, &QAbstractItemView::doubleClicked, this, &TrackerListWidget::editSelectedTracker);
+
+    // Announce times are calculated by the model when they are displayed so it is enough to repaint them
+    connect(m_announceRefreshTimer, &QTimer::timeout, this, &TrackerListWidget::refreshAnnounceTimes);
+    m_announceRefreshTimer->start(ANNOUNCE_TIME_REFRESH_INTERVAL);
 }
 
 TrackerListWidget::~TrackerListWidget()
@@ -130,6 +145,20 @@ BitTorrent::Torrent *TrackerListWidget::torrent() const
     return m_model->torrent();
 }
 
+void TrackerListWidget::refreshAnnounceTimes()
+{
+    if (!m_model->torrent() || !isVisible())
+        return;
+
+    for (const int column : {TrackerListModel::COL_NEXT_ANNOUNCE, TrackerListModel::COL_MIN_ANNOUNCE})
+    {
+        if (isColumnHidden(column))
+            continue;
+
+        viewport()->update(columnViewportPosition(column), 0, columnWidth(column), viewport()->height());
+    }
+}
+
 QModelIndexList TrackerListWidget::getSelectedTrackerRows() const
 {
     QModelIndexList selectedItemIndexes = selectionModel()->selectedRows();
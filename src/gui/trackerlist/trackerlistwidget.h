@@ -32,6 +32,8 @@
 #include <QtContainerFwd>
 #include <QTreeView>
 
+class QTimer;
+
 class TrackerListModel;
 
 namespace BitTorrent
@@ -69,6 +71,8 @@ private:
     int visibleColumnsCount() const;
     void openAddTrackersDialog();
     void displayColumnHeaderMenu();
+    void refreshAnnounceTimes();
 
     TrackerListModel *m_model;
+    QTimer *m_announceRefreshTimer;
 };
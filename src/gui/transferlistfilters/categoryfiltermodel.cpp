@@ -33,6 +33,7 @@
 
 #include "base/bittorrent/session.h"
 #include "base/global.h"
+#include "base/torrentfilterindex.h"
 #include "gui/uithememanager.h"
 
 class CategoryModelItem
@@ -425,21 +426,17 @@ void CategoryFilterModel::populate()
     m_rootItem->clear();
 
     const auto *session = BitTorrent::Session::instance();
-    const auto torrents = session->torrents();
+    const auto *filterIndex = TorrentFilterIndex::instance();
     m_isSubcategoriesEnabled = session->isSubcategoriesEnabled();
 
     // All torrents
     m_rootItem->addChild(CategoryModelItem::UID_ALL
-            , new CategoryModelItem(nullptr, tr("All"), torrents.count()));
+            , new CategoryModelItem(nullptr, tr("All"), filterIndex->statusTorrentsCount(TorrentFilter::All)));
 
     // Uncategorized torrents
-    using Torrent = BitTorrent::Torrent;
-    const int torrentsCount = std::ranges::count_if(torrents
-            , [](const Torrent *torrent) { return torrent->category().isEmpty(); });
     m_rootItem->addChild(CategoryModelItem::UID_UNCATEGORIZED
-            , new CategoryModelItem(nullptr, tr("Uncategorized"), torrentsCount));
+            , new CategoryModelItem(nullptr, tr("Uncategorized"), filterIndex->categoryTorrentsCount({})));
 
-    using BitTorrent::Torrent;
     if (m_isSubcategoriesEnabled)
     {
         for (const QString &categoryName : asConst(session->categories()))
@@ -449,11 +446,7 @@ void CategoryFilterModel::populate()
             {
                 const QString subcatName = shortName(subcat);
                 if (!parent->hasChild(subcatName))
-                {
-                    const int torrentsCount = std::ranges::count_if(torrents
-                            , [&subcat](const Torrent *torrent) { return torrent->category() == subcat; });
-                    new CategoryModelItem(parent, subcatName, torrentsCount);
-                }
+                    new CategoryModelItem(parent, subcatName, filterIndex->categoryTorrentsCount(subcat));
                 parent = parent->child(subcatName);
             }
         }
@@ -461,11 +454,7 @@ void CategoryFilterModel::populate()
     else
     {
         for (const QString &categoryName : asConst(session->categories()))
-        {
-            const int torrentsCount = std::ranges::count_if(torrents
-                    , [&categoryName](const Torrent *torrent) { return torrent->belongsToCategory(categoryName); });
-            new CategoryModelItem(m_rootItem, categoryName, torrentsCount);
-        }
+            new CategoryModelItem(m_rootItem, categoryName, filterIndex->categoryTorrentsCount(categoryName));
     }
 }
 
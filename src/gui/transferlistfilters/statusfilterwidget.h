@@ -29,10 +29,7 @@
 
 #pragma once
 
-#include <bitset>
-
 #include <QtContainerFwd>
-#include <QHash>
 
 #include "base/torrentfilter.h"
 #include "basefilterwidget.h"
@@ -58,24 +55,7 @@ private:
 
     void configure();
 
-    void update(const QList<BitTorrent::Torrent *> &torrents);
-    void updateTorrentStatus(const BitTorrent::Torrent *torrent);
+    void update();
     void updateTexts();
     void hideZeroItems();
-
-    using TorrentFilterBitset = std::bitset<32>;  // approximated size, this should be the number of TorrentFilter::Type elements
-    QHash<const BitTorrent::Torrent *, TorrentFilterBitset> m_torrentsStatus;
-    int m_nbDownloading = 0;
-    int m_nbSeeding = 0;
-    int m_nbCompleted = 0;
-    int m_nbRunning = 0;
-    int m_nbStopped = 0;
-    int m_nbActive = 0;
-    int m_nbInactive = 0;
-    int m_nbStalled = 0;
-    int m_nbStalledUploading = 0;
-    int m_nbStalledDownloading = 0;
-    int m_nbChecking = 0;
-    int m_nbMoving = 0;
-    int m_nbErrored = 0;
 };
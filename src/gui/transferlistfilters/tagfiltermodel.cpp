@@ -34,6 +34,7 @@
 
 #include "base/bittorrent/session.h"
 #include "base/global.h"
+#include "base/torrentfilterindex.h"
 #include "gui/uithememanager.h"
 
 const int ROW_ALL = 0;
@@ -286,24 +287,16 @@ void TagFilterModel::torrentAboutToBeRemoved(BitTorrent::Torrent *const torrent)
 
 void TagFilterModel::populate()
 {
-    using Torrent = BitTorrent::Torrent;
-
     const auto *session = BitTorrent::Session::instance();
-    const auto torrents = session->torrents();
+    const auto *filterIndex = TorrentFilterIndex::instance();
 
     // All torrents
-    addToModel(Tag(), torrents.count());
+    addToModel(Tag(), filterIndex->statusTorrentsCount(TorrentFilter::All));
 
-    const int untaggedCount = std::ranges::count_if(torrents
-            , [](const Torrent *torrent) { return torrent->tags().isEmpty(); });
-    addToModel(Tag(), untaggedCount);
+    addToModel(Tag(), filterIndex->tagTorrentsCount(Tag()));
 
     for (const Tag &tag : asConst(session->tags()))
-    {
-        const int count = std::ranges::count_if(torrents
-                , [&tag](const Torrent *torrent) { return torrent->hasTag(tag); });
-        addToModel(tag, count);
-    }
+        addToModel(tag, filterIndex->tagTorrentsCount(tag));
 }
 
 void TagFilterModel::addToModel(const Tag &tag, const int count)
@@ -29,11 +29,18 @@
 
 #include "trackersfilterwidget.h"
 
+#include <QBuffer>
+#include <QCache>
 #include <QCheckBox>
-#include <QIcon>
+#include <QFuture>
+#include <QImage>
+#include <QImageReader>
 #include <QListWidgetItem>
 #include <QMenu>
 #include <QMessageBox>
+#include <QPixmap>
+#include <QPromise>
+#include <QThreadPool>
 #include <QUrl>
 
 #include "base/algorithm.h"
@@ -41,10 +48,10 @@
 #include "base/bittorrent/trackerentry.h"
 #include "base/bittorrent/trackerentrystatus.h"
 #include "base/global.h"
-#include "base/net/downloadmanager.h"
+#include "base/net/faviconcache.h"
 #include "base/preferences.h"
 #include "base/utils/compare.h"
-#include "base/utils/fs.h"
+#include "base/utils/io.h"
 #include "gui/transferlistwidget.h"
 #include "gui/uithememanager.h"
 
@@ -71,22 +78,40 @@ namespace
 
     QString getHost(const QString &url)
     {
+        // the same trackers are usually used by many torrents, so their URLs aren't parsed again
+        static QCache<QString, QString> cache {1000};
+
+        if (const QString *host = cache.object(url))
+            return *host;
+
         // We want the hostname.
         // If failed to parse the domain, original input should be returned
 
-        const QString host = QUrl(url).host();
+        QString host = QUrl(url).host();
         if (host.isEmpty())
-            return url;
+            host = url;
 
+        cache.insert(url, new QString(host));
         return host;
     }
 
-    QString getFaviconHost(const QString &trackerHost)
+    // Hundreds of tracker hosts may be shown, so their icons are decoded in a worker thread
+    QList<QImage> decodeFavicon(const QByteArray &data)
     {
-        if (!QHostAddress(trackerHost).isNull())
-            return trackerHost;
+        QBuffer buffer;
+        buffer.setData(data);
+        buffer.open(QIODevice::ReadOnly);
+
+        // ICO files may contain the icon in several sizes
+        QImageReader reader {&buffer};
+        QList<QImage> images;
+        do
+        {
+            if (QImage image = reader.read(); !image.isNull())
+                images.append(std::move(image));
+        } while (reader.jumpToNextImage());
 
-        return trackerHost.section(u'.', -2, -1);
+        return images;
     }
 
     QString getFormatStringForRow(const int row)
@@ -145,16 +170,17 @@ TrackersFilterWidget::TrackersFilterWidget(QWidget *parent, TransferListWidget *
 
     handleTorrentsLoaded(BitTorrent::Session::instance()->torrents());
 
+    connect(Net::FaviconCache::instance(), &Net::FaviconCache::iconUpdated, this
+            , [this](const QString &faviconHost, const QByteArray &iconData)
+    {
+        if (m_downloadTrackerFavicon)
+            loadFavicon(faviconHost, {}, iconData);
+    });
+
     setCurrentRow(0, QItemSelectionModel::SelectCurrent);
     toggleFilter(Preferences::instance()->getTrackerFilterState());
 }
 
-TrackersFilterWidget::~TrackersFilterWidget()
-{
-    for (const Path &iconPath : asConst(m_iconPaths))
-        Utils::Fs::removeFile(iconPath);
-}
-
 void TrackersFilterWidget::addTrackers(const BitTorrent::Torrent *torrent, const QList<BitTorrent::TrackerEntry> &trackers)
 {
     const BitTorrent::TorrentID torrentID = torrent->id();
@@ -247,8 +273,7 @@ void TrackersFilterWidget::addItems(const QString &trackerURL, const QList<BitTo
         const TrackerData trackerData {{}, trackerItem};
         trackersIt = m_trackers.insert(host, trackerData);
 
-        const QString scheme = getScheme(trackerURL);
-        downloadFavicon(host, u"%1://%2/favicon.ico"_s.arg((scheme.startsWith(u"http") ? scheme : u"http"_s), getFaviconHost(host)));
+        requestFavicon(host, getScheme(trackerURL));
     }
 
     Q_ASSERT(trackerItem);
@@ -372,16 +397,28 @@ void TrackersFilterWidget::setDownloadTrackerFavicon(bool value)
         {
             const QString &tracker = i.key();
             if (!tracker.isEmpty())
-            {
-                const QString scheme = getScheme(tracker);
-                downloadFavicon(tracker, u"%1://%2/favicon.ico"_s
-                        .arg((scheme.startsWith(u"http") ? scheme : u"http"_s), getFaviconHost(tracker)));
-             }
+                requestFavicon(tracker, getScheme(tracker));
         }
     }
 }
 
-void TrackersFilterWidget::handleTrackerStatusesUpdated(const BitTorrent::Torrent *torrent
+void TrackersFilterWidget::handleTrackerStatusesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntryStatus>> &updatedTrackers)
+{
+    for (auto iter = updatedTrackers.cbegin(); iter != updatedTrackers.cend(); ++iter)
+        processTrackerStatuses(iter.key(), iter.value());
+
+    item(OTHERERROR_ROW)->setText(formatItemText(OTHERERROR_ROW, m_errors.size()));
+    item(TRACKERERROR_ROW)->setText(formatItemText(TRACKERERROR_ROW, m_trackerErrors.size()));
+    item(WARNING_ROW)->setText(formatItemText(WARNING_ROW, m_warnings.size()));
+
+    if (const int row = currentRow(); (row == OTHERERROR_ROW)
+        || (row == TRACKERERROR_ROW) || (row == WARNING_ROW))
+    {
+        applyFilter(row);
+    }
+}
+
+void TrackersFilterWidget::processTrackerStatuses(const BitTorrent::Torrent *torrent
         , const QHash<QString, BitTorrent::TrackerEntryStatus> &updatedTrackers)
 {
     const BitTorrent::TorrentID id = torrent->id();
@@ -472,32 +509,70 @@ void TrackersFilterWidget::handleTrackerStatusesUpdated(const BitTorrent::Torren
         m_trackerErrors.erase(trackerErrorHashesIt);
     if ((warningHashesIt != m_warnings.end()) && warningHashesIt->isEmpty())
         m_warnings.erase(warningHashesIt);
+}
 
-    item(OTHERERROR_ROW)->setText(formatItemText(OTHERERROR_ROW, m_errors.size()));
-    item(TRACKERERROR_ROW)->setText(formatItemText(TRACKERERROR_ROW, m_trackerErrors.size()));
-    item(WARNING_ROW)->setText(formatItemText(WARNING_ROW, m_warnings.size()));
+void TrackersFilterWidget::requestFavicon(const QString &trackerHost, const QString &scheme)
+{
+    if (!m_downloadTrackerFavicon)
+        return;
 
-    if (const int row = currentRow(); (row == OTHERERROR_ROW)
-        || (row == TRACKERERROR_ROW) || (row == WARNING_ROW))
+    const QString faviconHost = Net::FaviconCache::faviconHost(trackerHost);
+    if (const auto faviconIter = m_favicons.constFind(faviconHost); faviconIter != m_favicons.cend())
     {
-        applyFilter(row);
+        m_trackers.value(trackerHost).item->setData(Qt::DecorationRole, faviconIter.value());
     }
+    else if (!m_loadingFavicons.contains(faviconHost))
+    {
+        if (const Path iconPath = Net::FaviconCache::instance()->iconPath(faviconHost); !iconPath.isEmpty())
+            loadFavicon(faviconHost, iconPath, {});
+    }
+
+    // The cached icon is revalidated only when it is expired
+    Net::FaviconCache::instance()->fetchIcon(faviconHost, scheme);
 }
 
-void TrackersFilterWidget::downloadFavicon(const QString &trackerHost, const QString &faviconURL)
+void TrackersFilterWidget::loadFavicon(const QString &faviconHost, const Path &iconPath, const QByteArray &iconData)
 {
-    if (!m_downloadTrackerFavicon)
-        return;
+    // The icon that is loaded later supersedes the ones that are still being loaded
+    const quint64 loadID = ++m_lastFaviconLoadID;
+    m_loadingFavicons[faviconHost] = loadID;
 
-    QSet<QString> &downloadingFaviconNode = m_downloadingFavicons[faviconURL];
-    if (downloadingFaviconNode.isEmpty())
+    auto promise = std::make_shared<QPromise<QList<QImage>>>();
+    promise->start();
+    promise->future().then(this, [this, faviconHost, loadID](QFuture<QList<QImage>> future)
     {
-        Net::DownloadManager::instance()->download(
-                Net::DownloadRequest(faviconURL).saveToFile(true), Preferences::instance()->useProxyForGeneralPurposes()
-                , this, &TrackersFilterWidget::handleFavicoDownloadFinished);
-    }
+        if (m_loadingFavicons.value(faviconHost) != loadID)
+            return;
+
+        m_loadingFavicons.remove(faviconHost);
 
-    downloadingFaviconNode.insert(trackerHost);
+        const QList<QImage> images = future.takeResult();
+        QIcon icon;
+        for (const QImage &image : images)
+            icon.addPixmap(QPixmap::fromImage(image));
+        if (!icon.isNull())
+            setFavicon(faviconHost, icon);
+    });
+
+    QThreadPool::globalInstance()->start([promise, iconPath, iconData]
+    {
+        const QByteArray data = !iconData.isEmpty()
+                ? iconData : Utils::IO::readFile(iconPath, Net::MAX_FAVICON_SIZE).value_or(QByteArray());
+        promise->addResult(decodeFavicon(data));
+        promise->finish();
+    });
+}
+
+void TrackersFilterWidget::setFavicon(const QString &faviconHost, const QIcon &icon)
+{
+    m_favicons[faviconHost] = icon;
+
+    for (auto trackersIt = m_trackers.cbegin(); trackersIt != m_trackers.cend(); ++trackersIt)
+    {
+        const QString &trackerHost = trackersIt.key();
+        if (!trackerHost.isEmpty() && (Net::FaviconCache::faviconHost(trackerHost) == faviconHost))
+            trackersIt->item->setData(Qt::DecorationRole, icon);
+    }
 }
 
 void TrackersFilterWidget::removeTracker(const QString &tracker)
@@ -522,69 +597,6 @@ void TrackersFilterWidget::removeTracker(const QString &tracker)
     updateGeometry();
 }
 
-void TrackersFilterWidget::handleFavicoDownloadFinished(const Net::DownloadResult &result)
-{
-    const QSet<QString> trackerHosts = m_downloadingFavicons.take(result.url);
-    Q_ASSERT(!trackerHosts.isEmpty());
-    if (trackerHosts.isEmpty()) [[unlikely]]
-        return;
-
-    QIcon icon;
-    bool failed = false;
-    if (result.status != Net::DownloadStatus::Success)
-    {
-        failed = true;
-    }
-    else
-    {
-        icon = QIcon(result.filePath.data());
-        //Detect a non-decodable icon
-        QList<QSize> sizes = icon.availableSizes();
-        const bool invalid = (sizes.isEmpty() || icon.pixmap(sizes.first()).isNull());
-        if (invalid)
-        {
-            Utils::Fs::removeFile(result.filePath);
-            failed = true;
-        }
-    }
-
-    if (failed)
-    {
-        if (result.url.endsWith(u".ico", Qt::CaseInsensitive))
-        {
-            const QString faviconURL = QStringView(result.url).chopped(4) + u".png";
-            for (const auto &trackerHost : trackerHosts)
-            {
-                if (m_trackers.contains(trackerHost))
-                    downloadFavicon(trackerHost, faviconURL);
-            }
-        }
-
-        return;
-    }
-
-    bool matchedTrackerFound = false;
-    for (const auto &trackerHost : trackerHosts)
-    {
-        if (!m_trackers.contains(trackerHost))
-            continue;
-
-        matchedTrackerFound = true;
-
-        QListWidgetItem *trackerItem = item(rowFromTracker(trackerHost));
-        Q_ASSERT(trackerItem);
-        if (!trackerItem) [[unlikely]]
-            continue;
-
-        trackerItem->setData(Qt::DecorationRole, icon);
-    }
-
-    if (matchedTrackerFound)
-        m_iconPaths.append(result.filePath);
-    else
-        Utils::Fs::removeFile(result.filePath);
-}
-
 void TrackersFilterWidget::showMenu()
 {
     QMenu *menu = new QMenu(this);
@@ -31,6 +31,7 @@
 
 #include <QtContainerFwd>
 #include <QHash>
+#include <QIcon>
 
 #include "base/path.h"
 #include "basefilterwidget.h"
@@ -43,11 +44,6 @@ namespace BitTorrent
     struct TrackerEntryStatus;
 }
 
-namespace Net
-{
-    struct DownloadResult;
-}
-
 class TrackersFilterWidget final : public BaseFilterWidget
 {
     Q_OBJECT
@@ -55,18 +51,13 @@ class TrackersFilterWidget final : public BaseFilterWidget
 
 public:
     TrackersFilterWidget(QWidget *parent, TransferListWidget *transferList, bool downloadFavicon);
-    ~TrackersFilterWidget() override;
 
     void addTrackers(const BitTorrent::Torrent *torrent, const QList<BitTorrent::TrackerEntry> &trackers);
     void removeTrackers(const BitTorrent::Torrent *torrent, const QStringList &trackers);
     void refreshTrackers(const BitTorrent::Torrent *torrent);
-    void handleTrackerStatusesUpdated(const BitTorrent::Torrent *torrent
-            , const QHash<QString, BitTorrent::TrackerEntryStatus> &updatedTrackers);
+    void handleTrackerStatusesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntryStatus>> &updatedTrackers);
     void setDownloadTrackerFavicon(bool value);
 
-private slots:
-    void handleFavicoDownloadFinished(const Net::DownloadResult &result);
-
 private:
     // These 4 methods are virtual slots in the base class.
     // No need to redeclare them here as slots.
@@ -79,10 +70,14 @@ private:
 
     void addItems(const QString &trackerURL, const QList<BitTorrent::TorrentID> &torrents);
     void removeItem(const QString &trackerURL, const BitTorrent::TorrentID &id);
+    void processTrackerStatuses(const BitTorrent::Torrent *torrent, const QHash<QString, BitTorrent::TrackerEntryStatus> &updatedTrackers);
     QString trackerFromRow(int row) const;
     int rowFromTracker(const QString &tracker) const;
     QSet<BitTorrent::TorrentID> getTorrentIDs(int row) const;
-    void downloadFavicon(const QString &trackerHost, const QString &faviconURL);
+    void requestFavicon(const QString &trackerHost, const QString &scheme);
+    // the icon data is read from `iconPath` if it isn't provided
+    void loadFavicon(const QString &faviconHost, const Path &iconPath, const QByteArray &iconData);
+    void setFavicon(const QString &faviconHost, const QIcon &icon);
     void removeTracker(const QString &tracker);
 
     struct TrackerData
@@ -95,8 +90,9 @@ private:
     QHash<BitTorrent::TorrentID, QSet<QString>> m_errors;  // <torrent ID, tracker hosts>
     QHash<BitTorrent::TorrentID, QSet<QString>> m_trackerErrors;  // <torrent ID, tracker hosts>
     QHash<BitTorrent::TorrentID, QSet<QString>> m_warnings;  // <torrent ID, tracker hosts>
-    PathList m_iconPaths;
     int m_totalTorrents = 0;
     bool m_downloadTrackerFavicon = false;
-    QHash<QString, QSet<QString>> m_downloadingFavicons;   // <favicon URL, tracker hosts>
+    QHash<QString, QIcon> m_favicons;   // <favicon host, icon>
+    QHash<QString, quint64> m_loadingFavicons;   // <favicon host, ID of the latest load>
+    quint64 m_lastFaviconLoadID = 0;
 };
@@ -191,10 +191,9 @@ void TransferListFiltersWidget::refreshTrackers(const BitTorrent::Torrent *torre
     m_trackersFilterWidget->refreshTrackers(torrent);
 }
 
-void TransferListFiltersWidget::trackerEntryStatusesUpdated(const BitTorrent::Torrent *torrent
-        , const QHash<QString, BitTorrent::TrackerEntryStatus> &updatedTrackers)
+void TransferListFiltersWidget::trackerEntryStatusesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntryStatus>> &updatedTrackers)
 {
-    m_trackersFilterWidget->handleTrackerStatusesUpdated(torrent, updatedTrackers);
+    m_trackersFilterWidget->handleTrackerStatusesUpdated(updatedTrackers);
 }
 
 void TransferListFiltersWidget::onCategoryFilterStateChanged(bool enabled)
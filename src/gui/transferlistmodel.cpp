@@ -47,6 +47,73 @@
 
 namespace
 {
+    using ChangedField = BitTorrent::Torrent::ChangedField;
+    using ChangedFields = BitTorrent::Torrent::ChangedFields;
+
+    const ChangedFields STATUS_FIELDS = ChangedField::State | ChangedField::QueuePosition | ChangedField::Progress
+        | ChangedField::Peers | ChangedField::Speed | ChangedField::Transfer | ChangedField::Activity
+        | ChangedField::Availability | ChangedField::Trackers | ChangedField::Dates;
+
+    // Torrent properties that the column values are based on
+    ChangedFields columnDependencies(const int column)
+    {
+        switch (column)
+        {
+        case TransferListModel::TR_QUEUE_POSITION:
+            return ChangedField::QueuePosition;
+        case TransferListModel::TR_SIZE:
+        case TransferListModel::TR_PROGRESS:
+        case TransferListModel::TR_AMOUNT_LEFT:
+        case TransferListModel::TR_COMPLETED:
+            return ChangedField::Progress;
+        case TransferListModel::TR_STATUS:
+            return ChangedField::State;
+        case TransferListModel::TR_SEEDS:
+        case TransferListModel::TR_PEERS:
+            return ChangedField::Peers;
+        case TransferListModel::TR_DLSPEED:
+        case TransferListModel::TR_UPSPEED:
+            return ChangedField::Speed;
+        case TransferListModel::TR_RATIO:
+        case TransferListModel::TR_AMOUNT_DOWNLOADED:
+        case TransferListModel::TR_AMOUNT_UPLOADED:
+        case TransferListModel::TR_AMOUNT_DOWNLOADED_SESSION:
+        case TransferListModel::TR_AMOUNT_UPLOADED_SESSION:
+            return ChangedField::Transfer | ChangedField::Progress;
+        case TransferListModel::TR_POPULARITY:
+            return ChangedField::Transfer | ChangedField::Progress | ChangedField::Activity;
+        case TransferListModel::TR_TIME_ELAPSED:
+            return ChangedField::Activity;
+        case TransferListModel::TR_SEED_DATE:
+        case TransferListModel::TR_SEEN_COMPLETE_DATE:
+            return ChangedField::Dates;
+        case TransferListModel::TR_AVAILABILITY:
+            return ChangedField::Availability;
+        case TransferListModel::TR_REANNOUNCE:
+            return ChangedField::Trackers;
+        case TransferListModel::TR_TRACKER:
+            return ChangedField::Trackers | ChangedField::Configuration;
+        case TransferListModel::TR_ETA:
+        case TransferListModel::TR_LAST_ACTIVITY:
+            // also depend on transfer rate history or current time
+            return STATUS_FIELDS;
+        default:
+            return ChangedField::Configuration;
+        }
+    }
+
+    bool isCacheableColumn(const int column)
+    {
+        switch (column)
+        {
+        case TransferListModel::TR_ETA:
+        case TransferListModel::TR_LAST_ACTIVITY:
+            return false;
+        default:
+            return !columnDependencies(column).testFlag(ChangedField::Configuration);
+        }
+    }
+
     QHash<BitTorrent::TorrentState, QColor> torrentStateColorsFromUITheme()
     {
         struct TorrentStateColorDescriptor
@@ -126,6 +193,11 @@ TransferListModel::TransferListModel(QObject *parent)
     // Load the torrents
     using namespace BitTorrent;
     addTorrents(Session::instance()->torrents());
+    if (!Session::instance()->isRestored())
+    {
+        addPlaceholders(Session::instance()->startupSnapshots());
+        connect(Session::instance(), &Session::restored, this, &TransferListModel::handleSessionRestored);
+    }
 
     // Listen for torrent changes
     connect(Session::instance(), &Session::torrentsLoaded, this, &TransferListModel::addTorrents);
@@ -141,7 +213,7 @@ TransferListModel::TransferListModel(QObject *parent)
 
 int TransferListModel::rowCount(const QModelIndex &) const
 {
-    return m_torrentList.size();
+    return (m_torrentList.size() + m_placeholders.size());
 }
 
 int TransferListModel::columnCount(const QModelIndex &) const
@@ -448,6 +520,20 @@ QString TransferListModel::displayValue(const BitTorrent::Torrent *torrent, cons
     return {};
 }
 
+QString TransferListModel::cachedDisplayValue(const BitTorrent::Torrent *torrent, const int column) const
+{
+    if (!isCacheableColumn(column))
+        return displayValue(torrent, column);
+
+    QHash<int, QString> &cachedValues = m_displayValuesCache[torrent];
+    if (const auto iter = cachedValues.constFind(column); iter != cachedValues.cend())
+        return iter.value();
+
+    const QString value = displayValue(torrent, column);
+    cachedValues.insert(column, value);
+    return value;
+}
+
 QVariant TransferListModel::internalValue(const BitTorrent::Torrent *torrent, const int column, const bool alt) const
 {
     switch (column)
@@ -531,11 +617,95 @@ QVariant TransferListModel::internalValue(const BitTorrent::Torrent *torrent, co
     return {};
 }
 
+QString TransferListModel::placeholderDisplayValue(const BitTorrent::TorrentSnapshot &snapshot, const int column) const
+{
+    switch (column)
+    {
+    case TR_NAME:
+        return snapshot.name;
+    case TR_SIZE:
+        return Utils::Misc::friendlyUnit(snapshot.wantedSize);
+    case TR_PROGRESS:
+        return (snapshot.progress >= 1)
+                ? u"100%"_s
+                : (Utils::String::fromDouble((snapshot.progress * 100), 1) + u'%');
+    case TR_STATUS:
+        return m_statusStrings.value(snapshot.state);
+    case TR_RATIO:
+        return (snapshot.ratio >= BitTorrent::Torrent::MAX_RATIO)
+                ? C_INFINITY : Utils::String::fromDouble(snapshot.ratio, 2);
+    case TR_CATEGORY:
+        return snapshot.category;
+    case TR_TAGS:
+        return Utils::String::joinIntoString(snapshot.tags, u", "_s);
+    }
+
+    return {};
+}
+
+QVariant TransferListModel::placeholderInternalValue(const BitTorrent::TorrentSnapshot &snapshot, const int column) const
+{
+    switch (column)
+    {
+    case TR_NAME:
+        return snapshot.name;
+    case TR_SIZE:
+        return snapshot.wantedSize;
+    case TR_PROGRESS:
+        return snapshot.progress * 100;
+    case TR_STATUS:
+        return QVariant::fromValue(snapshot.state);
+    case TR_RATIO:
+        return snapshot.ratio;
+    case TR_CATEGORY:
+        return snapshot.category;
+    case TR_TAGS:
+        return QVariant::fromValue(snapshot.tags);
+    }
+
+    return {};
+}
+
+QVariant TransferListModel::placeholderData(const BitTorrent::TorrentSnapshot &snapshot, const int column, const int role) const
+{
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        return placeholderDisplayValue(snapshot, column);
+    case UnderlyingDataRole:
+    case AdditionalUnderlyingDataRole:
+        return placeholderInternalValue(snapshot, column);
+    case Qt::DecorationRole:
+        if (column == TR_NAME)
+            return getIconByState(snapshot.state);
+        break;
+    case Qt::ToolTipRole:
+        if (column == TR_NAME)
+            return tr("Loading torrent...");
+        break;
+    case Qt::TextAlignmentRole:
+        switch (column)
+        {
+        case TR_SIZE:
+        case TR_RATIO:
+            return QVariant(Qt::AlignRight | Qt::AlignVCenter);
+        }
+        break;
+    default:
+        break;
+    }
+
+    return {};
+}
+
 QVariant TransferListModel::data(const QModelIndex &index, const int role) const
 {
     if (!index.isValid())
         return {};
 
+    if (isPlaceholder(index))
+        return placeholderData(m_placeholders[index.row() - m_torrentList.size()], index.column(), role);
+
     const BitTorrent::Torrent *torrent = m_torrentList.value(index.row());
     if (!torrent)
         return {};
@@ -547,7 +717,7 @@ QVariant TransferListModel::data(const QModelIndex &index, const int role) const
             return m_stateThemeColors.value(torrent->state());
         break;
     case Qt::DisplayRole:
-        return displayValue(torrent, index.column());
+        return cachedDisplayValue(torrent, index.column());
     case UnderlyingDataRole:
         return internalValue(torrent, index.column(), false);
     case AdditionalUnderlyingDataRole:
@@ -568,7 +738,7 @@ QVariant TransferListModel::data(const QModelIndex &index, const int role) const
         case TR_DOWNLOAD_PATH:
         case TR_INFOHASH_V1:
         case TR_INFOHASH_V2:
-            return displayValue(torrent, index.column());
+            return cachedDisplayValue(torrent, index.column());
         }
         break;
     case Qt::TextAlignmentRole:
@@ -633,10 +803,19 @@ bool TransferListModel::setData(const QModelIndex &index, const QVariant &value,
 
 void TransferListModel::addTorrents(const QList<BitTorrent::Torrent *> &torrents)
 {
+    if (!m_placeholders.isEmpty())
+    {
+        QSet<BitTorrent::TorrentID> torrentIDs;
+        torrentIDs.reserve(torrents.size());
+        for (const BitTorrent::Torrent *torrent : torrents)
+            torrentIDs.insert(torrent->id());
+        removePlaceholders(torrentIDs);
+    }
+
     qsizetype row = m_torrentList.size();
     const qsizetype total = row + torrents.size();
 
-    beginInsertRows({}, row, total);
+    beginInsertRows({}, row, (total - 1));
 
     m_torrentList.reserve(total);
     for (BitTorrent::Torrent *torrent : torrents)
@@ -650,11 +829,73 @@ void TransferListModel::addTorrents(const QList<BitTorrent::Torrent *> &torrents
     endInsertRows();
 }
 
+void TransferListModel::addPlaceholders(const QList<BitTorrent::TorrentSnapshot> &snapshots)
+{
+    const auto *session = BitTorrent::Session::instance();
+
+    QList<BitTorrent::TorrentSnapshot> placeholders;
+    placeholders.reserve(snapshots.size());
+    for (const BitTorrent::TorrentSnapshot &snapshot : snapshots)
+    {
+        if (!session->getTorrent(snapshot.id))
+            placeholders.append(snapshot);
+    }
+
+    if (placeholders.isEmpty())
+        return;
+
+    const qsizetype row = rowCount();
+    beginInsertRows({}, row, (row + placeholders.size() - 1));
+    m_placeholders.append(placeholders);
+    endInsertRows();
+}
+
+void TransferListModel::removePlaceholders(const QSet<BitTorrent::TorrentID> &torrentIDs)
+{
+    // Placeholders are removed in ranges of adjacent rows starting from the end
+    qsizetype last = m_placeholders.size() - 1;
+    while (last >= 0)
+    {
+        if (!torrentIDs.contains(m_placeholders[last].id))
+        {
+            --last;
+            continue;
+        }
+
+        qsizetype first = last;
+        while ((first > 0) && torrentIDs.contains(m_placeholders[first - 1].id))
+            --first;
+
+        const qsizetype firstRow = m_torrentList.size() + first;
+        beginRemoveRows({}, firstRow, (firstRow + last - first));
+        m_placeholders.remove(first, (last - first + 1));
+        endRemoveRows();
+
+        last = first - 1;
+    }
+}
+
+void TransferListModel::handleSessionRestored()
+{
+    // Remaining placeholders belong to the torrents that failed to load
+    if (m_placeholders.isEmpty())
+        return;
+
+    const qsizetype firstRow = m_torrentList.size();
+    beginRemoveRows({}, firstRow, (firstRow + m_placeholders.size() - 1));
+    m_placeholders.clear();
+    endRemoveRows();
+}
+
 Qt::ItemFlags TransferListModel::flags(const QModelIndex &index) const
 {
     if (!index.isValid())
         return Qt::NoItemFlags;
 
+    // Placeholders can be neither selected nor edited until the torrents are loaded
+    if (isPlaceholder(index))
+        return Qt::NoItemFlags;
+
     return QAbstractListModel::flags(index);
 }
 
@@ -665,6 +906,11 @@ BitTorrent::Torrent *TransferListModel::torrentHandle(const QModelIndex &index)
     return m_torrentList.value(index.row());
 }
 
+bool TransferListModel::isPlaceholder(const QModelIndex &index) const
+{
+    return index.isValid() && (index.row() >= m_torrentList.size());
+}
+
 void TransferListModel::handleTorrentAboutToBeRemoved(BitTorrent::Torrent *const torrent)
 {
     const int row = m_torrentMap.value(torrent, -1);
@@ -673,6 +919,7 @@ void TransferListModel::handleTorrentAboutToBeRemoved(BitTorrent::Torrent *const
     beginRemoveRows({}, row, row);
     m_torrentList.removeAt(row);
     m_torrentMap.remove(torrent);
+    m_displayValuesCache.remove(torrent);
     for (int &value : m_torrentMap)
     {
         if (value > row)
@@ -686,13 +933,12 @@ void TransferListModel::handleTorrentStatusUpdated(BitTorrent::Torrent *const to
     const int row = m_torrentMap.value(torrent, -1);
     Q_ASSERT(row >= 0);
 
+    m_displayValuesCache.remove(torrent);
     emit dataChanged(index(row, 0), index(row, columnCount() - 1));
 }
 
 void TransferListModel::handleTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents)
 {
-    const int columns = (columnCount() - 1);
-
     if (torrents.size() <= (m_torrentList.size() * 0.5))
     {
         for (BitTorrent::Torrent *const torrent : torrents)
@@ -700,13 +946,68 @@ void TransferListModel::handleTorrentsUpdated(const QList<BitTorrent::Torrent *>
             const int row = m_torrentMap.value(torrent, -1);
             Q_ASSERT(row >= 0);
 
-            emit dataChanged(index(row, 0), index(row, columns));
+            notifyColumnsChanged(row, row, invalidateChangedColumns(torrent));
         }
     }
     else
     {
         // save the overhead when more than half of the torrent list needs update
-        emit dataChanged(index(0, 0), index((rowCount() - 1), columns));
+        std::bitset<NB_COLUMNS> changedColumns;
+        for (const BitTorrent::Torrent *torrent : torrents)
+            changedColumns |= invalidateChangedColumns(torrent);
+
+        notifyColumnsChanged(0, (rowCount() - 1), changedColumns);
+    }
+}
+
+std::bitset<TransferListModel::NB_COLUMNS> TransferListModel::invalidateChangedColumns(const BitTorrent::Torrent *torrent)
+{
+    const ChangedFields changedFields = torrent->changedFields();
+
+    // State affects the values of all the columns (e.g. text color, hidden zero values)
+    if (changedFields.testFlag(ChangedField::State))
+    {
+        m_displayValuesCache.remove(torrent);
+        return std::bitset<NB_COLUMNS>().set();
+    }
+
+    std::bitset<NB_COLUMNS> changedColumns;
+    for (int column = 0; column < NB_COLUMNS; ++column)
+    {
+        if (changedFields.testAnyFlags(columnDependencies(column)))
+            changedColumns.set(column);
+    }
+
+    if (const auto iter = m_displayValuesCache.find(torrent); iter != m_displayValuesCache.end())
+    {
+        iter->removeIf([&changedColumns](const auto &item) { return changedColumns.test(item.key()); });
+        if (iter->isEmpty())
+            m_displayValuesCache.erase(iter);
+    }
+
+    return changedColumns;
+}
+
+void TransferListModel::notifyColumnsChanged(const int firstRow, const int lastRow, const std::bitset<NB_COLUMNS> &columns)
+{
+    if (columns.none() || (lastRow < firstRow))
+        return;
+
+    // emit a signal per each range of adjacent columns
+    int column = 0;
+    while (column < NB_COLUMNS)
+    {
+        if (!columns.test(column))
+        {
+            ++column;
+            continue;
+        }
+
+        const int firstColumn = column;
+        while ((column < NB_COLUMNS) && columns.test(column))
+            ++column;
+
+        emit dataChanged(index(firstRow, firstColumn), index(lastRow, (column - 1)));
     }
 }
 
@@ -738,7 +1039,10 @@ void TransferListModel::configure()
     }
 
     if (isDataChanged)
+    {
+        m_displayValuesCache.clear();
         emit dataChanged(index(0, 0), index((rowCount() - 1), (columnCount() - 1)));
+    }
 }
 
 void TransferListModel::loadUIThemeResources()
@@ -29,13 +29,17 @@
 
 #pragma once
 
+#include <bitset>
+
 #include <QAbstractListModel>
 #include <QColor>
 #include <QHash>
 #include <QIcon>
 #include <QList>
+#include <QSet>
 
 #include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrentsnapshot.h"
 
 namespace BitTorrent
 {
@@ -107,23 +111,37 @@ public:
     Qt::ItemFlags flags(const QModelIndex &index) const override;
 
     BitTorrent::Torrent *torrentHandle(const QModelIndex &index) const;
+    // Placeholder rows display the torrents saved at last shutdown until they are loaded
+    bool isPlaceholder(const QModelIndex &index) const;
 
 private slots:
     void addTorrents(const QList<BitTorrent::Torrent *> &torrents);
     void handleTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent);
     void handleTorrentStatusUpdated(BitTorrent::Torrent *torrent);
     void handleTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents);
+    void handleSessionRestored();
 
 private:
     void configure();
     void loadUIThemeResources();
     QString displayValue(const BitTorrent::Torrent *torrent, int column) const;
+    QString cachedDisplayValue(const BitTorrent::Torrent *torrent, int column) const;
+    std::bitset<NB_COLUMNS> invalidateChangedColumns(const BitTorrent::Torrent *torrent);
+    void notifyColumnsChanged(int firstRow, int lastRow, const std::bitset<NB_COLUMNS> &columns);
     QVariant internalValue(const BitTorrent::Torrent *torrent, int column, bool alt) const;
+    QString placeholderDisplayValue(const BitTorrent::TorrentSnapshot &snapshot, int column) const;
+    QVariant placeholderInternalValue(const BitTorrent::TorrentSnapshot &snapshot, int column) const;
+    QVariant placeholderData(const BitTorrent::TorrentSnapshot &snapshot, int column, int role) const;
+    void addPlaceholders(const QList<BitTorrent::TorrentSnapshot> &snapshots);
+    void removePlaceholders(const QSet<BitTorrent::TorrentID> &torrentIDs);
     QIcon getIconByState(BitTorrent::TorrentState state) const;
 
     QList<BitTorrent::Torrent *> m_torrentList;  // maps row number to torrent handle
     QHash<BitTorrent::Torrent *, int> m_torrentMap;  // maps torrent handle to row number
+    QList<BitTorrent::TorrentSnapshot> m_placeholders;  // rows that follow the torrents
     const QHash<BitTorrent::TorrentState, QString> m_statusStrings;
+    // Formatted values of the columns that depend only on the properties reported by state updates
+    mutable QHash<const BitTorrent::Torrent *, QHash<int, QString>> m_displayValuesCache;
     // row text colors
     QHash<BitTorrent::TorrentState, QColor> m_stateThemeColors;
 
@@ -28,6 +28,7 @@
 
 #include "transferlistsortmodel.h"
 
+#include <algorithm>
 #include <type_traits>
 
 #include <QtVersionChecks>
@@ -35,10 +36,27 @@
 
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/torrent.h"
+#include "base/global.h"
+#include "base/torrentfilterindex.h"
 #include "transferlistmodel.h"
 
 namespace
 {
+    bool isNaturallySortedColumn(const int column)
+    {
+        switch (column)
+        {
+        case TransferListModel::TR_CATEGORY:
+        case TransferListModel::TR_DOWNLOAD_PATH:
+        case TransferListModel::TR_NAME:
+        case TransferListModel::TR_SAVE_PATH:
+        case TransferListModel::TR_TRACKER:
+            return true;
+        default:
+            return false;
+        }
+    }
+
     template <typename T>
     int threeWayCompare(const T &left, const T &right)
     {
@@ -111,6 +129,30 @@ TransferListSortModel::TransferListSortModel(QObject *parent)
     setSortRole(TransferListModel::UnderlyingDataRole);
 }
 
+void TransferListSortModel::setSourceModel(QAbstractItemModel *sourceModel)
+{
+    for (const QMetaObject::Connection &connection : asConst(m_sourceModelConnections))
+        disconnect(connection);
+    m_sourceModelConnections.clear();
+    clearSortKeys();
+
+    // Must be connected before the base class connects to the same signals
+    // so the outdated sort keys are dropped before the affected rows are sorted
+    if (sourceModel)
+    {
+        m_sourceModelConnections = {
+            connect(sourceModel, &QAbstractItemModel::dataChanged, this, &TransferListSortModel::invalidateSortKeys),
+            connect(sourceModel, &QAbstractItemModel::rowsInserted, this, &TransferListSortModel::clearSortKeys),
+            connect(sourceModel, &QAbstractItemModel::rowsRemoved, this, &TransferListSortModel::clearSortKeys),
+            connect(sourceModel, &QAbstractItemModel::rowsMoved, this, &TransferListSortModel::clearSortKeys),
+            connect(sourceModel, &QAbstractItemModel::layoutChanged, this, &TransferListSortModel::clearSortKeys),
+            connect(sourceModel, &QAbstractItemModel::modelReset, this, &TransferListSortModel::clearSortKeys)
+        };
+    }
+
+    QSortFilterProxyModel::setSourceModel(sourceModel);
+}
+
 void TransferListSortModel::sort(const int column, const Qt::SortOrder order)
 {
     if ((m_lastSortColumn != column) && (m_lastSortColumn != -1))
@@ -121,18 +163,78 @@ void TransferListSortModel::sort(const int column, const Qt::SortOrder order)
     m_lastSortColumn = column;
     m_lastSortOrder = ((order == Qt::AscendingOrder) ? 0 : 1);
 
+    // Keep the sort keys of the columns in use only
+    m_sortKeys.removeIf([this](const auto &item)
+    {
+        return (item.key() != m_lastSortColumn) && (item.key() != m_subSortColumn);
+    });
+
     QSortFilterProxyModel::sort(column, order);
 }
 
+const TransferListSortModel::SortKey &TransferListSortModel::sortKey(const QModelIndex &index) const
+{
+    QList<std::optional<SortKey>> &columnSortKeys = m_sortKeys[index.column()];
+    if (columnSortKeys.size() <= index.row())
+        columnSortKeys.resize(sourceModel()->rowCount());
+
+    std::optional<SortKey> &key = columnSortKeys[index.row()];
+    if (!key)
+    {
+        const bool hasAdditionalValue = (index.column() == TransferListModel::TR_PEERS)
+                || (index.column() == TransferListModel::TR_SEEDS);
+        key = SortKey {
+            .value = index.data(TransferListModel::UnderlyingDataRole),
+            .additionalValue = (hasAdditionalValue ? index.data(TransferListModel::AdditionalUnderlyingDataRole) : QVariant())
+        };
+        // Sorting compares each key many times so the natural-order key is obtained once.
+        // It is invalidated along with the value, e.g. when the torrent is renamed.
+        if (isNaturallySortedColumn(index.column()))
+            key->naturalKey = m_naturalCompare.sortKey(key->value.toString());
+    }
+
+    return *key;
+}
+
+void TransferListSortModel::invalidateSortKeys(const QModelIndex &topLeft, const QModelIndex &bottomRight)
+{
+    if (!topLeft.isValid() || !bottomRight.isValid())
+    {
+        clearSortKeys();
+        return;
+    }
+
+    for (auto it = m_sortKeys.begin(); it != m_sortKeys.end(); ++it)
+    {
+        const int column = it.key();
+        if ((column < topLeft.column()) || (column > bottomRight.column()))
+            continue;
+
+        QList<std::optional<SortKey>> &columnSortKeys = it.value();
+        const int lastRow = std::min<int>(bottomRight.row(), (columnSortKeys.size() - 1));
+        for (int row = topLeft.row(); row <= lastRow; ++row)
+            columnSortKeys[row].reset();
+    }
+}
+
+void TransferListSortModel::clearSortKeys()
+{
+    m_sortKeys.clear();
+}
+
 void TransferListSortModel::setStatusFilter(const TorrentFilter::Type filter)
 {
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
     beginFilterChange();
     m_filter.setType(filter);
+    m_matchingTorrentsRevision.reset();
     endFilterChange(Direction::Rows);
 #else
     if (m_filter.setType(filter))
+    {
+        m_matchingTorrentsRevision.reset();
         invalidateRowsFilter();
+    }
 #endif
 }
 
@@ -141,10 +243,14 @@ void TransferListSortModel::setCategoryFilter(const QString &category)
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
     beginFilterChange();
     m_filter.setCategory(category);
+    m_matchingTorrentsRevision.reset();
     endFilterChange(Direction::Rows);
 #else
     if (m_filter.setCategory(category))
+    {
+        m_matchingTorrentsRevision.reset();
         invalidateRowsFilter();
+    }
 #endif
 }
 
@@ -153,10 +259,14 @@ void TransferListSortModel::disableCategoryFilter()
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
     beginFilterChange();
     m_filter.setCategory(TorrentFilter::AnyCategory);
+    m_matchingTorrentsRevision.reset();
     endFilterChange(Direction::Rows);
 #else
     if (m_filter.setCategory(TorrentFilter::AnyCategory))
+    {
+        m_matchingTorrentsRevision.reset();
         invalidateRowsFilter();
+    }
 #endif
 }
 
@@ -165,10 +275,14 @@ void TransferListSortModel::setTagFilter(const Tag &tag)
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
     beginFilterChange();
     m_filter.setTag(tag);
+    m_matchingTorrentsRevision.reset();
     endFilterChange(Direction::Rows);
 #else
     if (m_filter.setTag(tag))
+    {
+        m_matchingTorrentsRevision.reset();
         invalidateRowsFilter();
+    }
 #endif
 }
 
@@ -177,10 +291,14 @@ void TransferListSortModel::disableTagFilter()
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
     beginFilterChange();
     m_filter.setTag(TorrentFilter::AnyTag);
+    m_matchingTorrentsRevision.reset();
     endFilterChange(Direction::Rows);
 #else
     if (m_filter.setTag(TorrentFilter::AnyTag))
+    {
+        m_matchingTorrentsRevision.reset();
         invalidateRowsFilter();
+    }
 #endif
 }
 
@@ -189,10 +307,14 @@ void TransferListSortModel::setTrackerFilter(const QSet<BitTorrent::TorrentID> &
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
     beginFilterChange();
     m_filter.setTorrentIDSet(torrentIDs);
+    m_matchingTorrentsRevision.reset();
     endFilterChange(Direction::Rows);
 #else
     if (m_filter.setTorrentIDSet(torrentIDs))
+    {
+        m_matchingTorrentsRevision.reset();
         invalidateRowsFilter();
+    }
 #endif
 }
 
@@ -201,18 +323,42 @@ void TransferListSortModel::disableTrackerFilter()
 #if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
     beginFilterChange();
     m_filter.setTorrentIDSet(TorrentFilter::AnyID);
+    m_matchingTorrentsRevision.reset();
     endFilterChange(Direction::Rows);
 #else
     if (m_filter.setTorrentIDSet(TorrentFilter::AnyID))
+    {
+        m_matchingTorrentsRevision.reset();
+        invalidateRowsFilter();
+    }
+#endif
+}
+
+void TransferListSortModel::setNameFilter(const QString &text)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 10, 0)
+    beginFilterChange();
+    m_nameFilter = text;
+    m_matchingTorrentsRevision.reset();
+    endFilterChange(Direction::Rows);
+#else
+    if (m_nameFilter != text)
+    {
+        m_nameFilter = text;
+        m_matchingTorrentsRevision.reset();
         invalidateRowsFilter();
+    }
 #endif
 }
 
 int TransferListSortModel::compare(const QModelIndex &left, const QModelIndex &right) const
 {
     const int compareColumn = left.column();
-    const QVariant leftValue = left.data(TransferListModel::UnderlyingDataRole);
-    const QVariant rightValue = right.data(TransferListModel::UnderlyingDataRole);
+    // Sort keys are copied since obtaining another one can reallocate the storage
+    const SortKey leftKey = sortKey(left);
+    const SortKey rightKey = sortKey(right);
+    const QVariant &leftValue = leftKey.value;
+    const QVariant &rightValue = rightKey.value;
 
     switch (compareColumn)
     {
@@ -221,7 +367,7 @@ int TransferListSortModel::compare(const QModelIndex &left, const QModelIndex &r
     case TransferListModel::TR_NAME:
     case TransferListModel::TR_SAVE_PATH:
     case TransferListModel::TR_TRACKER:
-        return m_naturalCompare(leftValue.toString(), rightValue.toString());
+        return leftKey.naturalKey->compare(*rightKey.naturalKey);
 
     case TransferListModel::TR_INFOHASH_V1:
         return threeWayCompare(leftValue.value<SHA1Hash>(), rightValue.value<SHA1Hash>());
@@ -280,8 +426,8 @@ int TransferListSortModel::compare(const QModelIndex &left, const QModelIndex &r
             if (activeL != activeR)
                 return threeWayCompare(activeL, activeR);
 
-            const auto totalL = left.data(TransferListModel::AdditionalUnderlyingDataRole).toInt();
-            const auto totalR = right.data(TransferListModel::AdditionalUnderlyingDataRole).toInt();
+            const auto totalL = leftKey.additionalValue.toInt();
+            const auto totalR = rightKey.additionalValue.toInt();
             return threeWayCompare(totalL, totalR);
         }
 
@@ -322,8 +468,29 @@ bool TransferListSortModel::matchFilter(const int sourceRow, const QModelIndex &
     const auto *model = qobject_cast<TransferListModel *>(sourceModel());
     if (!model) return false;
 
-    const BitTorrent::Torrent *torrent = model->torrentHandle(model->index(sourceRow, 0, sourceParent));
+    const QModelIndex index = model->index(sourceRow, 0, sourceParent);
+    // Placeholders are shown regardless of the filters since the actual torrent data isn't known yet
+    if (model->isPlaceholder(index))
+        return true;
+
+    const BitTorrent::Torrent *torrent = model->torrentHandle(index);
     if (!torrent) return false;
 
-    return m_filter.match(torrent);
+    // Status, category, tag and name are matched by the bitset of the torrents matching all of them
+    // which is rebuilt only when the filter or the torrents membership in the filter groups is changed
+    const auto *filterIndex = TorrentFilterIndex::instance();
+    if (m_matchingTorrentsRevision != filterIndex->revision())
+    {
+        m_matchingTorrents = filterIndex->matchingTorrents(m_filter.type(), m_filter.category(), m_filter.tag());
+        if (!m_nameFilter.isEmpty())
+            m_matchingTorrents &= filterIndex->matchingNameTorrents(m_nameFilter);
+        m_matchingTorrentsRevision = filterIndex->revision();
+    }
+
+    const int slot = filterIndex->torrentSlot(torrent);
+    if ((slot < 0) || (slot >= m_matchingTorrents.size()) || !m_matchingTorrents.testBit(slot))
+        return false;
+
+    const std::optional<TorrentIDSet> &idSet = m_filter.torrentIDSet();
+    return (!idSet || idSet->contains(torrent->id()));
 }
@@ -28,7 +28,13 @@
 
 #pragma once
 
+#include <optional>
+
+#include <QBitArray>
+#include <QHash>
+#include <QList>
 #include <QSortFilterProxyModel>
+#include <QVariant>
 
 #include "base/settingvalue.h"
 #include "base/torrentfilter.h"
@@ -47,6 +53,7 @@ class TransferListSortModel final : public QSortFilterProxyModel
 public:
     explicit TransferListSortModel(QObject *parent = nullptr);
 
+    void setSourceModel(QAbstractItemModel *sourceModel) override;
     void sort(int column, Qt::SortOrder order = Qt::AscendingOrder) override;
 
     void setStatusFilter(TorrentFilter::Type filter);
@@ -56,8 +63,22 @@ public:
     void disableTagFilter();
     void setTrackerFilter(const QSet<BitTorrent::TorrentID> &torrentIDs);
     void disableTrackerFilter();
+    // Matches the torrents whose name contains the text using the name index of TorrentFilterIndex,
+    // pass empty string to disable it
+    void setNameFilter(const QString &text);
 
 private:
+    struct SortKey
+    {
+        QVariant value;
+        QVariant additionalValue;
+        // Precomputed for the columns sorted in natural order
+        std::optional<Utils::Compare::NaturalSortKey> naturalKey;
+    };
+
+    const SortKey &sortKey(const QModelIndex &index) const;
+    void invalidateSortKeys(const QModelIndex &topLeft, const QModelIndex &bottomRight);
+    void clearSortKeys();
     int compare(const QModelIndex &left, const QModelIndex &right) const;
 
     bool lessThan(const QModelIndex &left, const QModelIndex &right) const override;
@@ -65,10 +86,18 @@ private:
     bool matchFilter(int sourceRow, const QModelIndex &sourceParent) const;
 
     TorrentFilter m_filter;
+    QString m_nameFilter;
     CachedSettingValue<int> m_subSortColumn;
     CachedSettingValue<int> m_subSortOrder;
     int m_lastSortColumn = -1;
     int m_lastSortOrder = 0;
 
     Utils::Compare::NaturalCompare<Qt::CaseInsensitive> m_naturalCompare;
+
+    // Sort keys of the source rows per column. They are kept until the source data is changed
+    // so only the rows with changed data need to be queried when they are moved to their new positions.
+    mutable QHash<int, QList<std::optional<SortKey>>> m_sortKeys;
+    mutable QBitArray m_matchingTorrents;
+    mutable std::optional<quint64> m_matchingTorrentsRevision;
+    QList<QMetaObject::Connection> m_sourceModelConnections;
 };
@@ -40,8 +40,10 @@
 #include <QMessageBox>
 #include <QMimeData>
 #include <QRegularExpression>
+#include <QScrollBar>
 #include <QSet>
 #include <QShortcut>
+#include <QTimer>
 #include <QWheelEvent>
 
 #include "base/bittorrent/session.h"
@@ -55,6 +57,7 @@
 #include "base/utils/compare.h"
 #include "base/utils/fs.h"
 #include "base/utils/misc.h"
+#include "base/utils/regex.h"
 #include "base/utils/string.h"
 #include "autoexpandabledialog.h"
 #include "deletionconfirmationdialog.h"
@@ -79,6 +82,8 @@
 #include "macutilities.h"
 #endif
 
+using namespace std::chrono_literals;
+
 namespace
 {
     QList<BitTorrent::TorrentID> extractIDs(const QList<BitTorrent::Torrent *> &torrents)
@@ -118,6 +123,7 @@ TransferListWidget::TransferListWidget(IGUIApplication *app, QWidget *parent)
     : GUIApplicationComponent(app, parent)
     , m_listModel {new TransferListModel(this)}
     , m_sortFilterModel {new TransferListSortModel(this)}
+    , m_watchedTorrentsTimer {new QTimer(this)}
 {
     // Load settings
     const bool columnLoaded = loadSettings();
@@ -227,10 +233,24 @@ TransferListWidget::TransferListWidget(IGUIApplication *app, QWidget *parent)
     connect(recheckHotkey, &QShortcut::activated, this, &TransferListWidget::recheckSelectedTorrents);
     const auto *forceStartHotkey = new QShortcut((Qt::CTRL | Qt::Key_M), this, nullptr, nullptr, Qt::WidgetShortcut);
     connect(forceStartHotkey, &QShortcut::activated, this, &TransferListWidget::forceStartSelectedTorrents);
+
+    // The torrents which are shown or selected are watched so that their details are kept up to date
+    m_watchedTorrentsTimer->setSingleShot(true);
+    m_watchedTorrentsTimer->setInterval(200ms);
+    connect(m_watchedTorrentsTimer, &QTimer::timeout, this, &TransferListWidget::updateWatchedTorrents);
+    const auto scheduleWatchedTorrentsUpdate = [this] { m_watchedTorrentsTimer->start(); };
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, this, scheduleWatchedTorrentsUpdate);
+    connect(selectionModel(), &QItemSelectionModel::selectionChanged, this, scheduleWatchedTorrentsUpdate);
+    connect(m_sortFilterModel, &QAbstractItemModel::layoutChanged, this, scheduleWatchedTorrentsUpdate);
+    connect(m_sortFilterModel, &QAbstractItemModel::modelReset, this, scheduleWatchedTorrentsUpdate);
+    connect(m_sortFilterModel, &QAbstractItemModel::rowsInserted, this, scheduleWatchedTorrentsUpdate);
+    connect(m_sortFilterModel, &QAbstractItemModel::rowsRemoved, this, scheduleWatchedTorrentsUpdate);
 }
 
 TransferListWidget::~TransferListWidget()
 {
+    BitTorrent::Session::instance()->setWatchedTorrents(this, {});
+
     // Save settings
     saveSettings();
 }
@@ -332,10 +352,36 @@ QList<BitTorrent::Torrent *> TransferListWidget::getVisibleTorrents() const
     QList<BitTorrent::Torrent *> torrents;
     torrents.reserve(visibleTorrentsCount);
     for (int i = 0; i < visibleTorrentsCount; ++i)
-        torrents << m_listModel->torrentHandle(mapToSource(m_sortFilterModel->index(i, 0)));
+    {
+        // placeholder rows have no torrent
+        if (BitTorrent::Torrent *torrent = m_listModel->torrentHandle(mapToSource(m_sortFilterModel->index(i, 0))))
+            torrents << torrent;
+    }
     return torrents;
 }
 
+void TransferListWidget::updateWatchedTorrents()
+{
+    QSet<BitTorrent::TorrentID> torrentIDs;
+    for (const BitTorrent::Torrent *torrent : asConst(getSelectedTorrents()))
+        torrentIDs.insert(torrent->id());
+
+    const QRect viewportRect = viewport()->rect();
+    if (const QModelIndex firstIndex = indexAt(viewportRect.topLeft()); firstIndex.isValid())
+    {
+        const QModelIndex lastIndex = indexAt(viewportRect.bottomLeft());
+        const int lastRow = lastIndex.isValid() ? lastIndex.row() : (m_sortFilterModel->rowCount() - 1);
+        for (int row = firstIndex.row(); row <= lastRow; ++row)
+        {
+            // placeholder rows have no torrent
+            if (const BitTorrent::Torrent *torrent = m_listModel->torrentHandle(mapToSource(m_sortFilterModel->index(row, 0))))
+                torrentIDs.insert(torrent->id());
+        }
+    }
+
+    BitTorrent::Session::instance()->setWatchedTorrents(this, torrentIDs);
+}
+
 void TransferListWidget::setSelectedTorrentsLocation()
 {
     const QList<BitTorrent::Torrent *> torrents = getSelectedTorrents();
@@ -806,6 +852,7 @@ void TransferListWidget::editTorrentTrackers()
 
     connect(trackerDialog, &QDialog::accepted, this, [torrents, trackerDialog]()
     {
+        const BitTorrent::Session::BulkUpdateScope bulkUpdate;
         for (BitTorrent::Torrent *torrent : torrents)
             torrent->replaceTrackers(trackerDialog->trackers());
     });
@@ -912,6 +959,7 @@ void TransferListWidget::applyToSelectedTorrents(const std::function<void (BitTo
     // the indexes previously obtained from selection model before we process them all.
     // Therefore, we must map all the selected indexes to source before start processing them.
     const QModelIndexList sourceRows = mapToSource(selectionModel()->selectedRows());
+    const BitTorrent::Session::BulkUpdateScope bulkUpdate;
     for (const QModelIndex &index : sourceRows)
     {
         BitTorrent::Torrent *const torrent = m_listModel->torrentHandle(index);
@@ -1354,10 +1402,20 @@ void TransferListWidget::applyTrackerFilter(const QSet<BitTorrent::TorrentID> &t
 
 void TransferListWidget::applyFilter(const QString &name, const TransferListModel::Column &type)
 {
+    const bool isRegex = Preferences::instance()->getRegexAsFilteringPatternForTransferList();
+    // Plain text in torrent names is found by the name index instead of matching each row
+    const bool isPlainText = !isRegex && !name.contains(u'*') && !name.contains(u'?') && !name.contains(u'[');
+    if ((type == TransferListModel::TR_NAME) && isPlainText)
+    {
+        m_sortFilterModel->setFilterRegularExpression(QRegularExpression());
+        m_sortFilterModel->setNameFilter(name);
+        return;
+    }
+
+    m_sortFilterModel->setNameFilter({});
     m_sortFilterModel->setFilterKeyColumn(type);
-    const QString pattern = (Preferences::instance()->getRegexAsFilteringPatternForTransferList()
-                ? name : Utils::String::wildcardToRegexPattern(name));
-    m_sortFilterModel->setFilterRegularExpression(QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption));
+    const QString pattern = (isRegex ? name : Utils::String::wildcardToRegexPattern(name));
+    m_sortFilterModel->setFilterRegularExpression(Utils::Regex::cached(pattern, QRegularExpression::CaseInsensitiveOption));
 }
 
 void TransferListWidget::applyStatusFilter(const int filterIndex)
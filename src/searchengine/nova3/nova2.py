@@ -1,4 +1,4 @@
-# VERSION: 1.50
+# VERSION: 1.53
 
 # Author:
 #  Fabien Devaux <fab AT gnux DOT info>
@@ -142,6 +142,7 @@ def get_capabilities(engines: Iterable[EngineModuleName]) -> str:
         <name>long name</name>
         <url>http://example.com</url>
         <categories>movies music games</categories>
+        <custom_download>yes</custom_download>
       </engine_module_name>
     </capabilities>
     """
@@ -164,11 +165,25 @@ def get_capabilities(engines: Iterable[EngineModuleName]) -> str:
                                              for key in sorted(engine_class.supported_categories.keys())
                                              if key != Category.all.name))
         ET.SubElement(engine_module_element, 'categories').text = supported_categories
+        # engines without their own `download_torrent()` are downloaded by qBittorrent itself
+        ET.SubElement(engine_module_element, 'custom_download').text = "yes" if hasattr(engine_class, "download_torrent") else "no"
 
     ET.indent(capabilities_element)
     return ET.tostring(capabilities_element, 'unicode')
 
 
+def search_engine(engine_class: type[Engine], what: str, cat: Category) -> None:
+    """ Run search in engine, propagating any exceptions raised by it """
+
+    engine = engine_class()
+    # avoid exceptions due to invalid category
+    if hasattr(engine, 'supported_categories'):
+        if cat.name in engine.supported_categories:
+            engine.search(what, cat.name)
+    else:
+        engine.search(what)
+
+
 def run_search(search_params: tuple[type[Engine], str, Category]) -> bool:
     """ Run search in engine
 
@@ -180,13 +195,7 @@ def run_search(search_params: tuple[type[Engine], str, Category]) -> bool:
 
     engine_class, what, cat = search_params
     try:
-        engine = engine_class()
-        # avoid exceptions due to invalid category
-        if hasattr(engine, 'supported_categories'):
-            if cat.name in engine.supported_categories:
-                engine.search(what, cat.name)
-        else:
-            engine.search(what)
+        search_engine(engine_class, what, cat)
         return True
     except Exception:
         traceback.print_exc()
@@ -205,15 +214,22 @@ if __name__ == "__main__":
 
         prog_name = sys.argv[0]
         prog_usage = (f"Usage: {prog_name} all|engine1[,engine2]* <category> <keywords>\n"
-                      f"To list available engines: {prog_name} --capabilities [--names]\n"
+                      f"To list available engines: {prog_name} --capabilities [--names] [--engines=engine1[,engine2]*]\n"
                       f"Found engines: {','.join(found_engines)}")
 
         if "--capabilities" in sys.argv:
+            # allow probing only the specified engines
+            probed_engines = found_engines
+            for arg in sys.argv:
+                if arg.startswith("--engines="):
+                    requested_engines = set(e.strip() for e in arg[len("--engines="):].split(","))
+                    probed_engines = [e for e in found_engines if e in requested_engines]
+
             if "--names" in sys.argv:
-                print(",".join((e for e in found_engines if import_engine(e) is not None)))
+                print(",".join((e for e in probed_engines if import_engine(e) is not None)))
                 return ExitCode.OK.value
 
-            print(get_capabilities(found_engines))
+            print(get_capabilities(probed_engines))
             return ExitCode.OK.value
         elif len(sys.argv) < 4:
             print(prog_usage, file=sys.stderr)
@@ -0,0 +1,191 @@
+# VERSION: 1.00
+
+# Redistribution and use in source and binary forms, with or without
+# modification, are permitted provided that the following conditions are met:
+#
+#    * Redistributions of source code must retain the above copyright notice,
+#      this list of conditions and the following disclaimer.
+#    * Redistributions in binary form must reproduce the above copyright
+#      notice, this list of conditions and the following disclaimer in the
+#      documentation and/or other materials provided with the distribution.
+#    * Neither the name of the author nor the names of its contributors may be
+#      used to endorse or promote products derived from this software without
+#      specific prior written permission.
+#
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+# AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+# IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE
+# ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR CONTRIBUTORS BE
+# LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR
+# CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF
+# SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS
+# INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN
+# CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+# ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+# POSSIBILITY OF SUCH DAMAGE.
+
+import io
+import os
+import pathlib
+import sys
+import threading
+import traceback
+import urllib.parse
+from concurrent.futures import ThreadPoolExecutor
+from typing import Optional, TextIO
+
+# qbt tend to run this script in 'isolate mode' so append the current path manually
+current_path = str(pathlib.Path(__file__).parent.resolve())
+if current_path not in sys.path:
+    sys.path.append(current_path)
+
+import nova2
+import novaprinter
+
+################################################################################
+# Long-lived search server. Engines stay imported between searches and several
+# searches can run at the same time. It uses a line-based protocol, fields are
+# separated by TAB.
+#
+# Commands (stdin):
+#   search <id> <engine1[,engine2]*|all> <category> <keywords>
+#   cancel <id>
+#
+# Replies (stdout):
+#   result <id> <result line as printed by novaprinter.prettyPrinter()>
+#   error <id> <error message line>
+#   finished <id> <0 = succeeded, 1 = failed, 2 = cancelled>
+################################################################################
+
+MAX_ENGINE_THREADS: int = max(4, 2 * nova2.MAX_THREADS)
+
+QueryId = str
+
+
+class Query:
+    def __init__(self, query_id: QueryId, pending: int) -> None:
+        self.id = query_id
+        self.pending = pending
+        self.success = True
+        self.cancelled = False
+
+
+class Server:
+    def __init__(self, output: TextIO) -> None:
+        self._output = output
+        self._lock = threading.Lock()
+        self._queries: dict[QueryId, Query] = {}
+        self._local = threading.local()
+        self._executor = ThreadPoolExecutor(max_workers=MAX_ENGINE_THREADS)
+
+    def _write(self, kind: str, query_id: QueryId, payload: str) -> None:
+        line = "\t".join((kind, query_id, payload.replace("\r", " ").replace("\n", " ")))
+        with self._lock:
+            print(line, file=self._output, flush=True)
+
+    def _current_query(self) -> Optional[Query]:
+        query: Optional[Query] = getattr(self._local, 'query', None)
+        if query is not None:
+            return query
+
+        # results printed from a thread spawned by the engine itself can only be attributed unambiguously
+        # when there are no other searches in progress
+        with self._lock:
+            if len(self._queries) == 1:
+                return next(iter(self._queries.values()))
+        return None
+
+    def handle_result(self, text: str) -> None:
+        query = self._current_query()
+        if (query is not None) and not query.cancelled:
+            self._write('result', query.id, text)
+
+    def _finish(self, query: Query) -> None:
+        if query.cancelled:
+            return
+        with self._lock:
+            self._queries.pop(query.id, None)
+        self._write('finished', query.id, '0' if query.success else '1')
+
+    def _run_engine(self, query: Query, engine_class: type[nova2.Engine], what: str, category: nova2.Category) -> None:
+        self._local.query = query
+        try:
+            if not query.cancelled:
+                nova2.search_engine(engine_class, what, category)
+        except Exception:
+            query.success = False
+            if not query.cancelled:
+                for message in traceback.format_exc().splitlines():
+                    self._write('error', query.id, message)
+        finally:
+            self._local.query = None
+            with self._lock:
+                query.pending -= 1
+                done = (query.pending == 0)
+            if done:
+                self._finish(query)
+
+    def search(self, query_id: QueryId, engines_param: str, category_param: str, keywords: str) -> None:
+        try:
+            category = nova2.Category[category_param.lower()]
+        except KeyError:
+            self._write('error', query_id, f"Invalid category: {category_param}")
+            self._write('finished', query_id, '1')
+            return
+
+        found_engines = nova2.list_engines()
+        engs = set(e.strip().lower() for e in engines_param.split(','))
+        engines = found_engines if 'all' in engs else [e for e in found_engines if e in engs]
+        engine_classes = [engine_class for e in engines if (engine_class := nova2.import_engine(e)) is not None]
+
+        query = Query(query_id, len(engine_classes))
+        if query.pending == 0:
+            self._write('finished', query_id, '0')
+            return
+
+        with self._lock:
+            self._queries[query_id] = query
+
+        what = urllib.parse.quote(keywords)
+        for engine_class in engine_classes:
+            self._executor.submit(self._run_engine, query, engine_class, what, category)
+
+    def cancel(self, query_id: QueryId) -> None:
+        with self._lock:
+            query = self._queries.pop(query_id, None)
+        if query is None:
+            return
+
+        # running engines cannot be interrupted, so their remaining output is dropped instead
+        query.cancelled = True
+        self._write('finished', query_id, '2')
+
+    def serve(self, commands: TextIO) -> None:
+        for line in commands:
+            parts = line.rstrip("\r\n").split("\t")
+            if (parts[0] == 'search') and (len(parts) >= 5):
+                self.search(parts[1], parts[2], parts[3], "\t".join(parts[4:]))
+            elif (parts[0] == 'cancel') and (len(parts) >= 2):
+                self.cancel(parts[1])
+            elif len(parts[0]) > 0:
+                print(f"Unknown command: {line.strip()}", file=sys.stderr, flush=True)
+
+
+if __name__ == "__main__":
+    def main() -> None:
+        # replies are written to fd 1 directly, so stray output of plugins must not end up there
+        output = open(1, 'w', encoding='utf-8', closefd=False)
+        sys.stdout = sys.stderr
+
+        if isinstance(sys.stdin, io.TextIOWrapper):
+            sys.stdin.reconfigure(encoding='utf-8')
+
+        server = Server(output)
+        novaprinter.setOutputHandler(server.handle_result)
+        server.serve(sys.stdin)
+
+        # stdin was closed, don't wait for searches still in progress
+        sys.stderr.flush()
+        os._exit(0)
+
+    main()
@@ -1,4 +1,4 @@
-# VERSION: 1.53
+# VERSION: 1.54
 
 # Redistribution and use in source and binary forms, with or without
 # modification, are permitted provided that the following conditions are met:
@@ -25,7 +25,8 @@
 # POSSIBILITY OF SUCH DAMAGE.
 
 import re
-from typing import TypedDict, Union
+from collections.abc import Callable
+from typing import Optional, TypedDict, Union
 
 SearchResults = TypedDict('SearchResults', {
     'link': str,
@@ -38,6 +39,14 @@ SearchResults = TypedDict('SearchResults', {
     'pub_date': int  # Optional  # TODO: use `NotRequired[int]` when using Python >= 3.11
 })
 
+# when set (e.g. by the persistent search server), receives the formatted result line instead of stdout
+_outputHandler: Optional[Callable[[str], None]] = None
+
+
+def setOutputHandler(handler: Optional[Callable[[str], None]]) -> None:
+    global _outputHandler
+    _outputHandler = handler
+
 
 def prettyPrinter(dictionary: SearchResults) -> None:
     outtext = "|".join((
@@ -51,6 +60,10 @@ def prettyPrinter(dictionary: SearchResults) -> None:
         str(dictionary.get("pub_date", -1))  # Optional
     ))
 
+    if _outputHandler is not None:
+        _outputHandler(outtext)
+        return
+
     # fd 1 is stdout
     with open(1, 'w', encoding='utf-8', closefd=False) as utf8stdout:
         print(outtext, file=utf8stdout)
@@ -31,7 +31,9 @@
 #include <algorithm>
 
 #include <QHash>
+#include <QJsonArray>
 #include <QJsonDocument>
+#include <QJsonObject>
 #include <QList>
 #include <QMetaObject>
 
@@ -43,6 +45,10 @@ void APIResult::clear()
     data.clear();
     mimeType.clear();
     filename.clear();
+    eventStream = nullptr;
+    contentProducer = nullptr;
+    headers.clear();
+    deferredData.reset();
     status = APIStatus::Ok;
 }
 
@@ -51,11 +57,12 @@ APIController::APIController(IApplication *app, QObject *parent)
 {
 }
 
-APIResult APIController::run(const QString &action, const StringMap &params, const DataMap &data)
+APIResult APIController::run(const QString &action, const StringMap &params, const DataMap &data, const Http::HeaderMap &headers)
 {
     m_result.clear(); // clear result
     m_params = params;
     m_data = data;
+    m_headers = headers;
 
     const QByteArray methodName = action.toLatin1() + "Action";
     if (!QMetaObject::invokeMethod(this, methodName.constData()))
@@ -74,6 +81,11 @@ const DataMap &APIController::data() const
     return m_data;
 }
 
+const Http::HeaderMap &APIController::headers() const
+{
+    return m_headers;
+}
+
 void APIController::requireParams(const QList<QString> &requiredParams) const
 {
     QStringList missingParams;
@@ -111,7 +123,44 @@ void APIController::setResult(const QByteArray &result, const QString &mimeType,
     m_result.filename = filename;
 }
 
+void APIController::setResult(Http::EventStream *eventStream)
+{
+    m_result.eventStream = eventStream;
+}
+
+void APIController::setResult(Http::ContentProducer *contentProducer, const QString &mimeType)
+{
+    m_result.contentProducer = contentProducer;
+    m_result.mimeType = mimeType;
+}
+
+void APIController::setResult(QFuture<QJsonArray> result)
+{
+    m_result.deferredData = result.then(QtFuture::Launch::Sync, [](const QJsonArray &array)
+    {
+        return QJsonDocument(array).toJson(QJsonDocument::Compact);
+    });
+}
+
+void APIController::setResult(QFuture<QJsonObject> result)
+{
+    m_result.deferredData = result.then(QtFuture::Launch::Sync, [](const QJsonObject &object)
+    {
+        return QJsonDocument(object).toJson(QJsonDocument::Compact);
+    });
+}
+
+void APIController::setResult(QFuture<QByteArray> result)
+{
+    m_result.deferredData = result;
+}
+
 void APIController::setStatus(const APIStatus status)
 {
     m_result.status = status;
 }
+
+void APIController::setHeader(const QString &name, const QString &value)
+{
+    m_result.headers[name] = value;
+}
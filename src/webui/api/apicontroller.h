@@ -28,12 +28,18 @@
 
 #pragma once
 
+#include <optional>
+
 #include <QtContainerFwd>
+#include <QByteArray>
+#include <QFuture>
+#include <QJsonDocument>
 #include <QObject>
 #include <QString>
 #include <QVariant>
 
 #include "base/applicationcomponent.h"
+#include "base/http/types.h"
 #include "apistatus.h"
 
 using DataMap = QHash<QString, QByteArray>;
@@ -44,6 +50,12 @@ struct APIResult
     QVariant data;
     QString mimeType;
     QString filename;
+    Http::EventStream *eventStream = nullptr;
+    Http::ContentProducer *contentProducer = nullptr;
+    // Additional headers of the response
+    Http::HeaderMap headers;
+    // If set, the response is sent once the serialized JSON is ready instead of data
+    std::optional<QFuture<QByteArray>> deferredData;
     APIStatus status = APIStatus::Ok;
 
     void clear();
@@ -57,22 +69,33 @@ class APIController : public ApplicationComponent<QObject>
 public:
     explicit APIController(IApplication *app, QObject *parent = nullptr);
 
-    APIResult run(const QString &action, const StringMap &params, const DataMap &data = {});
+    APIResult run(const QString &action, const StringMap &params, const DataMap &data = {}, const Http::HeaderMap &headers = {});
 
 protected:
     const StringMap &params() const;
     const DataMap &data() const;
+    // Headers of the request, only available to the actions that are not run in batch
+    const Http::HeaderMap &headers() const;
     void requireParams(const QList<QString> &requiredParams) const;
-
     void setResult(const QString &result);
     void setResult(const QJsonArray &result);
     void setResult(const QJsonObject &result);
     void setResult(const QByteArray &result, const QString &mimeType = {}, const QString &filename = {});
+    void setResult(Http::EventStream *eventStream);
+    void setResult(Http::ContentProducer *contentProducer, const QString &mimeType);
+    // The action is finished without waiting for the result, e.g. one fetched from libtorrent thread.
+    // APIError thrown while the result is produced is sent as the response.
+    void setResult(QFuture<QJsonArray> result);
+    void setResult(QFuture<QJsonObject> result);
+    // The result is serialized JSON, e.g. written by Utils::JsonWriter
+    void setResult(QFuture<QByteArray> result);
 
     void setStatus(APIStatus status);
+    void setHeader(const QString &name, const QString &value);
 
 private:
     StringMap m_params;
     DataMap m_data;
+    Http::HeaderMap m_headers;
     APIResult m_result;
 };
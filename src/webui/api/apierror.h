@@ -37,6 +37,7 @@ enum class APIErrorType
     BadData,
     Conflict,
     NotFound,
+    RangeNotSatisfiable,
     Unauthorized
 };
 
@@ -31,5 +31,6 @@
 enum class APIStatus
 {
     Ok,
-    Async
+    Async,
+    PartialContent
 };
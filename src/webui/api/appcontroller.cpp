@@ -51,7 +51,9 @@
 #include "base/bittorrent/session.h"
 #include "base/global.h"
 #include "base/interfaces/iapplication.h"
+#include "base/logger.h"
 #include "base/net/downloadmanager.h"
+#include "base/net/geoipmanager.h"
 #include "base/net/portforwarder.h"
 #include "base/net/proxyconfigurationmanager.h"
 #include "base/path.h"
@@ -69,6 +71,7 @@
 #include "base/utils/string.h"
 #include "base/version.h"
 #include "apierror.h"
+#include "isessionmanager.h"
 #include "../webapplication.h"
 
 using namespace std::chrono_literals;
@@ -84,6 +87,28 @@ const QString KEY_FILE_METADATA_SIZE = u"size"_s;
 const QString KEY_FILE_METADATA_CREATION_DATE = u"creation_date"_s;
 const QString KEY_FILE_METADATA_LAST_ACCESS_DATE = u"last_access_date"_s;
 const QString KEY_FILE_METADATA_LAST_MODIFICATION_DATE = u"last_modification_date"_s;
+const QString KEY_MEMORY_USAGE_TORRENTS = u"torrents"_s;
+const QString KEY_MEMORY_USAGE_LOG = u"log"_s;
+const QString KEY_MEMORY_USAGE_RSS = u"rss"_s;
+const QString KEY_MEMORY_USAGE_SEARCH = u"search"_s;
+const QString KEY_MEMORY_USAGE_WEBUI = u"webui"_s;
+const QString KEY_MEMORY_USAGE_GEOIP = u"geoip"_s;
+// in the order of `Log::Category` values
+const QString LOG_CATEGORY_KEYS[Log::CATEGORY_COUNT] =
+{
+    u"general"_s,
+    u"peers"_s,
+    u"trackers"_s,
+    u"network"_s,
+    u"storage"_s,
+    u"performance"_s
+};
+
+AppController::AppController(ISessionManager *sessionManager, IApplication *app, QObject *parent)
+    : APIController(app, parent)
+    , m_sessionManager {sessionManager}
+{
+}
 
 void AppController::webapiVersionAction()
 {
@@ -220,6 +245,10 @@ void AppController::preferencesAction()
     // Run an external program on torrent finished
     data[u"autorun_enabled"_s] = pref->isAutoRunOnTorrentFinishedEnabled();
     data[u"autorun_program"_s] = pref->getAutoRunOnTorrentFinishedProgram();
+    // External program execution
+    data[u"autorun_max_processes"_s] = pref->getAutoRunMaxProcesses();
+    data[u"autorun_timeout"_s] = pref->getAutoRunTimeout();
+    data[u"autorun_batching_enabled"_s] = pref->isAutoRunBatchingEnabled();
 
     // Connection
     // Listening Port
@@ -233,6 +262,10 @@ void AppController::preferencesAction()
     data[u"max_connec_per_torrent"_s] = session->maxConnectionsPerTorrent();
     data[u"max_uploads"_s] = session->maxUploads();
     data[u"max_uploads_per_torrent"_s] = session->maxUploadsPerTorrent();
+    data[u"unchoke_slots_tuning_enabled"_s] = session->isUnchokeSlotsTuningEnabled();
+    data[u"dormant_seeds_enabled"_s] = session->isDormantSeedsEnabled();
+    data[u"dormant_seed_idle_time"_s] = session->dormantSeedIdleTime();
+    data[u"dormant_seed_scrape_interval"_s] = session->dormantSeedScrapeInterval();
 
     // I2P
     data[u"i2p_enabled"_s] = session->isI2PEnabled();
@@ -324,6 +357,17 @@ void AppController::preferencesAction()
     data[u"anonymous_mode"_s] = session->isAnonymousModeEnabled();
     // Max active checking torrents
     data[u"max_active_checking_torrents"_s] = session->maxActiveCheckingTorrents();
+    // Disk-aware checking
+    data[u"disk_aware_checking_enabled"_s] = session->isDiskAwareCheckingEnabled();
+    data[u"max_active_checking_torrents_per_volume"_s] = session->maxActiveCheckingTorrentsPerVolume();
+    // Max active metadata downloads
+    data[u"max_active_metadata_downloads"_s] = session->maxActiveMetadataDownloads();
+    const QHash<QString, int> volumeLimits = session->checkingVolumeLimits();
+    QJsonObject checkingVolumeLimits;
+    for (auto i = volumeLimits.cbegin(); i != volumeLimits.cend(); ++i)
+        checkingVolumeLimits[i.key()] = i.value();
+    data[u"checking_volume_limits"_s] = checkingVolumeLimits;
+    data[u"checking_queue_order"_s] = Utils::String::fromEnum(session->checkingQueueOrder());
     // Torrent Queueing
     data[u"queueing_enabled"_s] = session->isQueueingSystemEnabled();
     data[u"max_active_downloads"_s] = session->maxActiveDownloads();
@@ -368,6 +412,13 @@ void AppController::preferencesAction()
     data[u"web_ui_max_auth_fail_count"_s] = pref->getWebUIMaxAuthFailCount();
     data[u"web_ui_ban_duration"_s] = static_cast<int>(pref->getWebUIBanDuration().count());
     data[u"web_ui_session_timeout"_s] = pref->getWebUISessionTimeout();
+    data[u"web_ui_request_budget_enabled"_s] = pref->isWebUIRequestBudgetEnabled();
+    data[u"web_ui_request_budget_rate"_s] = pref->getWebUIRequestBudgetRate();
+    data[u"web_ui_request_budget_burst"_s] = pref->getWebUIRequestBudgetBurst();
+    data[u"web_ui_worker_threads"_s] = pref->getWebUIWorkerThreadCount();
+    data[u"web_ui_http2_enabled"_s] = pref->isWebUIHTTP2Enabled();
+    data[u"web_ui_local_socket_enabled"_s] = pref->isWebUILocalSocketEnabled();
+    data[u"web_ui_local_socket_name"_s] = pref->getWebUILocalSocketName();
     // API key
     data[u"web_ui_api_key"_s] = pref->getWebUIApiKey();
     // Use alternative WebUI
@@ -384,6 +435,10 @@ void AppController::preferencesAction()
     // Reverse proxy
     data[u"web_ui_reverse_proxy_enabled"_s] = pref->isWebUIReverseProxySupportEnabled();
     data[u"web_ui_reverse_proxies_list"_s] = pref->getWebUITrustedReverseProxiesList();
+    // Metrics
+    data[u"web_ui_metrics_enabled"_s] = pref->isWebUIMetricsEnabled();
+    // Federation
+    data[u"web_ui_federation_nodes"_s] = pref->getWebUIFederationNodes();
     // Update my dynamic domain name
     data[u"dyndns_enabled"_s] = pref->isDynDNSEnabled();
     data[u"dyndns_service"_s] = static_cast<int>(pref->getDynDNSService());
@@ -404,10 +459,26 @@ void AppController::preferencesAction()
     // qBitorrent preferences
     // Resume data storage type
     data[u"resume_data_storage_type"_s] = Utils::String::fromEnum(session->resumeDataStorageType());
+    // SQLite database transaction size
+    data[u"resume_data_storage_batch_size"_s] = session->resumeDataStorageBatchSize();
+    // Compress resume data stored in SQLite database
+    data[u"resume_data_storage_compression_enabled"_s] = session->isResumeDataStorageCompressionEnabled();
+    // Release metadata of inactive stopped torrents
+    data[u"stopped_torrents_cold_mode_enabled"_s] = session->isStoppedTorrentsColdModeEnabled();
     // Torrent content removing mode
     data[u"torrent_content_remove_option"_s] = Utils::String::fromEnum(session->torrentContentRemoveOption());
+    data[u"torrent_content_removing_rate"_s] = session->torrentContentRemovingRate();
+    data[u"low_disk_space_threshold"_s] = session->lowDiskSpaceThreshold();
     // Physical memory (RAM) usage limit
     data[u"memory_working_set_limit"_s] = app()->memoryWorkingSetLimit();
+    // Thread scheduling
+    data[u"lower_bulk_work_priority"_s] = app()->isBulkWorkPriorityLowered();
+    data[u"latency_sensitive_threads_cpu_affinity"_s] = app()->latencySensitiveThreadsCPUAffinity();
+    // Log verbosity
+    QJsonObject logMessageTypes;
+    for (int i = 0; i < Log::CATEGORY_COUNT; ++i)
+        logMessageTypes[LOG_CATEGORY_KEYS[i]] = pref->getLogMessageTypes(static_cast<Log::Category>(i)).toInt();
+    data[u"log_message_types"_s] = logMessageTypes;
     // Current network interface
     data[u"current_network_interface"_s] = session->networkInterface();
     // Current network interface name
@@ -440,6 +511,8 @@ void AppController::preferencesAction()
     data[u"mark_of_the_web"_s] = pref->isMarkOfTheWebEnabled();
     // Ignore SSL errors
     data[u"ignore_ssl_errors"_s] = pref->isIgnoreSSLErrors();
+    // Max downloads per host
+    data[u"max_downloads_per_host"_s] = pref->maxDownloadsPerHost();
     // Python executable path
     data[u"python_executable_path"_s] = pref->getPythonExecutablePath().toString();
 
@@ -448,6 +521,8 @@ void AppController::preferencesAction()
     data[u"bdecode_depth_limit"_s] = pref->getBdecodeDepthLimit();
     // Bdecode token limit
     data[u"bdecode_token_limit"_s] = pref->getBdecodeTokenLimit();
+    // Performance profile
+    data[u"performance_profile"_s] = Utils::String::fromEnum(session->performanceProfile());
     // Async IO threads
     data[u"async_io_threads"_s] = session->asyncIOThreads();
     // Hashing threads
@@ -459,6 +534,11 @@ void AppController::preferencesAction()
     // Disk write cache
     data[u"disk_cache"_s] = session->diskCacheSize();
     data[u"disk_cache_ttl"_s] = session->diskCacheTTL();
+    data[u"disk_read_cache"_s] = session->diskReadCacheSize();
+    data[u"persistent_read_cache_path"_s] = session->persistentReadCachePath().toString();
+    data[u"persistent_read_cache_size"_s] = session->persistentReadCacheSize();
+    data[u"disk_write_coalescing_size"_s] = session->diskWriteCoalescingSize();
+    data[u"disk_write_coalescing_time"_s] = session->diskWriteCoalescingTime();
     // Disk queue size
     data[u"disk_queue_size"_s] = session->diskQueueSize();
     // Disk IO Type
@@ -467,6 +547,8 @@ void AppController::preferencesAction()
     data[u"disk_io_read_mode"_s] = static_cast<int>(session->diskIOReadMode());
     // Disk IO write mode
     data[u"disk_io_write_mode"_s] = static_cast<int>(session->diskIOWriteMode());
+    // Native session shards
+    data[u"native_session_shards"_s] = session->nativeSessionShards();
     // Coalesce reads & writes
     data[u"enable_coalesce_read_write"_s] = session->isCoalesceReadWriteEnabled();
     // Piece Extent Affinity
@@ -720,6 +802,13 @@ void AppController::setPreferencesAction()
         pref->setAutoRunOnTorrentFinishedEnabled(it.value().toBool());
     if (hasKey(u"autorun_program"_s))
         pref->setAutoRunOnTorrentFinishedProgram(it.value().toString().trimmed());
+    // External program execution
+    if (hasKey(u"autorun_max_processes"_s))
+        pref->setAutoRunMaxProcesses(it.value().toInt());
+    if (hasKey(u"autorun_timeout"_s))
+        pref->setAutoRunTimeout(it.value().toInt());
+    if (hasKey(u"autorun_batching_enabled"_s))
+        pref->setAutoRunBatchingEnabled(it.value().toBool());
 
     // Connection
     // Listening Port
@@ -747,6 +836,14 @@ void AppController::setPreferencesAction()
         session->setMaxUploads(it.value().toInt());
     if (hasKey(u"max_uploads_per_torrent"_s))
         session->setMaxUploadsPerTorrent(it.value().toInt());
+    if (hasKey(u"unchoke_slots_tuning_enabled"_s))
+        session->setUnchokeSlotsTuningEnabled(it.value().toBool());
+    if (hasKey(u"dormant_seeds_enabled"_s))
+        session->setDormantSeedsEnabled(it.value().toBool());
+    if (hasKey(u"dormant_seed_idle_time"_s))
+        session->setDormantSeedIdleTime(it.value().toInt());
+    if (hasKey(u"dormant_seed_scrape_interval"_s))
+        session->setDormantSeedScrapeInterval(it.value().toInt());
 
     // I2P
     if (hasKey(u"i2p_enabled"_s))
@@ -888,6 +985,24 @@ void AppController::setPreferencesAction()
     // Max active checking torrents
     if (hasKey(u"max_active_checking_torrents"_s))
         session->setMaxActiveCheckingTorrents(it.value().toInt());
+    // Disk-aware checking
+    if (hasKey(u"disk_aware_checking_enabled"_s))
+        session->setDiskAwareCheckingEnabled(it.value().toBool());
+    if (hasKey(u"max_active_checking_torrents_per_volume"_s))
+        session->setMaxActiveCheckingTorrentsPerVolume(it.value().toInt());
+    // Max active metadata downloads
+    if (hasKey(u"max_active_metadata_downloads"_s))
+        session->setMaxActiveMetadataDownloads(it.value().toInt());
+    if (hasKey(u"checking_volume_limits"_s))
+    {
+        QHash<QString, int> checkingVolumeLimits;
+        const QVariantHash limits = it.value().toHash();
+        for (auto i = limits.cbegin(); i != limits.cend(); ++i)
+            checkingVolumeLimits.insert(i.key(), i.value().toInt());
+        session->setCheckingVolumeLimits(checkingVolumeLimits);
+    }
+    if (hasKey(u"checking_queue_order"_s))
+        session->setCheckingQueueOrder(Utils::String::toEnum(it.value().toString(), BitTorrent::CheckingQueueOrder::QueuePosition));
     // Torrent Queueing
     if (hasKey(u"queueing_enabled"_s))
         session->setQueueingSystemEnabled(it.value().toBool());
@@ -983,6 +1098,20 @@ void AppController::setPreferencesAction()
         pref->setWebUIBanDuration(std::chrono::seconds {it.value().toInt()});
     if (hasKey(u"web_ui_session_timeout"_s))
         pref->setWebUISessionTimeout(it.value().toInt());
+    if (hasKey(u"web_ui_request_budget_enabled"_s))
+        pref->setWebUIRequestBudgetEnabled(it.value().toBool());
+    if (hasKey(u"web_ui_request_budget_rate"_s))
+        pref->setWebUIRequestBudgetRate(it.value().toInt());
+    if (hasKey(u"web_ui_request_budget_burst"_s))
+        pref->setWebUIRequestBudgetBurst(it.value().toInt());
+    if (hasKey(u"web_ui_worker_threads"_s))
+        pref->setWebUIWorkerThreadCount(it.value().toInt());
+    if (hasKey(u"web_ui_http2_enabled"_s))
+        pref->setWebUIHTTP2Enabled(it.value().toBool());
+    if (hasKey(u"web_ui_local_socket_enabled"_s))
+        pref->setWebUILocalSocketEnabled(it.value().toBool());
+    if (hasKey(u"web_ui_local_socket_name"_s))
+        pref->setWebUILocalSocketName(it.value().toString());
     // Use alternative WebUI
     if (hasKey(u"alternative_webui_enabled"_s))
         pref->setAltWebUIEnabled(it.value().toBool());
@@ -1007,6 +1136,12 @@ void AppController::setPreferencesAction()
         pref->setWebUIReverseProxySupportEnabled(it.value().toBool());
     if (hasKey(u"web_ui_reverse_proxies_list"_s))
         pref->setWebUITrustedReverseProxiesList(it.value().toString());
+    // Metrics
+    if (hasKey(u"web_ui_metrics_enabled"_s))
+        pref->setWebUIMetricsEnabled(it.value().toBool());
+    // Federation
+    if (hasKey(u"web_ui_federation_nodes"_s))
+        pref->setWebUIFederationNodes(it.value().toString());
     // Update my dynamic domain name
     if (hasKey(u"dyndns_enabled"_s))
         pref->setDynDNSEnabled(it.value().toBool());
@@ -1039,12 +1174,41 @@ void AppController::setPreferencesAction()
     // Resume data storage type
     if (hasKey(u"resume_data_storage_type"_s))
         session->setResumeDataStorageType(Utils::String::toEnum(it.value().toString(), BitTorrent::ResumeDataStorageType::Legacy));
+    // SQLite database transaction size
+    if (hasKey(u"resume_data_storage_batch_size"_s))
+        session->setResumeDataStorageBatchSize(it.value().toInt());
+    // Compress resume data stored in SQLite database
+    if (hasKey(u"resume_data_storage_compression_enabled"_s))
+        session->setResumeDataStorageCompressionEnabled(it.value().toBool());
+    // Release metadata of inactive stopped torrents
+    if (hasKey(u"stopped_torrents_cold_mode_enabled"_s))
+        session->setStoppedTorrentsColdModeEnabled(it.value().toBool());
     // Torrent content removing mode
     if (hasKey(u"torrent_content_remove_option"_s))
         session->setTorrentContentRemoveOption(Utils::String::toEnum(it.value().toString(), BitTorrent::TorrentContentRemoveOption::MoveToTrash));
+    if (hasKey(u"torrent_content_removing_rate"_s))
+        session->setTorrentContentRemovingRate(it.value().toInt());
+    // Low disk space threshold
+    if (hasKey(u"low_disk_space_threshold"_s))
+        session->setLowDiskSpaceThreshold(it.value().toInt());
     // Physical memory (RAM) usage limit
     if (hasKey(u"memory_working_set_limit"_s))
         app()->setMemoryWorkingSetLimit(it.value().toInt());
+    // Thread scheduling
+    if (hasKey(u"lower_bulk_work_priority"_s))
+        app()->setBulkWorkPriorityLowered(it.value().toBool());
+    if (hasKey(u"latency_sensitive_threads_cpu_affinity"_s))
+        app()->setLatencySensitiveThreadsCPUAffinity(it.value().toString());
+    // Log verbosity
+    if (hasKey(u"log_message_types"_s))
+    {
+        const QVariantHash logMessageTypes = it.value().toHash();
+        for (int i = 0; i < Log::CATEGORY_COUNT; ++i)
+        {
+            if (const auto typesIter = logMessageTypes.constFind(LOG_CATEGORY_KEYS[i]); typesIter != logMessageTypes.cend())
+                pref->setLogMessageTypes(static_cast<Log::Category>(i), Log::MsgTypes::fromInt(typesIter->toInt()));
+        }
+    }
     // Current network interface
     if (hasKey(u"current_network_interface"_s))
     {
@@ -1107,6 +1271,9 @@ void AppController::setPreferencesAction()
     // Ignore SLL errors
     if (hasKey(u"ignore_ssl_errors"_s))
         pref->setIgnoreSSLErrors(it.value().toBool());
+    // Max downloads per host
+    if (hasKey(u"max_downloads_per_host"_s))
+        pref->setMaxDownloadsPerHost(it.value().toInt());
     // Python executable path
     if (hasKey(u"python_executable_path"_s))
         pref->setPythonExecutablePath(Path(it.value().toString()));
@@ -1118,6 +1285,9 @@ void AppController::setPreferencesAction()
     // Bdecode token limit
     if (hasKey(u"bdecode_token_limit"_s))
         pref->setBdecodeTokenLimit(it.value().toInt());
+    // Performance profile
+    if (hasKey(u"performance_profile"_s))
+        session->setPerformanceProfile(Utils::String::toEnum(it.value().toString(), BitTorrent::PerformanceProfile::Manual));
     // Async IO threads
     if (hasKey(u"async_io_threads"_s))
         session->setAsyncIOThreads(it.value().toInt());
@@ -1135,6 +1305,19 @@ void AppController::setPreferencesAction()
         session->setDiskCacheSize(it.value().toInt());
     if (hasKey(u"disk_cache_ttl"_s))
         session->setDiskCacheTTL(it.value().toInt());
+    // Disk read cache
+    if (hasKey(u"disk_read_cache"_s))
+        session->setDiskReadCacheSize(it.value().toInt());
+    // Persistent read cache
+    if (hasKey(u"persistent_read_cache_path"_s))
+        session->setPersistentReadCachePath(Path(it.value().toString()));
+    if (hasKey(u"persistent_read_cache_size"_s))
+        session->setPersistentReadCacheSize(it.value().toInt());
+    // Disk write coalescing
+    if (hasKey(u"disk_write_coalescing_size"_s))
+        session->setDiskWriteCoalescingSize(it.value().toInt());
+    if (hasKey(u"disk_write_coalescing_time"_s))
+        session->setDiskWriteCoalescingTime(it.value().toInt());
     // Disk queue size
     if (hasKey(u"disk_queue_size"_s))
         session->setDiskQueueSize(it.value().toLongLong());
@@ -1147,6 +1330,9 @@ void AppController::setPreferencesAction()
     // Disk IO write mode
     if (hasKey(u"disk_io_write_mode"_s))
         session->setDiskIOWriteMode(static_cast<BitTorrent::DiskIOWriteMode>(it.value().toInt()));
+    // Native session shards
+    if (hasKey(u"native_session_shards"_s))
+        session->setNativeSessionShards(it.value().toInt());
     // Coalesce reads & writes
     if (hasKey(u"enable_coalesce_read_write"_s))
         session->setCoalesceReadWriteEnabled(it.value().toBool());
@@ -1448,3 +1634,25 @@ void AppController::networkInterfaceAddressListAction()
 
     setResult(addressList);
 }
+
+// Returns rough estimations of the memory (in bytes) used by the subsystems:
+//   - "torrents": torrents data (not including libtorrent's own data)
+//   - "log": buffered log messages and peer log entries
+//   - "rss": articles of all RSS feeds
+//   - "search": results of the searches started via WebAPI
+//   - "webui": data kept by WebUI sessions for synchronization
+//   - "geoip": GeoIP database and the cache of looked up countries
+void AppController::memoryUsageAction()
+{
+    const SessionsMemoryUsage sessionsMemoryUsage = m_sessionManager->estimatedSessionsMemoryUsage();
+    const Net::GeoIPManager *geoIPManager = Net::GeoIPManager::instance();
+
+    setResult(QJsonObject {
+        {KEY_MEMORY_USAGE_TORRENTS, BitTorrent::Session::instance()->estimatedTorrentsMemoryUsage()},
+        {KEY_MEMORY_USAGE_LOG, Logger::instance()->estimatedMemoryUsage()},
+        {KEY_MEMORY_USAGE_RSS, RSS::Session::instance()->estimatedArticlesMemoryUsage()},
+        {KEY_MEMORY_USAGE_SEARCH, sessionsMemoryUsage.searchResults},
+        {KEY_MEMORY_USAGE_WEBUI, sessionsMemoryUsage.syncData},
+        {KEY_MEMORY_USAGE_GEOIP, (geoIPManager ? geoIPManager->estimatedMemoryUsage() : 0)}
+    });
+}
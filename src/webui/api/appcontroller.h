@@ -32,13 +32,15 @@
 
 #include "apicontroller.h"
 
+struct ISessionManager;
+
 class AppController : public APIController
 {
     Q_OBJECT
     Q_DISABLE_COPY_MOVE(AppController)
 
 public:
-    using APIController::APIController;
+    explicit AppController(ISessionManager *sessionManager, IApplication *app, QObject *parent = nullptr);
 
 private slots:
     void webapiVersionAction();
@@ -57,4 +59,8 @@ private slots:
 
     void networkInterfaceListAction();
     void networkInterfaceAddressListAction();
+    void memoryUsageAction();
+
+private:
+    ISessionManager *m_sessionManager = nullptr;
 };
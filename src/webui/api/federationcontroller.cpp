@@ -0,0 +1,226 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "federationcontroller.h"
+
+#include <algorithm>
+
+#include <QFuture>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QMap>
+#include <QRegularExpression>
+
+#include "base/global.h"
+#include "base/utils/string.h"
+#include "apierror.h"
+#include "webui/federationmanager.h"
+
+namespace
+{
+    const QString KEY_NODE_NAME = u"name"_s;
+    const QString KEY_NODE_URL = u"url"_s;
+    const QString KEY_NODE_SYNCHRONIZED = u"synchronized"_s;
+    const QString KEY_NODE_TORRENTS_COUNT = u"torrents_count"_s;
+    const QString KEY_NODE_ERROR = u"error"_s;
+
+    const QString KEY_TORRENT_HASH = u"hash"_s;
+    const QString KEY_TORRENT_NODE = u"node"_s;
+
+    const QString KEY_TOTAL = u"total"_s;
+    const QString KEY_TORRENTS = u"torrents"_s;
+    const QString KEY_RESULTS = u"results"_s;
+    const QString KEY_UNKNOWN = u"unknown"_s;
+
+    const QString PARAM_ACTION = u"action"_s;
+    const QString PARAM_HASHES = u"hashes"_s;
+
+    // Values of the same field have the same type except "null" of the fields unavailable without metadata
+    bool lessThan(const QJsonValue &left, const QJsonValue &right)
+    {
+        if (left.type() != right.type())
+            return left.type() < right.type();
+
+        switch (left.type())
+        {
+        case QJsonValue::Bool:
+            return left.toBool() < right.toBool();
+        case QJsonValue::Double:
+            return left.toDouble() < right.toDouble();
+        case QJsonValue::String:
+            return left.toString() < right.toString();
+        default:
+            break;
+        }
+        return false;
+    }
+}
+
+FederationController::FederationController(FederationManager *federationManager, IApplication *app, QObject *parent)
+    : APIController(app, parent)
+    , m_federationManager {federationManager}
+{
+}
+
+// Returns the nodes of the federation and their synchronization states
+void FederationController::nodesAction()
+{
+    const QList<FederationManager::NodeStatus> statuses = m_federationManager->nodeStatuses();
+    QJsonArray nodes;
+    for (const FederationManager::NodeStatus &status : statuses)
+    {
+        nodes.append(QJsonObject {
+            {KEY_NODE_NAME, status.name},
+            {KEY_NODE_URL, status.url},
+            {KEY_NODE_SYNCHRONIZED, status.isSynchronized},
+            {KEY_NODE_TORRENTS_COUNT, static_cast<qint64>(status.torrentsCount)},
+            {KEY_NODE_ERROR, status.errorMessage}
+        });
+    }
+
+    setResult(nodes);
+}
+
+// Returns the torrents of the nodes in the format of "sync/maindata" torrents,
+// each of them also has "hash" and "node" fields
+// GET params:
+//   - node (string): the node to get the torrents of, all the nodes if it isn't presented
+//   - sort (string): name of field for sorting by its value
+//   - reverse (bool): enable reverse sorting
+//   - limit (int): set limit number of torrents returned (if greater than 0, otherwise - unlimited)
+//   - offset (int): set offset (if less than 0 - offset from end)
+void FederationController::torrentsAction()
+{
+    const QString nodeName {params()[KEY_TORRENT_NODE]};
+    const QString sortedField {params()[u"sort"_s]};
+    const bool reverse {Utils::String::parseBool(params()[u"reverse"_s]).value_or(false)};
+    qsizetype limit {params()[u"limit"_s].toInt()};
+    qsizetype offset {params()[u"offset"_s].toInt()};
+
+    if (!nodeName.isEmpty() && !m_federationManager->hasNode(nodeName))
+        throw APIError(APIErrorType::NotFound, tr("Node not found"));
+
+    QList<FederationManager::TorrentEntry> torrents = m_federationManager->torrents(nodeName);
+
+    const qsizetype size = torrents.size();
+    // normalize offset
+    if (offset < 0)
+        offset = std::max<qsizetype>((size + offset), 0);
+    // normalize limit
+    if (limit <= 0)
+        limit = -1; // unlimited
+
+    if (!sortedField.isEmpty())
+    {
+        // only the requested page is fully sorted
+        const qsizetype sortedCount = (limit > 0) ? std::clamp<qsizetype>((offset + limit), 0, size) : size;
+        std::ranges::partial_sort(torrents, (torrents.begin() + sortedCount)
+            , [&sortedField, reverse](const FederationManager::TorrentEntry &left, const FederationManager::TorrentEntry &right)
+        {
+            const QJsonValue leftValue = left.data.value(sortedField);
+            const QJsonValue rightValue = right.data.value(sortedField);
+            return reverse ? lessThan(rightValue, leftValue) : lessThan(leftValue, rightValue);
+        });
+    }
+
+    if ((limit > 0) || (offset > 0))
+        torrents = torrents.mid(offset, limit);
+
+    QJsonArray torrentList;
+    for (const FederationManager::TorrentEntry &entry : asConst(torrents))
+    {
+        QJsonObject torrent = entry.data;
+        torrent[KEY_TORRENT_HASH] = entry.id;
+        torrent[KEY_TORRENT_NODE] = entry.node;
+        torrentList.append(torrent);
+    }
+
+    setResult(QJsonObject {
+        {KEY_TOTAL, static_cast<qint64>(size)},
+        {KEY_TORRENTS, torrentList}
+    });
+}
+
+// Sends "torrents" API action to the nodes which own the given torrents
+// POST params:
+//   - action (string): name of the action of "torrents" API, e.g. "stop"
+//   - hashes (string): hashes of the torrents separated by |, each node gets the ones it owns
+//   - other params are passed to the action as is
+void FederationController::forwardAction()
+{
+    requireParams({PARAM_ACTION, PARAM_HASHES});
+
+    const QString action = params()[PARAM_ACTION];
+    const QRegularExpression actionPattern {u"^[A-Za-z_][A-Za-z_0-9]*$"_s};
+    if (!actionPattern.match(action).hasMatch())
+        throw APIError(APIErrorType::BadParams, tr("'action' parameter is invalid"));
+
+    const QStringList hashes = params()[PARAM_HASHES].split(u'|', Qt::SkipEmptyParts);
+    QMap<QString, QStringList> nodeHashes;
+    QJsonArray unknownHashes;
+    for (const QString &hash : hashes)
+    {
+        if (const QString nodeName = m_federationManager->torrentNode(hash); !nodeName.isEmpty())
+            nodeHashes[nodeName].append(hash);
+        else
+            unknownHashes.append(hash);
+    }
+
+    if (nodeHashes.isEmpty())
+        throw APIError(APIErrorType::NotFound, tr("Torrents not found"));
+
+    StringMap actionParams = params();
+    actionParams.remove(PARAM_ACTION);
+
+    QList<QFuture<QJsonObject>> results;
+    results.reserve(nodeHashes.size());
+    for (auto iter = nodeHashes.cbegin(); iter != nodeHashes.cend(); ++iter)
+    {
+        actionParams[PARAM_HASHES] = iter.value().join(u'|');
+        results.append(m_federationManager->sendRequest(iter.key(), (u"torrents/" + action), actionParams));
+    }
+
+    setResult(QtFuture::whenAll(results.begin(), results.end())
+        .then(QtFuture::Launch::Sync, [unknownHashes](const QList<QFuture<QJsonObject>> &finishedResults)
+    {
+        QJsonArray nodeResults;
+        for (const QFuture<QJsonObject> &result : finishedResults)
+        {
+            // the result is missing if the request was canceled
+            if (result.resultCount() > 0)
+                nodeResults.append(result.result());
+        }
+
+        return QJsonObject {
+            {KEY_RESULTS, nodeResults},
+            {KEY_UNKNOWN, unknownHashes}
+        };
+    }));
+}
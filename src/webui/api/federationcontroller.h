@@ -1,6 +1,6 @@
 /*
  * Bittorrent Client using Qt and libtorrent.
- * Copyright (C) 2019  sledgehammer999 <hammered999@gmail.com>
+ * Copyright (C) 2026  qBittorrent project
  *
  * This program is free software; you can redistribute it and/or
  * modify it under the terms of the GNU General Public License
@@ -28,21 +28,23 @@
 
 #pragma once
 
-#include <QSortFilterProxyModel>
+#include "apicontroller.h"
 
-#include "base/logger.h"
+class FederationManager;
 
-class LogFilterModel final : public QSortFilterProxyModel
+class FederationController final : public APIController
 {
     Q_OBJECT
-    Q_DISABLE_COPY_MOVE(LogFilterModel)
+    Q_DISABLE_COPY_MOVE(FederationController)
 
 public:
-    explicit LogFilterModel(Log::MsgTypes types = Log::ALL, QObject *parent = nullptr);
-    void setMessageTypes(Log::MsgTypes types);
+    FederationController(FederationManager *federationManager, IApplication *app, QObject *parent = nullptr);
 
-private:
-    bool filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const override;
+private slots:
+    void nodesAction();
+    void torrentsAction();
+    void forwardAction();
 
-    Log::MsgTypes m_types;
+private:
+    FederationManager *m_federationManager = nullptr;
 };
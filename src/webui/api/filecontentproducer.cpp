@@ -0,0 +1,108 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "filecontentproducer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <QTimer>
+
+#include "base/path.h"
+
+namespace
+{
+    const qint64 MAX_PART_SIZE = 256 * 1024;
+    const qint64 MIN_THROTTLED_PART_SIZE = 16 * 1024;
+}
+
+FileContentProducer::FileContentProducer(const Path &filePath, const qint64 position, const qint64 size
+        , RateLimitProvider rateLimitProvider, QObject *parent)
+    : Http::ContentProducer(parent)
+    , m_file {filePath.data()}
+    , m_position {position}
+    , m_remainingSize {size}
+    , m_rateLimitProvider {std::move(rateLimitProvider)}
+{
+}
+
+void FileContentProducer::produce()
+{
+    if (m_isProduceScheduled)
+        return;
+
+    if (m_remainingSize <= 0)
+    {
+        finish();
+        return;
+    }
+
+    if (const qint64 remainingTime = m_throttleDeadline.remainingTime(); remainingTime > 0)
+    {
+        m_isProduceScheduled = true;
+        QTimer::singleShot(remainingTime, this, [this]
+        {
+            m_isProduceScheduled = false;
+            produce();
+        });
+        return;
+    }
+
+    if (!m_file.isOpen())
+    {
+        if (!m_file.open(QIODevice::ReadOnly) || !m_file.seek(m_position))
+        {
+            finish();
+            return;
+        }
+    }
+
+    // smaller parts are sent at low rates, so the transfer is smooth
+    const int rateLimit = m_rateLimitProvider ? m_rateLimitProvider() : 0;
+    const qint64 partSize = (rateLimit > 0)
+            ? std::clamp<qint64>((rateLimit / 4), MIN_THROTTLED_PART_SIZE, MAX_PART_SIZE)
+            : MAX_PART_SIZE;
+
+    const QByteArray data = m_file.read(std::min(partSize, m_remainingSize));
+    if (data.isEmpty())
+    {
+        // the file is truncated or can't be read, so the content is incomplete
+        finish();
+        return;
+    }
+
+    m_position += data.size();
+    m_remainingSize -= data.size();
+    if (rateLimit > 0)
+        m_throttleDeadline.setRemainingTime((data.size() * 1000) / rateLimit);
+
+    write(data);
+
+    if (m_remainingSize <= 0)
+        finish();
+}
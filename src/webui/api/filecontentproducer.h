@@ -0,0 +1,63 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+
+#include <QDeadlineTimer>
+#include <QFile>
+
+#include "base/http/contentproducer.h"
+#include "base/pathfwd.h"
+
+// Produces the content of the file on disk in the given range of bytes. The file is read in parts
+// while it is sent, and no faster than allowed by the rate limit.
+class FileContentProducer final : public Http::ContentProducer
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(FileContentProducer)
+
+public:
+    // Returns the limit of the sending rate in bytes per second, or 0 if it's unlimited
+    using RateLimitProvider = std::function<int ()>;
+
+    FileContentProducer(const Path &filePath, qint64 position, qint64 size
+            , RateLimitProvider rateLimitProvider = {}, QObject *parent = nullptr);
+
+private:
+    void produce() override;
+
+    QFile m_file;
+    qint64 m_position = 0;
+    qint64 m_remainingSize = 0;
+    RateLimitProvider m_rateLimitProvider;
+    // the next part can't be produced earlier, so the rate limit isn't exceeded
+    QDeadlineTimer m_throttleDeadline;
+    bool m_isProduceScheduled = false;
+};
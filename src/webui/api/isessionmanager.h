@@ -38,6 +38,13 @@ struct ISession
     virtual QString id() const = 0;
 };
 
+// Rough estimations of the memory used by the data of all sessions
+struct SessionsMemoryUsage
+{
+    qint64 syncData = 0;
+    qint64 searchResults = 0;
+};
+
 struct ISessionManager
 {
     virtual ~ISessionManager() = default;
@@ -45,4 +52,5 @@ struct ISessionManager
     virtual ISession *session() = 0;
     virtual void sessionStart() = 0;
     virtual void sessionEnd() = 0;
+    virtual SessionsMemoryUsage estimatedSessionsMemoryUsage() const = 0;
 };
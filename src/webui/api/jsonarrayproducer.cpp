@@ -0,0 +1,79 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "jsonarrayproducer.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+    const qsizetype BATCH_SIZE = 100;
+}
+
+JsonArrayProducer::JsonArrayProducer(const qsizetype count, Serializer serializer, QObject *parent)
+    : Http::ContentProducer(parent)
+    , m_count {count}
+    , m_serializer {std::move(serializer)}
+{
+}
+
+void JsonArrayProducer::produce()
+{
+    QByteArray data;
+    if (m_nextIndex == 0)
+        data.append('[');
+
+    // skip the batches without existing elements, the connection waits for some data
+    do
+    {
+        const qsizetype batchEnd = std::min((m_nextIndex + BATCH_SIZE), m_count);
+        for (; m_nextIndex < batchEnd; ++m_nextIndex)
+        {
+            const std::optional<QByteArray> element = m_serializer(m_nextIndex);
+            if (!element)
+                continue;
+
+            if (m_hasElements)
+                data.append(',');
+            data.append(*element);
+            m_hasElements = true;
+        }
+
+        if (m_nextIndex >= m_count)
+        {
+            data.append(']');
+            write(data);
+            finish();
+            return;
+        }
+    }
+    while (data.isEmpty());
+
+    write(data);
+}
@@ -0,0 +1,58 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <functional>
+#include <optional>
+
+#include <QByteArray>
+
+#include "base/http/contentproducer.h"
+
+// Produces JSON array while the response is sent, so only one batch of the elements
+// is serialized at a time instead of the whole array.
+class JsonArrayProducer final : public Http::ContentProducer
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(JsonArrayProducer)
+
+public:
+    // Returns the JSON of the element at the given index, or nothing if it doesn't exist anymore
+    using Serializer = std::function<std::optional<QByteArray> (qsizetype index)>;
+
+    JsonArrayProducer(qsizetype count, Serializer serializer, QObject *parent = nullptr);
+
+private:
+    void produce() override;
+
+    qsizetype m_count = 0;
+    Serializer m_serializer;
+    qsizetype m_nextIndex = 0;
+    bool m_hasElements = false;
+};
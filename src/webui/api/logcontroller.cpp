@@ -28,13 +28,18 @@
 
 #include "logcontroller.h"
 
-#include <QJsonArray>
-#include <QJsonObject>
+#include <algorithm>
+#include <limits>
+#include <optional>
+
 #include <QList>
 
 #include "base/global.h"
+#include "base/http/types.h"
 #include "base/logger.h"
+#include "base/utils/jsonwriter.h"
 #include "base/utils/string.h"
+#include "apierror.h"
 
 const QString KEY_LOG_ID = u"id"_s;
 const QString KEY_LOG_TIMESTAMP = u"timestamp"_s;
@@ -44,6 +49,90 @@ const QString KEY_LOG_PEER_IP = u"ip"_s;
 const QString KEY_LOG_PEER_BLOCKED = u"blocked"_s;
 const QString KEY_LOG_PEER_REASON = u"reason"_s;
 
+namespace
+{
+    struct LogPageParams
+    {
+        std::optional<int> lastKnownID;
+        std::optional<int> beforeID;
+        qsizetype limit = std::numeric_limits<qsizetype>::max();
+        QString searchText;
+    };
+
+    std::optional<int> parseOptionalInt(const QString &str)
+    {
+        bool ok = false;
+        const int value = str.toInt(&ok);
+        return ok ? std::optional<int>(value) : std::nullopt;
+    }
+
+    LogPageParams parseLogPageParams(const StringMap &params)
+    {
+        LogPageParams pageParams
+        {
+            .lastKnownID = parseOptionalInt(params[u"last_known_id"_s]),
+            .beforeID = parseOptionalInt(params[u"before_id"_s]),
+            .searchText = params[u"search"_s]
+        };
+
+        if (const QString limitStr = params[u"limit"_s]; !limitStr.isEmpty())
+        {
+            const std::optional<int> limit = parseOptionalInt(limitStr);
+            if (!limit || (*limit < 0))
+                throw APIError(APIErrorType::BadParams, LogController::tr("'limit' parameter is invalid"));
+            if (*limit > 0)
+                pageParams.limit = *limit;
+        }
+
+        return pageParams;
+    }
+
+    // Serializes the page of the matching entries straight from the logger buffer.
+    // The entries after 'lastKnownID' are returned from the oldest one unless 'beforeID' is set,
+    // otherwise the newest entries before 'beforeID' (or the end of the log) are returned.
+    // Either way the entries are ordered by ID.
+    // The entries are written as JSON array straight into the buffer since the log may be large.
+    template <typename T, typename Matcher, typename Serializer>
+    QByteArray serializeLogPage(const Log::Snapshot<T> &snapshot, const LogPageParams &pageParams
+            , Matcher match, Serializer serialize)
+    {
+        const int beginID = pageParams.lastKnownID
+            ? std::max(snapshot.beginID(), (*pageParams.lastKnownID + 1)) : snapshot.beginID();
+        const int endID = pageParams.beforeID
+            ? std::min(snapshot.endID(), *pageParams.beforeID) : snapshot.endID();
+
+        Utils::JsonWriter writer;
+        writer.beginArray();
+        if (pageParams.lastKnownID && !pageParams.beforeID)
+        {
+            qsizetype count = 0;
+            for (int id = beginID; (id < endID) && (count < pageParams.limit); ++id)
+            {
+                if (const T &entry = snapshot.at(id); match(entry))
+                {
+                    serialize(writer, entry);
+                    ++count;
+                }
+            }
+
+            writer.endArray();
+            return writer.takeData();
+        }
+
+        QList<int> pageIDs;
+        for (int id = (endID - 1); (id >= beginID) && (pageIDs.size() < pageParams.limit); --id)
+        {
+            if (match(snapshot.at(id)))
+                pageIDs.append(id);
+        }
+
+        for (auto iter = pageIDs.crbegin(); iter != pageIDs.crend(); ++iter)
+            serialize(writer, snapshot.at(*iter));
+        writer.endArray();
+        return writer.takeData();
+    }
+}
+
 // Returns the log in JSON format.
 // The return value is an array of dictionaries.
 // The dictionary keys are:
@@ -57,6 +146,9 @@ const QString KEY_LOG_PEER_REASON = u"reason"_s;
 //   - warning (bool): include warning messages (default true)
 //   - critical (bool): include critical messages (default true)
 //   - last_known_id (int): exclude messages with id <= 'last_known_id' (default -1)
+//   - before_id (int): exclude messages with id >= 'before_id', the newest messages before it are returned
+//   - limit (int): maximum number of messages to return (default 0, i.e. unlimited)
+//   - search (string): include only messages containing the given text (case insensitive)
 void LogController::mainAction()
 {
     using Utils::String::parseBool;
@@ -65,33 +157,30 @@ void LogController::mainAction()
     const bool isInfo = parseBool(params()[u"info"_s]).value_or(true);
     const bool isWarning = parseBool(params()[u"warning"_s]).value_or(true);
     const bool isCritical = parseBool(params()[u"critical"_s]).value_or(true);
+    const LogPageParams pageParams = parseLogPageParams(params());
 
-    bool ok = false;
-    int lastKnownId = params()[u"last_known_id"_s].toInt(&ok);
-    if (!ok)
-        lastKnownId = -1;
-
-    Logger *const logger = Logger::instance();
-    QJsonArray msgList;
-
-    for (const Log::Msg &msg : asConst(logger->getMessages(lastKnownId)))
+    const auto match = [&](const Log::Msg &msg)
     {
         if (!(((msg.type == Log::NORMAL) && isNormal)
               || ((msg.type == Log::INFO) && isInfo)
               || ((msg.type == Log::WARNING) && isWarning)
               || ((msg.type == Log::CRITICAL) && isCritical)))
-            continue;
+            return false;
 
-        msgList.append(QJsonObject
-        {
-            {KEY_LOG_ID, msg.id},
-            {KEY_LOG_TIMESTAMP, msg.timestamp},
-            {KEY_LOG_MSG_TYPE, msg.type},
-            {KEY_LOG_MSG_MESSAGE, msg.message}
-        });
-    }
+        return pageParams.searchText.isEmpty() || msg.message.contains(pageParams.searchText, Qt::CaseInsensitive);
+    };
+
+    const auto serialize = [](Utils::JsonWriter &writer, const Log::Msg &msg)
+    {
+        writer.beginObject()
+            .key(KEY_LOG_ID).value(msg.id)
+            .key(KEY_LOG_MSG_MESSAGE).value(msg.message)
+            .key(KEY_LOG_TIMESTAMP).value(msg.timestamp)
+            .key(KEY_LOG_MSG_TYPE).value(static_cast<int>(msg.type))
+            .endObject();
+    };
 
-    setResult(msgList);
+    setResult(serializeLogPage(Logger::instance()->messagesSnapshot(), pageParams, match, serialize), Http::CONTENT_TYPE_JSON);
 }
 
 // Returns the peer log in JSON format.
@@ -104,27 +193,30 @@ void LogController::mainAction()
 //   - "reason": reason of the block
 // GET params:
 //   - last_known_id (int): exclude messages with id <= 'last_known_id' (default -1)
+//   - before_id (int): exclude messages with id >= 'before_id', the newest messages before it are returned
+//   - limit (int): maximum number of messages to return (default 0, i.e. unlimited)
+//   - search (string): include only messages whose IP or reason contains the given text (case insensitive)
 void LogController::peersAction()
 {
-    bool ok = false;
-    int lastKnownId = params()[u"last_known_id"_s].toInt(&ok);
-    if (!ok)
-        lastKnownId = -1;
+    const LogPageParams pageParams = parseLogPageParams(params());
 
-    Logger *const logger = Logger::instance();
-    QJsonArray peerList;
+    const auto match = [&pageParams](const Log::Peer &peer)
+    {
+        return pageParams.searchText.isEmpty()
+            || peer.ip.contains(pageParams.searchText, Qt::CaseInsensitive)
+            || peer.reason.contains(pageParams.searchText, Qt::CaseInsensitive);
+    };
 
-    for (const Log::Peer &peer : asConst(logger->getPeers(lastKnownId)))
+    const auto serialize = [](Utils::JsonWriter &writer, const Log::Peer &peer)
     {
-        peerList.append(QJsonObject
-        {
-            {KEY_LOG_ID, peer.id},
-            {KEY_LOG_TIMESTAMP, peer.timestamp},
-            {KEY_LOG_PEER_IP, peer.ip},
-            {KEY_LOG_PEER_BLOCKED, peer.blocked},
-            {KEY_LOG_PEER_REASON, peer.reason}
-        });
-    }
+        writer.beginObject()
+            .key(KEY_LOG_PEER_BLOCKED).value(peer.blocked)
+            .key(KEY_LOG_ID).value(peer.id)
+            .key(KEY_LOG_PEER_IP).value(peer.ip)
+            .key(KEY_LOG_PEER_REASON).value(peer.reason)
+            .key(KEY_LOG_TIMESTAMP).value(peer.timestamp)
+            .endObject();
+    };
 
-    setResult(peerList);
+    setResult(serializeLogPage(Logger::instance()->peersSnapshot(), pageParams, match, serialize), Http::CONTENT_TYPE_JSON);
 }
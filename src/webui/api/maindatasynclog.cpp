@@ -0,0 +1,1241 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "maindatasynclog.h"
+
+#include <algorithm>
+#include <chrono>
+#include <initializer_list>
+
+#include <QJsonArray>
+#include <QTimer>
+#include <QUrl>
+
+#include "base/algorithm.h"
+#include "base/bittorrent/cachestatus.h"
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/sessionstatus.h"
+#include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrentsnapshot.h"
+#include "base/bittorrent/trackerentrystatus.h"
+#include "base/global.h"
+#include "base/torrentfilter.h"
+#include "base/utils/memory.h"
+#include "base/utils/string.h"
+
+namespace
+{
+    // Removed items are remembered for this number of versions,
+    // clients having older data receive full update
+    const int REMOVED_ITEMS_HISTORY_LENGTH = 1000;
+    // Session data is refreshed at full rate for this time since the last request
+    const std::chrono::seconds REFRESH_SUBSCRIPTION_TIMEOUT {10};
+
+    // Sync main data keys
+    const QString KEY_SYNC_MAINDATA_QUEUEING = u"queueing"_s;
+    const QString KEY_SYNC_MAINDATA_REFRESH_INTERVAL = u"refresh_interval"_s;
+    const QString KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS = u"use_alt_speed_limits"_s;
+    const QString KEY_SYNC_MAINDATA_USE_SUBCATEGORIES = u"use_subcategories"_s;
+
+    // TransferInfo keys
+    const QString KEY_TRANSFER_CHECKING_ETA = u"checking_eta"_s;
+    const QString KEY_TRANSFER_CHECKING_REMAINING = u"checking_remaining"_s;
+    const QString KEY_TRANSFER_CHECKING_SPEED = u"checking_speed"_s;
+    const QString KEY_TRANSFER_CHECKING_TORRENTS = u"checking_torrents"_s;
+    const QString KEY_TRANSFER_CONNECTION_STATUS = u"connection_status"_s;
+    const QString KEY_TRANSFER_DHT_NODES = u"dht_nodes"_s;
+    const QString KEY_TRANSFER_DLDATA = u"dl_info_data"_s;
+    const QString KEY_TRANSFER_DLRATELIMIT = u"dl_rate_limit"_s;
+    const QString KEY_TRANSFER_DLSPEED = u"dl_info_speed"_s;
+    const QString KEY_TRANSFER_FREESPACEONDISK = u"free_space_on_disk"_s;
+    const QString KEY_TRANSFER_FREESPACEONVOLUMES = u"free_space_on_volumes"_s;
+    const QString KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V4 = u"last_external_address_v4"_s;
+    const QString KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V6 = u"last_external_address_v6"_s;
+    const QString KEY_TRANSFER_UPDATA = u"up_info_data"_s;
+    const QString KEY_TRANSFER_UPRATELIMIT = u"up_rate_limit"_s;
+    const QString KEY_TRANSFER_UPSPEED = u"up_info_speed"_s;
+
+    // Statistics keys
+    const QString KEY_TRANSFER_ALLTIME_DL = u"alltime_dl"_s;
+    const QString KEY_TRANSFER_ALLTIME_UL = u"alltime_ul"_s;
+    const QString KEY_TRANSFER_AVERAGE_TIME_QUEUE = u"average_time_queue"_s;
+    const QString KEY_TRANSFER_GLOBAL_RATIO = u"global_ratio"_s;
+    const QString KEY_TRANSFER_QUEUED_IO_JOBS = u"queued_io_jobs"_s;
+    const QString KEY_TRANSFER_READ_CACHE_HITS = u"read_cache_hits"_s;
+    const QString KEY_TRANSFER_READ_CACHE_OVERLOAD = u"read_cache_overload"_s;
+    const QString KEY_TRANSFER_TOTAL_BUFFERS_SIZE = u"total_buffers_size"_s;
+    const QString KEY_TRANSFER_TOTAL_PEER_CONNECTIONS = u"total_peer_connections"_s;
+    const QString KEY_TRANSFER_TOTAL_QUEUED_SIZE = u"total_queued_size"_s;
+    const QString KEY_TRANSFER_TOTAL_WASTE_SESSION = u"total_wasted_session"_s;
+    const QString KEY_TRANSFER_WRITE_CACHE_OVERLOAD = u"write_cache_overload"_s;
+
+    const QString KEY_SUFFIX_REMOVED = u"_removed"_s;
+
+    const QString KEY_CATEGORIES = u"categories"_s;
+    const QString KEY_CATEGORIES_REMOVED = KEY_CATEGORIES + KEY_SUFFIX_REMOVED;
+    const QString KEY_TAGS = u"tags"_s;
+    const QString KEY_TAGS_REMOVED = KEY_TAGS + KEY_SUFFIX_REMOVED;
+    const QString KEY_TORRENTS = u"torrents"_s;
+    const QString KEY_TORRENTS_REMOVED = KEY_TORRENTS + KEY_SUFFIX_REMOVED;
+    const QString KEY_TRACKERS = u"trackers"_s;
+    const QString KEY_TRACKERS_REMOVED = KEY_TRACKERS + KEY_SUFFIX_REMOVED;
+    const QString KEY_SERVER_STATE = u"server_state"_s;
+    const QString KEY_FILTER_COUNTS = u"filter_counts"_s;
+
+    // Names of the filter groups and of the status filters (in the order of TorrentFilter::Type)
+    const QString FILTER_GROUP_NAMES[] = {u"status"_s, u"category"_s, u"tag"_s, u"tracker"_s};
+    const QString STATUS_FILTER_NAMES[] =
+    {
+        u"all"_s, u"downloading"_s, u"seeding"_s, u"completed"_s, u"running"_s, u"stopped"_s, u"active"_s
+        , u"inactive"_s, u"stalled"_s, u"stalled_uploading"_s, u"stalled_downloading"_s, u"checking"_s
+        , u"moving"_s, u"errored"_s
+    };
+    static_assert(std::size(STATUS_FILTER_NAMES) == TorrentFilter::_Count);
+
+    const QString KEY_TORRENT_HAS_TRACKER_WARNING = u"has_tracker_warning"_s;
+    const QString KEY_TORRENT_HAS_TRACKER_ERROR = u"has_tracker_error"_s;
+    const QString KEY_TORRENT_HAS_OTHER_ANNOUNCE_ERROR = u"has_other_announce_error"_s;
+
+    const int FIELD_HAS_TRACKER_WARNING = TORRENT_FIELDS_COUNT;
+    const int FIELD_HAS_TRACKER_ERROR = TORRENT_FIELDS_COUNT + 1;
+    const int FIELD_HAS_OTHER_ANNOUNCE_ERROR = TORRENT_FIELDS_COUNT + 2;
+
+    TorrentSyncFieldSet makeFieldSet(const std::initializer_list<TorrentField> fields)
+    {
+        TorrentSyncFieldSet result;
+        for (const TorrentField field : fields)
+            result.set(static_cast<std::size_t>(field));
+        return result;
+    }
+
+    // Torrent ID is used as a key of "torrents" dictionary so it isn't repeated in the torrent data
+    const TorrentSyncFieldSet ALL_FIELDS = TorrentSyncFieldSet().set().reset(static_cast<std::size_t>(TorrentField::ID));
+    const TorrentSyncFieldSet ANNOUNCE_STATS_FIELDS = TorrentSyncFieldSet()
+            .set(FIELD_HAS_TRACKER_WARNING).set(FIELD_HAS_TRACKER_ERROR).set(FIELD_HAS_OTHER_ANNOUNCE_ERROR);
+    // Fields that can only be changed when torrent metadata is received
+    const TorrentSyncFieldSet METADATA_FIELDS = makeFieldSet({TorrentField::InfoHashV1, TorrentField::InfoHashV2
+            , TorrentField::HasMetadata, TorrentField::CreatedBy, TorrentField::CreationDate, TorrentField::Private
+            , TorrentField::TotalSize, TorrentField::PiecesNum, TorrentField::PieceSize});
+    // Fields that can be changed by regular torrent status update
+    const TorrentSyncFieldSet STATUS_FIELDS = ALL_FIELDS & ~(METADATA_FIELDS | ANNOUNCE_STATS_FIELDS);
+    const TorrentSyncFieldSet PATH_FIELDS = makeFieldSet({TorrentField::SavePath, TorrentField::DownloadPath
+            , TorrentField::ContentPath, TorrentField::RootPath});
+    const TorrentSyncFieldSet TRACKERS_FIELDS = makeFieldSet({TorrentField::Tracker, TorrentField::TrackersCount
+            , TorrentField::MagnetURI}) | ANNOUNCE_STATS_FIELDS;
+
+    QJsonArray asJsonArray(const QSet<BitTorrent::TorrentID> &torrentIDs)
+    {
+        QJsonArray result;
+        for (const BitTorrent::TorrentID &torrentID : torrentIDs)
+            result.append(torrentID.toString());
+
+        return result;
+    }
+
+    bool hasWarningMessage(const BitTorrent::TrackerEntryStatus &status)
+    {
+        return std::ranges::any_of(status.endpoints, [](const BitTorrent::TrackerEndpointStatus &endpointEntry)
+        {
+            return (endpointEntry.state == BitTorrent::TrackerEndpointState::Working) && !endpointEntry.message.isEmpty();
+        });
+    }
+
+    struct AnnounceStats
+    {
+        bool hasTrackerWarning = false;
+        bool hasTrackerError = false;
+        bool hasOtherAnnounceError = false;
+    };
+
+    AnnounceStats getAnnounceStats(const BitTorrent::Torrent &torrent)
+    {
+        AnnounceStats stats;
+        for (const BitTorrent::TrackerEntryStatus &status : asConst(torrent.trackers()))
+        {
+            switch (status.state)
+            {
+            case BitTorrent::TrackerEndpointState::Working:
+                if (!stats.hasTrackerWarning && hasWarningMessage(status))
+                    stats.hasTrackerWarning = true;
+                break;
+            case BitTorrent::TrackerEndpointState::TrackerError:
+                stats.hasTrackerError = true;
+                break;
+            case BitTorrent::TrackerEndpointState::NotWorking:
+            case BitTorrent::TrackerEndpointState::Unreachable:
+                stats.hasOtherAnnounceError = true;
+                break;
+            default:
+                break;
+            }
+
+            if (stats.hasTrackerWarning && stats.hasTrackerError && stats.hasOtherAnnounceError)
+                break;
+        }
+
+        return stats;
+    }
+
+    const QString &syncFieldKey(const int index)
+    {
+        switch (index)
+        {
+        case FIELD_HAS_TRACKER_WARNING:
+            return KEY_TORRENT_HAS_TRACKER_WARNING;
+        case FIELD_HAS_TRACKER_ERROR:
+            return KEY_TORRENT_HAS_TRACKER_ERROR;
+        case FIELD_HAS_OTHER_ANNOUNCE_ERROR:
+            return KEY_TORRENT_HAS_OTHER_ANNOUNCE_ERROR;
+        default:
+            return torrentFieldKey(static_cast<TorrentField>(index));
+        }
+    }
+
+    QJsonObject getCategoryInfo(const QString &categoryName)
+    {
+        const BitTorrent::CategoryOptions categoryOptions = BitTorrent::Session::instance()->categoryOptions(categoryName);
+        QJsonObject category = categoryOptions.toJSON();
+        // adjust it to be compatible with existing WebAPI
+        category[u"savePath"_s] = category.take(u"save_path"_s);
+        category.insert(u"name"_s, categoryName);
+        return category;
+    }
+
+    QVariantMap getTransferInfo()
+    {
+        QVariantMap map;
+        const auto *session = BitTorrent::Session::instance();
+
+        const BitTorrent::SessionStatus &sessionStatus = session->status();
+        const BitTorrent::CacheStatus &cacheStatus = session->cacheStatus();
+        map[KEY_TRANSFER_DLSPEED] = sessionStatus.payloadDownloadRate;
+        map[KEY_TRANSFER_DLDATA] = sessionStatus.totalPayloadDownload;
+        map[KEY_TRANSFER_UPSPEED] = sessionStatus.payloadUploadRate;
+        map[KEY_TRANSFER_UPDATA] = sessionStatus.totalPayloadUpload;
+        map[KEY_TRANSFER_DLRATELIMIT] = session->downloadSpeedLimit();
+        map[KEY_TRANSFER_UPRATELIMIT] = session->uploadSpeedLimit();
+
+        const qint64 atd = sessionStatus.allTimeDownload;
+        const qint64 atu = sessionStatus.allTimeUpload;
+        map[KEY_TRANSFER_ALLTIME_DL] = atd;
+        map[KEY_TRANSFER_ALLTIME_UL] = atu;
+        map[KEY_TRANSFER_TOTAL_WASTE_SESSION] = sessionStatus.totalWasted;
+        map[KEY_TRANSFER_GLOBAL_RATIO] = ((atd > 0) && (atu > 0)) ? Utils::String::fromDouble(static_cast<qreal>(atu) / atd, 2) : u"-"_s;
+        map[KEY_TRANSFER_TOTAL_PEER_CONNECTIONS] = sessionStatus.peersCount;
+
+        const qreal readRatio = cacheStatus.readRatio;
+        map[KEY_TRANSFER_READ_CACHE_HITS] = (readRatio > 0) ? Utils::String::fromDouble(100 * readRatio, 2) : u"0"_s;
+        map[KEY_TRANSFER_TOTAL_BUFFERS_SIZE] = cacheStatus.totalUsedBuffers * 16 * 1024;
+
+        map[KEY_TRANSFER_WRITE_CACHE_OVERLOAD] = ((sessionStatus.diskWriteQueue > 0) && (sessionStatus.peersCount > 0))
+            ? Utils::String::fromDouble((100. * sessionStatus.diskWriteQueue / sessionStatus.peersCount), 2)
+            : u"0"_s;
+        map[KEY_TRANSFER_READ_CACHE_OVERLOAD] = ((sessionStatus.diskReadQueue > 0) && (sessionStatus.peersCount > 0))
+            ? Utils::String::fromDouble((100. * sessionStatus.diskReadQueue / sessionStatus.peersCount), 2)
+            : u"0"_s;
+
+        map[KEY_TRANSFER_QUEUED_IO_JOBS] = cacheStatus.jobQueueLength;
+        map[KEY_TRANSFER_AVERAGE_TIME_QUEUE] = cacheStatus.averageJobTime;
+        map[KEY_TRANSFER_TOTAL_QUEUED_SIZE] = cacheStatus.queuedBytes;
+
+        map[KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V4] = session->lastExternalIPv4Address();
+        map[KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V6] = session->lastExternalIPv6Address();
+        map[KEY_TRANSFER_DHT_NODES] = sessionStatus.dhtNodes;
+        map[KEY_TRANSFER_CHECKING_TORRENTS] = sessionStatus.checkingTorrentsCount;
+        map[KEY_TRANSFER_CHECKING_SPEED] = sessionStatus.checkingRate;
+        map[KEY_TRANSFER_CHECKING_REMAINING] = sessionStatus.checkingRemaining;
+        map[KEY_TRANSFER_CHECKING_ETA] = sessionStatus.checkingETA;
+        map[KEY_TRANSFER_CONNECTION_STATUS] = session->isListening()
+            ? (sessionStatus.hasIncomingConnections ? u"connected"_s : u"firewalled"_s)
+            : u"disconnected"_s;
+
+        return map;
+    }
+}
+
+std::optional<TorrentSyncFieldSet> torrentSyncFieldsFromKeys(const QStringList &keys)
+{
+    static const QHash<QString, int> fieldIndexes = []
+    {
+        QHash<QString, int> result;
+        result.reserve(TORRENT_SYNC_FIELDS_COUNT);
+        for (int i = 0; i < TORRENT_SYNC_FIELDS_COUNT; ++i)
+            result.insert(syncFieldKey(i), i);
+        return result;
+    }();
+
+    TorrentSyncFieldSet fields;
+    for (const QString &key : keys)
+    {
+        const auto iter = fieldIndexes.constFind(key);
+        if (iter == fieldIndexes.cend())
+            return std::nullopt;
+
+        fields.set(iter.value());
+    }
+
+    return fields;
+}
+
+MaindataSyncLog::MaindataSyncLog(QObject *parent)
+    : QObject(parent)
+    , m_refreshSubscriptionTimer {new QTimer(this)}
+{
+    m_refreshSubscriptionTimer->setSingleShot(true);
+    m_refreshSubscriptionTimer->setInterval(REFRESH_SUBSCRIPTION_TIMEOUT);
+    connect(m_refreshSubscriptionTimer, &QTimer::timeout, this, [this]
+    {
+        BitTorrent::Session::instance()->removeRefreshSubscriber(this);
+    });
+}
+
+MaindataSyncLog::~MaindataSyncLog()
+{
+    if (m_refreshSubscriptionTimer->isActive())
+        BitTorrent::Session::instance()->removeRefreshSubscriber(this);
+}
+
+int MaindataSyncLog::update()
+{
+    // Keep the data refreshed at full rate while it is requested by the clients
+    if (!m_refreshSubscriptionTimer->isActive())
+        BitTorrent::Session::instance()->addRefreshSubscriber(this);
+    m_refreshSubscriptionTimer->start();
+
+    if (!m_isStarted)
+    {
+        start();
+        return m_version;
+    }
+
+    const bool hasPendingChanges = !m_dirtyTorrents.isEmpty() || !m_pendingRemovedTorrents.isEmpty()
+            || !m_updatedCategories.isEmpty() || !m_pendingRemovedCategories.isEmpty()
+            || !m_pendingAddedTags.isEmpty() || !m_pendingRemovedTags.isEmpty()
+            || !m_updatedTrackers.isEmpty() || !m_pendingRemovedTrackers.isEmpty()
+            || !m_dirtyFilterCounts.isEmpty() || m_isServerStateDirty;
+    if (!hasPendingChanges)
+        return m_version;
+
+    // Pending changes may not change the actual values (e.g. server state is marked dirty on each refresh),
+    // so the version is only kept when something is really changed
+    bool isChanged = !m_pendingRemovedTorrents.isEmpty() || !m_pendingRemovedCategories.isEmpty()
+            || !m_pendingAddedTags.isEmpty() || !m_pendingRemovedTags.isEmpty()
+            || !m_updatedTrackers.isEmpty() || !m_pendingRemovedTrackers.isEmpty();
+
+    ++m_version;
+
+    const auto *session = BitTorrent::Session::instance();
+
+    for (const BitTorrent::TorrentID &torrentID : asConst(m_pendingRemovedTorrents))
+    {
+        m_torrents.remove(torrentID);
+        m_changedTorrents.remove(torrentID);
+        m_removedTorrents.insert(torrentID, m_version);
+    }
+    m_pendingRemovedTorrents.clear();
+
+    for (const auto &[torrentID, dirtyFields] : asConst(m_dirtyTorrents).asKeyValueRange())
+    {
+        const BitTorrent::Torrent *torrent = session->getTorrent(torrentID);
+        Q_ASSERT(torrent);
+
+        // Placeholder contains only few fields so the rest must be filled in once the torrent is loaded
+        const TorrentSyncFieldSet fields = m_placeholderTorrents.remove(torrentID) ? ALL_FIELDS : dirtyFields;
+
+        auto torrentDataIter = m_torrents.find(torrentID);
+        if (torrentDataIter == m_torrents.end())
+        {
+            TorrentData torrentData;
+            // Undefined never matches a serialized value so every field of the new torrent is considered changed
+            torrentData.values.fill(QJsonValue(QJsonValue::Undefined));
+            torrentDataIter = m_torrents.insert(torrentID, torrentData);
+            m_removedTorrents.remove(torrentID);
+        }
+
+        if (applyTorrentChanges(torrent, torrentDataIter.value(), fields))
+            isChanged = true;
+        updateFilterMembership(torrent, fields);
+    }
+    m_dirtyTorrents.clear();
+
+    for (const QString &categoryName : asConst(m_updatedCategories))
+    {
+        if (applyCategoryChanges(categoryName))
+            isChanged = true;
+    }
+    m_updatedCategories.clear();
+
+    for (const QString &categoryName : asConst(m_pendingRemovedCategories))
+    {
+        m_categories.remove(categoryName);
+        m_changedCategories.remove(categoryName);
+        m_removedCategories.insert(categoryName, m_version);
+    }
+    m_pendingRemovedCategories.clear();
+
+    for (const QString &tag : asConst(m_pendingAddedTags))
+    {
+        m_tags.insert(tag);
+        m_removedTags.remove(tag);
+        m_addedTags.insert(tag, m_version);
+    }
+    m_pendingAddedTags.clear();
+
+    for (const QString &tag : asConst(m_pendingRemovedTags))
+    {
+        m_tags.remove(tag);
+        m_addedTags.remove(tag);
+        m_removedTags.insert(tag, m_version);
+    }
+    m_pendingRemovedTags.clear();
+
+    for (const QString &tracker : asConst(m_updatedTrackers))
+    {
+        m_removedTrackers.remove(tracker);
+        m_changedTrackers.insert(tracker, m_version);
+    }
+    m_updatedTrackers.clear();
+
+    for (const QString &tracker : asConst(m_pendingRemovedTrackers))
+    {
+        m_changedTrackers.remove(tracker);
+        m_removedTrackers.insert(tracker, m_version);
+    }
+    m_pendingRemovedTrackers.clear();
+
+    if (m_isServerStateDirty && applyServerStateChanges())
+        isChanged = true;
+
+    if (applyFilterCountChanges())
+        isChanged = true;
+
+    if (!isChanged)
+    {
+        --m_version;
+        return m_version;
+    }
+
+    removeOutdatedChanges();
+
+    return m_version;
+}
+
+int MaindataSyncLog::version() const
+{
+    return m_version;
+}
+
+qint64 MaindataSyncLog::estimatedMemoryUsage() const
+{
+    qint64 size = 0;
+
+    for (const TorrentData &data : asConst(m_torrents))
+    {
+        size += sizeof(BitTorrent::TorrentID) + sizeof(TorrentData);
+        for (const QJsonValue &value : data.values)
+            size += Utils::Memory::estimateHeapSize(value);
+    }
+
+    for (auto it = m_categories.cbegin(); it != m_categories.cend(); ++it)
+        size += Utils::Memory::estimateHeapSize(it.key()) + Utils::Memory::estimateHeapSize(QJsonValue(it.value()));
+
+    for (const QString &tag : asConst(m_tags))
+        size += Utils::Memory::estimateHeapSize(tag);
+
+    for (auto it = m_knownTrackers.cbegin(); it != m_knownTrackers.cend(); ++it)
+        size += Utils::Memory::estimateHeapSize(it.key()) + (it.value().size() * static_cast<qint64>(sizeof(BitTorrent::TorrentID)));
+
+    size += Utils::Memory::estimateHeapSize(QJsonValue(m_serverState));
+
+    for (const TorrentFilterMembership &membership : asConst(m_filterMemberships))
+    {
+        size += sizeof(BitTorrent::TorrentID) + sizeof(TorrentFilterMembership)
+            + ((membership.tags.size() + membership.trackerHosts.size()) * static_cast<qint64>(sizeof(QString)));
+    }
+    for (auto it = m_filterCounts.cbegin(); it != m_filterCounts.cend(); ++it)
+        size += sizeof(FilterKey) + sizeof(int) + Utils::Memory::estimateHeapSize(it.key().second);
+
+    size += m_changedTorrents.estimatedMemoryUsage() + m_removedTorrents.estimatedMemoryUsage()
+        + m_changedCategories.estimatedMemoryUsage() + m_removedCategories.estimatedMemoryUsage()
+        + m_addedTags.estimatedMemoryUsage() + m_removedTags.estimatedMemoryUsage()
+        + m_changedTrackers.estimatedMemoryUsage() + m_removedTrackers.estimatedMemoryUsage()
+        + m_changedFilterCounts.estimatedMemoryUsage();
+
+    return size;
+}
+
+bool MaindataSyncLog::canSyncSince(const int version) const
+{
+    return (version > 0) && (version >= m_oldestAvailableVersion) && (version <= m_version);
+}
+
+QJsonObject MaindataSyncLog::generateSyncData(const int sinceVersion, const TorrentSyncFieldSet &torrentFields
+        , const QSet<BitTorrent::TorrentID> *torrentIDs) const
+{
+    Q_ASSERT((sinceVersion == 0) || canSyncSince(sinceVersion));
+
+    const bool fullUpdate = (sinceVersion == 0);
+
+    QJsonObject syncData;
+
+    QJsonObject categories;
+    if (fullUpdate)
+    {
+        for (const auto &[categoryName, category] : m_categories.asKeyValueRange())
+            categories[categoryName] = category;
+    }
+    else
+    {
+        m_changedCategories.forEachSince(sinceVersion, [this, &categories](const QString &categoryName)
+        {
+            categories[categoryName] = m_categories.value(categoryName);
+        });
+    }
+    if (!categories.isEmpty())
+        syncData[KEY_CATEGORIES] = categories;
+
+    QJsonArray tags;
+    if (fullUpdate)
+    {
+        for (const QString &tag : m_tags)
+            tags.append(tag);
+    }
+    else
+    {
+        m_addedTags.forEachSince(sinceVersion, [&tags](const QString &tag) { tags.append(tag); });
+    }
+    if (!tags.isEmpty())
+        syncData[KEY_TAGS] = tags;
+
+    QJsonObject torrents;
+    const TorrentSyncFieldSet fields = torrentFields & ALL_FIELDS;
+    const auto serializeTorrent = [sinceVersion, &fields](const TorrentData &torrentData) -> QJsonObject
+    {
+        return serializeTorrentData(torrentData, fields, sinceVersion);
+    };
+    if (fullUpdate && torrentIDs)
+    {
+        torrents = generateTorrentsData(*torrentIDs, torrentFields);
+    }
+    else if (fullUpdate)
+    {
+        for (const auto &[torrentID, torrentData] : m_torrents.asKeyValueRange())
+            torrents[torrentID.toString()] = serializeTorrent(torrentData);
+    }
+    else
+    {
+        m_changedTorrents.forEachSince(sinceVersion, [this, &torrents, &serializeTorrent, torrentIDs](const BitTorrent::TorrentID &torrentID)
+        {
+            if (torrentIDs && !torrentIDs->contains(torrentID))
+                return;
+
+            const auto torrentDataIter = m_torrents.constFind(torrentID);
+            Q_ASSERT(torrentDataIter != m_torrents.cend());
+            // the torrent may have been changed only in the fields that aren't requested
+            if (const QJsonObject torrent = serializeTorrent(torrentDataIter.value()); !torrent.isEmpty())
+                torrents[torrentID.toString()] = torrent;
+        });
+    }
+    if (!torrents.isEmpty())
+        syncData[KEY_TORRENTS] = torrents;
+
+    QJsonObject trackers;
+    if (fullUpdate)
+    {
+        for (const auto &[tracker, torrentIDs] : m_knownTrackers.asKeyValueRange())
+            trackers[tracker] = asJsonArray(torrentIDs);
+    }
+    else
+    {
+        m_changedTrackers.forEachSince(sinceVersion, [this, &trackers](const QString &tracker)
+        {
+            trackers[tracker] = asJsonArray(m_knownTrackers.value(tracker));
+        });
+    }
+    if (!trackers.isEmpty())
+        syncData[KEY_TRACKERS] = trackers;
+
+    QJsonObject serverState;
+    for (const auto &[key, version] : m_serverStateVersions.asKeyValueRange())
+    {
+        if (version > sinceVersion)
+            serverState[key] = m_serverState.value(key);
+    }
+    if (!serverState.isEmpty())
+        syncData[KEY_SERVER_STATE] = serverState;
+
+    // Counts of the removed filter items are reported as zero once
+    std::array<QJsonObject, std::size(FILTER_GROUP_NAMES)> filterCounts;
+    if (fullUpdate)
+    {
+        for (const auto &[key, count] : m_filterCounts.asKeyValueRange())
+        {
+            if (count > 0)
+                filterCounts[key.first][key.second] = count;
+        }
+    }
+    else
+    {
+        m_changedFilterCounts.forEachSince(sinceVersion, [this, &filterCounts](const FilterKey &key)
+        {
+            filterCounts[key.first][key.second] = m_filterCounts.value(key);
+        });
+    }
+    QJsonObject filterCountsData;
+    for (std::size_t i = 0; i < filterCounts.size(); ++i)
+    {
+        if (!filterCounts[i].isEmpty())
+            filterCountsData[FILTER_GROUP_NAMES[i]] = filterCounts[i];
+    }
+    if (!filterCountsData.isEmpty())
+        syncData[KEY_FILTER_COUNTS] = filterCountsData;
+
+    if (!fullUpdate)
+    {
+        const auto collectRemovedItems = [sinceVersion](const ChangeIndex<QString> &index) -> QJsonArray
+        {
+            QJsonArray result;
+            index.forEachSince(sinceVersion, [&result](const QString &key) { result.append(key); });
+            return result;
+        };
+
+        if (const QJsonArray removedCategories = collectRemovedItems(m_removedCategories); !removedCategories.isEmpty())
+            syncData[KEY_CATEGORIES_REMOVED] = removedCategories;
+        if (const QJsonArray removedTags = collectRemovedItems(m_removedTags); !removedTags.isEmpty())
+            syncData[KEY_TAGS_REMOVED] = removedTags;
+        if (const QJsonArray removedTrackers = collectRemovedItems(m_removedTrackers); !removedTrackers.isEmpty())
+            syncData[KEY_TRACKERS_REMOVED] = removedTrackers;
+
+        QJsonArray removedTorrents;
+        m_removedTorrents.forEachSince(sinceVersion, [&removedTorrents, torrentIDs](const BitTorrent::TorrentID &torrentID)
+        {
+            if (!torrentIDs || torrentIDs->contains(torrentID))
+                removedTorrents.append(torrentID.toString());
+        });
+        if (!removedTorrents.isEmpty())
+            syncData[KEY_TORRENTS_REMOVED] = removedTorrents;
+    }
+
+    return syncData;
+}
+
+void MaindataSyncLog::start()
+{
+    Q_ASSERT(!m_isStarted);
+
+    m_isStarted = true;
+    m_version = 1;
+
+    auto *session = BitTorrent::Session::instance();
+    m_freeDiskSpace = session->freeDiskSpace();
+
+    const QList<BitTorrent::Torrent *> torrents = session->torrents();
+    m_torrents.reserve(torrents.size());
+    for (const BitTorrent::Torrent *torrent : torrents)
+    {
+        const BitTorrent::TorrentID torrentID = torrent->id();
+
+        TorrentData torrentData;
+        torrentData.values.fill(QJsonValue(QJsonValue::Undefined));
+        applyTorrentChanges(torrent, torrentData, ALL_FIELDS);
+        m_torrents.insert(torrentID, torrentData);
+        updateFilterMembership(torrent, ALL_FIELDS);
+
+        const QList<BitTorrent::TrackerEntryStatus> trackers = torrent->trackers();
+        for (const BitTorrent::TrackerEntryStatus &status : trackers)
+            m_knownTrackers[status.url].insert(torrentID);
+        updateTrackerHostsMembership(torrentID, trackers);
+    }
+    applyFilterCountChanges();
+
+    if (!session->isRestored())
+    {
+        addPlaceholderTorrents();
+        connect(session, &BitTorrent::Session::restored, this, &MaindataSyncLog::onSessionRestored);
+    }
+
+    for (const QString &categoryName : asConst(session->categories()))
+        applyCategoryChanges(categoryName);
+
+    for (const Tag &tag : asConst(session->tags()))
+        m_tags.insert(tag.toString());
+
+    applyServerStateChanges();
+
+    connect(session, &BitTorrent::Session::categoryAdded, this, &MaindataSyncLog::onCategoryAdded);
+    connect(session, &BitTorrent::Session::categoryRemoved, this, &MaindataSyncLog::onCategoryRemoved);
+    connect(session, &BitTorrent::Session::categoryOptionsChanged, this, &MaindataSyncLog::onCategoryOptionsChanged);
+    connect(session, &BitTorrent::Session::subcategoriesSupportChanged, this, &MaindataSyncLog::onSubcategoriesSupportChanged);
+    connect(session, &BitTorrent::Session::tagAdded, this, &MaindataSyncLog::onTagAdded);
+    connect(session, &BitTorrent::Session::tagRemoved, this, &MaindataSyncLog::onTagRemoved);
+    connect(session, &BitTorrent::Session::torrentAdded, this, &MaindataSyncLog::onTorrentAdded);
+    connect(session, &BitTorrent::Session::torrentAboutToBeRemoved, this, &MaindataSyncLog::onTorrentAboutToBeRemoved);
+    connect(session, &BitTorrent::Session::torrentCategoryChanged, this, &MaindataSyncLog::onTorrentCategoryChanged);
+    connect(session, &BitTorrent::Session::torrentMetadataReceived, this, &MaindataSyncLog::onTorrentMetadataReceived);
+    connect(session, &BitTorrent::Session::torrentStopped, this, &MaindataSyncLog::onTorrentStopped);
+    connect(session, &BitTorrent::Session::torrentStarted, this, &MaindataSyncLog::onTorrentStarted);
+    connect(session, &BitTorrent::Session::torrentSavePathChanged, this, &MaindataSyncLog::onTorrentSavePathChanged);
+    connect(session, &BitTorrent::Session::torrentSavingModeChanged, this, &MaindataSyncLog::onTorrentSavingModeChanged);
+    connect(session, &BitTorrent::Session::torrentTagAdded, this, &MaindataSyncLog::onTorrentTagAdded);
+    connect(session, &BitTorrent::Session::torrentTagRemoved, this, &MaindataSyncLog::onTorrentTagRemoved);
+    connect(session, &BitTorrent::Session::torrentsLoaded, this, &MaindataSyncLog::onTorrentsLoaded);
+    connect(session, &BitTorrent::Session::torrentsUpdated, this, &MaindataSyncLog::onTorrentsUpdated);
+    connect(session, &BitTorrent::Session::trackersAdded, this, &MaindataSyncLog::onTorrentTrackersChanged);
+    connect(session, &BitTorrent::Session::trackersRemoved, this, &MaindataSyncLog::onTorrentTrackersChanged);
+    connect(session, &BitTorrent::Session::trackersChanged, this, &MaindataSyncLog::onTorrentTrackersChanged);
+    connect(session, &BitTorrent::Session::trackerEntryStatusesUpdated, this, &MaindataSyncLog::onTorrentTrackerEntryStatusesUpdated);
+    connect(session, &BitTorrent::Session::freeDiskSpaceChecked, this, &MaindataSyncLog::onFreeDiskSpaceChecked);
+    connect(session, &BitTorrent::Session::storageVolumesChecked, this, [this] { m_isServerStateDirty = true; });
+    connect(session, &BitTorrent::Session::speedLimitModeChanged, this, [this] { m_isServerStateDirty = true; });
+    connect(session, &BitTorrent::Session::statsUpdated, this, [this] { m_isServerStateDirty = true; });
+}
+
+QJsonObject MaindataSyncLog::generateTorrentsData(const QSet<BitTorrent::TorrentID> &torrentIDs, const TorrentSyncFieldSet &torrentFields) const
+{
+    const TorrentSyncFieldSet fields = torrentFields & ALL_FIELDS;
+
+    QJsonObject torrents;
+    for (const BitTorrent::TorrentID &torrentID : torrentIDs)
+    {
+        if (const auto torrentDataIter = m_torrents.constFind(torrentID); torrentDataIter != m_torrents.cend())
+            torrents[torrentID.toString()] = serializeTorrentData(torrentDataIter.value(), fields, 0);
+    }
+
+    return torrents;
+}
+
+QJsonObject MaindataSyncLog::serializeTorrentData(const TorrentData &data, const TorrentSyncFieldSet &fields, const int sinceVersion)
+{
+    QJsonObject result;
+    for (int i = 0; i < TORRENT_SYNC_FIELDS_COUNT; ++i)
+    {
+        if (fields.test(i) && (data.versions[i] > sinceVersion))
+            result.insert(syncFieldKey(i), data.values[i]);
+    }
+
+    return result;
+}
+
+QSet<BitTorrent::TorrentID> MaindataSyncLog::trackerHostTorrents(const QString &host) const
+{
+    QSet<BitTorrent::TorrentID> torrentIDs;
+    for (const auto &[torrentID, membership] : m_filterMemberships.asKeyValueRange())
+    {
+        if (membership.trackerHosts.contains(host))
+            torrentIDs.insert(torrentID);
+    }
+
+    return torrentIDs;
+}
+
+void MaindataSyncLog::addPlaceholderTorrents()
+{
+    for (const BitTorrent::TorrentSnapshot &snapshot : asConst(BitTorrent::Session::instance()->startupSnapshots()))
+    {
+        if (m_torrents.contains(snapshot.id))
+            continue;
+
+        TorrentData torrentData;
+        torrentData.values.fill(QJsonValue(QJsonValue::Undefined));
+        for (int i = 0; i < TORRENT_FIELDS_COUNT; ++i)
+        {
+            if (!ALL_FIELDS.test(i))
+                continue;
+
+            if (const QJsonValue value = serializeTorrentSnapshotField(snapshot, static_cast<TorrentField>(i)); !value.isUndefined())
+            {
+                torrentData.values[i] = value;
+                torrentData.versions[i] = m_version;
+            }
+        }
+
+        m_torrents.insert(snapshot.id, torrentData);
+        m_changedTorrents.insert(snapshot.id, m_version);
+        m_placeholderTorrents.insert(snapshot.id);
+    }
+}
+
+bool MaindataSyncLog::applyTorrentChanges(const BitTorrent::Torrent *torrent, TorrentData &data, const TorrentSyncFieldSet &dirtyFields)
+{
+    bool isChanged = false;
+    const auto updateField = [this, &data, &isChanged](const int index, const QJsonValue &value)
+    {
+        if (data.values[index] == value)
+            return;
+
+        data.values[index] = value;
+        data.versions[index] = m_version;
+        isChanged = true;
+    };
+
+    for (int i = 0; i < TORRENT_FIELDS_COUNT; ++i)
+    {
+        if (dirtyFields.test(i))
+            updateField(i, serializeTorrentField(*torrent, static_cast<TorrentField>(i)));
+    }
+
+    if ((dirtyFields & ANNOUNCE_STATS_FIELDS).any())
+    {
+        const AnnounceStats stats = getAnnounceStats(*torrent);
+        updateField(FIELD_HAS_TRACKER_WARNING, stats.hasTrackerWarning);
+        updateField(FIELD_HAS_TRACKER_ERROR, stats.hasTrackerError);
+        updateField(FIELD_HAS_OTHER_ANNOUNCE_ERROR, stats.hasOtherAnnounceError);
+    }
+
+    if (isChanged)
+        m_changedTorrents.insert(torrent->id(), m_version);
+
+    return isChanged;
+}
+
+bool MaindataSyncLog::applyCategoryChanges(const QString &categoryName)
+{
+    const QJsonObject category = getCategoryInfo(categoryName);
+    QJsonObject &categorySnapshot = m_categories[categoryName];
+    if (categorySnapshot == category)
+        return false;
+
+    categorySnapshot = category;
+    m_removedCategories.remove(categoryName);
+    m_changedCategories.insert(categoryName, m_version);
+    return true;
+}
+
+bool MaindataSyncLog::applyServerStateChanges()
+{
+    m_isServerStateDirty = false;
+
+    const auto *session = BitTorrent::Session::instance();
+
+    QVariantMap serverState = getTransferInfo();
+    serverState[KEY_TRANSFER_FREESPACEONDISK] = m_freeDiskSpace;
+    QVariantMap freeSpaceOnVolumes;
+    for (const BitTorrent::StorageVolumeInfo &volume : asConst(session->storageVolumes()))
+        freeSpaceOnVolumes[volume.device] = volume.freeSpace;
+    serverState[KEY_TRANSFER_FREESPACEONVOLUMES] = freeSpaceOnVolumes;
+    serverState[KEY_SYNC_MAINDATA_QUEUEING] = session->isQueueingSystemEnabled();
+    serverState[KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS] = session->isAltGlobalSpeedLimitEnabled();
+    serverState[KEY_SYNC_MAINDATA_REFRESH_INTERVAL] = session->refreshInterval();
+    serverState[KEY_SYNC_MAINDATA_USE_SUBCATEGORIES] = session->isSubcategoriesEnabled();
+
+    bool isChanged = false;
+    for (auto it = serverState.cbegin(); it != serverState.cend(); ++it)
+    {
+        const QJsonValue value = QJsonValue::fromVariant(it.value());
+        if (m_serverState.value(it.key()) == value)
+            continue;
+
+        m_serverState[it.key()] = value;
+        m_serverStateVersions[it.key()] = m_version;
+        isChanged = true;
+    }
+
+    return isChanged;
+}
+
+void MaindataSyncLog::removeOutdatedChanges()
+{
+    const int outdatedVersion = m_version - REMOVED_ITEMS_HISTORY_LENGTH;
+    if (outdatedVersion <= m_oldestAvailableVersion)
+        return;
+
+    m_removedTorrents.removeUpTo(outdatedVersion);
+    m_removedCategories.removeUpTo(outdatedVersion);
+    m_removedTags.removeUpTo(outdatedVersion);
+    m_removedTrackers.removeUpTo(outdatedVersion);
+    m_oldestAvailableVersion = outdatedVersion;
+}
+
+void MaindataSyncLog::updateFilterMembership(const BitTorrent::Torrent *torrent, const TorrentSyncFieldSet &dirtyFields)
+{
+    static const std::array<TorrentFilter, TorrentFilter::_Count> statusFilters = []
+    {
+        std::array<TorrentFilter, TorrentFilter::_Count> filters;
+        for (int type = 0; type < TorrentFilter::_Count; ++type)
+            filters[type] = TorrentFilter(static_cast<TorrentFilter::Type>(type));
+        return filters;
+    }();
+    static const TorrentSyncFieldSet categoryFields = makeFieldSet({TorrentField::Category});
+    static const TorrentSyncFieldSet tagsFields = makeFieldSet({TorrentField::Tags});
+
+    TorrentFilterMembership &membership = m_filterMemberships[torrent->id()];
+    const bool isNew = !membership.isCounted;
+    membership.isCounted = true;
+
+    if (isNew || (dirtyFields & STATUS_FIELDS).any())
+    {
+        quint32 statuses = 0;
+        for (int type = 0; type < TorrentFilter::_Count; ++type)
+        {
+            if (statusFilters[type].match(torrent))
+                statuses |= (1U << type);
+        }
+
+        for (int type = 0; type < TorrentFilter::_Count; ++type)
+        {
+            const bool wasMatched = (membership.statuses & (1U << type));
+            const bool isMatched = (statuses & (1U << type));
+            if (wasMatched != isMatched)
+                changeFilterCount(FilterGroup::Status, STATUS_FILTER_NAMES[type], (isMatched ? 1 : -1));
+        }
+        membership.statuses = statuses;
+    }
+
+    if (const QString category = torrent->category(); isNew || ((dirtyFields & categoryFields).any() && (category != membership.category)))
+    {
+        if (!isNew)
+            changeFilterCount(FilterGroup::Category, membership.category, -1);
+        changeFilterCount(FilterGroup::Category, category, 1);
+        membership.category = category;
+    }
+
+    if (isNew || (dirtyFields & tagsFields).any())
+    {
+        const TagSet torrentTags = torrent->tags();
+        QSet<QString> tags;
+        for (const Tag &tag : torrentTags)
+            tags.insert(tag.toString());
+        // untagged torrents are counted under empty tag
+        if (tags.isEmpty())
+            tags.insert(QString());
+
+        if (isNew || (tags != membership.tags))
+        {
+            for (const QString &tag : asConst(membership.tags))
+            {
+                if (!tags.contains(tag))
+                    changeFilterCount(FilterGroup::Tag, tag, -1);
+            }
+            for (const QString &tag : asConst(tags))
+            {
+                if (!membership.tags.contains(tag))
+                    changeFilterCount(FilterGroup::Tag, tag, 1);
+            }
+            membership.tags = tags;
+        }
+    }
+}
+
+void MaindataSyncLog::updateTrackerHostsMembership(const BitTorrent::TorrentID &torrentID, const QList<BitTorrent::TrackerEntryStatus> &trackers)
+{
+    QSet<QString> trackerHosts;
+    for (const BitTorrent::TrackerEntryStatus &status : trackers)
+    {
+        const QString host = QUrl(status.url).host();
+        trackerHosts.insert(host.isEmpty() ? status.url : host);
+    }
+    // torrents without trackers are counted under empty host
+    if (trackerHosts.isEmpty())
+        trackerHosts.insert(QString());
+
+    TorrentFilterMembership &membership = m_filterMemberships[torrentID];
+    if (membership.isTrackersCounted && (trackerHosts == membership.trackerHosts))
+        return;
+
+    for (const QString &host : asConst(membership.trackerHosts))
+    {
+        if (!trackerHosts.contains(host))
+            changeFilterCount(FilterGroup::Tracker, host, -1);
+    }
+    for (const QString &host : asConst(trackerHosts))
+    {
+        if (!membership.trackerHosts.contains(host))
+            changeFilterCount(FilterGroup::Tracker, host, 1);
+    }
+    membership.trackerHosts = trackerHosts;
+    membership.isTrackersCounted = true;
+}
+
+void MaindataSyncLog::removeFilterMembership(const BitTorrent::TorrentID &torrentID)
+{
+    const auto iter = m_filterMemberships.constFind(torrentID);
+    if (iter == m_filterMemberships.cend())
+        return;
+
+    const TorrentFilterMembership &membership = iter.value();
+    if (membership.isCounted)
+    {
+        for (int type = 0; type < TorrentFilter::_Count; ++type)
+        {
+            if (membership.statuses & (1U << type))
+                changeFilterCount(FilterGroup::Status, STATUS_FILTER_NAMES[type], -1);
+        }
+        changeFilterCount(FilterGroup::Category, membership.category, -1);
+        for (const QString &tag : membership.tags)
+            changeFilterCount(FilterGroup::Tag, tag, -1);
+    }
+    for (const QString &host : membership.trackerHosts)
+        changeFilterCount(FilterGroup::Tracker, host, -1);
+
+    m_filterMemberships.erase(iter);
+}
+
+void MaindataSyncLog::changeFilterCount(const FilterGroup group, const QString &name, const int delta)
+{
+    const FilterKey key {static_cast<int>(group), name};
+    m_filterCounts[key] += delta;
+    m_dirtyFilterCounts.insert(key);
+}
+
+bool MaindataSyncLog::applyFilterCountChanges()
+{
+    if (m_dirtyFilterCounts.isEmpty())
+        return false;
+
+    for (const FilterKey &key : asConst(m_dirtyFilterCounts))
+        m_changedFilterCounts.insert(key, m_version);
+    m_dirtyFilterCounts.clear();
+    return true;
+}
+
+void MaindataSyncLog::markTorrentDirty(const BitTorrent::Torrent *torrent, const TorrentSyncFieldSet &fields)
+{
+    m_dirtyTorrents[torrent->id()] |= fields;
+}
+
+void MaindataSyncLog::onCategoryAdded(const QString &categoryName)
+{
+    m_pendingRemovedCategories.remove(categoryName);
+    m_updatedCategories.insert(categoryName);
+}
+
+void MaindataSyncLog::onCategoryRemoved(const QString &categoryName)
+{
+    m_updatedCategories.remove(categoryName);
+    m_pendingRemovedCategories.insert(categoryName);
+}
+
+void MaindataSyncLog::onCategoryOptionsChanged(const QString &categoryName)
+{
+    Q_ASSERT(!m_pendingRemovedCategories.contains(categoryName));
+
+    m_updatedCategories.insert(categoryName);
+}
+
+void MaindataSyncLog::onSubcategoriesSupportChanged()
+{
+    const QStringList categoriesList = BitTorrent::Session::instance()->categories();
+    for (const auto &categoryName : categoriesList)
+    {
+        if (!m_categories.contains(categoryName))
+        {
+            m_pendingRemovedCategories.remove(categoryName);
+            m_updatedCategories.insert(categoryName);
+        }
+    }
+
+    m_isServerStateDirty = true;
+}
+
+void MaindataSyncLog::onTagAdded(const Tag &tag)
+{
+    m_pendingRemovedTags.remove(tag.toString());
+    m_pendingAddedTags.insert(tag.toString());
+}
+
+void MaindataSyncLog::onTagRemoved(const Tag &tag)
+{
+    m_pendingAddedTags.remove(tag.toString());
+    m_pendingRemovedTags.insert(tag.toString());
+}
+
+void MaindataSyncLog::onTorrentAdded(BitTorrent::Torrent *torrent)
+{
+    const BitTorrent::TorrentID torrentID = torrent->id();
+
+    m_pendingRemovedTorrents.remove(torrentID);
+    markTorrentDirty(torrent, ALL_FIELDS);
+
+    const QList<BitTorrent::TrackerEntryStatus> trackers = torrent->trackers();
+    for (const BitTorrent::TrackerEntryStatus &status : trackers)
+    {
+        m_knownTrackers[status.url].insert(torrentID);
+        m_updatedTrackers.insert(status.url);
+        m_pendingRemovedTrackers.remove(status.url);
+    }
+    updateTrackerHostsMembership(torrentID, trackers);
+}
+
+void MaindataSyncLog::onTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent)
+{
+    const BitTorrent::TorrentID torrentID = torrent->id();
+
+    m_dirtyTorrents.remove(torrentID);
+    m_pendingRemovedTorrents.insert(torrentID);
+    removeFilterMembership(torrentID);
+
+    for (const BitTorrent::TrackerEntryStatus &status : asConst(torrent->trackers()))
+    {
+        const auto iter = m_knownTrackers.find(status.url);
+        Q_ASSERT(iter != m_knownTrackers.end());
+        if (iter == m_knownTrackers.end()) [[unlikely]]
+            continue;
+
+        QSet<BitTorrent::TorrentID> &torrentIDs = iter.value();
+        torrentIDs.remove(torrentID);
+        if (torrentIDs.isEmpty())
+        {
+            m_knownTrackers.erase(iter);
+            m_updatedTrackers.remove(status.url);
+            m_pendingRemovedTrackers.insert(status.url);
+        }
+        else
+        {
+            m_updatedTrackers.insert(status.url);
+        }
+    }
+}
+
+void MaindataSyncLog::onTorrentCategoryChanged(BitTorrent::Torrent *torrent
+        , [[maybe_unused]] const QString &oldCategory)
+{
+    // Category can affect torrent paths when Automatic Torrent Management is enabled
+    markTorrentDirty(torrent, makeFieldSet({TorrentField::Category}) | PATH_FIELDS);
+}
+
+void MaindataSyncLog::onTorrentMetadataReceived(BitTorrent::Torrent *torrent)
+{
+    markTorrentDirty(torrent, STATUS_FIELDS | METADATA_FIELDS);
+}
+
+void MaindataSyncLog::onTorrentStopped(BitTorrent::Torrent *torrent)
+{
+    markTorrentDirty(torrent, STATUS_FIELDS | ANNOUNCE_STATS_FIELDS);
+}
+
+void MaindataSyncLog::onTorrentStarted(BitTorrent::Torrent *torrent)
+{
+    markTorrentDirty(torrent, STATUS_FIELDS);
+}
+
+void MaindataSyncLog::onTorrentSavePathChanged(BitTorrent::Torrent *torrent)
+{
+    markTorrentDirty(torrent, PATH_FIELDS);
+}
+
+void MaindataSyncLog::onTorrentSavingModeChanged(BitTorrent::Torrent *torrent)
+{
+    markTorrentDirty(torrent, makeFieldSet({TorrentField::AutoTorrentManagement}) | PATH_FIELDS);
+}
+
+void MaindataSyncLog::onTorrentTagAdded(BitTorrent::Torrent *torrent, [[maybe_unused]] const Tag &tag)
+{
+    markTorrentDirty(torrent, makeFieldSet({TorrentField::Tags}));
+}
+
+void MaindataSyncLog::onTorrentTagRemoved(BitTorrent::Torrent *torrent, [[maybe_unused]] const Tag &tag)
+{
+    markTorrentDirty(torrent, makeFieldSet({TorrentField::Tags}));
+}
+
+void MaindataSyncLog::onTorrentsLoaded(const QList<BitTorrent::Torrent *> &torrents)
+{
+    // Torrents restored at startup aren't reported as added
+    for (BitTorrent::Torrent *torrent : torrents)
+        onTorrentAdded(torrent);
+}
+
+void MaindataSyncLog::onTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents)
+{
+    for (const BitTorrent::Torrent *torrent : torrents)
+        markTorrentDirty(torrent, STATUS_FIELDS);
+}
+
+void MaindataSyncLog::onTorrentTrackersChanged(BitTorrent::Torrent *torrent)
+{
+    using namespace BitTorrent;
+
+    const QList<TrackerEntryStatus> trackers = torrent->trackers();
+
+    QSet<QString> currentTrackers;
+    currentTrackers.reserve(trackers.size());
+    for (const TrackerEntryStatus &status : trackers)
+        currentTrackers.insert(status.url);
+
+    const TorrentID torrentID = torrent->id();
+    Algorithm::removeIf(m_knownTrackers
+        , [this, torrentID, currentTrackers](const QString &knownTracker, QSet<TorrentID> &torrentIDs)
+    {
+        if (auto idIter = torrentIDs.find(torrentID)
+                ; (idIter != torrentIDs.end()) && !currentTrackers.contains(knownTracker))
+        {
+            torrentIDs.erase(idIter);
+            if (torrentIDs.isEmpty())
+            {
+                m_updatedTrackers.remove(knownTracker);
+                m_pendingRemovedTrackers.insert(knownTracker);
+                return true;
+            }
+
+            m_updatedTrackers.insert(knownTracker);
+            return false;
+        }
+
+        if (currentTrackers.contains(knownTracker) && !torrentIDs.contains(torrentID))
+        {
+            torrentIDs.insert(torrentID);
+            m_updatedTrackers.insert(knownTracker);
+            return false;
+        }
+
+        return false;
+    });
+
+    for (const QString &currentTracker : asConst(currentTrackers))
+    {
+        if (!m_knownTrackers.contains(currentTracker))
+        {
+            m_knownTrackers.insert(currentTracker, {torrentID});
+            m_updatedTrackers.insert(currentTracker);
+            m_pendingRemovedTrackers.remove(currentTracker);
+        }
+    }
+
+    updateTrackerHostsMembership(torrentID, trackers);
+    markTorrentDirty(torrent, TRACKERS_FIELDS);
+}
+
+void MaindataSyncLog::onTorrentTrackerEntryStatusesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntryStatus>> &updatedTrackers)
+{
+    for (auto iter = updatedTrackers.cbegin(); iter != updatedTrackers.cend(); ++iter)
+        markTorrentDirty(iter.key(), ANNOUNCE_STATS_FIELDS);
+}
+
+void MaindataSyncLog::onFreeDiskSpaceChecked(const qint64 freeDiskSpace)
+{
+    m_freeDiskSpace = freeDiskSpace;
+    m_isServerStateDirty = true;
+}
+
+void MaindataSyncLog::onSessionRestored()
+{
+    // Remaining placeholders belong to the torrents that failed to load
+    for (const BitTorrent::TorrentID &torrentID : asConst(m_placeholderTorrents))
+        m_pendingRemovedTorrents.insert(torrentID);
+    m_placeholderTorrents.clear();
+}
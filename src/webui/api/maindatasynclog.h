@@ -0,0 +1,264 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <map>
+#include <optional>
+#include <utility>
+
+#include <QHash>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include "base/bittorrent/infohash.h"
+#include "base/tag.h"
+#include "serialize/serialize_torrent.h"
+
+class QTimer;
+
+namespace BitTorrent
+{
+    class Torrent;
+    struct TrackerEntryStatus;
+}
+
+// Torrent fields are followed by the announce statistics that are only exposed by "sync/maindata"
+inline constexpr int TORRENT_SYNC_FIELDS_COUNT = TORRENT_FIELDS_COUNT + 3;
+using TorrentSyncFieldSet = std::bitset<TORRENT_SYNC_FIELDS_COUNT>;
+
+// Returns nullopt if some key is unknown
+std::optional<TorrentSyncFieldSet> torrentSyncFieldsFromKeys(const QStringList &keys);
+
+// Server-wide log of "sync/maindata" changes shared by all WebUI sessions.
+// Pending changes are applied at most once per refresh and stamped with a version,
+// so a client only needs to know the version of the data it has (i.e. its "rid")
+// and the changes since that version are collected in O(changes).
+class MaindataSyncLog final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(MaindataSyncLog)
+
+public:
+    explicit MaindataSyncLog(QObject *parent = nullptr);
+    ~MaindataSyncLog() override;
+
+    // Applies pending changes and returns the version of the resulting data
+    int update();
+    int version() const;
+    // Returns whether the changes since the given version are still available
+    bool canSyncSince(int version) const;
+    // Returns the changes since the given version, or full data if the version is 0.
+    // Torrents data is limited to the given fields, and to the given torrents if they are specified.
+    QJsonObject generateSyncData(int sinceVersion, const TorrentSyncFieldSet &torrentFields = TorrentSyncFieldSet().set()
+            , const QSet<BitTorrent::TorrentID> *torrentIDs = nullptr) const;
+    // Returns full data of the given torrents by their IDs
+    QJsonObject generateTorrentsData(const QSet<BitTorrent::TorrentID> &torrentIDs, const TorrentSyncFieldSet &torrentFields) const;
+    // Returns the torrents having a tracker of the given host, or no trackers if the host is empty
+    QSet<BitTorrent::TorrentID> trackerHostTorrents(const QString &host) const;
+    // Rough estimation of the memory used by the current data and the applied changes
+    qint64 estimatedMemoryUsage() const;
+
+private:
+    // Keeps the version of the last change of each key
+    // and allows to enumerate the keys changed since some version
+    template <typename Key>
+    class ChangeIndex
+    {
+    public:
+        void insert(const Key &key, const int version)
+        {
+            remove(key);
+            m_versions.insert(key, version);
+            m_keysByVersion[version].insert(key);
+        }
+
+        bool remove(const Key &key)
+        {
+            const auto iter = m_versions.constFind(key);
+            if (iter == m_versions.cend())
+                return false;
+
+            const auto bucketIter = m_keysByVersion.find(iter.value());
+            bucketIter->second.remove(key);
+            if (bucketIter->second.isEmpty())
+                m_keysByVersion.erase(bucketIter);
+            m_versions.erase(iter);
+            return true;
+        }
+
+        // Removes the keys changed at the given version or earlier
+        void removeUpTo(const int version)
+        {
+            const auto end = m_keysByVersion.upper_bound(version);
+            for (auto it = m_keysByVersion.begin(); it != end; ++it)
+            {
+                for (const Key &key : it->second)
+                    m_versions.remove(key);
+            }
+            m_keysByVersion.erase(m_keysByVersion.begin(), end);
+        }
+
+        template <typename Func>
+        void forEachSince(const int version, Func func) const
+        {
+            for (auto it = m_keysByVersion.upper_bound(version); it != m_keysByVersion.cend(); ++it)
+            {
+                for (const Key &key : it->second)
+                    func(key);
+            }
+        }
+
+        qint64 estimatedMemoryUsage() const
+        {
+            // Each key is stored in both containers along with its version
+            const qint64 entryOverhead = 32;
+            return m_versions.size() * static_cast<qint64>((2 * sizeof(Key)) + sizeof(int) + entryOverhead);
+        }
+
+    private:
+        QHash<Key, int> m_versions;
+        std::map<int, QSet<Key>> m_keysByVersion;
+    };
+
+    struct TorrentData
+    {
+        std::array<QJsonValue, TORRENT_SYNC_FIELDS_COUNT> values;
+        std::array<int, TORRENT_SYNC_FIELDS_COUNT> versions {};
+    };
+
+    // Filters of the sidebar (i.e. status, category, tag and tracker host) the torrent is counted in
+    struct TorrentFilterMembership
+    {
+        bool isCounted = false;
+        quint32 statuses = 0;
+        QString category;
+        QSet<QString> tags;
+        QSet<QString> trackerHosts;
+        bool isTrackersCounted = false;
+    };
+
+    enum class FilterGroup
+    {
+        Status,
+        Category,
+        Tag,
+        Tracker
+    };
+
+    using FilterKey = std::pair<int, QString>;
+
+    // Returns the given fields of the torrent data changed after the given version
+    static QJsonObject serializeTorrentData(const TorrentData &data, const TorrentSyncFieldSet &fields, int sinceVersion);
+
+    void start();
+    void addPlaceholderTorrents();
+    // Following functions return whether some values have been changed
+    bool applyTorrentChanges(const BitTorrent::Torrent *torrent, TorrentData &data, const TorrentSyncFieldSet &dirtyFields);
+    bool applyCategoryChanges(const QString &categoryName);
+    bool applyServerStateChanges();
+    void removeOutdatedChanges();
+    void updateFilterMembership(const BitTorrent::Torrent *torrent, const TorrentSyncFieldSet &dirtyFields);
+    void updateTrackerHostsMembership(const BitTorrent::TorrentID &torrentID, const QList<BitTorrent::TrackerEntryStatus> &trackers);
+    void removeFilterMembership(const BitTorrent::TorrentID &torrentID);
+    void changeFilterCount(FilterGroup group, const QString &name, int delta);
+    bool applyFilterCountChanges();
+
+    void markTorrentDirty(const BitTorrent::Torrent *torrent, const TorrentSyncFieldSet &fields);
+
+    void onCategoryAdded(const QString &categoryName);
+    void onCategoryRemoved(const QString &categoryName);
+    void onCategoryOptionsChanged(const QString &categoryName);
+    void onSubcategoriesSupportChanged();
+    void onTagAdded(const Tag &tag);
+    void onTagRemoved(const Tag &tag);
+    void onTorrentAdded(BitTorrent::Torrent *torrent);
+    void onTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent);
+    void onTorrentCategoryChanged(BitTorrent::Torrent *torrent, const QString &oldCategory);
+    void onTorrentMetadataReceived(BitTorrent::Torrent *torrent);
+    void onTorrentStopped(BitTorrent::Torrent *torrent);
+    void onTorrentStarted(BitTorrent::Torrent *torrent);
+    void onTorrentSavePathChanged(BitTorrent::Torrent *torrent);
+    void onTorrentSavingModeChanged(BitTorrent::Torrent *torrent);
+    void onTorrentTagAdded(BitTorrent::Torrent *torrent, const Tag &tag);
+    void onTorrentTagRemoved(BitTorrent::Torrent *torrent, const Tag &tag);
+    void onTorrentsLoaded(const QList<BitTorrent::Torrent *> &torrents);
+    void onTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents);
+    void onTorrentTrackersChanged(BitTorrent::Torrent *torrent);
+    void onTorrentTrackerEntryStatusesUpdated(const QHash<BitTorrent::Torrent *, QHash<QString, BitTorrent::TrackerEntryStatus>> &updatedTrackers);
+    void onFreeDiskSpaceChecked(qint64 freeDiskSpace);
+    void onSessionRestored();
+
+    QTimer *m_refreshSubscriptionTimer = nullptr;
+    bool m_isStarted = false;
+    int m_version = 0;
+    // Changes made at this version or earlier may be partially lost
+    int m_oldestAvailableVersion = 0;
+    qint64 m_freeDiskSpace = 0;
+
+    // Current data
+    QHash<BitTorrent::TorrentID, TorrentData> m_torrents;
+    // Torrents saved at last shutdown that are shown until they are loaded
+    QSet<BitTorrent::TorrentID> m_placeholderTorrents;
+    QHash<QString, QJsonObject> m_categories;
+    QSet<QString> m_tags;
+    QHash<QString, QSet<BitTorrent::TorrentID>> m_knownTrackers;
+    QJsonObject m_serverState;
+    QHash<QString, int> m_serverStateVersions;
+    QHash<BitTorrent::TorrentID, TorrentFilterMembership> m_filterMemberships;
+    QHash<FilterKey, int> m_filterCounts;
+
+    // Applied changes
+    ChangeIndex<BitTorrent::TorrentID> m_changedTorrents;
+    ChangeIndex<BitTorrent::TorrentID> m_removedTorrents;
+    ChangeIndex<QString> m_changedCategories;
+    ChangeIndex<QString> m_removedCategories;
+    ChangeIndex<QString> m_addedTags;
+    ChangeIndex<QString> m_removedTags;
+    ChangeIndex<QString> m_changedTrackers;
+    ChangeIndex<QString> m_removedTrackers;
+    ChangeIndex<FilterKey> m_changedFilterCounts;
+
+    // Pending changes
+    QHash<BitTorrent::TorrentID, TorrentSyncFieldSet> m_dirtyTorrents;
+    QSet<BitTorrent::TorrentID> m_pendingRemovedTorrents;
+    QSet<QString> m_updatedCategories;
+    QSet<QString> m_pendingRemovedCategories;
+    QSet<QString> m_pendingAddedTags;
+    QSet<QString> m_pendingRemovedTags;
+    QSet<QString> m_updatedTrackers;
+    QSet<QString> m_pendingRemovedTrackers;
+    QSet<FilterKey> m_dirtyFilterCounts;
+    bool m_isServerStateDirty = false;
+};
@@ -28,12 +28,14 @@
 
 #include "rsscontroller.h"
 
+#include <QDateTime>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QList>
 
+#include "base/global.h"
 #include "base/rss/rss_article.h"
 #include "base/rss/rss_autodownloader.h"
 #include "base/rss/rss_autodownloadrule.h"
@@ -134,6 +136,63 @@ void RSSController::itemsAction()
     setResult(jsonVal.toObject());
 }
 
+// Returns the articles of RSS item, the most recent first
+// GET params:
+//   - itemPath (string): path of RSS feed or folder (root folder by default)
+//   - unreadOnly (bool): return only the unread articles
+//   - since (int): return only the articles published after the given time (Unix timestamp)
+//   - withDescription (bool): include article descriptions
+//   - limit (int): maximum number of articles returned (if greater than 0, otherwise - unlimited)
+//   - offset (int): number of matching articles to skip
+void RSSController::articlesAction()
+{
+    const QString itemPath = params()[u"itemPath"_s];
+    const bool unreadOnly = parseBool(params()[u"unreadOnly"_s]).value_or(false);
+    const bool withDescription = parseBool(params()[u"withDescription"_s]).value_or(false);
+    const int limit = params()[u"limit"_s].toInt();
+    const int offset = std::max(params()[u"offset"_s].toInt(), 0);
+
+    QDateTime since;
+    if (const QString sinceParam = params()[u"since"_s]; !sinceParam.isEmpty())
+    {
+        bool ok = false;
+        const qint64 timestamp = sinceParam.toLongLong(&ok);
+        if (!ok)
+            throw APIError(APIErrorType::BadParams, tr("Invalid 'since' value"));
+        since = QDateTime::fromSecsSinceEpoch(timestamp);
+    }
+
+    const RSS::Item *item = RSS::Session::instance()->itemByPath(itemPath);
+    if (!item)
+        throw APIError(APIErrorType::NotFound, tr("RSS item doesn't exist: %1.").arg(itemPath));
+
+    QJsonArray articlesArray;
+    int total = 0;
+    for (const RSS::Article *article : asConst(item->articles()))
+    {
+        // articles are ordered by date so there are no more recent ones
+        if (since.isValid() && !RSS::Article::articleDateRecentThan(article, since))
+            break;
+        if (unreadOnly && article->isRead())
+            continue;
+
+        ++total;
+        if ((total <= offset) || ((limit > 0) && (articlesArray.size() >= limit)))
+            continue;
+
+        QJsonObject articleObj = article->data().toJsonObject();
+        if (!withDescription)
+            articleObj.remove(RSS::Article::KeyDescription);
+        articleObj[u"feedPath"_s] = article->feed()->path();
+        articlesArray.append(articleObj);
+    }
+
+    setResult(QJsonObject {
+        {u"total"_s, total},
+        {u"articles"_s, articlesArray}
+    });
+}
+
 void RSSController::markAsReadAction()
 {
     requireParams({u"itemPath"_s});
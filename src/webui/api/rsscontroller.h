@@ -46,6 +46,7 @@ private slots:
     void removeItemAction();
     void moveItemAction();
     void itemsAction();
+    void articlesAction();
     void markAsReadAction();
     void refreshItemAction();
     void setRuleAction();
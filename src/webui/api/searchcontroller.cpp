@@ -30,6 +30,7 @@
 #include "searchcontroller.h"
 
 #include <limits>
+#include <optional>
 
 #include <QHash>
 #include <QJsonArray>
@@ -60,6 +61,25 @@ namespace
     *   - "id"
     *   - "name"
     */
+    std::optional<SearchResultStore::SortKey> resultSortKey(const QString &column)
+    {
+        if (column.isEmpty())
+            return SearchResultStore::SortKey::None;
+        if (column == u"fileName")
+            return SearchResultStore::SortKey::Name;
+        if (column == u"fileSize")
+            return SearchResultStore::SortKey::Size;
+        if (column == u"nbSeeders")
+            return SearchResultStore::SortKey::Seeders;
+        if (column == u"nbLeechers")
+            return SearchResultStore::SortKey::Leechers;
+        if (column == u"engineName")
+            return SearchResultStore::SortKey::EngineName;
+        if (column == u"pubDate")
+            return SearchResultStore::SortKey::PubDate;
+        return std::nullopt;
+    }
+
     QJsonArray getPluginCategories(QStringList categories)
     {
         QJsonArray categoriesInfo
@@ -82,6 +102,15 @@ namespace
     }
 }
 
+qint64 SearchController::estimatedMemoryUsage() const
+{
+    qint64 size = 0;
+    for (const std::shared_ptr<SearchHandler> &searchHandler : asConst(m_searchHandlers))
+        size += searchHandler->estimatedResultsMemoryUsage();
+
+    return size;
+}
+
 void SearchController::startAction()
 {
     requireParams({u"pattern"_s, u"category"_s, u"plugins"_s});
@@ -163,7 +192,7 @@ void SearchController::statusAction()
         {
             {u"id"_s, searchId},
             {u"status"_s, searchHandler->isActive() ? u"Running"_s : u"Stopped"_s},
-            {u"total"_s, searchHandler->results().size()}
+            {u"total"_s, searchHandler->resultStore().size()}
         };
     }
 
@@ -183,8 +212,8 @@ void SearchController::resultsAction()
         throw APIError(APIErrorType::NotFound);
 
     const std::shared_ptr<SearchHandler> &searchHandler = iter.value();
-    const QList<SearchResult> searchResults = searchHandler->results();
-    const qsizetype size = searchResults.size();
+    const SearchResultStore &resultStore = searchHandler->resultStore();
+    const qsizetype size = resultStore.size();
 
     if (offset > size)
         throw APIError(APIErrorType::Conflict, tr("Offset is out of range"));
@@ -197,10 +226,16 @@ void SearchController::resultsAction()
     if (limit <= 0)
         limit = -1;
 
-    if ((limit > 0) || (offset > 0))
-        setResult(getResults(searchResults.mid(offset, limit), searchHandler->isActive(), size));
-    else
-        setResult(getResults(searchResults, searchHandler->isActive(), size));
+    const QString sortedColumn = params()[u"sort"_s];
+    const bool reverse = Utils::String::parseBool(params()[u"reverse"_s]).value_or(false);
+    const auto sortKey = resultSortKey(sortedColumn);
+    if (!sortKey)
+        throw APIError(APIErrorType::BadParams, tr("'sort' is invalid"));
+
+    // only the requested window is copied out of the store
+    const QList<SearchResult> searchResults = resultStore.window(offset, limit, *sortKey
+        , (reverse ? Qt::DescendingOrder : Qt::AscendingOrder));
+    setResult(getResults(searchResults, searchHandler->isActive(), size));
 }
 
 void SearchController::deleteAction()
@@ -51,6 +51,9 @@ class SearchController : public APIController
 public:
     using APIController::APIController;
 
+    // Rough estimation of the memory used by the results of the searches
+    qint64 estimatedMemoryUsage() const;
+
 private slots:
     void startAction();
     void stopAction();
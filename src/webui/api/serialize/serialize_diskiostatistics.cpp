@@ -0,0 +1,68 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "serialize_diskiostatistics.h"
+
+#include <QJsonArray>
+
+#include "base/bittorrent/diskiostatistics.h"
+
+namespace
+{
+    QJsonArray toJsonArray(const std::array<qint64, BitTorrent::DISK_IO_LATENCY_HISTOGRAM_SIZE> &histogram)
+    {
+        QJsonArray array;
+        for (const qint64 value : histogram)
+            array.append(value);
+        return array;
+    }
+
+    QJsonObject serializeOperation(const BitTorrent::DiskIOOperationStatistics &stats)
+    {
+        return {
+            {KEY_DISK_IO_COUNT, stats.count},
+            {KEY_DISK_IO_BYTES, stats.bytes},
+            {KEY_DISK_IO_TOTAL_LATENCY, stats.totalLatency},
+            {KEY_DISK_IO_MAX_LATENCY, stats.maxLatency},
+            {KEY_DISK_IO_LATENCY_P50, stats.latencyPercentile(50)},
+            {KEY_DISK_IO_LATENCY_P95, stats.latencyPercentile(95)},
+            {KEY_DISK_IO_LATENCY_P99, stats.latencyPercentile(99)},
+            {KEY_DISK_IO_LATENCY_HISTOGRAM, toJsonArray(stats.latencyHistogram)}
+        };
+    }
+}
+
+QJsonObject serialize(const BitTorrent::DiskIOStatistics &stats)
+{
+    return {
+        {KEY_DISK_IO_READ, serializeOperation(stats[BitTorrent::DiskIOOperation::Read])},
+        {KEY_DISK_IO_WRITE, serializeOperation(stats[BitTorrent::DiskIOOperation::Write])},
+        {KEY_DISK_IO_HASH, serializeOperation(stats[BitTorrent::DiskIOOperation::Hash])},
+        {KEY_DISK_IO_MOVE, serializeOperation(stats[BitTorrent::DiskIOOperation::Move])}
+    };
+}
@@ -29,10 +29,12 @@
 #include "serialize_torrent.h"
 
 #include <QDateTime>
+#include <QHash>
 #include <QList>
 
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrentsnapshot.h"
 #include "base/bittorrent/trackerentrystatus.h"
 #include "base/path.h"
 #include "base/tagset.h"
@@ -41,144 +43,439 @@
 
 namespace
 {
-    QString torrentStateToString(const BitTorrent::TorrentState state)
+    int adjustQueuePosition(const int position)
     {
-        switch (state)
+        return (position < 0) ? 0 : (position + 1);
+    }
+
+    qreal adjustRatio(const qreal ratio)
+    {
+        return (ratio >= BitTorrent::Torrent::MAX_RATIO) ? -1 : ratio;
+    }
+
+    qint64 getLastActivityTime(const BitTorrent::Torrent &torrent)
+    {
+        const qlonglong timeSinceActivity = torrent.timeSinceActivity();
+        return (timeSinceActivity < 0)
+            ? Utils::DateTime::toSecsSinceEpoch(torrent.addedTime())
+            : (QDateTime::currentSecsSinceEpoch() - timeSinceActivity);
+    }
+}
+
+QString serializeTorrentState(const BitTorrent::TorrentState state)
+{
+    switch (state)
+    {
+    case BitTorrent::TorrentState::Error:
+        return u"error"_s;
+    case BitTorrent::TorrentState::MissingFiles:
+        return u"missingFiles"_s;
+    case BitTorrent::TorrentState::Uploading:
+        return u"uploading"_s;
+    case BitTorrent::TorrentState::StoppedUploading:
+        return u"stoppedUP"_s;
+    case BitTorrent::TorrentState::QueuedUploading:
+        return u"queuedUP"_s;
+    case BitTorrent::TorrentState::StalledUploading:
+        return u"stalledUP"_s;
+    case BitTorrent::TorrentState::CheckingUploading:
+        return u"checkingUP"_s;
+    case BitTorrent::TorrentState::ForcedUploading:
+        return u"forcedUP"_s;
+    case BitTorrent::TorrentState::Downloading:
+        return u"downloading"_s;
+    case BitTorrent::TorrentState::DownloadingMetadata:
+        return u"metaDL"_s;
+    case BitTorrent::TorrentState::ForcedDownloadingMetadata:
+        return u"forcedMetaDL"_s;
+    case BitTorrent::TorrentState::StoppedDownloading:
+        return u"stoppedDL"_s;
+    case BitTorrent::TorrentState::QueuedDownloading:
+        return u"queuedDL"_s;
+    case BitTorrent::TorrentState::StalledDownloading:
+        return u"stalledDL"_s;
+    case BitTorrent::TorrentState::CheckingDownloading:
+        return u"checkingDL"_s;
+    case BitTorrent::TorrentState::ForcedDownloading:
+        return u"forcedDL"_s;
+    case BitTorrent::TorrentState::CheckingResumeData:
+        return u"checkingResumeData"_s;
+    case BitTorrent::TorrentState::Moving:
+        return u"moving"_s;
+    default:
+        return u"unknown"_s;
+    }
+}
+
+const QString &torrentFieldKey(const TorrentField field)
+{
+    switch (field)
+    {
+    case TorrentField::ID:
+        return KEY_TORRENT_ID;
+    case TorrentField::InfoHashV1:
+        return KEY_TORRENT_INFOHASHV1;
+    case TorrentField::InfoHashV2:
+        return KEY_TORRENT_INFOHASHV2;
+    case TorrentField::Name:
+        return KEY_TORRENT_NAME;
+    case TorrentField::HasMetadata:
+        return KEY_TORRENT_HAS_METADATA;
+    case TorrentField::CreatedBy:
+        return KEY_TORRENT_CREATED_BY;
+    case TorrentField::CreationDate:
+        return KEY_TORRENT_CREATION_DATE;
+    case TorrentField::Private:
+        return KEY_TORRENT_PRIVATE;
+    case TorrentField::TotalSize:
+        return KEY_TORRENT_TOTAL_SIZE;
+    case TorrentField::PiecesNum:
+        return KEY_TORRENT_PIECES_NUM;
+    case TorrentField::PieceSize:
+        return KEY_TORRENT_PIECE_SIZE;
+    case TorrentField::MagnetURI:
+        return KEY_TORRENT_MAGNET_URI;
+    case TorrentField::Size:
+        return KEY_TORRENT_SIZE;
+    case TorrentField::Progress:
+        return KEY_TORRENT_PROGRESS;
+    case TorrentField::TotalWasted:
+        return KEY_TORRENT_TOTAL_WASTED;
+    case TorrentField::PiecesHave:
+        return KEY_TORRENT_PIECES_HAVE;
+    case TorrentField::DLSpeed:
+        return KEY_TORRENT_DLSPEED;
+    case TorrentField::UPSpeed:
+        return KEY_TORRENT_UPSPEED;
+    case TorrentField::QueuePosition:
+        return KEY_TORRENT_QUEUE_POSITION;
+    case TorrentField::Seeds:
+        return KEY_TORRENT_SEEDS;
+    case TorrentField::NumComplete:
+        return KEY_TORRENT_NUM_COMPLETE;
+    case TorrentField::Leechs:
+        return KEY_TORRENT_LEECHS;
+    case TorrentField::NumIncomplete:
+        return KEY_TORRENT_NUM_INCOMPLETE;
+    case TorrentField::State:
+        return KEY_TORRENT_STATE;
+    case TorrentField::ETA:
+        return KEY_TORRENT_ETA;
+    case TorrentField::SequentialDownload:
+        return KEY_TORRENT_SEQUENTIAL_DOWNLOAD;
+    case TorrentField::FirstLastPiecePrio:
+        return KEY_TORRENT_FIRST_LAST_PIECE_PRIO;
+    case TorrentField::Category:
+        return KEY_TORRENT_CATEGORY;
+    case TorrentField::Tags:
+        return KEY_TORRENT_TAGS;
+    case TorrentField::SuperSeeding:
+        return KEY_TORRENT_SUPER_SEEDING;
+    case TorrentField::ForceStart:
+        return KEY_TORRENT_FORCE_START;
+    case TorrentField::SavePath:
+        return KEY_TORRENT_SAVE_PATH;
+    case TorrentField::DownloadPath:
+        return KEY_TORRENT_DOWNLOAD_PATH;
+    case TorrentField::ContentPath:
+        return KEY_TORRENT_CONTENT_PATH;
+    case TorrentField::RootPath:
+        return KEY_TORRENT_ROOT_PATH;
+    case TorrentField::AddedOn:
+        return KEY_TORRENT_ADDED_ON;
+    case TorrentField::CompletionOn:
+        return KEY_TORRENT_COMPLETION_ON;
+    case TorrentField::Tracker:
+        return KEY_TORRENT_TRACKER;
+    case TorrentField::TrackersCount:
+        return KEY_TORRENT_TRACKERS_COUNT;
+    case TorrentField::DLLimit:
+        return KEY_TORRENT_DL_LIMIT;
+    case TorrentField::UPLimit:
+        return KEY_TORRENT_UP_LIMIT;
+    case TorrentField::AmountDownloaded:
+        return KEY_TORRENT_AMOUNT_DOWNLOADED;
+    case TorrentField::AmountUploaded:
+        return KEY_TORRENT_AMOUNT_UPLOADED;
+    case TorrentField::AmountDownloadedSession:
+        return KEY_TORRENT_AMOUNT_DOWNLOADED_SESSION;
+    case TorrentField::AmountUploadedSession:
+        return KEY_TORRENT_AMOUNT_UPLOADED_SESSION;
+    case TorrentField::AmountLeft:
+        return KEY_TORRENT_AMOUNT_LEFT;
+    case TorrentField::AmountCompleted:
+        return KEY_TORRENT_AMOUNT_COMPLETED;
+    case TorrentField::ConnectionsCount:
+        return KEY_TORRENT_CONNECTIONS_COUNT;
+    case TorrentField::ConnectionsLimit:
+        return KEY_TORRENT_CONNECTIONS_LIMIT;
+    case TorrentField::MaxRatio:
+        return KEY_TORRENT_MAX_RATIO;
+    case TorrentField::MaxSeedingTime:
+        return KEY_TORRENT_MAX_SEEDING_TIME;
+    case TorrentField::MaxInactiveSeedingTime:
+        return KEY_TORRENT_MAX_INACTIVE_SEEDING_TIME;
+    case TorrentField::Ratio:
+        return KEY_TORRENT_RATIO;
+    case TorrentField::RatioLimit:
+        return KEY_TORRENT_RATIO_LIMIT;
+    case TorrentField::Popularity:
+        return KEY_TORRENT_POPULARITY;
+    case TorrentField::SeedingTimeLimit:
+        return KEY_TORRENT_SEEDING_TIME_LIMIT;
+    case TorrentField::InactiveSeedingTimeLimit:
+        return KEY_TORRENT_INACTIVE_SEEDING_TIME_LIMIT;
+    case TorrentField::ShareLimitAction:
+        return KEY_TORRENT_SHARE_LIMIT_ACTION;
+    case TorrentField::LastSeenCompleteTime:
+        return KEY_TORRENT_LAST_SEEN_COMPLETE_TIME;
+    case TorrentField::AutoTorrentManagement:
+        return KEY_TORRENT_AUTO_TORRENT_MANAGEMENT;
+    case TorrentField::TimeActive:
+        return KEY_TORRENT_TIME_ACTIVE;
+    case TorrentField::SeedingTime:
+        return KEY_TORRENT_SEEDING_TIME;
+    case TorrentField::LastActivityTime:
+        return KEY_TORRENT_LAST_ACTIVITY_TIME;
+    case TorrentField::Availability:
+        return KEY_TORRENT_AVAILABILITY;
+    case TorrentField::Reannounce:
+        return KEY_TORRENT_REANNOUNCE;
+    case TorrentField::Comment:
+        return KEY_TORRENT_COMMENT;
+    default:
+        Q_UNREACHABLE();
+        break;
+    }
+
+    return KEY_TORRENT_ID;
+}
+
+std::optional<TorrentField> torrentFieldFromKey(const QString &key)
+{
+    static const QHash<QString, TorrentField> fields = []
+    {
+        QHash<QString, TorrentField> result;
+        result.reserve(TORRENT_FIELDS_COUNT);
+        for (int i = 0; i < TORRENT_FIELDS_COUNT; ++i)
         {
-        case BitTorrent::TorrentState::Error:
-            return u"error"_s;
-        case BitTorrent::TorrentState::MissingFiles:
-            return u"missingFiles"_s;
-        case BitTorrent::TorrentState::Uploading:
-            return u"uploading"_s;
-        case BitTorrent::TorrentState::StoppedUploading:
-            return u"stoppedUP"_s;
-        case BitTorrent::TorrentState::QueuedUploading:
-            return u"queuedUP"_s;
-        case BitTorrent::TorrentState::StalledUploading:
-            return u"stalledUP"_s;
-        case BitTorrent::TorrentState::CheckingUploading:
-            return u"checkingUP"_s;
-        case BitTorrent::TorrentState::ForcedUploading:
-            return u"forcedUP"_s;
-        case BitTorrent::TorrentState::Downloading:
-            return u"downloading"_s;
-        case BitTorrent::TorrentState::DownloadingMetadata:
-            return u"metaDL"_s;
-        case BitTorrent::TorrentState::ForcedDownloadingMetadata:
-            return u"forcedMetaDL"_s;
-        case BitTorrent::TorrentState::StoppedDownloading:
-            return u"stoppedDL"_s;
-        case BitTorrent::TorrentState::QueuedDownloading:
-            return u"queuedDL"_s;
-        case BitTorrent::TorrentState::StalledDownloading:
-            return u"stalledDL"_s;
-        case BitTorrent::TorrentState::CheckingDownloading:
-            return u"checkingDL"_s;
-        case BitTorrent::TorrentState::ForcedDownloading:
-            return u"forcedDL"_s;
-        case BitTorrent::TorrentState::CheckingResumeData:
-            return u"checkingResumeData"_s;
-        case BitTorrent::TorrentState::Moving:
-            return u"moving"_s;
-        default:
-            return u"unknown"_s;
+            const auto field = static_cast<TorrentField>(i);
+            result.insert(torrentFieldKey(field), field);
         }
+        return result;
+    }();
+
+    if (const auto iter = fields.constFind(key); iter != fields.cend())
+        return iter.value();
+    return std::nullopt;
+}
+
+QJsonValue serializeTorrentField(const BitTorrent::Torrent &torrent, const TorrentField field)
+{
+    switch (field)
+    {
+    case TorrentField::ID:
+        return torrent.id().toString();
+    case TorrentField::InfoHashV1:
+        return torrent.infoHash().v1().toString();
+    case TorrentField::InfoHashV2:
+        return torrent.infoHash().v2().toString();
+    case TorrentField::Name:
+        return torrent.name();
+
+    case TorrentField::HasMetadata:
+        return torrent.hasMetadata();
+    case TorrentField::CreatedBy:
+        return torrent.creator();
+    case TorrentField::CreationDate:
+        return Utils::DateTime::toSecsSinceEpoch(torrent.creationDate());
+    case TorrentField::Private:
+        return torrent.hasMetadata() ? QJsonValue(torrent.isPrivate()) : QJsonValue();
+    case TorrentField::TotalSize:
+        return torrent.totalSize();
+    case TorrentField::PiecesNum:
+        return torrent.piecesCount();
+    case TorrentField::PieceSize:
+        return torrent.pieceLength();
+
+    case TorrentField::MagnetURI:
+        return torrent.createMagnetURI();
+    case TorrentField::Size:
+        return torrent.wantedSize();
+    case TorrentField::Progress:
+        return torrent.progress();
+    case TorrentField::TotalWasted:
+        return torrent.wastedSize();
+    case TorrentField::PiecesHave:
+        return torrent.piecesHave();
+    case TorrentField::DLSpeed:
+        return torrent.downloadPayloadRate();
+    case TorrentField::UPSpeed:
+        return torrent.uploadPayloadRate();
+    case TorrentField::QueuePosition:
+        return adjustQueuePosition(torrent.queuePosition());
+    case TorrentField::Seeds:
+        return torrent.seedsCount();
+    case TorrentField::NumComplete:
+        return torrent.totalSeedsCount();
+    case TorrentField::Leechs:
+        return torrent.leechsCount();
+    case TorrentField::NumIncomplete:
+        return torrent.totalLeechersCount();
+
+    case TorrentField::State:
+        return serializeTorrentState(torrent.state());
+    case TorrentField::ETA:
+        return torrent.eta();
+    case TorrentField::SequentialDownload:
+        return torrent.isSequentialDownload();
+    case TorrentField::FirstLastPiecePrio:
+        return torrent.hasFirstLastPiecePriority();
+
+    case TorrentField::Category:
+        return torrent.category();
+    case TorrentField::Tags:
+        return Utils::String::joinIntoString(torrent.tags(), u", "_s);
+    case TorrentField::SuperSeeding:
+        return torrent.superSeeding();
+    case TorrentField::ForceStart:
+        return torrent.isForced();
+    case TorrentField::SavePath:
+        return torrent.savePath().toString();
+    case TorrentField::DownloadPath:
+        return torrent.downloadPath().toString();
+    case TorrentField::ContentPath:
+        return torrent.contentPath().toString();
+    case TorrentField::RootPath:
+        return torrent.rootPath().toString();
+    case TorrentField::AddedOn:
+        return Utils::DateTime::toSecsSinceEpoch(torrent.addedTime());
+    case TorrentField::CompletionOn:
+        return Utils::DateTime::toSecsSinceEpoch(torrent.completedTime());
+    case TorrentField::Tracker:
+        return torrent.currentTracker();
+    case TorrentField::TrackersCount:
+        return static_cast<qint64>(torrent.trackers().size());
+    case TorrentField::DLLimit:
+        return torrent.downloadLimit();
+    case TorrentField::UPLimit:
+        return torrent.uploadLimit();
+    case TorrentField::AmountDownloaded:
+        return torrent.totalDownload();
+    case TorrentField::AmountUploaded:
+        return torrent.totalUpload();
+    case TorrentField::AmountDownloadedSession:
+        return torrent.totalPayloadDownload();
+    case TorrentField::AmountUploadedSession:
+        return torrent.totalPayloadUpload();
+    case TorrentField::AmountLeft:
+        return torrent.remainingSize();
+    case TorrentField::AmountCompleted:
+        return torrent.completedSize();
+    case TorrentField::ConnectionsCount:
+        return torrent.connectionsCount();
+    case TorrentField::ConnectionsLimit:
+        return torrent.connectionsLimit();
+    case TorrentField::MaxRatio:
+        return torrent.maxRatio();
+    case TorrentField::MaxSeedingTime:
+        return torrent.maxSeedingTime();
+    case TorrentField::MaxInactiveSeedingTime:
+        return torrent.maxInactiveSeedingTime();
+    case TorrentField::Ratio:
+        return adjustRatio(torrent.realRatio());
+    case TorrentField::RatioLimit:
+        return torrent.ratioLimit();
+    case TorrentField::Popularity:
+        return torrent.popularity();
+    case TorrentField::SeedingTimeLimit:
+        return torrent.seedingTimeLimit();
+    case TorrentField::InactiveSeedingTimeLimit:
+        return torrent.inactiveSeedingTimeLimit();
+    case TorrentField::ShareLimitAction:
+        return Utils::String::fromEnum(torrent.shareLimitAction());
+    case TorrentField::LastSeenCompleteTime:
+        return Utils::DateTime::toSecsSinceEpoch(torrent.lastSeenComplete());
+    case TorrentField::AutoTorrentManagement:
+        return torrent.isAutoTMMEnabled();
+    case TorrentField::TimeActive:
+        return torrent.activeTime();
+    case TorrentField::SeedingTime:
+        return torrent.finishedTime();
+    case TorrentField::LastActivityTime:
+        return getLastActivityTime(torrent);
+    case TorrentField::Availability:
+        return torrent.distributedCopies();
+    case TorrentField::Reannounce:
+        return torrent.nextAnnounce();
+    case TorrentField::Comment:
+        return torrent.comment();
+    default:
+        Q_UNREACHABLE();
+        break;
     }
+
+    return {};
 }
 
-QVariantMap serialize(const BitTorrent::Torrent &torrent)
+QJsonValue serializeTorrentSnapshotField(const BitTorrent::TorrentSnapshot &snapshot, const TorrentField field)
 {
-    const auto adjustQueuePosition = [](const int position) -> int
+    switch (field)
     {
-        return (position < 0) ? 0 : (position + 1);
-    };
+    case TorrentField::ID:
+        return snapshot.id.toString();
+    case TorrentField::Name:
+        return snapshot.name;
+    case TorrentField::Size:
+        return snapshot.wantedSize;
+    case TorrentField::Progress:
+        return snapshot.progress;
+    case TorrentField::State:
+        return serializeTorrentState(snapshot.state);
+    case TorrentField::Category:
+        return snapshot.category;
+    case TorrentField::Tags:
+        return Utils::String::joinIntoString(snapshot.tags, u", "_s);
+    case TorrentField::Ratio:
+        return adjustRatio(snapshot.ratio);
+    default:
+        break;
+    }
+
+    return QJsonValue::Undefined;
+}
 
-    const auto adjustRatio = [](const qreal ratio) -> qreal
+bool torrentFieldLessThan(const QJsonValue &left, const QJsonValue &right)
+{
+    // Values of the same field have the same type except "null" of the fields unavailable without metadata
+    if (left.type() != right.type())
+        return left.type() < right.type();
+
+    switch (left.type())
     {
-        return (ratio >= BitTorrent::Torrent::MAX_RATIO) ? -1 : ratio;
-    };
+    case QJsonValue::Bool:
+        return left.toBool() < right.toBool();
+    case QJsonValue::Double:
+        return left.toDouble() < right.toDouble();
+    case QJsonValue::String:
+        return left.toString() < right.toString();
+    default:
+        break;
+    }
+    return false;
+}
 
-    const auto getLastActivityTime = [&torrent]() -> qlonglong
+QJsonObject serialize(const BitTorrent::Torrent &torrent, const TorrentFieldSet &fields)
+{
+    QJsonObject result;
+    for (int i = 0; i < TORRENT_FIELDS_COUNT; ++i)
     {
-        const qlonglong timeSinceActivity = torrent.timeSinceActivity();
-        return (timeSinceActivity < 0)
-            ? Utils::DateTime::toSecsSinceEpoch(torrent.addedTime())
-            : (QDateTime::currentSecsSinceEpoch() - timeSinceActivity);
-    };
-
-    const bool hasMetadata = torrent.hasMetadata();
-
-    return {
-        {KEY_TORRENT_ID, torrent.id().toString()},
-        {KEY_TORRENT_INFOHASHV1, torrent.infoHash().v1().toString()},
-        {KEY_TORRENT_INFOHASHV2, torrent.infoHash().v2().toString()},
-        {KEY_TORRENT_NAME, torrent.name()},
-
-        {KEY_TORRENT_HAS_METADATA, hasMetadata},
-        {KEY_TORRENT_CREATED_BY, torrent.creator()},
-        {KEY_TORRENT_CREATION_DATE, Utils::DateTime::toSecsSinceEpoch(torrent.creationDate())},
-        {KEY_TORRENT_PRIVATE, (hasMetadata ? torrent.isPrivate() : QVariant())},
-        {KEY_TORRENT_TOTAL_SIZE, torrent.totalSize()},
-        {KEY_TORRENT_PIECES_NUM, torrent.piecesCount()},
-        {KEY_TORRENT_PIECE_SIZE, torrent.pieceLength()},
-
-        {KEY_TORRENT_MAGNET_URI, torrent.createMagnetURI()},
-        {KEY_TORRENT_SIZE, torrent.wantedSize()},
-        {KEY_TORRENT_PROGRESS, torrent.progress()},
-        {KEY_TORRENT_TOTAL_WASTED, torrent.wastedSize()},
-        {KEY_TORRENT_PIECES_HAVE, torrent.piecesHave()},
-        {KEY_TORRENT_DLSPEED, torrent.downloadPayloadRate()},
-        {KEY_TORRENT_UPSPEED, torrent.uploadPayloadRate()},
-        {KEY_TORRENT_QUEUE_POSITION, adjustQueuePosition(torrent.queuePosition())},
-        {KEY_TORRENT_SEEDS, torrent.seedsCount()},
-        {KEY_TORRENT_NUM_COMPLETE, torrent.totalSeedsCount()},
-        {KEY_TORRENT_LEECHS, torrent.leechsCount()},
-        {KEY_TORRENT_NUM_INCOMPLETE, torrent.totalLeechersCount()},
-
-        {KEY_TORRENT_STATE, torrentStateToString(torrent.state())},
-        {KEY_TORRENT_ETA, torrent.eta()},
-        {KEY_TORRENT_SEQUENTIAL_DOWNLOAD, torrent.isSequentialDownload()},
-        {KEY_TORRENT_FIRST_LAST_PIECE_PRIO, torrent.hasFirstLastPiecePriority()},
-
-        {KEY_TORRENT_CATEGORY, torrent.category()},
-        {KEY_TORRENT_TAGS, Utils::String::joinIntoString(torrent.tags(), u", "_s)},
-        {KEY_TORRENT_SUPER_SEEDING, torrent.superSeeding()},
-        {KEY_TORRENT_FORCE_START, torrent.isForced()},
-        {KEY_TORRENT_SAVE_PATH, torrent.savePath().toString()},
-        {KEY_TORRENT_DOWNLOAD_PATH, torrent.downloadPath().toString()},
-        {KEY_TORRENT_CONTENT_PATH, torrent.contentPath().toString()},
-        {KEY_TORRENT_ROOT_PATH, torrent.rootPath().toString()},
-        {KEY_TORRENT_ADDED_ON, Utils::DateTime::toSecsSinceEpoch(torrent.addedTime())},
-        {KEY_TORRENT_COMPLETION_ON, Utils::DateTime::toSecsSinceEpoch(torrent.completedTime())},
-        {KEY_TORRENT_TRACKER, torrent.currentTracker()},
-        {KEY_TORRENT_TRACKERS_COUNT, torrent.trackers().size()},
-        {KEY_TORRENT_DL_LIMIT, torrent.downloadLimit()},
-        {KEY_TORRENT_UP_LIMIT, torrent.uploadLimit()},
-        {KEY_TORRENT_AMOUNT_DOWNLOADED, torrent.totalDownload()},
-        {KEY_TORRENT_AMOUNT_UPLOADED, torrent.totalUpload()},
-        {KEY_TORRENT_AMOUNT_DOWNLOADED_SESSION, torrent.totalPayloadDownload()},
-        {KEY_TORRENT_AMOUNT_UPLOADED_SESSION, torrent.totalPayloadUpload()},
-        {KEY_TORRENT_AMOUNT_LEFT, torrent.remainingSize()},
-        {KEY_TORRENT_AMOUNT_COMPLETED, torrent.completedSize()},
-        {KEY_TORRENT_CONNECTIONS_COUNT, torrent.connectionsCount()},
-        {KEY_TORRENT_CONNECTIONS_LIMIT, torrent.connectionsLimit()},
-        {KEY_TORRENT_MAX_RATIO, torrent.maxRatio()},
-        {KEY_TORRENT_MAX_SEEDING_TIME, torrent.maxSeedingTime()},
-        {KEY_TORRENT_MAX_INACTIVE_SEEDING_TIME, torrent.maxInactiveSeedingTime()},
-        {KEY_TORRENT_RATIO, adjustRatio(torrent.realRatio())},
-        {KEY_TORRENT_RATIO_LIMIT, torrent.ratioLimit()},
-        {KEY_TORRENT_POPULARITY, torrent.popularity()},
-        {KEY_TORRENT_SEEDING_TIME_LIMIT, torrent.seedingTimeLimit()},
-        {KEY_TORRENT_INACTIVE_SEEDING_TIME_LIMIT, torrent.inactiveSeedingTimeLimit()},
-        {KEY_TORRENT_SHARE_LIMIT_ACTION, Utils::String::fromEnum(torrent.shareLimitAction())},
-        {KEY_TORRENT_LAST_SEEN_COMPLETE_TIME, Utils::DateTime::toSecsSinceEpoch(torrent.lastSeenComplete())},
-        {KEY_TORRENT_AUTO_TORRENT_MANAGEMENT, torrent.isAutoTMMEnabled()},
-        {KEY_TORRENT_TIME_ACTIVE, torrent.activeTime()},
-        {KEY_TORRENT_SEEDING_TIME, torrent.finishedTime()},
-        {KEY_TORRENT_LAST_ACTIVITY_TIME, getLastActivityTime()},
-        {KEY_TORRENT_AVAILABILITY, torrent.distributedCopies()},
-        {KEY_TORRENT_REANNOUNCE, torrent.nextAnnounce()},
-        {KEY_TORRENT_COMMENT, torrent.comment()}
-    };
+        if (!fields.test(i))
+            continue;
+
+        const auto field = static_cast<TorrentField>(i);
+        result.insert(torrentFieldKey(field), serializeTorrentField(torrent, field));
+    }
+
+    return result;
 }
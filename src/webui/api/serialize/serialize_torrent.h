@@ -28,13 +28,20 @@
 
 #pragma once
 
-#include <QVariant>
+#include <bitset>
+#include <optional>
+
+#include <QJsonObject>
+#include <QJsonValue>
 
 #include "base/global.h"
 
 namespace BitTorrent
 {
     class Torrent;
+    struct TorrentSnapshot;
+
+    enum class TorrentState;
 }
 
 // Torrent keys
@@ -106,4 +113,94 @@ inline const QString KEY_TORRENT_PIECES_HAVE = u"pieces_have"_s;
 inline const QString KEY_TORRENT_CREATED_BY = u"created_by"_s;
 inline const QString KEY_TORRENT_CREATION_DATE = u"creation_date"_s;
 
-QVariantMap serialize(const BitTorrent::Torrent &torrent);
+enum class TorrentField
+{
+    ID,
+    InfoHashV1,
+    InfoHashV2,
+    Name,
+
+    HasMetadata,
+    CreatedBy,
+    CreationDate,
+    Private,
+    TotalSize,
+    PiecesNum,
+    PieceSize,
+
+    MagnetURI,
+    Size,
+    Progress,
+    TotalWasted,
+    PiecesHave,
+    DLSpeed,
+    UPSpeed,
+    QueuePosition,
+    Seeds,
+    NumComplete,
+    Leechs,
+    NumIncomplete,
+
+    State,
+    ETA,
+    SequentialDownload,
+    FirstLastPiecePrio,
+
+    Category,
+    Tags,
+    SuperSeeding,
+    ForceStart,
+    SavePath,
+    DownloadPath,
+    ContentPath,
+    RootPath,
+    AddedOn,
+    CompletionOn,
+    Tracker,
+    TrackersCount,
+    DLLimit,
+    UPLimit,
+    AmountDownloaded,
+    AmountUploaded,
+    AmountDownloadedSession,
+    AmountUploadedSession,
+    AmountLeft,
+    AmountCompleted,
+    ConnectionsCount,
+    ConnectionsLimit,
+    MaxRatio,
+    MaxSeedingTime,
+    MaxInactiveSeedingTime,
+    Ratio,
+    RatioLimit,
+    Popularity,
+    SeedingTimeLimit,
+    InactiveSeedingTimeLimit,
+    ShareLimitAction,
+    LastSeenCompleteTime,
+    AutoTorrentManagement,
+    TimeActive,
+    SeedingTime,
+    LastActivityTime,
+    Availability,
+    Reannounce,
+    Comment,
+
+    _Count
+};
+
+inline constexpr int TORRENT_FIELDS_COUNT = static_cast<int>(TorrentField::_Count);
+using TorrentFieldSet = std::bitset<TORRENT_FIELDS_COUNT>;
+
+const QString &torrentFieldKey(TorrentField field);
+std::optional<TorrentField> torrentFieldFromKey(const QString &key);
+QString serializeTorrentState(BitTorrent::TorrentState state);
+QJsonValue serializeTorrentField(const BitTorrent::Torrent &torrent, TorrentField field);
+// Returns undefined value for the fields that aren't saved in the snapshot
+QJsonValue serializeTorrentSnapshotField(const BitTorrent::TorrentSnapshot &snapshot, TorrentField field);
+
+// Compares the serialized values of the same field (e.g. for sorting torrents by it)
+bool torrentFieldLessThan(const QJsonValue &left, const QJsonValue &right);
+
+// Only the given fields are computed
+QJsonObject serialize(const BitTorrent::Torrent &torrent, const TorrentFieldSet &fields = TorrentFieldSet().set());
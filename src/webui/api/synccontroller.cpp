@@ -28,36 +28,39 @@
 
 #include "synccontroller.h"
 
+#include <algorithm>
+#include <iterator>
+
+#include <QBitArray>
 #include <QFuture>
 #include <QJsonArray>
+#include <QJsonDocument>
 #include <QJsonObject>
 #include <QMetaObject>
 
-#include "base/algorithm.h"
-#include "base/bittorrent/cachestatus.h"
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
 #include "base/bittorrent/session.h"
-#include "base/bittorrent/sessionstatus.h"
 #include "base/bittorrent/torrent.h"
 #include "base/bittorrent/torrentinfo.h"
-#include "base/bittorrent/trackerentrystatus.h"
+#include "base/bittorrent/torrentstatustable.h"
 #include "base/global.h"
+#include "base/http/eventstream.h"
 #include "base/net/geoipmanager.h"
 #include "base/preferences.h"
+#include "base/torrentfilter.h"
+#include "base/torrentfilterindex.h"
+#include "base/tracer.h"
+#include "base/utils/jsonwriter.h"
+#include "base/utils/memory.h"
 #include "base/utils/string.h"
 #include "apierror.h"
+#include "maindatasynclog.h"
 #include "serialize/serialize_torrent.h"
 
 namespace
 {
-    // Sync main data keys
-    const QString KEY_SYNC_MAINDATA_QUEUEING = u"queueing"_s;
-    const QString KEY_SYNC_MAINDATA_REFRESH_INTERVAL = u"refresh_interval"_s;
-    const QString KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS = u"use_alt_speed_limits"_s;
-    const QString KEY_SYNC_MAINDATA_USE_SUBCATEGORIES = u"use_subcategories"_s;
-
     // Sync torrent peers keys
     const QString KEY_SYNC_TORRENT_PEERS_SHOW_FLAGS = u"show_flags"_s;
 
@@ -80,120 +83,23 @@ namespace
     const QString KEY_PEER_TOT_UP = u"uploaded"_s;
     const QString KEY_PEER_UP_SPEED = u"up_speed"_s;
 
-    // TransferInfo keys
-    const QString KEY_TRANSFER_CONNECTION_STATUS = u"connection_status"_s;
-    const QString KEY_TRANSFER_DHT_NODES = u"dht_nodes"_s;
-    const QString KEY_TRANSFER_DLDATA = u"dl_info_data"_s;
-    const QString KEY_TRANSFER_DLRATELIMIT = u"dl_rate_limit"_s;
-    const QString KEY_TRANSFER_DLSPEED = u"dl_info_speed"_s;
-    const QString KEY_TRANSFER_FREESPACEONDISK = u"free_space_on_disk"_s;
-    const QString KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V4 = u"last_external_address_v4"_s;
-    const QString KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V6 = u"last_external_address_v6"_s;
-    const QString KEY_TRANSFER_UPDATA = u"up_info_data"_s;
-    const QString KEY_TRANSFER_UPRATELIMIT = u"up_rate_limit"_s;
-    const QString KEY_TRANSFER_UPSPEED = u"up_info_speed"_s;
-
-    // Statistics keys
-    const QString KEY_TRANSFER_ALLTIME_DL = u"alltime_dl"_s;
-    const QString KEY_TRANSFER_ALLTIME_UL = u"alltime_ul"_s;
-    const QString KEY_TRANSFER_AVERAGE_TIME_QUEUE = u"average_time_queue"_s;
-    const QString KEY_TRANSFER_GLOBAL_RATIO = u"global_ratio"_s;
-    const QString KEY_TRANSFER_QUEUED_IO_JOBS = u"queued_io_jobs"_s;
-    const QString KEY_TRANSFER_READ_CACHE_HITS = u"read_cache_hits"_s;
-    const QString KEY_TRANSFER_READ_CACHE_OVERLOAD = u"read_cache_overload"_s;
-    const QString KEY_TRANSFER_TOTAL_BUFFERS_SIZE = u"total_buffers_size"_s;
-    const QString KEY_TRANSFER_TOTAL_PEER_CONNECTIONS = u"total_peer_connections"_s;
-    const QString KEY_TRANSFER_TOTAL_QUEUED_SIZE = u"total_queued_size"_s;
-    const QString KEY_TRANSFER_TOTAL_WASTE_SESSION = u"total_wasted_session"_s;
-    const QString KEY_TRANSFER_WRITE_CACHE_OVERLOAD = u"write_cache_overload"_s;
-
-    const QString KEY_SUFFIX_REMOVED = u"_removed"_s;
-
-    const QString KEY_CATEGORIES = u"categories"_s;
-    const QString KEY_CATEGORIES_REMOVED = KEY_CATEGORIES + KEY_SUFFIX_REMOVED;
-    const QString KEY_TAGS = u"tags"_s;
-    const QString KEY_TAGS_REMOVED = KEY_TAGS + KEY_SUFFIX_REMOVED;
-    const QString KEY_TORRENTS = u"torrents"_s;
-    const QString KEY_TORRENTS_REMOVED = KEY_TORRENTS + KEY_SUFFIX_REMOVED;
-    const QString KEY_TRACKERS = u"trackers"_s;
-    const QString KEY_TRACKERS_REMOVED = KEY_TRACKERS + KEY_SUFFIX_REMOVED;
-    const QString KEY_SERVER_STATE = u"server_state"_s;
     const QString KEY_FULL_UPDATE = u"full_update"_s;
     const QString KEY_RESPONSE_ID = u"rid"_s;
+    const QString KEY_TORRENTS = u"torrents"_s;
+    const QString KEY_TORRENTS_REMOVED = u"torrents_removed"_s;
 
-    const QString KEY_TORRENT_HAS_TRACKER_WARNING = u"has_tracker_warning"_s;
-    const QString KEY_TORRENT_HAS_TRACKER_ERROR = u"has_tracker_error"_s;
-    const QString KEY_TORRENT_HAS_OTHER_ANNOUNCE_ERROR = u"has_other_announce_error"_s;
-
-    QStringList asStrings(const QSet<BitTorrent::TorrentID> &torrentIDs)
-    {
-        QStringList result;
-        result.reserve(torrentIDs.size());
-        for (const BitTorrent::TorrentID &torrentID : torrentIDs)
-            result.emplaceBack(torrentID.toString());
+    // Sync maindata view keys
+    const QString KEY_VIEW = u"view"_s;
+    const QString KEY_VIEW_TORRENTS = u"torrents"_s;
+    const QString KEY_VIEW_TOTAL = u"total"_s;
 
-        return result;
-    }
-
-    bool hasWarningMessage(const BitTorrent::TrackerEntryStatus &status)
-    {
-        return std::ranges::any_of(status.endpoints, [](const BitTorrent::TrackerEndpointStatus &endpointEntry)
-        {
-            return (endpointEntry.state == BitTorrent::TrackerEndpointState::Working) && !endpointEntry.message.isEmpty();
-        });
-    }
+    const QStringList MAINDATA_VIEW_PARAMS {u"filter"_s, u"category"_s, u"tag"_s, u"tracker"_s, u"search"_s
+            , u"sort"_s, u"reverse"_s, u"limit"_s, u"offset"_s};
 
     QVariantMap processMap(const QVariantMap &prevData, const QVariantMap &data);
     std::pair<QVariantMap, QVariantList> processHash(QVariantHash prevData, const QVariantHash &data);
     std::pair<QVariantList, QVariantList> processList(QVariantList prevData, const QVariantList &data);
-    QJsonObject generateSyncData(int acceptedResponseId, const QVariantMap &data, QVariantMap &lastAcceptedData, QVariantMap &lastData);
-
-    QVariantMap getTransferInfo()
-    {
-        QVariantMap map;
-        const auto *session = BitTorrent::Session::instance();
-
-        const BitTorrent::SessionStatus &sessionStatus = session->status();
-        const BitTorrent::CacheStatus &cacheStatus = session->cacheStatus();
-        map[KEY_TRANSFER_DLSPEED] = sessionStatus.payloadDownloadRate;
-        map[KEY_TRANSFER_DLDATA] = sessionStatus.totalPayloadDownload;
-        map[KEY_TRANSFER_UPSPEED] = sessionStatus.payloadUploadRate;
-        map[KEY_TRANSFER_UPDATA] = sessionStatus.totalPayloadUpload;
-        map[KEY_TRANSFER_DLRATELIMIT] = session->downloadSpeedLimit();
-        map[KEY_TRANSFER_UPRATELIMIT] = session->uploadSpeedLimit();
-
-        const qint64 atd = sessionStatus.allTimeDownload;
-        const qint64 atu = sessionStatus.allTimeUpload;
-        map[KEY_TRANSFER_ALLTIME_DL] = atd;
-        map[KEY_TRANSFER_ALLTIME_UL] = atu;
-        map[KEY_TRANSFER_TOTAL_WASTE_SESSION] = sessionStatus.totalWasted;
-        map[KEY_TRANSFER_GLOBAL_RATIO] = ((atd > 0) && (atu > 0)) ? Utils::String::fromDouble(static_cast<qreal>(atu) / atd, 2) : u"-"_s;
-        map[KEY_TRANSFER_TOTAL_PEER_CONNECTIONS] = sessionStatus.peersCount;
-
-        const qreal readRatio = cacheStatus.readRatio;  // TODO: remove when LIBTORRENT_VERSION_NUM >= 20000
-        map[KEY_TRANSFER_READ_CACHE_HITS] = (readRatio > 0) ? Utils::String::fromDouble(100 * readRatio, 2) : u"0"_s;
-        map[KEY_TRANSFER_TOTAL_BUFFERS_SIZE] = cacheStatus.totalUsedBuffers * 16 * 1024;
-
-        map[KEY_TRANSFER_WRITE_CACHE_OVERLOAD] = ((sessionStatus.diskWriteQueue > 0) && (sessionStatus.peersCount > 0))
-            ? Utils::String::fromDouble((100. * sessionStatus.diskWriteQueue / sessionStatus.peersCount), 2)
-            : u"0"_s;
-        map[KEY_TRANSFER_READ_CACHE_OVERLOAD] = ((sessionStatus.diskReadQueue > 0) && (sessionStatus.peersCount > 0))
-            ? Utils::String::fromDouble((100. * sessionStatus.diskReadQueue / sessionStatus.peersCount), 2)
-            : u"0"_s;
-
-        map[KEY_TRANSFER_QUEUED_IO_JOBS] = cacheStatus.jobQueueLength;
-        map[KEY_TRANSFER_AVERAGE_TIME_QUEUE] = cacheStatus.averageJobTime;
-        map[KEY_TRANSFER_TOTAL_QUEUED_SIZE] = cacheStatus.queuedBytes;
-
-        map[KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V4] = session->lastExternalIPv4Address();
-        map[KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V6] = session->lastExternalIPv6Address();
-        map[KEY_TRANSFER_DHT_NODES] = sessionStatus.dhtNodes;
-        map[KEY_TRANSFER_CONNECTION_STATUS] = session->isListening()
-            ? (sessionStatus.hasIncomingConnections ? u"connected"_s : u"firewalled"_s)
-            : u"disconnected"_s;
-
-        return map;
-    }
+    QByteArray generateSyncData(int acceptedResponseId, const QVariantMap &data, QVariantMap &lastAcceptedData, QVariantMap &lastData);
 
     // Compare two structures (prevData, data) and calculate difference (syncData).
     // Structures encoded as map.
@@ -372,7 +278,7 @@ namespace
         return result;
     }
 
-    QJsonObject generateSyncData(int acceptedResponseId, const QVariantMap &data, QVariantMap &lastAcceptedData, QVariantMap &lastData)
+    QByteArray generateSyncData(int acceptedResponseId, const QVariantMap &data, QVariantMap &lastAcceptedData, QVariantMap &lastData)
     {
         QVariantMap syncData;
         bool fullUpdate = true;
@@ -405,51 +311,49 @@ namespace
         lastData[KEY_RESPONSE_ID] = responseId;
         syncData[KEY_RESPONSE_ID] = responseId;
 
-        return QJsonObject::fromVariantMap(syncData);
+        // serialize the map directly instead of converting it to QJsonObject first
+        Utils::JsonWriter writer;
+        writer.value(QVariant(syncData));
+        return writer.takeData();
     }
+}
 
-    void addAnnounceStats(QVariantMap &serializedTorrent, const BitTorrent::Torrent *torrent)
-    {
-        bool hasTrackerWarning = false;
-        bool hasTrackerError = false;
-        bool hasOtherAnnounceError = false;
-        for (const BitTorrent::TrackerEntryStatus &status : asConst(torrent->trackers()))
-        {
-            switch (status.state)
-            {
-            case BitTorrent::TrackerEndpointState::Working:
-                if (!hasTrackerWarning && hasWarningMessage(status))
-                    hasTrackerWarning = true;
-                break;
-            case BitTorrent::TrackerEndpointState::TrackerError:
-                hasTrackerError = true;
-                break;
-            case BitTorrent::TrackerEndpointState::NotWorking:
-            case BitTorrent::TrackerEndpointState::Unreachable:
-                hasOtherAnnounceError = true;
-                break;
-            default:
-                break;
-            }
-
-            if (hasTrackerWarning && hasTrackerError && hasOtherAnnounceError)
-                break;
-        }
+SyncController::SyncController(MaindataSyncLog *maindataSyncLog, IApplication *app, QObject *parent)
+    : APIController(app, parent)
+    , m_maindataSyncLog {maindataSyncLog}
+{
+    Q_ASSERT(m_maindataSyncLog);
+}
 
-        serializedTorrent[KEY_TORRENT_HAS_TRACKER_WARNING] = hasTrackerWarning;
-        serializedTorrent[KEY_TORRENT_HAS_TRACKER_ERROR] = hasTrackerError;
-        serializedTorrent[KEY_TORRENT_HAS_OTHER_ANNOUNCE_ERROR] = hasOtherAnnounceError;
+SyncController::~SyncController()
+{
+    for (const MaindataStream &stream : asConst(m_maindataStreams))
+    {
+        if (stream.eventStream)
+            stream.eventStream->close();
     }
 }
 
-SyncController::SyncController(IApplication *app, QObject *parent)
-    : APIController(app, parent)
+qint64 SyncController::estimatedMemoryUsage() const
 {
+    qint64 viewSize = 0;
+    if (m_maindataView)
+    {
+        // each torrent of the view is stored in both the list and the set
+        const qint64 entryOverhead = 16;
+        viewSize = (m_maindataView->key.size() * static_cast<qint64>(sizeof(QChar)))
+            + (m_maindataView->torrentIDs.size() * static_cast<qint64>((2 * sizeof(BitTorrent::TorrentID)) + entryOverhead));
+    }
+
+    return Utils::Memory::estimateHeapSize(m_lastPeersResponse) + Utils::Memory::estimateHeapSize(m_lastAcceptedPeersResponse)
+        + (m_maindataStreams.size() * static_cast<qint64>(sizeof(MaindataStream))) + viewSize;
 }
 
-void SyncController::updateFreeDiskSpace(const qint64 freeDiskSpace)
+void SyncController::releaseIdleData()
 {
-    m_freeDiskSpace = freeDiskSpace;
+    m_lastPeersResponse.clear();
+    m_lastAcceptedPeersResponse.clear();
+    m_maindataView.reset();
 }
 
 // The function returns the changed data from the server to synchronize with the web client.
@@ -465,6 +369,13 @@ void SyncController::updateFreeDiskSpace(const qint64 freeDiskSpace)
 //  - "trackers": dictionary contains information about trackers
 //  - "trackers_removed": a list of removed trackers
 //  - "server_state": map contains information about the state of the server
+//  - "filter_counts": numbers of torrents by "status", "category", "tag" and "tracker" (host),
+//    uncategorized, untagged and trackerless torrents are counted under empty name
+//  - "view": the torrents of the requested view, it is sent with full update and when the view is changed:
+//    - "torrents": ordered list of hashes of the torrents in the view
+//    - "total": number of the matching torrents before "limit" and "offset" are applied
+// If the view is requested the torrents data is limited to its torrents. The torrents that enter the view
+// are sent with all the requested fields and those that leave it are listed in "torrents_removed".
 // The keys of the 'torrents' dictionary are hashes of torrents.
 // Each value of the 'torrents' dictionary contains map. The map can contain following keys:
 //  - "name": Torrent name
@@ -506,6 +417,10 @@ void SyncController::updateFreeDiskSpace(const qint64 freeDiskSpace)
 //  - "has_tracker_error": the torrent has a tracker error
 //  - "has_other_announce_error": the torrent has other problems announcing to a tracker
 // Server state map may contain the following keys:
+//  - "checking_eta": estimated time until all the torrents are checked
+//  - "checking_remaining": amount of data left to check
+//  - "checking_speed": aggregate checking rate
+//  - "checking_torrents": number of torrents being checked
 //  - "connection_status": connection status
 //  - "dht_nodes": DHT nodes count
 //  - "dl_info_data": bytes downloaded
@@ -521,578 +436,408 @@ void SyncController::updateFreeDiskSpace(const qint64 freeDiskSpace)
 //  - "free_space_on_disk": Free space on the default save path
 // GET param:
 //   - rid (int): last response id
+//   - fields (string): torrent fields to include, separated by |. Empty means all fields
+//   - filter (string): view torrents with the given status (the same as for "torrents/info")
+//   - category (string): view torrents with the given category (empty string means "without category")
+//   - tag (string): view torrents with the given tag (empty string means "without tag")
+//   - tracker (string): view torrents with a tracker of the given host (empty string means "without tracker")
+//   - search (string): view torrents whose name contains the given text (case insensitive)
+//   - sort (string): name of the field to sort the view by
+//   - reverse (bool): enable reverse sorting
+//   - limit (int): limit the number of the torrents in the view
+//   - offset (int): set offset of the view (if less than 0 - offset from end)
 void SyncController::maindataAction()
 {
-    if (m_maindataAcceptedID < 0)
-    {
-        makeMaindataSnapshot();
-
-        const auto *btSession = BitTorrent::Session::instance();
-        connect(btSession, &BitTorrent::Session::categoryAdded, this, &SyncController::onCategoryAdded);
-        connect(btSession, &BitTorrent::Session::categoryRemoved, this, &SyncController::onCategoryRemoved);
-        connect(btSession, &BitTorrent::Session::categoryOptionsChanged, this, &SyncController::onCategoryOptionsChanged);
-        connect(btSession, &BitTorrent::Session::subcategoriesSupportChanged, this, &SyncController::onSubcategoriesSupportChanged);
-        connect(btSession, &BitTorrent::Session::tagAdded, this, &SyncController::onTagAdded);
-        connect(btSession, &BitTorrent::Session::tagRemoved, this, &SyncController::onTagRemoved);
-        connect(btSession, &BitTorrent::Session::torrentAdded, this, &SyncController::onTorrentAdded);
-        connect(btSession, &BitTorrent::Session::torrentAboutToBeRemoved, this, &SyncController::onTorrentAboutToBeRemoved);
-        connect(btSession, &BitTorrent::Session::torrentCategoryChanged, this, &SyncController::onTorrentCategoryChanged);
-        connect(btSession, &BitTorrent::Session::torrentMetadataReceived, this, &SyncController::onTorrentMetadataReceived);
-        connect(btSession, &BitTorrent::Session::torrentStopped, this, &SyncController::onTorrentStopped);
-        connect(btSession, &BitTorrent::Session::torrentStarted, this, &SyncController::onTorrentStarted);
-        connect(btSession, &BitTorrent::Session::torrentSavePathChanged, this, &SyncController::onTorrentSavePathChanged);
-        connect(btSession, &BitTorrent::Session::torrentSavingModeChanged, this, &SyncController::onTorrentSavingModeChanged);
-        connect(btSession, &BitTorrent::Session::torrentTagAdded, this, &SyncController::onTorrentTagAdded);
-        connect(btSession, &BitTorrent::Session::torrentTagRemoved, this, &SyncController::onTorrentTagRemoved);
-        connect(btSession, &BitTorrent::Session::torrentsUpdated, this, &SyncController::onTorrentsUpdated);
-        connect(btSession, &BitTorrent::Session::trackersAdded, this, &SyncController::onTorrentTrackersChanged);
-        connect(btSession, &BitTorrent::Session::trackersRemoved, this, &SyncController::onTorrentTrackersChanged);
-        connect(btSession, &BitTorrent::Session::trackersChanged, this, &SyncController::onTorrentTrackersChanged);
-        connect(btSession, &BitTorrent::Session::trackerEntryStatusesUpdated, this, &SyncController::onTorrentTrackerEntryStatusesUpdated);
-    }
-
+    const TorrentSyncFieldSet torrentFields = parseTorrentFieldsParam();
+    const int version = m_maindataSyncLog->update();
+    std::optional<MaindataView> view = makeMaindataView();
+
+    // Response ID is the version of the shared maindata log. Only the versions sent to this session
+    // are accepted so the client cannot get partial data using the ID it received from another server instance.
+    // The client doesn't have the values of the fields it hasn't requested before so it receives full update
+    // if the requested fields are changed. The same is for the view, moreover only the view of the last
+    // response is kept so the changes can be computed only since it.
     const int acceptedID = params()[u"rid"_s].toInt();
-    bool fullUpdate = true;
-    if ((acceptedID > 0) && (m_maindataLastSentID > 0))
-    {
-        if (m_maindataLastSentID == acceptedID)
+    const QString viewKey = view ? view->key : QString();
+    const QString sentViewKey = m_maindataView ? m_maindataView->key : QString();
+    const bool fullUpdate = !isMaindataSentByThis(acceptedID) || (torrentFields != m_maindataTorrentFields)
+        || (viewKey != sentViewKey) || (view && (acceptedID != m_maindataLastSentID));
+    QJsonObject syncData = generateMaindataSyncData(version, (fullUpdate ? 0 : acceptedID), torrentFields
+            , (view ? &view->torrentIDSet : nullptr));
+    const bool isFullUpdate = syncData.contains(KEY_FULL_UPDATE);
+    if (view)
+    {
+        if (!isFullUpdate)
         {
-            m_maindataAcceptedID = acceptedID;
-            m_maindataSyncBuf = {};
+            // the torrents that have entered the view are sent completely,
+            // the changes of those that have left it are filtered out by the new view already
+            const QSet<BitTorrent::TorrentID> &sentTorrentIDs = m_maindataView->torrentIDSet;
+            const QSet<BitTorrent::TorrentID> enteredTorrentIDs = view->torrentIDSet - sentTorrentIDs;
+            if (!enteredTorrentIDs.isEmpty())
+            {
+                QJsonObject torrents = syncData.value(KEY_TORRENTS).toObject();
+                const QJsonObject enteredTorrents = m_maindataSyncLog->generateTorrentsData(enteredTorrentIDs, torrentFields);
+                for (auto it = enteredTorrents.constBegin(); it != enteredTorrents.constEnd(); ++it)
+                    torrents[it.key()] = it.value();
+                syncData[KEY_TORRENTS] = torrents;
+            }
+
+            QJsonArray removedTorrents = syncData.value(KEY_TORRENTS_REMOVED).toArray();
+            for (const BitTorrent::TorrentID &torrentID : sentTorrentIDs)
+            {
+                if (!view->torrentIDSet.contains(torrentID))
+                    removedTorrents.append(torrentID.toString());
+            }
+            if (!removedTorrents.isEmpty())
+                syncData[KEY_TORRENTS_REMOVED] = removedTorrents;
         }
 
-        if (m_maindataAcceptedID == acceptedID)
+        if (isFullUpdate || (view->torrentIDs != m_maindataView->torrentIDs) || (view->total != m_maindataView->total))
         {
-            // We are still able to send changes for the current state of the data having by client.
-            fullUpdate = false;
+            QJsonArray viewTorrents;
+            for (const BitTorrent::TorrentID &torrentID : asConst(view->torrentIDs))
+                viewTorrents.append(torrentID.toString());
+            syncData[KEY_VIEW] = QJsonObject {{KEY_VIEW_TORRENTS, viewTorrents}, {KEY_VIEW_TOTAL, static_cast<qint64>(view->total)}};
         }
     }
 
-    const int id = (m_maindataLastSentID % 1000000) + 1;  // cycle between 1 and 1000000
-    setResult(generateMaindataSyncData(id, fullUpdate));
-    m_maindataLastSentID = id;
-}
-
-void SyncController::makeMaindataSnapshot()
-{
-    m_knownTrackers.clear();
-    m_maindataAcceptedID = 0;
-    m_maindataSnapshot = {};
-
-    const auto *session = BitTorrent::Session::instance();
-
-    for (const BitTorrent::Torrent *torrent : asConst(session->torrents()))
+    if (isFullUpdate)
     {
-        const BitTorrent::TorrentID torrentID = torrent->id();
-
-        QVariantMap serializedTorrent = serialize(*torrent);
-        serializedTorrent.remove(KEY_TORRENT_ID);
-        addAnnounceStats(serializedTorrent, torrent);
-
-        for (const BitTorrent::TrackerEntryStatus &status : asConst(torrent->trackers()))
-            m_knownTrackers[status.url].insert(torrentID);
-
-        m_maindataSnapshot.torrents[torrentID.toString()] = serializedTorrent;
+        m_maindataFirstSentID = version;
+        m_maindataTorrentFields = torrentFields;
     }
+    m_maindataLastSentID = version;
+    m_maindataView = std::move(view);
 
-    const QStringList categoriesList = session->categories();
-    for (const auto &categoryName : categoriesList)
-    {
-        const BitTorrent::CategoryOptions categoryOptions = session->categoryOptions(categoryName);
-        QJsonObject category = categoryOptions.toJSON();
-        // adjust it to be compatible with existing WebAPI
-        category[u"savePath"_s] = category.take(u"save_path"_s);
-        category.insert(u"name"_s, categoryName);
-        m_maindataSnapshot.categories[categoryName] = category.toVariantMap();
-    }
-
-    for (const Tag &tag : asConst(session->tags()))
-        m_maindataSnapshot.tags.append(tag.toString());
-
-    for (const auto &[tracker, torrentIDs] : asConst(m_knownTrackers).asKeyValueRange())
-        m_maindataSnapshot.trackers[tracker] = asStrings(torrentIDs);
-
-    m_maindataSnapshot.serverState = getTransferInfo();
-    m_maindataSnapshot.serverState[KEY_TRANSFER_FREESPACEONDISK] = m_freeDiskSpace;
-    m_maindataSnapshot.serverState[KEY_SYNC_MAINDATA_QUEUEING] = session->isQueueingSystemEnabled();
-    m_maindataSnapshot.serverState[KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS] = session->isAltGlobalSpeedLimitEnabled();
-    m_maindataSnapshot.serverState[KEY_SYNC_MAINDATA_REFRESH_INTERVAL] = session->refreshInterval();
-    m_maindataSnapshot.serverState[KEY_SYNC_MAINDATA_USE_SUBCATEGORIES] = session->isSubcategoriesEnabled();
+    setResult(syncData);
 }
 
-QJsonObject SyncController::generateMaindataSyncData(const int id, const bool fullUpdate)
+// The function opens the stream of "sync/maindata" responses (i.e. "text/event-stream").
+// The first event contains the changes since the given response ID (or full data), subsequent events
+// are sent when the data is changed and contain the changes since the previous event.
+// ID of each event is the response ID of its data.
+// GET param:
+//   - rid (int): last response id
+//   - fields (string): torrent fields to include, separated by |. Empty means all fields
+void SyncController::maindataStreamAction()
 {
-    // if need to update existing sync data
-    for (const QString &category : asConst(m_updatedCategories))
-        m_maindataSyncBuf.removedCategories.removeOne(category);
-    for (const QString &category : asConst(m_removedCategories))
-        m_maindataSyncBuf.categories.remove(category);
-
-    for (const QString &tag : asConst(m_addedTags))
-        m_maindataSyncBuf.removedTags.removeOne(tag);
-    for (const QString &tag : asConst(m_removedTags))
-        m_maindataSyncBuf.tags.removeOne(tag);
-
-    for (const BitTorrent::TorrentID &torrentID : asConst(m_updatedTorrents))
-        m_maindataSyncBuf.removedTorrents.removeOne(torrentID.toString());
+    const TorrentSyncFieldSet torrentFields = parseTorrentFieldsParam();
+    const int version = m_maindataSyncLog->update();
 
-    for (const BitTorrent::TorrentID &torrentID : asConst(m_removedTorrents))
-    {
-        const QString torrentIDStr = torrentID.toString();
-        m_maindataSyncBuf.torrents.remove(torrentIDStr);
-    }
-
-    for (const QString &tracker : asConst(m_updatedTrackers))
-        m_maindataSyncBuf.removedTrackers.removeOne(tracker);
-    for (const QString &tracker : asConst(m_removedTrackers))
-        m_maindataSyncBuf.trackers.remove(tracker);
-
-    const auto *session = BitTorrent::Session::instance();
-
-    for (const QString &categoryName : asConst(m_updatedCategories))
-    {
-        const BitTorrent::CategoryOptions categoryOptions = session->categoryOptions(categoryName);
-        auto category = categoryOptions.toJSON().toVariantMap();
-        // adjust it to be compatible with existing WebAPI
-        category[u"savePath"_s] = category.take(u"save_path"_s);
-        category.insert(u"name"_s, categoryName);
-
-        auto &categorySnapshot = m_maindataSnapshot.categories[categoryName];
-        if (const QVariantMap syncData = processMap(categorySnapshot, category); !syncData.isEmpty())
-        {
-            m_maindataSyncBuf.categories[categoryName] = syncData;
-            categorySnapshot = category;
-        }
-    }
-    m_updatedCategories.clear();
+    // the streams don't support views so the data sent for a view can't be continued
+    const int acceptedID = params()[u"rid"_s].toInt();
+    const bool fullUpdate = !isMaindataSentByThis(acceptedID) || (torrentFields != m_maindataTorrentFields)
+        || m_maindataView.has_value();
+    const QJsonObject syncData = generateMaindataSyncData(version, (fullUpdate ? 0 : acceptedID), torrentFields);
 
-    for (const QString &category : asConst(m_removedCategories))
-    {
-        m_maindataSyncBuf.removedCategories.append(category);
-        m_maindataSnapshot.categories.remove(category);
-    }
-    m_removedCategories.clear();
+    // the stream is owned by HTTP connection
+    auto *eventStream = new Http::EventStream;
+    eventStream->sendEvent(QJsonDocument(syncData).toJson(QJsonDocument::Compact), {}, QString::number(version));
 
-    for (const QString &tag : asConst(m_addedTags))
+    // The client may continue with the ID of the last event using "sync/maindata",
+    // or reopen the stream with it, so the data is accounted as sent by this session
+    if (fullUpdate)
     {
-        m_maindataSyncBuf.tags.append(tag);
-        m_maindataSnapshot.tags.append(tag);
+        m_maindataFirstSentID = version;
+        m_maindataTorrentFields = torrentFields;
     }
-    m_addedTags.clear();
+    m_maindataLastSentID = version;
+    m_maindataView.reset();
 
-    for (const QString &tag : asConst(m_removedTags))
+    if (m_maindataStreams.isEmpty())
     {
-        m_maindataSyncBuf.removedTags.append(tag);
-        m_maindataSnapshot.tags.removeOne(tag);
+        // Data is changed only on session refresh, or it is sent when the next refresh occurs
+        const auto *btSession = BitTorrent::Session::instance();
+        connect(btSession, &BitTorrent::Session::torrentsUpdated, this, &SyncController::scheduleMaindataPush);
+        connect(btSession, &BitTorrent::Session::statsUpdated, this, &SyncController::scheduleMaindataPush);
     }
-    m_removedTags.clear();
+    m_maindataStreams.append({.eventStream = eventStream, .torrentFields = torrentFields, .lastSentID = version});
 
-    for (const BitTorrent::TorrentID &torrentID : asConst(m_updatedTorrents))
-    {
-        const BitTorrent::Torrent *torrent = session->getTorrent(torrentID);
-        Q_ASSERT(torrent);
+    setResult(eventStream);
+}
 
-        QVariantMap serializedTorrent = serialize(*torrent);
-        serializedTorrent.remove(KEY_TORRENT_ID);
+TorrentSyncFieldSet SyncController::parseTorrentFieldsParam() const
+{
+    const QString fieldsStr = params()[u"fields"_s];
+    if (fieldsStr.isEmpty())
+        return TorrentSyncFieldSet().set();
 
-        const QString torrentIDStr = torrentID.toString();
-        auto &torrentSnapshot = m_maindataSnapshot.torrents[torrentIDStr];
+    const std::optional<TorrentSyncFieldSet> fields = torrentSyncFieldsFromKeys(fieldsStr.split(u'|', Qt::SkipEmptyParts));
+    if (!fields)
+        throw APIError(APIErrorType::BadParams, tr("'fields' parameter is invalid"));
 
-        if (m_announcedTorrents.contains(torrentID))
-        {
-            addAnnounceStats(serializedTorrent, torrent);
-        }
-        else
-        {
-            serializedTorrent[KEY_TORRENT_HAS_TRACKER_WARNING] = torrentSnapshot[KEY_TORRENT_HAS_TRACKER_WARNING];
-            serializedTorrent[KEY_TORRENT_HAS_TRACKER_ERROR] = torrentSnapshot[KEY_TORRENT_HAS_TRACKER_ERROR];
-            serializedTorrent[KEY_TORRENT_HAS_OTHER_ANNOUNCE_ERROR] = torrentSnapshot[KEY_TORRENT_HAS_OTHER_ANNOUNCE_ERROR];
-        }
-
-        if (const QVariantMap syncData = processMap(torrentSnapshot, serializedTorrent); !syncData.isEmpty())
-        {
-            m_maindataSyncBuf.torrents[torrentIDStr] = syncData;
-            torrentSnapshot = serializedTorrent;
-        }
-    }
+    return *fields;
+}
 
-    for (const BitTorrent::TorrentID &torrentID : asConst(m_announcedTorrents))
+std::optional<SyncController::MaindataView> SyncController::makeMaindataView() const
+{
+    const bool hasView = std::ranges::any_of(MAINDATA_VIEW_PARAMS, [this](const QString &name)
     {
-        if (m_updatedTorrents.contains(torrentID))
+        return params().contains(name);
+    });
+    if (!hasView)
+        return std::nullopt;
+
+    const auto getOptionalString = [this](const QString &name) -> std::optional<QString>
+    {
+        const auto it = params().constFind(name);
+        if (it == params().cend())
+            return std::nullopt;
+
+        return it.value();
+    };
+
+    const QString filter = params()[u"filter"_s];
+    const std::optional<QString> category = getOptionalString(u"category"_s);
+    const std::optional<QString> tagName = getOptionalString(u"tag"_s);
+    const std::optional<Tag> tag = tagName ? std::optional<Tag>(Tag(*tagName)) : std::nullopt;
+    const std::optional<QString> trackerHost = getOptionalString(u"tracker"_s);
+    const QString searchText = params()[u"search"_s];
+    const QString sortedColumn = params()[u"sort"_s];
+    const bool reverse = Utils::String::parseBool(params()[u"reverse"_s]).value_or(false);
+    int limit = params()[u"limit"_s].toInt();
+    int offset = params()[u"offset"_s].toInt();
+
+    std::optional<TorrentIDSet> idSet;
+    if (trackerHost)
+        idSet = m_maindataSyncLog->trackerHostTorrents(*trackerHost);
+
+    const TorrentFilter torrentFilter {filter, idSet, category, tag};
+    const auto *filterIndex = TorrentFilterIndex::instance();
+    const QBitArray nameMatches = !searchText.isEmpty() ? filterIndex->matchingNameTorrents(searchText) : QBitArray();
+    QList<const BitTorrent::Torrent *> torrents;
+    for (const BitTorrent::Torrent *torrent : BitTorrent::Session::instance()->torrentStatusTable().torrents())
+    {
+        if (!torrentFilter.match(torrent))
             continue;
 
-        const BitTorrent::Torrent *torrent = session->getTorrent(torrentID);
-        Q_ASSERT(torrent);
-
-        const QString torrentIDStr = torrentID.toString();
-        auto &torrentSnapshot = m_maindataSnapshot.torrents[torrentIDStr];
-
-        // Only announce stats are changed so don't need to serialize torrent again
-        QVariantMap serializedTorrent = torrentSnapshot;
-        addAnnounceStats(serializedTorrent, torrent);
-
-        if (const QVariantMap syncData = processMap(torrentSnapshot, serializedTorrent); !syncData.isEmpty())
+        if (!searchText.isEmpty())
         {
-            m_maindataSyncBuf.torrents[torrentIDStr] = syncData;
-            torrentSnapshot = serializedTorrent;
+            const int slot = filterIndex->torrentSlot(torrent);
+            if ((slot < 0) || (slot >= nameMatches.size()) || !nameMatches.testBit(slot))
+                continue;
         }
-    }
-
-    m_updatedTorrents.clear();
-    m_announcedTorrents.clear();
-
-    for (const BitTorrent::TorrentID &torrentID : asConst(m_removedTorrents))
-    {
-        const QString torrentIDStr = torrentID.toString();
 
-        m_maindataSyncBuf.removedTorrents.append(torrentIDStr);
-        m_maindataSnapshot.torrents.remove(torrentIDStr);
+        torrents.append(torrent);
     }
-    m_removedTorrents.clear();
-
-    for (const QString &tracker : asConst(m_updatedTrackers))
-    {
-        const QStringList serializedTorrentIDs = asStrings(m_knownTrackers[tracker]);
 
-        m_maindataSyncBuf.trackers[tracker] = serializedTorrentIDs;
-        m_maindataSnapshot.trackers[tracker] = serializedTorrentIDs;
-    }
-    m_updatedTrackers.clear();
-
-    for (const QString &tracker : asConst(m_removedTrackers))
-    {
-        m_maindataSyncBuf.removedTrackers.append(tracker);
-        m_maindataSnapshot.trackers.remove(tracker);
-    }
-    m_removedTrackers.clear();
-
-    QVariantMap serverState = getTransferInfo();
-    serverState[KEY_TRANSFER_FREESPACEONDISK] = m_freeDiskSpace;
-    serverState[KEY_SYNC_MAINDATA_QUEUEING] = session->isQueueingSystemEnabled();
-    serverState[KEY_SYNC_MAINDATA_USE_ALT_SPEED_LIMITS] = session->isAltGlobalSpeedLimitEnabled();
-    serverState[KEY_SYNC_MAINDATA_REFRESH_INTERVAL] = session->refreshInterval();
-    serverState[KEY_SYNC_MAINDATA_USE_SUBCATEGORIES] = session->isSubcategoriesEnabled();
-    if (const QVariantMap syncData = processMap(m_maindataSnapshot.serverState, serverState); !syncData.isEmpty())
-    {
-        m_maindataSyncBuf.serverState = syncData;
-        m_maindataSnapshot.serverState = serverState;
-    }
+    MaindataView view;
+    view.total = torrents.size();
 
-    QJsonObject syncData;
-    syncData[KEY_RESPONSE_ID] = id;
-    if (fullUpdate)
+    // moving the window (i.e. changing limit/offset) is sent as the torrents entering and leaving the view
+    // so a scrolling client doesn't receive full update
+    QStringList keyParts;
+    for (const QString &name : MAINDATA_VIEW_PARAMS)
     {
-        m_maindataSyncBuf = m_maindataSnapshot;
-        syncData[KEY_FULL_UPDATE] = true;
-    }
+        if ((name == u"limit") || (name == u"offset"))
+            continue;
 
-    if (!m_maindataSyncBuf.categories.isEmpty())
-    {
-        QJsonObject categories;
-        for (auto it = m_maindataSyncBuf.categories.cbegin(); it != m_maindataSyncBuf.categories.cend(); ++it)
-            categories[it.key()] = QJsonObject::fromVariantMap(it.value());
-        syncData[KEY_CATEGORIES] = categories;
+        if (const auto it = params().constFind(name); it != params().cend())
+            keyParts.append(name + u'=' + it.value());
     }
-    if (!m_maindataSyncBuf.removedCategories.isEmpty())
-        syncData[KEY_CATEGORIES_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedCategories);
+    view.key = keyParts.join(u'&');
 
-    if (!m_maindataSyncBuf.tags.isEmpty())
-        syncData[KEY_TAGS] = QJsonArray::fromVariantList(m_maindataSyncBuf.tags);
-    if (!m_maindataSyncBuf.removedTags.isEmpty())
-        syncData[KEY_TAGS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTags);
+    const qsizetype size = torrents.size();
+    // normalize offset
+    if (offset < 0)
+        offset = size + offset;
+    // normalize limit
+    if (limit <= 0)
+        limit = -1; // unlimited
 
-    if (!m_maindataSyncBuf.torrents.isEmpty())
+    if (!sortedColumn.isEmpty())
     {
-        QJsonObject torrents;
-        for (auto it = m_maindataSyncBuf.torrents.cbegin(); it != m_maindataSyncBuf.torrents.cend(); ++it)
-            torrents[it.key()] = QJsonObject::fromVariantMap(it.value());
-        syncData[KEY_TORRENTS] = torrents;
-    }
-    if (!m_maindataSyncBuf.removedTorrents.isEmpty())
-        syncData[KEY_TORRENTS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTorrents);
-
-    if (!m_maindataSyncBuf.trackers.isEmpty())
-    {
-        QJsonObject trackers;
-        for (auto it = m_maindataSyncBuf.trackers.cbegin(); it != m_maindataSyncBuf.trackers.cend(); ++it)
-            trackers[it.key()] = QJsonArray::fromStringList(it.value());
-        syncData[KEY_TRACKERS] = trackers;
-    }
-    if (!m_maindataSyncBuf.removedTrackers.isEmpty())
-        syncData[KEY_TRACKERS_REMOVED] = QJsonArray::fromStringList(m_maindataSyncBuf.removedTrackers);
+        const std::optional<TorrentField> sortedField = torrentFieldFromKey(sortedColumn);
+        if (!sortedField)
+            throw APIError(APIErrorType::BadParams, tr("'sort' parameter is invalid"));
 
-    if (!m_maindataSyncBuf.serverState.isEmpty())
-        syncData[KEY_SERVER_STATE] = QJsonObject::fromVariantMap(m_maindataSyncBuf.serverState);
+        QList<std::pair<QJsonValue, const BitTorrent::Torrent *>> sortItems;
+        sortItems.reserve(size);
+        for (const BitTorrent::Torrent *torrent : asConst(torrents))
+            sortItems.emplaceBack(serializeTorrentField(*torrent, *sortedField), torrent);
 
-    return syncData;
-}
-
-// GET param:
-//   - hash (string): torrent hash (ID)
-//   - rid (int): last response id
-void SyncController::torrentPeersAction()
-{
-    const auto id = BitTorrent::TorrentID::fromString(params()[u"hash"_s]);
-    const BitTorrent::Torrent *torrent = BitTorrent::Session::instance()->getTorrent(id);
-    if (!torrent)
-        throw APIError(APIErrorType::NotFound);
-
-    QVariantMap data;
-    QVariantHash peers;
-
-    const QList<BitTorrent::PeerInfo> peersList = torrent->fetchPeerInfo().takeResult();
+        const qsizetype sortedCount = (limit > 0) ? std::clamp<qsizetype>((offset + limit), 0, size) : size;
+        std::ranges::partial_sort(sortItems, (sortItems.begin() + sortedCount)
+            , [reverse](const auto &item1, const auto &item2)
+        {
+            return reverse ? torrentFieldLessThan(item2.first, item1.first) : torrentFieldLessThan(item1.first, item2.first);
+        });
 
-    bool resolvePeerCountries = Preferences::instance()->resolvePeerCountries();
+        for (qsizetype i = 0; i < sortedCount; ++i)
+            torrents[i] = sortItems[i].second;
+    }
 
-    data[KEY_SYNC_TORRENT_PEERS_SHOW_FLAGS] = resolvePeerCountries;
+    if ((limit > 0) || (offset > 0))
+        torrents = torrents.mid(offset, limit);
 
-    for (const BitTorrent::PeerInfo &pi : peersList)
+    view.torrentIDs.reserve(torrents.size());
+    view.torrentIDSet.reserve(torrents.size());
+    for (const BitTorrent::Torrent *torrent : asConst(torrents))
     {
-        const bool useI2PSocket = pi.useI2PSocket();
-        if (pi.address().ip.isNull() && !useI2PSocket) continue;
-
-        QVariantMap peer =
-        {
-            {KEY_PEER_CLIENT, pi.client()},
-            {KEY_PEER_ID_CLIENT, pi.peerIdClient()},
-            {KEY_PEER_PROGRESS, pi.progress()},
-            {KEY_PEER_DOWN_SPEED, pi.payloadDownSpeed()},
-            {KEY_PEER_UP_SPEED, pi.payloadUpSpeed()},
-            {KEY_PEER_TOT_DOWN, pi.totalDownload()},
-            {KEY_PEER_TOT_UP, pi.totalUpload()},
-            {KEY_PEER_CONNECTION_TYPE, pi.connectionType()},
-            {KEY_PEER_FLAGS, pi.flags()},
-            {KEY_PEER_FLAGS_DESCRIPTION, pi.flagsDescription()},
-            {KEY_PEER_RELEVANCE, pi.relevance()}
-        };
-
-        if (torrent->hasMetadata())
-        {
-            const PathList filePaths = torrent->info().filesForPiece(pi.downloadingPieceIndex());
-            QStringList filesForPiece;
-            filesForPiece.reserve(filePaths.size());
-            for (const Path &filePath : filePaths)
-                filesForPiece.append(filePath.toString());
-            peer.insert(KEY_PEER_FILES, filesForPiece.join(u'\n'));
-        }
-
-        if (resolvePeerCountries && !useI2PSocket)
-        {
-            peer[KEY_PEER_COUNTRY_CODE] = pi.country().toLower();
-            peer[KEY_PEER_COUNTRY] = Net::GeoIPManager::CountryName(pi.country());
-        }
-
-        if (useI2PSocket)
-        {
-            peer[KEY_PEER_I2P_DEST] = pi.I2PAddress();
-            peers[pi.I2PAddress()] = peer;
-        }
-        else
-        {
-            peer[KEY_PEER_IP] = pi.address().ip.toString();
-            peer[KEY_PEER_PORT] = pi.address().port;
-            peers[pi.address().toString()] = peer;
-        }
+        view.torrentIDs.append(torrent->id());
+        view.torrentIDSet.insert(torrent->id());
     }
-    data[u"peers"_s] = peers;
 
-    const int acceptedResponseId = params()[u"rid"_s].toInt();
-    setResult(generateSyncData(acceptedResponseId, data, m_lastAcceptedPeersResponse, m_lastPeersResponse));
+    return view;
 }
 
-void SyncController::onCategoryAdded(const QString &categoryName)
+QJsonObject SyncController::generateMaindataSyncData(const int version, const int sinceID, const TorrentSyncFieldSet &torrentFields
+        , const QSet<BitTorrent::TorrentID> *torrentIDs) const
 {
-    m_removedCategories.remove(categoryName);
-    m_updatedCategories.insert(categoryName);
-}
+    const TraceSpan traceSpan {"SyncController::generateMaindataSyncData"};
 
-void SyncController::onCategoryRemoved(const QString &categoryName)
-{
-    m_updatedCategories.remove(categoryName);
-    m_removedCategories.insert(categoryName);
-}
+    const bool fullUpdate = !m_maindataSyncLog->canSyncSince(sinceID);
 
-void SyncController::onCategoryOptionsChanged(const QString &categoryName)
-{
-    Q_ASSERT(!m_removedCategories.contains(categoryName));
+    QJsonObject syncData = m_maindataSyncLog->generateSyncData((fullUpdate ? 0 : sinceID), torrentFields, torrentIDs);
+    syncData[KEY_RESPONSE_ID] = version;
+    if (fullUpdate)
+        syncData[KEY_FULL_UPDATE] = true;
 
-    m_updatedCategories.insert(categoryName);
+    return syncData;
 }
 
-void SyncController::onSubcategoriesSupportChanged()
+bool SyncController::isMaindataSentByThis(const int id) const
 {
-    const QStringList categoriesList = BitTorrent::Session::instance()->categories();
-    for (const auto &categoryName : categoriesList)
-    {
-        if (!m_maindataSnapshot.categories.contains(categoryName))
-        {
-            m_removedCategories.remove(categoryName);
-            m_updatedCategories.insert(categoryName);
-        }
-    }
+    return (id > 0) && (id >= m_maindataFirstSentID) && (id <= m_maindataLastSentID);
 }
 
-void SyncController::onTagAdded(const Tag &tag)
+void SyncController::scheduleMaindataPush()
 {
-    m_removedTags.remove(tag.toString());
-    m_addedTags.insert(tag.toString());
-}
+    // "torrentsUpdated" and "statsUpdated" are emitted at the same refresh so they are handled at once
+    if (m_isMaindataPushScheduled)
+        return;
 
-void SyncController::onTagRemoved(const Tag &tag)
-{
-    m_addedTags.remove(tag.toString());
-    m_removedTags.insert(tag.toString());
+    m_isMaindataPushScheduled = true;
+    QMetaObject::invokeMethod(this, &SyncController::pushMaindata, Qt::QueuedConnection);
 }
 
-void SyncController::onTorrentAdded(BitTorrent::Torrent *torrent)
+void SyncController::pushMaindata()
 {
-    const BitTorrent::TorrentID torrentID = torrent->id();
+    m_isMaindataPushScheduled = false;
 
-    m_removedTorrents.remove(torrentID);
-    m_updatedTorrents.insert(torrentID);
-    m_announcedTorrents.insert(torrentID);
-
-    for (const BitTorrent::TrackerEntryStatus &status : asConst(torrent->trackers()))
+    m_maindataStreams.removeIf([](const MaindataStream &stream)
+    {
+        return !stream.eventStream || stream.eventStream->isClosed();
+    });
+    if (m_maindataStreams.isEmpty())
     {
-        m_knownTrackers[status.url].insert(torrentID);
-        m_updatedTrackers.insert(status.url);
-        m_removedTrackers.remove(status.url);
+        BitTorrent::Session::instance()->disconnect(this);
+        return;
     }
-}
 
-void SyncController::onTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent)
-{
-    const BitTorrent::TorrentID torrentID = torrent->id();
+    // The session is kept alive while it receives the stream, even if the data isn't changed
+    emit maindataStreamActive();
 
-    m_announcedTorrents.remove(torrentID);
-    m_updatedTorrents.remove(torrentID);
-    m_removedTorrents.insert(torrentID);
+    const int version = m_maindataSyncLog->update();
+
+    // streams usually have the same ID and fields so their data is generated once
+    struct Event
+    {
+        int sinceID = 0;
+        TorrentSyncFieldSet torrentFields;
+        QByteArray data;
+    };
+    QList<Event> events;
 
-    for (const BitTorrent::TrackerEntryStatus &status : asConst(torrent->trackers()))
+    for (MaindataStream &stream : m_maindataStreams)
     {
-        const auto iter = m_knownTrackers.find(status.url);
-        Q_ASSERT(iter != m_knownTrackers.end());
-        if (iter == m_knownTrackers.end()) [[unlikely]]
+        if (stream.lastSentID == version)
             continue;
 
-        QSet<BitTorrent::TorrentID> &torrentIDs = iter.value();
-        torrentIDs.remove(torrentID);
-        if (torrentIDs.isEmpty())
+        auto eventIter = std::ranges::find_if(events, [&stream](const Event &event)
         {
-            m_knownTrackers.erase(iter);
-            m_updatedTrackers.remove(status.url);
-            m_removedTrackers.insert(status.url);
-        }
-        else
+            return (event.sinceID == stream.lastSentID) && (event.torrentFields == stream.torrentFields);
+        });
+        if (eventIter == events.end())
         {
-            m_updatedTrackers.insert(status.url);
+            const QJsonObject syncData = generateMaindataSyncData(version, stream.lastSentID, stream.torrentFields);
+            events.append({.sinceID = stream.lastSentID
+                    , .torrentFields = stream.torrentFields
+                    , .data = QJsonDocument(syncData).toJson(QJsonDocument::Compact)});
+            eventIter = std::prev(events.end());
         }
-    }
-}
-
-void SyncController::onTorrentCategoryChanged(BitTorrent::Torrent *torrent
-        , [[maybe_unused]] const QString &oldCategory)
-{
-    m_updatedTorrents.insert(torrent->id());
-}
-
-void SyncController::onTorrentMetadataReceived(BitTorrent::Torrent *torrent)
-{
-    m_updatedTorrents.insert(torrent->id());
-}
 
-void SyncController::onTorrentStopped(BitTorrent::Torrent *torrent)
-{
-    m_updatedTorrents.insert(torrent->id());
-    m_announcedTorrents.insert(torrent->id());
-}
-
-void SyncController::onTorrentStarted(BitTorrent::Torrent *torrent)
-{
-    m_updatedTorrents.insert(torrent->id());
-}
-
-void SyncController::onTorrentSavePathChanged(BitTorrent::Torrent *torrent)
-{
-    m_updatedTorrents.insert(torrent->id());
-}
-
-void SyncController::onTorrentSavingModeChanged(BitTorrent::Torrent *torrent)
-{
-    m_updatedTorrents.insert(torrent->id());
-}
-
-void SyncController::onTorrentTagAdded(BitTorrent::Torrent *torrent, [[maybe_unused]] const Tag &tag)
-{
-    m_updatedTorrents.insert(torrent->id());
+        stream.eventStream->sendEvent(eventIter->data, {}, QString::number(version));
+        stream.lastSentID = version;
+        m_maindataLastSentID = version;
+    }
 }
 
-void SyncController::onTorrentTagRemoved(BitTorrent::Torrent *torrent, [[maybe_unused]] const Tag &tag)
+// GET param:
+//   - hash (string): torrent hash (ID)
+//   - rid (int): last response id
+void SyncController::torrentPeersAction()
 {
-    m_updatedTorrents.insert(torrent->id());
-}
+    const auto id = BitTorrent::TorrentID::fromString(params()[u"hash"_s]);
+    const BitTorrent::Torrent *torrent = BitTorrent::Session::instance()->getTorrent(id);
+    if (!torrent)
+        throw APIError(APIErrorType::NotFound);
 
-void SyncController::onTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents)
-{
-    for (const BitTorrent::Torrent *torrent : torrents)
-        m_updatedTorrents.insert(torrent->id());
-}
+    const bool resolvePeerCountries = Preferences::instance()->resolvePeerCountries();
+    const int acceptedResponseId = params()[u"rid"_s].toInt();
 
-void SyncController::onTorrentTrackersChanged(BitTorrent::Torrent *torrent)
-{
-    using namespace BitTorrent;
+    // peers are fetched from libtorrent thread, don't block the main thread while waiting for them
+    setResult(torrent->fetchPeerInfo().then(this, [this, id, resolvePeerCountries, acceptedResponseId](const QList<BitTorrent::PeerInfo> &peersList)
+    {
+        const BitTorrent::Torrent *torrent = BitTorrent::Session::instance()->getTorrent(id);
+        if (!torrent)
+            throw APIError(APIErrorType::NotFound);
 
-    const QList<TrackerEntryStatus> trackers = torrent->trackers();
+        QVariantMap data;
+        QVariantHash peers;
 
-    QSet<QString> currentTrackers;
-    currentTrackers.reserve(trackers.size());
-    for (const TrackerEntryStatus &status : trackers)
-        currentTrackers.insert(status.url);
+        data[KEY_SYNC_TORRENT_PEERS_SHOW_FLAGS] = resolvePeerCountries;
 
-    const TorrentID torrentID = torrent->id();
-    Algorithm::removeIf(m_knownTrackers
-        , [this, torrentID, currentTrackers](const QString &knownTracker, QSet<TorrentID> &torrentIDs)
-    {
-        if (auto idIter = torrentIDs.find(torrentID)
-                ; (idIter != torrentIDs.end()) && !currentTrackers.contains(knownTracker))
+        for (const BitTorrent::PeerInfo &pi : peersList)
         {
-            torrentIDs.erase(idIter);
-            if (torrentIDs.isEmpty())
+            const bool useI2PSocket = pi.useI2PSocket();
+            if (pi.address().ip.isNull() && !useI2PSocket) continue;
+
+            QVariantMap peer =
             {
-                m_updatedTrackers.remove(knownTracker);
-                m_removedTrackers.insert(knownTracker);
-                return true;
+                {KEY_PEER_CLIENT, pi.client()},
+                {KEY_PEER_ID_CLIENT, pi.peerIdClient()},
+                {KEY_PEER_PROGRESS, pi.progress()},
+                {KEY_PEER_DOWN_SPEED, pi.payloadDownSpeed()},
+                {KEY_PEER_UP_SPEED, pi.payloadUpSpeed()},
+                {KEY_PEER_TOT_DOWN, pi.totalDownload()},
+                {KEY_PEER_TOT_UP, pi.totalUpload()},
+                {KEY_PEER_CONNECTION_TYPE, pi.connectionType()},
+                {KEY_PEER_FLAGS, pi.flags()},
+                {KEY_PEER_FLAGS_DESCRIPTION, pi.flagsDescription()},
+                {KEY_PEER_RELEVANCE, pi.relevance()}
+            };
+
+            if (torrent->hasMetadata())
+            {
+                const PathList filePaths = torrent->info().filesForPiece(pi.downloadingPieceIndex());
+                QStringList filesForPiece;
+                filesForPiece.reserve(filePaths.size());
+                for (const Path &filePath : filePaths)
+                    filesForPiece.append(filePath.toString());
+                peer.insert(KEY_PEER_FILES, filesForPiece.join(u'\n'));
             }
 
-            m_updatedTrackers.insert(knownTracker);
-            return false;
-        }
-
-        if (currentTrackers.contains(knownTracker) && !torrentIDs.contains(torrentID))
-        {
-            torrentIDs.insert(torrentID);
-            m_updatedTrackers.insert(knownTracker);
-            return false;
-        }
-
-        return false;
-    });
+            if (resolvePeerCountries && !useI2PSocket)
+            {
+                peer[KEY_PEER_COUNTRY_CODE] = pi.country().toLower();
+                peer[KEY_PEER_COUNTRY] = Net::GeoIPManager::CountryName(pi.country());
+            }
 
-    for (const QString &currentTracker : asConst(currentTrackers))
-    {
-        if (!m_knownTrackers.contains(currentTracker))
-        {
-            m_knownTrackers.insert(currentTracker, {torrentID});
-            m_updatedTrackers.insert(currentTracker);
-            m_removedTrackers.remove(currentTracker);
+            if (useI2PSocket)
+            {
+                peer[KEY_PEER_I2P_DEST] = pi.I2PAddress();
+                peers[pi.I2PAddress()] = peer;
+            }
+            else
+            {
+                peer[KEY_PEER_IP] = pi.address().ip.toString();
+                peer[KEY_PEER_PORT] = pi.address().port;
+                peers[pi.address().toString()] = peer;
+            }
         }
-    }
+        data[u"peers"_s] = peers;
 
-    m_announcedTorrents.insert(torrentID);
-}
-
-void SyncController::onTorrentTrackerEntryStatusesUpdated(const BitTorrent::Torrent *torrent
-        , [[maybe_unused]] const QHash<QString, BitTorrent::TrackerEntryStatus> &updatedTrackers)
-{
-    m_announcedTorrents.insert(torrent->id());
+        return generateSyncData(acceptedResponseId, data, m_lastAcceptedPeersResponse, m_lastPeersResponse);
+    }));
 }
@@ -28,18 +28,17 @@
 
 #pragma once
 
+#include <optional>
+
+#include <QList>
+#include <QPointer>
 #include <QSet>
 #include <QVariantMap>
 
 #include "base/bittorrent/infohash.h"
-#include "base/tag.h"
+#include "base/http/eventstream.h"
 #include "apicontroller.h"
-
-namespace BitTorrent
-{
-    class Torrent;
-    struct TrackerEntryStatus;
-}
+#include "maindatasynclog.h"
 
 class SyncController : public APIController
 {
@@ -47,78 +46,62 @@ class SyncController : public APIController
     Q_DISABLE_COPY_MOVE(SyncController)
 
 public:
-    using APIController::APIController;
+    SyncController(MaindataSyncLog *maindataSyncLog, IApplication *app, QObject *parent = nullptr);
+    ~SyncController() override;
 
-    explicit SyncController(IApplication *app, QObject *parent = nullptr);
+    // Rough estimation of the memory used by the data kept for this session
+    // (not including the shared maindata sync log)
+    qint64 estimatedMemoryUsage() const;
+    // The maindata is synced from the shared log so only the peers snapshot and the torrents view are dropped,
+    // they are rebuilt (with full update) when requested again
+    void releaseIdleData();
 
-public slots:
-    void updateFreeDiskSpace(qint64 freeDiskSpace);
+signals:
+    // Emitted at each data push while the maindata stream is open
+    void maindataStreamActive();
 
 private slots:
     void maindataAction();
+    void maindataStreamAction();
     void torrentPeersAction();
 
 private:
-    void makeMaindataSnapshot();
-    QJsonObject generateMaindataSyncData(int id, bool fullUpdate);
-
-    void onCategoryAdded(const QString &categoryName);
-    void onCategoryRemoved(const QString &categoryName);
-    void onCategoryOptionsChanged(const QString &categoryName);
-    void onSubcategoriesSupportChanged();
-    void onTagAdded(const Tag &tag);
-    void onTagRemoved(const Tag &tag);
-    void onTorrentAdded(BitTorrent::Torrent *torrent);
-    void onTorrentAboutToBeRemoved(BitTorrent::Torrent *torrent);
-    void onTorrentCategoryChanged(BitTorrent::Torrent *torrent, const QString &oldCategory);
-    void onTorrentMetadataReceived(BitTorrent::Torrent *torrent);
-    void onTorrentStopped(BitTorrent::Torrent *torrent);
-    void onTorrentStarted(BitTorrent::Torrent *torrent);
-    void onTorrentSavePathChanged(BitTorrent::Torrent *torrent);
-    void onTorrentSavingModeChanged(BitTorrent::Torrent *torrent);
-    void onTorrentTagAdded(BitTorrent::Torrent *torrent, const Tag &tag);
-    void onTorrentTagRemoved(BitTorrent::Torrent *torrent, const Tag &tag);
-    void onTorrentsUpdated(const QList<BitTorrent::Torrent *> &torrents);
-    void onTorrentTrackersChanged(BitTorrent::Torrent *torrent);
-    void onTorrentTrackerEntryStatusesUpdated(const BitTorrent::Torrent *torrent
-            , const QHash<QString, BitTorrent::TrackerEntryStatus> &updatedTrackers);
-
-    qint64 m_freeDiskSpace = 0;
-
-    QVariantMap m_lastPeersResponse;
-    QVariantMap m_lastAcceptedPeersResponse;
-
-    QHash<QString, QSet<BitTorrent::TorrentID>> m_knownTrackers;
-
-    QSet<QString> m_updatedCategories;
-    QSet<QString> m_removedCategories;
-    QSet<QString> m_addedTags;
-    QSet<QString> m_removedTags;
-    QSet<QString> m_updatedTrackers;
-    QSet<QString> m_removedTrackers;
-    QSet<BitTorrent::TorrentID> m_updatedTorrents;
-    QSet<BitTorrent::TorrentID> m_announcedTorrents;
-    QSet<BitTorrent::TorrentID> m_removedTorrents;
-
-    struct MaindataSyncBuf
+    // Torrents of "sync/maindata" filtered, sorted and windowed by the request parameters
+    struct MaindataView
     {
-        QHash<QString, QVariantMap> categories;
-        QStringList removedCategories;
-
-        QVariantList tags;
-        QStringList removedTags;
-
-        QHash<QString, QVariantMap> torrents;
-        QStringList removedTorrents;
+        // normalized parameters of the view
+        QString key;
+        QList<BitTorrent::TorrentID> torrentIDs;
+        QSet<BitTorrent::TorrentID> torrentIDSet;
+        // number of the matching torrents before the window is applied
+        qsizetype total = 0;
+    };
 
-        QHash<QString, QStringList> trackers;
-        QStringList removedTrackers;
+    TorrentSyncFieldSet parseTorrentFieldsParam() const;
+    // Returns nullopt if no view parameters are given
+    std::optional<MaindataView> makeMaindataView() const;
+    QJsonObject generateMaindataSyncData(int version, int sinceID, const TorrentSyncFieldSet &torrentFields
+            , const QSet<BitTorrent::TorrentID> *torrentIDs = nullptr) const;
+    bool isMaindataSentByThis(int id) const;
+    void scheduleMaindataPush();
+    void pushMaindata();
 
-        QVariantMap serverState;
+    struct MaindataStream
+    {
+        QPointer<Http::EventStream> eventStream;
+        TorrentSyncFieldSet torrentFields;
+        int lastSentID = 0;
     };
 
-    MaindataSyncBuf m_maindataSnapshot;
-    MaindataSyncBuf m_maindataSyncBuf;
+    MaindataSyncLog *m_maindataSyncLog = nullptr;
+    int m_maindataFirstSentID = 0;
     int m_maindataLastSentID = 0;
-    int m_maindataAcceptedID = -1;
+    TorrentSyncFieldSet m_maindataTorrentFields = TorrentSyncFieldSet().set();
+    // the view of the last sent response
+    std::optional<MaindataView> m_maindataView;
+    QList<MaindataStream> m_maindataStreams;
+    bool m_isMaindataPushScheduled = false;
+
+    QVariantMap m_lastPeersResponse;
+    QVariantMap m_lastAcceptedPeersResponse;
 };
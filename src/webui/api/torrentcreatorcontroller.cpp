@@ -29,6 +29,8 @@
 
 #include "torrentcreatorcontroller.h"
 
+#include <algorithm>
+
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QStringList>
@@ -44,9 +46,11 @@
 const QString KEY_COMMENT = u"comment"_s;
 const QString KEY_ERROR_MESSAGE = u"errorMessage"_s;
 const QString KEY_FORMAT = u"format"_s;
+const QString KEY_HASHING_THREADS = u"hashingThreads"_s;
 const QString KEY_OPTIMIZE_ALIGNMENT = u"optimizeAlignment"_s;
 const QString KEY_PADDED_FILE_SIZE_LIMIT = u"paddedFileSizeLimit"_s;
 const QString KEY_PIECE_SIZE = u"pieceSize"_s;
+const QString KEY_PRIORITY = u"priority"_s;
 const QString KEY_PRIVATE = u"private"_s;
 const QString KEY_PROGRESS = u"progress"_s;
 const QString KEY_SOURCE = u"source"_s;
@@ -133,6 +137,7 @@ void TorrentCreatorController::addTaskAction()
         .isPrivate = parseBool(params()[KEY_PRIVATE]).value_or(false),
 #ifdef QBT_USES_LIBTORRENT2
         .torrentFormat = parseTorrentFormat(params()[KEY_FORMAT].toLower()),
+        .hashingThreads = std::max(0, parseInt(params()[KEY_HASHING_THREADS]).value_or(0)),
 #else
         .isAlignmentOptimized = parseBool(params()[KEY_OPTIMIZE_ALIGNMENT]).value_or(true),
         .paddedFileSizeLimit = parseInt(params()[KEY_PADDED_FILE_SIZE_LIMIT]).value_or(-1),
@@ -143,7 +148,8 @@ void TorrentCreatorController::addTaskAction()
         .comment = params()[KEY_COMMENT],
         .source = params()[KEY_SOURCE],
         .trackers = parseUrls(params()[KEY_TRACKERS]),
-        .urlSeeds = parseUrls(params()[KEY_URL_SEEDS])
+        .urlSeeds = parseUrls(params()[KEY_URL_SEEDS]),
+        .priority = parseInt(params()[KEY_PRIORITY]).value_or(0)
     };
 
     bool const startSeeding = parseBool(params()[u"startSeeding"_s]).value_or(createTorrentParams.torrentFilePath.isEmpty());
@@ -174,9 +180,11 @@ void TorrentCreatorController::statusAction()
             {KEY_SOURCE_PATH, task->params().sourcePath.toString()},
             {KEY_PIECE_SIZE, task->params().pieceSize},
             {KEY_PRIVATE, task->params().isPrivate},
+            {KEY_PRIORITY, task->params().priority},
             {KEY_TIME_ADDED, task->timeAdded().toString()},
 #ifdef QBT_USES_LIBTORRENT2
             {KEY_FORMAT, torrentFormatToString(task->params().torrentFormat)},
+            {KEY_HASHING_THREADS, task->params().hashingThreads},
 #else
             {KEY_OPTIMIZE_ALIGNMENT, task->params().isAlignmentOptimized},
             {KEY_PADDED_FILE_SIZE_LIMIT, task->params().paddedFileSizeLimit},
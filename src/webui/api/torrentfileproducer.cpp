@@ -0,0 +1,105 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentfileproducer.h"
+
+#include <algorithm>
+
+#include <QFuture>
+
+#include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrentinfo.h"
+
+TorrentFileProducer::TorrentFileProducer(BitTorrent::Torrent *torrent, const int fileIndex
+        , const qint64 position, const qint64 size, QObject *parent)
+    : Http::ContentProducer(parent)
+    , m_torrent {torrent}
+    , m_fileIndex {fileIndex}
+    , m_position {position}
+    , m_remainingSize {size}
+{
+    Q_ASSERT(torrent->hasMetadata());
+
+    const BitTorrent::TorrentInfo torrentInfo = torrent->info();
+    m_fileOffset = torrentInfo.fileOffset(fileIndex);
+    m_pieceLength = torrentInfo.pieceLength();
+}
+
+TorrentFileProducer::~TorrentFileProducer()
+{
+    if (m_torrent)
+        m_torrent->stopStreaming(m_fileIndex);
+}
+
+void TorrentFileProducer::produce()
+{
+    // the previous request is still waiting for the piece
+    if (m_isFetchingPiece)
+        return;
+
+    if (!m_torrent || (m_remainingSize <= 0))
+    {
+        finish();
+        return;
+    }
+
+    m_torrent->setStreamingPosition(m_fileIndex, m_position);
+
+    const auto pieceIndex = static_cast<int>((m_fileOffset + m_position) / m_pieceLength);
+    m_isFetchingPiece = true;
+    m_torrent->fetchPieceData(pieceIndex).then(this, [this, pieceIndex](const QByteArray &data)
+    {
+        handlePieceData(pieceIndex, data);
+    }).onCanceled(this, [this]
+    {
+        // the torrent is removed or its metadata is reloaded
+        m_isFetchingPiece = false;
+        finish();
+    });
+}
+
+void TorrentFileProducer::handlePieceData(const int pieceIndex, const QByteArray &data)
+{
+    m_isFetchingPiece = false;
+
+    const qint64 offsetInPiece = (m_fileOffset + m_position) - (static_cast<qint64>(pieceIndex) * m_pieceLength);
+    const qint64 size = std::min((data.size() - offsetInPiece), m_remainingSize);
+    if (size <= 0)
+    {
+        // the piece can't be read, so the content is incomplete
+        finish();
+        return;
+    }
+
+    m_position += size;
+    m_remainingSize -= size;
+    write(data.sliced(offsetInPiece, size));
+
+    if (m_remainingSize <= 0)
+        finish();
+}
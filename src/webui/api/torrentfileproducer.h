@@ -0,0 +1,63 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QByteArray>
+#include <QPointer>
+
+#include "base/http/contentproducer.h"
+
+namespace BitTorrent
+{
+    class Torrent;
+}
+
+// Produces the content of the torrent file in the given range of bytes. The pieces are requested
+// as they are needed, so the response proceeds as soon as the next piece is downloaded.
+class TorrentFileProducer final : public Http::ContentProducer
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TorrentFileProducer)
+
+public:
+    TorrentFileProducer(BitTorrent::Torrent *torrent, int fileIndex, qint64 position, qint64 size, QObject *parent = nullptr);
+    ~TorrentFileProducer() override;
+
+private:
+    void produce() override;
+    void handlePieceData(int pieceIndex, const QByteArray &data);
+
+    QPointer<BitTorrent::Torrent> m_torrent;
+    int m_fileIndex = -1;
+    qint64 m_fileOffset = 0;
+    qint64 m_pieceLength = 0;
+    qint64 m_position = 0;
+    qint64 m_remainingSize = 0;
+    bool m_isFetchingPiece = false;
+};
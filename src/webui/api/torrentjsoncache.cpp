@@ -0,0 +1,86 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "torrentjsoncache.h"
+
+#include <QJsonDocument>
+
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrent.h"
+
+TorrentJsonCache::TorrentJsonCache(QObject *parent)
+    : QObject(parent)
+{
+    // The same notifications keep the shared "sync/maindata" data up to date
+    auto *session = BitTorrent::Session::instance();
+    const auto invalidateTorrent = [this](const BitTorrent::Torrent *torrent) { invalidate(torrent); };
+    connect(session, &BitTorrent::Session::torrentAboutToBeRemoved, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentCategoryChanged, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentMetadataReceived, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentStopped, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentStarted, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentSavePathChanged, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentSavingModeChanged, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentTagAdded, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentTagRemoved, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::trackersAdded, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::trackersRemoved, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::trackersChanged, this, invalidateTorrent);
+    connect(session, &BitTorrent::Session::torrentsUpdated, this, [this](const QList<BitTorrent::Torrent *> &torrents)
+    {
+        // the torrents whose status isn't changed aren't reported
+        for (const BitTorrent::Torrent *torrent : torrents)
+            invalidate(torrent);
+    });
+}
+
+QByteArray TorrentJsonCache::serializedTorrent(const BitTorrent::Torrent &torrent, const TorrentFieldSet &fields)
+{
+    CachedTorrent &cachedTorrent = m_torrents[torrent.id()];
+    if (cachedTorrent.json.isEmpty() || (cachedTorrent.fields != fields))
+    {
+        cachedTorrent.fields = fields;
+        cachedTorrent.json = QJsonDocument(serialize(torrent, fields)).toJson(QJsonDocument::Compact);
+    }
+
+    return cachedTorrent.json;
+}
+
+qint64 TorrentJsonCache::estimatedMemoryUsage() const
+{
+    const qint64 entryOverhead = 32;
+    qint64 size = m_torrents.size() * static_cast<qint64>(sizeof(BitTorrent::TorrentID) + sizeof(CachedTorrent) + entryOverhead);
+    for (const CachedTorrent &cachedTorrent : m_torrents)
+        size += cachedTorrent.json.capacity();
+    return size;
+}
+
+void TorrentJsonCache::invalidate(const BitTorrent::Torrent *torrent)
+{
+    m_torrents.remove(torrent->id());
+}
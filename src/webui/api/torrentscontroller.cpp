@@ -32,18 +32,28 @@
 #include <chrono>
 #include <concepts>
 #include <functional>
+#include <memory>
+#include <optional>
 
 #include <QBitArray>
 #include <QFileInfo>
 #include <QFuture>
 #include <QJsonArray>
+#include <QJsonDocument>
 #include <QJsonObject>
 #include <QList>
+#include <QMap>
+#include <QMimeDatabase>
+#include <QPointer>
+#include <QPromise>
 #include <QRegularExpression>
+#include <QSet>
+#include <QThreadPool>
 #include <QUrl>
 
 #include "base/addtorrentmanager.h"
 #include "base/bittorrent/categoryoptions.h"
+#include "base/bittorrent/diskiostatistics.h"
 #include "base/bittorrent/downloadpriority.h"
 #include "base/bittorrent/infohash.h"
 #include "base/bittorrent/peeraddress.h"
@@ -52,24 +62,37 @@
 #include "base/bittorrent/sslparameters.h"
 #include "base/bittorrent/torrent.h"
 #include "base/bittorrent/torrentdescriptor.h"
+#include "base/bittorrent/torrentstatustable.h"
 #include "base/bittorrent/trackerentry.h"
 #include "base/bittorrent/trackerentrystatus.h"
 #include "base/interfaces/iapplication.h"
 #include "base/global.h"
+#include "base/http/responsegenerator.h"
+#include "base/http/types.h"
 #include "base/logger.h"
 #include "base/net/downloadmanager.h"
+#include "base/net/faviconcache.h"
+#include "base/path.h"
 #include "base/preferences.h"
 #include "base/search/searchdownloadhandler.h"
 #include "base/search/searchpluginmanager.h"
 #include "base/torrentfilter.h"
+#include "base/torrentfilterindex.h"
 #include "base/utils/datetime.h"
 #include "base/utils/fs.h"
 #include "base/utils/io.h"
+#include "base/utils/jsonwriter.h"
 #include "base/utils/sslkey.h"
 #include "base/utils/string.h"
 #include "apierror.h"
 #include "apistatus.h"
+#include "filecontentproducer.h"
+#include "jsonarrayproducer.h"
+#include "serialize/serialize_diskiostatistics.h"
+#include "serialize/serialize_peerstatistics.h"
 #include "serialize/serialize_torrent.h"
+#include "torrentfileproducer.h"
+#include "torrentjsoncache.h"
 
 // Tracker keys
 const QString KEY_TRACKER_URL = u"url"_s;
@@ -133,6 +156,9 @@ const QString KEY_PROP_SSL_PRIVATEKEY = u"ssl_private_key"_s;
 const QString KEY_PROP_SSL_DHPARAMS = u"ssl_dh_params"_s;
 const QString KEY_PROP_HAS_METADATA = u"has_metadata"_s;
 const QString KEY_PROP_PROGRESS = u"progress"_s;
+const QString KEY_PROP_PREALLOCATION_PROGRESS = u"preallocation_progress"_s;
+const QString KEY_PROP_DISK_IO = u"disk_io"_s;
+const QString KEY_PROP_PEER_STATS = u"peer_stats"_s;
 const QString KEY_PROP_FILES = u"files"_s;
 const QString KEY_PROP_TRACKERS = u"trackers"_s;
 
@@ -147,6 +173,18 @@ const QString KEY_FILE_IS_SEED = u"is_seed"_s;
 const QString KEY_FILE_PIECE_RANGE = u"piece_range"_s;
 const QString KEY_FILE_AVAILABILITY = u"availability"_s;
 
+// Scoped and incremental file list
+const QString KEY_FILES_RID = u"rid"_s;
+const QString KEY_FILES_FULL_UPDATE = u"full_update"_s;
+const QString KEY_FILES_TOTAL = u"total"_s;
+const QString KEY_FILES_IS_SEED = u"is_seed"_s;
+const QString KEY_FILES_FILES = u"files"_s;
+const QString KEY_FILES_FOLDERS = u"folders"_s;
+const QString KEY_FOLDER_NAME = u"name"_s;
+const QString KEY_FOLDER_SIZE = u"size"_s;
+const QString KEY_FOLDER_PROGRESS = u"progress"_s;
+const QString KEY_FOLDER_FILES_COUNT = u"files_count"_s;
+
 // Torrent info
 const QString KEY_TORRENTINFO_FILE_LENGTH = u"length"_s;
 const QString KEY_TORRENTINFO_FILE_PATH = u"path"_s;
@@ -157,6 +195,17 @@ const QString KEY_TORRENTINFO_PIECE_LENGTH = u"piece_length"_s;
 const QString KEY_TORRENTINFO_TRACKERS = u"trackers"_s;
 const QString KEY_TORRENTINFO_WEBSEEDS = u"webseeds"_s;
 
+// Compact piece states
+const QString KEY_PIECE_STATES_COUNT = u"pieces_count"_s;
+const QString KEY_PIECE_STATES_TOKEN = u"token"_s;
+const QString KEY_PIECE_STATES_STATES = u"states"_s;
+const QString KEY_PIECE_STATES_CHANGES = u"changes"_s;
+
+// larger torrent lists are serialized while they are sent
+const qsizetype STREAMED_TORRENTS_THRESHOLD = 1000;
+// piece states and file states of at most this many torrents are kept for incremental updates
+const qsizetype MAX_TORRENT_SNAPSHOTS = 16;
+
 namespace
 {
     using Utils::String::parseBool;
@@ -169,6 +218,8 @@ namespace
     void applyToTorrents(const QStringList &idList, Func func)
         requires std::invocable<Func, BitTorrent::Torrent *>
     {
+        const BitTorrent::Session::BulkUpdateScope bulkUpdate;
+
         if ((idList.size() == 1) && (idList[0] == u"all"))
         {
             for (BitTorrent::Torrent *const torrent : asConst(BitTorrent::Session::instance()->torrents()))
@@ -186,6 +237,46 @@ namespace
         }
     }
 
+    // 2 bits per piece, the first piece is stored in the least significant bits of the first byte
+    QByteArray packPieceStates(const QBitArray &pieces, const QBitArray &downloadingPieces)
+    {
+        QByteArray packedStates {((pieces.size() + 3) / 4), '\0'};
+        for (qsizetype i = 0; i < pieces.size(); ++i)
+        {
+            const int state = downloadingPieces.testBit(i) ? 1 : (pieces.testBit(i) ? 2 : 0);
+            packedStates[i / 4] = static_cast<char>(packedStates[i / 4] | (state << ((i % 4) * 2)));
+        }
+
+        return packedStates;
+    }
+
+    std::optional<QJsonArray> getPieceStatesChanges(const QByteArray &previousStates, const QByteArray &currentStates, const qsizetype maxChanges)
+    {
+        QJsonArray changes;
+        for (qsizetype byteIndex = 0; byteIndex < currentStates.size(); ++byteIndex)
+        {
+            const auto currentByte = static_cast<uchar>(currentStates[byteIndex]);
+            const auto changedBits = static_cast<uchar>(currentByte ^ static_cast<uchar>(previousStates[byteIndex]));
+            if (changedBits == 0)
+                continue;
+
+            for (int i = 0; i < 4; ++i)
+            {
+                const int shift = i * 2;
+                if (((changedBits >> shift) & 0b11) == 0)
+                    continue;
+
+                if (changes.size() >= maxChanges)
+                    return std::nullopt;
+
+                const auto pieceIndex = static_cast<int>((byteIndex * 4) + i);
+                changes.append(QJsonArray {pieceIndex, ((currentByte >> shift) & 0b11)});
+            }
+        }
+
+        return changes;
+    }
+
     std::optional<QString> getOptionalString(const StringMap &params, const QString &name)
     {
         const auto it = params.constFind(name);
@@ -204,10 +295,9 @@ namespace
         return Tag(it.value());
     }
 
-    QJsonArray getStickyTrackers(const BitTorrent::Torrent *const torrent)
+    QJsonArray getStickyTrackers(const BitTorrent::Torrent *const torrent, const QList<BitTorrent::PeerInfo> &peersList)
     {
         int seedsDHT = 0, seedsPeX = 0, seedsLSD = 0, leechesDHT = 0, leechesPeX = 0, leechesLSD = 0;
-        const QList<BitTorrent::PeerInfo> peersList = torrent->fetchPeerInfo().takeResult();
         for (const BitTorrent::PeerInfo &peer : peersList)
         {
             if (peer.isConnecting())
@@ -332,11 +422,39 @@ namespace
         return trackerList;
     }
 
-    QJsonArray getFiles(const BitTorrent::Torrent *const torrent, QList<int> fileIndexes = {})
+    void writeFile(Utils::JsonWriter &writer, const BitTorrent::Torrent *const torrent, const BitTorrent::TorrentInfo &info, const int index
+            , const QList<BitTorrent::DownloadPriority> &priorities, const QList<qreal> &fp, const QList<qreal> &fileAvailability
+            , const std::optional<bool> isSeed = std::nullopt)
+    {
+        const BitTorrent::TorrentInfo::PieceRange idx = info.filePieces(index);
+
+        // the keys are in the same order as in QJsonObject
+        writer.beginObject()
+            .key(KEY_FILE_AVAILABILITY).value(fileAvailability[index])
+            .key(KEY_FILE_INDEX).value(index);
+        if (isSeed)
+            writer.key(KEY_FILE_IS_SEED).value(*isSeed);
+        // need to provide paths using a platform-independent separator format
+        writer.key(KEY_FILE_NAME).value(torrent->filePath(index).data())
+            .key(KEY_FILE_PIECE_RANGE).beginArray().value(idx.first()).value(idx.last()).endArray()
+            .key(KEY_FILE_PRIORITY).value(static_cast<int>(priorities[index]))
+            .key(KEY_FILE_PROGRESS).value(fp[index])
+            .key(KEY_FILE_SIZE).value(torrent->fileSize(index))
+            .endObject();
+    }
+
+    // Writes the files as JSON array, the first one is marked with "is_seed" if it is given
+    void writeFiles(Utils::JsonWriter &writer, const BitTorrent::Torrent *const torrent, QList<int> fileIndexes
+            , const QList<qreal> &fileAvailability, const std::optional<bool> isSeed = std::nullopt)
     {
         Q_ASSERT(torrent->hasMetadata());
+
+        writer.beginArray();
         if (!torrent->hasMetadata()) [[unlikely]]
-            return {};
+        {
+            writer.endArray();
+            return;
+        }
 
         if (fileIndexes.isEmpty())
         {
@@ -346,31 +464,12 @@ namespace
                 fileIndexes.append(i);
         }
 
-        QJsonArray fileList;
         const QList<BitTorrent::DownloadPriority> priorities = torrent->filePriorities();
         const QList<qreal> fp = torrent->filesProgress();
-        const QList<qreal> fileAvailability = torrent->fetchAvailableFileFractions().takeResult();
         const BitTorrent::TorrentInfo info = torrent->info();
-        for (const int index : asConst(fileIndexes))
-        {
-            const BitTorrent::TorrentInfo::PieceRange idx = info.filePieces(index);
-
-            const QJsonObject fileDict =
-            {
-                {KEY_FILE_INDEX, index},
-                {KEY_FILE_PROGRESS, fp[index]},
-                {KEY_FILE_PRIORITY, static_cast<int>(priorities[index])},
-                {KEY_FILE_SIZE, torrent->fileSize(index)},
-                {KEY_FILE_AVAILABILITY, fileAvailability[index]},
-                // need to provide paths using a platform-independent separator format
-                {KEY_FILE_NAME, torrent->filePath(index).data()},
-                {KEY_FILE_PIECE_RANGE, QJsonArray {idx.first(), idx.last()}}
-            };
-
-            fileList.append(fileDict);
-        }
-
-        return fileList;
+        for (qsizetype i = 0; i < fileIndexes.size(); ++i)
+            writeFile(writer, torrent, info, fileIndexes[i], priorities, fp, fileAvailability, ((i == 0) ? isSeed : std::nullopt));
+        writer.endArray();
     }
 
     QList<BitTorrent::TorrentID> toTorrentIDs(const QStringList &idStrings)
@@ -496,6 +595,24 @@ namespace
         return info;
     }
 
+    std::optional<TorrentFieldSet> parseTorrentFields(const QString &fieldsStr)
+    {
+        if (fieldsStr.isEmpty())
+            return TorrentFieldSet().set();
+
+        TorrentFieldSet fields;
+        for (const QString &key : asConst(fieldsStr.split(u'|', Qt::SkipEmptyParts)))
+        {
+            const std::optional<TorrentField> field = torrentFieldFromKey(key);
+            if (!field)
+                return std::nullopt;
+
+            fields.set(static_cast<std::size_t>(*field));
+        }
+
+        return fields;
+    }
+
     nonstd::expected<BitTorrent::DownloadPriority, QString> parseDownloadPriority(const QString &priorityStr)
     {
         bool ok = false;
@@ -506,12 +623,46 @@ namespace
             return nonstd::make_unexpected(TorrentsController::tr("Priority is not valid"));
         return priority;
     }
+
+    // Loads the torrents in parallel. A future has no result if its data isn't a valid torrent file.
+    QList<QFuture<BitTorrent::TorrentDescriptor>> loadTorrents(const QList<QByteArray> &torrentsData)
+    {
+        QList<QFuture<BitTorrent::TorrentDescriptor>> results;
+        results.reserve(torrentsData.size());
+        for (const QByteArray &data : torrentsData)
+        {
+            auto promise = std::make_shared<QPromise<BitTorrent::TorrentDescriptor>>();
+            promise->start();
+            results.append(promise->future());
+
+            QThreadPool::globalInstance()->start([promise, data]
+            {
+                if (const auto loadResult = BitTorrent::TorrentDescriptor::load(data))
+                    promise->addResult(loadResult.value());
+                promise->finish();
+            });
+        }
+
+        return results;
+    }
 }
 
-TorrentsController::TorrentsController(IApplication *app, QObject *parent)
+TorrentsController::TorrentsController(TorrentJsonCache *torrentJsonCache, IApplication *app, QObject *parent)
     : APIController(app, parent)
+    , m_torrentJsonCache {torrentJsonCache}
 {
     connect(BitTorrent::Session::instance(), &BitTorrent::Session::metadataDownloaded, this, &TorrentsController::onMetadataDownloaded);
+    connect(BitTorrent::Session::instance(), &BitTorrent::Session::torrentAboutToBeRemoved, this, [this](const BitTorrent::Torrent *torrent)
+    {
+        m_pieceStatesSnapshots.remove(torrent->id());
+        m_fileStatesSnapshots.remove(torrent->id());
+    });
+}
+
+void TorrentsController::releaseIdleData()
+{
+    m_pieceStatesSnapshots.clear();
+    m_fileStatesSnapshots.clear();
 }
 
 void TorrentsController::countAction()
@@ -545,9 +696,11 @@ void TorrentsController::countAction()
 //   - category (string): torrent category for filtering by it (empty string means "uncategorized"; no "category" param presented means "any category")
 //   - tag (string): torrent tag for filtering by it (empty string means "untagged"; no "tag" param presented means "any tag")
 //   - hashes (string): filter by hashes, can contain multiple hashes separated by |
+//   - search (string): filter torrents whose name contains the given text (case insensitive)
 //   - private (bool): filter torrents that are from private trackers (true) or not (false). Empty means any torrent (no filtering)
 //   - includeFiles (bool): include files in list output (true) or not (false). Empty means not included
 //   - includeTrackers (bool): include trackers in list output (true) or not (false). Empty means not included
+//   - fields (string): torrent fields to include in list output, separated by |. Empty means all fields
 //   - sort (string): name of column for sorting by its value
 //   - reverse (bool): enable reverse sorting
 //   - limit (int): set limit number of torrents returned (if greater than 0, otherwise - unlimited)
@@ -562,9 +715,13 @@ void TorrentsController::infoAction()
     int limit {params()[u"limit"_s].toInt()};
     int offset {params()[u"offset"_s].toInt()};
     const QStringList hashes {params()[u"hashes"_s].split(u'|', Qt::SkipEmptyParts)};
+    const QString searchText {params()[u"search"_s]};
     const std::optional<bool> isPrivate = parseBool(params()[u"private"_s]);
     const bool includeFiles = parseBool(params()[u"includeFiles"_s]).value_or(false);
     const bool includeTrackers = parseBool(params()[u"includeTrackers"_s]).value_or(false);
+    const std::optional<TorrentFieldSet> fields = parseTorrentFields(params()[u"fields"_s]);
+    if (!fields)
+        throw APIError(APIErrorType::BadParams, tr("'fields' parameter is invalid"));
 
     std::optional<TorrentIDSet> idSet;
     if (!hashes.isEmpty())
@@ -575,80 +732,120 @@ void TorrentsController::infoAction()
     }
 
     const TorrentFilter torrentFilter {filter, idSet, category, tag, isPrivate};
-    QVariantList torrentList;
-    for (const BitTorrent::Torrent *torrent : asConst(BitTorrent::Session::instance()->torrents()))
+    const auto *filterIndex = TorrentFilterIndex::instance();
+    const QBitArray nameMatches = !searchText.isEmpty() ? filterIndex->matchingNameTorrents(searchText) : QBitArray();
+    const auto matchName = [&searchText, filterIndex, &nameMatches](const BitTorrent::Torrent *torrent)
     {
-        if (!torrentFilter.match(torrent))
-            continue;
+        if (searchText.isEmpty())
+            return true;
 
-        QVariantMap serializedTorrent = serialize(*torrent);
-
-        if (includeFiles && torrent->hasMetadata())
-            serializedTorrent.insert(KEY_PROP_FILES, getFiles(torrent));
-        if (includeTrackers)
-            serializedTorrent.insert(KEY_PROP_TRACKERS, getTrackers(torrent));
+        const int slot = filterIndex->torrentSlot(torrent);
+        return (slot >= 0) && (slot < nameMatches.size()) && nameMatches.testBit(slot);
+    };
 
-        torrentList.append(serializedTorrent);
+    QList<const BitTorrent::Torrent *> torrents;
+    // the status table lists all the torrents without copying them
+    for (const BitTorrent::Torrent *torrent : BitTorrent::Session::instance()->torrentStatusTable().torrents())
+    {
+        if (torrentFilter.match(torrent) && matchName(torrent))
+            torrents.append(torrent);
     }
 
-    if (torrentList.isEmpty())
+    if (torrents.isEmpty())
     {
         setResult(QJsonArray {});
         return;
     }
 
+    const qsizetype size = torrents.size();
+    // normalize offset
+    if (offset < 0)
+        offset = size + offset;
+    // normalize limit
+    if (limit <= 0)
+        limit = -1; // unlimited
+
     if (!sortedColumn.isEmpty())
     {
-        if (!torrentList[0].toMap().contains(sortedColumn))
+        const std::optional<TorrentField> sortedField = torrentFieldFromKey(sortedColumn);
+        if (!sortedField)
             throw APIError(APIErrorType::BadParams, tr("'sort' parameter is invalid"));
 
-        const auto lessThan = [](const QVariant &left, const QVariant &right) -> bool
-        {
-            Q_ASSERT(left.userType() == right.userType());
+        // Only the sort key is serialized for each torrent, and only the requested page is fully sorted
+        QList<std::pair<QJsonValue, const BitTorrent::Torrent *>> sortItems;
+        sortItems.reserve(size);
+        for (const BitTorrent::Torrent *torrent : asConst(torrents))
+            sortItems.emplaceBack(serializeTorrentField(*torrent, *sortedField), torrent);
 
-            switch (left.userType())
-            {
-            case QMetaType::Bool:
-                return left.value<bool>() < right.value<bool>();
-            case QMetaType::Double:
-                return left.value<double>() < right.value<double>();
-            case QMetaType::Float:
-                return left.value<float>() < right.value<float>();
-            case QMetaType::Int:
-                return left.value<int>() < right.value<int>();
-            case QMetaType::LongLong:
-                return left.value<qlonglong>() < right.value<qlonglong>();
-            case QMetaType::QString:
-                return left.value<QString>() < right.value<QString>();
-            default:
-                qWarning("Unhandled QVariant comparison, type: %d, name: %s"
-                        , left.userType(), left.metaType().name());
-                break;
-            }
-            return false;
-        };
-
-        std::ranges::sort(torrentList
-            , [reverse, &sortedColumn, &lessThan](const QVariant &torrent1, const QVariant &torrent2)
+        const qsizetype sortedCount = (limit > 0) ? std::clamp<qsizetype>((offset + limit), 0, size) : size;
+        std::ranges::partial_sort(sortItems, (sortItems.begin() + sortedCount)
+            , [reverse](const auto &item1, const auto &item2)
         {
-            const QVariant value1 {torrent1.toMap().value(sortedColumn)};
-            const QVariant value2 {torrent2.toMap().value(sortedColumn)};
-            return reverse ? lessThan(value2, value1) : lessThan(value1, value2);
+            return reverse ? torrentFieldLessThan(item2.first, item1.first) : torrentFieldLessThan(item1.first, item2.first);
         });
-    }
 
-    const qsizetype size = torrentList.size();
-    // normalize offset
-    if (offset < 0)
-        offset = size + offset;
-    // normalize limit
-    if (limit <= 0)
-        limit = -1; // unlimited
+        for (qsizetype i = 0; i < sortedCount; ++i)
+            torrents[i] = sortItems[i].second;
+    }
 
     if ((limit > 0) || (offset > 0))
-        torrentList = torrentList.mid(offset, limit);
+        torrents = torrents.mid(offset, limit);
+
+    // the torrents listed without additional data share the cached JSON
+    const auto serializeTorrent = [torrentJsonCache = QPointer<TorrentJsonCache>(m_torrentJsonCache), fields = *fields
+            , includeFiles, includeTrackers](const BitTorrent::Torrent *torrent) -> QByteArray
+    {
+        if (!includeFiles && !includeTrackers && torrentJsonCache)
+            return torrentJsonCache->serializedTorrent(*torrent, fields);
+
+        QJsonObject serializedTorrent = serialize(*torrent, fields);
+        if (includeTrackers)
+            serializedTorrent.insert(KEY_PROP_TRACKERS, getTrackers(torrent));
+        if (!includeFiles || !torrent->hasMetadata())
+            return QJsonDocument(serializedTorrent).toJson(QJsonDocument::Compact);
+
+        // the file list may be large so it is written directly instead of being built as QJsonArray
+        Utils::JsonWriter writer;
+        writer.beginObject();
+        for (auto iter = serializedTorrent.constBegin(); iter != serializedTorrent.constEnd(); ++iter)
+            writer.key(iter.key()).value(iter.value());
+        writer.key(KEY_PROP_FILES);
+        writeFiles(writer, torrent, {}, torrent->fetchAvailableFileFractions().takeResult());
+        writer.endObject();
+        return writer.takeData();
+    };
+
+    if (torrents.size() > STREAMED_TORRENTS_THRESHOLD)
+    {
+        // torrents may be removed while the response is produced
+        QList<BitTorrent::TorrentID> torrentIDs;
+        torrentIDs.reserve(torrents.size());
+        for (const BitTorrent::Torrent *torrent : asConst(torrents))
+            torrentIDs.append(torrent->id());
 
-    setResult(QJsonArray::fromVariantList(torrentList));
+        const auto serializer = [torrentIDs, serializeTorrent](const qsizetype index) -> std::optional<QByteArray>
+        {
+            const BitTorrent::Torrent *torrent = BitTorrent::Session::instance()->getTorrent(torrentIDs[index]);
+            if (!torrent)
+                return std::nullopt;
+
+            return serializeTorrent(torrent);
+        };
+
+        setResult(new JsonArrayProducer(torrentIDs.size(), serializer), Http::CONTENT_TYPE_JSON);
+        return;
+    }
+
+    QByteArray torrentList = "[";
+    for (const BitTorrent::Torrent *torrent : asConst(torrents))
+    {
+        if (torrentList.size() > 1)
+            torrentList.append(',');
+        torrentList.append(serializeTorrent(torrent));
+    }
+    torrentList.append(']');
+
+    setResult(torrentList, Http::CONTENT_TYPE_JSON);
 }
 
 // Returns the properties for a torrent in JSON format.
@@ -693,6 +890,7 @@ void TorrentsController::infoAction()
 //   - "infohash_v2": Torrent v2 infohash (or empty string for v1 torrents)
 //   - "hash": Torrent TorrentID (infohashv1 for v1 torrents, truncated infohashv2 for v2/hybrid torrents)
 //   - "name": Torrent name
+//   - "preallocation_progress": Progress of reserving the disk space of the files in background (1 unless it is ongoing)
 void TorrentsController::propertiesAction()
 {
     requireParams({u"hash"_s});
@@ -758,7 +956,10 @@ void TorrentsController::propertiesAction()
         {KEY_PROP_DOWNLOAD_PATH, torrent->downloadPath().toString()},
         {KEY_PROP_COMMENT, torrent->comment()},
         {KEY_PROP_HAS_METADATA, torrent->hasMetadata()},
-        {KEY_PROP_PROGRESS, torrent->progress()}
+        {KEY_PROP_PROGRESS, torrent->progress()},
+        {KEY_PROP_PREALLOCATION_PROGRESS, torrent->preallocationProgress()},
+        {KEY_PROP_DISK_IO, serialize(BitTorrent::Session::instance()->torrentDiskIOStatistics(id))},
+        {KEY_PROP_PEER_STATS, serialize(torrent->peerStatistics())}
     };
 
     setResult(ret);
@@ -784,13 +985,49 @@ void TorrentsController::trackersAction()
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
 
-    QJsonArray trackersList = getStickyTrackers(torrent);
+    // peers are fetched from libtorrent thread, don't block the main thread while waiting for them
+    setResult(torrent->fetchPeerInfo().then(this, [id](const QList<BitTorrent::PeerInfo> &peersList)
+    {
+        const BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
+        if (!torrent)
+            throw APIError(APIErrorType::NotFound);
+
+        QJsonArray trackersList = getStickyTrackers(torrent, peersList);
+
+        // merge QJsonArray
+        for (const auto &tracker : asConst(getTrackers(torrent)))
+            trackersList.append(tracker);
+
+        return trackersList;
+    }));
+}
+
+// Returns the cached favicon of a tracker, so the browsers don't need to fetch it from the tracker host.
+// GET params:
+//   - url (string): tracker URL or host
+void TorrentsController::trackerFaviconAction()
+{
+    requireParams({u"url"_s});
+
+    const QString trackerURL = params()[u"url"_s].trimmed();
+    const QUrl url {trackerURL};
+    const QString host = !url.host().isEmpty() ? url.host() : trackerURL;
+    const QString faviconHost = Net::FaviconCache::faviconHost(host);
 
-    // merge QJsonArray
-    for (const auto &tracker : asConst(getTrackers(torrent)))
-        trackersList.append(tracker);
+    auto *faviconCache = Net::FaviconCache::instance();
+    // The icon isn't downloaded again if the cached one isn't expired yet
+    faviconCache->fetchIcon(faviconHost, url.scheme());
+
+    const Path iconPath = faviconCache->iconPath(faviconHost);
+    if (iconPath.isEmpty())
+        throw APIError(APIErrorType::NotFound);
+
+    const auto readResult = Utils::IO::readFile(iconPath, Net::MAX_FAVICON_SIZE);
+    if (!readResult)
+        throw APIError(APIErrorType::NotFound);
 
-    setResult(trackersList);
+    setHeader(Http::HEADER_CACHE_CONTROL, u"private, max-age=86400"_s);
+    setResult(readResult.value(), Net::FaviconCache::imageMimeType(readResult.value()));
 }
 
 // Returns the web seeds for a torrent in JSON format.
@@ -913,6 +1150,14 @@ void TorrentsController::removeWebSeedsAction()
 //   - "is_seed": Flag indicating if torrent is seeding/complete
 //   - "piece_range": Piece index range, the first number is the starting piece index
 //        and the second number is the ending piece index (inclusive)
+// If any of the following params is given, the return value is a JSON object instead
+// containing "rid", "full_update", "total", "is_seed", "files" and, if "path" is given, "folders":
+//   - path (string): list only the files directly in this folder and its direct subfolders
+//   - limit (int): set limit number of files returned (if greater than 0, otherwise - unlimited)
+//   - offset (int): set offset (if less than 0 - offset from end)
+//   - rid (int): if it is the "rid" of the previous response for the same torrent, "files" contain
+//        only "index", "progress", "priority" and "availability" of the files changed since then
+//        (and "name" of the renamed ones)
 void TorrentsController::filesAction()
 {
     requireParams({u"hash"_s});
@@ -921,8 +1166,25 @@ void TorrentsController::filesAction()
     const BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
+
+    const auto pathIt = params().constFind(u"path"_s);
+    const auto ridIt = params().constFind(u"rid"_s);
+    const bool isObjectResult = (pathIt != params().cend()) || (ridIt != params().cend())
+            || params().contains(u"limit"_s) || params().contains(u"offset"_s);
+
     if (!torrent->hasMetadata())
-        return setResult(QJsonArray{});
+    {
+        if (!isObjectResult)
+            return setResult(QJsonArray{});
+
+        return setResult(QJsonObject {
+            {KEY_FILES_RID, 0},
+            {KEY_FILES_FULL_UPDATE, true},
+            {KEY_FILES_TOTAL, 0},
+            {KEY_FILES_IS_SEED, false},
+            {KEY_FILES_FILES, QJsonArray()}
+        });
+    }
 
     QList<int> fileIndexes;
     const auto idxIt = params().constFind(u"indexes"_s);
@@ -943,19 +1205,170 @@ void TorrentsController::filesAction()
         }
     }
 
-    QJsonArray fileList = getFiles(torrent, fileIndexes);
-    if (!fileList.isEmpty())
+    // file availability is fetched from libtorrent thread, don't block the main thread while waiting for it
+    QFuture<QList<qreal>> fileAvailabilityFuture = torrent->fetchAvailableFileFractions();
+
+    if (!isObjectResult)
     {
-        QJsonObject firstFile = fileList[0].toObject();
-        firstFile[KEY_FILE_IS_SEED] = torrent->isFinished();
-        fileList[0] = firstFile;
+        setResult(fileAvailabilityFuture.then(this, [id, fileIndexes](const QList<qreal> &fileAvailability)
+        {
+            const BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
+            if (!torrent)
+                throw APIError(APIErrorType::NotFound);
+
+            Utils::JsonWriter writer;
+            writeFiles(writer, torrent, fileIndexes, fileAvailability, torrent->isFinished());
+            return writer.takeData();
+        }));
+        return;
     }
 
-    setResult(fileList);
+    const std::optional<QString> folderPath = (pathIt != params().cend())
+            ? std::optional<QString>(Path(pathIt.value()).data()) : std::nullopt;
+    const std::optional<int> rid = (ridIt != params().cend()) ? std::optional<int>(ridIt.value().toInt()) : std::nullopt;
+    const int limit = params()[u"limit"_s].toInt();
+    const int offset = params()[u"offset"_s].toInt();
+
+    setResult(fileAvailabilityFuture.then(this, [this, id, fileIndexes, folderPath, offset, limit, rid](const QList<qreal> &fileAvailability)
+    {
+        const BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
+        if (!torrent)
+            throw APIError(APIErrorType::NotFound);
+
+        return serializeFileList(torrent, fileIndexes, fileAvailability, folderPath, offset, limit, rid);
+    }));
+}
+
+QByteArray TorrentsController::serializeFileList(const BitTorrent::Torrent *torrent, QList<int> fileIndexes, const QList<qreal> &fileAvailability
+        , const std::optional<QString> &folderPath, int offset, int limit, const std::optional<int> rid)
+{
+    const BitTorrent::TorrentID id = torrent->id();
+    const int filesCount = torrent->filesCount();
+    if (fileIndexes.isEmpty())
+    {
+        fileIndexes.reserve(filesCount);
+        for (int i = 0; i < filesCount; ++i)
+            fileIndexes.append(i);
+    }
+
+    const QList<BitTorrent::DownloadPriority> priorities = torrent->filePriorities();
+    const QList<qreal> fp = torrent->filesProgress();
+    const BitTorrent::TorrentInfo info = torrent->info();
+
+    Utils::JsonWriter writer;
+    writer.beginObject();
+
+    if (folderPath)
+    {
+        struct FolderStats
+        {
+            qint64 size = 0;
+            qreal completedSize = 0;
+            int filesCount = 0;
+        };
+
+        const QString prefix = folderPath->isEmpty() ? QString() : (*folderPath + u'/');
+
+        QList<int> childFileIndexes;
+        QMap<QString, FolderStats> subfolders;
+        for (const int index : asConst(fileIndexes))
+        {
+            const QString filePath = torrent->filePath(index).data();
+            if (!filePath.startsWith(prefix))
+                continue;
+
+            const qsizetype separatorPos = filePath.indexOf(u'/', prefix.size());
+            if (separatorPos < 0)
+            {
+                childFileIndexes.append(index);
+                continue;
+            }
+
+            const qint64 fileSize = torrent->fileSize(index);
+            FolderStats &folderStats = subfolders[filePath.left(separatorPos)];
+            folderStats.size += fileSize;
+            folderStats.completedSize += fileSize * fp[index];
+            ++folderStats.filesCount;
+        }
+
+        writer.key(KEY_FILES_FOLDERS).beginArray();
+        for (auto it = subfolders.cbegin(); it != subfolders.cend(); ++it)
+        {
+            const FolderStats &folderStats = it.value();
+            writer.beginObject()
+                .key(KEY_FOLDER_FILES_COUNT).value(folderStats.filesCount)
+                .key(KEY_FOLDER_NAME).value(it.key())
+                .key(KEY_FOLDER_PROGRESS).value((folderStats.size > 0) ? (folderStats.completedSize / folderStats.size) : 1.0)
+                .key(KEY_FOLDER_SIZE).value(folderStats.size)
+                .endObject();
+        }
+        writer.endArray();
+
+        fileIndexes = childFileIndexes;
+    }
+
+    const auto total = static_cast<int>(fileIndexes.size());
+    if (offset < 0)
+        offset = std::max(0, (total + offset));
+    if (limit <= 0)
+        limit = -1; // unlimited
+    if ((limit > 0) || (offset > 0))
+        fileIndexes = fileIndexes.mid(offset, limit);
+
+    QList<FileStatesSnapshot::FileState> fileStates;
+    fileStates.reserve(filesCount);
+    for (int i = 0; i < filesCount; ++i)
+        fileStates.append({.path = torrent->filePath(i), .progress = fp[i], .priority = priorities[i], .availability = fileAvailability[i]});
+
+    const auto snapshotIt = m_fileStatesSnapshots.constFind(id);
+    const bool isFullUpdate = !rid || (snapshotIt == m_fileStatesSnapshots.cend())
+            || (snapshotIt->rid != *rid) || (snapshotIt->fileStates.size() != filesCount);
+
+    const int newRid = ++m_fileStatesRid;
+    writer.key(KEY_FILES_RID).value(newRid)
+        .key(KEY_FILES_FULL_UPDATE).value(isFullUpdate)
+        .key(KEY_FILES_TOTAL).value(total)
+        .key(KEY_FILES_IS_SEED).value(torrent->isFinished())
+        .key(KEY_FILES_FILES).beginArray();
+    for (const int index : asConst(fileIndexes))
+    {
+        if (isFullUpdate)
+        {
+            writeFile(writer, torrent, info, index, priorities, fp, fileAvailability);
+            continue;
+        }
+
+        const FileStatesSnapshot::FileState &prevState = snapshotIt->fileStates[index];
+        const FileStatesSnapshot::FileState &fileState = fileStates[index];
+        if ((fileState.progress == prevState.progress) && (fileState.priority == prevState.priority)
+                && (fileState.availability == prevState.availability) && (fileState.path == prevState.path))
+        {
+            continue;
+        }
+
+        writer.beginObject()
+            .key(KEY_FILE_AVAILABILITY).value(fileState.availability)
+            .key(KEY_FILE_INDEX).value(index);
+        if (fileState.path != prevState.path)
+            writer.key(KEY_FILE_NAME).value(fileState.path.data());
+        writer.key(KEY_FILE_PRIORITY).value(static_cast<int>(fileState.priority))
+            .key(KEY_FILE_PROGRESS).value(fileState.progress)
+            .endObject();
+    }
+    writer.endArray().endObject();
+
+    // the snapshot is replaced only after the changes since the previous one are written
+    if ((m_fileStatesSnapshots.size() >= MAX_TORRENT_SNAPSHOTS) && !m_fileStatesSnapshots.contains(id))
+        m_fileStatesSnapshots.clear();
+    m_fileStatesSnapshots.insert(id, {.rid = newRid, .fileStates = fileStates});
+
+    return writer.takeData();
 }
 
 // Returns an array of hashes (of each pieces respectively) for a torrent in JSON format.
 // The return value is a JSON-formatted array of strings (hex strings).
+// With `format=binary` the hashes are returned concatenated as raw bytes,
+// with `format=base64` the same bytes are returned as base64 text.
 void TorrentsController::pieceHashesAction()
 {
     requireParams({u"hash"_s});
@@ -965,14 +1378,30 @@ void TorrentsController::pieceHashesAction()
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
 
-    QJsonArray pieceHashes;
-    if (torrent->hasMetadata())
+    const QString format = params()[u"format"_s];
+    if (!format.isEmpty() && (format != u"json") && (format != u"binary") && (format != u"base64"))
+        throw APIError(APIErrorType::BadParams, tr("'format' parameter is invalid"));
+
+    const QList<QByteArray> hashes = torrent->hasMetadata() ? torrent->info().pieceHashes() : QList<QByteArray>();
+
+    if ((format == u"binary") || (format == u"base64"))
     {
-        const QList<QByteArray> hashes = torrent->info().pieceHashes();
+        QByteArray hashesData;
+        hashesData.reserve(hashes.size() * SHA1Hash::length());
         for (const QByteArray &hash : hashes)
-            pieceHashes.append(QString::fromLatin1(hash.toHex()));
+            hashesData.append(hash);
+
+        if (format == u"binary")
+            setResult(hashesData, Http::CONTENT_TYPE_OCTET_STREAM);
+        else
+            setResult(QString::fromLatin1(hashesData.toBase64()));
+        return;
     }
 
+    QJsonArray pieceHashes;
+    for (const QByteArray &hash : hashes)
+        pieceHashes.append(QString::fromLatin1(hash.toHex()));
+
     setResult(pieceHashes);
 }
 
@@ -981,28 +1410,88 @@ void TorrentsController::pieceHashesAction()
 // 0: piece not downloaded
 // 1: piece requested or downloading
 // 2: piece already downloaded
+// With `format=compact` the return value is a JSON object containing `pieces_count`,
+// `token` and either `states` (base64 of the states packed 4 pieces per byte)
+// or, if `since` matches the token of the previous response, `changes` ([index, state] pairs).
 void TorrentsController::pieceStatesAction()
 {
     requireParams({u"hash"_s});
 
     const auto id = BitTorrent::TorrentID::fromString(params()[u"hash"_s]);
-    BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
+    const BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
     if (!torrent)
         throw APIError(APIErrorType::NotFound);
 
-    QJsonArray pieceStates;
-    const QBitArray states = torrent->pieces();
-    for (qsizetype i = 0; i < states.size(); ++i)
-        pieceStates.append(static_cast<int>(states[i]) * 2);
+    const QString format = params()[u"format"_s];
+    if (!format.isEmpty() && (format != u"json") && (format != u"compact"))
+        throw APIError(APIErrorType::BadParams, tr("'format' parameter is invalid"));
+
+    // downloading pieces are fetched from libtorrent thread, don't block the main thread while waiting for them
+    QFuture<QBitArray> dlstatesFuture = torrent->fetchDownloadingPieces();
 
-    const QBitArray dlstates = torrent->fetchDownloadingPieces().takeResult();
-    for (qsizetype i = 0; i < states.size(); ++i)
+    if (format == u"compact")
     {
-        if (dlstates[i])
-            pieceStates[i] = 1;
+        const std::optional<int> since = parseInt(params()[u"since"_s]);
+
+        setResult(dlstatesFuture.then(this, [this, id, since](const QBitArray &dlstates)
+        {
+            const BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
+            if (!torrent)
+                throw APIError(APIErrorType::NotFound);
+
+            const QBitArray states = torrent->pieces();
+            const auto piecesCount = static_cast<int>(states.size());
+            const QByteArray packedStates = packPieceStates(states, dlstates);
+
+            QJsonObject result {
+                {KEY_PIECE_STATES_COUNT, piecesCount},
+                {KEY_PIECE_STATES_TOKEN, ++m_pieceStatesToken}
+            };
+
+            std::optional<QJsonArray> changes;
+            if (const auto snapshotIter = m_pieceStatesSnapshots.constFind(id); since
+                    && (snapshotIter != m_pieceStatesSnapshots.cend())
+                    && (snapshotIter->token == *since)
+                    && (snapshotIter->piecesCount == piecesCount))
+            {
+                // changes are sent only while they are smaller than the whole packed states
+                changes = getPieceStatesChanges(snapshotIter->states, packedStates, (piecesCount / 32));
+            }
+
+            if (changes)
+                result[KEY_PIECE_STATES_CHANGES] = *changes;
+            else
+                result[KEY_PIECE_STATES_STATES] = QString::fromLatin1(packedStates.toBase64());
+
+            if ((m_pieceStatesSnapshots.size() >= MAX_TORRENT_SNAPSHOTS) && !m_pieceStatesSnapshots.contains(id))
+                m_pieceStatesSnapshots.clear();
+            m_pieceStatesSnapshots.insert(id, {.token = m_pieceStatesToken, .piecesCount = piecesCount, .states = packedStates});
+
+            return result;
+        }));
+        return;
     }
 
-    setResult(pieceStates);
+    setResult(dlstatesFuture.then(this, [id](const QBitArray &dlstates)
+    {
+        const BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
+        if (!torrent)
+            throw APIError(APIErrorType::NotFound);
+
+        const QBitArray states = torrent->pieces();
+
+        QJsonArray pieceStates;
+        for (qsizetype i = 0; i < states.size(); ++i)
+            pieceStates.append(static_cast<int>(states[i]) * 2);
+
+        for (qsizetype i = 0; i < states.size(); ++i)
+        {
+            if (dlstates[i])
+                pieceStates[i] = 1;
+        }
+
+        return pieceStates;
+    }));
 }
 
 void TorrentsController::addAction()
@@ -1176,24 +1665,30 @@ void TorrentsController::addAction()
     }
 
     // process uploaded .torrent files
-    for (auto it = torrents.constBegin(); it != torrents.constEnd(); ++it)
-    {
-        if (const auto loadResult = BitTorrent::TorrentDescriptor::load(it.value()))
+    const QList<QFuture<BitTorrent::TorrentDescriptor>> loadResults = loadTorrents(torrents.values());
+    QSet<BitTorrent::TorrentID> uploadedTorrentIDs;
+    uploadedTorrentIDs.reserve(loadResults.size());
+    auto torrentsIter = torrents.constBegin();
+    for (QFuture<BitTorrent::TorrentDescriptor> loadResult : loadResults)
+    {
+        loadResult.waitForFinished();
+        if (loadResult.resultCount() == 0)
+            throw APIError(APIErrorType::BadData, tr("Error: '%1' is not a valid torrent file.").arg(torrentsIter.key()));
+
+        const BitTorrent::TorrentDescriptor torrentDescr = loadResult.result();
+        const BitTorrent::TorrentID torrentID = torrentDescr.infoHash().toTorrentID();
+        // the session doesn't know the torrents of this request until they are added
+        if (!uploadedTorrentIDs.contains(torrentID) && BitTorrent::Session::instance()->addTorrent(torrentDescr, addTorrentParams))
         {
-            const BitTorrent::TorrentDescriptor &torrentDescr = loadResult.value();
-            if (BitTorrent::Session::instance()->addTorrent(torrentDescr, addTorrentParams))
-            {
-                addedTorrentIDs.append(torrentDescr.infoHash().toTorrentID());
-            }
-            else
-            {
-                ++failure;
-            }
+            uploadedTorrentIDs.insert(torrentID);
+            addedTorrentIDs.append(torrentID);
         }
         else
         {
-            throw APIError(APIErrorType::BadData, tr("Error: '%1' is not a valid torrent file.").arg(it.key()));
+            ++failure;
         }
+
+        ++torrentsIter;
     }
 
     if (!addedTorrentIDs.isEmpty() || (pending > 0))
@@ -1372,6 +1867,46 @@ void TorrentsController::stopAction()
     setResult(QString());
 }
 
+// Sends the content of the file while it is downloaded
+// The "Range" header is supported, so media players are able to seek in the file
+// Pieces needed next are downloaded with priority
+// GET params:
+//   - hash (string): torrent hash (ID)
+//   - id (int): file index
+void TorrentsController::streamFileAction()
+{
+    const auto [torrent, fileIndex] = requestedTorrentFile();
+    // pieces of the ignored files may be kept in the part file only
+    if (torrent->filePriorities().at(fileIndex) == BitTorrent::DownloadPriority::Ignored)
+        throw APIError(APIErrorType::Conflict, tr("File is not downloaded"));
+
+    const Http::ByteRange range = requestedContentRange(torrent->fileSize(fileIndex));
+    const QString mimeType = QMimeDatabase().mimeTypeForFile(torrent->filePath(fileIndex).data(), QMimeDatabase::MatchExtension).name();
+    setResult(new TorrentFileProducer(torrent, fileIndex, range.first, (range.last - range.first + 1)), mimeType);
+}
+
+// Sends the content of the completed file from disk as attachment
+// The "Range" header is supported, so the download can be resumed
+// The sending rate is limited by the global upload speed limit of the session
+// GET params:
+//   - hash (string): torrent hash (ID)
+//   - id (int): file index
+void TorrentsController::downloadFileAction()
+{
+    const auto [torrent, fileIndex] = requestedTorrentFile();
+    if (torrent->filesProgress().at(fileIndex) < 1)
+        throw APIError(APIErrorType::Conflict, tr("File is not completed"));
+
+    const Http::ByteRange range = requestedContentRange(torrent->fileSize(fileIndex));
+    const Path filePath = torrent->actualStorageLocation() / torrent->actualFilePath(fileIndex);
+    const qint64 size = range.last - range.first + 1;
+    setHeader(Http::HEADER_CONTENT_DISPOSITION, u"attachment; filename=\"%1\""_s.arg(torrent->filePath(fileIndex).filename()));
+    setResult(new FileContentProducer(filePath, range.first, size, []
+    {
+        return BitTorrent::Session::instance()->uploadSpeedLimit();
+    }), Http::CONTENT_TYPE_OCTET_STREAM);
+}
+
 void TorrentsController::startAction()
 {
     requireParams({u"hashes"_s});
@@ -1829,6 +2364,9 @@ void TorrentsController::createCategoryAction()
         const Path downloadPath {params()[u"downloadPath"_s]};
         categoryOptions.downloadPath = {useDownloadPath.value(), downloadPath};
     }
+    categoryOptions.downloadLimit = std::max(0, parseInt(params()[u"downloadLimit"_s]).value_or(0));
+    categoryOptions.uploadLimit = std::max(0, parseInt(params()[u"uploadLimit"_s]).value_or(0));
+    categoryOptions.connectionsLimit = std::max(0, parseInt(params()[u"connectionsLimit"_s]).value_or(0));
 
     if (!BitTorrent::Session::instance()->addCategory(category, categoryOptions))
         throw APIError(APIErrorType::Conflict, tr("Unable to create category"));
@@ -1853,6 +2391,11 @@ void TorrentsController::editCategoryAction()
         const Path downloadPath {params()[u"downloadPath"_s]};
         categoryOptions.downloadPath = {useDownloadPath.value(), downloadPath};
     }
+    // limits which aren't specified are left unchanged
+    const BitTorrent::CategoryOptions currentOptions = BitTorrent::Session::instance()->categoryOptions(category);
+    categoryOptions.downloadLimit = std::max(0, parseInt(params()[u"downloadLimit"_s]).value_or(currentOptions.downloadLimit));
+    categoryOptions.uploadLimit = std::max(0, parseInt(params()[u"uploadLimit"_s]).value_or(currentOptions.uploadLimit));
+    categoryOptions.connectionsLimit = std::max(0, parseInt(params()[u"connectionsLimit"_s]).value_or(currentOptions.connectionsLimit));
 
     if (!BitTorrent::Session::instance()->editCategory(category, categoryOptions))
         throw APIError(APIErrorType::Conflict, tr("Unable to edit category"));
@@ -2168,7 +2711,7 @@ void TorrentsController::fetchMetadataAction()
             else
             {
                 const auto *pref = Preferences::instance();
-                Net::DownloadManager::instance()->download(Net::DownloadRequest(source).limit(pref->getTorrentFileSizeLimit())
+                Net::DownloadManager::instance()->download(Net::DownloadRequest(source).limit(pref->getTorrentFileSizeLimit()).priority(Net::DownloadPriority::High)
                         , pref->useProxyForGeneralPurposes(), this, &TorrentsController::onDownloadFinished);
 
             }
@@ -2338,3 +2881,42 @@ void TorrentsController::cacheMagnetURI(const QString &source, const BitTorrent:
             m_torrentMetadataCache.insert(torrentID, torrentDescr);
     }
 }
+
+std::pair<BitTorrent::Torrent *, int> TorrentsController::requestedTorrentFile() const
+{
+    requireParams({u"hash"_s, u"id"_s});
+
+    const auto id = BitTorrent::TorrentID::fromString(params()[u"hash"_s]);
+    BitTorrent::Torrent *const torrent = BitTorrent::Session::instance()->getTorrent(id);
+    if (!torrent)
+        throw APIError(APIErrorType::NotFound);
+    if (!torrent->hasMetadata())
+        throw APIError(APIErrorType::Conflict, tr("Torrent's metadata has not yet downloaded"));
+
+    bool ok = false;
+    const int fileIndex = params()[u"id"_s].toInt(&ok);
+    if (!ok)
+        throw APIError(APIErrorType::BadParams, tr("File IDs must be integers"));
+    if ((fileIndex < 0) || (fileIndex >= torrent->filesCount()))
+        throw APIError(APIErrorType::Conflict, tr("File ID is not valid"));
+
+    return {torrent, fileIndex};
+}
+
+Http::ByteRange TorrentsController::requestedContentRange(const qint64 contentSize)
+{
+    setHeader(Http::HEADER_ACCEPT_RANGES, u"bytes"_s);
+
+    const QString rangeValue = headers().value(Http::HEADER_RANGE);
+    if (rangeValue.isEmpty())
+        return {.first = 0, .last = (contentSize - 1)};
+
+    const std::optional<Http::ByteRange> range = Http::parseByteRange(rangeValue, contentSize);
+    if (!range)
+        throw APIError(APIErrorType::RangeNotSatisfiable, tr("Only a single range within the file can be requested"));
+
+    setStatus(APIStatus::PartialContent);
+    setHeader(Http::HEADER_CONTENT_RANGE, u"bytes %1-%2/%3"_s.arg(QString::number(range->first)
+            , QString::number(range->last), QString::number(contentSize)));
+    return *range;
+}
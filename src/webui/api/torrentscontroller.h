@@ -28,17 +28,25 @@
 
 #pragma once
 
+#include <optional>
+#include <utility>
+
+#include <QByteArray>
 #include <QHash>
+#include <QJsonObject>
+#include <QList>
 #include <QSet>
 
+#include "base/bittorrent/downloadpriority.h"
 #include "base/bittorrent/torrentdescriptor.h"
+#include "base/http/responsegenerator.h"
+#include "base/path.h"
 #include "apicontroller.h"
 
-class QByteArray;
-
 namespace BitTorrent
 {
     class InfoHash;
+    class Torrent;
     class TorrentID;
     class TorrentInfo;
 }
@@ -48,19 +56,25 @@ namespace Net
     struct DownloadResult;
 }
 
+class TorrentJsonCache;
+
 class TorrentsController : public APIController
 {
     Q_OBJECT
     Q_DISABLE_COPY_MOVE(TorrentsController)
 
 public:
-    explicit TorrentsController(IApplication *app, QObject *parent = nullptr);
+    TorrentsController(TorrentJsonCache *torrentJsonCache, IApplication *app, QObject *parent = nullptr);
+
+    // The snapshots are rebuilt (with full update) when requested again
+    void releaseIdleData();
 
 private slots:
     void countAction();
     void infoAction();
     void propertiesAction();
     void trackersAction();
+    void trackerFaviconAction();
     void webseedsAction();
     void addWebSeedsAction();
     void editWebSeedAction();
@@ -68,6 +82,8 @@ private slots:
     void filesAction();
     void pieceHashesAction();
     void pieceStatesAction();
+    void streamFileAction();
+    void downloadFileAction();
     void startAction();
     void stopAction();
     void recheckAction();
@@ -124,8 +140,40 @@ private:
     void onSearchPluginTorrentDownloaded(const QString &source, const QString &data);
     void cacheTorrentFile(const QString &source, const QByteArray &data);
     void cacheMagnetURI(const QString &source, const BitTorrent::TorrentDescriptor &torrentDescr);
+    QByteArray serializeFileList(const BitTorrent::Torrent *torrent, QList<int> fileIndexes, const QList<qreal> &fileAvailability
+            , const std::optional<QString> &folderPath, int offset, int limit, std::optional<int> rid);
+    // Returns the torrent and the index of the file given by "hash" and "id" params
+    std::pair<BitTorrent::Torrent *, int> requestedTorrentFile() const;
+    // Returns the bytes requested by "Range" header and sets the headers of the partial response
+    Http::ByteRange requestedContentRange(qint64 contentSize);
+
+    struct PieceStatesSnapshot
+    {
+        int token = 0;
+        int piecesCount = 0;
+        QByteArray states;
+    };
+
+    struct FileStatesSnapshot
+    {
+        struct FileState
+        {
+            Path path;
+            qreal progress = 0;
+            BitTorrent::DownloadPriority priority = BitTorrent::DownloadPriority::Normal;
+            qreal availability = 0;
+        };
+
+        int rid = 0;
+        QList<FileState> fileStates;
+    };
 
+    TorrentJsonCache *m_torrentJsonCache = nullptr;
     QHash<QString, BitTorrent::InfoHash> m_torrentSourceCache;
     QHash<BitTorrent::TorrentID, BitTorrent::TorrentDescriptor> m_torrentMetadataCache;
     QSet<QString> m_requestedTorrentSource;
+    QHash<BitTorrent::TorrentID, PieceStatesSnapshot> m_pieceStatesSnapshots;
+    int m_pieceStatesToken = 0;
+    QHash<BitTorrent::TorrentID, FileStatesSnapshot> m_fileStatesSnapshots;
+    int m_fileStatesRid = 0;
 };
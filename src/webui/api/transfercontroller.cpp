@@ -28,16 +28,28 @@
 
 #include "transfercontroller.h"
 
+#include <algorithm>
+
+#include <QHash>
+#include <QJsonArray>
 #include <QJsonObject>
 #include <QList>
 
+#include "base/bittorrent/alertstatistics.h"
+#include "base/bittorrent/diskiostatistics.h"
+#include "base/bittorrent/movestoragejobinfo.h"
 #include "base/bittorrent/peeraddress.h"
 #include "base/bittorrent/peerinfo.h"
+#include "base/bittorrent/peerstatistics.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/sessionstatus.h"
+#include "base/bittorrent/torrentcontentremovingjobinfo.h"
 #include "base/global.h"
+#include "base/speedhistory.h"
 #include "base/utils/string.h"
 #include "apierror.h"
+#include "serialize/serialize_diskiostatistics.h"
+#include "serialize/serialize_peerstatistics.h"
 
 const QString KEY_TRANSFER_DLSPEED = u"dl_info_speed"_s;
 const QString KEY_TRANSFER_DLDATA = u"dl_info_data"_s;
@@ -49,6 +61,108 @@ const QString KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V4 = u"last_external_address_v4
 const QString KEY_TRANSFER_LAST_EXTERNAL_ADDRESS_V6 = u"last_external_address_v6"_s;
 const QString KEY_TRANSFER_DHT_NODES = u"dht_nodes"_s;
 const QString KEY_TRANSFER_CONNECTION_STATUS = u"connection_status"_s;
+const QString KEY_TRANSFER_CHECKING_TORRENTS = u"checking_torrents"_s;
+const QString KEY_TRANSFER_CHECKING_SPEED = u"checking_speed"_s;
+const QString KEY_TRANSFER_CHECKING_REMAINING = u"checking_remaining"_s;
+const QString KEY_TRANSFER_CHECKING_ETA = u"checking_eta"_s;
+
+const QString KEY_ALERTS_COUNT = u"alert_count"_s;
+const QString KEY_ALERTS_BATCH_COUNT = u"batch_count"_s;
+const QString KEY_ALERTS_MAX_BATCH_SIZE = u"max_batch_size"_s;
+const QString KEY_ALERTS_BATCH_SIZE_HISTOGRAM = u"batch_size_histogram"_s;
+const QString KEY_ALERTS_BATCH_SIZE_HISTOGRAM_BOUNDS = u"batch_size_histogram_bounds"_s;
+const QString KEY_ALERTS_TOTAL_STALL_TIME = u"total_stall_time"_s;
+const QString KEY_ALERTS_MAX_STALL_TIME = u"max_stall_time"_s;
+const QString KEY_ALERTS_STALL_TIME_HISTOGRAM = u"stall_time_histogram"_s;
+const QString KEY_ALERTS_TIME_HISTOGRAM_BOUNDS = u"time_histogram_bounds"_s;
+const QString KEY_ALERTS_DROPPED_COUNT = u"dropped_count"_s;
+const QString KEY_ALERTS_TYPES = u"types"_s;
+const QString KEY_ALERT_TYPE_NAME = u"name"_s;
+const QString KEY_ALERT_TYPE_COUNT = u"count"_s;
+const QString KEY_ALERT_TYPE_TOTAL_TIME = u"total_time"_s;
+const QString KEY_ALERT_TYPE_MAX_TIME = u"max_time"_s;
+const QString KEY_ALERT_TYPE_TIME_HISTOGRAM = u"time_histogram"_s;
+
+const QString KEY_DISK_IO_VOLUMES = u"volumes"_s;
+const QString KEY_DISK_IO_LATENCY_HISTOGRAM_BOUNDS = u"latency_histogram_bounds"_s;
+
+const QString KEY_SPEED_HISTORY_TIMESTAMP = u"t"_s;
+const QString KEY_SPEED_HISTORY_UPLOAD = u"up"_s;
+const QString KEY_SPEED_HISTORY_DOWNLOAD = u"dl"_s;
+const QString KEY_SPEED_HISTORY_PAYLOAD_UPLOAD = u"payload_up"_s;
+const QString KEY_SPEED_HISTORY_PAYLOAD_DOWNLOAD = u"payload_dl"_s;
+const QString KEY_SPEED_HISTORY_OVERHEAD_UPLOAD = u"overhead_up"_s;
+const QString KEY_SPEED_HISTORY_OVERHEAD_DOWNLOAD = u"overhead_dl"_s;
+const QString KEY_SPEED_HISTORY_DHT_UPLOAD = u"dht_up"_s;
+const QString KEY_SPEED_HISTORY_DHT_DOWNLOAD = u"dht_dl"_s;
+const QString KEY_SPEED_HISTORY_TRACKER_UPLOAD = u"tracker_up"_s;
+const QString KEY_SPEED_HISTORY_TRACKER_DOWNLOAD = u"tracker_dl"_s;
+
+const QString KEY_MOVE_STORAGE_JOB_HASH = u"hash"_s;
+const QString KEY_MOVE_STORAGE_JOB_SOURCE_PATH = u"source_path"_s;
+const QString KEY_MOVE_STORAGE_JOB_DESTINATION_PATH = u"destination_path"_s;
+const QString KEY_MOVE_STORAGE_JOB_SOURCE_VOLUME = u"source_volume"_s;
+const QString KEY_MOVE_STORAGE_JOB_DESTINATION_VOLUME = u"destination_volume"_s;
+const QString KEY_MOVE_STORAGE_JOB_STATE = u"state"_s;
+const QString KEY_MOVE_STORAGE_JOB_SIZE = u"size"_s;
+const QString KEY_MOVE_STORAGE_JOB_MOVED_SIZE = u"moved_size"_s;
+const QString KEY_MOVE_STORAGE_JOB_ELAPSED_TIME = u"elapsed_time"_s;
+const QString KEY_MOVE_STORAGE_JOB_THROUGHPUT = u"throughput"_s;
+
+const QString KEY_CONTENT_REMOVING_JOB_HASH = u"hash"_s;
+const QString KEY_CONTENT_REMOVING_JOB_NAME = u"name"_s;
+const QString KEY_CONTENT_REMOVING_JOB_PATH = u"path"_s;
+const QString KEY_CONTENT_REMOVING_JOB_OPTION = u"option"_s;
+const QString KEY_CONTENT_REMOVING_JOB_STATE = u"state"_s;
+const QString KEY_CONTENT_REMOVING_JOB_REMOVED_FILES = u"removed_files"_s;
+const QString KEY_CONTENT_REMOVING_JOB_TOTAL_FILES = u"total_files"_s;
+
+namespace
+{
+    template <typename T>
+    QJsonArray toJsonArray(const T &values)
+    {
+        QJsonArray array;
+        for (const qint64 value : values)
+            array.append(value);
+        return array;
+    }
+
+    QJsonArray toJsonArray(const SpeedHistory::Value &value)
+    {
+        return {static_cast<qint64>(value.min), static_cast<qint64>(value.avg), static_cast<qint64>(value.max)};
+    }
+
+    QString toString(const BitTorrent::MoveStorageJobState state)
+    {
+        switch (state)
+        {
+        case BitTorrent::MoveStorageJobState::Queued:
+            return u"queued"_s;
+        case BitTorrent::MoveStorageJobState::Moving:
+            return u"moving"_s;
+        case BitTorrent::MoveStorageJobState::Finished:
+            return u"finished"_s;
+        case BitTorrent::MoveStorageJobState::Failed:
+            return u"failed"_s;
+        }
+
+        return {};
+    }
+
+    QString toString(const BitTorrent::TorrentContentRemovingJobState state)
+    {
+        switch (state)
+        {
+        case BitTorrent::TorrentContentRemovingJobState::Queued:
+            return u"queued"_s;
+        case BitTorrent::TorrentContentRemovingJobState::Removing:
+            return u"removing"_s;
+        }
+
+        return {};
+    }
+}
 
 // Returns the global transfer information in JSON format.
 // The return value is a JSON-formatted dictionary.
@@ -63,6 +177,10 @@ const QString KEY_TRANSFER_CONNECTION_STATUS = u"connection_status"_s;
 //   - "last_external_address_v6": external IPv6 address
 //   - "dht_nodes": DHT nodes connected to
 //   - "connection_status": Connection status
+//   - "checking_torrents": Number of torrents being checked
+//   - "checking_speed": Aggregate checking rate
+//   - "checking_remaining": Amount of data left to check
+//   - "checking_eta": Estimated time until all the torrents are checked
 void TransferController::infoAction()
 {
     const auto *btSession = BitTorrent::Session::instance();
@@ -83,10 +201,98 @@ void TransferController::infoAction()
         dict[KEY_TRANSFER_CONNECTION_STATUS] = u"disconnected"_s;
     else
         dict[KEY_TRANSFER_CONNECTION_STATUS] = sessionStatus.hasIncomingConnections ? u"connected"_s : u"firewalled"_s;
+    dict[KEY_TRANSFER_CHECKING_TORRENTS] = static_cast<qint64>(sessionStatus.checkingTorrentsCount);
+    dict[KEY_TRANSFER_CHECKING_SPEED] = static_cast<qint64>(sessionStatus.checkingRate);
+    dict[KEY_TRANSFER_CHECKING_REMAINING] = static_cast<qint64>(sessionStatus.checkingRemaining);
+    dict[KEY_TRANSFER_CHECKING_ETA] = static_cast<qint64>(sessionStatus.checkingETA);
 
     setResult(dict);
 }
 
+// Returns the statistics of libtorrent alerts handling in JSON format.
+// All times are in microseconds. Histograms contain the number of values
+// that are less than or equal to the corresponding bound, the last bucket
+// counts the values greater than all the bounds.
+// The dictionary keys are:
+//   - "alert_count": Number of handled alerts
+//   - "batch_count": Number of handled alert batches
+//   - "max_batch_size": Maximum number of alerts in a batch
+//   - "batch_size_histogram": Histogram of batch sizes
+//   - "batch_size_histogram_bounds": Bounds of "batch_size_histogram" buckets
+//   - "total_stall_time": Total time the main thread spent handling alert batches
+//   - "max_stall_time": Maximum time the main thread spent handling alert batch
+//   - "stall_time_histogram": Histogram of batch handling times
+//   - "time_histogram_bounds": Bounds of time histograms buckets
+//   - "dropped_count": Number of times the alerts were dropped due to full alert queue
+//   - "types": List of received alert types sorted by total handling time (slowest first):
+//     - "name": Alert type name
+//     - "count": Number of handled alerts of this type
+//     - "total_time": Total handling time
+//     - "max_time": Maximum handling time
+//     - "time_histogram": Histogram of handling times
+void TransferController::alertStatisticsAction()
+{
+    const BitTorrent::AlertStatistics &stats = BitTorrent::Session::instance()->alertStatistics();
+
+    QList<const BitTorrent::AlertTypeStatistics *> alertTypes;
+    for (const BitTorrent::AlertTypeStatistics &alertTypeStats : stats.alertTypes)
+    {
+        if (alertTypeStats.count > 0)
+            alertTypes.append(&alertTypeStats);
+    }
+    std::ranges::sort(alertTypes, std::ranges::greater(), &BitTorrent::AlertTypeStatistics::totalTime);
+
+    QJsonArray alertTypesArray;
+    for (const BitTorrent::AlertTypeStatistics *alertTypeStats : asConst(alertTypes))
+    {
+        alertTypesArray.append(QJsonObject {
+            {KEY_ALERT_TYPE_NAME, alertTypeStats->name},
+            {KEY_ALERT_TYPE_COUNT, alertTypeStats->count},
+            {KEY_ALERT_TYPE_TOTAL_TIME, alertTypeStats->totalTime},
+            {KEY_ALERT_TYPE_MAX_TIME, alertTypeStats->maxTime},
+            {KEY_ALERT_TYPE_TIME_HISTOGRAM, toJsonArray(alertTypeStats->timeHistogram)}
+        });
+    }
+
+    setResult(QJsonObject {
+        {KEY_ALERTS_COUNT, stats.alertCount},
+        {KEY_ALERTS_BATCH_COUNT, stats.batchCount},
+        {KEY_ALERTS_MAX_BATCH_SIZE, stats.maxBatchSize},
+        {KEY_ALERTS_BATCH_SIZE_HISTOGRAM, toJsonArray(stats.batchSizeHistogram)},
+        {KEY_ALERTS_BATCH_SIZE_HISTOGRAM_BOUNDS, toJsonArray(BitTorrent::ALERT_BATCH_SIZE_HISTOGRAM_BOUNDS)},
+        {KEY_ALERTS_TOTAL_STALL_TIME, stats.totalStallTime},
+        {KEY_ALERTS_MAX_STALL_TIME, stats.maxStallTime},
+        {KEY_ALERTS_STALL_TIME_HISTOGRAM, toJsonArray(stats.stallTimeHistogram)},
+        {KEY_ALERTS_TIME_HISTOGRAM_BOUNDS, toJsonArray(BitTorrent::ALERT_TIME_HISTOGRAM_BOUNDS)},
+        {KEY_ALERTS_DROPPED_COUNT, stats.droppedAlertsCount},
+        {KEY_ALERTS_TYPES, alertTypesArray}
+    });
+}
+
+void TransferController::diskIOStatisticsAction()
+{
+    const QHash<QString, BitTorrent::DiskIOStatistics> volumeStats = BitTorrent::Session::instance()->volumeDiskIOStatistics();
+
+    QJsonObject volumes;
+    for (auto iter = volumeStats.cbegin(); iter != volumeStats.cend(); ++iter)
+        volumes[iter.key()] = serialize(iter.value());
+
+    setResult(QJsonObject {
+        {KEY_DISK_IO_VOLUMES, volumes},
+        {KEY_DISK_IO_LATENCY_HISTOGRAM_BOUNDS, toJsonArray(BitTorrent::DISK_IO_LATENCY_HISTOGRAM_BOUNDS)}
+    });
+}
+
+// Returns the payload exchanged with the peers of all the torrents in JSON format.
+// The dictionary keys are:
+//   - "clients": Statistics by the client code from the peer ID (e.g. "qB"), "" is for unknown clients
+//   - "countries": Statistics by the country code, "" is for unknown countries
+// Each statistics object contains "downloaded" and "uploaded" bytes and the number of "connections".
+void TransferController::peerStatisticsAction()
+{
+    setResult(serialize(BitTorrent::Session::instance()->peerStatistics()));
+}
+
 void TransferController::uploadLimitAction()
 {
     setResult(QString::number(BitTorrent::Session::instance()->uploadSpeedLimit()));
@@ -160,3 +366,123 @@ void TransferController::banPeersAction()
 
     setResult(QString());
 }
+
+// Returns the history of global transfer rates in JSON format.
+// Params:
+//   - "resolution": Bucket interval, one of "second", "minute" (default) or "hour"
+//   - "since": Only return the buckets starting at or after this time (Unix timestamp in seconds)
+// The return value is a JSON-formatted list of buckets in chronological order,
+// the last one is still being accumulated. The bucket keys are:
+//   - "t": Start of the bucket interval (Unix timestamp in seconds)
+//   - "up", "dl": Total upload and download rates
+//   - "payload_up", "payload_dl": Payload upload and download rates
+//   - "overhead_up", "overhead_dl": Overhead upload and download rates
+//   - "dht_up", "dht_dl": DHT upload and download rates
+//   - "tracker_up", "tracker_dl": Tracker upload and download rates
+// Each rate is a list of minimum, average and maximum value during the bucket interval.
+void TransferController::speedHistoryAction()
+{
+    const QString resolutionParam = params()[u"resolution"_s];
+    SpeedHistory::Resolution resolution = SpeedHistory::Resolution::Minute;
+    if (resolutionParam == u"second")
+        resolution = SpeedHistory::Resolution::Second;
+    else if (resolutionParam == u"hour")
+        resolution = SpeedHistory::Resolution::Hour;
+    else if (!resolutionParam.isEmpty() && (resolutionParam != u"minute"))
+        throw APIError(APIErrorType::BadParams, tr("'resolution': invalid argument"));
+
+    qint64 since = 0;
+    if (const QString sinceParam = params()[u"since"_s]; !sinceParam.isEmpty())
+    {
+        bool ok = false;
+        since = sinceParam.toLongLong(&ok);
+        if (!ok)
+            throw APIError(APIErrorType::BadParams, tr("'since': invalid argument"));
+    }
+
+    const QList<SpeedHistory::Bucket> buckets = SpeedHistory::instance()->buckets(resolution, since);
+
+    QJsonArray result;
+    for (const SpeedHistory::Bucket &bucket : buckets)
+    {
+        result.append(QJsonObject {
+            {KEY_SPEED_HISTORY_TIMESTAMP, bucket.timestamp},
+            {KEY_SPEED_HISTORY_UPLOAD, toJsonArray(bucket.values[SpeedHistory::Upload])},
+            {KEY_SPEED_HISTORY_DOWNLOAD, toJsonArray(bucket.values[SpeedHistory::Download])},
+            {KEY_SPEED_HISTORY_PAYLOAD_UPLOAD, toJsonArray(bucket.values[SpeedHistory::PayloadUpload])},
+            {KEY_SPEED_HISTORY_PAYLOAD_DOWNLOAD, toJsonArray(bucket.values[SpeedHistory::PayloadDownload])},
+            {KEY_SPEED_HISTORY_OVERHEAD_UPLOAD, toJsonArray(bucket.values[SpeedHistory::OverheadUpload])},
+            {KEY_SPEED_HISTORY_OVERHEAD_DOWNLOAD, toJsonArray(bucket.values[SpeedHistory::OverheadDownload])},
+            {KEY_SPEED_HISTORY_DHT_UPLOAD, toJsonArray(bucket.values[SpeedHistory::DHTUpload])},
+            {KEY_SPEED_HISTORY_DHT_DOWNLOAD, toJsonArray(bucket.values[SpeedHistory::DHTDownload])},
+            {KEY_SPEED_HISTORY_TRACKER_UPLOAD, toJsonArray(bucket.values[SpeedHistory::TrackerUpload])},
+            {KEY_SPEED_HISTORY_TRACKER_DOWNLOAD, toJsonArray(bucket.values[SpeedHistory::TrackerDownload])}
+        });
+    }
+
+    setResult(result);
+}
+
+// Returns the storage move jobs in JSON format.
+// The return value is a JSON-formatted list of the recently finished jobs
+// followed by the ongoing and queued ones in queue order. The job keys are:
+//   - "hash": Torrent hash
+//   - "source_path", "destination_path": Locations the torrent is moved between
+//   - "source_volume", "destination_volume": Storage devices holding these locations
+//   - "state": One of "queued", "moving", "finished" or "failed"
+//   - "size": Size of the torrent content
+//   - "moved_size": Amount of data copied so far while moving to another storage device
+//   - "elapsed_time": Time spent moving in milliseconds
+//   - "throughput": Average rate in bytes per second (0 until the job is finished unless the data is being copied)
+void TransferController::storageMoveJobsAction()
+{
+    const QList<BitTorrent::MoveStorageJobInfo> jobs = BitTorrent::Session::instance()->moveStorageJobs();
+
+    QJsonArray result;
+    for (const BitTorrent::MoveStorageJobInfo &job : jobs)
+    {
+        result.append(QJsonObject {
+            {KEY_MOVE_STORAGE_JOB_HASH, job.torrentID.toString()},
+            {KEY_MOVE_STORAGE_JOB_SOURCE_PATH, job.sourcePath.toString()},
+            {KEY_MOVE_STORAGE_JOB_DESTINATION_PATH, job.destinationPath.toString()},
+            {KEY_MOVE_STORAGE_JOB_SOURCE_VOLUME, job.sourceVolume},
+            {KEY_MOVE_STORAGE_JOB_DESTINATION_VOLUME, job.destinationVolume},
+            {KEY_MOVE_STORAGE_JOB_STATE, toString(job.state)},
+            {KEY_MOVE_STORAGE_JOB_SIZE, job.size},
+            {KEY_MOVE_STORAGE_JOB_MOVED_SIZE, job.movedSize},
+            {KEY_MOVE_STORAGE_JOB_ELAPSED_TIME, job.elapsedTime},
+            {KEY_MOVE_STORAGE_JOB_THROUGHPUT, job.throughput}
+        });
+    }
+
+    setResult(result);
+}
+
+// Returns the content removing jobs of the removed torrents in JSON format.
+// The return value is a JSON-formatted list of the jobs in queue order. The job keys are:
+//   - "hash": Torrent hash
+//   - "name": Torrent name
+//   - "path": Location the content is removed from
+//   - "option": Torrent content removing mode
+//   - "state": One of "queued" or "removing"
+//   - "removed_files", "total_files": Progress of the job
+void TransferController::contentRemovingJobsAction()
+{
+    const QList<BitTorrent::TorrentContentRemovingJobInfo> jobs = BitTorrent::Session::instance()->torrentContentRemovingJobs();
+
+    QJsonArray result;
+    for (const BitTorrent::TorrentContentRemovingJobInfo &job : jobs)
+    {
+        result.append(QJsonObject {
+            {KEY_CONTENT_REMOVING_JOB_HASH, job.torrentID.toString()},
+            {KEY_CONTENT_REMOVING_JOB_NAME, job.name},
+            {KEY_CONTENT_REMOVING_JOB_PATH, job.path.toString()},
+            {KEY_CONTENT_REMOVING_JOB_OPTION, Utils::String::fromEnum(job.option)},
+            {KEY_CONTENT_REMOVING_JOB_STATE, toString(job.state)},
+            {KEY_CONTENT_REMOVING_JOB_REMOVED_FILES, job.removedFiles},
+            {KEY_CONTENT_REMOVING_JOB_TOTAL_FILES, job.totalFiles}
+        });
+    }
+
+    setResult(result);
+}
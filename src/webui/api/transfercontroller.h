@@ -40,6 +40,9 @@ public:
 
 private slots:
     void infoAction();
+    void alertStatisticsAction();
+    void diskIOStatisticsAction();
+    void peerStatisticsAction();
     void speedLimitsModeAction();
     void setSpeedLimitsModeAction();
     void toggleSpeedLimitsModeAction();
@@ -48,4 +51,7 @@ private slots:
     void setUploadLimitAction();
     void setDownloadLimitAction();
     void banPeersAction();
+    void speedHistoryAction();
+    void storageMoveJobsAction();
+    void contentRemovingJobsAction();
 };
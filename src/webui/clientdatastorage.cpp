@@ -28,26 +28,81 @@
 
 #include "clientdatastorage.h"
 
+#include <algorithm>
+#include <chrono>
+
 #include <QJsonDocument>
 #include <QJsonObject>
+#include <QThread>
+#include <QTimer>
 
+#include "base/asyncfilestorage.h"
 #include "base/global.h"
 #include "base/logger.h"
 #include "base/path.h"
 #include "base/profile.h"
 #include "base/utils/io.h"
 
+using namespace std::chrono_literals;
+
 const int CLIENT_DATA_FILE_MAX_SIZE = 1024 * 1024; // 1 MiB
 const QString CLIENT_DATA_FILE_NAME = u"web_clientdata.json"_s;
+const std::chrono::seconds STORING_DELAY = 2s;
+
+namespace
+{
+    // The size of `"key":value` as it appears in the compact JSON representation of the whole object
+    qsizetype entrySize(const QString &key, const QJsonValue &value)
+    {
+        return QJsonDocument(QJsonObject {{key, value}}).toJson(QJsonDocument::Compact).size() - 2;
+    }
+
+    qsizetype dataSize(const qsizetype entriesSize, const qsizetype entryCount)
+    {
+        // braces and separating commas
+        return 2 + entriesSize + std::max<qsizetype>((entryCount - 1), 0);
+    }
+}
 
 ClientDataStorage::ClientDataStorage(QObject *parent)
     : QObject(parent)
-    , m_clientDataFilePath(specialFolderLocation(SpecialFolder::Data) / Path(CLIENT_DATA_FILE_NAME))
+    , m_ioThread {new QThread}
+    , m_fileStorage {new AsyncFileStorage(specialFolderLocation(SpecialFolder::Data))}
+    , m_storingTimer {new QTimer(this)}
 {
-    if (!m_clientDataFilePath.exists())
+    m_storingTimer->setSingleShot(true);
+    m_storingTimer->setInterval(STORING_DELAY);
+    connect(m_storingTimer, &QTimer::timeout, this, &ClientDataStorage::store);
+
+    m_fileStorage->moveToThread(m_ioThread.get());
+    connect(m_ioThread.get(), &QThread::finished, m_fileStorage, &QObject::deleteLater);
+    connect(m_fileStorage, &AsyncFileStorage::failed, this, [](const Path &filePath, const QString &errorString)
+    {
+        LogMsg(tr("Failed to save web client data. File: \"%1\". Error: \"%2\"")
+            .arg(filePath.toString(), errorString), Log::WARNING);
+    });
+
+    m_ioThread->setObjectName("ClientDataStorage m_ioThread");
+    Utils::Thread::setWorkload(m_ioThread.get(), Utils::Thread::Workload::Bulk);
+    m_ioThread->start();
+
+    load();
+}
+
+ClientDataStorage::~ClientDataStorage()
+{
+    // it is written by IO thread which is stopped after all the other jobs are processed
+    if (m_storingTimer->isActive())
+        store();
+}
+
+void ClientDataStorage::load()
+{
+    const Path clientDataFilePath = m_fileStorage->storageDir() / Path(CLIENT_DATA_FILE_NAME);
+    if (!clientDataFilePath.exists())
         return;
 
-    const auto readResult = Utils::IO::readFile(m_clientDataFilePath, CLIENT_DATA_FILE_MAX_SIZE);
+    const auto readResult = Utils::IO::readFile(clientDataFilePath, CLIENT_DATA_FILE_MAX_SIZE);
     if (!readResult)
     {
         LogMsg(tr("Failed to load web client data. %1").arg(readResult.error().message), Log::WARNING);
@@ -59,65 +114,88 @@ ClientDataStorage::ClientDataStorage(QObject *parent)
     if (jsonError.error != QJsonParseError::NoError)
     {
         LogMsg(tr("Failed to parse web client data. File: \"%1\". Error: \"%2\"")
-            .arg(m_clientDataFilePath.toString(), jsonError.errorString()), Log::WARNING);
+            .arg(clientDataFilePath.toString(), jsonError.errorString()), Log::WARNING);
         return;
     }
 
     if (!jsonDoc.isObject())
     {
         LogMsg(tr("Failed to load web client data. File: \"%1\". Error: \"Invalid data format\"")
-            .arg(m_clientDataFilePath.toString()), Log::WARNING);
+            .arg(clientDataFilePath.toString()), Log::WARNING);
         return;
     }
 
     m_clientData = jsonDoc.object();
+    m_entrySizes.reserve(m_clientData.size());
+    for (auto it = m_clientData.constBegin(), end = m_clientData.constEnd(); it != end; ++it)
+    {
+        const qsizetype size = entrySize(it.key(), it.value());
+        m_entrySizes.insert(it.key(), size);
+        m_entriesSize += size;
+    }
 }
 
 nonstd::expected<void, QString> ClientDataStorage::storeData(const QJsonObject &object)
 {
-    QJsonObject clientData = m_clientData;
-    bool dataModified = false;
+    struct Change
+    {
+        QString key;
+        QJsonValue value;
+        qsizetype size = 0;
+    };
+
+    // find out the resulting data size first so that the data is either stored entirely or not at all
+    QList<Change> changes;
+    qsizetype entriesSize = m_entriesSize;
+    qsizetype entryCount = m_entrySizes.size();
     for (auto it = object.constBegin(), end = object.constEnd(); it != end; ++it)
     {
         const QString &key = it.key();
         const QJsonValue &value = it.value();
+        const auto existingValue = m_clientData.constFind(key);
+        const bool exists = (existingValue != m_clientData.constEnd());
 
         if (value.isNull())
         {
-            if (auto it = clientData.find(key); it != clientData.end())
+            if (exists)
             {
-                clientData.erase(it);
-                dataModified = true;
+                entriesSize -= m_entrySizes.value(key);
+                --entryCount;
+                changes.append({.key = key, .value = value});
             }
         }
-        else
+        else if (!exists || (existingValue.value() != value))
         {
-            const auto &existingValue = clientData.find(key);
-            if (existingValue == clientData.end())
-            {
-                clientData.insert(key, value);
-                dataModified = true;
-            }
-            else if (existingValue.value() != value)
-            {
-                existingValue.value() = value;
-                dataModified = true;
-            }
+            const qsizetype size = entrySize(key, value);
+            entriesSize += size - m_entrySizes.value(key);
+            if (!exists)
+                ++entryCount;
+            changes.append({.key = key, .value = value, .size = size});
         }
     }
 
-    if (dataModified)
+    if (changes.isEmpty())
+        return {};
+
+    if (dataSize(entriesSize, entryCount) > CLIENT_DATA_FILE_MAX_SIZE)
+        return nonstd::make_unexpected(tr("Total web client data must not be larger than %1 bytes").arg(CLIENT_DATA_FILE_MAX_SIZE));
+
+    for (const Change &change : asConst(changes))
     {
-        const QByteArray json = QJsonDocument(clientData).toJson(QJsonDocument::Compact);
-        if (json.size() > CLIENT_DATA_FILE_MAX_SIZE)
-            return nonstd::make_unexpected(tr("Total web client data must not be larger than %1 bytes").arg(CLIENT_DATA_FILE_MAX_SIZE));
-        const nonstd::expected<void, QString> result = Utils::IO::saveToFile(m_clientDataFilePath, json);
-        if (!result)
-            return nonstd::make_unexpected(tr("Failed to save web client data. Error: \"%1\"").arg(result.error()));
-
-        m_clientData = clientData;
+        if (change.value.isNull())
+        {
+            m_clientData.remove(change.key);
+            m_entrySizes.remove(change.key);
+        }
+        else
+        {
+            m_clientData.insert(change.key, change.value);
+            m_entrySizes.insert(change.key, change.size);
+        }
     }
+    m_entriesSize = entriesSize;
 
+    storeDeferred();
     return {};
 }
 
@@ -136,3 +214,16 @@ QJsonObject ClientDataStorage::loadData(const QStringList &keys) const
     }
     return clientData;
 }
+
+void ClientDataStorage::store()
+{
+    m_storingTimer->stop();
+
+    m_fileStorage->store(Path(CLIENT_DATA_FILE_NAME), QJsonDocument(m_clientData).toJson(QJsonDocument::Compact));
+}
+
+void ClientDataStorage::storeDeferred()
+{
+    if (!m_storingTimer->isActive())
+        m_storingTimer->start();
+}
@@ -28,11 +28,20 @@
 
 #pragma once
 
+#include <QHash>
 #include <QJsonObject>
+#include <QObject>
 
 #include "base/3rdparty/expected.hpp"
 #include "base/path.h"
+#include "base/utils/thread.h"
 
+class QTimer;
+
+class AsyncFileStorage;
+
+// The data is kept in memory, the changes are written to disk by IO thread after a short delay
+// so that the frequent changes made by WebUI are saved together
 class ClientDataStorage final : public QObject
 {
     Q_OBJECT
@@ -40,12 +49,23 @@ class ClientDataStorage final : public QObject
 
 public:
     ClientDataStorage(QObject *parent = nullptr);
+    ~ClientDataStorage() override;
 
     nonstd::expected<void, QString> storeData(const QJsonObject &object);
     QJsonObject loadData() const;
     QJsonObject loadData(const QStringList &keys) const;
 
 private:
-    Path m_clientDataFilePath;
+    void load();
+    void store();
+    void storeDeferred();
+
+    Utils::Thread::UniquePtr m_ioThread;
+    AsyncFileStorage *m_fileStorage = nullptr;
+    QTimer *m_storingTimer = nullptr;
+
     QJsonObject m_clientData;
+    // Serialized size of each entry, so the size of the data is known without serializing all of it
+    QHash<QString, qsizetype> m_entrySizes;
+    qsizetype m_entriesSize = 0;
 };
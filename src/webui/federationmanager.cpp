@@ -0,0 +1,328 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "federationmanager.h"
+
+#include <chrono>
+#include <memory>
+#include <utility>
+
+#include <QFuture>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonValue>
+#include <QList>
+#include <QPromise>
+#include <QTimer>
+#include <QUrl>
+
+#include "base/global.h"
+#include "base/net/downloadmanager.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    const std::chrono::seconds SYNC_INTERVAL = 2s;
+    const QString API_PATH_PREFIX = u"/api/v2/"_s;
+    const QString MAINDATA_API_PATH = u"sync/maindata"_s;
+
+    const QString KEY_FULL_UPDATE = u"full_update"_s;
+    const QString KEY_RESPONSE_ID = u"rid"_s;
+    const QString KEY_TORRENTS = u"torrents"_s;
+    const QString KEY_TORRENTS_REMOVED = u"torrents_removed"_s;
+
+    const QString KEY_RESULT_NODE = u"node"_s;
+    const QString KEY_RESULT_STATUS = u"status"_s;
+    const QString KEY_RESULT_DATA = u"data"_s;
+    const QString KEY_RESULT_ERROR = u"error"_s;
+
+    Net::DownloadRequest makeRequest(const QString &nodeURL, const QByteArray &apiKey, const QString &apiPath)
+    {
+        return Net::DownloadRequest(nodeURL + API_PATH_PREFIX + apiPath)
+            .rawHeader("Authorization", ("Bearer " + apiKey));
+    }
+
+    QByteArray encodeFormData(const QHash<QString, QString> &params)
+    {
+        // QUrlQuery doesn't encode '+' which is decoded as a space in form data
+        QByteArray data;
+        for (auto iter = params.cbegin(); iter != params.cend(); ++iter)
+        {
+            if (!data.isEmpty())
+                data.append('&');
+            data.append(QUrl::toPercentEncoding(iter.key()) + '=' + QUrl::toPercentEncoding(iter.value()));
+        }
+        return data;
+    }
+
+    QJsonObject makeResult(const QString &nodeName, const Net::DownloadResult &downloadResult)
+    {
+        QJsonObject result {{KEY_RESULT_NODE, nodeName}};
+        if (downloadResult.status != Net::DownloadStatus::Success)
+        {
+            result[KEY_RESULT_ERROR] = downloadResult.errorString;
+            return result;
+        }
+
+        result[KEY_RESULT_STATUS] = downloadResult.httpStatusCode;
+        if (const QJsonDocument jsonDoc = QJsonDocument::fromJson(downloadResult.data); !jsonDoc.isNull())
+            result[KEY_RESULT_DATA] = jsonDoc.isArray() ? QJsonValue(jsonDoc.array()) : QJsonValue(jsonDoc.object());
+        else if (!downloadResult.data.isEmpty())
+            result[KEY_RESULT_DATA] = QString::fromUtf8(downloadResult.data);
+        return result;
+    }
+}
+
+FederationManager::FederationManager(QObject *parent)
+    : QObject(parent)
+    , m_syncTimer {new QTimer(this)}
+{
+    m_syncTimer->setInterval(SYNC_INTERVAL);
+    connect(m_syncTimer, &QTimer::timeout, this, &FederationManager::synchronize);
+}
+
+void FederationManager::setNodes(const QString &nodesList)
+{
+    QMap<QString, Node> nodes;
+    const QList<QStringView> lines = QStringView(nodesList).split(u'\n', Qt::SkipEmptyParts);
+    for (const QStringView line : lines)
+    {
+        const QList<QStringView> items = line.trimmed().split(u' ', Qt::SkipEmptyParts);
+        if (items.isEmpty())
+            continue;
+
+        const QUrl url {items[0].toString()};
+        if (!url.isValid() || !url.scheme().startsWith(u"http") || url.host().isEmpty())
+            continue;
+
+        const QString nodeName = url.authority(QUrl::RemoveUserInfo);
+        if (nodes.contains(nodeName))
+            continue;
+
+        const QString nodeURL = url.adjusted(QUrl::RemoveQuery | QUrl::RemoveFragment | QUrl::StripTrailingSlash).toString();
+        const QByteArray apiKey = (items.size() > 1) ? items[1].toLatin1() : QByteArray();
+
+        // the node keeps its data if it is still configured the same way
+        if (const auto iter = m_nodes.find(nodeName); (iter != m_nodes.end())
+                && (iter->url == nodeURL) && (iter->apiKey == apiKey))
+        {
+            nodes.insert(nodeName, std::move(iter.value()));
+            m_nodes.erase(iter);
+        }
+        else
+        {
+            nodes.insert(nodeName, {.id = ++m_lastNodeID, .url = nodeURL, .apiKey = apiKey});
+        }
+    }
+
+    // the nodes left are the ones which are no longer configured
+    QMap<QString, Node> removedNodes = std::exchange(m_nodes, std::move(nodes));
+    for (auto iter = removedNodes.begin(); iter != removedNodes.end(); ++iter)
+        removeNodeTorrents(iter.key(), iter.value());
+
+    if (m_nodes.isEmpty())
+    {
+        m_syncTimer->stop();
+    }
+    else if (!m_syncTimer->isActive())
+    {
+        m_syncTimer->start();
+        synchronize();
+    }
+}
+
+QList<FederationManager::NodeStatus> FederationManager::nodeStatuses() const
+{
+    QList<NodeStatus> statuses;
+    statuses.reserve(m_nodes.size());
+    for (auto iter = m_nodes.cbegin(); iter != m_nodes.cend(); ++iter)
+    {
+        statuses.append({
+            .name = iter.key(),
+            .url = iter->url,
+            .isSynchronized = iter->isSynchronized,
+            .torrentsCount = iter->torrents.size(),
+            .errorMessage = iter->errorMessage
+        });
+    }
+    return statuses;
+}
+
+bool FederationManager::hasNode(const QString &nodeName) const
+{
+    return m_nodes.contains(nodeName);
+}
+
+QList<FederationManager::TorrentEntry> FederationManager::torrents(const QString &nodeName) const
+{
+    QList<TorrentEntry> entries;
+    for (auto nodeIter = m_nodes.cbegin(); nodeIter != m_nodes.cend(); ++nodeIter)
+    {
+        if (!nodeName.isEmpty() && (nodeIter.key() != nodeName))
+            continue;
+
+        const QHash<QString, QJsonObject> &nodeTorrents = nodeIter->torrents;
+        entries.reserve(entries.size() + nodeTorrents.size());
+        for (auto iter = nodeTorrents.cbegin(); iter != nodeTorrents.cend(); ++iter)
+            entries.append({.node = nodeIter.key(), .id = iter.key(), .data = iter.value()});
+    }
+    return entries;
+}
+
+QString FederationManager::torrentNode(const QString &torrentID) const
+{
+    return m_torrentNodes.value(torrentID);
+}
+
+QFuture<QJsonObject> FederationManager::sendRequest(const QString &nodeName, const QString &apiPath, const QHash<QString, QString> &params)
+{
+    auto promise = std::make_shared<QPromise<QJsonObject>>();
+    promise->start();
+
+    const auto iter = m_nodes.constFind(nodeName);
+    if (iter == m_nodes.cend())
+    {
+        promise->addResult(QJsonObject {{KEY_RESULT_NODE, nodeName}, {KEY_RESULT_ERROR, tr("Unknown node")}});
+        promise->finish();
+        return promise->future();
+    }
+
+    const Net::DownloadRequest request = makeRequest(iter->url, iter->apiKey, apiPath)
+        .postData(encodeFormData(params));
+    Net::DownloadManager::instance()->download(request, false, this, [promise, nodeName](const Net::DownloadResult &result)
+    {
+        promise->addResult(makeResult(nodeName, result));
+        promise->finish();
+    });
+
+    return promise->future();
+}
+
+void FederationManager::synchronize()
+{
+    for (auto iter = m_nodes.begin(); iter != m_nodes.end(); ++iter)
+    {
+        Node &node = iter.value();
+        if (node.isSyncing)
+            continue;
+
+        node.isSyncing = true;
+        const Net::DownloadRequest request = makeRequest(node.url, node.apiKey
+            , (MAINDATA_API_PATH + u"?rid=" + QString::number(node.rid)));
+        Net::DownloadManager::instance()->download(request, false, this
+            , [this, nodeName = iter.key(), nodeID = node.id](const Net::DownloadResult &result)
+        {
+            handleSyncFinished(nodeName, nodeID, result);
+        });
+    }
+}
+
+void FederationManager::handleSyncFinished(const QString &nodeName, const quint64 nodeID, const Net::DownloadResult &result)
+{
+    // the node could be removed or reconfigured while the request was processed
+    const auto iter = m_nodes.find(nodeName);
+    if ((iter == m_nodes.end()) || (iter->id != nodeID))
+        return;
+
+    Node &node = iter.value();
+    node.isSyncing = false;
+
+    if (result.status != Net::DownloadStatus::Success)
+    {
+        node.isSynchronized = false;
+        node.errorMessage = result.errorString;
+        return;
+    }
+
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(result.data);
+    if (!jsonDoc.isObject())
+    {
+        node.isSynchronized = false;
+        node.errorMessage = tr("Invalid data received from the node");
+        return;
+    }
+
+    applyMaindata(nodeName, node, jsonDoc.object());
+    node.isSynchronized = true;
+    node.errorMessage.clear();
+}
+
+void FederationManager::applyMaindata(const QString &nodeName, Node &node, const QJsonObject &maindata)
+{
+    node.rid = maindata.value(KEY_RESPONSE_ID).toInteger();
+
+    if (maindata.value(KEY_FULL_UPDATE).toBool())
+        removeNodeTorrents(nodeName, node);
+
+    const QJsonObject torrents = maindata.value(KEY_TORRENTS).toObject();
+    for (auto iter = torrents.constBegin(); iter != torrents.constEnd(); ++iter)
+    {
+        const QJsonObject changedFields = iter.value().toObject();
+        QJsonObject &torrent = node.torrents[iter.key()];
+        for (auto fieldIter = changedFields.constBegin(); fieldIter != changedFields.constEnd(); ++fieldIter)
+            torrent[fieldIter.key()] = fieldIter.value();
+
+        // the torrent added to several nodes belongs to the one which reported it first
+        if (!m_torrentNodes.contains(iter.key()))
+            m_torrentNodes.insert(iter.key(), nodeName);
+    }
+
+    const QJsonArray removedTorrents = maindata.value(KEY_TORRENTS_REMOVED).toArray();
+    for (const QJsonValue &removedID : removedTorrents)
+    {
+        const QString torrentID = removedID.toString();
+        node.torrents.remove(torrentID);
+        if (m_torrentNodes.value(torrentID) == nodeName)
+            reassignTorrentNode(torrentID);
+    }
+}
+
+void FederationManager::removeNodeTorrents(const QString &nodeName, Node &node)
+{
+    const QHash<QString, QJsonObject> torrents = std::exchange(node.torrents, {});
+    for (auto iter = torrents.cbegin(); iter != torrents.cend(); ++iter)
+    {
+        if (m_torrentNodes.value(iter.key()) == nodeName)
+            reassignTorrentNode(iter.key());
+    }
+}
+
+void FederationManager::reassignTorrentNode(const QString &torrentID)
+{
+    for (auto iter = m_nodes.cbegin(); iter != m_nodes.cend(); ++iter)
+    {
+        if (iter->torrents.contains(torrentID))
+        {
+            m_torrentNodes[torrentID] = iter.key();
+            return;
+        }
+    }
+
+    m_torrentNodes.remove(torrentID);
+}
@@ -0,0 +1,110 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <QtContainerFwd>
+#include <QHash>
+#include <QJsonObject>
+#include <QMap>
+#include <QObject>
+#include <QString>
+
+class QTimer;
+
+template <typename T> class QFuture;
+
+namespace Net
+{
+    struct DownloadResult;
+}
+
+// Keeps the merged index of the torrents of other qBittorrent instances ("nodes"),
+// synchronized using the incremental updates of their "sync/maindata" API,
+// and routes the requests concerning their torrents to the nodes owning them
+class FederationManager final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(FederationManager)
+
+public:
+    struct NodeStatus
+    {
+        QString name;
+        QString url;
+        bool isSynchronized = false;
+        qsizetype torrentsCount = 0;
+        QString errorMessage;
+    };
+
+    struct TorrentEntry
+    {
+        QString node;
+        QString id;
+        QJsonObject data;
+    };
+
+    explicit FederationManager(QObject *parent = nullptr);
+
+    // One "<URL> <API key>" entry per line, the nodes are named after the authority part of their URLs
+    void setNodes(const QString &nodesList);
+
+    QList<NodeStatus> nodeStatuses() const;
+    bool hasNode(const QString &nodeName) const;
+    // Returns the torrents of all the nodes if node name is empty
+    QList<TorrentEntry> torrents(const QString &nodeName = {}) const;
+    // Returns empty string if the torrent doesn't belong to any of the nodes
+    QString torrentNode(const QString &torrentID) const;
+
+    // Sends the request to the API of the node, the result contains the response of the node
+    QFuture<QJsonObject> sendRequest(const QString &nodeName, const QString &apiPath, const QHash<QString, QString> &params);
+
+private:
+    struct Node
+    {
+        quint64 id = 0;
+        QString url;
+        QByteArray apiKey;
+        qint64 rid = 0;
+        bool isSyncing = false;
+        bool isSynchronized = false;
+        QString errorMessage;
+        QHash<QString, QJsonObject> torrents;
+    };
+
+    void synchronize();
+    void handleSyncFinished(const QString &nodeName, quint64 nodeID, const Net::DownloadResult &result);
+    void applyMaindata(const QString &nodeName, Node &node, const QJsonObject &maindata);
+    void removeNodeTorrents(const QString &nodeName, Node &node);
+    void reassignTorrentNode(const QString &torrentID);
+
+    QTimer *m_syncTimer = nullptr;
+    QMap<QString, Node> m_nodes;
+    QHash<QString, QString> m_torrentNodes;
+    quint64 m_lastNodeID = 0;
+};
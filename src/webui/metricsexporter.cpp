@@ -0,0 +1,246 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include "metricsexporter.h"
+
+#include <algorithm>
+
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include <QString>
+
+#include "base/bittorrent/alertstatistics.h"
+#include "base/bittorrent/diskiostatistics.h"
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/sessionmetric.h"
+#include "base/bittorrent/torrent.h"
+#include "base/bittorrent/torrentstatustable.h"
+#include "base/global.h"
+#include "api/serialize/serialize_torrent.h"
+
+namespace
+{
+    // seconds
+    const std::array<double, MetricsExporter::REQUEST_DURATION_BUCKETS_COUNT> REQUEST_DURATION_BUCKET_BOUNDS
+            {0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5};
+
+    QByteArray toSeconds(const qint64 microseconds)
+    {
+        return QByteArray::number((microseconds / 1'000'000.), 'f', 6);
+    }
+
+    QByteArray diskIOOperationName(const BitTorrent::DiskIOOperation operation)
+    {
+        switch (operation)
+        {
+        case BitTorrent::DiskIOOperation::Read:
+            return "read";
+        case BitTorrent::DiskIOOperation::Write:
+            return "write";
+        case BitTorrent::DiskIOOperation::Hash:
+            return "hash";
+        case BitTorrent::DiskIOOperation::Move:
+            return "move";
+        }
+
+        return {};
+    }
+
+    QByteArray escapeLabelValue(const QString &value)
+    {
+        QByteArray result = value.toUtf8();
+        result.replace('\\', "\\\\");
+        result.replace('"', "\\\"");
+        result.replace('\n', "\\n");
+        return result;
+    }
+
+    class MetricsWriter
+    {
+    public:
+        void addFamily(const QByteArray &name, const QByteArray &type, const QByteArray &help)
+        {
+            m_data += "# HELP " + name + ' ' + help + '\n';
+            m_data += "# TYPE " + name + ' ' + type + '\n';
+        }
+
+        void addSample(const QByteArray &name, const QByteArray &value, const QByteArray &labels = {})
+        {
+            m_data += name;
+            if (!labels.isEmpty())
+                m_data += '{' + labels + '}';
+            m_data += ' ' + value + '\n';
+        }
+
+        void addSample(const QByteArray &name, const qint64 value, const QByteArray &labels = {})
+        {
+            addSample(name, QByteArray::number(value), labels);
+        }
+
+        QByteArray data() const
+        {
+            return m_data;
+        }
+
+    private:
+        QByteArray m_data;
+    };
+}
+
+MetricsExporter::MetricsExporter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void MetricsExporter::addRequestDuration(const std::chrono::nanoseconds duration)
+{
+    const double seconds = std::chrono::duration<double>(duration).count();
+    const auto bucketIter = std::ranges::lower_bound(REQUEST_DURATION_BUCKET_BOUNDS, seconds);
+    if (bucketIter != REQUEST_DURATION_BUCKET_BOUNDS.cend())
+        ++m_requestDurationHistogram[bucketIter - REQUEST_DURATION_BUCKET_BOUNDS.cbegin()];
+
+    ++m_requestCount;
+    m_requestDurationSum += duration;
+}
+
+QByteArray MetricsExporter::generate() const
+{
+    const auto *session = BitTorrent::Session::instance();
+    MetricsWriter writer;
+
+    // libtorrent session statistics
+    for (const BitTorrent::SessionMetric &metric : asConst(session->sessionMetrics()))
+    {
+        if (metric.name.isEmpty())
+            continue;
+
+        const QByteArray name = "libtorrent_" + metric.name.toLatin1().replace('.', '_');
+        const bool isGauge = (metric.type == BitTorrent::SessionMetric::Type::Gauge);
+        writer.addFamily(name, (isGauge ? "gauge" : "counter"), "libtorrent session statistics metric " + metric.name.toLatin1());
+        writer.addSample(name, metric.value);
+    }
+
+    // Torrents
+    const BitTorrent::TorrentStatusTable &statusTable = session->torrentStatusTable();
+    writer.addFamily("qbittorrent_torrents", "gauge", "Number of torrents by state");
+    for (int i = static_cast<int>(BitTorrent::TorrentState::Unknown); i <= static_cast<int>(BitTorrent::TorrentState::Error); ++i)
+    {
+        const auto state = static_cast<BitTorrent::TorrentState>(i);
+        if (const qsizetype count = statusTable.count(state); count > 0)
+            writer.addSample("qbittorrent_torrents", count, "state=\"" + escapeLabelValue(serializeTorrentState(state)) + '"');
+    }
+
+    writer.addFamily("qbittorrent_resume_data_pending", "gauge", "Number of torrents whose resume data is being saved");
+    writer.addSample("qbittorrent_resume_data_pending", session->pendingResumeDataCount());
+
+    // Alerts
+    const BitTorrent::AlertStatistics &alertStats = session->alertStatistics();
+
+    writer.addFamily("qbittorrent_alerts_total", "counter", "Number of handled libtorrent alerts by type");
+    for (const BitTorrent::AlertTypeStatistics &alertTypeStats : alertStats.alertTypes)
+    {
+        if (alertTypeStats.count > 0)
+            writer.addSample("qbittorrent_alerts_total", alertTypeStats.count, "type=\"" + escapeLabelValue(alertTypeStats.name) + '"');
+    }
+
+    writer.addFamily("qbittorrent_alert_handling_seconds_total", "counter", "Time spent handling libtorrent alerts by type");
+    for (const BitTorrent::AlertTypeStatistics &alertTypeStats : alertStats.alertTypes)
+    {
+        if (alertTypeStats.count > 0)
+            writer.addSample("qbittorrent_alert_handling_seconds_total", toSeconds(alertTypeStats.totalTime), "type=\"" + escapeLabelValue(alertTypeStats.name) + '"');
+    }
+
+    writer.addFamily("qbittorrent_alert_batches_total", "counter", "Number of handled libtorrent alert batches");
+    writer.addSample("qbittorrent_alert_batches_total", alertStats.batchCount);
+
+    writer.addFamily("qbittorrent_alert_stall_seconds_total", "counter", "Time the main thread spent handling libtorrent alert batches");
+    writer.addSample("qbittorrent_alert_stall_seconds_total", toSeconds(alertStats.totalStallTime));
+
+    writer.addFamily("qbittorrent_alert_queue_overflows_total", "counter", "Number of times libtorrent alerts were dropped due to full alert queue");
+    writer.addSample("qbittorrent_alert_queue_overflows_total", alertStats.droppedAlertsCount);
+
+    // Disk IO by volume (per torrent statistics are available via WebAPI only since they would produce too many series)
+    const QHash<QString, BitTorrent::DiskIOStatistics> volumeDiskIOStats = session->volumeDiskIOStatistics();
+    const auto forEachDiskIOOperation = [&volumeDiskIOStats](const auto &func)
+    {
+        for (auto iter = volumeDiskIOStats.cbegin(); iter != volumeDiskIOStats.cend(); ++iter)
+        {
+            for (int i = 0; i < BitTorrent::DISK_IO_OPERATION_COUNT; ++i)
+            {
+                const auto operation = static_cast<BitTorrent::DiskIOOperation>(i);
+                const QByteArray labels = "volume=\"" + escapeLabelValue(iter.key()) + "\",operation=\"" + diskIOOperationName(operation) + '"';
+                func(iter.value()[operation], labels);
+            }
+        }
+    };
+
+    writer.addFamily("qbittorrent_disk_io_operations_total", "counter", "Number of completed disk IO jobs by volume and operation");
+    forEachDiskIOOperation([&writer](const BitTorrent::DiskIOOperationStatistics &operationStats, const QByteArray &labels)
+    {
+        writer.addSample("qbittorrent_disk_io_operations_total", operationStats.count, labels);
+    });
+
+    writer.addFamily("qbittorrent_disk_io_bytes_total", "counter", "Amount of data processed by disk IO jobs by volume and operation");
+    forEachDiskIOOperation([&writer](const BitTorrent::DiskIOOperationStatistics &operationStats, const QByteArray &labels)
+    {
+        writer.addSample("qbittorrent_disk_io_bytes_total", operationStats.bytes, labels);
+    });
+
+    const QByteArray diskIOLatencyName = "qbittorrent_disk_io_latency_seconds";
+    writer.addFamily(diskIOLatencyName, "histogram", "Disk IO job completion time by volume and operation");
+    forEachDiskIOOperation([&writer, &diskIOLatencyName](const BitTorrent::DiskIOOperationStatistics &operationStats, const QByteArray &labels)
+    {
+        qint64 cumulativeOperationCount = 0;
+        for (int i = 0; i < (BitTorrent::DISK_IO_LATENCY_HISTOGRAM_SIZE - 1); ++i)
+        {
+            cumulativeOperationCount += operationStats.latencyHistogram[i];
+            writer.addSample((diskIOLatencyName + "_bucket"), cumulativeOperationCount
+                    , labels + ",le=\"" + toSeconds(BitTorrent::DISK_IO_LATENCY_HISTOGRAM_BOUNDS[i]) + '"');
+        }
+        writer.addSample((diskIOLatencyName + "_bucket"), operationStats.count, (labels + ",le=\"+Inf\""));
+        writer.addSample((diskIOLatencyName + "_sum"), toSeconds(operationStats.totalLatency), labels);
+        writer.addSample((diskIOLatencyName + "_count"), operationStats.count, labels);
+    });
+
+    // WebUI requests
+    const QByteArray requestDurationName = "qbittorrent_webui_request_duration_seconds";
+    writer.addFamily(requestDurationName, "histogram", "WebUI request processing time");
+    qint64 cumulativeCount = 0;
+    for (int i = 0; i < REQUEST_DURATION_BUCKETS_COUNT; ++i)
+    {
+        cumulativeCount += m_requestDurationHistogram[i];
+        writer.addSample((requestDurationName + "_bucket"), cumulativeCount
+                , "le=\"" + QByteArray::number(REQUEST_DURATION_BUCKET_BOUNDS[i]) + '"');
+    }
+    writer.addSample((requestDurationName + "_bucket"), m_requestCount, "le=\"+Inf\"");
+    writer.addSample((requestDurationName + "_sum"), toSeconds(std::chrono::duration_cast<std::chrono::microseconds>(m_requestDurationSum).count()));
+    writer.addSample((requestDurationName + "_count"), m_requestCount);
+
+    return writer.data();
+}
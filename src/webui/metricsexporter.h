@@ -0,0 +1,58 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <array>
+#include <chrono>
+
+#include <QObject>
+
+class QByteArray;
+
+// Collects WebUI level metrics and exports them together with the session metrics
+// in Prometheus text exposition format
+class MetricsExporter final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(MetricsExporter)
+
+public:
+    static constexpr int REQUEST_DURATION_BUCKETS_COUNT = 8;
+
+    explicit MetricsExporter(QObject *parent = nullptr);
+
+    void addRequestDuration(std::chrono::nanoseconds duration);
+    QByteArray generate() const;
+
+private:
+    // Non-cumulative counts, requests exceeding the largest bucket bound are only included in total count
+    std::array<qint64, REQUEST_DURATION_BUCKETS_COUNT> m_requestDurationHistogram {};
+    qint64 m_requestCount = 0;
+    std::chrono::nanoseconds m_requestDurationSum {0};
+};
@@ -31,28 +31,42 @@
 
 #include <algorithm>
 
+#include <QCryptographicHash>
 #include <QDateTime>
 #include <QDebug>
+#include <QCborArray>
+#include <QCborMap>
+#include <QCborValue>
 #include <QDir>
 #include <QFileInfo>
+#include <QFuture>
+#include <QJsonArray>
 #include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonValue>
 #include <QMetaObject>
 #include <QMimeDatabase>
 #include <QMimeType>
 #include <QNetworkCookie>
 #include <QRegularExpression>
 #include <QThread>
+#include <QTimer>
 #include <QUrl>
 
 #include "base/algorithm.h"
 #include "base/bittorrent/session.h"
 #include "base/bittorrent/torrentcreationmanager.h"
+#include "base/http/contentproducer.h"
+#include "base/http/deferredresponse.h"
+#include "base/http/eventstream.h"
 #include "base/http/httperror.h"
+#include "base/http/responsegenerator.h"
 #include "base/logger.h"
 #include "base/preferences.h"
 #include "base/types.h"
 #include "base/utils/apikey.h"
 #include "base/utils/fs.h"
+#include "base/utils/gzip.h"
 #include "base/utils/io.h"
 #include "base/utils/misc.h"
 #include "base/utils/password.h"
@@ -62,25 +76,57 @@
 #include "api/appcontroller.h"
 #include "api/authcontroller.h"
 #include "api/clientdatacontroller.h"
+#include "api/federationcontroller.h"
 #include "api/logcontroller.h"
+#include "api/maindatasynclog.h"
 #include "api/rsscontroller.h"
 #include "api/searchcontroller.h"
 #include "api/synccontroller.h"
 #include "api/torrentcreatorcontroller.h"
+#include "api/torrentjsoncache.h"
 #include "api/torrentscontroller.h"
 #include "api/transfercontroller.h"
 #include "clientdatastorage.h"
+#include "federationmanager.h"
+#include "metricsexporter.h"
 
 const int MAX_ALLOWED_FILESIZE = 10 * 1024 * 1024;
+const int MAX_BATCH_ACTIONS = 10000;
 const QString SESSION_COOKIE_NAME_PREFIX = u"QBT_SID_"_s;
+// Scripted clients logging in on each call would otherwise accumulate sessions until they expire
+const int MAX_SESSIONS = 500;
+const auto SESSIONS_CLEANUP_INTERVAL = 1min;
+const auto SESSION_IDLE_DATA_RELEASE_DELAY = 2min;
+// Identical polling requests of many clients within this time share the response
+const auto API_RESPONSE_CACHE_TTL = 1s;
+const int MAX_CACHED_API_RESPONSES = 64;
+const int MAX_CACHED_HOST_HEADERS = 64;
+// Several clients may share an address, e.g. behind NAT
+const int CLIENT_ADDRESS_BUDGET_FACTOR = 4;
+// The bulk requests can't use this part of the budgets, it is left for the interactive ones
+const double BULK_REQUEST_BUDGET_RESERVE = 0.5;
+const int MAX_REQUEST_BUDGETS = 1024;
 
 const QString WWW_FOLDER = u":/www"_s;
 const QString PUBLIC_FOLDER = u"/public"_s;
+const QString METRICS_PATH = u"/metrics"_s;
+const QString CONTENT_TYPE_METRICS = u"text/plain; version=0.0.4; charset=utf-8"_s;
 const QString PRIVATE_FOLDER = u"/private"_s;
 const QString INDEX_HTML = u"/index.html"_s;
 
 namespace
 {
+    // The results of these actions don't depend on the session and are only changed by
+    // the session refresh or by the other (non-GET) actions which invalidate the cache
+    const QSet<std::pair<QString, QString>> CACHEABLE_API_ACTIONS =
+    {
+        {u"torrents"_s, u"categories"_s},
+        {u"torrents"_s, u"count"_s},
+        {u"torrents"_s, u"info"_s},
+        {u"torrents"_s, u"tags"_s},
+        {u"transfer"_s, u"info"_s}
+    };
+
     QStringMap parseCookie(const QStringView cookieStr)
     {
         // [rfc6265] 4.2.1. Syntax
@@ -131,6 +177,130 @@ namespace
         return u"no-store"_s;
     }
 
+    [[noreturn]] void throwHTTPError(const APIError &error)
+    {
+        switch (error.type())
+        {
+        case APIErrorType::AccessDenied:
+            throw ForbiddenHTTPError(error.message());
+        case APIErrorType::BadData:
+            throw UnsupportedMediaTypeHTTPError(error.message());
+        case APIErrorType::BadParams:
+            throw BadRequestHTTPError(error.message());
+        case APIErrorType::Conflict:
+            throw ConflictHTTPError(error.message());
+        case APIErrorType::NotFound:
+            throw NotFoundHTTPError(error.message());
+        case APIErrorType::RangeNotSatisfiable:
+            throw RangeNotSatisfiableHTTPError(error.message());
+        case APIErrorType::Unauthorized:
+            throw UnauthorizedHTTPError(error.message());
+        default:
+            Q_UNREACHABLE();
+            break;
+        }
+    }
+
+    Http::Response toErrorResponse(const HTTPError &error)
+    {
+        Http::Response response {static_cast<uint>(error.statusCode()), error.statusText()};
+        response.headers[Http::HEADER_CONTENT_TYPE] = Http::CONTENT_TYPE_TXT;
+        response.content = (!error.message().isEmpty() ? error.message() : error.statusText()).toUtf8();
+        return response;
+    }
+
+    Http::Response toErrorResponse(const APIError &error)
+    {
+        try
+        {
+            throwHTTPError(error);
+        }
+        catch (const HTTPError &httpError)
+        {
+            return toErrorResponse(httpError);
+        }
+    }
+
+    // CBOR is sent to the clients asking for it explicitly unless they prefer JSON
+    QString negotiateAPIResponseType(const QString &acceptHeader)
+    {
+        const double cborQuality = Http::mediaTypeQuality(acceptHeader, Http::CONTENT_TYPE_CBOR);
+        return ((cborQuality > 0) && (cborQuality >= Http::mediaTypeQuality(acceptHeader, Http::CONTENT_TYPE_JSON)))
+            ? Http::CONTENT_TYPE_CBOR : Http::CONTENT_TYPE_JSON;
+    }
+
+    QByteArray toCBOR(const QJsonDocument &document)
+    {
+        const QCborValue value = document.isArray()
+            ? QCborValue(QCborArray::fromJsonArray(document.array()))
+            : QCborValue(QCborMap::fromJsonObject(document.object()));
+        return value.toCbor();
+    }
+
+    // Returns empty data if it isn't a JSON document
+    QByteArray jsonToCBOR(const QByteArray &json)
+    {
+        QJsonParseError jsonError;
+        const QJsonDocument document = QJsonDocument::fromJson(json, &jsonError);
+        if (jsonError.error != QJsonParseError::NoError)
+            return {};
+
+        return toCBOR(document);
+    }
+
+    Http::DeferredResponse *deferResult(QFuture<QByteArray> result, const QString &responseType)
+    {
+        auto *deferredResponse = new Http::DeferredResponse;
+        result.then(deferredResponse, [deferredResponse, responseType](const QByteArray &json)
+        {
+            const QByteArray cbor = (responseType == Http::CONTENT_TYPE_CBOR) ? jsonToCBOR(json) : QByteArray();
+
+            Http::Response response;
+            response.headers[Http::HEADER_CONTENT_TYPE] = !cbor.isEmpty() ? Http::CONTENT_TYPE_CBOR : Http::CONTENT_TYPE_JSON;
+            response.content = !cbor.isEmpty() ? cbor : json;
+            deferredResponse->resolve(response);
+        }).onFailed(deferredResponse, [deferredResponse](const APIError &error)
+        {
+            deferredResponse->resolve(toErrorResponse(error));
+        }).onFailed(deferredResponse, [deferredResponse]
+        {
+            deferredResponse->resolve(toErrorResponse(HTTPError(500, u"Internal Server Error"_s)));
+        }).onCanceled(deferredResponse, [deferredResponse]
+        {
+            // the controller producing the result is destroyed, e.g. the session is expired
+            deferredResponse->resolve(toErrorResponse(HTTPError(503, u"Service Unavailable"_s)));
+        });
+
+        return deferredResponse;
+    }
+
+    QString makeETag(const QString &hash, const bool isGzipped)
+    {
+        // strong validator must be unique for each encoding of the content
+        return isGzipped ? u"\"%1-gzip\""_s.arg(hash) : u"\"%1\""_s.arg(hash);
+    }
+
+    bool isETagMatched(const QString &ifNoneMatch, const QString &hash)
+    {
+        // [rfc9110] 13.1.2. If-None-Match
+        if (ifNoneMatch.trimmed() == u"*")
+            return true;
+
+        const QList<QStringView> tags = QStringView(ifNoneMatch).split(u',', Qt::SkipEmptyParts);
+        for (QStringView tag : tags)
+        {
+            tag = tag.trimmed();
+            // weak comparison is used, so the content matches in any encoding
+            if (tag.startsWith(u"W/"))
+                tag = tag.mid(2);
+
+            if ((tag == makeETag(hash, false)) || (tag == makeETag(hash, true)))
+                return true;
+        }
+
+        return false;
+    }
+
     QString createLanguagesOptionsHtml()
     {
         // List language files
@@ -158,9 +328,22 @@ WebApplication::WebApplication(IApplication *app, QObject *parent)
     , m_authController {new AuthController(this, app, this)}
     , m_torrentCreationManager {new BitTorrent::TorrentCreationManager(app, this)}
     , m_clientDataStorage {new ClientDataStorage(this)}
+    , m_maindataSyncLog {new MaindataSyncLog(this)}
+    , m_torrentJsonCache {new TorrentJsonCache(this)}
+    , m_metricsExporter {new MetricsExporter(this)}
+    , m_federationManager {new FederationManager(this)}
 {
     declarePublicAPI(u"auth/login"_s);
 
+    m_sessionsCleanupTimer = new QTimer(this);
+    m_sessionsCleanupTimer->setInterval(SESSIONS_CLEANUP_INTERVAL);
+    connect(m_sessionsCleanupTimer, &QTimer::timeout, this, &WebApplication::cleanupSessions);
+    m_sessionsCleanupTimer->start();
+
+    const auto *btSession = BitTorrent::Session::instance();
+    connect(btSession, &BitTorrent::Session::torrentsUpdated, this, [this] { m_cachedAPIResponses.clear(); });
+    connect(btSession, &BitTorrent::Session::statsUpdated, this, [this] { m_cachedAPIResponses.clear(); });
+
     configure();
     connect(Preferences::instance(), &Preferences::changed, this, &WebApplication::configure);
 }
@@ -169,6 +352,7 @@ WebApplication::~WebApplication()
 {
     // cleanup sessions data
     qDeleteAll(m_sessions);
+    delete m_apiKeySession;
 }
 
 void WebApplication::sendWebUIFile()
@@ -303,6 +487,17 @@ void WebApplication::setPasswordHash(const QByteArray &passwordHash)
 
 void WebApplication::doProcessRequest(const bool isUsingApiKey)
 {
+    if (m_isMetricsEnabled && (request().path == METRICS_PATH))
+    {
+        if (!session())
+            throw ForbiddenHTTPError();
+        if (m_request.method != Http::METHOD_GET)
+            throw MethodNotAllowedHTTPError();
+
+        print(m_metricsExporter->generate(), CONTENT_TYPE_METRICS);
+        return;
+    }
+
     const QRegularExpressionMatch match = m_apiPathPattern.match(request().path);
     if (!match.hasMatch())
     {
@@ -353,14 +548,68 @@ void WebApplication::doProcessRequest(const bool isUsingApiKey)
             throw MethodNotAllowedHTTPError();
     }
 
+    if (m_isRequestBudgetEnabled && !m_env.isLocalSocket)
+        consumeRequestBudget(isUsingApiKey);
+
+    // the same results are sent as JSON or CBOR depending on the "Accept" header
+    const QString responseType = negotiateAPIResponseType(request().headers.value(Http::HEADER_ACCEPT));
+
+    if ((scope == u"app") && (action == u"batch"))
+    {
+        setHeader({Http::HEADER_VARY, u"Accept"_s});
+        runBatch(responseType);
+        return;
+    }
+
+    // any other action may change the data
+    if (m_request.method != Http::METHOD_GET)
+        m_cachedAPIResponses.clear();
+
+    const QString cacheKey = cachedAPIResponseKey(scope, action, responseType);
+    if (!cacheKey.isEmpty())
+    {
+        if (const auto iter = m_cachedAPIResponses.find(cacheKey); iter != m_cachedAPIResponses.end())
+        {
+            if (!iter->expirationTimer.hasExpired())
+            {
+                sendCachedAPIResponse(*iter);
+                return;
+            }
+
+            m_cachedAPIResponses.erase(iter);
+        }
+    }
+
     DataMap data;
     for (const Http::UploadedFile &torrent : request().files)
         data[torrent.filename] = torrent.data;
 
     try
     {
-        const APIResult result = controller->run(action, m_params, data);
-        if (result.data.isNull())
+        const APIResult result = controller->run(action, m_params, data, request().headers);
+        for (auto iter = result.headers.cbegin(); iter != result.headers.cend(); ++iter)
+            setHeader({iter.key(), iter.value()});
+
+        if (result.deferredData)
+        {
+            setHeader({Http::HEADER_VARY, u"Accept"_s});
+            defer(deferResult(*result.deferredData, responseType));
+            status(200);
+        }
+        else if (result.eventStream)
+        {
+            stream(result.eventStream);
+            status(200);
+        }
+        else if (result.contentProducer)
+        {
+            stream(result.contentProducer, result.mimeType);
+            if (result.status == APIStatus::PartialContent)
+                status(206, u"Partial Content"_s);
+            else
+                status(200);
+        }
+        else if (result.data.isNull())
         {
             status(204);
         }
@@ -369,12 +618,46 @@ void WebApplication::doProcessRequest(const bool isUsingApiKey)
             switch (result.data.userType())
             {
             case QMetaType::QJsonDocument:
-                print(result.data.toJsonDocument().toJson(QJsonDocument::Compact), Http::CONTENT_TYPE_JSON);
+                {
+                    setHeader({Http::HEADER_VARY, u"Accept"_s});
+
+                    const QJsonDocument document = result.data.toJsonDocument();
+                    const QByteArray resultData = (responseType == Http::CONTENT_TYPE_CBOR)
+                        ? toCBOR(document) : document.toJson(QJsonDocument::Compact);
+                    if (!cacheKey.isEmpty() && (result.status == APIStatus::Ok))
+                    {
+                        sendCachedAPIResponse(cacheAPIResponse(cacheKey, resultData, responseType));
+                        return;
+                    }
+
+                    print(resultData, responseType);
+                }
                 break;
             case QMetaType::QByteArray:
                 {
-                    const auto resultData = result.data.toByteArray();
-                    print(resultData, (!result.mimeType.isEmpty() ? result.mimeType : Http::CONTENT_TYPE_TXT));
+                    QByteArray resultData = result.data.toByteArray();
+                    QString mimeType = (!result.mimeType.isEmpty() ? result.mimeType : Http::CONTENT_TYPE_TXT);
+                    if ((mimeType == Http::CONTENT_TYPE_JSON) && result.filename.isEmpty())
+                    {
+                        setHeader({Http::HEADER_VARY, u"Accept"_s});
+
+                        if (responseType == Http::CONTENT_TYPE_CBOR)
+                        {
+                            if (QByteArray cbor = jsonToCBOR(resultData); !cbor.isEmpty())
+                            {
+                                resultData = std::move(cbor);
+                                mimeType = Http::CONTENT_TYPE_CBOR;
+                            }
+                        }
+
+                        if (!cacheKey.isEmpty() && (result.status == APIStatus::Ok))
+                        {
+                            sendCachedAPIResponse(cacheAPIResponse(cacheKey, resultData, mimeType));
+                            return;
+                        }
+                    }
+
+                    print(resultData, mimeType);
                     if (!result.filename.isEmpty())
                     {
                         setHeader({u"Content-Disposition"_s, u"attachment; filename=\"%1\""_s.arg(result.filename)});
@@ -402,24 +685,7 @@ void WebApplication::doProcessRequest(const bool isUsingApiKey)
     catch (const APIError &error)
     {
         // re-throw as HTTPError
-        switch (error.type())
-        {
-        case APIErrorType::AccessDenied:
-            throw ForbiddenHTTPError(error.message());
-        case APIErrorType::BadData:
-            throw UnsupportedMediaTypeHTTPError(error.message());
-        case APIErrorType::BadParams:
-            throw BadRequestHTTPError(error.message());
-        case APIErrorType::Conflict:
-            throw ConflictHTTPError(error.message());
-        case APIErrorType::NotFound:
-            throw NotFoundHTTPError(error.message());
-        case APIErrorType::Unauthorized:
-            throw UnauthorizedHTTPError(error.message());
-        default:
-            Q_UNREACHABLE();
-            break;
-        }
+        throwHTTPError(error);
     }
 }
 
@@ -433,7 +699,7 @@ void WebApplication::configure()
     {
         m_isAltUIUsed = isAltUIUsed;
         m_rootFolder = rootFolder;
-        m_translatedFiles.clear();
+        m_cachedFiles.clear();
         if (!m_isAltUIUsed)
             LogMsg(tr("Using built-in WebUI."));
         else
@@ -444,7 +710,7 @@ void WebApplication::configure()
     if (m_currentLocale != newLocale)
     {
         m_currentLocale = newLocale;
-        m_translatedFiles.clear();
+        m_cachedFiles.clear();
 
         m_translationFileLoaded = m_translator.load((m_rootFolder / Path(u"translations/webui_"_s) + newLocale).data());
         if (m_translationFileLoaded)
@@ -460,7 +726,7 @@ void WebApplication::configure()
 
     m_isLocalAuthEnabled = pref->isWebUILocalAuthEnabled();
     m_isAuthSubnetWhitelistEnabled = pref->isWebUIAuthSubnetWhitelistEnabled();
-    m_authSubnetWhitelist = pref->getWebUIAuthSubnetWhitelist();
+    m_authSubnetWhitelist = Utils::Net::SubnetMatcher(pref->getWebUIAuthSubnetWhitelist());
     m_sessionTimeout = std::chrono::seconds(pref->getWebUISessionTimeout());
     m_sessionCookieName = SESSION_COOKIE_NAME_PREFIX + QString::number(pref->getWebUIPort());
 
@@ -468,14 +734,31 @@ void WebApplication::configure()
     for (WebSession *session : asConst(m_sessions))
         session->setCookieRefreshTime(0s);
 
-    m_domainList = pref->getServerDomains().split(u';', Qt::SkipEmptyParts);
-    for (QString &entry : m_domainList)
-        entry = entry.trimmed();
+    const QStringList domains = pref->getServerDomains().split(u';', Qt::SkipEmptyParts);
+    QStringList domainPatterns;
+    domainPatterns.reserve(domains.size());
+    for (const QString &domain : domains)
+        domainPatterns.append(u"(?:"_s + Utils::String::wildcardToRegexPattern(domain.trimmed()) + u')');
+    m_serverDomainsRegex = QRegularExpression(domainPatterns.join(u'|'), QRegularExpression::CaseInsensitiveOption);
+    m_serverDomainsRegex.optimize();
+    m_hostHeaderInfos.clear();
 
     m_isCSRFProtectionEnabled = pref->isWebUICSRFProtectionEnabled();
     m_isSecureCookieEnabled = pref->isWebUISecureCookieEnabled();
     m_isHostHeaderValidationEnabled = pref->isWebUIHostHeaderValidationEnabled();
     m_isHttpsEnabled = pref->isWebUIHttpsEnabled();
+    m_isMetricsEnabled = pref->isWebUIMetricsEnabled();
+
+    const auto requestBudgetRate = static_cast<double>(pref->getWebUIRequestBudgetRate());
+    const auto requestBudgetBurst = static_cast<double>(pref->getWebUIRequestBudgetBurst());
+    m_isRequestBudgetEnabled = pref->isWebUIRequestBudgetEnabled();
+    if (!m_isRequestBudgetEnabled || (requestBudgetRate != m_requestBudgetRate) || (requestBudgetBurst != m_requestBudgetBurst))
+    {
+        m_requestBudgetRate = requestBudgetRate;
+        m_requestBudgetBurst = requestBudgetBurst;
+        m_sessionRequestBudgets.clear();
+        m_clientRequestBudgets.clear();
+    }
 
     m_prebuiltHeaders.clear();
     m_prebuiltHeaders.push_back({Http::HEADER_X_XSS_PROTECTION, u"1; mode=block"_s});
@@ -526,8 +809,8 @@ void WebApplication::configure()
     {
         const QStringList proxyList = pref->getWebUITrustedReverseProxiesList().split(u';', Qt::SkipEmptyParts);
 
-        m_trustedReverseProxyList.clear();
-        m_trustedReverseProxyList.reserve(proxyList.size());
+        QList<Utils::Net::Subnet> trustedReverseProxyList;
+        trustedReverseProxyList.reserve(proxyList.size());
 
         for (QString proxy : proxyList)
         {
@@ -546,15 +829,26 @@ void WebApplication::configure()
 
             const std::optional<Utils::Net::Subnet> subnet = Utils::Net::parseSubnet(proxy);
             if (subnet)
-                m_trustedReverseProxyList.push_back(subnet.value());
+                trustedReverseProxyList.push_back(subnet.value());
         }
 
-        if (m_trustedReverseProxyList.isEmpty())
+        m_trustedReverseProxies = Utils::Net::SubnetMatcher(trustedReverseProxyList);
+        if (m_trustedReverseProxies.isEmpty())
             m_isReverseProxySupportEnabled = false;
     }
 
     if (const QString apiKey = pref->getWebUIApiKey(); apiKey.isEmpty() || Utils::APIKey::isValid(apiKey))
+    {
+        if (apiKey != m_apiKey)
+        {
+            // the data of the old key clients must not be reachable with the new key
+            delete m_apiKeySession;
+            m_apiKeySession = nullptr;
+        }
         m_apiKey = apiKey;
+    }
+
+    m_federationManager->setNodes(pref->getWebUIFederationNodes());
 }
 
 void WebApplication::declarePublicAPI(const QString &apiPath)
@@ -566,15 +860,137 @@ void WebApplication::sendFile(const Path &path)
 {
     const QDateTime lastModified = Utils::Fs::lastModified(path);
 
-    // find translated file in cache
-    if (const auto it = m_translatedFiles.constFind(path);
-        (it != m_translatedFiles.constEnd()) && (lastModified <= it->lastModified))
+    auto it = m_cachedFiles.constFind(path);
+    if ((it == m_cachedFiles.constEnd()) || (lastModified > it->lastModified))
+        it = m_cachedFiles.insert(path, loadFile(path, lastModified));
+
+    const bool useGzip = !it->gzipData.isEmpty()
+        && Http::acceptsGzipEncoding(request().headers.value(Http::HEADER_ACCEPT_ENCODING));
+
+    setHeader({Http::HEADER_CACHE_CONTROL, getCachingInterval(it->mimeType)});
+    setHeader({Http::HEADER_ETAG, makeETag(it->hash, useGzip)});
+    if (!it->gzipData.isEmpty())
+        setHeader({Http::HEADER_VARY, u"Accept-Encoding"_s});
+
+    if (isETagMatched(request().headers.value(Http::HEADER_IF_NONE_MATCH), it->hash))
     {
-        print(it->data, it->mimeType);
-        setHeader({Http::HEADER_CACHE_CONTROL, getCachingInterval(it->mimeType)});
+        status(304, u"Not Modified"_s);
         return;
     }
 
+    if (useGzip)
+    {
+        print(it->gzipData, it->mimeType);
+        setHeader({Http::HEADER_CONTENT_ENCODING, u"gzip"_s});
+    }
+    else
+    {
+        print(it->data, it->mimeType);
+    }
+}
+
+void WebApplication::consumeRequestBudget(const bool isBulkRequest)
+{
+    const Utils::TokenBucket::Clock::time_point now = Utils::TokenBucket::Clock::now();
+
+    const auto findBudget = [now](auto &budgets, const auto &key, const double rate, const double capacity) -> Utils::TokenBucket &
+    {
+        auto iter = budgets.find(key);
+        if (iter == budgets.end())
+        {
+            // the full budgets are the same as the ones created anew
+            if (budgets.size() >= MAX_REQUEST_BUDGETS)
+                budgets.removeIf([now](const auto &item) { return item.value().isFull(now); });
+            iter = budgets.insert(key, Utils::TokenBucket(rate, capacity, now));
+        }
+        return iter.value();
+    };
+
+    // the interactive requests (i.e. the ones of WebUI sessions) may use the whole budget
+    // while the bulk ones (i.e. the ones authenticated by API key) are refused earlier
+    const double reserveRatio = isBulkRequest ? BULK_REQUEST_BUDGET_RESERVE : 0;
+
+    Utils::TokenBucket &clientBudget = findBudget(m_clientRequestBudgets, m_clientAddress
+        , (m_requestBudgetRate * CLIENT_ADDRESS_BUDGET_FACTOR), (m_requestBudgetBurst * CLIENT_ADDRESS_BUDGET_FACTOR));
+    std::chrono::milliseconds waitTime = clientBudget.waitTime(1, (clientBudget.capacity() * reserveRatio), now);
+
+    Utils::TokenBucket *sessionBudget = nullptr;
+    if (session())
+    {
+        sessionBudget = &findBudget(m_sessionRequestBudgets, session()->id(), m_requestBudgetRate, m_requestBudgetBurst);
+        waitTime = std::max(waitTime, sessionBudget->waitTime(1, (sessionBudget->capacity() * reserveRatio), now));
+    }
+
+    if (waitTime > 0ms)
+    {
+        const auto retryAfter = std::chrono::ceil<std::chrono::seconds>(std::min<std::chrono::milliseconds>(waitTime, 1h));
+        setHeader({Http::HEADER_RETRY_AFTER, QString::number(std::max<qint64>(retryAfter.count(), 1))});
+        throw TooManyRequestsHTTPError();
+    }
+
+    clientBudget.consume(1, now);
+    if (sessionBudget)
+        sessionBudget->consume(1, now);
+}
+
+QString WebApplication::cachedAPIResponseKey(const QString &scope, const QString &action, const QString &responseType) const
+{
+    if ((m_request.method != Http::METHOD_GET) || !CACHEABLE_API_ACTIONS.contains({scope, action}))
+        return {};
+
+    QStringList paramNames = m_params.keys();
+    paramNames.sort();
+
+    QString key = u"%1/%2;%3"_s.arg(scope, action, responseType);
+    for (const QString &name : asConst(paramNames))
+        key += u"\n%1=%2"_s.arg(name, m_params[name]);
+    return key;
+}
+
+WebApplication::CachedAPIResponse &WebApplication::cacheAPIResponse(const QString &key, const QByteArray &data, const QString &mimeType)
+{
+    if (m_cachedAPIResponses.size() >= MAX_CACHED_API_RESPONSES)
+        m_cachedAPIResponses.clear();
+
+    CachedAPIResponse &cachedResponse = m_cachedAPIResponses[key];
+    cachedResponse = {.data = data, .mimeType = mimeType};
+    cachedResponse.expirationTimer.setRemainingTime(API_RESPONSE_CACHE_TTL);
+    return cachedResponse;
+}
+
+void WebApplication::sendCachedAPIResponse(CachedAPIResponse &cachedResponse)
+{
+    status(200);
+
+    const Http::ContentCoding coding = Http::negotiateContentCoding(request().headers.value(Http::HEADER_ACCEPT_ENCODING));
+    if (coding != Http::ContentCoding::Identity)
+    {
+        // the clients requesting the same data share the compressed content too
+        auto iter = cachedResponse.encodedData.find(coding);
+        if (iter == cachedResponse.encodedData.end())
+        {
+            Http::Response encodedResponse;
+            encodedResponse.headers[Http::HEADER_CONTENT_TYPE] = cachedResponse.mimeType;
+            encodedResponse.content = cachedResponse.data;
+            Http::compressContent(encodedResponse, coding);
+
+            const bool isEncoded = encodedResponse.headers.contains(Http::HEADER_CONTENT_ENCODING);
+            iter = cachedResponse.encodedData.insert(coding, (isEncoded ? encodedResponse.content : QByteArray()));
+        }
+
+        if (!iter->isEmpty())
+        {
+            print(*iter, cachedResponse.mimeType);
+            setHeader({Http::HEADER_CONTENT_ENCODING, Http::contentCodingName(coding)});
+            return;
+        }
+    }
+
+    print(cachedResponse.data, cachedResponse.mimeType);
+}
+
+WebApplication::CachedFile WebApplication::loadFile(const Path &path, const QDateTime &lastModified) const
+{
     const auto readResult = Utils::IO::readFile(path, MAX_ALLOWED_FILESIZE);
     if (!readResult)
     {
@@ -616,15 +1032,29 @@ void WebApplication::sendFile(const Path &path)
             dataStr.replace(u"${LANGUAGE_OPTIONS}"_s, createLanguagesOptionsHtml());
 
         data = dataStr.toUtf8();
-        m_translatedFiles[path] = {data, mimeType.name(), lastModified}; // caching translated file
     }
 
-    print(data, mimeType.name());
-    setHeader({Http::HEADER_CACHE_CONTROL, getCachingInterval(mimeType.name())});
+    CachedFile file {.data = data, .mimeType = mimeType.name(), .lastModified = lastModified};
+    file.hash = QString::fromLatin1(QCryptographicHash::hash(data, QCryptographicHash::Sha1).toHex());
+
+    // images are already compressed and small files aren't worth it
+    if (!mimeType.name().startsWith(u"image/") && (data.size() > 1024))
+    {
+        bool ok = false;
+        // compressed only once per locale, so use the best level
+        const QByteArray compressedData = Utils::Gzip::compress(data, 9, &ok);
+        if (ok && (compressedData.size() < data.size()))
+            file.gzipData = compressedData;
+    }
+
+    return file;
 }
 
 Http::Response WebApplication::processRequest(const Http::Request &request, const Http::Environment &env)
 {
+    QElapsedTimer processingTimer;
+    processingTimer.start();
+
     m_currentSession = nullptr;
     m_request = request;
     m_env = env;
@@ -647,9 +1077,10 @@ Http::Response WebApplication::processRequest(const Http::Request &request, cons
     {
         const bool isUsingApiKey = m_request.headers.contains(Http::HEADER_AUTHORIZATION);
 
-        // block suspicious requests
-        if ((!isUsingApiKey && m_isCSRFProtectionEnabled && isCrossSiteRequest(m_request))
-            || (m_isHostHeaderValidationEnabled && !validateHostHeader(m_domainList)))
+        // block suspicious requests, the browsers can't reach the local socket
+        if (!m_env.isLocalSocket
+            && ((!isUsingApiKey && m_isCSRFProtectionEnabled && isCrossSiteRequest(m_request))
+                || (m_isHostHeaderValidationEnabled && !validateHostHeader())))
         {
             throw UnauthorizedHTTPError();
         }
@@ -673,9 +1104,106 @@ Http::Response WebApplication::processRequest(const Http::Request &request, cons
     for (const Http::Header &prebuiltHeader : asConst(m_prebuiltHeaders))
         setHeader(prebuiltHeader);
 
+    m_metricsExporter->addRequestDuration(std::chrono::nanoseconds(processingTimer.nsecsElapsed()));
+
     return response();
 }
 
+void WebApplication::runBatch(const QString &responseType)
+{
+    QJsonParseError jsonError;
+    const QJsonDocument jsonDoc = QJsonDocument::fromJson(m_params[u"actions"_s].toUtf8(), &jsonError);
+    if ((jsonError.error != QJsonParseError::NoError) || !jsonDoc.isArray())
+        throw BadRequestHTTPError(tr("'actions' must be a JSON array"));
+
+    const QJsonArray actions = jsonDoc.array();
+    if (actions.size() > MAX_BATCH_ACTIONS)
+        throw BadRequestHTTPError(tr("Too many actions. Limit: %1").arg(MAX_BATCH_ACTIONS));
+
+    // The changes made by the actions are saved and reported to the clients together
+    QJsonArray results;
+    {
+        const BitTorrent::Session::BulkUpdateScope bulkUpdate;
+        for (const QJsonValue &item : actions)
+            results.append(runBatchAction(item.toObject()));
+    }
+
+    const QByteArray resultData = (responseType == Http::CONTENT_TYPE_CBOR)
+        ? QCborArray::fromJsonArray(results).toCborValue().toCbor()
+        : QJsonDocument(results).toJson(QJsonDocument::Compact);
+    print(resultData, responseType);
+}
+
+QJsonObject WebApplication::runBatchAction(const QJsonObject &item)
+{
+    const QString KEY_STATUS = u"status"_s;
+
+    try
+    {
+        const QString path = item.value(u"path"_s).toString();
+        const qsizetype sepPos = path.indexOf(u'/');
+        if (sepPos <= 0)
+            throw BadRequestHTTPError(tr("'path' must be in form of \"scope/action\""));
+
+        const QString scope = path.first(sepPos);
+        const QString action = path.sliced(sepPos + 1);
+        if ((scope == u"auth") || ((scope == u"app") && (action == u"batch")))
+            throw ForbiddenHTTPError();
+
+        APIController *controller = session()->getAPIController(scope);
+        if (!controller)
+            throw NotFoundHTTPError();
+
+        // the actions are sent as part of POST request
+        if (const auto allowedMethodIter = m_allowedMethod.constFind({scope, action});
+            (allowedMethodIter != m_allowedMethod.cend()) && (*allowedMethodIter != Http::METHOD_POST))
+        {
+            throw MethodNotAllowedHTTPError();
+        }
+
+        StringMap params;
+        const QJsonObject paramsObj = item.value(u"params"_s).toObject();
+        for (auto iter = paramsObj.constBegin(); iter != paramsObj.constEnd(); ++iter)
+            params[iter.key()] = iter.value().isString() ? iter.value().toString() : iter.value().toVariant().toString();
+
+        APIResult result;
+        try
+        {
+            result = controller->run(action, params);
+        }
+        catch (const APIError &error)
+        {
+            throwHTTPError(error);
+        }
+
+        if (result.eventStream || result.contentProducer || result.deferredData || !result.filename.isEmpty())
+        {
+            if (result.eventStream)
+                result.eventStream->deleteLater();
+            if (result.contentProducer)
+                result.contentProducer->deleteLater();
+            throw BadRequestHTTPError(tr("Action result can't be returned in batch"));
+        }
+
+        if (result.data.isNull())
+            return {{KEY_STATUS, 204}};
+
+        // serialized JSON is embedded as the value it represents rather than as a string
+        const QJsonDocument document = (result.data.userType() == QMetaType::QJsonDocument)
+            ? result.data.toJsonDocument()
+            : ((result.mimeType == Http::CONTENT_TYPE_JSON) ? QJsonDocument::fromJson(result.data.toByteArray()) : QJsonDocument());
+        const QJsonValue data = !document.isNull()
+            ? (document.isArray() ? QJsonValue(document.array()) : QJsonValue(document.object()))
+            : QJsonValue(result.data.toString());
+        return {{KEY_STATUS, ((result.status == APIStatus::Async) ? 202 : 200)}, {u"data"_s, data}};
+    }
+    catch (const HTTPError &error)
+    {
+        return {{KEY_STATUS, error.statusCode()}
+            , {u"error"_s, (!error.message().isEmpty() ? error.message() : error.statusText())}};
+    }
+}
+
 QString WebApplication::clientId() const
 {
     return m_clientAddress.toString();
@@ -739,22 +1267,17 @@ void WebApplication::apiKeySessionInitialize()
     if (m_apiKey.isEmpty())
         return;
 
-    QString sessionId;
-    if (const QString submittedKey = parseAuthorizationHeader(m_request.headers.value(Http::HEADER_AUTHORIZATION));
-        Utils::Password::slowEquals(submittedKey.toLatin1(), m_apiKey.toLatin1()))
-    {
-        sessionId = submittedKey;
-    }
+    const QString submittedKey = parseAuthorizationHeader(m_request.headers.value(Http::HEADER_AUTHORIZATION));
+    if (!Utils::Password::slowEquals(submittedKey.toLatin1(), m_apiKey.toLatin1()))
+        return;
 
-    if (!sessionId.isEmpty())
-    {
-        m_currentSession = m_sessions.value(sessionId);
-        // api key sessions don't "expire" since there's no point in triggering re-auth
-        if (m_currentSession)
-            m_currentSession->updateTimestamp();
-        else
-            sessionStartImpl(sessionId, false);
-    }
+    // API key requests are authenticated by the key itself so they don't need a session of their own.
+    // The shared session only keeps the state of the stateful APIs (e.g. sync and search) alive,
+    // it doesn't "expire" since there's no point in triggering re-auth.
+    if (!m_apiKeySession)
+        m_apiKeySession = createSession(generateSid());
+    m_apiKeySession->updateTimestamp();
+    m_currentSession = m_apiKeySession;
 }
 
 QString WebApplication::generateSid() const
@@ -775,9 +1298,12 @@ QString WebApplication::generateSid() const
 
 bool WebApplication::isAuthNeeded()
 {
+    // the access to the local socket is limited to the user running the application
+    if (m_env.isLocalSocket)
+        return false;
     if (!m_isLocalAuthEnabled && m_clientAddress.isLoopback())
         return false;
-    if (m_isAuthSubnetWhitelistEnabled && Utils::Net::isIPInSubnets(m_clientAddress, m_authSubnetWhitelist))
+    if (m_isAuthSubnetWhitelistEnabled && m_authSubnetWhitelist.contains(m_clientAddress))
         return false;
     return true;
 }
@@ -789,14 +1315,45 @@ bool WebApplication::isPublicAPI(const QString &scope, const QString &action) co
 
 void WebApplication::sessionStart()
 {
-    sessionStartImpl(generateSid(), true);
+    Q_ASSERT(!m_currentSession);
+
+    if (m_sessions.size() >= MAX_SESSIONS)
+    {
+        removeExpiredSessions();
+        if (m_sessions.size() >= MAX_SESSIONS)
+            removeLeastRecentSession();
+    }
+
+    m_currentSession = createSession(generateSid());
+    m_sessions[m_currentSession->id()] = m_currentSession;
+
+    setSessionCookie();
 }
 
-void WebApplication::sessionStartImpl(const QString &sessionId, const bool useCookie)
+WebSession *WebApplication::createSession(const QString &sessionId)
 {
-    Q_ASSERT(!m_currentSession);
+    auto *session = new WebSession(sessionId, app());
+
+    session->registerAPIController(u"app"_s, new AppController(this, app(), session));
+    session->registerAPIController(u"clientdata"_s, new ClientDataController(m_clientDataStorage, app(), session));
+    session->registerAPIController(u"federation"_s, new FederationController(m_federationManager, app(), session));
+    session->registerAPIController(u"log"_s, new LogController(app(), session));
+    session->registerAPIController(u"torrentcreator"_s, new TorrentCreatorController(m_torrentCreationManager, app(), session));
+    session->registerAPIController(u"rss"_s, new RSSController(app(), session));
+    session->registerAPIController(u"search"_s, new SearchController(app(), session));
+    session->registerAPIController(u"torrents"_s, new TorrentsController(m_torrentJsonCache, app(), session));
+    session->registerAPIController(u"transfer"_s, new TransferController(app(), session));
+
+    auto *syncController = new SyncController(m_maindataSyncLog, app(), session);
+    // the stream is received without any requests so the session would expire while it is open
+    connect(syncController, &SyncController::maindataStreamActive, session, &WebSession::updateTimestamp);
+    session->registerAPIController(u"sync"_s, syncController);
+
+    return session;
+}
 
-    // remove outdated sessions
+void WebApplication::removeExpiredSessions()
+{
     Algorithm::removeIf(m_sessions, [this](const QString &, const WebSession *session)
     {
         if (session->hasExpired(m_sessionTimeout))
@@ -807,27 +1364,36 @@ void WebApplication::sessionStartImpl(const QString &sessionId, const bool useCo
 
         return false;
     });
+}
 
-    m_currentSession = new WebSession(sessionId, app());
-    m_sessions[m_currentSession->id()] = m_currentSession;
+void WebApplication::removeLeastRecentSession()
+{
+    auto leastRecentIter = m_sessions.end();
+    for (auto iter = m_sessions.begin(); iter != m_sessions.end(); ++iter)
+    {
+        if ((leastRecentIter == m_sessions.end()) || (iter.value()->idleDuration() > leastRecentIter.value()->idleDuration()))
+            leastRecentIter = iter;
+    }
+
+    if (leastRecentIter == m_sessions.end())
+        return;
 
-    m_currentSession->registerAPIController(u"app"_s, new AppController(app(), m_currentSession));
-    m_currentSession->registerAPIController(u"clientdata"_s, new ClientDataController(m_clientDataStorage, app(), m_currentSession));
-    m_currentSession->registerAPIController(u"log"_s, new LogController(app(), m_currentSession));
-    m_currentSession->registerAPIController(u"torrentcreator"_s, new TorrentCreatorController(m_torrentCreationManager, app(), m_currentSession));
-    m_currentSession->registerAPIController(u"rss"_s, new RSSController(app(), m_currentSession));
-    m_currentSession->registerAPIController(u"search"_s, new SearchController(app(), m_currentSession));
-    m_currentSession->registerAPIController(u"torrents"_s, new TorrentsController(app(), m_currentSession));
-    m_currentSession->registerAPIController(u"transfer"_s, new TransferController(app(), m_currentSession));
+    delete leastRecentIter.value();
+    m_sessions.erase(leastRecentIter);
+}
 
-    const auto *btSession = BitTorrent::Session::instance();
-    auto *syncController = new SyncController(app(), m_currentSession);
-    syncController->updateFreeDiskSpace(btSession->freeDiskSpace());
-    connect(btSession, &BitTorrent::Session::freeDiskSpaceChecked, syncController, &SyncController::updateFreeDiskSpace);
-    m_currentSession->registerAPIController(u"sync"_s, syncController);
+void WebApplication::cleanupSessions()
+{
+    removeExpiredSessions();
 
-    if (useCookie)
-        setSessionCookie();
+    // Idle sessions keep their cookies but not their data
+    for (WebSession *session : asConst(m_sessions))
+    {
+        if (session->idleDuration() > SESSION_IDLE_DATA_RELEASE_DELAY)
+            session->releaseIdleData();
+    }
+    if (m_apiKeySession && (m_apiKeySession->idleDuration() > SESSION_IDLE_DATA_RELEASE_DELAY))
+        m_apiKeySession->releaseIdleData();
 }
 
 void WebApplication::sessionEnd()
@@ -838,12 +1404,33 @@ void WebApplication::sessionEnd()
     cookie.setPath(u"/"_s);
     cookie.setExpirationDate(QDateTime::currentDateTime().addDays(-1));
 
-    delete m_sessions.take(m_currentSession->id());
+    if (m_currentSession == m_apiKeySession)
+        m_apiKeySession = nullptr;
+    else
+        m_sessions.remove(m_currentSession->id());
+    delete m_currentSession;
     m_currentSession = nullptr;
 
     setHeader({Http::HEADER_SET_COOKIE, QString::fromLatin1(cookie.toRawForm())});
 }
 
+SessionsMemoryUsage WebApplication::estimatedSessionsMemoryUsage() const
+{
+    SessionsMemoryUsage memoryUsage {.syncData = m_maindataSyncLog->estimatedMemoryUsage() + m_torrentJsonCache->estimatedMemoryUsage()};
+    QList<const WebSession *> sessions {m_sessions.cbegin(), m_sessions.cend()};
+    if (m_apiKeySession)
+        sessions.append(m_apiKeySession);
+    for (const WebSession *session : asConst(sessions))
+    {
+        if (const auto *syncController = qobject_cast<const SyncController *>(session->getAPIController(u"sync"_s)))
+            memoryUsage.syncData += syncController->estimatedMemoryUsage();
+        if (const auto *searchController = qobject_cast<const SearchController *>(session->getAPIController(u"search"_s)))
+            memoryUsage.searchResults += searchController->estimatedMemoryUsage();
+    }
+
+    return memoryUsage;
+}
+
 bool WebApplication::isOriginTrustworthy() const
 {
     // https://w3c.github.io/webappsec-secure-contexts/#is-origin-trustworthy
@@ -912,13 +1499,29 @@ bool WebApplication::isCrossSiteRequest(const Http::Request &request) const
     return true;
 }
 
-bool WebApplication::validateHostHeader(const QStringList &domains) const
+bool WebApplication::validateHostHeader() const
 {
-    const QUrl hostHeader = urlFromHostHeader(m_request.headers[Http::HEADER_HOST]);
-    const QString requestHost = hostHeader.host();
+    const QString hostHeaderValue = m_request.headers[Http::HEADER_HOST];
+    auto hostHeaderInfoIter = m_hostHeaderInfos.constFind(hostHeaderValue);
+    if (hostHeaderInfoIter == m_hostHeaderInfos.cend())
+    {
+        // the header is controlled by the clients, so the cache is limited
+        if (m_hostHeaderInfos.size() >= MAX_CACHED_HOST_HEADERS)
+            m_hostHeaderInfos.clear();
+
+        const QUrl hostHeader = urlFromHostHeader(hostHeaderValue);
+        const QString requestHost = hostHeader.host();
+        const HostHeaderInfo hostHeaderInfo {
+            .port = hostHeader.port(),
+            .address = QHostAddress(requestHost),
+            .isAllowedDomain = (!m_serverDomainsRegex.pattern().isEmpty() && requestHost.contains(m_serverDomainsRegex))
+        };
+        hostHeaderInfoIter = m_hostHeaderInfos.insert(hostHeaderValue, hostHeaderInfo);
+    }
+    const HostHeaderInfo &hostHeaderInfo = hostHeaderInfoIter.value();
 
     // (if present) try matching host header's port with local port
-    const int requestPort = hostHeader.port();
+    const int requestPort = hostHeaderInfo.port;
     if ((requestPort != -1) && (m_env.localPort != requestPort))
     {
         LogMsg(tr("WebUI: Invalid Host header, port mismatch. Request source IP: '%1'. Server port: '%2'. Received Host header: '%3'")
@@ -929,18 +1532,14 @@ bool WebApplication::validateHostHeader(const QStringList &domains) const
     }
 
     // try matching host header with local address
-    const bool sameAddr = m_env.localAddress.isEqual(QHostAddress(requestHost));
+    const bool sameAddr = m_env.localAddress.isEqual(hostHeaderInfo.address);
 
     if (sameAddr)
         return true;
 
     // try matching host header with domain list
-    for (const auto &domain : domains)
-    {
-        const QRegularExpression domainRegex {Utils::String::wildcardToRegexPattern(domain), QRegularExpression::CaseInsensitiveOption};
-        if (requestHost.contains(domainRegex))
-            return true;
-    }
+    if (hostHeaderInfo.isAllowedDomain)
+        return true;
 
     LogMsg(tr("WebUI: Invalid Host header. Request source IP: '%1'. Received Host header: '%2'")
            .arg(m_env.clientAddress.toString(), m_request.headers[Http::HEADER_HOST])
@@ -954,7 +1553,7 @@ QHostAddress WebApplication::resolveClientAddress() const
         return m_env.clientAddress;
 
     // Only reverse proxy can overwrite client address
-    if (!Utils::Net::isIPInSubnets(m_env.clientAddress, m_trustedReverseProxyList))
+    if (!m_trustedReverseProxies.contains(m_env.clientAddress))
         return m_env.clientAddress;
 
     const QString forwardedFor = m_request.headers.value(Http::HEADER_X_FORWARDED_FOR);
@@ -1001,7 +1600,12 @@ bool WebSession::hasExpired(const std::chrono::milliseconds duration) const
     // don't expire for special values
     if (duration <= 0ms)
         return false;
-    return m_timestamp.durationElapsed() > duration;
+    return idleDuration() > duration;
+}
+
+std::chrono::milliseconds WebSession::idleDuration() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(m_timestamp.durationElapsed());
 }
 
 void WebSession::updateTimestamp()
@@ -1031,3 +1635,11 @@ APIController *WebSession::getAPIController(const QString &scope) const
 {
     return m_apiControllers.value(scope);
 }
+
+void WebSession::releaseIdleData()
+{
+    if (auto *syncController = qobject_cast<SyncController *>(getAPIController(u"sync"_s)))
+        syncController->releaseIdleData();
+    if (auto *torrentsController = qobject_cast<TorrentsController *>(getAPIController(u"torrents"_s)))
+        torrentsController->releaseIdleData();
+}
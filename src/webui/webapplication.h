@@ -48,20 +48,29 @@
 #include "base/applicationcomponent.h"
 #include "base/global.h"
 #include "base/http/irequesthandler.h"
+#include "base/http/responsegenerator.h"
 #include "base/http/responsebuilder.h"
 #include "base/http/types.h"
 #include "base/path.h"
 #include "base/utils/net.h"
+#include "base/utils/tokenbucket.h"
 #include "base/utils/version.h"
 #include "api/isessionmanager.h"
 
 using namespace std::chrono_literals;
 
-inline const Utils::Version<3, 2> API_VERSION {2, 14, 1};
+inline const Utils::Version<3, 2> API_VERSION {2, 14, 2};
+
+class QJsonObject;
+class QTimer;
 
 class APIController;
 class AuthController;
 class ClientDataStorage;
+class FederationManager;
+class MaindataSyncLog;
+class MetricsExporter;
+class TorrentJsonCache;
 class WebApplication;
 
 namespace BitTorrent
@@ -77,6 +86,7 @@ public:
     QString id() const override;
 
     bool hasExpired(std::chrono::milliseconds duration) const;
+    std::chrono::milliseconds idleDuration() const;
     void updateTimestamp();
     bool shouldRefreshCookie() const;
     void setCookieRefreshTime(std::chrono::seconds timeout);
@@ -84,6 +94,9 @@ public:
     void registerAPIController(const QString &scope, APIController *controller);
     APIController *getAPIController(const QString &scope) const;
 
+    // Drop the per-session snapshots, they are rebuilt (with full update) when requested again
+    void releaseIdleData();
+
 private:
     const QString m_sid;
     QElapsedTimer m_timestamp;
@@ -111,20 +124,58 @@ public:
     void setPasswordHash(const QByteArray &passwordHash);
 
 private:
+    struct CachedFile
+    {
+        QByteArray data;
+        QByteArray gzipData;  // empty if compression isn't worth it
+        QString mimeType;
+        QString hash;  // of the uncompressed data
+        QDateTime lastModified;
+    };
+
+    struct CachedAPIResponse
+    {
+        QByteArray data;
+        QString mimeType;
+        QMap<Http::ContentCoding, QByteArray> encodedData;  // empty if encoding isn't worth it
+        QDeadlineTimer expirationTimer;
+    };
+
+    // Host header of the requests is usually the same for all the requests of a client,
+    // so it is parsed and matched against the server domains once
+    struct HostHeaderInfo
+    {
+        int port = -1;
+        QHostAddress address;
+        bool isAllowedDomain = false;
+    };
+
     QString clientId() const override;
     WebSession *session() override;
     void sessionStart() override;
-    void sessionStartImpl(const QString &sessionId, bool useCookie);
     void sessionEnd() override;
+    SessionsMemoryUsage estimatedSessionsMemoryUsage() const override;
 
     void doProcessRequest(bool isUsingApiKey);
+    void runBatch(const QString &responseType);
+    QJsonObject runBatchAction(const QJsonObject &item);
     void configure();
 
     void declarePublicAPI(const QString &apiPath);
 
     void sendFile(const Path &path);
+    CachedFile loadFile(const Path &path, const QDateTime &lastModified) const;
     void sendWebUIFile();
 
+    // Memoization of the responses of idempotent API actions that don't depend on the session
+    QString cachedAPIResponseKey(const QString &scope, const QString &action, const QString &responseType) const;
+    CachedAPIResponse &cacheAPIResponse(const QString &key, const QByteArray &data, const QString &mimeType);
+    void sendCachedAPIResponse(CachedAPIResponse &cachedResponse);
+
+    // Limits the API requests of the current client, its session and address have separate budgets.
+    // Throws TooManyRequestsHTTPError if the request exceeds them.
+    void consumeRequestBudget(bool isBulkRequest);
+
     void translateDocument(QString &data) const;
 
     // Session management
@@ -132,18 +183,25 @@ private:
     void sessionInitialize();
     void setSessionCookie();
     void apiKeySessionInitialize();
+    WebSession *createSession(const QString &sessionId);
+    void removeExpiredSessions();
+    void removeLeastRecentSession();
+    void cleanupSessions();
     bool isAuthNeeded();
     bool isPublicAPI(const QString &scope, const QString &action) const;
 
     bool isOriginTrustworthy() const;
     bool isCrossSiteRequest(const Http::Request &request) const;
-    bool validateHostHeader(const QStringList &domains) const;
+    bool validateHostHeader() const;
 
     // reverse proxy
     QHostAddress resolveClientAddress() const;
 
     // Persistent data
     QHash<QString, WebSession *> m_sessions;
+    // shared by all API key clients, it isn't stored in m_sessions so it is neither expired nor evicted
+    WebSession *m_apiKeySession = nullptr;
+    QTimer *m_sessionsCleanupTimer = nullptr;
 
     // Current data
     WebSession *m_currentSession = nullptr;
@@ -158,6 +216,7 @@ private:
     const QHash<std::pair<QString, QString>, QString> m_allowedMethod =
     {
         // <<controller name, action name>, HTTP method>
+        {{u"app"_s, u"batch"_s}, Http::METHOD_POST},
         {{u"app"_s, u"deleteAPIKey"_s}, Http::METHOD_POST},
         {{u"app"_s, u"rotateAPIKey"_s}, Http::METHOD_POST},
         {{u"app"_s, u"sendTestEmail"_s}, Http::METHOD_POST},
@@ -167,6 +226,7 @@ private:
         {{u"auth"_s, u"login"_s}, Http::METHOD_POST},
         {{u"auth"_s, u"logout"_s}, Http::METHOD_POST},
         {{u"clientdata"_s, u"store"_s}, Http::METHOD_POST},
+        {{u"federation"_s, u"forward"_s}, Http::METHOD_POST},
         {{u"rss"_s, u"addFeed"_s}, Http::METHOD_POST},
         {{u"rss"_s, u"addFolder"_s}, Http::METHOD_POST},
         {{u"rss"_s, u"markAsRead"_s}, Http::METHOD_POST},
@@ -240,13 +300,8 @@ private:
     bool m_isAltUIUsed = false;
     Path m_rootFolder;
 
-    struct TranslatedFile
-    {
-        QByteArray data;
-        QString mimeType;
-        QDateTime lastModified;
-    };
-    QHash<Path, TranslatedFile> m_translatedFiles;
+    QHash<Path, CachedFile> m_cachedFiles;  // translated and compressed once per locale
+    QHash<QString, CachedAPIResponse> m_cachedAPIResponses;
     QString m_currentLocale;
     QTranslator m_translator;
     bool m_translationFileLoaded = false;
@@ -254,25 +309,39 @@ private:
     AuthController *m_authController = nullptr;
     bool m_isLocalAuthEnabled = false;
     bool m_isAuthSubnetWhitelistEnabled = false;
-    QList<Utils::Net::Subnet> m_authSubnetWhitelist;
+    Utils::Net::SubnetMatcher m_authSubnetWhitelist;
     std::chrono::seconds m_sessionTimeout = 0s;
     QString m_sessionCookieName;
     QString m_apiKey;
 
     // security related
-    QStringList m_domainList;
+    // all the server domains are matched at once, it is empty if there are none
+    QRegularExpression m_serverDomainsRegex;
+    mutable QHash<QString, HostHeaderInfo> m_hostHeaderInfos;
     bool m_isCSRFProtectionEnabled = true;
     bool m_isSecureCookieEnabled = true;
     bool m_isHostHeaderValidationEnabled = true;
     bool m_isHttpsEnabled = false;
+    bool m_isMetricsEnabled = false;
+
+    // Request budgets
+    bool m_isRequestBudgetEnabled = false;
+    double m_requestBudgetRate = 0;
+    double m_requestBudgetBurst = 0;
+    QHash<QString, Utils::TokenBucket> m_sessionRequestBudgets;
+    QHash<QHostAddress, Utils::TokenBucket> m_clientRequestBudgets;
 
     // Reverse proxy
     bool m_isReverseProxySupportEnabled = false;
-    QList<Utils::Net::Subnet> m_trustedReverseProxyList;
+    Utils::Net::SubnetMatcher m_trustedReverseProxies;
     QHostAddress m_clientAddress;
 
     QList<Http::Header> m_prebuiltHeaders;
 
     BitTorrent::TorrentCreationManager *m_torrentCreationManager = nullptr;
     ClientDataStorage *m_clientDataStorage = nullptr;
+    MaindataSyncLog *m_maindataSyncLog = nullptr;
+    TorrentJsonCache *m_torrentJsonCache = nullptr;
+    MetricsExporter *m_metricsExporter = nullptr;
+    FederationManager *m_federationManager = nullptr;
 };
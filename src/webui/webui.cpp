@@ -35,15 +35,31 @@
 #include "base/net/portforwarder.h"
 #include "base/path.h"
 #include "base/preferences.h"
+#include "base/profile.h"
+#include "base/tracer.h"
 #include "base/utils/io.h"
 #include "base/utils/net.h"
 #include "base/utils/password.h"
 #include "webapplication.h"
 
+namespace
+{
+    QString defaultLocalSocketName()
+    {
+#ifdef Q_OS_WIN
+        return u"qBittorrent-WebUI"_s;
+#else
+        return (specialFolderLocation(SpecialFolder::Data) / Path(u"webui.sock"_s)).toString();
+#endif
+    }
+}
+
 WebUI::WebUI(IApplication *app, const QByteArray &tempPasswordHash)
     : ApplicationComponent(app)
     , m_tempPasswordHash {tempPasswordHash}
 {
+    const TraceSpan traceSpan {"WebUI::WebUI"};
+
     configure();
     connect(Preferences::instance(), &Preferences::changed, this, &WebUI::configure);
 }
@@ -102,6 +118,9 @@ void WebUI::configure()
                 m_httpServer->close();
         }
 
+        m_httpServer->setWorkerThreadCount(pref->getWebUIWorkerThreadCount());
+        m_httpServer->setHTTP2Enabled(pref->isWebUIHTTP2Enabled());
+
         m_webapp->setUsername(username);
         m_webapp->setPasswordHash(passwordHash);
 
@@ -140,6 +159,28 @@ void WebUI::configure()
             }
         }
 
+        if (pref->isWebUILocalSocketEnabled())
+        {
+            const QString configuredName = pref->getWebUILocalSocketName();
+            const QString localSocketName = configuredName.isEmpty() ? defaultLocalSocketName() : configuredName;
+            if (m_httpServer->localServerName() != localSocketName)
+            {
+                if (m_httpServer->listenLocal(localSocketName))
+                {
+                    LogMsg(tr("WebUI: Now listening on local socket: %1").arg(localSocketName));
+                }
+                else
+                {
+                    LogMsg(tr("WebUI: Unable to listen on local socket: %1. Reason: %2")
+                        .arg(localSocketName, m_httpServer->localServerErrorString()), Log::CRITICAL);
+                }
+            }
+        }
+        else
+        {
+            m_httpServer->closeLocal();
+        }
+
         // DynDNS
         if (pref->isDynDNSEnabled())
         {
@@ -578,6 +578,10 @@ window.addEventListener("DOMContentLoaded", (event) => {
             status.classList.toggle("selectedFilter", (status.id === filterID));
     };
 
+    const getTotalTorrentsCount = () => {
+        return torrentsTable.useServerView ? torrentsTable.getServerFilterCount("status", "all") : torrentsTable.getRowSize();
+    };
+
     const updateCategoryList = () => {
         const categoryList = document.getElementById("categoryFilterList");
         if (!categoryList)
@@ -623,16 +627,21 @@ window.addEventListener("DOMContentLoaded", (event) => {
         };
 
         let uncategorized = 0;
-        for (const { full_data: { category } } of torrentsTable.getRowValues()) {
-            if (category.length === 0)
-                uncategorized += 1;
+        if (torrentsTable.useServerView) {
+            uncategorized = torrentsTable.getServerFilterCount("category", "");
+        }
+        else {
+            for (const { full_data: { category } } of torrentsTable.getRowValues()) {
+                if (category.length === 0)
+                    uncategorized += 1;
+            }
         }
 
         const sortedCategories = [];
         for (const [category, categoryData] of window.qBittorrent.Client.categoryMap) {
             sortedCategories.push({
                 categoryName: category,
-                categoryCount: categoryData.torrents.size,
+                categoryCount: torrentsTable.useServerView ? torrentsTable.getServerFilterCount("category", category) : categoryData.torrents.size,
                 nameSegments: category.split("/"),
                 ...(useSubcategories && {
                     children: [],
@@ -656,7 +665,7 @@ window.addEventListener("DOMContentLoaded", (event) => {
         });
 
         const categoriesFragment = new DocumentFragment();
-        categoriesFragment.appendChild(createLink(CATEGORIES_ALL, "QBT_TR(All)QBT_TR[CONTEXT=CategoryFilterModel]", torrentsTable.getRowSize()));
+        categoriesFragment.appendChild(createLink(CATEGORIES_ALL, "QBT_TR(All)QBT_TR[CONTEXT=CategoryFilterModel]", getTotalTorrentsCount()));
         categoriesFragment.appendChild(createLink(CATEGORIES_UNCATEGORIZED, "QBT_TR(Uncategorized)QBT_TR[CONTEXT=CategoryFilterModel]", uncategorized));
 
         if (useSubcategories) {
@@ -722,19 +731,24 @@ window.addEventListener("DOMContentLoaded", (event) => {
         };
 
         let untagged = 0;
-        for (const { full_data: { tags } } of torrentsTable.getRowValues()) {
-            if (tags.length === 0)
-                untagged += 1;
+        if (torrentsTable.useServerView) {
+            untagged = torrentsTable.getServerFilterCount("tag", "");
+        }
+        else {
+            for (const { full_data: { tags } } of torrentsTable.getRowValues()) {
+                if (tags.length === 0)
+                    untagged += 1;
+            }
         }
 
-        tagFilterList.appendChild(createLink(TAGS_ALL, "QBT_TR(All)QBT_TR[CONTEXT=TagFilterModel]", torrentsTable.getRowSize()));
+        tagFilterList.appendChild(createLink(TAGS_ALL, "QBT_TR(All)QBT_TR[CONTEXT=TagFilterModel]", getTotalTorrentsCount()));
         tagFilterList.appendChild(createLink(TAGS_UNTAGGED, "QBT_TR(Untagged)QBT_TR[CONTEXT=TagFilterModel]", untagged));
 
         const sortedTags = [];
         for (const [tag, torrents] of window.qBittorrent.Client.tagMap) {
             sortedTags.push({
                 tagName: tag,
-                tagSize: torrents.size
+                tagSize: torrentsTable.useServerView ? torrentsTable.getServerFilterCount("tag", tag) : torrents.size
             });
         }
         sortedTags.sort((left, right) => window.qBittorrent.Misc.naturalSortCollator.compare(left.tagName, right.tagName));
@@ -788,25 +802,37 @@ window.addEventListener("DOMContentLoaded", (event) => {
             return trackerFilterItem;
         };
 
-        let trackerlessCount = 0;
-        let trackerErrorCount = 0;
-        let announceErrorCount = 0;
-        let trackerWarningCount = 0;
-        for (const { full_data } of torrentsTable.getRowValues()) {
-            if (full_data.trackers_count === 0)
-                trackerlessCount += 1;
+        if (torrentsTable.useServerView && [TRACKERS_ANNOUNCE_ERROR, TRACKERS_ERROR, TRACKERS_WARNING].includes(selectedTracker)) {
+            selectedTracker = TRACKERS_ALL;
+            localPreferences.set("selected_tracker", selectedTracker);
+        }
 
-            // counting bools by adding them
-            trackerErrorCount += full_data.has_tracker_error;
-            announceErrorCount += full_data.has_other_announce_error;
-            trackerWarningCount += full_data.has_tracker_warning;
+        trackerFilterList.appendChild(createLink(TRACKERS_ALL, "QBT_TR(All)QBT_TR[CONTEXT=TrackerFiltersList]", getTotalTorrentsCount()));
+        if (torrentsTable.useServerView) {
+            // the server doesn't filter torrents by tracker status
+            trackerFilterList.appendChild(createLink(TRACKERS_TRACKERLESS, "QBT_TR(Trackerless)QBT_TR[CONTEXT=TrackerFiltersList]"
+                , torrentsTable.getServerFilterCount("tracker", "")));
         }
+        else {
+            let trackerlessCount = 0;
+            let trackerErrorCount = 0;
+            let announceErrorCount = 0;
+            let trackerWarningCount = 0;
+            for (const { full_data } of torrentsTable.getRowValues()) {
+                if (full_data.trackers_count === 0)
+                    trackerlessCount += 1;
+
+                // counting bools by adding them
+                trackerErrorCount += full_data.has_tracker_error;
+                announceErrorCount += full_data.has_other_announce_error;
+                trackerWarningCount += full_data.has_tracker_warning;
+            }
 
-        trackerFilterList.appendChild(createLink(TRACKERS_ALL, "QBT_TR(All)QBT_TR[CONTEXT=TrackerFiltersList]", torrentsTable.getRowSize()));
-        trackerFilterList.appendChild(createLink(TRACKERS_TRACKERLESS, "QBT_TR(Trackerless)QBT_TR[CONTEXT=TrackerFiltersList]", trackerlessCount));
-        trackerFilterList.appendChild(createLink(TRACKERS_ERROR, "QBT_TR(Tracker error)QBT_TR[CONTEXT=TrackerFiltersList]", trackerErrorCount));
-        trackerFilterList.appendChild(createLink(TRACKERS_ANNOUNCE_ERROR, "QBT_TR(Other error)QBT_TR[CONTEXT=TrackerFiltersList]", announceErrorCount));
-        trackerFilterList.appendChild(createLink(TRACKERS_WARNING, "QBT_TR(Warning)QBT_TR[CONTEXT=TrackerFiltersList]", trackerWarningCount));
+            trackerFilterList.appendChild(createLink(TRACKERS_TRACKERLESS, "QBT_TR(Trackerless)QBT_TR[CONTEXT=TrackerFiltersList]", trackerlessCount));
+            trackerFilterList.appendChild(createLink(TRACKERS_ERROR, "QBT_TR(Tracker error)QBT_TR[CONTEXT=TrackerFiltersList]", trackerErrorCount));
+            trackerFilterList.appendChild(createLink(TRACKERS_ANNOUNCE_ERROR, "QBT_TR(Other error)QBT_TR[CONTEXT=TrackerFiltersList]", announceErrorCount));
+            trackerFilterList.appendChild(createLink(TRACKERS_WARNING, "QBT_TR(Warning)QBT_TR[CONTEXT=TrackerFiltersList]", trackerWarningCount));
+        }
 
         // Sort trackers by hostname
         const sortedList = [];
@@ -819,7 +845,7 @@ window.addEventListener("DOMContentLoaded", (event) => {
 
             sortedList.push({
                 trackerHost: host,
-                trackerCount: uniqueTorrents.size,
+                trackerCount: torrentsTable.useServerView ? torrentsTable.getServerFilterCount("tracker", host) : uniqueTorrents.size,
             });
         }
         sortedList.sort((left, right) => window.qBittorrent.Misc.naturalSortCollator.compare(left.trackerHost, right.trackerHost));
@@ -860,14 +886,252 @@ window.addEventListener("DOMContentLoaded", (event) => {
         error: 17
     });
 
+    const processMainData = (responseJSON, viewParams) => {
+        clearTimeout(torrentsFilterInputTimer);
+        torrentsFilterInputTimer = -1;
+
+        let torrentsTableSelectedRows;
+        let updateStatuses = false;
+        let updateCategories = false;
+        let updateTags = false;
+        let updateTrackers = false;
+        let updateTorrents = false;
+        const fullUpdate = (responseJSON["fullUpdate"] === true);
+        if (fullUpdate) {
+            torrentsTableSelectedRows = torrentsTable.selectedRowsIds();
+            updateStatuses = true;
+            updateCategories = true;
+            updateTags = true;
+            updateTrackers = true;
+            updateTorrents = true;
+            torrentsTable.clear();
+            window.qBittorrent.Client.categoryMap.clear();
+            window.qBittorrent.Client.tagMap.clear();
+            trackerMap.clear();
+        }
+        if (responseJSON["rid"])
+            syncMainDataLastResponseId = responseJSON["rid"];
+        if (responseJSON["view"]) {
+            torrentsTable.setServerView(viewParams.offset, responseJSON["view"]["torrents"], responseJSON["view"]["total"]);
+            updateTorrents = true;
+        }
+        if (torrentsTable.useServerView && (fullUpdate || responseJSON["filter_counts"])) {
+            torrentsTable.updateServerFilterCounts(responseJSON["filter_counts"], fullUpdate);
+            updateStatuses = true;
+            updateCategories = true;
+            updateTags = true;
+            updateTrackers = true;
+        }
+        if (responseJSON["categories"]) {
+            for (const responseName in responseJSON["categories"]) {
+                if (!Object.hasOwn(responseJSON["categories"], responseName))
+                    continue;
+
+                const responseData = responseJSON["categories"][responseName];
+                const categoryData = window.qBittorrent.Client.categoryMap.get(responseName);
+                if (categoryData === undefined) {
+                    window.qBittorrent.Client.categoryMap.set(responseName, {
+                        savePath: responseData.savePath,
+                        downloadPath: responseData.download_path ?? null,
+                        torrents: new Set()
+                    });
+                }
+                else {
+                    if (responseData.savePath !== undefined)
+                        categoryData.savePath = responseData.savePath;
+                    if (responseData.download_path !== undefined)
+                        categoryData.downloadPath = responseData.download_path;
+                }
+            }
+            updateCategories = true;
+        }
+        if (responseJSON["categories_removed"]) {
+            for (const category of responseJSON["categories_removed"])
+                window.qBittorrent.Client.categoryMap.delete(category);
+            updateCategories = true;
+        }
+        if (responseJSON["tags"]) {
+            for (const tag of responseJSON["tags"]) {
+                if (!window.qBittorrent.Client.tagMap.has(tag))
+                    window.qBittorrent.Client.tagMap.set(tag, new Set());
+            }
+            updateTags = true;
+        }
+        if (responseJSON["tags_removed"]) {
+            for (const tag of responseJSON["tags_removed"])
+                window.qBittorrent.Client.tagMap.delete(tag);
+            updateTags = true;
+        }
+        if (responseJSON["trackers"]) {
+            for (const [tracker, torrents] of Object.entries(responseJSON["trackers"])) {
+                const host = window.qBittorrent.Misc.getHost(tracker);
+
+                let trackerListItem = trackerMap.get(host);
+                if (trackerListItem === undefined) {
+                    trackerListItem = new Map();
+                    trackerMap.set(host, trackerListItem);
+                }
+                trackerListItem.set(tracker, new Set(torrents));
+            }
+            updateTrackers = true;
+        }
+        if (responseJSON["trackers_removed"]) {
+            for (let i = 0; i < responseJSON["trackers_removed"].length; ++i) {
+                const tracker = responseJSON["trackers_removed"][i];
+                const host = window.qBittorrent.Misc.getHost(tracker);
+
+                const trackerTorrentMap = trackerMap.get(host);
+                if (trackerTorrentMap !== undefined) {
+                    trackerTorrentMap.delete(tracker);
+                    // Remove unused trackers
+                    if (trackerTorrentMap.size === 0) {
+                        trackerMap.delete(host);
+                        if (selectedTracker === host) {
+                            selectedTracker = TRACKERS_ALL;
+                            localPreferences.set("selected_tracker", selectedTracker);
+                        }
+                    }
+                }
+            }
+            updateTrackers = true;
+        }
+        if (responseJSON["torrents"]) {
+            for (const key in responseJSON["torrents"]) {
+                if (!Object.hasOwn(responseJSON["torrents"], key))
+                    continue;
+
+                responseJSON["torrents"][key]["hash"] = key;
+                responseJSON["torrents"][key]["rowId"] = key;
+                if (responseJSON["torrents"][key]["state"]) {
+                    const state = responseJSON["torrents"][key]["state"];
+                    responseJSON["torrents"][key]["status"] = state;
+                    responseJSON["torrents"][key]["_statusOrder"] = statusSortOrder[state];
+                    updateStatuses = true;
+                }
+                torrentsTable.updateRowData(responseJSON["torrents"][key]);
+                if (addTorrentToCategoryList(responseJSON["torrents"][key]))
+                    updateCategories = true;
+                if (addTorrentToTagList(responseJSON["torrents"][key]))
+                    updateTags = true;
+                updateTrackers = true;
+                updateTorrents = true;
+            }
+        }
+        if (responseJSON["torrents_removed"]) {
+            responseJSON["torrents_removed"].each((hash) => {
+                torrentsTable.removeRow(hash);
+                removeTorrentFromCategoryList(hash);
+                updateCategories = true; // Always to update All category
+                removeTorrentFromTagList(hash);
+                updateTags = true; // Always to update All tag
+                updateTrackers = true;
+            });
+            updateTorrents = true;
+            updateStatuses = true;
+        }
+
+        // don't update the table unnecessarily
+        if (updateTorrents)
+            torrentsTable.updateTable(fullUpdate);
+
+        if (responseJSON["server_state"]) {
+            const tmp = responseJSON["server_state"];
+            for (const k in tmp) {
+                if (!Object.hasOwn(tmp, k))
+                    continue;
+                serverState[k] = tmp[k];
+            }
+            processServerState();
+        }
+
+        if (updateStatuses)
+            updateFiltersList();
+
+        if (updateCategories) {
+            updateCategoryList();
+            window.qBittorrent.TransferList.contextMenu.updateCategoriesSubMenu(window.qBittorrent.Client.categoryMap);
+        }
+        if (updateTags) {
+            updateTagList();
+            window.qBittorrent.TransferList.contextMenu.updateTagsSubMenu(window.qBittorrent.Client.tagMap);
+        }
+        if (updateTrackers)
+            updateTrackerList();
+
+        if (fullUpdate)
+            // re-select previously selected rows
+            torrentsTable.reselectRows(torrentsTableSelectedRows);
+    };
+
+    // The changes are pushed by the server as they occur, the polling is used if the stream isn't available.
+    // The stream doesn't support server views.
+    let mainDataStream = null;
+    let isMainDataStreamSupported = (typeof EventSource !== "undefined");
+    const canStreamMainData = () => {
+        return isMainDataStreamSupported && !torrentsTable.useServerView;
+    };
+
+    const closeMainDataStream = () => {
+        if (mainDataStream === null)
+            return;
+
+        mainDataStream.close();
+        mainDataStream = null;
+    };
+
+    const openMainDataStream = () => {
+        // the stream is opened with the last received ID so that only the changes are sent
+        const url = new URL("api/v2/sync/maindataStream", window.location);
+        url.search = new URLSearchParams({
+            rid: syncMainDataLastResponseId
+        });
+
+        let isEventReceived = false;
+        mainDataStream = new EventSource(url);
+        mainDataStream.addEventListener("message", (event) => {
+            if (window.qBittorrent.Client.isStopped()) {
+                closeMainDataStream();
+                return;
+            }
+
+            isEventReceived = true;
+            document.getElementById("error_div").textContent = "";
+            processMainData(JSON.parse(event.data), null);
+        });
+        mainDataStream.addEventListener("error", () => {
+            // EventSource would reconnect with the ID of the first request so it is reopened manually
+            closeMainDataStream();
+            if (!isEventReceived) {
+                isMainDataStreamSupported = false;
+                syncData(100);
+                return;
+            }
+
+            const errorDiv = document.getElementById("error_div");
+            if (errorDiv)
+                errorDiv.textContent = "QBT_TR(qBittorrent client is not reachable)QBT_TR[CONTEXT=HttpServer]";
+            syncData(2000);
+        });
+    };
+
     let syncMainDataTimeoutID = -1;
     let syncRequestInProgress = false;
     const syncMainData = () => {
+        if (canStreamMainData()) {
+            if (mainDataStream === null)
+                openMainDataStream();
+            return;
+        }
+
+        closeMainDataStream();
         syncRequestInProgress = true;
         const url = new URL("api/v2/sync/maindata", window.location);
+        const viewParams = torrentsTable.getServerViewParams();
         url.search = new URLSearchParams({
-            rid: syncMainDataLastResponseId
+            rid: syncMainDataLastResponseId,
+            ...viewParams
         });
+        torrentsTable.requestedServerViewParams = viewParams;
         fetch(url, {
                 method: "GET",
                 cache: "no-store"
@@ -875,176 +1139,12 @@ window.addEventListener("DOMContentLoaded", (event) => {
             .then(async (response) => {
                     if (response.ok) {
                         document.getElementById("error_div").textContent = "";
-
-                        const responseJSON = await response.json();
-
-                        clearTimeout(torrentsFilterInputTimer);
-                        torrentsFilterInputTimer = -1;
-
-                        let torrentsTableSelectedRows;
-                        let updateStatuses = false;
-                        let updateCategories = false;
-                        let updateTags = false;
-                        let updateTrackers = false;
-                        let updateTorrents = false;
-                        const fullUpdate = (responseJSON["fullUpdate"] === true);
-                        if (fullUpdate) {
-                            torrentsTableSelectedRows = torrentsTable.selectedRowsIds();
-                            updateStatuses = true;
-                            updateCategories = true;
-                            updateTags = true;
-                            updateTrackers = true;
-                            updateTorrents = true;
-                            torrentsTable.clear();
-                            window.qBittorrent.Client.categoryMap.clear();
-                            window.qBittorrent.Client.tagMap.clear();
-                            trackerMap.clear();
-                        }
-                        if (responseJSON["rid"])
-                            syncMainDataLastResponseId = responseJSON["rid"];
-                        if (responseJSON["categories"]) {
-                            for (const responseName in responseJSON["categories"]) {
-                                if (!Object.hasOwn(responseJSON["categories"], responseName))
-                                    continue;
-
-                                const responseData = responseJSON["categories"][responseName];
-                                const categoryData = window.qBittorrent.Client.categoryMap.get(responseName);
-                                if (categoryData === undefined) {
-                                    window.qBittorrent.Client.categoryMap.set(responseName, {
-                                        savePath: responseData.savePath,
-                                        downloadPath: responseData.download_path ?? null,
-                                        torrents: new Set()
-                                    });
-                                }
-                                else {
-                                    if (responseData.savePath !== undefined)
-                                        categoryData.savePath = responseData.savePath;
-                                    if (responseData.download_path !== undefined)
-                                        categoryData.downloadPath = responseData.download_path;
-                                }
-                            }
-                            updateCategories = true;
-                        }
-                        if (responseJSON["categories_removed"]) {
-                            for (const category of responseJSON["categories_removed"])
-                                window.qBittorrent.Client.categoryMap.delete(category);
-                            updateCategories = true;
-                        }
-                        if (responseJSON["tags"]) {
-                            for (const tag of responseJSON["tags"]) {
-                                if (!window.qBittorrent.Client.tagMap.has(tag))
-                                    window.qBittorrent.Client.tagMap.set(tag, new Set());
-                            }
-                            updateTags = true;
-                        }
-                        if (responseJSON["tags_removed"]) {
-                            for (const tag of responseJSON["tags_removed"])
-                                window.qBittorrent.Client.tagMap.delete(tag);
-                            updateTags = true;
-                        }
-                        if (responseJSON["trackers"]) {
-                            for (const [tracker, torrents] of Object.entries(responseJSON["trackers"])) {
-                                const host = window.qBittorrent.Misc.getHost(tracker);
-
-                                let trackerListItem = trackerMap.get(host);
-                                if (trackerListItem === undefined) {
-                                    trackerListItem = new Map();
-                                    trackerMap.set(host, trackerListItem);
-                                }
-                                trackerListItem.set(tracker, new Set(torrents));
-                            }
-                            updateTrackers = true;
-                        }
-                        if (responseJSON["trackers_removed"]) {
-                            for (let i = 0; i < responseJSON["trackers_removed"].length; ++i) {
-                                const tracker = responseJSON["trackers_removed"][i];
-                                const host = window.qBittorrent.Misc.getHost(tracker);
-
-                                const trackerTorrentMap = trackerMap.get(host);
-                                if (trackerTorrentMap !== undefined) {
-                                    trackerTorrentMap.delete(tracker);
-                                    // Remove unused trackers
-                                    if (trackerTorrentMap.size === 0) {
-                                        trackerMap.delete(host);
-                                        if (selectedTracker === host) {
-                                            selectedTracker = TRACKERS_ALL;
-                                            localPreferences.set("selected_tracker", selectedTracker);
-                                        }
-                                    }
-                                }
-                            }
-                            updateTrackers = true;
-                        }
-                        if (responseJSON["torrents"]) {
-                            for (const key in responseJSON["torrents"]) {
-                                if (!Object.hasOwn(responseJSON["torrents"], key))
-                                    continue;
-
-                                responseJSON["torrents"][key]["hash"] = key;
-                                responseJSON["torrents"][key]["rowId"] = key;
-                                if (responseJSON["torrents"][key]["state"]) {
-                                    const state = responseJSON["torrents"][key]["state"];
-                                    responseJSON["torrents"][key]["status"] = state;
-                                    responseJSON["torrents"][key]["_statusOrder"] = statusSortOrder[state];
-                                    updateStatuses = true;
-                                }
-                                torrentsTable.updateRowData(responseJSON["torrents"][key]);
-                                if (addTorrentToCategoryList(responseJSON["torrents"][key]))
-                                    updateCategories = true;
-                                if (addTorrentToTagList(responseJSON["torrents"][key]))
-                                    updateTags = true;
-                                updateTrackers = true;
-                                updateTorrents = true;
-                            }
-                        }
-                        if (responseJSON["torrents_removed"]) {
-                            responseJSON["torrents_removed"].each((hash) => {
-                                torrentsTable.removeRow(hash);
-                                removeTorrentFromCategoryList(hash);
-                                updateCategories = true; // Always to update All category
-                                removeTorrentFromTagList(hash);
-                                updateTags = true; // Always to update All tag
-                                updateTrackers = true;
-                            });
-                            updateTorrents = true;
-                            updateStatuses = true;
-                        }
-
-                        // don't update the table unnecessarily
-                        if (updateTorrents)
-                            torrentsTable.updateTable(fullUpdate);
-
-                        if (responseJSON["server_state"]) {
-                            const tmp = responseJSON["server_state"];
-                            for (const k in tmp) {
-                                if (!Object.hasOwn(tmp, k))
-                                    continue;
-                                serverState[k] = tmp[k];
-                            }
-                            processServerState();
-                        }
-
-                        if (updateStatuses)
-                            updateFiltersList();
-
-                        if (updateCategories) {
-                            updateCategoryList();
-                            window.qBittorrent.TransferList.contextMenu.updateCategoriesSubMenu(window.qBittorrent.Client.categoryMap);
-                        }
-                        if (updateTags) {
-                            updateTagList();
-                            window.qBittorrent.TransferList.contextMenu.updateTagsSubMenu(window.qBittorrent.Client.tagMap);
-                        }
-                        if (updateTrackers)
-                            updateTrackerList();
-
-                        if (fullUpdate)
-                            // re-select previously selected rows
-                            torrentsTable.reselectRows(torrentsTableSelectedRows);
+                        processMainData(await response.json(), viewParams);
                     }
 
                     syncRequestInProgress = false;
-                    syncData(window.qBittorrent.Client.getSyncMainDataInterval());
+                    // the rows scrolled to while the request was in progress are requested right away
+                    syncData(torrentsTable.isServerViewOutdated() ? 100 : window.qBittorrent.Client.getSyncMainDataInterval());
                 },
                 (error) => {
                     const errorDiv = document.getElementById("error_div");
@@ -1075,6 +1175,10 @@ window.addEventListener("DOMContentLoaded", (event) => {
         syncMainDataTimeoutID = syncMainData.delay(delay);
     };
 
+    torrentsTable.onServerViewChanged = () => {
+        syncData(100);
+    };
+
     const processServerState = () => {
         let transfer_info = window.qBittorrent.Misc.friendlyUnit(serverState.dl_info_speed, true);
         if (serverState.dl_rate_limit > 0)
@@ -1096,6 +1200,21 @@ window.addEventListener("DOMContentLoaded", (event) => {
 
         document.getElementById("freeSpaceOnDisk").textContent = "QBT_TR(Free space: %1)QBT_TR[CONTEXT=HttpServer]".replace("%1", window.qBittorrent.Misc.friendlyUnit(serverState.free_space_on_disk));
 
+        const checkingElement = document.getElementById("checkingStatus");
+        if (serverState.checking_torrents > 0) {
+            checkingElement.textContent = "QBT_TR(Checking: %1, ETA: %2)QBT_TR[CONTEXT=StatusBar]"
+                .replace("%1", window.qBittorrent.Misc.friendlyUnit(serverState.checking_speed, true))
+                .replace("%2", window.qBittorrent.Misc.friendlyDuration(serverState.checking_eta, window.qBittorrent.Misc.MAX_ETA));
+            checkingElement.title = "QBT_TR(%1 left to check)QBT_TR[CONTEXT=StatusBar]"
+                .replace("%1", window.qBittorrent.Misc.friendlyUnit(serverState.checking_remaining));
+            checkingElement.classList.remove("invisible");
+            checkingElement.previousElementSibling.classList.remove("invisible");
+        }
+        else {
+            checkingElement.classList.add("invisible");
+            checkingElement.previousElementSibling.classList.add("invisible");
+        }
+
         const externalIPsElement = document.getElementById("externalIPs");
         if (window.qBittorrent.Cache.preferences.get().status_bar_external_ip) {
             const lastExternalAddressV4 = serverState.last_external_address_v4;
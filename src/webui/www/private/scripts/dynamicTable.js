@@ -1096,9 +1096,102 @@ window.qBittorrent.DynamicTable ??= (() => {
     }
 
     class TorrentsTable extends DynamicTable {
+        // number of rows the requested window of the server view is aligned to
+        static #SERVER_VIEW_PAGE_SIZE = 100;
+
         setupVirtualList() {
             super.setupVirtualList();
             this.rowHeight = 22;
+
+            // the server sends only the filtered and sorted torrents around the visible rows
+            this.useServerView = this.useVirtualList && (localPreferences.get("use_server_side_torrent_list", "false") === "true");
+            this.serverView = { offset: 0, torrents: [], total: 0 };
+            this.requestedServerViewParams = null;
+            this.serverFilterCounts = new Map();
+        }
+
+        // called when the rows to show can't be provided without requesting the server
+        onServerViewChanged() {}
+
+        #makeServerFilterParams(filterName, category, tag) {
+            const params = { filter: filterName };
+            if (category !== CATEGORIES_ALL)
+                params.category = (category === CATEGORIES_UNCATEGORIZED) ? "" : category;
+            if (tag !== TAGS_ALL)
+                params.tag = (tag === TAGS_UNTAGGED) ? "" : tag;
+
+            // the server matches the torrent name only
+            const filterText = document.getElementById("torrentsFilterInput").value.trim();
+            if ((filterText.length > 0) && (document.getElementById("torrentsFilterSelect").value === "name"))
+                params.search = filterText;
+
+            return params;
+        }
+
+        getServerViewParams() {
+            if (!this.useServerView)
+                return null;
+
+            const params = this.#makeServerFilterParams(selectedStatus, selectedCategory, selectedTag);
+            if (selectedTracker === TRACKERS_TRACKERLESS)
+                params.tracker = "";
+            else if (![TRACKERS_ALL, TRACKERS_ANNOUNCE_ERROR, TRACKERS_ERROR, TRACKERS_WARNING].includes(selectedTracker))
+                params.tracker = selectedTracker;
+
+            const column = this.columns[this.sortedColumn];
+            params.sort = (column.name === "status") ? "state" : column.dataProperties[0];
+            params.reverse = (this.reverseSort === "1");
+
+            // request whole pages around the visible rows so that the window isn't changed on every scroll
+            const pageSize = TorrentsTable.#SERVER_VIEW_PAGE_SIZE;
+            const firstVisibleRow = Math.trunc(this.renderedOffset / this.rowHeight);
+            const lastVisibleRow = firstVisibleRow + Math.ceil(this.renderedHeight / this.rowHeight);
+            params.offset = Math.max(((Math.trunc(firstVisibleRow / pageSize) - 1) * pageSize), 0);
+            params.limit = ((Math.trunc(lastVisibleRow / pageSize) + 2) * pageSize) - params.offset;
+
+            return params;
+        }
+
+        isServerViewOutdated() {
+            if (!this.useServerView)
+                return false;
+
+            return JSON.stringify(this.getServerViewParams()) !== JSON.stringify(this.requestedServerViewParams);
+        }
+
+        setServerView(offset, torrents, total) {
+            this.serverView = { offset: offset, torrents: torrents, total: total };
+        }
+
+        updateServerFilterCounts(filterCounts, fullUpdate) {
+            if (fullUpdate)
+                this.serverFilterCounts.clear();
+
+            for (const [group, counts] of Object.entries(filterCounts ?? {})) {
+                let groupCounts = this.serverFilterCounts.get(group);
+                if (groupCounts === undefined) {
+                    groupCounts = new Map();
+                    this.serverFilterCounts.set(group, groupCounts);
+                }
+
+                for (const [name, count] of Object.entries(counts)) {
+                    if (count > 0)
+                        groupCounts.set(name, count);
+                    else
+                        groupCounts.delete(name);
+                }
+            }
+        }
+
+        getServerFilterCount(group, name) {
+            return this.serverFilterCounts.get(group)?.get(name) ?? 0;
+        }
+
+        rerender(rows = this.getFilteredAndSortedRows()) {
+            super.rerender(rows);
+
+            if (this.isServerViewOutdated())
+                this.onServerViewChanged();
         }
 
         initColumns() {
@@ -1716,6 +1809,29 @@ window.qBittorrent.DynamicTable ??= (() => {
         }
 
         getFilteredTorrentsNumber(filterName, category, tag, tracker) {
+            if (this.useServerView) {
+                // only the counts of a single filter are known
+                if (category === CATEGORIES_UNCATEGORIZED)
+                    return this.getServerFilterCount("category", "");
+                if (category !== CATEGORIES_ALL) {
+                    let count = this.getServerFilterCount("category", category);
+                    if (useSubcategories) {
+                        for (const [name, subcategoryCount] of this.serverFilterCounts.get("category") ?? []) {
+                            if (name.startsWith(`${category}/`))
+                                count += subcategoryCount;
+                        }
+                    }
+                    return count;
+                }
+                if (tag !== TAGS_ALL)
+                    return this.getServerFilterCount("tag", ((tag === TAGS_UNTAGGED) ? "" : tag));
+                if (tracker === TRACKERS_TRACKERLESS)
+                    return this.getServerFilterCount("tracker", "");
+                if (tracker !== TRACKERS_ALL)
+                    return this.getServerFilterCount("tracker", tracker);
+                return this.getServerFilterCount("status", filterName);
+            }
+
             let cnt = 0;
 
             for (const row of this.rows.values()) {
@@ -1747,7 +1863,52 @@ window.qBittorrent.DynamicTable ??= (() => {
             return rowsHashes;
         }
 
+        // Unlike getFilteredTorrentsHashes() it also provides the torrents that aren't loaded from the server view
+        async fetchFilteredTorrentsHashes(filterName, category, tag, tracker) {
+            if (!this.useServerView)
+                return this.getFilteredTorrentsHashes(filterName, category, tag, tracker);
+
+            const url = new URL("api/v2/torrents/info", window.location);
+            url.search = new URLSearchParams({
+                ...this.#makeServerFilterParams(filterName, category, tag),
+                fields: "hash|trackers_count"
+            });
+            const response = await fetch(url, {
+                method: "GET",
+                cache: "no-store"
+            });
+            if (!response.ok)
+                return [];
+
+            let torrents = await response.json();
+            if (tracker === TRACKERS_TRACKERLESS) {
+                torrents = torrents.filter(torrent => (torrent.trackers_count === 0));
+            }
+            else if (tracker !== TRACKERS_ALL) {
+                const trackerTorrents = new Set();
+                for (const torrentIDs of trackerMap.get(tracker)?.values() ?? []) {
+                    for (const torrentID of torrentIDs)
+                        trackerTorrents.add(torrentID);
+                }
+                torrents = torrents.filter(torrent => trackerTorrents.has(torrent.hash));
+            }
+            return torrents.map(torrent => torrent.hash);
+        }
+
         getFilteredAndSortedRows() {
+            if (this.useServerView) {
+                // the rows are placed at their positions in the whole view
+                const rows = new Array(this.serverView.total);
+                for (const [i, rowId] of this.serverView.torrents.entries()) {
+                    const row = this.rows.get(rowId);
+                    if (row === undefined)
+                        continue;
+                    rows[this.serverView.offset + i] = row;
+                    rows[rowId] = row;
+                }
+                return rows;
+            }
+
             const filteredRows = [];
 
             const useRegex = document.getElementById("torrentsFilterRegexBox").checked;
@@ -509,7 +509,7 @@ const initializeWindows = () => {
             maximizable: false,
             padding: 10,
             width: loadWindowWidth(id, 285),
-            height: loadWindowHeight(id, 415),
+            height: loadWindowHeight(id, 600),
             onResize: window.qBittorrent.Misc.createDebounceHandler(500, (e) => {
                 saveWindowSize(id);
             }),
@@ -787,8 +787,8 @@ const initializeWindows = () => {
         }
     };
 
-    startVisibleTorrentsFN = () => {
-        const hashes = torrentsTable.getFilteredTorrentsHashes(selectedStatus, selectedCategory, selectedTag, selectedTracker);
+    startVisibleTorrentsFN = async () => {
+        const hashes = await torrentsTable.fetchFilteredTorrentsHashes(selectedStatus, selectedCategory, selectedTag, selectedTracker);
         if (hashes.length > 0) {
             fetch("api/v2/torrents/start", {
                     method: "POST",
@@ -808,8 +808,8 @@ const initializeWindows = () => {
         }
     };
 
-    stopVisibleTorrentsFN = () => {
-        const hashes = torrentsTable.getFilteredTorrentsHashes(selectedStatus, selectedCategory, selectedTag, selectedTracker);
+    stopVisibleTorrentsFN = async () => {
+        const hashes = await torrentsTable.fetchFilteredTorrentsHashes(selectedStatus, selectedCategory, selectedTag, selectedTracker);
         if (hashes.length > 0) {
             fetch("api/v2/torrents/stop", {
                     method: "POST",
@@ -829,8 +829,8 @@ const initializeWindows = () => {
         }
     };
 
-    deleteVisibleTorrentsFN = () => {
-        const hashes = torrentsTable.getFilteredTorrentsHashes(selectedStatus, selectedCategory, selectedTag, selectedTracker);
+    deleteVisibleTorrentsFN = async () => {
+        const hashes = await torrentsTable.fetchFilteredTorrentsHashes(selectedStatus, selectedCategory, selectedTag, selectedTracker);
         if (hashes.length > 0) {
             if (window.qBittorrent.Cache.preferences.get().confirm_torrent_deletion) {
                 new MochaUI.Modal({
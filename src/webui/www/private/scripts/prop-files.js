@@ -62,6 +62,10 @@ window.qBittorrent.PropFiles ??= (() => {
             });
     };
 
+    // files of the current torrent, updated with the changes since the last response
+    let torrentFiles = [];
+    let torrentFilesRid = 0;
+
     let loadTorrentFilesDataTimer = -1;
     const loadTorrentFilesData = () => {
         if (document.hidden)
@@ -86,7 +90,8 @@ window.qBittorrent.PropFiles ??= (() => {
 
         const url = new URL("api/v2/torrents/files", window.location);
         url.search = new URLSearchParams({
-            hash: current_hash
+            hash: current_hash,
+            rid: (loadedNewTorrent ? 0 : torrentFilesRid)
         });
         fetch(url, {
                 method: "GET",
@@ -96,7 +101,16 @@ window.qBittorrent.PropFiles ??= (() => {
                 if (!response.ok)
                     return;
 
-                const files = await response.json();
+                const data = await response.json();
+                if (data.full_update) {
+                    torrentFiles = data.files;
+                }
+                else {
+                    for (const changedFile of data.files)
+                        Object.assign(torrentFiles[changedFile.index], changedFile);
+                }
+                torrentFilesRid = data.rid;
+                const files = torrentFiles;
 
                 window.qBittorrent.TorrentContent.clearFilterInputTimer();
 
@@ -42,6 +42,30 @@ window.qBittorrent.PropGeneral ??= (() => {
     });
     document.getElementById("progress").appendChild(piecesBar);
 
+    // piece states of the current torrent, updated incrementally using the token of the last response
+    let pieceStates = {
+        hash: "",
+        token: null,
+        states: []
+    };
+
+    const updatePieceStates = (hash, data) => {
+        if (data.states !== undefined) {
+            const packedStates = Uint8Array.from(window.atob(data.states), (c) => c.charCodeAt(0));
+            const states = new Array(data.pieces_count);
+            for (let i = 0; i < data.pieces_count; ++i)
+                states[i] = (packedStates[i >> 2] >> ((i & 3) * 2)) & 0b11;
+            pieceStates.states = states;
+        }
+        else {
+            for (const [index, state] of data.changes)
+                pieceStates.states[index] = state;
+        }
+        pieceStates.hash = hash;
+        pieceStates.token = data.token;
+        return pieceStates.states;
+    };
+
     const clearData = () => {
         document.getElementById("progressPercentage").textContent = "";
         document.getElementById("time_elapsed").textContent = "";
@@ -72,6 +96,11 @@ window.qBittorrent.PropGeneral ??= (() => {
         document.getElementById("comment").textContent = "";
         document.getElementById("private").textContent = "";
         piecesBar.clear();
+        pieceStates = {
+            hash: "",
+            token: null,
+            states: []
+        };
     };
 
     let loadTorrentDataTimer = -1;
@@ -243,9 +272,13 @@ window.qBittorrent.PropGeneral ??= (() => {
             });
 
         const pieceStatesURL = new URL("api/v2/torrents/pieceStates", window.location);
-        pieceStatesURL.search = new URLSearchParams({
-            hash: current_id
+        const pieceStatesParams = new URLSearchParams({
+            hash: current_id,
+            format: "compact"
         });
+        if ((pieceStates.hash === current_id) && (pieceStates.token !== null))
+            pieceStatesParams.set("since", pieceStates.token);
+        pieceStatesURL.search = pieceStatesParams;
         fetch(pieceStatesURL, {
                 method: "GET",
                 cache: "no-store"
@@ -262,7 +295,7 @@ window.qBittorrent.PropGeneral ??= (() => {
 
                 const data = await response.json();
                 if (data)
-                    piecesBar.setPieces(data);
+                    piecesBar.setPieces(updatePieceStates(current_id, data));
                 else
                     clearData();
 
@@ -47,6 +47,15 @@ window.qBittorrent.Statistics ??= (() => {
         totalQueuedSize: 0,
     };
 
+    const transferHistory = {
+        dlSpeedDay: { average: 0, peak: 0 },
+        ulSpeedDay: { average: 0, peak: 0 },
+        dlSpeedWeek: { average: 0, peak: 0 },
+        ulSpeedWeek: { average: 0, peak: 0 },
+    };
+    const HISTORY_UPDATE_INTERVAL = 60000; // ms
+    let historyUpdateTime = 0;
+
     const save = (serverState) => {
         statistics.alltimeDL = serverState.alltime_dl;
         statistics.alltimeUL = serverState.alltime_ul;
@@ -62,10 +71,70 @@ window.qBittorrent.Statistics ??= (() => {
         statistics.totalQueuedSize = serverState.total_queued_size;
     };
 
+    const summarizeHistory = (buckets, key) => {
+        // each rate is [min, avg, max]
+        let sum = 0;
+        let peak = 0;
+        for (const bucket of buckets) {
+            sum += bucket[key][1];
+            peak = Math.max(peak, bucket[key][2]);
+        }
+        return {
+            average: (buckets.length > 0) ? Math.round(sum / buckets.length) : 0,
+            peak: peak
+        };
+    };
+
+    const updateHistory = () => {
+        historyUpdateTime = Date.now();
+
+        const now = Math.floor(historyUpdateTime / 1000);
+        const url = new URL("api/v2/transfer/speedHistory", window.location);
+        url.search = new URLSearchParams({
+            resolution: "hour",
+            since: now - (7 * 24 * 60 * 60)
+        });
+        fetch(url, {
+                method: "GET",
+                cache: "no-store"
+            })
+            .then(async (response) => {
+                if (!response.ok)
+                    return;
+
+                const weekBuckets = await response.json();
+                const dayBuckets = weekBuckets.filter((bucket) => bucket.t >= (now - (24 * 60 * 60)));
+                transferHistory.dlSpeedDay = summarizeHistory(dayBuckets, "dl");
+                transferHistory.ulSpeedDay = summarizeHistory(dayBuckets, "up");
+                transferHistory.dlSpeedWeek = summarizeHistory(weekBuckets, "dl");
+                transferHistory.ulSpeedWeek = summarizeHistory(weekBuckets, "up");
+                renderHistory();
+            });
+    };
+
+    const renderHistory = () => {
+        if (!document.getElementById("statisticsContent"))
+            return;
+
+        const friendlySpeed = (value) => window.qBittorrent.Misc.friendlyUnit(value, true);
+        document.getElementById("AverageDLSpeedDay").textContent = friendlySpeed(transferHistory.dlSpeedDay.average);
+        document.getElementById("PeakDLSpeedDay").textContent = friendlySpeed(transferHistory.dlSpeedDay.peak);
+        document.getElementById("AverageULSpeedDay").textContent = friendlySpeed(transferHistory.ulSpeedDay.average);
+        document.getElementById("PeakULSpeedDay").textContent = friendlySpeed(transferHistory.ulSpeedDay.peak);
+        document.getElementById("AverageDLSpeedWeek").textContent = friendlySpeed(transferHistory.dlSpeedWeek.average);
+        document.getElementById("PeakDLSpeedWeek").textContent = friendlySpeed(transferHistory.dlSpeedWeek.peak);
+        document.getElementById("AverageULSpeedWeek").textContent = friendlySpeed(transferHistory.ulSpeedWeek.average);
+        document.getElementById("PeakULSpeedWeek").textContent = friendlySpeed(transferHistory.ulSpeedWeek.peak);
+    };
+
     const render = () => {
         if (!document.getElementById("statisticsContent"))
             return;
 
+        // history changes slowly so it is only requested while the statistics are displayed
+        if ((Date.now() - historyUpdateTime) >= HISTORY_UPDATE_INTERVAL)
+            updateHistory();
+
         document.getElementById("AlltimeDL").textContent = window.qBittorrent.Misc.friendlyUnit(statistics.alltimeDL, false);
         document.getElementById("AlltimeUL").textContent = window.qBittorrent.Misc.friendlyUnit(statistics.alltimeUL, false);
         document.getElementById("TotalWastedSession").textContent = window.qBittorrent.Misc.friendlyUnit(statistics.totalWastedSession, false);
@@ -78,6 +147,7 @@ window.qBittorrent.Statistics ??= (() => {
         document.getElementById("QueuedIOJobs").textContent = statistics.queuedIOJobs;
         document.getElementById("AverageTimeInQueue").textContent = `${statistics.averageTimeInQueue} ms`;
         document.getElementById("TotalQueuedSize").textContent = window.qBittorrent.Misc.friendlyUnit(statistics.totalQueuedSize, false);
+        renderHistory();
     };
 
     return exports();
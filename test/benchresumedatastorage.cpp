@@ -0,0 +1,275 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include <QEventLoop>
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/bencoderesumedatastorage.h"
+#include "base/bittorrent/dbresumedatastorage.h"
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/journalresumedatastorage.h"
+#include "base/bittorrent/loadtorrentparams.h"
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrentinfo.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/path.h"
+#include "base/preferences.h"
+#include "base/profile.h"
+#include "base/settingsstorage.h"
+#include "base/tag.h"
+
+using BitTorrent::ResumeDataStorageType;
+
+namespace
+{
+    // Shape of the synthetic profile
+    const int FILES_PER_TORRENT = 10;
+    const int TRACKERS_PER_TORRENT = 3;
+    const int TAGS_PER_TORRENT = 2;
+    const int TAGS_COUNT = 20;
+    const int CATEGORIES_COUNT = 10;
+    const std::int64_t FILE_SIZE = 64 * 1024 * 1024;
+    const int PIECE_SIZE = 1024 * 1024;
+
+    struct SyntheticTorrent
+    {
+        BitTorrent::TorrentID id;
+        BitTorrent::LoadTorrentParams params;
+    };
+
+    SyntheticTorrent makeSyntheticTorrent(const int index)
+    {
+        const std::string torrentName = u"Synthetic torrent %1"_s.arg(index).toStdString();
+
+        lt::file_storage files;
+        for (int i = 0; i < FILES_PER_TORRENT; ++i)
+            files.add_file((torrentName + "/file " + std::to_string(i) + ".bin"), FILE_SIZE);
+
+#ifdef QBT_USES_LIBTORRENT2
+        lt::create_torrent creator {files, PIECE_SIZE, lt::create_torrent::v1_only};
+#else
+        lt::create_torrent creator {files, PIECE_SIZE};
+#endif
+        for (int i = 0; i < creator.num_pieces(); ++i)
+            creator.set_hash(lt::piece_index_t {i}, lt::sha1_hash {});
+
+        std::vector<char> buffer;
+        lt::bencode(std::back_inserter(buffer), creator.generate());
+        const auto nativeInfo = std::make_shared<lt::torrent_info>(buffer, lt::from_span);
+
+        BitTorrent::LoadTorrentParams params;
+        params.ltAddTorrentParams.ti = nativeInfo;
+        params.ltAddTorrentParams.save_path = "/downloads";
+        params.ltAddTorrentParams.have_pieces.resize(nativeInfo->num_pieces(), ((index % 2) == 0));
+        params.ltAddTorrentParams.total_uploaded = index * FILE_SIZE;
+        params.ltAddTorrentParams.total_downloaded = index * FILE_SIZE;
+        for (int i = 0; i < TRACKERS_PER_TORRENT; ++i)
+        {
+            params.ltAddTorrentParams.trackers.push_back("http://tracker" + std::to_string(i) + ".example.com/announce");
+            params.ltAddTorrentParams.tracker_tiers.push_back(i);
+        }
+
+        params.name = QString::fromStdString(torrentName);
+        params.category = u"category %1"_s.arg(index % CATEGORIES_COUNT);
+        for (int i = 0; i < TAGS_PER_TORRENT; ++i)
+            params.tags.insert(Tag(u"tag %1"_s.arg((index + i) % TAGS_COUNT)));
+        params.savePath = Path(u"/downloads"_s);
+        params.stopped = ((index % 3) == 0);
+
+        return {.id = BitTorrent::TorrentID::fromInfoHash(BitTorrent::TorrentInfo(*nativeInfo).infoHash()), .params = std::move(params)};
+    }
+
+    std::unique_ptr<BitTorrent::ResumeDataStorage> createStorage(const ResumeDataStorageType type, const Path &path)
+    {
+        switch (type)
+        {
+        case ResumeDataStorageType::SQLite:
+            return std::make_unique<BitTorrent::DBResumeDataStorage>(path);
+        case ResumeDataStorageType::Journal:
+            return std::make_unique<BitTorrent::JournalResumeDataStorage>(path);
+        default:
+            return std::make_unique<BitTorrent::BencodeResumeDataStorage>(path);
+        }
+    }
+
+    // Storages perform the I/O in their own threads, destroying them waits until all the jobs are done
+    void storeAll(const ResumeDataStorageType type, const Path &path, const QList<SyntheticTorrent> &torrents)
+    {
+        const std::unique_ptr<BitTorrent::ResumeDataStorage> storage = createStorage(type, path);
+        QList<BitTorrent::TorrentID> queue;
+        queue.reserve(torrents.size());
+        for (const SyntheticTorrent &torrent : torrents)
+        {
+            storage->store(torrent.id, torrent.params);
+            queue.append(torrent.id);
+        }
+        storage->storeQueue(queue);
+    }
+}
+
+class BenchResumeDataStorage final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchResumeDataStorage)
+
+public:
+    BenchResumeDataStorage() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_profileDir.isValid());
+
+        Logger::initInstance();
+        Profile::initInstance(Path(m_profileDir.path()), {}, false);
+        SettingsStorage::initInstance();
+        Preferences::initInstance();
+    }
+
+    void cleanupTestCase()
+    {
+        Preferences::freeInstance();
+        SettingsStorage::freeInstance();
+        Profile::freeInstance();
+        Logger::freeInstance();
+    }
+
+    void benchStore_data() const
+    {
+        addStorageRows();
+    }
+
+    void benchStore()
+    {
+        QFETCH(ResumeDataStorageType, storageType);
+        QFETCH(int, torrentsCount);
+
+        const QList<SyntheticTorrent> &torrents = syntheticTorrents(torrentsCount);
+        int run = 0;
+        QBENCHMARK
+        {
+            const Path path = storagePath(storageType, u"store-%1-%2"_s.arg(torrentsCount).arg(run++));
+            storeAll(storageType, path, torrents);
+        }
+    }
+
+    void benchLoadAll_data() const
+    {
+        addStorageRows();
+    }
+
+    void benchLoadAll()
+    {
+        QFETCH(ResumeDataStorageType, storageType);
+        QFETCH(int, torrentsCount);
+
+        const Path path = storagePath(storageType, u"load-%1"_s.arg(torrentsCount));
+        storeAll(storageType, path, syntheticTorrents(torrentsCount));
+
+        QBENCHMARK
+        {
+            const std::unique_ptr<BitTorrent::ResumeDataStorage> storage = createStorage(storageType, path);
+
+            QEventLoop loop;
+            connect(storage.get(), &BitTorrent::ResumeDataStorage::loadFinished, &loop, &QEventLoop::quit);
+            storage->loadAll();
+            loop.exec();
+
+            const QList<BitTorrent::LoadedResumeData> loadedResumeData = storage->fetchLoadedResumeData();
+            QCOMPARE(loadedResumeData.size(), torrentsCount);
+            QVERIFY(std::ranges::all_of(loadedResumeData, [](const BitTorrent::LoadedResumeData &data) { return data.result.has_value(); }));
+        }
+    }
+
+private:
+    static void addStorageRows()
+    {
+        QTest::addColumn<ResumeDataStorageType>("storageType");
+        QTest::addColumn<int>("torrentsCount");
+
+        const QList<std::pair<ResumeDataStorageType, QString>> storageTypes {
+            {ResumeDataStorageType::Legacy, u"bencode"_s},
+            {ResumeDataStorageType::SQLite, u"sqlite"_s},
+            {ResumeDataStorageType::Journal, u"journal"_s}
+        };
+        for (const auto &[type, typeName] : storageTypes)
+        {
+            for (const int count : {100, 1000, 10000})
+                QTest::addRow("%s/%d", qPrintable(typeName), count) << type << count;
+        }
+    }
+
+    const QList<SyntheticTorrent> &syntheticTorrents(const int count)
+    {
+        QList<SyntheticTorrent> &torrents = m_syntheticTorrents[count];
+        if (torrents.isEmpty())
+        {
+            torrents.reserve(count);
+            for (int i = 0; i < count; ++i)
+                torrents.append(makeSyntheticTorrent(i));
+        }
+        return torrents;
+    }
+
+    Path storagePath(const ResumeDataStorageType type, const QString &name) const
+    {
+        const Path basePath = Path(m_profileDir.path()) / Path(name);
+        switch (type)
+        {
+        case ResumeDataStorageType::SQLite:
+            return basePath + u".sqlite";
+        case ResumeDataStorageType::Journal:
+            return basePath + u".journal";
+        default:
+            return basePath;
+        }
+    }
+
+    QTemporaryDir m_profileDir;
+    QHash<int, QList<SyntheticTorrent>> m_syntheticTorrents;
+};
+
+QTEST_GUILESS_MAIN(BenchResumeDataStorage)
+#include "benchresumedatastorage.moc"
@@ -0,0 +1,164 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <libtorrent/add_torrent_params.hpp>
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include <QTest>
+
+#include "base/bittorrent/addtorrentparams.h"
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrentdescriptor.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/net/downloadmanager.h"
+#include "base/net/proxyconfigurationmanager.h"
+#include "base/path.h"
+#include "base/preferences.h"
+#include "base/profile.h"
+#include "base/settingsstorage.h"
+#include "base/tag.h"
+#include "base/torrentfilterindex.h"
+
+// Session populated with synthetic torrents for the benchmarks of the torrent views.
+// The torrents are added stopped and don't have any data on disk, so nothing is checked or downloaded.
+namespace SyntheticSession
+{
+    // Shape of the synthetic profile
+    inline constexpr int TORRENTS_COUNT = 10000;
+    inline constexpr int FILES_PER_TORRENT = 10;
+    inline constexpr int TRACKERS_PER_TORRENT = 3;
+    inline constexpr int TAGS_PER_TORRENT = 2;
+    inline constexpr int TAGS_COUNT = 20;
+    inline constexpr int CATEGORIES_COUNT = 10;
+    inline constexpr int PIECE_SIZE = 1024 * 1024;
+
+    inline QString syntheticCategory(const int index)
+    {
+        return u"category %1"_s.arg(index % CATEGORIES_COUNT);
+    }
+
+    inline Tag syntheticTag(const int index)
+    {
+        return Tag(u"tag %1"_s.arg(index % TAGS_COUNT));
+    }
+
+    inline BitTorrent::TorrentDescriptor makeTorrentDescriptor(const int index)
+    {
+        const std::string torrentName = u"Synthetic torrent %1"_s.arg(index).toStdString();
+        // Sizes differ between the torrents so sorting by size doesn't degenerate
+        const std::int64_t fileSize = static_cast<std::int64_t>((index % 97) + 1) * PIECE_SIZE;
+
+        lt::file_storage files;
+        for (int i = 0; i < FILES_PER_TORRENT; ++i)
+            files.add_file((torrentName + "/file " + std::to_string(i) + ".bin"), fileSize);
+
+#ifdef QBT_USES_LIBTORRENT2
+        lt::create_torrent creator {files, PIECE_SIZE, lt::create_torrent::v1_only};
+#else
+        lt::create_torrent creator {files, PIECE_SIZE};
+#endif
+        for (int i = 0; i < creator.num_pieces(); ++i)
+            creator.set_hash(lt::piece_index_t {i}, lt::sha1_hash {});
+        for (int i = 0; i < TRACKERS_PER_TORRENT; ++i)
+            creator.add_tracker(("http://tracker" + std::to_string((index + i) % 50) + ".example.com/announce"), i);
+
+        std::vector<char> buffer;
+        lt::bencode(std::back_inserter(buffer), creator.generate());
+
+        lt::add_torrent_params ltParams;
+        ltParams.ti = std::make_shared<lt::torrent_info>(buffer, lt::from_span);
+        return BitTorrent::TorrentDescriptor(std::move(ltParams));
+    }
+
+    // Initializes the application components in the same order as Application does
+    // and waits until the given number of synthetic torrents is loaded
+    inline bool init(const Path &profilePath, const int torrentsCount = TORRENTS_COUNT)
+    {
+        Logger::initInstance();
+        Profile::initInstance(profilePath, {}, false);
+        SettingsStorage::initInstance();
+        Preferences::initInstance();
+        Net::ProxyConfigurationManager::initInstance();
+        Net::DownloadManager::initInstance();
+        BitTorrent::Session::initInstance();
+        TorrentFilterIndex::initInstance();
+
+        auto *session = BitTorrent::Session::instance();
+        session->setDHTEnabled(false);
+        session->setLSDEnabled(false);
+        session->setPeXEnabled(false);
+        if (!QTest::qWaitFor([session] { return session->isRestored(); }, 60'000))
+            return false;
+
+        for (int i = 0; i < CATEGORIES_COUNT; ++i)
+            session->addCategory(syntheticCategory(i));
+        for (int i = 0; i < TAGS_COUNT; ++i)
+            session->addTag(syntheticTag(i));
+
+        const Path savePath = profilePath / Path(u"downloads"_s);
+        for (int i = 0; i < torrentsCount; ++i)
+        {
+            BitTorrent::AddTorrentParams params;
+            params.category = syntheticCategory(i);
+            for (int j = 0; j < TAGS_PER_TORRENT; ++j)
+                params.tags.insert(syntheticTag(i + j));
+            params.savePath = savePath;
+            params.useAutoTMM = false;
+            params.addStopped = true;
+            params.skipChecking = true;
+            if (!session->addTorrent(makeTorrentDescriptor(i), params))
+                return false;
+        }
+
+        return QTest::qWaitFor([session, torrentsCount] { return (session->torrentsCount() == torrentsCount); }, 600'000);
+    }
+
+    inline void free()
+    {
+        TorrentFilterIndex::freeInstance();
+        BitTorrent::Session::freeInstance();
+        Net::DownloadManager::freeInstance();
+        Net::ProxyConfigurationManager::freeInstance();
+        Preferences::freeInstance();
+        SettingsStorage::freeInstance();
+        Profile::freeInstance();
+        Logger::freeInstance();
+    }
+}
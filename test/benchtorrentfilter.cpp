@@ -0,0 +1,151 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+#include <optional>
+
+#include <QBitArray>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrent.h"
+#include "base/global.h"
+#include "base/path.h"
+#include "base/tag.h"
+#include "base/torrentfilter.h"
+#include "base/torrentfilterindex.h"
+#include "benchsyntheticsession.h"
+
+class BenchTorrentFilter final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchTorrentFilter)
+
+public:
+    BenchTorrentFilter() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_profileDir.isValid());
+        QVERIFY(SyntheticSession::init(Path(m_profileDir.path())));
+    }
+
+    void cleanupTestCase()
+    {
+        SyntheticSession::free();
+    }
+
+    void benchMatch_data() const
+    {
+        addFilterRows();
+    }
+
+    void benchMatch()
+    {
+        QFETCH(TorrentFilter::Type, type);
+        QFETCH(std::optional<QString>, category);
+        QFETCH(std::optional<Tag>, tag);
+
+        const TorrentFilter filter {type, TorrentFilter::AnyID, category, tag};
+        const QList<BitTorrent::Torrent *> torrents = BitTorrent::Session::instance()->torrents();
+        qsizetype matchedCount = 0;
+        QBENCHMARK
+        {
+            matchedCount = std::ranges::count_if(torrents, [&filter](const BitTorrent::Torrent *torrent) { return filter.match(torrent); });
+        }
+        QVERIFY(matchedCount <= torrents.size());
+    }
+
+    void benchMatchingTorrents_data() const
+    {
+        addFilterRows();
+    }
+
+    void benchMatchingTorrents()
+    {
+        QFETCH(TorrentFilter::Type, type);
+        QFETCH(std::optional<QString>, category);
+        QFETCH(std::optional<Tag>, tag);
+
+        const TorrentFilterIndex *index = TorrentFilterIndex::instance();
+        QBitArray matched;
+        QBENCHMARK
+        {
+            matched = index->matchingTorrents(type, category, tag);
+        }
+        QVERIFY(matched.count(true) <= BitTorrent::Session::instance()->torrentsCount());
+    }
+
+    void benchMatchingNameTorrents_data() const
+    {
+        QTest::addColumn<QString>("text");
+
+        QTest::newRow("common") << u"torrent"_s;
+        QTest::newRow("selective") << u"torrent 123"_s;
+        QTest::newRow("missing") << u"nonexistent"_s;
+    }
+
+    void benchMatchingNameTorrents()
+    {
+        QFETCH(QString, text);
+
+        const TorrentFilterIndex *index = TorrentFilterIndex::instance();
+        QBitArray matched;
+        QBENCHMARK
+        {
+            matched = index->matchingNameTorrents(text);
+        }
+        QVERIFY(matched.count(true) <= BitTorrent::Session::instance()->torrentsCount());
+    }
+
+private:
+    static void addFilterRows()
+    {
+        QTest::addColumn<TorrentFilter::Type>("type");
+        QTest::addColumn<std::optional<QString>>("category");
+        QTest::addColumn<std::optional<Tag>>("tag");
+
+        const QString category = SyntheticSession::syntheticCategory(1);
+        const Tag tag = SyntheticSession::syntheticTag(1);
+        QTest::newRow("all") << TorrentFilter::All << TorrentFilter::AnyCategory << TorrentFilter::AnyTag;
+        QTest::newRow("status") << TorrentFilter::Stopped << TorrentFilter::AnyCategory << TorrentFilter::AnyTag;
+        QTest::newRow("category") << TorrentFilter::All << std::optional<QString>(category) << TorrentFilter::AnyTag;
+        QTest::newRow("tag") << TorrentFilter::All << TorrentFilter::AnyCategory << std::optional<Tag>(tag);
+        QTest::newRow("status/category/tag") << TorrentFilter::Stopped << std::optional<QString>(category) << std::optional<Tag>(tag);
+    }
+
+    QTemporaryDir m_profileDir;
+};
+
+QTEST_GUILESS_MAIN(BenchTorrentFilter)
+#include "benchtorrentfilter.moc"
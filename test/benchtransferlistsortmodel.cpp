@@ -0,0 +1,173 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QString>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/path.h"
+#include "base/tag.h"
+#include "base/torrentfilter.h"
+#include "gui/transferlistmodel.h"
+#include "gui/transferlistsortmodel.h"
+#include "gui/uithememanager.h"
+#include "benchsyntheticsession.h"
+
+class BenchTransferListSortModel final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchTransferListSortModel)
+
+public:
+    BenchTransferListSortModel() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_profileDir.isValid());
+        QVERIFY(SyntheticSession::init(Path(m_profileDir.path())));
+        UIThemeManager::initInstance();
+
+        m_listModel = new TransferListModel(this);
+        QCOMPARE(m_listModel->rowCount(), SyntheticSession::TORRENTS_COUNT);
+    }
+
+    void cleanupTestCase()
+    {
+        delete m_listModel;
+        UIThemeManager::freeInstance();
+        SyntheticSession::free();
+    }
+
+    // Sorting from scratch, i.e. the sort keys of the column aren't cached yet
+    void benchSort_data() const
+    {
+        QTest::addColumn<int>("column");
+
+        QTest::newRow("name") << static_cast<int>(TransferListModel::TR_NAME);
+        QTest::newRow("size") << static_cast<int>(TransferListModel::TR_SIZE);
+        QTest::newRow("progress") << static_cast<int>(TransferListModel::TR_PROGRESS);
+        QTest::newRow("status") << static_cast<int>(TransferListModel::TR_STATUS);
+        QTest::newRow("ratio") << static_cast<int>(TransferListModel::TR_RATIO);
+        QTest::newRow("added on") << static_cast<int>(TransferListModel::TR_ADD_DATE);
+    }
+
+    void benchSort()
+    {
+        QFETCH(int, column);
+
+        QBENCHMARK
+        {
+            TransferListSortModel sortModel;
+            setupSortModel(sortModel);
+            sortModel.sort(column);
+            QCOMPARE(sortModel.rowCount(), SyntheticSession::TORRENTS_COUNT);
+        }
+    }
+
+    // Sorting again in the other order, the sort keys are already cached
+    void benchResort()
+    {
+        TransferListSortModel sortModel;
+        setupSortModel(sortModel);
+        sortModel.sort(TransferListModel::TR_NAME);
+
+        Qt::SortOrder order = Qt::DescendingOrder;
+        QBENCHMARK
+        {
+            sortModel.sort(TransferListModel::TR_NAME, order);
+            order = (order == Qt::AscendingOrder) ? Qt::DescendingOrder : Qt::AscendingOrder;
+        }
+    }
+
+    // Switching the filters of the sidebar while the list is sorted
+    void benchFilter_data() const
+    {
+        QTest::addColumn<TorrentFilter::Type>("status");
+        QTest::addColumn<QString>("category");
+        QTest::addColumn<QString>("tag");
+        QTest::addColumn<QString>("name");
+
+        const QString category = SyntheticSession::syntheticCategory(1);
+        const QString tag = SyntheticSession::syntheticTag(1).toString();
+        QTest::newRow("status") << TorrentFilter::Stopped << QString() << QString() << QString();
+        QTest::newRow("category") << TorrentFilter::All << category << QString() << QString();
+        QTest::newRow("tag") << TorrentFilter::All << QString() << tag << QString();
+        QTest::newRow("name") << TorrentFilter::All << QString() << QString() << u"torrent 12"_s;
+        QTest::newRow("status/category/tag") << TorrentFilter::Stopped << category << tag << QString();
+    }
+
+    void benchFilter()
+    {
+        QFETCH(TorrentFilter::Type, status);
+        QFETCH(QString, category);
+        QFETCH(QString, tag);
+        QFETCH(QString, name);
+
+        TransferListSortModel sortModel;
+        setupSortModel(sortModel);
+        sortModel.sort(TransferListModel::TR_NAME);
+
+        QBENCHMARK
+        {
+            sortModel.setStatusFilter(status);
+            if (!category.isEmpty())
+                sortModel.setCategoryFilter(category);
+            if (!tag.isEmpty())
+                sortModel.setTagFilter(Tag(tag));
+            sortModel.setNameFilter(name);
+            QVERIFY(sortModel.rowCount() <= SyntheticSession::TORRENTS_COUNT);
+
+            // Restore the unfiltered list for the next iteration
+            sortModel.setStatusFilter(TorrentFilter::All);
+            sortModel.disableCategoryFilter();
+            sortModel.disableTagFilter();
+            sortModel.setNameFilter({});
+        }
+    }
+
+private:
+    // Same setup as TransferListWidget
+    void setupSortModel(TransferListSortModel &sortModel) const
+    {
+        sortModel.setDynamicSortFilter(true);
+        sortModel.setSourceModel(m_listModel);
+        sortModel.setFilterKeyColumn(TransferListModel::TR_NAME);
+        sortModel.setFilterRole(Qt::DisplayRole);
+        sortModel.setSortCaseSensitivity(Qt::CaseInsensitive);
+        sortModel.setSortRole(TransferListModel::UnderlyingDataRole);
+    }
+
+    QTemporaryDir m_profileDir;
+    TransferListModel *m_listModel = nullptr;
+};
+
+QTEST_MAIN(BenchTransferListSortModel)
+#include "benchtransferlistsortmodel.moc"
@@ -0,0 +1,278 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+#include <random>
+
+#include <QByteArray>
+#include <QByteArrayView>
+#include <QList>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/path.h"
+#include "base/utils/bytearray.h"
+#include "base/utils/compare.h"
+#include "base/utils/gzip.h"
+#include "base/utils/misc.h"
+#include "base/utils/string.h"
+
+namespace
+{
+    // The inputs are generated with a fixed seed so that the results are comparable between runs
+    const std::mt19937::result_type SEED = 42;
+
+    QStringList makeFileNames(const int count)
+    {
+        const QStringList words {u"Season"_s, u"Episode"_s, u"Disc"_s, u"Part"_s, u"Track"_s, u"Chapter"_s};
+
+        std::mt19937 generator {SEED};
+        std::uniform_int_distribution<int> wordDistribution {0, static_cast<int>(words.size() - 1)};
+        std::uniform_int_distribution<int> numberDistribution {1, 999};
+
+        QStringList fileNames;
+        fileNames.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            fileNames.append(u"%1 %2 - %3 %4.mkv"_s.arg(words[wordDistribution(generator)], QString::number(numberDistribution(generator))
+                    , words[wordDistribution(generator)], QString::number(numberDistribution(generator))));
+        }
+        return fileNames;
+    }
+
+    QByteArray makeJSONLikeData(const int size)
+    {
+        QByteArray data;
+        data.reserve(size);
+        for (int i = 0; data.size() < size; ++i)
+        {
+            data += R"({"hash":")" + QByteArray::number((i * 2654435761U), 16).rightJustified(40, '0')
+                    + R"(","name":"Torrent )" + QByteArray::number(i) + R"(","progress":0.)" + QByteArray::number(i % 100)
+                    + R"(,"state":"downloading","dlspeed":)" + QByteArray::number(i * 1024) + "},";
+        }
+        data.truncate(size);
+        return data;
+    }
+
+    QList<qint64> makeSizes(const int count)
+    {
+        std::mt19937_64 generator {SEED};
+        // spread the values evenly over all the size units
+        std::uniform_int_distribution<int> exponentDistribution {0, 60};
+
+        QList<qint64> sizes;
+        sizes.reserve(count);
+        for (int i = 0; i < count; ++i)
+        {
+            const int exponent = exponentDistribution(generator);
+            sizes.append(static_cast<qint64>(generator() >> (63 - exponent)));
+        }
+        return sizes;
+    }
+}
+
+class BenchUtils final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchUtils)
+
+public:
+    BenchUtils() = default;
+
+private slots:
+    void benchSplitToViews_data() const
+    {
+        QTest::addColumn<QByteArray>("data");
+
+        for (const int count : {10, 1000, 100000})
+        {
+            QByteArrayList fields;
+            fields.reserve(count);
+            for (int i = 0; i < count; ++i)
+                fields.append("field" + QByteArray::number(i));
+            QTest::addRow("%d", count) << fields.join(',');
+        }
+    }
+
+    void benchSplitToViews() const
+    {
+        QFETCH(QByteArray, data);
+
+        QBENCHMARK
+        {
+            const QList<QByteArrayView> views = Utils::ByteArray::splitToViews(data, ",");
+            QVERIFY(!views.isEmpty());
+        }
+    }
+
+    void benchGzipCompress_data() const
+    {
+        QTest::addColumn<QByteArray>("data");
+
+        for (const int size : {1024, (64 * 1024), (1024 * 1024)})
+            QTest::addRow("%d", size) << makeJSONLikeData(size);
+    }
+
+    void benchGzipCompress() const
+    {
+        QFETCH(QByteArray, data);
+
+        QBENCHMARK
+        {
+            bool ok = false;
+            const QByteArray compressedData = Utils::Gzip::compress(data, 6, &ok);
+            QVERIFY(ok);
+        }
+    }
+
+    void benchPathNormalization_data() const
+    {
+        addFileNamesRows();
+    }
+
+    void benchPathNormalization() const
+    {
+        QFETCH(QStringList, fileNames);
+
+        QStringList pathStrings;
+        pathStrings.reserve(fileNames.size());
+        for (const QString &fileName : fileNames)
+            pathStrings.append(u"/home/user/./Downloads//Torrents/../Series/" + fileName);
+
+        QBENCHMARK
+        {
+            for (const QString &pathString : pathStrings)
+            {
+                const Path path {pathString};
+                QVERIFY(path.isValid());
+            }
+        }
+    }
+
+    void benchRelativePathOf_data() const
+    {
+        addFileNamesRows();
+    }
+
+    void benchRelativePathOf() const
+    {
+        QFETCH(QStringList, fileNames);
+
+        const Path basePath {u"/home/user/Downloads"_s};
+        PathList paths;
+        paths.reserve(fileNames.size());
+        for (const QString &fileName : fileNames)
+            paths.append(basePath / Path(u"Series/" + fileName));
+
+        QBENCHMARK
+        {
+            for (const Path &path : paths)
+            {
+                const Path relativePath = basePath.relativePathOf(path);
+                QVERIFY(relativePath.isRelative());
+            }
+        }
+    }
+
+    void benchFriendlyUnit() const
+    {
+        const QList<qint64> sizes = makeSizes(10000);
+
+        QBENCHMARK
+        {
+            for (const qint64 size : sizes)
+            {
+                const QString str = Utils::Misc::friendlyUnit(size);
+                QVERIFY(!str.isEmpty());
+            }
+        }
+    }
+
+    void benchStringFromDouble() const
+    {
+        QList<double> values;
+        values.reserve(10000);
+        for (int i = 0; i < 10000; ++i)
+            values.append(i / 7.0);
+
+        QBENCHMARK
+        {
+            for (const double value : values)
+            {
+                const QString str = Utils::String::fromDouble(value, 2);
+                QVERIFY(!str.isEmpty());
+            }
+        }
+    }
+
+    void benchStringParseInt() const
+    {
+        QStringList strings;
+        strings.reserve(10000);
+        for (int i = 0; i < 10000; ++i)
+            strings.append(QString::number(i * 7919));
+
+        QBENCHMARK
+        {
+            for (const QString &str : strings)
+                QVERIFY(Utils::String::parseInt(str).has_value());
+        }
+    }
+
+    void benchNaturalCompare_data() const
+    {
+        addFileNamesRows();
+    }
+
+    void benchNaturalCompare() const
+    {
+        QFETCH(QStringList, fileNames);
+
+        const Utils::Compare::NaturalLessThan<Qt::CaseInsensitive> lessThan;
+        QBENCHMARK
+        {
+            QStringList sortedFileNames = fileNames;
+            std::sort(sortedFileNames.begin(), sortedFileNames.end(), lessThan);
+        }
+    }
+
+private:
+    static void addFileNamesRows()
+    {
+        QTest::addColumn<QStringList>("fileNames");
+
+        for (const int count : {100, 10000})
+            QTest::addRow("%d", count) << makeFileNames(count);
+    }
+};
+
+QTEST_GUILESS_MAIN(BenchUtils)
+#include "benchutils.moc"
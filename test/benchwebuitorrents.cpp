@@ -0,0 +1,175 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QJsonObject>
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/session.h"
+#include "base/bittorrent/torrent.h"
+#include "base/global.h"
+#include "base/path.h"
+#include "webui/api/apicontroller.h"
+#include "webui/api/maindatasynclog.h"
+#include "webui/api/torrentjsoncache.h"
+#include "webui/api/torrentscontroller.h"
+#include "benchsyntheticsession.h"
+
+class BenchWebUITorrents final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(BenchWebUITorrents)
+
+public:
+    BenchWebUITorrents() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_profileDir.isValid());
+        QVERIFY(SyntheticSession::init(Path(m_profileDir.path())));
+    }
+
+    void cleanupTestCase()
+    {
+        SyntheticSession::free();
+    }
+
+    // Full data sent to a client connecting for the first time
+    void benchMaindataFull()
+    {
+        QBENCHMARK
+        {
+            MaindataSyncLog syncLog;
+            syncLog.update();
+            const QJsonObject syncData = syncLog.generateSyncData(0);
+            QCOMPARE(syncData.value(u"torrents"_s).toObject().size(), SyntheticSession::TORRENTS_COUNT);
+        }
+    }
+
+    // Full data of the torrents shown by a client that doesn't need all of them
+    void benchMaindataView_data() const
+    {
+        QTest::addColumn<int>("viewSize");
+
+        for (const int viewSize : {100, 1000})
+            QTest::addRow("%d", viewSize) << viewSize;
+    }
+
+    void benchMaindataView()
+    {
+        QFETCH(int, viewSize);
+
+        MaindataSyncLog syncLog;
+        syncLog.update();
+
+        const QList<BitTorrent::Torrent *> viewTorrents = BitTorrent::Session::instance()->torrents().first(viewSize);
+        QSet<BitTorrent::TorrentID> viewIDs;
+        viewIDs.reserve(viewSize);
+        for (const BitTorrent::Torrent *torrent : viewTorrents)
+            viewIDs.insert(torrent->id());
+
+        QBENCHMARK
+        {
+            const QJsonObject syncData = syncLog.generateSyncData(0, TorrentSyncFieldSet().set(), &viewIDs);
+            QCOMPARE(syncData.value(u"torrents"_s).toObject().size(), viewSize);
+        }
+    }
+
+    // Refresh after some torrents are reported as updated by the session
+    void benchMaindataUpdate_data() const
+    {
+        QTest::addColumn<int>("updatedCount");
+
+        for (const int updatedCount : {100, 1000, SyntheticSession::TORRENTS_COUNT})
+            QTest::addRow("%d", updatedCount) << updatedCount;
+    }
+
+    void benchMaindataUpdate()
+    {
+        QFETCH(int, updatedCount);
+
+        MaindataSyncLog syncLog;
+        int version = syncLog.update();
+
+        auto *session = BitTorrent::Session::instance();
+        const QList<BitTorrent::Torrent *> updatedTorrents = session->torrents().first(updatedCount);
+        QBENCHMARK
+        {
+            emit session->torrentsUpdated(updatedTorrents);
+            const int newVersion = syncLog.update();
+            const QJsonObject syncData = syncLog.generateSyncData(version);
+            QVERIFY(!syncData.isEmpty());
+            version = newVersion;
+        }
+    }
+
+    // "torrents/info" with sorting and pagination
+    void benchTorrentsInfo_data() const
+    {
+        QTest::addColumn<StringMap>("params");
+
+        for (const QString &sortedColumn : {u"name"_s, u"size"_s, u"added_on"_s, u"ratio"_s})
+        {
+            QTest::addRow("%s/first page", qPrintable(sortedColumn))
+                    << StringMap {{u"sort"_s, sortedColumn}, {u"limit"_s, u"100"_s}};
+            QTest::addRow("%s/middle page", qPrintable(sortedColumn))
+                    << StringMap {{u"sort"_s, sortedColumn}, {u"limit"_s, u"100"_s}, {u"offset"_s, u"5000"_s}};
+            QTest::addRow("%s/reversed page", qPrintable(sortedColumn))
+                    << StringMap {{u"sort"_s, sortedColumn}, {u"reverse"_s, u"true"_s}, {u"limit"_s, u"1000"_s}};
+        }
+        QTest::newRow("filtered/first page")
+                << StringMap {{u"category"_s, SyntheticSession::syntheticCategory(1)}, {u"sort"_s, u"name"_s}, {u"limit"_s, u"100"_s}};
+        QTest::newRow("searched/first page")
+                << StringMap {{u"search"_s, u"torrent 12"_s}, {u"sort"_s, u"name"_s}, {u"limit"_s, u"100"_s}};
+    }
+
+    void benchTorrentsInfo()
+    {
+        QFETCH(StringMap, params);
+
+        TorrentJsonCache torrentJsonCache;
+        TorrentsController controller {&torrentJsonCache, nullptr};
+        QBENCHMARK
+        {
+            const APIResult result = controller.run(u"info"_s, params);
+            QVERIFY(result.data.isValid());
+        }
+    }
+
+private:
+    QTemporaryDir m_profileDir;
+};
+
+QTEST_GUILESS_MAIN(BenchWebUITorrents)
+#include "benchwebuitorrents.moc"
@@ -0,0 +1,108 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <optional>
+
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/announcescheduler.h"
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+using BitTorrent::AnnounceScheduler;
+using BitTorrent::TorrentID;
+
+namespace
+{
+    TorrentID makeID(const int index)
+    {
+        return TorrentID::fromString(u"%1"_s.arg(index, 40, 16, u'0'));
+    }
+}
+
+class TestBittorrentAnnounceScheduler final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentAnnounceScheduler)
+
+public:
+    TestBittorrentAnnounceScheduler() = default;
+
+private slots:
+    void testHostBudget() const
+    {
+        AnnounceScheduler scheduler {2};
+        QCOMPARE(scheduler.hostBudget(), 2);
+
+        const QString url = u"udp://tracker.example.org:6969/announce"_s;
+        QCOMPARE(scheduler.schedule(makeID(1), url, 100), 0);
+        QCOMPARE(scheduler.schedule(makeID(2), url, 100), 0);
+        QCOMPARE(scheduler.schedule(makeID(3), url, 100), 1);
+        QCOMPARE(scheduler.schedule(makeID(4), url, 100), 1);
+        QCOMPARE(scheduler.schedule(makeID(5), url, 100), 2);
+
+        // the same host is paced regardless of the tracker URL
+        QCOMPARE(scheduler.schedule(makeID(1), u"http://tracker.example.org/announce"_s, 100), 2);
+        QCOMPARE(scheduler.schedule(makeID(1), u"http://other.example.org/announce"_s, 100), 0);
+
+        QCOMPARE(scheduler.schedule(makeID(6), url, 101), 2);
+        QCOMPARE(scheduler.schedule(makeID(7), url, 110), 0);
+    }
+
+    void testCoalesce() const
+    {
+        AnnounceScheduler scheduler {1};
+
+        const QString url = u"udp://tracker.example.org:6969/announce"_s;
+        QCOMPARE(scheduler.schedule(makeID(1), url, 100), 0);
+        QCOMPARE(scheduler.schedule(makeID(2), url, 100), 1);
+        QCOMPARE(scheduler.schedule(makeID(1), url, 100), std::nullopt);
+        QCOMPARE(scheduler.schedule(makeID(2), url, 101), std::nullopt);
+
+        // the announces which are due can be scheduled again
+        QCOMPARE(scheduler.schedule(makeID(1), url, 101), 1);
+        QCOMPARE(scheduler.schedule(makeID(2), url, 102), 1);
+    }
+
+    void testClear() const
+    {
+        AnnounceScheduler scheduler {1};
+
+        const QString url = u"udp://tracker.example.org:6969/announce"_s;
+        QCOMPARE(scheduler.schedule(makeID(1), url, 100), 0);
+        QCOMPARE(scheduler.schedule(makeID(2), url, 100), 1);
+
+        scheduler.clear();
+        QCOMPARE(scheduler.schedule(makeID(1), url, 100), 0);
+        QCOMPARE(scheduler.schedule(makeID(2), url, 100), 1);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentAnnounceScheduler)
+#include "testbittorrentannouncescheduler.moc"
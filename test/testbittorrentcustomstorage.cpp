@@ -0,0 +1,300 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <libtorrent/disk_buffer_holder.hpp>
+#include <libtorrent/disk_interface.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/io_context.hpp>
+#include <libtorrent/storage_defs.hpp>
+
+#include <QByteArray>
+#include <QDeadlineTimer>
+#include <QDir>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/customstorage.h"
+#include "base/bittorrent/diskiostatistics.h"
+#include "base/bittorrent/diskreadcache.h"
+#include "base/global.h"
+#include "base/path.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    const int BLOCK_SIZE = 16 * 1024;
+
+    // Native disk IO which performs the writes when it is told to do so.
+    // Releasing the files is a fence job like in libtorrent, i.e. it waits for the writes.
+    class NativeDiskIO final : public lt::disk_interface
+    {
+    public:
+        int writeCount = 0;
+        bool isReleaseRequested = false;
+        bool isMoveRequested = false;
+        // The state of the jobs at the time the storage is moved
+        qsizetype pendingWritesWhenMoved = -1;
+        int writeCountWhenMoved = -1;
+
+        void completeWrites()
+        {
+            for (const auto &handler : std::exchange(m_pendingWrites, {}))
+                handler(lt::storage_error());
+            if (m_releaseHandler)
+                std::exchange(m_releaseHandler, {})();
+        }
+
+        lt::storage_holder new_torrent(const lt::storage_params &, const std::shared_ptr<void> &) override
+        {
+            return lt::storage_holder(lt::storage_index_t {0}, *this);
+        }
+
+        void remove_torrent(lt::storage_index_t) override
+        {
+        }
+
+        void async_read(lt::storage_index_t, const lt::peer_request &
+                , std::function<void (lt::disk_buffer_holder, const lt::storage_error &)> handler, lt::disk_job_flags_t) override
+        {
+            handler(lt::disk_buffer_holder(), lt::storage_error());
+        }
+
+        bool async_write(lt::storage_index_t, const lt::peer_request &, const char *, std::shared_ptr<lt::disk_observer>
+                , std::function<void (const lt::storage_error &)> handler, lt::disk_job_flags_t) override
+        {
+            ++writeCount;
+            m_pendingWrites.push_back(std::move(handler));
+            return false;
+        }
+
+        void async_hash(lt::storage_index_t, lt::piece_index_t piece, lt::span<lt::sha256_hash>, lt::disk_job_flags_t
+                , std::function<void (lt::piece_index_t, const lt::sha1_hash &, const lt::storage_error &)> handler) override
+        {
+            handler(piece, lt::sha1_hash(), lt::storage_error());
+        }
+
+        void async_hash2(lt::storage_index_t, lt::piece_index_t piece, int, lt::disk_job_flags_t
+                , std::function<void (lt::piece_index_t, const lt::sha256_hash &, const lt::storage_error &)> handler) override
+        {
+            handler(piece, lt::sha256_hash(), lt::storage_error());
+        }
+
+        void async_move_storage(lt::storage_index_t, std::string path, lt::move_flags_t
+                , std::function<void (lt::status_t, const std::string &, const lt::storage_error &)> handler) override
+        {
+            isMoveRequested = true;
+            pendingWritesWhenMoved = static_cast<qsizetype>(m_pendingWrites.size());
+            writeCountWhenMoved = writeCount;
+            handler(lt::status_t {}, path, lt::storage_error());
+        }
+
+        void async_release_files(lt::storage_index_t, std::function<void ()> handler) override
+        {
+            isReleaseRequested = true;
+            if (m_pendingWrites.empty())
+                handler();
+            else
+                m_releaseHandler = std::move(handler);
+        }
+
+        void async_check_files(lt::storage_index_t, const lt::add_torrent_params *, lt::aux::vector<std::string, lt::file_index_t>
+                , std::function<void (lt::status_t, const lt::storage_error &)> handler) override
+        {
+            handler(lt::status_t {}, lt::storage_error());
+        }
+
+        void async_stop_torrent(lt::storage_index_t, std::function<void ()> handler) override
+        {
+            handler();
+        }
+
+        void async_rename_file(lt::storage_index_t, lt::file_index_t index, std::string name
+                , std::function<void (const std::string &, lt::file_index_t, const lt::storage_error &)> handler) override
+        {
+            handler(name, index, lt::storage_error());
+        }
+
+        void async_delete_files(lt::storage_index_t, lt::remove_flags_t, std::function<void (const lt::storage_error &)> handler) override
+        {
+            handler(lt::storage_error());
+        }
+
+        void async_set_file_priority(lt::storage_index_t, lt::aux::vector<lt::download_priority_t, lt::file_index_t> priorities
+                , std::function<void (const lt::storage_error &, lt::aux::vector<lt::download_priority_t, lt::file_index_t>)> handler) override
+        {
+            handler(lt::storage_error(), std::move(priorities));
+        }
+
+        void async_clear_piece(lt::storage_index_t, lt::piece_index_t index, std::function<void (lt::piece_index_t)> handler) override
+        {
+            handler(index);
+        }
+
+        void update_stats_counters(lt::counters &) const override
+        {
+        }
+
+        std::vector<lt::open_file_state> get_status(lt::storage_index_t) const override
+        {
+            return {};
+        }
+
+        void abort(bool) override
+        {
+        }
+
+        void submit_jobs() override
+        {
+        }
+
+        void settings_updated() override
+        {
+        }
+
+    private:
+        std::vector<std::function<void (const lt::storage_error &)>> m_pendingWrites;
+        std::function<void ()> m_releaseHandler;
+    };
+
+    bool waitFor(lt::io_context &ioContext, const std::function<bool ()> &condition)
+    {
+        const QDeadlineTimer deadline {5s};
+        while (!condition())
+        {
+            if (deadline.hasExpired())
+                return false;
+
+            ioContext.restart();
+            ioContext.poll();
+            std::this_thread::sleep_for(1ms);
+        }
+
+        return true;
+    }
+}
+
+class TestBittorrentCustomStorage final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentCustomStorage)
+
+public:
+    TestBittorrentCustomStorage() = default;
+
+private slots:
+    void testMoveWaitsForWrites() const
+    {
+        QFETCH(qint64, writeCoalescingSize);
+
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path sourcePath = Path(tmpDir.path()) / Path(u"source"_s);
+        const Path destinationPath = Path(tmpDir.path()) / Path(u"destination"_s);
+        QVERIFY(QDir().mkpath(sourcePath.data()));
+
+        lt::file_storage files;
+        files.add_file("file", (2 * BLOCK_SIZE));
+        files.set_piece_length(2 * BLOCK_SIZE);
+        files.set_num_pieces(1);
+        const lt::aux::vector<lt::download_priority_t, lt::file_index_t> priorities;
+        const lt::storage_params storageParams {files, nullptr, sourcePath.toString().toStdString()
+                , lt::storage_mode_sparse, priorities, lt::sha1_hash("0123456789abcdef0123")};
+
+        lt::io_context ioContext;
+        auto nativeDiskIOPtr = std::make_unique<NativeDiskIO>();
+        NativeDiskIO *nativeDiskIO = nativeDiskIOPtr.get();
+        const CustomDiskIOParams params
+        {
+            .readCache = std::make_shared<DiskReadCache>(),
+            .diskIOAccounting = std::make_shared<BitTorrent::DiskIOAccounting>(),
+            .writeCoalescingSize = writeCoalescingSize,
+            .writeCoalescingTime = 1min
+        };
+        CustomDiskIOThread diskIO {ioContext, std::move(nativeDiskIOPtr), params};
+        lt::storage_holder storage = diskIO.new_torrent(storageParams, nullptr);
+
+        const QByteArray block {BLOCK_SIZE, 'a'};
+        int writtenBlocks = 0;
+        const auto writeHandler = [&writtenBlocks](const lt::storage_error &error)
+        {
+            if (!error)
+                ++writtenBlocks;
+        };
+        diskIO.async_write(storage, {lt::piece_index_t {0}, 0, BLOCK_SIZE}, block.constData(), nullptr, writeHandler, {});
+
+        bool isMoved = false;
+        diskIO.async_move_storage(storage, destinationPath.toString().toStdString(), lt::move_flags_t::always_replace_files
+                , [&isMoved](lt::status_t, const std::string &, const lt::storage_error &)
+        {
+            isMoved = true;
+        });
+
+        // coalesced blocks are passed to the native disk IO first, then the move waits for them
+        QCOMPARE(nativeDiskIO->writeCount, 1);
+        QVERIFY(nativeDiskIO->isReleaseRequested);
+        ioContext.poll();
+        QVERIFY(!nativeDiskIO->isMoveRequested);
+        QVERIFY(!isMoved);
+
+        // the blocks received during the move are written after it
+        diskIO.async_write(storage, {lt::piece_index_t {0}, BLOCK_SIZE, BLOCK_SIZE}, block.constData(), nullptr, writeHandler, {});
+        QCOMPARE(nativeDiskIO->writeCount, 1);
+
+        nativeDiskIO->completeWrites();
+        QCOMPARE(writtenBlocks, 1);
+        QVERIFY(waitFor(ioContext, [&isMoved] { return isMoved; }));
+        QCOMPARE(nativeDiskIO->pendingWritesWhenMoved, 0);
+        QCOMPARE(nativeDiskIO->writeCountWhenMoved, 1);
+
+        if (writeCoalescingSize <= 0)
+            QCOMPARE(nativeDiskIO->writeCount, 2);
+
+        storage.reset();
+        diskIO.abort(true);
+    }
+
+    void testMoveWaitsForWrites_data() const
+    {
+        QTest::addColumn<qint64>("writeCoalescingSize");
+
+        QTest::newRow("direct writes") << qint64(0);
+        QTest::newRow("coalesced writes") << qint64(1024 * 1024);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentCustomStorage)
+#include "testbittorrentcustomstorage.moc"
@@ -0,0 +1,167 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <chrono>
+
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/diskiostatistics.h"
+#include "base/global.h"
+
+using namespace std::chrono_literals;
+
+class TestBittorrentDiskIOStatistics final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentDiskIOStatistics)
+
+public:
+    TestBittorrentDiskIOStatistics() = default;
+
+private slots:
+    void testEmpty() const
+    {
+        const BitTorrent::DiskIOOperationStatistics stats;
+        QCOMPARE(stats.count, 0);
+        QCOMPARE(stats.latencyPercentile(50), 0);
+        QCOMPARE(stats.latencyPercentile(99), 0);
+    }
+
+    void testAdd() const
+    {
+        BitTorrent::DiskIOOperationStatistics stats;
+        stats.add(16384, 50);
+        stats.add(16384, 100);
+        stats.add(16384, 101);
+        stats.add(0, 2'000'000);
+
+        QCOMPARE(stats.count, 4);
+        QCOMPARE(stats.bytes, (3 * 16384));
+        QCOMPARE(stats.totalLatency, 2'000'251);
+        QCOMPARE(stats.maxLatency, 2'000'000);
+        // bounds are inclusive
+        QCOMPARE(stats.latencyHistogram[0], 2);
+        QCOMPARE(stats.latencyHistogram[1], 1);
+        QCOMPARE(stats.latencyHistogram[BitTorrent::DISK_IO_LATENCY_HISTOGRAM_SIZE - 1], 1);
+    }
+
+    void testLatencyPercentile() const
+    {
+        BitTorrent::DiskIOOperationStatistics stats;
+        for (int i = 0; i < 90; ++i)
+            stats.add(0, 80);
+        for (int i = 0; i < 9; ++i)
+            stats.add(0, 3'000);
+        stats.add(0, 700'000);
+
+        QCOMPARE(stats.latencyPercentile(50), 100);
+        QCOMPARE(stats.latencyPercentile(90), 100);
+        QCOMPARE(stats.latencyPercentile(95), 5'000);
+        QCOMPARE(stats.latencyPercentile(99), 5'000);
+        QCOMPARE(stats.latencyPercentile(100), 700'000);
+    }
+
+    void testLatencyPercentileAboveBounds() const
+    {
+        BitTorrent::DiskIOOperationStatistics stats;
+        stats.add(0, 3'000'000);
+        stats.add(0, 4'000'000);
+
+        QCOMPARE(stats.latencyPercentile(50), 4'000'000);
+    }
+
+    void testAccounting() const
+    {
+        const auto torrent1 = BitTorrent::TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234567"_s);
+        const auto torrent2 = BitTorrent::TorrentID::fromString(u"76543210fedcba9876543210fedcba9876543210"_s);
+        const QString volume1 = u"/dev/sda1"_s;
+        const QString volume2 = u"/dev/sdb1"_s;
+
+        BitTorrent::DiskIOAccounting accounting;
+        accounting.addOperation(torrent1, volume1, BitTorrent::DiskIOOperation::Read, 16384, 100us);
+        accounting.addOperation(torrent1, volume1, BitTorrent::DiskIOOperation::Write, 16384, 200us);
+        accounting.addOperation(torrent2, volume1, BitTorrent::DiskIOOperation::Read, 16384, 300us);
+        accounting.addOperation(torrent2, volume2, BitTorrent::DiskIOOperation::Hash, 262144, 1ms);
+
+        const BitTorrent::DiskIOStatistics torrent1Stats = accounting.torrentStatistics(torrent1);
+        QCOMPARE(torrent1Stats[BitTorrent::DiskIOOperation::Read].count, 1);
+        QCOMPARE(torrent1Stats[BitTorrent::DiskIOOperation::Write].bytes, 16384);
+        QCOMPARE(torrent1Stats[BitTorrent::DiskIOOperation::Hash].count, 0);
+
+        const BitTorrent::DiskIOStatistics torrent2Stats = accounting.torrentStatistics(torrent2);
+        QCOMPARE(torrent2Stats[BitTorrent::DiskIOOperation::Read].totalLatency, 300);
+        QCOMPARE(torrent2Stats[BitTorrent::DiskIOOperation::Hash].totalLatency, 1'000);
+
+        const QHash<QString, BitTorrent::DiskIOStatistics> volumeStats = accounting.volumeStatistics();
+        QCOMPARE(volumeStats.size(), 2);
+        QCOMPARE(volumeStats[volume1][BitTorrent::DiskIOOperation::Read].count, 2);
+        QCOMPARE(volumeStats[volume1][BitTorrent::DiskIOOperation::Read].bytes, 32768);
+        QCOMPARE(volumeStats[volume1][BitTorrent::DiskIOOperation::Write].count, 1);
+        QCOMPARE(volumeStats[volume2][BitTorrent::DiskIOOperation::Hash].bytes, 262144);
+
+        // volume statistics outlive the torrents
+        accounting.removeTorrent(torrent1);
+        QCOMPARE(accounting.torrentStatistics(torrent1)[BitTorrent::DiskIOOperation::Read].count, 0);
+        QCOMPARE(accounting.volumeStatistics()[volume1][BitTorrent::DiskIOOperation::Read].count, 2);
+    }
+
+    void testMoveProgress() const
+    {
+        const auto torrent = BitTorrent::TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234567"_s);
+
+        BitTorrent::DiskIOAccounting accounting;
+        QCOMPARE(accounting.moveProgress(torrent), 0);
+
+        accounting.setMoveProgress(torrent, 1024);
+        accounting.setMoveProgress(torrent, 4096);
+        QCOMPARE(accounting.moveProgress(torrent), 4096);
+
+        accounting.removeMoveProgress(torrent);
+        QCOMPARE(accounting.moveProgress(torrent), 0);
+    }
+
+    void testCheckedBytes() const
+    {
+        const auto torrent = BitTorrent::TorrentID::fromString(u"0123456789abcdef0123456789abcdef01234567"_s);
+
+        BitTorrent::DiskIOAccounting accounting;
+        QCOMPARE(accounting.checkedBytes(), 0);
+
+        accounting.addCheckedBytes(262144);
+        accounting.addCheckedBytes(131072);
+        QCOMPARE(accounting.checkedBytes(), 393216);
+
+        // the total is kept when the torrents are removed so the rate can be computed from it
+        accounting.removeTorrent(torrent);
+        QCOMPARE(accounting.checkedBytes(), 393216);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentDiskIOStatistics)
+#include "testbittorrentdiskiostatistics.moc"
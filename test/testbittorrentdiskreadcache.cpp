@@ -0,0 +1,166 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/diskreadcache.h"
+
+namespace
+{
+    const int BLOCK_SIZE = 16 * 1024;
+
+    DiskReadCache::BlockKey blockKey(const int storage, const int piece, const int offset = 0)
+    {
+        return {storage, piece, offset, BLOCK_SIZE};
+    }
+
+    // Emulates a read request: returns `true` if the block was served from the cache
+    bool read(DiskReadCache &cache, const DiskReadCache::BlockKey &key, const QByteArray &data)
+    {
+        if (!cache.find(key).isNull())
+            return true;
+
+        cache.offer(key, data.constData());
+        return false;
+    }
+}
+
+class TestBittorrentDiskReadCache final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentDiskReadCache)
+
+public:
+    TestBittorrentDiskReadCache() = default;
+
+private slots:
+    void testDisabled() const
+    {
+        DiskReadCache cache;
+        const QByteArray data(BLOCK_SIZE, 'a');
+
+        QVERIFY(!read(cache, blockKey(0, 0), data));
+        QVERIFY(!read(cache, blockKey(0, 0), data));
+        QVERIFY(!read(cache, blockKey(0, 0), data));
+
+        const DiskReadCache::Statistics stats = cache.statistics();
+        QCOMPARE(stats.hits, 0);
+        QCOMPARE(stats.misses, 0);
+        QCOMPARE(stats.size, 0);
+    }
+
+    void testAdmission() const
+    {
+        DiskReadCache cache {4 * BLOCK_SIZE};
+        const QByteArray data(BLOCK_SIZE, 'a');
+
+        // a block is admitted on the second miss
+        QVERIFY(!read(cache, blockKey(0, 0), data));
+        QCOMPARE(cache.statistics().size, 0);
+        QVERIFY(!read(cache, blockKey(0, 0), data));
+        QCOMPARE(cache.statistics().size, BLOCK_SIZE);
+
+        QCOMPARE(cache.find(blockKey(0, 0)), data);
+        QVERIFY(cache.find(blockKey(0, 0, BLOCK_SIZE)).isNull());
+        QVERIFY(cache.find(blockKey(1, 0)).isNull());
+
+        const DiskReadCache::Statistics stats = cache.statistics();
+        QCOMPARE(stats.hits, 1);
+        QCOMPARE(stats.misses, 4);
+        QCOMPARE(stats.capacity, (4 * BLOCK_SIZE));
+    }
+
+    void testEviction() const
+    {
+        DiskReadCache cache {2 * BLOCK_SIZE};
+        const QByteArray data(BLOCK_SIZE, 'a');
+
+        for (int piece = 0; piece < 2; ++piece)
+        {
+            read(cache, blockKey(0, piece), data);
+            read(cache, blockKey(0, piece), data);
+        }
+        QCOMPARE(cache.statistics().size, (2 * BLOCK_SIZE));
+
+        // make piece 1 the least recently used one
+        QVERIFY(read(cache, blockKey(0, 0), data));
+
+        QVERIFY(cache.find(blockKey(0, 2)).isNull());
+        QVERIFY(cache.find(blockKey(0, 2)).isNull());
+        const QList<DiskReadCache::Block> evictedBlocks = cache.offer(blockKey(0, 2), data.constData());
+        QCOMPARE(evictedBlocks.size(), 1);
+        QVERIFY(evictedBlocks[0].key == blockKey(0, 1));
+        QCOMPARE(evictedBlocks[0].data, data);
+        QCOMPARE(cache.statistics().size, (2 * BLOCK_SIZE));
+        QVERIFY(!cache.find(blockKey(0, 0)).isNull());
+        QVERIFY(cache.find(blockKey(0, 1)).isNull());
+        QVERIFY(!cache.find(blockKey(0, 2)).isNull());
+
+        cache.setCapacity(BLOCK_SIZE);
+        QCOMPARE(cache.statistics().size, BLOCK_SIZE);
+        QVERIFY(!cache.find(blockKey(0, 2)).isNull());
+
+        cache.setCapacity(0);
+        QCOMPARE(cache.statistics().size, 0);
+    }
+
+    void testRemove() const
+    {
+        DiskReadCache cache {8 * BLOCK_SIZE};
+        const QByteArray data(BLOCK_SIZE, 'a');
+
+        const DiskReadCache::BlockKey keys[] =
+        {
+            blockKey(0, 0), blockKey(0, 0, BLOCK_SIZE), blockKey(0, 1),
+            blockKey(1, 0), blockKey(1, 1)
+        };
+        for (const DiskReadCache::BlockKey &key : keys)
+        {
+            read(cache, key, data);
+            read(cache, key, data);
+        }
+        QCOMPARE(cache.statistics().size, (5 * BLOCK_SIZE));
+
+        cache.removePiece(0, 0);
+        QCOMPARE(cache.statistics().size, (3 * BLOCK_SIZE));
+        QVERIFY(cache.find(blockKey(0, 0)).isNull());
+        QVERIFY(cache.find(blockKey(0, 0, BLOCK_SIZE)).isNull());
+        QVERIFY(!cache.find(blockKey(0, 1)).isNull());
+
+        cache.removeStorage(1);
+        QCOMPARE(cache.statistics().size, BLOCK_SIZE);
+        QVERIFY(cache.find(blockKey(1, 0)).isNull());
+        QVERIFY(cache.find(blockKey(1, 1)).isNull());
+        QVERIFY(!cache.find(blockKey(0, 1)).isNull());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentDiskReadCache)
+#include "testbittorrentdiskreadcache.moc"
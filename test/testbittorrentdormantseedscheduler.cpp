@@ -0,0 +1,160 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QList>
+#include <QObject>
+#include <QSet>
+#include <QTest>
+
+#include "base/bittorrent/dormantseedscheduler.h"
+#include "base/bittorrent/infohash.h"
+#include "base/global.h"
+
+using BitTorrent::DormantSeedScheduler;
+using BitTorrent::TorrentID;
+
+namespace
+{
+    TorrentID makeID(const int index)
+    {
+        return TorrentID::fromString(u"%1"_s.arg(index, 40, 16, u'0'));
+    }
+
+    QSet<TorrentID> toSet(const QList<TorrentID> &ids)
+    {
+        return {ids.cbegin(), ids.cend()};
+    }
+}
+
+class TestBittorrentDormantSeedScheduler final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentDormantSeedScheduler)
+
+public:
+    TestBittorrentDormantSeedScheduler() = default;
+
+private slots:
+    void testIdle() const
+    {
+        DormantSeedScheduler scheduler {100, 1000};
+        QVERIFY(scheduler.isEmpty());
+
+        scheduler.updateAwake(makeID(1), false, 0);
+        scheduler.updateAwake(makeID(2), false, 0);
+        QVERIFY(!scheduler.isEmpty());
+        QCOMPARE(scheduler.takeIdle(99), QList<TorrentID>());
+
+        // the demand postpones going dormant
+        scheduler.updateAwake(makeID(2), true, 50);
+        scheduler.updateAwake(makeID(1), false, 50);
+        QCOMPARE(scheduler.takeIdle(100), QList<TorrentID>({makeID(1)}));
+        QVERIFY(scheduler.isDormant(makeID(1)));
+        QVERIFY(!scheduler.isDormant(makeID(2)));
+        QCOMPARE(scheduler.dormantCount(), 1);
+
+        QCOMPARE(scheduler.takeIdle(149), QList<TorrentID>());
+        QCOMPARE(scheduler.takeIdle(150), QList<TorrentID>({makeID(2)}));
+        QCOMPARE(scheduler.takeIdle(1000), QList<TorrentID>());
+        QCOMPARE(scheduler.dormantCount(), 2);
+    }
+
+    void testScrape() const
+    {
+        DormantSeedScheduler scheduler {10, 100};
+        for (int i = 1; i <= 3; ++i)
+            scheduler.updateAwake(makeID(i), false, i);
+        QCOMPARE(toSet(scheduler.takeIdle(20)), toSet({makeID(1), makeID(2), makeID(3)}));
+
+        QCOMPARE(scheduler.takeScrapeDue(119, 10), QList<TorrentID>());
+        QCOMPARE(scheduler.takeScrapeDue(120, 2).size(), 2);
+        QCOMPARE(scheduler.takeScrapeDue(120, 2).size(), 1);
+        QCOMPARE(scheduler.takeScrapeDue(120, 2), QList<TorrentID>());
+
+        // the next scrapes are scheduled from the time of the previous ones
+        QCOMPARE(toSet(scheduler.takeScrapeDue(220, 10)), toSet({makeID(1), makeID(2), makeID(3)}));
+    }
+
+    void testScrapeOrder() const
+    {
+        DormantSeedScheduler scheduler {10, 100};
+        scheduler.updateAwake(makeID(1), false, 0);
+        QCOMPARE(scheduler.takeIdle(10), QList<TorrentID>({makeID(1)}));
+        scheduler.updateAwake(makeID(2), false, 0);
+        QCOMPARE(scheduler.takeIdle(20), QList<TorrentID>({makeID(2)}));
+        scheduler.updateAwake(makeID(3), false, 0);
+        QCOMPARE(scheduler.takeIdle(30), QList<TorrentID>({makeID(3)}));
+
+        // the most overdue scrapes go first
+        QCOMPARE(scheduler.takeScrapeDue(200, 1), QList<TorrentID>({makeID(1)}));
+        QCOMPARE(scheduler.takeScrapeDue(200, 1), QList<TorrentID>({makeID(2)}));
+        QCOMPARE(scheduler.takeScrapeDue(200, 1), QList<TorrentID>({makeID(3)}));
+    }
+
+    void testWake() const
+    {
+        DormantSeedScheduler scheduler {10, 100};
+        scheduler.updateAwake(makeID(1), false, 0);
+        QCOMPARE(scheduler.takeIdle(10), QList<TorrentID>({makeID(1)}));
+
+        scheduler.wake(makeID(1), 50);
+        QVERIFY(!scheduler.isDormant(makeID(1)));
+        QCOMPARE(scheduler.dormantCount(), 0);
+        QCOMPARE(scheduler.takeScrapeDue(1000, 10), QList<TorrentID>());
+
+        // the woken seed goes dormant again after the idle time
+        scheduler.updateAwake(makeID(1), false, 55);
+        QCOMPARE(scheduler.takeIdle(59), QList<TorrentID>());
+        QCOMPARE(scheduler.takeIdle(60), QList<TorrentID>({makeID(1)}));
+
+        // the unknown seed is awake once woken
+        scheduler.wake(makeID(2), 60);
+        QVERIFY(!scheduler.isDormant(makeID(2)));
+        QCOMPARE(scheduler.dormantCount(), 1);
+    }
+
+    void testRemove() const
+    {
+        DormantSeedScheduler scheduler {10, 100};
+        scheduler.updateAwake(makeID(1), false, 0);
+        scheduler.updateAwake(makeID(2), false, 5);
+        QCOMPARE(scheduler.takeIdle(10), QList<TorrentID>({makeID(1)}));
+
+        QVERIFY(scheduler.remove(makeID(1)));
+        QVERIFY(!scheduler.remove(makeID(1)));
+        QCOMPARE(scheduler.dormantCount(), 0);
+        QCOMPARE(scheduler.takeScrapeDue(1000, 10), QList<TorrentID>());
+
+        scheduler.clear();
+        QVERIFY(scheduler.isEmpty());
+        QCOMPARE(scheduler.takeIdle(1000), QList<TorrentID>());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentDormantSeedScheduler)
+#include "testbittorrentdormantseedscheduler.moc"
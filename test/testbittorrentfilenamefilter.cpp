@@ -0,0 +1,111 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QTest>
+
+#include "base/bittorrent/filenamefilter.h"
+#include "base/global.h"
+#include "base/path.h"
+
+using BitTorrent::FileNameFilter;
+
+class TestBittorrentFileNameFilter final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentFileNameFilter)
+
+public:
+    TestBittorrentFileNameFilter() = default;
+
+private slots:
+    void testEmpty() const
+    {
+        const FileNameFilter filter;
+        QVERIFY(filter.isEmpty());
+        QVERIFY(!filter.match(Path(u"a/b.txt"_s)));
+        QCOMPARE(filter.match(PathList {Path(u"a.txt"_s), Path(u"b.txt"_s)}), QList<bool>({false, false}));
+
+        QVERIFY(FileNameFilter(QStringList {u""_s}).isEmpty());
+    }
+
+    void testLiteralNames() const
+    {
+        const FileNameFilter filter {QStringList {u"Thumbs.db"_s, u"sample"_s}};
+        QVERIFY(!filter.isEmpty());
+
+        QVERIFY(filter.match(Path(u"thumbs.DB"_s)));
+        QVERIFY(filter.match(Path(u"folder/Thumbs.db"_s)));
+        QVERIFY(filter.match(Path(u"Sample/movie.mkv"_s)));
+        QVERIFY(!filter.match(Path(u"samples/movie.mkv"_s)));
+        QVERIFY(!filter.match(Path(u"Thumbs.db.txt"_s)));
+    }
+
+    void testExtensions() const
+    {
+        const FileNameFilter filter {QStringList {u"*.txt"_s, u"*.tar.gz"_s}};
+
+        QVERIFY(filter.match(Path(u"readme.TXT"_s)));
+        QVERIFY(filter.match(Path(u".txt"_s)));
+        QVERIFY(filter.match(Path(u"archive.tar.gz"_s)));
+        QVERIFY(filter.match(Path(u"notes.txt/file.bin"_s)));
+        QVERIFY(!filter.match(Path(u"archive.gz"_s)));
+        QVERIFY(!filter.match(Path(u"readme.txt.bak"_s)));
+        QVERIFY(!filter.match(Path(u"txt"_s)));
+    }
+
+    void testWildcards() const
+    {
+        const FileNameFilter filter {QStringList {u"[Ss]ample*"_s, u"?.nfo"_s, u"*.ex?"_s}};
+
+        QVERIFY(filter.match(Path(u"sample.mkv"_s)));
+        QVERIFY(filter.match(Path(u"movie/Samples/clip.mkv"_s)));
+        QVERIFY(filter.match(Path(u"a.NFO"_s)));
+        QVERIFY(filter.match(Path(u"setup.exe"_s)));
+        QVERIFY(!filter.match(Path(u"ab.nfo"_s)));
+        QVERIFY(!filter.match(Path(u"movie/example.mkv"_s)));
+    }
+
+    void testPathList() const
+    {
+        const FileNameFilter filter {QStringList {u"extras"_s, u"*.url"_s}};
+
+        const PathList filePaths {
+            Path(u"movie/movie.mkv"_s),
+            Path(u"movie/extras/clip1.mkv"_s),
+            Path(u"movie/extras/clip2.mkv"_s),
+            Path(u"movie/link.url"_s),
+            Path(u"movie/subs/en.srt"_s)
+        };
+        QCOMPARE(filter.match(filePaths), QList<bool>({false, true, true, true, false}));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentFileNameFilter)
+#include "testbittorrentfilenamefilter.moc"
@@ -0,0 +1,364 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include <QByteArray>
+#include <QFile>
+#include <QList>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/journalresumedatastorage.h"
+#include "base/bittorrent/loadtorrentparams.h"
+#include "base/bittorrent/torrentinfo.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/path.h"
+#include "base/preferences.h"
+#include "base/profile.h"
+#include "base/settingsstorage.h"
+
+using BitTorrent::JournalResumeDataStorage;
+using BitTorrent::LoadTorrentParams;
+using BitTorrent::TorrentID;
+
+namespace
+{
+    const int PIECE_SIZE = 16 * 1024;
+    // offset of the record type in the record header (payload size, payload checksum, record type, torrent ID)
+    const qint64 RECORD_TYPE_OFFSET = 6;
+
+    struct TestTorrent
+    {
+        TorrentID id;
+        LoadTorrentParams params;
+    };
+
+    TestTorrent makeTorrent(const int index, const int piecesCount = 4)
+    {
+        const std::string torrentName = "Torrent " + std::to_string(index);
+
+        lt::file_storage files;
+        files.add_file((torrentName + "/file.bin"), (static_cast<std::int64_t>(piecesCount) * PIECE_SIZE));
+
+#ifdef QBT_USES_LIBTORRENT2
+        lt::create_torrent creator {files, PIECE_SIZE, lt::create_torrent::v1_only};
+#else
+        lt::create_torrent creator {files, PIECE_SIZE};
+#endif
+        for (int i = 0; i < creator.num_pieces(); ++i)
+            creator.set_hash(lt::piece_index_t {i}, lt::sha1_hash {});
+
+        std::vector<char> buffer;
+        lt::bencode(std::back_inserter(buffer), creator.generate());
+        const auto nativeInfo = std::make_shared<lt::torrent_info>(buffer, lt::from_span);
+
+        LoadTorrentParams params;
+        params.ltAddTorrentParams.ti = nativeInfo;
+        params.ltAddTorrentParams.save_path = "/downloads";
+        params.name = QString::fromStdString(torrentName);
+        params.savePath = Path(u"/downloads"_s);
+
+        return {.id = TorrentID::fromInfoHash(BitTorrent::TorrentInfo(*nativeInfo).infoHash()), .params = std::move(params)};
+    }
+
+    // Returns the name of the loaded torrent, or null string if it can't be loaded
+    QString loadedName(const JournalResumeDataStorage &storage, const TorrentID &id)
+    {
+        const BitTorrent::LoadResumeDataResult result = storage.load(id);
+        return result ? result.value().name : QString();
+    }
+
+    qint64 fileSize(const Path &path)
+    {
+        return QFile(path.data()).size();
+    }
+
+    bool changeByte(const Path &path, const qint64 offset)
+    {
+        QFile file {path.data()};
+        if (!file.open(QIODevice::ReadWrite) || !file.seek(offset))
+            return false;
+
+        const QByteArray byte = file.read(1);
+        return (byte.size() == 1) && file.seek(offset) && (file.write(QByteArray(1, static_cast<char>(byte[0] ^ 0x7F))) == 1);
+    }
+}
+
+class TestBittorrentJournalResumeDataStorage final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentJournalResumeDataStorage)
+
+public:
+    TestBittorrentJournalResumeDataStorage() = default;
+
+private slots:
+    void initTestCase()
+    {
+        QVERIFY(m_profileDir.isValid());
+
+        Logger::initInstance();
+        Profile::initInstance(Path(m_profileDir.path()), {}, false);
+        SettingsStorage::initInstance();
+        Preferences::initInstance();
+    }
+
+    void cleanupTestCase()
+    {
+        Preferences::freeInstance();
+        SettingsStorage::freeInstance();
+        Profile::freeInstance();
+        Logger::freeInstance();
+    }
+
+    void testStoreAndRemove() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path path = Path(tmpDir.path()) / Path(u"resume.journal"_s);
+
+        const QList<TestTorrent> torrents {makeTorrent(0), makeTorrent(1), makeTorrent(2)};
+        {
+            // the records are written by the time the storage is destroyed
+            const JournalResumeDataStorage storage {path};
+            QVERIFY(storage.registeredTorrents().isEmpty());
+            for (const TestTorrent &torrent : torrents)
+                storage.store(torrent.id, torrent.params);
+            storage.remove(torrents[1].id);
+        }
+
+        const JournalResumeDataStorage storage {path};
+        QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[0].id, torrents[2].id}));
+        QCOMPARE(loadedName(storage, torrents[0].id), u"Torrent 0"_s);
+        QCOMPARE(loadedName(storage, torrents[2].id), u"Torrent 2"_s);
+        QVERIFY(!storage.load(torrents[1].id));
+    }
+
+    void testOverwrite() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path path = Path(tmpDir.path()) / Path(u"resume.journal"_s);
+
+        TestTorrent torrent = makeTorrent(0);
+        {
+            const JournalResumeDataStorage storage {path};
+            storage.store(torrent.id, torrent.params);
+            torrent.params.name = u"Renamed torrent"_s;
+            storage.store(torrent.id, torrent.params);
+        }
+
+        const JournalResumeDataStorage storage {path};
+        QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrent.id}));
+        QCOMPARE(loadedName(storage, torrent.id), u"Renamed torrent"_s);
+    }
+
+    void testQueueReplay() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path path = Path(tmpDir.path()) / Path(u"resume.journal"_s);
+
+        const QList<TestTorrent> torrents {makeTorrent(0), makeTorrent(1), makeTorrent(2), makeTorrent(3)};
+        {
+            const JournalResumeDataStorage storage {path};
+            for (const TestTorrent &torrent : torrents)
+                storage.store(torrent.id, torrent.params);
+            storage.storeQueue({torrents[0].id, torrents[1].id, torrents[2].id});
+            // the latest queue is replayed, it may refer to the removed torrents
+            storage.storeQueue({torrents[2].id, torrents[1].id, torrents[0].id});
+            storage.remove(torrents[1].id);
+        }
+
+        {
+            // the torrents missing in the queue follow it in order of their records
+            const JournalResumeDataStorage storage {path};
+            QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[2].id, torrents[0].id, torrents[3].id}));
+
+            storage.store(torrents[1].id, torrents[1].params);
+            storage.storeQueue({torrents[1].id, torrents[3].id});
+        }
+
+        const JournalResumeDataStorage storage {path};
+        QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[1].id, torrents[3].id, torrents[0].id, torrents[2].id}));
+    }
+
+    void testTruncatedLastRecord() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path path = Path(tmpDir.path()) / Path(u"resume.journal"_s);
+
+        const QList<TestTorrent> torrents {makeTorrent(0), makeTorrent(1), makeTorrent(2)};
+        {
+            const JournalResumeDataStorage storage {path};
+            storage.store(torrents[0].id, torrents[0].params);
+        }
+        const qint64 validSize = fileSize(path);
+        {
+            const JournalResumeDataStorage storage {path};
+            storage.store(torrents[1].id, torrents[1].params);
+        }
+
+        // the application was terminated while the record was being written
+        QVERIFY(QFile::resize(path.data(), (fileSize(path) - 10)));
+
+        {
+            const JournalResumeDataStorage storage {path};
+            QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[0].id}));
+            QCOMPARE(fileSize(path), validSize);
+            QCOMPARE(loadedName(storage, torrents[0].id), u"Torrent 0"_s);
+
+            // the new records follow the valid ones
+            storage.store(torrents[2].id, torrents[2].params);
+        }
+
+        const JournalResumeDataStorage storage {path};
+        QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[0].id, torrents[2].id}));
+        QCOMPARE(loadedName(storage, torrents[0].id), u"Torrent 0"_s);
+        QCOMPARE(loadedName(storage, torrents[2].id), u"Torrent 2"_s);
+    }
+
+    void testCorruptedLastRecord() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path path = Path(tmpDir.path()) / Path(u"resume.journal"_s);
+
+        const QList<TestTorrent> torrents {makeTorrent(0), makeTorrent(1)};
+        {
+            const JournalResumeDataStorage storage {path};
+            storage.store(torrents[0].id, torrents[0].params);
+        }
+        const qint64 firstRecordEnd = fileSize(path);
+        {
+            const JournalResumeDataStorage storage {path};
+            storage.store(torrents[1].id, torrents[1].params);
+            storage.storeQueue({torrents[1].id, torrents[0].id});
+        }
+        const qint64 validSize = fileSize(path);
+        {
+            const JournalResumeDataStorage storage {path};
+            storage.storeQueue({torrents[0].id, torrents[1].id});
+        }
+
+        // the record of unknown type ends the valid part of the journal
+        QVERIFY(changeByte(path, (validSize + RECORD_TYPE_OFFSET)));
+        {
+            const JournalResumeDataStorage storage {path};
+            QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[1].id, torrents[0].id}));
+            QCOMPARE(fileSize(path), validSize);
+
+            storage.storeQueue({torrents[0].id, torrents[1].id});
+        }
+
+        // so does the queue record which payload doesn't match its checksum
+        QVERIFY(changeByte(path, (fileSize(path) - 1)));
+        {
+            const JournalResumeDataStorage storage {path};
+            QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[1].id, torrents[0].id}));
+            QCOMPARE(fileSize(path), validSize);
+        }
+
+        // the payload of the resume data records is verified when they are loaded
+        QVERIFY(changeByte(path, (firstRecordEnd - 1)));
+        const JournalResumeDataStorage storage {path};
+        QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[1].id, torrents[0].id}));
+        QVERIFY(!storage.load(torrents[0].id));
+        QCOMPARE(loadedName(storage, torrents[1].id), u"Torrent 1"_s);
+    }
+
+    void testCompaction() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+        const Path path = Path(tmpDir.path()) / Path(u"resume.journal"_s);
+
+        TestTorrent bigTorrent = makeTorrent(0, (16 * 1024));
+        const QList<TestTorrent> torrents {makeTorrent(1), makeTorrent(2)};
+
+        // size of the journal having the single record is close enough to the size of the record
+        const Path scratchPath = Path(tmpDir.path()) / Path(u"scratch.journal"_s);
+        {
+            const JournalResumeDataStorage storage {scratchPath};
+            storage.store(bigTorrent.id, bigTorrent.params);
+        }
+        const qint64 bigRecordSize = fileSize(scratchPath);
+
+        // the journal is rewritten once the superseded records take more than 16 MiB
+        const int revisionsCount = 150;
+        const QString lastRevisionName = u"Revision %1"_s.arg(revisionsCount - 1);
+        {
+            const JournalResumeDataStorage storage {path};
+            for (const TestTorrent &torrent : torrents)
+                storage.store(torrent.id, torrent.params);
+            for (int i = 0; i < revisionsCount; ++i)
+            {
+                bigTorrent.params.name = u"Revision %1"_s.arg(i);
+                storage.store(bigTorrent.id, bigTorrent.params);
+            }
+            storage.storeQueue({torrents[1].id, bigTorrent.id, torrents[0].id});
+
+            QVERIFY(QTest::qWaitFor([&] { return (loadedName(storage, bigTorrent.id) == lastRevisionName); }, 60'000));
+            // the superseded revisions are dropped
+            QVERIFY(fileSize(path) < ((revisionsCount * bigRecordSize) / 2));
+
+            // the records are found at their new offsets
+            QCOMPARE(loadedName(storage, torrents[0].id), u"Torrent 1"_s);
+            QCOMPARE(loadedName(storage, torrents[1].id), u"Torrent 2"_s);
+
+            storage.store(torrents[0].id, torrents[0].params);
+        }
+
+        const JournalResumeDataStorage storage {path};
+        QCOMPARE(storage.registeredTorrents(), QList<TorrentID>({torrents[1].id, bigTorrent.id, torrents[0].id}));
+        QCOMPARE(loadedName(storage, bigTorrent.id), lastRevisionName);
+        QCOMPARE(loadedName(storage, torrents[0].id), u"Torrent 1"_s);
+        QCOMPARE(loadedName(storage, torrents[1].id), u"Torrent 2"_s);
+    }
+
+private:
+    QTemporaryDir m_profileDir;
+};
+
+QTEST_GUILESS_MAIN(TestBittorrentJournalResumeDataStorage)
+#include "testbittorrentjournalresumedatastorage.moc"
@@ -0,0 +1,120 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <algorithm>
+
+#include <libtorrent/bitfield.hpp>
+
+#include <QBitArray>
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/ltqbitarray.h"
+
+namespace
+{
+    lt::bitfield makeBitfield(const QBitArray &bits)
+    {
+        lt::bitfield result {static_cast<int>(bits.size()), false};
+        for (qsizetype i = 0; i < bits.size(); ++i)
+        {
+            if (bits.testBit(i))
+                result.set_bit(static_cast<int>(i));
+        }
+        return result;
+    }
+
+    QBitArray makeBits(const qsizetype size, const int step, const int offset = 0)
+    {
+        QBitArray result {size};
+        for (qsizetype i = offset; i < size; i += step)
+            result.setBit(i);
+        return result;
+    }
+}
+
+class TestBittorrentLTQBitArray final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentLTQBitArray)
+
+public:
+    TestBittorrentLTQBitArray() = default;
+
+private slots:
+    void testToQBitArray_data() const
+    {
+        QTest::addColumn<QBitArray>("bits");
+
+        QTest::newRow("empty") << QBitArray();
+        QTest::newRow("single byte") << makeBits(5, 2);
+        QTest::newRow("single word") << makeBits(64, 3, 1);
+        QTest::newRow("words and tail") << makeBits(1001, 7, 2);
+        QTest::newRow("all set") << QBitArray(517, true);
+    }
+
+    void testToQBitArray() const
+    {
+        QFETCH(QBitArray, bits);
+
+        QCOMPARE(BitTorrent::LT::toQBitArray(makeBitfield(bits)), bits);
+    }
+
+    void testCountSetBitsNotIn_data() const
+    {
+        QTest::addColumn<QBitArray>("bits");
+        QTest::addColumn<QBitArray>("mask");
+
+        QTest::newRow("empty") << QBitArray() << QBitArray();
+        QTest::newRow("empty mask") << makeBits(100, 3) << QBitArray();
+        QTest::newRow("single byte") << makeBits(6, 1) << makeBits(6, 2);
+        QTest::newRow("words and tail") << makeBits(1001, 3) << makeBits(1001, 5, 1);
+        QTest::newRow("shorter mask") << makeBits(1001, 3) << makeBits(555, 2);
+        QTest::newRow("longer mask") << makeBits(333, 1) << makeBits(1001, 4);
+        QTest::newRow("all masked") << makeBits(777, 2) << QBitArray(777, true);
+    }
+
+    void testCountSetBitsNotIn() const
+    {
+        QFETCH(QBitArray, bits);
+        QFETCH(QBitArray, mask);
+
+        qsizetype expected = 0;
+        for (qsizetype i = 0; i < std::min(bits.size(), mask.size()); ++i)
+        {
+            if (bits.testBit(i) && !mask.testBit(i))
+                ++expected;
+        }
+
+        QCOMPARE(BitTorrent::LT::countSetBitsNotIn(makeBitfield(bits), mask), expected);
+        QCOMPARE(BitTorrent::LT::countSetBitsNotIn(makeBitfield(bits), makeBitfield(mask)), expected);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentLTQBitArray)
+#include "testbittorrentltqbitarray.moc"
@@ -0,0 +1,134 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/metadatadownloadscheduler.h"
+#include "base/global.h"
+
+using BitTorrent::MetadataDownloadPriority;
+using BitTorrent::MetadataDownloadScheduler;
+using BitTorrent::TorrentID;
+
+namespace
+{
+    TorrentID makeID(const int index)
+    {
+        return TorrentID::fromString(u"%1"_s.arg(index, 40, 16, u'0'));
+    }
+}
+
+class TestBittorrentMetadataDownloadScheduler final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentMetadataDownloadScheduler)
+
+public:
+    TestBittorrentMetadataDownloadScheduler() = default;
+
+private slots:
+    void testMaxActive() const
+    {
+        MetadataDownloadScheduler scheduler {2};
+        QCOMPARE(scheduler.maxActive(), 2);
+        QVERIFY(scheduler.isEmpty());
+
+        QVERIFY(scheduler.schedule(makeID(1), MetadataDownloadPriority::Normal, 100));
+        QVERIFY(scheduler.schedule(makeID(2), MetadataDownloadPriority::Normal, 100));
+        QVERIFY(scheduler.schedule(makeID(3), MetadataDownloadPriority::Normal, 100));
+        QVERIFY(!scheduler.schedule(makeID(1), MetadataDownloadPriority::Normal, 100));
+        QCOMPARE(scheduler.queuedCount(), 3);
+
+        QCOMPARE(scheduler.takeStartable(100), QList<TorrentID>({makeID(1), makeID(2)}));
+        QCOMPARE(scheduler.takeStartable(100), QList<TorrentID>());
+        QVERIFY(scheduler.isActive(makeID(1)));
+        QVERIFY(scheduler.isQueued(makeID(3)));
+        QVERIFY(!scheduler.schedule(makeID(2), MetadataDownloadPriority::Normal, 100));
+
+        QVERIFY(scheduler.remove(makeID(1)));
+        QVERIFY(!scheduler.remove(makeID(1)));
+        QCOMPARE(scheduler.takeStartable(101), QList<TorrentID>({makeID(3)}));
+        QCOMPARE(scheduler.activeCount(), 2);
+        QCOMPARE(scheduler.queuedCount(), 0);
+
+        scheduler.setMaxActive(0);
+        QCOMPARE(scheduler.maxActive(), 1);
+    }
+
+    void testPriority() const
+    {
+        MetadataDownloadScheduler scheduler {1};
+
+        QVERIFY(scheduler.schedule(makeID(1), MetadataDownloadPriority::Normal, 100));
+        QVERIFY(scheduler.schedule(makeID(2), MetadataDownloadPriority::Normal, 100));
+        QVERIFY(scheduler.schedule(makeID(3), MetadataDownloadPriority::High, 101));
+        QVERIFY(scheduler.schedule(makeID(4), MetadataDownloadPriority::High, 102));
+
+        // the downloads of the same priority are started in the order they were scheduled
+        QCOMPARE(scheduler.takeStartable(102), QList<TorrentID>({makeID(3)}));
+        QVERIFY(scheduler.remove(makeID(3)));
+        QCOMPARE(scheduler.takeStartable(102), QList<TorrentID>({makeID(4)}));
+        QVERIFY(scheduler.remove(makeID(4)));
+        QCOMPARE(scheduler.takeStartable(102), QList<TorrentID>({makeID(1)}));
+        QVERIFY(scheduler.remove(makeID(1)));
+        QCOMPARE(scheduler.takeStartable(102), QList<TorrentID>({makeID(2)}));
+    }
+
+    void testExpiry() const
+    {
+        MetadataDownloadScheduler scheduler {1, 60};
+        QCOMPARE(scheduler.ttl(), 60);
+
+        QVERIFY(scheduler.schedule(makeID(1), MetadataDownloadPriority::Normal, 100));
+        QVERIFY(scheduler.schedule(makeID(2), MetadataDownloadPriority::Normal, 100));
+        QVERIFY(scheduler.schedule(makeID(3), MetadataDownloadPriority::High, 100));
+        QCOMPARE(scheduler.takeStartable(130), QList<TorrentID>({makeID(3)}));
+
+        // the queued downloads expire since they were scheduled
+        QCOMPARE(scheduler.takeExpired(159), QList<TorrentID>());
+        QCOMPARE(scheduler.takeExpired(160), QList<TorrentID>({makeID(1), makeID(2)}));
+        QVERIFY(!scheduler.isQueued(makeID(1)));
+
+        // the downloads of high priority don't expire
+        QCOMPARE(scheduler.takeExpired(1000), QList<TorrentID>());
+        QVERIFY(scheduler.remove(makeID(3)));
+        QVERIFY(scheduler.isEmpty());
+
+        // the active downloads expire since they were started
+        QVERIFY(scheduler.schedule(makeID(4), MetadataDownloadPriority::Normal, 1000));
+        QCOMPARE(scheduler.takeStartable(1050), QList<TorrentID>({makeID(4)}));
+        QCOMPARE(scheduler.takeExpired(1100), QList<TorrentID>());
+        QCOMPARE(scheduler.takeExpired(1110), QList<TorrentID>({makeID(4)}));
+        QVERIFY(scheduler.isEmpty());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentMetadataDownloadScheduler)
+#include "testbittorrentmetadatadownloadscheduler.moc"
@@ -0,0 +1,93 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/peerstatistics.h"
+#include "base/global.h"
+
+class TestBittorrentPeerStatistics final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentPeerStatistics)
+
+public:
+    TestBittorrentPeerStatistics() = default;
+
+private slots:
+    void testAdd() const
+    {
+        BitTorrent::PeerStatistics stats;
+        stats.clients[u"qB"_s] = {.downloaded = 10, .uploaded = 20, .connections = 1};
+
+        BitTorrent::PeerStatistics other;
+        other.clients[u"qB"_s] = {.downloaded = 5, .uploaded = 0, .connections = 2};
+        other.countries[u"de"_s] = {.downloaded = 5, .uploaded = 0, .connections = 2};
+        stats += other;
+
+        QCOMPARE(stats.clients.size(), 1);
+        QCOMPARE(stats.clients[u"qB"_s].downloaded, 15);
+        QCOMPARE(stats.clients[u"qB"_s].uploaded, 20);
+        QCOMPARE(stats.clients[u"qB"_s].connections, 3);
+        QCOMPARE(stats.countries.size(), 1);
+        QCOMPARE(stats.countries[u"de"_s].downloaded, 5);
+    }
+
+    void testSubtract() const
+    {
+        BitTorrent::PeerStatistics stats;
+        stats.clients[u"qB"_s] = {.downloaded = 10, .uploaded = 20, .connections = 3};
+        stats.clients[u"UT"_s] = {.downloaded = 1, .uploaded = 1, .connections = 1};
+        stats.countries[u"de"_s] = {.downloaded = 11, .uploaded = 21, .connections = 4};
+
+        BitTorrent::PeerStatistics other;
+        other.clients[u"qB"_s] = {.downloaded = 4, .uploaded = 20, .connections = 1};
+        other.clients[u"UT"_s] = {.downloaded = 1, .uploaded = 1, .connections = 1};
+        other.countries[u"de"_s] = {.downloaded = 5, .uploaded = 21, .connections = 2};
+        // unknown entries are ignored
+        other.countries[u"fr"_s] = {.downloaded = 1, .uploaded = 1, .connections = 1};
+        stats -= other;
+
+        QCOMPARE(stats.clients.size(), 1);
+        QCOMPARE(stats.clients[u"qB"_s].downloaded, 6);
+        QCOMPARE(stats.clients[u"qB"_s].uploaded, 0);
+        QCOMPARE(stats.clients[u"qB"_s].connections, 2);
+        QCOMPARE(stats.countries.size(), 1);
+        QCOMPARE(stats.countries[u"de"_s].downloaded, 6);
+        QCOMPARE(stats.countries[u"de"_s].connections, 2);
+
+        const BitTorrent::PeerStatistics remaining = stats;
+        stats -= remaining;
+        QVERIFY(stats.clients.isEmpty());
+        QVERIFY(stats.countries.isEmpty());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentPeerStatistics)
+#include "testbittorrentpeerstatistics.moc"
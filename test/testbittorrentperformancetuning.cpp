@@ -0,0 +1,116 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/performancetuning.h"
+#include "base/global.h"
+
+using BitTorrent::HostResources;
+using BitTorrent::PerformanceSettings;
+
+namespace
+{
+    const qint64 GiB = 1024 * 1024 * 1024;
+}
+
+class TestBittorrentPerformanceTuning final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentPerformanceTuning)
+
+public:
+    TestBittorrentPerformanceTuning() = default;
+
+private slots:
+    void testUnknownResources() const
+    {
+        // Nothing known about the host results in the defaults
+        QVERIFY(BitTorrent::autoTunedPerformanceSettings({}, 0) == PerformanceSettings());
+    }
+
+    void testLargeHost() const
+    {
+        const HostResources resources {.cpuCount = 32, .physicalMemory = (64 * GiB), .linkSpeed = 1'250'000'000};
+        const PerformanceSettings settings = BitTorrent::autoTunedPerformanceSettings(resources, 0);
+
+        QCOMPARE(settings.asyncIOThreads, 64);
+        QCOMPARE(settings.hashingThreads, 16);
+        QCOMPARE(settings.connectionSpeed, 200);
+        QCOMPARE(settings.filePoolSize, 2000);
+        QCOMPARE(settings.checkingMemUsage, 256);
+        QCOMPARE(settings.sendBufferWatermark, (16 * 1024));
+        QCOMPARE(settings.sendBufferLowWatermark, (4 * 1024));
+        QCOMPARE(settings.socketSendBufferSize, (4 * 1024 * 1024));
+    }
+
+    void testRotationalStorage() const
+    {
+        const HostResources resources {.cpuCount = 32, .isRotationalStorage = true};
+        const PerformanceSettings settings = BitTorrent::autoTunedPerformanceSettings(resources, 0);
+
+        QCOMPARE(settings.asyncIOThreads, 4);
+        QCOMPARE(settings.hashingThreads, 1);
+    }
+
+    void testOpenFilesLimit() const
+    {
+        const HostResources resources {.physicalMemory = (64 * GiB), .openFilesLimit = 1024};
+        QCOMPARE(BitTorrent::autoTunedPerformanceSettings(resources, 0).filePoolSize, 256);
+    }
+
+    void testObservedRate() const
+    {
+        const PerformanceSettings slowSettings = BitTorrent::autoTunedPerformanceSettings({}, 1'000'000);
+        QCOMPARE(slowSettings.sendBufferWatermark, PerformanceSettings().sendBufferWatermark);
+
+        // The observed rate is used when the link speed is unknown,
+        // close rates result in the same settings
+        const PerformanceSettings fastSettings = BitTorrent::autoTunedPerformanceSettings({}, 70'000'000);
+        QVERIFY(fastSettings.sendBufferWatermark > PerformanceSettings().sendBufferWatermark);
+        QVERIFY(BitTorrent::autoTunedPerformanceSettings({}, 80'000'000) == fastSettings);
+    }
+
+    void testOverrides() const
+    {
+        const HostResources resources {.cpuCount = 32, .physicalMemory = (64 * GiB)};
+        const PerformanceSettings autoTuned = BitTorrent::autoTunedPerformanceSettings(resources, 0);
+
+        QVERIFY(BitTorrent::applyPerformanceOverrides(autoTuned, {}) == autoTuned);
+
+        PerformanceSettings manual;
+        manual.filePoolSize = 42;
+        const PerformanceSettings settings = BitTorrent::applyPerformanceOverrides(autoTuned, manual);
+        QCOMPARE(settings.filePoolSize, 42);
+        QCOMPARE(settings.asyncIOThreads, autoTuned.asyncIOThreads);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentPerformanceTuning)
+#include "testbittorrentperformancetuning.moc"
@@ -0,0 +1,175 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <memory>
+
+#include <QByteArray>
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/persistentreadcache.h"
+#include "base/global.h"
+#include "base/path.h"
+
+namespace
+{
+    const int BLOCK_SIZE = 16 * 1024;
+    const QString TORRENT_ID = u"0123456789abcdef0123456789abcdef01234567"_s;
+    const QString OTHER_TORRENT_ID = u"fedcba9876543210fedcba9876543210fedcba98"_s;
+
+    PersistentReadCache::BlockKey blockKey(const QString &torrentID, const int piece, const int offset = 0)
+    {
+        return {torrentID, piece, offset, BLOCK_SIZE};
+    }
+
+    // Returns null QByteArray if the block isn't cached
+    QByteArray readBlock(PersistentReadCache &cache, const PersistentReadCache::BlockKey &key)
+    {
+        const auto result = std::make_shared<QByteArray>();
+        if (!cache.read(key, [result](const QByteArray &data) { *result = data; }))
+            return {};
+
+        cache.waitForDone();
+        return *result;
+    }
+}
+
+class TestBittorrentPersistentReadCache final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentPersistentReadCache)
+
+public:
+    TestBittorrentPersistentReadCache() = default;
+
+private slots:
+    void testStore() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        PersistentReadCache cache {Path(tmpDir.path()), (4 * BLOCK_SIZE)};
+        cache.waitForDone();
+
+        const QByteArray data1(BLOCK_SIZE, 'a');
+        const QByteArray data2(BLOCK_SIZE, 'b');
+        cache.store(blockKey(TORRENT_ID, 0), data1);
+        cache.store(blockKey(TORRENT_ID, 0, BLOCK_SIZE), data2);
+        QCOMPARE(cache.statistics().size, (2 * BLOCK_SIZE));
+
+        QCOMPARE(readBlock(cache, blockKey(TORRENT_ID, 0)), data1);
+        QCOMPARE(readBlock(cache, blockKey(TORRENT_ID, 0, BLOCK_SIZE)), data2);
+        QVERIFY(readBlock(cache, blockKey(TORRENT_ID, 1)).isNull());
+        QVERIFY(readBlock(cache, blockKey(OTHER_TORRENT_ID, 0)).isNull());
+        QCOMPARE(cache.statistics().hits, 2);
+    }
+
+    void testEviction() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        PersistentReadCache cache {Path(tmpDir.path()), (2 * BLOCK_SIZE)};
+        cache.waitForDone();
+
+        const QByteArray data(BLOCK_SIZE, 'a');
+        cache.store(blockKey(TORRENT_ID, 0), data);
+        cache.store(blockKey(TORRENT_ID, 1), data);
+        // make piece 1 the least recently used one
+        QCOMPARE(readBlock(cache, blockKey(TORRENT_ID, 0)), data);
+
+        cache.store(blockKey(TORRENT_ID, 2), data);
+        QCOMPARE(cache.statistics().size, (2 * BLOCK_SIZE));
+        QVERIFY(!readBlock(cache, blockKey(TORRENT_ID, 0)).isNull());
+        QVERIFY(readBlock(cache, blockKey(TORRENT_ID, 1)).isNull());
+        QVERIFY(!readBlock(cache, blockKey(TORRENT_ID, 2)).isNull());
+
+        cache.setCapacity(0);
+        QCOMPARE(cache.statistics().size, 0);
+    }
+
+    void testRemove() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        PersistentReadCache cache {Path(tmpDir.path()), (8 * BLOCK_SIZE)};
+        cache.waitForDone();
+
+        const QByteArray data(BLOCK_SIZE, 'a');
+        cache.store(blockKey(TORRENT_ID, 0), data);
+        cache.store(blockKey(TORRENT_ID, 1), data);
+        cache.store(blockKey(OTHER_TORRENT_ID, 0), data);
+
+        cache.removePiece(TORRENT_ID, 0);
+        QVERIFY(readBlock(cache, blockKey(TORRENT_ID, 0)).isNull());
+        QVERIFY(!readBlock(cache, blockKey(TORRENT_ID, 1)).isNull());
+
+        cache.removeTorrent(TORRENT_ID);
+        QVERIFY(readBlock(cache, blockKey(TORRENT_ID, 1)).isNull());
+        QVERIFY(!readBlock(cache, blockKey(OTHER_TORRENT_ID, 0)).isNull());
+        QCOMPARE(cache.statistics().size, BLOCK_SIZE);
+    }
+
+    void testPersistence() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const QByteArray data(BLOCK_SIZE, 'a');
+        {
+            PersistentReadCache cache {Path(tmpDir.path()), (4 * BLOCK_SIZE)};
+            cache.waitForDone();
+            cache.store(blockKey(TORRENT_ID, 0), data);
+            cache.store(blockKey(OTHER_TORRENT_ID, 3, BLOCK_SIZE), data);
+        }
+
+        {
+            PersistentReadCache cache {Path(tmpDir.path()), (4 * BLOCK_SIZE)};
+            cache.waitForDone();
+            QCOMPARE(cache.statistics().size, (2 * BLOCK_SIZE));
+            QCOMPARE(readBlock(cache, blockKey(TORRENT_ID, 0)), data);
+            QCOMPARE(readBlock(cache, blockKey(OTHER_TORRENT_ID, 3, BLOCK_SIZE)), data);
+        }
+
+        // the cache which wasn't closed properly (i.e. without the index) is discarded
+        QVERIFY((Path(tmpDir.path()) / Path(TORRENT_ID) / Path(u"0"_s)).exists());
+        QVERIFY(QFile::remove((Path(tmpDir.path()) / Path(u"index"_s)).data()));
+        {
+            PersistentReadCache cache {Path(tmpDir.path()), (4 * BLOCK_SIZE)};
+            cache.waitForDone();
+            QCOMPARE(cache.statistics().size, 0);
+            QVERIFY(!(Path(tmpDir.path()) / Path(TORRENT_ID) / Path(u"0"_s)).exists());
+        }
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentPersistentReadCache)
+#include "testbittorrentpersistentreadcache.moc"
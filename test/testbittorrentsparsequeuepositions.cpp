@@ -0,0 +1,184 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/sparsequeuepositions.h"
+#include "base/global.h"
+
+using BitTorrent::SparseQueuePositions;
+using BitTorrent::TorrentID;
+
+namespace
+{
+    TorrentID makeID(const int index)
+    {
+        return TorrentID::fromString(u"%1"_s.arg(index, 40, 16, u'0'));
+    }
+
+    QList<TorrentID> makeQueue(const int count)
+    {
+        QList<TorrentID> queue;
+        queue.reserve(count);
+        for (int i = 0; i < count; ++i)
+            queue.append(makeID(i + 1));
+        return queue;
+    }
+
+    bool isOrdered(const SparseQueuePositions &positions, const QList<TorrentID> &queue)
+    {
+        for (qsizetype i = 1; i < queue.size(); ++i)
+        {
+            if (positions.position(queue[i - 1]) >= positions.position(queue[i]))
+                return false;
+        }
+        return true;
+    }
+}
+
+class TestBittorrentSparseQueuePositions final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentSparseQueuePositions)
+
+public:
+    TestBittorrentSparseQueuePositions() = default;
+
+private slots:
+    void testInitial() const
+    {
+        SparseQueuePositions positions;
+        const QList<TorrentID> queue = makeQueue(10);
+
+        QCOMPARE(positions.update(queue).size(), 10);
+        QVERIFY(isOrdered(positions, queue));
+        QCOMPARE(positions.position(queue[0]), SparseQueuePositions::BASE_KEY);
+        QCOMPARE(positions.position(makeID(100)), Q_INT64_C(-1));
+
+        QVERIFY(positions.update(queue).isEmpty());
+    }
+
+    void testMove() const
+    {
+        SparseQueuePositions positions;
+        QList<TorrentID> queue = makeQueue(1000);
+        positions.update(queue);
+
+        queue.move(500, 0);
+        QCOMPARE(positions.update(queue).size(), 1);
+        QVERIFY(isOrdered(positions, queue));
+
+        queue.move(0, 999);
+        QCOMPARE(positions.update(queue).size(), 1);
+        QVERIFY(isOrdered(positions, queue));
+
+        queue.move(10, 20);
+        QCOMPARE(positions.update(queue).size(), 1);
+        QVERIFY(isOrdered(positions, queue));
+    }
+
+    void testInsert() const
+    {
+        SparseQueuePositions positions;
+        QList<TorrentID> queue = makeQueue(1000);
+        positions.update(queue);
+
+        queue.prepend(makeID(2000));
+        const auto changes = positions.update(queue);
+        QCOMPARE(changes.size(), 1);
+        QCOMPARE(changes[0].first, makeID(2000));
+        QVERIFY(isOrdered(positions, queue));
+
+        queue.insert(500, makeID(2001));
+        QCOMPARE(positions.update(queue).size(), 1);
+        QVERIFY(isOrdered(positions, queue));
+
+        queue.append(makeID(2002));
+        QCOMPARE(positions.update(queue).size(), 1);
+        QVERIFY(isOrdered(positions, queue));
+    }
+
+    void testRenumber() const
+    {
+        // the legacy positions are dense, there is no room to insert a torrent before the first one
+        QHash<TorrentID, qint64> storedPositions;
+        QList<TorrentID> queue = makeQueue(100);
+        for (qsizetype i = 0; i < queue.size(); ++i)
+            storedPositions.insert(queue[i], i);
+
+        SparseQueuePositions positions {storedPositions};
+        QVERIFY(positions.update(queue).isEmpty());
+
+        queue.prepend(makeID(200));
+        QCOMPARE(positions.update(queue).size(), 101);
+        QVERIFY(isOrdered(positions, queue));
+
+        // the room between two torrents is exhausted by the repeated insertions at the same place
+        for (int i = 0; i < 100; ++i)
+        {
+            queue.insert(50, makeID(201 + i));
+            positions.update(queue);
+            QVERIFY(isOrdered(positions, queue));
+        }
+    }
+
+    void testRemove() const
+    {
+        SparseQueuePositions positions;
+        QList<TorrentID> queue = makeQueue(10);
+        positions.update(queue);
+
+        positions.remove(queue[5]);
+        QCOMPARE(positions.position(queue[5]), Q_INT64_C(-1));
+
+        const auto changes = positions.update(queue);
+        QCOMPARE(changes.size(), 1);
+        QCOMPARE(changes[0].first, queue[5]);
+        QVERIFY(isOrdered(positions, queue));
+
+        queue.removeAt(5);
+        QVERIFY(positions.update(queue).isEmpty());
+    }
+
+    void testInvalidIDs() const
+    {
+        SparseQueuePositions positions;
+        QList<TorrentID> queue = makeQueue(3);
+        queue.insert(1, TorrentID());
+
+        QCOMPARE(positions.update(queue).size(), 3);
+        QCOMPARE(positions.position(TorrentID()), Q_INT64_C(-1));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentSparseQueuePositions)
+#include "testbittorrentsparsequeuepositions.moc"
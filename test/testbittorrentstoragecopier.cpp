@@ -0,0 +1,153 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+#include <atomic>
+
+#include <QByteArray>
+#include <QDir>
+#include <QFile>
+#include <QObject>
+#include <QTemporaryDir>
+#include <QTest>
+
+#include "base/bittorrent/storagecopier.h"
+#include "base/global.h"
+#include "base/path.h"
+
+namespace
+{
+    bool writeFile(const Path &path, const QByteArray &data)
+    {
+        QFile file {path.data()};
+        return file.open(QIODevice::WriteOnly) && (file.write(data) == data.size());
+    }
+
+    QByteArray readFile(const Path &path)
+    {
+        QFile file {path.data()};
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+}
+
+class TestBittorrentStorageCopier final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentStorageCopier)
+
+public:
+    TestBittorrentStorageCopier() = default;
+
+private slots:
+    void testCopyFiles() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path sourcePath = Path(tmpDir.path()) / Path(u"source"_s);
+        const Path destinationPath = Path(tmpDir.path()) / Path(u"destination"_s);
+        const QByteArray data1 {(3 * 1024 * 1024), 'a'};
+        const QByteArray data2 = "second file";
+        QVERIFY(QDir().mkpath((sourcePath / Path(u"folder"_s)).data()));
+        QVERIFY(writeFile((sourcePath / Path(u"file1"_s)), data1));
+        QVERIFY(writeFile((sourcePath / Path(u"folder/file2"_s)), data2));
+        QVERIFY(writeFile((sourcePath / Path(u"empty"_s)), {}));
+
+        const QList<StorageCopier::File> files
+        {
+            {(sourcePath / Path(u"file1"_s)), (destinationPath / Path(u"file1"_s))},
+            {(sourcePath / Path(u"folder/file2"_s)), (destinationPath / Path(u"folder/file2"_s))},
+            {(sourcePath / Path(u"empty"_s)), (destinationPath / Path(u"empty"_s))},
+            // not downloaded yet
+            {(sourcePath / Path(u"missing"_s)), (destinationPath / Path(u"missing"_s))}
+        };
+
+        std::atomic<qint64> reportedBytes = 0;
+        StorageCopier copier {files, [&reportedBytes](const qint64 copiedBytes)
+        {
+            if (copiedBytes > reportedBytes)
+                reportedBytes = copiedBytes;
+        }};
+        QVERIFY(copier.copyFiles(2).has_value());
+
+        const qint64 totalSize = data1.size() + data2.size();
+        QCOMPARE(copier.copiedBytes(), totalSize);
+        QCOMPARE(reportedBytes.load(), totalSize);
+        QCOMPARE(readFile(destinationPath / Path(u"file1"_s)), data1);
+        QCOMPARE(readFile(destinationPath / Path(u"folder/file2"_s)), data2);
+        QVERIFY((destinationPath / Path(u"empty"_s)).exists());
+        QVERIFY(!(destinationPath / Path(u"missing"_s)).exists());
+        QVERIFY((sourcePath / Path(u"file1"_s)).exists());
+
+        copier.removeSourceFiles();
+        QVERIFY(!(sourcePath / Path(u"file1"_s)).exists());
+        QVERIFY(!(sourcePath / Path(u"folder/file2"_s)).exists());
+    }
+
+    void testFailureRemovesCopiedFiles() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path sourcePath = Path(tmpDir.path()) / Path(u"source"_s);
+        const Path destinationPath = Path(tmpDir.path()) / Path(u"destination"_s);
+        QVERIFY(QDir().mkpath(sourcePath.data()));
+        QVERIFY(QDir().mkpath(destinationPath.data()));
+        QVERIFY(writeFile((sourcePath / Path(u"file1"_s)), "data"));
+        QVERIFY(writeFile((sourcePath / Path(u"file2"_s)), "data"));
+        // the folder of the second file can't be created
+        QVERIFY(writeFile((destinationPath / Path(u"blocker"_s)), {}));
+
+        StorageCopier copier {{
+            {(sourcePath / Path(u"file1"_s)), (destinationPath / Path(u"file1"_s))},
+            {(sourcePath / Path(u"file2"_s)), (destinationPath / Path(u"blocker/file2"_s))}
+        }, {}};
+        QVERIFY(!copier.copyFiles(1).has_value());
+
+        QVERIFY(!(destinationPath / Path(u"file1"_s)).exists());
+        QVERIFY((sourcePath / Path(u"file1"_s)).exists());
+        QVERIFY((sourcePath / Path(u"file2"_s)).exists());
+    }
+
+    void testCancel() const
+    {
+        const QTemporaryDir tmpDir;
+        QVERIFY(tmpDir.isValid());
+
+        const Path sourcePath = Path(tmpDir.path()) / Path(u"source"_s);
+        const Path destinationPath = Path(tmpDir.path()) / Path(u"destination"_s);
+        QVERIFY(QDir().mkpath(sourcePath.data()));
+        QVERIFY(writeFile((sourcePath / Path(u"file"_s)), "data"));
+
+        StorageCopier copier {{{(sourcePath / Path(u"file"_s)), (destinationPath / Path(u"file"_s))}}, {}};
+        copier.cancel();
+        QVERIFY(!copier.copyFiles(1).has_value());
+        QVERIFY(!(destinationPath / Path(u"file"_s)).exists());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentStorageCopier)
+#include "testbittorrentstoragecopier.moc"
@@ -0,0 +1,195 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/trackerpeerstore.h"
+#include "base/global.h"
+
+using BitTorrent::TorrentID;
+using BitTorrent::TrackerPeerStore;
+
+namespace
+{
+    TorrentID makeID(const int index)
+    {
+        return TorrentID::fromString(u"%1"_s.arg(index, 40, 16, u'0'));
+    }
+
+    QByteArray makeEndpoint(const int index)
+    {
+        const char data[] = {10, 0, static_cast<char>(index >> 8), static_cast<char>(index), 0x1A, static_cast<char>(0xE1)};
+        return {data, sizeof(data)};
+    }
+
+    QByteArray makeEndpoint6(const int index)
+    {
+        QByteArray data(TrackerPeerStore::IPV6_ENDPOINT_SIZE, 0);
+        data[0] = static_cast<char>(0xFD);
+        data[15] = static_cast<char>(index);
+        return data;
+    }
+
+    TrackerPeerStore::Peer makePeer(const bool isSeeder = false)
+    {
+        return {.peerId = "-qB0000-000000000000", .address = "10.0.0.1", .port = 6881, .isSeeder = isSeeder};
+    }
+}
+
+class TestBittorrentTrackerPeerStore final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentTrackerPeerStore)
+
+public:
+    TestBittorrentTrackerPeerStore() = default;
+
+private slots:
+    void testAnnounce() const
+    {
+        TrackerPeerStore store {10, 10, 800};
+        QVERIFY(!store.announce(makeID(1), "invalid", makePeer(), 0));
+        QCOMPARE(store.torrentsCount(), 0);
+
+        QVERIFY(store.announce(makeID(1), makeEndpoint(1), makePeer(), 0));
+        QVERIFY(store.announce(makeID(1), makeEndpoint(2), makePeer(true), 0));
+        QVERIFY(store.announce(makeID(1), makeEndpoint6(3), makePeer(), 0));
+        QCOMPARE(store.torrentsCount(), 1);
+        QCOMPARE(store.peersCount(makeID(1)), 3);
+        QCOMPARE(store.stats(makeID(1)).seeders, 1);
+        QCOMPARE(store.stats(makeID(1)).leechers, 2);
+
+        // announcing again replaces the peer
+        QVERIFY(store.announce(makeID(1), makeEndpoint(1), makePeer(true), 0));
+        QCOMPARE(store.peersCount(makeID(1)), 3);
+        QCOMPARE(store.stats(makeID(1)).seeders, 2);
+
+        const TrackerPeerStore::CompactPeers compactPeers = store.compactPeers(makeID(1), 50);
+        QCOMPARE(compactPeers.peers, (makeEndpoint(1) + makeEndpoint(2)));
+        QCOMPARE(compactPeers.peers6, makeEndpoint6(3));
+        QCOMPARE(store.peers(makeID(1), 50).size(), 3);
+        QCOMPARE(store.peers(makeID(1), 2).size(), 2);
+
+        store.addCompleted(makeID(1));
+        QCOMPARE(store.stats(makeID(1)).completed, 1);
+        QCOMPARE(store.peersCount(makeID(2)), 0);
+    }
+
+    void testRemove() const
+    {
+        TrackerPeerStore store {10, 10, 800};
+        for (int i = 0; i < 4; ++i)
+            store.announce(makeID(1), makeEndpoint(i), makePeer(i == 0), 0);
+
+        store.remove(makeID(1), makeEndpoint(0));
+        QCOMPARE(store.peersCount(makeID(1)), 3);
+        QCOMPARE(store.stats(makeID(1)).seeders, 0);
+        // the last peer takes place of the removed one
+        QCOMPARE(store.compactPeers(makeID(1), 50).peers, (makeEndpoint(3) + makeEndpoint(1) + makeEndpoint(2)));
+
+        store.remove(makeID(1), makeEndpoint(0));
+        QCOMPARE(store.peersCount(makeID(1)), 3);
+
+        store.remove(makeID(1), makeEndpoint(1));
+        store.remove(makeID(1), makeEndpoint(2));
+        store.remove(makeID(1), makeEndpoint(3));
+        QCOMPARE(store.torrentsCount(), 0);
+    }
+
+    void testLimits() const
+    {
+        TrackerPeerStore store {2, 3, 800};
+        store.announce(makeID(1), makeEndpoint(1), makePeer(), 100);
+        store.announce(makeID(1), makeEndpoint(2), makePeer(), 0);
+        store.announce(makeID(1), makeEndpoint(3), makePeer(), 100);
+        store.announce(makeID(1), makeEndpoint(4), makePeer(), 200);
+
+        // the peer which announced least recently is replaced
+        QCOMPARE(store.peersCount(makeID(1)), 3);
+        QCOMPARE(store.compactPeers(makeID(1), 50).peers, (makeEndpoint(1) + makeEndpoint(3) + makeEndpoint(4)));
+
+        store.announce(makeID(2), makeEndpoint(1), makePeer(), 0);
+        store.announce(makeID(3), makeEndpoint(1), makePeer(), 0);
+        QCOMPARE(store.torrentsCount(), 2);
+        QCOMPARE(store.peersCount(makeID(3)), 1);
+    }
+
+    void testPartialPeerList() const
+    {
+        TrackerPeerStore store {10, 10, 800};
+        for (int i = 0; i < 6; ++i)
+            store.announce(makeID(1), makeEndpoint(i), makePeer(), 0);
+        for (int i = 0; i < 2; ++i)
+            store.announce(makeID(1), makeEndpoint6(i), makePeer(), 0);
+
+        QVERIFY(store.compactPeers(makeID(1), 0).peers.isEmpty());
+
+        // the list is shared between the address families and rotated
+        TrackerPeerStore::CompactPeers compactPeers = store.compactPeers(makeID(1), 4);
+        QCOMPARE(compactPeers.peers, (makeEndpoint(0) + makeEndpoint(1) + makeEndpoint(2)));
+        QCOMPARE(compactPeers.peers6, makeEndpoint6(0));
+
+        compactPeers = store.compactPeers(makeID(1), 4);
+        QCOMPARE(compactPeers.peers, (makeEndpoint(3) + makeEndpoint(4) + makeEndpoint(5)));
+        QCOMPARE(compactPeers.peers6, makeEndpoint6(1));
+
+        compactPeers = store.compactPeers(makeID(1), 8);
+        QCOMPARE(compactPeers.peers.size(), (6 * TrackerPeerStore::IPV4_ENDPOINT_SIZE));
+        QCOMPARE(compactPeers.peers6.size(), (2 * TrackerPeerStore::IPV6_ENDPOINT_SIZE));
+    }
+
+    void testExpire() const
+    {
+        // peers live for 800 seconds at least and for 900 seconds at most
+        TrackerPeerStore store {10, 10, 800};
+        store.announce(makeID(1), makeEndpoint(1), makePeer(true), 0);
+        store.announce(makeID(1), makeEndpoint(2), makePeer(), 150);
+        store.announce(makeID(2), makeEndpoint(1), makePeer(), 50);
+
+        store.expire(850);
+        QCOMPARE(store.torrentsCount(), 2);
+
+        store.expire(900);
+        QCOMPARE(store.torrentsCount(), 1);
+        QCOMPARE(store.peersCount(makeID(1)), 1);
+        QCOMPARE(store.stats(makeID(1)).seeders, 0);
+
+        // announcing again keeps the peer
+        store.announce(makeID(1), makeEndpoint(2), makePeer(), 900);
+        store.expire(1100);
+        QCOMPARE(store.peersCount(makeID(1)), 1);
+
+        store.expire(1800);
+        QCOMPARE(store.torrentsCount(), 0);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentTrackerPeerStore)
+#include "testbittorrenttrackerpeerstore.moc"
@@ -0,0 +1,109 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <string>
+
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/trackerregistry.h"
+#include "base/global.h"
+
+using BitTorrent::TrackerRegistry;
+
+class TestBittorrentTrackerRegistry final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentTrackerRegistry)
+
+public:
+    TestBittorrentTrackerRegistry() = default;
+
+private slots:
+    void testURL() const
+    {
+        TrackerRegistry registry;
+
+        const QString url1 = registry.url(std::string("udp://tracker.example.org:6969/announce"));
+        const QString url2 = registry.url(std::string("udp://tracker.example.org:6969/announce"));
+        const QString url3 = registry.url(u"udp://tracker.example.org:6969/announce"_s);
+        QCOMPARE(url1, u"udp://tracker.example.org:6969/announce"_s);
+        QVERIFY(url1.isSharedWith(url2));
+        QVERIFY(url1.isSharedWith(url3));
+        QCOMPARE(registry.count(), 1);
+
+        const QString otherURL = registry.url(std::string("http://tracker.example.org/announce"));
+        QCOMPARE(otherURL, u"http://tracker.example.org/announce"_s);
+        QVERIFY(!otherURL.isSharedWith(url1));
+        QCOMPARE(registry.count(), 2);
+    }
+
+    void testEmpty() const
+    {
+        TrackerRegistry registry;
+
+        QVERIFY(registry.url(std::string()).isEmpty());
+        QVERIFY(registry.url(QString()).isEmpty());
+        QVERIFY(registry.message(std::string()).isEmpty());
+        QVERIFY(registry.errorMessage(std::string()).isEmpty());
+        QCOMPARE(registry.count(), 0);
+    }
+
+    void testMessages() const
+    {
+        TrackerRegistry registry;
+
+        const QString message1 = registry.message("Tracker is down");
+        const QString message2 = registry.message("Tracker is down");
+        QCOMPARE(message1, u"Tracker is down"_s);
+        QVERIFY(message1.isSharedWith(message2));
+
+        // messages and error messages are stored separately since they are decoded differently
+        const QString errorMessage = registry.errorMessage("Tracker is down");
+        QCOMPARE(errorMessage, u"Tracker is down"_s);
+        QVERIFY(!errorMessage.isSharedWith(message1));
+        QCOMPARE(registry.count(), 2);
+    }
+
+    void testPrune() const
+    {
+        TrackerRegistry registry;
+
+        const QString url = registry.url(std::string("udp://tracker.example.org:6969/announce"));
+        registry.url(std::string("http://tracker.example.org/announce"));
+        registry.message("Tracker is down");
+        QCOMPARE(registry.count(), 3);
+
+        registry.prune();
+        QCOMPARE(registry.count(), 1);
+        QVERIFY(registry.url(std::string("udp://tracker.example.org:6969/announce")).isSharedWith(url));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentTrackerRegistry)
+#include "testbittorrenttrackerregistry.moc"
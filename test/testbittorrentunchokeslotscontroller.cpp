@@ -0,0 +1,142 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include "base/bittorrent/unchokeslotscontroller.h"
+#include "base/global.h"
+
+using BitTorrent::UnchokeSlotsController;
+
+class TestBittorrentUnchokeSlotsController final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestBittorrentUnchokeSlotsController)
+
+public:
+    TestBittorrentUnchokeSlotsController() = default;
+
+private slots:
+    void testUnderUtilized() const
+    {
+        UnchokeSlotsController controller;
+        controller.setBaseLimits(20, 4);
+        QCOMPARE(controller.globalSlots(), 20);
+        QCOMPARE(controller.torrentSlots(), 4);
+
+        // limits aren't changed until the previous change is settled
+        QVERIFY(!controller.update(500, 1000, 20, 0));
+        QVERIFY(!controller.update(500, 1000, 20, 15'000));
+        QVERIFY(controller.update(500, 1000, 20, 30'000));
+        QCOMPARE(controller.globalSlots(), 25);
+        QCOMPARE(controller.torrentSlots(), 5);
+
+        QVERIFY(!controller.update(500, 1000, 25, 45'000));
+        QVERIFY(controller.update(500, 1000, 25, 60'000));
+        QCOMPARE(controller.globalSlots(), 31);
+
+        controller.reset();
+        QCOMPARE(controller.globalSlots(), 20);
+        QCOMPARE(controller.torrentSlots(), 4);
+    }
+
+    void testFreeSlots() const
+    {
+        UnchokeSlotsController controller;
+        controller.setBaseLimits(20, 4);
+
+        // there are not enough interested peers to use more slots
+        for (qint64 now = 0; now <= 120'000; now += 1000)
+            QVERIFY(!controller.update(500, 1000, 10, now));
+        QCOMPARE(controller.globalSlots(), 20);
+    }
+
+    void testSaturated() const
+    {
+        UnchokeSlotsController controller;
+        controller.setBaseLimits(20, 4);
+
+        QVERIFY(!controller.update(1000, 1000, 20, 0));
+        QVERIFY(controller.update(1000, 1000, 20, 30'000));
+        QCOMPARE(controller.globalSlots(), 16);
+        QCOMPARE(controller.torrentSlots(), 3);
+    }
+
+    void testDeadBand() const
+    {
+        UnchokeSlotsController controller;
+        controller.setBaseLimits(20, 4);
+
+        for (qint64 now = 0; now <= 120'000; now += 1000)
+            QVERIFY(!controller.update(900, 1000, 20, now));
+        QCOMPARE(controller.globalSlots(), 20);
+    }
+
+    void testSustain() const
+    {
+        UnchokeSlotsController controller;
+        controller.setBaseLimits(20, 4);
+
+        QVERIFY(!controller.update(900, 1000, 20, 0));
+        // the utilization has to be low for a while
+        QVERIFY(!controller.update(500, 1000, 20, 25'000));
+        QVERIFY(!controller.update(500, 1000, 20, 30'000));
+        QVERIFY(controller.update(500, 1000, 20, 35'000));
+    }
+
+    void testUnlimitedUploadRate() const
+    {
+        UnchokeSlotsController controller;
+        controller.setBaseLimits(20, 4);
+
+        // reaching the peak rate doesn't reduce the configured limits
+        for (qint64 now = 0; now <= 120'000; now += 1000)
+            QVERIFY(!controller.update(1000, 0, 20, now));
+        QCOMPARE(controller.globalSlots(), 20);
+
+        // the rate below the peak adds slots
+        QVERIFY(!controller.update(500, 0, 20, 130'000));
+        QVERIFY(controller.update(500, 0, 20, 140'000));
+        QCOMPARE(controller.globalSlots(), 25);
+    }
+
+    void testUnlimitedSlots() const
+    {
+        UnchokeSlotsController controller;
+        controller.setBaseLimits(-1, 4);
+
+        QVERIFY(!controller.update(500, 1000, 100, 0));
+        QVERIFY(controller.update(500, 1000, 100, 30'000));
+        QCOMPARE(controller.globalSlots(), -1);
+        QCOMPARE(controller.torrentSlots(), 5);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestBittorrentUnchokeSlotsController)
+#include "testbittorrentunchokeslotscontroller.moc"
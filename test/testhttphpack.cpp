@@ -0,0 +1,128 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/hpack.h"
+
+using namespace Http::HPack;
+
+class TestHttpHPack final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestHttpHPack)
+
+public:
+    TestHttpHPack() = default;
+
+private slots:
+    void testHuffman() const
+    {
+        // [rfc7541] C.4. Request Examples with Huffman Coding
+        QCOMPARE(encodeHuffman("www.example.com"), QByteArray::fromHex("f1e3c2e5f23a6ba0ab90f4ff"));
+        QCOMPARE(encodeHuffman("no-cache"), QByteArray::fromHex("a8eb10649cbf"));
+        QCOMPARE(encodeHuffman("custom-key"), QByteArray::fromHex("25a849e95ba97d7f"));
+
+        QCOMPARE(decodeHuffman(QByteArray::fromHex("f1e3c2e5f23a6ba0ab90f4ff")), "www.example.com"_ba);
+        QCOMPARE(decodeHuffman(QByteArray::fromHex("25a849e95bb8e8b4bf")), "custom-value"_ba);
+
+        const QByteArray binary = QByteArray::fromHex("00017f80feff");
+        QCOMPARE(decodeHuffman(encodeHuffman(binary)), binary);
+    }
+
+    void testInvalidHuffman() const
+    {
+        // padding longer than 7 bits
+        QVERIFY(!decodeHuffman(QByteArray::fromHex("f1e3c2e5f23a6ba0ab90f4ffff")));
+        // padding which isn't made of the most significant bits of EOS
+        QVERIFY(!decodeHuffman(QByteArray::fromHex("f1e3c2e5f23a6ba0ab90f4fe")));
+    }
+
+    void testDecode() const
+    {
+        // [rfc7541] C.4. Request Examples with Huffman Coding
+        Decoder decoder {64 * 1024};
+
+        const HeaderList first {{":method"_ba, "GET"_ba}, {":scheme"_ba, "http"_ba}, {":path"_ba, "/"_ba}
+            , {":authority"_ba, "www.example.com"_ba}};
+        QCOMPARE(decoder.decode(QByteArray::fromHex("828684418cf1e3c2e5f23a6ba0ab90f4ff")), first);
+
+        HeaderList second = first;
+        second.append({"cache-control"_ba, "no-cache"_ba});
+        QCOMPARE(decoder.decode(QByteArray::fromHex("828684be5886a8eb10649cbf")), second);
+
+        const HeaderList third {{":method"_ba, "GET"_ba}, {":scheme"_ba, "https"_ba}, {":path"_ba, "/index.html"_ba}
+            , {":authority"_ba, "www.example.com"_ba}, {"custom-key"_ba, "custom-value"_ba}};
+        QCOMPARE(decoder.decode(QByteArray::fromHex("828785bf408825a849e95ba97d7f8925a849e95bb8e8b4bf")), third);
+    }
+
+    void testDecodeInvalid() const
+    {
+        // index of the empty dynamic table
+        QVERIFY(!Decoder(64 * 1024).decode(QByteArray::fromHex("be")));
+        // index 0
+        QVERIFY(!Decoder(64 * 1024).decode(QByteArray::fromHex("80")));
+        // truncated string
+        QVERIFY(!Decoder(64 * 1024).decode(QByteArray::fromHex("418cf1e3c2")));
+        // table size update above the limit
+        QVERIFY(!Decoder(64 * 1024).decode(QByteArray::fromHex("3fe21f")));
+        // header list exceeding the limit
+        QVERIFY(!Decoder(16).decode(QByteArray::fromHex("828684418cf1e3c2e5f23a6ba0ab90f4ff")));
+    }
+
+    void testEncode() const
+    {
+        Encoder encoder;
+        Decoder decoder {64 * 1024};
+
+        const HeaderList headers {{":status"_ba, "200"_ba}, {"content-type"_ba, "application/json"_ba}
+            , {"set-cookie"_ba, "SID=secret"_ba}, {"x-custom"_ba, "value"_ba}};
+        const QByteArray first = encoder.encode(headers);
+        QCOMPARE(decoder.decode(first), headers);
+
+        // the indexed fields are referenced in the next block
+        const QByteArray second = encoder.encode(headers);
+        QVERIFY(second.size() < first.size());
+        QCOMPARE(decoder.decode(second), headers);
+    }
+
+    void testEncodeTableSizeUpdate() const
+    {
+        Encoder encoder;
+        encoder.setMaxTableSize(0);
+
+        const HeaderList headers {{":status"_ba, "200"_ba}};
+        QCOMPARE(encoder.encode(headers), QByteArray::fromHex("2088"));
+        QCOMPARE(encoder.encode(headers), QByteArray::fromHex("88"));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestHttpHPack)
+#include "testhttphpack.moc"
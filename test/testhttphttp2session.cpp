@@ -0,0 +1,539 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <memory>
+#include <utility>
+
+#include <QtEndian>
+#include <QBuffer>
+#include <QByteArray>
+#include <QHostAddress>
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/hpack.h"
+#include "base/http/http2session.h"
+#include "base/http/requestparser.h"
+#include "base/http/types.h"
+
+namespace
+{
+    // [rfc9113] 6. Frame Definitions
+    namespace FrameType
+    {
+        const quint8 Data = 0x0;
+        const quint8 Headers = 0x1;
+        const quint8 ResetStream = 0x3;
+        const quint8 Settings = 0x4;
+        const quint8 Ping = 0x6;
+        const quint8 GoAway = 0x7;
+        const quint8 WindowUpdate = 0x8;
+        const quint8 Continuation = 0x9;
+    }
+
+    namespace FrameFlag
+    {
+        const quint8 EndStream = 0x1;
+        const quint8 Ack = 0x1;
+        const quint8 EndHeaders = 0x4;
+    }
+
+    // [rfc9113] 7. Error Codes
+    namespace ErrorCode
+    {
+        const quint32 NoError = 0x0;
+        const quint32 ProtocolError = 0x1;
+        const quint32 FlowControlError = 0x3;
+        const quint32 FrameSizeError = 0x6;
+    }
+
+    const quint16 SETTING_INITIAL_WINDOW_SIZE = 0x4;
+    const qsizetype MAX_FRAME_SIZE = 16'384;
+
+    struct Frame
+    {
+        quint8 type = 0;
+        quint8 flags = 0;
+        quint32 streamID = 0;
+        QByteArray payload;
+    };
+
+    QByteArray toBigEndian(const quint32 value)
+    {
+        char buffer[sizeof(value)];
+        qToBigEndian(value, buffer);
+        return QByteArray(buffer, sizeof(buffer));
+    }
+
+    quint32 readUInt32(const QByteArrayView data)
+    {
+        return qFromBigEndian<quint32>(data.data());
+    }
+
+    QByteArray serializeFrame(const quint8 type, const quint8 flags, const quint32 streamID, const QByteArrayView payload = {})
+    {
+        const auto length = static_cast<quint32>(payload.size());
+
+        QByteArray frame;
+        frame.append(static_cast<char>(length >> 16))
+            .append(static_cast<char>(length >> 8))
+            .append(static_cast<char>(length))
+            .append(static_cast<char>(type))
+            .append(static_cast<char>(flags));
+        frame.append(toBigEndian(streamID));
+        frame.append(payload);
+        return frame;
+    }
+
+    QByteArray serializeSetting(const quint16 id, const quint32 value)
+    {
+        char buffer[sizeof(id)];
+        qToBigEndian(id, buffer);
+        return QByteArray(buffer, sizeof(buffer)) + toBigEndian(value);
+    }
+
+    QByteArray headerValue(const Http::HPack::HeaderList &fields, const QByteArray &name)
+    {
+        for (const Http::HPack::HeaderField &field : fields)
+        {
+            if (field.name == name)
+                return field.value;
+        }
+        return {};
+    }
+
+    // Plays the client side of the session, the frames written by the session are collected from the buffer
+    class Client
+    {
+        Q_DISABLE_COPY_MOVE(Client)
+
+    public:
+        Client()
+            : m_decoder {64 * 1024}
+        {
+            m_socket.open(QIODevice::ReadWrite);
+            m_session = std::make_unique<Http::Http2Session>(&m_socket, QHostAddress(QHostAddress::LocalHost)
+                , [this](const quint32 streamID, const Http::Request &request) { m_requests.append({streamID, request}); });
+        }
+
+        // Sends the connection preface and discards the frames sent by the session so far
+        void connect(const QByteArray &settings = {})
+        {
+            send(Http::Http2Session::CONNECTION_PREFACE + serializeFrame(FrameType::Settings, 0, 0, settings));
+            takeFrames();
+        }
+
+        void send(const QByteArrayView data)
+        {
+            m_session->processData(data);
+        }
+
+        void sendHeaders(const quint32 streamID, const Http::HPack::HeaderList &fields, const quint8 flags)
+        {
+            send(serializeFrame(FrameType::Headers, (flags | FrameFlag::EndHeaders), streamID, m_encoder.encode(fields)));
+        }
+
+        QList<Frame> takeFrames()
+        {
+            QList<Frame> frames;
+            const QByteArray &data = m_socket.data();
+            while ((data.size() - m_readPosition) >= 9)
+            {
+                const QByteArrayView header = QByteArrayView(data).sliced(m_readPosition, 9);
+                const qsizetype length = (static_cast<uchar>(header[0]) << 16) | (static_cast<uchar>(header[1]) << 8)
+                    | static_cast<uchar>(header[2]);
+                frames.append({.type = static_cast<quint8>(header[3]), .flags = static_cast<quint8>(header[4])
+                    , .streamID = (readUInt32(header.sliced(5)) & 0x7FFF'FFFF), .payload = data.sliced((m_readPosition + 9), length)});
+                m_readPosition += 9 + length;
+            }
+            return frames;
+        }
+
+        Http::HPack::HeaderList decodeHeaders(const Frame &frame)
+        {
+            return m_decoder.decode(frame.payload).value_or(Http::HPack::HeaderList());
+        }
+
+        Http::Http2Session *session() const
+        {
+            return m_session.get();
+        }
+
+        bool isSocketOpen() const
+        {
+            return m_socket.isOpen();
+        }
+
+        const QList<std::pair<quint32, Http::Request>> &requests() const
+        {
+            return m_requests;
+        }
+
+    private:
+        QBuffer m_socket;
+        std::unique_ptr<Http::Http2Session> m_session;
+        Http::HPack::Encoder m_encoder;
+        Http::HPack::Decoder m_decoder;
+        qsizetype m_readPosition = 0;
+        QList<std::pair<quint32, Http::Request>> m_requests;
+    };
+
+    const Http::HPack::HeaderList GET_REQUEST {{":method"_ba, "GET"_ba}, {":scheme"_ba, "http"_ba}
+        , {":path"_ba, "/api/v2/app/version"_ba}, {":authority"_ba, "localhost"_ba}};
+    const Http::HPack::HeaderList POST_REQUEST {{":method"_ba, "POST"_ba}, {":scheme"_ba, "http"_ba}
+        , {":path"_ba, "/api/v2/torrents/add"_ba}, {":authority"_ba, "localhost"_ba}
+        , {"content-type"_ba, "application/x-www-form-urlencoded"_ba}};
+}
+
+class TestHttpHttp2Session final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestHttpHttp2Session)
+
+public:
+    TestHttpHttp2Session() = default;
+
+private slots:
+    void testConnectionPreface() const
+    {
+        Client client;
+
+        // [rfc9113] 3.4. the server preface is sent at once, along with the window of the connection
+        const QList<Frame> serverPreface = client.takeFrames();
+        QCOMPARE(serverPreface.size(), 2);
+        QCOMPARE(serverPreface[0].type, FrameType::Settings);
+        QCOMPARE(serverPreface[0].flags, 0);
+        QCOMPARE(serverPreface[0].streamID, 0u);
+        QCOMPARE(serverPreface[1].type, FrameType::WindowUpdate);
+        QCOMPARE(serverPreface[1].streamID, 0u);
+        QCOMPARE(readUInt32(serverPreface[1].payload), static_cast<quint32>((1024 * 1024) - 65'535));
+
+        // the preface may be split between the reads
+        const QByteArray clientPreface = Http::Http2Session::CONNECTION_PREFACE + serializeFrame(FrameType::Settings, 0, 0);
+        client.send(clientPreface.first(10));
+        QVERIFY(client.takeFrames().isEmpty());
+        client.send(clientPreface.sliced(10));
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::Settings);
+        QCOMPARE(frames[0].flags, FrameFlag::Ack);
+        QVERIFY(frames[0].payload.isEmpty());
+    }
+
+    void testInvalidPreface() const
+    {
+        Client client;
+        client.takeFrames();
+
+        client.send("GET / HTTP/1.1\r\nHost: localhost\r\n\r\n");
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::GoAway);
+        QCOMPARE(readUInt32(frames[0].payload.sliced(4)), ErrorCode::ProtocolError);
+        QVERIFY(!client.isSocketOpen());
+    }
+
+    void testFrameBeforeSettings() const
+    {
+        Client client;
+        client.takeFrames();
+
+        client.send(Http::Http2Session::CONNECTION_PREFACE + serializeFrame(FrameType::Ping, 0, 0, QByteArray(8, '\0')));
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::GoAway);
+        QCOMPARE(readUInt32(frames[0].payload.sliced(4)), ErrorCode::ProtocolError);
+    }
+
+    void testOversizedFrame() const
+    {
+        Client client;
+        client.connect();
+
+        client.send(serializeFrame(FrameType::Data, 0, 1, QByteArray((MAX_FRAME_SIZE + 1), 'a')));
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::GoAway);
+        QCOMPARE(readUInt32(frames[0].payload.sliced(4)), ErrorCode::FrameSizeError);
+        QVERIFY(!client.isSocketOpen());
+    }
+
+    void testDataOnConnectionStream() const
+    {
+        Client client;
+        client.connect();
+
+        client.send(serializeFrame(FrameType::Data, 0, 0, "a=1"));
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::GoAway);
+        QCOMPARE(readUInt32(frames[0].payload.sliced(4)), ErrorCode::ProtocolError);
+    }
+
+    void testPing() const
+    {
+        Client client;
+        client.connect();
+
+        const QByteArray opaqueData = "12345678";
+        client.send(serializeFrame(FrameType::Ping, 0, 0, opaqueData));
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::Ping);
+        QCOMPARE(frames[0].flags, FrameFlag::Ack);
+        QCOMPARE(frames[0].payload, opaqueData);
+    }
+
+    void testContinuation() const
+    {
+        Client client;
+        client.connect();
+
+        Http::HPack::Encoder encoder;
+        const QByteArray block = encoder.encode(GET_REQUEST);
+        client.send(serializeFrame(FrameType::Headers, FrameFlag::EndStream, 1, QByteArrayView(block).first(5)));
+        QVERIFY(client.requests().isEmpty());
+        client.send(serializeFrame(FrameType::Continuation, FrameFlag::EndHeaders, 1, QByteArrayView(block).sliced(5)));
+
+        QCOMPARE(client.requests().size(), 1);
+        QCOMPARE(client.requests()[0].first, 1u);
+        QCOMPARE(client.requests()[0].second.method, u"GET"_s);
+        QCOMPARE(client.requests()[0].second.path, u"/api/v2/app/version"_s);
+        QCOMPARE(client.requests()[0].second.version, u"2"_s);
+    }
+
+    void testInterruptedHeaderBlock() const
+    {
+        Client client;
+        client.connect();
+
+        Http::HPack::Encoder encoder;
+        const QByteArray block = encoder.encode(GET_REQUEST);
+        client.send(serializeFrame(FrameType::Headers, FrameFlag::EndStream, 1, QByteArrayView(block).first(5)));
+        client.send(serializeFrame(FrameType::Ping, 0, 0, QByteArray(8, '\0')));
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::GoAway);
+        QCOMPARE(readUInt32(frames[0].payload.sliced(4)), ErrorCode::ProtocolError);
+        QVERIFY(client.requests().isEmpty());
+    }
+
+    void testRequest() const
+    {
+        Client client;
+        client.connect();
+
+        client.sendHeaders(1, POST_REQUEST, 0);
+        QVERIFY(client.takeFrames().isEmpty());
+
+        // the received data is acknowledged for both the connection and the stream,
+        // except the last frame since the stream is closed by it
+        client.send(serializeFrame(FrameType::Data, 0, 1, "a=1&"));
+        QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 2);
+        QCOMPARE(frames[0].type, FrameType::WindowUpdate);
+        QCOMPARE(frames[0].streamID, 0u);
+        QCOMPARE(readUInt32(frames[0].payload), 4u);
+        QCOMPARE(frames[1].type, FrameType::WindowUpdate);
+        QCOMPARE(frames[1].streamID, 1u);
+        QCOMPARE(readUInt32(frames[1].payload), 4u);
+        QVERIFY(client.requests().isEmpty());
+
+        client.send(serializeFrame(FrameType::Data, FrameFlag::EndStream, 1, "b=2"));
+        frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::WindowUpdate);
+        QCOMPARE(frames[0].streamID, 0u);
+        QCOMPARE(readUInt32(frames[0].payload), 3u);
+
+        QCOMPARE(client.requests().size(), 1);
+        const Http::Request &request = client.requests()[0].second;
+        QCOMPARE(request.method, u"POST"_s);
+        QCOMPARE(request.posts.value(u"a"_s), u"1"_s);
+        QCOMPARE(request.posts.value(u"b"_s), u"2"_s);
+
+        Http::Response response;
+        response.content = "Ok.";
+        client.session()->processResponse(1, response);
+
+        frames = client.takeFrames();
+        QCOMPARE(frames.size(), 2);
+        QCOMPARE(frames[0].type, FrameType::Headers);
+        QCOMPARE(frames[0].streamID, 1u);
+        QVERIFY(frames[0].flags & FrameFlag::EndHeaders);
+        QVERIFY(!(frames[0].flags & FrameFlag::EndStream));
+        const Http::HPack::HeaderList fields = client.decodeHeaders(frames[0]);
+        QCOMPARE(headerValue(fields, ":status"_ba), "200"_ba);
+        QCOMPARE(headerValue(fields, "content-length"_ba), "3"_ba);
+        QCOMPARE(frames[1].type, FrameType::Data);
+        QCOMPARE(frames[1].flags, FrameFlag::EndStream);
+        QCOMPARE(frames[1].payload, "Ok."_ba);
+        QVERIFY(client.session()->isIdle());
+    }
+
+    void testResponseFrameSize() const
+    {
+        Client client;
+        client.connect();
+
+        client.sendHeaders(1, GET_REQUEST, FrameFlag::EndStream);
+        client.takeFrames();
+
+        Http::Response response;
+        response.headers[Http::HEADER_CONTENT_ENCODING] = u"identity"_s;
+        response.content = QByteArray(40'000, 'a');
+        client.session()->processResponse(1, response);
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 4);
+        QCOMPARE(frames[0].type, FrameType::Headers);
+        QCOMPARE(frames[1].payload.size(), MAX_FRAME_SIZE);
+        QCOMPARE(frames[1].flags, 0);
+        QCOMPARE(frames[2].payload.size(), MAX_FRAME_SIZE);
+        QCOMPARE(frames[2].flags, 0);
+        QCOMPARE(frames[3].payload.size(), (40'000 - (2 * MAX_FRAME_SIZE)));
+        QCOMPARE(frames[3].flags, FrameFlag::EndStream);
+    }
+
+    void testResponseFlowControl() const
+    {
+        Client client;
+        client.connect(serializeSetting(SETTING_INITIAL_WINDOW_SIZE, 10));
+
+        client.sendHeaders(1, GET_REQUEST, FrameFlag::EndStream);
+        client.takeFrames();
+
+        Http::Response response;
+        response.headers[Http::HEADER_CONTENT_ENCODING] = u"identity"_s;
+        response.content = QByteArray(100, 'a');
+        client.session()->processResponse(1, response);
+
+        // the data exceeding the window of the stream waits for the window update
+        QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 2);
+        QCOMPARE(frames[0].type, FrameType::Headers);
+        QCOMPARE(frames[1].type, FrameType::Data);
+        QCOMPARE(frames[1].payload.size(), 10);
+        QCOMPARE(frames[1].flags, 0);
+        QVERIFY(!client.session()->isIdle());
+
+        client.send(serializeFrame(FrameType::WindowUpdate, 0, 1, toBigEndian(90)));
+        frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::Data);
+        QCOMPARE(frames[0].payload.size(), 90);
+        QCOMPARE(frames[0].flags, FrameFlag::EndStream);
+        QVERIFY(client.session()->isIdle());
+    }
+
+    void testConnectionWindowOverflow() const
+    {
+        Client client;
+        client.connect();
+
+        client.send(serializeFrame(FrameType::WindowUpdate, 0, 0, toBigEndian(0x7FFF'FFFF)));
+
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::GoAway);
+        QCOMPARE(readUInt32(frames[0].payload.sliced(4)), ErrorCode::FlowControlError);
+    }
+
+    void testStreamWindowOverflow() const
+    {
+        Client client;
+        client.connect();
+
+        client.sendHeaders(1, GET_REQUEST, FrameFlag::EndStream);
+        client.send(serializeFrame(FrameType::WindowUpdate, 0, 1, toBigEndian(0x7FFF'FFFF)));
+
+        // only the stream is closed
+        const QList<Frame> frames = client.takeFrames();
+        QCOMPARE(frames.size(), 1);
+        QCOMPARE(frames[0].type, FrameType::ResetStream);
+        QCOMPARE(frames[0].streamID, 1u);
+        QCOMPARE(readUInt32(frames[0].payload), ErrorCode::FlowControlError);
+        QVERIFY(client.session()->isIdle());
+        QVERIFY(client.isSocketOpen());
+    }
+
+    void testBufferedBodyLimit() const
+    {
+        Client client;
+        client.connect();
+
+        const auto sendBody = [&client](const quint32 streamID, const qint64 size)
+        {
+            const QByteArray chunk(MAX_FRAME_SIZE, 'a');
+            client.send(serializeFrame(FrameType::Data, 0, streamID, "a="));
+            for (qint64 sent = 0; sent < size; sent += chunk.size())
+                client.send(serializeFrame(FrameType::Data, 0, streamID, chunk));
+        };
+
+        // each request fits the limit, but they don't fit it together
+        const qint64 bodySize = (Http::RequestParser::MAX_CONTENT_SIZE / 2) + (1024 * 1024);
+        client.sendHeaders(1, POST_REQUEST, 0);
+        sendBody(1, bodySize);
+        client.sendHeaders(3, POST_REQUEST, 0);
+        client.takeFrames();
+        sendBody(3, bodySize);
+
+        const QList<Frame> frames = client.takeFrames();
+        QList<Frame> rejection;
+        for (const Frame &frame : frames)
+        {
+            if (frame.type != FrameType::WindowUpdate)
+                rejection.append(frame);
+        }
+        QCOMPARE(rejection.size(), 2);
+        QCOMPARE(rejection[0].type, FrameType::Headers);
+        QCOMPARE(rejection[0].streamID, 3u);
+        QCOMPARE(headerValue(client.decodeHeaders(rejection[0]), ":status"_ba), "413"_ba);
+        QCOMPARE(rejection[1].type, FrameType::ResetStream);
+        QCOMPARE(rejection[1].streamID, 3u);
+        QCOMPARE(readUInt32(rejection[1].payload), ErrorCode::NoError);
+
+        // the memory of the rejected request is released, so the other one can be finished
+        client.send(serializeFrame(FrameType::Data, FrameFlag::EndStream, 1));
+        QCOMPARE(client.requests().size(), 1);
+        QCOMPARE(client.requests()[0].first, 1u);
+        QVERIFY(client.requests()[0].second.posts.value(u"a"_s).size() >= bodySize);
+    }
+};
+
+QTEST_GUILESS_MAIN(TestHttpHttp2Session)
+#include "testhttphttp2session.moc"
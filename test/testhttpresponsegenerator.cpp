@@ -0,0 +1,90 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <optional>
+
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/http/responsegenerator.h"
+
+using Http::ByteRange;
+
+class TestHttpResponseGenerator final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestHttpResponseGenerator)
+
+public:
+    TestHttpResponseGenerator() = default;
+
+private slots:
+    void testParseByteRange() const
+    {
+        QVERIFY(Http::parseByteRange(u"bytes=0-499", 1000) == (ByteRange {.first = 0, .last = 499}));
+        QVERIFY(Http::parseByteRange(u"bytes=500-", 1000) == (ByteRange {.first = 500, .last = 999}));
+        QVERIFY(Http::parseByteRange(u"bytes=-300", 1000) == (ByteRange {.first = 700, .last = 999}));
+        QVERIFY(Http::parseByteRange(u" Bytes = 10 - 20 ", 1000) == (ByteRange {.first = 10, .last = 20}));
+
+        // ranges exceeding the content are truncated
+        QVERIFY(Http::parseByteRange(u"bytes=900-1999", 1000) == (ByteRange {.first = 900, .last = 999}));
+        QVERIFY(Http::parseByteRange(u"bytes=-2000", 1000) == (ByteRange {.first = 0, .last = 999}));
+    }
+
+    void testParseInvalidByteRange() const
+    {
+        QVERIFY(!Http::parseByteRange(u"", 1000));
+        QVERIFY(!Http::parseByteRange(u"items=0-1", 1000));
+        QVERIFY(!Http::parseByteRange(u"bytes=abc", 1000));
+        QVERIFY(!Http::parseByteRange(u"bytes=20-10", 1000));
+        QVERIFY(!Http::parseByteRange(u"bytes=-0", 1000));
+        QVERIFY(!Http::parseByteRange(u"bytes=1000-", 1000));
+        QVERIFY(!Http::parseByteRange(u"bytes=0-0", 0));
+        // multiple ranges aren't supported
+        QVERIFY(!Http::parseByteRange(u"bytes=0-1,5-6", 1000));
+    }
+
+    void testMediaTypeQuality() const
+    {
+        QCOMPARE(Http::mediaTypeQuality(u"application/cbor", u"application/cbor"), 1.0);
+        QCOMPARE(Http::mediaTypeQuality(u"application/json, Application/CBOR", u"application/cbor"), 1.0);
+        QCOMPARE(Http::mediaTypeQuality(u"application/json;q=0.9, application/cbor ; q=0.5", u"application/json"), 0.9);
+        QCOMPARE(Http::mediaTypeQuality(u"application/json;q=0.9, application/cbor ; q=0.5", u"application/cbor"), 0.5);
+        QCOMPARE(Http::mediaTypeQuality(u"application/cbor;level=1;q=0.2", u"application/cbor"), 0.2);
+
+        QCOMPARE(Http::mediaTypeQuality(u"", u"application/cbor"), 0.0);
+        QCOMPARE(Http::mediaTypeQuality(u"*/*", u"application/cbor"), 0.0);
+        QCOMPARE(Http::mediaTypeQuality(u"application/cbor-seq", u"application/cbor"), 0.0);
+        QCOMPARE(Http::mediaTypeQuality(u"application/cbor;q=0", u"application/cbor"), 0.0);
+        QCOMPARE(Http::mediaTypeQuality(u"application/cbor;q=abc", u"application/cbor"), 0.0);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestHttpResponseGenerator)
+#include "testhttpresponsegenerator.moc"
@@ -0,0 +1,118 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QString>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/logger.h"
+
+class TestLogger final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestLogger)
+
+public:
+    TestLogger() = default;
+
+private slots:
+    void init() const
+    {
+        Logger::initInstance();
+    }
+
+    void cleanup() const
+    {
+        Logger::freeInstance();
+    }
+
+    void testDefaultMessageTypes() const
+    {
+        for (int i = 0; i < Log::CATEGORY_COUNT; ++i)
+        {
+            const auto category = static_cast<Log::Category>(i);
+            QCOMPARE(Logger::instance()->messageTypes(category).toInt(), Log::MsgTypes(Log::ALL).toInt());
+            QVERIFY(Logger::instance()->isEnabled(category, Log::NORMAL));
+            QVERIFY(Logger::instance()->isEnabled(category, Log::CRITICAL));
+        }
+    }
+
+    void testSetMessageTypes() const
+    {
+        Logger *logger = Logger::instance();
+        logger->setMessageTypes(Log::Category::Peers, (Log::WARNING | Log::CRITICAL));
+
+        QCOMPARE(logger->messageTypes(Log::Category::Peers).toInt(), (Log::WARNING | Log::CRITICAL).toInt());
+        QVERIFY(!logger->isEnabled(Log::Category::Peers, Log::NORMAL));
+        QVERIFY(!logger->isEnabled(Log::Category::Peers, Log::INFO));
+        QVERIFY(logger->isEnabled(Log::Category::Peers, Log::WARNING));
+        // the other categories aren't affected
+        QVERIFY(logger->isEnabled(Log::Category::Trackers, Log::NORMAL));
+    }
+
+    void testLazyFormatting() const
+    {
+        Logger *logger = Logger::instance();
+        logger->setMessageTypes(Log::Category::Performance, Log::MsgTypes(Log::CRITICAL));
+
+        int formatCount = 0;
+        const auto formatter = [&formatCount]
+        {
+            ++formatCount;
+            return u"message"_s;
+        };
+
+        LogMsg(Log::Category::Performance, Log::INFO, formatter);
+        QCOMPARE(formatCount, 0);
+        QVERIFY(logger->getMessages().isEmpty());
+
+        LogMsg(Log::Category::Performance, Log::CRITICAL, formatter);
+        QCOMPARE(formatCount, 1);
+        const QList<Log::Msg> messages = logger->getMessages();
+        QCOMPARE(messages.size(), 1);
+        QCOMPARE(messages[0].message, u"message"_s);
+        QCOMPARE(messages[0].type, Log::CRITICAL);
+    }
+
+    void testGeneralCategory() const
+    {
+        Logger *logger = Logger::instance();
+        logger->setMessageTypes(Log::Category::General, Log::MsgTypes(Log::WARNING));
+
+        LogMsg(u"normal"_s);
+        LogMsg(u"warning"_s, Log::WARNING);
+
+        const QList<Log::Msg> messages = logger->getMessages();
+        QCOMPARE(messages.size(), 1);
+        QCOMPARE(messages[0].message, u"warning"_s);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestLogger)
+#include "testlogger.moc"
@@ -0,0 +1,95 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <chrono>
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QHash>
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/net/faviconcache.h"
+
+using namespace std::chrono_literals;
+
+class TestNetFaviconCache final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestNetFaviconCache)
+
+public:
+    TestNetFaviconCache() = default;
+
+private slots:
+    void testFaviconHost() const
+    {
+        QCOMPARE(Net::FaviconCache::faviconHost(u"tracker.example.org"_s), u"example.org"_s);
+        QCOMPARE(Net::FaviconCache::faviconHost(u"a.b.example.org"_s), u"example.org"_s);
+        QCOMPARE(Net::FaviconCache::faviconHost(u"example.org"_s), u"example.org"_s);
+        QCOMPARE(Net::FaviconCache::faviconHost(u"192.168.1.10"_s), u"192.168.1.10"_s);
+        QCOMPARE(Net::FaviconCache::faviconHost(u"2001:db8::1"_s), u"2001:db8::1"_s);
+    }
+
+    void testImageMimeType() const
+    {
+        QCOMPARE(Net::FaviconCache::imageMimeType(QByteArray("\x00\x00\x01\x00\x01\x00", 6)), u"image/x-icon"_s);
+        QCOMPARE(Net::FaviconCache::imageMimeType("\x89PNG\r\n\x1A\n\x00\x00"_ba), u"image/png"_s);
+        QCOMPARE(Net::FaviconCache::imageMimeType("GIF89a\x01\x00"_ba), u"image/gif"_s);
+        QCOMPARE(Net::FaviconCache::imageMimeType("\xFF\xD8\xFF\xE0"_ba), u"image/jpeg"_s);
+        QCOMPARE(Net::FaviconCache::imageMimeType("BM\x3A\x00"_ba), u"image/bmp"_s);
+        QCOMPARE(Net::FaviconCache::imageMimeType("RIFF\x24\x00\x00\x00WEBPVP8 "_ba), u"image/webp"_s);
+
+        QVERIFY(Net::FaviconCache::imageMimeType({}).isEmpty());
+        QVERIFY(Net::FaviconCache::imageMimeType("RIFF\x24\x00"_ba).isEmpty());
+        QVERIFY(Net::FaviconCache::imageMimeType("<!DOCTYPE html><html></html>"_ba).isEmpty());
+    }
+
+    void testLifetime() const
+    {
+        const QDateTime now = QDateTime::fromString(u"2024-05-01T12:00:00Z"_s, Qt::ISODate);
+
+        // default
+        QCOMPARE(Net::FaviconCache::lifetime({}, now), std::chrono::seconds(7 * 24h));
+        // max-age is preferred over Expires
+        QCOMPARE(Net::FaviconCache::lifetime({{"cache-control", "public, max-age=172800"}
+                , {"expires", "Thu, 02 May 2024 12:00:00 GMT"}}, now), std::chrono::seconds(48h));
+        QCOMPARE(Net::FaviconCache::lifetime({{"expires", "Sat, 04 May 2024 12:00:00 GMT"}}, now), std::chrono::seconds(72h));
+        // it is clamped
+        QCOMPARE(Net::FaviconCache::lifetime({{"cache-control", "max-age=60"}}, now), std::chrono::seconds(24h));
+        QCOMPARE(Net::FaviconCache::lifetime({{"cache-control", "no-cache"}}, now), std::chrono::seconds(24h));
+        QCOMPARE(Net::FaviconCache::lifetime({{"expires", "Wed, 01 May 2024 11:00:00 GMT"}}, now), std::chrono::seconds(24h));
+        QCOMPARE(Net::FaviconCache::lifetime({{"cache-control", "max-age=31536000"}}, now), std::chrono::seconds(30 * 24h));
+        // invalid values are ignored
+        QCOMPARE(Net::FaviconCache::lifetime({{"cache-control", "max-age=abc"}, {"expires", "0"}}, now), std::chrono::seconds(7 * 24h));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestNetFaviconCache)
+#include "testnetfaviconcache.moc"
@@ -0,0 +1,108 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QStringList>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/rss/rss_episodehistory.h"
+
+using RSS::EpisodeHistory;
+
+class TestRSSEpisodeHistory final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestRSSEpisodeHistory)
+
+public:
+    TestRSSEpisodeHistory() = default;
+
+private slots:
+    void testContains() const
+    {
+        EpisodeHistory history;
+        QVERIFY(history.isEmpty());
+
+        history.insert(u"01x05"_s);
+        history.insert(u"2017.01.01"_s);
+        history.insert(u"01x06-REPACK"_s);
+        QVERIFY(!history.isEmpty());
+
+        QVERIFY(history.contains(u"01x05"_s));
+        QVERIFY(history.contains(u"1x5"_s));
+        QVERIFY(history.contains(u"2017.01.01"_s));
+        QVERIFY(history.contains(u"01x06-REPACK"_s));
+
+        QVERIFY(!history.contains(u"01x06"_s));
+        QVERIFY(!history.contains(u"02x05"_s));
+        QVERIFY(!history.contains(u"01x05-PROPER"_s));
+
+        history.clear();
+        QVERIFY(history.isEmpty());
+        QVERIFY(!history.contains(u"01x05"_s));
+    }
+
+    void testToStringList() const
+    {
+        EpisodeHistory history;
+        for (int episode = 1; episode <= 24; ++episode)
+            history.insert(u"01x%1"_s.arg(episode, 2, 10, u'0'));
+        history.insert(u"02x03"_s);
+        history.insert(u"02x01"_s);
+        history.insert(u"02x02"_s);
+        history.insert(u"02x07"_s);
+        history.insert(u"01x10-PROPER"_s);
+
+        QStringList expected;
+        for (int episode = 1; episode <= 24; ++episode)
+            expected.append(u"01x%1"_s.arg(episode, 2, 10, u'0'));
+        expected.append({u"02x01"_s, u"02x02"_s, u"02x03"_s, u"02x07"_s, u"01x10-PROPER"_s});
+        QCOMPARE(history.toStringList(), expected);
+    }
+
+    void testLoad() const
+    {
+        const EpisodeHistory history {QStringList {u"01x02"_s, u"01x01"_s, u"3x8"_s, u"2017.01.01"_s, u"01x01-24"_s}};
+
+        QVERIFY(history.contains(u"01x01"_s));
+        QVERIFY(history.contains(u"01x02"_s));
+        QVERIFY(history.contains(u"03x08"_s));
+        QVERIFY(history.contains(u"2017.01.01"_s));
+
+        // ranges aren't expanded, they are kept as is
+        QVERIFY(!history.contains(u"01x12"_s));
+        QVERIFY(history.contains(u"01x01-24"_s));
+        QCOMPARE(history.toStringList(), (QStringList {u"01x01"_s, u"01x02"_s, u"03x08"_s, u"01x01-24"_s, u"2017.01.01"_s}));
+
+        QCOMPARE(EpisodeHistory(history.toStringList()), history);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestRSSEpisodeHistory)
+#include "testrssepisodehistory.moc"
@@ -0,0 +1,138 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/search/searchresultstore.h"
+
+namespace
+{
+    SearchResult makeResult(const QString &fileUrl, const QString &engineName, const qlonglong nbSeeders
+        , const qlonglong fileSize = 0)
+    {
+        SearchResult result;
+        result.fileName = engineName + u" file";
+        result.fileUrl = fileUrl;
+        result.engineName = engineName;
+        result.nbSeeders = nbSeeders;
+        result.fileSize = fileSize;
+        return result;
+    }
+}
+
+class TestSearchResultStore final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestSearchResultStore)
+
+public:
+    TestSearchResultStore() = default;
+
+private slots:
+    void testDeduplicationKey() const
+    {
+        const QString magnet = u"magnet:?xt=urn:btih:0123456789ABCDEF0123456789ABCDEF01234567&dn=name"_s;
+        QCOMPARE(SearchResultStore::deduplicationKey(makeResult(magnet, u"a"_s, 0))
+            , u"btih:0123456789abcdef0123456789abcdef01234567"_s);
+
+        const QString url = u"https://example.com/file.torrent"_s;
+        QCOMPARE(SearchResultStore::deduplicationKey(makeResult(url, u"a"_s, 0)), url);
+    }
+
+    void testAppend() const
+    {
+        SearchResultStore store;
+
+        const SearchResultStore::Changes changes1 = store.append({
+            makeResult(u"magnet:?xt=urn:btih:aaaa&tr=one"_s, u"a"_s, 5)
+            , makeResult(u"https://example.com/1.torrent"_s, u"a"_s, 3)
+            , makeResult(u"magnet:?xt=urn:btih:AAAA&tr=two"_s, u"b"_s, 7, 1024)
+        });
+        QCOMPARE(changes1.firstAddedIndex, 0);
+        QCOMPARE(changes1.added.size(), 2);
+        QVERIFY(changes1.updated.isEmpty());
+        // duplicate in the same batch is merged into the added result
+        QCOMPARE(changes1.added[0].nbSeeders, 7);
+        QCOMPARE(changes1.added[0].fileSize, 1024);
+        QCOMPARE(changes1.added[0].engineName, u"a"_s);
+
+        const SearchResultStore::Changes changes2 = store.append({
+            makeResult(u"https://example.com/2.torrent"_s, u"b"_s, 1)
+            , makeResult(u"https://example.com/1.torrent"_s, u"c"_s, 10)
+            , makeResult(u"magnet:?xt=urn:btih:aaaa"_s, u"c"_s, 2)
+        });
+        QCOMPARE(changes2.firstAddedIndex, 2);
+        QCOMPARE(changes2.added.size(), 1);
+        QCOMPARE(changes2.updated, QList<qsizetype> {1});
+        QCOMPARE(store.size(), 3);
+        QCOMPARE(store.at(0).nbSeeders, 7);
+        QCOMPARE(store.at(1).nbSeeders, 10);
+
+        store.clear();
+        QVERIFY(store.isEmpty());
+        QCOMPARE(store.append({makeResult(u"https://example.com/1.torrent"_s, u"a"_s, 1)}).added.size(), 1);
+    }
+
+    void testWindow() const
+    {
+        SearchResultStore store;
+        store.append({
+            makeResult(u"https://example.com/1.torrent"_s, u"a"_s, 5, 300)
+            , makeResult(u"https://example.com/2.torrent"_s, u"b"_s, 9, 100)
+            , makeResult(u"https://example.com/3.torrent"_s, u"c"_s, 1, 200)
+        });
+
+        const auto seeds = [](const QList<SearchResult> &results)
+        {
+            QList<qlonglong> values;
+            for (const SearchResult &result : results)
+                values.append(result.nbSeeders);
+            return values;
+        };
+
+        QCOMPARE(seeds(store.window(0, -1)), (QList<qlonglong> {5, 9, 1}));
+        QCOMPARE(seeds(store.window(1, 1)), QList<qlonglong> {9});
+        QCOMPARE(seeds(store.window(2, 10)), QList<qlonglong> {1});
+        QVERIFY(store.window(3, -1).isEmpty());
+
+        QCOMPARE(seeds(store.window(0, -1, SearchResultStore::SortKey::Seeders)), (QList<qlonglong> {1, 5, 9}));
+        QCOMPARE(seeds(store.window(0, 2, SearchResultStore::SortKey::Seeders, Qt::DescendingOrder)), (QList<qlonglong> {9, 5}));
+        QCOMPARE(seeds(store.window(1, -1, SearchResultStore::SortKey::Size)), (QList<qlonglong> {1, 5}));
+
+        // sort indexes are rebuilt once the results are changed
+        store.append({makeResult(u"https://example.com/4.torrent"_s, u"d"_s, 7, 50)});
+        QCOMPARE(seeds(store.window(0, -1, SearchResultStore::SortKey::Seeders)), (QList<qlonglong> {1, 5, 7, 9}));
+        QCOMPARE(seeds(store.window(0, 1, SearchResultStore::SortKey::Size)), QList<qlonglong> {7});
+    }
+};
+
+QTEST_APPLESS_MAIN(TestSearchResultStore)
+#include "testsearchresultstore.moc"
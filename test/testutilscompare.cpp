@@ -190,6 +190,22 @@ private slots:
         for (const TestData &data : testData)
             testLessThan(data, cmp(data.lhs, data.rhs), data.caseSensitiveResult);
     }
+
+    void testNaturalSortKeyCaseInsensitive() const
+    {
+        const Utils::Compare::NaturalCompare<Qt::CaseInsensitive> cmp;
+
+        for (const TestData &data : testData)
+            testCompare(data, cmp.sortKey(data.lhs).compare(cmp.sortKey(data.rhs)), data.caseInsensitiveResult);
+    }
+
+    void testNaturalSortKeyCaseSensitive() const
+    {
+        const Utils::Compare::NaturalCompare<Qt::CaseSensitive> cmp;
+
+        for (const TestData &data : testData)
+            testCompare(data, cmp.sortKey(data.lhs).compare(cmp.sortKey(data.rhs)), data.caseSensitiveResult);
+    }
 };
 
 QTEST_APPLESS_MAIN(TestUtilsCompare)
@@ -26,6 +26,8 @@
  * exception statement from your version.
  */
 
+#include <algorithm>
+
 #include <QObject>
 #include <QTest>
 
@@ -65,6 +67,67 @@ private slots:
         QVERIFY(ok);
         QCOMPARE(decompressedData, data);
     }
+
+    void testDecompressHighRatio() const
+    {
+        // the decompressed data is many times larger than the compressed one
+        const QByteArray data = QByteArray(1024 * 1024, 'a');
+
+        bool ok = false;
+        const QByteArray compressedData = Utils::Gzip::compress(data, 6, &ok);
+        QVERIFY(ok);
+        QCOMPARE_LT(compressedData.size(), (data.size() / 100));
+
+        ok = false;
+        const QByteArray decompressedData = Utils::Gzip::decompress(compressedData, &ok);
+        QVERIFY(ok);
+        QCOMPARE(decompressedData, data);
+    }
+
+    void testStreamCompressor() const
+    {
+        const QByteArray data1 = QByteArrayLiteral("abc").repeated(1000);
+        const QByteArray data2 = QByteArrayLiteral("def").repeated(1000);
+
+        Utils::Gzip::StreamCompressor compressor;
+        QVERIFY(compressor.isValid());
+
+        QByteArray compressedData = compressor.compress(data1);
+        QVERIFY(!compressedData.isEmpty());
+        compressedData += compressor.compress(data2);
+        compressedData += compressor.compress({}, true);
+        QVERIFY(compressor.compress(data1).isEmpty());
+
+        bool ok = false;
+        const QByteArray decompressedData = Utils::Gzip::decompress(compressedData, &ok);
+        QVERIFY(ok);
+        QCOMPARE(decompressedData, (data1 + data2));
+    }
+
+    void testStreamDecompressor() const
+    {
+        const QByteArray data = QByteArrayLiteral("abcdef").repeated(100000);
+        bool ok = false;
+        const QByteArray compressedData = Utils::Gzip::compress(data, 6, &ok);
+        QVERIFY(ok);
+
+        Utils::Gzip::StreamDecompressor decompressor;
+        QVERIFY(decompressor.isValid());
+
+        QByteArray decompressedData;
+        for (qsizetype i = 0; i < compressedData.size(); i += 7)
+        {
+            QVERIFY(!decompressor.isFinished());
+            decompressedData += decompressor.decompress(QByteArrayView(compressedData).sliced(i, std::min<qsizetype>(7, (compressedData.size() - i))));
+        }
+        QVERIFY(decompressor.isValid());
+        QVERIFY(decompressor.isFinished());
+        QCOMPARE(decompressedData, data);
+
+        Utils::Gzip::StreamDecompressor invalidDecompressor;
+        QVERIFY(invalidDecompressor.decompress(data).isEmpty());
+        QVERIFY(!invalidDecompressor.isValid());
+    }
 };
 
 QTEST_APPLESS_MAIN(TestUtilsGzip)
@@ -0,0 +1,147 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <limits>
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QObject>
+#include <QTest>
+#include <QVariant>
+
+#include "base/global.h"
+#include "base/utils/jsonwriter.h"
+
+class TestUtilsJsonWriter final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsJsonWriter)
+
+public:
+    TestUtilsJsonWriter() = default;
+
+private slots:
+    void testEmpty() const
+    {
+        Utils::JsonWriter writer;
+        writer.beginArray().endArray();
+        QCOMPARE(writer.data(), "[]");
+
+        writer.takeData();
+        writer.beginObject().endObject();
+        QCOMPARE(writer.takeData(), "{}");
+        QVERIFY(writer.data().isEmpty());
+    }
+
+    void testNesting() const
+    {
+        Utils::JsonWriter writer;
+        writer.beginObject()
+            .key(u"a"_s).value(1)
+            .key(u"b"_s).beginArray()
+                .value(true)
+                .beginObject().endObject()
+                .beginArray().value(2).value(3).endArray()
+                .nullValue()
+            .endArray()
+            .key(u"c"_s).rawValue("{\"d\":[]}")
+            .endObject();
+        QCOMPARE(writer.data(), R"({"a":1,"b":[true,{},[2,3],null],"c":{"d":[]}})");
+    }
+
+    void testNumbers() const
+    {
+        Utils::JsonWriter writer;
+        writer.beginArray()
+            .value(0)
+            .value(-42)
+            .value(std::numeric_limits<qint64>::max())
+            .value(qsizetype(7))
+            .value(0.5)
+            .value(1.0 / 3)
+            .value(1e20)
+            .value(std::numeric_limits<double>::infinity())
+            .value(std::numeric_limits<double>::quiet_NaN())
+            .endArray();
+
+        const QJsonArray expected {0, -42, std::numeric_limits<qint64>::max(), 7, 0.5, (1.0 / 3), 1e20, QJsonValue::Null, QJsonValue::Null};
+        QCOMPARE(writer.data(), QJsonDocument(expected).toJson(QJsonDocument::Compact));
+    }
+
+    void testStrings() const
+    {
+        const QStringList strings {
+            u""_s,
+            u"plain"_s,
+            u"quote \" and backslash \\"_s,
+            u"slash / isn't escaped"_s,
+            u"\b\f\n\r\t"_s,
+            u"\x01\x1f"_s,
+            u"é中\U0001F600"_s
+        };
+
+        Utils::JsonWriter writer;
+        writer.value(strings);
+        QCOMPARE(writer.data(), QJsonDocument(QJsonArray::fromStringList(strings)).toJson(QJsonDocument::Compact));
+    }
+
+    void testJsonValues() const
+    {
+        const QJsonObject object {
+            {u"z"_s, 1},
+            {u"a"_s, QJsonArray {u"x"_s, 2.5, false, QJsonValue::Null}},
+            {u"m"_s, QJsonObject {{u"key"_s, u"value"_s}, {u"big"_s, std::numeric_limits<qint64>::min()}}}
+        };
+
+        Utils::JsonWriter writer;
+        writer.value(object);
+        QCOMPARE(writer.data(), QJsonDocument(object).toJson(QJsonDocument::Compact));
+    }
+
+    void testVariants() const
+    {
+        const QVariantMap map {
+            {u"int"_s, 5},
+            {u"double"_s, 0.25},
+            {u"bool"_s, true},
+            {u"string"_s, u"str"_s},
+            {u"list"_s, QVariantList {1, u"2"_s, QVariant()}},
+            {u"strings"_s, QStringList {u"a"_s, u"b"_s}},
+            {u"hash"_s, QVariantHash {{u"y"_s, 1}, {u"x"_s, 2}, {u"w"_s, 3}}},
+            {u"map"_s, QVariantMap {{u"k"_s, qint64(1) << 60}}}
+        };
+
+        Utils::JsonWriter writer;
+        writer.value(QVariant(map));
+        QCOMPARE(writer.data(), QJsonDocument(QJsonObject::fromVariantMap(map)).toJson(QJsonDocument::Compact));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsJsonWriter)
+#include "testutilsjsonwriter.moc"
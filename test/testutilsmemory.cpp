@@ -0,0 +1,116 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QByteArray>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QTest>
+#include <QVariant>
+#include <QVariantHash>
+#include <QVariantList>
+#include <QVariantMap>
+
+#include "base/global.h"
+#include "base/utils/memory.h"
+
+class TestUtilsMemory final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsMemory)
+
+public:
+    TestUtilsMemory() = default;
+
+private slots:
+    void testString() const
+    {
+        QCOMPARE(Utils::Memory::estimateHeapSize(QString()), 0);
+        // string literals use static data
+        QCOMPARE(Utils::Memory::estimateHeapSize(u"literal"_s), 0);
+
+        QString str;
+        str.reserve(100);
+        str.append(u"abc");
+        QVERIFY(Utils::Memory::estimateHeapSize(str) >= (100 * static_cast<qint64>(sizeof(QChar))));
+    }
+
+    void testByteArray() const
+    {
+        QCOMPARE(Utils::Memory::estimateHeapSize(QByteArray()), 0);
+        QVERIFY(Utils::Memory::estimateHeapSize(QByteArray(100, 'a')) >= 100);
+    }
+
+    void testVariant() const
+    {
+        const QString str = QString(50, u'a');
+        const qint64 strSize = Utils::Memory::estimateHeapSize(str);
+
+        QCOMPARE(Utils::Memory::estimateHeapSize(QVariant()), 0);
+        QCOMPARE(Utils::Memory::estimateHeapSize(QVariant(42)), 0);
+        QCOMPARE(Utils::Memory::estimateHeapSize(QVariant(str)), strSize);
+
+        QVERIFY(Utils::Memory::estimateHeapSize(QVariant(QStringList {str, str})) > (2 * strSize));
+        QVERIFY(Utils::Memory::estimateHeapSize(QVariant(QVariantList {str, str})) > (2 * strSize));
+
+        const QVariantMap map {{u"key"_s, str}};
+        QVERIFY(Utils::Memory::estimateHeapSize(map) > strSize);
+        QCOMPARE(Utils::Memory::estimateHeapSize(QVariant(map)), Utils::Memory::estimateHeapSize(map));
+
+        const QVariantHash hash {{u"key"_s, str}};
+        QVERIFY(Utils::Memory::estimateHeapSize(hash) > strSize);
+        QCOMPARE(Utils::Memory::estimateHeapSize(QVariant(hash)), Utils::Memory::estimateHeapSize(hash));
+
+        // nested containers are taken into account
+        const QVariantMap nestedMap {{u"map"_s, map}};
+        QVERIFY(Utils::Memory::estimateHeapSize(nestedMap) > Utils::Memory::estimateHeapSize(map));
+    }
+
+    void testJsonValue() const
+    {
+        const QString str = QString(50, u'a');
+        const qint64 strSize = Utils::Memory::estimateHeapSize(str);
+
+        QCOMPARE(Utils::Memory::estimateHeapSize(QJsonValue()), 0);
+        QCOMPARE(Utils::Memory::estimateHeapSize(QJsonValue(42)), 0);
+        QCOMPARE(Utils::Memory::estimateHeapSize(QJsonValue(QJsonArray())), 0);
+        QVERIFY(Utils::Memory::estimateHeapSize(QJsonValue(str)) > 0);
+
+        const QJsonArray array {str, str};
+        QVERIFY(Utils::Memory::estimateHeapSize(QJsonValue(array)) > (2 * strSize));
+
+        const QJsonObject object {{u"key"_s, str}, {u"array"_s, array}};
+        QVERIFY(Utils::Memory::estimateHeapSize(QJsonValue(object)) > Utils::Memory::estimateHeapSize(QJsonValue(array)));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsMemory)
+#include "testutilsmemory.moc"
@@ -0,0 +1,111 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QHostAddress>
+#include <QList>
+#include <QObject>
+#include <QStringList>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/utils/net.h"
+
+namespace
+{
+    QList<Utils::Net::Subnet> parseSubnets(const QStringList &subnetStrings)
+    {
+        QList<Utils::Net::Subnet> subnets;
+        for (const QString &subnetStr : subnetStrings)
+            subnets.append(Utils::Net::parseSubnet(subnetStr).value());
+        return subnets;
+    }
+}
+
+class TestUtilsNet final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsNet)
+
+public:
+    TestUtilsNet() = default;
+
+private slots:
+    void testSubnetMatcherEmpty() const
+    {
+        const Utils::Net::SubnetMatcher matcher;
+        QVERIFY(matcher.isEmpty());
+        QVERIFY(!matcher.contains(QHostAddress(u"127.0.0.1"_s)));
+        QVERIFY(!matcher.contains(QHostAddress(u"::1"_s)));
+    }
+
+    void testSubnetMatcher_data() const
+    {
+        QTest::addColumn<QString>("address");
+
+        QTest::newRow("IPv4 in subnet") << u"192.168.1.20"_s;
+        QTest::newRow("IPv4 out of subnet") << u"192.168.2.20"_s;
+        QTest::newRow("IPv4 single address") << u"10.0.0.7"_s;
+        QTest::newRow("IPv4 next to single address") << u"10.0.0.8"_s;
+        QTest::newRow("IPv4 in nested subnet") << u"172.16.5.1"_s;
+        QTest::newRow("IPv4-mapped IPv6 in subnet") << u"::ffff:192.168.1.30"_s;
+        QTest::newRow("IPv4-mapped IPv6 out of subnet") << u"::ffff:8.8.8.8"_s;
+        QTest::newRow("IPv6 in subnet") << u"fd00::1234"_s;
+        QTest::newRow("IPv6 out of subnet") << u"fe80::1"_s;
+        QTest::newRow("IPv6 loopback") << u"::1"_s;
+        QTest::newRow("IPv4 in IPv4-mapped IPv6 subnet") << u"203.0.113.9"_s;
+        QTest::newRow("IPv4 out of IPv4-mapped IPv6 subnet") << u"203.0.114.9"_s;
+    }
+
+    void testSubnetMatcher() const
+    {
+        QFETCH(QString, address);
+
+        const QList<Utils::Net::Subnet> subnets = parseSubnets({u"192.168.1.0/24"_s, u"10.0.0.7/32"_s
+                , u"172.16.5.0/24"_s, u"172.16.0.0/12"_s, u"fd00::/8"_s, u"::ffff:203.0.113.0/120"_s});
+        const Utils::Net::SubnetMatcher matcher {subnets};
+        QVERIFY(!matcher.isEmpty());
+
+        const QHostAddress addr {address};
+        QCOMPARE(matcher.contains(addr), Utils::Net::isIPInSubnets(addr, subnets));
+    }
+
+    void testSubnetMatcherWholeRange() const
+    {
+        const Utils::Net::SubnetMatcher ipv4Matcher {parseSubnets({u"0.0.0.0/0"_s})};
+        QVERIFY(ipv4Matcher.contains(QHostAddress(u"1.2.3.4"_s)));
+        QVERIFY(ipv4Matcher.contains(QHostAddress(u"::ffff:1.2.3.4"_s)));
+        QVERIFY(!ipv4Matcher.contains(QHostAddress(u"2001:db8::1"_s)));
+
+        const Utils::Net::SubnetMatcher ipv6Matcher {parseSubnets({u"::/0"_s})};
+        QVERIFY(ipv6Matcher.contains(QHostAddress(u"1.2.3.4"_s)));
+        QVERIFY(ipv6Matcher.contains(QHostAddress(u"2001:db8::1"_s)));
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsNet)
+#include "testutilsnet.moc"
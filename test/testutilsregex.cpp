@@ -0,0 +1,80 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QRegularExpression>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/utils/regex.h"
+
+class TestUtilsRegex final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsRegex)
+
+public:
+    TestUtilsRegex() = default;
+
+private slots:
+    void testCached() const
+    {
+        const QRegularExpression regex = Utils::Regex::cached(u"ab+c"_s, QRegularExpression::CaseInsensitiveOption);
+        QVERIFY(regex.isValid());
+        QCOMPARE(regex.pattern(), u"ab+c"_s);
+        QCOMPARE(regex.patternOptions(), QRegularExpression::CaseInsensitiveOption);
+        QVERIFY(regex.match(u"xABBCx"_s).hasMatch());
+
+        QCOMPARE(Utils::Regex::cached(u"ab+c"_s, QRegularExpression::CaseInsensitiveOption), regex);
+
+        const QRegularExpression caseSensitiveRegex = Utils::Regex::cached(u"ab+c"_s);
+        QCOMPARE(caseSensitiveRegex.patternOptions(), QRegularExpression::NoPatternOption);
+        QVERIFY(!caseSensitiveRegex.match(u"xABBCx"_s).hasMatch());
+    }
+
+    void testInvalidPattern() const
+    {
+        const QRegularExpression regex = Utils::Regex::cached(u"(abc"_s);
+        QVERIFY(!regex.isValid());
+        QCOMPARE(regex.pattern(), u"(abc"_s);
+    }
+
+    void testEviction() const
+    {
+        for (int i = 0; i < 5000; ++i)
+        {
+            const QString pattern = u"^item%1$"_s.arg(i);
+            QVERIFY(Utils::Regex::cached(pattern).match(u"item%1"_s.arg(i)).hasMatch());
+        }
+
+        QVERIFY(Utils::Regex::cached(u"^item0$"_s).match(u"item0"_s).hasMatch());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsRegex)
+#include "testutilsregex.moc"
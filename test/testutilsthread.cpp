@@ -0,0 +1,86 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QList>
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/utils/thread.h"
+
+class TestUtilsThread final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsThread)
+
+public:
+    TestUtilsThread() = default;
+
+private slots:
+    void testParseCPUList() const
+    {
+        using Utils::Thread::parseCPUList;
+
+        QCOMPARE(parseCPUList(u""_s), QList<int>());
+        QCOMPARE(parseCPUList(u"   "_s), QList<int>());
+        QCOMPARE(parseCPUList(u"3"_s), QList<int>({3}));
+        QCOMPARE(parseCPUList(u"0-3"_s), QList<int>({0, 1, 2, 3}));
+        QCOMPARE(parseCPUList(u"0-1,6"_s), QList<int>({0, 1, 6}));
+        QCOMPARE(parseCPUList(u" 4 - 5 , 1 "_s), QList<int>({4, 5, 1}));
+        QCOMPARE(parseCPUList(u"1,0-2"_s), QList<int>({1, 0, 2}));
+    }
+
+    void testParseInvalidCPUList() const
+    {
+        using Utils::Thread::parseCPUList;
+
+        QCOMPARE(parseCPUList(u"a"_s), QList<int>());
+        QCOMPARE(parseCPUList(u"1,"_s), QList<int>());
+        QCOMPARE(parseCPUList(u"1-"_s), QList<int>());
+        QCOMPARE(parseCPUList(u"-1"_s), QList<int>());
+        QCOMPARE(parseCPUList(u"3-1"_s), QList<int>());
+        QCOMPARE(parseCPUList(u"0-100000000"_s), QList<int>());
+    }
+
+    void testSchedulingPolicy() const
+    {
+        const Utils::Thread::SchedulingPolicy defaultPolicy = Utils::Thread::schedulingPolicy();
+        QVERIFY(!defaultPolicy.lowerBulkPriority);
+        QVERIFY(defaultPolicy.latencySensitiveCPUs.isEmpty());
+
+        Utils::Thread::setSchedulingPolicy({.lowerBulkPriority = true, .latencySensitiveCPUs = {0}});
+        const Utils::Thread::SchedulingPolicy policy = Utils::Thread::schedulingPolicy();
+        QVERIFY(policy.lowerBulkPriority);
+        QCOMPARE(policy.latencySensitiveCPUs, QList<int>({0}));
+
+        Utils::Thread::setSchedulingPolicy(defaultPolicy);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsThread)
+#include "testutilsthread.moc"
@@ -0,0 +1,103 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <chrono>
+
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/utils/tokenbucket.h"
+
+using namespace std::chrono_literals;
+
+using Utils::TokenBucket;
+
+class TestUtilsTokenBucket final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsTokenBucket)
+
+public:
+    TestUtilsTokenBucket() = default;
+
+private slots:
+    void testConsume() const
+    {
+        const TokenBucket::Clock::time_point start;
+        TokenBucket bucket {10, 5, start};
+        QVERIFY(bucket.isFull(start));
+        QCOMPARE(bucket.waitTime(5, 0, start), 0ms);
+
+        bucket.consume(5, start);
+        QCOMPARE(bucket.availableTokens(start), 0.0);
+        QCOMPARE(bucket.waitTime(1, 0, start), 100ms);
+        QCOMPARE(bucket.waitTime(1, 0, (start + 50ms)), 50ms);
+        QCOMPARE(bucket.waitTime(1, 0, (start + 100ms)), 0ms);
+
+        // the refill is limited by the capacity
+        QCOMPARE(bucket.availableTokens(start + 10s), 5.0);
+        QVERIFY(bucket.isFull(start + 10s));
+    }
+
+    void testReserve() const
+    {
+        const TokenBucket::Clock::time_point start;
+        TokenBucket bucket {1, 10, start};
+
+        QCOMPARE(bucket.waitTime(5, 5, start), 0ms);
+        bucket.consume(5, start);
+        QCOMPARE(bucket.waitTime(1, 5, start), 1000ms);
+        QCOMPARE(bucket.waitTime(1, 0, start), 0ms);
+    }
+
+    void testDebt() const
+    {
+        const TokenBucket::Clock::time_point start;
+        TokenBucket bucket {2, 4, start};
+
+        bucket.consume(6, start);
+        QCOMPARE(bucket.availableTokens(start), -2.0);
+        QCOMPARE(bucket.waitTime(1, 0, start), 1500ms);
+    }
+
+    void testUnreachable() const
+    {
+        const TokenBucket::Clock::time_point start;
+        const TokenBucket bucket {1, 4, start};
+        QCOMPARE(bucket.waitTime(5, 0, start), std::chrono::milliseconds::max());
+        QCOMPARE(bucket.waitTime(3, 2, start), std::chrono::milliseconds::max());
+
+        const TokenBucket stalledBucket {0, 4, start};
+        QCOMPARE(stalledBucket.waitTime(4, 0, start), 0ms);
+        QCOMPARE(stalledBucket.waitTime(4, 1, start), std::chrono::milliseconds::max());
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsTokenBucket)
+#include "testutilstokenbucket.moc"
@@ -0,0 +1,113 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+
+#include <QObject>
+#include <QTest>
+
+#include "base/global.h"
+#include "base/utils/zstd.h"
+
+namespace
+{
+    // [rfc8878] 3.1.1. Zstandard Frames: Magic_Number 0xFD2FB528 in little-endian format
+    const QByteArray FRAME_MAGIC_NUMBER = QByteArrayLiteral("\x28\xB5\x2F\xFD");
+}
+
+class TestUtilsZstd final : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY_MOVE(TestUtilsZstd)
+
+public:
+    TestUtilsZstd() = default;
+
+private slots:
+    void testCompress() const
+    {
+        const QByteArray data = QByteArrayLiteral("abc").repeated(1000);
+
+        bool ok = false;
+        const QByteArray compressedData = Utils::Zstd::compress(data, 3, &ok);
+        QVERIFY(ok);
+        QVERIFY(compressedData.startsWith(FRAME_MAGIC_NUMBER));
+        QCOMPARE_LT(compressedData.size(), data.size());
+    }
+
+    void testCompressEmpty() const
+    {
+        bool ok = true;
+        const QByteArray compressedData = Utils::Zstd::compress({}, 3, &ok);
+        QVERIFY(!ok);
+        QVERIFY(compressedData.isEmpty());
+    }
+
+    void testDecompress() const
+    {
+        const QByteArray data = QByteArrayLiteral("abc").repeated(1000);
+
+        bool ok = false;
+        QCOMPARE(Utils::Zstd::decompress(Utils::Zstd::compress(data, 3), &ok), data);
+        QVERIFY(ok);
+    }
+
+    void testDecompressInvalid() const
+    {
+        const QByteArray compressedData = Utils::Zstd::compress(QByteArrayLiteral("abc").repeated(1000), 3);
+
+        bool ok = true;
+        QVERIFY(Utils::Zstd::decompress(QByteArrayLiteral("abc"), &ok).isEmpty());
+        QVERIFY(!ok);
+
+        ok = true;
+        QVERIFY(Utils::Zstd::decompress(compressedData.chopped(1), &ok).isEmpty());
+        QVERIFY(!ok);
+    }
+
+    void testStreamCompressor() const
+    {
+        const QByteArray data1 = QByteArrayLiteral("abc").repeated(1000);
+        const QByteArray data2 = QByteArrayLiteral("def").repeated(1000);
+
+        Utils::Zstd::StreamCompressor compressor;
+        QVERIFY(compressor.isValid());
+
+        QByteArray compressedData = compressor.compress(data1);
+        QVERIFY(compressedData.startsWith(FRAME_MAGIC_NUMBER));
+        compressedData += compressor.compress(data2);
+        compressedData += compressor.compress({}, true);
+        QVERIFY(compressor.compress(data1).isEmpty());
+        QCOMPARE_LT(compressedData.size(), (data1.size() + data2.size()));
+
+        bool ok = false;
+        QCOMPARE(Utils::Zstd::decompress(compressedData, &ok), (data1 + data2));
+        QVERIFY(ok);
+    }
+};
+
+QTEST_APPLESS_MAIN(TestUtilsZstd)
+#include "testutilszstd.moc"
@@ -0,0 +1,598 @@
+/*
+ * Bittorrent Client using Qt and libtorrent.
+ * Copyright (C) 2026  qBittorrent project
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link this program with the OpenSSL project's "OpenSSL" library (or with
+ * modified versions of it that use the same license as the "OpenSSL" library),
+ * and distribute the linked executables. You must obey the GNU General Public
+ * License in all respects for all of the code used other than "OpenSSL".  If you
+ * modify file(s), you may extend this exception to your version of the file(s),
+ * but you are not obligated to do so. If you do not wish to do so, delete this
+ * exception statement from your version.
+ */
+// Load generator for the WebUI back end.
+//
+// It can generate a synthetic profile to start qbittorrent-nox with and then replays a mix of typical
+// WebAPI client requests against a running instance from many concurrent clients, reporting throughput,
+// latency percentiles and (on Linux) the memory used by the server process.
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <libtorrent/bencode.hpp>
+#include <libtorrent/create_torrent.hpp>
+#include <libtorrent/file_storage.hpp>
+#include <libtorrent/torrent_info.hpp>
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QNetworkAccessManager>
+#include <QNetworkCookie>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QObject>
+#include <QRandomGenerator>
+#include <QStringList>
+#include <QTextStream>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+
+#include "base/bittorrent/bencoderesumedatastorage.h"
+#include "base/bittorrent/infohash.h"
+#include "base/bittorrent/loadtorrentparams.h"
+#include "base/bittorrent/torrentinfo.h"
+#include "base/global.h"
+#include "base/logger.h"
+#include "base/path.h"
+#include "base/preferences.h"
+#include "base/profile.h"
+#include "base/settingsstorage.h"
+#include "base/tag.h"
+#include "base/utils/misc.h"
+
+using namespace std::chrono_literals;
+
+namespace
+{
+    // Shape of the synthetic profile
+    const int FILES_PER_TORRENT = 4;
+    const int TRACKERS_PER_TORRENT = 2;
+    const int TAGS_COUNT = 20;
+    const int CATEGORIES_COUNT = 10;
+    const std::int64_t FILE_SIZE = 16 * 1024 * 1024;
+    const int PIECE_SIZE = 1024 * 1024;
+
+    const int TORRENTS_INFO_PAGE_SIZE = 100;
+    const int BULK_MUTATION_SIZE = 20;
+    const QString BULK_MUTATION_TAG = u"webapiloadgenerator"_s;
+    const int REQUEST_TIMEOUT = 60000; // msecs
+
+    enum class RequestKind
+    {
+        MainData,
+        TorrentsInfo,
+        TorrentPeers,
+        BulkMutation
+    };
+
+    const QList<std::pair<RequestKind, QString>> REQUEST_KINDS {
+        {RequestKind::MainData, u"sync/maindata"_s},
+        {RequestKind::TorrentsInfo, u"torrents/info"_s},
+        {RequestKind::TorrentPeers, u"sync/torrentPeers"_s},
+        {RequestKind::BulkMutation, u"torrents/(add|remove)Tags"_s}
+    };
+
+    struct Options
+    {
+        QUrl url;
+        QString sessionCookie;
+        int clientsCount = 0;
+        std::chrono::milliseconds duration {};
+        std::chrono::milliseconds thinkTime {};
+        QList<int> mix;
+        quint32 seed = 0;
+    };
+
+    struct RequestStatistics
+    {
+        std::vector<qint64> latencies; // in microseconds
+        int errors = 0;
+    };
+
+    // indexed by RequestKind
+    using Statistics = QList<RequestStatistics>;
+
+    void generateProfile(const Path &profilePath, const int torrentsCount)
+    {
+        Logger::initInstance();
+        Profile::initInstance(profilePath, {}, false);
+        SettingsStorage::initInstance();
+        Preferences::initInstance();
+
+        Preferences *pref = Preferences::instance();
+        pref->setWebUIEnabled(true);
+        // the load generator doesn't need to log in when it runs on the same host
+        pref->setWebUILocalAuthEnabled(false);
+
+        const Path savePath = profilePath / Path(u"downloads"_s);
+        {
+            // destroying the storage waits until all the data is written
+            BitTorrent::BencodeResumeDataStorage storage {Profile::instance()->location(SpecialFolder::Data) / Path(u"BT_backup"_s)};
+            QList<BitTorrent::TorrentID> queue;
+            queue.reserve(torrentsCount);
+            for (int i = 0; i < torrentsCount; ++i)
+            {
+                const std::string torrentName = u"Synthetic torrent %1"_s.arg(i).toStdString();
+
+                lt::file_storage files;
+                for (int j = 0; j < FILES_PER_TORRENT; ++j)
+                    files.add_file((torrentName + "/file " + std::to_string(j) + ".bin"), FILE_SIZE);
+
+#ifdef QBT_USES_LIBTORRENT2
+                lt::create_torrent creator {files, PIECE_SIZE, lt::create_torrent::v1_only};
+#else
+                lt::create_torrent creator {files, PIECE_SIZE};
+#endif
+                // make the info hash unique
+                creator.set_comment(torrentName.c_str());
+                for (int j = 0; j < creator.num_pieces(); ++j)
+                    creator.set_hash(lt::piece_index_t {j}, lt::sha1_hash {});
+
+                std::vector<char> buffer;
+                lt::bencode(std::back_inserter(buffer), creator.generate());
+                const auto nativeInfo = std::make_shared<lt::torrent_info>(buffer, lt::from_span);
+
+                BitTorrent::LoadTorrentParams params;
+                params.ltAddTorrentParams.ti = nativeInfo;
+                params.ltAddTorrentParams.save_path = savePath.toString().toStdString();
+                for (int j = 0; j < TRACKERS_PER_TORRENT; ++j)
+                {
+                    params.ltAddTorrentParams.trackers.push_back("http://tracker" + std::to_string(j) + ".example.com/announce");
+                    params.ltAddTorrentParams.tracker_tiers.push_back(j);
+                }
+                params.name = QString::fromStdString(torrentName);
+                params.category = u"category %1"_s.arg(i % CATEGORIES_COUNT);
+                params.tags.insert(Tag(u"tag %1"_s.arg(i % TAGS_COUNT)));
+                params.savePath = savePath;
+                // the torrents must not touch the disk or the network
+                params.stopped = true;
+
+                const auto id = BitTorrent::TorrentID::fromInfoHash(BitTorrent::TorrentInfo(*nativeInfo).infoHash());
+                storage.store(id, params);
+                queue.append(id);
+            }
+            storage.storeQueue(queue);
+        }
+
+        Preferences::freeInstance();
+        SettingsStorage::freeInstance();
+        Profile::freeInstance();
+        Logger::freeInstance();
+    }
+
+    // Returns -1 if the memory usage isn't available
+    qint64 residentSetSize(const qint64 pid)
+    {
+#ifdef Q_OS_LINUX
+        QFile file {u"/proc/%1/status"_s.arg(pid)};
+        if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+            return -1;
+
+        while (!file.atEnd())
+        {
+            const QByteArray line = file.readLine();
+            if (line.startsWith("VmRSS:"))
+                return line.mid(6).trimmed().split(' ').first().toLongLong() * 1024;
+        }
+        return -1;
+#else
+        Q_UNUSED(pid);
+        return -1;
+#endif
+    }
+
+    int responseRID(const QByteArray &data)
+    {
+        const QByteArrayView key = "\"rid\":";
+        const qsizetype keyPos = data.indexOf(key);
+        if (keyPos < 0)
+            return 0;
+
+        const qsizetype valueBegin = keyPos + key.size();
+        qsizetype valueEnd = valueBegin;
+        while ((valueEnd < data.size()) && (data[valueEnd] >= '0') && (data[valueEnd] <= '9'))
+            ++valueEnd;
+        return data.sliced(valueBegin, (valueEnd - valueBegin)).toInt();
+    }
+
+    QNetworkReply *waitForReply(QNetworkReply *reply)
+    {
+        QEventLoop loop;
+        QObject::connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
+        loop.exec();
+        return reply;
+    }
+}
+
+class LoadClient final : public QObject
+{
+    Q_DISABLE_COPY_MOVE(LoadClient)
+
+public:
+    LoadClient(const Options &options, const QStringList &torrentIDs, Statistics &statistics, const quint32 seed, QObject *parent = nullptr)
+        : QObject(parent)
+        , m_options {options}
+        , m_torrentIDs {torrentIDs}
+        , m_statistics {statistics}
+        , m_random {seed}
+        , m_manager {new QNetworkAccessManager(this)}
+    {
+        m_manager->setTransferTimeout(REQUEST_TIMEOUT);
+    }
+
+    void start()
+    {
+        sendNextRequest();
+    }
+
+    void stop()
+    {
+        m_isStopped = true;
+    }
+
+private:
+    void sendNextRequest()
+    {
+        if (m_isStopped)
+            return;
+
+        const RequestKind kind = pickRequestKind();
+        QElapsedTimer timer;
+        timer.start();
+
+        QNetworkReply *reply = send(kind);
+        connect(reply, &QNetworkReply::finished, this, [this, kind, reply, timer]
+        {
+            reply->deleteLater();
+
+            RequestStatistics &statistics = m_statistics[static_cast<int>(kind)];
+            statistics.latencies.push_back(timer.nsecsElapsed() / 1000);
+            if (reply->error() != QNetworkReply::NoError)
+            {
+                ++statistics.errors;
+            }
+            else if (kind == RequestKind::MainData)
+            {
+                m_mainDataRID = responseRID(reply->readAll());
+            }
+            else if (kind == RequestKind::TorrentPeers)
+            {
+                m_peersRID = responseRID(reply->readAll());
+            }
+
+            if (m_options.thinkTime > 0ms)
+                QTimer::singleShot(m_options.thinkTime, this, &LoadClient::sendNextRequest);
+            else
+                sendNextRequest();
+        });
+    }
+
+    RequestKind pickRequestKind()
+    {
+        int weight = m_random.bounded(std::max(std::accumulate(m_options.mix.cbegin(), m_options.mix.cend(), 0), 1));
+        for (qsizetype i = 0; i < m_options.mix.size(); ++i)
+        {
+            weight -= m_options.mix[i];
+            if (weight < 0)
+                return REQUEST_KINDS[i].first;
+        }
+        return RequestKind::MainData;
+    }
+
+    QString randomTorrentID()
+    {
+        return m_torrentIDs[m_random.bounded(m_torrentIDs.size())];
+    }
+
+    QNetworkReply *send(const RequestKind kind)
+    {
+        QUrlQuery query;
+        QString apiMethod;
+        switch (kind)
+        {
+        case RequestKind::MainData:
+            apiMethod = u"sync/maindata"_s;
+            query.addQueryItem(u"rid"_s, QString::number(m_mainDataRID));
+            break;
+        case RequestKind::TorrentsInfo:
+            apiMethod = u"torrents/info"_s;
+            query.addQueryItem(u"sort"_s, u"name"_s);
+            query.addQueryItem(u"limit"_s, QString::number(TORRENTS_INFO_PAGE_SIZE));
+            query.addQueryItem(u"offset"_s, QString::number(m_random.bounded((m_torrentIDs.size() / TORRENTS_INFO_PAGE_SIZE) + 1) * TORRENTS_INFO_PAGE_SIZE));
+            break;
+        case RequestKind::TorrentPeers:
+            apiMethod = u"sync/torrentPeers"_s;
+            // keep watching the same torrent for a while like the peers tab does
+            if (m_peersTorrentID.isEmpty() || (m_random.bounded(10) == 0))
+            {
+                m_peersTorrentID = randomTorrentID();
+                m_peersRID = 0;
+            }
+            query.addQueryItem(u"hash"_s, m_peersTorrentID);
+            query.addQueryItem(u"rid"_s, QString::number(m_peersRID));
+            break;
+        case RequestKind::BulkMutation:
+            {
+                QStringList ids;
+                for (int i = 0; i < BULK_MUTATION_SIZE; ++i)
+                    ids.append(randomTorrentID());
+
+                QUrlQuery postData;
+                postData.addQueryItem(u"hashes"_s, ids.join(u'|'));
+                postData.addQueryItem(u"tags"_s, BULK_MUTATION_TAG);
+                m_isTagAdded = !m_isTagAdded;
+                return m_manager->post(makeRequest((m_isTagAdded ? u"torrents/addTags"_s : u"torrents/removeTags"_s), {})
+                        , postData.toString(QUrl::FullyEncoded).toUtf8());
+            }
+        }
+
+        return m_manager->get(makeRequest(apiMethod, query));
+    }
+
+    QNetworkRequest makeRequest(const QString &apiMethod, const QUrlQuery &query) const
+    {
+        QUrl url = m_options.url.resolved(QUrl(u"api/v2/"_s + apiMethod));
+        url.setQuery(query);
+
+        QNetworkRequest request {url};
+        request.setHeader(QNetworkRequest::ContentTypeHeader, u"application/x-www-form-urlencoded"_s);
+        if (!m_options.sessionCookie.isEmpty())
+            request.setRawHeader("Cookie", m_options.sessionCookie.toLatin1());
+        return request;
+    }
+
+    const Options &m_options;
+    const QStringList &m_torrentIDs;
+    Statistics &m_statistics;
+    QRandomGenerator m_random;
+    QNetworkAccessManager *m_manager = nullptr;
+
+    bool m_isStopped = false;
+    bool m_isTagAdded = false;
+    int m_mainDataRID = 0;
+    int m_peersRID = 0;
+    QString m_peersTorrentID;
+};
+
+namespace
+{
+    QNetworkRequest makeBootstrapRequest(const Options &options, const QString &apiMethod)
+    {
+        QNetworkRequest request {options.url.resolved(QUrl(u"api/v2/"_s + apiMethod))};
+        request.setHeader(QNetworkRequest::ContentTypeHeader, u"application/x-www-form-urlencoded"_s);
+        request.setTransferTimeout(REQUEST_TIMEOUT);
+        if (!options.sessionCookie.isEmpty())
+            request.setRawHeader("Cookie", options.sessionCookie.toLatin1());
+        return request;
+    }
+
+    // Returns the session cookie, empty string if the server didn't issue one, or std::nullopt on failure
+    std::optional<QString> logIn(QNetworkAccessManager &manager, const Options &options, const QString &username, const QString &password)
+    {
+        QUrlQuery postData;
+        postData.addQueryItem(u"username"_s, username);
+        postData.addQueryItem(u"password"_s, password);
+
+        const std::unique_ptr<QNetworkReply> reply {waitForReply(manager.post(makeBootstrapRequest(options, u"auth/login"_s)
+                , postData.toString(QUrl::FullyEncoded).toUtf8()))};
+        if ((reply->error() != QNetworkReply::NoError) || (reply->readAll() != "Ok."))
+            return std::nullopt;
+
+        const auto cookies = reply->header(QNetworkRequest::SetCookieHeader).value<QList<QNetworkCookie>>();
+        if (cookies.isEmpty())
+            return QString();
+        return QString::fromLatin1(cookies.first().toRawForm(QNetworkCookie::NameAndValueOnly));
+    }
+
+    QStringList fetchTorrentIDs(QNetworkAccessManager &manager, const Options &options)
+    {
+        const std::unique_ptr<QNetworkReply> reply {waitForReply(manager.get(makeBootstrapRequest(options, u"torrents/info"_s)))};
+        if (reply->error() != QNetworkReply::NoError)
+            return {};
+
+        const QJsonArray torrents = QJsonDocument::fromJson(reply->readAll()).array();
+        QStringList ids;
+        ids.reserve(torrents.size());
+        for (const QJsonValue &torrent : torrents)
+            ids.append(torrent.toObject().value(u"hash"_s).toString());
+        return ids;
+    }
+
+    qint64 percentile(const std::vector<qint64> &sortedValues, const double p)
+    {
+        if (sortedValues.empty())
+            return 0;
+
+        const auto index = static_cast<std::size_t>(std::ceil(p * sortedValues.size()));
+        return sortedValues[std::clamp<std::size_t>(index, 1, sortedValues.size()) - 1];
+    }
+
+    QString formatLatency(const qint64 microseconds)
+    {
+        return QString::number((microseconds / 1000.0), 'f', 1);
+    }
+
+    void printReport(const Options &options, Statistics &statistics, const double elapsedSeconds
+            , const qint64 startMemory, const qint64 peakMemory, const qint64 endMemory)
+    {
+        QTextStream out {stdout};
+
+        qint64 totalCount = 0;
+        int totalErrors = 0;
+        for (const RequestStatistics &requestStatistics : asConst(statistics))
+        {
+            totalCount += static_cast<qint64>(requestStatistics.latencies.size());
+            totalErrors += requestStatistics.errors;
+        }
+
+        out << u"Duration: %1 s, clients: %2, requests: %3 (%4 req/s), errors: %5"_s.arg(QString::number(elapsedSeconds, 'f', 1))
+                .arg(options.clientsCount).arg(totalCount).arg(QString::number((totalCount / elapsedSeconds), 'f', 1)).arg(totalErrors) << Qt::endl;
+        out << Qt::endl;
+        out << u"%1 %2 %3 %4 %5 %6 %7 %8"_s.arg(u"Request"_s, -26).arg(u"Count"_s, 9).arg(u"Errors"_s, 7).arg(u"req/s"_s, 9)
+                .arg(u"p50 ms"_s, 9).arg(u"p90 ms"_s, 9).arg(u"p99 ms"_s, 9).arg(u"max ms"_s, 9) << Qt::endl;
+        for (const auto &[kind, name] : REQUEST_KINDS)
+        {
+            RequestStatistics &requestStatistics = statistics[static_cast<int>(kind)];
+            std::vector<qint64> &latencies = requestStatistics.latencies;
+            std::ranges::sort(latencies);
+
+            const auto count = static_cast<qint64>(latencies.size());
+            out << u"%1 %2 %3 %4 %5 %6 %7 %8"_s.arg(name, -26).arg(count, 9).arg(requestStatistics.errors, 7)
+                    .arg(QString::number((count / elapsedSeconds), 'f', 1), 9)
+                    .arg(formatLatency(percentile(latencies, 0.5)), 9).arg(formatLatency(percentile(latencies, 0.9)), 9)
+                    .arg(formatLatency(percentile(latencies, 0.99)), 9).arg(formatLatency(latencies.empty() ? 0 : latencies.back()), 9)
+                << Qt::endl;
+        }
+
+        if (startMemory >= 0)
+        {
+            out << Qt::endl;
+            out << u"Server memory (RSS): start %1, peak %2, end %3"_s.arg(Utils::Misc::friendlyUnit(startMemory)
+                    , Utils::Misc::friendlyUnit(peakMemory), Utils::Misc::friendlyUnit(endMemory)) << Qt::endl;
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app {argc, argv};
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(u"Replays a mix of WebAPI client requests against a running qBittorrent instance."_s);
+    parser.addHelpOption();
+    const QCommandLineOption urlOption {u"url"_s, u"WebUI address."_s, u"url"_s, u"http://127.0.0.1:8080/"_s};
+    const QCommandLineOption usernameOption {u"username"_s, u"WebUI username, no login is performed if omitted."_s, u"username"_s};
+    const QCommandLineOption passwordOption {u"password"_s, u"WebUI password."_s, u"password"_s};
+    const QCommandLineOption clientsOption {u"clients"_s, u"Number of concurrent clients."_s, u"count"_s, u"100"_s};
+    const QCommandLineOption durationOption {u"duration"_s, u"Duration of the run in seconds."_s, u"seconds"_s, u"60"_s};
+    const QCommandLineOption thinkTimeOption {u"think-time"_s, u"Delay between the requests of a client in milliseconds."_s, u"ms"_s, u"0"_s};
+    const QCommandLineOption mixOption {u"mix"_s, u"Relative weights of maindata, torrents/info, torrentPeers and bulk mutation requests."_s
+            , u"weights"_s, u"50,25,15,10"_s};
+    const QCommandLineOption seedOption {u"seed"_s, u"Seed of the request mix."_s, u"seed"_s, u"42"_s};
+    const QCommandLineOption pidOption {u"pid"_s, u"Process ID of the server to sample the memory usage of (Linux only)."_s, u"pid"_s};
+    const QCommandLineOption generateProfileOption {u"generate-profile"_s
+            , u"Generate a synthetic profile for `qbittorrent-nox --profile=<dir>` and exit."_s, u"dir"_s};
+    const QCommandLineOption torrentsOption {u"torrents"_s, u"Number of torrents in the generated profile."_s, u"count"_s, u"50000"_s};
+    parser.addOptions({urlOption, usernameOption, passwordOption, clientsOption, durationOption, thinkTimeOption, mixOption
+            , seedOption, pidOption, generateProfileOption, torrentsOption});
+    parser.process(app);
+
+    QTextStream err {stderr};
+
+    if (parser.isSet(generateProfileOption))
+    {
+        const int torrentsCount = parser.value(torrentsOption).toInt();
+        generateProfile(Path(parser.value(generateProfileOption)), torrentsCount);
+        err << u"Generated profile with %1 torrents in %2"_s.arg(torrentsCount).arg(parser.value(generateProfileOption)) << Qt::endl;
+        return 0;
+    }
+
+    Options options;
+    options.url = QUrl(parser.value(urlOption));
+    options.clientsCount = std::max(1, parser.value(clientsOption).toInt());
+    options.duration = std::chrono::seconds(std::max(1, parser.value(durationOption).toInt()));
+    options.thinkTime = std::chrono::milliseconds(std::max(0, parser.value(thinkTimeOption).toInt()));
+    options.seed = parser.value(seedOption).toUInt();
+    for (const QString &weight : asConst(parser.value(mixOption).split(u',')))
+        options.mix.append(std::max(0, weight.toInt()));
+    options.mix.resize(REQUEST_KINDS.size());
+
+    QNetworkAccessManager bootstrapManager;
+    if (parser.isSet(usernameOption))
+    {
+        const std::optional<QString> sessionCookie = logIn(bootstrapManager, options, parser.value(usernameOption), parser.value(passwordOption));
+        if (!sessionCookie)
+        {
+            err << u"Couldn't log in to %1"_s.arg(options.url.toString()) << Qt::endl;
+            return 1;
+        }
+        options.sessionCookie = *sessionCookie;
+    }
+
+    const QStringList torrentIDs = fetchTorrentIDs(bootstrapManager, options);
+    if (torrentIDs.isEmpty())
+    {
+        err << u"Couldn't fetch the torrent list from %1 or it is empty"_s.arg(options.url.toString()) << Qt::endl;
+        return 1;
+    }
+    err << u"Running %1 clients against %2 torrents for %3 s"_s.arg(options.clientsCount).arg(torrentIDs.size())
+            .arg(std::chrono::duration_cast<std::chrono::seconds>(options.duration).count()) << Qt::endl;
+
+    const qint64 pid = parser.isSet(pidOption) ? parser.value(pidOption).toLongLong() : -1;
+    const qint64 startMemory = (pid > 0) ? residentSetSize(pid) : -1;
+    qint64 peakMemory = startMemory;
+    QTimer memoryTimer;
+    if (startMemory >= 0)
+    {
+        QObject::connect(&memoryTimer, &QTimer::timeout, &memoryTimer, [pid, &peakMemory]
+        {
+            peakMemory = std::max(peakMemory, residentSetSize(pid));
+        });
+        memoryTimer.start(1s);
+    }
+
+    Statistics statistics(REQUEST_KINDS.size());
+    QList<LoadClient *> clients;
+    clients.reserve(options.clientsCount);
+    for (int i = 0; i < options.clientsCount; ++i)
+        clients.append(new LoadClient(options, torrentIDs, statistics, (options.seed + i), &app));
+
+    QElapsedTimer elapsedTimer;
+    elapsedTimer.start();
+    for (LoadClient *client : asConst(clients))
+        client->start();
+
+    QTimer::singleShot(options.duration, &app, [&app, &clients]
+    {
+        for (LoadClient *client : asConst(clients))
+            client->stop();
+        app.quit();
+    });
+    app.exec();
+
+    const double elapsedSeconds = elapsedTimer.elapsed() / 1000.0;
+    const qint64 endMemory = (startMemory >= 0) ? residentSetSize(pid) : -1;
+    printReport(options, statistics, elapsedSeconds, startMemory, std::max(peakMemory, endMemory), endMemory);
+    return 0;
+}